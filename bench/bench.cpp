@@ -0,0 +1,370 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <hephaistos/hephaistos.hpp>
+#include <hephaistos/raytracing.hpp>
+
+using namespace hephaistos;
+
+namespace {
+
+/*********************************** HARNESS **********************************/
+
+struct Options {
+    //only run benchmarks whose name contains the filter
+    std::string filter;
+    //measured iterations per benchmark; warm up runs are not counted
+    uint32_t iterations = 20;
+    uint32_t warmup = 3;
+    bool csv = false;
+    std::string output;
+};
+
+struct Result {
+    std::string name;
+    uint32_t iterations;
+    double min;
+    double median;
+    double mean;
+    double max;
+    //throughput derived from the median; zero if not applicable
+    double bytesPerSecond;
+    double itemsPerSecond;
+};
+
+class Runner {
+public:
+    //amount of bytes or items processed by a single iteration
+    struct Work {
+        uint64_t bytes = 0;
+        uint64_t items = 0;
+    };
+
+    void run(const std::string& name, Work work, const std::function<void()>& fn) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+            return;
+        std::cerr << "Running " << name << "..." << std::endl;
+
+        for (auto i = 0u; i < options.warmup; ++i)
+            fn();
+        std::vector<double> times(options.iterations);
+        for (auto& time : times) {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            auto end = std::chrono::steady_clock::now();
+            time = std::chrono::duration<double, std::nano>(end - start).count();
+        }
+
+        std::sort(times.begin(), times.end());
+        auto n = times.size();
+        auto median = n % 2 ? times[n / 2] : 0.5 * (times[n / 2 - 1] + times[n / 2]);
+        auto perSecond = [median](uint64_t amount) {
+            return median > 0.0 ? amount * 1e9 / median : 0.0;
+        };
+        results.push_back({
+            .name = name,
+            .iterations = static_cast<uint32_t>(n),
+            .min = times.front(),
+            .median = median,
+            .mean = std::accumulate(times.begin(), times.end(), 0.0) / n,
+            .max = times.back(),
+            .bytesPerSecond = perSecond(work.bytes),
+            .itemsPerSecond = perSecond(work.items)
+        });
+    }
+
+    bool enabled(std::string_view name) const {
+        return options.filter.empty() || name.find(options.filter) != std::string_view::npos;
+    }
+
+    Options options;
+    std::vector<Result> results;
+};
+
+void writeJsonString(std::ostream& out, std::string_view str) {
+    out << '"';
+    for (auto c : str) {
+        if (c == '"' || c == '\\')
+            out << '\\';
+        if (static_cast<unsigned char>(c) >= 0x20)
+            out << c;
+    }
+    out << '"';
+}
+
+void writeJson(std::ostream& out, const DeviceInfo& device, const std::vector<Result>& results) {
+    out << "{\n  \"version\": \"" << VERSION_MAJOR << '.' << VERSION_MINOR << '.' << VERSION_PATCH << "\",\n"
+        << "  \"device\": ";
+    writeJsonString(out, device.name);
+    out << ",\n  \"discrete\": " << (device.isDiscrete ? "true" : "false") << ",\n"
+        << "  \"unit\": \"ns\",\n  \"results\": [";
+    for (auto i = 0u; i < results.size(); ++i) {
+        auto& r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"name\": ";
+        writeJsonString(out, r.name);
+        out << ", \"iterations\": " << r.iterations
+            << ", \"min\": " << r.min
+            << ", \"median\": " << r.median
+            << ", \"mean\": " << r.mean
+            << ", \"max\": " << r.max
+            << ", \"bytes_per_second\": " << r.bytesPerSecond
+            << ", \"items_per_second\": " << r.itemsPerSecond << '}';
+    }
+    out << "\n  ]\n}\n";
+}
+
+void writeCsv(std::ostream& out, const std::vector<Result>& results) {
+    out << "name,iterations,min_ns,median_ns,mean_ns,max_ns,bytes_per_second,items_per_second\n";
+    for (auto& r : results) {
+        out << r.name << ',' << r.iterations << ','
+            << r.min << ',' << r.median << ',' << r.mean << ',' << r.max << ','
+            << r.bytesPerSecond << ',' << r.itemsPerSecond << '\n';
+    }
+}
+
+/********************************* BENCHMARKS *********************************/
+
+constexpr auto AddSource = R"(
+    #version 460
+
+    layout(local_size_x = 32) in;
+
+    readonly buffer tensorA { int in_a[]; };
+    readonly buffer tensorB { int in_b[]; };
+    writeonly buffer tensorOut { int out_c[]; };
+
+    void main() {
+        uint idx = gl_GlobalInvocationID.x;
+        out_c[idx] = in_a[idx] + in_b[idx];
+    }
+)";
+
+void benchSubmit(Runner& runner, const ContextHandle& context) {
+    Tensor<int> tensor(context, 64);
+
+    //round trip of a single tiny command through a one time submit
+    runner.run("submit/one_time", { .items = 1 }, [&]() {
+        execute(context, clearTensor(tensor, { .size = 4 }));
+    });
+
+    //overhead of a sequence grows with the amount of steps
+    for (auto steps : { 1u, 8u, 64u }) {
+        runner.run("submit/sequence/steps=" + std::to_string(steps), { .items = steps }, [&]() {
+            auto builder = beginSequence(context);
+            for (auto i = 0u; i < steps; ++i)
+                builder.Then(clearTensor(tensor, { .size = 4, .data = i }));
+            builder.Submit().wait();
+        });
+    }
+}
+
+void benchTransfer(Runner& runner, const ContextHandle& context) {
+    for (uint64_t size : { 4ull << 10, 64ull << 10, 1ull << 20, 16ull << 20, 64ull << 20 }) {
+        auto suffix = "/size=" + std::to_string(size);
+        if (!runner.enabled("transfer/upload" + suffix) && !runner.enabled("transfer/download" + suffix))
+            continue;
+
+        Buffer<std::byte> buffer(context, size);
+        Tensor<std::byte> tensor(context, size);
+        runner.run("transfer/upload" + suffix, { .bytes = size }, [&]() {
+            execute(context, updateTensor(buffer, tensor));
+        });
+        runner.run("transfer/download" + suffix, { .bytes = size }, [&]() {
+            execute(context, retrieveTensor(tensor, buffer));
+        });
+    }
+}
+
+void benchDispatch(Runner& runner, const ContextHandle& context) {
+    if (!runner.enabled("dispatch/record"))
+        return;
+
+    Compiler compiler;
+    Program program(context, compiler.compile(AddSource));
+    Tensor<int> a(context, 1024), b(context, 1024), c(context, 1024);
+    program.bindParameterList(a, b, c);
+
+    //cost of recording dispatches into a subroutine on the host
+    for (auto count : { 1u, 64u, 1024u }) {
+        runner.run("dispatch/record/count=" + std::to_string(count), { .items = count }, [&]() {
+            SubroutineBuilder builder(context);
+            for (auto i = 0u; i < count; ++i)
+                builder.addCommand(program.dispatch(32));
+            auto subroutine = builder.finish();
+        });
+    }
+}
+
+void benchCompiler(Runner& runner) {
+    if (!runner.enabled("compiler/compile"))
+        return;
+
+    Compiler compiler;
+    runner.run("compiler/compile", { .bytes = std::string_view(AddSource).size(), .items = 1 }, [&]() {
+        auto code = compiler.compile(AddSource);
+    });
+}
+
+//grid of quads in the xy plane
+Mesh createGrid(uint32_t size, std::vector<float>& vertices, std::vector<uint32_t>& indices) {
+    vertices.clear();
+    indices.clear();
+    for (auto y = 0u; y <= size; ++y) {
+        for (auto x = 0u; x <= size; ++x) {
+            vertices.push_back(static_cast<float>(x));
+            vertices.push_back(static_cast<float>(y));
+            vertices.push_back(0.0f);
+        }
+    }
+    for (auto y = 0u; y < size; ++y) {
+        for (auto x = 0u; x < size; ++x) {
+            auto i = y * (size + 1) + x;
+            indices.insert(indices.end(), { i, i + 1, i + size + 1 });
+            indices.insert(indices.end(), { i + 1, i + size + 2, i + size + 1 });
+        }
+    }
+    return {
+        .vertices = std::as_bytes(std::span<const float>(vertices)),
+        .indices = indices
+    };
+}
+
+void benchRaytracing(Runner& runner, const ContextHandle& context) {
+    if (!isRaytracingEnabled(context)) {
+        std::cerr << "Skipping raytracing: not supported on this device" << std::endl;
+        return;
+    }
+
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    for (auto size : { 16u, 256u }) {
+        auto triangles = 2ull * size * size;
+        auto name = "raytracing/blas/triangles=" + std::to_string(triangles);
+        if (!runner.enabled(name))
+            continue;
+        auto mesh = createGrid(size, vertices, indices);
+        runner.run(name, { .items = triangles }, [&]() {
+            GeometryStore store(context, mesh, false, {
+                .preference = BuildPreference::FAST_BUILD,
+                .compact = false
+            });
+        });
+    }
+
+    auto mesh = createGrid(4, vertices, indices);
+    GeometryStore store(context, mesh);
+    for (auto count : { 16u, 4096u }) {
+        auto name = "raytracing/tlas/instances=" + std::to_string(count);
+        if (!runner.enabled(name))
+            continue;
+        std::vector<GeometryInstance> instances;
+        for (auto i = 0u; i < count; ++i) {
+            auto transform = IdentityTransform;
+            transform.matrix[0][3] = static_cast<float>(i % 64) * 8.0f;
+            transform.matrix[1][3] = static_cast<float>(i / 64) * 8.0f;
+            instances.push_back(store.createInstance(0, transform, i));
+        }
+        runner.run(name, { .items = count }, [&]() {
+            AccelerationStructure tlas(context, instances, {
+                .preference = BuildPreference::FAST_BUILD
+            });
+        });
+    }
+}
+
+/************************************ MAIN ************************************/
+
+void printUsage() {
+    std::cerr << "Usage: hephaistos_bench [options]\n"
+        << "  --filter <text>      Only run benchmarks whose name contains text\n"
+        << "  --iterations <n>     Measured iterations per benchmark (default: 20)\n"
+        << "  --warmup <n>         Unmeasured iterations per benchmark (default: 3)\n"
+        << "  --csv                Write CSV instead of JSON\n"
+        << "  --output <file>      Write results to file instead of stdout\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Runner runner;
+    auto& options = runner.options;
+    for (auto i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (++i >= argc) {
+                printUsage();
+                std::exit(1);
+            }
+            return argv[i];
+        };
+        if (arg == "--filter") {
+            options.filter = next();
+        }
+        else if (arg == "--iterations") {
+            options.iterations = std::max(1, std::stoi(next()));
+        }
+        else if (arg == "--warmup") {
+            options.warmup = std::max(0, std::stoi(next()));
+        }
+        else if (arg == "--csv") {
+            options.csv = true;
+        }
+        else if (arg == "--output") {
+            options.output = next();
+        }
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    //enable ray tracing if available, so its builds can be measured too
+    auto context = createEmptyContext();
+    try {
+        auto extensions = std::to_array({ createRaytracingExtension() });
+        context = createContext(extensions);
+    }
+    catch (const std::exception&) {
+        context = createContext();
+    }
+    auto device = getDeviceInfo(context);
+    std::cerr << "Selected Device: " << device.name << "\n\n";
+
+    try {
+        benchSubmit(runner, context);
+        benchTransfer(runner, context);
+        benchDispatch(runner, context);
+        benchCompiler(runner);
+        benchRaytracing(runner, context);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Benchmark failed!\n" << e.what() << '\n';
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!options.output.empty()) {
+        file.open(options.output);
+        if (!file) {
+            std::cerr << "Could not open " << options.output << '\n';
+            return 1;
+        }
+    }
+    auto& out = options.output.empty() ? std::cout : file;
+    if (options.csv)
+        writeCsv(out, runner.results);
+    else
+        writeJson(out, device, runner.results);
+}
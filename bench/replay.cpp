@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <hephaistos/hephaistos.hpp>
+
+using namespace hephaistos;
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: hephaistos_replay [options] <capture>\n"
+        << "  --iterations <n>     Measured runs (default: 10)\n"
+        << "  --warmup <n>         Unmeasured runs (default: 1)\n"
+        << "  --keep-contents      Do not restore the captured tensors between runs\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    ReplayOptions options{};
+    std::string path;
+    for (auto i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (++i >= argc) {
+                printUsage();
+                std::exit(1);
+            }
+            return argv[i];
+        };
+        if (arg == "--iterations") {
+            options.iterations = std::max(1, std::stoi(next()));
+        }
+        else if (arg == "--warmup") {
+            options.warmup = std::max(0, std::stoi(next()));
+        }
+        else if (arg == "--keep-contents") {
+            options.resetTensors = false;
+        }
+        else if (path.empty() && !arg.starts_with("--")) {
+            path = arg;
+        }
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    if (path.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    try {
+        Capture capture{ std::filesystem::path(path) };
+        auto context = createContext();
+        std::cerr << "Selected Device: " << getDeviceInfo(context).name << '\n';
+        std::cerr << "Replaying " << capture.getSteps().size() << " steps using "
+            << capture.getProgramCount() << " programs and "
+            << capture.getTensorCount() << " tensors...\n\n";
+
+        auto times = replayCapture(context, capture, options);
+        std::sort(times.begin(), times.end());
+        auto n = times.size();
+        auto median = n % 2 ? times[n / 2] : 0.5 * (times[n / 2 - 1] + times[n / 2]);
+        std::cout << "iterations: " << n << '\n'
+            << "min_ns:     " << times.front() << '\n'
+            << "median_ns:  " << median << '\n'
+            << "mean_ns:    " << std::accumulate(times.begin(), times.end(), 0.0) / n << '\n'
+            << "max_ns:     " << times.back() << '\n';
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Replay failed!\n" << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,72 @@
+#Cross builds can not run the tool they build, thus allow using one built for the host
+set(HEPHAISTOS_SHADERC "" CACHE FILEPATH "hephaistos_shaderc used for compiling shaders at build time")
+
+#[[
+hephaistos_add_shaders(<target>
+    SOURCES <glsl files...>
+    [HEADER <name>]
+    [NAMESPACE <namespace>]
+    [INCLUDE_DIRS <dirs...>]
+    [DEFINES <name[=value]...>]
+    [DEPENDS <files...>]
+    [STRIP_DEBUG_INFO]
+)
+
+Compiles the compute shaders at build time and embeds them in the header
+<name>.hpp (default: shaders.hpp) available to <target>. For each shader the
+header contains its SPIR-V as constexpr uint32_t array named after the file,
+followed by its reflected local size and bindings. loadBundle() returns a
+ProgramBundle of all shaders carrying their reflection. List included files
+under DEPENDS to recompile if they change.
+#]]
+function(hephaistos_add_shaders target)
+    cmake_parse_arguments(PARSE_ARGV 1 ARG
+        "STRIP_DEBUG_INFO"
+        "HEADER;NAMESPACE"
+        "SOURCES;INCLUDE_DIRS;DEFINES;DEPENDS"
+    )
+    if(NOT ARG_SOURCES)
+        message(FATAL_ERROR "hephaistos_add_shaders: no SOURCES given!")
+    endif()
+    if(NOT ARG_HEADER)
+        set(ARG_HEADER shaders)
+    endif()
+    if(NOT ARG_NAMESPACE)
+        set(ARG_NAMESPACE shaders)
+    endif()
+
+    if(HEPHAISTOS_SHADERC)
+        set(shaderc ${HEPHAISTOS_SHADERC})
+    else()
+        set(shaderc $<TARGET_FILE:hephaistos_shaderc>)
+        list(APPEND ARG_DEPENDS hephaistos_shaderc)
+    endif()
+
+    set(header ${CMAKE_CURRENT_BINARY_DIR}/${target}_shaders/${ARG_HEADER}.hpp)
+    set(args -o ${header} -n ${ARG_NAMESPACE})
+    foreach(dir IN LISTS ARG_INCLUDE_DIRS)
+        get_filename_component(dir ${dir} ABSOLUTE)
+        list(APPEND args -I ${dir})
+    endforeach()
+    foreach(define IN LISTS ARG_DEFINES)
+        list(APPEND args -D ${define})
+    endforeach()
+    if(ARG_STRIP_DEBUG_INFO)
+        list(APPEND args --strip)
+    endif()
+    set(sources)
+    foreach(source IN LISTS ARG_SOURCES)
+        get_filename_component(source ${source} ABSOLUTE)
+        list(APPEND sources ${source})
+    endforeach()
+
+    add_custom_command(
+        OUTPUT ${header}
+        COMMAND ${shaderc} ${args} ${sources}
+        DEPENDS ${sources} ${ARG_DEPENDS}
+        COMMENT "Compiling shaders of ${target}"
+        VERBATIM
+    )
+    target_sources(${target} PRIVATE ${header})
+    target_include_directories(${target} PRIVATE ${CMAKE_CURRENT_BINARY_DIR}/${target}_shaders)
+endfunction()
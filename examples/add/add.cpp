@@ -34,10 +34,7 @@ int main() {
         .And(updateTensor(buffer2, tensor2))
         .Then(program.dispatch(10))
         .Then(retrieveTensor(tensor3, buffer3))
-        .Submit();
-
-    //If we don't catch the submission generated by Submit()
-    //the execution is paused until it's finished
+        .Submit().wait();
 
     //read out
     for (auto v : buffer3.getMemory()) {
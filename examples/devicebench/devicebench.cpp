@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "hephaistos/hephaistos.hpp"
+namespace hp = hephaistos;
+
+namespace {
+
+//tiny kernel, so dispatches are dominated by their overhead
+constexpr auto IncrementSource = R"(
+    #version 460
+
+    layout(local_size_x = 32) in;
+
+    buffer Data { uint data[]; };
+
+    void main() {
+        data[gl_LocalInvocationID.x] += 1;
+    }
+)";
+
+constexpr auto Sizes = { 64ull << 10, 1ull << 20, 16ull << 20, 64ull << 20 };
+constexpr auto DispatchCount = 1024u;
+
+uint32_t iterations = 10;
+
+//median duration of fn in seconds after a single warm up run
+double measure(const std::function<void()>& fn) {
+    fn();
+    std::vector<double> times(iterations);
+    for (auto& time : times) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        time = std::chrono::duration<double>(end - start).count();
+    }
+    std::sort(times.begin(), times.end());
+    auto n = times.size();
+    return n % 2 ? times[n / 2] : 0.5 * (times[n / 2 - 1] + times[n / 2]);
+}
+
+std::string formatSize(uint64_t size) {
+    return size >= (1 << 20)
+        ? std::to_string(size >> 20) + " MiB"
+        : std::to_string(size >> 10) + " KiB";
+}
+
+void printBandwidth(std::string_view name, uint64_t size, double seconds) {
+    std::cout << "  " << std::left << std::setw(22) << name
+        << std::right << std::setw(8) << formatSize(size)
+        << std::setw(12) << std::fixed << std::setprecision(2)
+        << size / seconds * 1e-9 << " GB/s\n";
+}
+
+void benchBandwidth(const hp::ContextHandle& context) {
+    std::cout << "Bandwidth:\n";
+    for (auto size : Sizes) {
+        hp::Buffer<std::byte> buffer(context, size);
+        hp::Tensor<std::byte> tensor(context, size);
+        hp::Tensor<std::byte> other(context, size);
+        std::memset(buffer.getMemory().data(), 1, size);
+
+        //staging copies of unmapped tensors
+        printBandwidth("host -> device", size, measure([&]() {
+            hp::execute(context, hp::updateTensor(buffer, tensor));
+        }));
+        printBandwidth("device -> host", size, measure([&]() {
+            hp::execute(context, hp::retrieveTensor(tensor, buffer));
+        }));
+        printBandwidth("device -> device", size, measure([&]() {
+            hp::execute(context, hp::copyTensor(tensor, other));
+        }));
+
+        //mapped tensors are accessed by the host directly
+        hp::Tensor<std::byte> mapped(context, size, true);
+        if (!mapped.isMapped())
+            continue;
+        printBandwidth("host -> mapped", size, measure([&]() {
+            mapped.update(buffer.getMemory());
+        }));
+        printBandwidth("mapped -> host", size, measure([&]() {
+            mapped.retrieve(buffer.getMemory());
+        }));
+    }
+}
+
+void benchLatency(const hp::ContextHandle& context) {
+    hp::Tensor<uint32_t> tensor(context, 32);
+    auto latency = measure([&]() {
+        hp::execute(context, hp::clearTensor(tensor, { .size = 4 }));
+    });
+    std::cout << "Latency:\n  " << std::left << std::setw(30) << "execute round trip"
+        << std::right << std::setw(12) << std::fixed << std::setprecision(2)
+        << latency * 1e6 << " us\n";
+}
+
+void benchDispatch(const hp::ContextHandle& context) {
+    hp::Compiler compiler;
+    hp::Program program(context, compiler.compile(IncrementSource));
+    hp::Tensor<uint32_t> tensor(context, 32);
+    program.bindParameterList(tensor);
+
+    //record once, so only the submission and the device are measured
+    hp::SubroutineBuilder builder(context);
+    for (auto i = 0u; i < DispatchCount; ++i)
+        builder.addCommand(program.dispatch(1));
+    auto subroutine = builder.finish();
+    auto seconds = measure([&]() {
+        hp::execute(context, subroutine);
+    });
+    std::cout << "Dispatch:\n  " << std::left << std::setw(30) << "throughput"
+        << std::right << std::setw(12) << std::fixed << std::setprecision(2)
+        << DispatchCount / seconds * 1e-6 << " M/s\n";
+}
+
+void printUsage() {
+    std::cerr << "Usage: devicebench [options]\n"
+        << "  --device <id>        Only measure the device with the given index\n"
+        << "  --iterations <n>     Measured runs per value (default: 10)\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    int selected = -1;
+    for (auto i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (++i >= argc) {
+                printUsage();
+                std::exit(1);
+            }
+            return argv[i];
+        };
+        if (arg == "--device") {
+            selected = std::stoi(next());
+        }
+        else if (arg == "--iterations") {
+            iterations = std::max(1, std::stoi(next()));
+        }
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    //print header
+    std::cout << "Hephaistos v" << hp::VERSION_MAJOR << "." << hp::VERSION_MINOR << "." << hp::VERSION_PATCH << std::endl;
+
+    auto devices = hp::enumerateDevices();
+    if (selected >= static_cast<int>(devices.size())) {
+        std::cerr << "Device " << selected << " not found!\n";
+        return 1;
+    }
+    for (auto i = 0u; i < devices.size(); ++i) {
+        if (selected >= 0 && static_cast<uint32_t>(selected) != i)
+            continue;
+        auto info = hp::getDeviceInfo(devices[i]);
+        std::cout << "\n[" << i << "] " << info.name
+            << (info.isDiscrete ? " (discrete)" : "") << '\n';
+
+        try {
+            auto context = hp::createContext(devices[i]);
+            benchBandwidth(context);
+            benchLatency(context);
+            benchDispatch(context);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Benchmark failed!\n" << e.what() << '\n';
+            return 1;
+        }
+    }
+
+    //done
+    return 0;
+}
@@ -1,6 +1,19 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 //shader
 #include "mandelbrot.h"
@@ -8,62 +21,254 @@
 #include <hephaistos/hephaistos.hpp>
 using namespace hephaistos;
 
-//8k resolution
-constexpr uint32_t width = 7680;
-constexpr uint32_t height = 4320;
+namespace {
+
 //Typed push descriptor
 struct Push {
     float transX;
     float transY;
     float scale;
+    uint32_t width;
+    uint32_t height;
+    uint32_t tileSize;
+};
+//origin of a tile in pixels
+struct Tile {
+    uint32_t x;
+    uint32_t y;
 };
+//matches the shader's local size
+constexpr uint32_t GroupSize = 16;
+//largest image assembled on the host for saving
+constexpr uint64_t MaxSavedPixels = 1ull << 28;
 
-int main(int argc, char* argv[]) {
-    //Either use default params or parse args
+struct Options {
+    //virtual resolution; 32k x 16k by default
+    uint32_t width = 32768;
+    uint32_t height = 16384;
+    uint32_t tileSize = 1024;
+    uint32_t tilesPerChunk = 4;
+    uint32_t slots = 3;
+    bool allDevices = false;
     Push push{ 0.f, 0.f, 1.f };
-    if (argc == 4) {
-        push.transX = std::atof(argv[1]);
-        push.transY = std::atof(argv[2]);
-        push.scale = std::atof(argv[3]);
+    std::string output;
+};
+
+//renders tiles on a single device until the shared tile counter runs dry
+struct Renderer {
+    std::string name;
+    ContextHandle context;
+    StreamExecutor executor;
+    Program program;
+    std::vector<Subroutine> compute;
+
+    //stats
+    uint64_t tiles = 0;
+    uint64_t chunks = 0;
+    double seconds = 0.0;
+
+    Renderer(ContextHandle _context, const Options& options)
+        : name(getDeviceInfo(_context).name)
+        , context(std::move(_context))
+        , executor(context, sizeof(Tile),
+            uint64_t(options.tileSize) * options.tileSize * 4, {
+                .chunkSize = options.tilesPerChunk,
+                .slots = options.slots
+            })
+        , program(context, code)
+    {
+        //record the compute of each slot once against its tensors
+        auto groups = options.tileSize / GroupSize;
+        for (auto i = 0u; i < executor.getSlotCount(); ++i) {
+            auto slot = executor.getSlot(i);
+            program.bindParameterList(slot.input, slot.output, slot.count);
+            compute.push_back(SubroutineBuilder(context)
+                .addCommand(program.dispatch(options.push, groups, groups,
+                    static_cast<uint32_t>(executor.getChunkSize())))
+                .finish());
+        }
     }
+};
 
-    //create context
-    auto context = createContext();
+void printUsage() {
+    std::cerr << "Usage: mandelbrot [options]\n"
+        << "  --size <w> <h>       Virtual resolution (default: 32768 16384)\n"
+        << "  --tile <n>           Edge of a square tile, multiple of 16 (default: 1024)\n"
+        << "  --chunk <n>          Tiles per chunk (default: 4)\n"
+        << "  --slots <n>          Chunks in flight per device (default: 3)\n"
+        << "  --view <x> <y> <s>   Center and scale of the view (default: 0 0 1)\n"
+        << "  --all-devices        Splits the tiles across all suitable devices\n"
+        << "  --save <file>        Saves the image if it has at most 2^28 pixels\n";
+}
 
-    //print selected device
-    auto device = getDeviceInfo(context);
-    std::cout << "Selected Device: " << device.name << "\n\n";
+}
 
-    //allocate memory
-    ImageBuffer buffer(context, width, height);
-    Image image(context, ImageBuffer::Format, width, height);
+int main(int argc, char* argv[]) {
+    //parse args
+    Options options;
+    for (auto i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (++i >= argc) {
+                printUsage();
+                std::exit(1);
+            }
+            return argv[i];
+        };
+        if (arg == "--size") {
+            options.width = std::stoul(next());
+            options.height = std::stoul(next());
+        }
+        else if (arg == "--tile") {
+            options.tileSize = std::stoul(next());
+        }
+        else if (arg == "--chunk") {
+            options.tilesPerChunk = std::max(1ul, std::stoul(next()));
+        }
+        else if (arg == "--slots") {
+            options.slots = std::max(1ul, std::stoul(next()));
+        }
+        else if (arg == "--view") {
+            options.push.transX = std::stof(next());
+            options.push.transY = std::stof(next());
+            options.push.scale = std::stof(next());
+        }
+        else if (arg == "--all-devices") {
+            options.allDevices = true;
+        }
+        else if (arg == "--save") {
+            options.output = next();
+        }
+        else {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+    auto tileSize = options.tileSize;
+    if (tileSize == 0 || tileSize % GroupSize ||
+        options.width % tileSize || options.height % tileSize)
+    {
+        std::cerr << "Tile size must be a multiple of 16 and divide the resolution!\n";
+        return 1;
+    }
+    auto pixels = uint64_t(options.width) * options.height;
+    if (!options.output.empty() && pixels > MaxSavedPixels) {
+        std::cerr << "Image is too large to be saved!\n";
+        return 1;
+    }
+    options.push.width = options.width;
+    options.push.height = options.height;
+    options.push.tileSize = tileSize;
+
+    //create a renderer per device
+    std::vector<std::unique_ptr<Renderer>> renderers;
+    try {
+        if (options.allDevices) {
+            for (auto& device : enumerateDevices()) {
+                if (isDeviceSuitable(device))
+                    renderers.push_back(std::make_unique<Renderer>(createContext(device), options));
+            }
+        }
+        else {
+            renderers.push_back(std::make_unique<Renderer>(createContext(), options));
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Failed to create renderer!\n" << e.what() << '\n';
+        return 1;
+    }
+    for (auto& renderer : renderers)
+        std::cout << "Selected Device: " << renderer->name << '\n';
 
-    //create program
-    Program program(context, code);
-    program.bindParameter(image, "outImage");
+    //host copy of the image if it gets saved
+    std::vector<uint32_t> image(options.output.empty() ? 0 : pixels);
+    auto tilesX = options.width / tileSize;
+    auto tileCount = uint64_t(tilesX) * (options.height / tileSize);
+    std::atomic<uint64_t> nextTile = 0;
 
-    std::cout << "Rendering...\n";
+    std::cout << "Rendering " << options.width << "x" << options.height
+        << " in " << tileCount << " tiles...\n";
 
-    //stop the time needed for rendering
-    StopWatch watch(context);
+    //each device pulls tiles until all are rendered
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    std::mutex errorMutex;
+    std::string error;
+    for (auto& r : renderers) {
+        threads.emplace_back([&, &renderer = *r]() {
+            std::vector<std::vector<Tile>> inFlight(renderer.executor.getSlotCount());
+            std::vector<std::reference_wrapper<const Subroutine>> compute(
+                renderer.compute.begin(), renderer.compute.end());
+            auto source = [&](std::span<std::byte> chunk, uint64_t index) -> uint64_t {
+                auto count = renderer.executor.getChunkSize();
+                auto first = nextTile.fetch_add(count);
+                if (first >= tileCount)
+                    return 0;
+                count = std::min(count, tileCount - first);
+                auto& tiles = inFlight[index % inFlight.size()];
+                tiles.resize(count);
+                for (auto i = 0u; i < count; ++i) {
+                    auto t = first + i;
+                    tiles[i] = { static_cast<uint32_t>(t % tilesX) * tileSize,
+                        static_cast<uint32_t>(t / tilesX) * tileSize };
+                }
+                std::memcpy(chunk.data(), tiles.data(), count * sizeof(Tile));
+                return count;
+            };
+            auto sink = [&](std::span<const std::byte> chunk, uint64_t index) {
+                auto& tiles = inFlight[index % inFlight.size()];
+                renderer.tiles += tiles.size();
+                if (image.empty())
+                    return;
+                //copy each row of the tiles into the image
+                auto rowSize = tileSize * sizeof(uint32_t);
+                for (auto i = 0u; i < tiles.size(); ++i) {
+                    for (auto y = 0u; y < tileSize; ++y) {
+                        auto dst = uint64_t(tiles[i].y + y) * options.width + tiles[i].x;
+                        std::memcpy(image.data() + dst,
+                            chunk.data() + (uint64_t(i) * tileSize + y) * rowSize, rowSize);
+                    }
+                }
+            };
 
-    //create sequence
-    beginSequence(context)
-        .And(watch.start())
-        .And(program.dispatch(push, width / 4, height / 4))
-        .And(watch.stop())
-        .And(retrieveImage(image, buffer)) //has implicit barrier
-        .Submit();
-    
-    //If we don't catch the submission generated by Submit()
-    //the execution is paused until it's finished
+            try {
+                auto begin = std::chrono::steady_clock::now();
+                renderer.chunks = renderer.executor.run(compute, source, sink);
+                auto end = std::chrono::steady_clock::now();
+                renderer.seconds = std::chrono::duration<double>(end - begin).count();
+            }
+            catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                error = e.what();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    auto end = std::chrono::steady_clock::now();
+    if (!error.empty()) {
+        std::cerr << "Rendering failed!\n" << error << '\n';
+        return 1;
+    }
 
-    //check how long the rendering takes
-    std::cout << std::setprecision(3);
-    std::cout << "Rendered in " << watch.getElapsedTime() * 1e-6 << " ms\n";
+    //report throughput
+    auto tilePixels = uint64_t(tileSize) * tileSize;
+    std::cout << std::fixed << std::setprecision(2);
+    for (auto& renderer : renderers) {
+        std::cout << "  " << std::left << std::setw(40) << renderer->name << std::right
+            << std::setw(10) << renderer->tiles * tilePixels / renderer->seconds * 1e-6 << " Mpixel/s"
+            << std::setw(10) << renderer->seconds * 1e6 / std::max<uint64_t>(renderer->chunks, 1)
+            << " us/chunk\n";
+    }
+    auto seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << "Rendered in " << seconds * 1e3 << " ms ("
+        << pixels / seconds * 1e-6 << " Mpixel/s)\n";
 
     //write image to disk
-    std::cout << "Saving...\n";
-    buffer.save("mandelbrot.png");
+    if (!options.output.empty()) {
+        std::cout << "Saving...\n";
+        saveImage(options.output, std::as_bytes(std::span<const uint32_t>(image)),
+            options.width, options.height, ImageBuffer::DefaultFormat);
+    }
     std::cout << "Done!\n";
 }
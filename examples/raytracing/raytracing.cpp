@@ -70,7 +70,7 @@ int main() {
     beginSequence(context)
         .And(program.dispatch(push, 256, 256))
         .Then(retrieveImage(image, imgBuffer))
-        .Submit();
+        .Submit().wait();
 
     //write image to disk
     imgBuffer.save("raytracing.png");
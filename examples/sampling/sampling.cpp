@@ -23,7 +23,7 @@ int main(int argc, char* argv[]) {
 
     //load image
     auto texture = ImageBuffer::load(context, inPath).createTexture();
-    Image image(context, ImageBuffer::Format, width, height);
+    Image image(context, ImageBuffer::DefaultFormat, width, height);
     ImageBuffer result(context, width, height);
 
     //create program
@@ -34,7 +34,7 @@ int main(int argc, char* argv[]) {
     beginSequence(context)
         .And(program.dispatch(width, height))
         .Then(retrieveImage(image, result))
-        .Submit();
+        .Submit().wait();
 
     //write image to disk
     result.save(outPath);
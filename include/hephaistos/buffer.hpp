@@ -1,8 +1,13 @@
 #pragma once
 
 #include <cstddef>
+#include <filesystem>
+#include <functional>
 #include <initializer_list>
+#include <memory>
 #include <span>
+#include <type_traits>
+#include <vector>
 
 #include "hephaistos/argument.hpp"
 #include "hephaistos/command.hpp"
@@ -16,6 +21,29 @@ namespace hephaistos {
 */
 constexpr uint64_t whole_size = (~0ULL);
 
+/**
+ * @brief Tag selecting constructors importing existing host memory
+*/
+struct import_host_memory_t {
+    explicit import_host_memory_t() = default;
+};
+/**
+ * @brief Tag selecting constructors importing existing host memory
+*/
+inline constexpr import_host_memory_t import_host_memory{};
+
+/**
+ * @brief Checks wether the context supports importing host memory into buffers
+ *
+ * Requires VK_EXT_external_memory_host, which is enabled if available.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isHostMemoryImportSupported(const ContextHandle& context);
+/**
+ * @brief Returns the alignment in bytes address and size of imported host
+ *        memory must adhere to. Zero if importing is not supported.
+*/
+[[nodiscard]] HEPHAISTOS_API uint64_t getHostMemoryImportAlignment(const ContextHandle& context);
+
 template<class T = std::byte> class Buffer;
 
 /**
@@ -57,11 +85,28 @@ public:
      * @param data Data to fill the Buffer with
     */
     Buffer(ContextHandle context, std::span<const std::byte> data);
+    /**
+     * @brief Creates a buffer using the given host memory
+     *
+     * Instead of allocating new memory and copying the data, the device
+     * directly accesses the given memory, which must stay alive as long as
+     * the buffer is used. Throws if importing host memory is not supported.
+     *
+     * @param context Context onto which to create the buffer
+     * @param memory Memory to import. Address and size must be multiples of
+     *               getHostMemoryImportAlignment().
+    */
+    Buffer(ContextHandle context, std::span<std::byte> memory, import_host_memory_t);
     ~Buffer() override;
 
 public: //internal
     const vulkan::Buffer& getBuffer() const noexcept;
 
+protected: //internal
+    Buffer(ContextHandle context, BufferHandle buffer, std::span<std::byte> memory);
+    //swaps in a new buffer managing the given memory
+    BufferHandle exchangeBuffer(BufferHandle buffer, std::span<std::byte> memory) noexcept;
+
 private:
     BufferHandle buffer;
     std::span<std::byte> memory;
@@ -105,14 +150,330 @@ public:
     Buffer(ContextHandle context, std::initializer_list<T> data)
         : Buffer(std::move(context), std::span<const T>{data})
     {}
+    Buffer(ContextHandle context, std::span<T> memory, import_host_memory_t tag)
+        : Buffer<std::byte>(std::move(context), std::as_writable_bytes(memory), tag)
+    {}
     ~Buffer() override = default;
 };
 
 template<class Container> Buffer(ContextHandle, const Container&)
     -> Buffer<typename Container::value_type>;
 
+/**
+ * @brief Buffer optimized for uploading data to the device
+ *
+ * Unlike Buffer, which may be placed in host cached memory suited for
+ * reading back results, this buffer is allocated for sequential writes and
+ * prefers device local memory visible to the host, e.g. via resizable BAR.
+ * Such memory is usually write-combined, thus should be filled via write()
+ * using streaming stores and never be read from the host.
+ *
+ * @note Reading from the memory of an upload buffer is valid but may be
+ *       orders of magnitude slower than reading a Buffer.
+*/
+class HEPHAISTOS_API UploadBuffer : public Buffer<std::byte> {
+public:
+    /**
+     * @brief True, if the buffer lives in device local memory
+     *
+     * Copies from device local upload buffers to tensors do not cross the
+     * bus.
+    */
+    [[nodiscard]] bool isDeviceLocal() const;
+
+    /**
+     * @brief Writes the data into the buffer
+     *
+     * Uses non-temporal stores bypassing the host's caches if available,
+     * which avoids polluting them and makes full use of write-combining.
+     *
+     * @param data Data to write
+     * @param offset Offset into the buffer in bytes
+    */
+    void write(std::span<const std::byte> data, uint64_t offset = 0);
+
+    UploadBuffer(UploadBuffer&& other) noexcept;
+    UploadBuffer& operator=(UploadBuffer&& other) noexcept;
+
+    /**
+     * @brief Allocates a new upload buffer
+     *
+     * @param context Context onto which to create the buffer
+     * @param size Size of the buffer in bytes
+    */
+    UploadBuffer(ContextHandle context, uint64_t size);
+    /**
+     * @brief Allocates a new upload buffer
+     *
+     * @param context Context onto which to create the buffer
+     * @param data Data to fill the buffer with
+    */
+    UploadBuffer(ContextHandle context, std::span<const std::byte> data);
+    ~UploadBuffer() override;
+};
+
+/**
+ * @brief Buffer backed by a region of a memory mapped file
+ *
+ * If importing host memory is supported, the mapped pages are imported
+ * directly, letting copies stream from the file without duplicating its
+ * content in memory. Otherwise, the region is read into a newly allocated
+ * buffer.
+ *
+ * @note The content is read only. Writing to it either from the host or the
+ *       device, e.g. by using it as destination of a copy, is undefined.
+*/
+class HEPHAISTOS_API MappedFileBuffer : public Buffer<std::byte> {
+public:
+    /**
+     * @brief True, if the mapped file is accessed directly by the device
+    */
+    [[nodiscard]] bool isImported() const noexcept;
+
+    MappedFileBuffer(MappedFileBuffer&& other) noexcept;
+    MappedFileBuffer& operator=(MappedFileBuffer&& other) noexcept;
+
+    /**
+     * @brief Maps the given region of a file
+     *
+     * @param context Context onto which to create the buffer
+     * @param path Path to the file to map
+     * @param offset Offset into the file in bytes
+     * @param size Size of the region in bytes. whole_size maps the rest of
+     *             the file.
+    */
+    MappedFileBuffer(ContextHandle context,
+        const std::filesystem::path& path,
+        uint64_t offset = 0, uint64_t size = whole_size);
+    ~MappedFileBuffer() override;
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Returns the NUMA node the device is attached to
+ *
+ * Derived from the device's PCI address reported by VK_EXT_pci_bus_info.
+ * Currently only determined on Linux.
+ *
+ * @return Index of the NUMA node or -1 if unknown
+*/
+[[nodiscard]] HEPHAISTOS_API int32_t getDeviceNumaNode(const ContextHandle& context);
+
+/**
+ * @brief Kind of pages backing host memory
+*/
+enum class HugePages {
+    /**
+     * @brief Regular pages of the system's default size
+    */
+    NONE,
+    /**
+     * @brief Hints the system to back the memory with transparent huge pages
+     *
+     * Falls back to regular pages if none are available.
+    */
+    TRANSPARENT,
+    /**
+     * @brief Allocates huge pages reserved by the system's administrator
+     *
+     * Fails if not enough huge pages are reserved, e.g. via
+     * /proc/sys/vm/nr_hugepages on Linux or lacking the privilege to lock
+     * pages in memory on Windows.
+    */
+    EXPLICIT
+};
+
+/**
+ * @brief Policy for allocating the host memory of a PinnedBuffer
+*/
+struct HostAllocationPolicy {
+    /**
+     * @brief Places the memory on the NUMA node the device is attached to
+     *
+     * Copies between the buffer and the device then do not cross the
+     * interconnect between sockets. Ignored if the node is unknown.
+    */
+    bool localNumaNode = true;
+    /**
+     * @brief Kind of pages backing the memory
+     *
+     * Huge pages reduce the amount of pages the driver has to pin and
+     * translate, resulting in more stable peak bandwidth.
+    */
+    HugePages hugePages = HugePages::NONE;
+};
+
+/**
+ * @brief Buffer whose host memory is allocated following a placement policy
+ *
+ * Allocates the pages itself and imports them, which allows to place them
+ * on the NUMA node local to the device and to back them by huge pages. If
+ * importing host memory is not supported, falls back to allocating a
+ * regular Buffer ignoring the policy.
+*/
+class HEPHAISTOS_API PinnedBuffer : public Buffer<std::byte> {
+public:
+    /**
+     * @brief True, if the buffer uses memory allocated via its policy
+    */
+    [[nodiscard]] bool isImported() const noexcept;
+    /**
+     * @brief NUMA node the memory is bound to or -1 if not bound
+    */
+    [[nodiscard]] int32_t getNumaNode() const noexcept;
+    /**
+     * @brief Kind of pages the memory was allocated with
+    */
+    [[nodiscard]] HugePages getHugePages() const noexcept;
+
+    PinnedBuffer(PinnedBuffer&& other) noexcept;
+    PinnedBuffer& operator=(PinnedBuffer&& other) noexcept;
+
+    /**
+     * @brief Allocates a new pinned buffer
+     *
+     * Throws if explicit huge pages were requested but are not available.
+     *
+     * @param context Context onto which to create the buffer
+     * @param size Size of the buffer in bytes
+     * @param policy Policy to allocate the host memory with
+    */
+    PinnedBuffer(ContextHandle context, uint64_t size,
+        const HostAllocationPolicy& policy = {});
+    ~PinnedBuffer() override;
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
 template<class T = std::byte> class Tensor;
 
+/**
+ * @brief Enables sub-allocating small tensors from shared device buffers
+ *
+ * Tensors created afterwards, whose size does not exceed the given threshold,
+ * share a large buffer and memory allocation with others of the same kind
+ * instead of each owning a dedicated one. They get bound by offset. This
+ * avoids hitting the driver's limit on the number of allocations when
+ * creating many small tensors, e.g. for parameters. Sizes above a few
+ * megabytes are always allocated dedicated.
+ *
+ * @note Existing tensors are not affected. Shared buffers are kept until the
+ *       context gets destroyed.
+ *
+ * @param context Context on which to enable pooling
+ * @param threshold Maximum size in bytes of pooled tensors. Zero disables
+ *                  pooling, which is the default.
+*/
+HEPHAISTOS_API void setTensorPoolThreshold(const ContextHandle& context, uint64_t threshold);
+/**
+ * @brief Returns the maximum size in bytes of tensors sub-allocated from
+ *        shared buffers. Zero if pooling is disabled.
+ *
+ * @param context Context to query
+*/
+[[nodiscard]] HEPHAISTOS_API uint64_t getTensorPoolThreshold(const ContextHandle& context);
+/**
+ * @brief Enables mapping all tensors on devices with unified memory
+ *
+ * If enabled and isUnifiedMemorySupported() returns true, tensors created
+ * afterwards are mapped regardless of what was requested, as mapped memory
+ * still resides on the device. Their content can then be written and read
+ * directly via getMemory() instead of using staging copies. Tensor::update()
+ * and Tensor::retrieve() already skip staging for mapped tensors. Disabled by
+ * default.
+ *
+ * @note Existing tensors are not affected.
+ *
+ * @param context Context on which to enable automatic mapping
+ * @param enable True, if tensors should be mapped automatically
+*/
+HEPHAISTOS_API void setTensorAutoMapping(const ContextHandle& context, bool enable);
+/**
+ * @brief Returns true if tensors are mapped automatically on devices
+ *        with unified memory
+ *
+ * @param context Context to query
+*/
+[[nodiscard]] HEPHAISTOS_API bool getTensorAutoMapping(const ContextHandle& context);
+/**
+ * @brief Enables deferring the allocation of tensors until their first use
+ *
+ * If enabled, tensors created afterwards only reserve their size. Memory is
+ * allocated and initial data uploaded once the tensor is first used, e.g.
+ * bound to a program, recorded into a command or queried for its address.
+ * Pipelines creating tensors only needed by some configurations thus start
+ * faster and use less memory. Data passed on creation is kept on the host
+ * until then. Disabled by default.
+ *
+ * @note Existing tensors are not affected. Tensors created from a Buffer are
+ *       allocated right away, as they copy it.
+ *
+ * @param context Context on which to enable lazy allocation
+ * @param enable True, if tensors should be allocated lazily
+*/
+HEPHAISTOS_API void setTensorLazyAllocation(const ContextHandle& context, bool enable);
+/**
+ * @brief Returns true if tensors are allocated on their first use
+ *
+ * @param context Context to query
+*/
+[[nodiscard]] HEPHAISTOS_API bool getTensorLazyAllocation(const ContextHandle& context);
+
+/**
+ * @brief Statistics of a defragmentation run
+*/
+struct DefragmentationResult {
+    /**
+     * @brief Number of bytes copied to new locations
+    */
+    uint64_t bytesMoved;
+    /**
+     * @brief Number of bytes of device memory released
+    */
+    uint64_t bytesFreed;
+    /**
+     * @brief Number of tensors moved to new locations
+    */
+    uint32_t tensorsMoved;
+    /**
+     * @brief Number of device memory blocks released
+    */
+    uint32_t blocksFreed;
+};
+/**
+ * @brief Callback notified about a tensor moved by defragmentTensors()
+ *
+ * Receives the tensor's old and new device address as well as its size.
+*/
+using RelocationCallback = std::function<void(uint64_t oldAddress, uint64_t newAddress, uint64_t size)>;
+/**
+ * @brief Compacts the memory occupied by tensors
+ *
+ * Long running contexts creating and destroying tensors of varying sizes
+ * fragment their memory, eventually forcing new device memory blocks to be
+ * allocated. This moves tensors into fewer blocks and releases the empty
+ * ones. Copies are recorded and executed on the device. Moved tensors keep
+ * their content, but their address() and mapped memory change.
+ *
+ * @note Sub-allocated tensors as well as buffers and images are never moved.
+ * @note No work using any tensor of the context may be pending and no other
+ *       thread may use the context while defragmenting. Recorded
+ *       subroutines, sequence templates and task graphs, parameter sets and
+ *       dispatch lists referencing moved tensors must be recreated.
+ *
+ * @param context Context whose tensors to compact
+ * @param callback Optional callback notified about each moved tensor, e.g.
+ *                 to patch device addresses stored in other tensors
+ * @return Statistics of the run
+*/
+HEPHAISTOS_API DefragmentationResult defragmentTensors(
+    const ContextHandle& context, const RelocationCallback& callback = {});
+
 /**
  * @brief Allocates memory on the device
 */
@@ -122,7 +483,21 @@ public:
     /**
      * @brief Returns device memory address
     */
-    [[nodiscard]] uint64_t address() const noexcept;
+    [[nodiscard]] uint64_t address() const;
+    /**
+     * @brief True, if the tensor's memory was allocated
+     *
+     * Only false for lazily allocated tensors not used yet.
+     *
+     * @note See setTensorLazyAllocation()
+    */
+    [[nodiscard]] bool isAllocated() const noexcept;
+    /**
+     * @brief True, if the tensor is sub-allocated from a shared buffer
+     *
+     * @note See setTensorPoolThreshold()
+    */
+    [[nodiscard]] bool isPooled() const;
     /**
      * @brief Returns the tensor memory mapped to host memory space
      * 
@@ -137,7 +512,7 @@ public:
      * @note Mapping memory may not supported by the device, in which case this
      *       will be false even if requested.
     */
-    [[nodiscard]] bool isMapped() const noexcept;
+    [[nodiscard]] bool isMapped() const;
     /**
      * @brief Size of the tensor in bytes
     */
@@ -151,18 +526,37 @@ public:
      * @brief If true, calling flush() and invalidate() are necessary to make
      * changes in mapped memory between device and host available.
     */
-    [[nodiscard]] bool isNonCoherent() const noexcept;
+    [[nodiscard]] bool isNonCoherent() const;
 
     /**
      * @brief Updates the tensor at the given offset in bytes with data from src
      * 
      * Copies data from src to the tensor at the given offset in bytes and
-     * calls flush() if necessary.
+     * calls flush() if necessary. If the tensor's memory is not accessible
+     * by the host, the data is copied via a staging buffer shared by the
+     * context, blocking until the transfer finished.
      * 
      * @param src Source data to copy from
      * @param offset Offset into tensor where copying starts
     */
     void update(std::span<const std::byte> src, uint64_t offset = 0);
+    /**
+     * @brief Updates the tensor at the given offset in bytes with data from
+     *        src without waiting for the transfer to finish
+     *
+     * Copies data from src into a staging buffer shared by the context and
+     * submits the copy into the tensor to the main queue, thus src may be
+     * reused directly after returning. The copy is ordered after previously
+     * submitted work, e.g. dispatches still reading the tensor, and allows
+     * uploading the next batch while the previous one is being processed.
+     * Large transfers are split into multiple submissions, in which case the
+     * returned one finishes last.
+     *
+     * @param src Source data to copy from
+     * @param offset Offset into tensor where copying starts
+     * @return Submission finishing once the tensor was updated
+    */
+    [[nodiscard]] Submission updateAsync(std::span<const std::byte> src, uint64_t offset = 0);
     /**
      * @brief Makes writes in mapped memory from the host available to the device
      * 
@@ -179,11 +573,27 @@ public:
      * 
      * Copies data from the device at the given offset in bytes to the memory
      * range provided by dst and calls invalidate() beforehand if needed.
+     * If the tensor's memory is not accessible by the host, the data is
+     * copied via a staging buffer shared by the context.
      * 
      * @param dst Destination to which the data is copied
      * @param offset Offset into tensor where the copy starts
     */
     void retrieve(std::span<std::byte> dst, uint64_t offset = 0);
+    /**
+     * @brief Retrieves data from the tensor at the given offset in bytes into
+     *        dst without waiting for the transfer to finish
+     *
+     * Copies dst.size_bytes() bytes from the tensor directly into the host
+     * buffer, thus not needing any staging. The copy is ordered after
+     * previously submitted work. The content of dst is available once the
+     * returned submission finished.
+     *
+     * @param dst Destination buffer to which the data is copied
+     * @param offset Offset into tensor where the copy starts
+     * @return Submission finishing once the data was copied
+    */
+    [[nodiscard]] Submission retrieveAsync(const Buffer<std::byte>& dst, uint64_t offset = 0);
     /**
      * @brief Makes writes in mapped memory from the device available to the host
      * 
@@ -213,6 +623,22 @@ public:
      *       isMapped().
     */
     Tensor(ContextHandle context, uint64_t size, bool mapped = false);
+    /**
+     * @brief Allocates a new Tensor using the given allocation hints
+     *
+     * Tensors with hints other than the default ones are never sub-allocated
+     * from shared buffers.
+     *
+     * @param context Context onto which to create the Tensor
+     * @param size Number of elements
+     * @param hints Hints for allocating the memory
+     * @param mapped If true, tries to map the allocated tensor to host memory space
+     *
+     * @note Mapping may not supported by the device. Check for success via
+     *       isMapped().
+    */
+    Tensor(ContextHandle context, uint64_t size,
+        const AllocationHints& hints, bool mapped = false);
     /**
      * @brief Allocates a new Tensor
      * 
@@ -237,11 +663,24 @@ public:
     ~Tensor() override;
 
 public: //internal
-    [[nodiscard]] const vulkan::Buffer& getBuffer() const noexcept;
+    //allocates lazy tensors
+    [[nodiscard]] const vulkan::Buffer& getBuffer() const;
+    //wraps a range of a buffer owned by someone else
+    Tensor(ContextHandle context, BufferHandle buffer, uint64_t size);
+
+protected: //internal
+    //swaps in a new buffer bound by offset; descriptors are updated in place,
+    //thus programs referencing the tensor pick it up on their next dispatch
+    BufferHandle exchangeBuffer(BufferHandle buffer);
+    //changes the size and the range bound as descriptor
+    void setSize(uint64_t size) noexcept;
 
 private:
+    //allocates the buffer of lazy tensors on first use
+    void allocate() const;
+
     uint64_t _size;
-    BufferHandle buffer;
+    mutable BufferHandle buffer;
 
     struct Parameter;
     std::unique_ptr<Parameter> parameter;
@@ -268,6 +707,9 @@ public:
     void update(std::span<const T> src, uint64_t offset = 0) {
         Tensor<std::byte>::update(std::as_bytes(src), sizeof(T) * offset);
     }
+    [[nodiscard]] Submission updateAsync(std::span<const T> src, uint64_t offset = 0) {
+        return Tensor<std::byte>::updateAsync(std::as_bytes(src), sizeof(T) * offset);
+    }
     void flush(uint64_t offset = 0, uint64_t size = whole_size) {
         Tensor<std::byte>::flush(sizeof(T) * offset, size);
     }
@@ -275,6 +717,9 @@ public:
     void retrieve(std::span<T> dst, uint64_t offset = 0) {
         Tensor<std::byte>::retrieve(std::as_writable_bytes(dst), sizeof(T) * offset);
     }
+    [[nodiscard]] Submission retrieveAsync(const Buffer<std::byte>& dst, uint64_t offset = 0) {
+        return Tensor<std::byte>::retrieveAsync(dst, sizeof(T) * offset);
+    }
     void invalidate(uint64_t offset = 0, uint64_t size = whole_size) {
         Tensor<std::byte>::invalidate(sizeof(T) * offset, size);
     }
@@ -293,6 +738,9 @@ public:
     Tensor(ContextHandle context, size_t count, bool mapped = false)
         : Tensor<std::byte>(std::move(context), count * sizeof(T), mapped)
     {}
+    Tensor(ContextHandle context, size_t count, const AllocationHints& hints, bool mapped = false)
+        : Tensor<std::byte>(std::move(context), count * sizeof(T), hints, mapped)
+    {}
     explicit Tensor(const Buffer<std::byte>& buffer, bool mapped = false)
         : Tensor<std::byte>(buffer, mapped)
     {}
@@ -308,6 +756,520 @@ public:
     ~Tensor() override = default;
 };
 
+/**
+ * @brief Data to copy into a Tensor as part of a batched update
+*/
+struct TensorUpdate {
+    /**
+     * @brief Tensor to update
+    */
+    std::reference_wrapper<Tensor<std::byte>> tensor;
+    /**
+     * @brief Source data to copy from
+    */
+    std::span<const std::byte> data;
+    /**
+     * @brief Offset into the tensor in bytes where copying starts
+    */
+    uint64_t offset = 0;
+};
+/**
+ * @brief Updates multiple tensors at once
+ *
+ * Behaves like calling Tensor::update() on each entry, but packs all staged
+ * data into a shared staging range and records every copy in a single
+ * command buffer with one barrier in front and one after, thus blocking only
+ * once until all transfers finished. Batches exceeding the context's staging
+ * capacity are split into multiple submissions.
+ *
+ * @note All tensors must belong to the same context
+ *
+ * @param updates List of updates to perform
+*/
+HEPHAISTOS_API void updateTensors(std::span<const TensorUpdate> updates);
+
+/**
+ * @brief Sub-range of a Tensor that can be bound to programs
+ *
+ * Binds only the given range of the tensor without copying it, e.g. to
+ * partition a batch across multiple dispatches. Accesses of programs are
+ * tracked on the range only, thus dispatches using disjoint views of the same
+ * tensor do not have to wait on each other inside sequences.
+ *
+ * @note The view does not keep the tensor alive. Views of tensors whose
+ *       memory changes, e.g. by growing or defragmentation, must be recreated.
+*/
+class HEPHAISTOS_API TensorView : public Argument {
+public:
+    /**
+     * @brief Returns the device memory address of the start of the range
+    */
+    [[nodiscard]] uint64_t address() const noexcept;
+    /**
+     * @brief Offset of the range into the tensor in bytes
+    */
+    [[nodiscard]] uint64_t offset() const noexcept;
+    /**
+     * @brief Size of the range in bytes
+    */
+    [[nodiscard]] uint64_t size_bytes() const noexcept;
+    /**
+     * @brief The tensor the range belongs to
+    */
+    [[nodiscard]] const Tensor<std::byte>& getTensor() const noexcept;
+
+    void bindParameter(VkWriteDescriptorSet& binding) const final override;
+
+    TensorView(const TensorView& other);
+    TensorView& operator=(const TensorView& other);
+
+    TensorView(TensorView&& other) noexcept;
+    TensorView& operator=(TensorView&& other) noexcept;
+
+    /**
+     * @brief Creates a new view of the given tensor
+     *
+     * @param tensor Tensor to create a view of
+     * @param offset Offset into the tensor in bytes. Must be a multiple of
+     *               the device's minStorageBufferOffsetAlignment.
+     * @param size Size of the range in bytes. whole_size spans the rest of
+     *             the tensor.
+    */
+    TensorView(const Tensor<std::byte>& tensor,
+        uint64_t offset = 0, uint64_t size = whole_size);
+    ~TensorView() override;
+
+private:
+    struct Parameter;
+    std::reference_wrapper<const Tensor<std::byte>> tensor;
+    uint64_t _offset;
+    //on the heap, so bound programs stay valid after moving the view
+    std::unique_ptr<Parameter> parameter;
+};
+
+/**
+ * @brief Allocator for scratch tensors sharing memory
+ *
+ * Intermediate tensors of multi stage pipelines often live only for a few
+ * steps of a sequence. Declaring them together with the first and last step
+ * using them allows tensors whose lifetimes do not overlap to occupy the
+ * same memory, reducing the peak memory usage. Once all tensors are
+ * declared, allocate() places them into a single shared buffer.
+ *
+ * Consecutive steps of a sequence are ordered by semaphores, which also
+ * order their memory accesses. Thus no extra barriers are needed as long as
+ * each tensor is only used within its declared steps.
+ *
+ * @note The content of scratch tensors is undefined at the start of their
+ *       lifetime. Work using them must not run concurrently with other work
+ *       using the same allocator.
+*/
+class HEPHAISTOS_API ScratchAllocator : public Resource {
+public:
+    /**
+     * @brief Declares a new scratch tensor
+     *
+     * @param size Size of the tensor in bytes
+     * @param firstStep Index of the first sequence step using the tensor
+     * @param lastStep Index of the last sequence step using the tensor
+     * @return Id of the tensor used to retrieve it via get()
+    */
+    size_t declare(uint64_t size, uint32_t firstStep, uint32_t lastStep);
+    /**
+     * @brief Allocates memory for all declared tensors
+     *
+     * @note No tensors can be declared afterwards.
+    */
+    void allocate();
+    /**
+     * @brief True, if allocate() was called
+    */
+    [[nodiscard]] bool isAllocated() const noexcept;
+
+    /**
+     * @brief Returns the scratch tensor with the given id
+     *
+     * @note Only available after allocate() was called
+    */
+    [[nodiscard]] Tensor<std::byte>& get(size_t id) const;
+
+    /**
+     * @brief Number of declared tensors
+    */
+    [[nodiscard]] size_t size() const noexcept;
+    /**
+     * @brief Size of the shared memory in bytes
+     *
+     * @note Zero until allocate() was called
+    */
+    [[nodiscard]] uint64_t size_bytes() const noexcept;
+    /**
+     * @brief Sum of sizes of all declared tensors in bytes, i.e. memory
+     *        required without aliasing
+    */
+    [[nodiscard]] uint64_t declared_bytes() const noexcept;
+
+    ScratchAllocator(const ScratchAllocator&) = delete;
+    ScratchAllocator& operator=(const ScratchAllocator&) = delete;
+
+    ScratchAllocator(ScratchAllocator&& other) noexcept;
+    ScratchAllocator& operator=(ScratchAllocator&& other) noexcept;
+
+    /**
+     * @brief Creates a new empty ScratchAllocator
+     *
+     * @param context Context on which to allocate the tensors
+    */
+    explicit ScratchAllocator(ContextHandle context);
+    ~ScratchAllocator() override;
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Ring of small uniform blocks for per dispatch parameters
+ *
+ * Stores parameter blocks in a persistently mapped uniform buffer. Each call
+ * to push() writes the next block, which gets bound by subsequent calls to
+ * bindParameter(). Dispatches keep the block that was current when the
+ * ring was bound, thus binding the ring after each push gives every
+ * dispatch its own parameters without a tensor and an upload per change.
+ * Blocks are not limited by the size of push constants.
+ *
+ * @note Blocks are reused after capacity pushes. The capacity must exceed the
+ *       amount of blocks used by work still pending on the device.
+*/
+class HEPHAISTOS_API UniformRing : public Argument, public Resource {
+public:
+    /**
+     * @brief Writes data into the next block and makes it the current one
+     *
+     * @param data Data to write. Must not exceed the block size.
+     * @return Index of the written block
+    */
+    uint32_t push(std::span<const std::byte> data);
+    /**
+     * @brief Writes data into the next block and makes it the current one
+     *
+     * @param data Data to write. Must not exceed the block size.
+     * @return Index of the written block
+    */
+    template<class T>
+    uint32_t push(const T& data) requires (!std::is_convertible_v<const T&, std::span<const std::byte>>) {
+        return push(std::as_bytes(std::span<const T>(&data, 1)));
+    }
+
+    /**
+     * @brief Index of the current block
+    */
+    [[nodiscard]] uint32_t current() const noexcept;
+    /**
+     * @brief Amount of blocks in the ring
+    */
+    [[nodiscard]] uint32_t capacity() const noexcept;
+    /**
+     * @brief Size of a single block in bytes
+    */
+    [[nodiscard]] uint64_t blockSize() const noexcept;
+    /**
+     * @brief Size of the whole ring in bytes including padding between blocks
+    */
+    [[nodiscard]] uint64_t size_bytes() const noexcept;
+
+    void bindParameter(VkWriteDescriptorSet& binding) const final override;
+
+    UniformRing(const UniformRing&) = delete;
+    UniformRing& operator=(const UniformRing&) = delete;
+
+    UniformRing(UniformRing&& other) noexcept;
+    UniformRing& operator=(UniformRing&& other) noexcept;
+
+    /**
+     * @brief Creates a new UniformRing
+     *
+     * @param context Context on which to allocate the ring
+     * @param blockSize Size of a single block in bytes. Must not exceed the
+     *                  device's maxUniformBufferRange.
+     * @param capacity Amount of blocks in the ring
+    */
+    UniformRing(ContextHandle context, uint64_t blockSize, uint32_t capacity = 64);
+    ~UniformRing() override;
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Builder for uniform blocks of tensor addresses and scalars
+ *
+ * Programs accessing many tensors via buffer_reference get their addresses
+ * from a single uniform block instead of hand packed push constants. Values
+ * are appended in the order of the block's members using the scalar block
+ * layout, i.e. each is aligned to the size of its components, which matches
+ * blocks declared with layout(scalar). commit() uploads the block into the
+ * next slot of an internal UniformRing, which subsequent calls to
+ * bindParameter() bind. Thus the block can be cleared and rebuilt for the
+ * next dispatch while previous ones still use theirs.
+ *
+ * The referenced tensors are collected, e.g. to keep them alive or declare
+ * them to other work, but are not kept alive by the block itself. They must
+ * outlive all work using the block.
+ *
+ * @note Blocks are reused after capacity commits. The capacity must exceed
+ *       the amount of blocks used by work still pending on the device.
+*/
+class HEPHAISTOS_API ArgumentBlock : public Argument {
+public:
+    /**
+     * @brief Appends the device address of the given tensor
+    */
+    ArgumentBlock& add(const Tensor<std::byte>& tensor);
+    /**
+     * @brief Appends the device address of the start of the given view
+    */
+    ArgumentBlock& add(const TensorView& view);
+    /**
+     * @brief Appends the given scalar aligned to its size
+    */
+    template<class T>
+    ArgumentBlock& add(T value) requires std::is_arithmetic_v<T> {
+        return addBytes(std::as_bytes(std::span<const T>(&value, 1)), sizeof(T));
+    }
+    /**
+     * @brief Appends raw data, e.g. a vector or struct
+     *
+     * @param data Data to append
+     * @param alignment Alignment of the data in bytes. Must be a power of two.
+    */
+    ArgumentBlock& addBytes(std::span<const std::byte> data, uint64_t alignment = 4);
+
+    /**
+     * @brief Returns the data appended since the last clear
+    */
+    [[nodiscard]] std::span<const std::byte> data() const noexcept;
+    /**
+     * @brief Returns the size of the appended data in bytes
+    */
+    [[nodiscard]] uint64_t size_bytes() const noexcept;
+    /**
+     * @brief Returns the tensors whose address got appended
+    */
+    [[nodiscard]] std::span<const std::reference_wrapper<const Tensor<std::byte>>>
+        getTensors() const noexcept;
+    /**
+     * @brief Returns the ring the blocks are uploaded to
+    */
+    [[nodiscard]] const UniformRing& getRing() const noexcept;
+
+    /**
+     * @brief Uploads the appended data into the next block of the ring
+     *
+     * @return Index of the written block
+    */
+    uint32_t commit();
+    /**
+     * @brief Removes all appended data and tensors
+     *
+     * Does not affect committed blocks.
+    */
+    void clear() noexcept;
+
+    void bindParameter(VkWriteDescriptorSet& binding) const final override;
+
+    ArgumentBlock(const ArgumentBlock&) = delete;
+    ArgumentBlock& operator=(const ArgumentBlock&) = delete;
+
+    ArgumentBlock(ArgumentBlock&& other) noexcept;
+    ArgumentBlock& operator=(ArgumentBlock&& other) noexcept;
+
+    /**
+     * @brief Creates a new ArgumentBlock
+     *
+     * @param context Context on which to allocate the blocks
+     * @param blockSize Maximum size of a block in bytes. Must not exceed the
+     *                  device's maxUniformBufferRange.
+     * @param capacity Amount of blocks in the ring
+    */
+    ArgumentBlock(ContextHandle context, uint64_t blockSize, uint32_t capacity = 64);
+    ~ArgumentBlock() override;
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Checks wether the context supports sparse tensors
+ *
+ * Requires the sparseBinding feature and a main queue supporting sparse
+ * binding, which are enabled if available.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isSparseTensorSupported(const ContextHandle& context);
+/**
+ * @brief Checks wether sparse tensors can be used while partially committed
+ *
+ * Requires the sparseResidencyBuffer feature, which is enabled if available.
+ * Otherwise, sparse tensors must be committed completely before any command
+ * uses them.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isSparseResidencySupported(const ContextHandle& context);
+
+/**
+ * @brief Tensor reserving a virtual address range backed by memory on demand
+ *
+ * Unlike ordinary tensors, sparse tensors are not limited by the maximum size
+ * of a single allocation. Only the address range is reserved on creation,
+ * while memory gets committed and decommitted in pages of getPageSize()
+ * bytes. This allows e.g. queues to grow without allocating their worst case
+ * size upfront.
+ *
+ * If residency is supported, uncommitted ranges can be accessed: Writes are
+ * discarded while reads return undefined values, or zero if the device
+ * guarantees strict residency.
+ *
+ * @note Storage buffer bindings are limited to the device's
+ *       maxStorageBufferRange. Larger tensors must be accessed via address().
+ * @note Commands using a range must have finished before it gets
+ *       decommitted.
+*/
+class HEPHAISTOS_API SparseTensor : public Tensor<std::byte> {
+public:
+    /**
+     * @brief Size in bytes of the pages memory is committed in
+    */
+    [[nodiscard]] uint64_t getPageSize() const noexcept;
+    /**
+     * @brief Number of bytes currently backed by memory
+    */
+    [[nodiscard]] uint64_t size_committed() const noexcept;
+    /**
+     * @brief True, if the given range is completely backed by memory
+     *
+     * @param offset Offset in bytes of the range
+     * @param size Size in bytes of the range
+    */
+    [[nodiscard]] bool isCommitted(uint64_t offset = 0, uint64_t size = whole_size) const;
+
+    /**
+     * @brief Backs the given range with memory
+     *
+     * The range is extended to whole pages. Already committed pages keep
+     * their content, while the content of newly committed ones is undefined.
+     * Blocks until the memory is bound.
+     *
+     * @param offset Offset in bytes of the range
+     * @param size Size in bytes of the range
+    */
+    void commit(uint64_t offset = 0, uint64_t size = whole_size);
+    /**
+     * @brief Releases the memory backing the given range
+     *
+     * Only pages completely contained in the range are released. Blocks until
+     * the memory is unbound.
+     *
+     * @param offset Offset in bytes of the range
+     * @param size Size in bytes of the range
+    */
+    void decommit(uint64_t offset = 0, uint64_t size = whole_size);
+
+    SparseTensor(const SparseTensor&) = delete;
+    SparseTensor& operator=(const SparseTensor&) = delete;
+
+    SparseTensor(SparseTensor&& other) noexcept;
+    SparseTensor& operator=(SparseTensor&& other) noexcept;
+
+    /**
+     * @brief Reserves a new sparse tensor without committing any memory
+     *
+     * Throws if sparse tensors are not supported.
+     *
+     * @param context Context onto which to create the tensor
+     * @param size Size of the tensor in bytes
+    */
+    SparseTensor(ContextHandle context, uint64_t size);
+    ~SparseTensor() override;
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Tensor growing its memory on demand
+ *
+ * Distinguishes between its size and the capacity of the allocated memory.
+ * Growing beyond the capacity allocates new memory of at least twice the
+ * capacity and copies the content on the device, thus the cost of growing
+ * is amortized. Programs and parameters bound to the tensor pick up the new
+ * memory on their next dispatch without being rebound.
+ *
+ * Since the address() changes when growing, the tensor maintains an address
+ * slot: a small tensor holding the current address, which is updated as part
+ * of growing. Shaders accessing the tensor via its address should read it
+ * from there.
+ *
+ * @note Growing waits for work on the main queue to finish. Work on other
+ *       queues using the tensor must have finished before. Recorded
+ *       subroutines, sequence templates and task graphs, parameter sets and
+ *       dispatch lists referencing the tensor must be recreated.
+ * @note Growable tensors are never moved by defragmentTensors().
+*/
+class HEPHAISTOS_API GrowableTensor : public Tensor<std::byte> {
+public:
+    /**
+     * @brief Size of the allocated memory in bytes
+    */
+    [[nodiscard]] uint64_t capacity() const noexcept;
+    /**
+     * @brief Tensor holding the current address() as a single uint64_t
+    */
+    [[nodiscard]] const Tensor<std::byte>& getAddressSlot() const noexcept;
+
+    /**
+     * @brief Ensures the capacity is at least the given amount of bytes
+     *
+     * Only grows and keeps the size. Grows at least geometrically, so
+     * repeated calls with slowly increasing capacities stay cheap.
+     *
+     * @param capacity Minimum capacity in bytes
+    */
+    void reserve(uint64_t capacity);
+    /**
+     * @brief Changes the size of the tensor
+     *
+     * Grows the memory via reserve() if needed. The content within the old
+     * size is kept, while the content beyond it is undefined. Shrinking only
+     * changes the size, but keeps the capacity.
+     *
+     * @param size New size in bytes
+    */
+    void resize(uint64_t size);
+
+    GrowableTensor(const GrowableTensor&) = delete;
+    GrowableTensor& operator=(const GrowableTensor&) = delete;
+
+    GrowableTensor(GrowableTensor&& other) noexcept;
+    GrowableTensor& operator=(GrowableTensor&& other) noexcept;
+
+    /**
+     * @brief Allocates a new growable tensor
+     *
+     * @param context Context onto which to create the tensor
+     * @param size Initial size in bytes
+     * @param capacity Initial capacity in bytes. If smaller than size, the
+     *                 capacity equals the size.
+    */
+    GrowableTensor(ContextHandle context, uint64_t size, uint64_t capacity = 0);
+    ~GrowableTensor() override;
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
 /**
  * @brief Description of memory region for copying
 */
@@ -332,6 +1294,9 @@ struct CopyRegion {
 
 /**
  * @brief Command for copying data from a Tensor to a Buffer
+ *
+ * Copies any number of regions using a single copy and barrier pair.
+ * Adjacent regions are merged.
 */
 class HEPHAISTOS_API RetrieveTensorCommand : public Command {
 public:
@@ -345,17 +1310,11 @@ public:
     std::reference_wrapper<const Buffer<std::byte>> destination;
 
     /**
-     * @brief Offset into the source Tensor in bytes
-    */
-    uint64_t sourceOffset;
-    /**
-     * @brief Offset into the destination Buffer in bytes
-    */
-    uint64_t destinationOffset;
-    /**
-     * @brief Number of bytes to copy
+     * @brief Regions to copy
+     *
+     * @note CopyRegion::unsafe of the individual regions is ignored.
     */
-    uint64_t size;
+    std::vector<CopyRegion> regions;
     /**
      * @brief If true, omits barriers ensuring read after write ordering.
     */
@@ -380,6 +1339,19 @@ public:
         const Tensor<std::byte>& src,
         const Buffer<std::byte>& dst,
         const CopyRegion& region = {});
+    /**
+     * @brief Creates a new RetrieveTensorCommand copying multiple regions
+     *
+     * @param src Source Tensor to copy from
+     * @param dst Destination Buffer to copy to
+     * @param regions Regions to copy. Must not overlap within dst.
+     * @param unsafe If true, omits barriers ensuring read after write ordering.
+    */
+    RetrieveTensorCommand(
+        const Tensor<std::byte>& src,
+        const Buffer<std::byte>& dst,
+        std::span<const CopyRegion> regions,
+        bool unsafe = false);
     ~RetrieveTensorCommand() override;
 };
 /**
@@ -396,9 +1368,28 @@ public:
 {
     return RetrieveTensorCommand(src, dst, region);
 }
+/**
+ * @brief Creates a new RetrieveTensorCommand copying multiple regions
+ *
+ * @param src Source Tensor to copy from
+ * @param dst Destination Buffer to copy to
+ * @param regions Regions to copy. Must not overlap within dst.
+ * @param unsafe If true, omits barriers ensuring read after write ordering.
+*/
+[[nodiscard]] inline RetrieveTensorCommand retrieveTensor(
+    const Tensor<std::byte>& src,
+    const Buffer<std::byte>& dst,
+    std::span<const CopyRegion> regions,
+    bool unsafe = false)
+{
+    return RetrieveTensorCommand(src, dst, regions, unsafe);
+}
 
 /**
  * @brief Command for copying data from Buffer to Tensor
+ *
+ * Copies any number of regions using a single copy and barrier pair.
+ * Adjacent regions are merged.
 */
 class HEPHAISTOS_API UpdateTensorCommand : public Command {
 public:
@@ -412,17 +1403,11 @@ public:
     std::reference_wrapper<const Tensor<std::byte>> destination;
 
     /**
-     * @brief Offset into the source Buffer in bytes
-    */
-    uint64_t sourceOffset;
-    /**
-     * @brief Offset into the destination Tensor in bytes
-    */
-    uint64_t destinationOffset;
-    /**
-     * @brief Number of bytes to copy
+     * @brief Regions to copy
+     *
+     * @note CopyRegion::unsafe of the individual regions is ignored.
     */
-    uint64_t size;
+    std::vector<CopyRegion> regions;
     /**
      * @brief If true, omits barriers ensuring read after write ordering.
     */
@@ -447,6 +1432,19 @@ public:
         const Buffer<std::byte>& src,
         const Tensor<std::byte>& dst,
         const CopyRegion& region = {});
+    /**
+     * @brief Creates a new UpdateTensorCommand copying multiple regions
+     *
+     * @param src Source Buffer to copy from
+     * @param dst Destination Tensor to copy to
+     * @param regions Regions to copy. Must not overlap within dst.
+     * @param unsafe If true, omits barriers ensuring read after write ordering.
+    */
+    UpdateTensorCommand(
+        const Buffer<std::byte>& src,
+        const Tensor<std::byte>& dst,
+        std::span<const CopyRegion> regions,
+        bool unsafe = false);
     ~UpdateTensorCommand() override;
 };
 /**
@@ -463,6 +1461,205 @@ public:
 {
     return UpdateTensorCommand(src, dst, region);
 }
+/**
+ * @brief Creates a UpdateTensorCommand copying multiple regions
+ *
+ * @param src Source Buffer to copy from
+ * @param dst Destination Tensor to copy to
+ * @param regions Regions to copy. Must not overlap within dst.
+ * @param unsafe If true, omits barriers ensuring read after write ordering.
+*/
+[[nodiscard]] inline UpdateTensorCommand updateTensor(
+    const Buffer<std::byte>& src,
+    const Tensor<std::byte>& dst,
+    std::span<const CopyRegion> regions,
+    bool unsafe = false)
+{
+    return UpdateTensorCommand(src, dst, regions, unsafe);
+}
+
+/**
+ * @brief Splits a copy from a Tensor to a Buffer into chunks
+ *
+ * Recording each chunk in its own step, e.g. via SequenceBuilder::Then(),
+ * lets every chunk signal its own timeline value, so the host can start
+ * processing finished chunks while later ones are still in flight.
+ *
+ * @param src Source Tensor to copy from
+ * @param dst Destination Buffer to copy to
+ * @param chunkSize Size of each chunk in bytes. The last one may be smaller.
+ * @param region Region to copy
+ * @return Commands copying one chunk each in order
+*/
+[[nodiscard]] HEPHAISTOS_API std::vector<RetrieveTensorCommand> retrieveTensorChunked(
+    const Tensor<std::byte>& src,
+    const Buffer<std::byte>& dst,
+    uint64_t chunkSize,
+    const CopyRegion& region = {});
+/**
+ * @brief Splits a copy from a Buffer to a Tensor into chunks
+ *
+ * Recording each chunk in its own step lets work waiting on the timeline
+ * value of a chunk start before the whole transfer finished.
+ *
+ * @param src Source Buffer to copy from
+ * @param dst Destination Tensor to copy to
+ * @param chunkSize Size of each chunk in bytes. The last one may be smaller.
+ * @param region Region to copy
+ * @return Commands copying one chunk each in order
+*/
+[[nodiscard]] HEPHAISTOS_API std::vector<UpdateTensorCommand> updateTensorChunked(
+    const Buffer<std::byte>& src,
+    const Tensor<std::byte>& dst,
+    uint64_t chunkSize,
+    const CopyRegion& region = {});
+
+/**
+ * @brief Callback consuming a chunk of retrieved data
+ *
+ * Receives the offset of the chunk relative to the start of the copied
+ * region and its data inside the destination buffer.
+*/
+using ChunkCallback = std::function<void(uint64_t offset, std::span<const std::byte> chunk)>;
+/**
+ * @brief Retrieves a Tensor in chunks handing each to the callback once it
+ *        arrived
+ *
+ * Submits all chunks at once and calls the callback on the calling thread in
+ * order as soon as each chunk finished, while later chunks are still being
+ * copied. Blocks until all chunks were consumed.
+ *
+ * @param src Source Tensor to copy from
+ * @param dst Destination Buffer to copy to
+ * @param chunkSize Size of each chunk in bytes. The last one may be smaller.
+ * @param callback Callback called for each chunk
+ * @param region Region to copy
+*/
+HEPHAISTOS_API void retrieveTensorStreamed(
+    const Tensor<std::byte>& src,
+    const Buffer<std::byte>& dst,
+    uint64_t chunkSize,
+    const ChunkCallback& callback,
+    const CopyRegion& region = {});
+
+/**
+ * @brief Description of memory region for copying between tensors
+*/
+struct TensorCopyRegion {
+    /**
+     * @brief Offset into the source Tensor
+    */
+    uint64_t sourceOffset = 0;
+    /**
+     * @brief Offset into the destination Tensor
+    */
+    uint64_t destinationOffset = 0;
+    /**
+     * @brief Number of bytes to copy
+    */
+    uint64_t size = whole_size;
+    /**
+     * @brief If true, omits barriers ensuring read after write ordering.
+    */
+    bool unsafe = false;
+};
+
+/**
+ * @brief Command for copying data between Tensors
+ *
+ * Copies entirely on the device without staging through the host. Copies any
+ * number of regions using a single copy and barrier pair. Adjacent regions
+ * are merged.
+ *
+ * @note Source and destination may be the same Tensor as long as the copied
+ *       regions do not overlap.
+*/
+class HEPHAISTOS_API CopyTensorCommand : public Command {
+public:
+    /**
+     * @brief Source Tensor to copy from
+    */
+    std::reference_wrapper<const Tensor<std::byte>> source;
+    /**
+     * @brief Destination Tensor to copy to
+    */
+    std::reference_wrapper<const Tensor<std::byte>> destination;
+
+    /**
+     * @brief Regions to copy
+     *
+     * @note TensorCopyRegion::unsafe of the individual regions is ignored.
+    */
+    std::vector<TensorCopyRegion> regions;
+    /**
+     * @brief If true, omits barriers ensuring read after write ordering.
+    */
+    bool unsafe;
+
+    virtual void record(vulkan::Command& cmd) const override;
+
+    CopyTensorCommand(const CopyTensorCommand& other);
+    CopyTensorCommand& operator=(const CopyTensorCommand& other);
+
+    CopyTensorCommand(CopyTensorCommand&& other) noexcept;
+    CopyTensorCommand& operator=(CopyTensorCommand&& other) noexcept;
+
+    /**
+     * @brief Creates a new CopyTensorCommand
+     *
+     * @param src Source Tensor to copy from
+     * @param dst Destination Tensor to copy to
+     * @param region Region to copy
+    */
+    CopyTensorCommand(
+        const Tensor<std::byte>& src,
+        const Tensor<std::byte>& dst,
+        const TensorCopyRegion& region = {});
+    /**
+     * @brief Creates a new CopyTensorCommand copying multiple regions
+     *
+     * @param src Source Tensor to copy from
+     * @param dst Destination Tensor to copy to
+     * @param regions Regions to copy. Must not overlap within dst.
+     * @param unsafe If true, omits barriers ensuring read after write ordering.
+    */
+    CopyTensorCommand(
+        const Tensor<std::byte>& src,
+        const Tensor<std::byte>& dst,
+        std::span<const TensorCopyRegion> regions,
+        bool unsafe = false);
+    ~CopyTensorCommand() override;
+};
+/**
+ * @brief Creates a new CopyTensorCommand
+ *
+ * @param src Source Tensor to copy from
+ * @param dst Destination Tensor to copy to
+ * @param region Region to copy
+*/
+[[nodiscard]] inline CopyTensorCommand copyTensor(
+    const Tensor<std::byte>& src,
+    const Tensor<std::byte>& dst,
+    const TensorCopyRegion& region = {})
+{
+    return CopyTensorCommand(src, dst, region);
+}
+/**
+ * @brief Creates a new CopyTensorCommand copying multiple regions
+ *
+ * @param src Source Tensor to copy from
+ * @param dst Destination Tensor to copy to
+ * @param regions Regions to copy. Must not overlap within dst.
+ * @param unsafe If true, omits barriers ensuring read after write ordering.
+*/
+[[nodiscard]] inline CopyTensorCommand copyTensor(
+    const Tensor<std::byte>& src,
+    const Tensor<std::byte>& dst,
+    std::span<const TensorCopyRegion> regions,
+    bool unsafe = false)
+{
+    return CopyTensorCommand(src, dst, regions, unsafe);
+}
 
 /**
  * @brief Creates a ClearTensorCommand
@@ -541,4 +1738,102 @@ public:
     return ClearTensorCommand(tensor, params);
 }
 
+/**
+ * @brief Command filling a tensor with a repeated pattern
+ *
+ * Unlike ClearTensorCommand the pattern can be of any size multiple of 4,
+ * e.g. a whole struct. The pattern is recorded into the command buffer and
+ * replicated on the device, thus no host buffer is needed. 4 byte patterns
+ * are filled directly.
+ *
+ * @note Offset must be a multiple of 4 and size a multiple of the pattern size
+*/
+class HEPHAISTOS_API FillTensorCommand : public Command {
+public:
+    struct Params {
+        uint64_t offset = 0;
+        uint64_t size   = whole_size;
+        bool unsafe     = false;
+    };
+
+public:
+    /**
+     * @brief Target Tensor to fill
+    */
+    std::reference_wrapper<const Tensor<std::byte>> tensor;
+    /**
+     * @brief Offset into the target Tensor in bytes
+     *
+     * @note Must be a multiple of 4
+    */
+    uint64_t offset;
+    /**
+     * @brief Size of the region to fill in bytes
+     *
+     * @note Must be a multiple of the pattern size. whole_size, however, is
+     *       always truncated to the largest multiple fitting into the rest of
+     *       the Tensor.
+    */
+    uint64_t size;
+    /**
+     * @brief Pattern repeated to fill the Tensor
+     *
+     * @note Size must be a non zero multiple of 4 and at most 65536 bytes
+    */
+    std::vector<std::byte> pattern;
+    /**
+     * @brief If true, omits barriers ensuring read after write ordering.
+    */
+    bool unsafe;
+
+    virtual void record(vulkan::Command& cmd) const override;
+
+    FillTensorCommand(const FillTensorCommand& other);
+    FillTensorCommand& operator=(const FillTensorCommand& other);
+
+    FillTensorCommand(FillTensorCommand&& other) noexcept;
+    FillTensorCommand& operator=(FillTensorCommand&& other) noexcept;
+
+    /**
+     * @brief Creates a new FillTensorCommand
+     *
+     * @param tensor Target Tensor to fill
+     * @param pattern Pattern repeated to fill the tensor
+     * @param params Parametrization of the fill command
+    */
+    FillTensorCommand(const Tensor<std::byte>& tensor,
+        std::span<const std::byte> pattern, const Params& params);
+    ~FillTensorCommand() override;
+};
+/**
+ * @brief Creates a FillTensorCommand
+ *
+ * @param tensor Target Tensor to fill
+ * @param pattern Pattern repeated to fill the tensor
+ * @param params Parameterization of the fill command
+*/
+[[nodiscard]] inline FillTensorCommand fillTensor(
+    const Tensor<std::byte>& tensor,
+    std::span<const std::byte> pattern,
+    const FillTensorCommand::Params& params = {})
+{
+    return FillTensorCommand(tensor, pattern, params);
+}
+/**
+ * @brief Creates a FillTensorCommand
+ *
+ * @param tensor Target Tensor to fill
+ * @param pattern Value, e.g. a struct, repeated to fill the tensor
+ * @param params Parameterization of the fill command
+*/
+template<class T>
+[[nodiscard]] FillTensorCommand fillTensor(
+    const Tensor<std::byte>& tensor,
+    const T& pattern,
+    const FillTensorCommand::Params& params = {})
+    requires std::is_trivially_copyable_v<T>
+{
+    return FillTensorCommand(tensor, std::as_bytes(std::span(&pattern, 1)), params);
+}
+
 }
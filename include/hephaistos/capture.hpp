@@ -0,0 +1,191 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "hephaistos/buffer.hpp"
+#include "hephaistos/context.hpp"
+#include "hephaistos/handles.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief Dispatch recorded in a Capture
+*/
+struct CaptureDispatch {
+    /**
+     * @brief Index of the dispatched program
+    */
+    uint32_t program;
+    /**
+     * @brief Indices of the tensors bound to the program's bindings in order
+    */
+    std::vector<uint32_t> tensors;
+    /**
+     * @brief Push data passed to the dispatch
+    */
+    std::vector<std::byte> push;
+    /**
+     * @brief Amount of groups in X dimension
+    */
+    uint32_t groupCountX = 1;
+    /**
+     * @brief Amount of groups in Y dimension
+    */
+    uint32_t groupCountY = 1;
+    /**
+     * @brief Amount of groups in Z dimension
+    */
+    uint32_t groupCountZ = 1;
+};
+
+/**
+ * @brief Self-contained recording of dispatches for benchmarking
+ *
+ * Stores the code and specialization of programs, the contents of tensors at
+ * the time they were added and the structure of the dispatched work, so it
+ * can be saved and replayed without the surrounding application, e.g. on a
+ * different driver. Dispatches are grouped into steps: Dispatches within a
+ * step run concurrently, while each step waits on the previous one.
+*/
+class HEPHAISTOS_API Capture {
+public:
+    /**
+     * @brief Adds a program to the capture
+     *
+     * @param code SPIR-V code of the program
+     * @param specialization Data used for filling in specialization constants
+     * @return Index of the program
+    */
+    uint32_t addProgram(std::span<const uint32_t> code,
+        std::span<const std::byte> specialization = {});
+    /**
+     * @brief Adds a tensor with the given contents to the capture
+     *
+     * @param data Contents of the tensor
+     * @return Index of the tensor
+    */
+    uint32_t addTensor(std::span<const std::byte> data);
+    /**
+     * @brief Adds a tensor to the capture
+     *
+     * Reads the tensor's current contents and waits for it to finish.
+     *
+     * @param tensor Tensor whose contents to capture
+     * @return Index of the tensor
+    */
+    uint32_t addTensor(const Tensor<std::byte>& tensor);
+
+    /**
+     * @brief Records a dispatch in the current step
+     *
+     * @param dispatch Dispatch to record
+     * @return Reference to this
+    */
+    Capture& dispatch(CaptureDispatch dispatch);
+    /**
+     * @brief Starts a new step waiting on all dispatches recorded before
+     *
+     * @return Reference to this
+    */
+    Capture& nextStep();
+
+    /**
+     * @brief Returns the amount of programs
+    */
+    [[nodiscard]] uint32_t getProgramCount() const noexcept;
+    /**
+     * @brief Returns the amount of tensors
+    */
+    [[nodiscard]] uint32_t getTensorCount() const noexcept;
+    /**
+     * @brief Returns the SPIR-V code of the given program
+    */
+    [[nodiscard]] std::span<const uint32_t> getCode(uint32_t program) const;
+    /**
+     * @brief Returns the specialization data of the given program
+    */
+    [[nodiscard]] std::span<const std::byte> getSpecialization(uint32_t program) const;
+    /**
+     * @brief Returns the captured contents of the given tensor
+    */
+    [[nodiscard]] std::span<const std::byte> getTensorData(uint32_t tensor) const;
+    /**
+     * @brief Returns the dispatches of each step
+    */
+    [[nodiscard]] const std::vector<std::vector<CaptureDispatch>>& getSteps() const noexcept;
+
+    /**
+     * @brief Serializes the capture
+    */
+    [[nodiscard]] std::vector<std::byte> serialize() const;
+    /**
+     * @brief Saves the capture to the given file
+    */
+    void save(const std::filesystem::path& path) const;
+
+    Capture(const Capture&) = delete;
+    Capture& operator=(const Capture&) = delete;
+
+    Capture(Capture&&) noexcept;
+    Capture& operator=(Capture&&) noexcept;
+
+    /**
+     * @brief Creates an empty capture
+    */
+    Capture();
+    /**
+     * @brief Loads a capture from serialized data
+    */
+    explicit Capture(std::span<const std::byte> data);
+    /**
+     * @brief Loads a capture from the given file
+    */
+    explicit Capture(const std::filesystem::path& path);
+    ~Capture();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Options controlling how a capture is replayed
+*/
+struct ReplayOptions {
+    /**
+     * @brief Amount of untimed runs before measuring
+    */
+    uint32_t warmup = 1;
+    /**
+     * @brief Amount of timed runs
+    */
+    uint32_t iterations = 10;
+    /**
+     * @brief Restore the captured tensor contents before each run
+     *
+     * Restoring is not part of the measured time.
+    */
+    bool resetTensors = true;
+};
+
+/**
+ * @brief Replays the capture on the given context and measures each run
+ *
+ * Creates the programs and tensors once and submits all steps per run, while
+ * a StopWatch measures the time between the start of the first and the end
+ * of the last step.
+ *
+ * @param context Context on which to replay the capture
+ * @param capture Capture to replay
+ * @param options Options controlling the runs
+ * @return Duration of each timed run in nanoseconds
+*/
+[[nodiscard]] HEPHAISTOS_API std::vector<double> replayCapture(
+    const ContextHandle& context, const Capture& capture,
+    const ReplayOptions& options = {});
+
+}
@@ -1,9 +1,14 @@
 #pragma once
 
 #include <concepts>
+#include <coroutine>
 #include <functional>
+#include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "hephaistos/context.hpp"
 #include "hephaistos/handles.hpp"
@@ -13,7 +18,10 @@ namespace hephaistos {
 //forward
 namespace vulkan {
     struct Command;
+    struct SubroutineBuffer;
+    struct SubroutinePart;
     struct Timeline;
+    class HazardTracker;
 }
 struct SubmissionResources;
 
@@ -45,6 +53,12 @@ public:
      * @brief Wether this Subroutine can be submitted multiple times simultaneously
     */
     bool simultaneousUse() const;
+    /**
+     * @brief Wether this Subroutine can be nested inside other Subroutines
+     * 
+     * Only Subroutines solely assembled from SubroutinePart can be nested.
+    */
+    bool nestable() const;
 
     Subroutine(const Subroutine&) = delete;
     Subroutine& operator=(const Subroutine&) = delete;
@@ -56,22 +70,117 @@ public:
 
 public: //internal
     const vulkan::Command& getCommandBuffer() const;
+    const std::vector<std::shared_ptr<vulkan::SubroutinePart>>& getParts() const;
 
 private:
     Subroutine(
         ContextHandle context,
-        std::unique_ptr<vulkan::Command> cmdBuffer,
-        bool simultaneous_use);
+        std::unique_ptr<vulkan::SubroutineBuffer> cmdBuffer,
+        std::vector<std::shared_ptr<vulkan::SubroutinePart>> parts,
+        bool simultaneous_use,
+        bool parts_only);
 
     friend class SubroutineBuilder;
 
 private:
-    std::unique_ptr<vulkan::Command> cmdBuffer;
+    std::unique_ptr<vulkan::SubroutineBuffer> cmdBuffer;
+    std::vector<std::shared_ptr<vulkan::SubroutinePart>> parts;
     bool simultaneous_use;
+    bool parts_only;
+};
+
+/**
+ * @brief Part of a Subroutine recorded independently of others
+ * 
+ * Each part is recorded into its own command pool, thus allowing multiple
+ * parts to be recorded in parallel on different threads. The parts are then
+ * stitched together into a Subroutine via SubroutineBuilder::addPart()
+ * without re-recording them. The same part can be used by multiple
+ * Subroutines.
+*/
+class HEPHAISTOS_API SubroutinePart : public Resource {
+public:
+    SubroutinePart(const SubroutinePart&) = delete;
+    SubroutinePart& operator=(const SubroutinePart&) = delete;
+
+    SubroutinePart(SubroutinePart&& other) noexcept;
+    SubroutinePart& operator=(SubroutinePart&& other) noexcept;
+
+    ~SubroutinePart() override;
+
+public: //internal
+    const std::shared_ptr<vulkan::SubroutinePart>& getPart() const;
+
+private:
+    SubroutinePart(ContextHandle context, std::shared_ptr<vulkan::SubroutinePart> part);
+
+    friend class SubroutinePartBuilder;
+
+private:
+    std::shared_ptr<vulkan::SubroutinePart> part;
+};
+
+/**
+ * @brief Builder for creating SubroutinePart from a sequence of Command
+ * 
+ * Different builders can be used on different threads simultaneously.
+*/
+class HEPHAISTOS_API SubroutinePartBuilder final {
+public:
+    /**
+     * @brief True, if the builder is still recording
+    */
+    explicit operator bool() const;
+
+    /**
+     * @brief Records the next command into the sequence
+    */
+    SubroutinePartBuilder& addCommand(const Command& command) &;
+    /**
+     * @brief Records the next command into the sequence
+    */
+    SubroutinePartBuilder addCommand(const Command& command) &&;
+    /**
+     * @brief Enables automatic hazard tracking for the following commands
+     * 
+     * @note Hazards are only tracked within this part
+    */
+    SubroutinePartBuilder& trackHazards() &;
+    /**
+     * @brief Enables automatic hazard tracking for the following commands
+    */
+    SubroutinePartBuilder trackHazards() &&;
+    /**
+     * @brief Finishes recording and returns the built SubroutinePart
+    */
+    SubroutinePart finish();
+
+    SubroutinePartBuilder(const SubroutinePartBuilder& other) = delete;
+    SubroutinePartBuilder& operator=(const SubroutinePartBuilder& other) = delete;
+
+    SubroutinePartBuilder(SubroutinePartBuilder&& other) noexcept;
+    SubroutinePartBuilder& operator=(SubroutinePartBuilder&& other) noexcept;
+
+    /**
+     * @brief Creates a new SubroutinePartBuilder
+     * 
+     * @param context Conext onto which to create the builder
+    */
+    explicit SubroutinePartBuilder(ContextHandle context);
+    ~SubroutinePartBuilder();
+
+private:
+    ContextHandle context;
+    std::shared_ptr<vulkan::SubroutinePart> part;
+    std::unique_ptr<vulkan::HazardTracker> tracker;
 };
 
 /**
  * @brief Builder for creating Subroutines from a sequence of Command
+ * 
+ * @note Builders share a command pool per context and must therefore not be
+ *       used on different threads simultaneously. Use SubroutinePartBuilder
+ *       to record in parallel.
 */
 class HEPHAISTOS_API SubroutineBuilder final {
 public:
@@ -88,6 +197,40 @@ public:
      * @brief Records the next command into the sequence
     */
     SubroutineBuilder addCommand(const Command& command) &&;
+    /**
+     * @brief Appends the given part to the sequence without re-recording it
+     * 
+     * @note Parts are not tracked for hazards
+    */
+    SubroutineBuilder& addPart(const SubroutinePart& part) &;
+    /**
+     * @brief Appends the given part to the sequence without re-recording it
+    */
+    SubroutineBuilder addPart(const SubroutinePart& part) &&;
+    /**
+     * @brief Appends the parts of the given Subroutine to the sequence
+     *        without re-recording them
+     * 
+     * @note The Subroutine must be nestable, i.e. assembled from parts only
+    */
+    SubroutineBuilder& addSubroutine(const Subroutine& subroutine) &;
+    /**
+     * @brief Appends the parts of the given Subroutine to the sequence
+     *        without re-recording them
+    */
+    SubroutineBuilder addSubroutine(const Subroutine& subroutine) &&;
+    /**
+     * @brief Enables automatic hazard tracking for the following commands
+     * 
+     * Instead of conservatively synchronizing each command, barriers are
+     * only recorded between commands actually depending on each other.
+     * Should be enabled before any command is recorded.
+    */
+    SubroutineBuilder& trackHazards() &;
+    /**
+     * @brief Enables automatic hazard tracking for the following commands
+    */
+    SubroutineBuilder trackHazards() &&;
     /**
      * @brief Finishes recording and returns the built Subroutine
     */
@@ -111,8 +254,11 @@ public:
 
 private:
     ContextHandle context;
-    std::unique_ptr<vulkan::Command> cmdBuffer;
+    std::unique_ptr<vulkan::SubroutineBuffer> cmdBuffer;
+    std::unique_ptr<vulkan::HazardTracker> tracker;
+    std::vector<std::shared_ptr<vulkan::SubroutinePart>> parts;
     bool simultaneous_use;
+    bool parts_only;
 };
 
 /**
@@ -152,6 +298,47 @@ template<std::derived_from<Command> ...T>
     return builder.finish();
 }
 
+class Timeline;
+
+/**
+ * @brief Function resuming a suspended coroutine, e.g. by scheduling it onto
+ *        a thread pool
+*/
+using Executor = std::function<void(std::coroutine_handle<>)>;
+
+/**
+ * @brief Awaitable suspending a coroutine until a Timeline reaches a value
+ * 
+ * Instead of blocking a thread, the coroutine gets resumed via the context's
+ * completion service (see Timeline::onValue()) either directly on its thread
+ * or handed to the given Executor. The latter is recommended as the
+ * completion thread is shared among all pending waits.
+ * 
+ * @note The coroutine never resumes if the Timeline gets destroyed before
+ *       reaching the value.
+*/
+class HEPHAISTOS_API TimelineAwaiter {
+public:
+    [[nodiscard]] bool await_ready() const;
+    void await_suspend(std::coroutine_handle<> handle) const;
+    void await_resume() const noexcept {}
+
+    /**
+     * @brief Creates a new TimelineAwaiter
+     * 
+     * @param timeline Timeline to wait on
+     * @param value Value the timeline has to reach
+     * @param executor Executor to resume the coroutine on. If empty, resumes
+     *                 it directly on the completion thread.
+    */
+    TimelineAwaiter(const Timeline& timeline, uint64_t value, Executor executor = {});
+
+private:
+    const Timeline& timeline;
+    uint64_t value;
+    Executor executor;
+};
+
 /**
  * @brief Synchronizes work between and across GPU and CPU
  * 
@@ -194,6 +381,30 @@ public:
      * @return True, if the value was reached, false if timeout
     */
     [[nodiscard]] bool waitValue(uint64_t value, uint64_t timeout) const;
+    /**
+     * @brief Registers a callback to run once the timeline reaches the given
+     *        value
+     * 
+     * Callbacks run on a single background thread owned by the context,
+     * which waits on all pending timelines at once. They should return
+     * quickly and must not throw. Callbacks still pending when the Timeline
+     * gets destroyed are dropped.
+     * 
+     * @param value Value the timeline has to reach
+     * @param callback Function to call once the value is reached
+    */
+    void onValue(uint64_t value, std::function<void()> callback) const;
+    /**
+     * @brief Returns an awaitable suspending a coroutine until the timeline
+     *        reaches the given value
+     * 
+     * @note See TimelineAwaiter
+     * 
+     * @param value Value the timeline has to reach
+     * @param executor Executor to resume the coroutine on. If empty, resumes
+     *                 it directly on the completion thread.
+    */
+    [[nodiscard]] TimelineAwaiter awaitValue(uint64_t value, Executor executor = {}) const;
 
     Timeline(const Timeline&) = delete;
     Timeline& operator=(const Timeline&) = delete;
@@ -212,6 +423,8 @@ public:
 
 public: //internal
     vulkan::Timeline& getTimeline() const;
+    std::unique_ptr<vulkan::Timeline> releaseTimeline();
+    Timeline(ContextHandle context, std::unique_ptr<vulkan::Timeline> timeline);
 
 private:
     std::unique_ptr<vulkan::Timeline> timeline;
@@ -232,12 +445,12 @@ public:
     uint64_t getFinalStep() const;
 
     /**
-     * @brief If true, Submission can be destructed without any wait
+     * @brief If true, Submission does not manage any internal resources
      * 
-     * Submission may manage internal resources, which can only be destroyed
-     * once the submitted work has finished. If true, the Submission does not
-     * manage any such resources and can be destructed immediately, otherwise
-     * the destructor waits on the work to finish.
+     * Submission may manage internal resources, which can only be recycled
+     * once the submitted work has finished. Either way, the destructor does
+     * not wait but hands such resources back to the context, which recycles
+     * them lazily once the work has finished.
     */
     [[nodiscard]] bool forgettable() const noexcept;
 
@@ -253,6 +466,29 @@ public:
      * @return True, if the work has finished, false if the timeout expires
     */
     [[nodiscard]] bool wait(uint64_t timeout) const;
+    /**
+     * @brief Registers a callback to run once the submitted work has finished
+     * 
+     * @note See Timeline::onValue()
+     * 
+     * @param callback Function to call once the work has finished
+    */
+    void onFinished(std::function<void()> callback) const;
+    /**
+     * @brief Returns an awaitable suspending a coroutine until the submitted
+     *        work has finished
+     * 
+     * @note See TimelineAwaiter
+     * 
+     * @param executor Executor to resume the coroutine on. If empty, resumes
+     *                 it directly on the completion thread.
+    */
+    [[nodiscard]] TimelineAwaiter awaitFinished(Executor executor = {}) const;
+    /**
+     * @brief Suspends the awaiting coroutine until the submitted work has
+     *        finished and resumes it on the completion thread
+    */
+    [[nodiscard]] TimelineAwaiter operator co_await() const;
 
     Submission(const Submission&) = delete;
     Submission& operator=(const Submission&) = delete;
@@ -270,6 +506,235 @@ private:
     std::unique_ptr<SubmissionResources> resources;
 };
 
+/**
+ * @brief Limits the amount of submissions in flight on the given context
+ *
+ * Once the limit is reached, submitting further work blocks until enough
+ * previously submitted work finished, while SequenceBuilder::TrySubmit()
+ * returns without submitting instead. This gives producers backpressure
+ * without waiting on individual submissions. Batches larger than the limit
+ * are submitted once nothing is in flight. Only submissions made while a
+ * limit is set count towards it.
+ *
+ * @note Submissions waiting on host work issued after submitting, e.g. a
+ *       timeline value signaled by the same thread, may block forever
+ *
+ * @param context Context on which to set the limit
+ * @param limit Maximum amount of submissions in flight. Zero disables it.
+*/
+HEPHAISTOS_API void setSubmissionLimit(const ContextHandle& context, uint32_t limit);
+/**
+ * @brief Returns the limit of submissions in flight; zero if unlimited
+*/
+[[nodiscard]] HEPHAISTOS_API uint32_t getSubmissionLimit(const ContextHandle& context);
+/**
+ * @brief Returns the amount of submissions counting towards the limit that
+ *        have not finished yet
+*/
+[[nodiscard]] HEPHAISTOS_API uint32_t getSubmissionsInFlight(const ContextHandle& context);
+
+/**
+ * @brief Pair of Timeline and value to wait for
+*/
+struct TimelineValue {
+    /**
+     * @brief Timeline to wait on
+    */
+    std::reference_wrapper<const Timeline> timeline;
+    /**
+     * @brief Value the timeline has to reach
+    */
+    uint64_t value;
+};
+
+/**
+ * @brief Blocks calling code until all timelines reach their value
+ * 
+ * Waits on all of them at once using a single call to the driver.
+ * 
+ * @note All timelines must have been created on the same context
+ * 
+ * @param values List of timeline and value pairs to wait for
+*/
+HEPHAISTOS_API void waitAll(std::span<const TimelineValue> values);
+/**
+ * @brief Blocks calling code until all timelines reach their value or the
+ *        timeout expires
+ * 
+ * @note All timelines must have been created on the same context
+ * 
+ * @param values List of timeline and value pairs to wait for
+ * @param timeout Timeout in nanoseconds to wait for
+ * @return True, if all values were reached, false if timeout
+*/
+[[nodiscard]] HEPHAISTOS_API bool waitAll(
+    std::span<const TimelineValue> values, uint64_t timeout);
+/**
+ * @brief Blocks calling code until all submissions finish
+ * 
+ * @note All submissions must have been created on the same context
+ * 
+ * @param submissions List of submissions to wait for
+*/
+HEPHAISTOS_API void waitAll(std::span<const Submission> submissions);
+/**
+ * @brief Blocks calling code until all submissions finish or the timeout
+ *        expires
+ * 
+ * @note All submissions must have been created on the same context
+ * 
+ * @param submissions List of submissions to wait for
+ * @param timeout Timeout in nanoseconds to wait for
+ * @return True, if all submissions finished, false if timeout
+*/
+[[nodiscard]] HEPHAISTOS_API bool waitAll(
+    std::span<const Submission> submissions, uint64_t timeout);
+
+/**
+ * @brief Blocks calling code until any of the timelines reaches its value
+ * 
+ * Waits on all of them at once using a single call to the driver.
+ * 
+ * @note All timelines must have been created on the same context
+ * 
+ * @param values Non-empty list of timeline and value pairs to wait for
+ * @return Index of the first pair whose value was reached
+*/
+[[nodiscard]] HEPHAISTOS_API size_t waitAny(std::span<const TimelineValue> values);
+/**
+ * @brief Blocks calling code until any of the timelines reaches its value or
+ *        the timeout expires
+ * 
+ * @note All timelines must have been created on the same context
+ * 
+ * @param values Non-empty list of timeline and value pairs to wait for
+ * @param timeout Timeout in nanoseconds to wait for
+ * @return Index of the first pair whose value was reached, or none if timeout
+*/
+[[nodiscard]] HEPHAISTOS_API std::optional<size_t> waitAny(
+    std::span<const TimelineValue> values, uint64_t timeout);
+/**
+ * @brief Blocks calling code until any of the submissions finishes
+ * 
+ * @note All submissions must have been created on the same context
+ * 
+ * @param submissions Non-empty list of submissions to wait for
+ * @return Index of the first finished submission
+*/
+[[nodiscard]] HEPHAISTOS_API size_t waitAny(std::span<const Submission> submissions);
+/**
+ * @brief Blocks calling code until any of the submissions finishes or the
+ *        timeout expires
+ * 
+ * @note All submissions must have been created on the same context
+ * 
+ * @param submissions Non-empty list of submissions to wait for
+ * @param timeout Timeout in nanoseconds to wait for
+ * @return Index of the first finished submission, or none if timeout
+*/
+[[nodiscard]] HEPHAISTOS_API std::optional<size_t> waitAny(
+    std::span<const Submission> submissions, uint64_t timeout);
+
+/**
+ * @brief Value of a timeline a step in a wait graph waits on or signals
+*/
+struct WaitGraphValue {
+    /**
+     * @brief Id of the timeline as returned by Timeline::getId()
+    */
+    uint64_t timeline;
+    /**
+     * @brief Value waited on or signaled
+    */
+    uint64_t value;
+};
+/**
+ * @brief Single step in a wait graph, i.e. one submission to a queue
+*/
+struct WaitGraphStep {
+    /**
+     * @brief Queue the step runs on
+    */
+    QueueType queue;
+    /**
+     * @brief Number of command buffers and subroutines submitted
+    */
+    uint32_t commandBufferCount;
+    /**
+     * @brief Timeline values the step waits on before it starts
+    */
+    std::vector<WaitGraphValue> waits;
+    /**
+     * @brief Timeline value signaled once the step finished
+    */
+    WaitGraphValue signal;
+};
+/**
+ * @brief Structured representation of the steps recorded by a SequenceBuilder
+*/
+struct WaitGraph {
+    /**
+     * @brief Steps in submission order
+    */
+    std::vector<WaitGraphStep> steps;
+};
+
+/**
+ * @brief Estimated timing of a wait graph's steps
+ *
+ * All times are in nanoseconds relative to the start of the earliest step.
+*/
+struct WaitGraphTiming {
+    /**
+     * @brief Estimated start time per step
+    */
+    std::vector<double> start;
+    /**
+     * @brief Estimated finish time per step
+    */
+    std::vector<double> finish;
+    /**
+     * @brief Time the step's queue idled right before the step started
+    */
+    std::vector<double> idle;
+    /**
+     * @brief Indices of the steps on the critical path in execution order
+    */
+    std::vector<size_t> criticalPath;
+    /**
+     * @brief Estimated total time until all steps finished
+    */
+    double duration;
+};
+
+/**
+ * @brief Creates a representation of the wait graph in the DOT language
+ *
+ * Each step becomes a node connected to the steps signaling the values it
+ * waits on. Values not signaled by any step are drawn as separate nodes.
+*/
+[[nodiscard]] HEPHAISTOS_API std::string printDot(const WaitGraph& graph);
+/**
+ * @brief Creates a JSON representation of the wait graph
+*/
+[[nodiscard]] HEPHAISTOS_API std::string printJson(const WaitGraph& graph);
+/**
+ * @brief Estimates the timing of the wait graph from the steps' durations
+ *
+ * Steps start once all values they wait on are signaled and the previous step
+ * on the same queue finished. Values not signaled by any step in the graph
+ * are assumed to be available from the start. The durations are typically
+ * measured using a StopWatch around each step's commands.
+ *
+ * @param graph Wait graph to analyze
+ * @param durations Duration of each step in nanoseconds
+ * @return Estimated timing including critical path and idle gaps
+*/
+[[nodiscard]] HEPHAISTOS_API WaitGraphTiming analyzeWaitGraph(
+    const WaitGraph& graph, std::span<const double> durations);
+
+class SequenceTemplate;
+
 /**
  * @brief Builder for creating work to be submitted to the device
 */
@@ -350,6 +815,46 @@ public:
      * @param value Value to wait for
     */
     SequenceBuilder& WaitFor(const Timeline& timeline, uint64_t value) &;
+    /**
+     * @brief Finalizes the current step and runs the given function on the
+     *        host before the next step starts
+     * 
+     * Once the previous steps finished, the function runs on a background
+     * worker thread, after which the host signals the underlying Timeline
+     * allowing the following steps to start. Thus the whole sequence is still
+     * submitted at once without the caller blocking in between, e.g. to read
+     * a counter and write the parameters of the next step.
+     * 
+     * @note The function must not throw. Exceptions are dropped and the
+     *       following steps start nonetheless.
+     * 
+     * @param callback Function to run on the host
+    */
+    SequenceBuilder& ThenHost(std::function<void()> callback) &;
+    /**
+     * @brief Finalizes the current step if it contains work and issues it
+     *        and all following steps to run on the given queue
+     * 
+     * Steps on different queues are still run in sequence, but allow other
+     * work, e.g. from other sequences, to overlap on the remaining queues.
+     * Falls back to the main queue if there is no dedicated one.
+     * 
+     * @note Subroutines can only run on queues sharing the main queue's family
+     * 
+     * @param queue Type of queue to run on
+    */
+    SequenceBuilder& OnQueue(QueueType queue) &;
+    /**
+     * @brief Enables automatic hazard tracking for the following commands
+     * 
+     * Instead of conservatively synchronizing each command, barriers are
+     * only recorded between commands within a step actually depending on
+     * each other. Steps are still synchronized via the timeline.
+     * 
+     * @note Should be enabled before any command is recorded. Subroutines
+     *       are not tracked.
+    */
+    SequenceBuilder& TrackHazards() &;
 
     SequenceBuilder And(const Command& command) &&;
     SequenceBuilder And(const Subroutine& subroutine) &&;
@@ -363,18 +868,45 @@ public:
     SequenceBuilder Then(const Subroutine& subroutine) &&;
     SequenceBuilder WaitFor(uint64_t value) &&;
     SequenceBuilder WaitFor(const Timeline& timeline, uint64_t value) &&;
+    SequenceBuilder ThenHost(std::function<void()> callback) &&;
+    SequenceBuilder OnQueue(QueueType queue) &&;
+    SequenceBuilder TrackHazards() &&;
 
     /**
      * @brief Submits the recorded work to the device
      * 
+     * Blocks while the context's submission limit is reached.
+     * 
      * @return Submission allowing to wait on the work to finish
     */
     Submission Submit();
+    /**
+     * @brief Submits the recorded work unless the context's submission limit
+     *        is reached
+     * 
+     * If the limit is reached, nothing is submitted and the builder stays
+     * usable, so the caller can retry later.
+     * 
+     * @return Submission allowing to wait on the work to finish or none if
+     *         submitting would block
+    */
+    [[nodiscard]] std::optional<Submission> TrySubmit();
+    /**
+     * @brief Finishes recording and returns the work as SequenceTemplate,
+     *        which can be submitted multiple times
+     * 
+     * @note Only available if the builder was created as reusable
+    */
+    SequenceTemplate Freeze();
 
     /**
      * @brief Creates a human readable representation of recorded steps
     */
     std::string printWaitGraph() const;
+    /**
+     * @brief Returns the structured wait graph of the recorded steps
+    */
+    [[nodiscard]] WaitGraph getWaitGraph() const;
 
     SequenceBuilder(SequenceBuilder&) = delete;
     SequenceBuilder& operator=(SequenceBuilder&) = delete;
@@ -385,23 +917,104 @@ public:
     /**
      * @brief Creates a new SequenceBuilder
      * 
-     * @note Creates an internal Timeline used for synchronizing steps
+     * @note Takes an internal Timeline for synchronizing steps from a pool
+     *       owned by the context. Its values continue where its last user
+     *       stopped.
      * 
      * @param context Context onto which to create the builder
+     * @param reusable Wether the recorded work can be frozen into a
+     *                 SequenceTemplate
     */
-    explicit SequenceBuilder(ContextHandle context);
+    explicit SequenceBuilder(ContextHandle context, bool reusable = false);
     /**
      * @brief Creates a new SequenceBuilder
      * 
      * @param timeline Timeline used to synchronize steps
      * @param startValue Value the first step should wait for before starting
+     * @param reusable Wether the recorded work can be frozen into a
+     *                 SequenceTemplate
     */
-    explicit SequenceBuilder(Timeline& timeline, uint64_t startValue = 0);
+    explicit SequenceBuilder(Timeline& timeline, uint64_t startValue = 0, bool reusable = false);
     ~SequenceBuilder();
 
 private:
     struct pImp;
     std::unique_ptr<pImp> _pImp;
+
+    friend class SequenceTemplate;
+    friend HEPHAISTOS_API std::vector<Submission> submitBatch(
+        std::span<SequenceBuilder> sequences);
+};
+
+/**
+ * @brief Submits the recorded work of multiple sequences at once
+ *
+ * Merges the steps of all sequences into a single submission per queue
+ * instead of one per sequence, thus reducing the overhead of many small
+ * submissions. Sequences stay independent, i.e. they only synchronize via
+ * their timelines as if submitted one after another in the given order.
+ *
+ * @note All sequences must belong to the same context
+ *
+ * @param sequences Sequences to submit. Finishes all of them.
+ * @return Submission of each sequence in the given order
+*/
+HEPHAISTOS_API std::vector<Submission> submitBatch(std::span<SequenceBuilder> sequences);
+
+/**
+ * @brief Recorded sequence of work, which can be submitted multiple times
+ * 
+ * Reuses the recorded command buffers and submission infos and only shifts
+ * the values of its Timeline on each submission, e.g. a sequence waiting on
+ * value 2 and finishing at value 5 runs from value 5 to 8 when submitted a
+ * second time. Waits on other timelines are kept as they are.
+ * 
+ * @note The SequenceTemplate must outlive the returned Submission. Its
+ *       resources are recycled once the last submission finished.
+*/
+class HEPHAISTOS_API SequenceTemplate final {
+public:
+    /**
+     * @brief Returns the Timeline used to synchronize the steps
+    */
+    const Timeline& getTimeline() const;
+    /**
+     * @brief Returns the value the next submission waits for by default,
+     *        i.e. the final step of the previous submission
+    */
+    uint64_t getNextStartValue() const;
+
+    /**
+     * @brief Submits the work continuing where the previous submission ended
+     * 
+     * @return Submission allowing to wait on the work to finish
+    */
+    Submission Submit();
+    /**
+     * @brief Submits the work with the first step waiting on the given value
+     * 
+     * @note Must not be lower than the final step of the previous submission.
+     *       Not available for sequences using an internal Timeline.
+     * 
+     * @param startValue Value the first step should wait for before starting
+     * @return Submission allowing to wait on the work to finish
+    */
+    Submission Submit(uint64_t startValue);
+
+    SequenceTemplate(const SequenceTemplate&) = delete;
+    SequenceTemplate& operator=(const SequenceTemplate&) = delete;
+
+    SequenceTemplate(SequenceTemplate&& other) noexcept;
+    SequenceTemplate& operator=(SequenceTemplate&& other) noexcept;
+
+    ~SequenceTemplate();
+
+private:
+    explicit SequenceTemplate(std::unique_ptr<SequenceBuilder::pImp> pImp);
+    friend class SequenceBuilder;
+
+    std::unique_ptr<SequenceBuilder::pImp> _pImp;
+    bool submitted;
 };
 
 /**
@@ -417,7 +1030,9 @@ inline SequenceBuilder beginSequence(Timeline& timeline, uint64_t startValue = 0
 /**
  * @brief Creates a new SequenceBuilder
  * 
- * @note Creates an internal Timeline used for synchronizing steps
+ * @note Takes an internal Timeline for synchronizing steps from a pool
+ *       owned by the context. Its values continue where its last user
+ *       stopped.
  * 
  * @param context Context onto which to create the builder
 */
@@ -425,6 +1040,124 @@ inline SequenceBuilder beginSequence(Timeline& timeline, uint64_t startValue = 0
 inline SequenceBuilder beginSequence(const ContextHandle& context) {
     return SequenceBuilder(context);
 }
+/**
+ * @brief Creates a new SequenceBuilder, whose work can be frozen into a
+ *        SequenceTemplate
+ * 
+ * @param timeline Timeline used to synchronize steps
+ * @param startValue Value the first step should wait for before starting
+*/
+[[nodiscard]]
+inline SequenceBuilder beginSequenceTemplate(Timeline& timeline, uint64_t startValue = 0) {
+    return SequenceBuilder(timeline, startValue, true);
+}
+/**
+ * @brief Creates a new SequenceBuilder, whose work can be frozen into a
+ *        SequenceTemplate
+ * 
+ * @note Takes an internal Timeline for synchronizing steps from a pool
+ *       owned by the context. Its values continue where its last user
+ *       stopped.
+ * 
+ * @param context Context onto which to create the builder
+*/
+[[nodiscard]]
+inline SequenceBuilder beginSequenceTemplate(const ContextHandle& context) {
+    return SequenceBuilder(context, true);
+}
+
+/**
+ * @brief Graph of tasks and their dependencies, which can be submitted
+ *        multiple times
+ *
+ * Tasks and the dependencies between them are declared once. On the first
+ * submission, the graph gets mapped onto steps: Independent tasks on the same
+ * queue share a step and each queue gets its own internal Timeline, so tasks
+ * on different queues may run concurrently. Steps only wait on the Timelines
+ * they actually depend on and redundant waits, i.e. ones already implied by
+ * others, are omitted. All steps of a queue are submitted at once.
+ *
+ * Each submission starts after the previous one finished and reuses the
+ * recorded command buffers.
+ *
+ * @note Commands are recorded as soon as they are added, thus any resources
+ *       they reference must outlive the TaskGraph. Its last submission must
+ *       finish before the TaskGraph gets destroyed; if it contains tasks on
+ *       multiple queues, the destructor waits for it.
+*/
+class HEPHAISTOS_API TaskGraph final {
+public:
+    /**
+     * @brief Returns the number of tasks in the graph
+    */
+    [[nodiscard]] size_t size() const noexcept;
+
+    /**
+     * @brief Adds a task running the given command
+     *
+     * @param command Command to run
+     * @param queue Type of queue to run on. Falls back to the main queue if
+     *              there is no dedicated one.
+     * @return Index of the new task
+    */
+    size_t addTask(const Command& command, QueueType queue = QueueType::MAIN);
+    /**
+     * @brief Adds a task running the given subroutine
+     *
+     * @note Subroutines must be created for simultaneous use and can only run
+     *       on queues sharing the main queue's family
+     *
+     * @param subroutine Subroutine to run
+     * @param queue Type of queue to run on. Falls back to the main queue if
+     *              there is no dedicated one.
+     * @return Index of the new task
+    */
+    size_t addTask(const Subroutine& subroutine, QueueType queue = QueueType::MAIN);
+    /**
+     * @brief Declares a task to not start before another one finished
+     *
+     * @param before Index of the task to finish first
+     * @param after Index of the task to start afterwards
+    */
+    void addDependency(size_t before, size_t after);
+
+    /**
+     * @brief Submits the graph to the device
+     *
+     * The first call finalizes the graph. Afterwards, no tasks and
+     * dependencies can be added anymore.
+     *
+     * @note The TaskGraph must outlive the returned Submission
+     *
+     * @return Submission allowing to wait on the work to finish
+    */
+    Submission Submit();
+
+    /**
+     * @brief Returns the structured wait graph of the next submission
+     *
+     * @note Finalizes the graph like Submit()
+    */
+    [[nodiscard]] WaitGraph getWaitGraph();
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    TaskGraph(TaskGraph&& other) noexcept;
+    TaskGraph& operator=(TaskGraph&& other) noexcept;
+
+    /**
+     * @brief Creates a new empty TaskGraph
+     *
+     * @param context Context onto which to create the TaskGraph
+    */
+    explicit TaskGraph(ContextHandle context);
+    ~TaskGraph();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
 
 /**
  * @brief Runs the given Command on the context and waits for it to finish
@@ -448,6 +1181,39 @@ HEPHAISTOS_API void execute(const ContextHandle& context, const Subroutine& subr
 */
 HEPHAISTOS_API void execute(const ContextHandle& context,
     const std::function<void(vulkan::Command& cmd)>& emitter);
+/**
+ * @brief Runs the given Command on the context without waiting for it to
+ *        finish
+ * 
+ * @note The work is synchronized using a Timeline from an internal pool
+ * 
+ * @param context Context to run the Command on
+ * @param command Command to run
+ * @return Submission allowing to wait on the work to finish
+*/
+[[nodiscard]] HEPHAISTOS_API Submission executeAsync(
+    const ContextHandle& context, const Command& command);
+/**
+ * @brief Runs the given Subroutine on the context without waiting for it to
+ *        finish
+ * 
+ * @note The Subroutine must stay alive until the work has finished
+ * 
+ * @param context Context to run the Subroutine on
+ * @param subroutine Subroutine to run
+ * @return Submission allowing to wait on the work to finish
+*/
+[[nodiscard]] HEPHAISTOS_API Submission executeAsync(
+    const ContextHandle& context, const Subroutine& subroutine);
+/**
+ * @brief Runs work on the given context without waiting for it to finish
+ * 
+ * @param context Context on which to run the work
+ * @param emitter Function recording work
+ * @return Submission allowing to wait on the work to finish
+*/
+[[nodiscard]] HEPHAISTOS_API Submission executeAsync(const ContextHandle& context,
+    const std::function<void(vulkan::Command& cmd)>& emitter);
 /**
  * @brief Runs the given sequence Command on the context
  * 
@@ -461,4 +1227,21 @@ void executeList(const ContextHandle& context, const T& ...commands) {
     });
 }
 
+/**
+ * @brief Runs the given sequence Command on the context without waiting for
+ *        it to finish
+ * 
+ * @param context Context on which to run the work
+ * @param commands... Sequence of Commands to run
+ * @return Submission allowing to wait on the work to finish
+*/
+template<std::derived_from<Command> ...T>
+[[nodiscard]] Submission executeListAsync(
+    const ContextHandle& context, const T& ...commands)
+{
+    return executeAsync(context, [&commands...](vulkan::Command& cmd) {
+        (commands.record(cmd), ...);
+    });
+}
+
 }
@@ -1,16 +1,209 @@
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
+#include <future>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "hephaistos/config.hpp"
+#include "hephaistos/program.hpp"
 
 namespace hephaistos {
 
+/**
+ * @brief Target environment code gets compiled for
+*/
+enum class CompileTarget {
+    /**
+     * @brief Vulkan 1.2 using SPIR-V 1.4
+    */
+    VULKAN_1_2 = 0,
+    /**
+     * @brief Vulkan 1.2 using SPIR-V 1.5
+    */
+    VULKAN_1_2_SPIRV_1_5 = 1,
+    /**
+     * @brief Vulkan 1.3 using SPIR-V 1.6
+     *
+     * @note Contexts currently target Vulkan 1.2, thus programs can not be
+     *       created from code compiled for this target.
+    */
+    VULKAN_1_3 = 2
+};
+
+/**
+ * @brief Shader stage code gets compiled for
+*/
+enum class ShaderStage {
+    /**
+     * @brief Compute shader used by Program
+    */
+    COMPUTE = 0,
+    /**
+     * @brief Ray generation shader used by RayTracingProgram
+    */
+    RAYGEN = 1,
+    /**
+     * @brief Miss shader used by RayTracingProgram
+    */
+    MISS = 2,
+    /**
+     * @brief Closest hit shader used by RayTracingProgram
+    */
+    CLOSEST_HIT = 3,
+    /**
+     * @brief Any hit shader used by RayTracingProgram
+    */
+    ANY_HIT = 4,
+    /**
+     * @brief Intersection shader used by RayTracingProgram
+    */
+    INTERSECTION = 5
+};
+
+/**
+ * @brief Handling of denormalized floats in compiled code
+*/
+enum class DenormMode {
+    /**
+     * @brief Leaves the handling to the device
+    */
+    DEFAULT = 0,
+    /**
+     * @brief Denormalized floats are preserved
+     *
+     * @note Requires support by the device for each float width used, see
+     *       getFloatControlsProperties()
+    */
+    PRESERVE = 1,
+    /**
+     * @brief Denormalized floats are flushed to zero
+     *
+     * Usually faster on devices handling denormalized floats in software.
+     *
+     * @note Requires support by the device for each float width used, see
+     *       getFloatControlsProperties()
+    */
+    FLUSH_TO_ZERO = 2
+};
+
+/**
+ * @brief Options controlling the compilation of shader code
+*/
+struct CompileOptions {
+    /**
+     * @brief Target environment to compile for
+    */
+    CompileTarget target = CompileTarget::VULKAN_1_2;
+    /**
+     * @brief Macros defined before the source code as pairs of name and value
+    */
+    std::vector<std::pair<std::string, std::string>> defines = {};
+    /**
+     * @brief If true, removes debug information like names from the code
+     *
+     * @note Binding names get lost, thus parameters can only be bound by
+     *       their binding number.
+    */
+    bool stripDebugInfo = false;
+    /**
+     * @brief Shader stage to compile for
+    */
+    ShaderStage stage = ShaderStage::COMPUTE;
+    /**
+     * @brief Handling of denormalized floats
+    */
+    DenormMode denormMode = DenormMode::DEFAULT;
+    /**
+     * @brief If true, 32 bit float operations may use lower precision
+     *
+     * Decorates all float results as relaxed precision like mediump does,
+     * allowing devices to compute them with 16 bit.
+    */
+    bool relaxedPrecision = false;
+    /**
+     * @brief If true, allows fast math for all float operations
+     *
+     * Allows the device to assume there are neither NaNs, infinities nor
+     * signed zeros, to use reciprocals and to contract and reassociate
+     * operations. Operations declared as precise are unaffected.
+     *
+     * @note Requires VK_KHR_shader_float_controls2, which contexts enable if
+     *       supported, see getFloatControlsProperties()
+    */
+    bool fastMath = false;
+    /**
+     * @brief If true, compiles for the Vulkan memory model
+     *
+     * Enables GL_KHR_memory_scope_semantics, i.e. scoped atomics and barriers
+     * with explicit acquire/release semantics, and makes coherent memory
+     * accesses follow the Vulkan memory model.
+     *
+     * @note Requires the memory model to be enabled on the context, which
+     *       contexts do if supported, see getMemoryModelFeatures()
+    */
+    bool vulkanMemoryModel = false;
+};
+
+/**
+ * @brief Handle to a program built in the background
+ *
+ * Returned by Compiler::buildProgramAsync(). Can be polled or waited on until
+ * the program is ready.
+*/
+class HEPHAISTOS_API PendingProgram {
+public:
+    /**
+     * @brief Checks wether the program finished building
+     *
+     * @return True, if get() will not block, false otherwise
+    */
+    [[nodiscard]] bool isReady() const;
+    /**
+     * @brief Blocks until the program finished building
+    */
+    void wait() const;
+    /**
+     * @brief Returns the built program
+     *
+     * Blocks until the program finished building. Rethrows errors raised
+     * during compilation or program creation.
+     * @note Can only be called once
+    */
+    [[nodiscard]] Program get();
+
+    PendingProgram(PendingProgram&&) noexcept;
+    PendingProgram& operator=(PendingProgram&&) noexcept;
+
+    PendingProgram(const PendingProgram&) = delete;
+    PendingProgram& operator=(const PendingProgram&) = delete;
+
+    explicit PendingProgram(std::future<Program> future);
+    ~PendingProgram();
+
+private:
+    std::future<Program> future;
+};
+
 /**
  * @brief Compiler for GLSL shader code
+ *
+ * Besides headers passed explicitly or found in the include directories, the
+ * built-in headers shipped with the library can always be included, e.g.
+ * "hephaistos/random.glsl" providing counter-based random numbers. The
+ * GL_GOOGLE_include_directive extension is enabled implicitly, so shaders do
+ * not need to request it.
+ *
+ * If the library was built with BUILD_RUNTIME_COMPILER turned off, which
+ * defines HEPHAISTOS_NO_COMPILER, glslang is left out and all compilations
+ * throw. Shaders are then compiled at build time instead, e.g. via the
+ * hephaistos_add_shaders() CMake function.
 */
 class HEPHAISTOS_API Compiler {
 public:
@@ -48,6 +241,66 @@ public:
      * @brief Removes all include directories
     */
     void clearIncludeDir();
+    /**
+     * @brief Loads all files in the include directories into memory
+     *
+     * Include files are cached after they were first loaded and only read
+     * again if they changed on disk. Preloading avoids the first load
+     * happening during compilation. Changing the include directories clears
+     * the cache.
+    */
+    void preloadIncludes();
+
+    /**
+     * @brief Sets the options used for compiling
+    */
+    void setOptions(CompileOptions options);
+    /**
+     * @brief Returns the options used for compiling
+    */
+    [[nodiscard]] const CompileOptions& getOptions() const noexcept;
+
+    /**
+     * @brief Sets the directory used to cache compiled code
+     *
+     * If set, compiled code is stored in the given directory keyed by the
+     * source code, the header map, the include directories, the options and
+     * the compiler version. Later compilations of the same source return the stored code
+     * without compiling it again, as long as the include files loaded from
+     * disk did not change. An empty path disables caching, which is the
+     * default. The directory gets created if it does not exist.
+     * Failing to read or write the cache is not an error, but causes the code
+     * to be compiled.
+     *
+     * @param dir Path to the cache directory
+    */
+    void setCacheDir(std::filesystem::path dir);
+    /**
+     * @brief Returns the directory used to cache compiled code
+     *
+     * @return Path to the cache directory. Empty if caching is disabled.
+    */
+    [[nodiscard]] const std::filesystem::path& getCacheDir() const noexcept;
+
+    /**
+     * @brief Returns the key compiled code is cached under
+     *
+     * Combines the source code with the header map, the include directories,
+     * the options and the compiler version. Equal keys yield the same code as
+     * long as the include files loaded from disk did not change.
+     *
+     * @param code GLSL source code
+     * @return Key of the compiled code
+    */
+    [[nodiscard]] uint64_t getCacheKey(std::string_view code) const;
+    /**
+     * @brief Returns the key compiled code is cached under
+     *
+     * @param code GLSL source code
+     * @param headers Map of source code for resolving includes
+     * @return Key of the compiled code
+    */
+    [[nodiscard]] uint64_t getCacheKey(std::string_view code, const HeaderMap& headers) const;
 
     /**
      * @brief Compiles the given GLSL source code
@@ -65,6 +318,94 @@ public:
     */
     [[nodiscard]] std::vector<uint32_t> compile(std::string_view code, const HeaderMap& headers) const;
 
+    /**
+     * @brief Compiles the given GLSL sources in parallel
+     *
+     * Distributes the sources on up to the given amount of threads including
+     * the calling one. If any compilation fails, throws the first error after
+     * all threads finished.
+     *
+     * @param codes GLSL source codes
+     * @param threads Maximum amount of threads to use. Zero uses one per core.
+     * @return Compiled SPIR-V byte code in the same order as codes
+    */
+    [[nodiscard]] std::vector<std::vector<uint32_t>> compileMany(
+        std::span<const std::string_view> codes, uint32_t threads = 0) const;
+    /**
+     * @brief Compiles the given GLSL sources in parallel
+     *
+     * Distributes the sources on up to the given amount of threads including
+     * the calling one. If any compilation fails, throws the first error after
+     * all threads finished.
+     *
+     * @param codes GLSL source codes
+     * @param headers Map of source code for resolving includes. Takes precedence
+     * @param threads Maximum amount of threads to use. Zero uses one per core.
+     * @return Compiled SPIR-V byte code in the same order as codes
+    */
+    [[nodiscard]] std::vector<std::vector<uint32_t>> compileMany(
+        std::span<const std::string_view> codes,
+        const HeaderMap& headers,
+        uint32_t threads = 0) const;
+
+    /**
+     * @brief Compiles the given GLSL source code on an internal worker pool
+     *
+     * Include directories, options and cache directory are copied, so the
+     * compiler may be changed or destroyed while the compilation is running.
+     *
+     * @param code GLSL source code
+     * @return Future of the compiled SPIR-V byte code. Rethrows compile errors.
+    */
+    [[nodiscard]] std::future<std::vector<uint32_t>> compileAsync(std::string code) const;
+    /**
+     * @brief Compiles the given GLSL source code on an internal worker pool
+     *
+     * Include directories, options and cache directory are copied, so the
+     * compiler may be changed or destroyed while the compilation is running.
+     *
+     * @param code GLSL source code
+     * @param headers Map of source code for resolving includes. Takes precedence
+     * @return Future of the compiled SPIR-V byte code. Rethrows compile errors.
+    */
+    [[nodiscard]] std::future<std::vector<uint32_t>> compileAsync(
+        std::string code, HeaderMap headers) const;
+
+    /**
+     * @brief Compiles the given GLSL source code and creates a program from it
+     *        in the background
+     *
+     * Include directories, options and cache directory are copied, so the
+     * compiler may be changed or destroyed while the program is building.
+     *
+     * @param context Context on which to create the program
+     * @param code GLSL source code
+     * @param specialization Data used to populate specialization constants
+     * @return Handle to poll or wait for the program
+    */
+    [[nodiscard]] PendingProgram buildProgramAsync(
+        ContextHandle context,
+        std::string code,
+        std::vector<std::byte> specialization = {}) const;
+    /**
+     * @brief Compiles the given GLSL source code and creates a program from it
+     *        in the background
+     *
+     * Include directories, options and cache directory are copied, so the
+     * compiler may be changed or destroyed while the program is building.
+     *
+     * @param context Context on which to create the program
+     * @param code GLSL source code
+     * @param headers Map of source code for resolving includes. Takes precedence
+     * @param specialization Data used to populate specialization constants
+     * @return Handle to poll or wait for the program
+    */
+    [[nodiscard]] PendingProgram buildProgramAsync(
+        ContextHandle context,
+        std::string code,
+        HeaderMap headers,
+        std::vector<std::byte> specialization = {}) const;
+
     Compiler& operator=(Compiler&&) noexcept;
     Compiler(Compiler&&) noexcept;
 
@@ -77,8 +418,51 @@ public:
     Compiler();
     ~Compiler();
 
+private:
+    [[nodiscard]] std::vector<std::vector<uint32_t>> compileMany(
+        std::span<const std::string_view> codes,
+        const HeaderMap* headers,
+        uint32_t threads) const;
+
+public: //internal
+    struct IncludeCache;
+
 private:
     std::vector<std::filesystem::path> includeDirs;
+    std::shared_ptr<IncludeCache> includeCache;
+    std::filesystem::path cacheDir;
+    CompileOptions options;
 };
 
+/**
+ * @brief Folds specialization constants into the given SPIR-V code
+ *
+ * Replaces specialization constants with regular constants of the given
+ * values, so drivers can optimize the code as if the values were hardcoded
+ * without relying on specializing during pipeline creation. Composites only
+ * consisting of constants get folded as well.
+ * The data is interpreted the same way as the specialization of Program:
+ * Tightly packed 4 byte values ordered by their constant id. Constants
+ * without data keep their default value and can still be specialized.
+ *
+ * @param code SPIR-V byte code
+ * @param specialization Data used to populate specialization constants
+ * @return Specialized SPIR-V byte code
+*/
+[[nodiscard]] HEPHAISTOS_API std::vector<uint32_t> specializeCode(
+    std::span<const uint32_t> code, std::span<const std::byte> specialization);
+/**
+ * @brief Folds specialization constants into the given SPIR-V code
+ *
+ * @param code SPIR-V byte code
+ * @param specialization Data used to populate specialization constants
+ * @return Specialized SPIR-V byte code
+*/
+template<class T>
+[[nodiscard]] std::vector<uint32_t> specializeCode(
+    std::span<const uint32_t> code, const T& specialization)
+{
+    return specializeCode(code, std::as_bytes(std::span<const T>{ &specialization, 1 }));
+}
+
 }
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+#include "hephaistos/buffer.hpp"
+#include "hephaistos/command.hpp"
+#include "hephaistos/context.hpp"
+#include "hephaistos/handles.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief Checks for conditional execution support
+ *
+ * @param device Handle to device to be checked for conditional execution support
+ * @return True, if the given device supports conditional execution, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isConditionalExecutionSupported(const DeviceHandle& device);
+/**
+ * @brief Checks wether conditional execution is enabled
+ *
+ * @param context Context to check
+ * @return True, if conditional execution is enabled in the given context, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isConditionalExecutionEnabled(const ContextHandle& context);
+
+/**
+ * @brief Creates a conditional execution extension
+ *
+ * Returns an extension which can be passed during the creation of a context to
+ * enable conditional execution.
+ *
+ * @return Extension for enabling conditional execution
+*/
+[[nodiscard]] HEPHAISTOS_API ExtensionHandle createConditionalExecutionExtension();
+
+/**
+ * @brief Command for starting a block of conditionally executed dispatches
+ *
+ * Dispatches recorded after this command until the next EndConditionalCommand
+ * are discarded by the device if the 32 bit value read from the tensor at the
+ * given offset is zero, or non zero if inverted. Since the value is read while
+ * the device executes the commands, earlier programs can decide whether the
+ * block runs without a round trip to the host. Other commands, e.g. copies,
+ * are not affected.
+ *
+ * @note Begin and end of a block must be recorded into the same step of a
+ *       sequence or the same subroutine. Blocks cannot be nested.
+*/
+class HEPHAISTOS_API BeginConditionalCommand : public Command {
+public:
+    /**
+     * @brief Tensor from which to read the predicate
+    */
+    std::reference_wrapper<const Tensor<std::byte>> tensor;
+    /**
+     * @brief Offset in bytes into tensor at which the predicate is stored
+    */
+    uint64_t offset;
+    /**
+     * @brief If true, the block is discarded if the predicate is non zero
+    */
+    bool inverted;
+
+    void record(vulkan::Command& cmd) const override;
+
+    BeginConditionalCommand(const BeginConditionalCommand&);
+    BeginConditionalCommand& operator=(const BeginConditionalCommand&);
+
+    /**
+     * @brief Creates a new BeginConditionalCommand
+     *
+     * @param tensor Tensor from which to read the predicate
+     * @param offset Offset in bytes at which the predicate is stored.
+     *               Must be a multiple of 4.
+     * @param inverted If true, the block is discarded if the predicate is non zero
+    */
+    explicit BeginConditionalCommand(
+        const Tensor<std::byte>& tensor, uint64_t offset = 0, bool inverted = false);
+    ~BeginConditionalCommand() override;
+};
+/**
+ * @brief Creates a new BeginConditionalCommand
+ *
+ * @param tensor Tensor from which to read the predicate
+ * @param offset Offset in bytes at which the predicate is stored.
+ *               Must be a multiple of 4.
+ * @param inverted If true, the block is discarded if the predicate is non zero
+ * @return BeginConditionalCommand starting the block on being recorded
+*/
+[[nodiscard]] inline BeginConditionalCommand beginConditional(
+    const Tensor<std::byte>& tensor, uint64_t offset = 0, bool inverted = false)
+{
+    return BeginConditionalCommand(tensor, offset, inverted);
+}
+
+/**
+ * @brief Command for ending a block of conditionally executed dispatches
+*/
+class HEPHAISTOS_API EndConditionalCommand : public Command {
+public:
+    /**
+     * @brief Context on which the block was started
+    */
+    std::reference_wrapper<const vulkan::Context> context;
+
+    void record(vulkan::Command& cmd) const override;
+
+    EndConditionalCommand(const EndConditionalCommand&);
+    EndConditionalCommand& operator=(const EndConditionalCommand&);
+
+    /**
+     * @brief Creates a new EndConditionalCommand
+     *
+     * @param context Context on which the block was started
+    */
+    explicit EndConditionalCommand(const ContextHandle& context);
+    ~EndConditionalCommand() override;
+};
+/**
+ * @brief Creates a new EndConditionalCommand
+ *
+ * @param context Context on which the block was started
+ * @return EndConditionalCommand ending the block on being recorded
+*/
+[[nodiscard]] inline EndConditionalCommand endConditional(const ContextHandle& context) {
+    return EndConditionalCommand(context);
+}
+
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <filesystem>
 #include <span>
 #include <string>
 #include <string_view>
@@ -22,6 +25,278 @@ struct DeviceInfo {
      * @brief Wether the device is a discrete GPU
     */
     bool isDiscrete;
+    /**
+     * @brief Name of the vendor, e.g. "NVIDIA". "Unknown" if not recognized.
+    */
+    std::string vendor;
+    /**
+     * @brief PCI vendor id of the device
+    */
+    uint32_t vendorID;
+    /**
+     * @brief Vendor specific id of the device
+    */
+    uint32_t deviceID;
+    /**
+     * @brief Universally unique identifier of the device
+     *
+     * Stays the same across processes and APIs, e.g. to match the device
+     * with one used by another library.
+    */
+    std::array<uint8_t, 16> uuid;
+    /**
+     * @brief Vendor specific encoded version of the driver
+    */
+    uint32_t driverVersion;
+    /**
+     * @brief Name and version of the driver as reported by it
+    */
+    std::string driverInfo;
+    /**
+     * @brief Size of the largest device local memory heap in bytes
+     *
+     * For integrated devices this is usually shared with the host.
+    */
+    uint64_t deviceMemory;
+    /**
+     * @brief Amount of compute units (AMD) or streaming multiprocessors
+     *        (NVIDIA). Zero if the device does not report it.
+    */
+    uint32_t computeUnits;
+    /**
+     * @brief Default amount of invocations in a subgroup
+    */
+    uint32_t subgroupSize;
+    /**
+     * @brief Maximum amount of invocations in a single work group
+    */
+    uint32_t maxWorkGroupInvocations;
+    /**
+     * @brief Maximum amount of shared memory per work group in bytes
+    */
+    uint32_t maxSharedMemorySize;
+};
+
+/**
+ * @brief Limits of a device relevant for sizing work and resources
+*/
+struct DeviceLimits {
+    /**
+     * @brief Maximum amount of work groups in a single dispatch per dimension
+     *
+     * Dispatches exceeding it get split automatically at the cost of extra
+     * commands.
+    */
+    std::array<uint32_t, 3> maxWorkGroupCount;
+    /**
+     * @brief Maximum local size of a work group per dimension
+    */
+    std::array<uint32_t, 3> maxWorkGroupSize;
+    /**
+     * @brief Maximum amount of invocations in a single work group
+    */
+    uint32_t maxWorkGroupInvocations;
+    /**
+     * @brief Maximum amount of shared memory per work group in bytes
+    */
+    uint32_t maxSharedMemorySize;
+    /**
+     * @brief Maximum size in bytes a single tensor binding can span
+    */
+    uint32_t maxStorageBufferRange;
+    /**
+     * @brief Maximum size in bytes of a single uniform buffer binding
+    */
+    uint32_t maxUniformBufferRange;
+    /**
+     * @brief Maximum size of push constants in bytes
+    */
+    uint32_t maxPushConstantsSize;
+    /**
+     * @brief Maximum size of a single allocation in bytes
+     *
+     * Drivers may fail larger allocations even if enough memory is available.
+    */
+    uint64_t maxMemoryAllocationSize;
+    /**
+     * @brief Size in bytes of each memory heap of the device
+    */
+    std::vector<uint64_t> heapSizes;
+    /**
+     * @brief Nanoseconds per timestamp tick
+    */
+    float timestampPeriod;
+};
+
+/**
+ * @brief Memory usage of a single memory heap
+*/
+struct HeapStatistics {
+    /**
+     * @brief Wether the heap is local to the device, i.e. backs tensors
+    */
+    bool deviceLocal;
+    /**
+     * @brief Size of the heap in bytes
+    */
+    uint64_t size;
+    /**
+     * @brief Bytes currently used by this process, including overhead
+    */
+    uint64_t usage;
+    /**
+     * @brief Estimated bytes this process can use before allocations start
+     *        to fail or degrade performance
+     *
+     * @note Only accurate if isMemoryBudgetSupported() returns true,
+     *       otherwise a heuristic based on the heap size.
+    */
+    uint64_t budget;
+    /**
+     * @brief Number of device memory blocks allocated from the heap
+    */
+    uint32_t blockCount;
+    /**
+     * @brief Bytes allocated in device memory blocks
+    */
+    uint64_t blockBytes;
+    /**
+     * @brief Number of resources occupying the heap's blocks
+    */
+    uint32_t allocationCount;
+    /**
+     * @brief Bytes occupied by resources inside the heap's blocks
+    */
+    uint64_t allocationBytes;
+    /**
+     * @brief Size of the largest free range inside any existing block
+    */
+    uint64_t largestFreeRange;
+};
+/**
+ * @brief Memory usage of a context
+*/
+struct MemoryStatistics {
+    /**
+     * @brief Statistics per memory heap of the device
+    */
+    std::vector<HeapStatistics> heaps;
+    /**
+     * @brief Total number of device memory blocks
+    */
+    uint32_t blockCount;
+    /**
+     * @brief Total bytes allocated in device memory blocks
+    */
+    uint64_t blockBytes;
+    /**
+     * @brief Total number of resources
+    */
+    uint32_t allocationCount;
+    /**
+     * @brief Total bytes occupied by resources
+    */
+    uint64_t allocationBytes;
+};
+
+/**
+ * @brief Live resource recorded by the resource tracking of a context
+ *
+ * @see setResourceTracking()
+*/
+struct ResourceInfo {
+    /**
+     * @brief Type of the resource, e.g. "Tensor" or "Program". Resources
+     *        without dedicated accounting are reported as "Resource".
+    */
+    std::string type;
+    /**
+     * @brief Size of the resource's memory in bytes. Zero if unknown.
+    */
+    uint64_t size;
+    /**
+     * @brief Tag assigned via setResourceTag(). Empty if none.
+    */
+    std::string tag;
+};
+
+/**
+ * @brief Counters of the work issued on a context
+ *
+ * All counters start at zero on context creation and only increase, i.e.
+ * rates can be derived by sampling them periodically.
+ *
+ * @see getContextStatistics()
+*/
+struct ContextStatistics {
+    /**
+     * @brief Number of submissions to any queue of the context
+    */
+    uint64_t submissions;
+    /**
+     * @brief Total number of command buffers across all submissions
+    */
+    uint64_t commandBuffers;
+    /**
+     * @brief Number of one time submits, i.e. execute() and its variants
+     *        including the ones issued internally, e.g. by Tensor::update()
+    */
+    uint64_t oneTimeSubmits;
+    /**
+     * @brief Bytes transferred from host to device memory
+     *
+     * Includes recorded update commands as well as direct updates of
+     * tensors and images.
+    */
+    uint64_t bytesUploaded;
+    /**
+     * @brief Bytes transferred from device to host memory
+     *
+     * Includes recorded retrieve commands as well as direct retrieves of
+     * tensors.
+    */
+    uint64_t bytesDownloaded;
+    /**
+     * @brief Number of dispatches recorded, including indirect ones
+    */
+    uint64_t dispatches;
+    /**
+     * @brief Number of pipeline barriers recorded
+    */
+    uint64_t barriers;
+    /**
+     * @brief Number of pipelines found in the pipeline cache
+     *
+     * Requires VK_EXT_pipeline_creation_feedback. Otherwise stays zero.
+    */
+    uint64_t pipelineCacheHits;
+    /**
+     * @brief Number of pipelines the driver had to compile
+     *
+     * Requires VK_EXT_pipeline_creation_feedback. Otherwise stays zero.
+    */
+    uint64_t pipelineCacheMisses;
+};
+
+/**
+ * @brief Type of queue work is submitted to
+ * 
+ * Contexts request additional queues if the device supports them. Work
+ * targeting a type without dedicated queue runs on the main queue instead.
+*/
+enum class QueueType {
+    /**
+     * @brief Main queue supporting compute and transfer
+    */
+    MAIN,
+    /**
+     * @brief Queue restricted to transfer, usually backed by DMA engines
+    */
+    TRANSFER,
+    /**
+     * @brief Additional queue supporting compute and transfer
+    */
+    COMPUTE
 };
 
 /**
@@ -74,6 +349,14 @@ protected:
 
     Resource(ContextHandle context);
 
+    /**
+     * @brief Sets the type and size reported by the resource tracking
+     *
+     * @param type Type of the resource. Must be a string literal.
+     * @param size Size of the resource's memory in bytes
+    */
+    void trackResource(const char* type, uint64_t size);
+
 private:
     ContextHandle context;
 };
@@ -110,12 +393,462 @@ private:
  * @brief Returns information about the device used to create the given context
 */
 [[nodiscard]] HEPHAISTOS_API DeviceInfo getDeviceInfo(const ContextHandle& context);
+/**
+ * @brief Returns the limits of the given device
+*/
+[[nodiscard]] HEPHAISTOS_API DeviceLimits getDeviceLimits(const DeviceHandle& device);
+/**
+ * @brief Returns the limits of the device used to create the given context
+*/
+[[nodiscard]] HEPHAISTOS_API DeviceLimits getDeviceLimits(const ContextHandle& context);
+
+/**
+ * @brief Queries wether the context has a dedicated queue of the given type
+ * 
+ * @note The main queue is always dedicated
+*/
+[[nodiscard]] HEPHAISTOS_API bool hasDedicatedQueue(
+    const ContextHandle& context, QueueType type);
+
+/**
+ * @brief System wide scheduling priority of a context's queues
+ *
+ * Unlike the priority between queues of the same context, the global
+ * priority is respected by the driver across processes, i.e. work of a
+ * context with a higher priority may preempt work of other applications.
+*/
+enum class QueuePriority {
+    /**
+     * @brief Background work yielding to everything else
+    */
+    LOW,
+    /**
+     * @brief Default priority of every queue
+    */
+    MEDIUM,
+    /**
+     * @brief Latency sensitive work
+     *
+     * @note May require elevated privileges depending on the system
+    */
+    HIGH,
+    /**
+     * @brief Work that must not be delayed by any other work
+     *
+     * @note Usually requires elevated privileges
+    */
+    REALTIME
+};
+
+/**
+ * @brief Checks wether the device supports setting the global queue priority
+ *
+ * @param device Device to check
+ * @return True, if VK_KHR_global_priority or VK_EXT_global_priority is
+ *         supported, false otherwise
+*/
+[[nodiscard]] HEPHAISTOS_API bool isQueuePrioritySupported(const DeviceHandle& device);
+/**
+ * @brief Returns the global priority of the given context's queues
+ *
+ * Might be lower than requested if the process lacks the privileges for the
+ * requested one, in which case the context falls back to MEDIUM.
+*/
+[[nodiscard]] HEPHAISTOS_API QueuePriority getQueuePriority(const ContextHandle& context);
+/**
+ * @brief Creates an extension setting the global priority of all queues
+ *
+ * Returns an extension which can be passed during the creation of a context
+ * to schedule its work with the given priority relative to other
+ * applications using the same device.
+ *
+ * @param priority Global priority of the context's queues
+ * @return Extension for setting the queue priority
+*/
+[[nodiscard]] HEPHAISTOS_API ExtensionHandle createQueuePriorityExtension(QueuePriority priority);
+
+/**
+ * @brief Preferred placement of memory allocations
+*/
+enum class MemoryPlacement {
+    /**
+     * @brief Lets the allocator decide based on the usage
+    */
+    AUTO = 0,
+    /**
+     * @brief Prefers memory local to the device
+    */
+    PREFER_DEVICE = 1,
+    /**
+     * @brief Prefers memory residing on the host
+    */
+    PREFER_HOST = 2
+};
+
+/**
+ * @brief Hints for allocating memory of tensors and images
+*/
+struct AllocationHints {
+    /**
+     * @brief Priority in the range [0,1] of keeping the memory resident
+     *
+     * Allocations with a lower priority get paged out first if the device
+     * runs out of memory. Only has an effect if isMemoryPrioritySupported()
+     * returns true. Allocations with a non default priority are dedicated.
+    */
+    float priority = 0.5f;
+    /**
+     * @brief Preferred placement of the memory
+    */
+    MemoryPlacement placement = MemoryPlacement::AUTO;
+    /**
+     * @brief If true, the allocation gets its own memory block
+    */
+    bool dedicated = false;
+};
+
+/**
+ * @brief Queries wether the context supports memory priorities
+ *
+ * Uses VK_EXT_memory_priority if supported by the device. Otherwise,
+ * AllocationHints::priority is ignored.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isMemoryPrioritySupported(const ContextHandle& context);
+
+/**
+ * @brief Queries wether the context tracks memory budgets reported by the driver
+ *
+ * Uses VK_EXT_memory_budget if supported by the device. Otherwise budgets
+ * returned by getMemoryStatistics() are estimated from the heap sizes.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isMemoryBudgetSupported(const ContextHandle& context);
+/**
+ * @brief Queries wether the device local memory is directly accessible by the host
+ *
+ * True if the device is integrated or supports resizable BAR, i.e. mapped
+ * tensors reside in device local memory without extra copies.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isUnifiedMemorySupported(const ContextHandle& context);
+/**
+ * @brief Returns the current memory usage and budget of the given context
+ *
+ * Can be used to size work to fit into the remaining memory, i.e. budget
+ * minus usage of the device local heaps.
+ *
+ * @note Collecting the statistics iterates all allocations and thus should
+ *       not be done too frequently.
+*/
+[[nodiscard]] HEPHAISTOS_API MemoryStatistics getMemoryStatistics(const ContextHandle& context);
+/**
+ * @brief Returns the counters of the work issued on the given context
+ *
+ * Counters are updated using relaxed atomics and thus are cheap enough to
+ * be always enabled. Counters read while other threads issue work may be
+ * slightly out of sync with each other.
+*/
+[[nodiscard]] HEPHAISTOS_API ContextStatistics getContextStatistics(const ContextHandle& context);
+
+/**
+ * @brief Enables or disables deferred destruction of resources
+ *
+ * While enabled, destroying a resource like a Tensor, Image, Program or
+ * Subroutine does not destroy its Vulkan objects right away, but retires
+ * them until all work submitted on the context before finished. Retired
+ * resources are destroyed lazily on later submissions or destructions, or
+ * when calling collectRetiredResources(). Thus resources still used by work
+ * in flight can be dropped without waiting on it.
+ *
+ * @note Memory of retired resources stays allocated until they are destroyed
+ * @note Only work submitted while enabled is waited on, thus enable it before
+ *       submitting work using resources that might get dropped early.
+ *
+ * @param context Context on which to defer destruction
+ * @param enable True, if destruction should be deferred
+*/
+HEPHAISTOS_API void setDeferredDestruction(const ContextHandle& context, bool enable);
+/**
+ * @brief Checks whether the given context defers the destruction of resources
+*/
+[[nodiscard]] HEPHAISTOS_API bool isDeferredDestructionEnabled(const ContextHandle& context);
+/**
+ * @brief Destroys retired resources whose work has finished
+ *
+ * @return Amount of retired resources still waiting on work
+*/
+HEPHAISTOS_API size_t collectRetiredResources(const ContextHandle& context);
+
+/**
+ * @brief Sets how long waits poll before blocking
+ *
+ * Blocking waits put the thread to sleep, which on some drivers takes
+ * hundreds of microseconds to wake up again once the work finished. Waiting
+ * on timelines, submissions and execute() instead polls for up to the given
+ * time before falling back to a blocking wait, trading CPU time for latency.
+ *
+ * @param context Context whose waits to change
+ * @param nanoseconds Time to poll before blocking. Zero blocks right away.
+*/
+HEPHAISTOS_API void setWaitSpinTime(const ContextHandle& context, uint64_t nanoseconds);
+/**
+ * @brief Returns how long waits on the given context poll before blocking
+*/
+[[nodiscard]] HEPHAISTOS_API uint64_t getWaitSpinTime(const ContextHandle& context);
+
+/**
+ * @brief Robustness of buffer accesses inside programs
+*/
+enum class BufferRobustness {
+    /**
+     * @brief Follows the device, i.e. DebugOptions::enableRobustBufferAccess
+    */
+    DEFAULT,
+    /**
+     * @brief Out of bounds accesses are undefined
+    */
+    DISABLED,
+    /**
+     * @brief Out of bounds accesses are bounds checked
+    */
+    ENABLED
+};
+/**
+ * @brief Checks whether programs can override the device's robustness
+ *
+ * Requires VK_EXT_pipeline_robustness.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isProgramRobustnessSupported(const ContextHandle& context);
+/**
+ * @brief Sets the robustness of programs created afterwards
+ *
+ * Allows disabling bounds checks for validated programs while keeping them
+ * for the rest, or the other way around. Programs keep the robustness they
+ * were created with, while reloading a program applies the current one.
+ * Programs using shader objects always follow the device.
+ *
+ * @param context Context on which to set the robustness
+ * @param robustness Robustness of storage and uniform buffer accesses
+ * @throws std::runtime_error if overriding the robustness is not supported
+*/
+HEPHAISTOS_API void setProgramRobustness(const ContextHandle& context, BufferRobustness robustness);
+/**
+ * @brief Returns the robustness of programs created on the given context
+*/
+[[nodiscard]] HEPHAISTOS_API BufferRobustness getProgramRobustness(const ContextHandle& context);
+
+/**
+ * @brief Sets whether programs created afterwards bind cached descriptor sets
+ *
+ * By default, programs push their parameters on each dispatch, which some
+ * drivers, e.g. MoltenVK, handle slower than binding already written
+ * descriptor sets. If enabled, programs instead write each unique combination
+ * of bound parameters once into a descriptor set allocated from pools they
+ * own and bind it on later dispatches. Programs with more descriptors than
+ * the device can push always use cached sets. Programs keep the mode they
+ * were created with, while reloading a program applies the current one.
+ *
+ * @note Cached sets stay allocated until the program gets destroyed, while
+ *       destroying any resource on the context invalidates them, as their
+ *       handles might get reused. Thus, this suits programs dispatched
+ *       repeatedly with the same long living resources.
+ *
+ * @param context Context on which to set the mode
+ * @param enable True, if programs should use cached descriptor sets
+*/
+HEPHAISTOS_API void setDescriptorSetCache(const ContextHandle& context, bool enable);
+/**
+ * @brief Checks whether programs created on the given context use cached
+ *        descriptor sets
+*/
+[[nodiscard]] HEPHAISTOS_API bool isDescriptorSetCacheEnabled(const ContextHandle& context);
+
+/**
+ * @brief Float controls programs on a context can request
+ *
+ * Tells which of the float options in CompileOptions the device supports.
+*/
+struct FloatControlsProperties {
+    /**
+     * @brief True, if 16 bit denormalized floats can be flushed to zero
+    */
+    bool denormFlushToZeroFloat16;
+    /**
+     * @brief True, if 32 bit denormalized floats can be flushed to zero
+    */
+    bool denormFlushToZeroFloat32;
+    /**
+     * @brief True, if 64 bit denormalized floats can be flushed to zero
+    */
+    bool denormFlushToZeroFloat64;
+    /**
+     * @brief True, if 16 bit denormalized floats can be preserved
+    */
+    bool denormPreserveFloat16;
+    /**
+     * @brief True, if 32 bit denormalized floats can be preserved
+    */
+    bool denormPreserveFloat32;
+    /**
+     * @brief True, if 64 bit denormalized floats can be preserved
+    */
+    bool denormPreserveFloat64;
+    /**
+     * @brief True, if programs can allow fast math
+     *
+     * Requires VK_KHR_shader_float_controls2, which gets enabled if supported.
+    */
+    bool fastMath;
+};
+/**
+ * @brief Queries the float controls supported by the given context
+*/
+[[nodiscard]] HEPHAISTOS_API FloatControlsProperties getFloatControlsProperties(const ContextHandle& context);
+
+/**
+ * @brief Features of the Vulkan memory model enabled on a context
+ *
+ * The memory model allows fine-grained synchronization between invocations
+ * and workgroups via scoped atomics, barriers and acquire/release semantics
+ * of GL_KHR_memory_scope_semantics. Programs opt in by compiling with
+ * CompileOptions::vulkanMemoryModel.
+*/
+struct MemoryModelFeatures {
+    /**
+     * @brief True, if the Vulkan memory model is enabled
+    */
+    bool vulkanMemoryModel;
+    /**
+     * @brief True, if synchronization can use device scope
+     *
+     * Required to synchronize invocations of different workgroups, e.g. in
+     * single pass reductions or scans.
+    */
+    bool deviceScope;
+    /**
+     * @brief True, if availability and visibility operations can be chained
+    */
+    bool availabilityVisibilityChains;
+};
+/**
+ * @brief Queries the features of the Vulkan memory model enabled on the
+ *        given context
+ *
+ * Contexts enable all features of the memory model the device supports.
+*/
+[[nodiscard]] HEPHAISTOS_API MemoryModelFeatures getMemoryModelFeatures(const ContextHandle& context);
+
+/**
+ * @brief Enables or disables the accounting of live resources
+ *
+ * While enabled, the context records every resource created on it together
+ * with its type and size until it gets destroyed. Resources created before
+ * enabling it are not recorded. Disabling it discards all records.
+ *
+ * @param context Context on which to track resources
+ * @param enable True, if resources should be tracked
+*/
+HEPHAISTOS_API void setResourceTracking(const ContextHandle& context, bool enable);
+/**
+ * @brief Checks whether the given context tracks its live resources
+*/
+[[nodiscard]] HEPHAISTOS_API bool isResourceTrackingEnabled(const ContextHandle& context);
+/**
+ * @brief Assigns a tag to the resource shown in resource reports
+ *
+ * Does nothing if the resource is not tracked.
+ *
+ * @param resource Resource to tag
+ * @param tag Tag identifying the resource, e.g. where it was created
+*/
+HEPHAISTOS_API void setResourceTag(const Resource& resource, std::string_view tag);
+/**
+ * @brief Returns the live resources tracked by the given context
+ *
+ * @return List of live resources in order of creation
+*/
+[[nodiscard]] HEPHAISTOS_API std::vector<ResourceInfo> getLiveResources(const ContextHandle& context);
+/**
+ * @brief Creates a human readable report of the live resources
+ *
+ * Summarizes the tracked resources by type followed by a list of each one.
+ * Since resources keep their context alive, calling this right before
+ * releasing the last handle to the context reports all leaked resources.
+ *
+ * @param context Context to report on
+ * @return Report as multi line string
+*/
+[[nodiscard]] HEPHAISTOS_API std::string dumpResources(const ContextHandle& context);
+
+/**
+ * @brief Loads pipeline cache data from the given file into the context
+ *
+ * Merges previously saved data into the context's pipeline cache, so the
+ * driver can skip compiling programs it already compiled in earlier runs.
+ * Data created by a different driver or device is ignored.
+ *
+ * @param context Context to load the pipeline cache into
+ * @param path File containing data saved by savePipelineCache()
+ * @return True, if the data was loaded, false if the file does not exist or
+ *         its data is not compatible with the device.
+*/
+HEPHAISTOS_API bool loadPipelineCache(
+    const ContextHandle& context, const std::filesystem::path& path);
+/**
+ * @brief Saves the pipeline cache data of the context to the given file
+ *
+ * Throws if the file could not be written.
+ *
+ * @param context Context whose pipeline cache to save
+ * @param path File to write the data to. Gets replaced if it exists.
+*/
+HEPHAISTOS_API void savePipelineCache(
+    const ContextHandle& context, const std::filesystem::path& path);
+/**
+ * @brief Persists the pipeline cache of the context in the given file
+ *
+ * Loads the file's data if present, and writes the cache back to it once
+ * the context gets destroyed. Passing an empty path disables writing it back.
+ *
+ * @param context Context whose pipeline cache to persist
+ * @param path File to persist the pipeline cache in
+ * @return True, if existing data was loaded from the file
+*/
+HEPHAISTOS_API bool setPipelineCacheFile(
+    const ContextHandle& context, const std::filesystem::path& path);
+/**
+ * @brief Returns the file the pipeline cache is persisted in
+ *
+ * Empty if setPipelineCacheFile() was not called.
+*/
+[[nodiscard]] HEPHAISTOS_API std::filesystem::path getPipelineCacheFile(
+    const ContextHandle& context);
+/**
+ * @brief Merges the pipeline cache of one context into another one
+ *
+ * Allows contexts on identical devices to skip compiling programs the other
+ * one already compiled. Data of a different driver or device is ignored.
+ *
+ * @param source Context whose pipeline cache to copy
+ * @param destination Context to merge the pipeline cache into
+ * @return True, if the data was merged, false if the devices are not
+ *         compatible.
+*/
+HEPHAISTOS_API bool sharePipelineCache(
+    const ContextHandle& source, const ContextHandle& destination);
 
 /**
  * @brief Creates a new context
  * 
  * Creates a new context on a device that supports all demanded extensions.
- * Throws if no suitable device is available. Prefers discrete devices.
+ * Throws if no suitable device is available. Prefers discrete devices and
+ * among them the one with the most compute throughput, i.e. compute units
+ * times subgroup size, followed by the most device memory.
+ *
+ * Contexts are internally synchronized and can be shared by multiple
+ * threads, e.g. to record and submit work or create and destroy resources
+ * concurrently. This avoids duplicating memory and pipelines per thread.
+ * Individual objects created on a context, e.g. a Program or a
+ * SequenceBuilder, are not synchronized and must not be used by multiple
+ * threads at the same time.
  * 
  * @param extensions Extensions to enable
  * @return Handle to newly created context
@@ -134,6 +867,34 @@ private:
 */
 [[nodiscard]] HEPHAISTOS_API ContextHandle createContext(
     const DeviceHandle& device, std::span<ExtensionHandle> extensions = {});
+/**
+ * @brief Creates a context sharing the device of an existing one
+ *
+ * The new context uses the same device, memory allocator and pipeline cache
+ * as the given one, but has its own command pools, staging memory, buffer
+ * pools and statistics. This allows independent libraries within the same
+ * process to work on the same device without splitting its memory across
+ * allocators or compiling the same pipelines twice. Resources can be used
+ * on any context sharing their device, e.g. copied between them or bound to
+ * programs of the other one.
+ *
+ * The extensions of the given context are enabled on the new one too. As the
+ * queues of a device are fixed when it is created, shared contexts submit to
+ * the queues of the original context. The original context is kept alive
+ * until all contexts sharing its device are destroyed.
+ *
+ * @param context Context whose device to share
+ * @return Handle to newly created context
+*/
+[[nodiscard]] HEPHAISTOS_API ContextHandle createSharedContext(const ContextHandle& context);
+/**
+ * @brief Checks whether both contexts share the same device
+ *
+ * True, if both are the same context or share their device via
+ * createSharedContext().
+*/
+[[nodiscard]] HEPHAISTOS_API bool isSharingDevice(
+    const ContextHandle& first, const ContextHandle& second);
 
 /**
  * @brief Creates an empty context
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "hephaistos/context.hpp"
+#include "hephaistos/handles.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief Type of the components of a cooperative matrix
+*/
+enum class ComponentType {
+    FLOAT16 = 0,
+    FLOAT32 = 1,
+    FLOAT64 = 2,
+    SINT8 = 3,
+    SINT16 = 4,
+    SINT32 = 5,
+    SINT64 = 6,
+    UINT8 = 7,
+    UINT16 = 8,
+    UINT32 = 9,
+    UINT64 = 10
+};
+
+/**
+ * @brief Scope of threads sharing a cooperative matrix
+*/
+enum class MatrixScope {
+    DEVICE = 1,
+    WORKGROUP = 2,
+    SUBGROUP = 3,
+    QUEUE_FAMILY = 5
+};
+
+/**
+ * @brief Matrix multiply-add configuration supported by the device
+ *
+ * Describes a supported operation Result = A * B + C, where A is a MxK, B a
+ * KxN and both C and Result MxN matrices.
+*/
+struct CooperativeMatrixProperties {
+    /**
+     * @brief Amount of rows of A, C and Result
+    */
+    uint32_t MSize;
+    /**
+     * @brief Amount of columns of B, C and Result
+    */
+    uint32_t NSize;
+    /**
+     * @brief Amount of columns of A and rows of B
+    */
+    uint32_t KSize;
+    /**
+     * @brief Component type of A
+    */
+    ComponentType AType;
+    /**
+     * @brief Component type of B
+    */
+    ComponentType BType;
+    /**
+     * @brief Component type of C
+    */
+    ComponentType CType;
+    /**
+     * @brief Component type of Result
+    */
+    ComponentType ResultType;
+    /**
+     * @brief Wether the operation saturates instead of wrapping around
+    */
+    bool saturatingAccumulation;
+    /**
+     * @brief Scope of threads sharing the matrices
+    */
+    MatrixScope scope;
+};
+
+/**
+ * @brief Returns the cooperative matrix configurations the device supports
+ *
+ * @param device Device to query
+ * @return List of supported configurations. Empty if cooperative matrices
+ *         are not supported.
+*/
+[[nodiscard]] HEPHAISTOS_API std::vector<CooperativeMatrixProperties>
+    getCooperativeMatrixProperties(const DeviceHandle& device);
+
+/**
+ * @brief Checks for cooperative matrix support
+ *
+ * Cooperative matrices allow programs to use dedicated matrix hardware, e.g.
+ * tensor cores, via GL_KHR_cooperative_matrix.
+ *
+ * @param device Handle to device to be checked for cooperative matrix support
+ * @return True, if the given device supports cooperative matrices, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isCooperativeMatrixSupported(const DeviceHandle& device);
+/**
+ * @brief Checks wether cooperative matrices are enabled
+ *
+ * @param context Context to check
+ * @return True, if cooperative matrices are enabled in the given context, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isCooperativeMatrixEnabled(const ContextHandle& context);
+
+/**
+ * @brief Creates a cooperative matrix extension
+ *
+ * Returns an extension which can be passed during the creation of a context to
+ * enable cooperative matrices in programs. Also enables the Vulkan memory
+ * model required by GL_KHR_memory_scope_semantics.
+ *
+ * @return Extension for enabling cooperative matrices
+*/
+[[nodiscard]] HEPHAISTOS_API ExtensionHandle createCooperativeMatrixExtension();
+
+}
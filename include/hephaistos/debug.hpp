@@ -1,13 +1,22 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <functional>
+#include <string>
+#include <string_view>
 #include <type_traits>
 
+#include "hephaistos/buffer.hpp"
+#include "hephaistos/command.hpp"
 #include "hephaistos/config.hpp"
+#include "hephaistos/handles.hpp"
 
 namespace hephaistos {
 
+class Image;
+class Program;
+
 /**
  * @brief Flags indicating debug message severity
 */
@@ -79,6 +88,16 @@ struct DebugOptions {
 	 * @brief Enables validation of the Vulkan API usage
 	*/
 	bool enableAPIValidation = false;
+
+	/**
+	 * @brief Enables robust buffer access on contexts created afterwards
+	 *
+	 * Out of bounds accesses of buffers are bounds checked instead of
+	 * undefined, using robustBufferAccess2 if available. Costs performance
+	 * on some devices, thus intended for development only.
+	 * See isRobustBufferAccessEnabled().
+	*/
+	bool enableRobustBufferAccess = false;
 };
 
 /**
@@ -102,4 +121,192 @@ HEPHAISTOS_API void configureDebug(
 	DebugOptions options,
 	DebugCallback callback = nullptr);
 
+/**
+ * @brief Enables debug labels and object names
+ *
+ * Enables VK_EXT_debug_utils if the system supports it without requiring the
+ * validation layers, so labels and names show up in external tools like
+ * RenderDoc, Nsight or RGP. Configuring debug via configureDebug() enables
+ * them too.
+ *
+ * @note This only takes effect if called before any other function
+ *       except isDebugAvailable() and isVulkanAvailable()
+*/
+HEPHAISTOS_API void enableDebugLabels();
+/**
+ * @brief Checks whether debug labels and object names are enabled
+ *
+ * If not, label commands and setDebugName() are no-ops.
+ *
+ * @param context Context to check
+ * @return True, if debug labels are enabled in the given context
+*/
+[[nodiscard]] HEPHAISTOS_API bool isDebugLabelsEnabled(const ContextHandle& context);
+
+/**
+ * @brief Checks whether the given context accesses buffers robustly
+ *
+ * Enabled via DebugOptions::enableRobustBufferAccess if the device supports
+ * it. Programs may still opt out via setProgramRobustness().
+ *
+ * @param context Context to check
+ * @return True, if robust buffer access is enabled in the given context
+*/
+[[nodiscard]] HEPHAISTOS_API bool isRobustBufferAccessEnabled(const ContextHandle& context);
+
+/**
+ * @brief Command opening a labeled region of commands
+ *
+ * Regions can be nested and must be closed by an EndLabelCommand within the
+ * same step of a sequence or the same subroutine. Does nothing if debug labels
+ * are not enabled.
+*/
+class HEPHAISTOS_API BeginLabelCommand : public Command {
+public:
+	/**
+	 * @brief Context on which the label is recorded
+	*/
+	std::reference_wrapper<const vulkan::Context> context;
+	/**
+	 * @brief Name of the region
+	*/
+	std::string name;
+	/**
+	 * @brief Optional RGBA color of the region. All zero if unused.
+	*/
+	std::array<float, 4> color;
+
+	void record(vulkan::Command& cmd) const override;
+
+	BeginLabelCommand(const BeginLabelCommand&);
+	BeginLabelCommand& operator=(const BeginLabelCommand&);
+
+	/**
+	 * @brief Creates a new BeginLabelCommand
+	 *
+	 * @param context Context on which the label is recorded
+	 * @param name Name of the region
+	 * @param color Optional RGBA color of the region
+	*/
+	BeginLabelCommand(const ContextHandle& context,
+		std::string_view name, std::array<float, 4> color = {});
+	~BeginLabelCommand() override;
+};
+/**
+ * @brief Creates a new BeginLabelCommand
+ *
+ * @param context Context on which the label is recorded
+ * @param name Name of the region
+ * @param color Optional RGBA color of the region
+ * @return BeginLabelCommand opening the region on being recorded
+*/
+[[nodiscard]] inline BeginLabelCommand beginLabel(const ContextHandle& context,
+	std::string_view name, std::array<float, 4> color = {}
+) {
+	return BeginLabelCommand(context, name, color);
+}
+
+/**
+ * @brief Command closing the innermost labeled region
+*/
+class HEPHAISTOS_API EndLabelCommand : public Command {
+public:
+	/**
+	 * @brief Context on which the label was recorded
+	*/
+	std::reference_wrapper<const vulkan::Context> context;
+
+	void record(vulkan::Command& cmd) const override;
+
+	EndLabelCommand(const EndLabelCommand&);
+	EndLabelCommand& operator=(const EndLabelCommand&);
+
+	/**
+	 * @brief Creates a new EndLabelCommand
+	 *
+	 * @param context Context on which the label was recorded
+	*/
+	explicit EndLabelCommand(const ContextHandle& context);
+	~EndLabelCommand() override;
+};
+/**
+ * @brief Creates a new EndLabelCommand
+ *
+ * @param context Context on which the label was recorded
+ * @return EndLabelCommand closing the region on being recorded
+*/
+[[nodiscard]] inline EndLabelCommand endLabel(const ContextHandle& context) {
+	return EndLabelCommand(context);
+}
+
+/**
+ * @brief Command inserting a single label between commands
+*/
+class HEPHAISTOS_API InsertLabelCommand : public Command {
+public:
+	/**
+	 * @brief Context on which the label is recorded
+	*/
+	std::reference_wrapper<const vulkan::Context> context;
+	/**
+	 * @brief Text of the label
+	*/
+	std::string name;
+	/**
+	 * @brief Optional RGBA color of the label. All zero if unused.
+	*/
+	std::array<float, 4> color;
+
+	void record(vulkan::Command& cmd) const override;
+
+	InsertLabelCommand(const InsertLabelCommand&);
+	InsertLabelCommand& operator=(const InsertLabelCommand&);
+
+	/**
+	 * @brief Creates a new InsertLabelCommand
+	 *
+	 * @param context Context on which the label is recorded
+	 * @param name Text of the label
+	 * @param color Optional RGBA color of the label
+	*/
+	InsertLabelCommand(const ContextHandle& context,
+		std::string_view name, std::array<float, 4> color = {});
+	~InsertLabelCommand() override;
+};
+/**
+ * @brief Creates a new InsertLabelCommand
+ *
+ * @param context Context on which the label is recorded
+ * @param name Text of the label
+ * @param color Optional RGBA color of the label
+ * @return InsertLabelCommand inserting the label on being recorded
+*/
+[[nodiscard]] inline InsertLabelCommand insertLabel(const ContextHandle& context,
+	std::string_view name, std::array<float, 4> color = {}
+) {
+	return InsertLabelCommand(context, name, color);
+}
+
+/**
+ * @brief Names the program's pipeline and shader in external tools
+ *
+ * Does nothing if debug labels are not enabled.
+ *
+ * @note Reloading the program's code replaces the named handles.
+*/
+HEPHAISTOS_API void setDebugName(const Program& program, std::string_view name);
+/**
+ * @brief Names the tensor's buffer in external tools
+ *
+ * Does nothing if debug labels are not enabled or the tensor is sub-allocated
+ * from a pooled buffer shared with other tensors.
+*/
+HEPHAISTOS_API void setDebugName(const Tensor<std::byte>& tensor, std::string_view name);
+/**
+ * @brief Names the image and its view in external tools
+ *
+ * Does nothing if debug labels are not enabled.
+*/
+HEPHAISTOS_API void setDebugName(const Image& image, std::string_view name);
+
 }
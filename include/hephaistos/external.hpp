@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cstdint>
+
+#include "hephaistos/buffer.hpp"
+#include "hephaistos/command.hpp"
+#include "hephaistos/context.hpp"
+#include "hephaistos/handles.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief Checks for external memory support
+ *
+ * External memory allows sharing tensors and timelines with other APIs,
+ * e.g. CUDA, without copying them through the host.
+ *
+ * @param device Handle to device to be checked for external memory support
+ * @return True, if the given device supports external memory, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isExternalMemorySupported(const DeviceHandle& device);
+/**
+ * @brief Checks wether external memory is enabled
+ *
+ * @param context Context to check
+ * @return True, if external memory is enabled in the given context, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isExternalMemoryEnabled(const ContextHandle& context);
+
+/**
+ * @brief Creates an external memory extension
+ *
+ * Returns an extension which can be passed during the creation of a context to
+ * enable exporting tensors and timelines.
+ *
+ * @return Extension for enabling external memory
+*/
+[[nodiscard]] HEPHAISTOS_API ExtensionHandle createExternalMemoryExtension();
+
+/**
+ * @brief Native handle of exported memory or semaphores
+ *
+ * File descriptor on Linux, HANDLE on Windows. The receiver owns the handle
+ * and is responsible for closing it, e.g. by importing it.
+*/
+using ExternalHandle = int64_t;
+
+/**
+ * @brief Exported memory of a tensor
+*/
+struct ExternalMemory {
+    /**
+     * @brief Native handle to the exported memory
+    */
+    ExternalHandle handle;
+    /**
+     * @brief Size of the exported memory in bytes
+     *
+     * @note May be larger than the tensor.
+    */
+    uint64_t size;
+    /**
+     * @brief Offset in bytes of the tensor into the exported memory
+    */
+    uint64_t offset;
+};
+
+/**
+ * @brief Allocates a new tensor whose memory can be exported
+ *
+ * The tensor gets its own dedicated allocation, which is required by most
+ * importers, e.g. CUDA's cudaExternalMemoryDedicated.
+ *
+ * @param context Context onto which to create the tensor
+ * @param size Size of the tensor in bytes
+ * @return Exportable tensor
+*/
+[[nodiscard]] HEPHAISTOS_API Tensor<std::byte> createExportableTensor(
+    const ContextHandle& context, uint64_t size);
+/**
+ * @brief Exports the memory of the given tensor
+ *
+ * Each call creates a new handle. Throws if the tensor was not created using
+ * createExportableTensor().
+ *
+ * @param tensor Tensor to export
+ * @return Exported memory
+*/
+[[nodiscard]] HEPHAISTOS_API ExternalMemory exportTensor(const Tensor<std::byte>& tensor);
+
+/**
+ * @brief Creates a tensor using memory exported by another process
+ *
+ * Allows processes on the same device to share tensors without copying
+ * them through the host. The handle must first be transferred into the
+ * importing process, e.g. via a Unix domain socket or DuplicateHandle().
+ * The exporting context must use the same physical device and driver.
+ * On Linux, a successful import takes ownership of the file descriptor,
+ * while handles on Windows must still be closed by the caller.
+ *
+ * @note Import tensors with the same size they were exported with. Smaller
+ *       ones can not use the dedicated allocation some drivers require.
+ *
+ * @param context Context onto which to create the tensor
+ * @param memory Memory exported via exportTensor()
+ * @param size Size of the tensor in bytes. whole_size uses the remaining
+ *             memory after the offset.
+ * @return Tensor accessing the imported memory
+*/
+[[nodiscard]] HEPHAISTOS_API Tensor<std::byte> importTensor(
+    const ContextHandle& context, const ExternalMemory& memory, uint64_t size = whole_size);
+
+/**
+ * @brief Creates a new timeline which can be exported
+ *
+ * Allows work in other APIs to wait on or signal work submitted to the
+ * context, e.g. via cudaImportExternalSemaphore.
+ *
+ * @param context Context onto which to create the timeline
+ * @param initialValue Initial value of the timeline
+ * @return Exportable timeline
+*/
+[[nodiscard]] HEPHAISTOS_API Timeline createExportableTimeline(
+    const ContextHandle& context, uint64_t initialValue = 0);
+/**
+ * @brief Exports the semaphore of the given timeline
+ *
+ * Each call creates a new handle. Throws if the timeline was not created
+ * using createExportableTimeline().
+ *
+ * @param timeline Timeline to export
+ * @return Native handle to the exported semaphore
+*/
+[[nodiscard]] HEPHAISTOS_API ExternalHandle exportTimeline(const Timeline& timeline);
+/**
+ * @brief Creates a timeline using a semaphore exported by another process
+ *
+ * Both processes can wait on and signal the shared timeline, synchronizing
+ * work on the device without involving the host. The same rules regarding
+ * the transfer and ownership of the handle as for importTensor() apply.
+ *
+ * @param context Context onto which to create the timeline
+ * @param handle Native handle returned by exportTimeline()
+ * @return Timeline sharing the semaphore of the exported one
+*/
+[[nodiscard]] HEPHAISTOS_API Timeline importTimeline(
+    const ContextHandle& context, ExternalHandle handle);
+
+}
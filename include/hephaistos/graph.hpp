@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include "hephaistos/buffer.hpp"
+#include "hephaistos/command.hpp"
+#include "hephaistos/context.hpp"
+#include "hephaistos/handles.hpp"
+#include "hephaistos/program.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief Checks for execution graph support
+ *
+ * @note Execution graphs are experimental.
+ *
+ * @param device Handle to device to be checked for execution graph support
+ * @return True, if the given device supports execution graphs, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isExecutionGraphSupported(const DeviceHandle& device);
+/**
+ * @brief Checks wether execution graphs are enabled
+ *
+ * @param context Context to check
+ * @return True, if execution graphs are enabled in the given context, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isExecutionGraphEnabled(const ContextHandle& context);
+
+/**
+ * @brief Creates an execution graph extension
+ *
+ * Returns an extension which can be passed during the creation of a context to
+ * enable the experimental execution graphs.
+ *
+ * @return Extension for enabling execution graphs
+*/
+[[nodiscard]] HEPHAISTOS_API ExtensionHandle createExecutionGraphExtension();
+
+/**
+ * @brief Node of an ExecutionGraph
+*/
+struct GraphNode {
+    /**
+     * @brief Program processing the node's records. Its bindings are
+     *        captured on creation of the graph.
+    */
+    std::reference_wrapper<const Program> program;
+    /**
+     * @brief Maximum amount of workgroups per round. Zero uses the occupancy
+     *        of the program.
+    */
+    uint32_t maxGroups = 0;
+};
+
+/**
+ * @brief Command seeding an ExecutionGraph or running it until it drains
+ *
+ * Created by ExecutionGraph::seed() and ExecutionGraph::launch(). Runs
+ * multiple dispatches synchronized among each other, but like DispatchCommand
+ * not with work recorded before or after.
+*/
+class HEPHAISTOS_API ExecutionGraphCommand : public Command {
+public:
+    void record(vulkan::Command& cmd) const override;
+
+    ExecutionGraphCommand(const ExecutionGraphCommand&);
+    ExecutionGraphCommand& operator=(const ExecutionGraphCommand&);
+
+    ExecutionGraphCommand(ExecutionGraphCommand&&) noexcept;
+    ExecutionGraphCommand& operator=(ExecutionGraphCommand&&) noexcept;
+
+    ~ExecutionGraphCommand() override;
+
+public: //internal
+    struct State;
+    explicit ExecutionGraphCommand(std::shared_ptr<const State> state);
+
+private:
+    std::shared_ptr<const State> state;
+};
+
+/**
+ * @brief Experimental graph of programs enqueuing work to each other on the
+ *        device
+ *
+ * Dynamically branching workloads, e.g. particles spawning secondaries of a
+ * different kind, are expressed as nodes each processing its own kind of
+ * records, while emitting records to any node including itself. Programs
+ * include the built-in header "hephaistos/graph.glsl" and loop popping
+ * records of their node via graphPop() until it drained, enqueuing follow up
+ * work via graphEnqueue(). Thus, the host neither needs to know how much work
+ * each node receives, nor in which order nodes run.
+ *
+ * Each node owns a queue like WorkQueue. A round dispatches the programs of
+ * all nodes at once sized to their pending records, followed by a single
+ * dispatch advancing all queues. Records enqueued in a round are processed in
+ * the next one. Rounds after the graph drained dispatch no workgroups.
+ *
+ * Records are 32 bit values, e.g. indices into other tensors holding the
+ * actual payload.
+ *
+ * @note Execution graphs are emulated via persistent work queues and
+ *       indirect dispatches, thus run on any device. Native shader enqueue,
+ *       i.e. VK_AMDX_shader_enqueue, is not used.
+ * @note Programs access the graph via its address, which must be passed to
+ *       them, e.g. as part of the push constant shared by all nodes.
+*/
+class HEPHAISTOS_API ExecutionGraph {
+public:
+    /**
+     * @brief Returns the amount of nodes
+    */
+    [[nodiscard]] uint32_t getNodeCount() const noexcept;
+    /**
+     * @brief Returns the amount of records each half of a node's queue can
+     *        hold
+    */
+    [[nodiscard]] uint32_t getCapacity() const noexcept;
+    /**
+     * @brief Returns the device address of the graph
+    */
+    [[nodiscard]] uint64_t getAddress() const noexcept;
+    /**
+     * @brief Returns the tensor holding the queues of all nodes
+     *
+     * Queues are stored consecutively each starting with a WorkQueueHeader.
+     *
+     * @see getQueueOffset
+    */
+    [[nodiscard]] const Tensor<std::byte>& getTensor() const noexcept;
+    /**
+     * @brief Returns the offset in bytes of the given node's queue inside
+     *        the tensor
+    */
+    [[nodiscard]] uint64_t getQueueOffset(uint32_t node) const;
+
+    /**
+     * @brief Creates a command resetting all nodes and filling the given one
+     *        with a range of consecutive records
+     *
+     * @param node Node receiving the records
+     * @param count Amount of records
+     * @param first Value of the first record
+    */
+    [[nodiscard]] ExecutionGraphCommand seed(
+        uint32_t node, uint32_t count, uint32_t first = 0) const;
+    /**
+     * @brief Creates a command resetting all nodes and filling the given one
+     *        with the records stored in the given tensor
+     *
+     * @param node Node receiving the records
+     * @param records Tensor holding the records as uint32
+     * @param count Amount of records. Defaults to the size of records.
+    */
+    [[nodiscard]] ExecutionGraphCommand seed(
+        uint32_t node,
+        const Tensor<std::byte>& records,
+        std::optional<uint32_t> count = std::nullopt) const;
+
+    /**
+     * @brief Creates a command running the graph until it drains
+     *
+     * @param push Data used as push constant by all nodes
+     * @param rounds Maximum amount of rounds
+    */
+    [[nodiscard]] ExecutionGraphCommand launch(
+        std::span<const std::byte> push = {}, uint32_t rounds = 16) const;
+    /**
+     * @brief Creates a command running the graph until it drains
+     *
+     * @param push Data used as push constant by all nodes
+     * @param rounds Maximum amount of rounds
+    */
+    template<class T>
+    [[nodiscard]] ExecutionGraphCommand launch(const T& push, uint32_t rounds = 16) const {
+        return launch({ reinterpret_cast<const std::byte*>(&push), sizeof(T) }, rounds);
+    }
+
+    ExecutionGraph(const ExecutionGraph&) = delete;
+    ExecutionGraph& operator=(const ExecutionGraph&) = delete;
+
+    ExecutionGraph(ExecutionGraph&& other) noexcept;
+    ExecutionGraph& operator=(ExecutionGraph&& other) noexcept;
+
+    /**
+     * @brief Creates a new ExecutionGraph
+     *
+     * @param context Context onto which to create the graph. Must have
+     *                execution graphs enabled.
+     * @param nodes Nodes of the graph. Their index is used to address them.
+     * @param capacity Amount of records each half of a node's queue can hold
+    */
+    ExecutionGraph(ContextHandle context, std::span<const GraphNode> nodes, uint32_t capacity);
+    ~ExecutionGraph();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Returns the source of the built-in GLSL header
+ *        "hephaistos/graph.glsl"
+*/
+[[nodiscard]] HEPHAISTOS_API std::string_view getExecutionGraphSource() noexcept;
+
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "hephaistos/buffer.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief IEEE 754 half precision float as stored in buffers and tensors
+ *
+ * Pure storage type without arithmetic. Convert from and to float via
+ * toHalf() and fromHalf() or in bulk via convertToHalf() and
+ * convertFromHalf().
+*/
+struct half {
+    /**
+     * @brief Raw bits of the half precision float
+    */
+    uint16_t bits;
+};
+
+/**
+ * @brief Buffer holding half precision floats
+*/
+using HalfBuffer = Buffer<half>;
+/**
+ * @brief Tensor holding half precision floats
+*/
+using HalfTensor = Tensor<half>;
+
+/**
+ * @brief Converts the float to half precision rounding to nearest even
+ *
+ * Values exceeding the range of half precision become infinity.
+*/
+[[nodiscard]] HEPHAISTOS_API half toHalf(float value) noexcept;
+/**
+ * @brief Converts the half precision float to single precision
+*/
+[[nodiscard]] HEPHAISTOS_API float fromHalf(half value) noexcept;
+
+/**
+ * @brief Converts floats to half precision in bulk
+ *
+ * Uses F16C on x86 if the processor supports it and NEON on ARM64, thus
+ * is considerably faster than converting each value on its own. Rounds to
+ * nearest even like toHalf(). The destination may point to the memory of a
+ * Buffer or a mapped Tensor.
+ *
+ * @param src Floats to convert
+ * @param dst Destination of the converted values. Must have the same size.
+*/
+HEPHAISTOS_API void convertToHalf(std::span<const float> src, std::span<half> dst);
+/**
+ * @brief Converts half precision floats to single precision in bulk
+ *
+ * Uses F16C on x86 if the processor supports it and NEON on ARM64. The
+ * source may point to the memory of a Buffer or a mapped Tensor.
+ *
+ * @param src Half precision floats to convert
+ * @param dst Destination of the converted values. Must have the same size.
+*/
+HEPHAISTOS_API void convertFromHalf(std::span<const half> src, std::span<float> dst);
+
+}
@@ -1,11 +1,21 @@
 #pragma once
 
 #include "hephaistos/buffer.hpp"
+#include "hephaistos/capture.hpp"
 #include "hephaistos/command.hpp"
 #include "hephaistos/compiler.hpp"
 #include "hephaistos/context.hpp"
+#include "hephaistos/half.hpp"
 #include "hephaistos/handles.hpp"
 #include "hephaistos/image.hpp"
+#include "hephaistos/multidevice.hpp"
+#include "hephaistos/primitives.hpp"
 #include "hephaistos/program.hpp"
+#include "hephaistos/random.hpp"
+#include "hephaistos/scheduler.hpp"
 #include "hephaistos/stopwatch.hpp"
+#include "hephaistos/stream.hpp"
+#include "hephaistos/trace.hpp"
+#include "hephaistos/tuning.hpp"
 #include "hephaistos/version.hpp"
+#include "hephaistos/workqueue.hpp"
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <filesystem>
+#include <future>
+#include <string_view>
+#include <vector>
+
 #include "hephaistos/argument.hpp"
 #include "hephaistos/buffer.hpp"
 #include "hephaistos/command.hpp"
@@ -46,6 +51,20 @@ enum class Filter {
     LINEAR
 };
 
+/**
+ * @brief List of methods to interpolate in between mip levels
+*/
+enum class MipmapMode {
+    /**
+     * @brief Uses the nearest mip level
+    */
+    NEAREST,
+    /**
+     * @brief Linear interpolation between the two nearest mip levels
+    */
+    LINEAR
+};
+
 /**
  * @brief Queries wether the given combination of format and filter is supported
  * 
@@ -69,6 +88,33 @@ enum class Filter {
 [[nodiscard]] bool isFilterSupported(const ContextHandle& context,
     ImageFormat format, Filter filter);
 
+/**
+ * @brief Queries wether the given format can be used for textures
+ * 
+ * Support of block compressed formats varies between devices, e.g. BC formats
+ * are common on desktop GPUs, while ETC2 and ASTC are mostly found on mobile.
+ * 
+ * @param device Device on which to query support
+ * @param format Image format to query
+ * 
+ * @return True, if textures of the format are supported, false otherwise
+*/
+[[nodiscard]] HEPHAISTOS_API bool isTextureFormatSupported(
+    const DeviceHandle& device, ImageFormat format);
+/**
+ * @brief Queries wether the given format can be used for textures
+ * 
+ * Support of block compressed formats varies between devices, e.g. BC formats
+ * are common on desktop GPUs, while ETC2 and ASTC are mostly found on mobile.
+ * 
+ * @param context Context on which to query support
+ * @param format Image format to query
+ * 
+ * @return True, if textures of the format are supported, false otherwise
+*/
+[[nodiscard]] HEPHAISTOS_API bool isTextureFormatSupported(
+    const ContextHandle& context, ImageFormat format);
+
 /**
  * @brief Configuration of a sampler
  * 
@@ -93,16 +139,55 @@ struct Sampler {
      * @brief Filter method
     */
     Filter filter = Filter::LINEAR;
+    /**
+     * @brief Method for selecting between mip levels
+    */
+    MipmapMode mipmapMode = MipmapMode::LINEAR;
+
+    /**
+     * @brief Bias added to the computed level of detail
+    */
+    float lodBias = 0.0f;
+    /**
+     * @brief Minimum level of detail the computed one gets clamped to
+    */
+    float minLod = 0.0f;
+    /**
+     * @brief Maximum level of detail the computed one gets clamped to
+     * 
+     * The default value effectively disables clamping.
+    */
+    float maxLod = 1000.0f;
 
     /**
      * @brief Wether to use unnormalized coordinates
      * 
      * If false, pixel coordinates are in the range [0,1], otherwise whole
      * numbers represents whole pixels.
+     * 
+     * @note Unnormalized coordinates only allow sampling the first mip level.
+     *       The mipmap mode and level of detail settings are ignored.
+     * @note Combined with nearest filtering, lookups are plain texel fetches.
+     *       Binding the texture as sampled image, e.g. texture2D, and reading
+     *       it via texelFetch() skips the sampler entirely.
     */
     bool unnormalizedCoordinates = false;
 };
 
+/**
+ * @brief Number of array layers of an Image or Texture
+ * 
+ * Layered images are presented inside programs as arrays, e.g. image2DArray
+ * or sampler2DArray, so that many images of the same size and format share
+ * a single binding. Only 1D and 2D images can have layers.
+*/
+struct ArrayLayers {
+    /**
+     * @brief Number of layers
+    */
+    uint32_t count;
+};
+
 /**
  * @brief Storage image allocated on device memory
  * 
@@ -129,9 +214,14 @@ public:
      * @brief Format of the image
     */
     [[nodiscard]] ImageFormat getFormat() const noexcept;
+    /**
+     * @brief Number of array layers. Zero if the image is not an array.
+    */
+    [[nodiscard]] uint32_t getLayers() const noexcept;
     /**
      * @brief Size of the image in linear memory layout in bytes 
      * 
+     * Includes all array layers.
      * @note This is not the size the image takes on the device, but can be used
      *       for allocating memory on the host to retrieve or stage the image.
     */
@@ -153,21 +243,44 @@ public:
      * @param width Width of the image in pixels
      * @param height Height of the image in pixels
      * @param depth Depth of the image in pixels
+     * @param hints Hints for allocating the image's memory
     */
     Image(ContextHandle context,
         ImageFormat format,
         uint32_t width,
         uint32_t height = 1,
-        uint32_t depth = 1);
+        uint32_t depth = 1,
+        const AllocationHints& hints = {});
+    /**
+     * @brief Allocates an array image on the given context
+     * 
+     * @param context Context onto which to create the image
+     * @param format Format of the image to create
+     * @param width Width of each layer in pixels
+     * @param height Height of each layer in pixels. One creates a 1D array.
+     * @param layers Number of array layers
+     * @param hints Hints for allocating the image's memory
+    */
+    Image(ContextHandle context,
+        ImageFormat format,
+        uint32_t width,
+        uint32_t height,
+        ArrayLayers layers,
+        const AllocationHints& hints = {});
     ~Image() override;
 
 public: //internal
     const vulkan::Image& getImage() const noexcept;
 
 private:
+    Image(ContextHandle context, ImageFormat format,
+        uint32_t width, uint32_t height, uint32_t depth, uint32_t layers,
+        const AllocationHints& hints);
+
     ImageHandle image;
     ImageFormat format;
     uint32_t width, height, depth;
+    uint32_t layers;
 
     struct Parameter;
     std::unique_ptr<Parameter> parameter;
@@ -179,6 +292,13 @@ private:
  * Textures are readonly and optimized for lookups providing more advanced
  * methods like interpolation. Texture lookups may be more performant than
  * tensor or image lookups depending on the workload.
+ *
+ * Textures can be bound to combined image samplers, e.g. sampler2D, or to
+ * sampled images, e.g. texture2D, which carry no sampler and are read via
+ * texelFetch() using GL_EXT_samplerless_texture_functions. The latter suits
+ * lookup tables, i.e. nearest filtering with unnormalized coordinates, as it
+ * avoids the sampler and uses smaller descriptors. One dimensional tables may
+ * also be stored in a tensor and read through a TexelBuffer.
 */
 class HEPHAISTOS_API Texture : public Argument, public Resource {
 public:
@@ -199,13 +319,51 @@ public:
     */
     [[nodiscard]] ImageFormat getFormat() const noexcept;
     /**
-     * @brief Size of the texture in bytes
+     * @brief Number of mip levels of the texture
+    */
+    [[nodiscard]] uint32_t getMipLevels() const noexcept;
+    /**
+     * @brief Number of array layers. Zero if the texture is not an array.
+    */
+    [[nodiscard]] uint32_t getLayers() const noexcept;
+    /**
+     * @brief Size of the texture's first mip level in bytes
      * 
+     * Includes all array layers.
      * @note This is not the size the image takes on the device, but can be used
      *       for allocating memory on the host to retrieve or stage the image.
     */
     [[nodiscard]] uint64_t size_bytes() const noexcept;
 
+    /**
+     * @brief Loads a texture from a KTX2 or DDS file
+     * 
+     * Uploads the stored payload including all of its mip levels as is, i.e.
+     * block compressed formats are not decompressed on the host. Only single
+     * 2D and 3D images without supercompression are supported.
+     * 
+     * @param context Context onto which to create the Texture
+     * @param filename Path to the KTX2 or DDS file
+     * @param sampler Sampler configuration used for texture lookups
+     * @return New Texture containing the loaded image
+    */
+    [[nodiscard]] static Texture load(ContextHandle context,
+        const char* filename, const Sampler& sampler = {});
+    /**
+     * @brief Loads a texture from a KTX2 or DDS file stored in memory
+     * 
+     * Uploads the stored payload including all of its mip levels as is, i.e.
+     * block compressed formats are not decompressed on the host. Only single
+     * 2D and 3D images without supercompression are supported.
+     * 
+     * @param context Context onto which to create the Texture
+     * @param memory Memory range containing the KTX2 or DDS file
+     * @param sampler Sampler configuration used for texture lookups
+     * @return New Texture containing the loaded image
+    */
+    [[nodiscard]] static Texture load(ContextHandle context,
+        std::span<const std::byte> memory, const Sampler& sampler = {});
+
     void bindParameter(VkWriteDescriptorSet& binding) const final override;
 
     Texture(const Texture&) = delete;
@@ -221,11 +379,13 @@ public:
      * @param format Image format of the texture
      * @param width Width of the texture in pixels
      * @param sampler Sampler configuration used for texture lookups
+     * @param mipLevels Number of mip levels. Zero creates the full mip chain.
     */
     Texture(ContextHandle context,
         ImageFormat format,
         uint32_t width,
-        const Sampler& sampler = {});
+        const Sampler& sampler = {},
+        uint32_t mipLevels = 1);
     /**
      * @brief Allocates a texture on the given context
      * 
@@ -234,12 +394,14 @@ public:
      * @param width Width of the texture in pixels
      * @param height Height of the texture in pixels
      * @param sampler Sampler configuration used for texture lookups
+     * @param mipLevels Number of mip levels. Zero creates the full mip chain.
     */   
     Texture(ContextHandle context,
         ImageFormat format,
         uint32_t width,
         uint32_t height,
-        const Sampler& sampler = {});
+        const Sampler& sampler = {},
+        uint32_t mipLevels = 1);
     /**
      * @brief Allocates a texture on the given context
      * 
@@ -249,44 +411,492 @@ public:
      * @param height Height of the texture in pixels
      * @param depth Depth of the texture in pixels
      * @param sampler Sampler configuration used for texture lookups
+     * @param mipLevels Number of mip levels. Zero creates the full mip chain.
     */
     Texture(ContextHandle context,
         ImageFormat format,
         uint32_t width,
         uint32_t height,
         uint32_t depth,
-        const Sampler& sampler = {});
+        const Sampler& sampler = {},
+        uint32_t mipLevels = 1);
+    /**
+     * @brief Allocates an array texture on the given context
+     * 
+     * @param context Context onto which to create the texture
+     * @param format Image format of the texture
+     * @param width Width of each layer in pixels
+     * @param height Height of each layer in pixels. One creates a 1D array.
+     * @param layers Number of array layers
+     * @param sampler Sampler configuration used for texture lookups
+     * @param mipLevels Number of mip levels. Zero creates the full mip chain.
+    */
+    Texture(ContextHandle context,
+        ImageFormat format,
+        uint32_t width,
+        uint32_t height,
+        ArrayLayers layers,
+        const Sampler& sampler = {},
+        uint32_t mipLevels = 1);
     ~Texture() override;
 
 public: //internal
     const vulkan::Image& getImage() const noexcept;
 
+protected: //internal
+    Texture(ContextHandle context, ImageHandle image, ImageFormat format,
+        uint32_t width, uint32_t height, uint32_t depth, uint32_t layers,
+        const Sampler& sampler, uint32_t mipLevels);
+
 private:
+    Texture(ContextHandle context, ImageFormat format,
+        uint32_t width, uint32_t height, uint32_t depth, uint32_t layers,
+        const Sampler& sampler, uint32_t mipLevels);
+
     ImageHandle image;
     ImageFormat format;
     uint32_t width, height, depth;
+    uint32_t mipLevels;
+    uint32_t layers;
+
+    struct Parameter;
+    std::unique_ptr<Parameter> parameter;
+};
+
+/**
+ * @brief Checks wether the context supports sparse textures
+ *
+ * Requires the sparseBinding and sparseResidencyImage3D features and a main
+ * queue supporting sparse binding, which are enabled if available.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isSparseTextureSupported(const ContextHandle& context);
+/**
+ * @brief Queries wether the given format can be used for sparse textures
+ *
+ * @param context Context on which to query support
+ * @param format Image format to query
+ *
+ * @return True, if sparse textures of the format are supported, false otherwise
+*/
+[[nodiscard]] HEPHAISTOS_API bool isSparseTextureFormatSupported(
+    const ContextHandle& context, ImageFormat format);
+
+/**
+ * @brief Tile of a SparseTexture memory gets committed in
+ *
+ * Coordinates are given in tiles, i.e. the tile covers the texels starting
+ * at x * getTileWidth(), y * getTileHeight() and z * getTileDepth() inside
+ * the given mip level.
+*/
+struct SparseTile {
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t z = 0;
+    /**
+     * @brief Mip level of the tile
+    */
+    uint32_t level = 0;
+
+    bool operator==(const SparseTile&) const = default;
+};
+
+/**
+ * @brief Location of a SparseTexture's access feedback
+ *
+ * Matches the layout of SparseFeedback in the built-in GLSL header
+ * "hephaistos/sparse.glsl", thus can be copied into push constants or
+ * buffers as is.
+*/
+struct SparseFeedback {
+    /**
+     * @brief Device address of the feedback holding one word per tile
+    */
+    uint64_t address;
+    /**
+     * @brief Size of the first mip level in texels
+    */
+    uint32_t width, height, depth;
+    /**
+     * @brief Size of a tile in texels
+    */
+    uint32_t tileWidth, tileHeight, tileDepth;
+    /**
+     * @brief Number of mip levels committed in tiles
+    */
+    uint32_t levels;
+    uint32_t _reserved;
+};
+
+/**
+ * @brief 3D texture reserving its image without backing it by memory
+ *
+ * Allows textures larger than the device's memory, of which only the working
+ * set is resident. Memory is committed and decommitted in tiles of
+ * getTileSize() bytes covering a box of texels, whose extent depends on the
+ * format. The mip levels too small to be split into tiles form the mip tail,
+ * which is committed for the texture's whole lifetime.
+ *
+ * Lookups of texels not committed return undefined values, or zero if the
+ * device guarantees strict residency. To find the tiles worth committing,
+ * programs record their lookups in the texture's feedback using
+ * sparseFeedbackMark() declared in the built-in header
+ * "hephaistos/sparse.glsl", which the Compiler resolves without the shader
+ * requesting GL_GOOGLE_include_directive. The accessed tiles are read back on
+ * the host via fetchAccessedTiles().
+ *
+ * @note Commands using a tile must have finished before it gets decommitted.
+ * @note Newly committed tiles have undefined content and must be updated,
+ *       e.g. via updateTexture() with a region covering the tile.
+*/
+class HEPHAISTOS_API SparseTexture : public Texture {
+public:
+    /**
+     * @brief Width of a tile in texels
+    */
+    [[nodiscard]] uint32_t getTileWidth() const noexcept;
+    /**
+     * @brief Height of a tile in texels
+    */
+    [[nodiscard]] uint32_t getTileHeight() const noexcept;
+    /**
+     * @brief Depth of a tile in texels
+    */
+    [[nodiscard]] uint32_t getTileDepth() const noexcept;
+    /**
+     * @brief Size in bytes of the memory backing a single tile
+    */
+    [[nodiscard]] uint64_t getTileSize() const noexcept;
+    /**
+     * @brief Number of mip levels committed in tiles
+     *
+     * Levels beyond form the mip tail, which is always committed.
+    */
+    [[nodiscard]] uint32_t getTiledLevels() const noexcept;
+    /**
+     * @brief Number of tiles of the given mip level in each dimension
+     *
+     * @param level Mip level of the tiles. Must be smaller than getTiledLevels().
+     * @return Tile count as coordinates x, y and z
+    */
+    [[nodiscard]] SparseTile getTileGrid(uint32_t level = 0) const;
+    /**
+     * @brief Total number of tiles across all tiled mip levels
+    */
+    [[nodiscard]] uint32_t getTileCount() const noexcept;
+    /**
+     * @brief Number of bytes currently committed excluding the mip tail
+    */
+    [[nodiscard]] uint64_t size_committed() const noexcept;
+    /**
+     * @brief True, if the given tile is backed by memory
+    */
+    [[nodiscard]] bool isCommitted(const SparseTile& tile) const;
+
+    /**
+     * @brief Backs the given tiles with memory
+     *
+     * Already committed tiles keep their content. Blocks until the memory is
+     * bound.
+     *
+     * @param tiles Tiles to commit
+    */
+    void commit(std::span<const SparseTile> tiles);
+    /**
+     * @brief Releases the memory backing the given tiles
+     *
+     * Blocks until the memory is unbound.
+     *
+     * @param tiles Tiles to decommit
+    */
+    void decommit(std::span<const SparseTile> tiles);
+    /**
+     * @brief Releases the memory of all tiles
+    */
+    void decommitAll();
+
+    /**
+     * @brief Location of the access feedback to pass to programs
+    */
+    [[nodiscard]] SparseFeedback getFeedback() const noexcept;
+    /**
+     * @brief Tensor holding the access feedback
+     *
+     * Holds one word per tile ordered by mip level, then z, y and x, which
+     * is non zero if the tile was accessed.
+    */
+    [[nodiscard]] const Tensor<uint32_t>& getFeedbackTensor() const noexcept;
+    /**
+     * @brief Returns the tiles accessed since the feedback was last reset
+     *
+     * Reads back the feedback and blocks until it is available.
+     *
+     * @note Work writing to the feedback must have finished.
+     *
+     * @param reset If true, clears the feedback afterwards
+    */
+    [[nodiscard]] std::vector<SparseTile> fetchAccessedTiles(bool reset = true);
+
+    SparseTexture(const SparseTexture&) = delete;
+    SparseTexture& operator=(const SparseTexture&) = delete;
+
+    SparseTexture(SparseTexture&& other) noexcept;
+    SparseTexture& operator=(SparseTexture&& other) noexcept;
+
+    /**
+     * @brief Reserves a new sparse 3D texture committing only its mip tail
+     *
+     * Throws if sparse textures or the format are not supported.
+     *
+     * @param context Context onto which to create the texture
+     * @param format Image format of the texture
+     * @param width Width of the texture in pixels
+     * @param height Height of the texture in pixels
+     * @param depth Depth of the texture in pixels
+     * @param sampler Sampler configuration used for texture lookups
+     * @param mipLevels Number of mip levels. Zero creates the full mip chain.
+    */
+    SparseTexture(ContextHandle context,
+        ImageFormat format,
+        uint32_t width,
+        uint32_t height,
+        uint32_t depth,
+        const Sampler& sampler = {},
+        uint32_t mipLevels = 1);
+    ~SparseTexture() override;
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Returns the source of the built-in GLSL header "hephaistos/sparse.glsl"
+*/
+[[nodiscard]] HEPHAISTOS_API std::string_view getSparseFeedbackSource() noexcept;
+
+/**
+ * @brief Returns the number of mip levels in a full mip chain
+ * 
+ * @param width Width of the base level in pixels
+ * @param height Height of the base level in pixels
+ * @param depth Depth of the base level in pixels
+*/
+[[nodiscard]] HEPHAISTOS_API uint32_t getMaxMipLevels(
+    uint32_t width, uint32_t height = 1, uint32_t depth = 1);
+
+/**
+ * @brief Queries wether the given format can be used for texel buffers
+ * 
+ * @param device Device on which to query support
+ * @param format Format of the texels
+ * @param storage If true, queries storage texel buffers, i.e. support for
+ *                writing. Otherwise queries read only uniform texel buffers.
+ * 
+ * @return True, if texel buffers of the format are supported, false otherwise
+*/
+[[nodiscard]] HEPHAISTOS_API bool isTexelBufferFormatSupported(
+    const DeviceHandle& device, ImageFormat format, bool storage = true);
+/**
+ * @brief Queries wether the given format can be used for texel buffers
+ * 
+ * @param context Context on which to query support
+ * @param format Format of the texels
+ * @param storage If true, queries storage texel buffers, i.e. support for
+ *                writing. Otherwise queries read only uniform texel buffers.
+ * 
+ * @return True, if texel buffers of the format are supported, false otherwise
+*/
+[[nodiscard]] HEPHAISTOS_API bool isTexelBufferFormatSupported(
+    const ContextHandle& context, ImageFormat format, bool storage = true);
+
+/**
+ * @brief Formatted view of a tensor's memory
+ * 
+ * Presents a range of a tensor inside programs as a one dimensional array of
+ * texels in the given format, i.e. as uniform or storage texel buffer
+ * (samplerBuffer and imageBuffer in GLSL). Reads and writes convert between
+ * the format and the shader's type in hardware, while not being limited by
+ * the maximum dimension of images.
+ * 
+ * @note The tensor must outlive the texel buffer.
+*/
+class HEPHAISTOS_API TexelBuffer : public Argument, public Resource {
+public:
+    /**
+     * @brief Format of the texels
+    */
+    [[nodiscard]] ImageFormat getFormat() const noexcept;
+    /**
+     * @brief Offset of the range into the tensor in bytes
+    */
+    [[nodiscard]] uint64_t offset() const noexcept;
+    /**
+     * @brief Number of texels in the range
+    */
+    [[nodiscard]] uint64_t size() const noexcept;
+    /**
+     * @brief Size of the range in bytes
+    */
+    [[nodiscard]] uint64_t size_bytes() const noexcept;
+    /**
+     * @brief The tensor the range belongs to
+    */
+    [[nodiscard]] const Tensor<std::byte>& getTensor() const noexcept;
+
+    void bindParameter(VkWriteDescriptorSet& binding) const final override;
+
+    TexelBuffer(const TexelBuffer&) = delete;
+    TexelBuffer& operator=(const TexelBuffer&) = delete;
+
+    TexelBuffer(TexelBuffer&& other) noexcept;
+    TexelBuffer& operator=(TexelBuffer&& other) noexcept;
+
+    /**
+     * @brief Creates a new texel buffer viewing the given tensor
+     * 
+     * @param tensor Tensor to create a view of
+     * @param format Format of the texels. Must not be block compressed.
+     * @param offset Offset into the tensor in bytes. Must be a multiple of
+     *               the device's minTexelBufferOffsetAlignment.
+     * @param size Size of the range in bytes. Must be a multiple of the
+     *             texel size. whole_size spans the rest of the tensor.
+    */
+    TexelBuffer(const Tensor<std::byte>& tensor, ImageFormat format,
+        uint64_t offset = 0, uint64_t size = whole_size);
+    ~TexelBuffer() override;
 
+private:
     struct Parameter;
+    std::reference_wrapper<const Tensor<std::byte>> tensor;
+    ImageFormat format;
+    uint64_t _offset;
+    //on the heap, so bound programs stay valid after moving the view
     std::unique_ptr<Parameter> parameter;
 };
 
+/**
+ * @brief File format images are saved in
+*/
+enum class ImageFileFormat {
+    /**
+     * @brief PNG for 8 bit and 16 bit images, Radiance HDR for floating point ones
+    */
+    AUTO,
+    /**
+     * @brief PNG using the image's bit depth. Supports 8 bit and 16 bit images.
+    */
+    PNG,
+    /**
+     * @brief Radiance HDR dropping the alpha channel. Supports floating point images.
+    */
+    HDR,
+    /**
+     * @brief Binary PPM dropping the alpha channel. Supports 8 bit and 16 bit
+     *        images. Uncompressed, thus fast to write.
+    */
+    PPM,
+    /**
+     * @brief Quite OK Image format. Supports 8 bit images. Compresses about
+     *        as well as PNG, but considerably faster.
+    */
+    QOI,
+    /**
+     * @brief Uncompressed TIFF. Supports all image buffer formats and is fast
+     *        to write.
+    */
+    TIFF
+};
+
+/**
+ * @brief Options for saving images
+*/
+struct ImageSaveOptions {
+    /**
+     * @brief File format the image is saved in
+    */
+    ImageFileFormat fileFormat = ImageFileFormat::AUTO;
+    /**
+     * @brief Compression level of PNG images
+     *
+     * Ranges from 0, i.e. no compression, to 9. Negative values use the
+     * default level, which favors size over speed. Ignored by other formats.
+    */
+    int32_t compressionLevel = -1;
+};
+
+/**
+ * @brief Encodes the given image in memory
+ *
+ * Works on any host memory containing a 2D RGBA image in linear layout, e.g.
+ * the memory of a Buffer the image was retrieved into.
+ *
+ * @param data Pixels of the image
+ * @param width Width of the image in pixels
+ * @param height Height of the image in pixels
+ * @param format Format of the pixels. Must be supported by ImageBuffer.
+ * @param options Options for encoding the image
+ * @return Encoded image
+*/
+[[nodiscard]] HEPHAISTOS_API std::vector<std::byte> encodeImage(
+    std::span<const std::byte> data, uint32_t width, uint32_t height,
+    ImageFormat format, const ImageSaveOptions& options = {});
+/**
+ * @brief Saves the given image at the given filepath
+ *
+ * Works on any host memory containing a 2D RGBA image in linear layout, e.g.
+ * the memory of a Buffer the image was retrieved into.
+ *
+ * @param filename Filepath to where to save the image
+ * @param data Pixels of the image
+ * @param width Width of the image in pixels
+ * @param height Height of the image in pixels
+ * @param format Format of the pixels. Must be supported by ImageBuffer.
+ * @param options Options for encoding the image
+*/
+HEPHAISTOS_API void saveImage(const std::filesystem::path& filename,
+    std::span<const std::byte> data, uint32_t width, uint32_t height,
+    ImageFormat format, const ImageSaveOptions& options = {});
+/**
+ * @brief Saves the given image at the given filepath in the background
+ *
+ * Encodes and writes the image on an internal worker pool, so e.g. the next
+ * frame can be rendered meanwhile. The memory must stay alive and unchanged
+ * until the returned future is ready, which rethrows any error occurred
+ * while saving.
+ *
+ * @param filename Filepath to where to save the image
+ * @param data Pixels of the image
+ * @param width Width of the image in pixels
+ * @param height Height of the image in pixels
+ * @param format Format of the pixels. Must be supported by ImageBuffer.
+ * @param options Options for encoding the image
+ * @return Future becoming ready once the image is saved
+*/
+[[nodiscard]] HEPHAISTOS_API std::future<void> saveImageAsync(std::filesystem::path filename,
+    std::span<const std::byte> data, uint32_t width, uint32_t height,
+    ImageFormat format, const ImageSaveOptions& options = {});
+
 /**
  * @brief Image buffer allocated on host memory
  * 
  * Image buffer is a utility class allocating enough memory to store 2D RGBA
- * images * in linear memory layout providing additional methods for loading
- * and saving images from disk.
+ * images in linear memory layout providing additional methods for loading
+ * and saving images from disk. Supports 8 bit and 16 bit normalized as well
+ * as 32 bit floating point channels.
 */
-class HEPHAISTOS_API ImageBuffer : public Buffer<Vec4<uint8_t>> {
+class HEPHAISTOS_API ImageBuffer : public Buffer<std::byte> {
 public:
     /**
-     * @brief Type of a single pixel
+     * @brief Format of image buffers if not specified otherwise
     */
-    using ElementType = Vec4<uint8_t>;
+    static constexpr auto DefaultFormat = ImageFormat::R8G8B8A8_UNORM;
+
     /**
-     * @brief Format of the image
+     * @brief Checks whether the given format can be used for image buffers
+     * 
+     * Supported are R8G8B8A8_UNORM, R16G16B16A16_UNORM and R32G32B32A32_SFLOAT.
     */
-    static constexpr auto Format = ImageFormat::R8G8B8A8_UNORM;
+    [[nodiscard]] static bool isFormatSupported(ImageFormat format) noexcept;
 
 public:
     /**
@@ -297,9 +907,13 @@ public:
      * @brief Height of the image in pixels
     */
     [[nodiscard]] uint32_t getHeight() const;
+    /**
+     * @brief Format of the image
+    */
+    [[nodiscard]] ImageFormat getFormat() const;
 
     /**
-     * @brief Creates an Image of equal dimension
+     * @brief Creates an Image of equal dimension and format
      * 
      * @param copy If true, copies the content of this buffer to the newly
      *             created image
@@ -307,7 +921,7 @@ public:
     */
     [[nodiscard]] Image createImage(bool copy = true) const;
     /**
-     * @brief Creates a Texture of equal dimension
+     * @brief Creates a Texture of equal dimension and format
      * 
      * @param sample Sampler to use with the texture
      * @param copy If true, copies the content of this buffer to the newly
@@ -320,31 +934,75 @@ public:
      * @brief Loads image from disk
      * 
      * Loads the image at the given filepath from disk and returns its contents
-     * in a new ImageBuffer.
+     * in a new ImageBuffer converted to the given format. HDR images are
+     * loaded without quantization if the format is R32G32B32A32_SFLOAT.
      * 
      * @param context Context onto which to create the ImageBuffer
      * @param filename Path to the image on disk to load
+     * @param format Format of the created ImageBuffer
      * @return New ImageBuffer containing the loaded image
     */
-    [[nodiscard]] static ImageBuffer load(ContextHandle context, const char* filename);
+    [[nodiscard]] static ImageBuffer load(ContextHandle context,
+        const char* filename, ImageFormat format = DefaultFormat);
     /**
      * @brief Loads image from memory
      * 
      * Loads the image stored in the given memory range in a serialized format
-     * and returns the deserialize image in a new ImageBuffer.
+     * and returns the deserialize image in a new ImageBuffer converted to the
+     * given format.
      * 
      * @param context Context onto which to create the ImageBuffer
      * @param memory Memory range containing the serialized image
+     * @param format Format of the created ImageBuffer
      * @return New ImageBuffer containing the deserialized image
     */
-    [[nodiscard]] static ImageBuffer load(ContextHandle context, std::span<const std::byte> memory);
+    [[nodiscard]] static ImageBuffer load(ContextHandle context,
+        std::span<const std::byte> memory, ImageFormat format = DefaultFormat);
+    /**
+     * @brief Loads images from disk in parallel
+     * 
+     * Decodes the images on an internal worker pool directly into the memory
+     * of the returned ImageBuffers. Each future becomes ready as soon as its
+     * image finished loading and rethrows any error occurred while loading.
+     * 
+     * @param context Context onto which to create the ImageBuffers
+     * @param filenames Paths to the images on disk to load
+     * @param format Format of the created ImageBuffers
+     * @return Futures of the loaded images in the same order as filenames
+    */
+    [[nodiscard]] static std::vector<std::future<ImageBuffer>> loadAsync(
+        ContextHandle context, std::span<const std::filesystem::path> filenames,
+        ImageFormat format = DefaultFormat);
 
     /**
      * @brief Saves the current content if the ImageBuffer at the given filepath
      * 
+     * The file type depends on the format: 8 bit and 16 bit images are saved
+     * as PNG using the same bit depth, floating point ones as Radiance HDR
+     * dropping the alpha channel.
+     * 
      * @param filename Filepath to where to save the image
     */
     void save(const char* filename) const;
+    /**
+     * @brief Saves the current content of the ImageBuffer at the given filepath
+     *
+     * @param filename Filepath to where to save the image
+     * @param options Options for encoding the image
+    */
+    void save(const std::filesystem::path& filename, const ImageSaveOptions& options) const;
+    /**
+     * @brief Saves the current content of the ImageBuffer in the background
+     *
+     * Encodes and writes the image on an internal worker pool. The buffer
+     * must stay alive and unchanged until the returned future is ready.
+     *
+     * @param filename Filepath to where to save the image
+     * @param options Options for encoding the image
+     * @return Future becoming ready once the image is saved
+    */
+    [[nodiscard]] std::future<void> saveAsync(
+        std::filesystem::path filename, const ImageSaveOptions& options = {}) const;
 
     ImageBuffer(const ImageBuffer&) = delete;
     ImageBuffer& operator=(const ImageBuffer&) = delete;
@@ -358,12 +1016,81 @@ public:
      * @param context Context onto which to create the ImageBuffer
      * @param width Width of the image in pixels
      * @param height Height of the image in pixels
+     * @param format Format of the image. Throws if not supported.
     */
-    ImageBuffer(ContextHandle context, uint32_t width, uint32_t height);
+    ImageBuffer(ContextHandle context, uint32_t width, uint32_t height,
+        ImageFormat format = DefaultFormat);
     ~ImageBuffer() override;
 
 private:
     uint32_t width, height;
+    ImageFormat format;
+};
+
+/**
+ * @brief Region of an image taking part in a copy
+ * 
+ * Describes a box inside one mip level and range of array layers of an image
+ * as well as the layout of the corresponding data inside the buffer. The
+ * default selects the whole first mip level of all layers tightly packed at
+ * the start of the buffer.
+*/
+struct ImageRegion {
+    /**
+     * @brief Offset of the region in X dimension in pixels
+    */
+    uint32_t x = 0;
+    /**
+     * @brief Offset of the region in Y dimension in pixels
+    */
+    uint32_t y = 0;
+    /**
+     * @brief Offset of the region in Z dimension in pixels
+    */
+    uint32_t z = 0;
+
+    /**
+     * @brief Width of the region in pixels. Zero extends it to the image's edge.
+    */
+    uint32_t width = 0;
+    /**
+     * @brief Height of the region in pixels. Zero extends it to the image's edge.
+    */
+    uint32_t height = 0;
+    /**
+     * @brief Depth of the region in pixels. Zero extends it to the image's edge.
+    */
+    uint32_t depth = 0;
+
+    /**
+     * @brief Mip level the region is located in
+    */
+    uint32_t mipLevel = 0;
+    /**
+     * @brief First array layer of the region
+    */
+    uint32_t layer = 0;
+    /**
+     * @brief Number of array layers. Zero extends it to the last layer.
+     * 
+     * Consecutive layers are laid out in the buffer like depth slices.
+    */
+    uint32_t layerCount = 0;
+
+    /**
+     * @brief Offset into the buffer in bytes. Must be a multiple of the pixel size.
+    */
+    uint64_t bufferOffset = 0;
+    /**
+     * @brief Length of a row in the buffer in pixels. Zero means tightly packed.
+    */
+    uint32_t bufferRowLength = 0;
+    /**
+     * @brief Number of rows per slice in the buffer. Zero means tightly packed.
+    */
+    uint32_t bufferImageHeight = 0;
+
+    bool operator==(const ImageRegion&) const = default;
 };
 
 /**
@@ -379,6 +1106,10 @@ public:
      * @brief Buffer destination to copy to
     */
     std::reference_wrapper<const Buffer<std::byte>> Destination;
+    /**
+     * @brief Region to copy
+    */
+    ImageRegion Region;
 
     void record(vulkan::Command& cmd) const override;
 
@@ -393,8 +1124,10 @@ public:
      * 
      * @param src Image source to copy from
      * @param dst Buffer destination to copy to
+     * @param region Region to copy
     */
-    RetrieveImageCommand(const Image& src, const Buffer<std::byte>& dst);
+    RetrieveImageCommand(const Image& src, const Buffer<std::byte>& dst,
+        const ImageRegion& region = {});
     ~RetrieveImageCommand() override;
 };
 /**
@@ -402,11 +1135,12 @@ public:
  * 
  * @param src Image source to copy from
  * @param dst Buffer destination to copy to
+ * @param region Region to copy
 */
 [[nodiscard]] inline RetrieveImageCommand retrieveImage(
-    const Image& src, const Buffer<std::byte>& dst)
+    const Image& src, const Buffer<std::byte>& dst, const ImageRegion& region = {})
 {
-    return RetrieveImageCommand(src, dst);
+    return RetrieveImageCommand(src, dst, region);
 }
 
 /**
@@ -422,6 +1156,10 @@ public:
      * @brief Destination image to copy to
     */
     std::reference_wrapper<const Image> Destination;
+    /**
+     * @brief Region to copy
+    */
+    ImageRegion Region;
 
     void record(vulkan::Command& cmd) const override;
 
@@ -436,8 +1174,10 @@ public:
      * 
      * @param src Buffer source to copy from
      * @param dst Image destination to copy to
+     * @param region Region to copy
     */
-    UpdateImageCommand(const Buffer<std::byte>& src, const Image& dst);
+    UpdateImageCommand(const Buffer<std::byte>& src, const Image& dst,
+        const ImageRegion& region = {});
     ~UpdateImageCommand() override;
 };
 /**
@@ -445,11 +1185,12 @@ public:
  * 
  * @param src Buffer source to copy from
  * @param dst Image destination to copy to
+ * @param region Region to copy
 */
 [[nodiscard]] inline UpdateImageCommand updateImage(
-    const Buffer<std::byte>& src, const Image& dst)
+    const Buffer<std::byte>& src, const Image& dst, const ImageRegion& region = {})
 {
-    return UpdateImageCommand(src, dst);
+    return UpdateImageCommand(src, dst, region);
 }
 
 /**
@@ -465,6 +1206,10 @@ public:
      * @brief Texture destination to copy to
     */
     std::reference_wrapper<const Texture> Destination;
+    /**
+     * @brief Region to copy
+    */
+    ImageRegion Region;
 
     void record(vulkan::Command& cmd) const override;
 
@@ -479,8 +1224,10 @@ public:
      * 
      * @param src Buffer source to copy from
      * @param dst Texture destination to copy to
+     * @param region Region to copy
     */
-    UpdateTextureCommand(const Buffer<std::byte>& src, const Texture& dst);
+    UpdateTextureCommand(const Buffer<std::byte>& src, const Texture& dst,
+        const ImageRegion& region = {});
     ~UpdateTextureCommand() override;
 };
 /**
@@ -488,11 +1235,212 @@ public:
  * 
  * @param src Buffer source to copy from
  * @param dst Texture destination to copy to
+ * @param region Region to copy
 */
 [[nodiscard]] inline UpdateTextureCommand updateTexture(
-    const Buffer<std::byte>& src, const Texture& dst)
+    const Buffer<std::byte>& src, const Texture& dst, const ImageRegion& region = {})
 {
-    return UpdateTextureCommand(src, dst);
+    return UpdateTextureCommand(src, dst, region);
+}
+
+/**
+ * @brief Command for copying an image into a tensor on the device
+ * 
+ * Unlike RetrieveImageCommand and UpdateImageCommand the data stays on the
+ * device. The region's buffer offset and layout refer to the tensor.
+*/
+class HEPHAISTOS_API CopyImageToTensorCommand : public Command {
+public:
+    /**
+     * @brief Image source to copy from
+    */
+    std::reference_wrapper<const Image> Source;
+    /**
+     * @brief Tensor destination to copy to
+    */
+    std::reference_wrapper<const Tensor<std::byte>> Destination;
+    /**
+     * @brief Region to copy
+    */
+    ImageRegion Region;
+
+    void record(vulkan::Command& cmd) const override;
+
+    CopyImageToTensorCommand(const CopyImageToTensorCommand& other);
+    CopyImageToTensorCommand& operator=(const CopyImageToTensorCommand& other);
+
+    CopyImageToTensorCommand(CopyImageToTensorCommand&& other) noexcept;
+    CopyImageToTensorCommand& operator=(CopyImageToTensorCommand&& other) noexcept;
+
+    /**
+     * @brief Creates a new CopyImageToTensorCommand
+     * 
+     * @param src Image source to copy from
+     * @param dst Tensor destination to copy to
+     * @param region Region to copy
+    */
+    CopyImageToTensorCommand(const Image& src, const Tensor<std::byte>& dst,
+        const ImageRegion& region = {});
+    ~CopyImageToTensorCommand() override;
+};
+/**
+ * @brief Creates a CopyImageToTensorCommand for copying an image into a tensor
+ * 
+ * @param src Image source to copy from
+ * @param dst Tensor destination to copy to
+ * @param region Region to copy
+*/
+[[nodiscard]] inline CopyImageToTensorCommand copyImageToTensor(
+    const Image& src, const Tensor<std::byte>& dst, const ImageRegion& region = {})
+{
+    return CopyImageToTensorCommand(src, dst, region);
+}
+
+/**
+ * @brief Command for copying a tensor into an image on the device
+ * 
+ * Unlike RetrieveImageCommand and UpdateImageCommand the data stays on the
+ * device. The region's buffer offset and layout refer to the tensor.
+*/
+class HEPHAISTOS_API CopyTensorToImageCommand : public Command {
+public:
+    /**
+     * @brief Tensor source to copy from
+    */
+    std::reference_wrapper<const Tensor<std::byte>> Source;
+    /**
+     * @brief Image destination to copy to
+    */
+    std::reference_wrapper<const Image> Destination;
+    /**
+     * @brief Region to copy
+    */
+    ImageRegion Region;
+
+    void record(vulkan::Command& cmd) const override;
+
+    CopyTensorToImageCommand(const CopyTensorToImageCommand& other);
+    CopyTensorToImageCommand& operator=(const CopyTensorToImageCommand& other);
+
+    CopyTensorToImageCommand(CopyTensorToImageCommand&& other) noexcept;
+    CopyTensorToImageCommand& operator=(CopyTensorToImageCommand&& other) noexcept;
+
+    /**
+     * @brief Creates a new CopyTensorToImageCommand
+     * 
+     * @param src Tensor source to copy from
+     * @param dst Image destination to copy to
+     * @param region Region to copy
+    */
+    CopyTensorToImageCommand(const Tensor<std::byte>& src, const Image& dst,
+        const ImageRegion& region = {});
+    ~CopyTensorToImageCommand() override;
+};
+/**
+ * @brief Creates a CopyTensorToImageCommand for copying a tensor into an image
+ * 
+ * @param src Tensor source to copy from
+ * @param dst Image destination to copy to
+ * @param region Region to copy
+*/
+[[nodiscard]] inline CopyTensorToImageCommand copyTensorToImage(
+    const Tensor<std::byte>& src, const Image& dst, const ImageRegion& region = {})
+{
+    return CopyTensorToImageCommand(src, dst, region);
+}
+
+/**
+ * @brief Command for copying a tensor into a texture on the device
+ * 
+ * Like UpdateTextureCommand, but the data stays on the device. Other mip
+ * levels are left untouched.
+*/
+class HEPHAISTOS_API CopyTensorToTextureCommand : public Command {
+public:
+    /**
+     * @brief Tensor source to copy from
+    */
+    std::reference_wrapper<const Tensor<std::byte>> Source;
+    /**
+     * @brief Texture destination to copy to
+    */
+    std::reference_wrapper<const Texture> Destination;
+    /**
+     * @brief Region to copy
+    */
+    ImageRegion Region;
+
+    void record(vulkan::Command& cmd) const override;
+
+    CopyTensorToTextureCommand(const CopyTensorToTextureCommand& other);
+    CopyTensorToTextureCommand& operator=(const CopyTensorToTextureCommand& other);
+
+    CopyTensorToTextureCommand(CopyTensorToTextureCommand&& other) noexcept;
+    CopyTensorToTextureCommand& operator=(CopyTensorToTextureCommand&& other) noexcept;
+
+    /**
+     * @brief Creates a new CopyTensorToTextureCommand
+     * 
+     * @param src Tensor source to copy from
+     * @param dst Texture destination to copy to
+     * @param region Region to copy
+    */
+    CopyTensorToTextureCommand(const Tensor<std::byte>& src, const Texture& dst,
+        const ImageRegion& region = {});
+    ~CopyTensorToTextureCommand() override;
+};
+/**
+ * @brief Creates a CopyTensorToTextureCommand for copying a tensor into a texture
+ * 
+ * @param src Tensor source to copy from
+ * @param dst Texture destination to copy to
+ * @param region Region to copy
+*/
+[[nodiscard]] inline CopyTensorToTextureCommand copyTensorToTexture(
+    const Tensor<std::byte>& src, const Texture& dst, const ImageRegion& region = {})
+{
+    return CopyTensorToTextureCommand(src, dst, region);
+}
+
+/**
+ * @brief Command for generating the mip chain of a texture
+ * 
+ * Fills all mip levels of the texture starting from its first one by
+ * successively downsampling the previous level on the device. Formats, which
+ * do not support linear filtering, are downsampled using nearest filtering.
+ * 
+ * @note Requires the texture's format to support blitting. Throws otherwise.
+*/
+class HEPHAISTOS_API GenerateMipmapsCommand : public Command {
+public:
+    /**
+     * @brief Texture whose mip levels to generate
+    */
+    std::reference_wrapper<const Texture> Target;
+
+    void record(vulkan::Command& cmd) const override;
+
+    GenerateMipmapsCommand(const GenerateMipmapsCommand& other);
+    GenerateMipmapsCommand& operator=(const GenerateMipmapsCommand& other);
+
+    GenerateMipmapsCommand(GenerateMipmapsCommand&& other) noexcept;
+    GenerateMipmapsCommand& operator=(GenerateMipmapsCommand&& other) noexcept;
+
+    /**
+     * @brief Creates a new GenerateMipmapsCommand
+     * 
+     * @param texture Texture whose mip levels to generate
+    */
+    explicit GenerateMipmapsCommand(const Texture& texture);
+    ~GenerateMipmapsCommand() override;
+};
+/**
+ * @brief Creates a GenerateMipmapsCommand for filling a texture's mip chain
+ * 
+ * @param texture Texture whose mip levels to generate
+*/
+[[nodiscard]] inline GenerateMipmapsCommand generateMipmaps(const Texture& texture) {
+    return GenerateMipmapsCommand(texture);
 }
 
 }
@@ -48,6 +48,10 @@ enum class ImageFormat {
      * @brief 16 bit per channel RGBA stored using unsigned integer [0,65535]
     */
     R16G16B16A16_UINT = 95,
+    /**
+     * @brief 16 bit per channel RGBA normalized to [0,1]
+    */
+    R16G16B16A16_UNORM = 91,
     /**
      * @brief 16 bit per channel RGBA stored using signed integer [-32768,32767]
     */
@@ -89,6 +93,50 @@ enum class ImageFormat {
      * @brief 32 bit per channel RGBA image stored using floats
     */
     R32G32B32A32_SFLOAT = 109,
+    /**
+     * @brief BC1 compressed RGBA normalized to [0,1] with 1 bit alpha
+    */
+    BC1_RGBA_UNORM = 133,
+    /**
+     * @brief BC3 compressed RGBA normalized to [0,1]
+    */
+    BC3_UNORM = 137,
+    /**
+     * @brief BC4 compressed single channel normalized to [0,1]
+    */
+    BC4_UNORM = 139,
+    /**
+     * @brief BC4 compressed single channel normalized to [-1,1]
+    */
+    BC4_SNORM = 140,
+    /**
+     * @brief BC5 compressed two channel normalized to [0,1]
+    */
+    BC5_UNORM = 141,
+    /**
+     * @brief BC5 compressed two channel normalized to [-1,1]
+    */
+    BC5_SNORM = 142,
+    /**
+     * @brief BC6H compressed RGB storing unsigned half floats
+    */
+    BC6H_UFLOAT = 143,
+    /**
+     * @brief BC6H compressed RGB storing signed half floats
+    */
+    BC6H_SFLOAT = 144,
+    /**
+     * @brief BC7 compressed RGBA normalized to [0,1]
+    */
+    BC7_UNORM = 145,
+    /**
+     * @brief ETC2 compressed RGBA normalized to [0,1]
+    */
+    ETC2_R8G8B8A8_UNORM = 151,
+    /**
+     * @brief ASTC compressed RGBA normalized to [0,1] using 4x4 blocks
+    */
+    ASTC_4x4_UNORM = 157,
     /**
      * @brief placeholder for unknown/unsupported format encountered in reflection
     */
@@ -98,9 +146,39 @@ enum class ImageFormat {
 /**
  * @brief Return the pixel size in bytes
  * 
+ * For block compressed formats the size of a whole block is returned.
+ * 
  * @param format ImageFormat to query
 */
 [[nodiscard]] HEPHAISTOS_API uint64_t getElementSize(ImageFormat format);
+/**
+ * @brief Checks whether the given format is block compressed
+ * 
+ * Compressed formats can only be used for textures.
+ * 
+ * @param format ImageFormat to query
+*/
+[[nodiscard]] HEPHAISTOS_API bool isCompressed(ImageFormat format);
+/**
+ * @brief Returns the width and height of a single block in pixels
+ * 
+ * Uncompressed formats are treated as consisting of 1x1 blocks.
+ * 
+ * @param format ImageFormat to query
+*/
+[[nodiscard]] HEPHAISTOS_API uint32_t getBlockExtent(ImageFormat format);
+/**
+ * @brief Returns the size of an image in bytes in a linear memory layout
+ * 
+ * Partial blocks of compressed formats at the edges count as whole ones.
+ * 
+ * @param format ImageFormat of the image
+ * @param width Width of the image in pixels
+ * @param height Height of the image in pixels
+ * @param depth Depth of the image in pixels
+*/
+[[nodiscard]] HEPHAISTOS_API uint64_t getImageSize(ImageFormat format,
+    uint32_t width, uint32_t height = 1, uint32_t depth = 1);
 
 /**
  * @brief Image format trait storing element type of a single pixel
@@ -113,6 +191,7 @@ template<> struct ImageElementType<ImageFormat::R8G8B8A8_UINT> { using ElementTy
 template<> struct ImageElementType<ImageFormat::R8G8B8A8_SINT> { using ElementType = Vec4<int8_t>; };
 
 template<> struct ImageElementType<ImageFormat::R16G16B16A16_UINT> { using ElementType = Vec4<uint16_t>; };
+template<> struct ImageElementType<ImageFormat::R16G16B16A16_UNORM> { using ElementType = Vec4<uint16_t>; };
 template<> struct ImageElementType<ImageFormat::R16G16B16A16_SINT> { using ElementType = Vec4<int16_t>; };
 
 template<> struct ImageElementType<ImageFormat::R32_UINT> { using ElementType = uint32_t; };
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "hephaistos/config.hpp"
+#include "hephaistos/context.hpp"
+#include "hephaistos/handles.hpp"
+#include "hephaistos/program.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief Creates the extensions to enable on a single device
+ *
+ * Extensions can only be used by a single context. Thus a DeviceGroup asks
+ * for a fresh list for every device it checks and creates a context on.
+*/
+using ExtensionFactory = std::function<std::vector<ExtensionHandle>()>;
+
+/**
+ * @brief Strategy for distributing work items across the devices of a group
+*/
+enum class LoadBalancing {
+    /**
+     * @brief Splits the items upfront into equally sized contiguous ranges
+     *
+     * Has no overhead, but the slowest device determines the total time.
+    */
+    STATIC,
+    /**
+     * @brief Devices fetch the next item as soon as they finished the last one
+     *
+     * Faster devices process more items. Suited for devices with different
+     * performance or items with varying cost.
+    */
+    DYNAMIC
+};
+
+/**
+ * @brief Set of contexts each running on a different device
+ *
+ * Contexts are strictly single device. A DeviceGroup bundles one context per
+ * device, so work can be spread over all of them using distribute() or
+ * gather(). Resources are not shared between the devices, i.e. each one
+ * needs its own copy, e.g. created via createPrograms().
+*/
+class HEPHAISTOS_API DeviceGroup {
+public:
+    /**
+     * @brief Returns the amount of devices in this group
+    */
+    [[nodiscard]] uint32_t size() const noexcept;
+    /**
+     * @brief Returns the context of the device with the given index
+    */
+    [[nodiscard]] const ContextHandle& getContext(uint32_t index) const;
+    /**
+     * @brief Returns the contexts of all devices in this group
+    */
+    [[nodiscard]] std::span<const ContextHandle> getContexts() const noexcept;
+
+    DeviceGroup(const DeviceGroup&);
+    DeviceGroup& operator=(const DeviceGroup&);
+
+    DeviceGroup(DeviceGroup&&) noexcept;
+    DeviceGroup& operator=(DeviceGroup&&) noexcept;
+
+    /**
+     * @brief Creates a group from existing contexts
+     *
+     * Throws if the list is empty.
+     *
+     * @param contexts Contexts forming the group
+    */
+    explicit DeviceGroup(std::vector<ContextHandle> contexts);
+    /**
+     * @brief Creates a context on every suitable device
+     *
+     * Checks every device for support of the extensions returned by the
+     * factory and creates a context on each suitable one. Discrete devices
+     * come first. Throws if no device is suitable.
+     *
+     * @param extensions Factory creating the extensions to enable per device.
+     *                   May be empty.
+     * @param maxDevices Maximum amount of devices to use. Zero uses all.
+    */
+    explicit DeviceGroup(const ExtensionFactory& extensions = {}, uint32_t maxDevices = 0);
+    ~DeviceGroup();
+
+private:
+    std::vector<ContextHandle> contexts;
+};
+
+/**
+ * @brief Creates the same program on every device of the group
+ *
+ * The program is created on the first device and its pipeline cache shared
+ * with the other devices before creating it there, so identical devices only
+ * compile the shader once.
+ *
+ * @param group Group on whose devices to create the program
+ * @param code SPIR-V byte code shared by all devices
+ * @param specialization Specialization constants data
+ * @return One program per device in the order of the group's contexts
+*/
+[[nodiscard]] HEPHAISTOS_API std::vector<Program> createPrograms(
+    const DeviceGroup& group,
+    std::span<const uint32_t> code,
+    std::span<const std::byte> specialization = {});
+
+/**
+ * @brief Runs a task for a range of items spread across the group's devices
+ *
+ * Calls task(device, item) for every item in [0, count). Each device runs
+ * its items sequentially on its own host thread, i.e. the task is expected
+ * to block until its work on the given device finished. Stops handing out
+ * new items once a task throws and rethrows the first exception after all
+ * devices finished.
+ *
+ * @param group Devices to spread the items across
+ * @param count Amount of items
+ * @param task Function called for each item with the index of the device
+ *             in the group that should process it
+ * @param balancing How to assign items to devices
+ * @return Amount of items processed per device
+*/
+HEPHAISTOS_API std::vector<uint32_t> distribute(
+    const DeviceGroup& group, uint32_t count,
+    const std::function<void(uint32_t device, uint32_t item)>& task,
+    LoadBalancing balancing = LoadBalancing::DYNAMIC);
+
+/**
+ * @brief Runs a task for a range of items and collects their results
+ *
+ * Same as distribute(), but gathers the value returned by each task.
+ *
+ * @param group Devices to spread the items across
+ * @param count Amount of items
+ * @param task Function called for each item with the index of the device
+ *             in the group that should process it
+ * @param balancing How to assign items to devices
+ * @return Result of each item in order of the items
+*/
+template<class T, class F>
+[[nodiscard]] std::vector<T> gather(
+    const DeviceGroup& group, uint32_t count, F&& task,
+    LoadBalancing balancing = LoadBalancing::DYNAMIC)
+{
+    //elements of std::vector<bool> cannot be written concurrently
+    static_assert(!std::is_same_v<T, bool>, "Use an integer type instead of bool!");
+    std::vector<T> results(count);
+    distribute(group, count, [&results, &task](uint32_t device, uint32_t item) {
+        results[item] = task(device, item);
+    }, balancing);
+    return results;
+}
+
+}
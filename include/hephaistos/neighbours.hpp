@@ -0,0 +1,241 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "hephaistos/buffer.hpp"
+#include "hephaistos/command.hpp"
+#include "hephaistos/context.hpp"
+#include "hephaistos/handles.hpp"
+#include "hephaistos/raytracing.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief Method used to find the points near a query
+*/
+enum class NeighbourMethod {
+    /**
+     * @brief Uses ray tracing if enabled, otherwise a grid
+    */
+    AUTO,
+    /**
+     * @brief Places a box around each point and finds the ones containing a
+     *        query using ray queries, i.e. hardware accelerated traversal.
+     *        Requires ray tracing to be enabled.
+    */
+    RAYTRACING,
+    /**
+     * @brief Sorts the points into a uniform grid of cells as large as the
+     *        radius, which are hashed into a table, and visits the cells
+     *        around a query
+    */
+    GRID
+};
+
+/**
+ * @brief Point found near a query
+*/
+struct Neighbour {
+    /**
+     * @brief Index of the point
+    */
+    uint32_t index;
+    /**
+     * @brief Distance between the point and the query
+    */
+    float distance;
+};
+
+/**
+ * @brief Options controlling how a NeighbourSearch runs on the device
+*/
+struct NeighbourSearchOptions {
+    /**
+     * @brief Method used to find neighbours
+    */
+    NeighbourMethod method = NeighbourMethod::AUTO;
+    /**
+     * @brief Threads per workgroup. Zero picks one based on the device.
+    */
+    uint32_t localSize = 0;
+    /**
+     * @brief Options used for building the acceleration structures
+    */
+    BuildOptions buildOptions = {};
+};
+
+/**
+ * @brief Points prepared for finding neighbours
+ *
+ * Created by NeighbourSearch::build(). Holds a copy of the points' positions
+ * as well as either an acceleration structure or a grid, thus does not
+ * reference the tensor it was built from.
+*/
+class HEPHAISTOS_API NeighbourIndex {
+public:
+    /**
+     * @brief Returns the method used to find neighbours
+    */
+    [[nodiscard]] NeighbourMethod getMethod() const noexcept;
+    /**
+     * @brief Returns the radius within neighbours are found
+    */
+    [[nodiscard]] float getRadius() const noexcept;
+    /**
+     * @brief Returns the amount of points
+    */
+    [[nodiscard]] uint32_t getCount() const noexcept;
+
+    NeighbourIndex(const NeighbourIndex&) = delete;
+    NeighbourIndex& operator=(const NeighbourIndex&) = delete;
+
+    NeighbourIndex(NeighbourIndex&& other) noexcept;
+    NeighbourIndex& operator=(NeighbourIndex&& other) noexcept;
+
+    ~NeighbourIndex();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+
+    explicit NeighbourIndex(std::unique_ptr<pImp> imp);
+    friend class NeighbourSearch;
+};
+
+/**
+ * @brief Command finding the neighbours of a tensor of queries
+ *
+ * Created by NeighbourSearch. Like DispatchCommand not synchronized with work
+ * recorded before or after unless hazard tracking is used.
+*/
+class HEPHAISTOS_API NeighbourQueryCommand : public Command {
+public:
+    void record(vulkan::Command& cmd) const override;
+
+    NeighbourQueryCommand(const NeighbourQueryCommand&);
+    NeighbourQueryCommand& operator=(const NeighbourQueryCommand&);
+
+    NeighbourQueryCommand(NeighbourQueryCommand&&) noexcept;
+    NeighbourQueryCommand& operator=(NeighbourQueryCommand&&) noexcept;
+
+    ~NeighbourQueryCommand() override;
+
+public: //internal
+    struct State;
+    explicit NeighbourQueryCommand(std::shared_ptr<const State> state);
+
+private:
+    std::shared_ptr<const State> state;
+};
+
+/**
+ * @brief Finds points within a radius of queries on the device
+ *
+ * Prepares a tensor of points via build() and creates commands finding for
+ * each query either all points within the radius or the nearest ones among
+ * them. With ray tracing each point is enclosed by a box, whose candidates
+ * reported by a short ray query starting at the query are the only points
+ * tested. Otherwise the points are hashed into a grid sorted using
+ * Primitives and the 27 cells around a query are visited.
+ *
+ * Points and queries are read as three consecutive floats each. The programs
+ * are compiled on first use.
+ *
+ * @note Commands reference the programs owned by this object as well as the
+ *       NeighbourIndex they query, which therefore must outlive them.
+*/
+class HEPHAISTOS_API NeighbourSearch {
+public:
+    /**
+     * @brief Returns the method used to find neighbours
+    */
+    [[nodiscard]] NeighbourMethod getMethod() const noexcept;
+    /**
+     * @brief Returns the amount of threads per workgroup
+    */
+    [[nodiscard]] uint32_t getLocalSize() const noexcept;
+
+    /**
+     * @brief Prepares points for finding neighbours
+     *
+     * Runs on the device and waits for it to finish.
+     *
+     * @param points Tensor holding the points
+     * @param radius Distance within points are considered neighbours
+     * @param count Amount of points. Defaults to the size of points.
+     * @param stride Stride in bytes between points. Must be a multiple of 4.
+    */
+    [[nodiscard]] NeighbourIndex build(
+        const Tensor<std::byte>& points,
+        float radius,
+        uint32_t count = std::numeric_limits<uint32_t>::max(),
+        uint32_t stride = 3 * sizeof(float)) const;
+
+    /**
+     * @brief Creates a command finding all points within the radius
+     *
+     * Writes the amount of points found per query into counts and up to
+     * maxNeighbours of them in no particular order into neighbours, starting
+     * at maxNeighbours times the index of the query. The count includes
+     * points not written if there were too many.
+     *
+     * @param index Points to search
+     * @param queries Tensor holding the queries as three floats each
+     * @param counts Tensor receiving an uint32 count per query
+     * @param neighbours Tensor receiving maxNeighbours Neighbour per query
+     * @param maxNeighbours Maximum amount of neighbours stored per query
+     * @param count Amount of queries. Defaults to the size of queries.
+    */
+    [[nodiscard]] NeighbourQueryCommand queryRadius(
+        const NeighbourIndex& index,
+        const Tensor<std::byte>& queries,
+        const Tensor<std::byte>& counts,
+        const Tensor<std::byte>& neighbours,
+        uint32_t maxNeighbours,
+        uint32_t count = std::numeric_limits<uint32_t>::max()) const;
+    /**
+     * @brief Creates a command finding the nearest points within the radius
+     *
+     * Like queryRadius(), but keeps the k nearest points ordered by their
+     * distance, ties broken by their index. The count is at most k.
+     *
+     * @param index Points to search
+     * @param queries Tensor holding the queries as three floats each
+     * @param counts Tensor receiving an uint32 count per query
+     * @param neighbours Tensor receiving k Neighbour per query
+     * @param k Amount of nearest neighbours to find
+     * @param count Amount of queries. Defaults to the size of queries.
+    */
+    [[nodiscard]] NeighbourQueryCommand queryNearest(
+        const NeighbourIndex& index,
+        const Tensor<std::byte>& queries,
+        const Tensor<std::byte>& counts,
+        const Tensor<std::byte>& neighbours,
+        uint32_t k,
+        uint32_t count = std::numeric_limits<uint32_t>::max()) const;
+
+    NeighbourSearch(const NeighbourSearch&) = delete;
+    NeighbourSearch& operator=(const NeighbourSearch&) = delete;
+
+    NeighbourSearch(NeighbourSearch&& other) noexcept;
+    NeighbourSearch& operator=(NeighbourSearch&& other) noexcept;
+
+    /**
+     * @brief Creates a new NeighbourSearch on the given context
+     *
+     * Throws if ray tracing is requested but not enabled.
+     *
+     * @param context Context on which to find neighbours
+     * @param options Options controlling how neighbours are found
+    */
+    explicit NeighbourSearch(ContextHandle context, const NeighbourSearchOptions& options = {});
+    ~NeighbourSearch();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+}
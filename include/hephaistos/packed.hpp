@@ -0,0 +1,64 @@
+#pragma once
+
+#include "hephaistos/context.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief List of features for storing and processing packed 16 and 8 bit types
+*/
+struct PackedTypesProperties {
+    /**
+     * @brief 16 bit types in storage buffers, e.g. tensors
+    */
+    bool storageBuffer16BitAccess;
+    /**
+     * @brief 16 bit types in uniform and storage buffers
+    */
+    bool uniformAndStorageBuffer16BitAccess;
+    /**
+     * @brief 16 bit types in push constants
+    */
+    bool storagePushConstant16;
+
+    /**
+     * @brief 8 bit types in storage buffers, e.g. tensors
+    */
+    bool storageBuffer8BitAccess;
+    /**
+     * @brief 8 bit types in uniform and storage buffers
+    */
+    bool uniformAndStorageBuffer8BitAccess;
+    /**
+     * @brief 8 bit types in push constants
+    */
+    bool storagePushConstant8;
+
+    /**
+     * @brief Integer dot product instructions, e.g. of packed 4x8 bit vectors
+    */
+    bool integerDotProduct;
+};
+
+/**
+ * @brief Returns the supported packed type features on the given device
+ * 
+ * @param device Device to query
+*/
+[[nodiscard]]
+HEPHAISTOS_API PackedTypesProperties getPackedTypesProperties(const DeviceHandle& device);
+/**
+ * @brief Returns the enabled packed type features in the given context
+ * 
+ * @param context Context to query
+*/
+[[nodiscard]]
+HEPHAISTOS_API const PackedTypesProperties& getEnabledPackedTypes(const ContextHandle& context);
+
+/**
+ * @brief Creates an extension to enable the specified packed type features
+*/
+[[nodiscard]]
+HEPHAISTOS_API ExtensionHandle createPackedTypesExtension(const PackedTypesProperties& properties);
+
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "hephaistos/command.hpp"
+#include "hephaistos/context.hpp"
+#include "hephaistos/handles.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief Checks for performance query support
+ *
+ * @param device Handle to device to be checked for performance query support
+ * @return True, if the given device supports performance queries, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isPerformanceQuerySupported(const DeviceHandle& device);
+/**
+ * @brief Checks wether performance queries are enabled
+ *
+ * @param context Context to check
+ * @return True, if performance queries are enabled in the given context, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isPerformanceQueryEnabled(const ContextHandle& context);
+
+/**
+ * @brief Creates a performance query extension
+ *
+ * Returns an extension which can be passed during the creation of a context to
+ * enable hardware performance counters via VK_KHR_performance_query.
+ *
+ * @return Extension for enabling performance queries
+*/
+[[nodiscard]] HEPHAISTOS_API ExtensionHandle createPerformanceQueryExtension();
+
+/**
+ * @brief Unit of a performance counter
+*/
+enum class PerformanceCounterUnit {
+    GENERIC,
+    PERCENTAGE,
+    NANOSECONDS,
+    BYTES,
+    BYTES_PER_SECOND,
+    KELVIN,
+    WATTS,
+    VOLTS,
+    AMPS,
+    HERTZ,
+    CYCLES
+};
+
+/**
+ * @brief Description of a hardware performance counter
+*/
+struct PerformanceCounter {
+    /**
+     * @brief Name of the counter as reported by the driver
+    */
+    std::string name;
+    /**
+     * @brief Category the counter belongs to
+    */
+    std::string category;
+    /**
+     * @brief Description of the counter
+    */
+    std::string description;
+    /**
+     * @brief Unit of the counter's value
+    */
+    PerformanceCounterUnit unit;
+};
+
+/**
+ * @brief Value of a performance counter measured by a PerformanceQuery
+*/
+struct PerformanceCounterResult {
+    /**
+     * @brief Name of the counter
+    */
+    std::string name;
+    /**
+     * @brief Measured value
+    */
+    double value;
+    /**
+     * @brief Unit of the value
+    */
+    PerformanceCounterUnit unit;
+};
+
+/**
+ * @brief Enumerates the performance counters available on the context
+ *
+ * Lists the counters of the context's main queue family.
+ *
+ * @param context Context with performance queries enabled
+ * @return List of available performance counters
+*/
+[[nodiscard]] HEPHAISTOS_API std::vector<PerformanceCounter> enumeratePerformanceCounters(
+    const ContextHandle& context);
+
+/**
+ * @brief Measures hardware performance counters over a region of commands
+ *
+ * Records the commands into a dedicated command buffer bracketed by a
+ * performance query. Since devices may only collect a limited amount of
+ * counters at once, the command buffer is submitted and waited on once for
+ * every pass the selected counters require. Holds the device's profiling
+ * lock during recording and all passes.
+ *
+ * @note Commands are executed once per pass. Their results must therefore
+ *       not depend on previous executions.
+*/
+class HEPHAISTOS_API PerformanceQuery : public Resource {
+public:
+    /**
+     * @brief Returns the counters measured by this query
+    */
+    [[nodiscard]] std::span<const PerformanceCounter> getCounters() const noexcept;
+    /**
+     * @brief Returns the amount of passes needed to measure all counters
+    */
+    [[nodiscard]] uint32_t getPassCount() const noexcept;
+
+    /**
+     * @brief Measures the counters over the work recorded by emitter
+     *
+     * Blocks until all passes finished.
+     *
+     * @param emitter Function recording work
+     * @return Value of each counter in the order they were specified
+    */
+    std::vector<PerformanceCounterResult> measure(
+        const std::function<void(vulkan::Command& cmd)>& emitter);
+    /**
+     * @brief Measures the counters over the given command
+     *
+     * @param command Command to run
+     * @return Value of each counter in the order they were specified
+    */
+    std::vector<PerformanceCounterResult> measure(const Command& command);
+    /**
+     * @brief Measures the counters over the given sequence of commands
+     *
+     * @param commands... Sequence of Commands to run
+     * @return Value of each counter in the order they were specified
+    */
+    template<std::derived_from<Command> ...T>
+    std::vector<PerformanceCounterResult> measureList(const T& ...commands) {
+        return measure([&commands...](vulkan::Command& cmd) {
+            (commands.record(cmd), ...);
+        });
+    }
+
+    PerformanceQuery(const PerformanceQuery&) = delete;
+    PerformanceQuery& operator=(const PerformanceQuery&) = delete;
+
+    PerformanceQuery(PerformanceQuery&& other) noexcept;
+    PerformanceQuery& operator=(PerformanceQuery&& other) noexcept;
+
+    /**
+     * @brief Creates a new PerformanceQuery on the given context
+     *
+     * Throws if performance queries are not enabled or any counter is not
+     * available.
+     *
+     * @param context Context with performance queries enabled
+     * @param counters Names of the counters to measure
+    */
+    PerformanceQuery(ContextHandle context, std::span<const std::string> counters);
+    ~PerformanceQuery() override;
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+}
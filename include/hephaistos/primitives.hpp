@@ -0,0 +1,630 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "hephaistos/buffer.hpp"
+#include "hephaistos/command.hpp"
+#include "hephaistos/config.hpp"
+#include "hephaistos/handles.hpp"
+
+namespace hephaistos {
+
+class Program;
+
+/**
+ * @brief Type of the elements processed by a primitive
+*/
+enum class ElementType {
+    INT32,
+    UINT32,
+    FLOAT32
+};
+
+/**
+ * @brief Returns the ElementType matching the given type
+*/
+template<class T>
+[[nodiscard]] constexpr ElementType getElementType() {
+    if constexpr (std::is_same_v<T, int32_t>)
+        return ElementType::INT32;
+    else if constexpr (std::is_same_v<T, uint32_t>)
+        return ElementType::UINT32;
+    else if constexpr (std::is_same_v<T, float>)
+        return ElementType::FLOAT32;
+    else
+        static_assert(!sizeof(T), "Unsupported element type!");
+}
+
+/**
+ * @brief Associative operation used to combine elements
+*/
+enum class ReduceOperation {
+    ADD,
+    MIN,
+    MAX
+};
+
+/**
+ * @brief Type of the keys sorted by a primitive
+*/
+enum class SortKeyType {
+    INT32,
+    UINT32,
+    FLOAT32,
+    INT64,
+    UINT64,
+    FLOAT64
+};
+
+/**
+ * @brief Returns the SortKeyType matching the given type
+*/
+template<class T>
+[[nodiscard]] constexpr SortKeyType getSortKeyType() {
+    if constexpr (std::is_same_v<T, int32_t>)
+        return SortKeyType::INT32;
+    else if constexpr (std::is_same_v<T, uint32_t>)
+        return SortKeyType::UINT32;
+    else if constexpr (std::is_same_v<T, float>)
+        return SortKeyType::FLOAT32;
+    else if constexpr (std::is_same_v<T, int64_t>)
+        return SortKeyType::INT64;
+    else if constexpr (std::is_same_v<T, uint64_t>)
+        return SortKeyType::UINT64;
+    else if constexpr (std::is_same_v<T, double>)
+        return SortKeyType::FLOAT64;
+    else
+        static_assert(!sizeof(T), "Unsupported key type!");
+}
+
+/**
+ * @brief Strategy used to accumulate a histogram
+*/
+enum class HistogramStrategy {
+    /**
+     * @brief Picks the strategy based on the bins and enabled atomics
+    */
+    AUTO,
+    /**
+     * @brief Accumulates directly into the output using buffer atomics
+    */
+    GLOBAL,
+    /**
+     * @brief Accumulates into a private copy of the bins per workgroup in
+     *        shared memory, which gets merged into the output afterwards
+    */
+    SHARED,
+    /**
+     * @brief Like SHARED, but first combines items of a subgroup falling
+     *        into the same bin. Lowers contention on few very full bins.
+     *        Falls back to buffer atomics if the bins exceed shared memory.
+    */
+    SUBGROUP,
+    /**
+     * @brief Sums the items of each workgroup per bin in a fixed order and
+     *        merges these partial bins in order afterwards. Produces
+     *        bit-identical float bins across runs and needs no atomics, but
+     *        its cost grows with the amount of bins.
+    */
+    DETERMINISTIC
+};
+
+/**
+ * @brief Options controlling how primitives run on the device
+*/
+struct PrimitivesOptions {
+    /**
+     * @brief Threads per workgroup. Zero picks one based on the device.
+    */
+    uint32_t localSize = 0;
+    /**
+     * @brief Elements processed per thread. Zero picks a default.
+    */
+    uint32_t itemsPerThread = 0;
+    /**
+     * @brief If true, uses subgroup arithmetic where the device supports it
+    */
+    bool useSubgroups = true;
+    /**
+     * @brief If true, reductions combine elements in a fixed order
+     *        independent of the subgroup size and float histograms default to
+     *        HistogramStrategy::DETERMINISTIC, making their results
+     *        bit-reproducible on the same device and options.
+    */
+    bool deterministic = false;
+};
+
+/**
+ * @brief Column of items moved during stream compaction or sorting
+ *
+ * Describes an array of items, e.g. a single field of a structure of arrays,
+ * inside the source and destination tensor.
+*/
+struct CompactColumn {
+    /**
+     * @brief Offset in bytes of the column inside the source tensor
+    */
+    uint64_t srcOffset;
+    /**
+     * @brief Offset in bytes of the column inside the destination tensor
+    */
+    uint64_t dstOffset;
+    /**
+     * @brief Size in bytes of a single item. Must be a multiple of 4.
+    */
+    uint32_t stride;
+};
+
+/**
+ * @brief Single pass of an indirect dispatch chain
+ *
+ * The amount of workgroups is derived on the device from an item count, e.g.
+ * written by the previous pass, by dividing it by the items processed per
+ * workgroup.
+ *
+ * @see Primitives::indirectChain
+*/
+struct IndirectPass {
+    /**
+     * @brief Program to dispatch. Its bindings are captured on creation.
+    */
+    std::reference_wrapper<const Program> program;
+    /**
+     * @brief Tensor holding the amount of items as uint32
+    */
+    std::reference_wrapper<const Tensor<std::byte>> count;
+    /**
+     * @brief Offset in bytes of the amount inside count
+    */
+    uint64_t countOffset = 0;
+    /**
+     * @brief Items processed per workgroup. Zero uses the program's local
+     *        size in X.
+    */
+    uint32_t itemsPerGroup = 0;
+    /**
+     * @brief Upper limit of the amount of workgroups
+    */
+    uint32_t maxGroups = std::numeric_limits<uint32_t>::max();
+    /**
+     * @brief Data used as push constant. May be empty.
+    */
+    std::span<const std::byte> pushData = {};
+};
+
+/**
+ * @brief Command running a parallel primitive
+ *
+ * Created by Primitives. Runs multiple dispatches synchronized among each
+ * other, but like DispatchCommand not with work recorded before or after.
+ * Owns the scratch memory it needs, thus each command may only run once at a
+ * time.
+*/
+class HEPHAISTOS_API PrimitiveCommand : public Command {
+public:
+    void record(vulkan::Command& cmd) const override;
+
+    PrimitiveCommand(const PrimitiveCommand&);
+    PrimitiveCommand& operator=(const PrimitiveCommand&);
+
+    PrimitiveCommand(PrimitiveCommand&&) noexcept;
+    PrimitiveCommand& operator=(PrimitiveCommand&&) noexcept;
+
+    ~PrimitiveCommand() override;
+
+public: //internal
+    struct State;
+    explicit PrimitiveCommand(std::shared_ptr<const State> state);
+
+private:
+    std::shared_ptr<const State> state;
+};
+
+/**
+ * @brief Library of common parallel primitives
+ *
+ * Provides prefix sums, reductions and stream compaction on tensors of 32 bit
+ * elements as well as radix sort of 32 and 64 bit keys. The required programs
+ * are compiled on first use and cached. Scans run in a single pass using
+ * decoupled look-back, while reductions reduce the elements in multiple
+ * passes. Sorting runs a single histogram pass followed by one pass per digit
+ * of 8 bits, each using decoupled look-back per digit (onesweep). Histograms
+ * privatize their bins in shared memory where possible. Sparse tensors can be
+ * compressed by eliminating zero words before retrieving them.
+ * Workgroups use subgroup arithmetic and ballots if supported by the device.
+ * Float sums may thus differ in their last bits between runs, unless the
+ * library is created deterministic, in which case reductions and float
+ * histograms combine elements in a fixed order.
+ *
+ * Elements are accessed via their device address, thus tensors are not bound
+ * and the same programs can be used by multiple commands at once.
+ *
+ * @note Commands reference the programs owned by this object, which
+ *       therefore must outlive them.
+*/
+class HEPHAISTOS_API Primitives {
+public:
+    /**
+     * @brief Returns the amount of threads per workgroup
+    */
+    [[nodiscard]] uint32_t getLocalSize() const noexcept;
+    /**
+     * @brief Returns the amount of elements processed per workgroup
+    */
+    [[nodiscard]] uint32_t getTileSize() const noexcept;
+    /**
+     * @brief True, if the programs use subgroup arithmetic
+    */
+    [[nodiscard]] bool usesSubgroups() const noexcept;
+    /**
+     * @brief True, if reductions and float histograms are deterministic
+    */
+    [[nodiscard]] bool isDeterministic() const noexcept;
+
+    /**
+     * @brief Creates a command computing the inclusive scan of a tensor
+     *
+     * Input and output may be the same tensor.
+     *
+     * @param input Tensor holding the elements to scan
+     * @param output Tensor the scan is written to
+     * @param type Type of the elements
+     * @param op Operation combining the elements
+     * @param count Amount of elements. Defaults to the size of input.
+    */
+    [[nodiscard]] PrimitiveCommand inclusiveScan(
+        const Tensor<std::byte>& input,
+        const Tensor<std::byte>& output,
+        ElementType type,
+        ReduceOperation op = ReduceOperation::ADD,
+        uint32_t count = std::numeric_limits<uint32_t>::max()) const;
+    /**
+     * @brief Creates a command computing the inclusive scan of a tensor in
+     *        place
+     *
+     * @param tensor Tensor holding the elements to scan
+     * @param op Operation combining the elements
+    */
+    template<class T>
+    [[nodiscard]] PrimitiveCommand inclusiveScan(
+        const Tensor<T>& tensor,
+        ReduceOperation op = ReduceOperation::ADD) const
+    {
+        return inclusiveScan(tensor, tensor, getElementType<T>(), op);
+    }
+    /**
+     * @brief Creates a command computing the exclusive scan of a tensor
+     *
+     * Input and output may be the same tensor.
+     *
+     * @param input Tensor holding the elements to scan
+     * @param output Tensor the scan is written to
+     * @param type Type of the elements
+     * @param op Operation combining the elements
+     * @param count Amount of elements. Defaults to the size of input.
+    */
+    [[nodiscard]] PrimitiveCommand exclusiveScan(
+        const Tensor<std::byte>& input,
+        const Tensor<std::byte>& output,
+        ElementType type,
+        ReduceOperation op = ReduceOperation::ADD,
+        uint32_t count = std::numeric_limits<uint32_t>::max()) const;
+    /**
+     * @brief Creates a command computing the exclusive scan of a tensor in
+     *        place
+     *
+     * @param tensor Tensor holding the elements to scan
+     * @param op Operation combining the elements
+    */
+    template<class T>
+    [[nodiscard]] PrimitiveCommand exclusiveScan(
+        const Tensor<T>& tensor,
+        ReduceOperation op = ReduceOperation::ADD) const
+    {
+        return exclusiveScan(tensor, tensor, getElementType<T>(), op);
+    }
+
+    /**
+     * @brief Creates a command reducing a tensor to a single element
+     *
+     * @param input Tensor holding the elements to reduce
+     * @param output Tensor the result is written to as its first element
+     * @param type Type of the elements
+     * @param op Operation combining the elements
+     * @param count Amount of elements. Defaults to the size of input.
+    */
+    [[nodiscard]] PrimitiveCommand reduce(
+        const Tensor<std::byte>& input,
+        const Tensor<std::byte>& output,
+        ElementType type,
+        ReduceOperation op = ReduceOperation::ADD,
+        uint32_t count = std::numeric_limits<uint32_t>::max()) const;
+    /**
+     * @brief Creates a command reducing a tensor to a single element
+     *
+     * @param input Tensor holding the elements to reduce
+     * @param output Tensor the result is written to as its first element
+     * @param op Operation combining the elements
+    */
+    template<class T>
+    [[nodiscard]] PrimitiveCommand reduce(
+        const Tensor<T>& input,
+        const Tensor<T>& output,
+        ReduceOperation op = ReduceOperation::ADD) const
+    {
+        return reduce(input, output, getElementType<T>(), op);
+    }
+
+    /**
+     * @brief Creates a command compacting items based on a tensor of flags
+     *
+     * Moves each item whose flag is non zero from the source to the
+     * destination tensor while preserving their order. Items may span
+     * multiple columns, e.g. the fields of a structure of arrays, which are
+     * moved alike.
+     *
+     * @param flags Tensor holding a uint32 flag per item
+     * @param src Tensor holding the items to compact
+     * @param dst Tensor receiving the kept items. Must differ from src.
+     * @param columns Columns of the items inside the tensors
+     * @param count Amount of items. Defaults to the size of flags.
+     * @param countTensor Optional tensor receiving the amount of kept items
+     * @param countOffset Offset in bytes the amount is written to
+    */
+    [[nodiscard]] PrimitiveCommand compact(
+        const Tensor<std::byte>& flags,
+        const Tensor<std::byte>& src,
+        const Tensor<std::byte>& dst,
+        std::span<const CompactColumn> columns,
+        uint32_t count = std::numeric_limits<uint32_t>::max(),
+        const Tensor<std::byte>* countTensor = nullptr,
+        uint64_t countOffset = 0) const;
+
+    /**
+     * @brief Creates a command sorting keys in place
+     *
+     * The sort is stable. Optional values are moved alike.
+     *
+     * @param keys Tensor holding the keys to sort
+     * @param type Type of the keys
+     * @param count Amount of keys. Defaults to the size of keys.
+     * @param values Optional tensor holding a value per key
+     * @param valueStride Size in bytes of a single value. Must be a multiple of 4.
+    */
+    [[nodiscard]] PrimitiveCommand sort(
+        const Tensor<std::byte>& keys,
+        SortKeyType type,
+        uint32_t count = std::numeric_limits<uint32_t>::max(),
+        const Tensor<std::byte>* values = nullptr,
+        uint32_t valueStride = 4) const;
+    /**
+     * @brief Creates a command sorting keys in place
+     *
+     * @param keys Tensor holding the keys to sort
+    */
+    template<class T>
+    [[nodiscard]] PrimitiveCommand sort(const Tensor<T>& keys) const {
+        return sort(keys, getSortKeyType<T>());
+    }
+    /**
+     * @brief Creates a command computing the permutation sorting the keys
+     *
+     * Writes the index of the key for each position in sorted order, i.e. a
+     * stable argsort. The keys are left unchanged.
+     *
+     * @param keys Tensor holding the keys to sort
+     * @param indices Tensor receiving an uint32 index per key
+     * @param type Type of the keys
+     * @param count Amount of keys. Defaults to the size of keys.
+    */
+    [[nodiscard]] PrimitiveCommand sortIndices(
+        const Tensor<std::byte>& keys,
+        const Tensor<std::byte>& indices,
+        SortKeyType type,
+        uint32_t count = std::numeric_limits<uint32_t>::max()) const;
+    /**
+     * @brief Creates a command sorting items spanning multiple columns
+     *
+     * Moves the items from the source to the destination tensor ordered by a
+     * key column inside the source, e.g. sorting the structure of arrays of
+     * a queue by one of its fields. The sort is stable.
+     *
+     * @param src Tensor holding the items to sort
+     * @param dst Tensor receiving the sorted items. Must differ from src.
+     * @param type Type of the keys
+     * @param keyOffset Offset in bytes of the key column inside src
+     * @param columns Columns of the items moved to dst
+     * @param count Amount of items
+     * @param countOffset Optional offset in bytes of an uint32 inside src
+     *                    limiting the amount of items, e.g. the counter of a
+     *                    queue. Copied into dst at the same offset.
+    */
+    [[nodiscard]] PrimitiveCommand sortColumns(
+        const Tensor<std::byte>& src,
+        const Tensor<std::byte>& dst,
+        SortKeyType type,
+        uint64_t keyOffset,
+        std::span<const CompactColumn> columns,
+        uint32_t count,
+        std::optional<uint64_t> countOffset = std::nullopt) const;
+
+    /**
+     * @brief Returns the strategy used for histograms of the given type and
+     *        amount of bins
+     *
+     * @param type Type of the bins
+     * @param binCount Amount of bins
+     * @param strategy Requested strategy
+    */
+    [[nodiscard]] HistogramStrategy getHistogramStrategy(
+        ElementType type, uint32_t binCount,
+        HistogramStrategy strategy = HistogramStrategy::AUTO) const;
+    /**
+     * @brief Creates a command accumulating items into a histogram
+     *
+     * Adds one or the item's weight to the bin given by the item's index.
+     * Items with indices outside of the histogram are skipped. Previous
+     * contents of the histogram are kept, i.e. multiple commands accumulate.
+     * Float bins require the corresponding atomic add being enabled, unless
+     * accumulated deterministically.
+     *
+     * @param indices Tensor holding an uint32 bin index per item
+     * @param histogram Tensor holding the bins. Its size defines their amount.
+     * @param type Type of the bins and weights
+     * @param weights Optional tensor holding a weight per item
+     * @param count Amount of items. Defaults to the size of indices.
+     * @param strategy Strategy used to accumulate the bins
+    */
+    [[nodiscard]] PrimitiveCommand histogram(
+        const Tensor<std::byte>& indices,
+        const Tensor<std::byte>& histogram,
+        ElementType type = ElementType::UINT32,
+        const Tensor<std::byte>* weights = nullptr,
+        uint32_t count = std::numeric_limits<uint32_t>::max(),
+        HistogramStrategy strategy = HistogramStrategy::AUTO) const;
+
+    /**
+     * @brief Creates a command copying the live prefix of items counted on
+     *        the device
+     *
+     * Reads the amount of items from an uint32 inside src, e.g. the counter
+     * of a queue, and only copies that many items of each column, clamped to
+     * the capacity, without a round trip to the host. The amount is copied
+     * into dst at the same offset. If dst is mapped, the device writes only
+     * the live prefix into host visible memory, from which the host reads it
+     * directly, i.e. a queue is read back in a single submission without
+     * transferring its whole capacity.
+     *
+     * @param src Tensor holding the count and the items
+     * @param dst Tensor receiving the count and the items. Must differ from src.
+     * @param countOffset Offset in bytes of the uint32 count inside src and dst
+     * @param columns Columns of the items inside the tensors
+     * @param capacity Maximum amount of items
+    */
+    [[nodiscard]] PrimitiveCommand copyPrefix(
+        const Tensor<std::byte>& src,
+        const Tensor<std::byte>& dst,
+        uint64_t countOffset,
+        std::span<const CompactColumn> columns,
+        uint32_t capacity) const;
+
+    /**
+     * @brief Creates a command compressing a tensor of 32 bit words
+     *
+     * Writes a stream eliminating zero words, suited for sparse data like
+     * histograms or mostly empty queues before retrieving them. The stream
+     * starts with the amount of words and the amount of non zero words as
+     * uint32 followed by a mask of the non zero words per block of 32 words
+     * and finally the non zero words in order. Its total size is given by
+     * getCompressedSize() on the header, e.g. retrieved first or read from a
+     * mapped tensor, so only the compressed part needs to be retrieved.
+     * Decode it on the host using decompressData().
+     *
+     * @param input Tensor holding the words to compress
+     * @param output Tensor receiving the stream. Must differ from input and
+     *               hold at least getMaxCompressedSize() bytes.
+     * @param count Amount of words. Defaults to the size of input.
+    */
+    [[nodiscard]] PrimitiveCommand compress(
+        const Tensor<std::byte>& input,
+        const Tensor<std::byte>& output,
+        uint32_t count = std::numeric_limits<uint32_t>::max()) const;
+    /**
+     * @brief Creates a command decompressing a stream into a tensor
+     *
+     * Inverse of compress(), e.g. for uploading a stream created on the host
+     * via compressData(). Zero words are written too, i.e. the previous
+     * contents of the output are overwritten.
+     *
+     * @param input Tensor holding the compressed stream
+     * @param output Tensor receiving the words. Must differ from input.
+     * @param count Amount of words. Must match the stream. Defaults to the
+     *              size of output.
+    */
+    [[nodiscard]] PrimitiveCommand decompress(
+        const Tensor<std::byte>& input,
+        const Tensor<std::byte>& output,
+        uint32_t count = std::numeric_limits<uint32_t>::max()) const;
+
+    /**
+     * @brief Creates a command running a chain of indirect dispatches
+     *
+     * Before each pass a built-in kernel reads the pass' item count and
+     * writes its indirect dispatch arguments, dividing the count by the
+     * items per workgroup rounding up and clamping it to the pass' maximum
+     * as well as the device's limit. Thus each pass may size the next one
+     * without a round trip to the host. Passes are only separated by a
+     * single barrier each, also covering their arguments.
+     *
+     * @param passes Passes to run in the given order
+    */
+    [[nodiscard]] PrimitiveCommand indirectChain(std::span<const IndirectPass> passes) const;
+
+    Primitives(const Primitives&) = delete;
+    Primitives& operator=(const Primitives&) = delete;
+
+    Primitives(Primitives&& other) noexcept;
+    Primitives& operator=(Primitives&& other) noexcept;
+
+    /**
+     * @brief Creates a new primitives library on the given context
+     *
+     * @param context Context on which to run the primitives
+     * @param options Options controlling how primitives run on the device
+    */
+    explicit Primitives(ContextHandle context, const PrimitivesOptions& options = {});
+    ~Primitives();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Returns the size in bytes a compressed stream of the given amount
+ *        of 32 bit words occupies at most
+*/
+[[nodiscard]] constexpr uint64_t getMaxCompressedSize(uint32_t count) noexcept {
+    return 4ull * (2ull + (uint64_t(count) + 31) / 32 + count);
+}
+/**
+ * @brief Returns the size in bytes of a compressed stream
+ *
+ * Only reads the header, i.e. the first 8 bytes of the stream.
+*/
+[[nodiscard]] HEPHAISTOS_API uint64_t getCompressedSize(std::span<const std::byte> stream);
+/**
+ * @brief Returns the size in bytes of the data stored in a compressed stream
+ *
+ * Only reads the header, i.e. the first 8 bytes of the stream.
+*/
+[[nodiscard]] HEPHAISTOS_API uint64_t getDecompressedSize(std::span<const std::byte> stream);
+
+/**
+ * @brief Compresses 32 bit words on the host
+ *
+ * Creates the same stream as Primitives::compress(), e.g. to upload sparse
+ * data and decompress it on the device.
+ *
+ * @param data Words to compress. Size must be a multiple of 4.
+*/
+[[nodiscard]] HEPHAISTOS_API std::vector<std::byte> compressData(std::span<const std::byte> data);
+/**
+ * @brief Decompresses a stream on the host
+ *
+ * Decodes streams created by Primitives::compress() or compressData().
+ * Blocks without or of only non zero words are copied as a whole.
+ *
+ * @param stream Compressed stream
+ * @param data Destination of the words. Must hold getDecompressedSize() bytes.
+*/
+HEPHAISTOS_API void decompressData(std::span<const std::byte> stream, std::span<std::byte> data);
+
+}
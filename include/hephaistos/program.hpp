@@ -1,7 +1,14 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <future>
+#include <memory>
 #include <optional>
 #include <span>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
@@ -12,8 +19,13 @@
 
 namespace hephaistos {
 
+class Compiler;
+
 namespace vulkan {
+    struct ParameterSet;
     struct Program;
+    struct RayTracingProgram;
+    struct ResourceHeap;
 }
 
 /**
@@ -24,6 +36,22 @@ struct SubgroupProperties {
      * @brief Threads per subgroup
     */
     uint32_t subgroupSize;
+    /**
+     * @brief Minimum threads per subgroup a program may run with
+    */
+    uint32_t minSubgroupSize;
+    /**
+     * @brief Maximum threads per subgroup a program may run with
+    */
+    uint32_t maxSubgroupSize;
+    /**
+     * @brief Support for requiring a subgroup size in programs
+    */
+    bool requiredSubgroupSizeSupport;
+    /**
+     * @brief Support for requiring full subgroups in programs
+    */
+    bool fullSubgroupsSupport;
     /**
      * @brief Support for GL_KHR_shader_subgroup_basic
     */
@@ -81,6 +109,30 @@ struct SubgroupProperties {
 [[nodiscard]] HEPHAISTOS_API SubgroupProperties
     getSubgroupProperties(const ContextHandle& context);
 
+/**
+ * @brief Requirements on the subgroups a program runs with
+ * 
+ * On devices with variable subgroup sizes the driver otherwise picks any size
+ * between SubgroupProperties::minSubgroupSize and maxSubgroupSize. Requires
+ * the corresponding support in SubgroupProperties.
+*/
+struct SubgroupRequirements {
+    /**
+     * @brief Threads per subgroup the program must run with
+     * 
+     * Must be a power of two within the range given by SubgroupProperties.
+     * Zero lets the driver choose.
+    */
+    uint32_t size = 0;
+    /**
+     * @brief If true, all subgroups of a workgroup must be full
+     * 
+     * Requires the workgroup's size in X to be a multiple of the required or
+     * maximum subgroup size.
+    */
+    bool fullSubgroups = false;
+};
+
 /**
  * @brief Parameter Type
  * 
@@ -91,11 +143,11 @@ enum class ParameterType {
     //SAMPLER = 0,
     
     COMBINED_IMAGE_SAMPLER = 1,
-    //SAMPLED_IMAGE = 2,
+    SAMPLED_IMAGE = 2,
     
     STORAGE_IMAGE = 3,
-    //UNIFORM_TEXEL_BUFFER = 4,
-    //STORAGE_TEXEL_BUFFER = 5,
+    UNIFORM_TEXEL_BUFFER = 4,
+    STORAGE_TEXEL_BUFFER = 5,
     
     UNIFORM_BUFFER = 6,
     STORAGE_BUFFER = 7,
@@ -117,6 +169,89 @@ struct ImageBindingTraits {
      * @brief Number of dimension the image has
     */
     uint8_t dims;
+    /**
+     * @brief Whether the binding expects an array image
+    */
+    bool arrayed;
+};
+
+/**
+ * @brief Base type of a member inside a block
+*/
+enum class MemberType {
+    STRUCT,
+    BOOL,
+    INT,
+    UINT,
+    FLOAT
+};
+
+/**
+ * @brief Layout of a single member of a buffer or push constant block
+ *
+ * Describes the layout the shader was compiled with, e.g. std430 or scalar,
+ * allowing host structs to be checked or generated to match it exactly.
+*/
+struct BlockMember {
+    /**
+     * @brief Name of the member
+     *
+     * May be empty if the compiler stripped away this information.
+    */
+    std::string name;
+    /**
+     * @brief Offset in bytes relative to the start of the enclosing block
+     *        or struct
+    */
+    uint32_t offset;
+    /**
+     * @brief Size in bytes occupied by the member including all array elements
+     *
+     * Zero for runtime arrays.
+    */
+    uint32_t size;
+    /**
+     * @brief Base type of the member
+    */
+    MemberType type;
+    /**
+     * @brief Size of a single scalar in bits. Zero for structs.
+    */
+    uint32_t width;
+    /**
+     * @brief Amount of vector components; one for scalars
+     *
+     * For matrices this denotes the amount of rows.
+    */
+    uint32_t components;
+    /**
+     * @brief Amount of matrix columns; one if not a matrix
+    */
+    uint32_t columns;
+    /**
+     * @brief Bytes between consecutive columns, or rows if rowMajor is set.
+     *        Zero if not a matrix.
+    */
+    uint32_t matrixStride;
+    /**
+     * @brief Whether the matrix is stored in row major order
+    */
+    bool rowMajor;
+    /**
+     * @brief Size of each array dimension, outermost first
+     *
+     * Empty if the member is not an array. A size of zero denotes a
+     * runtime array.
+    */
+    std::vector<uint32_t> arrayDims;
+    /**
+     * @brief Bytes between consecutive array elements. Zero if not an array.
+    */
+    uint32_t arrayStride;
+    /**
+     * @brief Members of a struct in declaration order
+    */
+    std::vector<BlockMember> members;
 };
 
 /**
@@ -157,10 +292,19 @@ struct BindingTraits {
      * will give the size of the array. A value of zero denotes a runtime array.
     */
     uint32_t count;
+    /**
+     * @brief Layout of the block members
+     *
+     * Only set for uniform and storage buffers.
+    */
+    std::vector<BlockMember> members;
 };
 
 /**
  * @brief Command for executing a program using the given group size 
+ * 
+ * Group counts exceeding the device's limits are split into multiple
+ * dispatches using base offsets.
 */
 class HEPHAISTOS_API DispatchCommand : public Command {
 public:
@@ -181,16 +325,48 @@ public:
      * 
      * Data used as push constant, e.g. a simple struct.
      * May be empty, i.e. zero sized, if no push data should be sent.
+     * Must stay alive until the command is recorded unless copied into the
+     * command via copyPushData().
     */
     std::span<const std::byte> pushData;
 
+    /**
+     * @brief Size of push data stored inside the command without allocation
+    */
+    static constexpr size_t InlinePushSize = 128;
+
+    /**
+     * @brief Copies the push data into the command
+     * 
+     * Afterwards, pushData points into the command itself instead of the
+     * memory it was created with, which thus may go out of scope before the
+     * command gets recorded, e.g. a struct on the stack. Copies of the command
+     * point into their own copy. Data of up to InlinePushSize bytes does not
+     * allocate.
+     * 
+     * @return This command
+    */
+    DispatchCommand& copyPushData() &;
+    /**
+     * @brief Copies the push data into the command
+     * 
+     * Afterwards, pushData points into the command itself instead of the
+     * memory it was created with, which thus may go out of scope before the
+     * command gets recorded, e.g. a struct on the stack. Copies of the command
+     * point into their own copy. Data of up to InlinePushSize bytes does not
+     * allocate.
+     * 
+     * @return This command
+    */
+    [[nodiscard]] DispatchCommand copyPushData() &&;
+
     void record(vulkan::Command& cmd) const override;
 
-    DispatchCommand(const DispatchCommand&);
-    DispatchCommand& operator=(const DispatchCommand&);
+    DispatchCommand(const DispatchCommand& other);
+    DispatchCommand& operator=(const DispatchCommand& other);
 
-    DispatchCommand(DispatchCommand&&) noexcept;
-    DispatchCommand& operator=(DispatchCommand&&) noexcept;
+    DispatchCommand(DispatchCommand&& other) noexcept;
+    DispatchCommand& operator=(DispatchCommand&& other) noexcept;
 
     /**
      * @brief Creates a new DispatchCommand for the given program
@@ -205,11 +381,53 @@ public:
         const vulkan::Program& program,
         uint32_t x, uint32_t y, uint32_t z,
         std::span<const std::byte> push);
+    /**
+     * @brief Creates a new DispatchCommand for the given program using the
+     *        parameters of the given set
+     * 
+     * @param program Program to dispatch
+     * @param set ParameterSet providing the parameters
+     * @param x Amount of groups in X dimension
+     * @param y Amount of groups in Y dimension
+     * @param z Amount of groups in Z dimension
+     * @param push Data used as push constant
+    */
+    DispatchCommand(
+        const vulkan::Program& program,
+        const vulkan::ParameterSet& set,
+        uint32_t x, uint32_t y, uint32_t z,
+        std::span<const std::byte> push);
+    /**
+     * @brief Creates a new DispatchCommand for the given program using the
+     *        resources of the given heap
+     * 
+     * @param program Program to dispatch
+     * @param heap ResourceHeap providing the resources
+     * @param x Amount of groups in X dimension
+     * @param y Amount of groups in Y dimension
+     * @param z Amount of groups in Z dimension
+     * @param push Data used as push constant
+    */
+    DispatchCommand(
+        const vulkan::Program& program,
+        const vulkan::ResourceHeap& heap,
+        uint32_t x, uint32_t y, uint32_t z,
+        std::span<const std::byte> push);
     ~DispatchCommand() override;
 
 private:
     std::reference_wrapper<const vulkan::Program> program;
-    std::vector<VkWriteDescriptorSet> params;
+    //shared with the program until its bindings change
+    std::shared_ptr<const std::vector<VkWriteDescriptorSet>> params;
+    const vulkan::ParameterSet* set;
+    const vulkan::ResourceHeap* heap;
+    //copy of the push data made by copyPushData(); larger data is allocated
+    //and shared between copies as it is never modified
+    std::array<std::byte, InlinePushSize> inlinePush{};
+    std::shared_ptr<const std::byte[]> heapPush;
+
+    //points pushData into the own storage if other's points into its own
+    void rebasePushData(const DispatchCommand& other) noexcept;
 };
 
 /**
@@ -281,9 +499,61 @@ public:
     ~DispatchIndirectCommand() override;
 
 private:
+    //sync: whether to record a barrier for the indirect data
+    void record(vulkan::Command& cmd, bool sync) const;
+    friend class DispatchIndirectListCommand;
+    friend class PrimitiveCommand;
+
     std::reference_wrapper<const vulkan::Program> program;
-    std::vector<VkWriteDescriptorSet> params;
+    //shared with the program until its bindings change
+    std::shared_ptr<const std::vector<VkWriteDescriptorSet>> params;
+};
+
+/**
+ * @brief Command for running a list of indirect dispatches at once
+ *
+ * Each dispatch may use a different program and push data, while the amount
+ * of groups is read from device memory. Since a dispatch with zero groups does
+ * nothing, programs running earlier can decide on the device which work runs
+ * next and how much without a round trip to the host. Compared to recording
+ * each DispatchIndirectCommand on its own, the indirect data is synchronized
+ * only once for the whole list.
+*/
+class HEPHAISTOS_API DispatchIndirectListCommand : public Command {
+public:
+    /**
+     * @brief Dispatches to run in the given order
+    */
+    std::vector<DispatchIndirectCommand> dispatches;
+
+    void record(vulkan::Command& cmd) const override;
+
+    DispatchIndirectListCommand(const DispatchIndirectListCommand&);
+    DispatchIndirectListCommand& operator=(const DispatchIndirectListCommand&);
+
+    DispatchIndirectListCommand(DispatchIndirectListCommand&&) noexcept;
+    DispatchIndirectListCommand& operator=(DispatchIndirectListCommand&&) noexcept;
+
+    /**
+     * @brief Creates a new DispatchIndirectListCommand
+     *
+     * @param dispatches Dispatches to run in the given order
+    */
+    explicit DispatchIndirectListCommand(std::vector<DispatchIndirectCommand> dispatches);
+    ~DispatchIndirectListCommand() override;
 };
+/**
+ * @brief Creates a command running the given indirect dispatches at once
+ *
+ * @param dispatches Dispatches to run in the given order
+ * @return DispatchIndirectListCommand running the dispatches
+*/
+[[nodiscard]] inline DispatchIndirectListCommand dispatchIndirectList(
+    std::span<const DispatchIndirectCommand> dispatches)
+{
+    return DispatchIndirectListCommand(std::vector<DispatchIndirectCommand>(
+        dispatches.begin(), dispatches.end()));
+}
 
 /**
  * @brief Shape of a workgroup
@@ -306,6 +576,64 @@ struct LocalSize {
     uint32_t z;
 };
 
+/**
+ * @brief Statistic about a compiled program reported by the driver
+*/
+struct ProgramStatistic {
+    /**
+     * @brief Name of the statistic
+    */
+    std::string name;
+    /**
+     * @brief Description of the statistic
+    */
+    std::string description;
+    /**
+     * @brief Value of the statistic
+    */
+    double value;
+};
+
+/**
+ * @brief Resource usage and expected occupancy of a program
+ *
+ * Shared memory is derived from the shader code, while registers are only
+ * known if the driver reports them. The occupancy assumes 2048 resident
+ * threads per compute unit and the device's shared memory limit per
+ * compute unit and does not account for registers.
+*/
+struct ProgramStatistics {
+    /**
+     * @brief Bytes of shared memory used by a single workgroup
+     *
+     * Arrays sized by specialization constants use their default size.
+    */
+    uint32_t sharedMemorySize;
+    /**
+     * @brief Registers used per thread if reported by the driver
+    */
+    std::optional<uint32_t> registerCount;
+    /**
+     * @brief Workgroups expected to be resident on a compute unit at once
+    */
+    uint32_t residentGroups;
+    /**
+     * @brief Fraction of a compute unit's thread slots filled by resident
+     * workgroups
+    */
+    float occupancy;
+    /**
+     * @brief Statistics reported by the driver
+     *
+     * Empty if VK_KHR_pipeline_executable_properties is not supported or
+     * the program was created as shader object.
+    */
+    std::vector<ProgramStatistic> driverStatistics;
+};
+
+class ParameterSet;
+class ResourceHeap;
+
 /**
  * @brief Program containing shader code to run on the device.
  * 
@@ -367,10 +695,31 @@ public:
      * @return Vector of BindingTraits one for each binding
     */
     [[nodiscard]] const std::vector<BindingTraits>& listBindings() const noexcept;
+    /**
+     * @brief Returns the size of the push constant block in bytes
+     *
+     * Zero if the program does not use push constants.
+    */
+    [[nodiscard]] uint32_t getPushConstantSize() const noexcept;
+    /**
+     * @brief Returns the layout of the push constant block members
+     *
+     * Empty if the program does not use push constants.
+    */
+    [[nodiscard]] const std::vector<BlockMember>& getPushConstantMembers() const noexcept;
+    /**
+     * @brief Checks whether the program binds cached descriptor sets
+     *
+     * True if created while setDescriptorSetCache() was enabled or if the
+     * program has more descriptors than the device can push.
+    */
+    [[nodiscard]] bool usesDescriptorSetCache() const noexcept;
 
     /**
      * @brief Binds the given parameter
      * 
+     * Binding a single parameter to an array binding binds its first element.
+     * 
      * @param param Parameter to bind
      * @param binding Binding number to bind the parameter to
     */
@@ -381,6 +730,8 @@ public:
     /**
      * @brief Binds the given parameter
      * 
+     * Binding a single parameter to an array binding binds its first element.
+     * 
      * @param param Parameter to bind
      * @param binding Name of the binding to bind the parameter to
     */
@@ -401,6 +752,32 @@ public:
         uint32_t binding = 0;
         (param.bindParameter(getBinding(binding++)),...);
     }
+    /**
+     * @brief Binds the given parameters to the elements of an array binding
+     * 
+     * All elements are written using a single descriptor update. Binding fewer
+     * parameters than the array holds leaves the remaining elements unbound,
+     * which requires partially bound arrays, i.e. isPartiallyBoundEnabled().
+     * The shader must then not access the unbound elements. Runtime arrays
+     * can only be used with a ResourceHeap.
+     * 
+     * @param params Parameters to bind in order of the array's elements
+     * @param binding Binding number of the array
+    */
+    void bindParameterArray(std::span<const Argument* const> params, uint32_t binding);
+    /**
+     * @brief Binds the given parameters to the elements of an array binding
+     * 
+     * All elements are written using a single descriptor update. Binding fewer
+     * parameters than the array holds leaves the remaining elements unbound,
+     * which requires partially bound arrays, i.e. isPartiallyBoundEnabled().
+     * The shader must then not access the unbound elements. Runtime arrays
+     * can only be used with a ResourceHeap.
+     * 
+     * @param params Parameters to bind in order of the array's elements
+     * @param binding Name of the array binding
+    */
+    void bindParameterArray(std::span<const Argument* const> params, std::string_view binding);
 
     /**
      * @brief Dispatches the current program
@@ -437,6 +814,149 @@ public:
     [[nodiscard]] DispatchCommand dispatch(const T& push, uint32_t x = 1, uint32_t y = 1, uint32_t z = 1) const {
         return dispatch({ reinterpret_cast<const std::byte*>(&push), sizeof(T)}, x, y, z);
     }
+    /**
+     * @brief Dispatches the current program covering the given amount of
+     *        elements
+     * 
+     * Derives the amount of groups from the program's local size, rounding up.
+     * As with any dispatch, grids exceeding the device's limit of groups per
+     * dispatch are split into multiple dispatches using base offsets, so
+     * gl_GlobalInvocationID and gl_WorkGroupID stay the same, but
+     * gl_NumWorkGroups only reports the size of each part.
+     * 
+     * @note Shaders must check for out of bounds invocations when the amount
+     *       of elements is not a multiple of the local size.
+     * 
+     * @param push Additional push data
+     * @param nx Amount of elements in X dimension
+     * @param ny Amount of elements in Y dimension
+     * @param nz Amount of elements in Z dimension
+     * @return DispatchCommand to issue a dispatch
+    */
+    [[nodiscard]] DispatchCommand dispatchElements(
+        std::span<const std::byte> push,
+        uint32_t nx, uint32_t ny = 1, uint32_t nz = 1) const;
+    /**
+     * @brief Dispatches the current program covering the given amount of
+     *        elements
+     * 
+     * @param nx Amount of elements in X dimension
+     * @param ny Amount of elements in Y dimension
+     * @param nz Amount of elements in Z dimension
+     * @return DispatchCommand to issue a dispatch
+    */
+    [[nodiscard]] DispatchCommand dispatchElements(
+        uint32_t nx, uint32_t ny = 1, uint32_t nz = 1) const;
+    /**
+     * @brief Dispatches the current program covering the given amount of
+     *        elements
+     * 
+     * @param push Additional push data
+     * @param nx Amount of elements in X dimension
+     * @param ny Amount of elements in Y dimension
+     * @param nz Amount of elements in Z dimension
+     * @return DispatchCommand to issue a dispatch
+    */
+    template<class T, typename = typename std::enable_if_t<std::is_standard_layout_v<T> && !std::is_integral_v<T>>>
+    [[nodiscard]] DispatchCommand dispatchElements(const T& push, uint32_t nx, uint32_t ny = 1, uint32_t nz = 1) const {
+        return dispatchElements({ reinterpret_cast<const std::byte*>(&push), sizeof(T)}, nx, ny, nz);
+    }
+
+    /**
+     * @brief Dispatches the current program using the parameters of the
+     *        given set
+     * 
+     * Unlike the other dispatches, the parameters are not copied into the
+     * command but read from the set once the work runs. Changing the
+     * parameters of the set therefore does not require re-recording.
+     * 
+     * @param set ParameterSet created for this program
+     * @param push Additional push data
+     * @param x Amount of groups in X dimension
+     * @param y Amount of groups in Y dimension
+     * @param z Amount of groups in Z dimension
+     * @return DispatchCommand to issue a dispatch
+    */
+    [[nodiscard]] DispatchCommand dispatch(
+        const ParameterSet& set,
+        std::span<const std::byte> push,
+        uint32_t x = 1, uint32_t y = 1, uint32_t z = 1) const;
+    /**
+     * @brief Dispatches the current program using the parameters of the
+     *        given set
+     * 
+     * @param set ParameterSet created for this program
+     * @param x Amount of groups in X dimension
+     * @param y Amount of groups in Y dimension
+     * @param z Amount of groups in Z dimension
+     * @return DispatchCommand to issue a dispatch
+    */
+    [[nodiscard]] DispatchCommand dispatch(
+        const ParameterSet& set,
+        uint32_t x = 1, uint32_t y = 1, uint32_t z = 1) const;
+    /**
+     * @brief Dispatches the current program using the parameters of the
+     *        given set
+     * 
+     * @param set ParameterSet created for this program
+     * @param push Additional push data
+     * @param x Amount of groups in X dimension
+     * @param y Amount of groups in Y dimension
+     * @param z Amount of groups in Z dimension
+     * @return DispatchCommand to issue a dispatch
+    */
+    template<class T, typename = typename std::enable_if_t<std::is_standard_layout_v<T> && !std::is_integral_v<T>>>
+    [[nodiscard]] DispatchCommand dispatch(const ParameterSet& set, const T& push, uint32_t x = 1, uint32_t y = 1, uint32_t z = 1) const {
+        return dispatch(set, { reinterpret_cast<const std::byte*>(&push), sizeof(T)}, x, y, z);
+    }
+
+    /**
+     * @brief Dispatches the current program using the resources of the
+     *        given heap
+     * 
+     * The program's bindings are replaced by the heap's, which are usually
+     * indexed using indices passed via push constants. Requires the program
+     * to only declare bindings matching the heap's layout.
+     * 
+     * @param heap ResourceHeap providing the resources
+     * @param push Additional push data, e.g. indices into the heap
+     * @param x Amount of groups in X dimension
+     * @param y Amount of groups in Y dimension
+     * @param z Amount of groups in Z dimension
+     * @return DispatchCommand to issue a dispatch
+    */
+    [[nodiscard]] DispatchCommand dispatch(
+        const ResourceHeap& heap,
+        std::span<const std::byte> push,
+        uint32_t x = 1, uint32_t y = 1, uint32_t z = 1) const;
+    /**
+     * @brief Dispatches the current program using the resources of the
+     *        given heap
+     * 
+     * @param heap ResourceHeap providing the resources
+     * @param x Amount of groups in X dimension
+     * @param y Amount of groups in Y dimension
+     * @param z Amount of groups in Z dimension
+     * @return DispatchCommand to issue a dispatch
+    */
+    [[nodiscard]] DispatchCommand dispatch(
+        const ResourceHeap& heap,
+        uint32_t x = 1, uint32_t y = 1, uint32_t z = 1) const;
+    /**
+     * @brief Dispatches the current program using the resources of the
+     *        given heap
+     * 
+     * @param heap ResourceHeap providing the resources
+     * @param push Additional push data, e.g. indices into the heap
+     * @param x Amount of groups in X dimension
+     * @param y Amount of groups in Y dimension
+     * @param z Amount of groups in Z dimension
+     * @return DispatchCommand to issue a dispatch
+    */
+    template<class T, typename = typename std::enable_if_t<std::is_standard_layout_v<T> && !std::is_integral_v<T>>>
+    [[nodiscard]] DispatchCommand dispatch(const ResourceHeap& heap, const T& push, uint32_t x = 1, uint32_t y = 1, uint32_t z = 1) const {
+        return dispatch(heap, { reinterpret_cast<const std::byte*>(&push), sizeof(T)}, x, y, z);
+    }
 
     /**
      * @brief Dispatches the current program using indirect params
@@ -472,23 +992,69 @@ public:
         return dispatchIndirect({ reinterpret_cast<const std::byte*>(&push), sizeof(T) }, tensor, offset);
     }
 
-    Program(const Program&) = delete;
-    Program& operator=(const Program&) = delete;
+    /**
+     * @brief Returns the binary of the program's shader object
+     *
+     * The binary can be passed on creating the same program again, e.g. in a
+     * later run, to skip compiling the shader. Binaries are only compatible
+     * with the same device and driver.
+     * @note Only available if shader objects are enabled
+    */
+    [[nodiscard]] std::vector<std::byte> getShaderBinary() const;
 
-    Program(Program&& other) noexcept;
-    Program& operator=(Program&& other) noexcept;
+    /**
+     * @brief Returns the resource usage and expected occupancy
+     *
+     * Queries the driver's statistics on each call.
+    */
+    [[nodiscard]] ProgramStatistics getStatistics() const;
 
     /**
-     * @brief Creates a new Program on the given context
-     * 
-     * @param context Context on which to create the program
+     * @brief Replaces the program's code
+     *
+     * Builds the new code and swaps it in once it compiled successfully,
+     * otherwise the program stays unchanged. Bound parameters are kept if the
+     * new code declares the same bindings and push size, else they get reset
+     * and parameter sets created from this program must be recreated.
+     * Subgroup requirements are kept.
+     * The previous code stays alive until the program gets destroyed, thus
+     * pending submissions and recorded subroutines can still use it. Record
+     * them again to run the new code.
+     *
+     * @note Must not be called while commands of this program are recorded.
+     *
      * @param code Compiled shader byte code
+     * @param specialization Data used to populate specialization constants
     */
-    Program(ContextHandle context, std::span<const uint32_t> code);
+    void reload(std::span<const uint32_t> code, std::span<const std::byte> specialization = {});
     /**
-     * @brief Creates a new Program on the given context
-     * 
-     * @param context Context on which to create the program
+     * @brief Replaces the program's code
+     *
+     * @param code Compiled shader byte code
+     * @param specialization Data used to populate specialization constants
+    */
+    template<class T>
+    void reload(std::span<const uint32_t> code, const T& specialization) {
+        reload(code, std::as_bytes(std::span<const T>{ &specialization, 1 }));
+    }
+
+    Program(const Program&) = delete;
+    Program& operator=(const Program&) = delete;
+
+    Program(Program&& other) noexcept;
+    Program& operator=(Program&& other) noexcept;
+
+    /**
+     * @brief Creates a new Program on the given context
+     * 
+     * @param context Context on which to create the program
+     * @param code Compiled shader byte code
+    */
+    Program(ContextHandle context, std::span<const uint32_t> code);
+    /**
+     * @brief Creates a new Program on the given context
+     * 
+     * @param context Context on which to create the program
      * @param code Compiled shader byte code
      * @param specialization Data used to populate specialization constants
     */
@@ -504,17 +1070,982 @@ public:
     Program(ContextHandle context, std::span<const uint32_t> code, const T& specialization)
         : Program(std::move(context), code, std::as_bytes(std::span<const T>{ &specialization, 1 }))
     {}
+    /**
+     * @brief Creates a new Program on the given context
+     * 
+     * @param context Context on which to create the program
+     * @param code Compiled shader byte code
+     * @param specialization Data used to populate specialization constants
+     * @param subgroup Requirements on the subgroups the program runs with
+    */
+    Program(ContextHandle context, std::span<const uint32_t> code,
+        std::span<const std::byte> specialization, const SubgroupRequirements& subgroup);
+    /**
+     * @brief Creates a new Program on the given context
+     * 
+     * @param context Context on which to create the program
+     * @param code Compiled shader byte code
+     * @param specialization Data used to populate specialization constants
+     * @param subgroup Requirements on the subgroups the program runs with
+     * @param binary Binary previously retrieved via getShaderBinary() used
+     *               instead of compiling the code. Ignored if shader objects
+     *               are not enabled or the binary is incompatible.
+    */
+    Program(ContextHandle context, std::span<const uint32_t> code,
+        std::span<const std::byte> specialization, const SubgroupRequirements& subgroup,
+        std::span<const std::byte> binary);
     ~Program() override;
 
 public: //internal
     [[nodiscard]] VkWriteDescriptorSet& getBinding(uint32_t i);
     [[nodiscard]] VkWriteDescriptorSet& getBinding(std::string_view name);
+    [[nodiscard]] const vulkan::Program& getProgram() const noexcept;
 
 private:
     std::unique_ptr<vulkan::Program> program;
     std::vector<BindingTraits> bindingTraits;
 };
 
+/**
+ * @brief Source of a program to be created by createPrograms()
+*/
+struct ProgramSource {
+    /**
+     * @brief Compiled shader byte code
+    */
+    std::span<const uint32_t> code;
+    /**
+     * @brief Data used to populate specialization constants
+    */
+    std::span<const std::byte> specialization = {};
+    /**
+     * @brief Requirements on the subgroups the program runs with
+    */
+    SubgroupRequirements subgroup = {};
+    /**
+     * @brief Binary of the shader object retrieved via getShaderBinary()
+    */
+    std::span<const std::byte> binary = {};
+};
+
+/**
+ * @brief Creates multiple programs in parallel
+ *
+ * Reflects and compiles the programs on multiple threads sharing the
+ * context's pipeline cache, which considerably speeds up creating a large
+ * amount of programs, e.g. at startup. If any program fails to be created,
+ * throws the first error after all threads finished.
+ *
+ * @param context Context on which to create the programs
+ * @param sources Code and specialization of the programs to create
+ * @param threads Maximum amount of threads to use. Zero uses one per core.
+ * @return Programs in the same order as sources
+*/
+[[nodiscard]] HEPHAISTOS_API std::vector<Program> createPrograms(
+    const ContextHandle& context,
+    std::span<const ProgramSource> sources,
+    uint32_t threads = 0);
+
+/**
+ * @brief Collection of named programs including their reflection, which can
+ *        be saved to a file and created all at once later on
+ *
+ * Stores the code, specialization and subgroup requirements of each program
+ * together with its reflected interface, i.e. local size, bindings and push
+ * constant size. Programs created from a bundle skip reflecting their code
+ * and get compiled in parallel against the context's pipeline cache. Together
+ * with a persistent pipeline cache, see setPipelineCacheFile(), this allows
+ * to ship all programs of an application in a single file and to compile them
+ * in the background via warmUp() before their first use.
+*/
+class HEPHAISTOS_API ProgramBundle {
+public:
+    /**
+     * @brief Returns the number of programs in the bundle
+    */
+    [[nodiscard]] size_t size() const noexcept;
+    /**
+     * @brief Returns the names of all programs in the order they were added
+    */
+    [[nodiscard]] std::vector<std::string> getNames() const;
+    /**
+     * @brief Checks whether the bundle contains a program of the given name
+    */
+    [[nodiscard]] bool contains(std::string_view name) const noexcept;
+    /**
+     * @brief Returns the local size of the given program
+     *
+     * Throws if there is no program of the given name.
+    */
+    [[nodiscard]] const LocalSize& getLocalSize(std::string_view name) const;
+    /**
+     * @brief Returns the traits of all bindings of the given program
+     *
+     * Throws if there is no program of the given name.
+    */
+    [[nodiscard]] std::span<const BindingTraits> getBindingTraits(std::string_view name) const;
+
+    /**
+     * @brief Adds a program to the bundle
+     *
+     * Reflects the code right away, thus throws if the code is invalid or a
+     * program with the same name already exists.
+     *
+     * @param name Name used to identify the program
+     * @param code Compiled shader byte code
+     * @param specialization Data used to populate specialization constants
+     * @param subgroup Requirements on the subgroups the program runs with
+    */
+    void add(std::string name, std::span<const uint32_t> code,
+        std::span<const std::byte> specialization = {},
+        const SubgroupRequirements& subgroup = {});
+
+    /**
+     * @brief Creates the program of the given name
+     *
+     * Throws if there is no program of the given name.
+     *
+     * @param context Context on which to create the program
+     * @param name Name of the program
+    */
+    [[nodiscard]] Program createProgram(const ContextHandle& context, std::string_view name) const;
+    /**
+     * @brief Creates all programs of the bundle in parallel
+     *
+     * @param context Context on which to create the programs
+     * @param threads Maximum amount of threads to use. Zero uses one per core.
+     * @return Programs in the order they were added
+    */
+    [[nodiscard]] std::vector<Program> createPrograms(
+        const ContextHandle& context, uint32_t threads = 0) const;
+    /**
+     * @brief Compiles all programs in the background
+     *
+     * Creates and drops all programs on a background thread, leaving the
+     * compiled pipelines in the context's pipeline cache and the reflections
+     * in its layout cache. Programs created afterwards thus skip compiling.
+     *
+     * @note The bundle must outlive the returned future
+     *
+     * @param context Context on which to compile the programs
+     * @param threads Maximum amount of threads to use. Zero uses one per core.
+     * @return Future finishing once all programs were compiled
+    */
+    std::future<void> warmUp(const ContextHandle& context, uint32_t threads = 0) const;
+
+    /**
+     * @brief Serializes the bundle into a binary blob
+    */
+    [[nodiscard]] std::vector<std::byte> serialize() const;
+    /**
+     * @brief Saves the bundle to the given file
+     *
+     * Throws if the file could not be written.
+     *
+     * @param path File to write the bundle to. Gets replaced if it exists.
+    */
+    void save(const std::filesystem::path& path) const;
+
+    ProgramBundle(const ProgramBundle&) = delete;
+    ProgramBundle& operator=(const ProgramBundle&) = delete;
+
+    ProgramBundle(ProgramBundle&& other) noexcept;
+    ProgramBundle& operator=(ProgramBundle&& other) noexcept;
+
+    /**
+     * @brief Creates a new empty bundle
+    */
+    ProgramBundle();
+    /**
+     * @brief Loads a bundle from data created by serialize()
+     *
+     * Throws if the data is not a valid bundle.
+     *
+     * @param data Serialized bundle
+    */
+    explicit ProgramBundle(std::span<const std::byte> data);
+    /**
+     * @brief Loads a bundle from a file written by save()
+     *
+     * Throws if the file could not be read or is not a valid bundle.
+     *
+     * @param path File containing the bundle
+    */
+    explicit ProgramBundle(const std::filesystem::path& path);
+    ~ProgramBundle();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Family of programs sharing the same code but differing in their
+ *        specialization
+ *
+ * Creates a variant for each distinct specialization data on its first
+ * request and returns the same one on later requests, thus variants can be
+ * fetched cheaply on the hot path. Variants share the reflection and layouts
+ * of the code via the context.
+ *
+ * @note Variants stay alive until the family is cleared or destroyed.
+ *       Fetching variants is thread safe.
+*/
+class HEPHAISTOS_API ProgramFamily {
+public:
+    /**
+     * @brief Returns the number of variants created so far
+    */
+    [[nodiscard]] size_t size() const;
+
+    /**
+     * @brief Returns the variant for the given specialization data
+     *
+     * Creates the variant if it did not exist before.
+     *
+     * @param specialization Data used to populate specialization constants
+     * @return Program of the variant
+    */
+    [[nodiscard]] Program& getVariant(std::span<const std::byte> specialization = {});
+    /**
+     * @brief Returns the variant for the given specialization
+     *
+     * @param specialization Data used to populate specialization constants
+     * @return Program of the variant
+    */
+    template<class T>
+    [[nodiscard]] Program& getVariant(const T& specialization) {
+        return getVariant(std::as_bytes(std::span<const T>{ &specialization, 1 }));
+    }
+
+    /**
+     * @brief Destroys all variants
+     *
+     * @note Previously returned variants must not be used afterwards
+    */
+    void clear();
+
+    ProgramFamily(const ProgramFamily&) = delete;
+    ProgramFamily& operator=(const ProgramFamily&) = delete;
+
+    ProgramFamily(ProgramFamily&& other) noexcept;
+    ProgramFamily& operator=(ProgramFamily&& other) noexcept;
+
+    /**
+     * @brief Creates a new empty family
+     *
+     * @param context Context on which to create the variants
+     * @param code Compiled shader byte code shared by all variants
+     * @param subgroup Requirements on the subgroups the variants run with
+    */
+    ProgramFamily(ContextHandle context, std::span<const uint32_t> code,
+        const SubgroupRequirements& subgroup = {});
+    ~ProgramFamily();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Limits of a ProgramCache
+*/
+struct ProgramCacheLimits {
+    /**
+     * @brief Maximum amount of cached programs. Zero means no limit.
+    */
+    uint32_t maxPrograms = 256;
+    /**
+     * @brief Maximum total size of the cached programs' code in bytes. Zero
+     *        means no limit.
+     *
+     * The memory drivers use for pipelines is not exposed, but grows with
+     * the size of the code, thus the latter serves as estimate.
+    */
+    uint64_t maxCodeSize = 0;
+};
+
+/**
+ * @brief Statistics of a ProgramCache
+*/
+struct ProgramCacheStatistics {
+    /**
+     * @brief Requests served by a cached program
+    */
+    uint64_t hits;
+    /**
+     * @brief Requests creating a new program
+    */
+    uint64_t misses;
+    /**
+     * @brief Programs dropped to stay within the limits
+    */
+    uint64_t evictions;
+};
+
+/**
+ * @brief Cache of programs keyed by their code, specialization and subgroup
+ *        requirements
+ *
+ * Meant for code paths generating many programs on the fly, e.g. from
+ * templated source code, where the same program is likely requested again.
+ * Returns the cached program if an identical one was requested before and
+ * creates it otherwise. The least recently used programs are dropped once
+ * the cache exceeds its limits, so memory stays bounded.
+ *
+ * Programs are shared between all requests of the same key including their
+ * bound parameters, which therefore must be bound again before each dispatch.
+ * Dropped programs stay alive as long as they are referenced elsewhere.
+ *
+ * @note Fetching programs is thread safe.
+*/
+class HEPHAISTOS_API ProgramCache {
+public:
+    /**
+     * @brief Returns the number of cached programs
+    */
+    [[nodiscard]] size_t size() const;
+    /**
+     * @brief Returns the total size of the cached programs' code in bytes
+    */
+    [[nodiscard]] uint64_t getCodeSize() const;
+    /**
+     * @brief Returns the hits, misses and evictions counted so far
+    */
+    [[nodiscard]] ProgramCacheStatistics getStatistics() const;
+
+    /**
+     * @brief Returns the limits of the cache
+    */
+    [[nodiscard]] ProgramCacheLimits getLimits() const;
+    /**
+     * @brief Sets the limits of the cache
+     *
+     * Drops the least recently used programs until the new limits are met.
+    */
+    void setLimits(const ProgramCacheLimits& limits);
+
+    /**
+     * @brief Returns the program for the given code and specialization
+     *
+     * Creates the program if it is not cached.
+     *
+     * @param code Compiled shader byte code
+     * @param specialization Data used to populate specialization constants
+     * @param subgroup Requirements on the subgroups the program runs with
+     * @return Shared program
+    */
+    [[nodiscard]] std::shared_ptr<Program> get(
+        std::span<const uint32_t> code,
+        std::span<const std::byte> specialization = {},
+        const SubgroupRequirements& subgroup = {});
+    /**
+     * @brief Returns the program for the given code and specialization
+     *
+     * @param code Compiled shader byte code
+     * @param specialization Data used to populate specialization constants
+     * @return Shared program
+    */
+    template<class T>
+    [[nodiscard]] std::shared_ptr<Program> get(std::span<const uint32_t> code, const T& specialization) {
+        return get(code, std::as_bytes(std::span<const T>{ &specialization, 1 }));
+    }
+    /**
+     * @brief Returns the program compiled from the given GLSL source code
+     *
+     * Skips compiling if the source was compiled with the same compiler
+     * settings for a program still in the cache, see Compiler::getCacheKey().
+     * Otherwise compiles it using the compiler, which may load the code from
+     * its cache directory.
+     *
+     * @param compiler Compiler used for compiling the source code
+     * @param source GLSL source code
+     * @param specialization Data used to populate specialization constants
+     * @param subgroup Requirements on the subgroups the program runs with
+     * @return Shared program
+    */
+    [[nodiscard]] std::shared_ptr<Program> compile(
+        const Compiler& compiler,
+        std::string_view source,
+        std::span<const std::byte> specialization = {},
+        const SubgroupRequirements& subgroup = {});
+
+    /**
+     * @brief Drops all cached programs
+    */
+    void clear();
+
+    ProgramCache(const ProgramCache&) = delete;
+    ProgramCache& operator=(const ProgramCache&) = delete;
+
+    ProgramCache(ProgramCache&& other) noexcept;
+    ProgramCache& operator=(ProgramCache&& other) noexcept;
+
+    /**
+     * @brief Creates a new empty cache
+     *
+     * @param context Context on which to create the programs
+     * @param limits Limits of the cache
+    */
+    explicit ProgramCache(ContextHandle context, const ProgramCacheLimits& limits = {});
+    ~ProgramCache();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Set of parameters a program can be dispatched with, which can be
+ *        changed without re-recording the dispatch
+ * 
+ * Dispatches created via Program::dispatch(const ParameterSet&, ...) only
+ * reference the set and read its parameters once they run. The same recorded
+ * Subroutine can thus be reused for different parameters by binding new ones
+ * to the set and calling update() between submissions.
+ * 
+ * @note update() must not be called while submitted work using the set is
+ *       still pending. Parameters of a set are not tracked for hazards.
+*/
+class HEPHAISTOS_API ParameterSet : public Resource {
+public:
+    /**
+     * @brief Binds the given parameter
+     * 
+     * @note Takes only effect after calling update()
+     * 
+     * @param param Parameter to bind
+     * @param binding Binding number to bind the parameter to
+    */
+    template<class T>
+    void bindParameter(const T& param, uint32_t binding) {
+        param.bindParameter(getBinding(binding));
+    }
+    /**
+     * @brief Binds the given parameter
+     * 
+     * @note Takes only effect after calling update()
+     * 
+     * @param param Parameter to bind
+     * @param binding Name of the binding to bind the parameter to
+    */
+    template<class T>
+    void bindParameter(const T& param, std::string_view binding) {
+        param.bindParameter(getBinding(binding));
+    }
+    /**
+     * @brief Binds the given list of parameters in order of their binding
+     * 
+     * @note Takes only effect after calling update()
+     * 
+     * @param param List of parameters to bind
+    */
+    template<class ...T>
+    void bindParameterList(const T&...param) {
+        uint32_t binding = 0;
+        (param.bindParameter(getBinding(binding++)),...);
+    }
+    /**
+     * @brief Binds the given parameters to the elements of an array binding
+     * 
+     * Leaving trailing elements unbound requires isPartiallyBoundEnabled().
+     * 
+     * @note Takes only effect after calling update()
+     * 
+     * @param params Parameters to bind in order of the array's elements
+     * @param binding Binding number of the array
+    */
+    void bindParameterArray(std::span<const Argument* const> params, uint32_t binding);
+    /**
+     * @brief Binds the given parameters to the elements of an array binding
+     * 
+     * Leaving trailing elements unbound requires isPartiallyBoundEnabled().
+     * 
+     * @note Takes only effect after calling update()
+     * 
+     * @param params Parameters to bind in order of the array's elements
+     * @param binding Name of the array binding
+    */
+    void bindParameterArray(std::span<const Argument* const> params, std::string_view binding);
+
+    /**
+     * @brief Writes the bound parameters to the device
+     * 
+     * All dispatches using this set will use the new parameters from now on.
+     * Throws if not all bindings are bound.
+     * 
+     * @note Must not be called while submitted work using this set is pending
+    */
+    void update();
+
+    /**
+     * @brief Returns a list of BindingTraits of all bindings
+    */
+    [[nodiscard]] const std::vector<BindingTraits>& listBindings() const noexcept;
+
+    ParameterSet(const ParameterSet&) = delete;
+    ParameterSet& operator=(const ParameterSet&) = delete;
+
+    ParameterSet(ParameterSet&& other) noexcept;
+    ParameterSet& operator=(ParameterSet&& other) noexcept;
+
+    /**
+     * @brief Creates a new ParameterSet for the given program
+     * 
+     * @note The set must not outlive the program
+     * 
+     * @param program Program the set provides parameters for
+    */
+    explicit ParameterSet(const Program& program);
+    ~ParameterSet() override;
+
+public: //internal
+    [[nodiscard]] VkWriteDescriptorSet& getBinding(uint32_t i);
+    [[nodiscard]] VkWriteDescriptorSet& getBinding(std::string_view name);
+    [[nodiscard]] const vulkan::ParameterSet& getParameterSet() const noexcept;
+
+private:
+    std::unique_ptr<vulkan::ParameterSet> set;
+    std::vector<BindingTraits> bindingTraits;
+};
+
+/**
+ * @brief Checks for descriptor buffer support
+ *
+ * @param device Handle to device to be checked for descriptor buffer support
+ * @return True, if the given device supports descriptor buffers, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isDescriptorBufferSupported(const DeviceHandle& device);
+/**
+ * @brief Checks wether descriptor buffers are enabled
+ *
+ * @param context Context to check
+ * @return True, if descriptor buffers are enabled in the given context, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isDescriptorBufferEnabled(const ContextHandle& context);
+
+/**
+ * @brief Creates a descriptor buffer extension
+ *
+ * Returns an extension which can be passed during the creation of a context to
+ * let parameter sets store their descriptors in device visible memory using
+ * VK_EXT_descriptor_buffer. Descriptors are written once on update() and
+ * dispatches using the set only bind an offset into a buffer shared by all
+ * sets, reducing the cost of recording them. Dispatches without sets are not
+ * affected.
+ *
+ * @return Extension for enabling descriptor buffers
+*/
+[[nodiscard]] HEPHAISTOS_API ExtensionHandle createDescriptorBufferExtension();
+
+/**
+ * @brief Checks for shader object support
+ *
+ * @param device Handle to device to be checked for shader object support
+ * @return True, if the given device supports shader objects, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isShaderObjectSupported(const DeviceHandle& device);
+/**
+ * @brief Checks wether shader objects are enabled
+ *
+ * @param context Context to check
+ * @return True, if shader objects are enabled in the given context, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isShaderObjectEnabled(const ContextHandle& context);
+
+/**
+ * @brief Creates a shader object extension
+ *
+ * Returns an extension which can be passed during the creation of a context to
+ * let programs use VK_EXT_shader_object instead of pipelines for dispatches
+ * binding their parameters directly. Creating shader objects avoids the
+ * overhead of pipeline objects, which makes creating many programs at runtime
+ * faster. Their binaries can be retrieved via Program::getShaderBinary() to
+ * skip compilation in later runs. Dispatches using parameter sets or resource
+ * heaps still use pipelines.
+ *
+ * @return Extension for enabling shader objects
+*/
+[[nodiscard]] HEPHAISTOS_API ExtensionHandle createShaderObjectExtension();
+
+/**
+ * @brief Checks for resource heap support
+ *
+ * @param device Handle to device to be checked for resource heap support
+ * @return True, if the given device supports resource heaps, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isResourceHeapSupported(const DeviceHandle& device);
+/**
+ * @brief Checks wether resource heaps are enabled
+ *
+ * @param context Context to check
+ * @return True, if resource heaps are enabled in the given context, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isResourceHeapEnabled(const ContextHandle& context);
+
+/**
+ * @brief Checks wether array bindings can be partially bound
+ *
+ * Enabled on all devices supporting descriptorBindingPartiallyBound, in which
+ * case Program::bindParameterArray() may bind fewer parameters than the array
+ * holds.
+ *
+ * @param context Context to check
+ * @return True, if partially bound arrays are enabled, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isPartiallyBoundEnabled(const ContextHandle& context);
+
+/**
+ * @brief Creates a resource heap extension
+ *
+ * Returns an extension which can be passed during the creation of a context to
+ * enable ResourceHeap, i.e. bindless resources using descriptor indexing.
+ * Devices not supporting the given capacity are considered unsupported.
+ *
+ * @param capacity Maximum amount of resources of each type in a heap
+ * @return Extension for enabling resource heaps
+*/
+[[nodiscard]] HEPHAISTOS_API ExtensionHandle createResourceHeapExtension(uint32_t capacity = 4096);
+
+/**
+ * @brief Large set of resources programs can index into
+ * 
+ * Resources are added once and identified by an index programs receive e.g.
+ * via push constants, so dispatches do not have to bind any parameters. The
+ * heap provides the following bindings, which programs dispatched with it may
+ * declare as (runtime) arrays:
+ *  - binding 0: storage buffers, e.g. tensors
+ *  - binding 1: storage images
+ *  - binding 2: combined image samplers, i.e. textures
+ * 
+ * All types share the same index space, i.e. an index refers to at most one
+ * resource. Added resources must stay alive until they are removed from the
+ * heap or the heap is destroyed.
+ * 
+ * @note Resources of the heap are not tracked for hazards. Replacing or
+ *       removing resources used by pending work is allowed, but changes
+ *       visible to it are undefined.
+*/
+class HEPHAISTOS_API ResourceHeap : public Resource {
+public:
+    /**
+     * @brief Maximum amount of resources in the heap
+    */
+    [[nodiscard]] uint32_t capacity() const noexcept;
+    /**
+     * @brief Amount of resources currently in the heap
+    */
+    [[nodiscard]] uint32_t size() const noexcept;
+
+    /**
+     * @brief Adds the given resource to the heap
+     * 
+     * Throws if the heap is full.
+     * 
+     * @param arg Tensor, Image or Texture to add
+     * @return Index of the resource in the heap
+    */
+    uint32_t add(const Argument& arg);
+    /**
+     * @brief Replaces the resource at the given index
+     * 
+     * @param index Index as returned by add()
+     * @param arg Tensor, Image or Texture to put at the index
+    */
+    void set(uint32_t index, const Argument& arg);
+    /**
+     * @brief Removes the resource at the given index
+     * 
+     * The index might be returned by later calls to add().
+     * 
+     * @param index Index as returned by add()
+    */
+    void remove(uint32_t index);
+
+    ResourceHeap(const ResourceHeap&) = delete;
+    ResourceHeap& operator=(const ResourceHeap&) = delete;
+
+    ResourceHeap(ResourceHeap&& other) noexcept;
+    ResourceHeap& operator=(ResourceHeap&& other) noexcept;
+
+    /**
+     * @brief Creates a new empty ResourceHeap
+     * 
+     * Throws if resource heaps are not enabled.
+     * 
+     * @param context Context on which to create the heap
+    */
+    explicit ResourceHeap(ContextHandle context);
+    ~ResourceHeap() override;
+
+public: //internal
+    [[nodiscard]] const vulkan::ResourceHeap& getResourceHeap() const noexcept;
+
+private:
+    std::unique_ptr<vulkan::ResourceHeap> heap;
+};
+
+/**
+ * @brief Shaders forming a hit group of a RayTracingProgram
+ *
+ * Each stage is optional. Groups with an intersection shader are procedural
+ * and used for geometries built from BoundingBoxes, while groups without one
+ * are used for triangles.
+*/
+struct HitGroup {
+    /**
+     * @brief Compiled closest hit shader. Empty if none.
+    */
+    std::span<const uint32_t> closestHit = {};
+    /**
+     * @brief Compiled any hit shader. Empty if none.
+    */
+    std::span<const uint32_t> anyHit = {};
+    /**
+     * @brief Compiled intersection shader. Empty for triangle geometries.
+    */
+    std::span<const uint32_t> intersection = {};
+};
+
+/**
+ * @brief Shaders of a RayTracingProgram
+ *
+ * The index of miss shaders and hit groups in their lists equals the index
+ * used by traceRayEXT() to select them, i.e. missIndex and sbtRecordOffset
+ * plus the instance's shader binding table offset respectively.
+*/
+struct RayTracingShaders {
+    /**
+     * @brief Compiled ray generation shader
+    */
+    std::span<const uint32_t> rayGen;
+    /**
+     * @brief Compiled miss shaders
+    */
+    std::vector<std::span<const uint32_t>> miss = {};
+    /**
+     * @brief Hit groups
+    */
+    std::vector<HitGroup> hitGroups = {};
+};
+
+/**
+ * @brief Command for tracing rays using a RayTracingProgram
+ *
+ * Launches one invocation of the ray generation shader for each element of
+ * the given grid.
+*/
+class HEPHAISTOS_API TraceRaysCommand : public Command {
+public:
+    /**
+     * @brief Amount of rays in X dimension
+    */
+    uint32_t width;
+    /**
+     * @brief Amount of rays in Y dimension
+    */
+    uint32_t height;
+    /**
+     * @brief Amount of rays in Z dimension
+    */
+    uint32_t depth;
+    /**
+     * @brief Data used as push constant
+     *
+     * May be empty, i.e. zero sized, if no push data should be sent.
+    */
+    std::span<const std::byte> pushData;
+
+    void record(vulkan::Command& cmd) const override;
+
+    TraceRaysCommand(const TraceRaysCommand&);
+    TraceRaysCommand& operator=(const TraceRaysCommand&);
+
+    TraceRaysCommand(TraceRaysCommand&&) noexcept;
+    TraceRaysCommand& operator=(TraceRaysCommand&&) noexcept;
+
+    /**
+     * @brief Creates a new TraceRaysCommand for the given program
+     *
+     * @param program Program to trace rays with
+     * @param width Amount of rays in X dimension
+     * @param height Amount of rays in Y dimension
+     * @param depth Amount of rays in Z dimension
+     * @param push Data used as push constant
+    */
+    TraceRaysCommand(
+        const vulkan::RayTracingProgram& program,
+        uint32_t width, uint32_t height, uint32_t depth,
+        std::span<const std::byte> push);
+    ~TraceRaysCommand() override;
+
+private:
+    std::reference_wrapper<const vulkan::RayTracingProgram> program;
+    //shared with the program until its bindings change
+    std::shared_ptr<const std::vector<VkWriteDescriptorSet>> params;
+};
+
+/**
+ * @brief Program running on the ray tracing pipeline
+ *
+ * Unlike ray queries issued from a compute Program, the hardware schedules
+ * the shader invocations of each hit group and thus handles divergent,
+ * material heavy tracing more efficiently. Requires ray tracing pipelines to
+ * be enabled via createRaytracingExtension(). Shaders can be compiled by the
+ * Compiler using the corresponding ShaderStage.
+ *
+ * All shaders share a single set of bindings and push constants. The shader
+ * binding table is built on creation and holds no additional data per record.
+*/
+class HEPHAISTOS_API RayTracingProgram : public Resource {
+public:
+    /**
+     * @brief Returns the traits of the given binding
+     *
+     * Throws if the given binding does not exist.
+     *
+     * @param i Binding number to be reflected
+     * @return BindingTraits of the given binding
+    */
+    [[nodiscard]] const BindingTraits& getBindingTraits(uint32_t i) const;
+    /**
+     * @brief Returns the traits of the given binding
+     *
+     * Throws if the given binding cannot be found.
+     * @note Shader compiler may strip away the binding names
+     *
+     * @param name Name of the binding to be reflected
+     * @return BindingTraits of the given binding
+    */
+    [[nodiscard]] const BindingTraits& getBindingTraits(std::string_view name) const;
+    /**
+     * @brief Checks whether the given binding is currently bound
+     *
+     * @param i Binding number to be checked
+     * @return True, if the binding is currently bound, false otherwise
+    */
+    [[nodiscard]] bool isBindingBound(uint32_t i) const;
+    /**
+     * @brief Returns a list of BindingTraits of all bindings
+     *
+     * Bindings used by any of the shaders are merged into a single list.
+     *
+     * @return Vector of BindingTraits one for each binding
+    */
+    [[nodiscard]] const std::vector<BindingTraits>& listBindings() const noexcept;
+
+    /**
+     * @brief Returns the amount of miss shaders
+    */
+    [[nodiscard]] uint32_t getMissCount() const noexcept;
+    /**
+     * @brief Returns the amount of hit groups
+    */
+    [[nodiscard]] uint32_t getHitGroupCount() const noexcept;
+
+    /**
+     * @brief Binds the given parameter
+     *
+     * @param param Parameter to bind
+     * @param binding Binding number to bind the parameter to
+    */
+    template<class T>
+    void bindParameter(const T& param, uint32_t binding) {
+        param.bindParameter(getBinding(binding));
+    }
+    /**
+     * @brief Binds the given parameter
+     *
+     * @param param Parameter to bind
+     * @param binding Name of the binding to bind the parameter to
+    */
+    template<class T>
+    void bindParameter(const T& param, std::string_view binding) {
+        param.bindParameter(getBinding(binding));
+    }
+    /**
+     * @brief Binds the list of parameters
+     *
+     * Binds the given list of parameters to bindings in the order as they are
+     * defined in the program.
+     *
+     * @param param... List of parameters to bind
+    */
+    template<class ...T>
+    void bindParameterList(const T&...param) {
+        uint32_t binding = 0;
+        (param.bindParameter(getBinding(binding++)),...);
+    }
+
+    /**
+     * @brief Traces rays using the current bindings
+     *
+     * @param push Additional push data
+     * @param width Amount of rays in X dimension
+     * @param height Amount of rays in Y dimension
+     * @param depth Amount of rays in Z dimension
+     * @return TraceRaysCommand launching the ray generation shader
+    */
+    [[nodiscard]] TraceRaysCommand traceRays(std::span<const std::byte> push,
+        uint32_t width, uint32_t height = 1, uint32_t depth = 1) const;
+    /**
+     * @brief Traces rays using the current bindings
+     *
+     * @param width Amount of rays in X dimension
+     * @param height Amount of rays in Y dimension
+     * @param depth Amount of rays in Z dimension
+     * @return TraceRaysCommand launching the ray generation shader
+    */
+    [[nodiscard]] TraceRaysCommand traceRays(
+        uint32_t width, uint32_t height = 1, uint32_t depth = 1) const;
+    /**
+     * @brief Traces rays using the current bindings
+     *
+     * @param push Additional push data
+     * @param width Amount of rays in X dimension
+     * @param height Amount of rays in Y dimension
+     * @param depth Amount of rays in Z dimension
+     * @return TraceRaysCommand launching the ray generation shader
+    */
+    template<class T, typename = typename std::enable_if_t<std::is_standard_layout_v<T> && !std::is_integral_v<T>>>
+    [[nodiscard]] TraceRaysCommand traceRays(const T& push,
+        uint32_t width, uint32_t height = 1, uint32_t depth = 1) const
+    {
+        return traceRays({ reinterpret_cast<const std::byte*>(&push), sizeof(T) }, width, height, depth);
+    }
+
+    RayTracingProgram(const RayTracingProgram&) = delete;
+    RayTracingProgram& operator=(const RayTracingProgram&) = delete;
+
+    RayTracingProgram(RayTracingProgram&& other) noexcept;
+    RayTracingProgram& operator=(RayTracingProgram&& other) noexcept;
+
+    /**
+     * @brief Creates a new RayTracingProgram on the given context
+     *
+     * Throws if ray tracing pipelines are not enabled.
+     *
+     * @param context Context on which to create the program
+     * @param shaders Compiled shaders of the program
+     * @param specialization Data used to populate specialization constants of
+     *                       all shaders
+     * @param maxRecursionDepth Maximum depth of recursive traceRayEXT() calls
+    */
+    RayTracingProgram(ContextHandle context, const RayTracingShaders& shaders,
+        std::span<const std::byte> specialization = {},
+        uint32_t maxRecursionDepth = 1);
+    ~RayTracingProgram() override;
+
+public: //internal
+    [[nodiscard]] VkWriteDescriptorSet& getBinding(uint32_t i);
+    [[nodiscard]] VkWriteDescriptorSet& getBinding(std::string_view name);
+    [[nodiscard]] const vulkan::RayTracingProgram& getProgram() const noexcept;
+
+private:
+    std::unique_ptr<vulkan::RayTracingProgram> program;
+    std::vector<BindingTraits> bindingTraits;
+};
+
 /**
  * @brief Command for flushing device memory
  * 
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+#include "hephaistos/config.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief Range of random streams handed to a single dispatch
+ *
+ * Matches the layout of RandomStreams in the built-in GLSL header
+ * "hephaistos/random.glsl", thus can be copied into push constants or
+ * buffers as is.
+*/
+struct RandomStreams {
+    /**
+     * @brief Seed used as key of the generator
+    */
+    uint64_t seed;
+    /**
+     * @brief Index of the first stream of the range
+    */
+    uint64_t offset;
+};
+
+/**
+ * @brief Allocates disjoint ranges of random streams
+ *
+ * Random numbers are generated by the counter-based generator Philox4x32-10,
+ * which derives each number from the seed, the index of its stream and its
+ * position inside it. Programs therefore need no stored state, but streams
+ * must not be reused across dispatches. This allocator hands out consecutive
+ * ranges of stream indices, e.g. one stream per invocation and dispatch.
+ *
+ * Inside programs, streams are created via createRandomStream() declared in
+ * the built-in header "hephaistos/random.glsl" available to all compilations.
+ *
+ * @note Allocation is thread safe.
+*/
+class HEPHAISTOS_API RandomStreamAllocator {
+public:
+    /**
+     * @brief Returns the seed of all allocated streams
+    */
+    [[nodiscard]] uint64_t getSeed() const noexcept;
+    /**
+     * @brief Returns the amount of streams allocated so far
+    */
+    [[nodiscard]] uint64_t getAllocated() const noexcept;
+
+    /**
+     * @brief Allocates the given amount of streams
+     *
+     * @param count Amount of streams to allocate
+     * @return Range of the allocated streams
+    */
+    [[nodiscard]] RandomStreams allocate(uint64_t count) noexcept;
+    /**
+     * @brief Resets the allocation to the given stream index
+     *
+     * Streams allocated before get reused, thus repeating their numbers.
+     *
+     * @param offset Index of the next stream allocated
+    */
+    void reset(uint64_t offset = 0) noexcept;
+
+    RandomStreamAllocator(const RandomStreamAllocator&) = delete;
+    RandomStreamAllocator& operator=(const RandomStreamAllocator&) = delete;
+
+    /**
+     * @brief Creates a new allocator
+     *
+     * @param seed Seed of all allocated streams
+     * @param offset Index of the first stream allocated
+    */
+    explicit RandomStreamAllocator(uint64_t seed, uint64_t offset = 0);
+    ~RandomStreamAllocator();
+
+private:
+    uint64_t seed;
+    std::atomic<uint64_t> next;
+};
+
+/**
+ * @brief Evaluates the Philox4x32-10 generator on the host
+ *
+ * Same as philox4x32() in "hephaistos/random.glsl". A stream's numbers are
+ * the components of the blocks with counter (draw, substream, stream low,
+ * stream high) and the seed split into low and high word as key.
+ *
+ * @param counter Counter of the block
+ * @param key Key of the generator
+ * @return Block of four random numbers
+*/
+[[nodiscard]] HEPHAISTOS_API std::array<uint32_t, 4> philox4x32(
+    std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key) noexcept;
+
+/**
+ * @brief Returns the source of the built-in GLSL header "hephaistos/random.glsl"
+*/
+[[nodiscard]] HEPHAISTOS_API std::string_view getRandomSource() noexcept;
+
+}
@@ -1,9 +1,17 @@
 #pragma once
 
+#include <cstdint>
+#include <filesystem>
+#include <future>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <span>
+#include <vector>
 
 #include "hephaistos/argument.hpp"
+#include "hephaistos/buffer.hpp"
+#include "hephaistos/command.hpp"
 #include "hephaistos/context.hpp"
 #include "hephaistos/handles.hpp"
 
@@ -23,6 +31,23 @@ namespace hephaistos {
  * @return True, if ray tracing is enabled in the given context, false otherwise.
 */
 [[nodiscard]] HEPHAISTOS_API bool isRaytracingEnabled(const ContextHandle& context);
+/**
+ * @brief Checks wether the given device supports ray tracing pipelines
+ *
+ * Ray tracing pipelines additionally require VK_KHR_ray_tracing_pipeline on
+ * top of the support checked by isRaytracingSupported().
+ *
+ * @param device Handle to device to be checked
+ * @return True, if the given device supports ray tracing pipelines
+*/
+[[nodiscard]] HEPHAISTOS_API bool isRaytracingPipelineSupported(const DeviceHandle& device);
+/**
+ * @brief Checks wether ray tracing pipelines are enabled
+ *
+ * @param context Context to check
+ * @return True, if RayTracingProgram can be created on the given context
+*/
+[[nodiscard]] HEPHAISTOS_API bool isRaytracingPipelineEnabled(const ContextHandle& context);
 
 /**
  * @brief Creates a ray tracing extension
@@ -30,9 +55,11 @@ namespace hephaistos {
  * Returns an extension which can be passed during the creation of a context to
  * enable ray tracing.
  * 
+ * @param pipeline If true, also enables ray tracing pipelines required by
+ *                 RayTracingProgram
  * @return Extension for enabling ray tracing
 */
-[[nodiscard]] HEPHAISTOS_API ExtensionHandle createRaytracingExtension();
+[[nodiscard]] HEPHAISTOS_API ExtensionHandle createRaytracingExtension(bool pipeline = false);
 
 /**
  * @brief Transformation matrix
@@ -60,12 +87,110 @@ constexpr TransformMatrix IdentityTransform = {
     0.0f, 0.0f, 1.0f, 0.0f
 };
 
+/**
+ * @brief Size in bytes of a single instance in device memory
+ * 
+ * @see writeInstances
+*/
+constexpr size_t GeometryInstanceSize = 64;
+
+/**
+ * @brief What acceleration structure builds should optimize for
+*/
+enum class BuildPreference {
+    /**
+     * @brief Prefers higher trace performance over build time
+    */
+    FAST_TRACE,
+    /**
+     * @brief Prefers faster builds over trace performance
+    */
+    FAST_BUILD
+};
+
+/**
+ * @brief Options for building acceleration structures
+ * 
+ * @see GeometryStore, AccelerationStructure
+*/
+struct BuildOptions {
+    /**
+     * @brief What the build should optimize for
+    */
+    BuildPreference preference = BuildPreference::FAST_TRACE;
+    /**
+     * @brief Whether to compact the acceleration structures after building
+     * 
+     * Compaction reduces the memory footprint but requires an additional
+     * round trip to the device and a copy. Only applies to GeometryStore.
+    */
+    bool compact                 = true;
+    /**
+     * @brief Whether the acceleration structures can be updated later on
+    */
+    bool allowUpdate             = false;
+    /**
+     * @brief Reduces the memory needed for building at the cost of build time
+     *        and trace performance
+    */
+    bool lowMemory               = false;
+    /**
+     * @brief Queue the initial build and compaction run on
+     * 
+     * Building on QueueType::COMPUTE keeps the main queue free for other
+     * work, e.g. tracing the previous frame while loading the next scene.
+     * Runs on the main queue if the context has no dedicated one.
+     * QueueType::TRANSFER is rejected with std::invalid_argument, as its
+     * family may lack the needed compute capabilities.
+     * 
+     * @note Only applies to builds issued on creation. Device side builds
+     *       run on the queue of the step recording them.
+    */
+    QueueType queue              = QueueType::MAIN;
+};
+
+/**
+ * @brief Memory sizes of built acceleration structures
+*/
+struct BuildSizes {
+    /**
+     * @brief Size in bytes as built
+    */
+    uint64_t built     = 0;
+    /**
+     * @brief Size in bytes after compaction. Same as built if not compacted.
+    */
+    uint64_t compacted = 0;
+};
+
+/**
+ * @brief Format of the vertex positions in a Mesh
+ * 
+ * @see Mesh
+*/
+enum class VertexFormat {
+    /**
+     * @brief Three 32 bit floats
+    */
+    FLOAT32,
+    /**
+     * @brief Four 16 bit floats. The fourth component is ignored.
+    */
+    FLOAT16,
+    /**
+     * @brief Four 16 bit signed normalized integers. The fourth component is
+     *        ignored.
+    */
+    SNORM16
+};
+
 /**
  * @brief Polygon mesh
  * 
  * Mesh consisting of triangles used to create geometries used in ray tracing.
  * Allows for arbitrary vertex format via a stride as well as indexing of
- * vertices.
+ * vertices. Positions may use compact 16 bit formats and indices may use 16 bit
+ * to reduce the memory needed for building and keeping the mesh data.
  * 
  * @see Geometry, GeometryStore
 */
@@ -78,10 +203,123 @@ struct Mesh {
      * @brief Stride between vertices in the vertex data
     */
     uint32_t vertexStride               = 3 * sizeof(float);
+    /**
+     * @brief Format of the position at the start of each vertex
+    */
+    VertexFormat vertexFormat           = VertexFormat::FLOAT32;
     /**
      * @brief Memory range containing the index data. May be empty.
     */
     std::span<const uint32_t> indices   = {};
+    /**
+     * @brief Memory range containing 16 bit index data. May be empty.
+     * 
+     * @note Only one of indices and indices16 may be set.
+    */
+    std::span<const uint16_t> indices16 = {};
+};
+
+/**
+ * @brief Mesh whose data already resides in device memory
+ * 
+ * References vertex and index data stored in Tensors, e.g. generated by a
+ * previous dispatch, which are read directly by the build without copying them
+ * to or from the host.
+ * 
+ * @note Work writing the tensors must have finished before building.
+ * 
+ * @see GeometryStore, Mesh
+*/
+struct TensorMesh {
+    /**
+     * @brief Tensor containing the vertex data
+    */
+    const Tensor<std::byte>* vertices   = nullptr;
+    /**
+     * @brief Offset in bytes into the vertex tensor where the vertices start
+    */
+    uint64_t verticesOffset             = 0;
+    /**
+     * @brief Number of vertices
+    */
+    uint32_t vertexCount                = 0;
+    /**
+     * @brief Stride between vertices in the vertex data
+    */
+    uint32_t vertexStride               = 3 * sizeof(float);
+    /**
+     * @brief Format of the position at the start of each vertex
+    */
+    VertexFormat vertexFormat           = VertexFormat::FLOAT32;
+    /**
+     * @brief Tensor containing the index data. May be null.
+    */
+    const Tensor<std::byte>* indices    = nullptr;
+    /**
+     * @brief Offset in bytes into the index tensor where the indices start
+    */
+    uint64_t indicesOffset              = 0;
+    /**
+     * @brief Number of indices
+    */
+    uint32_t indexCount                 = 0;
+    /**
+     * @brief Whether the indices are 16 bit instead of 32 bit
+    */
+    bool shortIndices                   = false;
+};
+
+/**
+ * @brief Set of axis aligned bounding boxes
+ * 
+ * Procedural geometry consisting of axis aligned bounding boxes, each given by
+ * its minimum followed by its maximum x, y and z coordinate as floats. Ray
+ * queries report boxes hit as candidates to be intersected analytically in the
+ * shader, e.g. to trace spheres or cylinders without tessellating them. The
+ * index of the box is available as primitive index and the custom index of the
+ * instance can be used to tell different kinds of shapes apart.
+ * 
+ * @see Geometry, GeometryStore
+*/
+struct BoundingBoxes {
+    /**
+     * @brief Memory range containing the box data
+    */
+    std::span<const std::byte> boxes = {};
+    /**
+     * @brief Stride between boxes in the box data. Must be a multiple of 8.
+    */
+    uint32_t stride                  = 6 * sizeof(float);
+};
+
+/**
+ * @brief Set of axis aligned bounding boxes residing in device memory
+ * 
+ * Like BoundingBoxes, but references box data stored in a Tensor, e.g.
+ * generated by a previous dispatch, which is read directly by the build
+ * without copying it to or from the host.
+ * 
+ * @note Work writing the tensor must have finished before building.
+ * 
+ * @see BoundingBoxes, GeometryStore
+*/
+struct TensorBoundingBoxes {
+    /**
+     * @brief Tensor containing the box data
+    */
+    const Tensor<std::byte>* boxes  = nullptr;
+    /**
+     * @brief Offset in bytes into the tensor where the boxes start
+    */
+    uint64_t offset                 = 0;
+    /**
+     * @brief Number of boxes
+    */
+    uint32_t count                  = 0;
+    /**
+     * @brief Stride between boxes in the box data. Must be a multiple of 8.
+    */
+    uint32_t stride                 = 6 * sizeof(float);
 };
 
 /**
@@ -103,7 +341,8 @@ struct Geometry {
     */
     uint64_t blas_address     = 0;
     /**
-     * @brief Device memory address containing the vertex data
+     * @brief Device memory address containing the vertex data or the box data
+     *        if created from BoundingBoxes
     */
     uint64_t vertices_address = 0;
     /**
@@ -139,13 +378,48 @@ struct GeometryInstance {
     uint32_t mask        : 8  = 0xFF;
 };
 
+/**
+ * @brief Writes instances in the layout expected by the device
+ * 
+ * Converts the given instances into the layout of
+ * VkAccelerationStructureInstanceKHR, e.g. to fill a Tensor used to rebuild
+ * an AccelerationStructure on the device.
+ * 
+ * @param instances Instances to convert
+ * @param dst Memory to write to. Must hold GeometryInstanceSize bytes per
+ *            instance.
+ * 
+ * @see RebuildAccelerationStructureCommand
+*/
+HEPHAISTOS_API void writeInstances(
+    std::span<const GeometryInstance> instances, std::span<std::byte> dst);
+
+/**
+ * @brief Saves meshes in a binary mesh container
+ * 
+ * The container starts with the magic "HPMESH\0\1" followed by the number of
+ * meshes as 64 bit integer and a table holding for each mesh the offset and
+ * size in bytes of its vertex data as 64 bit integers, the vertex stride and
+ * format as 32 bit integers, the offset and number of its indices as 64 bit
+ * integers and the index size in bytes, i.e. 0, 2 or 4, followed by 4 bytes of
+ * padding. Offsets are relative to the start of the file. All values are
+ * stored in the byte order of the host.
+ * 
+ * @param path Path of the file to write
+ * @param meshes Meshes to save
+ * 
+ * @see GeometryStore
+*/
+HEPHAISTOS_API void saveMeshes(
+    const std::filesystem::path& path, std::span<const Mesh> meshes);
+
 /**
  * @brief Factory class for creating GeometryInstance from a set of Mesh
  * 
- * Upon construction GeometryStore creates a Geometry for each provided Mesh and
- * provides methods for creating GeometryInstance from them.
+ * Upon construction GeometryStore creates a Geometry for each provided Mesh or
+ * BoundingBoxes and provides methods for creating GeometryInstance from them.
  * 
- * @see Geometry, GeometryInstance, Mesh
+ * @see BoundingBoxes, Geometry, GeometryInstance, Mesh
 */
 class HEPHAISTOS_API GeometryStore : public Resource {
 public:
@@ -165,6 +439,36 @@ public:
      * @brief Returns the amount of Geometry in this store
     */
     [[nodiscard]] size_t size() const noexcept;
+    /**
+     * @brief Wether the stored geometries can be updated with new vertices
+     * 
+     * @see UpdateGeometryCommand
+    */
+    [[nodiscard]] bool updatable() const noexcept;
+    /**
+     * @brief Returns the sizes of all geometries before and after compaction
+    */
+    [[nodiscard]] const BuildSizes& buildSizes() const noexcept;
+    /**
+     * @brief Wether the geometries were loaded from serialized data
+     * 
+     * False, if they were built instead, e.g. because the serialized data was
+     * incompatible with the device.
+    */
+    [[nodiscard]] bool deserialized() const noexcept;
+
+    /**
+     * @brief Serializes the stored geometries
+     * 
+     * The returned data can be used to recreate the geometries without
+     * building them again, e.g. on the next start of the application. It is
+     * only compatible with the same device and driver version.
+     * 
+     * @note The mesh data is not included.
+     * 
+     * @return Opaque serialized geometries
+    */
+    [[nodiscard]] std::vector<std::byte> serialize() const;
 
     /**
      * @brief Creates a GeometryInstance referencing the i-th Geometry
@@ -199,13 +503,16 @@ public:
      * @param mesh Mesh to create a Geometry from
      * @param keepMeshData If False, deletes mesh data from device memory after
      *                     creating Geometry.
+     * @param options Options used for building. allowUpdate implies
+     *                keepMeshData.
      * 
-     * @see Geometry, Mesh
+     * @see Geometry, Mesh, UpdateGeometryCommand
     */
     GeometryStore(
         ContextHandle context,
         const Mesh& mesh,
-        bool keepMeshData = false);
+        bool keepMeshData = false,
+        const BuildOptions& options = {});
     /**
      * @brief Creates a new GeometryStore
      * 
@@ -220,20 +527,256 @@ public:
      * @param meshes List of Mesh to create Geometry from
      * @param keepMeshData If False, deletes mesh data from device memory after
      *                     creating Geometry.
+     * @param options Options used for building. allowUpdate implies
+     *                keepMeshData.
+     * 
+     * @see Geometry, Mesh, UpdateGeometryCommand
+    */
+    GeometryStore(
+        ContextHandle context,
+        std::span<const Mesh> meshes,
+        bool keepMeshData = false,
+        const BuildOptions& options = {});
+    /**
+     * @brief Creates a new GeometryStore from meshes in device memory
+     * 
+     * Builds the geometries directly from the referenced tensors. Each
+     * Geometry stores the device addresses of its vertices and indices inside
+     * the tensors.
+     * 
+     * @note Work writing the tensors must have finished before calling this.
+     * @note If allowUpdate is set, the index tensors must outlive the store as
+     *       refits read the indices again.
+     * 
+     * @param context Context on which to create the GeometryStore
+     * @param meshes List of TensorMesh to create Geometry from
+     * @param options Options used for building
+     * 
+     * @see Geometry, TensorMesh, UpdateGeometryCommand
+    */
+    GeometryStore(
+        ContextHandle context,
+        std::span<const TensorMesh> meshes,
+        const BuildOptions& options = {});
+    /**
+     * @brief Creates a new GeometryStore from procedural geometry
+     * 
+     * @note Device memory addresses to the box data are stored inside each
+     *       Geometry as vertices_address
+     * 
+     * @param context Context on which to create the GeometryStore
+     * @param boxes BoundingBoxes to create a Geometry from
+     * @param keepBoxData If False, deletes box data from device memory after
+     *                    creating Geometry.
+     * @param options Options used for building. allowUpdate implies
+     *                keepBoxData.
+     * 
+     * @see BoundingBoxes, Geometry, UpdateGeometryCommand
+    */
+    GeometryStore(
+        ContextHandle context,
+        const BoundingBoxes& boxes,
+        bool keepBoxData = false,
+        const BuildOptions& options = {});
+    /**
+     * @brief Creates a new GeometryStore from procedural geometry
+     * 
+     * Creates a Geometry for each BoundingBoxes provided. Geometries can later
+     * be referenced using their index which matches the index of the boxes
+     * provided to create it.
+     * 
+     * @note Device memory addresses to the box data are stored inside each
+     *       Geometry as vertices_address
+     * 
+     * @param context Context on which to create the GeometryStore
+     * @param boxes List of BoundingBoxes to create Geometry from
+     * @param keepBoxData If False, deletes box data from device memory after
+     *                    creating Geometry.
+     * @param options Options used for building. allowUpdate implies
+     *                keepBoxData.
+     * 
+     * @see BoundingBoxes, Geometry, UpdateGeometryCommand
+    */
+    GeometryStore(
+        ContextHandle context,
+        std::span<const BoundingBoxes> boxes,
+        bool keepBoxData = false,
+        const BuildOptions& options = {});
+    /**
+     * @brief Creates a new GeometryStore from procedural geometry in device
+     *        memory
+     * 
+     * Builds the geometries directly from the referenced tensors. Each
+     * Geometry stores the device address of its boxes inside the tensor as
+     * vertices_address.
+     * 
+     * @note Work writing the tensors must have finished before calling this.
+     * 
+     * @param context Context on which to create the GeometryStore
+     * @param boxes List of TensorBoundingBoxes to create Geometry from
+     * @param options Options used for building
+     * 
+     * @see Geometry, TensorBoundingBoxes, UpdateGeometryCommand
+    */
+    GeometryStore(
+        ContextHandle context,
+        std::span<const TensorBoundingBoxes> boxes,
+        const BuildOptions& options = {});
+    /**
+     * @brief Creates a new GeometryStore from serialized geometries
+     * 
+     * Loads the geometries from data previously returned by serialize(). Falls
+     * back to building them from the meshes if the data is empty, malformed,
+     * does not contain one geometry per mesh or is incompatible with the
+     * device, e.g. after a driver update.
+     * 
+     * @note Loaded geometries keep no mesh data and cannot be updated. If
+     *       allowUpdate is set, the geometries are always built.
+     * 
+     * @param context Context on which to create the GeometryStore
+     * @param serialized Data returned by serialize(). May be empty.
+     * @param meshes List of Mesh to build Geometry from if loading fails
+     * @param options Options used for building
      * 
-     * @see Geometry, Mesh
+     * @see deserialized(), serialize()
     */
     GeometryStore(
         ContextHandle context,
+        std::span<const std::byte> serialized,
         std::span<const Mesh> meshes,
-        bool keepMeshData = false);
+        const BuildOptions& options = {});
+    /**
+     * @brief Creates a new GeometryStore from a binary mesh container
+     * 
+     * Maps the file into memory and streams the mesh data in chunks through
+     * the context's staging memory directly into device memory, so the meshes
+     * never have to be loaded into host memory as a whole.
+     * 
+     * @param context Context on which to create the GeometryStore
+     * @param path Path to a file written by saveMeshes()
+     * @param keepMeshData If False, deletes mesh data from device memory after
+     *                     creating Geometry.
+     * @param options Options used for building. allowUpdate implies
+     *                keepMeshData.
+     * 
+     * @see Geometry, saveMeshes()
+    */
+    GeometryStore(
+        ContextHandle context,
+        const std::filesystem::path& path,
+        bool keepMeshData = false,
+        const BuildOptions& options = {});
     ~GeometryStore() override;
 
+    /**
+     * @brief Creates a new GeometryStore in the background
+     * 
+     * Builds the geometries on an internal worker pool, so the calling thread
+     * can continue e.g. loading the rest of the scene while the device builds
+     * them. All meshes are built in a single batch.
+     * 
+     * @note The memory referenced by the meshes must stay alive until the
+     *       returned future is ready.
+     * 
+     * @param context Context on which to create the GeometryStore
+     * @param meshes List of Mesh to create Geometry from
+     * @param keepMeshData If False, deletes mesh data from device memory after
+     *                     creating Geometry.
+     * @param options Options used for building. allowUpdate implies
+     *                keepMeshData.
+     * @return Future of the GeometryStore rethrowing any error during creation
+    */
+    [[nodiscard]] static std::future<GeometryStore> buildAsync(
+        ContextHandle context,
+        std::span<const Mesh> meshes,
+        bool keepMeshData = false,
+        const BuildOptions& options = {});
+
 private:
+    friend class UpdateGeometryCommand;
     struct Imp;
     std::unique_ptr<Imp> pImp;
 };
 
+/**
+ * @brief Command for refitting a Geometry to new vertex positions
+ * 
+ * Updates the BLAS of a Geometry in place using vertex positions read from a
+ * Tensor, which is considerably cheaper than building a new one. The topology,
+ * i.e. the number of vertices, their stride and the indices, stays the same.
+ * Geometries created from BoundingBoxes read new boxes instead, using the
+ * same count and stride.
+ * Refitting degrades the trace performance if vertices move a lot compared to
+ * the initial build.
+ * 
+ * @note Acceleration structures referencing the updated Geometry must be
+ *       rebuilt afterwards to account for the changed bounds.
+ * @note The GeometryStore must have been created with
+ *       BuildOptions::allowUpdate set.
+ * 
+ * @see GeometryStore
+*/
+class HEPHAISTOS_API UpdateGeometryCommand : public Command {
+public:
+    /**
+     * @brief GeometryStore containing the Geometry to update
+    */
+    std::reference_wrapper<const GeometryStore> store;
+    /**
+     * @brief Index of the Geometry to update
+    */
+    size_t index;
+    /**
+     * @brief Tensor containing the new vertex positions
+    */
+    std::reference_wrapper<const Tensor<std::byte>> vertices;
+    /**
+     * @brief Offset in bytes into the tensor where the vertices start
+    */
+    uint64_t offset;
+
+    virtual void record(vulkan::Command& cmd) const override;
+
+    UpdateGeometryCommand(const UpdateGeometryCommand& other);
+    UpdateGeometryCommand& operator=(const UpdateGeometryCommand& other);
+
+    UpdateGeometryCommand(UpdateGeometryCommand&& other) noexcept;
+    UpdateGeometryCommand& operator=(UpdateGeometryCommand&& other) noexcept;
+
+    /**
+     * @brief Creates a new UpdateGeometryCommand
+     * 
+     * @param store GeometryStore containing the Geometry to update
+     * @param idx Index of the Geometry to update
+     * @param vertices Tensor containing the new vertex positions using the
+     *                 same layout as the Mesh used to create the Geometry
+     * @param offset Offset in bytes into the tensor where the vertices start
+    */
+    UpdateGeometryCommand(
+        const GeometryStore& store,
+        size_t idx,
+        const Tensor<std::byte>& vertices,
+        uint64_t offset = 0);
+    ~UpdateGeometryCommand() override;
+};
+/**
+ * @brief Creates a new UpdateGeometryCommand
+ * 
+ * @param store GeometryStore containing the Geometry to update
+ * @param idx Index of the Geometry to update
+ * @param vertices Tensor containing the new vertex positions using the same
+ *                 layout as the Mesh used to create the Geometry
+ * @param offset Offset in bytes into the tensor where the vertices start
+*/
+[[nodiscard]] inline UpdateGeometryCommand updateGeometry(
+    const GeometryStore& store,
+    size_t idx,
+    const Tensor<std::byte>& vertices,
+    uint64_t offset = 0)
+{
+    return UpdateGeometryCommand(store, idx, vertices, offset);
+}
+
 /**
  * @brief Acceleration structure used for tracing rays against
  * 
@@ -246,6 +789,15 @@ class HEPHAISTOS_API AccelerationStructure : public Argument, public Resource {
 public:
     void bindParameter(VkWriteDescriptorSet& binding) const final override;
 
+    /**
+     * @brief Returns the maximum number of instances it can be built from
+    */
+    [[nodiscard]] uint32_t maxInstances() const noexcept;
+    /**
+     * @brief Returns the size of the acceleration structure in bytes
+    */
+    [[nodiscard]] uint64_t size_bytes() const noexcept;
+
     AccelerationStructure(const AccelerationStructure&) = delete;
     AccelerationStructure& operator=(const AccelerationStructure&) = delete;
 
@@ -257,21 +809,345 @@ public:
      * 
      * @param context Context on which to create the AccelerationStructure
      * @param instance GeometryInstance used to create the AccelerationStructure
+     * @param options Options used for building
     */
-    AccelerationStructure(ContextHandle context, const GeometryInstance& instance);
+    AccelerationStructure(ContextHandle context, const GeometryInstance& instance,
+        const BuildOptions& options = {});
     /**
      * @brief Creates a new acceleration structure
      * 
      * @param context Context on which to create the AccelerationStructure
      * @param instances List of GeometryInstance used to create the
      *                  AccelerationStructure
+     * @param options Options used for building
     */
-    AccelerationStructure(ContextHandle context, std::span<const GeometryInstance> instances);
+    AccelerationStructure(ContextHandle context, std::span<const GeometryInstance> instances,
+        const BuildOptions& options = {});
+    /**
+     * @brief Creates a new acceleration structure built on the device
+     * 
+     * Reserves memory for the given amount of instances. The acceleration
+     * structure is empty and must be built using a
+     * RebuildAccelerationStructureCommand before it can be used.
+     * 
+     * @param context Context on which to create the AccelerationStructure
+     * @param maxInstances Maximum number of instances it can be built from
+     * @param options Options used for building. If allowUpdate is set, it
+     *                can also be updated instead of rebuilt, which is faster
+     *                but degrades trace performance.
+    */
+    AccelerationStructure(ContextHandle context, uint32_t maxInstances,
+        const BuildOptions& options = {});
     ~AccelerationStructure() override;
 
+    /**
+     * @brief Creates a new acceleration structure in the background
+     * 
+     * Builds the acceleration structure on an internal worker pool, so the
+     * calling thread can continue while the device builds it.
+     * 
+     * @param context Context on which to create the AccelerationStructure
+     * @param instances List of GeometryInstance used to create the
+     *                  AccelerationStructure. Copied before returning.
+     * @param options Options used for building
+     * @return Future of the AccelerationStructure rethrowing any error during
+     *         creation
+    */
+    [[nodiscard]] static std::future<AccelerationStructure> buildAsync(
+        ContextHandle context,
+        std::span<const GeometryInstance> instances,
+        const BuildOptions& options = {});
+
 private:
+    //records a build reading count instances from the given buffer
+    void record(vulkan::Command& cmd, const vulkan::Buffer& instances,
+        uint64_t offset, uint32_t count, bool update) const;
+    friend class RebuildAccelerationStructureCommand;
+
     struct Parameter;
     std::unique_ptr<Parameter> param;
 };
 
+/**
+ * @brief Command for rebuilding an AccelerationStructure on the device
+ * 
+ * Rebuilds or updates the AccelerationStructure in place using instances read
+ * from a Tensor, e.g. after animating them in a shader. The instances must use
+ * the layout of VkAccelerationStructureInstanceKHR.
+ * 
+ * Issuing the rebuild in a step on QueueType::COMPUTE lets it overlap with
+ * tracing on the main queue, e.g. of the previous frame using a second
+ * AccelerationStructure. Steps waiting on the sequence's timeline see the
+ * finished build.
+ * 
+ * @note The AccelerationStructure must have been created with a maximum
+ *       instance count.
+ * @note Updates must use the same instance count as the last rebuild.
+ * 
+ * @see AccelerationStructure, writeInstances
+*/
+class HEPHAISTOS_API RebuildAccelerationStructureCommand : public Command {
+public:
+    /**
+     * @brief AccelerationStructure to rebuild
+    */
+    std::reference_wrapper<const AccelerationStructure> accelerationStructure;
+    /**
+     * @brief Tensor containing the instances
+    */
+    std::reference_wrapper<const Tensor<std::byte>> instances;
+    /**
+     * @brief Number of instances to build from
+    */
+    uint32_t count;
+    /**
+     * @brief Offset in bytes into the tensor where the instances start
+    */
+    uint64_t offset;
+    /**
+     * @brief If true, updates the AccelerationStructure instead of rebuilding
+    */
+    bool update;
+
+    virtual void record(vulkan::Command& cmd) const override;
+
+    RebuildAccelerationStructureCommand(const RebuildAccelerationStructureCommand& other);
+    RebuildAccelerationStructureCommand& operator=(const RebuildAccelerationStructureCommand& other);
+
+    RebuildAccelerationStructureCommand(RebuildAccelerationStructureCommand&& other) noexcept;
+    RebuildAccelerationStructureCommand& operator=(RebuildAccelerationStructureCommand&& other) noexcept;
+
+    /**
+     * @brief Creates a new RebuildAccelerationStructureCommand
+     * 
+     * @param accelerationStructure AccelerationStructure to rebuild
+     * @param instances Tensor containing the instances
+     * @param count Number of instances to build from
+     * @param offset Offset in bytes into the tensor where the instances start
+     * @param update If true, updates instead of rebuilding
+    */
+    RebuildAccelerationStructureCommand(
+        const AccelerationStructure& accelerationStructure,
+        const Tensor<std::byte>& instances,
+        uint32_t count,
+        uint64_t offset = 0,
+        bool update = false);
+    ~RebuildAccelerationStructureCommand() override;
+};
+/**
+ * @brief Creates a new RebuildAccelerationStructureCommand
+ * 
+ * @param accelerationStructure AccelerationStructure to rebuild
+ * @param instances Tensor containing the instances
+ * @param count Number of instances to build from
+ * @param offset Offset in bytes into the tensor where the instances start
+ * @param update If true, updates instead of rebuilding
+*/
+[[nodiscard]] inline RebuildAccelerationStructureCommand rebuildAccelerationStructure(
+    const AccelerationStructure& accelerationStructure,
+    const Tensor<std::byte>& instances,
+    uint32_t count,
+    uint64_t offset = 0,
+    bool update = false)
+{
+    return RebuildAccelerationStructureCommand(
+        accelerationStructure, instances, count, offset, update);
+}
+
+
+/**
+ * @brief Ray cast by a RayCaster
+ *
+ * Matches the std430 layout of a struct with a vec3 origin, a float tMin, a
+ * vec3 direction and a float tMax.
+*/
+struct Ray {
+    /**
+     * @brief Origin of the ray
+    */
+    float origin[3];
+    /**
+     * @brief Minimum distance along the ray a hit is reported at
+    */
+    float tMin;
+    /**
+     * @brief Direction of the ray. Does not need to be normalized.
+    */
+    float direction[3];
+    /**
+     * @brief Maximum distance along the ray a hit is reported at
+    */
+    float tMax;
+};
+
+/**
+ * @brief Hit written by a RayCaster for each ray
+ *
+ * Distances are measured in multiples of the ray's direction.
+*/
+struct RayHit {
+    /**
+     * @brief Instance index marking a ray that did not hit anything
+    */
+    static constexpr uint32_t Miss = 0xFFFFFFFF;
+
+    /**
+     * @brief Distance along the ray of the reported hit. tMax if missed.
+    */
+    float t;
+    /**
+     * @brief Index of the hit instance in the acceleration structure or Miss
+    */
+    uint32_t instanceIndex;
+    /**
+     * @brief Custom index of the hit instance
+    */
+    uint32_t customIndex;
+    /**
+     * @brief Index of the hit triangle inside its geometry
+    */
+    uint32_t primitiveIndex;
+    /**
+     * @brief Barycentric coordinates of the second and third vertex
+    */
+    float barycentrics[2];
+    /**
+     * @brief Index of the hit geometry inside the instance's BLAS
+    */
+    uint32_t geometryIndex;
+    /**
+     * @brief Amount of hits found along the ray
+     *
+     * Zero or one unless RayCastMode::COUNT is used.
+    */
+    uint32_t count;
+};
+
+/**
+ * @brief Determines which hit a RayCaster reports
+*/
+enum class RayCastMode {
+    /**
+     * @brief Reports the closest hit along the ray
+    */
+    CLOSEST,
+    /**
+     * @brief Reports the first hit found and stops traversal, e.g. for
+     *        shadow or visibility tests. Not necessarily the closest one.
+    */
+    ANY,
+    /**
+     * @brief Counts all hits along the ray while reporting the closest one
+     *
+     * Visits every candidate, thus is considerably slower than CLOSEST.
+    */
+    COUNT
+};
+
+/**
+ * @brief Options controlling how a RayCaster runs on the device
+*/
+struct RayCasterOptions {
+    /**
+     * @brief Threads per workgroup. Zero picks one based on the device.
+     *
+     * Ray queries diverge a lot, thus small workgroups of a few subgroups
+     * usually perform best.
+    */
+    uint32_t localSize = 0;
+    /**
+     * @brief Rays cast per thread. Zero picks a default.
+    */
+    uint32_t raysPerThread = 0;
+};
+
+/**
+ * @brief Command casting a tensor of rays
+ *
+ * Created by RayCaster. Like DispatchCommand not synchronized with work
+ * recorded before or after unless hazard tracking is used.
+*/
+class HEPHAISTOS_API CastRaysCommand : public Command {
+public:
+    void record(vulkan::Command& cmd) const override;
+
+    CastRaysCommand(const CastRaysCommand&);
+    CastRaysCommand& operator=(const CastRaysCommand&);
+
+    CastRaysCommand(CastRaysCommand&&) noexcept;
+    CastRaysCommand& operator=(CastRaysCommand&&) noexcept;
+
+    ~CastRaysCommand() override;
+
+public: //internal
+    struct State;
+    explicit CastRaysCommand(std::shared_ptr<const State> state);
+
+private:
+    std::shared_ptr<const State> state;
+};
+
+/**
+ * @brief Casts batches of rays against an acceleration structure
+ *
+ * Provides a built-in ray query kernel, so casting rays does not require
+ * writing a shader. Rays are read from and hits written to tensors of Ray
+ * and RayHit respectively. Only triangle geometries are considered, while
+ * instances of BoundingBoxes are ignored. The kernel for each mode is
+ * compiled on first use and sized to the device.
+ *
+ * Requires ray tracing to be enabled via createRaytracingExtension().
+ *
+ * @note Commands reference the programs owned by this object, which
+ *       therefore must outlive them.
+*/
+class HEPHAISTOS_API RayCaster {
+public:
+    /**
+     * @brief Returns the amount of threads per workgroup
+    */
+    [[nodiscard]] uint32_t getLocalSize() const noexcept;
+    /**
+     * @brief Returns the amount of rays cast per thread
+    */
+    [[nodiscard]] uint32_t getRaysPerThread() const noexcept;
+
+    /**
+     * @brief Creates a command casting rays against the acceleration structure
+     *
+     * @param accelerationStructure Scene to cast the rays against
+     * @param rays Tensor holding the rays
+     * @param hits Tensor receiving a RayHit per ray
+     * @param mode Determines which hit gets reported
+     * @param count Amount of rays. Defaults to the size of rays.
+    */
+    [[nodiscard]] CastRaysCommand castRays(
+        const AccelerationStructure& accelerationStructure,
+        const Tensor<std::byte>& rays,
+        const Tensor<std::byte>& hits,
+        RayCastMode mode = RayCastMode::CLOSEST,
+        uint32_t count = std::numeric_limits<uint32_t>::max()) const;
+
+    RayCaster(const RayCaster&) = delete;
+    RayCaster& operator=(const RayCaster&) = delete;
+
+    RayCaster(RayCaster&& other) noexcept;
+    RayCaster& operator=(RayCaster&& other) noexcept;
+
+    /**
+     * @brief Creates a new RayCaster on the given context
+     *
+     * Throws if ray tracing is not enabled.
+     *
+     * @param context Context on which to cast rays
+     * @param options Options controlling how rays are cast on the device
+    */
+    explicit RayCaster(ContextHandle context, const RayCasterOptions& options = {});
+    ~RayCaster();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
 }
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "hephaistos/command.hpp"
+#include "hephaistos/config.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief Function called by the TaskScheduler for each task
+ *
+ * Called with the index of the configuration the task uses and the increasing
+ * count of the task, i.e. 0 for the first, 1 for the second and so on.
+*/
+using TaskFunction = std::function<void(uint32_t config, uint64_t task)>;
+
+/**
+ * @brief Result of TaskScheduler::schedule()
+*/
+struct ScheduleResult {
+    /**
+     * @brief Amount of tasks actually scheduled
+    */
+    uint32_t count;
+    /**
+     * @brief Submission running the scheduled tasks. Empty if count is zero.
+    */
+    std::optional<Submission> submission;
+};
+
+/**
+ * @brief Schedules tasks onto a set of buffered Subroutines
+ *
+ * Each task runs one of multiple Subroutines each using its own
+ * configuration, rotating through them. Before a task gets submitted, an
+ * update function prepares its configuration on a background thread once the
+ * previous task using it has finished, so the host can update the next
+ * configurations while the device is still busy. With more than two
+ * configurations the host can run multiple tasks ahead, smoothing out uneven
+ * update times. An optional process function runs on a second background
+ * thread after each task finished, e.g. to consume its results. Tasks wait on
+ * the processing of the previous one using the same configuration before
+ * overwriting its results.
+ *
+ * Tasks are bundled into a single submission per call to schedule(), making
+ * it more efficient than submitting each task on its own.
+ *
+ * @note Exceptions thrown by the update or process function are swallowed,
+ *       since the device would otherwise wait forever on the task.
+*/
+class HEPHAISTOS_API TaskScheduler {
+public:
+    /**
+     * @brief Total amount of tasks scheduled
+    */
+    [[nodiscard]] uint64_t getTotalTasks() const;
+    /**
+     * @brief Amount of scheduled tasks whose configuration has not yet been
+     *        updated
+    */
+    [[nodiscard]] uint64_t getPendingTasks() const;
+    /**
+     * @brief Amount of finished tasks, including processing if any
+    */
+    [[nodiscard]] uint64_t getFinishedTasks() const;
+    /**
+     * @brief Maximum amount of pending tasks. Zero means infinite.
+    */
+    [[nodiscard]] uint32_t getQueueSize() const noexcept;
+    /**
+     * @brief Amount of configurations tasks rotate through
+    */
+    [[nodiscard]] uint32_t getConfigCount() const noexcept;
+
+    /**
+     * @brief Schedules the given amount of tasks after previous ones
+     *
+     * Blocks while the queue is full. Stops scheduling further tasks once
+     * waiting on a free spot in the queue times out, or the tasks of this
+     * call alone would exceed the queue.
+     *
+     * @param count Amount of tasks to schedule
+     * @param timeout Timeout in nanoseconds to wait for a free spot in the
+     *                queue per task
+     * @return Amount of tasks actually scheduled and their submission
+    */
+    ScheduleResult schedule(
+        uint32_t count, uint64_t timeout = std::numeric_limits<uint64_t>::max());
+
+    /**
+     * @brief Blocks the calling code until all scheduled tasks finished
+    */
+    void wait() const;
+    /**
+     * @brief Blocks the calling code until the given amount of tasks finished
+     *
+     * @note Waiting on tasks not yet scheduled blocks until another thread
+     *       schedules them
+     *
+     * @param task Amount of tasks to wait for
+    */
+    void wait(uint64_t task) const;
+    /**
+     * @brief Blocks the calling code until the given amount of tasks finished
+     *        or the timeout expires
+     *
+     * @param task Amount of tasks to wait for
+     * @param timeout Timeout in nanoseconds
+     * @return True, if the tasks finished, false if timeout
+    */
+    [[nodiscard]] bool wait(uint64_t task, uint64_t timeout) const;
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    TaskScheduler(TaskScheduler&& other) noexcept;
+    TaskScheduler& operator=(TaskScheduler&& other) noexcept;
+
+    /**
+     * @brief Creates a new TaskScheduler
+     *
+     * @note The Subroutines must outlive the scheduler
+     *
+     * @param configs Subroutine running tasks per configuration. Requires at
+     *                least two.
+     * @param update Function updating a configuration before its task runs
+     * @param process Optional function processing the results of a task
+     * @param queueSize Maximum amount of pending tasks. Zero means infinite.
+    */
+    TaskScheduler(
+        std::vector<std::reference_wrapper<const Subroutine>> configs,
+        TaskFunction update,
+        TaskFunction process = {},
+        uint32_t queueSize = 0);
+    /**
+     * @brief Waits for the background threads to finish all pending tasks
+    */
+    ~TaskScheduler();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+}
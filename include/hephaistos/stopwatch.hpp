@@ -1,11 +1,57 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "hephaistos/command.hpp"
+#include "hephaistos/context.hpp"
+#include "hephaistos/handles.hpp"
 
 namespace hephaistos {
 
+/**
+ * @brief Checks whether the context supports calibrated timestamps
+ *
+ * Requires VK_KHR_calibrated_timestamps or VK_EXT_calibrated_timestamps
+ * supporting the time domain of the host's steady clock, which are enabled
+ * if available.
+ *
+ * @param context Context to check
+ * @return True, if calibrated timestamps are supported, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isCalibratedTimestampsSupported(const ContextHandle& context);
+
+/**
+ * @brief Correlation between device timestamps and the host's steady clock
+*/
+struct ClockCorrelation {
+    /**
+     * @brief Offset in nanoseconds converting device timestamps into
+     *        std::chrono::steady_clock time
+    */
+    double deviceOffset;
+    /**
+     * @brief Maximum deviation of the correlation in nanoseconds
+    */
+    double maxDeviation;
+};
+
+/**
+ * @brief Correlates the device's timestamps with the host's steady clock
+ *
+ * Uses calibrated timestamps if supported. Otherwise submits a single
+ * timestamp and waits on it, taking the midpoint of the host's time around
+ * the submission, whose round trip bounds the deviation. The result is kept
+ * on the context and used to convert timestamps into host time.
+ *
+ * @param context Context whose clocks to correlate
+ * @return Correlation between device and host clock
+*/
+[[nodiscard]] HEPHAISTOS_API ClockCorrelation getClockCorrelation(const ContextHandle& context);
+
 /**
  * @brief Allows measuring of elapsed time between commands execution
  * 
@@ -60,6 +106,21 @@ public:
      * @return Elapsed time between timestamps in nanoseconds
     */
     [[nodiscard]] double getElapsedTime(bool wait = false) const;
+    /**
+     * @brief Returns the host time at which the device executed start()
+     *
+     * Converts the first timestamp into std::chrono::steady_clock time in
+     * nanoseconds using the context's clock correlation. Comparing it with
+     * the host time of the submission reveals how long the work waited
+     * before starting. If wait is true, blocks the call until the timestamp
+     * is recorded, otherwise returns NaN if it is not yet available.
+     *
+     * @param wait If true, blocks the calling code until the timestamp is
+     *             recorded.
+     *
+     * @return Host time of the first timestamp in nanoseconds
+    */
+    [[nodiscard]] double getStartTime(bool wait = false) const;
 
     StopWatch(const StopWatch&) = delete;
     StopWatch& operator=(const StopWatch&) = delete;
@@ -80,4 +141,293 @@ private:
     std::unique_ptr<pImp> _pImp;
 };
 
+/**
+ * @brief Checks wether the context supports pipeline statistics
+ *
+ * Requires the pipelineStatisticsQuery feature, which is enabled if available.
+ *
+ * @param context Context to check
+ * @return True, if pipeline statistics can be queried, false otherwise.
+*/
+[[nodiscard]] HEPHAISTOS_API bool isPipelineStatisticsSupported(const ContextHandle& context);
+
+/**
+ * @brief Statistics recorded by PipelineStatistics
+*/
+struct PipelineStatisticsResult {
+    /**
+     * @brief Amount of compute shader invocations between start() and stop()
+    */
+    uint64_t invocations;
+    /**
+     * @brief Elapsed time between start() and stop() in nanoseconds
+    */
+    double elapsedTime;
+};
+
+/**
+ * @brief Counts compute shader invocations between commands execution
+ *
+ * Like StopWatch, but in addition to the elapsed time also counts the amount
+ * of compute shader invocations the device executed between start() and
+ * stop(), e.g. to report invocations per second.
+ *
+ * @note start() and stop() must be recorded into the same step of a sequence,
+ *       i.e. using And() instead of Then().
+*/
+class HEPHAISTOS_API PipelineStatistics : public Resource {
+public:
+    /**
+     * @brief Returns the command for starting the query.
+     *
+     * Records a timestamp once previous commands have been issued onto the
+     * device's pipeline and starts counting invocations.
+     *
+     * @return Command for starting the query.
+    */
+    [[nodiscard]] const Command& start();
+    /**
+     * @brief Returns the command for stopping the query.
+     *
+     * Stops counting invocations and records a timestamp once previous
+     * commands have left the pipeline, i.e. are finished.
+     *
+     * @return Command for stopping the query.
+    */
+    [[nodiscard]] const Command& stop();
+    /**
+     * @brief Resets the query, so it can be recorded again
+    */
+    void reset();
+
+    /**
+     * @brief Returns the statistics recorded between start() and stop()
+     *
+     * If wait is true, blocks the call until the results are available,
+     * otherwise returns zero invocations and a NaN elapsed time if they are
+     * not yet available.
+     *
+     * @param wait If true, blocks the calling code until all results are
+     *             recorded.
+     *
+     * @return Recorded statistics
+    */
+    [[nodiscard]] PipelineStatisticsResult getResult(bool wait = false) const;
+
+    PipelineStatistics(const PipelineStatistics&) = delete;
+    PipelineStatistics& operator=(const PipelineStatistics&) = delete;
+
+    PipelineStatistics(PipelineStatistics&& other) noexcept;
+    PipelineStatistics& operator=(PipelineStatistics&& other) noexcept;
+
+    /**
+     * @brief Creates a new PipelineStatistics on the given context.
+     *
+     * Throws if the context does not support pipeline statistics.
+     *
+     * @param context Context used to create the PipelineStatistics
+    */
+    explicit PipelineStatistics(ContextHandle context);
+    ~PipelineStatistics() override;
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+class Profiler;
+
+/**
+ * @brief Command starting or ending a named scope of a Profiler
+ *
+ * Created by Profiler::beginScope() and Profiler::endScope().
+*/
+class HEPHAISTOS_API ProfilerScopeCommand : public Command {
+public:
+    /**
+     * @brief Profiler recording the scope
+    */
+    std::reference_wrapper<Profiler> profiler;
+    /**
+     * @brief Name of the scope to begin or empty to end the innermost open scope
+    */
+    std::string name;
+
+    void record(vulkan::Command& cmd) const override;
+
+    ProfilerScopeCommand(const ProfilerScopeCommand&);
+    ProfilerScopeCommand& operator=(const ProfilerScopeCommand&);
+
+    /**
+     * @brief Creates a new ProfilerScopeCommand
+     *
+     * @param profiler Profiler recording the scope
+     * @param name Name of the scope to begin or empty to end the innermost
+     *             open scope
+    */
+    ProfilerScopeCommand(Profiler& profiler, std::string name);
+    ~ProfilerScopeCommand() override;
+};
+
+/**
+ * @brief Single measurement of a scope recorded by a Profiler
+*/
+struct ProfilerSample {
+    /**
+     * @brief Path of the scope, i.e. the names of all enclosing scopes and its
+     *        own joined by '/'
+    */
+    std::string name;
+    /**
+     * @brief Amount of scopes enclosing this one
+    */
+    uint32_t depth;
+    /**
+     * @brief Frame during which the scope was recorded
+    */
+    uint64_t frame;
+    /**
+     * @brief Device timestamp at which the scope started in nanoseconds
+    */
+    double start;
+    /**
+     * @brief Elapsed time between start and end of the scope in nanoseconds
+    */
+    double duration;
+};
+
+/**
+ * @brief Aggregated measurements of all scopes sharing the same path
+*/
+struct ProfilerScopeStatistics {
+    /**
+     * @brief Path of the scope, i.e. the names of all enclosing scopes and its
+     *        own joined by '/'
+    */
+    std::string name;
+    /**
+     * @brief Amount of scopes enclosing this one
+    */
+    uint32_t depth;
+    /**
+     * @brief Total amount of measurements since the last reset
+    */
+    uint64_t count;
+    /**
+     * @brief Shortest duration within the sample window in nanoseconds
+    */
+    double min;
+    /**
+     * @brief Mean duration within the sample window in nanoseconds
+    */
+    double mean;
+    /**
+     * @brief 99th percentile of the duration within the sample window in
+     *        nanoseconds
+    */
+    double p99;
+};
+
+/**
+ * @brief Hierarchical profiler measuring named scopes on the device
+ *
+ * Scopes are started and ended by the commands returned from beginScope()
+ * and endScope() and can be nested as well as recorded into any sequence or
+ * subroutine. Each scope brackets its commands with a pair of timestamps
+ * taken from query pools, which grow on demand.
+ *
+ * Scopes are assigned to the current frame, while the profiler keeps a ring
+ * of frameCount frames. Results are gathered without ever waiting on the
+ * device: available timestamps are read whenever collect() or nextFrame() is
+ * called, while results still not available once a frame's slot is reused
+ * frameCount frames later are discarded. The durations are aggregated per
+ * scope path into min, mean and 99th percentile over a window of the most
+ * recent measurements.
+ *
+ * @note Scopes are tracked while recording, i.e. begin and end of a scope
+ *       must be recorded in order from a single thread. Subroutines
+ *       containing scopes are measured at most once per frame and must be
+ *       recorded again once their frame's slot is reused.
+*/
+class HEPHAISTOS_API Profiler : public Resource {
+public:
+    /**
+     * @brief Returns the command starting a new scope
+     *
+     * The scope is nested inside the innermost scope still open at the time
+     * the command is recorded.
+     *
+     * @param name Name of the scope. Must not be empty or contain '/'.
+     * @return Command starting the scope on being recorded
+    */
+    [[nodiscard]] ProfilerScopeCommand beginScope(std::string_view name);
+    /**
+     * @brief Returns the command ending the innermost open scope
+     *
+     * @return Command ending the scope on being recorded
+    */
+    [[nodiscard]] ProfilerScopeCommand endScope();
+
+    /**
+     * @brief Returns the current frame number
+    */
+    [[nodiscard]] uint64_t getCurrentFrame() const noexcept;
+    /**
+     * @brief Returns the amount of frames kept in the ring
+    */
+    [[nodiscard]] uint32_t getFrameCount() const noexcept;
+    /**
+     * @brief Advances to the next frame
+     *
+     * Collects available results and recycles the queries of the frame
+     * recorded frameCount frames ago. Throws if scopes are still open.
+     *
+     * @return The new frame number
+    */
+    uint64_t nextFrame();
+
+    /**
+     * @brief Reads all results available without waiting on the device
+    */
+    void collect();
+    /**
+     * @brief Returns the collected measurements of the frames still in the ring
+     *
+     * Calls collect() first. Samples are ordered by frame and start time.
+    */
+    [[nodiscard]] std::vector<ProfilerSample> getSamples();
+    /**
+     * @brief Returns the aggregated measurements ordered by scope path
+     *
+     * Calls collect() first.
+    */
+    [[nodiscard]] std::vector<ProfilerScopeStatistics> getStatistics();
+    /**
+     * @brief Clears the aggregated measurements
+    */
+    void resetStatistics();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    Profiler(Profiler&& other) noexcept;
+    Profiler& operator=(Profiler&& other) noexcept;
+
+    /**
+     * @brief Creates a new Profiler on the given context.
+     *
+     * @param context Context used to create the Profiler
+     * @param frameCount Amount of frames kept in the ring. Should exceed the
+     *                   amount of frames the device lags behind the host.
+    */
+    explicit Profiler(ContextHandle context, uint32_t frameCount = 3);
+    ~Profiler() override;
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+
+    friend class ProfilerScopeCommand;
+};
+
 }
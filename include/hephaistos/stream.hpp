@@ -0,0 +1,373 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "hephaistos/buffer.hpp"
+#include "hephaistos/command.hpp"
+#include "hephaistos/config.hpp"
+#include "hephaistos/context.hpp"
+#include "hephaistos/handles.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief Function filling the next chunk of input
+ *
+ * Called with the host memory of the chunk and its index. Returns the amount
+ * of items written, which must not exceed the chunk size. Returning zero ends
+ * the stream.
+*/
+using ChunkSource = std::function<uint64_t(std::span<std::byte> chunk, uint64_t index)>;
+/**
+ * @brief Function consuming the output of a chunk
+ *
+ * Called in order with the host memory holding the chunk's output items and
+ * its index. The memory is only valid during the call.
+*/
+using ChunkSink = std::function<void(std::span<const std::byte> chunk, uint64_t index)>;
+
+/**
+ * @brief Options of a StreamExecutor
+*/
+struct StreamOptions {
+    /**
+     * @brief Items per chunk. Zero derives it from the memory budget.
+    */
+    uint64_t chunkSize = 0;
+    /**
+     * @brief Amount of chunks in flight, each using its own slot
+    */
+    uint32_t slots = 3;
+    /**
+     * @brief Fraction of the remaining device memory budget the slots may
+     *        occupy when deriving the chunk size
+    */
+    float memoryFraction = 0.5f;
+    /**
+     * @brief If true, runs transfers on the dedicated transfer queue if there
+     *        is one, allowing them to overlap with compute
+    */
+    bool useTransferQueue = true;
+};
+
+/**
+ * @brief Device memory of a single chunk in flight
+*/
+struct StreamSlot {
+    /**
+     * @brief Tensor holding the chunk's input items
+    */
+    const Tensor<std::byte>& input;
+    /**
+     * @brief Tensor receiving the chunk's output items
+    */
+    const Tensor<std::byte>& output;
+    /**
+     * @brief Tensor holding the amount of items in the chunk as single uint32.
+     *        Only the last chunk may be partially filled.
+    */
+    const Tensor<uint32_t>& count;
+};
+
+/**
+ * @brief Streams datasets larger than device memory through the device in
+ *        chunks
+ *
+ * Each chunk is uploaded from the host, processed by a per slot Subroutine
+ * and its output downloaded again. Chunks rotate through multiple slots, each
+ * with its own device and staging memory as well as Timeline, so the upload
+ * of one chunk, the compute of the previous and the download of the one
+ * before may run concurrently. Transfers run on the dedicated transfer queue
+ * where available. While the device is busy, the host fills the next chunk
+ * and consumes finished ones.
+ *
+ * Subroutines are recorded against the tensors of their slot, which are
+ * available after construction, i.e. the executor is created first and the
+ * Subroutines afterwards.
+*/
+class HEPHAISTOS_API StreamExecutor {
+public:
+    /**
+     * @brief Returns the maximum amount of items per chunk
+    */
+    [[nodiscard]] uint64_t getChunkSize() const noexcept;
+    /**
+     * @brief Returns the amount of slots chunks rotate through
+    */
+    [[nodiscard]] uint32_t getSlotCount() const noexcept;
+    /**
+     * @brief Returns the size of a single input item in bytes
+    */
+    [[nodiscard]] uint64_t getInputItemSize() const noexcept;
+    /**
+     * @brief Returns the size of a single output item in bytes
+    */
+    [[nodiscard]] uint64_t getOutputItemSize() const noexcept;
+    /**
+     * @brief Returns the device memory of the given slot
+    */
+    [[nodiscard]] StreamSlot getSlot(uint32_t slot) const;
+
+    /**
+     * @brief Streams chunks from source through the device into sink
+     *
+     * Blocks until the source ran dry and the sink consumed all chunks.
+     *
+     * @param compute Subroutine processing the chunk in each slot. Must
+     *                process all items of its slot's input tensor given by
+     *                its count tensor.
+     * @param source Function filling the input of the next chunk
+     * @param sink Function consuming the output of a finished chunk
+     * @return Amount of chunks processed
+    */
+    uint64_t run(
+        const std::vector<std::reference_wrapper<const Subroutine>>& compute,
+        const ChunkSource& source,
+        const ChunkSink& sink);
+
+    StreamExecutor(const StreamExecutor&) = delete;
+    StreamExecutor& operator=(const StreamExecutor&) = delete;
+
+    StreamExecutor(StreamExecutor&& other) noexcept;
+    StreamExecutor& operator=(StreamExecutor&& other) noexcept;
+
+    /**
+     * @brief Creates a new StreamExecutor
+     *
+     * If no chunk size is given, derives it from the device memory budget
+     * remaining after subtracting the current usage, i.e. resources created
+     * before the executor are taken into account.
+     *
+     * @param context Context onto which to create the executor
+     * @param inputItemSize Size of a single input item in bytes
+     * @param outputItemSize Size of a single output item in bytes
+     * @param options Options of the executor
+    */
+    StreamExecutor(
+        ContextHandle context,
+        uint64_t inputItemSize,
+        uint64_t outputItemSize,
+        const StreamOptions& options = {});
+    ~StreamExecutor();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Uploads data to tensors through a ring of staging buffers
+ *
+ * Hands out the memory of the next free staging buffer, which gets copied
+ * into a tensor by the following call to upload(). Each buffer is recycled
+ * once the Timeline passes its last upload, so the host can fill the next
+ * buffers while previous uploads are still in flight. Uploads run in order
+ * on the transfer queue if there is one.
+*/
+class HEPHAISTOS_API StreamingUploader {
+public:
+    /**
+     * @brief Returns the size of each staging buffer in bytes
+    */
+    [[nodiscard]] uint64_t getBufferSize() const noexcept;
+    /**
+     * @brief Returns the amount of staging buffers
+    */
+    [[nodiscard]] uint32_t getBufferCount() const noexcept;
+    /**
+     * @brief Returns the Timeline the uploads signal
+    */
+    [[nodiscard]] const Timeline& getTimeline() const noexcept;
+
+    /**
+     * @brief Returns the memory of the next free staging buffer
+     *
+     * Blocks until the upload previously using the buffer finished. Calling
+     * it again without an upload in between returns the same memory.
+    */
+    [[nodiscard]] std::span<std::byte> next();
+    /**
+     * @brief Uploads the memory returned by next() into the given tensor
+     *
+     * @param dst Tensor to copy to
+     * @param dstOffset Offset into dst in bytes
+     * @param size Amount of bytes to copy. Defaults to the whole buffer
+     *             clamped to the remaining size of dst.
+     * @return Submission of the upload
+    */
+    Submission upload(
+        const Tensor<std::byte>& dst,
+        uint64_t dstOffset = 0,
+        uint64_t size = whole_size);
+    /**
+     * @brief Uploads the given data into the tensor, splitting it across
+     *        staging buffers if needed
+     *
+     * Only blocks while waiting on free staging buffers, i.e. the last
+     * uploads may still be in flight after returning.
+     *
+     * @param data Data to upload
+     * @param dst Tensor to copy to
+     * @param dstOffset Offset into dst in bytes
+    */
+    void upload(
+        std::span<const std::byte> data,
+        const Tensor<std::byte>& dst,
+        uint64_t dstOffset = 0);
+
+    /**
+     * @brief Blocks until all uploads finished
+    */
+    void wait() const;
+
+    StreamingUploader(const StreamingUploader&) = delete;
+    StreamingUploader& operator=(const StreamingUploader&) = delete;
+
+    StreamingUploader(StreamingUploader&& other) noexcept;
+    StreamingUploader& operator=(StreamingUploader&& other) noexcept;
+
+    /**
+     * @brief Creates a new StreamingUploader
+     *
+     * @param context Context onto which to create the uploader
+     * @param bufferSize Size of each staging buffer in bytes
+     * @param bufferCount Amount of staging buffers. Requires at least one.
+     * @param queue Type of queue to run uploads on. Falls back to the main
+     *              queue if there is no dedicated one.
+    */
+    StreamingUploader(
+        ContextHandle context,
+        uint64_t bufferSize,
+        uint32_t bufferCount = 2,
+        QueueType queue = QueueType::TRANSFER);
+    /**
+     * @brief Waits for all uploads to finish
+    */
+    ~StreamingUploader();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Downloads data from tensors through a ring of staging buffers
+ *
+ * Mirrors StreamingUploader: download() copies a tensor region into the next
+ * staging buffer without waiting, while fetch() waits for the oldest pending
+ * download and returns its memory. Multiple downloads can be in flight at
+ * once, up to the amount of staging buffers. Downloads run in order on the
+ * transfer queue if there is one.
+*/
+class HEPHAISTOS_API StreamingDownloader {
+public:
+    /**
+     * @brief Returns the size of each staging buffer in bytes
+    */
+    [[nodiscard]] uint64_t getBufferSize() const noexcept;
+    /**
+     * @brief Returns the amount of staging buffers
+    */
+    [[nodiscard]] uint32_t getBufferCount() const noexcept;
+    /**
+     * @brief Returns the Timeline the downloads signal
+    */
+    [[nodiscard]] const Timeline& getTimeline() const noexcept;
+    /**
+     * @brief Returns the amount of downloads not yet fetched
+    */
+    [[nodiscard]] uint32_t getPendingCount() const noexcept;
+
+    /**
+     * @brief Downloads a region of the given tensor into the next staging
+     *        buffer
+     *
+     * @note Throws if all staging buffers hold downloads not yet fetched
+     *
+     * @param src Tensor to copy from
+     * @param srcOffset Offset into src in bytes
+     * @param size Amount of bytes to copy. Defaults to the whole buffer
+     *             clamped to the remaining size of src.
+     * @return Submission of the download
+    */
+    Submission download(
+        const Tensor<std::byte>& src,
+        uint64_t srcOffset = 0,
+        uint64_t size = whole_size);
+    /**
+     * @brief Waits for the oldest pending download and returns its data
+     *
+     * The memory stays valid until its staging buffer gets used by another
+     * download.
+     *
+     * @note Throws if there is no pending download
+    */
+    [[nodiscard]] std::span<const std::byte> fetch();
+    /**
+     * @brief Downloads a region of the given tensor into the given memory,
+     *        splitting it across staging buffers if needed
+     *
+     * Keeps all staging buffers in flight and blocks until the data has been
+     * copied.
+     *
+     * @note Requires no pending downloads
+     *
+     * @param src Tensor to copy from
+     * @param data Memory to copy into
+     * @param srcOffset Offset into src in bytes
+    */
+    void download(
+        const Tensor<std::byte>& src,
+        std::span<std::byte> data,
+        uint64_t srcOffset = 0);
+
+    StreamingDownloader(const StreamingDownloader&) = delete;
+    StreamingDownloader& operator=(const StreamingDownloader&) = delete;
+
+    StreamingDownloader(StreamingDownloader&& other) noexcept;
+    StreamingDownloader& operator=(StreamingDownloader&& other) noexcept;
+
+    /**
+     * @brief Creates a new StreamingDownloader
+     *
+     * @param context Context onto which to create the downloader
+     * @param bufferSize Size of each staging buffer in bytes
+     * @param bufferCount Amount of staging buffers. Requires at least one.
+     * @param queue Type of queue to run downloads on. Falls back to the main
+     *              queue if there is no dedicated one.
+    */
+    StreamingDownloader(
+        ContextHandle context,
+        uint64_t bufferSize,
+        uint32_t bufferCount = 2,
+        QueueType queue = QueueType::TRANSFER);
+    /**
+     * @brief Waits for all downloads to finish
+    */
+    ~StreamingDownloader();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Derives the amount of items per chunk fitting into the memory budget
+ *
+ * @param context Context to query the memory budget from
+ * @param bytesPerItem Device memory occupied per item and slot
+ * @param slots Amount of chunks in flight
+ * @param memoryFraction Fraction of the remaining budget to occupy
+ * @return Amount of items per chunk. At least one.
+*/
+[[nodiscard]] HEPHAISTOS_API uint64_t getStreamChunkSize(
+    const ContextHandle& context,
+    uint64_t bytesPerItem,
+    uint32_t slots = 3,
+    float memoryFraction = 0.5f);
+
+}
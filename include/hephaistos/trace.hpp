@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "hephaistos/config.hpp"
+#include "hephaistos/handles.hpp"
+#include "hephaistos/stopwatch.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief Single event of a Trace
+*/
+struct TraceEvent {
+    /**
+     * @brief Name of the event, e.g. the scope name for device events
+    */
+    std::string name;
+    /**
+     * @brief Category of the event, e.g. "submit", "wait", "update" or "device"
+    */
+    std::string category;
+    /**
+     * @brief Track the event belongs to
+     *
+     * Zero for events on the device, otherwise the index of the host thread
+     * starting at one.
+    */
+    uint32_t thread;
+    /**
+     * @brief Start of the event on the host's steady clock in nanoseconds
+    */
+    double start;
+    /**
+     * @brief Duration of the event in nanoseconds. Zero for instant events.
+    */
+    double duration;
+};
+
+/**
+ * @brief Host and device events recorded between beginTrace() and endTrace()
+*/
+struct Trace {
+    /**
+     * @brief Recorded events
+    */
+    std::vector<TraceEvent> events;
+    /**
+     * @brief Time at which tracing started on the host's steady clock in
+     *        nanoseconds
+    */
+    double startTime;
+    /**
+     * @brief Offset converting device timestamps into the host's steady clock
+     *        in nanoseconds
+    */
+    double deviceOffset;
+};
+
+/**
+ * @brief Starts recording host events on the given context
+ *
+ * Records submissions, waits on timelines and timeline updates from the host
+ * until endTrace() is called. Also correlates the device's timestamps with
+ * the host's steady clock, so profiler samples can be added to the trace.
+ * Restarts tracing if it was already active.
+ *
+ * @param context Context on which to record events
+*/
+HEPHAISTOS_API void beginTrace(const ContextHandle& context);
+/**
+ * @brief Stops recording host events on the given context
+ *
+ * @param context Context on which events were recorded
+ * @return Trace containing all events recorded since beginTrace()
+*/
+[[nodiscard]] HEPHAISTOS_API Trace endTrace(const ContextHandle& context);
+/**
+ * @brief Checks whether the given context is recording host events
+*/
+[[nodiscard]] HEPHAISTOS_API bool isTracing(const ContextHandle& context);
+
+/**
+ * @brief Adds samples of a Profiler as device events to the trace
+ *
+ * @param trace Trace to add the events to
+ * @param samples Samples as returned by Profiler::getSamples()
+*/
+HEPHAISTOS_API void addProfilerSamples(Trace& trace, std::span<const ProfilerSample> samples);
+
+/**
+ * @brief Writes the trace in the Chrome trace event JSON format
+ *
+ * The result can be opened by chrome://tracing or the Perfetto UI.
+ *
+ * @param trace Trace to write
+ * @return JSON string
+*/
+[[nodiscard]] HEPHAISTOS_API std::string writeChromeTrace(const Trace& trace);
+/**
+ * @brief Writes the trace in the Perfetto protobuf format
+ *
+ * @param trace Trace to write
+ * @return Serialized protobuf message
+*/
+[[nodiscard]] HEPHAISTOS_API std::vector<std::byte> writePerfettoTrace(const Trace& trace);
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "hephaistos/context.hpp"
+#include "hephaistos/handles.hpp"
+#include "hephaistos/program.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief Options controlling how candidates are benchmarked
+*/
+struct TuningOptions {
+    /**
+     * @brief Amount of untimed runs per candidate before measuring
+    */
+    uint32_t warmup = 1;
+    /**
+     * @brief Amount of timed runs per candidate
+     *
+     * The median of all runs is used to compare candidates.
+    */
+    uint32_t repetitions = 5;
+    /**
+     * @brief File results are cached in
+     *
+     * Results are stored per device, shader code and candidates, so a single
+     * file can be shared by multiple programs and devices. Empty disables
+     * caching.
+    */
+    std::filesystem::path cacheFile = {};
+};
+
+/**
+ * @brief Result of tuning a program
+*/
+struct TuningResult {
+    /**
+     * @brief Index of the fastest candidate
+    */
+    uint32_t index;
+    /**
+     * @brief Specialization of the fastest candidate
+    */
+    std::vector<std::byte> specialization;
+    /**
+     * @brief Median time in nanoseconds of each candidate
+     *
+     * Infinite for candidates which failed to be created. Empty if the result
+     * was read from the cache.
+    */
+    std::vector<double> times;
+};
+
+/**
+ * @brief Creates the dispatch to benchmark for the given candidate
+ *
+ * Called once per candidate with the program created using its
+ * specialization. Expected to bind the parameters and return a
+ * representative dispatch, e.g. with the amount of groups matching the
+ * candidate's workgroup size.
+*/
+using TuningDispatch = std::function<DispatchCommand(Program& program, uint32_t candidate)>;
+
+/**
+ * @brief Finds the fastest specialization of the given program on the device
+ *
+ * Creates the program once for each candidate specialization, e.g. different
+ * workgroup sizes passed via local_size_x_id, and times the dispatch returned
+ * by the callback using a StopWatch. Candidates throwing while being created
+ * or benchmarked are skipped. Throws the first error if no candidate succeeds.
+ *
+ * @note Candidates must respect the device's limits, e.g. the maximum
+ *       workgroup size, as violating them is not necessarily reported.
+ *
+ * @param context Context on which to tune the program
+ * @param code Compiled shader byte code
+ * @param candidates Specializations to choose from
+ * @param dispatch Callback creating the dispatch to benchmark
+ * @param options Options controlling the benchmark and caching
+ * @return Result containing the fastest candidate
+*/
+[[nodiscard]] HEPHAISTOS_API TuningResult tuneProgram(
+    const ContextHandle& context,
+    std::span<const uint32_t> code,
+    std::span<const std::vector<std::byte>> candidates,
+    const TuningDispatch& dispatch,
+    const TuningOptions& options = {});
+/**
+ * @brief Finds the fastest specialization of the given program on the device
+ *
+ * @param context Context on which to tune the program
+ * @param code Compiled shader byte code
+ * @param candidates Specializations to choose from, e.g. simple structs
+ * @param dispatch Callback creating the dispatch to benchmark
+ * @param options Options controlling the benchmark and caching
+ * @return Result containing the fastest candidate
+*/
+template<class T, typename = typename std::enable_if_t<std::is_trivially_copyable_v<T>>>
+[[nodiscard]] TuningResult tuneProgram(
+    const ContextHandle& context,
+    std::span<const uint32_t> code,
+    std::span<const T> candidates,
+    const TuningDispatch& dispatch,
+    const TuningOptions& options = {})
+{
+    std::vector<std::vector<std::byte>> data;
+    data.reserve(candidates.size());
+    for (auto& candidate : candidates) {
+        auto bytes = std::as_bytes(std::span<const T>{ &candidate, 1 });
+        data.emplace_back(bytes.begin(), bytes.end());
+    }
+    return tuneProgram(context, code,
+        std::span<const std::vector<std::byte>>{ data }, dispatch, options);
+}
+
+}
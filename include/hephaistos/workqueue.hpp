@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include "hephaistos/buffer.hpp"
+#include "hephaistos/command.hpp"
+#include "hephaistos/config.hpp"
+#include "hephaistos/handles.hpp"
+#include "hephaistos/program.hpp"
+
+namespace hephaistos {
+
+/**
+ * @brief Header at the start of a WorkQueue's tensor
+ *
+ * Matches the layout of WorkQueue in the built-in GLSL header
+ * "hephaistos/workqueue.glsl", thus can be retrieved from the device to
+ * inspect the state of a queue.
+*/
+struct WorkQueueHeader {
+    /**
+     * @brief Groups of the next round read by the indirect dispatch
+    */
+    uint32_t dispatch[3];
+    /**
+     * @brief Index of the current round
+    */
+    uint32_t round;
+    /**
+     * @brief Amount of items popped in the current round
+    */
+    uint32_t head;
+    /**
+     * @brief Amount of items in each half of the queue
+    */
+    uint32_t count[2];
+    /**
+     * @brief Amount of items each half can hold
+    */
+    uint32_t capacity;
+    /**
+     * @brief Amount of items dropped since the queue was full
+    */
+    uint32_t overflow;
+    /**
+     * @brief Amount of items processed in finished rounds
+    */
+    uint32_t processed;
+    uint32_t _reserved[6];
+};
+static_assert(sizeof(WorkQueueHeader) == 64);
+
+/**
+ * @brief Command running persistent workgroups on a WorkQueue until it
+ *        drains
+ *
+ * Created by WorkQueue::launch(). Runs multiple dispatches synchronized among
+ * each other, but like DispatchCommand not with work recorded before or after.
+*/
+class HEPHAISTOS_API WorkQueueCommand : public Command {
+public:
+    void record(vulkan::Command& cmd) const override;
+
+    WorkQueueCommand(const WorkQueueCommand&);
+    WorkQueueCommand& operator=(const WorkQueueCommand&);
+
+    WorkQueueCommand(WorkQueueCommand&&) noexcept;
+    WorkQueueCommand& operator=(WorkQueueCommand&&) noexcept;
+
+    ~WorkQueueCommand() override;
+
+public: //internal
+    struct State;
+    explicit WorkQueueCommand(std::shared_ptr<const State> state);
+
+private:
+    std::shared_ptr<const State> state;
+};
+
+/**
+ * @brief Device side queue of work items processed by persistent workgroups
+ *
+ * Irregular workloads, e.g. paths of varying length, leave most of the device
+ * idle if each step runs its own dispatch sized to the initial amount of
+ * work. Instead, programs include the built-in header
+ * "hephaistos/workqueue.glsl" and loop popping items from the queue via
+ * workQueuePop() until it is empty, pushing follow up work via
+ * workQueuePush(). Only as many workgroups as fit onto the device at once are
+ * launched.
+ *
+ * The queue consists of two halves: Items are popped from one and pushed to
+ * the other. After each round a single invocation swaps them and sizes the
+ * next indirect dispatch to the remaining work, shrinking it to zero once the
+ * queue drained. Since items pushed in a round only get popped in the next
+ * one, no invocation ever waits on another.
+ *
+ * Items are 32 bit values, e.g. indices into other tensors holding the
+ * actual work.
+ *
+ * @note Programs access the queue via its address, which must be passed to
+ *       them, e.g. as part of the push constant.
+*/
+class HEPHAISTOS_API WorkQueue {
+public:
+    /**
+     * @brief Returns the amount of items each half of the queue can hold
+    */
+    [[nodiscard]] uint32_t getCapacity() const noexcept;
+    /**
+     * @brief Returns the tensor holding the queue
+    */
+    [[nodiscard]] const Tensor<std::byte>& getTensor() const noexcept;
+    /**
+     * @brief Returns the device address of the queue
+    */
+    [[nodiscard]] uint64_t getAddress() const noexcept;
+
+    /**
+     * @brief Returns the amount of workgroups of the given program resident
+     *        on the device at once
+    */
+    [[nodiscard]] uint32_t getOccupancy(const Program& program) const;
+
+    /**
+     * @brief Creates a command resetting the queue and filling it with a
+     *        range of consecutive items
+     *
+     * @param count Amount of items
+     * @param first Value of the first item
+    */
+    [[nodiscard]] WorkQueueCommand seed(uint32_t count, uint32_t first = 0) const;
+    /**
+     * @brief Creates a command resetting the queue and filling it with the
+     *        items stored in the given tensor
+     *
+     * @param items Tensor holding the items as uint32
+     * @param count Amount of items. Defaults to the size of items.
+    */
+    [[nodiscard]] WorkQueueCommand seed(
+        const Tensor<std::byte>& items, std::optional<uint32_t> count = std::nullopt) const;
+
+    /**
+     * @brief Creates a command running the given program until the queue
+     *        drains
+     *
+     * Each round dispatches at most as many workgroups as are resident on
+     * the device, but not more than needed for the remaining items. Rounds
+     * after the queue drained dispatch no workgroups.
+     *
+     * @note The program's bindings are captured on creation. Programs must
+     *       be given the queue's address themselves, e.g. via push.
+     *
+     * @param program Program processing the items
+     * @param push Data used as push constant
+     * @param rounds Maximum amount of rounds
+     * @param maxGroups Maximum amount of workgroups per round. Zero uses the
+     *                  occupancy of the program.
+    */
+    [[nodiscard]] WorkQueueCommand launch(
+        const Program& program,
+        std::span<const std::byte> push = {},
+        uint32_t rounds = 16,
+        uint32_t maxGroups = 0) const;
+    /**
+     * @brief Creates a command running the given program until the queue
+     *        drains
+     *
+     * @param program Program processing the items
+     * @param push Data used as push constant
+     * @param rounds Maximum amount of rounds
+     * @param maxGroups Maximum amount of workgroups per round. Zero uses the
+     *                  occupancy of the program.
+    */
+    template<class T>
+    [[nodiscard]] WorkQueueCommand launch(
+        const Program& program,
+        const T& push,
+        uint32_t rounds = 16,
+        uint32_t maxGroups = 0) const
+    {
+        return launch(program,
+            { reinterpret_cast<const std::byte*>(&push), sizeof(T) },
+            rounds, maxGroups);
+    }
+
+    WorkQueue(const WorkQueue&) = delete;
+    WorkQueue& operator=(const WorkQueue&) = delete;
+
+    WorkQueue(WorkQueue&& other) noexcept;
+    WorkQueue& operator=(WorkQueue&& other) noexcept;
+
+    /**
+     * @brief Creates a new WorkQueue
+     *
+     * @param context Context onto which to create the queue
+     * @param capacity Amount of items each half of the queue can hold
+    */
+    WorkQueue(ContextHandle context, uint32_t capacity);
+    ~WorkQueue();
+
+private:
+    struct pImp;
+    std::unique_ptr<pImp> _pImp;
+};
+
+/**
+ * @brief Returns the source of the built-in GLSL header
+ *        "hephaistos/workqueue.glsl"
+*/
+[[nodiscard]] HEPHAISTOS_API std::string_view getWorkQueueSource() noexcept;
+
+}
@@ -1,15 +1,24 @@
 #include <nanobind/nanobind.h>
 #include <nanobind/ndarray.h>
+#include <nanobind/stl/filesystem.h>
+#include <nanobind/stl/function.h>
 #include <nanobind/stl/optional.h>
 #include <nanobind/stl/string.h>
 #include <nanobind/stl/string_view.h>
+#include <nanobind/stl/tuple.h>
+#include <nanobind/stl/vector.h>
 
 #include <array>
 #include <cstdint>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 #include <hephaistos/buffer.hpp>
+#include <hephaistos/half.hpp>
 #include <hephaistos/program.hpp>
 
 #include "context.hpp"
@@ -18,10 +27,63 @@ namespace hp = hephaistos;
 namespace nb = nanobind;
 using namespace nb::literals;
 
+//lets numpy see half buffers as float16
+namespace nanobind::detail {
+template<> struct dtype_traits<hp::half> {
+    static constexpr dlpack::dtype value{
+        static_cast<uint8_t>(dlpack::dtype_code::Float), 16, 1 };
+    static constexpr auto name = const_name("float16");
+};
+}
+
 namespace {
 
 constexpr auto units = std::to_array({" B", " KB", " MB", " GB"});
 
+//regions are passed as (srcOffset, dstOffset, size) tuples
+//or (bufferOffset, tensorOffset, size) for buffer copies
+using RegionList = std::vector<std::tuple<uint64_t, uint64_t, uint64_t>>;
+
+std::vector<hp::CopyRegion> toCopyRegions(const RegionList& list) {
+    std::vector<hp::CopyRegion> regions;
+    regions.reserve(list.size());
+    for (auto& [bufferOffset, tensorOffset, size] : list) {
+        regions.push_back({
+            .bufferOffset = bufferOffset,
+            .tensorOffset = tensorOffset,
+            .size = size
+        });
+    }
+    return regions;
+}
+
+using RegionArray = nb::ndarray<const uint64_t, nb::shape<-1, 3>, nb::c_contig, nb::device::cpu>;
+
+std::vector<hp::CopyRegion> toCopyRegions(const RegionArray& array) {
+    std::vector<hp::CopyRegion> regions(array.shape(0));
+    auto data = array.data();
+    for (auto& region : regions) {
+        region.bufferOffset = data[0];
+        region.tensorOffset = data[1];
+        region.size = data[2];
+        data += 3;
+    }
+    return regions;
+}
+
+std::vector<hp::TensorCopyRegion> toTensorCopyRegions(const RegionList& list) {
+    std::vector<hp::TensorCopyRegion> regions;
+    regions.reserve(list.size());
+    for (auto& [sourceOffset, destinationOffset, size] : list) {
+        regions.push_back({
+            .sourceOffset = sourceOffset,
+            .destinationOffset = destinationOffset,
+            .size = size
+        });
+    }
+    return regions;
+}
+
 void printSize(size_t size, std::ostream& str) {
     int dim = 0;
     for (; dim < units.size() - 1 && size > 9216; dim++, size >>= 10);
@@ -40,7 +102,17 @@ public:
     RawBuffer(uint64_t size)
         : hp::Buffer<std::byte>(getCurrentContext(), size)
     {}
+    //imports the array's memory, which is kept alive by holding a reference
+    explicit RawBuffer(nb::ndarray<nb::c_contig, nb::device::cpu> array)
+        : hp::Buffer<std::byte>(getCurrentContext(),
+            { static_cast<std::byte*>(array.data()), array.nbytes() },
+            hp::import_host_memory)
+        , array(std::move(array))
+    {}
     virtual ~RawBuffer() = default;
+
+private:
+    nb::ndarray<nb::c_contig, nb::device::cpu> array;
 };
 template<class T>
 class TypedBuffer : public hp::Buffer<T> {
@@ -59,6 +131,134 @@ public:
     {}
     virtual ~TypedBuffer() = default;
 };
+
+namespace {
+
+template<class T>
+std::span<const T> span_cast(const nb::ndarray<T, nb::shape<-1>, nb::c_contig, nb::device::cpu>& array) {
+    return { array.data(), array.size() };
+}
+
+}
+
+template<class T>
+class TypedTensor : public hp::Tensor<T> {
+public:
+    using array_type = nb::ndarray<T, nb::shape<-1>, nb::c_contig, nb::device::cpu>;
+
+    TypedTensor(size_t count, bool mapped)
+        : hp::Tensor<T>(getCurrentContext(), count, mapped) {}
+    TypedTensor(size_t count, const hp::AllocationHints& hints, bool mapped)
+        : hp::Tensor<T>(getCurrentContext(), count, hints, mapped) {}
+    TypedTensor(uint64_t addr, size_t n, bool mapped)
+        : hp::Tensor<T>(getCurrentContext(), { reinterpret_cast<const T*>(addr), n }, mapped) {}
+    TypedTensor(const array_type& array, bool mapped)
+        : hp::Tensor<T>(getCurrentContext(), span_cast(array), mapped) {}
+    ~TypedTensor() override = default;
+};
+namespace {
+
+/******************************* BUFFER PROTOCOL ******************************/
+
+//memory exposed via the buffer protocol; data is null if not host visible
+struct BufferView {
+    void* data;
+    Py_ssize_t count;
+    Py_ssize_t itemSize;
+    const char* format;
+    bool readonly;
+};
+
+template<class T>
+constexpr const char* formatOf() {
+    if constexpr (std::is_same_v<T, float>) return "f";
+    else if constexpr (std::is_same_v<T, hp::half>) return "e";
+    else if constexpr (std::is_same_v<T, double>) return "d";
+    else if constexpr (std::is_same_v<T, uint8_t>) return "B";
+    else if constexpr (std::is_same_v<T, uint16_t>) return "H";
+    else if constexpr (std::is_same_v<T, uint32_t>) return "I";
+    else if constexpr (std::is_same_v<T, uint64_t>) return "Q";
+    else if constexpr (std::is_same_v<T, int8_t>) return "b";
+    else if constexpr (std::is_same_v<T, int16_t>) return "h";
+    else if constexpr (std::is_same_v<T, int32_t>) return "i";
+    else if constexpr (std::is_same_v<T, int64_t>) return "q";
+}
+
+template<class T>
+BufferView makeView(std::span<T> memory, bool readonly) {
+    return {
+        .data = const_cast<std::remove_const_t<T>*>(memory.data()),
+        .count = static_cast<Py_ssize_t>(memory.size()),
+        .itemSize = sizeof(T),
+        .format = formatOf<std::remove_const_t<T>>(),
+        .readonly = readonly
+    };
+}
+
+BufferView getView(const RawBuffer& buffer) {
+    return makeView(std::span<uint8_t>(
+        reinterpret_cast<uint8_t*>(buffer.getMemory().data()), buffer.size_bytes()), false);
+}
+BufferView getView(const hp::MappedFileBuffer& buffer) {
+    return makeView(std::span<const uint8_t>(
+        reinterpret_cast<const uint8_t*>(buffer.getMemory().data()), buffer.size_bytes()), true);
+}
+BufferView getView(const hp::PinnedBuffer& buffer) {
+    return makeView(std::span<uint8_t>(
+        reinterpret_cast<uint8_t*>(buffer.getMemory().data()), buffer.size_bytes()), false);
+}
+template<class T>
+BufferView getView(const TypedBuffer<T>& buffer) {
+    return makeView(buffer.getMemory(), false);
+}
+template<class T>
+BufferView getView(const TypedTensor<T>& tensor) {
+    if (!tensor.isMapped())
+        return { .data = nullptr };
+    return makeView(tensor.getMemory(), false);
+}
+
+template<class C>
+int getBuffer(PyObject* self, Py_buffer* view, int flags) {
+    view->obj = nullptr;
+    auto memory = getView(*nb::inst_ptr<C>(nb::handle(self)));
+    if (!memory.data) {
+        PyErr_SetString(PyExc_BufferError, "Memory is not accessible from the host!");
+        return -1;
+    }
+    if (memory.readonly && (flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "Memory is read only!");
+        return -1;
+    }
+
+    //shape and strides must outlive the view -> freed in releaseBuffer
+    auto layout = new Py_ssize_t[2]{ memory.count, memory.itemSize };
+    view->obj = Py_NewRef(self);
+    view->buf = memory.data;
+    view->len = memory.count * memory.itemSize;
+    view->readonly = memory.readonly;
+    view->itemsize = memory.itemSize;
+    view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(memory.format) : nullptr;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? layout : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? layout + 1 : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = layout;
+    return 0;
+}
+void releaseBuffer(PyObject*, Py_buffer* view) {
+    delete[] static_cast<Py_ssize_t*>(view->internal);
+}
+
+template<class C>
+PyType_Slot BufferSlots[] = {
+    { Py_bf_getbuffer, reinterpret_cast<void*>(&getBuffer<C>) },
+    { Py_bf_releasebuffer, reinterpret_cast<void*>(&releaseBuffer) },
+    { 0, nullptr }
+};
+
+}
+
 template<class T>
 void registerBuffer(nb::module_& m, const char* name, const char* type_name) {
     //build doc string
@@ -66,12 +266,14 @@ void registerBuffer(nb::module_& m, const char* name, const char* type_name) {
     docStream
         << "Buffer representing memory allocated on the host holding an array of type "
         << type_name
-        << " and given size which can be accessed as numpy array."
+        << " and given size which can be accessed as numpy array or via the buffer"
+        << " protocol, e.g. memoryview(buffer), without copies."
         << "\n\nParameters\n----------\n"
         << "size: int\n"
         << "    Number of elements\n";
 
-    nb::class_<TypedBuffer<T>, hp::Buffer<std::byte>>(m, name)
+    nb::class_<TypedBuffer<T>, hp::Buffer<std::byte>>(m, name,
+            nb::type_slots(BufferSlots<TypedBuffer<T>>))
         .def(nb::init<size_t>(), "size"_a)
         .def_prop_ro("size", [](const TypedBuffer<T>& b) { return b.size(); },
             "The number of elements in this buffer.")
@@ -90,28 +292,6 @@ void registerBuffer(nb::module_& m, const char* name, const char* type_name) {
         .doc() = docStream.str();
 }
 
-namespace {
-
-template<class T>
-std::span<const T> span_cast(const nb::ndarray<T, nb::shape<-1>, nb::c_contig, nb::device::cpu>& array) {
-    return { array.data(), array.size() };
-}
-
-}
-
-template<class T>
-class TypedTensor : public hp::Tensor<T> {
-public:
-    using array_type = nb::ndarray<T, nb::shape<-1>, nb::c_contig, nb::device::cpu>;
-
-    TypedTensor(size_t count, bool mapped)
-        : hp::Tensor<T>(getCurrentContext(), count, mapped) {}
-    TypedTensor(uint64_t addr, size_t n, bool mapped)
-        : hp::Tensor<T>(getCurrentContext(), { reinterpret_cast<const T*>(addr), n }, mapped) {}
-    TypedTensor(const array_type& array, bool mapped)
-        : hp::Tensor<T>(getCurrentContext(), span_cast(array), mapped) {}
-    ~TypedTensor() override = default;
-};
 template<class T>
 void registerTensor(nb::module_& m, const char* name, const char* type_name) {
     //build doc string
@@ -121,9 +301,11 @@ void registerTensor(nb::module_& m, const char* name, const char* type_name) {
         << type_name
         << " and given size. If mapped can be accessed from the host using its memory "
         << "address. Mapping can optionally be requested but will be ignored if the "
-        << "device does not support it. Query its support after creation via isMapped.\n";
+        << "device does not support it. Query its support after creation via isMapped. "
+        << "Mapped tensors support the buffer protocol, e.g. memoryview(tensor).\n";
 
-    nb::class_<TypedTensor<T>, hp::Tensor<std::byte>>(m, name)
+    nb::class_<TypedTensor<T>, hp::Tensor<std::byte>>(m, name,
+            nb::type_slots(BufferSlots<TypedTensor<T>>))
         .def(nb::init<size_t, bool>(),
             "size"_a, "mapped"_a = false,
             "Creates a new tensor of given size."
@@ -132,6 +314,16 @@ void registerTensor(nb::module_& m, const char* name, const char* type_name) {
             "    Number of elements\n"
             "mapped: bool, default=False\n"
             "    If True, tries to map memory to host address space")
+        .def(nb::init<size_t, const hp::AllocationHints&, bool>(),
+            "size"_a, "hints"_a, "mapped"_a = false,
+            "Creates a new tensor of given size using the given allocation hints."
+            "\n\nParameters\n----------\n"
+            "size: int\n"
+            "    Number of elements\n"
+            "hints: AllocationHints\n"
+            "    Hints for allocating the memory\n"
+            "mapped: bool, default=False\n"
+            "    If True, tries to map memory to host address space")
         .def(nb::init<uint64_t, size_t, bool>(),
             "addr"_a, "n"_a, "mapped"_a = false,
             "Creates a new tensor and fills it with the provided data"
@@ -153,6 +345,9 @@ void registerTensor(nb::module_& m, const char* name, const char* type_name) {
             "    If True, tries to map memory to host address space")
         .def_prop_ro("address", [](const TypedTensor<T>& t) { return t.address(); },
             "The device address of this tensor.")
+        .def_prop_ro("isAllocated", [](const TypedTensor<T>& t) { return t.isAllocated(); },
+            "True, if the tensor's memory was allocated. Only False for lazily allocated "
+            "tensors not used yet.")
         .def_prop_ro("isMapped", [](const TypedTensor<T>& t) { return t.isMapped(); },
             "True, if the underlying memory is writable by the CPU.")
         .def_prop_ro("memory", [](const TypedTensor<T>& t)
@@ -165,6 +360,8 @@ void registerTensor(nb::module_& m, const char* name, const char* type_name) {
         .def_prop_ro("isNonCoherent", [](const TypedTensor<T>& t) { return t.isNonCoherent(); },
             "Wether calls to flush() and invalidate() are necessary to make changes"
             "in mapped memory between devices and host available")
+        .def_prop_ro("isPooled", [](const TypedTensor<T>& t) { return t.isPooled(); },
+            "True, if the tensor is sub-allocated from a shared buffer.")
         .def("update",
             [](TypedTensor<T>& t, uint64_t ptr, size_t n, uint64_t offset) {
                 t.update({ reinterpret_cast<const T*>(ptr), n }, offset);
@@ -177,6 +374,21 @@ void registerTensor(nb::module_& m, const char* name, const char* type_name) {
             "   Amount of elements to copy\n"
             "offset: int, default=0\n"
             "   Offset into the tensor in number of elements where the copy starts")
+        .def("updateAsync",
+            [](TypedTensor<T>& t, uint64_t ptr, size_t n, uint64_t offset) {
+                return t.updateAsync({ reinterpret_cast<const T*>(ptr), n }, offset);
+            }, "addr"_a, "n"_a, "offset"_a = 0,
+            "Updates the tensor at the given offset with n elements from addr without "
+            "waiting for the transfer to finish. The data is staged before returning, "
+            "thus the memory at addr can be reused directly. The copy is ordered after "
+            "previously submitted work."
+            "\n\nParameters\n----------\n"
+            "ptr: int\n"
+            "   Address of memory to copy from\n"
+            "n: int\n"
+            "   Amount of elements to copy\n"
+            "offset: int, default=0\n"
+            "   Offset into the tensor in number of elements where the copy starts")
         .def("flush",
             [](TypedTensor<T>& t, uint64_t offset, std::optional<uint64_t> size) {
                 uint64_t _size = hp::whole_size;
@@ -202,6 +414,18 @@ void registerTensor(nb::module_& m, const char* name, const char* type_name) {
             "   Amount of elements to copy\n"
             "offset: int, default=0\n"
             "   Offset into the tensor in amount of elements where the copy starts")
+        .def("retrieveAsync",
+            [](TypedTensor<T>& t, const hp::Buffer<std::byte>& dst, uint64_t offset) {
+                return t.retrieveAsync(dst, offset);
+            }, "buffer"_a, "offset"_a = 0,
+            "Copies data from the tensor at the given offset into the buffer without "
+            "waiting for the transfer to finish. The copy is ordered after previously "
+            "submitted work."
+            "\n\nParameters\n----------\n"
+            "buffer: Buffer\n"
+            "   Buffer to copy to. Its size determines the amount of data copied\n"
+            "offset: int, default=0\n"
+            "   Offset into the tensor in amount of elements where the copy starts")
         .def("invalidate",
             [](TypedTensor<T>& t, uint64_t offset, std::optional<uint64_t> size) {
                 uint64_t _size = hp::whole_size;
@@ -219,9 +443,15 @@ void registerTensor(nb::module_& m, const char* name, const char* type_name) {
         .def("bindParameter", [](const TypedTensor<T>& t, hp::Program& p, uint32_t b)
             { t.bindParameter(p.getBinding(b)); }, "program"_a, "binding"_a,
             "Binds the tensor to the program at the given binding")
+        .def("bindParameter", [](const TypedTensor<T>& t, hp::ParameterSet& p, uint32_t b)
+            { t.bindParameter(p.getBinding(b)); }, "set"_a, "binding"_a,
+            "Binds the tensor to the parameter set at the given binding")
         .def("bindParameter", [](const TypedTensor<T>& t, hp::Program& p, std::string_view b)
             { t.bindParameter(p.getBinding(b)); }, "program"_a, "binding"_a,
             "Binds the tensor to the program at the given binding")
+        .def("bindParameter", [](const TypedTensor<T>& t, hp::ParameterSet& p, std::string_view b)
+            { t.bindParameter(p.getBinding(b)); }, "set"_a, "binding"_a,
+            "Binds the tensor to the parameter set at the given binding")
         .def("__repr__", [name = std::string(name)](const TypedTensor<T>& t) {
             std::ostringstream str;
             str << name
@@ -241,16 +471,39 @@ void registerBufferModule(nb::module_& m) {
     nb::class_<hp::Buffer<std::byte>>(m, "Buffer",
         "Base class for all buffers managing memory allocation on the host");
     nb::class_<hp::Tensor<std::byte>>(m, "Tensor",
-        "Base class for all tensors managing memory allocations on the device");
+            "Base class for all tensors managing memory allocations on the device")
+        .def_prop_ro("address", [](const hp::Tensor<std::byte>& t) { return t.address(); },
+            "The device address of this tensor.")
+        .def_prop_ro("size_bytes", [](const hp::Tensor<std::byte>& t) { return t.size_bytes(); },
+            "The size of the tensor in bytes.")
+        .def("bindParameter", [](const hp::Tensor<std::byte>& t, hp::Program& p, uint32_t b)
+            { t.bindParameter(p.getBinding(b)); }, "program"_a, "binding"_a,
+            "Binds the tensor to the program at the given binding")
+        .def("bindParameter", [](const hp::Tensor<std::byte>& t, hp::ParameterSet& p, uint32_t b)
+            { t.bindParameter(p.getBinding(b)); }, "set"_a, "binding"_a,
+            "Binds the tensor to the parameter set at the given binding")
+        .def("bindParameter", [](const hp::Tensor<std::byte>& t, hp::Program& p, std::string_view b)
+            { t.bindParameter(p.getBinding(b)); }, "program"_a, "binding"_a,
+            "Binds the tensor to the program at the given binding")
+        .def("bindParameter", [](const hp::Tensor<std::byte>& t, hp::ParameterSet& p, std::string_view b)
+            { t.bindParameter(p.getBinding(b)); }, "set"_a, "binding"_a,
+            "Binds the tensor to the parameter set at the given binding");
 
     nb::class_<RawBuffer, hp::Buffer<std::byte>>(m, "RawBuffer",
+            nb::type_slots(BufferSlots<RawBuffer>),
             "Buffer for allocating a raw chunk of memory on the host "
             "accessible via its memory address. "
-            "Useful as a base class providing more complex functionality."
+            "Useful as a base class providing more complex functionality. "
+            "Supports the buffer protocol, e.g. memoryview(buffer), without copies."
             "\n\nParameters\n----------\n"
             "size: int\n"
             "    size of the buffer in bytes")
         .def(nb::init<uint64_t>(), "size"_a)
+        .def(nb::init<nb::ndarray<nb::c_contig, nb::device::cpu>>(), "array"_a,
+            "Creates a buffer using the memory of the given contiguous array instead of "
+            "allocating new one, avoiding a copy. The array is kept alive by the buffer. "
+            "Its address and size must be multiples of getHostMemoryImportAlignment(). "
+            "Requires isHostMemoryImportSupported() to be True.")
         .def_prop_ro("address", [](const RawBuffer& b) { return b.getAddress(); },
             "The memory address of the allocated buffer.")
         .def_prop_ro("size", [](const RawBuffer& b) { return b.size(); },
@@ -265,8 +518,113 @@ void registerBufferModule(nb::module_& m) {
             return str.str();
         });
 
+    nb::class_<hp::MappedFileBuffer, hp::Buffer<std::byte>>(m, "MappedFileBuffer",
+            nb::type_slots(BufferSlots<hp::MappedFileBuffer>),
+            "Buffer backed by a region of a memory mapped file. If importing host memory "
+            "is supported, the mapped pages are used directly, letting copies stream from "
+            "the file without duplicating its content in memory. Otherwise, the region is "
+            "read into a newly allocated buffer. The content is read only and should only "
+            "be used as source of copies. Supports the read only buffer protocol.")
+        .def("__init__", [](
+            hp::MappedFileBuffer* b,
+            const std::filesystem::path& path,
+            uint64_t offset,
+            std::optional<uint64_t> size
+        ) {
+            new (b) hp::MappedFileBuffer(getCurrentContext(),
+                path, offset, size.value_or(hp::whole_size));
+        }, "path"_a, "offset"_a = 0, "size"_a.none() = nb::none(),
+            "Maps the given region of a file. If size is None, maps the rest of the file."
+            "\n\nParameters\n----------\n"
+            "path: str|PathLike\n"
+            "    Path to the file to map\n"
+            "offset: int, default=0\n"
+            "    Offset into the file in bytes\n"
+            "size: None|int, default=None\n"
+            "    Size of the region in bytes")
+        .def_prop_ro("address", [](const hp::MappedFileBuffer& b) {
+                return reinterpret_cast<int64_t>(b.getMemory().data());
+            }, "The memory address of the mapped region.")
+        .def_prop_ro("imported", &hp::MappedFileBuffer::isImported,
+            "True, if the mapped file is accessed directly by the device")
+        .def_prop_ro("size_bytes", [](const hp::MappedFileBuffer& b) { return b.size_bytes(); },
+            "The size of the buffer in bytes.");
+
+    nb::enum_<hp::HugePages>(m, "HugePages", "Kind of pages backing host memory")
+        .value("NONE", hp::HugePages::NONE,
+            "Regular pages of the system's default size")
+        .value("TRANSPARENT", hp::HugePages::TRANSPARENT,
+            "Hints the system to back the memory with transparent huge pages. "
+            "Falls back to regular pages if none are available.")
+        .value("EXPLICIT", hp::HugePages::EXPLICIT,
+            "Allocates huge pages reserved by the system's administrator. Fails "
+            "if not enough are reserved.");
+    nb::class_<hp::PinnedBuffer, hp::Buffer<std::byte>>(m, "PinnedBuffer",
+            nb::type_slots(BufferSlots<hp::PinnedBuffer>),
+            "Buffer whose host memory is allocated following a placement policy. "
+            "Allocates the pages itself and imports them, which allows to place "
+            "them on the NUMA node local to the device and to back them by huge "
+            "pages. If importing host memory is not supported, falls back to a "
+            "regular buffer ignoring the policy. Supports the buffer protocol.")
+        .def("__init__", [](
+            hp::PinnedBuffer* b, uint64_t size, bool localNumaNode, hp::HugePages hugePages
+        ) {
+            new (b) hp::PinnedBuffer(getCurrentContext(), size, {
+                .localNumaNode = localNumaNode,
+                .hugePages = hugePages
+            });
+        }, "size"_a, nb::kw_only(), "localNumaNode"_a = true,
+            "hugePages"_a = hp::HugePages::NONE,
+            "Allocates a new pinned buffer. Throws if explicit huge pages were "
+            "requested but are not available."
+            "\n\nParameters\n----------\n"
+            "size: int\n"
+            "    Size of the buffer in bytes\n"
+            "localNumaNode: bool, default=True\n"
+            "    Places the memory on the NUMA node the device is attached to\n"
+            "hugePages: HugePages, default=HugePages.NONE\n"
+            "    Kind of pages backing the memory\n")
+        .def_prop_ro("address", [](const hp::PinnedBuffer& b) {
+                return reinterpret_cast<int64_t>(b.getMemory().data());
+            }, "The memory address of the buffer.")
+        .def_prop_ro("hugePages", &hp::PinnedBuffer::getHugePages,
+            "Kind of pages the memory was allocated with")
+        .def_prop_ro("imported", &hp::PinnedBuffer::isImported,
+            "True, if the buffer uses memory allocated via its policy")
+        .def_prop_ro("numaNode", &hp::PinnedBuffer::getNumaNode,
+            "NUMA node the memory is bound to or -1 if not bound")
+        .def_prop_ro("size_bytes", [](const hp::PinnedBuffer& b) { return b.size_bytes(); },
+            "The size of the buffer in bytes.");
+
+    nb::class_<hp::UploadBuffer, hp::Buffer<std::byte>>(m, "UploadBuffer",
+            "Buffer optimized for uploading data to the device. Allocated for "
+            "sequential writes preferring device local memory visible to the host, "
+            "e.g. via resizable BAR. Such memory is usually write-combined, thus "
+            "should only be filled via write() and never be read from the host.")
+        .def("__init__", [](hp::UploadBuffer* b, uint64_t size) {
+                new (b) hp::UploadBuffer(getCurrentContext(), size);
+            }, "size"_a, "Allocates a new upload buffer of the given size in bytes")
+        .def("write",
+            [](hp::UploadBuffer& b, nb::ndarray<nb::ro, nb::c_contig, nb::device::cpu> data, uint64_t offset) {
+                std::span<const std::byte> bytes(
+                    static_cast<const std::byte*>(data.data()), data.nbytes());
+                nb::gil_scoped_release release;
+                b.write(bytes, offset);
+            }, "data"_a, "offset"_a = 0,
+            "Writes the data into the buffer using non-temporal stores if available."
+            "\n\nParameters\n----------\n"
+            "data: ndarray\n"
+            "    C contiguous array holding the data to write\n"
+            "offset: int, default=0\n"
+            "    Offset into the buffer in bytes\n")
+        .def_prop_ro("deviceLocal", &hp::UploadBuffer::isDeviceLocal,
+            "True, if the buffer lives in device local memory")
+        .def_prop_ro("size_bytes", [](const hp::UploadBuffer& b) { return b.size_bytes(); },
+            "The size of the buffer in bytes.");
+
     //Register typed buffers
     registerBuffer<float>(m, "FloatBuffer", "float");
+    registerBuffer<hp::half>(m, "HalfBuffer", "float16");
     registerBuffer<double>(m, "DoubleBuffer", "double");
     registerBuffer<uint8_t>(m, "ByteBuffer", "uint8");
     registerBuffer<uint16_t>(m, "UnsignedShortBuffer", "uint16");
@@ -279,6 +637,45 @@ void registerBufferModule(nb::module_& m) {
 
     //Register typed buffers
     registerTensor<float>(m, "FloatTensor", "float");
+    registerTensor<hp::half>(m, "HalfTensor", "float16");
+
+    //half conversion directly into and out of host visible memory
+    using FloatArray = nb::ndarray<float, nb::shape<-1>, nb::c_contig, nb::device::cpu>;
+    auto mappedMemory = [](const hp::Tensor<hp::half>& tensor) {
+        if (!tensor.isMapped())
+            throw std::runtime_error("Tensor is not mapped!");
+        return tensor.getMemory();
+    };
+    m.def("convertToHalf",
+        [](const FloatArray& src, const TypedBuffer<hp::half>& dst) {
+            nb::gil_scoped_release release;
+            hp::convertToHalf({ src.data(), src.size() }, dst.getMemory());
+        }, "src"_a, "dst"_a,
+        "Converts the float32 array into half precision writing directly into the "
+        "buffer, which must have the same size. Uses SIMD if available.");
+    m.def("convertToHalf",
+        [mappedMemory](const FloatArray& src, const TypedTensor<hp::half>& dst) {
+            auto memory = mappedMemory(dst);
+            nb::gil_scoped_release release;
+            hp::convertToHalf({ src.data(), src.size() }, memory);
+        }, "src"_a, "dst"_a,
+        "Converts the float32 array into half precision writing directly into the "
+        "mapped tensor, which must have the same size. Uses SIMD if available.");
+    m.def("convertFromHalf",
+        [](const TypedBuffer<hp::half>& src, FloatArray dst) {
+            nb::gil_scoped_release release;
+            hp::convertFromHalf(src.getMemory(), { dst.data(), dst.size() });
+        }, "src"_a, "dst"_a,
+        "Converts the buffer's half precision floats into the float32 array, which "
+        "must have the same size. Uses SIMD if available.");
+    m.def("convertFromHalf",
+        [mappedMemory](const TypedTensor<hp::half>& src, FloatArray dst) {
+            auto memory = mappedMemory(src);
+            nb::gil_scoped_release release;
+            hp::convertFromHalf(memory, { dst.data(), dst.size() });
+        }, "src"_a, "dst"_a,
+        "Converts the mapped tensor's half precision floats into the float32 array, "
+        "which must have the same size. Uses SIMD if available.");
     registerTensor<double>(m, "DoubleTensor", "double");
     registerTensor<uint8_t>(m, "ByteTensor", "uint8");
     registerTensor<uint16_t>(m, "UnsignedShortTensor", "uint16");
@@ -347,6 +744,26 @@ void registerBufferModule(nb::module_& m) {
         "    Amount of data to copy in bytes. If None, equals to the complete buffer\n"
         "unsafe: bool, default=False\n"
         "   Wether to omit barriers ensuring read after write ordering");
+    m.def("retrieveTensor",
+        [](
+            const hp::Tensor<std::byte>& src,
+            const hp::Buffer<std::byte>& dst,
+            const RegionList& regions,
+            bool unsafe
+        ) {
+            return hp::retrieveTensor(src, dst, toCopyRegions(regions), unsafe);
+        }, "src"_a, "dst"_a, "regions"_a, "unsafe"_a = false,
+        "Creates a command for copying multiple regions of the src tensor back to "
+        "the destination buffer using a single copy. Adjacent regions are merged."
+        "\n\nParameters\n----------\n"
+        "src: Tensor\n"
+        "    Source tensor\n"
+        "dst: Buffer\n"
+        "    Destination buffer\n"
+        "regions: list[tuple[int, int, int]]\n"
+        "    Regions to copy as (bufferOffset, tensorOffset, size) in bytes\n"
+        "unsafe: bool, default=False\n"
+        "   Wether to omit barriers ensuring read after write ordering");
     //update tensor command
     nb::class_<hp::UpdateTensorCommand, hp::Command>(m, "UpdateTensorCommand",
             "Command for copying the src buffer into the destination tensor")
@@ -405,6 +822,249 @@ void registerBufferModule(nb::module_& m) {
         "    Amount of data to copy in bytes. If None, equals to the complete buffer\n"
         "unsafe: bool, default=False\n"
         "   Wether to omit barriers ensuring read after write ordering");
+    m.def("updateTensor",
+        [](
+            const hp::Buffer<std::byte>& src,
+            const hp::Tensor<std::byte>& dst,
+            const RegionList& regions,
+            bool unsafe
+        ) {
+            return hp::updateTensor(src, dst, toCopyRegions(regions), unsafe);
+        }, "src"_a, "dst"_a, "regions"_a, "unsafe"_a = false,
+        "Creates a command for copying multiple regions of the src buffer into "
+        "the destination tensor using a single copy. Adjacent regions are merged."
+        "\n\nParameters\n----------\n"
+        "src: Buffer\n"
+        "    Source Buffer\n"
+        "dst: Tensor\n"
+        "    Destination Tensor\n"
+        "regions: list[tuple[int, int, int]]\n"
+        "    Regions to copy as (bufferOffset, tensorOffset, size) in bytes\n"
+        "unsafe: bool, default=False\n"
+        "   Wether to omit barriers ensuring read after write ordering");
+    m.def("updateTensorBatch",
+        [](
+            const hp::Buffer<std::byte>& src,
+            const hp::Tensor<std::byte>& dst,
+            const RegionArray& regions,
+            bool unsafe
+        ) {
+            return hp::updateTensor(src, dst, toCopyRegions(regions), unsafe);
+        }, "src"_a, "dst"_a, "regions"_a, "unsafe"_a = false,
+        "Creates a command for copying multiple regions of the src buffer into "
+        "the destination tensor using a single copy. Same as updateTensor() but "
+        "reads the regions directly from an array without walking a list."
+        "\n\nParameters\n----------\n"
+        "src: Buffer\n"
+        "    Source Buffer\n"
+        "dst: Tensor\n"
+        "    Destination Tensor\n"
+        "regions: ndarray[uint64]\n"
+        "    Regions to copy as rows of (bufferOffset, tensorOffset, size) in bytes\n"
+        "    with shape (n, 3)\n"
+        "unsafe: bool, default=False\n"
+        "   Wether to omit barriers ensuring read after write ordering");
+    m.def("retrieveTensorChunked",
+        [](
+            const hp::Tensor<std::byte>& src,
+            const hp::Buffer<std::byte>& dst,
+            uint64_t chunkSize,
+            uint64_t bufferOffset,
+            uint64_t tensorOffset,
+            std::optional<uint64_t> size
+        ) {
+            hp::CopyRegion region{ .bufferOffset = bufferOffset, .tensorOffset = tensorOffset };
+            if (size) region.size = *size;
+            return hp::retrieveTensorChunked(src, dst, chunkSize, region);
+        }, "src"_a, "dst"_a, "chunkSize"_a, "bufferOffset"_a = 0, "tensorOffset"_a = 0,
+        "size"_a.none() = nb::none(),
+        "Splits a copy from the src tensor to the destination buffer into commands "
+        "copying one chunk each. Recording each in its own step lets every chunk "
+        "signal its own timeline value."
+        "\n\nParameters\n----------\n"
+        "src: Tensor\n"
+        "    Source tensor\n"
+        "dst: Buffer\n"
+        "    Destination buffer\n"
+        "chunkSize: int\n"
+        "    Size of each chunk in bytes. The last one may be smaller.\n"
+        "bufferOffset: int, default=0\n"
+        "    Offset into the buffer in bytes\n"
+        "tensorOffset: int, default=0\n"
+        "    Offset into the tensor in bytes\n"
+        "size: None|int, default=None\n"
+        "    Amount of data to copy in bytes. If None, equals to the complete buffer\n");
+    m.def("updateTensorChunked",
+        [](
+            const hp::Buffer<std::byte>& src,
+            const hp::Tensor<std::byte>& dst,
+            uint64_t chunkSize,
+            uint64_t bufferOffset,
+            uint64_t tensorOffset,
+            std::optional<uint64_t> size
+        ) {
+            hp::CopyRegion region{ .bufferOffset = bufferOffset, .tensorOffset = tensorOffset };
+            if (size) region.size = *size;
+            return hp::updateTensorChunked(src, dst, chunkSize, region);
+        }, "src"_a, "dst"_a, "chunkSize"_a, "bufferOffset"_a = 0, "tensorOffset"_a = 0,
+        "size"_a.none() = nb::none(),
+        "Splits a copy from the src buffer to the destination tensor into commands "
+        "copying one chunk each. Recording each in its own step lets every chunk "
+        "signal its own timeline value."
+        "\n\nParameters\n----------\n"
+        "src: Buffer\n"
+        "    Source buffer\n"
+        "dst: Tensor\n"
+        "    Destination tensor\n"
+        "chunkSize: int\n"
+        "    Size of each chunk in bytes. The last one may be smaller.\n"
+        "bufferOffset: int, default=0\n"
+        "    Offset into the buffer in bytes\n"
+        "tensorOffset: int, default=0\n"
+        "    Offset into the tensor in bytes\n"
+        "size: None|int, default=None\n"
+        "    Amount of data to copy in bytes. If None, equals to the complete buffer\n");
+    m.def("retrieveTensorStreamed",
+        [](
+            const hp::Tensor<std::byte>& src,
+            const hp::Buffer<std::byte>& dst,
+            uint64_t chunkSize,
+            nb::callable callback,
+            uint64_t bufferOffset,
+            uint64_t tensorOffset,
+            std::optional<uint64_t> size
+        ) {
+            hp::CopyRegion region{ .bufferOffset = bufferOffset, .tensorOffset = tensorOffset };
+            if (size) region.size = *size;
+            hp::ChunkCallback fn = [&callback](uint64_t offset, std::span<const std::byte> chunk) {
+                nb::gil_scoped_acquire acquire;
+                //expose the chunk without copies
+                auto view = nb::steal(PyMemoryView_FromMemory(
+                    reinterpret_cast<char*>(const_cast<std::byte*>(chunk.data())),
+                    static_cast<Py_ssize_t>(chunk.size()), PyBUF_READ));
+                callback(offset, view);
+            };
+            nb::gil_scoped_release release;
+            hp::retrieveTensorStreamed(src, dst, chunkSize, fn, region);
+        }, "src"_a, "dst"_a, "chunkSize"_a, "callback"_a,
+        "bufferOffset"_a = 0, "tensorOffset"_a = 0, "size"_a.none() = nb::none(),
+        "Retrieves the src tensor in chunks and calls the callback with the offset "
+        "of each chunk relative to the copied region and a memoryview of its data "
+        "as soon as it arrived, while later chunks are still being copied. Blocks "
+        "until all chunks were consumed."
+        "\n\nParameters\n----------\n"
+        "src: Tensor\n"
+        "    Source tensor\n"
+        "dst: Buffer\n"
+        "    Destination buffer\n"
+        "chunkSize: int\n"
+        "    Size of each chunk in bytes. The last one may be smaller.\n"
+        "callback: (int, memoryview) -> None\n"
+        "    Callback consuming each chunk in order\n"
+        "bufferOffset: int, default=0\n"
+        "    Offset into the buffer in bytes\n"
+        "tensorOffset: int, default=0\n"
+        "    Offset into the tensor in bytes\n"
+        "size: None|int, default=None\n"
+        "    Amount of data to copy in bytes. If None, equals to the complete buffer\n");
+    m.def("updateTensors",
+        [](const std::vector<std::tuple<hp::Tensor<std::byte>*, uint64_t, uint64_t, uint64_t>>& list) {
+            std::vector<hp::TensorUpdate> updates;
+            updates.reserve(list.size());
+            for (auto& [tensor, ptr, size, offset] : list) {
+                updates.push_back({
+                    .tensor = *tensor,
+                    .data = { reinterpret_cast<const std::byte*>(ptr), size },
+                    .offset = offset
+                });
+            }
+            nb::gil_scoped_release release;
+            hp::updateTensors(updates);
+        }, "updates"_a,
+        "Updates multiple tensors at once, blocking only until all transfers "
+        "finished. Packs the staged data of all updates and copies them using a "
+        "single submission. All tensors must belong to the same context."
+        "\n\nParameters\n----------\n"
+        "updates: list[tuple[Tensor, int, int, int]]\n"
+        "    Updates as (tensor, addr, size, offset) with size and offset in bytes\n");
+    //copy tensor command
+    nb::class_<hp::CopyTensorCommand, hp::Command>(m, "CopyTensorCommand",
+            "Command for copying the src tensor into the destination tensor")
+        .def("__init__",
+            [](
+                hp::CopyTensorCommand* cmd,
+                const hp::Tensor<std::byte>& src,
+                const hp::Tensor<std::byte>& dst,
+                std::optional<uint64_t> srcOffset,
+                std::optional<uint64_t> dstOffset,
+                std::optional<uint64_t> size,
+                bool unsafe
+            ) {
+                hp::TensorCopyRegion region{};
+                if (srcOffset) region.sourceOffset = *srcOffset;
+                if (dstOffset) region.destinationOffset = *dstOffset;
+                if (size) region.size = *size;
+                region.unsafe = unsafe;
+                new (cmd) hp::CopyTensorCommand(src, dst, region);
+            }, "src"_a, "dst"_a,
+            "srcOffset"_a.none() = nb::none(),
+            "dstOffset"_a.none() = nb::none(),
+            "size"_a.none() = nb::none(),
+            "unsafe"_a = false);
+    m.def("copyTensor",
+        [](
+            const hp::Tensor<std::byte>& src,
+            const hp::Tensor<std::byte>& dst,
+            std::optional<uint64_t> srcOffset,
+            std::optional<uint64_t> dstOffset,
+            std::optional<uint64_t> size,
+            bool unsafe
+        ) {
+            hp::TensorCopyRegion region{};
+            if (srcOffset) region.sourceOffset = *srcOffset;
+            if (dstOffset) region.destinationOffset = *dstOffset;
+            if (size) region.size = *size;
+            region.unsafe = unsafe;
+            return hp::copyTensor(src, dst, region);
+        }, "src"_a, "dst"_a,
+        "srcOffset"_a.none() = nb::none(),
+        "dstOffset"_a.none() = nb::none(),
+        "size"_a.none() = nb::none(),
+        "unsafe"_a = false,
+        "Creates a command for copying the src tensor into the destination tensor"
+        "\n\nParameters\n----------\n"
+        "src: Tensor\n"
+        "    Source tensor\n"
+        "dst: Tensor\n"
+        "    Destination tensor\n"
+        "srcOffset: None|int, default=None\n"
+        "    Optional offset into the source tensor in bytes\n"
+        "dstOffset: None|int, default=None\n"
+        "    Optional offset into the destination tensor in bytes\n"
+        "size: None|int, default=None\n"
+        "    Amount of data to copy in bytes. If None, equals to the complete source\n"
+        "unsafe: bool, default=False\n"
+        "   Wether to omit barriers ensuring read after write ordering");
+    m.def("copyTensor",
+        [](
+            const hp::Tensor<std::byte>& src,
+            const hp::Tensor<std::byte>& dst,
+            const RegionList& regions,
+            bool unsafe
+        ) {
+            return hp::copyTensor(src, dst, toTensorCopyRegions(regions), unsafe);
+        }, "src"_a, "dst"_a, "regions"_a, "unsafe"_a = false,
+        "Creates a command for copying multiple regions of the src tensor into "
+        "the destination tensor using a single copy. Adjacent regions are merged."
+        "\n\nParameters\n----------\n"
+        "src: Tensor\n"
+        "    Source tensor\n"
+        "dst: Tensor\n"
+        "    Destination tensor\n"
+        "regions: list[tuple[int, int, int]]\n"
+        "    Regions to copy as (srcOffset, dstOffset, size) in bytes\n"
+        "unsafe: bool, default=False\n"
+        "   Wether to omit barriers ensuring read after write ordering");
     //clear tensor command
     nb::class_<hp::ClearTensorCommand, hp::Command>(m, "ClearTensorCommand",
             "Command for filling a tensor with constant data over a given range")
@@ -465,4 +1125,355 @@ void registerBufferModule(nb::module_& m) {
         "    32 bit integer used to fill the tensor. If None, uses all zeros.\n"
         "unsafe: bool, default=false\n"
         "   Wether to omit barriers ensuring read after write ordering.");
+
+    //fill tensor command
+    nb::class_<hp::FillTensorCommand, hp::Command>(m, "FillTensorCommand",
+            "Command for filling a tensor with a repeated pattern of arbitrary size")
+        .def("__init__",
+            [](
+                hp::FillTensorCommand* cmd,
+                const hp::Tensor<std::byte>& tensor,
+                nb::bytes pattern,
+                std::optional<uint64_t> offset,
+                std::optional<uint64_t> size,
+                bool unsafe
+            ) {
+                hp::FillTensorCommand::Params params{};
+                if (offset) params.offset = *offset;
+                if (size) params.size = *size;
+                params.unsafe = unsafe;
+                std::span<const std::byte> data{
+                    static_cast<const std::byte*>(pattern.data()), pattern.size() };
+                new (cmd) hp::FillTensorCommand(tensor, data, params);
+            },
+            "tensor"_a,
+            "pattern"_a,
+            "offset"_a.none() = nb::none(),
+            "size"_a.none() = nb::none(),
+            "unsafe"_a = false,
+            "Creates a command for filling a tensor with a repeated pattern over a given "
+            "range. Defaults to filling the complete tensor");
+    m.def("fillTensor",
+        [](
+            const hp::Tensor<std::byte>& tensor,
+            nb::bytes pattern,
+            std::optional<uint64_t> offset,
+            std::optional<uint64_t> size,
+            bool unsafe
+        ) {
+            hp::FillTensorCommand::Params params{};
+            if (offset) params.offset = *offset;
+            if (size) params.size = *size;
+            params.unsafe = unsafe;
+            std::span<const std::byte> data{
+                static_cast<const std::byte*>(pattern.data()), pattern.size() };
+            return hp::fillTensor(tensor, data, params);
+        },
+        "tensor"_a,
+        "pattern"_a,
+        "offset"_a.none() = nb::none(),
+        "size"_a.none() = nb::none(),
+        "unsafe"_a = false,
+        "Creates a command for filling a tensor with a repeated pattern over a given range. "
+        "Defaults to filling the complete tensor"
+        "\n\nParameters\n----------\n"
+        "tensor: Tensor\n"
+        "    Tensor to be modified\n"
+        "pattern: bytes\n"
+        "    Pattern repeated to fill the tensor, e.g. a packed struct. "
+            "Size must be a multiple of 4.\n"
+        "offset: None|int, default=None\n"
+        "    Offset into the Tensor at which to start filling it. "
+            "Defaults to the start of the Tensor.\n"
+        "size: None|int, default=None\n"
+        "    Amount of bytes to fill. Must be a multiple of the pattern size. If None, "
+            "equals to the largest multiple fitting into the rest of the tensor\n"
+        "unsafe: bool, default=false\n"
+        "   Wether to omit barriers ensuring read after write ordering.");
+
+    m.def("isHostMemoryImportSupported",
+        []() { return hp::isHostMemoryImportSupported(getCurrentContext()); },
+        "Returns True, if the current context supports importing host memory, e.g. numpy "
+        "arrays, into buffers. Note that this may initialize the context.");
+    m.def("getDeviceNumaNode",
+        []() { return hp::getDeviceNumaNode(getCurrentContext()); },
+        "Returns the NUMA node the current device is attached to or -1 if unknown. "
+        "Note that this may initialize the context.");
+    m.def("getHostMemoryImportAlignment",
+        []() { return hp::getHostMemoryImportAlignment(getCurrentContext()); },
+        "Returns the alignment in bytes address and size of imported host memory must "
+        "adhere to. Zero if importing is not supported.");
+
+    m.def("setTensorPoolThreshold",
+        [](uint64_t threshold) { hp::setTensorPoolThreshold(getCurrentContext(), threshold); },
+        "threshold"_a,
+        "Enables sub-allocating tensors created afterwards, whose size in bytes does not "
+        "exceed the threshold, from shared buffers. Avoids hitting the driver's allocation "
+        "limit when creating many small tensors. Zero disables pooling, which is the default.");
+    m.def("getTensorPoolThreshold",
+        []() { return hp::getTensorPoolThreshold(getCurrentContext()); },
+        "Returns the maximum size in bytes of tensors sub-allocated from shared buffers. "
+        "Zero if pooling is disabled.");
+    m.def("setTensorAutoMapping",
+        [](bool enable) { hp::setTensorAutoMapping(getCurrentContext(), enable); },
+        "enable"_a,
+        "Enables mapping all tensors created afterwards if the device supports unified "
+        "memory, as mapped memory still resides on the device. Their content can then be "
+        "accessed directly via their memory address. Disabled by default.");
+    m.def("getTensorAutoMapping",
+        []() { return hp::getTensorAutoMapping(getCurrentContext()); },
+        "Returns True, if tensors are mapped automatically on devices with unified memory.");
+    m.def("setTensorLazyAllocation",
+        [](bool enable) { hp::setTensorLazyAllocation(getCurrentContext(), enable); },
+        "enable"_a,
+        "Enables deferring the allocation of tensors created afterwards until their first "
+        "use, e.g. being bound to a program or recorded into a command. Data passed on "
+        "creation is kept on the host until then. Disabled by default.");
+    m.def("getTensorLazyAllocation",
+        []() { return hp::getTensorLazyAllocation(getCurrentContext()); },
+        "Returns True, if tensors are allocated on their first use.");
+
+    nb::class_<hp::ScratchAllocator>(m, "ScratchAllocator",
+            "Allocator for scratch tensors sharing memory. Tensors are declared with the first "
+            "and last step of a sequence using them. Tensors whose lifetimes do not overlap "
+            "may occupy the same memory, reducing the peak memory usage. The content of "
+            "scratch tensors is undefined at the start of their lifetime.")
+        .def("__init__", [](hp::ScratchAllocator* a) {
+            new (a) hp::ScratchAllocator(getCurrentContext());
+        })
+        .def("__len__", &hp::ScratchAllocator::size)
+        .def("declare", &hp::ScratchAllocator::declare,
+            "size"_a, "firstStep"_a, "lastStep"_a,
+            "Declares a new scratch tensor of the given size in bytes used from firstStep "
+            "until lastStep including and returns its id.")
+        .def("allocate", &hp::ScratchAllocator::allocate,
+            "Allocates memory for all declared tensors. No tensors can be declared afterwards.")
+        .def_prop_ro("isAllocated", &hp::ScratchAllocator::isAllocated,
+            "True, if allocate() was called")
+        .def("get", &hp::ScratchAllocator::get, "id"_a, nb::rv_policy::reference_internal,
+            "Returns the scratch tensor with the given id. Only available after allocation.")
+        .def_prop_ro("size_bytes", &hp::ScratchAllocator::size_bytes,
+            "Size of the shared memory in bytes. Zero until allocated.")
+        .def_prop_ro("declared_bytes", &hp::ScratchAllocator::declared_bytes,
+            "Sum of sizes of all declared tensors in bytes, i.e. memory required "
+            "without aliasing.");
+
+    nb::class_<hp::UniformRing>(m, "UniformRing",
+            "Ring of small uniform blocks in persistently mapped memory for per dispatch "
+            "parameters. Each push writes the next block, which gets bound by subsequent "
+            "calls to bindParameter. Dispatches keep the block current at binding. Blocks "
+            "are reused after capacity pushes, thus the capacity must exceed the amount of "
+            "blocks used by pending work.")
+        .def("__init__", [](hp::UniformRing* r, uint64_t blockSize, uint32_t capacity) {
+            new (r) hp::UniformRing(getCurrentContext(), blockSize, capacity);
+        }, "blockSize"_a, "capacity"_a = 64,
+            "Creates a new ring of capacity blocks each blockSize bytes large.")
+        .def("push", [](hp::UniformRing& r, nb::bytes data) {
+            return r.push({ reinterpret_cast<const std::byte*>(data.c_str()), data.size() });
+        }, "data"_a, "Writes data into the next block, makes it the current one and "
+            "returns its index.")
+        .def_prop_ro("current", &hp::UniformRing::current,
+            "Index of the current block")
+        .def_prop_ro("capacity", &hp::UniformRing::capacity,
+            "Amount of blocks in the ring")
+        .def_prop_ro("blockSize", &hp::UniformRing::blockSize,
+            "Size of a single block in bytes")
+        .def_prop_ro("size_bytes", &hp::UniformRing::size_bytes,
+            "Size of the whole ring in bytes including padding between blocks")
+        .def("bindParameter", [](const hp::UniformRing& r, hp::Program& p, uint32_t b)
+            { r.bindParameter(p.getBinding(b)); }, "program"_a, "binding"_a,
+            "Binds the current block to the program at the given binding")
+        .def("bindParameter", [](const hp::UniformRing& r, hp::ParameterSet& p, uint32_t b)
+            { r.bindParameter(p.getBinding(b)); }, "set"_a, "binding"_a,
+            "Binds the current block to the parameter set at the given binding")
+        .def("bindParameter", [](const hp::UniformRing& r, hp::Program& p, std::string_view b)
+            { r.bindParameter(p.getBinding(b)); }, "program"_a, "binding"_a,
+            "Binds the current block to the program at the given binding")
+        .def("bindParameter", [](const hp::UniformRing& r, hp::ParameterSet& p, std::string_view b)
+            { r.bindParameter(p.getBinding(b)); }, "set"_a, "binding"_a,
+            "Binds the current block to the parameter set at the given binding");
+
+    nb::class_<hp::ArgumentBlock>(m, "ArgumentBlock",
+            "Builder for uniform blocks of tensor addresses and scalars used with "
+            "buffer_reference. Values are appended in order using the scalar block "
+            "layout, i.e. aligned to the size of their components, matching blocks "
+            "declared with layout(scalar). commit() uploads the block into the next "
+            "slot of a uniform ring bound by subsequent calls to bindParameter, thus "
+            "the block can be rebuilt while previous dispatches still use theirs. "
+            "Appended tensors are kept alive as long as the block."
+            "\n\nParameters\n----------\n"
+            "blockSize: int\n"
+            "    Maximum size of a block in bytes\n"
+            "capacity: int, default=64\n"
+            "    Amount of blocks in the ring. Must exceed the amount of blocks used "
+            "by pending work.\n")
+        .def("__init__", [](hp::ArgumentBlock* b, uint64_t blockSize, uint32_t capacity) {
+            new (b) hp::ArgumentBlock(getCurrentContext(), blockSize, capacity);
+        }, "blockSize"_a, "capacity"_a = 64)
+        .def("addAddress", [](hp::ArgumentBlock& b, const hp::Tensor<std::byte>& t) -> hp::ArgumentBlock&
+            { return b.add(t); }, "tensor"_a, nb::keep_alive<1, 2>(), nb::rv_policy::reference,
+            "Appends the device address of the given tensor")
+        .def("addAddress", [](hp::ArgumentBlock& b, const hp::TensorView& v) -> hp::ArgumentBlock&
+            { return b.add(v); }, "view"_a, nb::keep_alive<1, 2>(), nb::rv_policy::reference,
+            "Appends the device address of the start of the given view")
+        .def("addInt32", [](hp::ArgumentBlock& b, int32_t v) -> hp::ArgumentBlock&
+            { return b.add(v); }, "value"_a, nb::rv_policy::reference,
+            "Appends a signed 32 bit integer")
+        .def("addUint32", [](hp::ArgumentBlock& b, uint32_t v) -> hp::ArgumentBlock&
+            { return b.add(v); }, "value"_a, nb::rv_policy::reference,
+            "Appends an unsigned 32 bit integer")
+        .def("addInt64", [](hp::ArgumentBlock& b, int64_t v) -> hp::ArgumentBlock&
+            { return b.add(v); }, "value"_a, nb::rv_policy::reference,
+            "Appends a signed 64 bit integer")
+        .def("addUint64", [](hp::ArgumentBlock& b, uint64_t v) -> hp::ArgumentBlock&
+            { return b.add(v); }, "value"_a, nb::rv_policy::reference,
+            "Appends an unsigned 64 bit integer")
+        .def("addFloat32", [](hp::ArgumentBlock& b, float v) -> hp::ArgumentBlock&
+            { return b.add(v); }, "value"_a, nb::rv_policy::reference,
+            "Appends a 32 bit float")
+        .def("addFloat64", [](hp::ArgumentBlock& b, double v) -> hp::ArgumentBlock&
+            { return b.add(v); }, "value"_a, nb::rv_policy::reference,
+            "Appends a 64 bit float")
+        .def("addBytes", [](hp::ArgumentBlock& b, nb::bytes data, uint64_t alignment) -> hp::ArgumentBlock& {
+            return b.addBytes({ reinterpret_cast<const std::byte*>(data.c_str()), data.size() }, alignment);
+        }, "data"_a, "alignment"_a = 4, nb::rv_policy::reference,
+            "Appends raw data, e.g. a vector or ctypes structure, with the given "
+            "alignment in bytes")
+        .def_prop_ro("data", [](const hp::ArgumentBlock& b) {
+            auto data = b.data();
+            return nb::bytes(reinterpret_cast<const char*>(data.data()), data.size());
+        }, "Data appended since the last clear")
+        .def_prop_ro("size_bytes", &hp::ArgumentBlock::size_bytes,
+            "Size of the appended data in bytes")
+        .def("commit", &hp::ArgumentBlock::commit,
+            "Uploads the appended data into the next block and returns its index")
+        .def("clear", &hp::ArgumentBlock::clear,
+            "Removes all appended data. Does not affect committed blocks.")
+        .def("bindParameter", [](const hp::ArgumentBlock& a, hp::Program& p, uint32_t b)
+            { a.bindParameter(p.getBinding(b)); }, "program"_a, "binding"_a,
+            "Binds the last committed block to the program at the given binding")
+        .def("bindParameter", [](const hp::ArgumentBlock& a, hp::ParameterSet& p, uint32_t b)
+            { a.bindParameter(p.getBinding(b)); }, "set"_a, "binding"_a,
+            "Binds the last committed block to the parameter set at the given binding")
+        .def("bindParameter", [](const hp::ArgumentBlock& a, hp::Program& p, std::string_view b)
+            { a.bindParameter(p.getBinding(b)); }, "program"_a, "binding"_a,
+            "Binds the last committed block to the program at the given binding")
+        .def("bindParameter", [](const hp::ArgumentBlock& a, hp::ParameterSet& p, std::string_view b)
+            { a.bindParameter(p.getBinding(b)); }, "set"_a, "binding"_a,
+            "Binds the last committed block to the parameter set at the given binding");
+
+    nb::class_<hp::TensorView>(m, "TensorView",
+            "Sub-range of a tensor that can be bound to programs without copying it. "
+            "Dispatches using disjoint views of the same tensor do not wait on each other. "
+            "Views must be recreated if the tensor's memory changes, e.g. by growing.")
+        .def(nb::init<const hp::Tensor<std::byte>&, uint64_t, uint64_t>(),
+            "tensor"_a, "offset"_a = 0, "size"_a = hp::whole_size, nb::keep_alive<1, 2>(),
+            "Creates a view of the given tensor starting at offset with the given size in "
+            "bytes. The offset must be a multiple of minStorageBufferOffsetAlignment.")
+        .def_prop_ro("address", &hp::TensorView::address,
+            "The device address of the start of the view")
+        .def_prop_ro("offset", &hp::TensorView::offset,
+            "Offset of the view into the tensor in bytes")
+        .def_prop_ro("size_bytes", &hp::TensorView::size_bytes,
+            "Size of the view in bytes")
+        .def("bindParameter", [](const hp::TensorView& v, hp::Program& p, uint32_t b)
+            { v.bindParameter(p.getBinding(b)); }, "program"_a, "binding"_a,
+            "Binds the view to the program at the given binding")
+        .def("bindParameter", [](const hp::TensorView& v, hp::ParameterSet& p, uint32_t b)
+            { v.bindParameter(p.getBinding(b)); }, "set"_a, "binding"_a,
+            "Binds the view to the parameter set at the given binding")
+        .def("bindParameter", [](const hp::TensorView& v, hp::Program& p, std::string_view b)
+            { v.bindParameter(p.getBinding(b)); }, "program"_a, "binding"_a,
+            "Binds the view to the program at the given binding")
+        .def("bindParameter", [](const hp::TensorView& v, hp::ParameterSet& p, std::string_view b)
+            { v.bindParameter(p.getBinding(b)); }, "set"_a, "binding"_a,
+            "Binds the view to the parameter set at the given binding");
+
+    nb::class_<hp::GrowableTensor, hp::Tensor<std::byte>>(m, "GrowableTensor",
+            "Tensor growing its memory on demand by at least doubling its capacity and "
+            "copying the content on the device. Programs bound to it pick up the new "
+            "memory on their next dispatch. Shaders accessing it via its address should "
+            "read the current one from addressSlot. Growing waits for work on the main "
+            "queue. Recorded subroutines, sequence templates, task graphs, parameter "
+            "sets and dispatch lists referencing it must be recreated after growing.")
+        .def("__init__", [](hp::GrowableTensor* t, uint64_t size, uint64_t capacity) {
+            new (t) hp::GrowableTensor(getCurrentContext(), size, capacity);
+        }, "size"_a, "capacity"_a = 0, "Allocates a new growable tensor with the given "
+            "size and capacity in bytes. The capacity is at least the size.")
+        .def_prop_ro("address", [](const hp::GrowableTensor& t) { return t.address(); },
+            "The device address of this tensor. Changes when growing.")
+        .def_prop_ro("addressSlot", &hp::GrowableTensor::getAddressSlot,
+            nb::rv_policy::reference_internal,
+            "Tensor holding the current address as a single uint64")
+        .def_prop_ro("capacity", &hp::GrowableTensor::capacity,
+            "Size of the allocated memory in bytes")
+        .def_prop_ro("size_bytes", [](const hp::GrowableTensor& t) { return t.size_bytes(); },
+            "The size of the tensor in bytes.")
+        .def("reserve", &hp::GrowableTensor::reserve, "capacity"_a,
+            "Ensures the capacity is at least the given amount of bytes.")
+        .def("resize", &hp::GrowableTensor::resize, "size"_a,
+            "Changes the size of the tensor in bytes, growing its memory if needed. "
+            "Content beyond the old size is undefined.");
+
+    m.def("isSparseTensorSupported",
+        []() { return hp::isSparseTensorSupported(getCurrentContext()); },
+        "Returns True, if the current context supports sparse tensors. Note that this "
+        "may initialize the context.");
+    m.def("isSparseResidencySupported",
+        []() { return hp::isSparseResidencySupported(getCurrentContext()); },
+        "Returns True, if sparse tensors can be used while only partially committed. "
+        "Otherwise, they must be committed completely before use. Note that this may "
+        "initialize the context.");
+    nb::class_<hp::SparseTensor, hp::Tensor<std::byte>>(m, "SparseTensor",
+            "Tensor reserving a virtual address range, which gets backed by memory on "
+            "demand in pages. Not limited by the maximum size of a single allocation. "
+            "Storage buffer bindings are limited to the device's maxStorageBufferRange, "
+            "larger tensors must be accessed via their address.")
+        .def("__init__", [](hp::SparseTensor* t, uint64_t size) {
+            new (t) hp::SparseTensor(getCurrentContext(), size);
+        }, "size"_a, "Reserves a new sparse tensor of the given size in bytes without "
+            "committing any memory.")
+        .def_prop_ro("address", [](const hp::SparseTensor& t) { return t.address(); },
+            "The device address of this tensor.")
+        .def_prop_ro("size_bytes", [](const hp::SparseTensor& t) { return t.size_bytes(); },
+            "The size of the tensor in bytes.")
+        .def_prop_ro("pageSize", &hp::SparseTensor::getPageSize,
+            "Size in bytes of the pages memory is committed in")
+        .def_prop_ro("size_committed", &hp::SparseTensor::size_committed,
+            "Number of bytes currently backed by memory")
+        .def("isCommitted", &hp::SparseTensor::isCommitted,
+            "offset"_a = 0, "size"_a = hp::whole_size,
+            "Returns True, if the given range in bytes is completely backed by memory.")
+        .def("commit", &hp::SparseTensor::commit,
+            "offset"_a = 0, "size"_a = hp::whole_size,
+            "Backs the given range in bytes extended to whole pages with memory. The "
+            "content of newly committed pages is undefined.")
+        .def("decommit", &hp::SparseTensor::decommit,
+            "offset"_a = 0, "size"_a = hp::whole_size,
+            "Releases the memory of all pages completely contained in the given range "
+            "in bytes. Work using them must have finished.");
+
+    nb::class_<hp::DefragmentationResult>(m, "DefragmentationResult",
+            "Statistics of a defragmentation run")
+        .def_ro("bytesMoved", &hp::DefragmentationResult::bytesMoved,
+            "Number of bytes copied to new locations")
+        .def_ro("bytesFreed", &hp::DefragmentationResult::bytesFreed,
+            "Number of bytes of device memory released")
+        .def_ro("tensorsMoved", &hp::DefragmentationResult::tensorsMoved,
+            "Number of tensors moved to new locations")
+        .def_ro("blocksFreed", &hp::DefragmentationResult::blocksFreed,
+            "Number of device memory blocks released");
+    m.def("defragmentTensors",
+        [](std::optional<hp::RelocationCallback> callback) {
+            return hp::defragmentTensors(getCurrentContext(), callback.value_or(nullptr));
+        }, "callback"_a.none() = nb::none(),
+        "Compacts the memory occupied by tensors and releases empty device memory blocks. "
+        "Moved tensors keep their content, but their address and mapped memory change. "
+        "Sub-allocated tensors are never moved. No work using tensors may be pending. "
+        "Recorded subroutines, sequence templates, task graphs, parameter sets and "
+        "dispatch lists referencing moved tensors must be recreated.\n\n"
+        "Parameters\n"
+        "----------\n"
+        "callback: (int, int, int) -> None | None, default=None\n"
+        "   Called for each moved tensor with its old and new device address and size");
 }
@@ -0,0 +1,136 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/filesystem.h>
+#include <nanobind/stl/vector.h>
+
+#include <hephaistos/capture.hpp>
+#include "context.hpp"
+
+namespace hp = hephaistos;
+namespace nb = nanobind;
+using namespace nb::literals;
+
+namespace {
+
+std::span<const std::byte> asBytes(const nb::bytes& data) {
+    return { reinterpret_cast<const std::byte*>(data.c_str()), data.size() };
+}
+
+}
+
+void registerCaptureModule(nb::module_& m) {
+    nb::class_<hp::Capture>(m, "Capture",
+            "Self-contained recording of dispatches for benchmarking. Stores the "
+            "code and specialization of programs, the contents of tensors at the "
+            "time they were added and the structure of the dispatched work, so it "
+            "can be saved and replayed without the surrounding application. "
+            "Dispatches within a step run concurrently, while each step waits on "
+            "the previous one.")
+        .def(nb::init<>(), "Creates an empty capture")
+        .def("__init__",
+            [](hp::Capture* c, const std::filesystem::path& path) {
+                nb::gil_scoped_release release;
+                new (c) hp::Capture(path);
+            }, "path"_a, "Loads a capture from the given file")
+        .def("__init__",
+            [](hp::Capture* c, nb::bytes data) {
+                new (c) hp::Capture(asBytes(data));
+            }, "data"_a, "Loads a capture from serialized data")
+        .def("addProgram",
+            [](hp::Capture& c, nb::bytes code, nb::bytes specialization) {
+                return c.addProgram(
+                    std::span<const uint32_t>{
+                        reinterpret_cast<const uint32_t*>(code.c_str()),
+                        code.size() / 4
+                    }, asBytes(specialization));
+            }, "code"_a, "specialization"_a = nb::bytes(),
+            "Adds a program to the capture and returns its index."
+            "\n\nParameters\n----------\n"
+            "code: bytes\n"
+            "    SPIR-V code of the program\n"
+            "specialization: bytes, default=b''\n"
+            "    Data used for filling in specialization constants\n")
+        .def("addTensor",
+            [](hp::Capture& c, const hp::Tensor<std::byte>& tensor) {
+                nb::gil_scoped_release release;
+                return c.addTensor(tensor);
+            }, "tensor"_a,
+            "Adds a tensor to the capture and returns its index. Reads the "
+            "tensor's current contents and waits for it to finish.")
+        .def("addTensor",
+            [](hp::Capture& c, nb::bytes data) {
+                return c.addTensor(asBytes(data));
+            }, "data"_a,
+            "Adds a tensor with the given contents to the capture and returns its index.")
+        .def("dispatch",
+            [](hp::Capture& c, uint32_t program, std::vector<uint32_t> tensors,
+                nb::bytes push, uint32_t x, uint32_t y, uint32_t z) -> hp::Capture&
+            {
+                auto data = asBytes(push);
+                return c.dispatch({
+                    .program = program,
+                    .tensors = std::move(tensors),
+                    .push = { data.begin(), data.end() },
+                    .groupCountX = x,
+                    .groupCountY = y,
+                    .groupCountZ = z
+                });
+            }, "program"_a, "tensors"_a, "push"_a = nb::bytes(),
+            "x"_a = 1, "y"_a = 1, "z"_a = 1, nb::rv_policy::reference_internal,
+            "Records a dispatch in the current step."
+            "\n\nParameters\n----------\n"
+            "program: int\n"
+            "    Index of the dispatched program\n"
+            "tensors: list[int]\n"
+            "    Indices of the tensors bound to the program's bindings in order\n"
+            "push: bytes, default=b''\n"
+            "    Push data passed to the dispatch\n"
+            "x: int, default=1\n"
+            "    Amount of groups in X dimension\n"
+            "y: int, default=1\n"
+            "    Amount of groups in Y dimension\n"
+            "z: int, default=1\n"
+            "    Amount of groups in Z dimension\n")
+        .def("nextStep", &hp::Capture::nextStep, nb::rv_policy::reference_internal,
+            "Starts a new step waiting on all dispatches recorded before")
+        .def_prop_ro("programCount", &hp::Capture::getProgramCount,
+            "Amount of programs")
+        .def_prop_ro("tensorCount", &hp::Capture::getTensorCount,
+            "Amount of tensors")
+        .def_prop_ro("stepCount",
+            [](const hp::Capture& c) { return c.getSteps().size(); },
+            "Amount of steps")
+        .def("serialize",
+            [](const hp::Capture& c) {
+                auto data = c.serialize();
+                return nb::bytes(reinterpret_cast<const char*>(data.data()), data.size());
+            }, "Serializes the capture")
+        .def("save",
+            [](const hp::Capture& c, const std::filesystem::path& path) {
+                nb::gil_scoped_release release;
+                c.save(path);
+            }, "path"_a, "Saves the capture to the given file");
+
+    m.def("replayCapture",
+        [](const hp::Capture& capture, uint32_t warmup, uint32_t iterations, bool resetTensors) {
+            nb::gil_scoped_release release;
+            return hp::replayCapture(getCurrentContext(), capture, {
+                .warmup = warmup,
+                .iterations = iterations,
+                .resetTensors = resetTensors
+            });
+        }, "capture"_a, nb::kw_only(), "warmup"_a = 1, "iterations"_a = 10,
+        "resetTensors"_a = true,
+        "Replays the capture on the current device and returns the duration of "
+        "each timed run in nanoseconds, measured from the start of the first to "
+        "the end of the last step."
+        "\n\nParameters\n----------\n"
+        "capture: Capture\n"
+        "    Capture to replay\n"
+        "warmup: int, default=1\n"
+        "    Amount of untimed runs\n"
+        "iterations: int, default=10\n"
+        "    Amount of timed runs\n"
+        "resetTensors: bool, default=True\n"
+        "    Restore the captured tensor contents before each run. Restoring is "
+        "not measured.\n");
+}
@@ -1,9 +1,15 @@
 #include <nanobind/nanobind.h>
+#include <nanobind/stl/optional.h>
 #include <nanobind/stl/string.h>
+#include <nanobind/stl/vector.h>
 
+#include <functional>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <type_traits>
 #include <variant>
+#include <vector>
 
 #include <hephaistos/command.hpp>
 #include "context.hpp"
@@ -12,6 +18,66 @@ namespace hp = hephaistos;
 namespace nb = nanobind;
 using namespace nb::literals;
 
+namespace {
+
+//Wraps a Python callable so it can be called from the completion thread
+std::function<void()> wrapCallback(nb::callable callable) {
+    //the callable may only be released while holding the GIL
+    auto deleter = [](nb::callable* c) {
+        nb::gil_scoped_acquire acquire;
+        delete c;
+    };
+    std::shared_ptr<nb::callable> holder(new nb::callable(std::move(callable)), deleter);
+    return [holder]() {
+        nb::gil_scoped_acquire acquire;
+        try {
+            (*holder)();
+        }
+        catch (nb::python_error& e) {
+            e.discard_as_unraisable("callback");
+        }
+    };
+}
+
+//Creates an asyncio future on the running event loop, which resolves once
+//the completion service calls the callback passed to subscribe
+nb::object createFuture(const std::function<void(std::function<void()>)>& subscribe) {
+    auto loop = nb::module_::import_("asyncio").attr("get_running_loop")();
+    auto future = loop.attr("create_future")();
+    //futures may only be resolved on the loop's thread and might have been
+    //cancelled in the meantime
+    nb::object resolve = nb::cpp_function([future]() {
+        if (!nb::cast<bool>(future.attr("done")()))
+            future.attr("set_result")(nb::none());
+    });
+    nb::object notify = loop.attr("call_soon_threadsafe");
+    subscribe(wrapCallback(nb::borrow<nb::callable>(nb::cpp_function([notify, resolve]() {
+        notify(resolve);
+    }))));
+    return future;
+}
+
+//Collects submissions or (timeline, value) tuples
+std::vector<hp::TimelineValue> toTimelineValues(nb::list list) {
+    std::vector<hp::TimelineValue> values;
+    values.reserve(list.size());
+    for (nb::handle h : list) {
+        if (nb::isinstance<hp::Submission>(h)) {
+            auto& s = nb::cast<const hp::Submission&>(h);
+            values.push_back({ s.getTimeline(), s.getFinalStep() });
+        }
+        else {
+            auto t = nb::cast<nb::tuple>(h);
+            if (t.size() != 2)
+                throw nb::value_error("Expected either Submission or (Timeline, value) tuple!");
+            values.push_back({ nb::cast<const hp::Timeline&>(t[0]), nb::cast<uint64_t>(t[1]) });
+        }
+    }
+    return values;
+}
+
+}
+
 void registerCommandModule(nb::module_& m) {
     nb::class_<hp::Command>(m, "Command",
         "Base class for commands running on the device. "
@@ -24,9 +90,17 @@ void registerCommandModule(nb::module_& m) {
             "and may be amortized by reusing sequences via Subroutines.")
         .def_prop_ro("simultaneousUse",
             [](const hp::Subroutine& s) -> bool { return s.simultaneousUse(); },
-            "True, if the subroutine can be used simultaneous");
-    m.def("createSubroutine",
-        [](nb::list list, bool simultaneous) -> hp::Subroutine {
+            "True, if the subroutine can be used simultaneous")
+        .def_prop_ro("nestable",
+            [](const hp::Subroutine& s) -> bool { return s.nestable(); },
+            "True, if the subroutine only consists of parts and can thus be nested "
+            "inside other subroutines");
+    nb::class_<hp::SubroutinePart>(m, "SubroutinePart",
+        "Part of a subroutine recorded independently of others. "
+        "Multiple parts can be recorded in parallel on different threads and "
+        "then assembled into subroutines without re-recording them.");
+    m.def("createSubroutinePart",
+        [](nb::list list, bool trackHazards) -> hp::SubroutinePart {
             //try to minimize holding of GIL
             // -> collect commands before recording
             std::vector<const hp::Command*> commands(list.size());
@@ -34,22 +108,69 @@ void registerCommandModule(nb::module_& m) {
             for (nb::handle h : list)
                 commands[i++] = nb::cast<const hp::Command*>(h);
 
+            //release GIL -> allows recording parts on multiple threads
+            nb::gil_scoped_release release;
+            hp::SubroutinePartBuilder builder(getCurrentContext());
+            if (trackHazards)
+                builder.trackHazards();
+            for (auto c : commands)
+                builder.addCommand(*c);
+            return builder.finish();
+        }, "commands"_a, "trackHazards"_a = false,
+        "creates a subroutine part from the list of commands"
+        "\n\nParameters\n----------\n"
+        "commands: Command[]\n"
+        "    Sequence of commands the part consists of\n"
+        "trackHazards: bool, default=False\n"
+        "    True, if barriers should only be recorded between commands actually\n"
+        "    depending on each other.");
+    m.def("createSubroutine",
+        [](nb::list list, bool simultaneous, bool trackHazards) -> hp::Subroutine {
+            //try to minimize holding of GIL
+            // -> collect commands before recording
+            using Item = std::variant<const hp::Command*, const hp::SubroutinePart*, const hp::Subroutine*>;
+            std::vector<Item> items(list.size());
+            auto i = 0u;
+            for (nb::handle h : list) {
+                if (nb::isinstance<hp::SubroutinePart>(h))
+                    items[i++] = nb::cast<const hp::SubroutinePart*>(h);
+                else if (nb::isinstance<hp::Subroutine>(h))
+                    items[i++] = nb::cast<const hp::Subroutine*>(h);
+                else
+                    items[i++] = nb::cast<const hp::Command*>(h);
+            }
+
             //release GIL
             nb::gil_scoped_release release;
             //build subroutine
             hp::SubroutineBuilder builder(getCurrentContext(), simultaneous);
-            for (auto c : commands)
-                builder.addCommand(*c);
+            if (trackHazards)
+                builder.trackHazards();
+            for (auto& item : items) {
+                std::visit([&builder](auto p) {
+                    using T = std::remove_cvref_t<decltype(*p)>;
+                    if constexpr (std::is_same_v<T, hp::SubroutinePart>)
+                        builder.addPart(*p);
+                    else if constexpr (std::is_same_v<T, hp::Subroutine>)
+                        builder.addSubroutine(*p);
+                    else
+                        builder.addCommand(*p);
+                }, item);
+            }
             return builder.finish();
-        }, "commands"_a, "simultaneous"_a = false,
+        }, "commands"_a, "simultaneous"_a = false, "trackHazards"_a = false,
         "creates a subroutine from the list of commands"
         "\n\nParameters\n----------\n"
-        "commands: Command[]\n"
-        "    Sequence of commands the Subroutine consists of\n"
+        "commands: (Command | SubroutinePart | Subroutine)[]\n"
+        "    Sequence of commands the Subroutine consists of. Parts and nestable\n"
+        "    subroutines are included without re-recording them.\n"
         "simultaneous: bool, default=False\n"
         "    True, if the subroutine can be submitted while a previous submission\n"
         "    has not yet finished. Disobeying this requirement results in undefined\n"
-        "    behavior.");
+        "    behavior.\n"
+        "trackHazards: bool, default=False\n"
+        "    True, if barriers should only be recorded between commands actually\n"
+        "    depending on each other.");
 
     nb::class_<hp::Timeline>(m, "Timeline",
             "Timeline managing the execution of code and commands using an "
@@ -89,6 +210,29 @@ void registerCommandModule(nb::module_& m) {
             "timeout: int\n"
             "    Time in nanoseconds to wait. May be rounded to the closest "
                 "internal precision of the device clock.")
+        .def("onValue", [](const hp::Timeline& t, uint64_t v, nb::callable c) {
+                t.onValue(v, wrapCallback(std::move(c)));
+            }, "value"_a, "callback"_a,
+            "Registers a callback to run once the timeline reaches the given value. "
+            "Callbacks run on a background thread and should return quickly. "
+            "Raised exceptions are reported as unraisable. Callbacks still pending "
+            "when the timeline gets destroyed are dropped."
+            "\n\nParameters\n----------\n"
+            "value: int\n"
+            "    Value the timeline has to reach\n"
+            "callback: Callable[[], None]\n"
+            "    Function to call once the value is reached\n")
+        .def("waitAsync", [](const hp::Timeline& t, uint64_t v) {
+                return createFuture([&t, v](std::function<void()> done) {
+                    t.onValue(v, std::move(done));
+                });
+            }, "value"_a,
+            "Returns an asyncio future resolving once the timeline reaches the given "
+            "value. Must be called from within a running event loop. Does not block "
+            "the loop or need an extra thread."
+            "\n\nParameters\n----------\n"
+            "value: int\n"
+            "    Value the timeline has to reach\n")
         .def("__repr__", [](const hp::Timeline& t) -> std::string {
             std::ostringstream str;
             str << "Timeline (ID: 0x" << std::hex << t.getId() << ")\n";
@@ -103,7 +247,8 @@ void registerCommandModule(nb::module_& m) {
         .def_prop_ro("finalStep", [](const hp::Submission& s) { return s.getFinalStep(); },
             "The value the timeline will reach when the submission finishes.")
         .def_prop_ro("forgettable", [](const hp::Submission& s){ return s.forgettable(); },
-            "True, if the Submission can be discarded safely, i.e. fire and forget.")
+            "True, if the Submission does not manage any internal resources. "
+            "Either way, it can be discarded without waiting, i.e. fire and forget.")
         .def("wait", [](const hp::Submission& s) {
                 nb::gil_scoped_release release;
                 s.wait();
@@ -113,7 +258,56 @@ void registerCommandModule(nb::module_& m) {
                 return s.wait(t);
             }, "ns"_a,
             "Blocks the caller until the submission finished or the specified time elapsed. "
-            "Returns True in the first, False in the second case.");
+            "Returns True in the first, False in the second case.")
+        .def("onFinished", [](const hp::Submission& s, nb::callable c) {
+                s.onFinished(wrapCallback(std::move(c)));
+            }, "callback"_a,
+            "Registers a callback to run once the submission finished. "
+            "See Timeline.onValue for details.")
+        .def("waitAsync", [](const hp::Submission& s) {
+                return createFuture([&s](std::function<void()> done) {
+                    s.onFinished(std::move(done));
+                });
+            },
+            "Returns an asyncio future resolving once the submission finished. "
+            "Must be called from within a running event loop. "
+            "See Timeline.waitAsync for details.");
+
+    nb::class_<hp::WaitGraphValue>(m, "WaitGraphValue",
+            "Value of a timeline a step in a wait graph waits on or signals")
+        .def_ro("timeline", &hp::WaitGraphValue::timeline, "Id of the timeline")
+        .def_ro("value", &hp::WaitGraphValue::value, "Value waited on or signaled");
+    nb::class_<hp::WaitGraphStep>(m, "WaitGraphStep",
+            "Single step in a wait graph, i.e. one submission to a queue")
+        .def_ro("queue", &hp::WaitGraphStep::queue, "Queue the step runs on")
+        .def_ro("commandBufferCount", &hp::WaitGraphStep::commandBufferCount,
+            "Number of command buffers and subroutines submitted")
+        .def_ro("waits", &hp::WaitGraphStep::waits,
+            "Timeline values the step waits on before it starts")
+        .def_ro("signal", &hp::WaitGraphStep::signal,
+            "Timeline value signaled once the step finished");
+    nb::class_<hp::WaitGraph>(m, "WaitGraph",
+            "Structured representation of the steps recorded by a SequenceBuilder")
+        .def_ro("steps", &hp::WaitGraph::steps, "Steps in submission order")
+        .def("toDot", [](const hp::WaitGraph& g) { return hp::printDot(g); },
+            "Creates a representation of the wait graph in the DOT language.")
+        .def("toJson", [](const hp::WaitGraph& g) { return hp::printJson(g); },
+            "Creates a JSON representation of the wait graph.")
+        .def("analyze", [](const hp::WaitGraph& g, const std::vector<double>& d) {
+                return hp::analyzeWaitGraph(g, d);
+            }, "durations"_a,
+            "Estimates the timing of the wait graph from the steps' durations in nanoseconds, "
+            "e.g. measured using a StopWatch, including critical path and idle gaps.");
+    nb::class_<hp::WaitGraphTiming>(m, "WaitGraphTiming",
+            "Estimated timing of a wait graph's steps in nanoseconds relative to the start of the earliest step")
+        .def_ro("start", &hp::WaitGraphTiming::start, "Estimated start time per step")
+        .def_ro("finish", &hp::WaitGraphTiming::finish, "Estimated finish time per step")
+        .def_ro("idle", &hp::WaitGraphTiming::idle,
+            "Time the step's queue idled right before the step started")
+        .def_ro("criticalPath", &hp::WaitGraphTiming::criticalPath,
+            "Indices of the steps on the critical path in execution order")
+        .def_ro("duration", &hp::WaitGraphTiming::duration,
+            "Estimated total time until all steps finished");
 
     nb::class_<hp::SequenceBuilder>(m, "SequenceBuilder",
             "Builder class for recording a sequence of commands and subroutines "
@@ -193,6 +387,16 @@ void registerCommandModule(nb::module_& m) {
                 return sb.Then(s);
             }, "subroutine"_a, nb::rv_policy::reference_internal,
             "Issues a new step to execute after waiting for the previous one to finish.")
+        .def("ThenHost", [](hp::SequenceBuilder& sb, nb::callable c) -> hp::SequenceBuilder& {
+                return sb.ThenHost(wrapCallback(std::move(c)));
+            }, "callback"_a, nb::rv_policy::reference_internal,
+            "Issues a step running the callback on a background thread once the "
+            "previous steps finished. Following steps wait for it to return, "
+            "while the whole sequence is still submitted at once. Raised exceptions "
+            "are reported as unraisable and do not stop the sequence."
+            "\n\nParameters\n----------\n"
+            "callback: Callable[[], None]\n"
+            "    Function to run on the host\n")
         .def("NextStep", [](hp::SequenceBuilder& sb) -> hp::SequenceBuilder& {
                 nb::gil_scoped_release release;
                 return sb.NextStep();
@@ -208,17 +412,91 @@ void registerCommandModule(nb::module_& m) {
                 return sb.WaitFor(t, v);
             }, "timeline"_a, "value"_a, nb::rv_policy::reference_internal,
             "Issues the following steps to wait for the given timeline to reach the given value")
+        .def("OnQueue", [](hp::SequenceBuilder& sb, hp::QueueType q) -> hp::SequenceBuilder& {
+                nb::gil_scoped_release release;
+                return sb.OnQueue(q);
+            }, "queue"_a, nb::rv_policy::reference_internal,
+            "Runs the current step, or a new one if it already contains work, and all following steps on the given queue.")
+        .def("TrackHazards", [](hp::SequenceBuilder& sb) -> hp::SequenceBuilder& {
+                return sb.TrackHazards();
+            }, nb::rv_policy::reference_internal,
+            "Only records barriers between commands within a step actually depending on each other. "
+            "Should be called before any command is recorded.")
         .def("printWaitGraph", [](const hp::SequenceBuilder& sb) { return sb.printWaitGraph(); },
             "Returns a visualization of the current wait graph in the form: "
             "(Timeline.ID(WaitValue))* -> (submissions) -> (Timeline.ID(SignalValue)). "
             "Must be called before Submit().")
+        .def("getWaitGraph", [](const hp::SequenceBuilder& sb) { return sb.getWaitGraph(); },
+            "Returns the structured wait graph of the recorded steps. Must be called before Submit().")
         .def("Submit", &hp::SequenceBuilder::Submit,
-            "Submits the recorded steps as a single batch to the GPU.");
+            "Submits the recorded steps as a single batch to the GPU. Blocks while "
+            "the submission limit of the context is reached.",
+            nb::call_guard<nb::gil_scoped_release>())
+        .def("TrySubmit", &hp::SequenceBuilder::TrySubmit,
+            "Submits the recorded steps like Submit(), unless the submission limit "
+            "of the context is reached. Returns None without submitting in that case.")
+        .def("Freeze", &hp::SequenceBuilder::Freeze,
+            "Finishes recording and returns a SequenceTemplate, which can be submitted multiple times. "
+            "Only available for sequences started with beginSequenceTemplate().");
+
+    nb::class_<hp::SequenceTemplate>(m, "SequenceTemplate",
+            "Recorded sequence of commands and subroutines, which can be submitted "
+            "multiple times. Each submission shifts the values of its timeline, "
+            "e.g. a sequence waiting on 2 and finishing at 5 runs from 5 to 8 "
+            "when submitted a second time. Waits on other timelines stay as they are.")
+        .def_prop_ro("timeline", [](const hp::SequenceTemplate& t) -> const hp::Timeline& { return t.getTimeline(); },
+            "The timeline used to orchestrate the steps.")
+        .def_prop_ro("nextStartValue", [](const hp::SequenceTemplate& t) { return t.getNextStartValue(); },
+            "The value the next submission waits on by default, i.e. the final step of the previous one.")
+        .def("Submit", [](hp::SequenceTemplate& t) {
+                nb::gil_scoped_release release;
+                return t.Submit();
+            }, nb::keep_alive<0, 1>(),
+            "Submits the recorded steps continuing where the previous submission ended.")
+        .def("Submit", [](hp::SequenceTemplate& t, uint64_t v) {
+                nb::gil_scoped_release release;
+                return t.Submit(v);
+            }, "startValue"_a, nb::keep_alive<0, 1>(),
+            "Submits the recorded steps with the first one waiting on the given value. "
+            "Must not be lower than the final step of the previous submission.");
+
+    nb::class_<hp::TaskGraph>(m, "TaskGraph",
+            "Graph of tasks and their dependencies, which can be submitted multiple times. "
+            "Independent tasks on the same queue share a step, tasks on different queues may "
+            "run concurrently and only waits not implied by others are issued. Each submission "
+            "starts after the previous one finished.")
+        .def("__init__", [](hp::TaskGraph* g) { new (g) hp::TaskGraph(getCurrentContext()); })
+        .def("__len__", &hp::TaskGraph::size)
+        .def("addTask", [](hp::TaskGraph& g, const hp::Command& c, hp::QueueType q) {
+                nb::gil_scoped_release release;
+                return g.addTask(c, q);
+            }, "cmd"_a, "queue"_a = hp::QueueType::MAIN, nb::keep_alive<1, 2>(),
+            "Adds a task running the given command on the given queue and returns its index.")
+        .def("addTask", [](hp::TaskGraph& g, const hp::Subroutine& s, hp::QueueType q) {
+                return g.addTask(s, q);
+            }, "subroutine"_a, "queue"_a = hp::QueueType::MAIN, nb::keep_alive<1, 2>(),
+            "Adds a task running the given subroutine on the given queue and returns its index. "
+            "The subroutine must have been created for simultaneous use.")
+        .def("addDependency", &hp::TaskGraph::addDependency, "before"_a, "after"_a,
+            "Declares the task after to not start before the task before finished.")
+        .def("getWaitGraph", &hp::TaskGraph::getWaitGraph,
+            "Returns the structured wait graph of the next submission. Finalizes the graph.")
+        .def("Submit", [](hp::TaskGraph& g) {
+                nb::gil_scoped_release release;
+                return g.Submit();
+            }, nb::keep_alive<0, 1>(),
+            "Submits the graph. The first call finalizes it, after which no tasks and "
+            "dependencies can be added anymore.");
     
     m.def("beginSequence", [](hp::Timeline& t, uint64_t v) { return hp::beginSequence(t, v); },
         "timeline"_a, "startValue"_a = 0, "Starts a new sequence.", nb::rv_policy::move);
     m.def("beginSequence", []() { return hp::beginSequence(getCurrentContext()); },
         "Starts a new sequence.", nb::rv_policy::move);
+    m.def("beginSequenceTemplate", [](hp::Timeline& t, uint64_t v) { return hp::beginSequenceTemplate(t, v); },
+        "timeline"_a, "startValue"_a = 0, "Starts a new sequence, which can be frozen into a SequenceTemplate.",
+        nb::rv_policy::move);
+    m.def("beginSequenceTemplate", []() { return hp::beginSequenceTemplate(getCurrentContext()); },
+        "Starts a new sequence, which can be frozen into a SequenceTemplate.", nb::rv_policy::move);
     
     m.def("execute", [](const hp::Command& cmd) { hp::execute(getCurrentContext(), cmd); },
         nb::call_guard<nb::gil_scoped_release>(),
@@ -243,4 +521,88 @@ void registerCommandModule(nb::module_& m) {
                 }
             });
         }, "list"_a, "Runs the given of list commands synchronous");
+
+    m.def("executeAsync", [](const hp::Command& cmd) { return hp::executeAsync(getCurrentContext(), cmd); },
+        nb::call_guard<nb::gil_scoped_release>(),
+        "cmd"_a, "Runs the given command asynchronous and returns a Submission to wait on.");
+    m.def("executeAsync", [](const hp::Subroutine& sub) { return hp::executeAsync(getCurrentContext(), sub); },
+        nb::call_guard<nb::gil_scoped_release>(), nb::keep_alive<0, 1>(),
+        "sub"_a, "Runs the given subroutine asynchronous and returns a Submission to wait on.");
+    m.def("executeListAsync", [](nb::list list)
+        {
+            //minimize time with GIL -> collect commands
+            std::vector<const hp::Command*> commands(list.size());
+            auto i = 0u;
+            for (nb::handle h : list)
+                commands[i++] = nb::cast<const hp::Command*>(h);
+            
+            //release GIL
+            nb::gil_scoped_release release;
+            //record commands
+            return hp::executeAsync(getCurrentContext(), [&commands](hp::vulkan::Command& cmd) {
+                for (auto c : commands) {
+                    c->record(cmd);
+                }
+            });
+        }, "list"_a, "Runs the given list of commands asynchronous and returns a Submission to wait on.");
+
+    m.def("setSubmissionLimit", [](uint32_t limit) {
+            hp::setSubmissionLimit(getCurrentContext(), limit);
+        }, "limit"_a,
+        "Limits the amount of submissions in flight on the current context. Once "
+        "reached, submitting further work blocks until enough previous work finished. "
+        "Zero disables the limit. Note that this may initialize the context.");
+    m.def("getSubmissionLimit", []() {
+            return hp::getSubmissionLimit(getCurrentContext());
+        },
+        "Returns the limit of submissions in flight on the current context; zero if "
+        "unlimited. Note that this may initialize the context.");
+    m.def("getSubmissionsInFlight", []() {
+            return hp::getSubmissionsInFlight(getCurrentContext());
+        },
+        "Returns the amount of submissions counting towards the limit that have not "
+        "finished yet. Note that this may initialize the context.");
+
+    m.def("submitBatch", [](nb::list list) {
+            //take over the builders; they are finished afterwards either way
+            std::vector<hp::SequenceBuilder> sequences;
+            sequences.reserve(list.size());
+            for (nb::handle h : list)
+                sequences.push_back(std::move(nb::cast<hp::SequenceBuilder&>(h)));
+
+            nb::gil_scoped_release release;
+            return hp::submitBatch(sequences);
+        }, "list"_a,
+        "Submits the recorded steps of all given sequences at once, merging them into a "
+        "single batch per queue. Returns a Submission per sequence in the given order. "
+        "All sequences must have been created on the same context.");
+
+            auto values = toTimelineValues(list);
+            nb::gil_scoped_release release;
+            hp::waitAll(values);
+        }, "list"_a,
+        "Blocks the caller until all given submissions or (Timeline, value) tuples finished. "
+        "All of them must have been created on the same context.");
+    m.def("waitAllTimeout", [](nb::list list, uint64_t t) -> bool {
+            auto values = toTimelineValues(list);
+            nb::gil_scoped_release release;
+            return hp::waitAll(values, t);
+        }, "list"_a, "ns"_a,
+        "Blocks the caller until all given submissions or (Timeline, value) tuples finished "
+        "or the specified time elapsed. Returns True in the first, False in the second case.");
+    m.def("waitAny", [](nb::list list) -> size_t {
+            auto values = toTimelineValues(list);
+            nb::gil_scoped_release release;
+            return hp::waitAny(values);
+        }, "list"_a,
+        "Blocks the caller until any of the given submissions or (Timeline, value) tuples "
+        "finished and returns its index. All of them must have been created on the same context.");
+    m.def("waitAnyTimeout", [](nb::list list, uint64_t t) -> std::optional<size_t> {
+            auto values = toTimelineValues(list);
+            nb::gil_scoped_release release;
+            return hp::waitAny(values, t);
+        }, "list"_a, "ns"_a,
+        "Blocks the caller until any of the given submissions or (Timeline, value) tuples "
+        "finished or the specified time elapsed. Returns the index of the finished one "
+        "in the first, None in the second case.");
 }
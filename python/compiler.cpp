@@ -1,11 +1,16 @@
 #include <nanobind/nanobind.h>
 #include <nanobind/stl/bind_map.h>
 #include <nanobind/stl/filesystem.h>
+#include <nanobind/stl/optional.h>
+#include <nanobind/stl/pair.h>
 #include <nanobind/stl/string.h>
 #include <nanobind/stl/string_view.h>
+#include <nanobind/stl/vector.h>
 
 #include <hephaistos/compiler.hpp>
 
+#include "context.hpp"
+
 namespace hp = hephaistos;
 namespace nb = nanobind;
 using namespace nb::literals;
@@ -15,6 +20,99 @@ void registerCompilerModule(nb::module_& m) {
         "Dict mapping filepaths to shader source code. "
         "Consumed by Compiler to resolve include directives.");
 
+    nb::enum_<hp::CompileTarget>(m, "CompileTarget",
+            "Target environment code gets compiled for")
+        .value("VULKAN_1_2", hp::CompileTarget::VULKAN_1_2,
+            "Vulkan 1.2 using SPIR-V 1.4")
+        .value("VULKAN_1_2_SPIRV_1_5", hp::CompileTarget::VULKAN_1_2_SPIRV_1_5,
+            "Vulkan 1.2 using SPIR-V 1.5")
+        .value("VULKAN_1_3", hp::CompileTarget::VULKAN_1_3,
+            "Vulkan 1.3 using SPIR-V 1.6. Programs can not be created from it, "
+            "since contexts currently target Vulkan 1.2.");
+    nb::enum_<hp::ShaderStage>(m, "ShaderStage",
+            "Shader stage code gets compiled for")
+        .value("COMPUTE", hp::ShaderStage::COMPUTE,
+            "Compute shader used by Program")
+        .value("RAYGEN", hp::ShaderStage::RAYGEN,
+            "Ray generation shader used by RayTracingProgram")
+        .value("MISS", hp::ShaderStage::MISS,
+            "Miss shader used by RayTracingProgram")
+        .value("CLOSEST_HIT", hp::ShaderStage::CLOSEST_HIT,
+            "Closest hit shader used by RayTracingProgram")
+        .value("ANY_HIT", hp::ShaderStage::ANY_HIT,
+            "Any hit shader used by RayTracingProgram")
+        .value("INTERSECTION", hp::ShaderStage::INTERSECTION,
+            "Intersection shader used by RayTracingProgram");
+    nb::enum_<hp::DenormMode>(m, "DenormMode",
+            "Handling of denormalized floats in compiled code")
+        .value("DEFAULT", hp::DenormMode::DEFAULT,
+            "Leaves the handling to the device")
+        .value("PRESERVE", hp::DenormMode::PRESERVE,
+            "Denormalized floats are preserved. Requires support by the device.")
+        .value("FLUSH_TO_ZERO", hp::DenormMode::FLUSH_TO_ZERO,
+            "Denormalized floats are flushed to zero. Requires support by the device.");
+    nb::class_<hp::CompileOptions>(m, "CompileOptions",
+            "Options controlling the compilation of shader code")
+        .def("__init__", [](hp::CompileOptions* o,
+            hp::CompileTarget target,
+            std::vector<std::pair<std::string, std::string>> defines,
+            bool stripDebugInfo,
+            hp::ShaderStage stage,
+            hp::DenormMode denormMode,
+            bool relaxedPrecision,
+            bool fastMath,
+            bool vulkanMemoryModel
+        ) {
+            new (o) hp::CompileOptions{ target, std::move(defines), stripDebugInfo, stage,
+                denormMode, relaxedPrecision, fastMath, vulkanMemoryModel };
+        }, "target"_a = hp::CompileTarget::VULKAN_1_2,
+            "defines"_a = std::vector<std::pair<std::string, std::string>>{},
+            "stripDebugInfo"_a = false,
+            "stage"_a = hp::ShaderStage::COMPUTE,
+            "denormMode"_a = hp::DenormMode::DEFAULT,
+            "relaxedPrecision"_a = false,
+            "fastMath"_a = false,
+            "vulkanMemoryModel"_a = false)
+        .def_rw("target", &hp::CompileOptions::target,
+            "Target environment to compile for")
+        .def_rw("defines", &hp::CompileOptions::defines,
+            "Macros defined before the source code as list of (name, value)")
+        .def_rw("stripDebugInfo", &hp::CompileOptions::stripDebugInfo,
+            "If True, removes debug information like names from the code. "
+            "Parameters can then only be bound by their binding number.")
+        .def_rw("stage", &hp::CompileOptions::stage,
+            "Shader stage to compile for")
+        .def_rw("denormMode", &hp::CompileOptions::denormMode,
+            "Handling of denormalized floats")
+        .def_rw("relaxedPrecision", &hp::CompileOptions::relaxedPrecision,
+            "If True, 32 bit float operations may be computed with lower precision "
+            "like mediump does.")
+        .def_rw("fastMath", &hp::CompileOptions::fastMath,
+            "If True, allows the device to assume there are neither NaNs, infinities "
+            "nor signed zeros and to contract and reassociate float operations. "
+            "Requires support by the device, see getFloatControlsProperties().")
+        .def_rw("vulkanMemoryModel", &hp::CompileOptions::vulkanMemoryModel,
+            "If True, compiles for the Vulkan memory model and enables "
+            "GL_KHR_memory_scope_semantics, i.e. scoped atomics and barriers with "
+            "explicit acquire/release semantics. Requires support by the device, "
+            "see getMemoryModelFeatures().");
+
+    nb::class_<hp::PendingProgram>(m, "PendingProgram",
+            "Handle to a program built in the background. Can be polled or "
+            "waited on until the program is ready.")
+        .def("isReady", &hp::PendingProgram::isReady,
+            "Checks wether the program finished building")
+        .def("wait", [](const hp::PendingProgram& p) {
+                nb::gil_scoped_release release;
+                p.wait();
+            }, "Blocks until the program finished building")
+        .def("get", [](hp::PendingProgram& p) {
+                nb::gil_scoped_release release;
+                return p.get();
+            },
+            "Returns the built program. Blocks until the program finished building "
+            "and raises errors occurred during building. Can only be called once.");
+
     nb::class_<hp::Compiler>(m, "Compiler",
             "Compiler for generating SPIR-V byte code used by Programs from "
             "shader code written in GLSL. Has additional methods to handle "
@@ -27,6 +125,20 @@ void registerCompilerModule(nb::module_& m) {
             "Removes the last added include dir from the internal list")
         .def("clearIncludeDir", &hp::Compiler::clearIncludeDir,
             "Clears the internal list of include directories")
+        .def("preloadIncludes", &hp::Compiler::preloadIncludes,
+            "Loads all files in the include directories into memory. Include "
+            "files are cached and only read again if they changed on disk.")
+        .def_prop_rw("options",
+            [](const hp::Compiler& c) { return c.getOptions(); },
+            [](hp::Compiler& c, hp::CompileOptions options) { c.setOptions(std::move(options)); },
+            "Options used for compiling")
+        .def_prop_rw("cacheDir",
+            [](const hp::Compiler& c) { return c.getCacheDir(); },
+            [](hp::Compiler& c, std::filesystem::path dir) { c.setCacheDir(std::move(dir)); },
+            "Directory in which compiled code is cached across runs. Entries are "
+            "keyed by the source code, headers, include directories and compiler "
+            "version. Changed include files loaded from disk invalidate them. "
+            "Empty path disables caching (default).")
         .def("compile",
             [](const hp::Compiler& c, std::string_view code) -> nb::bytes {
                 std::vector<uint32_t> result;
@@ -53,5 +165,90 @@ void registerCompilerModule(nb::module_& m) {
                 },
             "code"_a, "headers"_a,
             "Compiles the given GLSL code using the provided header files "
-            "and returns the SPIR-V code as bytes");
+            "and returns the SPIR-V code as bytes")
+        .def("buildProgramAsync", [](
+                const hp::Compiler& c,
+                std::string code,
+                const hp::Compiler::HeaderMap* headers,
+                std::optional<nb::bytes> spec
+                ) -> hp::PendingProgram {
+                    std::vector<std::byte> specialization;
+                    if (spec) {
+                        auto data = reinterpret_cast<const std::byte*>(spec->c_str());
+                        specialization.assign(data, data + spec->size());
+                    }
+                    if (headers) {
+                        return c.buildProgramAsync(getCurrentContext(),
+                            std::move(code), *headers, std::move(specialization));
+                    }
+                    else {
+                        return c.buildProgramAsync(getCurrentContext(),
+                            std::move(code), std::move(specialization));
+                    }
+                },
+            "code"_a, "headers"_a.none() = nb::none(), "specialization"_a.none() = nb::none(),
+            "Compiles the given GLSL code and creates a program from it in the "
+            "background. Returns a handle to poll or wait for the program."
+            "\n\nParameters\n----------\n"
+            "code: str\n"
+            "    GLSL source code\n"
+            "headers: HeaderMap | None, default=None\n"
+            "    Map of source code for resolving includes. Takes precedence\n"
+            "specialization: bytes | None, default=None\n"
+            "    Data used for filling in specialization constants\n")
+        .def("compileMany", [](
+                const hp::Compiler& c,
+                const std::vector<std::string>& codes,
+                const hp::Compiler::HeaderMap* headers,
+                uint32_t threads
+                ) -> std::vector<nb::bytes> {
+                    std::vector<std::vector<uint32_t>> results;
+                    {
+                        //release GIL during compilation
+                        nb::gil_scoped_release release;
+                        std::vector<std::string_view> views(codes.begin(), codes.end());
+                        results = headers
+                            ? c.compileMany(views, *headers, threads)
+                            : c.compileMany(views, threads);
+                    }
+                    std::vector<nb::bytes> list;
+                    list.reserve(results.size());
+                    for (auto& r : results)
+                        list.emplace_back((const char*)r.data(), r.size()*4);
+                    return list;
+                },
+            "codes"_a, "headers"_a.none() = nb::none(), "threads"_a = 0,
+            "Compiles the given GLSL codes in parallel and returns the SPIR-V "
+            "codes as bytes in the same order. Throws the first error after all "
+            "compilations finished."
+            "\n\nParameters\n----------\n"
+            "codes: list[str]\n"
+            "    GLSL source codes\n"
+            "headers: HeaderMap | None, default=None\n"
+            "    Map of source code for resolving includes. Takes precedence\n"
+            "threads: int, default=0\n"
+            "    Maximum amount of threads to use. Zero uses one per core.\n");
+
+    m.def("specializeCode",
+        [](nb::bytes code, nb::bytes specialization) -> nb::bytes {
+            auto result = hp::specializeCode(
+                std::span<const uint32_t>{
+                    reinterpret_cast<const uint32_t*>(code.c_str()),
+                    code.size() / 4
+                },
+                std::span<const std::byte>{
+                    reinterpret_cast<const std::byte*>(specialization.c_str()),
+                    specialization.size()
+                });
+            return nb::bytes((const char*)result.data(), result.size()*4);
+        }, "code"_a, "specialization"_a,
+        "Folds specialization constants into the given SPIR-V code, so drivers "
+        "can optimize it as if the values were hardcoded. Data is interpreted "
+        "the same way as the specialization of Program. Constants without data "
+        "keep their default value."
+        "\n\nParameters\n----------\n"
+        "code: bytes\n"
+        "    SPIR-V byte code\n"
+        "specialization: bytes\n"
+        "    Data used for filling in specialization constants\n");
 }
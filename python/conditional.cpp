@@ -0,0 +1,90 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/optional.h>
+
+#include <stdexcept>
+
+#include <hephaistos/conditional.hpp>
+
+#include "context.hpp"
+
+namespace hp = hephaistos;
+namespace nb = nanobind;
+using namespace nb::literals;
+
+namespace {
+
+bool isConditionalExecutionSupported(std::optional<uint32_t> id) {
+    auto& devices = getDevices();
+    if (id) {
+        if (id >= devices.size())
+            throw std::runtime_error("There is no device with the selected id!");
+        return hp::isConditionalExecutionSupported(devices[*id]);
+    }
+    else {
+        //check if any device is supported
+        for (auto& dev : devices) {
+            if (hp::isConditionalExecutionSupported(dev))
+                return true;
+        }
+        return false;
+    }
+}
+
+}
+
+void registerConditionalModule(nb::module_& m) {
+    m.def("isConditionalExecutionSupported", &isConditionalExecutionSupported,
+        "id"_a.none() = nb::none(),
+        "Checks wether any or the given device supports conditional execution.");
+    m.def("isConditionalExecutionEnabled",
+        []() -> bool { return hp::isConditionalExecutionEnabled(getCurrentContext()); },
+        "Checks wether conditional execution was enabled. Note that this creates the context.");
+    m.def("enableConditionalExecution",
+        [](bool force) { addExtension(hp::createConditionalExecutionExtension(), force); },
+        "force"_a = false,
+        "Enables conditional execution. (Lazy) context creation fails if not supported. "
+        "Set force=True if an existing context should be destroyed.");
+
+    nb::class_<hp::BeginConditionalCommand, hp::Command>(m, "BeginConditionalCommand",
+            "Command for starting a block of dispatches, which are discarded if the "
+            "32 bit predicate read from the tensor is zero, or non zero if inverted.")
+        .def(nb::init<const hp::Tensor<std::byte>&, uint64_t, bool>(),
+            "tensor"_a, "offset"_a = 0, "inverted"_a = false,
+            "Creates a new BeginConditionalCommand."
+            "\n\nParameters\n----------\n"
+            "tensor: Tensor\n"
+            "    Tensor from which to read the predicate\n"
+            "offset: int, default=0\n"
+            "    Offset in bytes at which the predicate is stored. Must be a multiple of 4.\n"
+            "inverted: bool, default=False\n"
+            "    If True, the block is discarded if the predicate is non zero\n")
+        .def_rw("offset", &hp::BeginConditionalCommand::offset,
+            "Offset in bytes into tensor at which the predicate is stored")
+        .def_rw("inverted", &hp::BeginConditionalCommand::inverted,
+            "If True, the block is discarded if the predicate is non zero");
+    m.def("beginConditional",
+        [](const hp::Tensor<std::byte>& tensor, uint64_t offset, bool inverted)
+            -> hp::BeginConditionalCommand
+            { return hp::beginConditional(tensor, offset, inverted); },
+        "tensor"_a, "offset"_a = 0, "inverted"_a = false,
+        "Starts a block of dispatches, which are discarded if the 32 bit predicate "
+        "read from the tensor is zero, or non zero if inverted. Begin and end of a "
+        "block must be recorded into the same step of a sequence or the same subroutine."
+        "\n\nParameters\n----------\n"
+        "tensor: Tensor\n"
+        "    Tensor from which to read the predicate\n"
+        "offset: int, default=0\n"
+        "    Offset in bytes at which the predicate is stored. Must be a multiple of 4.\n"
+        "inverted: bool, default=False\n"
+        "    If True, the block is discarded if the predicate is non zero\n");
+
+    nb::class_<hp::EndConditionalCommand, hp::Command>(m, "EndConditionalCommand",
+            "Command for ending a block of conditionally executed dispatches")
+        .def("__init__",
+            [](hp::EndConditionalCommand* cmd)
+                { new (cmd) hp::EndConditionalCommand(getCurrentContext()); });
+    m.def("endConditional",
+        []() -> hp::EndConditionalCommand
+            { return hp::endConditional(getCurrentContext()); },
+        "Ends a block of conditionally executed dispatches.");
+}
@@ -1,15 +1,24 @@
 #include "context.hpp"
 
+#include <algorithm>
+#include <iomanip>
 #include <stdexcept>
 #include <sstream>
 #include <string>
 #include <string_view>
 
 #include <nanobind/nanobind.h>
+#include <nanobind/stl/array.h>
+#include <nanobind/stl/filesystem.h>
+#include <nanobind/stl/optional.h>
 #include <nanobind/stl/string.h>
+#include <nanobind/stl/string_view.h>
 #include <nanobind/stl/vector.h>
 
+#include <hephaistos/buffer.hpp>
 #include <hephaistos/context.hpp>
+#include <hephaistos/image.hpp>
+#include <hephaistos/program.hpp>
 
 namespace hp = hephaistos;
 namespace nb = nanobind;
@@ -25,6 +34,18 @@ hp::ContextHandle currentContext{ nullptr, _emptyDtor };
 constexpr uint32_t MaxId = 0xFFFFFFFF;
 uint32_t selectedDeviceId = MaxId;
 
+//warns about resources still alive while the context gets replaced
+void reportLeakedResources() {
+    if (!currentContext || !hp::isResourceTrackingEnabled(currentContext))
+        return;
+    if (hp::getLiveResources(currentContext).empty())
+        return;
+    auto report = "Replacing the context while resources are still alive!\n" +
+        hp::dumpResources(currentContext);
+    if (PyErr_WarnEx(PyExc_ResourceWarning, report.c_str(), 1) != 0)
+        throw nb::python_error();
+}
+
 //extension list
 std::vector<hp::ExtensionHandle> extensions{};
 std::vector<std::string_view> extension_names{};
@@ -46,6 +67,7 @@ void selectDevice(uint32_t id, bool force) {
         if (force) {
             //delete old context
             //objects are now undefined
+            reportLeakedResources();
             currentContext.reset();
             handles.clear();
             //instance should have been deleted now (doesn't really matter)
@@ -102,6 +124,7 @@ void addExtension(hp::ExtensionHandle extension, bool force) {
         if (force) {
             //delete old context
             //objects are now undefined
+            reportLeakedResources();
             currentContext.reset();
             handles.clear();
             //instance should have been deleted now (doesn't really matter)
@@ -129,6 +152,32 @@ void registerContextModule(nb::module_& m) {
         .def_ro("isDiscrete", &hp::DeviceInfo::isDiscrete,
             "True, if the device is a discrete GPU. "
             "Can be useful to distinguish from integrated ones.")
+        .def_ro("vendor", &hp::DeviceInfo::vendor,
+            "Name of the vendor, e.g. 'NVIDIA'. 'Unknown' if not recognized.")
+        .def_ro("vendorID", &hp::DeviceInfo::vendorID, "PCI vendor id of the device")
+        .def_ro("deviceID", &hp::DeviceInfo::deviceID, "Vendor specific id of the device")
+        .def_prop_ro("uuid", [](const hp::DeviceInfo& info) {
+                std::ostringstream str;
+                str << std::hex << std::setfill('0');
+                for (auto b : info.uuid)
+                    str << std::setw(2) << static_cast<uint32_t>(b);
+                return str.str();
+            }, "Universally unique identifier of the device as hex string. "
+            "Stable across processes and APIs.")
+        .def_ro("driverVersion", &hp::DeviceInfo::driverVersion,
+            "Vendor specific encoded version of the driver")
+        .def_ro("driverInfo", &hp::DeviceInfo::driverInfo,
+            "Name and version of the driver")
+        .def_ro("deviceMemory", &hp::DeviceInfo::deviceMemory,
+            "Size of the largest device local memory heap in bytes")
+        .def_ro("computeUnits", &hp::DeviceInfo::computeUnits,
+            "Amount of compute units (SMs/CUs). Zero if the driver does not report it.")
+        .def_ro("subgroupSize", &hp::DeviceInfo::subgroupSize,
+            "Default amount of invocations in a subgroup")
+        .def_ro("maxWorkGroupInvocations", &hp::DeviceInfo::maxWorkGroupInvocations,
+            "Maximum amount of invocations in a single workgroup")
+        .def_ro("maxSharedMemorySize", &hp::DeviceInfo::maxSharedMemorySize,
+            "Maximum amount of shared memory per workgroup in bytes")
         .def("__repr__", [](const hp::DeviceInfo& info){
             std::ostringstream str;
             str << info.name;
@@ -136,10 +185,379 @@ void registerContextModule(nb::module_& m) {
                 str << " (discrete)";
             return str.str();
         });
+    nb::class_<hp::DeviceLimits>(m, "DeviceLimits",
+            "Limits of a device relevant for sizing work and resources")
+        .def_ro("maxWorkGroupCount", &hp::DeviceLimits::maxWorkGroupCount,
+            "Maximum amount of work groups in a single dispatch per dimension. "
+            "Dispatches exceeding it get split automatically.")
+        .def_ro("maxWorkGroupSize", &hp::DeviceLimits::maxWorkGroupSize,
+            "Maximum local size of a work group per dimension")
+        .def_ro("maxWorkGroupInvocations", &hp::DeviceLimits::maxWorkGroupInvocations,
+            "Maximum amount of invocations in a single work group")
+        .def_ro("maxSharedMemorySize", &hp::DeviceLimits::maxSharedMemorySize,
+            "Maximum amount of shared memory per work group in bytes")
+        .def_ro("maxStorageBufferRange", &hp::DeviceLimits::maxStorageBufferRange,
+            "Maximum size in bytes a single tensor binding can span")
+        .def_ro("maxUniformBufferRange", &hp::DeviceLimits::maxUniformBufferRange,
+            "Maximum size in bytes of a single uniform buffer binding")
+        .def_ro("maxPushConstantsSize", &hp::DeviceLimits::maxPushConstantsSize,
+            "Maximum size of push constants in bytes")
+        .def_ro("maxMemoryAllocationSize", &hp::DeviceLimits::maxMemoryAllocationSize,
+            "Maximum size of a single allocation in bytes")
+        .def_ro("heapSizes", &hp::DeviceLimits::heapSizes,
+            "Size in bytes of each memory heap of the device")
+        .def_ro("timestampPeriod", &hp::DeviceLimits::timestampPeriod,
+            "Nanoseconds per timestamp tick");
+    nb::enum_<hp::QueueType>(m, "QueueType", "Type of queue work is submitted to")
+        .value("MAIN", hp::QueueType::MAIN, "Main queue supporting compute and transfer")
+        .value("TRANSFER", hp::QueueType::TRANSFER,
+            "Queue restricted to transfer, usually backed by DMA engines")
+        .value("COMPUTE", hp::QueueType::COMPUTE,
+            "Additional queue supporting compute and transfer");
+    m.def("hasDedicatedQueue", [](hp::QueueType type) {
+            return hp::hasDedicatedQueue(getCurrentContext(), type);
+        }, "type"_a,
+        "Returns True, if the current context has a dedicated queue of the given type. "
+        "Work targeting a missing queue runs on the main queue instead. "
+        "Note that this may initialize the context.");
+    nb::enum_<hp::QueuePriority>(m, "QueuePriority",
+            "System wide scheduling priority of the context's queues")
+        .value("LOW", hp::QueuePriority::LOW, "Background work yielding to everything else")
+        .value("MEDIUM", hp::QueuePriority::MEDIUM, "Default priority of every queue")
+        .value("HIGH", hp::QueuePriority::HIGH,
+            "Latency sensitive work. May require elevated privileges.")
+        .value("REALTIME", hp::QueuePriority::REALTIME,
+            "Work that must not be delayed by any other work. Usually requires elevated privileges.");
+    m.def("isQueuePrioritySupported", [](std::optional<uint32_t> id) -> bool {
+            auto& devices = getDevices();
+            if (id) {
+                if (*id >= devices.size())
+                    throw std::runtime_error("There is no device with the selected id!");
+                return hp::isQueuePrioritySupported(devices[*id]);
+            }
+            return std::any_of(devices.begin(), devices.end(),
+                [](const hp::DeviceHandle& d) { return hp::isQueuePrioritySupported(d); });
+        }, "id"_a.none() = nb::none(),
+        "Checks wether any or the given device supports setting the global queue priority.");
+    m.def("enableQueuePriority",
+        [](hp::QueuePriority priority, bool force) {
+            addExtension(hp::createQueuePriorityExtension(priority), force);
+        }, "priority"_a, "force"_a = false,
+        "Sets the global priority of the context's queues relative to other applications. "
+        "(Lazy) context creation fails if not supported. Set force=True if an existing "
+        "context should be destroyed.");
+    m.def("getQueuePriority", []() { return hp::getQueuePriority(getCurrentContext()); },
+        "Returns the global priority of the current context's queues. Might be MEDIUM if "
+        "the process lacks the privileges for the requested one. "
+        "Note that this may initialize the context.");
+    nb::class_<hp::HeapStatistics>(m, "HeapStatistics",
+            "Memory usage of a single memory heap")
+        .def_ro("deviceLocal", &hp::HeapStatistics::deviceLocal,
+            "True, if the heap is local to the device, i.e. backs tensors")
+        .def_ro("size", &hp::HeapStatistics::size, "Size of the heap in bytes")
+        .def_ro("usage", &hp::HeapStatistics::usage,
+            "Bytes currently used by this process, including overhead")
+        .def_ro("budget", &hp::HeapStatistics::budget,
+            "Estimated bytes this process can use before allocations start to fail "
+            "or degrade performance. Only accurate if isMemoryBudgetSupported() "
+            "returns True, otherwise a heuristic based on the heap size.")
+        .def_ro("blockCount", &hp::HeapStatistics::blockCount,
+            "Number of device memory blocks allocated from the heap")
+        .def_ro("blockBytes", &hp::HeapStatistics::blockBytes,
+            "Bytes allocated in device memory blocks")
+        .def_ro("allocationCount", &hp::HeapStatistics::allocationCount,
+            "Number of resources occupying the heap's blocks")
+        .def_ro("allocationBytes", &hp::HeapStatistics::allocationBytes,
+            "Bytes occupied by resources inside the heap's blocks")
+        .def_ro("largestFreeRange", &hp::HeapStatistics::largestFreeRange,
+            "Size of the largest free range inside any existing block");
+    nb::class_<hp::MemoryStatistics>(m, "MemoryStatistics",
+            "Memory usage of the current context")
+        .def_ro("heaps", &hp::MemoryStatistics::heaps,
+            "Statistics per memory heap of the device")
+        .def_ro("blockCount", &hp::MemoryStatistics::blockCount,
+            "Total number of device memory blocks")
+        .def_ro("blockBytes", &hp::MemoryStatistics::blockBytes,
+            "Total bytes allocated in device memory blocks")
+        .def_ro("allocationCount", &hp::MemoryStatistics::allocationCount,
+            "Total number of resources")
+        .def_ro("allocationBytes", &hp::MemoryStatistics::allocationBytes,
+            "Total bytes occupied by resources");
+    nb::enum_<hp::MemoryPlacement>(m, "MemoryPlacement",
+            "Preferred placement of memory allocations")
+        .value("AUTO", hp::MemoryPlacement::AUTO,
+            "Lets the allocator decide based on the usage")
+        .value("PREFER_DEVICE", hp::MemoryPlacement::PREFER_DEVICE,
+            "Prefers memory local to the device")
+        .value("PREFER_HOST", hp::MemoryPlacement::PREFER_HOST,
+            "Prefers memory residing on the host");
+    nb::class_<hp::AllocationHints>(m, "AllocationHints",
+            "Hints for allocating memory of tensors and images")
+        .def("__init__", [](hp::AllocationHints* h,
+            float priority, hp::MemoryPlacement placement, bool dedicated
+        ) {
+            new (h) hp::AllocationHints{ priority, placement, dedicated };
+        }, "priority"_a = 0.5f, "placement"_a = hp::MemoryPlacement::AUTO,
+            "dedicated"_a = false)
+        .def_rw("priority", &hp::AllocationHints::priority,
+            "Priority in the range [0,1] of keeping the memory resident. Allocations "
+            "with a lower priority get paged out first if the device runs out of "
+            "memory. Only has an effect if isMemoryPrioritySupported() returns True.")
+        .def_rw("placement", &hp::AllocationHints::placement,
+            "Preferred placement of the memory")
+        .def_rw("dedicated", &hp::AllocationHints::dedicated,
+            "If True, the allocation gets its own memory block");
+    m.def("isUnifiedMemorySupported", []() {
+            return hp::isUnifiedMemorySupported(getCurrentContext());
+        },
+        "Returns True, if the device local memory of the current context is directly "
+        "accessible by the host, i.e. the device is integrated or supports resizable "
+        "BAR. Note that this may initialize the context.");
+    m.def("isMemoryPrioritySupported", []() {
+            return hp::isMemoryPrioritySupported(getCurrentContext());
+        },
+        "Returns True, if the current context supports memory priorities. "
+        "Otherwise, AllocationHints.priority is ignored. "
+        "Note that this may initialize the context.");
+    m.def("isMemoryBudgetSupported", []() {
+            return hp::isMemoryBudgetSupported(getCurrentContext());
+        },
+        "Returns True, if the current context tracks memory budgets reported by "
+        "the driver. Otherwise budgets are estimated from the heap sizes. "
+        "Note that this may initialize the context.");
+    m.def("getMemoryStatistics", []() {
+            return hp::getMemoryStatistics(getCurrentContext());
+        },
+        "Returns the current memory usage and budget of the current context. "
+        "Collecting the statistics iterates all allocations and thus should not "
+        "be done too frequently. Note that this may initialize the context.");
+    nb::class_<hp::ContextStatistics>(m, "ContextStatistics",
+            "Counters of the work issued on the current context. Counters only "
+            "increase, i.e. rates can be derived by sampling them periodically.")
+        .def_ro("submissions", &hp::ContextStatistics::submissions,
+            "Number of submissions to any queue of the context")
+        .def_ro("commandBuffers", &hp::ContextStatistics::commandBuffers,
+            "Total number of command buffers across all submissions")
+        .def_ro("oneTimeSubmits", &hp::ContextStatistics::oneTimeSubmits,
+            "Number of one time submits, i.e. execute() and its variants including "
+            "the ones issued internally")
+        .def_ro("bytesUploaded", &hp::ContextStatistics::bytesUploaded,
+            "Bytes transferred from host to device memory")
+        .def_ro("bytesDownloaded", &hp::ContextStatistics::bytesDownloaded,
+            "Bytes transferred from device to host memory")
+        .def_ro("dispatches", &hp::ContextStatistics::dispatches,
+            "Number of dispatches recorded, including indirect ones")
+        .def_ro("barriers", &hp::ContextStatistics::barriers,
+            "Number of pipeline barriers recorded")
+        .def_ro("pipelineCacheHits", &hp::ContextStatistics::pipelineCacheHits,
+            "Number of pipelines found in the pipeline cache. Stays zero if the "
+            "driver does not report pipeline creation feedback.")
+        .def_ro("pipelineCacheMisses", &hp::ContextStatistics::pipelineCacheMisses,
+            "Number of pipelines the driver had to compile. Stays zero if the "
+            "driver does not report pipeline creation feedback.");
+    m.def("getContextStatistics", []() {
+            return hp::getContextStatistics(getCurrentContext());
+        },
+        "Returns the counters of the work issued on the current context. "
+        "Note that this may initialize the context.");
+
+    nb::class_<hp::ResourceInfo>(m, "ResourceInfo",
+            "Live resource recorded by the resource tracking")
+        .def_ro("type", &hp::ResourceInfo::type,
+            "Type of the resource, e.g. Tensor or Program")
+        .def_ro("size", &hp::ResourceInfo::size,
+            "Size of the resource's memory in bytes. Zero if unknown.")
+        .def_ro("tag", &hp::ResourceInfo::tag,
+            "Tag assigned via setResourceTag(). Empty if none.")
+        .def("__repr__", [](const hp::ResourceInfo& info) {
+            std::ostringstream str;
+            str << "ResourceInfo(type=" << info.type << ", size=" << info.size;
+            if (!info.tag.empty())
+                str << ", tag=" << info.tag;
+            str << ')';
+            return str.str();
+        });
+    m.def("setResourceTracking", [](bool enable) {
+            hp::setResourceTracking(getCurrentContext(), enable);
+        }, "enable"_a,
+        "Enables or disables the accounting of live resources on the current context. "
+        "Resources created before enabling it are not recorded. Disabling it discards "
+        "all records. While enabled, replacing the context with live resources issues "
+        "a ResourceWarning. Note that this may initialize the context.");
+    m.def("isResourceTrackingEnabled", []() {
+            return hp::isResourceTrackingEnabled(getCurrentContext());
+        },
+        "Returns True, if the current context tracks its live resources. "
+        "Note that this may initialize the context.");
+    m.def("setDeferredDestruction", [](bool enable) {
+            hp::setDeferredDestruction(getCurrentContext(), enable);
+        }, "enable"_a,
+        "Enables or disables deferred destruction on the current context. While "
+        "enabled, destroyed resources are retired until all work submitted before "
+        "finished instead of being destroyed immediately. Note that this may "
+        "initialize the context.");
+    m.def("isDeferredDestructionEnabled", []() {
+            return hp::isDeferredDestructionEnabled(getCurrentContext());
+        },
+        "Returns True, if the current context defers the destruction of resources. "
+        "Note that this may initialize the context.");
+    m.def("collectRetiredResources", []() {
+            nb::gil_scoped_release release;
+            return hp::collectRetiredResources(getCurrentContext());
+        },
+        "Destroys retired resources whose work has finished and returns the amount "
+        "of retired resources still waiting. Note that this may initialize the context.");
+    m.def("setWaitSpinTime", [](uint64_t nanoseconds) {
+            hp::setWaitSpinTime(getCurrentContext(), nanoseconds);
+        }, "nanoseconds"_a,
+        "Sets how long waits on the current context poll before blocking, which "
+        "avoids the wake up latency of blocking waits on some drivers at the cost "
+        "of CPU time. Zero blocks right away. Note that this may initialize the "
+        "context.");
+    m.def("getWaitSpinTime", []() {
+            return hp::getWaitSpinTime(getCurrentContext());
+        },
+        "Returns how long waits on the current context poll before blocking in "
+        "nanoseconds. Note that this may initialize the context.");
+    nb::enum_<hp::BufferRobustness>(m, "BufferRobustness",
+            "Robustness of buffer accesses inside programs")
+        .value("DEFAULT", hp::BufferRobustness::DEFAULT,
+            "Follows the device, i.e. the enableRobustBufferAccess debug option")
+        .value("DISABLED", hp::BufferRobustness::DISABLED,
+            "Out of bounds accesses are undefined")
+        .value("ENABLED", hp::BufferRobustness::ENABLED,
+            "Out of bounds accesses are bounds checked");
+    m.def("isProgramRobustnessSupported", []() {
+            return hp::isProgramRobustnessSupported(getCurrentContext());
+        },
+        "Returns True, if programs can override the robustness of the current "
+        "context. Note that this may initialize the context.");
+    m.def("setProgramRobustness", [](hp::BufferRobustness robustness) {
+            hp::setProgramRobustness(getCurrentContext(), robustness);
+        }, "robustness"_a,
+        "Sets the robustness of programs created afterwards on the current "
+        "context, e.g. to disable bounds checks for validated programs. "
+        "Reloading a program applies the current robustness. Note that this "
+        "may initialize the context.");
+    m.def("getProgramRobustness", []() {
+            return hp::getProgramRobustness(getCurrentContext());
+        },
+        "Returns the robustness of programs created on the current context. "
+        "Note that this may initialize the context.");
+    nb::class_<hp::FloatControlsProperties>(m, "FloatControlsProperties",
+            "Float controls programs on a context can request")
+        .def_ro("denormFlushToZeroFloat16", &hp::FloatControlsProperties::denormFlushToZeroFloat16,
+            "True, if 16 bit denormalized floats can be flushed to zero")
+        .def_ro("denormFlushToZeroFloat32", &hp::FloatControlsProperties::denormFlushToZeroFloat32,
+            "True, if 32 bit denormalized floats can be flushed to zero")
+        .def_ro("denormFlushToZeroFloat64", &hp::FloatControlsProperties::denormFlushToZeroFloat64,
+            "True, if 64 bit denormalized floats can be flushed to zero")
+        .def_ro("denormPreserveFloat16", &hp::FloatControlsProperties::denormPreserveFloat16,
+            "True, if 16 bit denormalized floats can be preserved")
+        .def_ro("denormPreserveFloat32", &hp::FloatControlsProperties::denormPreserveFloat32,
+            "True, if 32 bit denormalized floats can be preserved")
+        .def_ro("denormPreserveFloat64", &hp::FloatControlsProperties::denormPreserveFloat64,
+            "True, if 64 bit denormalized floats can be preserved")
+        .def_ro("fastMath", &hp::FloatControlsProperties::fastMath,
+            "True, if programs can allow fast math");
+    m.def("getFloatControlsProperties", []() {
+            return hp::getFloatControlsProperties(getCurrentContext());
+        },
+        "Queries the float controls supported by the current context. Note that "
+        "this may initialize the context.");
+    nb::class_<hp::MemoryModelFeatures>(m, "MemoryModelFeatures",
+            "Features of the Vulkan memory model enabled on a context")
+        .def_ro("vulkanMemoryModel", &hp::MemoryModelFeatures::vulkanMemoryModel,
+            "True, if the Vulkan memory model is enabled")
+        .def_ro("deviceScope", &hp::MemoryModelFeatures::deviceScope,
+            "True, if synchronization can use device scope")
+        .def_ro("availabilityVisibilityChains", &hp::MemoryModelFeatures::availabilityVisibilityChains,
+            "True, if availability and visibility operations can be chained");
+    m.def("getMemoryModelFeatures", []() {
+            return hp::getMemoryModelFeatures(getCurrentContext());
+        },
+        "Queries the features of the Vulkan memory model enabled on the current "
+        "context. Note that this may initialize the context.");
+    m.def("setDescriptorSetCache", [](bool enable) {
+            hp::setDescriptorSetCache(getCurrentContext(), enable);
+        }, "enable"_a,
+        "Sets whether programs created afterwards on the current context bind "
+        "cached descriptor sets, one per unique combination of parameters, "
+        "instead of pushing them on each dispatch. Programs with more bindings "
+        "than the device can push always use cached sets. Cached sets are "
+        "dropped once any resource gets destroyed. Note that this may "
+        "initialize the context.");
+    m.def("isDescriptorSetCacheEnabled", []() {
+            return hp::isDescriptorSetCacheEnabled(getCurrentContext());
+        },
+        "Returns True, if programs created on the current context bind cached "
+        "descriptor sets. Note that this may initialize the context.");
+    m.def("setResourceTag", [](const hp::Buffer<std::byte>& buffer, std::string_view tag) {
+            hp::setResourceTag(buffer, tag);
+        }, "buffer"_a, "tag"_a,
+        "Assigns a tag to the buffer shown in resource reports");
+    m.def("setResourceTag", [](const hp::Tensor<std::byte>& tensor, std::string_view tag) {
+            hp::setResourceTag(tensor, tag);
+        }, "tensor"_a, "tag"_a,
+        "Assigns a tag to the tensor shown in resource reports");
+    m.def("setResourceTag", [](const hp::Image& image, std::string_view tag) {
+            hp::setResourceTag(image, tag);
+        }, "image"_a, "tag"_a,
+        "Assigns a tag to the image shown in resource reports");
+    m.def("setResourceTag", [](const hp::Texture& texture, std::string_view tag) {
+            hp::setResourceTag(texture, tag);
+        }, "texture"_a, "tag"_a,
+        "Assigns a tag to the texture shown in resource reports");
+    m.def("setResourceTag", [](const hp::Program& program, std::string_view tag) {
+            hp::setResourceTag(program, tag);
+        }, "program"_a, "tag"_a,
+        "Assigns a tag to the program shown in resource reports");
+    m.def("getLiveResources", []() {
+            return hp::getLiveResources(getCurrentContext());
+        },
+        "Returns the live resources tracked by the current context in order of creation. "
+        "Note that this may initialize the context.");
+    m.def("dumpResources", []() {
+            return hp::dumpResources(getCurrentContext());
+        },
+        "Returns a human readable report of the live resources tracked by the current "
+        "context summarized by type. Note that this may initialize the context.");
+    m.def("loadPipelineCache", [](const std::filesystem::path& path) {
+            return hp::loadPipelineCache(getCurrentContext(), path);
+        }, "path"_a,
+        "Merges pipeline cache data previously saved to the given file into the current "
+        "context. Returns False if the file does not exist or its data was created by a "
+        "different driver or device. Note that this may initialize the context.");
+    m.def("savePipelineCache", [](const std::filesystem::path& path) {
+            hp::savePipelineCache(getCurrentContext(), path);
+        }, "path"_a,
+        "Saves the pipeline cache data of the current context to the given file. "
+        "Note that this may initialize the context.");
+    m.def("setPipelineCacheFile", [](const std::filesystem::path& path) {
+            return hp::setPipelineCacheFile(getCurrentContext(), path);
+        }, "path"_a,
+        "Persists the pipeline cache of the current context in the given file, i.e. "
+        "loads its data if present and writes it back once the context gets destroyed. "
+        "An empty path disables writing it back. Returns True, if existing data was "
+        "loaded. Note that this may initialize the context.");
+    m.def("getPipelineCacheFile", []() {
+            return hp::getPipelineCacheFile(getCurrentContext());
+        },
+        "Returns the file the pipeline cache is persisted in. Empty if none was set.");
     m.def("enumerateDevices", &enumerateDevices,
         "Returns a list of all supported installed devices.");
     m.def("getCurrentDevice", []() { return hp::getDeviceInfo(getCurrentContext()); },
         "Returns the currently active device. Note that this may initialize the context.");
+    m.def("getDeviceLimits", [](std::optional<uint32_t> id) {
+            if (!id)
+                return hp::getDeviceLimits(getCurrentContext());
+            auto& devices = getDevices();
+            if (*id >= devices.size())
+                throw std::runtime_error("There is no device with the selected id!");
+            return hp::getDeviceLimits(devices[*id]);
+        }, "id"_a.none() = nb::none(),
+        "Returns the limits of the given or, if None, the currently active device. "
+        "Note that the latter may initialize the context.");
     m.def("selectDevice", &selectDevice, "id"_a, "force"_a = false,
         "Sets the device on which the context will be initialized. "
         "Set force=True if an existing context should be destroyed.");
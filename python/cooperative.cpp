@@ -0,0 +1,125 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/optional.h>
+#include <nanobind/stl/string.h>
+#include <nanobind/stl/vector.h>
+
+#include <sstream>
+#include <stdexcept>
+
+#include <hephaistos/cooperative.hpp>
+
+#include "context.hpp"
+
+namespace hp = hephaistos;
+namespace nb = nanobind;
+using namespace nb::literals;
+
+namespace {
+
+bool isCooperativeMatrixSupported(std::optional<uint32_t> id) {
+    auto& devices = getDevices();
+    if (id) {
+        if (id >= devices.size())
+            throw std::runtime_error("There is no device with the selected id!");
+        return hp::isCooperativeMatrixSupported(devices[*id]);
+    }
+    else {
+        //check if any device is supported
+        for (auto& dev : devices) {
+            if (hp::isCooperativeMatrixSupported(dev))
+                return true;
+        }
+        return false;
+    }
+}
+
+const char* toString(hp::ComponentType type) {
+    switch (type) {
+    case hp::ComponentType::FLOAT16: return "FLOAT16";
+    case hp::ComponentType::FLOAT32: return "FLOAT32";
+    case hp::ComponentType::FLOAT64: return "FLOAT64";
+    case hp::ComponentType::SINT8: return "SINT8";
+    case hp::ComponentType::SINT16: return "SINT16";
+    case hp::ComponentType::SINT32: return "SINT32";
+    case hp::ComponentType::SINT64: return "SINT64";
+    case hp::ComponentType::UINT8: return "UINT8";
+    case hp::ComponentType::UINT16: return "UINT16";
+    case hp::ComponentType::UINT32: return "UINT32";
+    case hp::ComponentType::UINT64: return "UINT64";
+    default: return "UNKNOWN";
+    }
+}
+
+}
+
+void registerCooperativeModule(nb::module_& m) {
+    nb::enum_<hp::ComponentType>(m, "ComponentType",
+            "Type of the components of a cooperative matrix")
+        .value("FLOAT16", hp::ComponentType::FLOAT16)
+        .value("FLOAT32", hp::ComponentType::FLOAT32)
+        .value("FLOAT64", hp::ComponentType::FLOAT64)
+        .value("SINT8", hp::ComponentType::SINT8)
+        .value("SINT16", hp::ComponentType::SINT16)
+        .value("SINT32", hp::ComponentType::SINT32)
+        .value("SINT64", hp::ComponentType::SINT64)
+        .value("UINT8", hp::ComponentType::UINT8)
+        .value("UINT16", hp::ComponentType::UINT16)
+        .value("UINT32", hp::ComponentType::UINT32)
+        .value("UINT64", hp::ComponentType::UINT64);
+    nb::enum_<hp::MatrixScope>(m, "MatrixScope",
+            "Scope of threads sharing a cooperative matrix")
+        .value("DEVICE", hp::MatrixScope::DEVICE)
+        .value("WORKGROUP", hp::MatrixScope::WORKGROUP)
+        .value("SUBGROUP", hp::MatrixScope::SUBGROUP)
+        .value("QUEUE_FAMILY", hp::MatrixScope::QUEUE_FAMILY);
+
+    nb::class_<hp::CooperativeMatrixProperties>(m, "CooperativeMatrixProperties",
+            "Matrix multiply-add configuration Result = A * B + C supported by the "
+            "device, where A is a MxK, B a KxN and both C and Result MxN matrices.")
+        .def_ro("MSize", &hp::CooperativeMatrixProperties::MSize,
+            "Amount of rows of A, C and Result")
+        .def_ro("NSize", &hp::CooperativeMatrixProperties::NSize,
+            "Amount of columns of B, C and Result")
+        .def_ro("KSize", &hp::CooperativeMatrixProperties::KSize,
+            "Amount of columns of A and rows of B")
+        .def_ro("AType", &hp::CooperativeMatrixProperties::AType,
+            "Component type of A")
+        .def_ro("BType", &hp::CooperativeMatrixProperties::BType,
+            "Component type of B")
+        .def_ro("CType", &hp::CooperativeMatrixProperties::CType,
+            "Component type of C")
+        .def_ro("ResultType", &hp::CooperativeMatrixProperties::ResultType,
+            "Component type of Result")
+        .def_ro("saturatingAccumulation", &hp::CooperativeMatrixProperties::saturatingAccumulation,
+            "Wether the operation saturates instead of wrapping around")
+        .def_ro("scope", &hp::CooperativeMatrixProperties::scope,
+            "Scope of threads sharing the matrices")
+        .def("__repr__", [](const hp::CooperativeMatrixProperties& p) {
+            std::ostringstream str;
+            str << p.MSize << 'x' << p.NSize << 'x' << p.KSize << ": ";
+            str << toString(p.ResultType) << " = " << toString(p.AType) << " * ";
+            str << toString(p.BType) << " + " << toString(p.CType);
+            if (p.saturatingAccumulation)
+                str << " (saturating)";
+            return str.str();
+        });
+
+    m.def("getCooperativeMatrixProperties", [](uint32_t id) {
+        auto& devices = getDevices();
+        if (id >= devices.size())
+            throw std::runtime_error("There is no device with the selected id!");
+        return hp::getCooperativeMatrixProperties(devices[id]);
+    }, "id"_a, "Returns the cooperative matrix configurations the device given by its "
+        "id supports. Empty if cooperative matrices are not supported.");
+    m.def("isCooperativeMatrixSupported", &isCooperativeMatrixSupported,
+        "id"_a.none() = nb::none(),
+        "Checks wether any or the given device supports cooperative matrices.");
+    m.def("isCooperativeMatrixEnabled",
+        []() -> bool { return hp::isCooperativeMatrixEnabled(getCurrentContext()); },
+        "Checks wether cooperative matrices were enabled. Note that this creates the context.");
+    m.def("enableCooperativeMatrix",
+        [](bool force) { addExtension(hp::createCooperativeMatrixExtension(), force); },
+        "force"_a = false,
+        "Enables cooperative matrices in programs. (Lazy) context creation fails if not "
+        "supported. Set force=True if an existing context should be destroyed.");
+}
@@ -1,12 +1,19 @@
 #include <nanobind/nanobind.h>
+#include <nanobind/stl/array.h>
 #include <nanobind/stl/function.h>
 #include <nanobind/stl/shared_ptr.h>
 #include <nanobind/stl/string.h>
+#include <nanobind/stl/string_view.h>
 
+#include <array>
 #include <sstream>
 #include <string>
 
 #include <hephaistos/debug.hpp>
+#include <hephaistos/image.hpp>
+#include <hephaistos/program.hpp>
+
+#include "context.hpp"
 
 namespace hp = hephaistos;
 namespace nb = nanobind;
@@ -47,6 +54,7 @@ void configureDebug(
     bool enableSynchronizationValidation,
     bool enableThreadSafetyValidation,
     bool enableAPIValidation,
+    bool enableRobustBufferAccess,
     hp::DebugCallback callback
 ) {
     pyCallback = std::move(callback);
@@ -55,7 +63,8 @@ void configureDebug(
         .enableGPUValidation = enableGPUValidation,
         .enableSynchronizationValidation = enableSynchronizationValidation,
         .enableThreadSafetyValidation = enableThreadSafetyValidation,
-        .enableAPIValidation = enableAPIValidation
+        .enableAPIValidation = enableAPIValidation,
+        .enableRobustBufferAccess = enableRobustBufferAccess
     }, pyDebugCallback);
 }
 void cleanUpDebug() {
@@ -90,9 +99,105 @@ void registerDebugModule(nb::module_& m) {
         "enableSynchronizationValidation"_a = false,
         "enableThreadSafetyValidation"_a = false,
         "enableAPIValidation"_a = false,
+        "enableRobustBufferAccess"_a = false,
         "callback"_a = noneCallback,
         "Configures the debug state");
-    
+
+    m.def("enableDebugLabels", &hp::enableDebugLabels,
+        "Enables debug labels and object names if supported, so they show up in "
+        "external tools. Must be called before any other library calls except "
+        "isVulkanAvailable() and isDebugAvailable().");
+    m.def("isDebugLabelsEnabled",
+        []() -> bool { return hp::isDebugLabelsEnabled(getCurrentContext()); },
+        "Checks whether debug labels and object names are enabled");
+    m.def("isRobustBufferAccessEnabled",
+        []() -> bool { return hp::isRobustBufferAccessEnabled(getCurrentContext()); },
+        "Checks whether the current context accesses buffers robustly. "
+        "Note that this may initialize the context.");
+
+    nb::class_<hp::BeginLabelCommand, hp::Command>(m, "BeginLabelCommand",
+            "Command opening a labeled region of commands shown in external tools")
+        .def("__init__",
+            [](hp::BeginLabelCommand* cmd, std::string_view name, std::array<float, 4> color)
+                { new (cmd) hp::BeginLabelCommand(getCurrentContext(), name, color); },
+            "name"_a, "color"_a = std::array<float, 4>{},
+            "Creates a new BeginLabelCommand."
+            "\n\nParameters\n----------\n"
+            "name: str\n"
+            "    Name of the region\n"
+            "color: tuple[float, float, float, float], default=(0.0, 0.0, 0.0, 0.0)\n"
+            "    Optional RGBA color of the region\n")
+        .def_rw("name", &hp::BeginLabelCommand::name,
+            "Name of the region")
+        .def_rw("color", &hp::BeginLabelCommand::color,
+            "Optional RGBA color of the region");
+    m.def("beginLabel",
+        [](std::string_view name, std::array<float, 4> color) -> hp::BeginLabelCommand
+            { return hp::beginLabel(getCurrentContext(), name, color); },
+        "name"_a, "color"_a = std::array<float, 4>{},
+        "Opens a labeled region of commands shown in external tools. Regions can be "
+        "nested and must be closed within the same step of a sequence or the same "
+        "subroutine. Does nothing if debug labels are not enabled."
+        "\n\nParameters\n----------\n"
+        "name: str\n"
+        "    Name of the region\n"
+        "color: tuple[float, float, float, float], default=(0.0, 0.0, 0.0, 0.0)\n"
+        "    Optional RGBA color of the region\n");
+
+    nb::class_<hp::EndLabelCommand, hp::Command>(m, "EndLabelCommand",
+            "Command closing the innermost labeled region")
+        .def("__init__",
+            [](hp::EndLabelCommand* cmd)
+                { new (cmd) hp::EndLabelCommand(getCurrentContext()); });
+    m.def("endLabel",
+        []() -> hp::EndLabelCommand
+            { return hp::endLabel(getCurrentContext()); },
+        "Closes the innermost labeled region.");
+
+    nb::class_<hp::InsertLabelCommand, hp::Command>(m, "InsertLabelCommand",
+            "Command inserting a single label between commands")
+        .def("__init__",
+            [](hp::InsertLabelCommand* cmd, std::string_view name, std::array<float, 4> color)
+                { new (cmd) hp::InsertLabelCommand(getCurrentContext(), name, color); },
+            "name"_a, "color"_a = std::array<float, 4>{},
+            "Creates a new InsertLabelCommand."
+            "\n\nParameters\n----------\n"
+            "name: str\n"
+            "    Text of the label\n"
+            "color: tuple[float, float, float, float], default=(0.0, 0.0, 0.0, 0.0)\n"
+            "    Optional RGBA color of the label\n")
+        .def_rw("name", &hp::InsertLabelCommand::name,
+            "Text of the label")
+        .def_rw("color", &hp::InsertLabelCommand::color,
+            "Optional RGBA color of the label");
+    m.def("insertLabel",
+        [](std::string_view name, std::array<float, 4> color) -> hp::InsertLabelCommand
+            { return hp::insertLabel(getCurrentContext(), name, color); },
+        "name"_a, "color"_a = std::array<float, 4>{},
+        "Inserts a single label between commands shown in external tools. Does "
+        "nothing if debug labels are not enabled."
+        "\n\nParameters\n----------\n"
+        "name: str\n"
+        "    Text of the label\n"
+        "color: tuple[float, float, float, float], default=(0.0, 0.0, 0.0, 0.0)\n"
+        "    Optional RGBA color of the label\n");
+
+    m.def("setDebugName",
+        [](const hp::Program& program, std::string_view name) { hp::setDebugName(program, name); },
+        "program"_a, "name"_a,
+        "Names the program's pipeline and shader in external tools. Does nothing if "
+        "debug labels are not enabled.");
+    m.def("setDebugName",
+        [](const hp::Tensor<std::byte>& tensor, std::string_view name) { hp::setDebugName(tensor, name); },
+        "tensor"_a, "name"_a,
+        "Names the tensor's buffer in external tools. Does nothing if debug labels "
+        "are not enabled or the tensor is sub-allocated from a shared buffer.");
+    m.def("setDebugName",
+        [](const hp::Image& image, std::string_view name) { hp::setDebugName(image, name); },
+        "image"_a, "name"_a,
+        "Names the image in external tools. Does nothing if debug labels are not "
+        "enabled.");
+
     //register clean up code
     //TODO: Got this from pybind11, not sure if nanobind has something more clever
     auto atexit = nb::module_::import_("atexit");
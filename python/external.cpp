@@ -0,0 +1,99 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/optional.h>
+
+#include <stdexcept>
+
+#include <hephaistos/external.hpp>
+
+#include "context.hpp"
+
+namespace hp = hephaistos;
+namespace nb = nanobind;
+using namespace nb::literals;
+
+namespace {
+
+bool isExternalMemorySupported(std::optional<uint32_t> id) {
+    auto& devices = getDevices();
+    if (id) {
+        if (id >= devices.size())
+            throw std::runtime_error("There is no device with the selected id!");
+        return hp::isExternalMemorySupported(devices[*id]);
+    }
+    else {
+        //check if any device is supported
+        for (auto& dev : devices) {
+            if (hp::isExternalMemorySupported(dev))
+                return true;
+        }
+        return false;
+    }
+}
+
+}
+
+void registerExternalModule(nb::module_& m) {
+    m.def("isExternalMemorySupported", &isExternalMemorySupported,
+        "id"_a.none() = nb::none(),
+        "Checks wether any or the given device supports exporting memory and timelines.");
+    m.def("isExternalMemoryEnabled",
+        []() -> bool { return hp::isExternalMemoryEnabled(getCurrentContext()); },
+        "Checks wether external memory was enabled. Note that this creates the context.");
+    m.def("enableExternalMemory",
+        [](bool force) { addExtension(hp::createExternalMemoryExtension(), force); },
+        "force"_a = false,
+        "Enables exporting memory and timelines. (Lazy) context creation fails if not "
+        "supported. Set force=True if an existing context should be destroyed.");
+
+    nb::class_<hp::ExternalMemory>(m, "ExternalMemory",
+            "Exported memory of a tensor")
+        .def("__init__",
+            [](hp::ExternalMemory* e, hp::ExternalHandle handle, uint64_t size, uint64_t offset) {
+                new (e) hp::ExternalMemory{ handle, size, offset };
+            }, "handle"_a, "size"_a, "offset"_a = 0,
+            "Describes memory exported by another process, e.g. after receiving "
+            "its handle via socket.recv_fds().")
+        .def_ro("handle", &hp::ExternalMemory::handle,
+            "Native handle to the exported memory, i.e. a file descriptor on Linux "
+            "and a HANDLE on Windows. The receiver is responsible for closing it.")
+        .def_ro("size", &hp::ExternalMemory::size,
+            "Size of the exported memory in bytes. May be larger than the tensor.")
+        .def_ro("offset", &hp::ExternalMemory::offset,
+            "Offset in bytes of the tensor into the exported memory");
+
+    m.def("createExportableTensor",
+        [](uint64_t size) { return hp::createExportableTensor(getCurrentContext(), size); },
+        "size"_a,
+        "Allocates a new tensor of the given size in bytes in its own dedicated memory, "
+        "which can be exported to other APIs, e.g. CUDA.");
+    m.def("exportTensor", &hp::exportTensor, "tensor"_a,
+        "Exports the memory of a tensor created by createExportableTensor(). "
+        "Each call creates a new handle.");
+    m.def("importTensor",
+        [](const hp::ExternalMemory& memory, std::optional<uint64_t> size) {
+            return hp::importTensor(getCurrentContext(), memory, size.value_or(hp::whole_size));
+        }, "memory"_a, "size"_a.none() = nb::none(),
+        "Creates a tensor using memory exported by another process on the same device, "
+        "sharing it without copies. On Linux, a successful import takes ownership of "
+        "the file descriptor. Import tensors with the same size they were exported with."
+        "\n\nParameters\n----------\n"
+        "memory: ExternalMemory\n"
+        "    Memory exported via exportTensor()\n"
+        "size: None|int, default=None\n"
+        "    Size of the tensor in bytes. If None, uses the remaining memory after "
+        "the offset.\n");
+    m.def("createExportableTimeline",
+        [](uint64_t value) { return hp::createExportableTimeline(getCurrentContext(), value); },
+        "initialValue"_a = 0,
+        "Creates a new timeline, which can be exported to other APIs, e.g. CUDA, to "
+        "synchronize with work submitted to the context.");
+    m.def("exportTimeline", &hp::exportTimeline, "timeline"_a,
+        "Exports the semaphore of a timeline created by createExportableTimeline() and "
+        "returns its native handle. Each call creates a new handle.");
+    m.def("importTimeline",
+        [](hp::ExternalHandle handle) { return hp::importTimeline(getCurrentContext(), handle); },
+        "handle"_a,
+        "Creates a timeline using a semaphore exported by another process via "
+        "exportTimeline(). On Linux, a successful import takes ownership of the file "
+        "descriptor.");
+}
@@ -0,0 +1,149 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/optional.h>
+#include <nanobind/stl/vector.h>
+
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include <hephaistos/graph.hpp>
+
+#include "context.hpp"
+
+namespace hp = hephaistos;
+namespace nb = nanobind;
+using namespace nb::literals;
+
+namespace {
+
+bool isExecutionGraphSupported(std::optional<uint32_t> id) {
+    auto& devices = getDevices();
+    if (id) {
+        if (id >= devices.size())
+            throw std::runtime_error("There is no device with the selected id!");
+        return hp::isExecutionGraphSupported(devices[*id]);
+    }
+    else {
+        //check if any device is supported
+        for (auto& dev : devices) {
+            if (hp::isExecutionGraphSupported(dev))
+                return true;
+        }
+        return false;
+    }
+}
+
+}
+
+void registerGraphModule(nb::module_& m) {
+    m.def("isExecutionGraphSupported", &isExecutionGraphSupported,
+        "id"_a.none() = nb::none(),
+        "Checks wether any or the given device supports execution graphs.");
+    m.def("isExecutionGraphEnabled",
+        []() -> bool { return hp::isExecutionGraphEnabled(getCurrentContext()); },
+        "Checks wether execution graphs were enabled. Note that this creates the context.");
+    m.def("enableExecutionGraph",
+        [](bool force) { addExtension(hp::createExecutionGraphExtension(), force); },
+        "force"_a = false,
+        "Enables the experimental execution graphs. (Lazy) context creation fails "
+        "if not supported. Set force=True if an existing context should be destroyed.");
+
+    nb::class_<hp::ExecutionGraphCommand, hp::Command>(m, "ExecutionGraphCommand",
+        "Command seeding an execution graph or running it until it drains. Runs "
+        "multiple dispatches synchronized among each other, but not with work "
+        "recorded before or after.");
+
+    nb::class_<hp::ExecutionGraph>(m, "ExecutionGraph",
+            "Experimental graph of programs enqueuing 32 bit records to each other "
+            "on the device. Programs include the built-in header "
+            "\"hephaistos/graph.glsl\" and loop popping records of their node via "
+            "graphPop() until it drained, enqueuing follow up work to any node via "
+            "graphEnqueue(). Records enqueued in a round are processed in the next "
+            "one. Emulated via work queues and indirect dispatches. Programs must "
+            "be passed the graph's address, e.g. via push constants."
+            "\n\nParameters\n----------\n"
+            "nodes: list[Program]\n"
+            "    Programs of each node. Their bindings are captured on creation.\n"
+            "capacity: int\n"
+            "    Amount of records each half of a node's queue can hold\n"
+            "maxGroups: list[int] | None, default=None\n"
+            "    Maximum amount of workgroups per round of each node. Zero or None "
+            "uses the occupancy of the program.\n")
+        .def("__init__",
+            [](hp::ExecutionGraph* g,
+                nb::list nodes,
+                uint32_t capacity,
+                std::optional<std::vector<uint32_t>> maxGroups)
+            {
+                if (maxGroups && maxGroups->size() != nodes.size())
+                    throw std::runtime_error("Expected maxGroups for each node!");
+                std::vector<hp::GraphNode> _nodes;
+                auto i = 0u;
+                for (nb::handle h : nodes) {
+                    _nodes.push_back({
+                        nb::cast<const hp::Program&>(h),
+                        maxGroups ? (*maxGroups)[i++] : 0u
+                    });
+                }
+                nb::gil_scoped_release release;
+                new (g) hp::ExecutionGraph(getCurrentContext(), _nodes, capacity);
+            }, "nodes"_a, "capacity"_a, nb::kw_only(), "maxGroups"_a.none() = nb::none(),
+            nb::keep_alive<1, 2>())
+        .def_prop_ro("address", [](const hp::ExecutionGraph& g) { return g.getAddress(); },
+            "Device address of the graph")
+        .def_prop_ro("capacity", [](const hp::ExecutionGraph& g) { return g.getCapacity(); },
+            "Amount of records each half of a node's queue can hold")
+        .def_prop_ro("nodeCount", [](const hp::ExecutionGraph& g) { return g.getNodeCount(); },
+            "Amount of nodes")
+        .def_prop_ro("tensor", [](const hp::ExecutionGraph& g) -> const hp::Tensor<std::byte>& {
+                return g.getTensor();
+            }, nb::rv_policy::reference_internal,
+            "Tensor holding the queues of all nodes. Each starts with the same 64 "
+            "byte header as the one of WorkQueue.")
+        .def("getQueueOffset", &hp::ExecutionGraph::getQueueOffset, "node"_a,
+            "Returns the offset in bytes of the given node's queue inside tensor.")
+        .def("launch",
+            [](const hp::ExecutionGraph& g, nb::bytes push, uint32_t rounds) {
+                return g.launch(
+                    std::span<const std::byte>{
+                        reinterpret_cast<const std::byte*>(push.c_str()),
+                        push.size()
+                    }, rounds);
+            }, "push"_a = nb::bytes(), nb::kw_only(), "rounds"_a = 16,
+            nb::keep_alive<0, 1>(),
+            "Creates a command running the graph until it drains."
+            "\n\nParameters\n----------\n"
+            "push: bytes, default=b''\n"
+            "    Data pushed to the dispatches of all nodes\n"
+            "rounds: int, default=16\n"
+            "    Maximum amount of rounds\n")
+        .def("seed",
+            [](const hp::ExecutionGraph& g, uint32_t node, uint32_t count, uint32_t first) {
+                return g.seed(node, count, first);
+            }, "node"_a, "count"_a, "first"_a = 0, nb::keep_alive<0, 1>(),
+            "Creates a command resetting all nodes and filling the given one with "
+            "a range of consecutive records."
+            "\n\nParameters\n----------\n"
+            "node: int\n"
+            "    Node receiving the records\n"
+            "count: int\n"
+            "    Amount of records\n"
+            "first: int, default=0\n"
+            "    Value of the first record\n")
+        .def("seed",
+            [](const hp::ExecutionGraph& g, uint32_t node,
+                const hp::Tensor<std::byte>& records, std::optional<uint32_t> count)
+            {
+                return g.seed(node, records, count);
+            }, "node"_a, "records"_a, "count"_a.none() = nb::none(),
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 3>(),
+            "Creates a command resetting all nodes and filling the given one with "
+            "the records stored in the given tensor."
+            "\n\nParameters\n----------\n"
+            "node: int\n"
+            "    Node receiving the records\n"
+            "records: Tensor\n"
+            "    Tensor holding the records as 32 bit unsigned integers\n"
+            "count: int | None, default=None\n"
+            "    Amount of records. Uses the whole tensor if None.\n");
+}
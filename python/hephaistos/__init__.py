@@ -21,3 +21,19 @@ def _bindParams(program: Program, *params, **namedparams) -> None:
         p.bindParameter(program, name)
 #register function in class
 Program.bindParams = _bindParams
+ParameterSet.bindParams = _bindParams
+
+# ray tracing programs bind the params themselves
+def _bindRayTracingParams(program: RayTracingProgram, *params, **namedparams) -> None:
+    """
+    Helper function to bind a list of params in a ray tracing program.
+    """
+    for i, p in enumerate(params):
+        program.bindParameter(p, i)
+
+    names = [b.name for b in program.bindings]
+    for name, p in namedparams.items():
+        if name not in names:
+            continue
+        program.bindParameter(p, name)
+RayTracingProgram.bindParams = _bindRayTracingParams
@@ -1,8 +1,12 @@
 from __future__ import annotations
 import numpy as np
-from ctypes import Structure, c_float, c_uint32, c_int32
-from typing import Type, Union
-from hephaistos import Tensor
+from ctypes import (
+    Structure, sizeof,
+    c_double, c_float, c_int8, c_int16, c_int32, c_int64,
+    c_uint8, c_uint16, c_uint32, c_uint64,
+)
+from typing import Sequence, Type, Union
+from hephaistos import BlockMember, MemberType, Program, Tensor
 
 
 class vec(Structure):
@@ -296,3 +300,125 @@ class buffer_reference(Structure):
             value = value.address
         self.lo = value & 0xFFFFFFFF
         self.hi = value >> 32 & 0xFFFFFFFF
+
+
+class RandomStreams(Structure):
+    """
+    Range of random streams handed to a dispatch. Matches RandomStreams
+    declared in the built-in header "hephaistos/random.glsl".
+    """
+
+    _fields_ = [("seed", c_uint64), ("offset", c_uint64)]
+
+
+_SCALARS = {
+    (MemberType.BOOL, 32): c_uint32,
+    (MemberType.INT, 8): c_int8,
+    (MemberType.INT, 16): c_int16,
+    (MemberType.INT, 32): c_int32,
+    (MemberType.INT, 64): c_int64,
+    (MemberType.UINT, 8): c_uint8,
+    (MemberType.UINT, 16): c_uint16,
+    (MemberType.UINT, 32): c_uint32,
+    (MemberType.UINT, 64): c_uint64,
+    # ctypes has no half type; keep the raw bits
+    (MemberType.FLOAT, 16): c_uint16,
+    (MemberType.FLOAT, 32): c_float,
+    (MemberType.FLOAT, 64): c_double,
+}
+_VECTORS = {
+    (c_float, 2): vec2, (c_float, 3): vec3, (c_float, 4): vec4,
+    (c_int32, 2): ivec2, (c_int32, 3): ivec3, (c_int32, 4): ivec4,
+    (c_uint32, 2): uvec2, (c_uint32, 3): uvec3, (c_uint32, 4): uvec4,
+}
+
+
+def _padded(name: str, t, size: int):
+    """Wraps t into a structure of the given size if it is smaller"""
+    if size <= sizeof(t):
+        return t
+    return type(name, (Structure,), {
+        "_pack_": 1, "_layout_": "ms",
+        "_fields_": [("value", t), ("_pad", c_uint8 * (size - sizeof(t)))],
+    })
+
+
+def _memberType(member: BlockMember):
+    """Returns the ctypes type of a single element of the given member"""
+    if member.type == MemberType.STRUCT:
+        # arrays pad their elements to the stride instead
+        size = 0 if member.arrayDims else member.size
+        return createStructure(member.members, size, member.name or "Struct")
+
+    scalar = _SCALARS.get((member.type, member.width))
+    if scalar is None:
+        raise ValueError(f"Unsupported member type: {member.type} ({member.width} bit)")
+    # matrices are stored as columns, or rows if row major
+    length, count = member.components, member.columns
+    if member.rowMajor:
+        length, count = count, length
+    t = _VECTORS.get((scalar, length), scalar * length) if length > 1 else scalar
+    if member.columns > 1:
+        t = _padded(f"{member.name}_column", t, member.matrixStride) * count
+    return t
+
+
+def createStructure(
+    members: Sequence[BlockMember], size: int = 0, name: str = "Block"
+) -> Type[Structure]:
+    """
+    Creates a ctypes Structure matching the reflected layout of a block,
+    including std430 and scalar layouts. Gaps between members are filled with
+    padding fields, so instances can be copied from and to the device as is.
+
+    Parameters
+    ----------
+    members: Sequence[BlockMember]
+        Members of the block as reported by BindingTraits or a Program
+    size: int, default=0
+        Size of the structure in bytes. Pads the end if larger than needed.
+    name: str, default="Block"
+        Name of the created class
+
+    Returns
+    -------
+    structure: Type[Structure]
+        Structure class with one field per named member
+
+    Examples
+    --------
+    >>> Push = createPushStructure(program)
+    >>> Data = createStructure(program.bindings[0].members)
+    """
+    fields = []
+    offset = 0
+    for i, member in enumerate(members):
+        if member.offset > offset:
+            fields.append((f"_pad{i}", c_uint8 * (member.offset - offset)))
+        elif member.offset < offset:
+            raise ValueError(f"Member {member.name} overlaps its predecessor!")
+
+        t = _memberType(member)
+        if member.arrayDims:
+            # pad single elements to the stride of the innermost dimension
+            inner = 1
+            for d in member.arrayDims[1:]:
+                inner *= d
+            stride = member.arrayStride // max(inner, 1)
+            t = _padded(f"{member.name}_element", t, stride)
+            for d in reversed(member.arrayDims):
+                t = t * d
+        fields.append((member.name or f"_member{i}", t))
+        offset = member.offset + sizeof(t)
+    if size > offset:
+        fields.append(("_pad", c_uint8 * (size - offset)))
+
+    return type(name, (Structure,), {"_pack_": 1, "_layout_": "ms", "_fields_": fields})
+
+
+def createPushStructure(program: Program, name: str = "Push") -> Type[Structure]:
+    """
+    Creates a ctypes Structure matching the push constants of the given program.
+    See createStructure() for details.
+    """
+    return createStructure(program.pushConstantMembers, program.pushConstantSize, name)
@@ -3,33 +3,42 @@ from __future__ import annotations
 from abc import ABC, abstractmethod
 from ctypes import Structure, addressof, memmove, sizeof, c_uint8
 from itertools import chain
-from queue import Queue
-from threading import Event, Lock, Thread
+from collections import deque
+from math import isnan, nan
+from threading import Lock
+from time import perf_counter_ns
 import warnings
 
 from hephaistos import (
     Command,
+    Compiler,
     Program,
     RawBuffer,
+    ScratchAllocator,
+    StopWatch,
+    StreamExecutor,
     Submission,
     Subroutine,
+    TaskScheduler,
     Tensor,
-    Timeline,
     beginSequence,
     createSubroutine,
+    flushMemory,
     retrieveTensor,
     updateTensor,
 )
 from hephaistos.util import StructureTensor
-from numpy import frombuffer, float32
+from numpy import asarray, dtype, frombuffer, float32, ndarray, repeat
 
-from numpy.typing import DTypeLike, NDArray
+from numpy.typing import ArrayLike, DTypeLike, NDArray
 from typing import (
     Any,
     Callable,
+    Deque,
     Dict,
     Iterable,
     List,
+    NamedTuple,
     Optional,
     Set,
     Tuple,
@@ -42,9 +51,11 @@ class PipelineStage(ABC):
     """
     Base class for pipeline stages.
 
-    Handles double buffering of configuration, allowing the CPU to update one
-    configuration while the other is still in use by the GPU, prevents the GPU
-    in the best case from waiting on the CPU, thus boosting throughput.
+    Handles buffering of configuration, allowing the CPU to update one
+    configuration while the others are still in use by the GPU, prevents the GPU
+    in the best case from waiting on the CPU, thus boosting throughput. By
+    default, configurations are double buffered. More configurations allow the
+    CPU to run further ahead, which helps if the time to update them varies.
 
     UBOs can be defined by passing a dictionary mapping binding names to a
     ctypes structure describing it. It's field name are reflected, added to the
@@ -56,8 +67,14 @@ class PipelineStage(ABC):
     `setParam` can be passed by name in the `extras` set. They are most likely
     implemented as properties.
 
-    During creation of a `Pipeline` the method `run(i)` will be called for both
-    buffers only once each. It must return a list of commands that define the
+    Intermediate tensors only consumed by the next few stages can be declared
+    as transient via `declareTransient`. Instead of keeping them resident, the
+    `Pipeline` places transients whose lifetimes do not overlap into the same
+    memory and assigns them before calling `run(i)`, where they can be
+    retrieved via `getTransient`.
+
+    During creation of a `Pipeline` the method `run(i)` will be called for each
+    buffer only once. It must return a list of commands that define the
     function of the stage and will be used to create a pipeline subroutine that
     gets reused.
 
@@ -71,26 +88,36 @@ class PipelineStage(ABC):
     ----------
     params: {str: Structure}, default={}
         Dictionary of named ctype structure containing the stage's parameters.
-        Each structure will be allocated on the CPU side and twice on the GPU
-        for buffering. The latter can be bound in programs
+        Each structure will be allocated on the CPU side and once per
+        configuration on the GPU for buffering. The latter can be bound in
+        programs
     extra: {str}, default={}
         Set of extra parameter name, that can be set and retrieved using the
         stage api. Take precedence over parameters defined by structs. Should
         be be implemented in subclasses as properties.
+    nConfigs: int, default=2
+        Number of configurations to buffer. All stages of a pipeline must use
+        the same number.
     """
 
     name = "stage"
     """default stage name. Should be changed in subclasses."""
 
     def __init__(
-        self, params: Dict[str, Type[Structure]] = {}, extra: Set[str] = set()
+        self,
+        params: Dict[str, Type[Structure]] = {},
+        extra: Set[str] = set(),
+        *,
+        nConfigs: int = 2,
     ) -> None:
+        if nConfigs < 1:
+            raise ValueError("nConfigs must be at least one!")
         # create local configuration
         self._local = {name: param() for name, param in params.items()}
-        # create double buffered device config
+        # create buffered device config
         self._device = [
             {name: StructureTensor(param, True) for name, param in params.items()}
-            for _ in range(2)
+            for _ in range(nConfigs)
         ]
         # check tensors are mapped
         if any(
@@ -111,12 +138,57 @@ class PipelineStage(ABC):
         # collect all fields without private one (starts with "_")
         self._fields = frozenset(extra | self._params.keys())
         self._public = frozenset(f for f in self._fields if not f.startswith("_"))
+        # transient outputs: name -> (size, lastUse) and tensors per config
+        self._transients: Dict[str, Tuple[int, int]] = {}
+        self._transientTensors: List[Dict[str, Tensor]] = [{} for _ in range(nConfigs)]
 
     @property
     def fields(self) -> Set[str]:
         """Set of all public parameter names"""
         return self._public
 
+    @property
+    def nConfigs(self) -> int:
+        """Number of buffered configurations"""
+        return len(self._device)
+
+    @property
+    def transients(self) -> Dict[str, Tuple[int, int]]:
+        """
+        Transient outputs declared by this stage mapping their name to their
+        size in bytes and the number of following stages consuming them
+        """
+        return dict(self._transients)
+
+    def declareTransient(self, name: str, size: int, *, lastUse: int = 1) -> None:
+        """
+        Declares a transient output tensor of the given size in bytes, which
+        is produced by this stage and consumed by up to `lastUse` following
+        stages of the pipeline. Its content is undefined at the start of this
+        stage and it must not be used by any stage afterwards. Must be called
+        before the stage is added to a `Pipeline`.
+        """
+        if size <= 0:
+            raise ValueError("Transient outputs must have a positive size!")
+        if lastUse < 0:
+            raise ValueError("lastUse must not be negative!")
+        self._transients[name] = (size, lastUse)
+
+    def getTransient(self, name: str, i: int) -> Tensor:
+        """
+        Returns the transient output of the given name assigned to the i-th
+        configuration. Only available once the stage is part of a `Pipeline`.
+        """
+        if name not in self._transients:
+            raise ValueError(f"No transient output with name {name}")
+        if name not in self._transientTensors[i]:
+            raise RuntimeError("Transient outputs are only available inside a Pipeline!")
+        return self._transientTensors[i][name]
+
+    def _assignTransient(self, i: int, name: str, tensor: Tensor) -> None:
+        """Assigns the tensor of a transient output for the i-th configuration"""
+        self._transientTensors[i][name] = tensor
+
     def __dir__(self) -> Iterable[str]:
         return chain(super().__dir__(), self._public)
 
@@ -193,6 +265,53 @@ class PipelineStage(ABC):
         for name, struct in self._local.items():
             memmove(self._device[i][name].memory, addressof(struct), sizeof(struct))
 
+    def canPackParams(self, names: Iterable[str]) -> bool:
+        """
+        True, if the given parameters can be written via `packParams`, i.e. they
+        are all defined by structures and the stage does not compute private
+        parameters in `_finishParams`.
+        """
+        if type(self)._finishParams is not PipelineStage._finishParams:
+            return False
+        return all(name in self._params for name in names if name in self._fields)
+
+    def packParams(self, params: Dict[str, ArrayLike], count: int) -> Dict[str, NDArray]:
+        """
+        Packs the parameters of many tasks into arrays matching the layout of
+        the stage's configuration, one row per task, which can be written to
+        the device via `updatePacked`. Parameters not provided are taken from
+        the current local state. Unknown parameters are ignored.
+
+        Parameters
+        ----------
+        params: {str: ArrayLike}
+            Values of each parameter for all tasks
+        count: int
+            Number of tasks
+        """
+        packed = {}
+        for name, struct in self._local.items():
+            layout = dtype(type(struct))
+            local = (c_uint8 * sizeof(struct)).from_address(addressof(struct))
+            rows = repeat(frombuffer(local, layout), count)
+            for field in layout.names:
+                if field in params:
+                    rows[field] = params[field]
+            packed[name] = rows
+        return packed
+
+    def updatePacked(self, i: int, packed: Dict[str, NDArray], n: int) -> None:
+        """
+        Updates the i-th configuration stored on the device using the n-th row
+        of parameters packed via `packParams`. Does not alter the local state.
+        """
+        for name, rows in packed.items():
+            memmove(
+                self._device[i][name].memory,
+                rows.ctypes.data + n * rows.itemsize,
+                rows.itemsize,
+            )
+
     @abstractmethod
     def run(self, i: int) -> List[Command]:
         """
@@ -222,12 +341,16 @@ class SourceCodeMixin(PipelineStage):
     ----------
     params: {str: Structure}, default={}
         Dictionary of named ctype structure containing the stage's parameters.
-        Each structure will be allocated on the CPU side and twice on the GPU
-        for buffering. The latter can be bound in programs
+        Each structure will be allocated on the CPU side and once per
+        configuration on the GPU for buffering. The latter can be bound in
+        programs
     extra: {str}, default={}
         Set of extra parameter name, that can be set and retrieved using the
         stage api. Take precedence over parameters defined by structs. Should
         be be implemented in subclasses as properties.
+    nConfigs: int, default=2
+        Number of configurations to buffer. All stages of a pipeline must use
+        the same number.
 
     See Also
     --------
@@ -235,9 +358,13 @@ class SourceCodeMixin(PipelineStage):
     """
 
     def __init__(
-        self, params: Dict[str, type[Structure]] = {}, extra: Set[str] = set()
+        self,
+        params: Dict[str, type[Structure]] = {},
+        extra: Set[str] = set(),
+        *,
+        nConfigs: int = 2,
     ) -> None:
-        super().__init__(params, extra)
+        super().__init__(params, extra, nConfigs=nConfigs)
 
     @property
     @abstractmethod
@@ -258,6 +385,84 @@ class SourceCodeMixin(PipelineStage):
         return []
 
 
+class FusableStage(SourceCodeMixin):
+    """
+    Base class for mixin whose source code declares a composable GLSL function.
+    A `Pipeline` fuses consecutive fusable stages into a single kernel calling
+    their functions in order, passing intermediate values in registers instead
+    of writing them to global memory in between, e.g. sampling -> transform ->
+    accumulate.
+
+    The function gets called once per invocation with the signature
+    `outputType functionName(uint idx, inputType value)`, where the value
+    parameter is omitted if `inputType` is None and the return type is void if
+    `outputType` is None. The input type of each stage must match the output
+    type of the previous one. The first stage of each fused group defines the
+    number of invocations via `workSize`.
+
+    Parameters are bound to the fused kernel via `bindParams`. Names of
+    functions, bindings and other globals must therefore be unique across the
+    fused stages.
+
+    Parameters
+    ----------
+    params: {str: Structure}, default={}
+        Dictionary of named ctype structure containing the stage's parameters.
+        Each structure will be allocated on the CPU side and once per
+        configuration on the GPU for buffering. The latter can be bound in
+        programs
+    extra: {str}, default={}
+        Set of extra parameter name, that can be set and retrieved using the
+        stage api. Take precedence over parameters defined by structs. Should
+        be be implemented in subclasses as properties.
+    nConfigs: int, default=2
+        Number of configurations to buffer. All stages of a pipeline must use
+        the same number.
+
+    See Also
+    --------
+    SourceCodeMixin, fuseStageSource
+    """
+
+    def __init__(
+        self,
+        params: Dict[str, type[Structure]] = {},
+        extra: Set[str] = set(),
+        *,
+        nConfigs: int = 2,
+    ) -> None:
+        super().__init__(params, extra, nConfigs=nConfigs)
+
+    @property
+    @abstractmethod
+    def functionName(self) -> str:
+        """Name of the GLSL function declared in the source code"""
+        pass
+
+    @property
+    def inputType(self) -> Optional[str]:
+        """GLSL type of the value passed from the previous stage, if any"""
+        return None
+
+    @property
+    def outputType(self) -> Optional[str]:
+        """GLSL type of the value passed to the next stage, if any"""
+        return None
+
+    @property
+    def workSize(self) -> Optional[int]:
+        """
+        Number of invocations to run if this is the first stage of a fused
+        group. May be None otherwise.
+        """
+        return None
+
+    @property
+    def extensions(self) -> Set[str]:
+        """Set of GLSL extensions the source code requires"""
+        return set()
+
+
 class RetrieveTensorStage(PipelineStage):
     """
     Utility stage retrieving a tensor to a local buffer.
@@ -266,11 +471,11 @@ class RetrieveTensorStage(PipelineStage):
 
     name = "retrieve"
 
-    def __init__(self, src: Tensor) -> None:
-        super().__init__({})
+    def __init__(self, src: Tensor, *, nConfigs: int = 2) -> None:
+        super().__init__({}, nConfigs=nConfigs)
         self._src = src
         # create local buffers
-        self._buffers = [RawBuffer(src.size_bytes) for _ in range(2)]
+        self._buffers = [RawBuffer(src.size_bytes) for _ in range(nConfigs)]
         # create byte array to mimic std::span<std::byte>
         span = c_uint8 * src.size_bytes
         self._data = [span.from_address(buf.address) for buf in self._buffers]
@@ -308,11 +513,11 @@ class UpdateTensorStage(PipelineStage):
 
     name = "update"
 
-    def __init__(self, dst: Tensor) -> None:
-        super().__init__({})
+    def __init__(self, dst: Tensor, *, nConfigs: int = 2) -> None:
+        super().__init__({}, nConfigs=nConfigs)
         self._dst = dst
         # create local buffers
-        self._buffers = [RawBuffer(dst.size_bytes) for _ in range(2)]
+        self._buffers = [RawBuffer(dst.size_bytes) for _ in range(nConfigs)]
         # create byte array to mimic std::span<std::byte>
         span = c_uint8 * dst.size_bytes
         self._data = [span.from_address(buf.address) for buf in self._buffers]
@@ -338,6 +543,79 @@ class UpdateTensorStage(PipelineStage):
         return [updateTensor(self._buffers[i], self._dst)]
 
 
+FUSED_LOCAL_SIZE = 32
+"""Workgroup size of kernels generated from fused stages"""
+
+# compiled fused kernels keyed by their source code
+_fusedCodeCache: Dict[str, bytes] = {}
+_fusedCodeLock = Lock()
+
+
+def fuseStageSource(stages: List[FusableStage]) -> str:
+    """
+    Generates the source code of a single kernel running the given fusable
+    stages in order, passing the output of each stage's function as input to
+    the next one.
+    """
+    if not stages:
+        raise ValueError("Cannot fuse an empty list of stages!")
+    workSize = stages[0].workSize
+    if workSize is None:
+        raise ValueError(f'First fused stage "{stages[0].name}" must define a workSize!')
+    # check types are compatible
+    valueType = None
+    for stage in stages:
+        if stage.inputType != valueType:
+            raise ValueError(
+                f'Stage "{stage.name}" expects {stage.inputType} as input, '
+                f"but the previous stage produces {valueType}!"
+            )
+        valueType = stage.outputType
+
+    # assemble code
+    extensions = sorted(set().union(*(stage.extensions for stage in stages)))
+    lines = ["#version 460"]
+    lines += [f"#extension {ext} : require" for ext in extensions]
+    lines.append(f"layout(local_size_x = {FUSED_LOCAL_SIZE}) in;")
+    for stage in stages:
+        lines += ["", f"// stage: {stage.name}", stage.sourceCode]
+    lines += ["", "void main() {", "    uint idx = gl_GlobalInvocationID.x;"]
+    lines.append(f"    if (idx >= {workSize}u) return;")
+    for n, stage in enumerate(stages):
+        args = "idx" if stage.inputType is None else f"idx, value{n - 1}"
+        call = f"{stage.functionName}({args});"
+        if stage.outputType is None:
+            lines.append(f"    {call}")
+        else:
+            lines.append(f"    {stage.outputType} value{n} = {call}")
+    lines.append("}")
+    return "\n".join(lines) + "\n"
+
+
+def _compileFused(code: str) -> bytes:
+    """Compiles the fused source code, reusing previous results"""
+    with _fusedCodeLock:
+        if code not in _fusedCodeCache:
+            _fusedCodeCache[code] = Compiler().compile(code)
+        return _fusedCodeCache[code]
+
+
+class _FusedKernel:
+    """Single kernel running a group of consecutive fusable stages"""
+
+    def __init__(self, stages: List[FusableStage]) -> None:
+        self.stages = stages
+        self.source = fuseStageSource(stages)
+        self.program = Program(_compileFused(self.source))
+        workSize = stages[0].workSize
+        self.groups = (workSize + FUSED_LOCAL_SIZE - 1) // FUSED_LOCAL_SIZE
+
+    def run(self, i: int) -> List[Command]:
+        for stage in self.stages:
+            stage.bindParams(self.program, i)
+        return [self.program.dispatch(self.groups)]
+
+
 class Pipeline:
     """
     Pipelines contain a sequence of named pipeline stages, manages their states
@@ -351,6 +629,22 @@ class Pipeline:
     "{stage_name}__{parameter]" to change the parameter in a specific stage or
     just "parameter" to apply the change to all stages with that property.
 
+    Consecutive `FusableStage` are fused into a single kernel, whose compiled
+    code gets cached and reused by other pipelines fusing the same stages.
+
+    Transient outputs declared by the stages are allocated once per
+    configuration, where transients whose lifetimes do not overlap share the
+    same memory. Stages are then separated by memory barriers, as they
+    otherwise could run concurrently on the aliased memory. The memory saved
+    this way is reported by `transientMemory`.
+
+    If profile is True, each kernel, i.e. each stage or group of fused stages,
+    is bracketed by a pair of timestamps, whose durations are reported by
+    `stageTimes` averaged over the last profileWindow runs. Stages are then
+    separated by memory barriers as well, so the timestamps do not overlap.
+    The results of a run are collected once its configuration gets updated
+    again or the profile is queried.
+
     Parameters
     ----------
     stages: (PipelineStage | (name, PipelineStage))[]
@@ -358,13 +652,26 @@ class Pipeline:
         specify a name used for updating properties. If no name is provided
         (i.e. not a tuple), it get the name "stage{i}" where i is the stage's
         position in the pipeline
+    profile: bool, default=False
+        Whether to measure the time each stage takes on the GPU
+    profileWindow: int, default=100
+        Amount of most recent runs the reported times are averaged over
     """
 
     def __init__(
-        self, stages: List[Union[PipelineStage, Tuple[str, PipelineStage]]]
+        self,
+        stages: List[Union[PipelineStage, Tuple[str, PipelineStage]]],
+        *,
+        profile: bool = False,
+        profileWindow: int = 100,
     ) -> None:
         # create stage list and dict
         stages = [s if isinstance(s, tuple) else (s.name, s) for s in stages]
+        # all stages must agree on the number of configurations
+        nConfigs = {stage.nConfigs for _, stage in stages}
+        if len(nConfigs) > 1:
+            raise ValueError("All stages must have the same number of configurations!")
+        self._nConfigs = nConfigs.pop() if nConfigs else 2
         self._stageList = []  # for ordering
         self._stageDict = {}  # for lookup
         name_counter = {}
@@ -379,21 +686,214 @@ class Pipeline:
             self._stageList.append((name, stage))
             self._stageDict[name] = stage
 
+        # fuse consecutive fusable stages into a single kernel each
+        self._runners: List[Union[PipelineStage, _FusedKernel]] = []
+        self._runnerNames: List[str] = []
+        group: List[FusableStage] = []
+        groupNames: List[str] = []
+        for name, stage in self._stageList:
+            if isinstance(stage, FusableStage):
+                group.append(stage)
+                groupNames.append(name)
+                continue
+            if group:
+                self._runners.append(_FusedKernel(group))
+                self._runnerNames.append("+".join(groupNames))
+                group, groupNames = [], []
+            self._runners.append(stage)
+            self._runnerNames.append(name)
+        if group:
+            self._runners.append(_FusedKernel(group))
+            self._runnerNames.append("+".join(groupNames))
+
+        # plan transients before stages create their commands
+        self._allocators = self._allocateTransients()
+
+        # one stop watch per kernel and configuration
+        self._profile = profile
+        if profile:
+            self._stopWatches = [
+                [StopWatch() for _ in self._runners] for _ in range(self._nConfigs)
+            ]
+            self._stageTimes = [deque(maxlen=profileWindow) for _ in self._runners]
+            self._queueWaits = deque(maxlen=profileWindow)
+            # configurations submitted but not yet collected
+            self._pending = [False] * self._nConfigs
+            self._readyTimes = [None] * self._nConfigs
+            self._profileLock = Lock()
+
         # create subroutines
         self._subroutines = [
-            createSubroutine(
-                list(chain.from_iterable(stage.run(i) for _, stage in self._stageList)),
-                simultaneous=True,
-            )
-            for i in range(2)
+            createSubroutine(self._recordRunners(i), simultaneous=True)
+            for i in range(self._nConfigs)
         ]
 
+    def _allocateTransients(self) -> List[ScratchAllocator]:
+        """
+        Declares the transient outputs of all stages using the runner index as
+        step and assigns the allocated tensors to the stages
+        """
+        # map each stage onto the runner it runs in
+        steps = []
+        for n, runner in enumerate(self._runners):
+            stages = runner.stages if isinstance(runner, _FusedKernel) else [runner]
+            steps += [n] * len(stages)
+        stages = [stage for _, stage in self._stageList]
+        declarations = [
+            (stage, name, size, steps[k], steps[min(k + lastUse, len(stages) - 1)])
+            for k, stage in enumerate(stages)
+            for name, (size, lastUse) in stage.transients.items()
+        ]
+        if not declarations:
+            return []
+
+        # configurations may run concurrently -> one allocator each
+        allocators = []
+        for i in range(self._nConfigs):
+            allocator = ScratchAllocator()
+            ids = [
+                allocator.declare(size, first, last)
+                for _, _, size, first, last in declarations
+            ]
+            allocator.allocate()
+            for (stage, name, *_), handle in zip(declarations, ids):
+                stage._assignTransient(i, name, allocator.get(handle))
+            allocators.append(allocator)
+        return allocators
+
+    def _recordRunners(self, i: int) -> List[Command]:
+        """Creates the commands of all runners using the i-th configuration"""
+        if not self._allocators and not self._profile:
+            return list(chain.from_iterable(runner.run(i) for runner in self._runners))
+        # aliased memory and timestamps require the runners to not overlap
+        commands = []
+        for n, runner in enumerate(self._runners):
+            if n > 0:
+                commands.append(flushMemory())
+            if self._profile:
+                commands.append(self._stopWatches[i][n].start())
+            commands += runner.run(i)
+            if self._profile:
+                commands.append(self._stopWatches[i][n].stop())
+        return commands
+
+    def _collectTimings(self, i: int) -> bool:
+        """
+        Adds the timings of the last run using the i-th configuration to the
+        profile if all are available. Must hold the profile lock.
+        """
+        watches = self._stopWatches[i]
+        times = [watch.getElapsedTime() for watch in watches]
+        if any(isnan(t) for t in times):
+            return False
+        for t, window in zip(times, self._stageTimes):
+            window.append(t)
+        ready = self._readyTimes[i]
+        if ready is not None:
+            start = watches[0].getStartTime()
+            if not isnan(start):
+                self._queueWaits.append(max(start - ready, 0.0))
+        return True
+
+    def _beginProfile(self, i: int) -> None:
+        """
+        Collects the previous run of the i-th configuration and prepares its
+        timestamps for the next one. The configuration must not be in use.
+        """
+        if not self._profile:
+            return
+        with self._profileLock:
+            if self._pending[i]:
+                self._collectTimings(i)
+            for watch in self._stopWatches[i]:
+                watch.reset()
+            self._pending[i] = True
+            self._readyTimes[i] = None
+
+    def _markReady(self, i: int) -> None:
+        """Notes the host time the i-th configuration was ready to be run"""
+        if self._profile:
+            self._readyTimes[i] = perf_counter_ns()
+
+    def _collectProfile(self) -> None:
+        """Collects all finished runs not yet in the profile"""
+        with self._profileLock:
+            for i, pending in enumerate(self._pending):
+                if pending and self._collectTimings(i):
+                    self._pending[i] = False
+
+    @property
+    def transientMemory(self) -> Tuple[int, int]:
+        """
+        Memory used by the transient outputs of all configurations in bytes as
+        tuple of (without aliasing, with aliasing), i.e. the peak memory before
+        and after planning.
+        """
+        return (
+            sum(a.declared_bytes for a in self._allocators),
+            sum(a.size_bytes for a in self._allocators),
+        )
+
+    @property
+    def nConfigs(self) -> int:
+        """Number of buffered configurations"""
+        return self._nConfigs
+
     @property
     def stages(self) -> List[Tuple[str, PipelineStage]]:
         """Sequence of named pipeline stages."""
         # create copy to be safe
         return list(self._stageList)
 
+    @property
+    def profiling(self) -> bool:
+        """True, if the pipeline measures the time of each stage"""
+        return self._profile
+
+    @property
+    def stageTimes(self) -> Dict[str, float]:
+        """
+        Mean time in nanoseconds each kernel took on the GPU over the recent
+        runs. Fused stages are reported as a single kernel named after its
+        stages joined by '+'. NaN if no run finished yet. Empty if the pipeline
+        is not profiling.
+        """
+        if not self._profile:
+            return {}
+        self._collectProfile()
+        return {
+            name: sum(window) / len(window) if window else nan
+            for name, window in zip(self._runnerNames, self._stageTimes)
+        }
+
+    @property
+    def queueWaitTime(self) -> float:
+        """
+        Mean time in nanoseconds runs waited between their configuration being
+        updated and the GPU starting it over the recent runs. NaN if not
+        profiling or no run finished yet.
+        """
+        if not self._profile:
+            return nan
+        self._collectProfile()
+        waits = self._queueWaits
+        return sum(waits) / len(waits) if waits else nan
+
+    def resetProfile(self) -> None:
+        """Clears the measured times"""
+        if not self._profile:
+            return
+        self._collectProfile()
+        with self._profileLock:
+            for window in self._stageTimes:
+                window.clear()
+            self._queueWaits.clear()
+
+    @property
+    def fusedSources(self) -> List[str]:
+        """Generated source code of each kernel fusing consecutive stages"""
+        return [r.source for r in self._runners if isinstance(r, _FusedKernel)]
+
     def getSubroutine(self, i: int) -> Subroutine:
         """
         Returns the subroutine responsible for running the pipeline using
@@ -428,6 +928,15 @@ class Pipeline:
                 for _, stage in self._stageList:
                     stage.setParam(name, value)
 
+    def packParams(self, params: Union[NDArray, Dict[str, ArrayLike]]) -> PackedParams:
+        """
+        Packs the parameters of many tasks at once. Expects either a numpy
+        structured array with one row per task or a dictionary mapping the
+        parameter names to a sequence of values, one per task. Names are
+        resolved the same way as in `setParams`.
+        """
+        return PackedParams(self, params)
+
     def update(self, i: int) -> None:
         """
         Updates the i-th configuration of all stages using their current
@@ -445,8 +954,10 @@ class Pipeline:
         running the pipeline. Note that this does not check if the configuration
         is currently in use and results in undefined behavior if so.
         """
+        self._beginProfile(i)
         if update:
             self.update(i)
+        self._markReady(i)
         return beginSequence().And(self.getSubroutine(i)).Submit()
 
     def run(self, i: int, *, update: bool = True) -> None:
@@ -460,6 +971,71 @@ class Pipeline:
         self.runAsync(i, update=update).wait()
 
 
+class PackedParams:
+    """
+    Parameters of many tasks packed into arrays matching the layout of each
+    stage's configuration. Created via `Pipeline.packParams`. Applying a task
+    writes each structure of a stage with a single copy instead of setting the
+    parameters one by one.
+
+    Stages computing private parameters in `_finishParams` or tasks setting
+    their extra parameters fall back to setting the parameters per task.
+    Parameters not provided are taken from the stages' local state at the time
+    of packing. Unlike `Pipeline.setParams`, packed stages' local state is not
+    altered.
+    """
+
+    def __init__(
+        self,
+        pipeline: Pipeline,
+        params: Union[NDArray, Dict[str, ArrayLike]],
+    ) -> None:
+        # normalize to columns
+        if isinstance(params, ndarray):
+            columns = {name: params[name] for name in params.dtype.names}
+        else:
+            columns = {name: asarray(value) for name, value in params.items()}
+        counts = {len(column) for column in columns.values()}
+        if len(counts) > 1:
+            raise ValueError("All parameters must have the same number of tasks!")
+        self._count = counts.pop() if counts else 0
+        # assign columns to stages
+        stages = pipeline.stages
+        stageDict = dict(stages)
+        perStage: Dict[str, Dict[str, NDArray]] = {name: {} for name, _ in stages}
+        for name, column in columns.items():
+            if "__" in name:
+                stage, param = name.split("__", 1)
+                if stage not in stageDict:
+                    warnings.warn(f'There is no stage "{stage}" in this pipeline!')
+                    continue
+                perStage[stage][param] = column
+            else:
+                for stageName, stage in stages:
+                    if name in stage._fields:
+                        perStage[stageName][name] = column
+        # pack what we can
+        self._packed = []
+        self._unpacked = []
+        for name, stage in stages:
+            stageParams = perStage[name]
+            if stage.canPackParams(stageParams):
+                self._packed.append((stage, stage.packParams(stageParams, self._count)))
+            else:
+                self._unpacked.append((stage, stageParams))
+
+    def __len__(self) -> int:
+        return self._count
+
+    def update(self, i: int, n: int) -> None:
+        """Updates the i-th configuration using the parameters of the n-th task"""
+        for stage, packed in self._packed:
+            stage.updatePacked(i, packed, n)
+        for stage, params in self._unpacked:
+            stage.setParams(**{name: column[n].tolist() for name, column in params.items()})
+            stage.update(i)
+
+
 def runPipeline(
     stages: Iterable[PipelineStage], i: int = 0, *, update: bool = True
 ) -> None:
@@ -480,62 +1056,66 @@ def runPipeline(
     ).Submit().wait()
 
 
-class _CounterWorkerThread:
+def streamPipeline(
+    executor: StreamExecutor,
+    pipeline: Pipeline,
+    source: Callable[[memoryview, int], int],
+    sink: Callable[[memoryview, int], None],
+) -> int:
     """
-    Util class for worker threads used by the scheduler. Runs a function as many
-    times as specified, while allowing to increase this value. If it is reached
-    it suspends the thread ready to run more loops.
+    Streams chunks from source through the pipeline into sink using the given
+    executor. The i-th configuration of the pipeline processes the chunks in the
+    executor's i-th slot, i.e. its stages are expected to use the tensors
+    returned by `executor.getInput(i)`, `executor.getOutput(i)` and
+    `executor.getCount(i)` in their i-th configuration. Updates the
+    configurations using the stages' current state before streaming. Profiling
+    pipelines are not supported, as the executor reuses configurations without
+    giving the chance to collect their timings.
+
+    Parameters
+    ----------
+    executor: StreamExecutor
+        Executor providing the slots and running the chunks
+    pipeline: Pipeline
+        Pipeline with at least as many configurations as the executor has slots
+    source: Callable( (chunk: memoryview, index: int) -> int )
+        Function filling the memory of the next chunk and returning the amount
+        of items written. Returning zero ends the stream.
+    sink: Callable( (chunk: memoryview, index: int) -> None )
+        Function called in order with the output of each finished chunk. The
+        memory is only valid during the call.
+
+    Returns
+    -------
+    nChunks: int
+        Number of chunks processed
     """
+    nSlots = executor.slotCount
+    if pipeline.profiling:
+        raise ValueError("Profiling pipelines can not be streamed!")
+    if pipeline.nConfigs < nSlots:
+        raise ValueError(
+            f"Pipeline requires at least {nSlots} configurations, one per slot!"
+        )
+    for i in range(nSlots):
+        pipeline.update(i)
+    return executor.run(
+        [pipeline.getSubroutine(i) for i in range(nSlots)], source, sink
+    )
 
-    def __init__(self, fn: Callable[[int], None]) -> None:
-        self._thread = Thread(target=self._loop, daemon=True)
-        self._isSuspending = True
-        self._suspendLock = Lock()
-        self._wakeEvent = Event()
-        self._counter = 0
-        self._target = 0
-        self._fn = fn
-        # start thread
-        self._thread.start()
 
-    @property
-    def count(self) -> int:
-        """Number of finished iterations"""
-        return self._counter
+class PipelineProfile(NamedTuple):
+    """Recent timings of tasks scheduled by a `PipelineScheduler`"""
 
-    @property
-    def total(self) -> int:
-        """Total number of issued iterations"""
-        return self._target
-
-    def run(self, n: int) -> None:
-        """Increases the loop target"""
-        self._target += n
-        # check if we need to wake
-        with self._suspendLock:
-            if self._isSuspending:
-                self._wakeEvent.set()
-
-    def _loop(self) -> None:
-        """Thread body"""
-        # infinite loop -> must run inside a daemon thread
-        while True:
-            # suspend if necessary
-            if self._isSuspending:
-                self._wakeEvent.wait()
-                # resume work
-                self._wakeEvent.clear()
-                self._isSuspending = False
-            # quick and unsafe check
-            if self._counter >= self._target:
-                # might want to suspend -> check again, but safe
-                with self._suspendLock:
-                    if self._counter >= self._target:
-                        self._isSuspending = True
-                        continue
-            # run function
-            self._fn(self._counter)
-            self._counter += 1
+    stageTimes: Dict[str, float]
+    """Mean GPU time per kernel in nanoseconds. See `Pipeline.stageTimes`."""
+    updateTime: float
+    """Mean host time spent updating a task's configuration in nanoseconds"""
+    queueWaitTime: float
+    """
+    Mean time in nanoseconds tasks waited between their update and the GPU
+    starting them. See `Pipeline.queueWaitTime`.
+    """
 
 
 class PipelineScheduler:
@@ -551,8 +1131,10 @@ class PipelineScheduler:
 
     New tasks can be issued while previous ones are still processed.
 
-    The scheduler requires exclusive access to two configurations, but may
-    otherwise share the pipeline.
+    Tasks rotate through all of the pipeline's configurations. With more than
+    two, the update of upcoming tasks can run multiple tasks ahead of the GPU.
+    The scheduler requires exclusive access to all configurations, but may
+    otherwise share the pipeline. At least two configurations are required.
 
     Parameters
     ----------
@@ -566,6 +1148,9 @@ class PipelineScheduler:
         count processed, i.e. 0 for the first task, 1 for the second and so on.
         The scheduler ensures tasks using the same configuration to wait until
         processing finished. Will run in its own thread.
+    profileWindow: int, default=100
+        Amount of most recent tasks the host update time reported by `profile`
+        is averaged over. GPU times require the pipeline to be profiling.
     """
 
     def __init__(
@@ -574,24 +1159,21 @@ class PipelineScheduler:
         *,
         queueSize: int = 0,
         processFn: Optional[Callable[[int, int], None]] = None,
+        profileWindow: int = 100,
     ) -> None:
-        # save params
-        self._queueSize = queueSize
-        self._totalTasks = 0
         self._pipeline = pipeline
-        self._pipelineTimeline = Timeline()
-        # create queue worker
-        self._updateTimeline = Timeline()
-        self._updateWorker = _CounterWorkerThread(self._update)
-        self._updateQueue = Queue()
-        # create process worker if needed
-        self._processFn = processFn
-        if processFn is None:
-            self._processWorker = None
-            self._processTimeline = None
-        else:
-            self._processWorker = _CounterWorkerThread(self._process)
-            self._processTimeline = Timeline()
+        self._updateTimes: Deque[int] = deque(maxlen=profileWindow)
+        # tasks waiting on their update, either a dict of params or a row of
+        # packed params; only the native update thread pops
+        self._tasks: Deque[Any] = deque()
+        # bookkeeping and threads run natively; only the callbacks need the GIL
+        # callbacks must not reference self to prevent a reference cycle
+        self._scheduler = TaskScheduler(
+            [pipeline.getSubroutine(i) for i in range(pipeline.nConfigs)],
+            _makeUpdateFn(pipeline, self._tasks, self._updateTimes),
+            None if processFn is None else _makeProcessFn(processFn),
+            queueSize=queueSize,
+        )
 
     @property
     def pipeline(self) -> Pipeline:
@@ -604,25 +1186,41 @@ class PipelineScheduler:
         Capacity of the internal queue used for scheduling tasks.
         A value of zero means infinite.
         """
-        return self._queueSize
+        return self._scheduler.queueSize
+
+    @property
+    def profile(self) -> PipelineProfile:
+        """
+        Recent per stage GPU time, host update time and queue wait time of the
+        scheduled tasks in nanoseconds. GPU and queue wait times are only
+        available if the pipeline is profiling.
+        """
+        times = list(self._updateTimes)
+        return PipelineProfile(
+            self._pipeline.stageTimes,
+            sum(times) / len(times) if times else nan,
+            self._pipeline.queueWaitTime,
+        )
+
+    def resetProfile(self) -> None:
+        """Clears the measured times including the ones of the pipeline"""
+        self._updateTimes.clear()
+        self._pipeline.resetProfile()
 
     @property
     def totalTasks(self) -> int:
         """Total number of tasks scheduled"""
-        return self._totalTasks
+        return self._scheduler.totalTasks
 
     @property
     def tasksScheduled(self) -> int:
         """Approximate number of tasks scheduled"""
-        return self._updateQueue.qsize()
+        return self._scheduler.pendingTasks
 
     @property
     def tasksFinished(self) -> int:
         """Returns the number of finished tasks processed by the timeline"""
-        if self._processWorker is None:
-            return self._pipelineTimeline.value
-        else:
-            return self._processWorker.count
+        return self._scheduler.finishedTasks
 
     def schedule(
         self, tasks: Iterable[Dict[str, Any]], *, timeout: Optional[float] = None
@@ -650,53 +1248,57 @@ class PipelineScheduler:
             `submission.finalStep`.
             None if nSubmitted == 0.
         """
-        # put task onto queue
-        n = 0
-        builder = None
-        for task in tasks:
-            # try to enlist in queue
-            try:
-                self._updateQueue.put(task, timeout=timeout)
-            except:
-                break
-
-            # lazy create builder
-            if builder is None:
-                builder = beginSequence(self._pipelineTimeline, self._totalTasks)
-
-            # issue wait on previous task
-            builder.WaitFor(self._pipelineTimeline, self._totalTasks)
-            # issue wait on update thread
-            builder.WaitFor(self._updateTimeline, self._totalTasks + 1)
-            # issue wait on process thread is present
-            if self._processTimeline is not None and self._totalTasks >= 2:
-                # double buffered -> wait for the processing of tasks scheduled
-                # two earlier to finish to make sure we don't overwrite the
-                # result it tries to process
-                builder.WaitFor(self._processTimeline, self._totalTasks - 1)
-            # run task
-            i = self._totalTasks % 2
-            builder.And(self._pipeline.getSubroutine(i))
-
-            # update counters
-            n += 1
-            self._totalTasks += 1
-
-        # enqueued anything?
-        if n == 0:
-            return (0, None)
+        return self._enqueue(list(tasks), timeout)
 
-        # submit work
-        submission = builder.Submit()
-        # just to ensure we're not breaking stuff in the future
-        assert submission.forgettable
+    def schedulePacked(
+        self,
+        params: Union[PackedParams, NDArray, Dict[str, ArrayLike]],
+        *,
+        timeout: Optional[float] = None,
+    ) -> Tuple[int, Submission]:
+        """
+        Schedules a batch of tasks whose parameters are given all at once.
+        Faster than `schedule` for many tasks or parameters, as the parameters
+        are packed into the layout of the stages' configurations upfront and
+        each task's update only copies them to the device.
 
-        # update worker threads
-        self._updateWorker.run(n)
-        if self._processWorker is not None:
-            self._processWorker.run(n)
+        Parameters
+        ----------
+        params: PackedParams | NDArray | Dict[str, ArrayLike]
+            Parameters of all tasks either already packed via
+            `Pipeline.packParams`, or as numpy structured array or dictionary
+            mapping parameter names to one value per task. See
+            `Pipeline.packParams` for details.
+        timeout: float | None, default=None
+            Timeout in seconds for waiting on free space in the queue.
+            If None, waits indefinitely.
+
+        Returns
+        -------
+        nSubmitted: int
+            Number of tasks actually submitted, i.e. the first nSubmitted rows
+            of params.
+        submission: Submission | None
+            The submission created for submitting work to the GPU.
+            None if nSubmitted == 0.
+        """
+        if not isinstance(params, PackedParams):
+            params = self._pipeline.packParams(params)
+        return self._enqueue([(params, n) for n in range(len(params))], timeout)
 
-        # return result
+    def _enqueue(self, tasks: List[Any], timeout: Optional[float]) -> Tuple[int, Submission]:
+        """Enlists the given tasks and schedules them"""
+        if not tasks:
+            return (0, None)
+        # enlist tasks before scheduling, as the update thread may start
+        # consuming them right away
+        self._tasks.extend(tasks)
+        if timeout is not None:
+            timeout = int(timeout * 1e9)
+        n, submission = self._scheduler.schedule(len(tasks), timeout=timeout)
+        # drop tasks that did not fit into the queue
+        for _ in range(len(tasks) - n):
+            self._tasks.pop()
         return (n, submission)
 
     def wait(self, task: Optional[int] = None) -> None:
@@ -707,12 +1309,7 @@ class PipelineScheduler:
         Waiting on a task not scheduled may result in a deadlock if no further
         thread schedule tasks.
         """
-        if task is None:
-            task = self.totalTasks
-        if self._processTimeline is None:
-            self._pipelineTimeline.wait(task)
-        else:
-            self._processTimeline.wait(task)
+        self._scheduler.wait(task)
 
     def waitTimeout(self, task: Optional[int] = None, *, timeout: int = 1000) -> bool:
         """
@@ -732,42 +1329,49 @@ class PipelineScheduler:
         finished: bool
             True, if the given task finished.
         """
-        if task is None:
-            task = self.totalTasks
-        if self._processTimeline is None:
-            self._pipelineTimeline.waitTimeout(task, timeout)
-        else:
-            self._processTimeline.waitTimeout(task, timeout)
-
-    def _update(self, n: int) -> None:
-        """Internal update thread body"""
-        # fetch next task (don't need to block, as this is handled by the worker)
-        task: Optional[Dict[str, Any]] = self._updateQueue.get(block=False)
-        # update pipeline
-        self._pipeline.setParams(**task)
-        # wait for the i-th config to be safe to update
-        if n >= 2:
-            self._pipelineTimeline.wait(n - 1)
-        # update config
+        return self._scheduler.waitTimeout(task, timeout=timeout)
+
+
+def _makeUpdateFn(
+    pipeline: Pipeline, tasks: Deque[Any], updateTimes: Deque[int]
+) -> Callable[[int, int], None]:
+    """Creates the function preparing a task's config"""
+
+    def update(config: int, n: int) -> None:
+        # previous task using this config finished -> collect its timings
+        pipeline._beginProfile(config)
+        start = perf_counter_ns()
+        # fetch next task; the scheduler ensures there is one
+        task = tasks.popleft()
         # eventually calls user provided functions
         # -> treat as evil to prevent from deadlocking timeline
         try:
-            self._pipeline.update(n % 2)
+            if isinstance(task, tuple):
+                # row of packed params
+                packed, row = task
+                packed.update(config, row)
+            else:
+                pipeline.setParams(**task)
+                pipeline.update(config)
         except Exception as ex:
             warnings.warn(f"Exception raised while preparing task {n}:\n{ex}")
-        # advance timeline
-        self._updateTimeline.value = n + 1
-
-    def _process(self, n: int) -> None:
-        """Internal process thread body"""
-        # wait on task to finish
-        self._pipelineTimeline.wait(n + 1)
-        # process
+        updateTimes.append(perf_counter_ns() - start)
+        pipeline._markReady(config)
+
+    return update
+
+
+def _makeProcessFn(
+    processFn: Callable[[int, int], None],
+) -> Callable[[int, int], None]:
+    """Wraps the user provided process function"""
+
+    def process(config: int, n: int) -> None:
         # external provided function
         # -> treat as evil to prevent from deadlocking timeline
         try:
-            self._processFn(n % 2, n)
+            processFn(config, n)
         except Exception as ex:
             warnings.warn(f"Exception raised while processing task {n}:\n{ex}")
-        # advance timeline
-        self._processTimeline.value = n + 1
+
+    return process
@@ -1,8 +1,11 @@
-from typing import Callable, Iterable, Literal, Optional, overload
+from typing import Awaitable, Callable, Iterable, Literal, Optional, overload
 
 import hephaistos.pyhephaistos
 import numpy.typing
 import os
+import pathlib
+
+ASTC_4x4_UNORM: ImageFormat
 
 class AccelerationStructure:
     """
@@ -16,26 +19,229 @@ class AccelerationStructure:
     """
 
     def __init__(
-        self, instances: hephaistos.pyhephaistos.GeometryInstanceVector
+        self,
+        instances: hephaistos.pyhephaistos.GeometryInstanceVector,
+        options: hephaistos.pyhephaistos.BuildOptions = BuildOptions(),
     ) -> None:
         """
         Creates an acceleration structure for consumption in shaders from the
         given geometry instances.
         """
         ...
+    @overload
+    def __init__(
+        self,
+        maxInstances: int,
+        options: hephaistos.pyhephaistos.BuildOptions = BuildOptions(),
+    ) -> None:
+        """
+        Creates an empty acceleration structure to be built on the device from
+        up to maxInstances instances. If options.allowUpdate is True, it can
+        also be updated instead of rebuilt.
+        """
+        ...
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
+    ) -> None:
+        """
+        Binds the acceleration structure to the program or parameter set at
+        the given binding
+        """
+        ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
+    ) -> None:
+        """
+        Binds the acceleration structure to the program or parameter set at
+        the given binding
+        """
+        ...
+    @property
+    def maxInstances(self) -> int:
+        """
+        Maximum number of instances the acceleration structure can be built from
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        Size of the acceleration structure in bytes
+        """
+        ...
+
+class AllocationHints:
+    """
+    Hints for allocating memory of tensors and images
+    """
+
+    def __init__(
+        self,
+        priority: float = 0.5,
+        placement: hephaistos.pyhephaistos.MemoryPlacement = MemoryPlacement.AUTO,
+        dedicated: bool = False,
+    ) -> None: ...
+    @property
+    def dedicated(self) -> bool:
+        """
+        If True, the allocation gets its own memory block
+        """
+        ...
+    @dedicated.setter
+    def dedicated(self, arg: bool, /) -> None:
+        """
+        If True, the allocation gets its own memory block
+        """
+        ...
+    @property
+    def placement(self) -> hephaistos.pyhephaistos.MemoryPlacement:
+        """
+        Preferred placement of the memory
+        """
+        ...
+    @placement.setter
+    def placement(self, arg: hephaistos.pyhephaistos.MemoryPlacement, /) -> None:
+        """
+        Preferred placement of the memory
+        """
+        ...
+    @property
+    def priority(self) -> float:
+        """
+        Priority in the range [0,1] of keeping the memory resident. Allocations
+        with a lower priority get paged out first if the device runs out of
+        memory. Only has an effect if isMemoryPrioritySupported() returns True.
+        """
+        ...
+    @priority.setter
+    def priority(self, arg: float, /) -> None:
+        """
+        Priority in the range [0,1] of keeping the memory resident. Allocations
+        with a lower priority get paged out first if the device runs out of
+        memory. Only has an effect if isMemoryPrioritySupported() returns True.
+        """
+        ...
+
+class ArgumentBlock:
+    """
+    Builder for uniform blocks of tensor addresses and scalars used with
+    buffer_reference. Values are appended in order using the scalar block
+    layout, i.e. aligned to the size of their components, matching blocks
+    declared with layout(scalar). commit() uploads the block into the next slot
+    of a uniform ring bound by subsequent calls to bindParameter, thus the block
+    can be rebuilt while previous dispatches still use theirs. Appended tensors
+    are kept alive as long as the block.
+
+    Parameters
+    ----------
+    blockSize: int
+        Maximum size of a block in bytes
+    capacity: int, default=64
+        Amount of blocks in the ring. Must exceed the amount of blocks used by
+        pending work.
+    """
+
+    def __init__(self, blockSize: int, capacity: int = 64) -> None: ...
+    @overload
+    def addAddress(
+        self, tensor: hephaistos.pyhephaistos.Tensor
+    ) -> hephaistos.pyhephaistos.ArgumentBlock:
+        """
+        Appends the device address of the given tensor
+        """
+        ...
+    @overload
+    def addAddress(
+        self, view: hephaistos.pyhephaistos.TensorView
+    ) -> hephaistos.pyhephaistos.ArgumentBlock:
+        """
+        Appends the device address of the start of the given view
+        """
+        ...
+    def addBytes(
+        self, data: bytes, alignment: int = 4
+    ) -> hephaistos.pyhephaistos.ArgumentBlock:
+        """
+        Appends raw data, e.g. a vector or ctypes structure, with the given
+        alignment in bytes
+        """
+        ...
+    def addFloat32(self, value: float) -> hephaistos.pyhephaistos.ArgumentBlock:
+        """
+        Appends a 32 bit float
+        """
+        ...
+    def addFloat64(self, value: float) -> hephaistos.pyhephaistos.ArgumentBlock:
+        """
+        Appends a 64 bit float
+        """
+        ...
+    def addInt32(self, value: int) -> hephaistos.pyhephaistos.ArgumentBlock:
+        """
+        Appends a signed 32 bit integer
+        """
+        ...
+    def addInt64(self, value: int) -> hephaistos.pyhephaistos.ArgumentBlock:
+        """
+        Appends a signed 64 bit integer
+        """
+        ...
+    def addUint32(self, value: int) -> hephaistos.pyhephaistos.ArgumentBlock:
+        """
+        Appends an unsigned 32 bit integer
+        """
+        ...
+    def addUint64(self, value: int) -> hephaistos.pyhephaistos.ArgumentBlock:
+        """
+        Appends an unsigned 64 bit integer
+        """
+        ...
+    @overload
     def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: str
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
     ) -> None:
         """
-        Binds the acceleration structure to the program at the given binding
+        Binds the last committed block to the program or parameter set at the
+        given binding
         """
         ...
     @overload
     def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: int
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
     ) -> None:
         """
-        Binds the acceleration structure to the program at the given binding
+        Binds the last committed block to the program or parameter set at the
+        given binding
+        """
+        ...
+    def clear(self) -> None:
+        """
+        Removes all appended data. Does not affect committed blocks.
+        """
+        ...
+    def commit(self) -> int:
+        """
+        Uploads the appended data into the next block and returns its index
+        """
+        ...
+    @property
+    def data(self) -> bytes:
+        """
+        Data appended since the last clear
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        Size of the appended data in bytes
         """
         ...
 
@@ -93,6 +299,113 @@ class AtomicsProperties:
     @property
     def sharedInt64Atomics(self) -> bool: ...
 
+BC1_RGBA_UNORM: ImageFormat
+
+BC3_UNORM: ImageFormat
+
+BC4_SNORM: ImageFormat
+
+BC4_UNORM: ImageFormat
+
+BC5_SNORM: ImageFormat
+
+BC5_UNORM: ImageFormat
+
+BC6H_SFLOAT: ImageFormat
+
+BC6H_UFLOAT: ImageFormat
+
+BC7_UNORM: ImageFormat
+
+class BeginConditionalCommand:
+    """
+    Command for starting a block of dispatches, which are discarded if the 32
+    bit predicate read from the tensor is zero, or non zero if inverted.
+    """
+
+    def __init__(self, tensor: Tensor, offset: int = 0, inverted: bool = False) -> None:
+        """
+        Creates a new BeginConditionalCommand.
+
+        Parameters
+        ----------
+        tensor: Tensor
+            Tensor from which to read the predicate
+        offset: int, default=0
+            Offset in bytes at which the predicate is stored. Must be a multiple of 4.
+        inverted: bool, default=False
+            If True, the block is discarded if the predicate is non zero
+        """
+        ...
+    @property
+    def inverted(self) -> bool:
+        """
+        If True, the block is discarded if the predicate is non zero
+        """
+        ...
+    @inverted.setter
+    def inverted(self, arg: bool, /) -> None:
+        """
+        If True, the block is discarded if the predicate is non zero
+        """
+        ...
+    @property
+    def offset(self) -> int:
+        """
+        Offset in bytes into tensor at which the predicate is stored
+        """
+        ...
+    @offset.setter
+    def offset(self, arg: int, /) -> None:
+        """
+        Offset in bytes into tensor at which the predicate is stored
+        """
+        ...
+
+class BeginLabelCommand:
+    """
+    Command opening a labeled region of commands shown in external tools
+    """
+
+    def __init__(
+        self, name: str, color: tuple[float, float, float, float] = (0.0, 0.0, 0.0, 0.0)
+    ) -> None:
+        """
+        Creates a new BeginLabelCommand.
+
+        Parameters
+        ----------
+        name: str
+            Name of the region
+        color: tuple[float, float, float, float], default=(0.0, 0.0, 0.0, 0.0)
+            Optional RGBA color of the region
+        """
+        ...
+    @property
+    def color(self) -> tuple[float, float, float, float]:
+        """
+        Optional RGBA color of the region
+        """
+        ...
+    @color.setter
+    def color(self, arg: tuple[float, float, float, float], /) -> None:
+        """
+        Optional RGBA color of the region
+        """
+        ...
+    @property
+    def name(self) -> str:
+        """
+        Name of the region
+        """
+        ...
+    @name.setter
+    def name(self, arg: str, /) -> None:
+        """
+        Name of the region
+        """
+        ...
+
 class BindingTraits:
     """
     Properties of binding found in programs
@@ -117,6 +430,12 @@ class BindingTraits:
         """
         ...
     @property
+    def members(self) -> list[hephaistos.pyhephaistos.BlockMember]:
+        """
+        Layout of the block members. Only set for uniform and storage buffers.
+        """
+        ...
+    @property
     def name(self) -> str:
         """
         Name of the binding. Might be empty.
@@ -129,213 +448,303 @@ class BindingTraits:
         """
         ...
 
-class Buffer:
-    """
-    Base class for all buffers managing memory allocation on the host
-    """
-
-    ...
-
-class ByteBuffer:
+class BlockMember:
     """
-    Buffer representing memory allocated on the host holding an array of type
-    uint8 and given size which can be accessed as numpy array.
-
-    Parameters
-    ----------
-    size: int
-        Number of elements
+    Layout of a single member of a buffer or push constant block
     """
 
-    def numpy(self) -> numpy.typing.NDArray:
+    @property
+    def arrayDims(self) -> list[int]:
         """
-        Returns a numpy array using this buffer's memory.
+        Size of each array dimension, outermost first. Zero denotes a runtime
+        array.
         """
         ...
     @property
-    def size(self) -> int:
+    def arrayStride(self) -> int:
         """
-        The number of elements in this buffer.
+        Bytes between consecutive array elements
         """
         ...
     @property
-    def size_bytes(self) -> int:
+    def columns(self) -> int:
         """
-        The size of the buffer in bytes.
+        Amount of matrix columns; one if not a matrix
         """
         ...
-
-class ByteTensor:
-    """
-    Tensor representing memory allocated on the device holding an array of type
-    uint8 and given size. If mapped can be accessed from the host using its memory
-    address. Mapping can optionally be requested but will be ignored if the device
-    does not support it. Query its support after creation via isMapped.
-    """
-
-    def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
+    @property
+    def components(self) -> int:
         """
-        Creates a new tensor and fills it with the provided data
-
-        Parameters
-        ----------
-        array: NDArray
-            Numpy array containing the data used to fill the tensor.
-            Its type must match the tensor's.
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        Amount of vector components or matrix rows
         """
         ...
-    @overload
-    def __init__(self, size: int, mapped: bool = False) -> None:
+    @property
+    def matrixStride(self) -> int:
         """
-        Creates a new tensor of given size.
-
-        Parameters
-        ----------
-        size: int
-            Number of elements
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        Bytes between consecutive columns, or rows if row major
         """
         ...
-    @overload
-    def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
+    @property
+    def members(self) -> list[hephaistos.pyhephaistos.BlockMember]:
         """
-        Creates a new tensor and fills it with the provided data
-
-        Parameters
-        ----------
-        addr: int
-            Address of the data used to fill the tensor
-        n: int
-            Number of bytes to copy from addr
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        Members of a struct in declaration order
         """
         ...
     @property
-    def address(self) -> int:
+    def name(self) -> str:
         """
-        The device address of this tensor.
+        Name of the member. Might be empty.
         """
         ...
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: str
-    ) -> None:
+    @property
+    def offset(self) -> int:
         """
-        Binds the tensor to the program at the given binding
+        Offset in bytes relative to the enclosing block or struct
         """
         ...
-    @overload
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: int
-    ) -> None:
+    @property
+    def rowMajor(self) -> bool:
         """
-        Binds the tensor to the program at the given binding
+        Whether the matrix is stored in row major order
         """
         ...
-    def flush(self, offset: int = 0, size: int | None = None, /) -> None:
+    @property
+    def size(self) -> int:
         """
-        Makes writes in mapped memory from the host available to the device.
-        Only needed if isNonCoherent is True.
+        Size in bytes including all array elements. Zero for runtime arrays.
+        """
+        ...
+    @property
+    def type(self) -> hephaistos.pyhephaistos.MemberType:
+        """
+        Base type of the member
+        """
+        ...
+    @property
+    def width(self) -> int:
+        """
+        Size of a single scalar in bits. Zero for structs.
+        """
+        ...
 
-        Parameters
-        ----------
-        offset: int, default=0
-            Offset in amount of elements into mapped memory to flush
-        size: int|None, default=None
-            Number of elements to flush starting at offset.
-            If None, flushes all remaining elements.
+class BoundingBoxes:
+    """
+    Procedural geometry consisting of axis aligned bounding boxes. Ray queries
+    report boxes hit as candidates to be intersected analytically in the
+    shader. BoundingBoxes are used to build Geometries.
+    """
+
+    def __init__(self) -> None: ...
+    @property
+    def boxes(self) -> numpy.typing.NDArray:
+        """
+        Numpy array holding one box per row given by its minimum followed by its
+        maximum x, y and z coordinate.
         """
         ...
-    def invalidate(self, offset: int = 0, size: int | None = None, /) -> None:
+    @boxes.setter
+    def boxes(self, arg: numpy.typing.NDArray, /) -> None:
         """
-        Makes writes in mapped memory from the device available to the host.
-        Only needed if isNonCoherent is True.
+        Numpy array holding one box per row given by its minimum followed by its
+        maximum x, y and z coordinate.
+        """
+        ...
 
-        Parameters
-        ----------
-        offset: int, default=0
-            Offset in amount of elements into mapped memory to invalidate
-        size: int | None, default=None
-            Number of elements to invalidate starting at offset.
-            If None, invalidates all remaining elements.
+class BoundingBoxesVector:
+    """
+    List of BoundingBoxes
+    """
+
+    def __init__(self, arg: Iterable[hephaistos.pyhephaistos.BoundingBoxes], /) -> None:
+        """
+        Construct from an iterable object
+        """
+        ...
+    @overload
+    def __init__(self) -> None:
+        """
+        Default constructor
+        """
+        ...
+    @overload
+    def __init__(self, arg: hephaistos.pyhephaistos.BoundingBoxesVector) -> None:
+        """
+        Copy constructor
+        """
+        ...
+    def append(self, arg: hephaistos.pyhephaistos.BoundingBoxes, /) -> None:
+        """
+        Append `arg` to the end of the list.
+        """
+        ...
+    def clear(self) -> None:
+        """
+        Remove all items from list.
+        """
+        ...
+    def extend(self, arg: hephaistos.pyhephaistos.BoundingBoxesVector, /) -> None:
+        """
+        Extend `self` by appending elements from `arg`.
+        """
+        ...
+    def insert(self, arg0: int, arg1: hephaistos.pyhephaistos.BoundingBoxes, /) -> None:
+        """
+        Insert object `arg1` before index `arg0`.
+        """
+        ...
+    def pop(self, index: int = -1) -> hephaistos.pyhephaistos.BoundingBoxes:
+        """
+        Remove and return item at `index` (default last).
         """
         ...
+
+class Buffer:
+    """
+    Base class for all buffers managing memory allocation on the host
+    """
+
+    ...
+
+class BufferRobustness:
+    """
+    Robustness of buffer accesses inside programs
+    """
+
+    DEFAULT: BufferRobustness
+    """
+    Follows the device, i.e. the enableRobustBufferAccess debug option
+    """
+
+    DISABLED: BufferRobustness
+    """
+    Out of bounds accesses are undefined
+    """
+
+    ENABLED: BufferRobustness
+    """
+    Out of bounds accesses are bounds checked
+    """
+
+class BuildOptions:
+    """
+    Options for building acceleration structures
+    """
+
+    def __init__(
+        self,
+        preference: hephaistos.pyhephaistos.BuildPreference = BuildPreference.FAST_TRACE,
+        compact: bool = True,
+        allowUpdate: bool = False,
+        lowMemory: bool = False,
+        queue: hephaistos.pyhephaistos.QueueType = QueueType.MAIN,
+    ) -> None: ...
     @property
-    def isMapped(self) -> bool:
+    def allowUpdate(self) -> bool:
         """
-        True, if the underlying memory is writable by the CPU.
+        Whether the acceleration structures can be updated later on
+        """
+        ...
+    @allowUpdate.setter
+    def allowUpdate(self, arg: bool, /) -> None:
+        """
+        Whether the acceleration structures can be updated later on
         """
         ...
     @property
-    def isNonCoherent(self) -> bool:
+    def compact(self) -> bool:
         """
-        Wether calls to flush() and invalidate() are necessary to make changes
-        in mapped memory between devices and host available
+        Whether to compact the acceleration structures after building. Only
+        applies to GeometryStore.
+        """
+        ...
+    @compact.setter
+    def compact(self, arg: bool, /) -> None:
+        """
+        Whether to compact the acceleration structures after building. Only
+        applies to GeometryStore.
         """
         ...
     @property
-    def memory(self) -> int:
+    def lowMemory(self) -> bool:
         """
-        Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
+        Reduces the memory needed for building at the cost of build time and
+        trace performance
         """
         ...
-    def retrieve(self, addr: int, n: int, offset: int = 0, /) -> None:
+    @lowMemory.setter
+    def lowMemory(self, arg: bool, /) -> None:
         """
-        Retrieves n elements from the tensor at the given offset and stores it
-        in dst.
-
-        Parameters
-        ----------
-        addr: int
-            Address of memory to copy to
-        n: int
-            Amount of elements to copy
-        offset: int, default=0
-            Offset into the tensor in amount of elements where the copy starts
-        
-        Note
-        ----
-        This operation is only guaranteed to succeed on mapped tensors.
+        Reduces the memory needed for building at the cost of build time and
+        trace performance
         """
         ...
     @property
-    def size(self) -> int:
+    def preference(self) -> hephaistos.pyhephaistos.BuildPreference:
         """
-        The number of elements in this tensor.
+        What the build should optimize for
+        """
+        ...
+    @preference.setter
+    def preference(self, arg: hephaistos.pyhephaistos.BuildPreference, /) -> None:
+        """
+        What the build should optimize for
         """
         ...
     @property
-    def size_bytes(self) -> int:
+    def queue(self) -> hephaistos.pyhephaistos.QueueType:
         """
-        The size of the tensor in bytes.
+        Queue the initial build and compaction run on. Building on COMPUTE
+        keeps the main queue free for other work. TRANSFER is rejected with
+        a ValueError.
         """
         ...
-    def update(self, addr: int, n: int, offset: int = 0, /) -> None:
+    @queue.setter
+    def queue(self, arg: hephaistos.pyhephaistos.QueueType, /) -> None:
         """
-        Updates the tensor at the given offset with n elements stored at addr.
+        Queue the initial build and compaction run on. Building on COMPUTE
+        keeps the main queue free for other work. TRANSFER is rejected with
+        a ValueError.
+        """
+        ...
 
-        Parameters
-        ----------
-        addr: int
-            Address of memory to copy from
-        n: int
-            Amount of elements to copy
-        offset: int, default=0
-            Offset into the tensor in amount of elements where the copy starts
-        
-        Note
-        ----
-        This operation is only guaranteed to succeed on mapped tensors.
+class BuildPreference:
+    """
+    What acceleration structure builds should optimize for
+    """
+
+    FAST_BUILD: BuildPreference
+    """
+    Prefers faster builds over trace performance
+    """
+
+    FAST_TRACE: BuildPreference
+    """
+    Prefers higher trace performance over build time
+    """
+
+class BuildSizes:
+    """
+    Memory sizes of built acceleration structures
+    """
+
+    @property
+    def built(self) -> int:
+        """
+        Size in bytes as built
+        """
+        ...
+    @property
+    def compacted(self) -> int:
+        """
+        Size in bytes after compaction. Same as built if not compacted.
         """
         ...
 
-class CharBuffer:
+class ByteBuffer:
     """
     Buffer representing memory allocated on the host holding an array of type
-    int8 and given size which can be accessed as numpy array.
+    uint8 and given size which can be accessed as numpy array or via the buffer
+    protocol, e.g. memoryview(buffer), without copies.
 
     Parameters
     ----------
@@ -343,7 +752,7 @@ class CharBuffer:
         Number of elements
     """
 
-    def __init__(self, size: int) -> None: ...
+    def __buffer__(self, flags: int, /) -> memoryview: ...
     def numpy(self) -> numpy.typing.NDArray:
         """
         Returns a numpy array using this buffer's memory.
@@ -362,14 +771,17 @@ class CharBuffer:
         """
         ...
 
-class CharTensor:
+class ByteTensor:
     """
     Tensor representing memory allocated on the device holding an array of type
-    int8 and given size. If mapped can be accessed from the host using its memory
-    address. Mapping can optionally be requested but will be ignored if the
-    device does not support it. Query its support after creation via isMapped.
+    uint8 and given size. If mapped can be accessed from the host using its
+    memory address. Mapping can optionally be requested but will be ignored if
+    the device does not support it. Query its support after creation via
+    isMapped. Mapped tensors support the buffer protocol, e.g.
+    memoryview(tensor).
     """
 
+    def __buffer__(self, flags: int, /) -> memoryview: ...
     def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
         """
         Creates a new tensor and fills it with the provided data
@@ -397,6 +809,26 @@ class CharTensor:
         """
         ...
     @overload
+    def __init__(
+        self,
+        size: int,
+        hints: hephaistos.pyhephaistos.AllocationHints,
+        mapped: bool = False,
+    ) -> None:
+        """
+        Creates a new tensor of given size using the given allocation hints.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        hints: AllocationHints
+            Hints for allocating the memory
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
     def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
         """
         Creates a new tensor and fills it with the provided data
@@ -418,18 +850,22 @@ class CharTensor:
         """
         ...
     def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: str
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
     ) -> None:
         """
-        Binds the tensor to the program at the given binding
+        Binds the tensor to the program or parameter set at the given binding
         """
         ...
     @overload
     def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: int
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
     ) -> None:
         """
-        Binds the tensor to the program at the given binding
+        Binds the tensor to the program or parameter set at the given binding
         """
         ...
     def flush(self, offset: int = 0, size: int | None = None, /) -> None:
@@ -461,6 +897,13 @@ class CharTensor:
         """
         ...
     @property
+    def isAllocated(self) -> bool:
+        """
+        True, if the tensor's memory was allocated. Only False for lazily
+        allocated tensors not used yet.
+        """
+        ...
+    @property
     def isMapped(self) -> bool:
         """
         True, if the underlying memory is writable by the CPU.
@@ -474,6 +917,12 @@ class CharTensor:
         """
         ...
     @property
+    def isPooled(self) -> bool:
+        """
+        True, if the tensor is sub-allocated from a shared buffer.
+        """
+        ...
+    @property
     def memory(self) -> int:
         """
         Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
@@ -498,6 +947,20 @@ class CharTensor:
         This operation is only guaranteed to succeed on mapped tensors.
         """
         ...
+    def retrieveAsync(self, buffer: hephaistos.pyhephaistos.Buffer, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Copies data from the tensor at the given offset into the buffer without
+        waiting for the transfer to finish. The copy is ordered after previously
+        submitted work.
+
+        Parameters
+        ----------
+        buffer: Buffer
+            Buffer to copy to. Its size determines the amount of data copied
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        """
+        ...
     @property
     def size(self) -> int:
         """
@@ -528,201 +991,150 @@ class CharTensor:
         This operation is only guaranteed to succeed on mapped tensors.
         """
         ...
-
-class ClearTensorCommand:
-    """
-    Command for filling a tensor with constant data over a given range
-    """
-
-    def __init__(
-        self,
-        tensor: hephaistos.pyhephaistos.Tensor,
-        offset: Optional[int] = None,
-        size: Optional[int] = None,
-        data: Optional[int] = None,
-        unsafe: bool = False,
-    ) -> None:
+    def updateAsync(self, addr: int, n: int, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
         """
-        Creates a command for filling a tensor with constant data over a given
-        range. Defaults to zeroing the complete tensor
+        Updates the tensor at the given offset with n elements from addr without
+        waiting for the transfer to finish. The data is staged before returning,
+        thus the memory at addr can be reused directly. The copy is ordered after
+        previously submitted work.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in number of elements where the copy starts
         """
         ...
 
-class Command:
-    """
-    Base class for commands running on the device. Execution happens
-    asynchronous after being submitted.
-    """
-
-class Compiler:
+class Capture:
     """
-    Compiler for generating SPIR-V byte code used by Programs from shader code
-    written in GLSL. Has additional methods to handle includes.
+    Self-contained recording of dispatches for benchmarking. Stores the code and
+    specialization of programs, the contents of tensors at the time they were
+    added and the structure of the dispatched work, so it can be saved and
+    replayed without the surrounding application. Dispatches within a step run
+    concurrently, while each step waits on the previous one.
     """
 
-    def __init__(self) -> None: ...
-    def addIncludeDir(self, path: os.PathLike) -> None:
+    @overload
+    def __init__(self) -> None:
         """
-        Adds a path to the list of include directories that take part in
-        resolving includes.
+        Creates an empty capture
         """
         ...
-    def clearIncludeDir(self) -> None:
+    @overload
+    def __init__(self, path: str | os.PathLike) -> None:
         """
-        Clears the internal list of include directories
+        Loads a capture from the given file
         """
         ...
-    def compile(self, code: str, headers: hephaistos.pyhephaistos.HeaderMap) -> bytes:
+    @overload
+    def __init__(self, data: bytes) -> None:
         """
-        Compiles the given GLSL code using the provided header files and returns
-        the SPIR-V code as bytes
-        """
-        ...
-    @overload
-    def compile(self, code: str) -> bytes:
-        """
-        Compiles the given GLSL code and returns the SPIR-V code as bytes
+        Loads a capture from serialized data
         """
         ...
-    def popIncludeDir(self) -> None:
-        """
-        Removes the last added include dir from the internal list
+    def addProgram(self, code: bytes, specialization: bytes = b"") -> int:
         """
-        ...
-
-class DebugMessage:
-    """
-    Structure describing a debug message including text and some meta information
-    """
+        Adds a program to the capture and returns its index.
 
-    @property
-    def idName(self) -> str:
-        """
-        Name of the message type
+        Parameters
+        ----------
+        code: bytes
+            SPIR-V code of the program
+        specialization: bytes, default=b''
+            Data used for filling in specialization constants
         """
         ...
-    @property
-    def idNumber(self) -> int:
+    @overload
+    def addTensor(self, tensor: hephaistos.pyhephaistos.Tensor) -> int:
         """
-        Id of the message type
+        Adds a tensor to the capture and returns its index. Reads the tensor's
+        current contents and waits for it to finish.
         """
         ...
-    @property
-    def message(self) -> str:
+    @overload
+    def addTensor(self, data: bytes) -> int:
         """
-        The actual message text
+        Adds a tensor with the given contents to the capture and returns its
+        index.
         """
         ...
-
-class DebugMessageSeverityFlagBits:
-    """
-    Flags indicating debug message severity
-    """
-
-    INFO: DebugMessageSeverityFlagBits
-
-    ERROR: DebugMessageSeverityFlagBits
-
-    VERBOSE: DebugMessageSeverityFlagBits
-
-    WARNING: DebugMessageSeverityFlagBits
-
-class Device:
-    """
-    Handle for a physical device implementing the Vulkan API. Contains basic
-    properties of the device.
-    """
-
-    @property
-    def isDiscrete(self) -> bool:
+    def dispatch(
+        self,
+        program: int,
+        tensors: list[int],
+        push: bytes = b"",
+        x: int = 1,
+        y: int = 1,
+        z: int = 1,
+    ) -> hephaistos.pyhephaistos.Capture:
         """
-        True, if the device is a discrete GPU. Can be useful to distinguish from
-        integrated ones.
+        Records a dispatch in the current step.
+
+        Parameters
+        ----------
+        program: int
+            Index of the dispatched program
+        tensors: list[int]
+            Indices of the tensors bound to the program's bindings in order
+        push: bytes, default=b''
+            Push data passed to the dispatch
+        x: int, default=1
+            Amount of groups in X dimension
+        y: int, default=1
+            Amount of groups in Y dimension
+        z: int, default=1
+            Amount of groups in Z dimension
         """
         ...
-    @property
-    def name(self) -> str:
+    def nextStep(self) -> hephaistos.pyhephaistos.Capture:
         """
-        Name of the device
+        Starts a new step waiting on all dispatches recorded before
         """
         ...
-
-class DispatchCommand:
-    """
-    Command for executing a program using the given group size
-    """
-
     @property
-    def groupCountX(self) -> int:
-        """
-        Amount of groups in X dimension
-        """
-        ...
-    @groupCountX.setter
-    def groupCountX(self, arg: int, /) -> None:
+    def programCount(self) -> int:
         """
-        Amount of groups in X dimension
+        Amount of programs
         """
         ...
-    @property
-    def groupCountY(self) -> int:
+    def save(self, path: str | os.PathLike) -> None:
         """
-        Amount of groups in Y dimension
+        Saves the capture to the given file
         """
         ...
-    @groupCountY.setter
-    def groupCountY(self, arg: int, /) -> None:
+    def serialize(self) -> bytes:
         """
-        Amount of groups in Y dimension
+        Serializes the capture
         """
         ...
     @property
-    def groupCountZ(self) -> int:
+    def stepCount(self) -> int:
         """
-        Amount of groups in Z dimension
+        Amount of steps
         """
         ...
-    @groupCountZ.setter
-    def groupCountZ(self, arg: int, /) -> None:
+    @property
+    def tensorCount(self) -> int:
         """
-        Amount of groups in Z dimension
+        Amount of tensors
         """
         ...
 
-class DispatchIndirectCommand:
+class CastRaysCommand:
     """
-    Command for executing a program using the group size read from the provided tensor at given offset
+    Command casting a tensor of rays. Not synchronized with work recorded
+    before or after unless hazard tracking is used.
     """
 
-    @property
-    def offset(self) -> int:
-        """
-        Offset into the Tensor in bytes on where to start reading
-        """
-        ...
-    @offset.setter
-    def offset(self, arg: int, /) -> None:
-        """
-        Offset into the Tensor in bytes on where to start reading
-        """
-        ...
-    @property
-    def tensor(self) -> Tensor:
-        """
-        Tensor from which to read the group size
-        """
-        ...
-    @tensor.setter
-    def tensor(self, arg: Tensor, /) -> None:
-        """
-        Tensor from which to read the group size
-        """
-        ...
-
-class DoubleBuffer:
+class CharBuffer:
     """
     Buffer representing memory allocated on the host holding an array of type
-    double and given size which can be accessed as numpy array.
+    int8 and given size which can be accessed as numpy array or via the buffer
+    protocol, e.g. memoryview(buffer), without copies.
 
     Parameters
     ----------
@@ -730,6 +1142,7 @@ class DoubleBuffer:
         Number of elements
     """
 
+    def __buffer__(self, flags: int, /) -> memoryview: ...
     def __init__(self, size: int) -> None: ...
     def numpy(self) -> numpy.typing.NDArray:
         """
@@ -749,14 +1162,17 @@ class DoubleBuffer:
         """
         ...
 
-class DoubleTensor:
+class CharTensor:
     """
     Tensor representing memory allocated on the device holding an array of type
-    double and given size. If mapped can be accessed from the host using its
+    int8 and given size. If mapped can be accessed from the host using its
     memory address. Mapping can optionally be requested but will be ignored if
-    the device does not support it. Query its support after creation via isMapped.
+    the device does not support it. Query its support after creation via
+    isMapped. Mapped tensors support the buffer protocol, e.g.
+    memoryview(tensor).
     """
 
+    def __buffer__(self, flags: int, /) -> memoryview: ...
     def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
         """
         Creates a new tensor and fills it with the provided data
@@ -784,6 +1200,26 @@ class DoubleTensor:
         """
         ...
     @overload
+    def __init__(
+        self,
+        size: int,
+        hints: hephaistos.pyhephaistos.AllocationHints,
+        mapped: bool = False,
+    ) -> None:
+        """
+        Creates a new tensor of given size using the given allocation hints.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        hints: AllocationHints
+            Hints for allocating the memory
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
     def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
         """
         Creates a new tensor and fills it with the provided data
@@ -805,18 +1241,22 @@ class DoubleTensor:
         """
         ...
     def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: str
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
     ) -> None:
         """
-        Binds the tensor to the program at the given binding
+        Binds the tensor to the program or parameter set at the given binding
         """
         ...
     @overload
     def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: int
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
     ) -> None:
         """
-        Binds the tensor to the program at the given binding
+        Binds the tensor to the program or parameter set at the given binding
         """
         ...
     def flush(self, offset: int = 0, size: int | None = None, /) -> None:
@@ -848,6 +1288,13 @@ class DoubleTensor:
         """
         ...
     @property
+    def isAllocated(self) -> bool:
+        """
+        True, if the tensor's memory was allocated. Only False for lazily
+        allocated tensors not used yet.
+        """
+        ...
+    @property
     def isMapped(self) -> bool:
         """
         True, if the underlying memory is writable by the CPU.
@@ -861,6 +1308,12 @@ class DoubleTensor:
         """
         ...
     @property
+    def isPooled(self) -> bool:
+        """
+        True, if the tensor is sub-allocated from a shared buffer.
+        """
+        ...
+    @property
     def memory(self) -> int:
         """
         Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
@@ -885,6 +1338,20 @@ class DoubleTensor:
         This operation is only guaranteed to succeed on mapped tensors.
         """
         ...
+    def retrieveAsync(self, buffer: hephaistos.pyhephaistos.Buffer, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Copies data from the tensor at the given offset into the buffer without
+        waiting for the transfer to finish. The copy is ordered after previously
+        submitted work.
+
+        Parameters
+        ----------
+        buffer: Buffer
+            Buffer to copy to. Its size determines the amount of data copied
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        """
+        ...
     @property
     def size(self) -> int:
         """
@@ -915,924 +1382,829 @@ class DoubleTensor:
         This operation is only guaranteed to succeed on mapped tensors.
         """
         ...
+    def updateAsync(self, addr: int, n: int, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Updates the tensor at the given offset with n elements from addr without
+        waiting for the transfer to finish. The data is staged before returning,
+        thus the memory at addr can be reused directly. The copy is ordered after
+        previously submitted work.
 
-class FloatBuffer:
-    """
-    Buffer representing memory allocated on the host holding an array of type
-    float and given size which can be accessed as numpy array.
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in number of elements where the copy starts
+        """
+        ...
 
-    Parameters
-    ----------
-    size: int
-        Number of elements
+class ClearTensorCommand:
+    """
+    Command for filling a tensor with constant data over a given range
     """
 
-    def __init__(self, size: int) -> None: ...
-    def numpy(self) -> numpy.typing.NDArray:
+    def __init__(
+        self,
+        tensor: hephaistos.pyhephaistos.Tensor,
+        offset: Optional[int] = None,
+        size: Optional[int] = None,
+        data: Optional[int] = None,
+        unsafe: bool = False,
+    ) -> None:
         """
-        Returns a numpy array using this buffer's memory.
+        Creates a command for filling a tensor with constant data over a given
+        range. Defaults to zeroing the complete tensor
         """
         ...
+
+class ClockCorrelation:
+    """
+    Correlation between device timestamps and the host's steady clock
+    """
+
     @property
-    def size(self) -> int:
+    def deviceOffset(self) -> float:
         """
-        The number of elements in this buffer.
+        Offset in nanoseconds converting device timestamps into steady clock time
         """
         ...
     @property
-    def size_bytes(self) -> int:
+    def maxDeviation(self) -> float:
         """
-        The size of the buffer in bytes.
+        Maximum deviation of the correlation in nanoseconds
         """
         ...
 
-class FloatTensor:
+class Command:
     """
-    Tensor representing memory allocated on the device holding an array of type
-    float and given size. If mapped can be accessed from the host using its
-    memory address. Mapping can optionally be requested but will be ignored if
-    the device does not support it. Query its support after creation via isMapped.
+    Base class for commands running on the device. Execution happens
+    asynchronous after being submitted.
     """
 
-    def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
-        """
-        Creates a new tensor and fills it with the provided data
+class CompileOptions:
+    """
+    Options controlling the compilation of shader code
+    """
 
-        Parameters
-        ----------
-        array: NDArray
-            Numpy array containing the data used to fill the tensor.
-            Its type must match the tensor's.
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
-        """
-        ...
-    @overload
-    def __init__(self, size: int, mapped: bool = False) -> None:
+    def __init__(
+        self,
+        target: hephaistos.pyhephaistos.CompileTarget = CompileTarget.VULKAN_1_2,
+        defines: list[tuple[str, str]] = [],
+        stripDebugInfo: bool = False,
+        stage: hephaistos.pyhephaistos.ShaderStage = ShaderStage.COMPUTE,
+        denormMode: hephaistos.pyhephaistos.DenormMode = DenormMode.DEFAULT,
+        relaxedPrecision: bool = False,
+        fastMath: bool = False,
+        vulkanMemoryModel: bool = False,
+    ) -> None: ...
+    @property
+    def defines(self) -> list[tuple[str, str]]:
         """
-        Creates a new tensor of given size.
-
-        Parameters
-        ----------
-        size: int
-            Number of elements
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        Macros defined before the source code as list of (name, value)
         """
         ...
-    @overload
-    def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
+    @defines.setter
+    def defines(self, arg: list[tuple[str, str]], /) -> None:
         """
-        Creates a new tensor and fills it with the provided data
-
-        Parameters
-        ----------
-        addr: int
-            Address of the data used to fill the tensor
-        n: int
-            Number of bytes to copy from addr
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        Macros defined before the source code as list of (name, value)
         """
         ...
     @property
-    def address(self) -> int:
+    def denormMode(self) -> hephaistos.pyhephaistos.DenormMode:
         """
-        The device address of this tensor.
+        Handling of denormalized floats
         """
         ...
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: str
-    ) -> None:
+    @denormMode.setter
+    def denormMode(self, arg: hephaistos.pyhephaistos.DenormMode, /) -> None:
         """
-        Binds the tensor to the program at the given binding
+        Handling of denormalized floats
         """
         ...
-    @overload
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: int
-    ) -> None:
+    @property
+    def fastMath(self) -> bool:
         """
-        Binds the tensor to the program at the given binding
+        If True, allows the device to assume there are neither NaNs, infinities
+        nor signed zeros and to contract and reassociate float operations.
+        Requires support by the device, see getFloatControlsProperties().
         """
         ...
-    def flush(self, offset: int = 0, size: int | None = None, /) -> None:
+    @fastMath.setter
+    def fastMath(self, arg: bool, /) -> None:
         """
-        Makes writes in mapped memory from the host available to the device.
-        Only needed if isNonCoherent is True.
-
-        Parameters
-        ----------
-        offset: int, default=0
-            Offset in amount of elements into mapped memory to flush
-        size: int|None, default=None
-            Number of elements to flush starting at offset.
-            If None, flushes all remaining elements.
+        If True, allows the device to assume there are neither NaNs, infinities
+        nor signed zeros and to contract and reassociate float operations.
+        Requires support by the device, see getFloatControlsProperties().
         """
         ...
-    def invalidate(self, offset: int = 0, size: int | None = None, /) -> None:
+    @property
+    def relaxedPrecision(self) -> bool:
         """
-        Makes writes in mapped memory from the device available to the host.
-        Only needed if isNonCoherent is True.
-
-        Parameters
-        ----------
-        offset: int, default=0
-            Offset in amount of elements into mapped memory to invalidate
-        size: int | None, default=None
-            Number of elements to invalidate starting at offset.
-            If None, invalidates all remaining elements.
+        If True, 32 bit float operations may be computed with lower precision
+        like mediump does.
         """
         ...
-    @property
-    def isMapped(self) -> bool:
+    @relaxedPrecision.setter
+    def relaxedPrecision(self, arg: bool, /) -> None:
         """
-        True, if the underlying memory is writable by the CPU.
+        If True, 32 bit float operations may be computed with lower precision
+        like mediump does.
         """
         ...
     @property
-    def isNonCoherent(self) -> bool:
+    def stage(self) -> hephaistos.pyhephaistos.ShaderStage:
         """
-        Wether calls to flush() and invalidate() are necessary to make changes
-        in mapped memory between devices and host available
+        Shader stage to compile for
+        """
+        ...
+    @stage.setter
+    def stage(self, arg: hephaistos.pyhephaistos.ShaderStage, /) -> None:
+        """
+        Shader stage to compile for
         """
         ...
     @property
-    def memory(self) -> int:
+    def stripDebugInfo(self) -> bool:
         """
-        Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
+        If True, removes debug information like names from the code. Parameters
+        can then only be bound by their binding number.
         """
         ...
-    def retrieve(self, addr: int, n: int, offset: int = 0, /) -> None:
+    @stripDebugInfo.setter
+    def stripDebugInfo(self, arg: bool, /) -> None:
         """
-        Retrieves n elements from the tensor at the given offset and stores it
-        in dst.
-
-        Parameters
-        ----------
-        addr: int
-            Address of memory to copy to
-        n: int
-            Amount of elements to copy
-        offset: int, default=0
-            Offset into the tensor in amount of elements where the copy starts
-        
-        Note
-        ----
-        This operation is only guaranteed to succeed on mapped tensors.
+        If True, removes debug information like names from the code. Parameters
+        can then only be bound by their binding number.
         """
         ...
     @property
-    def size(self) -> int:
+    def target(self) -> hephaistos.pyhephaistos.CompileTarget:
         """
-        The number of elements in this tensor.
+        Target environment to compile for
+        """
+        ...
+    @target.setter
+    def target(self, arg: hephaistos.pyhephaistos.CompileTarget, /) -> None:
+        """
+        Target environment to compile for
         """
         ...
     @property
-    def size_bytes(self) -> int:
+    def vulkanMemoryModel(self) -> bool:
         """
-        The size of the tensor in bytes.
+        If True, compiles for the Vulkan memory model and enables
+        GL_KHR_memory_scope_semantics, i.e. scoped atomics and barriers with
+        explicit acquire/release semantics. Requires support by the device, see
+        getMemoryModelFeatures().
         """
         ...
-    def update(self, addr: int, n: int, offset: int = 0, /) -> None:
+    @vulkanMemoryModel.setter
+    def vulkanMemoryModel(self, arg: bool, /) -> None:
         """
-        Updates the tensor at the given offset with n elements stored at addr.
-
-        Parameters
-        ----------
-        addr: int
-            Address of memory to copy from
-        n: int
-            Amount of elements to copy
-        offset: int, default=0
-            Offset into the tensor in amount of elements where the copy starts
-        
-        Note
-        ----
-        This operation is only guaranteed to succeed on mapped tensors.
+        If True, compiles for the Vulkan memory model and enables
+        GL_KHR_memory_scope_semantics, i.e. scoped atomics and barriers with
+        explicit acquire/release semantics. Requires support by the device, see
+        getMemoryModelFeatures().
         """
         ...
 
-class FlushMemoryCommand:
+class CompileTarget:
     """
-    Command for flushing memory writes
+    Target environment code gets compiled for
     """
 
-    ...
+    VULKAN_1_2: CompileTarget
 
-class Geometry:
+    VULKAN_1_2_SPIRV_1_5: CompileTarget
+
+    VULKAN_1_3: CompileTarget
+
+class Compiler:
     """
-    Underlying structure Acceleration Structures use to trace rays against
-    constructed from Meshes.
+    Compiler for generating SPIR-V byte code used by Programs from shader code
+    written in GLSL. Has additional methods to handle includes.
     """
 
     def __init__(self) -> None: ...
-    @property
-    def blas_address(self) -> int:
-        """
-        device address of the underlying blas
-        """
-        ...
-    @blas_address.setter
-    def blas_address(self, arg: int, /) -> None:
-        """
-        device address of the underlying blas
-        """
-        ...
-    @property
-    def indices_address(self) -> int:
+    def addIncludeDir(self, path: os.PathLike) -> None:
         """
-        device address of the index buffer, or zero if it was discarded or is
-        non existent
+        Adds a path to the list of include directories that take part in
+        resolving includes.
         """
         ...
-    @indices_address.setter
-    def indices_address(self, arg: int, /) -> None:
+    def buildProgramAsync(
+        self,
+        code: str,
+        headers: Optional[hephaistos.pyhephaistos.HeaderMap] = None,
+        specialization: Optional[bytes] = None,
+    ) -> hephaistos.pyhephaistos.PendingProgram:
         """
-        device address of the index buffer, or zero if it was discarded or is
-        non existent
+        Compiles the given GLSL code and creates a program from it in the
+        background. Returns a handle to poll or wait for the program.
+
+        Parameters
+        ----------
+        code: str
+            GLSL source code
+        headers: HeaderMap | None, default=None
+            Map of source code for resolving includes. Takes precedence
+        specialization: bytes | None, default=None
+            Data used for filling in specialization constants
         """
         ...
     @property
-    def vertices_address(self) -> int:
-        """
-        device address of the vertex buffer or zero if it was discarded
-        """
-        ...
-    @vertices_address.setter
-    def vertices_address(self, arg: int, /) -> None:
+    def cacheDir(self) -> os.PathLike:
         """
-        device address of the vertex buffer or zero if it was discarded
+        Directory in which compiled code is cached across runs. Entries are keyed
+        by the source code, headers, include directories and compiler version.
+        Changed include files loaded from disk invalidate them. Empty path
+        disables caching (default).
         """
         ...
-
-class GeometryInstance:
-    """
-    Building blocks of Acceleration Structures containing a reference to a
-    Geometry along a transformation to be applied to the underlying mesh as
-    well as additional information.
-    """
-
-    def __init__(self) -> None: ...
-    @property
-    def blas_address(self) -> int:
+    @cacheDir.setter
+    def cacheDir(self, arg: os.PathLike, /) -> None: ...
+    def clearIncludeDir(self) -> None:
         """
-        device address of the referenced BLAS/geometry
+        Clears the internal list of include directories
         """
         ...
-    @blas_address.setter
-    def blas_address(self, arg: int, /) -> None:
+    def compile(self, code: str, headers: hephaistos.pyhephaistos.HeaderMap) -> bytes:
         """
-        device address of the referenced BLAS/geometry
+        Compiles the given GLSL code using the provided header files and returns
+        the SPIR-V code as bytes
         """
         ...
-    @property
-    def customIndex(self) -> int:
+    @overload
+    def compile(self, code: str) -> bytes:
         """
-        The custom index of this instance available in the shader.
+        Compiles the given GLSL code and returns the SPIR-V code as bytes
         """
         ...
-    @customIndex.setter
-    def customIndex(self, arg: int, /) -> None:
+    def compileMany(
+        self,
+        codes: list[str],
+        headers: Optional[hephaistos.pyhephaistos.HeaderMap] = None,
+        threads: int = 0,
+    ) -> list[bytes]:
         """
-        The custom index of this instance available in the shader.
+        Compiles the given GLSL codes in parallel and returns the SPIR-V codes as
+        bytes in the same order. Throws the first error after all compilations
+        finished.
+
+        Parameters
+        ----------
+        codes: list[str]
+            GLSL source codes
+        headers: HeaderMap | None, default=None
+            Map of source code for resolving includes. Takes precedence
+        threads: int, default=0
+            Maximum amount of threads to use. Zero uses one per core.
         """
         ...
     @property
-    def mask(self) -> int:
+    def options(self) -> hephaistos.pyhephaistos.CompileOptions:
         """
-        Mask of this instance used for masking ray traces.
+        Options used for compiling
         """
         ...
-    @mask.setter
-    def mask(self, arg: int, /) -> None:
+    @options.setter
+    def options(self, arg: hephaistos.pyhephaistos.CompileOptions, /) -> None:
         """
-        Mask of this instance used for masking ray traces.
+        Options used for compiling
         """
         ...
-    @property
-    def transform(self) -> numpy.typing.NDArray:
+    def popIncludeDir(self) -> None:
         """
-        The transformation applied to the referenced geometry.
+        Removes the last added include dir from the internal list
         """
         ...
-    @transform.setter
-    def transform(self, arg: numpy.typing.NDArray, /) -> None:
+    def preloadIncludes(self) -> None:
         """
-        The transformation applied to the referenced geometry.
+        Loads all files in the include directories into memory. Include files are
+        cached and only read again if they changed on disk.
         """
         ...
 
-class GeometryInstanceVector:
+class ComponentType:
     """
-    List of GeometryInstance
+    Type of the components of a cooperative matrix
     """
 
-    def __init__(
-        self, arg: Iterable[hephaistos.pyhephaistos.GeometryInstance], /
-    ) -> None:
+    FLOAT16: ComponentType
+
+    FLOAT32: ComponentType
+
+    FLOAT64: ComponentType
+
+    SINT16: ComponentType
+
+    SINT32: ComponentType
+
+    SINT64: ComponentType
+
+    SINT8: ComponentType
+
+    UINT16: ComponentType
+
+    UINT32: ComponentType
+
+    UINT64: ComponentType
+
+    UINT8: ComponentType
+
+class ContextStatistics:
+    """
+    Counters of the work issued on the current context. Counters only
+    increase, i.e. rates can be derived by sampling them periodically.
+    """
+
+    @property
+    def barriers(self) -> int:
         """
-        Construct from an iterable object
+        Number of pipeline barriers recorded
         """
         ...
-    @overload
-    def __init__(self) -> None:
+    @property
+    def bytesDownloaded(self) -> int:
         """
-        Default constructor
+        Bytes transferred from device to host memory
         """
         ...
-    @overload
-    def __init__(self, arg: hephaistos.pyhephaistos.GeometryInstanceVector) -> None:
+    @property
+    def bytesUploaded(self) -> int:
         """
-        Copy constructor
+        Bytes transferred from host to device memory
         """
         ...
-    def append(self, arg: hephaistos.pyhephaistos.GeometryInstance, /) -> None:
+    @property
+    def commandBuffers(self) -> int:
         """
-        Append `arg` to the end of the list.
+        Total number of command buffers across all submissions
         """
         ...
-    def clear(self) -> None:
+    @property
+    def dispatches(self) -> int:
         """
-        Remove all items from list.
+        Number of dispatches recorded, including indirect ones
         """
         ...
-    def extend(self, arg: hephaistos.pyhephaistos.GeometryInstanceVector, /) -> None:
+    @property
+    def oneTimeSubmits(self) -> int:
         """
-        Extend `self` by appending elements from `arg`.
+        Number of one time submits, i.e. execute() and its variants including
+        the ones issued internally
         """
         ...
-    def insert(
-        self, arg0: int, arg1: hephaistos.pyhephaistos.GeometryInstance, /
-    ) -> None:
+    @property
+    def pipelineCacheHits(self) -> int:
         """
-        Insert object `arg1` before index `arg0`.
+        Number of pipelines found in the pipeline cache. Stays zero if the
+        driver does not report pipeline creation feedback.
         """
         ...
-    def pop(self, index: int = -1) -> hephaistos.pyhephaistos.GeometryInstance:
+    @property
+    def pipelineCacheMisses(self) -> int:
         """
-        Remove and return item at `index` (default last).
+        Number of pipelines the driver had to compile. Stays zero if the
+        driver does not report pipeline creation feedback.
+        """
+        ...
+    @property
+    def submissions(self) -> int:
+        """
+        Number of submissions to any queue of the context
         """
         ...
 
-class GeometryStore:
+class CooperativeMatrixProperties:
     """
-    If True, keeps the mesh data on the GPU after building Geometries.
+    Matrix multiply-add configuration Result = A * B + C supported by the
+    device, where A is a MxK, B a KxN and both C and Result MxN matrices.
     """
 
-    def __init__(
-        self, meshes: hephaistos.pyhephaistos.MeshVector, keepMeshData: bool = True
-    ) -> None:
-        """
-        Creates a geometry store responsible for managing the BLAS/geometries
-        used to create and run acceleration structures.
-        """
-        ...
-    def createInstance(self, idx: int) -> hephaistos.pyhephaistos.GeometryInstance:
-        """
-        Creates a new instance of the specified geometry
-        """
-        ...
     @property
-    def geometries(self) -> hephaistos.pyhephaistos.GeometryVector:
+    def AType(self) -> hephaistos.pyhephaistos.ComponentType:
         """
-        Returns the list of stored geometries
+        Component type of A
         """
         ...
     @property
-    def size(self) -> int:
+    def BType(self) -> hephaistos.pyhephaistos.ComponentType:
         """
-        Number of geometries stored
+        Component type of B
         """
         ...
-
-class GeometryVector:
-    """
-    List of Geometry
-    """
-
-    def __init__(self, arg: Iterable[hephaistos.pyhephaistos.Geometry], /) -> None:
+    @property
+    def CType(self) -> hephaistos.pyhephaistos.ComponentType:
         """
-        Construct from an iterable object
+        Component type of C
         """
         ...
-    @overload
-    def __init__(self) -> None:
+    @property
+    def KSize(self) -> int:
         """
-        Default constructor
+        Amount of columns of A and rows of B
         """
         ...
-    @overload
-    def __init__(self, arg: hephaistos.pyhephaistos.GeometryVector) -> None:
+    @property
+    def MSize(self) -> int:
         """
-        Copy constructor
+        Amount of rows of A, C and Result
         """
         ...
-    def append(self, arg: hephaistos.pyhephaistos.Geometry, /) -> None:
+    @property
+    def NSize(self) -> int:
         """
-        Append `arg` to the end of the list.
+        Amount of columns of B, C and Result
         """
         ...
-    def clear(self) -> None:
+    @property
+    def ResultType(self) -> hephaistos.pyhephaistos.ComponentType:
         """
-        Remove all items from list.
+        Component type of Result
         """
         ...
-    def extend(self, arg: hephaistos.pyhephaistos.GeometryVector, /) -> None:
+    @property
+    def saturatingAccumulation(self) -> bool:
         """
-        Extend `self` by appending elements from `arg`.
+        Wether the operation saturates instead of wrapping around
         """
         ...
-    def insert(self, arg0: int, arg1: hephaistos.pyhephaistos.Geometry, /) -> None:
+    @property
+    def scope(self) -> hephaistos.pyhephaistos.MatrixScope:
         """
-        Insert object `arg1` before index `arg0`.
-        """
-        ...
-    def pop(self, index: int = -1) -> hephaistos.pyhephaistos.Geometry:
-        """
-        Remove and return item at `index` (default last).
+        Scope of threads sharing the matrices
         """
         ...
 
-class HeaderMap:
+class CopyImageToTensorCommand:
     """
-    Dict mapping filepaths to shader source code. Consumed by Compiler to
-    resolve include directives.
+    Command for copying the image into the given tensor on the device
     """
 
-    class ItemView: ...
-    class KeyView: ...
-    class ValueView: ...
+    def __init__(
+        self,
+        src: hephaistos.pyhephaistos.Image,
+        dst: hephaistos.pyhephaistos.Tensor,
+        region: hephaistos.pyhephaistos.ImageRegion = ImageRegion(),
+    ) -> None: ...
 
-    def __init__(self, arg: dict[str, str], /) -> None:
-        """
-        Construct from a dictionary
-        """
-        ...
-    @overload
-    def __init__(self) -> None:
+class CopyTensorCommand:
+    """
+    Command for copying the src tensor into the destination tensor
+    """
+
+    def __init__(
+        self,
+        src: hephaistos.pyhephaistos.Tensor,
+        dst: hephaistos.pyhephaistos.Tensor,
+        srcOffset: Optional[int] = None,
+        dstOffset: Optional[int] = None,
+        size: Optional[int] = None,
+        unsafe: bool = False
+    ) -> None: ...
+
+class CopyTensorToImageCommand:
+    """
+    Command for copying the tensor into the given image on the device
+    """
+
+    def __init__(
+        self,
+        src: hephaistos.pyhephaistos.Tensor,
+        dst: hephaistos.pyhephaistos.Image,
+        region: hephaistos.pyhephaistos.ImageRegion = ImageRegion(),
+    ) -> None: ...
+
+class CopyTensorToTextureCommand:
+    """
+    Command for copying the tensor into the given texture on the device
+    """
+
+    def __init__(
+        self,
+        src: hephaistos.pyhephaistos.Tensor,
+        dst: hephaistos.pyhephaistos.Texture,
+        region: hephaistos.pyhephaistos.ImageRegion = ImageRegion(),
+    ) -> None: ...
+
+class DebugMessage:
+    """
+    Structure describing a debug message including text and some meta information
+    """
+
+    @property
+    def idName(self) -> str:
         """
-        Default constructor
+        Name of the message type
         """
         ...
-    @overload
-    def __init__(self, arg: hephaistos.pyhephaistos.HeaderMap) -> None:
+    @property
+    def idNumber(self) -> int:
         """
-        Copy constructor
+        Id of the message type
         """
         ...
-    def clear(self) -> None:
+    @property
+    def message(self) -> str:
         """
-        Remove all items
+        The actual message text
         """
         ...
-    def items(self) -> hephaistos.pyhephaistos.HeaderMap.ItemView:
+
+class DebugMessageSeverityFlagBits:
+    """
+    Flags indicating debug message severity
+    """
+
+    INFO: DebugMessageSeverityFlagBits
+
+    ERROR: DebugMessageSeverityFlagBits
+
+    VERBOSE: DebugMessageSeverityFlagBits
+
+    WARNING: DebugMessageSeverityFlagBits
+
+class DefragmentationResult:
+    """
+    Statistics of a defragmentation run
+    """
+
+    @property
+    def blocksFreed(self) -> int:
         """
-        Returns an iterable view of the map's items.
+        Number of device memory blocks released
         """
         ...
-    def keys(self) -> hephaistos.pyhephaistos.HeaderMap.KeyView:
+    @property
+    def bytesFreed(self) -> int:
         """
-        Returns an iterable view of the map's keys.
+        Number of bytes of device memory released
         """
         ...
-    def update(self, arg: hephaistos.pyhephaistos.HeaderMap, /) -> None:
+    @property
+    def bytesMoved(self) -> int:
         """
-        Update the map with element from `arg`
+        Number of bytes copied to new locations
         """
         ...
-    def values(self) -> hephaistos.pyhephaistos.HeaderMap.ValueView:
+    @property
+    def tensorsMoved(self) -> int:
         """
-        Returns an iterable view of the map's values.
+        Number of tensors moved to new locations
         """
         ...
 
-class Image:
+class DenormMode:
+    """
+    Handling of denormalized floats in compiled code
     """
-    Allocates memory on the device using a memory layout it deems optimal for
-    images presenting it inside programs as storage images thus allowing reads
-    and writes to it.
 
-    Parameters
-    ----------
-    format: ImageFormat
-        Format of the image
-    width: int
-        Width of the image in pixels
-    height: int, default=1
-        Height of the image in pixels
-    depth: int, default=1
-        Depth of the image in pixels
+    DEFAULT: DenormMode
+
+    FLUSH_TO_ZERO: DenormMode
+
+    PRESERVE: DenormMode
+
+class Device:
+    """
+    Handle for a physical device implementing the Vulkan API. Contains basic
+    properties of the device.
     """
 
-    def __init__(
-        self,
-        format: hephaistos.pyhephaistos.ImageFormat,
-        width: int,
-        height: int = 1,
-        depth: int = 1,
-    ) -> None: ...
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: str, /
-    ) -> None:
+    @property
+    def computeUnits(self) -> int:
         """
-        Binds the image to the program at the given binding
+        Amount of compute units (SMs/CUs). Zero if the driver does not report it.
         """
         ...
-    @overload
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: int, /
-    ) -> None:
+    @property
+    def deviceID(self) -> int:
         """
-        Binds the image to the program at the given binding
+        Vendor specific id of the device
         """
         ...
     @property
-    def depth(self) -> int:
+    def deviceMemory(self) -> int:
         """
-        Depth of the image in pixels
+        Size of the largest device local memory heap in bytes
         """
         ...
     @property
-    def format(self) -> hephaistos.pyhephaistos.ImageFormat:
+    def driverInfo(self) -> str:
         """
-        Format of the image
+        Name and version of the driver
         """
         ...
     @property
-    def height(self) -> int:
+    def driverVersion(self) -> int:
         """
-        Height of the image in pixels
+        Vendor specific encoded version of the driver
         """
         ...
     @property
-    def size_bytes(self) -> int:
+    def isDiscrete(self) -> bool:
         """
-        Size the image takes in a linear/compact memory layout in bytes. This
-        can differ from the actual size the image takes on the device but can
-        be useful to allocate buffers for transferring the image.
+        True, if the device is a discrete GPU. Can be useful to distinguish from
+        integrated ones.
         """
         ...
     @property
-    def width(self) -> int:
+    def maxSharedMemorySize(self) -> int:
         """
-        With of the image in pixels
+        Maximum amount of shared memory per workgroup in bytes
         """
         ...
-
-class ImageBindingTraits:
-    """
-    Properties a binding expects from a bound image
-    """
-
     @property
-    def dims(self) -> int:
+    def maxWorkGroupInvocations(self) -> int:
         """
-        Image dimensions
+        Maximum amount of invocations in a single workgroup
         """
         ...
     @property
-    def format(self) -> hephaistos.pyhephaistos.ImageFormat:
+    def name(self) -> str:
         """
-        Expected image format
+        Name of the device
         """
         ...
-
-class ImageBuffer:
-    """
-    Utility class allocating memory on the host side in linear memory layout
-    allowing easy manipulating of 2D 32bit RGBA image data that can later be
-    copied to an image or texture. Provides additional methods for loading and
-    saving image data from and to disk in various file formats.
-
-    Parameters
-    ----------
-    width: int
-        Width of the image in pixels
-    height: int
-        Height of the image in pixels
-    """
-
-    def __init__(self, width: int, height: int) -> None: ...
     @property
-    def height(self) -> int:
+    def subgroupSize(self) -> int:
         """
-        Height of the image in pixels
+        Default amount of invocations in a subgroup
         """
         ...
-    def loadFile(filename: str) -> hephaistos.pyhephaistos.ImageBuffer:
+    @property
+    def uuid(self) -> str:
         """
-        Loads the image at the given filepath and returns a new ImageBuffer
+        Universally unique identifier of the device as hex string. Stable
+        across processes and APIs.
         """
         ...
-    def loadMemory(data: bytes) -> hephaistos.pyhephaistos.ImageBuffer:
+    @property
+    def vendor(self) -> str:
         """
-        Loads serialized image data from memory and returns a new ImageBuffer
-
-        Parameters
-        ----------
-        data: bytes
-            Binary data containing the image data
+        Name of the vendor, e.g. 'NVIDIA'. 'Unknown' if not recognized.
         """
         ...
-    def numpy(self) -> numpy.typing.NDArray:
+    @property
+    def vendorID(self) -> int:
         """
-        Returns a numpy array that allows to manipulate the data handled
-        by this ImageBuffer
+        PCI vendor id of the device
         """
         ...
-    def save(self, filename: str) -> None:
+
+class DeviceLimits:
+    """
+    Limits of a device relevant for sizing work and resources
+    """
+
+    @property
+    def heapSizes(self) -> list[int]:
         """
-        Saves the image under the given filepath
+        Size in bytes of each memory heap of the device
         """
         ...
     @property
-    def width(self) -> int:
+    def maxMemoryAllocationSize(self) -> int:
         """
-        Width of the image in pixels
+        Maximum size of a single allocation in bytes
         """
         ...
-
-class ImageFormat:
-    """
-    List of supported image formats
-    """
-
-    R16G16B16A16_SINT: ImageFormat
-
-    R16G16B16A16_UINT: ImageFormat
-
-    R32G32B32A32_SFLOAT: ImageFormat
-
-    R32G32B32A32_SINT: ImageFormat
-
-    R32G32B32A32_UINT: ImageFormat
-
-    R32G32_SFLOAT: ImageFormat
-
-    R32G32_SINT: ImageFormat
-
-    R32G32_UINT: ImageFormat
-
-    R32_SFLOAT: ImageFormat
-
-    R32_SINT: ImageFormat
-
-    R32_UINT: ImageFormat
-
-    R8G8B8A8_SINT: ImageFormat
-
-    R8G8B8A8_SNORM: ImageFormat
-
-    R8G8B8A8_UINT: ImageFormat
-
-    R8G8B8A8_UNORM: ImageFormat
-
-class IntBuffer:
-    """
-    Buffer representing memory allocated on the host holding an array of type
-    int32 and given size which can be accessed as numpy array.
-
-    Parameters
-    ----------
-    size: int
-        Number of elements
-    """
-
-    def __init__(self, size: int) -> None: ...
-    def numpy(self) -> numpy.typing.NDArray:
+    @property
+    def maxPushConstantsSize(self) -> int:
         """
-        Returns a numpy array using this buffer's memory.
+        Maximum size of push constants in bytes
         """
         ...
     @property
-    def size(self) -> int:
+    def maxSharedMemorySize(self) -> int:
         """
-        The number of elements in this buffer.
+        Maximum amount of shared memory per work group in bytes
         """
         ...
     @property
-    def size_bytes(self) -> int:
+    def maxStorageBufferRange(self) -> int:
         """
-        The size of the buffer in bytes.
+        Maximum size in bytes a single tensor binding can span
         """
         ...
-
-class IntTensor:
-    """
-    Tensor representing memory allocated on the device holding an array of type
-    int32 and given size. If mapped can be accessed from the host using its
-    memory address. Mapping can optionally be requested but will be ignored if
-    the device does not support it. Query its support after creation via isMapped.
-    """
-
-    def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
-        """
-        Creates a new tensor and fills it with the provided data
-
-        Parameters
-        ----------
-        array: NDArray
-            Numpy array containing the data used to fill the tensor.
-            Its type must match the tensor's.
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
-        """
-        ...
-    @overload
-    def __init__(self, size: int, mapped: bool = False) -> None:
+    @property
+    def maxUniformBufferRange(self) -> int:
         """
-        Creates a new tensor of given size.
-
-        Parameters
-        ----------
-        size: int
-            Number of elements
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        Maximum size in bytes of a single uniform buffer binding
         """
         ...
-    @overload
-    def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
+    @property
+    def maxWorkGroupCount(self) -> tuple[int, int, int]:
         """
-        Creates a new tensor and fills it with the provided data
-
-        Parameters
-        ----------
-        addr: int
-            Address of the data used to fill the tensor
-        n: int
-            Number of bytes to copy from addr
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        Maximum amount of work groups in a single dispatch per dimension.
+        Dispatches exceeding it get split automatically.
         """
         ...
     @property
-    def address(self) -> int:
+    def maxWorkGroupInvocations(self) -> int:
         """
-        The device address of this tensor.
+        Maximum amount of invocations in a single work group
         """
         ...
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: str
-    ) -> None:
+    @property
+    def maxWorkGroupSize(self) -> tuple[int, int, int]:
         """
-        Binds the tensor to the program at the given binding
+        Maximum local size of a work group per dimension
         """
         ...
-    @overload
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: int
-    ) -> None:
+    @property
+    def timestampPeriod(self) -> float:
         """
-        Binds the tensor to the program at the given binding
+        Nanoseconds per timestamp tick
         """
         ...
-    def flush(self, offset: int = 0, size: int | None = None, /) -> None:
-        """
-        Makes writes in mapped memory from the host available to the device.
-        Only needed if isNonCoherent is True.
 
-        Parameters
-        ----------
-        offset: int, default=0
-            Offset in amount of elements into mapped memory to flush
-        size: int|None, default=None
-            Number of elements to flush starting at offset.
-            If None, flushes all remaining elements.
-        """
-        ...
-    def invalidate(self, offset: int = 0, size: int | None = None, /) -> None:
-        """
-        Makes writes in mapped memory from the device available to the host.
-        Only needed if isNonCoherent is True.
+class DispatchCommand:
+    """
+    Command for executing a program using the given group size
+    """
 
-        Parameters
-        ----------
-        offset: int, default=0
-            Offset in amount of elements into mapped memory to invalidate
-        size: int | None, default=None
-            Number of elements to invalidate starting at offset.
-            If None, invalidates all remaining elements.
-        """
-        ...
     @property
-    def isMapped(self) -> bool:
+    def groupCountX(self) -> int:
         """
-        True, if the underlying memory is writable by the CPU.
+        Amount of groups in X dimension
         """
         ...
-    @property
-    def isNonCoherent(self) -> bool:
+    @groupCountX.setter
+    def groupCountX(self, arg: int, /) -> None:
         """
-        Wether calls to flush() and invalidate() are necessary to make changes
-        in mapped memory between devices and host available
+        Amount of groups in X dimension
         """
         ...
     @property
-    def memory(self) -> int:
-        """
-        Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
-        """
-        ...
-    def retrieve(self, addr: int, n: int, offset: int = 0, /) -> None:
+    def groupCountY(self) -> int:
         """
-        Retrieves n elements from the tensor at the given offset and stores it
-        in dst.
-
-        Parameters
-        ----------
-        addr: int
-            Address of memory to copy to
-        n: int
-            Amount of elements to copy
-        offset: int, default=0
-            Offset into the tensor in amount of elements where the copy starts
-        
-        Note
-        ----
-        This operation is only guaranteed to succeed on mapped tensors.
+        Amount of groups in Y dimension
         """
         ...
-    @property
-    def size(self) -> int:
+    @groupCountY.setter
+    def groupCountY(self, arg: int, /) -> None:
         """
-        The number of elements in this tensor.
+        Amount of groups in Y dimension
         """
         ...
     @property
-    def size_bytes(self) -> int:
+    def groupCountZ(self) -> int:
         """
-        The size of the tensor in bytes.
+        Amount of groups in Z dimension
         """
         ...
-    def update(self, addr: int, n: int, offset: int = 0, /) -> None:
+    @groupCountZ.setter
+    def groupCountZ(self, arg: int, /) -> None:
         """
-        Updates the tensor at the given offset with n elements stored at addr.
-
-        Parameters
-        ----------
-        addr: int
-            Address of memory to copy from
-        n: int
-            Amount of elements to copy
-        offset: int, default=0
-            Offset into the tensor in amount of elements where the copy starts
-        
-        Note
-        ----
-        This operation is only guaranteed to succeed on mapped tensors.
+        Amount of groups in Z dimension
         """
         ...
 
-class LocalSize:
+class DispatchIndirectCommand:
     """
-    Description if the local size, i.e. the number and arrangement of threads in
-    a single thread group
+    Command for executing a program using the group size read from the provided tensor at given offset
     """
 
-    def __init__(self) -> None: ...
-    @property
-    def x(self) -> int:
-        """
-        Number of threads in X dimension
-        """
-        ...
-    @x.setter
-    def x(self, arg: int, /) -> None:
-        """
-        Number of threads in X dimension
-        """
-        ...
     @property
-    def y(self) -> int:
+    def offset(self) -> int:
         """
-        Number of threads in Y dimension
+        Offset into the Tensor in bytes on where to start reading
         """
         ...
-    @y.setter
-    def y(self, arg: int, /) -> None:
+    @offset.setter
+    def offset(self, arg: int, /) -> None:
         """
-        Number of threads in Y dimension
+        Offset into the Tensor in bytes on where to start reading
         """
         ...
     @property
-    def z(self) -> int:
+    def tensor(self) -> Tensor:
         """
-        Number of threads in Z dimension
+        Tensor from which to read the group size
         """
         ...
-    @z.setter
-    def z(self, arg: int, /) -> None:
+    @tensor.setter
+    def tensor(self, arg: Tensor, /) -> None:
         """
-        Number of threads in Z dimension
+        Tensor from which to read the group size
         """
         ...
 
-class LongBuffer:
+class DispatchIndirectListCommand:
+    """
+    Command for running a list of indirect dispatches at once. Programs running
+    earlier can decide which dispatches run by writing zero groups for the others.
+    """
+
+class DoubleBuffer:
     """
     Buffer representing memory allocated on the host holding an array of type
-    int64 and given size which can be accessed as numpy array.
+    double and given size which can be accessed as numpy array or via the buffer
+    protocol, e.g. memoryview(buffer), without copies.
 
     Parameters
     ----------
@@ -1840,6 +2212,7 @@ class LongBuffer:
         Number of elements
     """
 
+    def __buffer__(self, flags: int, /) -> memoryview: ...
     def __init__(self, size: int) -> None: ...
     def numpy(self) -> numpy.typing.NDArray:
         """
@@ -1859,14 +2232,17 @@ class LongBuffer:
         """
         ...
 
-class LongTensor:
+class DoubleTensor:
     """
     Tensor representing memory allocated on the device holding an array of type
-    int64 and given size. If mapped can be accessed from the host using its
+    double and given size. If mapped can be accessed from the host using its
     memory address. Mapping can optionally be requested but will be ignored if
-    the device does not support it. Query its support after creation via isMapped.
+    the device does not support it. Query its support after creation via
+    isMapped. Mapped tensors support the buffer protocol, e.g.
+    memoryview(tensor).
     """
 
+    def __buffer__(self, flags: int, /) -> memoryview: ...
     def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
         """
         Creates a new tensor and fills it with the provided data
@@ -1894,6 +2270,26 @@ class LongTensor:
         """
         ...
     @overload
+    def __init__(
+        self,
+        size: int,
+        hints: hephaistos.pyhephaistos.AllocationHints,
+        mapped: bool = False,
+    ) -> None:
+        """
+        Creates a new tensor of given size using the given allocation hints.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        hints: AllocationHints
+            Hints for allocating the memory
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
     def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
         """
         Creates a new tensor and fills it with the provided data
@@ -1915,18 +2311,22 @@ class LongTensor:
         """
         ...
     def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: str
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
     ) -> None:
         """
-        Binds the tensor to the program at the given binding
+        Binds the tensor to the program or parameter set at the given binding
         """
         ...
     @overload
     def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: int
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
     ) -> None:
         """
-        Binds the tensor to the program at the given binding
+        Binds the tensor to the program or parameter set at the given binding
         """
         ...
     def flush(self, offset: int = 0, size: int | None = None, /) -> None:
@@ -1958,6 +2358,13 @@ class LongTensor:
         """
         ...
     @property
+    def isAllocated(self) -> bool:
+        """
+        True, if the tensor's memory was allocated. Only False for lazily
+        allocated tensors not used yet.
+        """
+        ...
+    @property
     def isMapped(self) -> bool:
         """
         True, if the underlying memory is writable by the CPU.
@@ -1971,6 +2378,12 @@ class LongTensor:
         """
         ...
     @property
+    def isPooled(self) -> bool:
+        """
+        True, if the tensor is sub-allocated from a shared buffer.
+        """
+        ...
+    @property
     def memory(self) -> int:
         """
         Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
@@ -1995,6 +2408,20 @@ class LongTensor:
         This operation is only guaranteed to succeed on mapped tensors.
         """
         ...
+    def retrieveAsync(self, buffer: hephaistos.pyhephaistos.Buffer, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Copies data from the tensor at the given offset into the buffer without
+        waiting for the transfer to finish. The copy is ordered after previously
+        submitted work.
+
+        Parameters
+        ----------
+        buffer: Buffer
+            Buffer to copy to. Its size determines the amount of data copied
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        """
+        ...
     @property
     def size(self) -> int:
         """
@@ -2025,963 +2452,925 @@ class LongTensor:
         This operation is only guaranteed to succeed on mapped tensors.
         """
         ...
+    def updateAsync(self, addr: int, n: int, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Updates the tensor at the given offset with n elements from addr without
+        waiting for the transfer to finish. The data is staged before returning,
+        thus the memory at addr can be reused directly. The copy is ordered after
+        previously submitted work.
 
-class Mesh:
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in number of elements where the copy starts
+        """
+        ...
+
+ETC2_R8G8B8A8_UNORM: ImageFormat
+
+class ElementType:
     """
-    Representation of a geometric shape consisting of triangles defined by their
-    vertices, which can optionally be indexed. Meshes are used to build Geometries.
+    Type of the elements processed by a primitive
+    """
+
+    FLOAT32: ElementType
+
+    INT32: ElementType
+
+    UINT32: ElementType
+
+class EndConditionalCommand:
+    """
+    Command for ending a block of conditionally executed dispatches
     """
 
     def __init__(self) -> None: ...
-    @property
-    def indices(self) -> numpy.typing.NDArray:
-        """
-        Optional numpy array holding the indices referencing vertices to create
-        triangles.
-        """
-        ...
-    @indices.setter
-    def indices(self, arg: numpy.typing.NDArray, /) -> None:
-        """
-        Optional numpy array holding the indices referencing vertices to create
-        triangles.
-        """
+
+class EndLabelCommand:
+    """
+    Command closing the innermost labeled region
+    """
+
+    def __init__(self) -> None: ...
+
+class ExecutionGraph:
+    """
+    Experimental graph of programs enqueuing 32 bit records to each other on
+    the device. Programs include the built-in header "hephaistos/graph.glsl"
+    and loop popping records of their node via graphPop() until it drained,
+    enqueuing follow up work to any node via graphEnqueue(). Records enqueued
+    in a round are processed in the next one. Emulated via work queues and
+    indirect dispatches. Programs must be passed the graph's address, e.g. via
+    push constants.
+
+    Parameters
+    ----------
+    nodes: list[Program]
+        Programs of each node. Their bindings are captured on creation.
+    capacity: int
+        Amount of records each half of a node's queue can hold
+    maxGroups: list[int] | None, default=None
+        Maximum amount of workgroups per round of each node. Zero or None uses
+        the occupancy of the program.
+    """
+
+    def __init__(
+        self, nodes: list, capacity: int, *, maxGroups: Optional[list[int]] = None
+    ) -> None: ...
+    @property
+    def address(self) -> int:
+        """
+        Device address of the graph
+        """
         ...
     @property
-    def vertices(self) -> numpy.typing.NDArray:
+    def capacity(self) -> int:
         """
-        Numpy array holding the vertex data. The first three columns must be the
-        x, y and z positions.
+        Amount of records each half of a node's queue can hold
         """
         ...
-    @vertices.setter
-    def vertices(self, arg: numpy.typing.NDArray, /) -> None:
+    def getQueueOffset(self, node: int) -> int:
         """
-        Numpy array holding the vertex data. The first three columns must be the
-        x, y and z positions.
+        Returns the offset in bytes of the given node's queue inside tensor.
         """
         ...
+    def launch(
+        self, push: bytes = b"", *, rounds: int = 16
+    ) -> hephaistos.pyhephaistos.ExecutionGraphCommand:
+        """
+        Creates a command running the graph until it drains.
 
-class MeshVector:
-    """
-    List of Mesh
-    """
-
-    def __init__(self, arg: Iterable[hephaistos.pyhephaistos.Mesh], /) -> None:
+        Parameters
+        ----------
+        push: bytes, default=b''
+            Data pushed to the dispatches of all nodes
+        rounds: int, default=16
+            Maximum amount of rounds
         """
-        Construct from an iterable object
+        ...
+    @property
+    def nodeCount(self) -> int:
+        """
+        Amount of nodes
         """
         ...
     @overload
-    def __init__(self) -> None:
+    def seed(
+        self, node: int, count: int, first: int = 0
+    ) -> hephaistos.pyhephaistos.ExecutionGraphCommand:
         """
-        Default constructor
+        Creates a command resetting all nodes and filling the given one with a
+        range of consecutive records.
+
+        Parameters
+        ----------
+        node: int
+            Node receiving the records
+        count: int
+            Amount of records
+        first: int, default=0
+            Value of the first record
         """
         ...
     @overload
-    def __init__(self, arg: hephaistos.pyhephaistos.MeshVector) -> None:
+    def seed(
+        self,
+        node: int,
+        records: hephaistos.pyhephaistos.Tensor,
+        count: Optional[int] = None,
+    ) -> hephaistos.pyhephaistos.ExecutionGraphCommand:
         """
-        Copy constructor
+        Creates a command resetting all nodes and filling the given one with the
+        records stored in the given tensor.
+
+        Parameters
+        ----------
+        node: int
+            Node receiving the records
+        records: Tensor
+            Tensor holding the records as 32 bit unsigned integers
+        count: int | None, default=None
+            Amount of records. Uses the whole tensor if None.
         """
         ...
-    def append(self, arg: hephaistos.pyhephaistos.Mesh, /) -> None:
+    @property
+    def tensor(self) -> hephaistos.pyhephaistos.Tensor:
         """
-        Append `arg` to the end of the list.
+        Tensor holding the queues of all nodes. Each starts with the same 64
+        byte header as the one of WorkQueue.
         """
         ...
-    def clear(self) -> None:
+
+class ExecutionGraphCommand:
+    """
+    Command seeding an execution graph or running it until it drains. Runs
+    multiple dispatches synchronized among each other, but not with work
+    recorded before or after.
+    """
+
+class ExternalMemory:
+    """
+    Exported memory of a tensor
+    """
+
+    def __init__(self, handle: int, size: int, offset: int = 0) -> None:
         """
-        Remove all items from list.
+        Describes memory exported by another process, e.g. after receiving its
+        handle via socket.recv_fds().
         """
         ...
-    def extend(self, arg: hephaistos.pyhephaistos.MeshVector, /) -> None:
+    @property
+    def handle(self) -> int:
         """
-        Extend `self` by appending elements from `arg`.
+        Native handle to the exported memory, i.e. a file descriptor on Linux
+        and a HANDLE on Windows. The receiver is responsible for closing it.
         """
         ...
-    def insert(self, arg0: int, arg1: hephaistos.pyhephaistos.Mesh, /) -> None:
+    @property
+    def offset(self) -> int:
         """
-        Insert object `arg1` before index `arg0`.
+        Offset in bytes of the tensor into the exported memory
         """
         ...
-    def pop(self, index: int = -1) -> hephaistos.pyhephaistos.Mesh:
+    @property
+    def size(self) -> int:
         """
-        Remove and return item at `index` (default last).
+        Size of the exported memory in bytes. May be larger than the tensor.
         """
         ...
 
-class ParameterType:
-    """
-    Type of parameter
+class FloatBuffer:
     """
+    Buffer representing memory allocated on the host holding an array of type
+    float and given size which can be accessed as numpy array or via the buffer
+    protocol, e.g. memoryview(buffer), without copies.
 
-    ACCELERATION_STRUCTURE: ParameterType
-
-    COMBINED_IMAGE_SAMPLER: ParameterType
-
-    STORAGE_BUFFER: ParameterType
-
-    STORAGE_IMAGE: ParameterType
+    Parameters
+    ----------
+    size: int
+        Number of elements
+    """
 
-    UNIFORM_BUFFER: ParameterType
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(self, size: int) -> None: ...
+    def numpy(self) -> numpy.typing.NDArray:
+        """
+        Returns a numpy array using this buffer's memory.
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        The number of elements in this buffer.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the buffer in bytes.
+        """
+        ...
 
-class Program:
+class FloatControlsProperties:
     """
-    Encapsulates a shader program enabling introspection into its bindings as
-    well as keeping track of the parameters currently bound to them. Execution
-    happens trough commands.
+    Float controls programs on a context can request
     """
 
-    def __init__(self, code: bytes, specialization: bytes) -> None:
+    @property
+    def denormFlushToZeroFloat16(self) -> bool:
         """
-        Creates a new program using the shader's byte code.
-
-        Parameters
-        ----------
-        code: bytes
-            Byte code of the program
-        specialization: bytes
-            Data used for filling in specialization constants
+        True, if 16 bit denormalized floats can be flushed to zero
         """
         ...
-    @overload
-    def __init__(self, code: bytes) -> None:
+    @property
+    def denormFlushToZeroFloat32(self) -> bool:
         """
-        Creates a new program using the shader's byte code.
-
-        Parameters
-        ----------
-        code: bytes
-            Byte code of the program
+        True, if 32 bit denormalized floats can be flushed to zero
         """
         ...
-    def bindParams(*params, **namedparams) -> None:
+    @property
+    def denormFlushToZeroFloat64(self) -> bool:
         """
-        Binds the given parameters.
-        Positional arguments are bound to the binding of the corresponding
-        position. Keyword arguments are matched with the binding of the same
-        name.
+        True, if 64 bit denormalized floats can be flushed to zero
         """
         ...
     @property
-    def bindings(self) -> list[hephaistos.pyhephaistos.BindingTraits]:
+    def denormPreserveFloat16(self) -> bool:
         """
-        Returns a list of all bindings.
+        True, if 16 bit denormalized floats can be preserved
         """
         ...
-    def dispatch(
-        self, x: int = 1, y: int = 1, z: int = 1
-    ) -> hephaistos.pyhephaistos.DispatchCommand:
+    @property
+    def denormPreserveFloat32(self) -> bool:
         """
-        Dispatches a program execution with the given amount of workgroups.
+        True, if 32 bit denormalized floats can be preserved
+        """
+        ...
+    @property
+    def denormPreserveFloat64(self) -> bool:
+        """
+        True, if 64 bit denormalized floats can be preserved
+        """
+        ...
+    @property
+    def fastMath(self) -> bool:
+        """
+        True, if programs can allow fast math
+        """
+        ...
+
+class FloatTensor:
+    """
+    Tensor representing memory allocated on the device holding an array of type
+    float and given size. If mapped can be accessed from the host using its
+    memory address. Mapping can optionally be requested but will be ignored if
+    the device does not support it. Query its support after creation via
+    isMapped. Mapped tensors support the buffer protocol, e.g.
+    memoryview(tensor).
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
+        """
+        Creates a new tensor and fills it with the provided data
 
         Parameters
         ----------
-        x: int, default=1
-            Number of groups to dispatch in X dimension
-        y: int, default=1
-            Number of groups to dispatch in Y dimension
-        z: int, default=1
-            Number of groups to dispatch in Z dimension
+        array: NDArray
+            Numpy array containing the data used to fill the tensor.
+            Its type must match the tensor's.
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
         """
         ...
-    def dispatchIndirect(
-        self, tensor: hephaistos.pyhephaistos.Tensor, offset: int = 0
-    ) -> hephaistos.pyhephaistos.DispatchIndirectCommand:
+    @overload
+    def __init__(self, size: int, mapped: bool = False) -> None:
         """
-        Dispatches a program execution using the amount of workgroups stored in
-        the given tensor at the given offset. Expects the workgroup size as
-        three consecutive unsigned 32 bit integers.
+        Creates a new tensor of given size.
 
         Parameters
         ----------
-        tensor: Tensor
-            Tensor from which to read the amount of workgroups
-        offset: int, default=0
-            Offset at which to start reading
+        size: int
+            Number of elements
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
         """
         ...
-    def dispatchIndirectPush(
-        self, push: bytes, tensor: hephaistos.pyhephaistos.Tensor, offset: int = 0
-    ) -> hephaistos.pyhephaistos.DispatchIndirectCommand:
+    @overload
+    def __init__(
+        self,
+        size: int,
+        hints: hephaistos.pyhephaistos.AllocationHints,
+        mapped: bool = False,
+    ) -> None:
         """
-        Dispatches a program execution with the given push data using the amount
-        of workgroups stored in the given tensor at the given offset.
+        Creates a new tensor of given size using the given allocation hints.
 
         Parameters
         ----------
-        push: bytes
-            Data pushed to the dispatch as bytes
-        tensor: Tensor
-            Tensor from which to read the amount of workgroups
-        offset: int, default=0
-            Offset at which to start reading
+        size: int
+            Number of elements
+        hints: AllocationHints
+            Hints for allocating the memory
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
         """
         ...
-    def dispatchPush(
-        self, push: bytes, x: int = 1, y: int = 1, z: int = 1
-    ) -> hephaistos.pyhephaistos.DispatchCommand:
+    @overload
+    def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
         """
-        Dispatches a program execution with the given push data and amount of
-        workgroups.
+        Creates a new tensor and fills it with the provided data
 
         Parameters
         ----------
-        push: bytes
-            Data pushed to the dispatch as bytes
-        x: int, default=1
-            Number of groups to dispatch in X dimension
-        y: int, default=1
-            Number of groups to dispatch in Y dimension
-        z: int, default=1
-            Number of groups to dispatch in Z dimension
+        addr: int
+            Address of the data used to fill the tensor
+        n: int
+            Number of bytes to copy from addr
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
         """
         ...
-    def isBindingBound(i: int,/) -> bool:
+    @property
+    def address(self) -> int:
         """
-        Checks wether the i-th binding is currently bound.
+        The device address of this tensor.
         """
         ...
-    @overload
-    def isBindingBound(name: str,/) -> bool:
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
+    ) -> None:
         """
-        Checks wether the binding specified by its name is currently bound
+        Binds the tensor to the program or parameter set at the given binding
         """
         ...
-    @property
-    def localSize(self) -> hephaistos.pyhephaistos.LocalSize:
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
+    ) -> None:
         """
-        Returns the size of the local work group.
+        Binds the tensor to the program or parameter set at the given binding
         """
         ...
+    def flush(self, offset: int = 0, size: int | None = None, /) -> None:
+        """
+        Makes writes in mapped memory from the host available to the device.
+        Only needed if isNonCoherent is True.
 
-R16G16B16A16_SINT: ImageFormat
-
-R16G16B16A16_UINT: ImageFormat
-
-R32G32B32A32_SFLOAT: ImageFormat
-
-R32G32B32A32_SINT: ImageFormat
-
-R32G32B32A32_UINT: ImageFormat
-
-R32G32_SFLOAT: ImageFormat
-
-R32G32_SINT: ImageFormat
-
-R32G32_UINT: ImageFormat
-
-R32_SFLOAT: ImageFormat
-
-R32_SINT: ImageFormat
-
-R32_UINT: ImageFormat
-
-R8G8B8A8_SINT: ImageFormat
-
-R8G8B8A8_SNORM: ImageFormat
-
-R8G8B8A8_UINT: ImageFormat
-
-R8G8B8A8_UNORM: ImageFormat
-
-class RawBuffer:
-    """
-    Buffer for allocating a raw chunk of memory on the host accessible via its
-    memory address. Useful as a base class providing more complex functionality.
-
-    Parameters
-    ----------
-    size: int
-        size of the buffer in bytes
-    """
-
-    def __init__(self, size: int) -> None: ...
-    @property
-    def address(self) -> int:
-        """
-        The memory address of the allocated buffer.
+        Parameters
+        ----------
+        offset: int, default=0
+            Offset in amount of elements into mapped memory to flush
+        size: int|None, default=None
+            Number of elements to flush starting at offset.
+            If None, flushes all remaining elements.
         """
         ...
-    @property
-    def size(self) -> int:
+    def invalidate(self, offset: int = 0, size: int | None = None, /) -> None:
         """
-        The size of the buffer in bytes.
+        Makes writes in mapped memory from the device available to the host.
+        Only needed if isNonCoherent is True.
+
+        Parameters
+        ----------
+        offset: int, default=0
+            Offset in amount of elements into mapped memory to invalidate
+        size: int | None, default=None
+            Number of elements to invalidate starting at offset.
+            If None, invalidates all remaining elements.
         """
         ...
     @property
-    def size_bytes(self) -> int:
-        """
-        The size of the buffer in bytes.
-        """
-        ...
-
-class RetrieveImageCommand:
-    """
-    Command for copying the image back into the given buffer
-    """
-
-    def __init__(
-        self, src: hephaistos.pyhephaistos.Image, dst: hephaistos.pyhephaistos.Buffer, /
-    ) -> None: ...
-
-class RetrieveTensorCommand:
-    """
-    Command for copying the src tensor back to the destination buffer
-    """
-
-    def __init__(
-        self,
-        src: hephaistos.pyhephaistos.Tensor,
-        dst: hephaistos.pyhephaistos.Buffer,
-        bufferOffset: Optional[int] = None,
-        tensorOffset: Optional[int] = None,
-        size: Optional[int] = None,
-        unsafe: bool = False
-    ) -> None: ...
-
-class SequenceBuilder:
-    """
-    Builder class for recording a sequence of commands and subroutines and
-    submitting it to the device for execution, which happens asynchronous, i.e.
-    submit() returns before the recorded work finishes.
-    """
-
-    def And(
-        self, subroutine: hephaistos.pyhephaistos.Subroutine
-    ) -> hephaistos.pyhephaistos.SequenceBuilder:
+    def isAllocated(self) -> bool:
         """
-        Issues the subroutine to run parallel in the current step.
+        True, if the tensor's memory was allocated. Only False for lazily
+        allocated tensors not used yet.
         """
         ...
-    @overload
-    def And(
-        self, cmd: hephaistos.pyhephaistos.Command
-    ) -> hephaistos.pyhephaistos.SequenceBuilder:
+    @property
+    def isMapped(self) -> bool:
         """
-        Issues the command to run parallel in the current step.
+        True, if the underlying memory is writable by the CPU.
         """
         ...
-    def AndList(self, list: list) -> hephaistos.pyhephaistos.SequenceBuilder:
+    @property
+    def isNonCoherent(self) -> bool:
         """
-        Issues each element of the list to run parallel in the current step
+        Wether calls to flush() and invalidate() are necessary to make changes
+        in mapped memory between devices and host available
         """
         ...
-    def NextStep(self) -> hephaistos.pyhephaistos.SequenceBuilder:
+    @property
+    def isPooled(self) -> bool:
         """
-        Issues a new step. Following calls to And are ensured to run after previous ones finished.
+        True, if the tensor is sub-allocated from a shared buffer.
         """
         ...
-    def Submit(self) -> hephaistos.pyhephaistos.Submission:
+    @property
+    def memory(self) -> int:
         """
-        Submits the recorded steps as a single batch to the GPU.
+        Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
         """
         ...
-    def Then(
-        self, subroutine: hephaistos.pyhephaistos.Subroutine
-    ) -> hephaistos.pyhephaistos.SequenceBuilder:
+    def retrieve(self, addr: int, n: int, offset: int = 0, /) -> None:
         """
-        Issues a new step to execute after waiting for the previous one to finish.
+        Retrieves n elements from the tensor at the given offset and stores it
+        in dst.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy to
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        
+        Note
+        ----
+        This operation is only guaranteed to succeed on mapped tensors.
         """
         ...
-    @overload
-    def Then(
-        self, cmd: hephaistos.pyhephaistos.Command
-    ) -> hephaistos.pyhephaistos.SequenceBuilder:
+    def retrieveAsync(self, buffer: hephaistos.pyhephaistos.Buffer, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
         """
-        Issues a new step to execute after waiting for the previous one to finish.
+        Copies data from the tensor at the given offset into the buffer without
+        waiting for the transfer to finish. The copy is ordered after previously
+        submitted work.
+
+        Parameters
+        ----------
+        buffer: Buffer
+            Buffer to copy to. Its size determines the amount of data copied
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
         """
         ...
-    def WaitFor(
-        self, timeline: hephaistos.pyhephaistos.Timeline, value: int
-    ) -> hephaistos.pyhephaistos.SequenceBuilder:
+    @property
+    def size(self) -> int:
         """
-        Issues the following steps to wait for the given timeline to reach the given value
+        The number of elements in this tensor.
         """
         ...
-    @overload
-    def WaitFor(self, value: int) -> hephaistos.pyhephaistos.SequenceBuilder:
+    @property
+    def size_bytes(self) -> int:
         """
-        Issues the following steps to wait on the sequence timeline to reach the given value.
+        The size of the tensor in bytes.
         """
         ...
-    def __init__(
-        self, timeline: hephaistos.pyhephaistos.Timeline, startValue: int
-    ) -> None:
+    def update(self, addr: int, n: int, offset: int = 0, /) -> None:
         """
-        Creates a new SequenceBuilder.
+        Updates the tensor at the given offset with n elements stored at addr.
 
         Parameters
         ----------
-        timeline: Timeline
-            Timeline to use for orchestrating commands and subroutines
-        startValue: int
-            Counter value to wait for on the timeline to start with
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        
+        Note
+        ----
+        This operation is only guaranteed to succeed on mapped tensors.
         """
         ...
-    @overload
-    def __init__(self, timeline: hephaistos.pyhephaistos.Timeline) -> None:
+    def updateAsync(self, addr: int, n: int, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
         """
-        Creates a new SequenceBuilder.
+        Updates the tensor at the given offset with n elements from addr without
+        waiting for the transfer to finish. The data is staged before returning,
+        thus the memory at addr can be reused directly. The copy is ordered after
+        previously submitted work.
 
         Parameters
         ----------
-        timeline: Timeline
-            Timeline to use for orchestrating commands and subroutines
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in number of elements where the copy starts
         """
         ...
-    def printWaitGraph(self) -> str:
+
+class FillTensorCommand:
+    """
+    Command for filling a tensor with a repeated pattern of arbitrary size
+    """
+
+    def __init__(
+        self,
+        tensor: hephaistos.pyhephaistos.Tensor,
+        pattern: bytes,
+        offset: Optional[int] = None,
+        size: Optional[int] = None,
+        unsafe: bool = False,
+    ) -> None:
         """
-        Returns a visualization of the current wait graph in the form:
-        (Timeline.ID(WaitValue))* -> (submissions) -> (Timeline.ID(SignalValue)).
-        Must be called before Submit().
+        Creates a command for filling a tensor with a repeated pattern over a
+        given range. Defaults to filling the complete tensor
         """
         ...
 
-class ShortBuffer:
+class FlushMemoryCommand:
+    """
+    Command for flushing memory writes
     """
-    Buffer representing memory allocated on the host holding an array of type
-    int16 and given size which can be accessed as numpy array.
 
-    Parameters
-    ----------
-    size: int
-        Number of elements
+    ...
+
+class GenerateMipmapsCommand:
+    """
+    Command for generating the mip chain of the texture from its first level
     """
 
-    def __init__(self, size: int) -> None: ...
-    def numpy(self) -> numpy.typing.NDArray:
+    def __init__(self, texture: hephaistos.pyhephaistos.Texture) -> None: ...
+
+class Geometry:
+    """
+    Underlying structure Acceleration Structures use to trace rays against
+    constructed from Meshes or BoundingBoxes.
+    """
+
+    def __init__(self) -> None: ...
+    @property
+    def blas_address(self) -> int:
         """
-        Returns a numpy array using this buffer's memory.
+        device address of the underlying blas
         """
         ...
-    @property
-    def size(self) -> int:
+    @blas_address.setter
+    def blas_address(self, arg: int, /) -> None:
         """
-        The number of elements in this buffer.
+        device address of the underlying blas
         """
         ...
     @property
-    def size_bytes(self) -> int:
+    def indices_address(self) -> int:
         """
-        The size of the buffer in bytes.
+        device address of the index buffer, or zero if it was discarded or is
+        non existent
         """
         ...
-
-class ShortTensor:
-    """
-    Tensor representing memory allocated on the device holding an array of type
-    int16 and given size. If mapped can be accessed from the host using its
-    memory address. Mapping can optionally be requested but will be ignored if
-    the device does not support it. Query its support after creation via isMapped.
-    """
-
-    def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
+    @indices_address.setter
+    def indices_address(self, arg: int, /) -> None:
         """
-        Creates a new tensor and fills it with the provided data
-
-        Parameters
-        ----------
-        array: NDArray
-            Numpy array containing the data used to fill the tensor.
-            Its type must match the tensor's.
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        device address of the index buffer, or zero if it was discarded or is
+        non existent
         """
         ...
-    @overload
-    def __init__(self, size: int, mapped: bool = False) -> None:
+    @property
+    def vertices_address(self) -> int:
         """
-        Creates a new tensor of given size.
-
-        Parameters
-        ----------
-        size: int
-            Number of elements
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        device address of the vertex or box buffer or zero if it was discarded
         """
         ...
-    @overload
-    def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
+    @vertices_address.setter
+    def vertices_address(self, arg: int, /) -> None:
         """
-        Creates a new tensor and fills it with the provided data
-
-        Parameters
-        ----------
-        addr: int
-            Address of the data used to fill the tensor
-        n: int
-            Number of bytes to copy from addr
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        device address of the vertex or box buffer or zero if it was discarded
         """
         ...
+
+class GeometryInstance:
+    """
+    Building blocks of Acceleration Structures containing a reference to a
+    Geometry along a transformation to be applied to the underlying mesh as
+    well as additional information.
+    """
+
+    def __init__(self) -> None: ...
     @property
-    def address(self) -> int:
-        """
-        The device address of this tensor.
-        """
-        ...
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: str
-    ) -> None:
+    def blas_address(self) -> int:
         """
-        Binds the tensor to the program at the given binding
+        device address of the referenced BLAS/geometry
         """
         ...
-    @overload
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: int
-    ) -> None:
+    @blas_address.setter
+    def blas_address(self, arg: int, /) -> None:
         """
-        Binds the tensor to the program at the given binding
+        device address of the referenced BLAS/geometry
         """
         ...
-    def flush(self, offset: int = 0, size: int | None = None, /) -> None:
+    @property
+    def customIndex(self) -> int:
         """
-        Makes writes in mapped memory from the host available to the device.
-        Only needed if isNonCoherent is True.
-
-        Parameters
-        ----------
-        offset: int, default=0
-            Offset in amount of elements into mapped memory to flush
-        size: int|None, default=None
-            Number of elements to flush starting at offset.
-            If None, flushes all remaining elements.
+        The custom index of this instance available in the shader.
         """
         ...
-    def invalidate(self, offset: int = 0, size: int | None = None, /) -> None:
+    @customIndex.setter
+    def customIndex(self, arg: int, /) -> None:
         """
-        Makes writes in mapped memory from the device available to the host.
-        Only needed if isNonCoherent is True.
-
-        Parameters
-        ----------
-        offset: int, default=0
-            Offset in amount of elements into mapped memory to invalidate
-        size: int | None, default=None
-            Number of elements to invalidate starting at offset.
-            If None, invalidates all remaining elements.
+        The custom index of this instance available in the shader.
         """
         ...
     @property
-    def isMapped(self) -> bool:
+    def mask(self) -> int:
         """
-        True, if the underlying memory is writable by the CPU.
+        Mask of this instance used for masking ray traces.
         """
         ...
-    @property
-    def isNonCoherent(self) -> bool:
+    @mask.setter
+    def mask(self, arg: int, /) -> None:
         """
-        Wether calls to flush() and invalidate() are necessary to make changes
-        in mapped memory between devices and host available
+        Mask of this instance used for masking ray traces.
         """
         ...
     @property
-    def memory(self) -> int:
+    def transform(self) -> numpy.typing.NDArray:
         """
-        Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
+        The transformation applied to the referenced geometry.
         """
         ...
-    def retrieve(self, addr: int, n: int, offset: int = 0, /) -> None:
+    @transform.setter
+    def transform(self, arg: numpy.typing.NDArray, /) -> None:
         """
-        Retrieves n elements from the tensor at the given offset and stores it
-        in dst.
-
-        Parameters
-        ----------
-        addr: int
-            Address of memory to copy to
-        n: int
-            Amount of elements to copy
-        offset: int, default=0
-            Offset into the tensor in amount of elements where the copy starts
-        
-        Note
-        ----
-        This operation is only guaranteed to succeed on mapped tensors.
+        The transformation applied to the referenced geometry.
         """
         ...
-    @property
-    def size(self) -> int:
+
+class GeometryInstanceVector:
+    """
+    List of GeometryInstance
+    """
+
+    def __init__(
+        self, arg: Iterable[hephaistos.pyhephaistos.GeometryInstance], /
+    ) -> None:
         """
-        The number of elements in this tensor.
+        Construct from an iterable object
         """
         ...
-    @property
-    def size_bytes(self) -> int:
+    @overload
+    def __init__(self) -> None:
         """
-        The size of the tensor in bytes.
+        Default constructor
         """
         ...
-    def update(self, addr: int, n: int, offset: int = 0, /) -> None:
+    @overload
+    def __init__(self, arg: hephaistos.pyhephaistos.GeometryInstanceVector) -> None:
         """
-        Updates the tensor at the given offset with n elements stored at addr.
-
-        Parameters
-        ----------
-        addr: int
-            Address of memory to copy from
-        n: int
-            Amount of elements to copy
-        offset: int, default=0
-            Offset into the tensor in amount of elements where the copy starts
-        
-        Note
-        ----
-        This operation is only guaranteed to succeed on mapped tensors.
+        Copy constructor
         """
         ...
-
-class StopWatch:
-    """
-    Allows the measuring of elapsed time between commands execution
-    
-    """
-
-    def __init__(self) -> None:
+    def append(self, arg: hephaistos.pyhephaistos.GeometryInstance, /) -> None:
         """
-        Creates a new stopwatch for measuring elapsed time between commands.
+        Append `arg` to the end of the list.
         """
         ...
-    def getElapsedTime(self, wait: bool = False) -> list[float]:
+    def clear(self) -> None:
         """
-        Retrieves the elapsed time between start() and stop() in nanoseconds.
-        If wait = True, blocks the caller until all timestamps are available,
-        otherwise returns NaN.
+        Remove all items from list.
         """
         ...
-    def reset(self) -> None:
+    def extend(self, arg: hephaistos.pyhephaistos.GeometryInstanceVector, /) -> None:
         """
-        Resets the stop watch.
+        Extend `self` by appending elements from `arg`.
         """
         ...
-    def start(self) -> hephaistos.pyhephaistos.Command:
+    def insert(
+        self, arg0: int, arg1: hephaistos.pyhephaistos.GeometryInstance, /
+    ) -> None:
         """
-        Returns the command to start the stop watch.
+        Insert object `arg1` before index `arg0`.
         """
         ...
-    def stop(self) -> hephaistos.pyhephaistos.Command:
+    def pop(self, index: int = -1) -> hephaistos.pyhephaistos.GeometryInstance:
         """
-        Returns the command to stop the stop watch. Can be recorded multiple
-        times to record up to stopCount stop times.
+        Remove and return item at `index` (default last).
         """
         ...
 
-class SubgroupProperties:
+class GeometryStore:
     """
-    List of subgroup properties and supported operations
+    Handles the creation of Geometries using Meshes and their lifetime
+
+    Parameters
+    ----------
+    meshes: Mesh[]
+        List of meshes used for creating Geometries
+    keepMeshData: bool, default=True
+        If True, keeps the mesh data on the GPU after building Geometries.
+    options: BuildOptions, default=BuildOptions()
+        Options used for building. allowUpdate implies keepMeshData.
     """
 
-    @property
-    def arithmeticSupport(self) -> bool:
+    def __init__(
+        self,
+        meshes: hephaistos.pyhephaistos.MeshVector,
+        keepMeshData: bool = True,
+        options: hephaistos.pyhephaistos.BuildOptions = BuildOptions(),
+    ) -> None:
         """
-        Support for GL_KHR_shader_subgroup_arithmetic
+        Creates a geometry store responsible for managing the BLAS/geometries
+        used to create and run acceleration structures.
         """
         ...
-    @property
-    def ballotSupport(self) -> bool:
+    @overload
+    def __init__(
+        self,
+        meshes: hephaistos.pyhephaistos.TensorMeshVector,
+        options: hephaistos.pyhephaistos.BuildOptions = BuildOptions(),
+    ) -> None:
         """
-        Support for GL_KHR_shader_subgroup_ballot
+        Creates a geometry store from meshes whose data is read directly from
+        tensors.
         """
         ...
-    @property
-    def basicSupport(self) -> bool:
+    @overload
+    def __init__(
+        self,
+        boxes: hephaistos.pyhephaistos.BoundingBoxesVector,
+        keepBoxData: bool = True,
+        options: hephaistos.pyhephaistos.BuildOptions = BuildOptions(),
+    ) -> None:
         """
-        Support for GL_KHR_shader_subgroup_basic
+        Creates a geometry store from procedural geometry. The box data is
+        accessible via the geometries' vertices_address.
         """
         ...
-    @property
-    def quadSupport(self) -> bool:
+    @overload
+    def __init__(
+        self,
+        serialized: bytes,
+        meshes: hephaistos.pyhephaistos.MeshVector,
+        options: hephaistos.pyhephaistos.BuildOptions = BuildOptions(),
+    ) -> None:
         """
-        Support for GL_KHR_shader_subgroup_quad
+        Loads the geometries from data returned by serialize(). Falls back to
+        building them from the meshes if the data is incompatible with the
+        device.
         """
         ...
-    @property
-    def shuffleClusteredSupport(self) -> bool:
+    @overload
+    def __init__(
+        self,
+        path: os.PathLike,
+        keepMeshData: bool = True,
+        options: hephaistos.pyhephaistos.BuildOptions = BuildOptions(),
+    ) -> None:
         """
-        Support for GL_KHR_shader_subgroup_clustered
+        Creates a geometry store from a mesh file written by saveMeshes().
+        Streams the mesh data in chunks from the mapped file to the GPU without
+        loading it into host memory as a whole.
         """
         ...
     @property
-    def shuffleRelativeSupport(self) -> bool:
+    def buildSizes(self) -> hephaistos.pyhephaistos.BuildSizes:
         """
-        Support for GL_KHR_shader_subgroup_shuffle_relative
+        Sizes of all geometries before and after compaction
         """
         ...
-    @property
-    def shuffleSupport(self) -> bool:
+    def createInstance(self, idx: int) -> hephaistos.pyhephaistos.GeometryInstance:
         """
-        Support for GL_KHR_shader_subgroup_shuffle
+        Creates a new instance of the specified geometry
         """
         ...
     @property
-    def subgroupSize(self) -> int:
+    def deserialized(self) -> bool:
         """
-        Threads per subgroup
+        Whether the geometries were loaded from serialized data
         """
         ...
     @property
-    def voteSupport(self) -> bool:
+    def geometries(self) -> hephaistos.pyhephaistos.GeometryVector:
         """
-        Support for GL_KHR_shader_subgroup_vote
+        Returns the list of stored geometries
         """
         ...
-
-class Submission:
-    """
-    Submissions are issued after work has been submitted to the device and can
-    be used to wait for its completion.
-    """
-
-    @property
-    def finalStep(self) -> int:
+    def serialize(self) -> bytes:
         """
-        The value the timeline will reach when the submission finishes.
+        Serializes the geometries, so they can be loaded later on without
+        building them. The data is only compatible with the same device and
+        driver.
         """
         ...
     @property
-    def forgettable(self) -> bool:
+    def size(self) -> int:
         """
-        True, if the Submission can be discarded safely, i.e. fire and forget.
+        Number of geometries stored
         """
         ...
     @property
-    def timeline(self) -> hephaistos.pyhephaistos.Timeline:
-        """
-        The timeline this submission was issued with.
-        """
-        ...
-    def wait(self) -> None:
-        """
-        Blocks the caller until the submission finishes.
-        """
-        ...
-    def waitTimeout(self, ns: int) -> bool:
+    def updatable(self) -> bool:
         """
-        Blocks the caller until the submission finished or the specified time
-        elapsed. Returns True in the first, False in the second case.
+        Whether the geometries can be refit to new vertex positions
         """
         ...
 
-class Subroutine:
+class GeometryVector:
     """
-    Subroutines are reusable sequences of commands that can be submitted
-    multiple times to the device. Recording sequence of commands require non
-    negligible CPU time and may be amortized by reusing sequences via Subroutines.
+    List of Geometry
     """
 
-    @property
-    def simultaneousUse(self) -> bool:
+    def __init__(self, arg: Iterable[hephaistos.pyhephaistos.Geometry], /) -> None:
         """
-        True, if the subroutine can be used simultaneous
+        Construct from an iterable object
         """
         ...
-
-class Tensor:
-    """
-    Base class for all tensors managing memory allocations on the device
-    """
-
-    ...
-
-class Texture:
-    """
-    Allocates memory on the device using a memory layout it deems optimal for
-    images and presents it inside programs as texture allowing filtered lookups.
-    The filter methods can specified
-
-    Parameters
-    ----------
-    format: ImageFormat
-        Format of the image
-    width: int
-        Width of the image in pixels
-    height: int, default=1
-        Height of the image in pixels
-    depth: int, default=1
-        Depth of the image in pixels
-    filter: 'nearest'|'n'|'linear'|'l', default='linear'
-        Method used to interpolate between pixels
-    unnormalized: bool, default=False
-        If True, use coordinates in pixel space rather than normalized ones
-        inside programs
-    modeU: 'repeat'|'r'|'mirrored repeat'|'mr'|'clamp edge'|'ce'|'mirrored clamp edge'|'mce', default='repeat'
-        Method used to handle out of range coordinates in U dimension
-    modeV: 'repeat'|'r'|'mirrored repeat'|'mr'|'clamp edge'|'ce'|'mirrored clamp edge'|'mce', default='repeat'
-        Method used to handle out of range coordinates in V dimension
-    modeW: 'repeat'|'r'|'mirrored repeat'|'mr'|'clamp edge'|'ce'|'mirrored clamp edge'|'mce', default='repeat'
-        Method used to handle out of range coordinates in W dimension
-    """
-
-    def __init__(
-        format: hephaistos.pyhephaistos.ImageFormat,
-        width: int,
-        height: int = 1,
-        depth: int = 1,
-        *,
-        filter: Literal["nearest", "n", "linear", "l"] = "linear",
-        unnormalized: bool = False,
-        modeU: Literal[
-            "repeat",
-            "r",
-            "mirrored repeat",
-            "mr",
-            "clamp edge",
-            "ce",
-            "mirrored clamp edge",
-            "mce",
-        ] = "repeat",
-        modeV: Literal[
-            "repeat",
-            "r",
-            "mirrored repeat",
-            "mr",
-            "clamp edge",
-            "ce",
-            "mirrored clamp edge",
-            "mce",
-        ] = "repeat",
-        modeW: Literal[
-            "repeat",
-            "r",
-            "mirrored repeat",
-            "mr",
-            "clamp edge",
-            "ce",
-            "mirrored clamp edge",
-            "mce",
-        ] = "repeat",
-    ) -> None: ...
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: str, /
-    ) -> None:
+    @overload
+    def __init__(self) -> None:
         """
-        Binds the texture to the program at the given binding
+        Default constructor
         """
         ...
     @overload
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: int, /
-    ) -> None:
+    def __init__(self, arg: hephaistos.pyhephaistos.GeometryVector) -> None:
         """
-        Binds the texture to the program at the given binding
+        Copy constructor
         """
         ...
-    @property
-    def depth(self) -> int:
+    def append(self, arg: hephaistos.pyhephaistos.Geometry, /) -> None:
         """
-        Depth of the texture in pixels
+        Append `arg` to the end of the list.
         """
         ...
-    @property
-    def format(self) -> hephaistos.pyhephaistos.ImageFormat:
+    def clear(self) -> None:
         """
-        Format of the texture
+        Remove all items from list.
         """
         ...
-    @property
-    def height(self) -> int:
+    def extend(self, arg: hephaistos.pyhephaistos.GeometryVector, /) -> None:
         """
-        Height of the texture in pixels
+        Extend `self` by appending elements from `arg`.
         """
         ...
-    @property
-    def size_bytes(self) -> int:
+    def insert(self, arg0: int, arg1: hephaistos.pyhephaistos.Geometry, /) -> None:
         """
-        Size the texture takes in a linear/compact memory layout in bytes. This
-        can differ from the actual size the texture takes on the device but can
-        be useful to allocate buffers for transferring the texture.
+        Insert object `arg1` before index `arg0`.
         """
         ...
-    @property
-    def width(self) -> int:
+    def pop(self, index: int = -1) -> hephaistos.pyhephaistos.Geometry:
         """
-        Width of the texture in pixels
+        Remove and return item at `index` (default last).
         """
         ...
 
-class Timeline:
+class GrowableTensor:
     """
-    Timeline managing the execution of code and commands using an increasing
-    internal counter. Both GPU and CPU can wait and/or increase this counter
-    thus creating a synchronization between them or among themselves. The
-    current value of the counter can be queried allowing an asynchronous method
-    of reporting the progress.
-
-    Parameters
-    ----------
-    value: int, default=0
-        Initial value of the internal counter
+    Tensor growing its memory on demand by at least doubling its capacity and
+    copying the content on the device. Programs bound to it pick up the new
+    memory on their next dispatch. Shaders accessing it via its address should
+    read the current one from addressSlot. Growing waits for work on the main
+    queue. Recorded subroutines, sequence templates, task graphs, parameter
+    sets and dispatch lists referencing it must be recreated after growing.
     """
 
-    def __init__(self, initialValue: int) -> None: ...
-    @overload
-    def __init__(self) -> None: ...
+    def __init__(self, size: int, capacity: int = 0) -> None:
+        """
+        Allocates a new growable tensor with the given size and capacity in
+        bytes. The capacity is at least the size.
+        """
+        ...
     @property
-    def id(self) -> int:
+    def address(self) -> int:
         """
-        Id of this timeline
+        The device address of this tensor. Changes when growing.
         """
         ...
     @property
-    def value(self) -> int:
+    def addressSlot(self) -> hephaistos.pyhephaistos.Tensor:
         """
-        Returns or sets the current value of the timeline. Note that the value
-        can only increase. Disobeying this requirement results in undefined
-        behavior.
+        Tensor holding the current address as a single uint64
         """
         ...
-    @value.setter
-    def value(self, arg: int, /) -> None:
+    @property
+    def capacity(self) -> int:
         """
-        Returns or sets the current value of the timeline. Note that the value
-        can only increase. Disobeying this requirement results in undefined
-        behavior.
+        Size of the allocated memory in bytes
         """
         ...
-    def wait(self, value: int) -> None:
+    def reserve(self, capacity: int) -> None:
         """
-        Waits for the timeline to reach the given value.
+        Ensures the capacity is at least the given amount of bytes.
         """
         ...
-    def waitTimeout(self, value: int, timeout: int) -> bool:
+    def resize(self, size: int) -> None:
         """
-        Waits for the timeline to reach the given value for a certain amount.
-        Returns True if the value was reached and False if it timed out.
-
-        Parameters
-        ----------
-        value: int
-            Value to wait for
-        timeout: int
-            Time in nanoseconds to wait. May be rounded to the closest internal
-            precision of the device clock.
+        Changes the size of the tensor in bytes, growing its memory if needed.
+        Content beyond the old size is undefined.
         """
         ...
-
-
-class TypeSupport:
-    """List of supported extended types, e.g. float64"""
-
     @property
-    def float64(self) -> bool: ...
-    @property
-    def float16(self) -> bool: ...
-    @property
-    def int64(self) -> bool: ...
-    @property
-    def int16(self) -> bool: ...
-    @property
-    def int8(self) -> bool: ...
-
+    def size_bytes(self) -> int:
+        """
+        The size of the tensor in bytes.
+        """
+        ...
 
-class UnsignedIntBuffer:
+class HalfBuffer:
     """
     Buffer representing memory allocated on the host holding an array of type
-    uint32 and given size which can be accessed as numpy array.
+    float16 and given size which can be accessed as numpy array or via the buffer
+    protocol, e.g. memoryview(buffer), without copies.
 
     Parameters
     ----------
@@ -2989,6 +3378,7 @@ class UnsignedIntBuffer:
         Number of elements
     """
 
+    def __buffer__(self, flags: int, /) -> memoryview: ...
     def __init__(self, size: int) -> None: ...
     def numpy(self) -> numpy.typing.NDArray:
         """
@@ -3008,14 +3398,17 @@ class UnsignedIntBuffer:
         """
         ...
 
-class UnsignedIntTensor:
+class HalfTensor:
     """
     Tensor representing memory allocated on the device holding an array of type
-    uint32 and given size. If mapped can be accessed from the host using its
+    float16 and given size. If mapped can be accessed from the host using its
     memory address. Mapping can optionally be requested but will be ignored if
-    the device does not support it. Query its support after creation via isMapped.
+    the device does not support it. Query its support after creation via
+    isMapped. Mapped tensors support the buffer protocol, e.g.
+    memoryview(tensor).
     """
 
+    def __buffer__(self, flags: int, /) -> memoryview: ...
     def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
         """
         Creates a new tensor and fills it with the provided data
@@ -3043,6 +3436,26 @@ class UnsignedIntTensor:
         """
         ...
     @overload
+    def __init__(
+        self,
+        size: int,
+        hints: hephaistos.pyhephaistos.AllocationHints,
+        mapped: bool = False,
+    ) -> None:
+        """
+        Creates a new tensor of given size using the given allocation hints.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        hints: AllocationHints
+            Hints for allocating the memory
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
     def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
         """
         Creates a new tensor and fills it with the provided data
@@ -3064,18 +3477,22 @@ class UnsignedIntTensor:
         """
         ...
     def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: str
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
     ) -> None:
         """
-        Binds the tensor to the program at the given binding
+        Binds the tensor to the program or parameter set at the given binding
         """
         ...
     @overload
     def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: int
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
     ) -> None:
         """
-        Binds the tensor to the program at the given binding
+        Binds the tensor to the program or parameter set at the given binding
         """
         ...
     def flush(self, offset: int = 0, size: int | None = None, /) -> None:
@@ -3107,6 +3524,13 @@ class UnsignedIntTensor:
         """
         ...
     @property
+    def isAllocated(self) -> bool:
+        """
+        True, if the tensor's memory was allocated. Only False for lazily
+        allocated tensors not used yet.
+        """
+        ...
+    @property
     def isMapped(self) -> bool:
         """
         True, if the underlying memory is writable by the CPU.
@@ -3120,6 +3544,12 @@ class UnsignedIntTensor:
         """
         ...
     @property
+    def isPooled(self) -> bool:
+        """
+        True, if the tensor is sub-allocated from a shared buffer.
+        """
+        ...
+    @property
     def memory(self) -> int:
         """
         Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
@@ -3144,6 +3574,20 @@ class UnsignedIntTensor:
         This operation is only guaranteed to succeed on mapped tensors.
         """
         ...
+    def retrieveAsync(self, buffer: hephaistos.pyhephaistos.Buffer, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Copies data from the tensor at the given offset into the buffer without
+        waiting for the transfer to finish. The copy is ordered after previously
+        submitted work.
+
+        Parameters
+        ----------
+        buffer: Buffer
+            Buffer to copy to. Its size determines the amount of data copied
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        """
+        ...
     @property
     def size(self) -> int:
         """
@@ -3174,723 +3618,8893 @@ class UnsignedIntTensor:
         This operation is only guaranteed to succeed on mapped tensors.
         """
         ...
+    def updateAsync(self, addr: int, n: int, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Updates the tensor at the given offset with n elements from addr without
+        waiting for the transfer to finish. The data is staged before returning,
+        thus the memory at addr can be reused directly. The copy is ordered after
+        previously submitted work.
 
-class UnsignedLongBuffer:
-    """
-    Buffer representing memory allocated on the host holding an array of type
-    uint64 and given size which can be accessed as numpy array.
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in number of elements where the copy starts
+        """
+        ...
 
-    Parameters
-    ----------
-    size: int
-        Number of elements
+class HeaderMap:
+    """
+    Dict mapping filepaths to shader source code. Consumed by Compiler to
+    resolve include directives.
     """
 
-    def __init__(self, size: int) -> None: ...
-    def numpy(self) -> numpy.typing.NDArray:
+    class ItemView: ...
+    class KeyView: ...
+    class ValueView: ...
+
+    def __init__(self, arg: dict[str, str], /) -> None:
         """
-        Returns a numpy array using this buffer's memory.
+        Construct from a dictionary
         """
         ...
-    @property
-    def size(self) -> int:
+    @overload
+    def __init__(self) -> None:
         """
-        The number of elements in this buffer.
+        Default constructor
         """
         ...
-    @property
-    def size_bytes(self) -> int:
+    @overload
+    def __init__(self, arg: hephaistos.pyhephaistos.HeaderMap) -> None:
         """
-        The size of the buffer in bytes.
+        Copy constructor
         """
         ...
-
-class UnsignedLongTensor:
-    """
-    Tensor representing memory allocated on the device holding an array of type
-    uint64 and given size. If mapped can be accessed from the host using its
-    memory address. Mapping can optionally be requested but will be ignored if
-    the device does not support it. Query its support after creation via isMapped.
-    """
-
-    def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
+    def clear(self) -> None:
         """
-        Creates a new tensor and fills it with the provided data
-
-        Parameters
-        ----------
-        array: NDArray
-            Numpy array containing the data used to fill the tensor.
-            Its type must match the tensor's.
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        Remove all items
         """
         ...
-    @overload
-    def __init__(self, size: int, mapped: bool = False) -> None:
+    def items(self) -> hephaistos.pyhephaistos.HeaderMap.ItemView:
         """
-        Creates a new tensor of given size.
-
-        Parameters
-        ----------
-        size: int
-            Number of elements
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        Returns an iterable view of the map's items.
         """
         ...
-    @overload
-    def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
+    def keys(self) -> hephaistos.pyhephaistos.HeaderMap.KeyView:
         """
-        Creates a new tensor and fills it with the provided data
-
-        Parameters
-        ----------
-        addr: int
-            Address of the data used to fill the tensor
-        n: int
-            Number of bytes to copy from addr
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        Returns an iterable view of the map's keys.
         """
         ...
-    @property
-    def address(self) -> int:
+    def update(self, arg: hephaistos.pyhephaistos.HeaderMap, /) -> None:
         """
-        The device address of this tensor.
+        Update the map with element from `arg`
         """
         ...
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: str
-    ) -> None:
+    def values(self) -> hephaistos.pyhephaistos.HeaderMap.ValueView:
         """
-        Binds the tensor to the program at the given binding
+        Returns an iterable view of the map's values.
         """
         ...
-    @overload
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: int
-    ) -> None:
+
+class HeapStatistics:
+    """
+    Memory usage of a single memory heap
+    """
+
+    @property
+    def allocationBytes(self) -> int:
         """
-        Binds the tensor to the program at the given binding
+        Bytes occupied by resources inside the heap's blocks
         """
         ...
-    def flush(self, offset: int = 0, size: int | None = None, /) -> None:
+    @property
+    def allocationCount(self) -> int:
         """
-        Makes writes in mapped memory from the host available to the device.
-        Only needed if isNonCoherent is True.
-
-        Parameters
-        ----------
-        offset: int, default=0
-            Offset in amount of elements into mapped memory to flush
-        size: int|None, default=None
-            Number of elements to flush starting at offset.
-            If None, flushes all remaining elements.
+        Number of resources occupying the heap's blocks
         """
         ...
-    def invalidate(self, offset: int = 0, size: int | None = None, /) -> None:
+    @property
+    def blockBytes(self) -> int:
         """
-        Makes writes in mapped memory from the device available to the host.
-        Only needed if isNonCoherent is True.
-
-        Parameters
-        ----------
-        offset: int, default=0
-            Offset in amount of elements into mapped memory to invalidate
-        size: int | None, default=None
-            Number of elements to invalidate starting at offset.
-            If None, invalidates all remaining elements.
+        Bytes allocated in device memory blocks
         """
         ...
     @property
-    def isMapped(self) -> bool:
+    def blockCount(self) -> int:
         """
-        True, if the underlying memory is writable by the CPU.
+        Number of device memory blocks allocated from the heap
         """
         ...
     @property
-    def isNonCoherent(self) -> bool:
+    def budget(self) -> int:
         """
-        Wether calls to flush() and invalidate() are necessary to make changes
-        in mapped memory between devices and host available
+        Estimated bytes this process can use before allocations start to fail or
+        degrade performance. Only accurate if isMemoryBudgetSupported() returns
+        True, otherwise a heuristic based on the heap size.
         """
         ...
     @property
-    def memory(self) -> int:
+    def deviceLocal(self) -> bool:
         """
-        Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
+        True, if the heap is local to the device, i.e. backs tensors
         """
         ...
-    def retrieve(self, addr: int, n: int, offset: int = 0, /) -> None:
+    @property
+    def largestFreeRange(self) -> int:
         """
-        Retrieves n elements from the tensor at the given offset and stores it
-        in dst.
-
-        Parameters
-        ----------
-        addr: int
-            Address of memory to copy to
-        n: int
-            Amount of elements to copy
-        offset: int, default=0
-            Offset into the tensor in amount of elements where the copy starts
-        
-        Note
-        ----
-        This operation is only guaranteed to succeed on mapped tensors.
+        Size of the largest free range inside any existing block
         """
         ...
     @property
     def size(self) -> int:
         """
-        The number of elements in this tensor.
+        Size of the heap in bytes
         """
         ...
     @property
-    def size_bytes(self) -> int:
+    def usage(self) -> int:
         """
-        The size of the tensor in bytes.
+        Bytes currently used by this process, including overhead
         """
         ...
-    def update(self, addr: int, n: int, offset: int = 0, /) -> None:
-        """
-        Updates the tensor at the given offset with n elements stored at addr.
 
-        Parameters
-        ----------
-        addr: int
-            Address of memory to copy from
-        n: int
-            Amount of elements to copy
-        offset: int, default=0
-            Offset into the tensor in amount of elements where the copy starts
-        
-        Note
-        ----
-        This operation is only guaranteed to succeed on mapped tensors.
-        """
-        ...
+class HistogramStrategy:
+    """
+    Strategy used to accumulate a histogram
+    """
 
-class UnsignedShortBuffer:
+    AUTO: HistogramStrategy
+    """
+    Picks the strategy based on the bins and enabled atomics
     """
-    Buffer representing memory allocated on the host holding an array of type
-    uint16 and given size which can be accessed as numpy array.
 
-    Parameters
-    ----------
-    size: int
-        Number of elements
+    GLOBAL: HistogramStrategy
+    """
+    Accumulates directly into the output using buffer atomics
     """
 
-    def __init__(self, size: int) -> None: ...
-    def numpy(self) -> numpy.typing.NDArray:
+    SHARED: HistogramStrategy
+    """
+    Accumulates into a private copy of the bins per workgroup in shared memory,
+    which gets merged into the output afterwards
+    """
+
+    SUBGROUP: HistogramStrategy
+    """
+    Like SHARED, but first combines items of a subgroup falling into the same
+    bin. Lowers contention on few very full bins. Falls back to buffer atomics
+    if the bins exceed shared memory.
+    """
+
+    DETERMINISTIC: HistogramStrategy
+    """
+    Sums the items of each workgroup per bin in a fixed order and merges these
+    partial bins in order afterwards. Produces bit-identical float bins across
+    runs and needs no atomics, but its cost grows with the amount of bins.
+    """
+
+class HitGroup:
+    """
+    Shaders forming a hit group of a RayTracingProgram. Each stage is
+    optional. Groups with an intersection shader are procedural, while groups
+    without one are used for triangles.
+    """
+
+    def __init__(
+        self,
+        closestHit: bytes = b"",
+        anyHit: bytes = b"",
+        intersection: bytes = b"",
+    ) -> None: ...
+    @property
+    def anyHit(self) -> bytes:
         """
-        Returns a numpy array using this buffer's memory.
+        Compiled any hit shader. Empty if none.
         """
         ...
+    @anyHit.setter
+    def anyHit(self, arg: bytes, /) -> None: ...
     @property
-    def size(self) -> int:
+    def closestHit(self) -> bytes:
         """
-        The number of elements in this buffer.
+        Compiled closest hit shader. Empty if none.
         """
         ...
+    @closestHit.setter
+    def closestHit(self, arg: bytes, /) -> None: ...
     @property
-    def size_bytes(self) -> int:
+    def intersection(self) -> bytes:
         """
-        The size of the buffer in bytes.
+        Compiled intersection shader. Empty for triangle geometries.
         """
         ...
+    @intersection.setter
+    def intersection(self, arg: bytes, /) -> None: ...
 
-class UnsignedShortTensor:
+class HugePages:
     """
-    Tensor representing memory allocated on the device holding an array of type
-    uint16 and given size. If mapped can be accessed from the host using its
-    memory address. Mapping can optionally be requested but will be ignored if
-    the device does not support it. Query its support after creation via isMapped.
+    Kind of pages backing host memory
     """
 
-    def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
-        """
-        Creates a new tensor and fills it with the provided data
+    EXPLICIT: HugePages
 
-        Parameters
-        ----------
-        array: NDArray
-            Numpy array containing the data used to fill the tensor.
-            Its type must match the tensor's.
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+    NONE: HugePages
+
+    TRANSPARENT: HugePages
+
+class Image:
+    """
+    Allocates memory on the device using a memory layout it deems optimal for
+    images presenting it inside programs as storage images thus allowing reads
+    and writes to it.
+
+    Parameters
+    ----------
+    format: ImageFormat
+        Format of the image
+    width: int
+        Width of the image in pixels
+    height: int, default=1
+        Height of the image in pixels
+    depth: int, default=1
+        Depth of the image in pixels
+    layers: int, default=0
+        Number of array layers. Zero creates a plain image. Arrays require a
+        depth of one.
+    hints: None|AllocationHints, default=None
+        Optional hints for allocating the image's memory
+    """
+
+    def __init__(
+        self,
+        format: hephaistos.pyhephaistos.ImageFormat,
+        width: int,
+        height: int = 1,
+        depth: int = 1,
+        layers: int = 0,
+        hints: Optional[hephaistos.pyhephaistos.AllocationHints] = None,
+    ) -> None: ...
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
+        /,
+    ) -> None:
+        """
+        Binds the image to the program or parameter set at the given binding
         """
         ...
     @overload
-    def __init__(self, size: int, mapped: bool = False) -> None:
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
+        /,
+    ) -> None:
         """
-        Creates a new tensor of given size.
-
-        Parameters
-        ----------
-        size: int
-            Number of elements
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        Binds the image to the program or parameter set at the given binding
         """
         ...
-    @overload
-    def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
+    @property
+    def depth(self) -> int:
         """
-        Creates a new tensor and fills it with the provided data
-
-        Parameters
-        ----------
-        addr: int
-            Address of the data used to fill the tensor
-        n: int
-            Number of bytes to copy from addr
-        mapped: bool, default=False
-            If True, tries to map memory to host address space
+        Depth of the image in pixels
         """
         ...
     @property
-    def address(self) -> int:
+    def format(self) -> hephaistos.pyhephaistos.ImageFormat:
         """
-        The device address of this tensor.
+        Format of the image
         """
         ...
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: str
-    ) -> None:
+    @property
+    def height(self) -> int:
         """
-        Binds the tensor to the program at the given binding
+        Height of the image in pixels
         """
         ...
-    @overload
-    def bindParameter(
-        self, program: hephaistos.pyhephaistos.Program, binding: int
-    ) -> None:
+    @property
+    def layers(self) -> int:
         """
-        Binds the tensor to the program at the given binding
+        Number of array layers. Zero if the image is not an array.
         """
         ...
-    def flush(self, offset: int = 0, size: int | None = None, /) -> None:
+    @property
+    def size_bytes(self) -> int:
         """
-        Makes writes in mapped memory from the host available to the device.
-        Only needed if isNonCoherent is True.
+        Size the image takes in a linear/compact memory layout in bytes. This
+        can differ from the actual size the image takes on the device but can
+        be useful to allocate buffers for transferring the image.
+        """
+        ...
+    @property
+    def width(self) -> int:
+        """
+        With of the image in pixels
+        """
+        ...
 
-        Parameters
-        ----------
-        offset: int, default=0
-            Offset in amount of elements into mapped memory to flush
-        size: int|None, default=None
-            Number of elements to flush starting at offset.
-            If None, flushes all remaining elements.
+class ImageBindingTraits:
+    """
+    Properties a binding expects from a bound image
+    """
+
+    @property
+    def arrayed(self) -> bool:
+        """
+        Whether the image is an array
         """
         ...
-    def invalidate(self, offset: int = 0, size: int | None = None, /) -> None:
+    @property
+    def dims(self) -> int:
         """
-        Makes writes in mapped memory from the device available to the host.
-        Only needed if isNonCoherent is True.
+        Image dimensions
+        """
+        ...
+    @property
+    def format(self) -> hephaistos.pyhephaistos.ImageFormat:
+        """
+        Expected image format
+        """
+        ...
+
+class ImageBuffer:
+    """
+    Utility class allocating memory on the host side in linear memory layout
+    allowing easy manipulating of 2D RGBA image data that can later be copied
+    to an image or texture. Provides additional methods for loading and saving
+    image data from and to disk in various file formats. Supports the formats
+    R8G8B8A8_UNORM, R16G16B16A16_UNORM and R32G32B32A32_SFLOAT.
+
+    Parameters
+    ----------
+    width: int
+        Width of the image in pixels
+    height: int
+        Height of the image in pixels
+    format: ImageFormat, default=ImageFormat.R8G8B8A8_UNORM
+        Format of the image
+    """
+
+    def __init__(
+        self,
+        width: int,
+        height: int,
+        format: hephaistos.pyhephaistos.ImageFormat = ImageFormat.R8G8B8A8_UNORM,
+    ) -> None: ...
+    def encode(
+        self,
+        fileFormat: hephaistos.pyhephaistos.ImageFileFormat = ImageFileFormat.AUTO,
+        compressionLevel: int = -1,
+    ) -> bytes:
+        """
+        Encodes the image in the given file format and returns it as bytes.
 
         Parameters
         ----------
-        offset: int, default=0
-            Offset in amount of elements into mapped memory to invalidate
-        size: int | None, default=None
-            Number of elements to invalidate starting at offset.
-            If None, invalidates all remaining elements.
+        fileFormat: ImageFileFormat, default=ImageFileFormat.AUTO
+            File format the image is encoded in
+        compressionLevel: int, default=-1
+            Compression level of PNG images from 0 to 9. Negative uses the
+            default.
         """
         ...
     @property
-    def isMapped(self) -> bool:
+    def format(self) -> hephaistos.pyhephaistos.ImageFormat:
         """
-        True, if the underlying memory is writable by the CPU.
+        Format of the image
         """
         ...
     @property
-    def isNonCoherent(self) -> bool:
+    def height(self) -> int:
         """
-        Wether calls to flush() and invalidate() are necessary to make changes
-        in mapped memory between devices and host available
+        Height of the image in pixels
         """
         ...
-    @property
-    def memory(self) -> int:
+    def loadFile(
+        filename: str,
+        format: hephaistos.pyhephaistos.ImageFormat = ImageFormat.R8G8B8A8_UNORM,
+    ) -> hephaistos.pyhephaistos.ImageBuffer:
         """
-        Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
+        Loads the image at the given filepath and returns a new ImageBuffer
+        using the given format
         """
         ...
-    def retrieve(self, addr: int, n: int, offset: int = 0, /) -> None:
+    def loadFiles(
+        filenames: list[str | os.PathLike],
+        format: hephaistos.pyhephaistos.ImageFormat = ImageFormat.R8G8B8A8_UNORM,
+    ) -> list[hephaistos.pyhephaistos.ImageBuffer]:
         """
-        Retrieves n elements from the tensor at the given offset and stores it
-        in dst.
+        Loads the images at the given filepaths in parallel and returns them
+        as a list of new ImageBuffers in the same order.
 
         Parameters
         ----------
-        addr: int
-            Address of memory to copy to
-        n: int
-            Amount of elements to copy
-        offset: int, default=0
-            Offset into the tensor in amount of elements where the copy starts
-        
-        Note
-        ----
-        This operation is only guaranteed to succeed on mapped tensors.
+        filenames: list[str | PathLike]
+            Paths to the images to load
+        format: ImageFormat, default=ImageFormat.R8G8B8A8_UNORM
+            Format of the loaded images
         """
         ...
-    @property
-    def size(self) -> int:
+    def loadMemory(
+        data: bytes,
+        format: hephaistos.pyhephaistos.ImageFormat = ImageFormat.R8G8B8A8_UNORM,
+    ) -> hephaistos.pyhephaistos.ImageBuffer:
         """
-        The number of elements in this tensor.
+        Loads serialized image data from memory and returns a new ImageBuffer
+
+        Parameters
+        ----------
+        data: bytes
+            Binary data containing the image data
+        format: ImageFormat, default=ImageFormat.R8G8B8A8_UNORM
+            Format of the loaded image
         """
         ...
-    @property
-    def size_bytes(self) -> int:
+    def numpy(self) -> numpy.typing.NDArray:
         """
-        The size of the tensor in bytes.
+        Returns a numpy array that allows to manipulate the data handled
+        by this ImageBuffer
         """
         ...
-    def update(self, addr: int, n: int, offset: int = 0, /) -> None:
+    def save(
+        self,
+        filename: str | os.PathLike,
+        fileFormat: hephaistos.pyhephaistos.ImageFileFormat = ImageFileFormat.AUTO,
+        compressionLevel: int = -1,
+    ) -> None:
         """
-        Updates the tensor at the given offset with n elements stored at addr.
+        Saves the image under the given filepath. By default, 8 and 16 bit
+        images are saved as PNG, floating point ones as Radiance HDR without
+        alpha.
 
         Parameters
         ----------
-        addr: int
-            Address of memory to copy from
-        n: int
-            Amount of elements to copy
-        offset: int, default=0
-            Offset into the tensor in amount of elements where the copy starts
-        
-        Note
-        ----
-        This operation is only guaranteed to succeed on mapped tensors.
+        filename: str | PathLike
+            Path to where to save the image
+        fileFormat: ImageFileFormat, default=ImageFileFormat.AUTO
+            File format the image is saved in
+        compressionLevel: int, default=-1
+            Compression level of PNG images from 0 to 9. Negative uses the
+            default.
         """
         ...
+    def saveAsync(
+        self,
+        filename: str | os.PathLike,
+        fileFormat: hephaistos.pyhephaistos.ImageFileFormat = ImageFileFormat.AUTO,
+        compressionLevel: int = -1,
+    ) -> hephaistos.pyhephaistos.PendingSave:
+        """
+        Saves the image in the background and returns a handle to wait on. The
+        image must not be changed until the save finished.
 
-class UpdateImageCommand:
+        Parameters
+        ----------
+        filename: str | PathLike
+            Path to where to save the image
+        fileFormat: ImageFileFormat, default=ImageFileFormat.AUTO
+            File format the image is saved in
+        compressionLevel: int, default=-1
+            Compression level of PNG images from 0 to 9. Negative uses the
+            default.
+        """
+        ...
+    @property
+    def width(self) -> int:
+        """
+        Width of the image in pixels
+        """
+        ...
+
+class ImageFileFormat:
     """
-    Command for copying data from the given buffer into the image
+    File format images are saved in
     """
 
-    def __init__(
-        self,
-        src: hephaistos.pyhephaistos.Buffer,
-        dst: hephaistos.pyhephaistos.Image,
-        /,
-    ) -> None: ...
+    AUTO: ImageFileFormat
 
-class UpdateTensorCommand:
+    HDR: ImageFileFormat
+
+    PNG: ImageFileFormat
+
+    PPM: ImageFileFormat
+
+    QOI: ImageFileFormat
+
+    TIFF: ImageFileFormat
+
+class ImageFormat:
     """
-    Command for copying the src buffer into the destination tensor
+    List of supported image formats
     """
 
-    def __init__(
-        self,
-        src: hephaistos.pyhephaistos.Buffer,
-        dst: hephaistos.pyhephaistos.Tensor,
-        bufferOffset: Optional[int] = None,
-        tensorOffset: Optional[int] = None,
-        size: Optional[int] = None,
-        unsafe: bool = False,
-    ) -> None: ...
+    ASTC_4x4_UNORM: ImageFormat
 
-class UpdateTextureCommand:
+    BC1_RGBA_UNORM: ImageFormat
+
+    BC3_UNORM: ImageFormat
+
+    BC4_SNORM: ImageFormat
+
+    BC4_UNORM: ImageFormat
+
+    BC5_SNORM: ImageFormat
+
+    BC5_UNORM: ImageFormat
+
+    BC6H_SFLOAT: ImageFormat
+
+    BC6H_UFLOAT: ImageFormat
+
+    BC7_UNORM: ImageFormat
+
+    ETC2_R8G8B8A8_UNORM: ImageFormat
+
+    R16G16B16A16_SINT: ImageFormat
+
+    R16G16B16A16_UINT: ImageFormat
+
+    R16G16B16A16_UNORM: ImageFormat
+
+    R32G32B32A32_SFLOAT: ImageFormat
+
+    R32G32B32A32_SINT: ImageFormat
+
+    R32G32B32A32_UINT: ImageFormat
+
+    R32G32_SFLOAT: ImageFormat
+
+    R32G32_SINT: ImageFormat
+
+    R32G32_UINT: ImageFormat
+
+    R32_SFLOAT: ImageFormat
+
+    R32_SINT: ImageFormat
+
+    R32_UINT: ImageFormat
+
+    R8G8B8A8_SINT: ImageFormat
+
+    R8G8B8A8_SNORM: ImageFormat
+
+    R8G8B8A8_UINT: ImageFormat
+
+    R8G8B8A8_UNORM: ImageFormat
+
+class ImageRegion:
     """
-    Command for copying data from the given buffer into the texture
+    Region of an image taking part in a copy. Describes a box inside one mip
+    level of an image as well as the layout of the corresponding data inside
+    the buffer. The default selects the whole first mip level tightly packed at
+    the start of the buffer.
     """
 
     def __init__(
         self,
-        src: hephaistos.pyhephaistos.Buffer,
-        dst: hephaistos.pyhephaistos.Texture,
-        /,
+        x: int = 0,
+        y: int = 0,
+        z: int = 0,
+        width: int = 0,
+        height: int = 0,
+        depth: int = 0,
+        mipLevel: int = 0,
+        layer: int = 0,
+        layerCount: int = 0,
+        bufferOffset: int = 0,
+        bufferRowLength: int = 0,
+        bufferImageHeight: int = 0,
     ) -> None: ...
-
-def beginSequence() -> hephaistos.pyhephaistos.SequenceBuilder:
-    """
-    Starts a new sequence.
-    """
-    ...
-
-@overload
-def beginSequence(
-    timeline: hephaistos.pyhephaistos.Timeline, startValue: int = 0
-) -> hephaistos.pyhephaistos.SequenceBuilder:
-    """
-    Starts a new sequence.
+    @property
+    def bufferImageHeight(self) -> int:
+        """
+        Number of rows per slice in the buffer. Zero means tightly packed.
+        """
+        ...
+    @bufferImageHeight.setter
+    def bufferImageHeight(self, arg: int, /) -> None:
+        """
+        Number of rows per slice in the buffer. Zero means tightly packed.
+        """
+        ...
+    @property
+    def bufferOffset(self) -> int:
+        """
+        Offset into the buffer in bytes. Must be a multiple of the pixel size.
+        """
+        ...
+    @bufferOffset.setter
+    def bufferOffset(self, arg: int, /) -> None:
+        """
+        Offset into the buffer in bytes. Must be a multiple of the pixel size.
+        """
+        ...
+    @property
+    def bufferRowLength(self) -> int:
+        """
+        Length of a row in the buffer in pixels. Zero means tightly packed.
+        """
+        ...
+    @bufferRowLength.setter
+    def bufferRowLength(self, arg: int, /) -> None:
+        """
+        Length of a row in the buffer in pixels. Zero means tightly packed.
+        """
+        ...
+    @property
+    def depth(self) -> int:
+        """
+        Depth of the region in pixels. Zero extends it to the image's edge.
+        """
+        ...
+    @depth.setter
+    def depth(self, arg: int, /) -> None:
+        """
+        Depth of the region in pixels. Zero extends it to the image's edge.
+        """
+        ...
+    @property
+    def height(self) -> int:
+        """
+        Height of the region in pixels. Zero extends it to the image's edge.
+        """
+        ...
+    @height.setter
+    def height(self, arg: int, /) -> None:
+        """
+        Height of the region in pixels. Zero extends it to the image's edge.
+        """
+        ...
+    @property
+    def layer(self) -> int:
+        """
+        First array layer of the region
+        """
+        ...
+    @layer.setter
+    def layer(self, arg: int, /) -> None:
+        """
+        First array layer of the region
+        """
+        ...
+    @property
+    def layerCount(self) -> int:
+        """
+        Number of array layers. Zero extends it to the last layer.
+        """
+        ...
+    @layerCount.setter
+    def layerCount(self, arg: int, /) -> None:
+        """
+        Number of array layers. Zero extends it to the last layer.
+        """
+        ...
+    @property
+    def mipLevel(self) -> int:
+        """
+        Mip level the region is located in
+        """
+        ...
+    @mipLevel.setter
+    def mipLevel(self, arg: int, /) -> None:
+        """
+        Mip level the region is located in
+        """
+        ...
+    @property
+    def width(self) -> int:
+        """
+        Width of the region in pixels. Zero extends it to the image's edge.
+        """
+        ...
+    @width.setter
+    def width(self, arg: int, /) -> None:
+        """
+        Width of the region in pixels. Zero extends it to the image's edge.
+        """
+        ...
+    @property
+    def x(self) -> int:
+        """
+        Offset of the region in X dimension in pixels
+        """
+        ...
+    @x.setter
+    def x(self, arg: int, /) -> None:
+        """
+        Offset of the region in X dimension in pixels
+        """
+        ...
+    @property
+    def y(self) -> int:
+        """
+        Offset of the region in Y dimension in pixels
+        """
+        ...
+    @y.setter
+    def y(self, arg: int, /) -> None:
+        """
+        Offset of the region in Y dimension in pixels
+        """
+        ...
+    @property
+    def z(self) -> int:
+        """
+        Offset of the region in Z dimension in pixels
+        """
+        ...
+    @z.setter
+    def z(self, arg: int, /) -> None:
+        """
+        Offset of the region in Z dimension in pixels
+        """
+        ...
+
+class IndirectPass:
+    """
+    Single pass of an indirect dispatch chain. The amount of workgroups is
+    derived on the device from an item count, e.g. written by the previous
+    pass, by dividing it by the items processed per workgroup. The program's
+    bindings are captured when creating the chain.
+
+    Parameters
+    ----------
+    program: Program
+        Program to dispatch
+    count: Tensor
+        Tensor holding the amount of items as uint32
+    countOffset: int, default=0
+        Offset in bytes of the amount inside count
+    itemsPerGroup: int, default=0
+        Items processed per workgroup. Zero uses the program's local size in X.
+    maxGroups: int, default=2**32-1
+        Upper limit of the amount of workgroups
+    push: bytes, default=b''
+        Data used as push constant
+    """
+    def __init__(
+        self,
+        program: hephaistos.pyhephaistos.Program,
+        count: hephaistos.pyhephaistos.Tensor,
+        countOffset: int = 0,
+        *,
+        itemsPerGroup: int = 0,
+        maxGroups: int = 4294967295,
+        push: bytes = b"",
+    ) -> None: ...
+    @property
+    def count(self) -> hephaistos.pyhephaistos.Tensor:
+        """
+        Tensor holding the amount of items as uint32
+        """
+        ...
+    @property
+    def countOffset(self) -> int:
+        """
+        Offset in bytes of the amount inside count
+        """
+        ...
+    @property
+    def itemsPerGroup(self) -> int:
+        """
+        Items processed per workgroup. Zero uses the program's local size in X.
+        """
+        ...
+    @property
+    def maxGroups(self) -> int:
+        """
+        Upper limit of the amount of workgroups
+        """
+        ...
+    @property
+    def program(self) -> hephaistos.pyhephaistos.Program:
+        """
+        Program to dispatch
+        """
+        ...
+
+class InsertLabelCommand:
+    """
+    Command inserting a single label between commands
+    """
+
+    def __init__(
+        self, name: str, color: tuple[float, float, float, float] = (0.0, 0.0, 0.0, 0.0)
+    ) -> None:
+        """
+        Creates a new InsertLabelCommand.
+
+        Parameters
+        ----------
+        name: str
+            Text of the label
+        color: tuple[float, float, float, float], default=(0.0, 0.0, 0.0, 0.0)
+            Optional RGBA color of the label
+        """
+        ...
+    @property
+    def color(self) -> tuple[float, float, float, float]:
+        """
+        Optional RGBA color of the label
+        """
+        ...
+    @color.setter
+    def color(self, arg: tuple[float, float, float, float], /) -> None:
+        """
+        Optional RGBA color of the label
+        """
+        ...
+    @property
+    def name(self) -> str:
+        """
+        Text of the label
+        """
+        ...
+    @name.setter
+    def name(self, arg: str, /) -> None:
+        """
+        Text of the label
+        """
+        ...
+
+class IntBuffer:
+    """
+    Buffer representing memory allocated on the host holding an array of type
+    int32 and given size which can be accessed as numpy array or via the buffer
+    protocol, e.g. memoryview(buffer), without copies.
+
+    Parameters
+    ----------
+    size: int
+        Number of elements
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(self, size: int) -> None: ...
+    def numpy(self) -> numpy.typing.NDArray:
+        """
+        Returns a numpy array using this buffer's memory.
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        The number of elements in this buffer.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the buffer in bytes.
+        """
+        ...
+
+class IntTensor:
+    """
+    Tensor representing memory allocated on the device holding an array of type
+    int32 and given size. If mapped can be accessed from the host using its
+    memory address. Mapping can optionally be requested but will be ignored if
+    the device does not support it. Query its support after creation via
+    isMapped. Mapped tensors support the buffer protocol, e.g.
+    memoryview(tensor).
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
+        """
+        Creates a new tensor and fills it with the provided data
+
+        Parameters
+        ----------
+        array: NDArray
+            Numpy array containing the data used to fill the tensor.
+            Its type must match the tensor's.
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(self, size: int, mapped: bool = False) -> None:
+        """
+        Creates a new tensor of given size.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(
+        self,
+        size: int,
+        hints: hephaistos.pyhephaistos.AllocationHints,
+        mapped: bool = False,
+    ) -> None:
+        """
+        Creates a new tensor of given size using the given allocation hints.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        hints: AllocationHints
+            Hints for allocating the memory
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
+        """
+        Creates a new tensor and fills it with the provided data
+
+        Parameters
+        ----------
+        addr: int
+            Address of the data used to fill the tensor
+        n: int
+            Number of bytes to copy from addr
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @property
+    def address(self) -> int:
+        """
+        The device address of this tensor.
+        """
+        ...
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
+    ) -> None:
+        """
+        Binds the tensor to the program or parameter set at the given binding
+        """
+        ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
+    ) -> None:
+        """
+        Binds the tensor to the program or parameter set at the given binding
+        """
+        ...
+    def flush(self, offset: int = 0, size: int | None = None, /) -> None:
+        """
+        Makes writes in mapped memory from the host available to the device.
+        Only needed if isNonCoherent is True.
+
+        Parameters
+        ----------
+        offset: int, default=0
+            Offset in amount of elements into mapped memory to flush
+        size: int|None, default=None
+            Number of elements to flush starting at offset.
+            If None, flushes all remaining elements.
+        """
+        ...
+    def invalidate(self, offset: int = 0, size: int | None = None, /) -> None:
+        """
+        Makes writes in mapped memory from the device available to the host.
+        Only needed if isNonCoherent is True.
+
+        Parameters
+        ----------
+        offset: int, default=0
+            Offset in amount of elements into mapped memory to invalidate
+        size: int | None, default=None
+            Number of elements to invalidate starting at offset.
+            If None, invalidates all remaining elements.
+        """
+        ...
+    @property
+    def isAllocated(self) -> bool:
+        """
+        True, if the tensor's memory was allocated. Only False for lazily
+        allocated tensors not used yet.
+        """
+        ...
+    @property
+    def isMapped(self) -> bool:
+        """
+        True, if the underlying memory is writable by the CPU.
+        """
+        ...
+    @property
+    def isNonCoherent(self) -> bool:
+        """
+        Wether calls to flush() and invalidate() are necessary to make changes
+        in mapped memory between devices and host available
+        """
+        ...
+    @property
+    def isPooled(self) -> bool:
+        """
+        True, if the tensor is sub-allocated from a shared buffer.
+        """
+        ...
+    @property
+    def memory(self) -> int:
+        """
+        Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
+        """
+        ...
+    def retrieve(self, addr: int, n: int, offset: int = 0, /) -> None:
+        """
+        Retrieves n elements from the tensor at the given offset and stores it
+        in dst.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy to
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        
+        Note
+        ----
+        This operation is only guaranteed to succeed on mapped tensors.
+        """
+        ...
+    def retrieveAsync(self, buffer: hephaistos.pyhephaistos.Buffer, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Copies data from the tensor at the given offset into the buffer without
+        waiting for the transfer to finish. The copy is ordered after previously
+        submitted work.
+
+        Parameters
+        ----------
+        buffer: Buffer
+            Buffer to copy to. Its size determines the amount of data copied
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        The number of elements in this tensor.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the tensor in bytes.
+        """
+        ...
+    def update(self, addr: int, n: int, offset: int = 0, /) -> None:
+        """
+        Updates the tensor at the given offset with n elements stored at addr.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        
+        Note
+        ----
+        This operation is only guaranteed to succeed on mapped tensors.
+        """
+        ...
+    def updateAsync(self, addr: int, n: int, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Updates the tensor at the given offset with n elements from addr without
+        waiting for the transfer to finish. The data is staged before returning,
+        thus the memory at addr can be reused directly. The copy is ordered after
+        previously submitted work.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in number of elements where the copy starts
+        """
+        ...
+
+class LocalSize:
+    """
+    Description if the local size, i.e. the number and arrangement of threads in
+    a single thread group
+    """
+
+    def __init__(self) -> None: ...
+    @property
+    def x(self) -> int:
+        """
+        Number of threads in X dimension
+        """
+        ...
+    @x.setter
+    def x(self, arg: int, /) -> None:
+        """
+        Number of threads in X dimension
+        """
+        ...
+    @property
+    def y(self) -> int:
+        """
+        Number of threads in Y dimension
+        """
+        ...
+    @y.setter
+    def y(self, arg: int, /) -> None:
+        """
+        Number of threads in Y dimension
+        """
+        ...
+    @property
+    def z(self) -> int:
+        """
+        Number of threads in Z dimension
+        """
+        ...
+    @z.setter
+    def z(self, arg: int, /) -> None:
+        """
+        Number of threads in Z dimension
+        """
+        ...
+
+class LongBuffer:
+    """
+    Buffer representing memory allocated on the host holding an array of type
+    int64 and given size which can be accessed as numpy array or via the buffer
+    protocol, e.g. memoryview(buffer), without copies.
+
+    Parameters
+    ----------
+    size: int
+        Number of elements
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(self, size: int) -> None: ...
+    def numpy(self) -> numpy.typing.NDArray:
+        """
+        Returns a numpy array using this buffer's memory.
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        The number of elements in this buffer.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the buffer in bytes.
+        """
+        ...
+
+class LongTensor:
+    """
+    Tensor representing memory allocated on the device holding an array of type
+    int64 and given size. If mapped can be accessed from the host using its
+    memory address. Mapping can optionally be requested but will be ignored if
+    the device does not support it. Query its support after creation via
+    isMapped. Mapped tensors support the buffer protocol, e.g.
+    memoryview(tensor).
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
+        """
+        Creates a new tensor and fills it with the provided data
+
+        Parameters
+        ----------
+        array: NDArray
+            Numpy array containing the data used to fill the tensor.
+            Its type must match the tensor's.
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(self, size: int, mapped: bool = False) -> None:
+        """
+        Creates a new tensor of given size.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(
+        self,
+        size: int,
+        hints: hephaistos.pyhephaistos.AllocationHints,
+        mapped: bool = False,
+    ) -> None:
+        """
+        Creates a new tensor of given size using the given allocation hints.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        hints: AllocationHints
+            Hints for allocating the memory
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
+        """
+        Creates a new tensor and fills it with the provided data
+
+        Parameters
+        ----------
+        addr: int
+            Address of the data used to fill the tensor
+        n: int
+            Number of bytes to copy from addr
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @property
+    def address(self) -> int:
+        """
+        The device address of this tensor.
+        """
+        ...
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
+    ) -> None:
+        """
+        Binds the tensor to the program or parameter set at the given binding
+        """
+        ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
+    ) -> None:
+        """
+        Binds the tensor to the program or parameter set at the given binding
+        """
+        ...
+    def flush(self, offset: int = 0, size: int | None = None, /) -> None:
+        """
+        Makes writes in mapped memory from the host available to the device.
+        Only needed if isNonCoherent is True.
+
+        Parameters
+        ----------
+        offset: int, default=0
+            Offset in amount of elements into mapped memory to flush
+        size: int|None, default=None
+            Number of elements to flush starting at offset.
+            If None, flushes all remaining elements.
+        """
+        ...
+    def invalidate(self, offset: int = 0, size: int | None = None, /) -> None:
+        """
+        Makes writes in mapped memory from the device available to the host.
+        Only needed if isNonCoherent is True.
+
+        Parameters
+        ----------
+        offset: int, default=0
+            Offset in amount of elements into mapped memory to invalidate
+        size: int | None, default=None
+            Number of elements to invalidate starting at offset.
+            If None, invalidates all remaining elements.
+        """
+        ...
+    @property
+    def isAllocated(self) -> bool:
+        """
+        True, if the tensor's memory was allocated. Only False for lazily
+        allocated tensors not used yet.
+        """
+        ...
+    @property
+    def isMapped(self) -> bool:
+        """
+        True, if the underlying memory is writable by the CPU.
+        """
+        ...
+    @property
+    def isNonCoherent(self) -> bool:
+        """
+        Wether calls to flush() and invalidate() are necessary to make changes
+        in mapped memory between devices and host available
+        """
+        ...
+    @property
+    def isPooled(self) -> bool:
+        """
+        True, if the tensor is sub-allocated from a shared buffer.
+        """
+        ...
+    @property
+    def memory(self) -> int:
+        """
+        Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
+        """
+        ...
+    def retrieve(self, addr: int, n: int, offset: int = 0, /) -> None:
+        """
+        Retrieves n elements from the tensor at the given offset and stores it
+        in dst.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy to
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        
+        Note
+        ----
+        This operation is only guaranteed to succeed on mapped tensors.
+        """
+        ...
+    def retrieveAsync(self, buffer: hephaistos.pyhephaistos.Buffer, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Copies data from the tensor at the given offset into the buffer without
+        waiting for the transfer to finish. The copy is ordered after previously
+        submitted work.
+
+        Parameters
+        ----------
+        buffer: Buffer
+            Buffer to copy to. Its size determines the amount of data copied
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        The number of elements in this tensor.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the tensor in bytes.
+        """
+        ...
+    def update(self, addr: int, n: int, offset: int = 0, /) -> None:
+        """
+        Updates the tensor at the given offset with n elements stored at addr.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        
+        Note
+        ----
+        This operation is only guaranteed to succeed on mapped tensors.
+        """
+        ...
+    def updateAsync(self, addr: int, n: int, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Updates the tensor at the given offset with n elements from addr without
+        waiting for the transfer to finish. The data is staged before returning,
+        thus the memory at addr can be reused directly. The copy is ordered after
+        previously submitted work.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in number of elements where the copy starts
+        """
+        ...
+
+class MappedFileBuffer:
+    """
+    Buffer backed by a region of a memory mapped file. If importing host memory
+    is supported, the mapped pages are used directly, letting copies stream from
+    the file without duplicating its content in memory. Otherwise, the region is
+    read into a newly allocated buffer. The content is read only and should only
+    be used as source of copies. Supports the read only buffer protocol.
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(
+        self, path: str | os.PathLike, offset: int = 0, size: Optional[int] = None
+    ) -> None:
+        """
+        Maps the given region of a file. If size is None, maps the rest of the
+        file.
+
+        Parameters
+        ----------
+        path: str|PathLike
+            Path to the file to map
+        offset: int, default=0
+            Offset into the file in bytes
+        size: None|int, default=None
+            Size of the region in bytes
+        """
+        ...
+    @property
+    def address(self) -> int:
+        """
+        The memory address of the mapped region.
+        """
+        ...
+    @property
+    def imported(self) -> bool:
+        """
+        True, if the mapped file is accessed directly by the device
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the buffer in bytes.
+        """
+        ...
+
+class MatrixScope:
+    """
+    Scope of threads sharing a cooperative matrix
+    """
+
+    DEVICE: MatrixScope
+
+    QUEUE_FAMILY: MatrixScope
+
+    SUBGROUP: MatrixScope
+
+    WORKGROUP: MatrixScope
+
+class MemberType:
+    """
+    Base type of a block member
+    """
+
+    BOOL: MemberType
+
+    FLOAT: MemberType
+
+    INT: MemberType
+
+    STRUCT: MemberType
+
+    UINT: MemberType
+
+class MemoryModelFeatures:
+    """
+    Features of the Vulkan memory model enabled on a context
+    """
+
+    @property
+    def availabilityVisibilityChains(self) -> bool:
+        """
+        True, if availability and visibility operations can be chained
+        """
+        ...
+    @property
+    def deviceScope(self) -> bool:
+        """
+        True, if synchronization can use device scope
+        """
+        ...
+    @property
+    def vulkanMemoryModel(self) -> bool:
+        """
+        True, if the Vulkan memory model is enabled
+        """
+        ...
+
+class MemoryPlacement:
+    """
+    Preferred placement of memory allocations
+    """
+
+    AUTO: MemoryPlacement
+    """
+    Lets the allocator decide based on the usage
+    """
+
+    PREFER_DEVICE: MemoryPlacement
+    """
+    Prefers memory local to the device
+    """
+
+    PREFER_HOST: MemoryPlacement
+    """
+    Prefers memory residing on the host
+    """
+
+class Mesh:
+    """
+    Representation of a geometric shape consisting of triangles defined by their
+    vertices, which can optionally be indexed. Meshes are used to build Geometries.
+    """
+
+    def __init__(self) -> None: ...
+    @property
+    def indices(self) -> numpy.typing.NDArray:
+        """
+        Optional numpy array holding the indices referencing vertices to create
+        triangles.
+        """
+        ...
+    @indices.setter
+    def indices(self, arg: numpy.typing.NDArray, /) -> None:
+        """
+        Optional numpy array holding the indices referencing vertices to create
+        triangles.
+        """
+        ...
+    @property
+    def vertices(self) -> numpy.typing.NDArray:
+        """
+        Numpy array holding the vertex data. The first three columns must be the
+        x, y and z positions.
+        """
+        ...
+    @vertices.setter
+    def vertices(self, arg: numpy.typing.NDArray, /) -> None:
+        """
+        Numpy array holding the vertex data. The first three columns must be the
+        x, y and z positions.
+        """
+        ...
+
+class MeshVector:
+    """
+    List of Mesh
+    """
+
+    def __init__(self, arg: Iterable[hephaistos.pyhephaistos.Mesh], /) -> None:
+        """
+        Construct from an iterable object
+        """
+        ...
+    @overload
+    def __init__(self) -> None:
+        """
+        Default constructor
+        """
+        ...
+    @overload
+    def __init__(self, arg: hephaistos.pyhephaistos.MeshVector) -> None:
+        """
+        Copy constructor
+        """
+        ...
+    def append(self, arg: hephaistos.pyhephaistos.Mesh, /) -> None:
+        """
+        Append `arg` to the end of the list.
+        """
+        ...
+    def clear(self) -> None:
+        """
+        Remove all items from list.
+        """
+        ...
+    def extend(self, arg: hephaistos.pyhephaistos.MeshVector, /) -> None:
+        """
+        Extend `self` by appending elements from `arg`.
+        """
+        ...
+    def insert(self, arg0: int, arg1: hephaistos.pyhephaistos.Mesh, /) -> None:
+        """
+        Insert object `arg1` before index `arg0`.
+        """
+        ...
+    def pop(self, index: int = -1) -> hephaistos.pyhephaistos.Mesh:
+        """
+        Remove and return item at `index` (default last).
+        """
+        ...
+
+class MemoryStatistics:
+    """
+    Memory usage of the current context
+    """
+
+    @property
+    def allocationBytes(self) -> int:
+        """
+        Total bytes occupied by resources
+        """
+        ...
+    @property
+    def allocationCount(self) -> int:
+        """
+        Total number of resources
+        """
+        ...
+    @property
+    def blockBytes(self) -> int:
+        """
+        Total bytes allocated in device memory blocks
+        """
+        ...
+    @property
+    def blockCount(self) -> int:
+        """
+        Total number of device memory blocks
+        """
+        ...
+    @property
+    def heaps(self) -> list[hephaistos.pyhephaistos.HeapStatistics]:
+        """
+        Statistics per memory heap of the device
+        """
+        ...
+
+class PackedTypesProperties:
+    """
+    List of packed 16 and 8 bit type features a device supports or are enabled
+    """
+
+    @property
+    def integerDotProduct(self) -> bool: ...
+    @property
+    def storageBuffer16BitAccess(self) -> bool: ...
+    @property
+    def storageBuffer8BitAccess(self) -> bool: ...
+    @property
+    def storagePushConstant16(self) -> bool: ...
+    @property
+    def storagePushConstant8(self) -> bool: ...
+    @property
+    def uniformAndStorageBuffer16BitAccess(self) -> bool: ...
+    @property
+    def uniformAndStorageBuffer8BitAccess(self) -> bool: ...
+
+class ParameterSet:
+    """
+    Set of parameters a program can be dispatched with. Dispatches using a set
+    read its parameters once they run, allowing to change them without
+    recording the dispatch again. Changes take effect after calling update(),
+    which must not happen while work using the set is still pending.
+    """
+
+    def __init__(self, program: hephaistos.pyhephaistos.Program) -> None:
+        """
+        Creates a new parameter set for the given program
+        """
+        ...
+    def bindParams(*params, **namedparams) -> None:
+        """
+        Binds the given parameters. Takes only effect after calling update().
+        Positional arguments are bound to the binding of the corresponding
+        position. Keyword arguments are matched with the binding of the same
+        name.
+        """
+        ...
+    @property
+    def bindings(self) -> list[hephaistos.pyhephaistos.BindingTraits]:
+        """
+        Returns a list of all bindings.
+        """
+        ...
+    def update(self) -> None:
+        """
+        Writes the bound parameters to the device. Throws if not all bindings
+        are bound.
+        """
+        ...
+
+class ParameterType:
+    """
+    Type of parameter
+    """
+
+    ACCELERATION_STRUCTURE: ParameterType
+
+    COMBINED_IMAGE_SAMPLER: ParameterType
+
+    SAMPLED_IMAGE: ParameterType
+
+    STORAGE_BUFFER: ParameterType
+
+    STORAGE_IMAGE: ParameterType
+
+    STORAGE_TEXEL_BUFFER: ParameterType
+
+    UNIFORM_BUFFER: ParameterType
+
+    UNIFORM_TEXEL_BUFFER: ParameterType
+
+class PendingProgram:
+    """
+    Handle to a program built in the background. Can be polled or waited on
+    until the program is ready.
+    """
+
+    def get(self) -> hephaistos.pyhephaistos.Program:
+        """
+        Returns the built program. Blocks until the program finished building
+        and raises errors occurred during building. Can only be called once.
+        """
+        ...
+    def isReady(self) -> bool:
+        """
+        Checks wether the program finished building
+        """
+        ...
+    def wait(self) -> None:
+        """
+        Blocks until the program finished building
+        """
+        ...
+
+class PendingSave:
+    """
+    Handle to an image saved in the background. Waits for the save to finish
+    when destroyed.
+    """
+
+    def isReady(self) -> bool:
+        """
+        Checks whether the image finished saving
+        """
+        ...
+    def wait(self) -> None:
+        """
+        Blocks until the image finished saving and raises errors occurred
+        while saving.
+        """
+        ...
+
+class PerformanceCounter:
+    """
+    Description of a hardware performance counter
+    """
+
+    @property
+    def category(self) -> str:
+        """
+        Category the counter belongs to
+        """
+        ...
+    @property
+    def description(self) -> str:
+        """
+        Description of the counter
+        """
+        ...
+    @property
+    def name(self) -> str:
+        """
+        Name of the counter as reported by the driver
+        """
+        ...
+    @property
+    def unit(self) -> hephaistos.pyhephaistos.PerformanceCounterUnit:
+        """
+        Unit of the counter's value
+        """
+        ...
+
+class PerformanceCounterResult:
+    """
+    Value of a performance counter measured by a PerformanceQuery
+    """
+
+    @property
+    def name(self) -> str:
+        """
+        Name of the counter
+        """
+        ...
+    @property
+    def unit(self) -> hephaistos.pyhephaistos.PerformanceCounterUnit:
+        """
+        Unit of the value
+        """
+        ...
+    @property
+    def value(self) -> float:
+        """
+        Measured value
+        """
+        ...
+
+class PerformanceCounterUnit:
+    """
+    Unit of a performance counter
+    """
+
+    AMPS: PerformanceCounterUnit
+    """
+    Current in Ampere
+    """
+
+    BYTES: PerformanceCounterUnit
+    """
+    Bytes
+    """
+
+    BYTES_PER_SECOND: PerformanceCounterUnit
+    """
+    Bytes per second
+    """
+
+    CYCLES: PerformanceCounterUnit
+    """
+    Clock cycles
+    """
+
+    GENERIC: PerformanceCounterUnit
+    """
+    Unitless value
+    """
+
+    HERTZ: PerformanceCounterUnit
+    """
+    Frequency in Hertz
+    """
+
+    KELVIN: PerformanceCounterUnit
+    """
+    Temperature in Kelvin
+    """
+
+    NANOSECONDS: PerformanceCounterUnit
+    """
+    Nanoseconds
+    """
+
+    PERCENTAGE: PerformanceCounterUnit
+    """
+    Percentage
+    """
+
+    VOLTS: PerformanceCounterUnit
+    """
+    Voltage in Volts
+    """
+
+    WATTS: PerformanceCounterUnit
+    """
+    Power in Watts
+    """
+
+class PerformanceQuery:
+    """
+    Measures hardware performance counters over a list of commands. The
+    commands are executed once per pass the selected counters require.
+    """
+
+    def __init__(self, counters: list[str]) -> None:
+        """
+        Creates a new query measuring the given counters.
+
+        Parameters
+        ----------
+        counters: list[str]
+            Names of the counters to measure
+        """
+        ...
+    @property
+    def counters(self) -> list[hephaistos.pyhephaistos.PerformanceCounter]:
+        """
+        Counters measured by this query
+        """
+        ...
+    def measure(
+        self, list: list
+    ) -> list[hephaistos.pyhephaistos.PerformanceCounterResult]:
+        """
+        Runs the given list of commands once per pass and returns the value of
+        each counter.
+        """
+        ...
+    @property
+    def passCount(self) -> int:
+        """
+        Amount of passes needed to measure all counters
+        """
+        ...
+
+class PinnedBuffer:
+    """
+    Buffer whose host memory is allocated following a placement policy.
+    Allocates the pages itself and imports them, which allows to place them on
+    the NUMA node local to the device and to back them by huge pages. If
+    importing host memory is not supported, falls back to a regular buffer
+    ignoring the policy. Supports the buffer protocol.
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(
+        self,
+        size: int,
+        *,
+        localNumaNode: bool = True,
+        hugePages: hephaistos.pyhephaistos.HugePages = HugePages.NONE,
+    ) -> None:
+        """
+        Allocates a new pinned buffer. Throws if explicit huge pages were
+        requested but are not available.
+
+        Parameters
+        ----------
+        size: int
+            Size of the buffer in bytes
+        localNumaNode: bool, default=True
+            Places the memory on the NUMA node the device is attached to
+        hugePages: HugePages, default=HugePages.NONE
+            Kind of pages backing the memory
+        """
+        ...
+    @property
+    def address(self) -> int:
+        """
+        The memory address of the buffer.
+        """
+        ...
+    @property
+    def hugePages(self) -> hephaistos.pyhephaistos.HugePages:
+        """
+        Kind of pages the memory was allocated with
+        """
+        ...
+    @property
+    def imported(self) -> bool:
+        """
+        True, if the buffer uses memory allocated via its policy
+        """
+        ...
+    @property
+    def numaNode(self) -> int:
+        """
+        NUMA node the memory is bound to or -1 if not bound
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the buffer in bytes.
+        """
+        ...
+
+class PipelineStatistics:
+    """
+    Counts compute shader invocations between commands execution. start() and
+    stop() must be recorded into the same step of a sequence.
+    """
+
+    def __init__(self) -> None:
+        """
+        Creates a new query for counting compute shader invocations between
+        commands.
+        """
+        ...
+    def getResult(
+        self, wait: bool = False
+    ) -> hephaistos.pyhephaistos.PipelineStatisticsResult:
+        """
+        Returns the amount of compute shader invocations and elapsed time in
+        nanoseconds between start() and stop(). If wait is True, blocks the call
+        until the results are available, otherwise returns zero invocations and
+        NaN if they are not yet available.
+        """
+        ...
+    def reset(self) -> None:
+        """
+        Resets the query.
+        """
+        ...
+    def start(self) -> hephaistos.pyhephaistos.Command:
+        """
+        Returns the command to start the query.
+        """
+        ...
+    def stop(self) -> hephaistos.pyhephaistos.Command:
+        """
+        Returns the command to stop the query.
+        """
+        ...
+
+class PipelineStatisticsResult:
+    """
+    Statistics recorded by PipelineStatistics
+    """
+
+    @property
+    def elapsedTime(self) -> float:
+        """
+        Elapsed time between start() and stop() in nanoseconds
+        """
+        ...
+    @property
+    def invocations(self) -> int:
+        """
+        Amount of compute shader invocations between start() and stop()
+        """
+        ...
+    @property
+    def invocationsPerSecond(self) -> float:
+        """
+        Amount of compute shader invocations per second
+        """
+        ...
+
+class PrimitiveCommand:
+    """
+    Command running a parallel primitive. Runs multiple dispatches synchronized
+    among each other, but not with work recorded before or after. Owns its
+    scratch memory, thus may only run once at a time.
+    """
+
+class Primitives:
+    """
+    Library of common parallel primitives on tensors of 32 bit elements: prefix
+    sums, reductions and stream compaction, as well as radix sort of 32 and 64
+    bit keys. Programs are compiled on first use. Scans run in a single pass
+    using decoupled look-back, sorting in one pass per 8 bit digit using
+    look-back per digit. Workgroups use subgroup arithmetic and ballots if
+    supported by the device, thus float sums may differ in their last bits
+    between runs unless created deterministic. Histograms privatize their bins
+    in shared memory where possible. The element type is deduced from typed tensors, i.e.
+    IntTensor, UnsignedIntTensor and FloatTensor, unless given explicitly.
+
+    Parameters
+    ----------
+    localSize: int, default=0
+        Threads per workgroup. Zero picks one based on the device.
+    itemsPerThread: int, default=0
+        Elements processed per thread. Zero picks a default.
+    useSubgroups: bool, default=True
+        Whether to use subgroup arithmetic where supported
+    deterministic: bool, default=False
+        If True, reductions combine elements in a fixed order independent of
+        the subgroup size and float histograms default to
+        HistogramStrategy.DETERMINISTIC, making their results bit-reproducible
+        on the same device and options.
+    """
+
+    def __init__(
+        self,
+        *,
+        localSize: int = 0,
+        itemsPerThread: int = 0,
+        useSubgroups: bool = True,
+        deterministic: bool = False,
+    ) -> None: ...
+    def compact(
+        self,
+        flags: hephaistos.pyhephaistos.Tensor,
+        src: hephaistos.pyhephaistos.Tensor,
+        dst: hephaistos.pyhephaistos.Tensor,
+        columns: list[tuple[int, int, int]],
+        *,
+        count: Optional[int] = None,
+        countTensor: Optional[hephaistos.pyhephaistos.Tensor] = None,
+        countOffset: int = 0,
+    ) -> hephaistos.pyhephaistos.PrimitiveCommand:
+        """
+        Creates a command moving each item whose flag is non zero from src to
+        dst while preserving their order. Items may span multiple columns, e.g.
+        the fields of a structure of arrays, which are moved alike.
+
+        Parameters
+        ----------
+        flags: Tensor
+            Tensor holding a uint32 flag per item
+        src: Tensor
+            Tensor holding the items to compact
+        dst: Tensor
+            Tensor receiving the kept items. Must differ from src.
+        columns: list[tuple[int, int, int]]
+            Offset in bytes into src and dst as well as the size in bytes of a
+            single item per column. Must be multiples of 4.
+        count: int | None, default=None
+            Amount of items. Uses the size of flags if None.
+        countTensor: Tensor | None, default=None
+            Tensor receiving the amount of kept items
+        countOffset: int, default=0
+            Offset in bytes the amount is written to
+        """
+        ...
+    def compress(
+        self,
+        input: hephaistos.pyhephaistos.Tensor,
+        output: hephaistos.pyhephaistos.Tensor,
+        *,
+        count: Optional[int] = None,
+    ) -> hephaistos.pyhephaistos.PrimitiveCommand:
+        """
+        Creates a command compressing 32 bit words by eliminating zero words,
+        suited for sparse data before retrieving it. The stream starts with the
+        amount of words and of non zero words as uint32 followed by a mask of
+        the non zero words per block of 32 words and the non zero words in
+        order. Use getCompressedSize() on its header to retrieve only the
+        compressed part and decompressData() to decode it on the host.
+
+        Parameters
+        ----------
+        input: Tensor
+            Tensor holding the words to compress
+        output: Tensor
+            Tensor receiving the stream. Must differ from input and hold at least
+            getMaxCompressedSize() bytes.
+        count: int | None, default=None
+            Amount of words. Uses the whole input if None.
+        """
+        ...
+    def copyPrefix(
+        self,
+        src: hephaistos.pyhephaistos.Tensor,
+        dst: hephaistos.pyhephaistos.Tensor,
+        countOffset: int,
+        columns: list[tuple[int, int, int]],
+        capacity: int,
+    ) -> hephaistos.pyhephaistos.PrimitiveCommand:
+        """
+        Creates a command reading the amount of items from an uint32 inside
+        src, e.g. the counter of a queue, and copying only that many items of
+        each column to dst, clamped to the capacity. The amount is copied into
+        dst at the same offset. If dst is mapped, only the live prefix is
+        written to host visible memory, i.e. a queue is read back in a single
+        submission.
+
+        Parameters
+        ----------
+        src: Tensor
+            Tensor holding the count and the items
+        dst: Tensor
+            Tensor receiving the count and the items. Must differ from src.
+        countOffset: int
+            Offset in bytes of the uint32 count inside src and dst
+        columns: list[tuple[int, int, int]]
+            Offset in bytes into src and dst as well as the size in bytes of a
+            single item per column. Must be multiples of 4.
+        capacity: int
+            Maximum amount of items
+        """
+        ...
+    def decompress(
+        self,
+        input: hephaistos.pyhephaistos.Tensor,
+        output: hephaistos.pyhephaistos.Tensor,
+        *,
+        count: Optional[int] = None,
+    ) -> hephaistos.pyhephaistos.PrimitiveCommand:
+        """
+        Creates a command decompressing a stream created by compress() or
+        compressData() into a tensor overwriting its previous contents.
+
+        Parameters
+        ----------
+        input: Tensor
+            Tensor holding the compressed stream
+        output: Tensor
+            Tensor receiving the words. Must differ from input.
+        count: int | None, default=None
+            Amount of words. Must match the stream. Uses the whole output if None.
+        """
+        ...
+    def exclusiveScan(
+        self,
+        input: hephaistos.pyhephaistos.Tensor,
+        output: Optional[hephaistos.pyhephaistos.Tensor] = None,
+        *,
+        type: Optional[hephaistos.pyhephaistos.ElementType] = None,
+        op: hephaistos.pyhephaistos.ReduceOperation = ReduceOperation.ADD,
+        count: Optional[int] = None,
+    ) -> hephaistos.pyhephaistos.PrimitiveCommand:
+        """
+        Creates a command computing the exclusive scan of the input.
+
+        Parameters
+        ----------
+        input: Tensor
+            Tensor holding the elements to scan
+        output: Tensor | None, default=None
+            Tensor the scan is written to. Scans in place if None.
+        type: ElementType | None, default=None
+            Type of the elements. Deduced from input if None.
+        op: ReduceOperation, default=ReduceOperation.ADD
+            Operation combining the elements
+        count: int | None, default=None
+            Amount of elements. Uses the whole input if None.
+        """
+        ...
+    def getHistogramStrategy(
+        self,
+        type: hephaistos.pyhephaistos.ElementType,
+        binCount: int,
+        strategy: hephaistos.pyhephaistos.HistogramStrategy = HistogramStrategy.AUTO,
+    ) -> hephaistos.pyhephaistos.HistogramStrategy:
+        """
+        Returns the strategy used for histograms of the given type and amount
+        of bins.
+
+        Parameters
+        ----------
+        type: ElementType
+            Type of the bins
+        binCount: int
+            Amount of bins
+        strategy: HistogramStrategy, default=HistogramStrategy.AUTO
+            Requested strategy
+        """
+        ...
+    def histogram(
+        self,
+        indices: hephaistos.pyhephaistos.Tensor,
+        histogram: hephaistos.pyhephaistos.Tensor,
+        *,
+        weights: Optional[hephaistos.pyhephaistos.Tensor] = None,
+        type: Optional[hephaistos.pyhephaistos.ElementType] = None,
+        count: Optional[int] = None,
+        strategy: hephaistos.pyhephaistos.HistogramStrategy = HistogramStrategy.AUTO,
+    ) -> hephaistos.pyhephaistos.PrimitiveCommand:
+        """
+        Creates a command adding one or the item's weight to the bin given by
+        the item's index. Items with indices outside of the histogram are
+        skipped. Previous contents of the histogram are kept, i.e. multiple
+        commands accumulate. Float bins require the corresponding atomic add
+        being enabled.
+
+        Parameters
+        ----------
+        indices: Tensor
+            Tensor holding an uint32 bin index per item
+        histogram: Tensor
+            Tensor holding the bins. Its size defines their amount.
+        weights: Tensor | None, default=None
+            Optional tensor holding a weight per item
+        type: ElementType | None, default=None
+            Type of the bins and weights. Deduced from histogram if None.
+        count: int | None, default=None
+            Amount of items. Uses the size of indices if None.
+        strategy: HistogramStrategy, default=HistogramStrategy.AUTO
+            Strategy used to accumulate the bins
+        """
+        ...
+    def inclusiveScan(
+        self,
+        input: hephaistos.pyhephaistos.Tensor,
+        output: Optional[hephaistos.pyhephaistos.Tensor] = None,
+        *,
+        type: Optional[hephaistos.pyhephaistos.ElementType] = None,
+        op: hephaistos.pyhephaistos.ReduceOperation = ReduceOperation.ADD,
+        count: Optional[int] = None,
+    ) -> hephaistos.pyhephaistos.PrimitiveCommand:
+        """
+        Creates a command computing the inclusive scan of the input.
+
+        Parameters
+        ----------
+        input: Tensor
+            Tensor holding the elements to scan
+        output: Tensor | None, default=None
+            Tensor the scan is written to. Scans in place if None.
+        type: ElementType | None, default=None
+            Type of the elements. Deduced from input if None.
+        op: ReduceOperation, default=ReduceOperation.ADD
+            Operation combining the elements
+        count: int | None, default=None
+            Amount of elements. Uses the whole input if None.
+        """
+        ...
+    def indirectChain(
+        self, passes: list[hephaistos.pyhephaistos.IndirectPass]
+    ) -> hephaistos.pyhephaistos.PrimitiveCommand:
+        """
+        Creates a command running a chain of indirect dispatches. Before each
+        pass a built-in kernel reads the pass' item count and writes its
+        dispatch arguments, dividing the count by the items per workgroup
+        rounding up and clamping it to the pass' maximum and the device's limit.
+        Thus each pass may size the next one without a round trip to the host.
+        Passes are only separated by a single barrier each.
+
+        Parameters
+        ----------
+        passes: list[IndirectPass]
+            Passes to run in the given order
+        """
+        ...
+    @property
+    def isDeterministic(self) -> bool:
+        """
+        True, if reductions and float histograms are deterministic
+        """
+        ...
+    @property
+    def localSize(self) -> int:
+        """
+        Threads per workgroup
+        """
+        ...
+    def reduce(
+        self,
+        input: hephaistos.pyhephaistos.Tensor,
+        output: hephaistos.pyhephaistos.Tensor,
+        *,
+        type: Optional[hephaistos.pyhephaistos.ElementType] = None,
+        op: hephaistos.pyhephaistos.ReduceOperation = ReduceOperation.ADD,
+        count: Optional[int] = None,
+    ) -> hephaistos.pyhephaistos.PrimitiveCommand:
+        """
+        Creates a command reducing the input to a single element written to the
+        first element of output.
+
+        Parameters
+        ----------
+        input: Tensor
+            Tensor holding the elements to reduce
+        output: Tensor
+            Tensor receiving the result
+        type: ElementType | None, default=None
+            Type of the elements. Deduced from input if None.
+        op: ReduceOperation, default=ReduceOperation.ADD
+            Operation combining the elements
+        count: int | None, default=None
+            Amount of elements. Uses the whole input if None.
+        """
+        ...
+    def sort(
+        self,
+        keys: hephaistos.pyhephaistos.Tensor,
+        values: Optional[hephaistos.pyhephaistos.Tensor] = None,
+        *,
+        type: Optional[hephaistos.pyhephaistos.SortKeyType] = None,
+        count: Optional[int] = None,
+        valueStride: int = 4,
+    ) -> hephaistos.pyhephaistos.PrimitiveCommand:
+        """
+        Creates a command sorting the keys in place. The sort is stable and
+        moves optional values alike.
+
+        Parameters
+        ----------
+        keys: Tensor
+            Tensor holding the keys to sort
+        values: Tensor | None, default=None
+            Optional tensor holding a value per key
+        type: SortKeyType | None, default=None
+            Type of the keys. Deduced from keys if None.
+        count: int | None, default=None
+            Amount of keys. Uses the whole tensor if None.
+        valueStride: int, default=4
+            Size in bytes of a single value. Must be a multiple of 4.
+        """
+        ...
+    def sortColumns(
+        self,
+        src: hephaistos.pyhephaistos.Tensor,
+        dst: hephaistos.pyhephaistos.Tensor,
+        type: hephaistos.pyhephaistos.SortKeyType,
+        keyOffset: int,
+        columns: list[tuple[int, int, int]],
+        count: int,
+        *,
+        countOffset: Optional[int] = None,
+    ) -> hephaistos.pyhephaistos.PrimitiveCommand:
+        """
+        Creates a command moving items from src to dst ordered by a key column
+        inside src, e.g. sorting the structure of arrays of a queue by one of
+        its fields. The sort is stable.
+
+        Parameters
+        ----------
+        src: Tensor
+            Tensor holding the items to sort
+        dst: Tensor
+            Tensor receiving the sorted items. Must differ from src.
+        type: SortKeyType
+            Type of the keys
+        keyOffset: int
+            Offset in bytes of the key column inside src
+        columns: list[tuple[int, int, int]]
+            Offset in bytes into src and dst as well as the size in bytes of a
+            single item per column moved to dst. Must be multiples of 4.
+        count: int
+            Amount of items
+        countOffset: int | None, default=None
+            Optional offset in bytes of an uint32 inside src limiting the amount
+            of items, e.g. the counter of a queue. Copied to dst at the same offset.
+        """
+        ...
+    def sortIndices(
+        self,
+        keys: hephaistos.pyhephaistos.Tensor,
+        indices: hephaistos.pyhephaistos.Tensor,
+        *,
+        type: Optional[hephaistos.pyhephaistos.SortKeyType] = None,
+        count: Optional[int] = None,
+    ) -> hephaistos.pyhephaistos.PrimitiveCommand:
+        """
+        Creates a command writing the index of the key for each position in
+        sorted order, i.e. a stable argsort. The keys are left unchanged.
+
+        Parameters
+        ----------
+        keys: Tensor
+            Tensor holding the keys to sort
+        indices: Tensor
+            Tensor receiving an uint32 index per key
+        type: SortKeyType | None, default=None
+            Type of the keys. Deduced from keys if None.
+        count: int | None, default=None
+            Amount of keys. Uses the whole tensor if None.
+        """
+        ...
+    @property
+    def tileSize(self) -> int:
+        """
+        Elements processed per workgroup
+        """
+        ...
+    @property
+    def usesSubgroups(self) -> bool:
+        """
+        True, if the programs use subgroup arithmetic
+        """
+        ...
+
+class Profiler:
+    """
+    Hierarchical profiler measuring named scopes on the device. Results are
+    gathered without waiting on the device and kept in a ring of frames.
+    """
+
+    def __init__(self, frameCount: int = 3) -> None:
+        """
+        Creates a new profiler keeping a ring of frameCount frames.
+
+        Parameters
+        ----------
+        frameCount: int, default=3
+            Amount of frames kept in the ring. Should exceed the amount of frames
+            the device lags behind the host.
+        """
+        ...
+    def beginScope(self, name: str) -> hephaistos.pyhephaistos.ProfilerScopeCommand:
+        """
+        Returns the command starting a new scope nested inside the innermost
+        scope still open while recording. The name must not be empty or contain
+        '/'.
+        """
+        ...
+    def collect(self) -> None:
+        """
+        Reads all results available without waiting on the device.
+        """
+        ...
+    @property
+    def currentFrame(self) -> int:
+        """
+        The current frame number
+        """
+        ...
+    def endScope(self) -> hephaistos.pyhephaistos.ProfilerScopeCommand:
+        """
+        Returns the command ending the innermost open scope.
+        """
+        ...
+    @property
+    def frameCount(self) -> int:
+        """
+        Amount of frames kept in the ring
+        """
+        ...
+    def getSamples(self) -> list[hephaistos.pyhephaistos.ProfilerSample]:
+        """
+        Returns the collected measurements of the frames still in the ring
+        ordered by frame and start time.
+        """
+        ...
+    def getStatistics(self) -> list[hephaistos.pyhephaistos.ProfilerScopeStatistics]:
+        """
+        Returns min, mean and 99th percentile of the durations per scope path.
+        """
+        ...
+    def nextFrame(self) -> int:
+        """
+        Collects available results, recycles the oldest frame and returns the
+        new frame number. Raises if scopes are still open.
+        """
+        ...
+    def resetStatistics(self) -> None:
+        """
+        Clears the aggregated measurements.
+        """
+        ...
+
+class ProfilerSample:
+    """
+    Single measurement of a scope recorded by a Profiler
+    """
+
+    @property
+    def depth(self) -> int:
+        """
+        Amount of scopes enclosing this one
+        """
+        ...
+    @property
+    def duration(self) -> float:
+        """
+        Elapsed time between start and end of the scope in nanoseconds
+        """
+        ...
+    @property
+    def frame(self) -> int:
+        """
+        Frame during which the scope was recorded
+        """
+        ...
+    @property
+    def name(self) -> str:
+        """
+        Path of the scope, i.e. the names of all enclosing scopes and its
+        own joined by '/'
+        """
+        ...
+    @property
+    def start(self) -> float:
+        """
+        Device timestamp at which the scope started in nanoseconds
+        """
+        ...
+
+class ProfilerScopeCommand:
+    """
+    Command starting or ending a named scope of a Profiler
+    """
+
+    @property
+    def name(self) -> str:
+        """
+        Name of the scope to begin or empty to end the innermost open scope
+        """
+        ...
+
+class ProfilerScopeStatistics:
+    """
+    Aggregated measurements of all scopes sharing the same path
+    """
+
+    @property
+    def count(self) -> int:
+        """
+        Total amount of measurements since the last reset
+        """
+        ...
+    @property
+    def depth(self) -> int:
+        """
+        Amount of scopes enclosing this one
+        """
+        ...
+    @property
+    def mean(self) -> float:
+        """
+        Mean duration within the sample window in nanoseconds
+        """
+        ...
+    @property
+    def min(self) -> float:
+        """
+        Shortest duration within the sample window in nanoseconds
+        """
+        ...
+    @property
+    def name(self) -> str:
+        """
+        Path of the scope, i.e. the names of all enclosing scopes and its
+        own joined by '/'
+        """
+        ...
+    @property
+    def p99(self) -> float:
+        """
+        99th percentile of the duration within the sample window in
+        nanoseconds
+        """
+        ...
+
+class Program:
+    """
+    Encapsulates a shader program enabling introspection into its bindings as
+    well as keeping track of the parameters currently bound to them. Execution
+    happens trough commands.
+    """
+
+    def __init__(
+        self,
+        code: bytes,
+        specialization: Optional[bytes] = None,
+        subgroupSize: int = 0,
+        fullSubgroups: bool = False,
+        binary: Optional[bytes] = None,
+    ) -> None:
+        """
+        Creates a new program using the shader's byte code.
+
+        Parameters
+        ----------
+        code: bytes
+            Byte code of the program
+        specialization: bytes | None, default=None
+            Data used for filling in specialization constants
+        subgroupSize: int, default=0
+            Threads per subgroup the program must run with. Zero lets the driver
+            choose.
+        fullSubgroups: bool, default=False
+            If True, all subgroups of a workgroup must be full
+        binary: bytes | None, default=None
+            Shader object binary retrieved via getShaderBinary() used instead of
+            compiling the code. Ignored if incompatible or shader objects are
+            disabled.
+        """
+        ...
+    @overload
+    def __init__(self, code: bytes) -> None:
+        """
+        Creates a new program using the shader's byte code.
+
+        Parameters
+        ----------
+        code: bytes
+            Byte code of the program
+        """
+        ...
+    def bindParams(*params, **namedparams) -> None:
+        """
+        Binds the given parameters.
+        Positional arguments are bound to the binding of the corresponding
+        position. Keyword arguments are matched with the binding of the same
+        name.
+        """
+        ...
+    @property
+    def bindings(self) -> list[hephaistos.pyhephaistos.BindingTraits]:
+        """
+        Returns a list of all bindings.
+        """
+        ...
+    @overload
+    def dispatch(
+        self,
+        set: hephaistos.pyhephaistos.ParameterSet,
+        x: int = 1,
+        y: int = 1,
+        z: int = 1,
+    ) -> hephaistos.pyhephaistos.DispatchCommand:
+        """
+        Dispatches a program execution with the given amount of workgroups using
+        the parameters of the given set, which are read once the dispatch runs.
+        Updating the set thus does not require recording the dispatch again.
+
+        Parameters
+        ----------
+        set: ParameterSet
+            Set providing the parameters
+        x: int, default=1
+            Number of groups to dispatch in X dimension
+        y: int, default=1
+            Number of groups to dispatch in Y dimension
+        z: int, default=1
+            Number of groups to dispatch in Z dimension
+        """
+        ...
+    @overload
+    def dispatch(
+        self,
+        heap: hephaistos.pyhephaistos.ResourceHeap,
+        x: int = 1,
+        y: int = 1,
+        z: int = 1,
+    ) -> hephaistos.pyhephaistos.DispatchCommand:
+        """
+        Dispatches a program execution with the given amount of workgroups using
+        the resources of the given heap instead of bound parameters.
+
+        Parameters
+        ----------
+        heap: ResourceHeap
+            Heap providing the resources
+        x: int, default=1
+            Number of groups to dispatch in X dimension
+        y: int, default=1
+            Number of groups to dispatch in Y dimension
+        z: int, default=1
+            Number of groups to dispatch in Z dimension
+        """
+        ...
+    @overload
+    def dispatch(
+        self, x: int = 1, y: int = 1, z: int = 1
+    ) -> hephaistos.pyhephaistos.DispatchCommand:
+        """
+        Dispatches a program execution with the given amount of workgroups.
+
+        Parameters
+        ----------
+        x: int, default=1
+            Number of groups to dispatch in X dimension
+        y: int, default=1
+            Number of groups to dispatch in Y dimension
+        z: int, default=1
+            Number of groups to dispatch in Z dimension
+        """
+        ...
+    @overload
+    def dispatchBatch(
+        self,
+        groupCounts: numpy.typing.NDArray,
+        push: Optional[numpy.typing.NDArray] = None,
+        *,
+        simultaneous: bool = False,
+        trackHazards: bool = False,
+    ) -> hephaistos.pyhephaistos.Subroutine:
+        """
+        Records a dispatch for each row of the given arrays into a new
+        subroutine using a single call. Much faster than creating each dispatch
+        on its own when issuing many of them.
+
+        Parameters
+        ----------
+        groupCounts: ndarray[uint32]
+            Amount of workgroups in X, Y and Z dimension per dispatch as array
+            of shape (n, 3)
+        push: ndarray | None, default=None
+            Push data of each dispatch as C contiguous array with one row per
+            dispatch, e.g. a structured array
+        simultaneous: bool, default=False
+            True, if the subroutine can be submitted while a previous submission
+            has not yet finished
+        trackHazards: bool, default=False
+            True, if barriers should only be recorded between dispatches actually
+            depending on each other
+        """
+        ...
+    @overload
+    def dispatchBatch(
+        self,
+        sequence: hephaistos.pyhephaistos.SequenceBuilder,
+        groupCounts: numpy.typing.NDArray,
+        push: Optional[numpy.typing.NDArray] = None,
+    ) -> hephaistos.pyhephaistos.SequenceBuilder:
+        """
+        Issues a dispatch for each row of the given arrays in the current step
+        of the sequence using a single call. Returns the sequence.
+
+        Parameters
+        ----------
+        sequence: SequenceBuilder
+            Sequence to record the dispatches into
+        groupCounts: ndarray[uint32]
+            Amount of workgroups in X, Y and Z dimension per dispatch as array
+            of shape (n, 3)
+        push: ndarray | None, default=None
+            Push data of each dispatch as C contiguous array with one row per
+            dispatch, e.g. a structured array
+        """
+        ...
+    def dispatchElements(
+        self, nx: int, ny: int = 1, nz: int = 1
+    ) -> hephaistos.pyhephaistos.DispatchCommand:
+        """
+        Dispatches a program execution covering the given amount of elements.
+        The amount of workgroups is derived from the local size, rounding up.
+        Shaders must thus check for out of bounds invocations.
+
+        Parameters
+        ----------
+        nx: int
+            Number of elements in X dimension
+        ny: int, default=1
+            Number of elements in Y dimension
+        nz: int, default=1
+            Number of elements in Z dimension
+        """
+        ...
+    def dispatchElementsPush(
+        self, push: bytes, nx: int, ny: int = 1, nz: int = 1
+    ) -> hephaistos.pyhephaistos.DispatchCommand:
+        """
+        Dispatches a program execution with the given push data covering the
+        given amount of elements.
+
+        Parameters
+        ----------
+        push: bytes
+            Data pushed to the dispatch as bytes
+        nx: int
+            Number of elements in X dimension
+        ny: int, default=1
+            Number of elements in Y dimension
+        nz: int, default=1
+            Number of elements in Z dimension
+        """
+        ...
+    def dispatchIndirect(
+        self, tensor: hephaistos.pyhephaistos.Tensor, offset: int = 0
+    ) -> hephaistos.pyhephaistos.DispatchIndirectCommand:
+        """
+        Dispatches a program execution using the amount of workgroups stored in
+        the given tensor at the given offset. Expects the workgroup size as
+        three consecutive unsigned 32 bit integers.
+
+        Parameters
+        ----------
+        tensor: Tensor
+            Tensor from which to read the amount of workgroups
+        offset: int, default=0
+            Offset at which to start reading
+        """
+        ...
+    def dispatchIndirectPush(
+        self, push: bytes, tensor: hephaistos.pyhephaistos.Tensor, offset: int = 0
+    ) -> hephaistos.pyhephaistos.DispatchIndirectCommand:
+        """
+        Dispatches a program execution with the given push data using the amount
+        of workgroups stored in the given tensor at the given offset.
+
+        Parameters
+        ----------
+        push: bytes
+            Data pushed to the dispatch as bytes
+        tensor: Tensor
+            Tensor from which to read the amount of workgroups
+        offset: int, default=0
+            Offset at which to start reading
+        """
+        ...
+    @overload
+    def dispatchPush(
+        self,
+        set: hephaistos.pyhephaistos.ParameterSet,
+        push: bytes,
+        x: int = 1,
+        y: int = 1,
+        z: int = 1,
+    ) -> hephaistos.pyhephaistos.DispatchCommand:
+        """
+        Dispatches a program execution with the given push data and amount of
+        workgroups using the parameters of the given set.
+
+        Parameters
+        ----------
+        set: ParameterSet
+            Set providing the parameters
+        push: bytes
+            Data pushed to the dispatch as bytes
+        x: int, default=1
+            Number of groups to dispatch in X dimension
+        y: int, default=1
+            Number of groups to dispatch in Y dimension
+        z: int, default=1
+            Number of groups to dispatch in Z dimension
+        """
+        ...
+    @overload
+    def dispatchPush(
+        self,
+        heap: hephaistos.pyhephaistos.ResourceHeap,
+        push: bytes,
+        x: int = 1,
+        y: int = 1,
+        z: int = 1,
+    ) -> hephaistos.pyhephaistos.DispatchCommand:
+        """
+        Dispatches a program execution with the given push data and amount of
+        workgroups using the resources of the given heap. The push data usually
+        contains the indices of the resources to use.
+
+        Parameters
+        ----------
+        heap: ResourceHeap
+            Heap providing the resources
+        push: bytes
+            Data pushed to the dispatch as bytes
+        x: int, default=1
+            Number of groups to dispatch in X dimension
+        y: int, default=1
+            Number of groups to dispatch in Y dimension
+        z: int, default=1
+            Number of groups to dispatch in Z dimension
+        """
+        ...
+    @overload
+    def dispatchPush(
+        self, push: bytes, x: int = 1, y: int = 1, z: int = 1
+    ) -> hephaistos.pyhephaistos.DispatchCommand:
+        """
+        Dispatches a program execution with the given push data and amount of
+        workgroups.
+
+        Parameters
+        ----------
+        push: bytes
+            Data pushed to the dispatch as bytes
+        x: int, default=1
+            Number of groups to dispatch in X dimension
+        y: int, default=1
+            Number of groups to dispatch in Y dimension
+        z: int, default=1
+            Number of groups to dispatch in Z dimension
+        """
+        ...
+    def getShaderBinary(self) -> bytes:
+        """
+        Returns the binary of the program's shader object, which can be passed on
+        creating the same program again to skip compilation. Only available if
+        shader objects are enabled.
+        """
+        ...
+    def getStatistics(self) -> hephaistos.pyhephaistos.ProgramStatistics:
+        """
+        Returns the resource usage and expected occupancy. Queries the driver's
+        statistics on each call.
+        """
+        ...
+    def isBindingBound(i: int,/) -> bool:
+        """
+        Checks wether the i-th binding is currently bound.
+        """
+        ...
+    @overload
+    def isBindingBound(name: str,/) -> bool:
+        """
+        Checks wether the binding specified by its name is currently bound
+        """
+        ...
+    @property
+    def localSize(self) -> hephaistos.pyhephaistos.LocalSize:
+        """
+        Returns the size of the local work group.
+        """
+        ...
+    @property
+    def pushConstantMembers(self) -> list[hephaistos.pyhephaistos.BlockMember]:
+        """
+        Layout of the push constant block members.
+        """
+        ...
+    @property
+    def pushConstantSize(self) -> int:
+        """
+        Size of the push constant block in bytes. Zero if not used.
+        """
+        ...
+    def reload(self, code: bytes, specialization: Optional[bytes] = None) -> None:
+        """
+        Replaces the program's code. Bound parameters are kept if the new code
+        declares the same bindings, otherwise they get reset. The previous code
+        stays alive, so pending submissions and recorded subroutines still use
+        it.
+
+        Parameters
+        ----------
+        code: bytes
+            Byte code of the program
+        specialization: bytes | None, default=None
+            Data used for filling in specialization constants
+        """
+        ...
+    @property
+    def usesDescriptorSetCache(self) -> bool:
+        """
+        True, if the program binds cached descriptor sets instead of pushing
+        its parameters.
+        """
+        ...
+
+class ProgramBundle:
+    """
+    Collection of named programs including their reflection, which can be
+    saved to a file and created all at once later on. Programs created from a
+    bundle skip reflecting their code and get compiled in parallel against
+    the context's pipeline cache.
+    """
+
+    @overload
+    def __init__(self) -> None:
+        """
+        Creates a new empty bundle
+        """
+        ...
+    @overload
+    def __init__(self, path: str | os.PathLike) -> None:
+        """
+        Loads a bundle from a file written by save()
+        """
+        ...
+    def __contains__(self, name: str) -> bool: ...
+    def __len__(self) -> int: ...
+    def add(
+        self,
+        name: str,
+        code: bytes,
+        specialization: Optional[bytes] = None,
+        subgroupSize: int = 0,
+        fullSubgroups: bool = False,
+    ) -> None:
+        """
+        Adds a program to the bundle. Reflects the code right away.
+
+        Parameters
+        ----------
+        name: str
+            Name used to identify the program
+        code: bytes
+            Byte code of the program
+        specialization: bytes | None, default=None
+            Data used for filling in specialization constants
+        subgroupSize: int, default=0
+            Threads per subgroup the program must run with. Zero lets the driver
+            choose.
+        fullSubgroups: bool, default=False
+            If True, all subgroups of a workgroup must be full
+        """
+        ...
+    def createProgram(self, name: str) -> hephaistos.pyhephaistos.Program:
+        """
+        Creates the program of the given name
+        """
+        ...
+    def createPrograms(self, threads: int = 0) -> list:
+        """
+        Creates all programs of the bundle in parallel and returns them in the
+        order they were added.
+
+        Parameters
+        ----------
+        threads: int, default=0
+            Maximum amount of threads to use. Zero uses one per core.
+        """
+        ...
+    @staticmethod
+    def fromBytes(data: bytes) -> hephaistos.pyhephaistos.ProgramBundle:
+        """
+        Loads a bundle from data created by serialize()
+        """
+        ...
+    def getBindings(self, name: str) -> list[hephaistos.pyhephaistos.BindingTraits]:
+        """
+        Returns the traits of all bindings of the given program
+        """
+        ...
+    def getLocalSize(self, name: str) -> hephaistos.pyhephaistos.LocalSize:
+        """
+        Returns the local size of the given program
+        """
+        ...
+    @property
+    def names(self) -> list[str]:
+        """
+        Names of all programs in the order they were added
+        """
+        ...
+    def save(self, path: str | os.PathLike) -> None:
+        """
+        Saves the bundle to the given file
+        """
+        ...
+    def serialize(self) -> bytes:
+        """
+        Serializes the bundle into bytes
+        """
+        ...
+    def warmUp(self, threads: int = 0) -> None:
+        """
+        Compiles all programs, leaving them in the context's pipeline cache, so
+        programs created afterwards skip compiling. Blocks until finished, but
+        releases the GIL, thus can be run on a separate thread.
+
+        Parameters
+        ----------
+        threads: int, default=0
+            Maximum amount of threads to use. Zero uses one per core.
+        """
+        ...
+
+class ProgramCache:
+    """
+    Cache of programs keyed by their code, specialization and subgroup
+    requirements. Returns the same program for identical requests and drops
+    the least recently used ones once it exceeds its limits. Programs are
+    shared between requests including their bound parameters.
+
+    Parameters
+    ----------
+    maxPrograms: int, default=256
+        Maximum amount of cached programs. Zero means no limit.
+    maxCodeSize: int, default=0
+        Maximum total size of the cached code in bytes. Zero means no limit.
+    """
+
+    def __init__(self, maxPrograms: int = 256, maxCodeSize: int = 0) -> None: ...
+    def __len__(self) -> int: ...
+    def clear(self) -> None:
+        """
+        Drops all cached programs. Programs still referenced stay alive.
+        """
+        ...
+    @property
+    def codeSize(self) -> int:
+        """
+        Total size of the cached programs' code in bytes
+        """
+        ...
+    def compile(
+        self,
+        compiler: hephaistos.pyhephaistos.Compiler,
+        source: str,
+        specialization: Optional[bytes] = None,
+    ) -> hephaistos.pyhephaistos.Program:
+        """
+        Returns the program compiled from the given GLSL source code. Skips
+        compiling if the same source was compiled with the same compiler
+        settings for a program still in the cache.
+
+        Parameters
+        ----------
+        compiler: Compiler
+            Compiler used for compiling the source code
+        source: str
+            GLSL source code
+        specialization: bytes | None, default=None
+            Data used for filling in specialization constants
+        """
+        ...
+    def get(
+        self,
+        code: bytes,
+        specialization: Optional[bytes] = None,
+        subgroupSize: int = 0,
+        fullSubgroups: bool = False,
+    ) -> hephaistos.pyhephaistos.Program:
+        """
+        Returns the program for the given code and specialization, creating it
+        if it is not cached.
+
+        Parameters
+        ----------
+        code: bytes
+            Compiled shader byte code
+        specialization: bytes | None, default=None
+            Data used for filling in specialization constants
+        subgroupSize: int, default=0
+            Threads per subgroup the program must run with. Zero lets the driver
+            choose.
+        fullSubgroups: bool, default=False
+            If True, all subgroups of a workgroup must be full
+        """
+        ...
+    @property
+    def maxCodeSize(self) -> int:
+        """
+        Maximum total size of the cached code in bytes. Zero means no limit.
+        """
+        ...
+    @property
+    def maxPrograms(self) -> int:
+        """
+        Maximum amount of cached programs. Zero means no limit.
+        """
+        ...
+    def setLimits(self, maxPrograms: int, maxCodeSize: int = 0) -> None:
+        """
+        Sets the limits of the cache dropping the least recently used programs
+        until they are met.
+
+        Parameters
+        ----------
+        maxPrograms: int
+            Maximum amount of cached programs. Zero means no limit.
+        maxCodeSize: int, default=0
+            Maximum total size of the cached code in bytes. Zero means no limit.
+        """
+        ...
+    @property
+    def statistics(self) -> hephaistos.pyhephaistos.ProgramCacheStatistics:
+        """
+        Hits, misses and evictions counted so far
+        """
+        ...
+
+class ProgramCacheStatistics:
+    """
+    Counters of a ProgramCache
+    """
+
+    @property
+    def evictions(self) -> int:
+        """
+        Programs dropped to stay within the limits
+        """
+        ...
+    @property
+    def hits(self) -> int:
+        """
+        Requests served by a cached program
+        """
+        ...
+    @property
+    def misses(self) -> int:
+        """
+        Requests creating a new program
+        """
+        ...
+
+class ProgramFamily:
+    """
+    Family of programs sharing the same code but differing in their
+    specialization. Creates a variant for each distinct specialization on its
+    first request and returns the same one afterwards.
+
+    Parameters
+    ----------
+    code: bytes
+        Byte code shared by all variants
+    subgroupSize: int, default=0
+        Threads per subgroup the variants must run with. Zero lets the driver
+        choose.
+    fullSubgroups: bool, default=False
+        If True, all subgroups of a workgroup must be full
+    """
+
+    def __init__(
+        self, code: bytes, subgroupSize: int = 0, fullSubgroups: bool = False
+    ) -> None: ...
+    def __len__(self) -> int: ...
+    def clear(self) -> None:
+        """
+        Destroys all variants. Previously returned ones must not be used
+        anymore.
+        """
+        ...
+    def getVariant(
+        self, specialization: Optional[bytes] = None
+    ) -> hephaistos.pyhephaistos.Program:
+        """
+        Returns the variant for the given specialization data, creating it on
+        the first request.
+
+        Parameters
+        ----------
+        specialization: bytes | None, default=None
+            Data used for filling in specialization constants
+        """
+        ...
+
+class ProgramStatistic:
+    """
+    Statistic about a compiled program reported by the driver
+    """
+
+    @property
+    def description(self) -> str:
+        """
+        Description of the statistic
+        """
+        ...
+    @property
+    def name(self) -> str:
+        """
+        Name of the statistic
+        """
+        ...
+    @property
+    def value(self) -> float:
+        """
+        Value of the statistic
+        """
+        ...
+
+class ProgramStatistics:
+    """
+    Resource usage and expected occupancy of a program. The occupancy assumes
+    2048 resident threads per compute unit and the device's shared memory limit
+    per compute unit and does not account for registers.
+    """
+
+    @property
+    def driverStatistics(self) -> list[hephaistos.pyhephaistos.ProgramStatistic]:
+        """
+        Statistics reported by the driver. Empty if
+        VK_KHR_pipeline_executable_properties is not supported or the program was
+        created as shader object.
+        """
+        ...
+    @property
+    def occupancy(self) -> float:
+        """
+        Fraction of a compute unit's thread slots filled by resident workgroups
+        """
+        ...
+    @property
+    def registerCount(self) -> Optional[int]:
+        """
+        Registers used per thread if reported by the driver
+        """
+        ...
+    @property
+    def residentGroups(self) -> int:
+        """
+        Workgroups expected to be resident on a compute unit at once
+        """
+        ...
+    @property
+    def sharedMemorySize(self) -> int:
+        """
+        Bytes of shared memory used by a single workgroup. Arrays sized by
+        specialization constants use their default size.
+        """
+        ...
+
+R16G16B16A16_SINT: ImageFormat
+
+R16G16B16A16_UINT: ImageFormat
+
+R16G16B16A16_UNORM: ImageFormat
+
+R32G32B32A32_SFLOAT: ImageFormat
+
+R32G32B32A32_SINT: ImageFormat
+
+R32G32B32A32_UINT: ImageFormat
+
+R32G32_SFLOAT: ImageFormat
+
+R32G32_SINT: ImageFormat
+
+R32G32_UINT: ImageFormat
+
+R32_SFLOAT: ImageFormat
+
+R32_SINT: ImageFormat
+
+R32_UINT: ImageFormat
+
+R8G8B8A8_SINT: ImageFormat
+
+R8G8B8A8_SNORM: ImageFormat
+
+R8G8B8A8_UINT: ImageFormat
+
+R8G8B8A8_UNORM: ImageFormat
+
+class QueuePriority:
+    """
+    System wide scheduling priority of the context's queues
+    """
+
+    HIGH: QueuePriority
+    """
+    Latency sensitive work. May require elevated privileges.
+    """
+
+    LOW: QueuePriority
+    """
+    Background work yielding to everything else
+    """
+
+    MEDIUM: QueuePriority
+    """
+    Default priority of every queue
+    """
+
+    REALTIME: QueuePriority
+    """
+    Work that must not be delayed by any other work. Usually requires elevated
+    privileges.
+    """
+
+class QueueType:
+    """
+    Type of queue work is submitted to
+    """
+
+    COMPUTE: QueueType
+    """
+    Additional queue supporting compute and transfer
+    """
+
+    MAIN: QueueType
+    """
+    Main queue supporting compute and transfer
+    """
+
+    TRANSFER: QueueType
+    """
+    Queue restricted to transfer, usually backed by DMA engines
+    """
+
+class RandomStreamAllocator:
+    """
+    Allocates disjoint ranges of random streams. Random numbers are generated
+    by the counter-based generator Philox4x32-10 deriving each number from the
+    seed, the index of its stream and its position inside it. Programs
+    therefore need no stored state, but streams must not be reused across
+    dispatches. Inside programs, streams are created via createRandomStream()
+    declared in the built-in header "hephaistos/random.glsl" available to all
+    compilations. Pass the allocated range to them using RandomStreams from
+    hephaistos.glsl. Allocation is thread safe.
+
+    Parameters
+    ----------
+    seed: int
+        Seed of all allocated streams
+    offset: int, default=0
+        Index of the first stream allocated
+    """
+
+    def __init__(self, seed: int, offset: int = 0) -> None: ...
+    def allocate(self, count: int) -> int:
+        """
+        Allocates the given amount of streams and returns the index of the
+        first one.
+        """
+        ...
+    @property
+    def allocated(self) -> int:
+        """
+        Amount of streams allocated so far
+        """
+        ...
+    def reset(self, offset: int = 0) -> None:
+        """
+        Resets the allocation to the given stream index. Streams allocated
+        before get reused, thus repeating their numbers.
+        """
+        ...
+    @property
+    def seed(self) -> int:
+        """
+        Seed of all allocated streams
+        """
+        ...
+
+class RawBuffer:
+    """
+    Buffer for allocating a raw chunk of memory on the host accessible via its
+    memory address. Useful as a base class providing more complex functionality.
+    Supports the buffer protocol, e.g. memoryview(buffer), without copies.
+
+    Parameters
+    ----------
+    size: int
+        size of the buffer in bytes
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    @overload
+    def __init__(self, size: int) -> None: ...
+    @overload
+    def __init__(self, array: numpy.typing.NDArray) -> None:
+        """
+        Creates a buffer using the memory of the given contiguous array instead
+        of allocating new one, avoiding a copy. The array is kept alive by the
+        buffer. Its address and size must be multiples of
+        getHostMemoryImportAlignment(). Requires isHostMemoryImportSupported() to
+        be True.
+        """
+        ...
+    @property
+    def address(self) -> int:
+        """
+        The memory address of the allocated buffer.
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        The size of the buffer in bytes.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the buffer in bytes.
+        """
+        ...
+
+class RayCastMode:
+    """
+    Determines which hit a RayCaster reports
+    """
+
+    ANY: RayCastMode
+    """
+    Reports the first hit found and stops traversal
+    """
+
+    CLOSEST: RayCastMode
+    """
+    Reports the closest hit along the ray
+    """
+
+    COUNT: RayCastMode
+    """
+    Counts all hits along the ray while reporting the closest one
+    """
+
+class RayCaster:
+    """
+    Casts batches of rays against an acceleration structure using a built-in
+    ray query kernel. Rays are read as structs of (vec3 origin, float tMin,
+    vec3 direction, float tMax) and a hit is written for each as struct of
+    (float t, uint instanceIndex, uint customIndex, uint primitiveIndex, vec2
+    barycentrics, uint geometryIndex, uint count), i.e. 32 bytes each. Missed
+    rays have an instanceIndex of 0xFFFFFFFF. Only triangle geometries are
+    considered. Requires ray tracing to be enabled.
+
+    Parameters
+    ----------
+    localSize: int, default=0
+        Threads per workgroup. Zero picks one based on the device.
+    raysPerThread: int, default=0
+        Rays cast per thread. Zero picks a default.
+    """
+
+    def __init__(self, *, localSize: int = 0, raysPerThread: int = 0) -> None: ...
+    def castRays(
+        self,
+        accelerationStructure: hephaistos.pyhephaistos.AccelerationStructure,
+        rays: hephaistos.pyhephaistos.Tensor,
+        hits: hephaistos.pyhephaistos.Tensor,
+        mode: hephaistos.pyhephaistos.RayCastMode = RayCastMode.CLOSEST,
+        *,
+        count: Optional[int] = None,
+    ) -> hephaistos.pyhephaistos.CastRaysCommand:
+        """
+        Creates a command casting rays against the acceleration structure.
+
+        Parameters
+        ----------
+        accelerationStructure: AccelerationStructure
+            Scene to cast the rays against
+        rays: Tensor
+            Tensor holding the rays
+        hits: Tensor
+            Tensor receiving a hit per ray
+        mode: RayCastMode, default=RayCastMode.CLOSEST
+            Determines which hit gets reported
+        count: int | None, default=None
+            Amount of rays. Uses the whole ray tensor if None.
+        """
+        ...
+    @property
+    def localSize(self) -> int:
+        """
+        Threads per workgroup
+        """
+        ...
+    @property
+    def raysPerThread(self) -> int:
+        """
+        Rays cast per thread
+        """
+        ...
+
+class RayTracingProgram:
+    """
+    Program running on the ray tracing pipeline. All shaders share a single
+    set of bindings and push constants. Requires ray tracing pipelines to be
+    enabled via enableRaytracing(pipeline=True).
+
+    Parameters
+    ----------
+    rayGen: bytes
+        Compiled ray generation shader
+    miss: list[bytes], default=[]
+        Compiled miss shaders. Their index is used by traceRayEXT()
+    hitGroups: list[HitGroup], default=[]
+        Hit groups selected via sbtRecordOffset and the instance's offset
+    specialization: bytes, default=b''
+        Data used for filling in specialization constants of all shaders
+    maxRecursionDepth: int, default=1
+        Maximum depth of recursive traceRayEXT() calls
+    """
+
+    def __init__(
+        self,
+        rayGen: bytes,
+        miss: list[bytes] = [],
+        hitGroups: list[hephaistos.pyhephaistos.HitGroup] = [],
+        *,
+        specialization: bytes = b"",
+        maxRecursionDepth: int = 1,
+    ) -> None: ...
+    def bindParameter(
+        self,
+        param: hephaistos.pyhephaistos.Tensor | hephaistos.pyhephaistos.AccelerationStructure,
+        binding: int | str,
+    ) -> None:
+        """
+        Binds the tensor or acceleration structure to the given binding
+        """
+        ...
+    def bindParams(*params, **namedparams) -> None:
+        """
+        Binds the given parameters.
+        Positional arguments are bound to the binding of the corresponding
+        position. Keyword arguments are matched with the binding of the same
+        name.
+        """
+        ...
+    @property
+    def bindings(self) -> list[hephaistos.pyhephaistos.BindingTraits]:
+        """
+        Returns a list of all bindings shared by the shaders.
+        """
+        ...
+    @property
+    def hitGroupCount(self) -> int:
+        """
+        Amount of hit groups
+        """
+        ...
+    def isBindingBound(self, i: int) -> bool:
+        """
+        Checks wether the i-th binding is bound
+        """
+        ...
+    @property
+    def missCount(self) -> int:
+        """
+        Amount of miss shaders
+        """
+        ...
+    def traceRays(
+        self, width: int, height: int = 1, depth: int = 1
+    ) -> hephaistos.pyhephaistos.TraceRaysCommand:
+        """
+        Traces rays using the current bindings launching one ray generation
+        invocation per element of the given grid.
+
+        Parameters
+        ----------
+        width: int
+            Amount of rays in X dimension
+        height: int, default=1
+            Amount of rays in Y dimension
+        depth: int, default=1
+            Amount of rays in Z dimension
+        """
+        ...
+    def traceRaysPush(
+        self, push: bytes, width: int, height: int = 1, depth: int = 1
+    ) -> hephaistos.pyhephaistos.TraceRaysCommand:
+        """
+        Traces rays using the current bindings and the given push data.
+
+        Parameters
+        ----------
+        push: bytes
+           Data pushed to all shaders as bytes
+        width: int
+            Amount of rays in X dimension
+        height: int, default=1
+            Amount of rays in Y dimension
+        depth: int, default=1
+            Amount of rays in Z dimension
+        """
+        ...
+
+class RebuildAccelerationStructureCommand:
+    """
+    Command for rebuilding an acceleration structure from instances stored in a
+    tensor
+    """
+
+    def __init__(
+        self,
+        accelerationStructure: hephaistos.pyhephaistos.AccelerationStructure,
+        instances: hephaistos.pyhephaistos.Tensor,
+        count: int,
+        offset: int = 0,
+        update: bool = False,
+    ) -> None: ...
+
+class ReduceOperation:
+    """
+    Associative operation used to combine elements
+    """
+
+    ADD: ReduceOperation
+
+    MAX: ReduceOperation
+
+    MIN: ReduceOperation
+
+class ResourceHeap:
+    """
+    Large set of resources programs can index into. Provides storage buffers at
+    binding 0, storage images at binding 1 and combined image samplers at
+    binding 2, sharing a single index space. Resources are not tracked for
+    hazards.
+    """
+
+    def __init__(self) -> None:
+        """
+        Creates a new empty resource heap
+        """
+        ...
+    @overload
+    def add(self, tensor: hephaistos.pyhephaistos.Tensor) -> int:
+        """
+        Adds the tensor to the heap and returns its index
+        """
+        ...
+    @overload
+    def add(self, view: hephaistos.pyhephaistos.TensorView) -> int:
+        """
+        Adds the tensor view to the heap and returns its index
+        """
+        ...
+    @overload
+    def add(self, image: hephaistos.pyhephaistos.Image) -> int:
+        """
+        Adds the image to the heap and returns its index
+        """
+        ...
+    @overload
+    def add(self, texture: hephaistos.pyhephaistos.Texture) -> int:
+        """
+        Adds the texture to the heap and returns its index
+        """
+        ...
+    @property
+    def capacity(self) -> int:
+        """
+        Maximum amount of resources in the heap
+        """
+        ...
+    def remove(self, index: int) -> None:
+        """
+        Removes the resource at the given index, which might be reused by later
+        additions
+        """
+        ...
+    @overload
+    def set(self, index: int, tensor: hephaistos.pyhephaistos.Tensor) -> None:
+        """
+        Replaces the resource at the given index with the tensor
+        """
+        ...
+    @overload
+    def set(self, index: int, view: hephaistos.pyhephaistos.TensorView) -> None:
+        """
+        Replaces the resource at the given index with the tensor view
+        """
+        ...
+    @overload
+    def set(self, index: int, image: hephaistos.pyhephaistos.Image) -> None:
+        """
+        Replaces the resource at the given index with the image
+        """
+        ...
+    @overload
+    def set(self, index: int, texture: hephaistos.pyhephaistos.Texture) -> None:
+        """
+        Replaces the resource at the given index with the texture
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        Amount of resources currently in the heap
+        """
+        ...
+
+class ResourceInfo:
+    """
+    Live resource recorded by the resource tracking
+    """
+
+    def __repr__(self) -> str: ...
+    @property
+    def size(self) -> int:
+        """
+        Size of the resource's memory in bytes. Zero if unknown.
+        """
+        ...
+    @property
+    def tag(self) -> str:
+        """
+        Tag assigned via setResourceTag(). Empty if none.
+        """
+        ...
+    @property
+    def type(self) -> str:
+        """
+        Type of the resource, e.g. Tensor or Program
+        """
+        ...
+
+class RetrieveImageCommand:
+    """
+    Command for copying the image back into the given buffer
+    """
+
+    def __init__(
+        self,
+        src: hephaistos.pyhephaistos.Image,
+        dst: hephaistos.pyhephaistos.Buffer,
+        region: hephaistos.pyhephaistos.ImageRegion = ImageRegion(),
+    ) -> None: ...
+
+class RetrieveTensorCommand:
+    """
+    Command for copying the src tensor back to the destination buffer
+    """
+
+    def __init__(
+        self,
+        src: hephaistos.pyhephaistos.Tensor,
+        dst: hephaistos.pyhephaistos.Buffer,
+        bufferOffset: Optional[int] = None,
+        tensorOffset: Optional[int] = None,
+        size: Optional[int] = None,
+        unsafe: bool = False
+    ) -> None: ...
+
+class ScratchAllocator:
+    """
+    Allocator for scratch tensors sharing memory. Tensors are declared with the
+    first and last step of a sequence using them. Tensors whose lifetimes do not
+    overlap may occupy the same memory, reducing the peak memory usage. The
+    content of scratch tensors is undefined at the start of their lifetime.
+    """
+
+    def __init__(self) -> None: ...
+    def __len__(self) -> int: ...
+    def allocate(self) -> None:
+        """
+        Allocates memory for all declared tensors. No tensors can be declared
+        afterwards.
+        """
+        ...
+    @property
+    def declared_bytes(self) -> int:
+        """
+        Sum of sizes of all declared tensors in bytes, i.e. memory required
+        without aliasing.
+        """
+        ...
+    def declare(self, size: int, firstStep: int, lastStep: int) -> int:
+        """
+        Declares a new scratch tensor of the given size in bytes used from
+        firstStep until lastStep including and returns its id.
+        """
+        ...
+    def get(self, id: int) -> hephaistos.pyhephaistos.Tensor:
+        """
+        Returns the scratch tensor with the given id. Only available after
+        allocation.
+        """
+        ...
+    @property
+    def isAllocated(self) -> bool:
+        """
+        True, if allocate() was called
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        Size of the shared memory in bytes. Zero until allocated.
+        """
+        ...
+
+class SequenceBuilder:
+    """
+    Builder class for recording a sequence of commands and subroutines and
+    submitting it to the device for execution, which happens asynchronous, i.e.
+    submit() returns before the recorded work finishes.
+    """
+
+    def And(
+        self, subroutine: hephaistos.pyhephaistos.Subroutine
+    ) -> hephaistos.pyhephaistos.SequenceBuilder:
+        """
+        Issues the subroutine to run parallel in the current step.
+        """
+        ...
+    @overload
+    def And(
+        self, cmd: hephaistos.pyhephaistos.Command
+    ) -> hephaistos.pyhephaistos.SequenceBuilder:
+        """
+        Issues the command to run parallel in the current step.
+        """
+        ...
+    def AndList(self, list: list) -> hephaistos.pyhephaistos.SequenceBuilder:
+        """
+        Issues each element of the list to run parallel in the current step
+        """
+        ...
+    def Freeze(self) -> hephaistos.pyhephaistos.SequenceTemplate:
+        """
+        Finishes recording and returns a SequenceTemplate, which can be submitted multiple times. Only available for sequences started with beginSequenceTemplate().
+        """
+        ...
+    def NextStep(self) -> hephaistos.pyhephaistos.SequenceBuilder:
+        """
+        Issues a new step. Following calls to And are ensured to run after previous ones finished.
+        """
+        ...
+    def OnQueue(
+        self, queue: hephaistos.pyhephaistos.QueueType
+    ) -> hephaistos.pyhephaistos.SequenceBuilder:
+        """
+        Runs the current step, or a new one if it already contains work, and all following steps on the given queue.
+        """
+        ...
+    def Submit(self) -> hephaistos.pyhephaistos.Submission:
+        """
+        Submits the recorded steps as a single batch to the GPU. Blocks while
+        the submission limit of the context is reached.
+        """
+        ...
+    def Then(
+        self, subroutine: hephaistos.pyhephaistos.Subroutine
+    ) -> hephaistos.pyhephaistos.SequenceBuilder:
+        """
+        Issues a new step to execute after waiting for the previous one to finish.
+        """
+        ...
+    @overload
+    def Then(
+        self, cmd: hephaistos.pyhephaistos.Command
+    ) -> hephaistos.pyhephaistos.SequenceBuilder:
+        """
+        Issues a new step to execute after waiting for the previous one to finish.
+        """
+        ...
+    def ThenHost(
+        self, callback: Callable[[], None]
+    ) -> hephaistos.pyhephaistos.SequenceBuilder:
+        """
+        Issues a step running the callback on a background thread once the
+        previous steps finished. Following steps wait for it to return, while
+        the whole sequence is still submitted at once. Raised exceptions are
+        reported as unraisable and do not stop the sequence.
+
+        Parameters
+        ----------
+        callback: Callable[[], None]
+            Function to run on the host
+        """
+        ...
+    def TrackHazards(self) -> hephaistos.pyhephaistos.SequenceBuilder:
+        """
+        Only records barriers between commands within a step actually depending on each other. Should be called before any command is recorded.
+        """
+        ...
+    def TrySubmit(self) -> Optional[hephaistos.pyhephaistos.Submission]:
+        """
+        Submits the recorded steps like Submit(), unless the submission limit
+        of the context is reached. Returns None without submitting in that case.
+        """
+        ...
+    def WaitFor(
+        self, timeline: hephaistos.pyhephaistos.Timeline, value: int
+    ) -> hephaistos.pyhephaistos.SequenceBuilder:
+        """
+        Issues the following steps to wait for the given timeline to reach the given value
+        """
+        ...
+    @overload
+    def WaitFor(self, value: int) -> hephaistos.pyhephaistos.SequenceBuilder:
+        """
+        Issues the following steps to wait on the sequence timeline to reach the given value.
+        """
+        ...
+    def __init__(
+        self, timeline: hephaistos.pyhephaistos.Timeline, startValue: int
+    ) -> None:
+        """
+        Creates a new SequenceBuilder.
+
+        Parameters
+        ----------
+        timeline: Timeline
+            Timeline to use for orchestrating commands and subroutines
+        startValue: int
+            Counter value to wait for on the timeline to start with
+        """
+        ...
+    @overload
+    def __init__(self, timeline: hephaistos.pyhephaistos.Timeline) -> None:
+        """
+        Creates a new SequenceBuilder.
+
+        Parameters
+        ----------
+        timeline: Timeline
+            Timeline to use for orchestrating commands and subroutines
+        """
+        ...
+    def getWaitGraph(self) -> hephaistos.pyhephaistos.WaitGraph:
+        """
+        Returns the structured wait graph of the recorded steps.
+        Must be called before Submit().
+        """
+        ...
+    def printWaitGraph(self) -> str:
+        """
+        Returns a visualization of the current wait graph in the form:
+        (Timeline.ID(WaitValue))* -> (submissions) -> (Timeline.ID(SignalValue)).
+        Must be called before Submit().
+        """
+        ...
+
+class SequenceTemplate:
+    """
+    Recorded sequence of commands and subroutines, which can be submitted
+    multiple times. Each submission shifts the values of its timeline, e.g. a
+    sequence waiting on 2 and finishing at 5 runs from 5 to 8 when submitted a
+    second time. Waits on other timelines stay as they are.
+    """
+
+    def Submit(self, startValue: int) -> hephaistos.pyhephaistos.Submission:
+        """
+        Submits the recorded steps with the first one waiting on the given value. Must not be lower than the final step of the previous submission.
+        """
+        ...
+    @overload
+    def Submit(self) -> hephaistos.pyhephaistos.Submission:
+        """
+        Submits the recorded steps continuing where the previous submission ended.
+        """
+        ...
+    @property
+    def nextStartValue(self) -> int:
+        """
+        The value the next submission waits on by default, i.e. the final step of the previous one.
+        """
+        ...
+    @property
+    def timeline(self) -> hephaistos.pyhephaistos.Timeline:
+        """
+        The timeline used to orchestrate the steps.
+        """
+        ...
+
+class ShaderStage:
+    """
+    Shader stage code gets compiled for
+    """
+
+    ANY_HIT: ShaderStage
+
+    CLOSEST_HIT: ShaderStage
+
+    COMPUTE: ShaderStage
+
+    INTERSECTION: ShaderStage
+
+    MISS: ShaderStage
+
+    RAYGEN: ShaderStage
+
+class ShortBuffer:
+    """
+    Buffer representing memory allocated on the host holding an array of type
+    int16 and given size which can be accessed as numpy array or via the buffer
+    protocol, e.g. memoryview(buffer), without copies.
+
+    Parameters
+    ----------
+    size: int
+        Number of elements
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(self, size: int) -> None: ...
+    def numpy(self) -> numpy.typing.NDArray:
+        """
+        Returns a numpy array using this buffer's memory.
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        The number of elements in this buffer.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the buffer in bytes.
+        """
+        ...
+
+class ShortTensor:
+    """
+    Tensor representing memory allocated on the device holding an array of type
+    int16 and given size. If mapped can be accessed from the host using its
+    memory address. Mapping can optionally be requested but will be ignored if
+    the device does not support it. Query its support after creation via
+    isMapped. Mapped tensors support the buffer protocol, e.g.
+    memoryview(tensor).
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
+        """
+        Creates a new tensor and fills it with the provided data
+
+        Parameters
+        ----------
+        array: NDArray
+            Numpy array containing the data used to fill the tensor.
+            Its type must match the tensor's.
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(self, size: int, mapped: bool = False) -> None:
+        """
+        Creates a new tensor of given size.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(
+        self,
+        size: int,
+        hints: hephaistos.pyhephaistos.AllocationHints,
+        mapped: bool = False,
+    ) -> None:
+        """
+        Creates a new tensor of given size using the given allocation hints.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        hints: AllocationHints
+            Hints for allocating the memory
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
+        """
+        Creates a new tensor and fills it with the provided data
+
+        Parameters
+        ----------
+        addr: int
+            Address of the data used to fill the tensor
+        n: int
+            Number of bytes to copy from addr
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @property
+    def address(self) -> int:
+        """
+        The device address of this tensor.
+        """
+        ...
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
+    ) -> None:
+        """
+        Binds the tensor to the program or parameter set at the given binding
+        """
+        ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
+    ) -> None:
+        """
+        Binds the tensor to the program or parameter set at the given binding
+        """
+        ...
+    def flush(self, offset: int = 0, size: int | None = None, /) -> None:
+        """
+        Makes writes in mapped memory from the host available to the device.
+        Only needed if isNonCoherent is True.
+
+        Parameters
+        ----------
+        offset: int, default=0
+            Offset in amount of elements into mapped memory to flush
+        size: int|None, default=None
+            Number of elements to flush starting at offset.
+            If None, flushes all remaining elements.
+        """
+        ...
+    def invalidate(self, offset: int = 0, size: int | None = None, /) -> None:
+        """
+        Makes writes in mapped memory from the device available to the host.
+        Only needed if isNonCoherent is True.
+
+        Parameters
+        ----------
+        offset: int, default=0
+            Offset in amount of elements into mapped memory to invalidate
+        size: int | None, default=None
+            Number of elements to invalidate starting at offset.
+            If None, invalidates all remaining elements.
+        """
+        ...
+    @property
+    def isAllocated(self) -> bool:
+        """
+        True, if the tensor's memory was allocated. Only False for lazily
+        allocated tensors not used yet.
+        """
+        ...
+    @property
+    def isMapped(self) -> bool:
+        """
+        True, if the underlying memory is writable by the CPU.
+        """
+        ...
+    @property
+    def isNonCoherent(self) -> bool:
+        """
+        Wether calls to flush() and invalidate() are necessary to make changes
+        in mapped memory between devices and host available
+        """
+        ...
+    @property
+    def isPooled(self) -> bool:
+        """
+        True, if the tensor is sub-allocated from a shared buffer.
+        """
+        ...
+    @property
+    def memory(self) -> int:
+        """
+        Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
+        """
+        ...
+    def retrieve(self, addr: int, n: int, offset: int = 0, /) -> None:
+        """
+        Retrieves n elements from the tensor at the given offset and stores it
+        in dst.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy to
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        
+        Note
+        ----
+        This operation is only guaranteed to succeed on mapped tensors.
+        """
+        ...
+    def retrieveAsync(self, buffer: hephaistos.pyhephaistos.Buffer, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Copies data from the tensor at the given offset into the buffer without
+        waiting for the transfer to finish. The copy is ordered after previously
+        submitted work.
+
+        Parameters
+        ----------
+        buffer: Buffer
+            Buffer to copy to. Its size determines the amount of data copied
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        The number of elements in this tensor.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the tensor in bytes.
+        """
+        ...
+    def update(self, addr: int, n: int, offset: int = 0, /) -> None:
+        """
+        Updates the tensor at the given offset with n elements stored at addr.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        
+        Note
+        ----
+        This operation is only guaranteed to succeed on mapped tensors.
+        """
+        ...
+    def updateAsync(self, addr: int, n: int, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Updates the tensor at the given offset with n elements from addr without
+        waiting for the transfer to finish. The data is staged before returning,
+        thus the memory at addr can be reused directly. The copy is ordered after
+        previously submitted work.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in number of elements where the copy starts
+        """
+        ...
+
+class SortKeyType:
+    """
+    Type of the keys sorted by a primitive
+    """
+
+    FLOAT32: SortKeyType
+
+    FLOAT64: SortKeyType
+
+    INT32: SortKeyType
+
+    INT64: SortKeyType
+
+    UINT32: SortKeyType
+
+    UINT64: SortKeyType
+
+class SparseTensor:
+    """
+    Tensor reserving a virtual address range, which gets backed by memory on
+    demand in pages. Not limited by the maximum size of a single allocation.
+    Storage buffer bindings are limited to the device's maxStorageBufferRange,
+    larger tensors must be accessed via their address.
+    """
+
+    def __init__(self, size: int) -> None:
+        """
+        Reserves a new sparse tensor of the given size in bytes without
+        committing any memory.
+        """
+        ...
+    @property
+    def address(self) -> int:
+        """
+        The device address of this tensor.
+        """
+        ...
+    def commit(self, offset: int = 0, size: int = 18446744073709551615) -> None:
+        """
+        Backs the given range in bytes extended to whole pages with memory. The
+        content of newly committed pages is undefined.
+        """
+        ...
+    def decommit(self, offset: int = 0, size: int = 18446744073709551615) -> None:
+        """
+        Releases the memory of all pages completely contained in the given
+        range in bytes. Work using them must have finished.
+        """
+        ...
+    def isCommitted(self, offset: int = 0, size: int = 18446744073709551615) -> bool:
+        """
+        Returns True, if the given range in bytes is completely backed by
+        memory.
+        """
+        ...
+    @property
+    def pageSize(self) -> int:
+        """
+        Size in bytes of the pages memory is committed in
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the tensor in bytes.
+        """
+        ...
+    @property
+    def size_committed(self) -> int:
+        """
+        Number of bytes currently backed by memory
+        """
+        ...
+
+class SparseTexture:
+    """
+    3D texture reserving its image without backing it by memory. Memory is
+    committed in tiles given as (x, y, z, level) in units of tiles, while the
+    mip tail is always committed. Programs record the tiles their lookups touch
+    via sparseFeedbackMark() declared in the built-in header
+    hephaistos/sparse.glsl, which can be read back via fetchAccessedTiles().
+
+    Parameters
+    ----------
+    format: ImageFormat
+        Format of the image
+    width: int
+        Width of the image in pixels
+    height: int
+        Height of the image in pixels
+    depth: int
+        Depth of the image in pixels
+    mipLevels: int, default=1
+        Number of mip levels. Zero creates the full mip chain
+    kwargs
+        Sampler configuration as in Texture
+    """
+
+    def __init__(self, format: hephaistos.pyhephaistos.ImageFormat, width: int, height: int, depth: int, mipLevels: int = 1, **kwargs) -> None:
+        ...
+    def commit(self, tiles: list[tuple[int, int, int, int]]) -> None:
+        """
+        Backs the given tiles with memory. The content of newly committed tiles
+        is undefined.
+        """
+        ...
+    def decommit(self, tiles: list[tuple[int, int, int, int]]) -> None:
+        """
+        Releases the memory backing the given tiles. Work using them must have
+        finished.
+        """
+        ...
+    def decommitAll(self) -> None:
+        """
+        Releases the memory of all tiles
+        """
+        ...
+    @property
+    def feedback(self) -> bytes:
+        """
+        Location of the access feedback as bytes matching SparseFeedback in
+        hephaistos/sparse.glsl, e.g. to pass it as push constant
+        """
+        ...
+    def fetchAccessedTiles(self, reset: bool = True) -> list[tuple[int, int, int, int]]:
+        """
+        Returns the tiles accessed since the feedback was last reset and
+        optionally resets it. Work writing to the feedback must have finished.
+        """
+        ...
+    def getTileGrid(self, level: int = 0) -> tuple[int, int, int]:
+        """
+        Returns the number of tiles of the given mip level as (x, y, z)
+        """
+        ...
+    def isCommitted(self, tile: tuple[int, int, int, int]) -> bool:
+        """
+        Returns True, if the given tile is backed by memory
+        """
+        ...
+    @property
+    def size_committed(self) -> int:
+        """
+        Number of bytes currently committed excluding the mip tail
+        """
+        ...
+    @property
+    def tileCount(self) -> int:
+        """
+        Total number of tiles across all tiled mip levels
+        """
+        ...
+    @property
+    def tileDepth(self) -> int:
+        """
+        Depth of a tile in texels
+        """
+        ...
+    @property
+    def tileHeight(self) -> int:
+        """
+        Height of a tile in texels
+        """
+        ...
+    @property
+    def tileSize(self) -> int:
+        """
+        Size in bytes of the memory backing a single tile
+        """
+        ...
+    @property
+    def tileWidth(self) -> int:
+        """
+        Width of a tile in texels
+        """
+        ...
+    @property
+    def tiledLevels(self) -> int:
+        """
+        Number of mip levels committed in tiles
+        """
+        ...
+
+class StopWatch:
+    """
+    Allows the measuring of elapsed time between commands execution
+    
+    """
+
+    def __init__(self) -> None:
+        """
+        Creates a new stopwatch for measuring elapsed time between commands.
+        """
+        ...
+    def getElapsedTime(self, wait: bool = False) -> list[float]:
+        """
+        Retrieves the elapsed time between start() and stop() in nanoseconds.
+        If wait = True, blocks the caller until all timestamps are available,
+        otherwise returns NaN.
+        """
+        ...
+    def getStartTime(self, wait: bool = False) -> float:
+        """
+        Returns the host time at which the device executed start() on the steady
+        clock in nanoseconds, e.g. to measure how long work waited before
+        starting. If wait is true, blocks the call until the timestamp is
+        recorded, otherwise returns NaN if it is not yet available.
+        """
+        ...
+    def reset(self) -> None:
+        """
+        Resets the stop watch.
+        """
+        ...
+    def start(self) -> hephaistos.pyhephaistos.Command:
+        """
+        Returns the command to start the stop watch.
+        """
+        ...
+    def stop(self) -> hephaistos.pyhephaistos.Command:
+        """
+        Returns the command to stop the stop watch. Can be recorded multiple
+        times to record up to stopCount stop times.
+        """
+        ...
+
+class StreamExecutor:
+    """
+    Streams datasets larger than device memory through the device in chunks.
+    Each chunk is uploaded, processed by a per slot subroutine and its output
+    downloaded again. Chunks rotate through multiple slots, each with its own
+    device memory and timeline, so the upload of one chunk, the compute of the
+    previous and the download of the one before may run concurrently. Transfers
+    run on the dedicated transfer queue where available. Create the subroutines
+    after the executor using the tensors of each slot.
+
+    Parameters
+    ----------
+    inputItemSize: int
+        Size of a single input item in bytes
+    outputItemSize: int
+        Size of a single output item in bytes
+    chunkSize: int, default=0
+        Items per chunk. Zero derives it from the memory budget.
+    slots: int, default=3
+        Amount of chunks in flight
+    memoryFraction: float, default=0.5
+        Fraction of the remaining device memory budget the slots may occupy when
+        deriving the chunk size
+    useTransferQueue: bool, default=True
+        If True, runs transfers on the dedicated transfer queue if there is one
+    """
+
+    def __init__(
+        self,
+        inputItemSize: int,
+        outputItemSize: int,
+        *,
+        chunkSize: int = 0,
+        slots: int = 3,
+        memoryFraction: float = 0.5,
+        useTransferQueue: bool = True,
+    ) -> None: ...
+    @property
+    def chunkSize(self) -> int:
+        """
+        Maximum amount of items per chunk
+        """
+        ...
+    def getCount(self, slot: int) -> hephaistos.pyhephaistos.Tensor:
+        """
+        Returns the tensor holding the amount of items in the given slot's chunk
+        as a single uint32
+        """
+        ...
+    def getInput(self, slot: int) -> hephaistos.pyhephaistos.Tensor:
+        """
+        Returns the tensor holding the input items of the given slot
+        """
+        ...
+    def getOutput(self, slot: int) -> hephaistos.pyhephaistos.Tensor:
+        """
+        Returns the tensor receiving the output items of the given slot
+        """
+        ...
+    @property
+    def inputItemSize(self) -> int:
+        """
+        Size of a single input item in bytes
+        """
+        ...
+    @property
+    def outputItemSize(self) -> int:
+        """
+        Size of a single output item in bytes
+        """
+        ...
+    def run(
+        self,
+        compute: Iterable[hephaistos.pyhephaistos.Subroutine],
+        source: Callable[[memoryview, int], int],
+        sink: Callable[[memoryview, int], None],
+    ) -> int:
+        """
+        Streams chunks from source through the device into sink and returns the
+        amount of chunks processed. Blocks until the source ran dry and the sink
+        consumed all chunks. Exceptions raised by source or sink stop the stream.
+
+        Parameters
+        ----------
+        compute: list[Subroutine]
+            Subroutine processing the chunk in each slot
+        source: Callable[[memoryview, int], int]
+            Function called with the writable memory and index of the next chunk
+            returning the amount of items written. Returning zero ends the
+            stream.
+        sink: Callable[[memoryview, int], None]
+            Function called in order with the output items and index of a
+            finished chunk. The memory is only valid during the call.
+        """
+        ...
+    @property
+    def slotCount(self) -> int:
+        """
+        Amount of slots chunks rotate through
+        """
+        ...
+
+class StreamingDownloader:
+    """
+    Downloads data from tensors through a ring of staging buffers. download()
+    copies a tensor region into the next staging buffer without waiting, while
+    fetch() waits for the oldest pending download and returns its memory.
+    Multiple downloads can be in flight at once, up to the amount of staging
+    buffers.
+
+    Parameters
+    ----------
+    bufferSize: int
+        Size of each staging buffer in bytes
+    bufferCount: int, default=2
+        Amount of staging buffers
+    queue: QueueType, default=QueueType.TRANSFER
+        Queue to run downloads on. Falls back to the main queue if there is no
+        dedicated one.
+    """
+
+    def __init__(
+        self,
+        bufferSize: int,
+        bufferCount: int = 2,
+        *,
+        queue: hephaistos.pyhephaistos.QueueType = QueueType.TRANSFER,
+    ) -> None: ...
+    @property
+    def bufferCount(self) -> int:
+        """
+        Amount of staging buffers
+        """
+        ...
+    @property
+    def bufferSize(self) -> int:
+        """
+        Size of each staging buffer in bytes
+        """
+        ...
+    def download(
+        self,
+        src: hephaistos.pyhephaistos.Tensor,
+        srcOffset: int = 0,
+        size: Optional[int] = None,
+    ) -> hephaistos.pyhephaistos.Submission:
+        """
+        Downloads a region of the given tensor into the next staging buffer and
+        returns the submission. Raises if all staging buffers hold downloads not
+        yet fetched.
+
+        Parameters
+        ----------
+        src: Tensor
+            Tensor to copy from
+        srcOffset: int, default=0
+            Offset into src in bytes
+        size: int | None, default=None
+            Amount of bytes to copy. If None, copies the whole buffer clamped to
+            the remaining size of src.
+        """
+        ...
+    @overload
+    def download(
+        self,
+        src: hephaistos.pyhephaistos.Tensor,
+        data: numpy.typing.NDArray,
+        srcOffset: int = 0,
+    ) -> None:
+        """
+        Downloads a region of the given tensor into the given array, splitting it
+        across staging buffers if needed. Blocks until the data has been copied.
+        Requires no pending downloads.
+        """
+        ...
+    def fetch(self) -> memoryview:
+        """
+        Waits for the oldest pending download and returns its data as read only
+        memoryview. The memory stays valid until its staging buffer gets used by
+        another download.
+        """
+        ...
+    @property
+    def pendingCount(self) -> int:
+        """
+        Amount of downloads not yet fetched
+        """
+        ...
+    @property
+    def timeline(self) -> hephaistos.pyhephaistos.Timeline:
+        """
+        Timeline the downloads signal
+        """
+        ...
+
+class StreamingUploader:
+    """
+    Uploads data to tensors through a ring of staging buffers. Hands out the
+    memory of the next free staging buffer via next(), which gets copied into a
+    tensor by the following call to upload(). Each buffer is recycled once its
+    upload finished, so the host can fill the next buffers while previous
+    uploads are still in flight.
+
+    Parameters
+    ----------
+    bufferSize: int
+        Size of each staging buffer in bytes
+    bufferCount: int, default=2
+        Amount of staging buffers
+    queue: QueueType, default=QueueType.TRANSFER
+        Queue to run uploads on. Falls back to the main queue if there is no
+        dedicated one.
+    """
+
+    def __init__(
+        self,
+        bufferSize: int,
+        bufferCount: int = 2,
+        *,
+        queue: hephaistos.pyhephaistos.QueueType = QueueType.TRANSFER,
+    ) -> None: ...
+    @property
+    def bufferCount(self) -> int:
+        """
+        Amount of staging buffers
+        """
+        ...
+    @property
+    def bufferSize(self) -> int:
+        """
+        Size of each staging buffer in bytes
+        """
+        ...
+    def next(self) -> memoryview:
+        """
+        Returns the writable memory of the next free staging buffer. Blocks until
+        the upload previously using it finished.
+        """
+        ...
+    @property
+    def timeline(self) -> hephaistos.pyhephaistos.Timeline:
+        """
+        Timeline the uploads signal
+        """
+        ...
+    def upload(
+        self,
+        dst: hephaistos.pyhephaistos.Tensor,
+        dstOffset: int = 0,
+        size: Optional[int] = None,
+    ) -> hephaistos.pyhephaistos.Submission:
+        """
+        Uploads the memory returned by next() into the given tensor and returns
+        the submission.
+
+        Parameters
+        ----------
+        dst: Tensor
+            Tensor to copy to
+        dstOffset: int, default=0
+            Offset into dst in bytes
+        size: int | None, default=None
+            Amount of bytes to copy. If None, copies the whole buffer clamped to
+            the remaining size of dst.
+        """
+        ...
+    @overload
+    def upload(
+        self,
+        data: numpy.typing.NDArray,
+        dst: hephaistos.pyhephaistos.Tensor,
+        dstOffset: int = 0,
+    ) -> None:
+        """
+        Uploads the given data into the tensor, splitting it across staging
+        buffers if needed. Only blocks while waiting on free staging buffers.
+        """
+        ...
+    def wait(self) -> None:
+        """
+        Blocks until all uploads finished
+        """
+        ...
+
+class SubgroupProperties:
+    """
+    List of subgroup properties and supported operations
+    """
+
+    @property
+    def arithmeticSupport(self) -> bool:
+        """
+        Support for GL_KHR_shader_subgroup_arithmetic
+        """
+        ...
+    @property
+    def ballotSupport(self) -> bool:
+        """
+        Support for GL_KHR_shader_subgroup_ballot
+        """
+        ...
+    @property
+    def basicSupport(self) -> bool:
+        """
+        Support for GL_KHR_shader_subgroup_basic
+        """
+        ...
+    @property
+    def fullSubgroupsSupport(self) -> bool:
+        """
+        Support for requiring full subgroups in programs
+        """
+        ...
+    @property
+    def maxSubgroupSize(self) -> int:
+        """
+        Maximum threads per subgroup a program may run with
+        """
+        ...
+    @property
+    def minSubgroupSize(self) -> int:
+        """
+        Minimum threads per subgroup a program may run with
+        """
+        ...
+    @property
+    def quadSupport(self) -> bool:
+        """
+        Support for GL_KHR_shader_subgroup_quad
+        """
+        ...
+    @property
+    def requiredSubgroupSizeSupport(self) -> bool:
+        """
+        Support for requiring a subgroup size in programs
+        """
+        ...
+    @property
+    def shuffleClusteredSupport(self) -> bool:
+        """
+        Support for GL_KHR_shader_subgroup_clustered
+        """
+        ...
+    @property
+    def shuffleRelativeSupport(self) -> bool:
+        """
+        Support for GL_KHR_shader_subgroup_shuffle_relative
+        """
+        ...
+    @property
+    def shuffleSupport(self) -> bool:
+        """
+        Support for GL_KHR_shader_subgroup_shuffle
+        """
+        ...
+    @property
+    def subgroupSize(self) -> int:
+        """
+        Threads per subgroup
+        """
+        ...
+    @property
+    def voteSupport(self) -> bool:
+        """
+        Support for GL_KHR_shader_subgroup_vote
+        """
+        ...
+
+class Submission:
+    """
+    Submissions are issued after work has been submitted to the device and can
+    be used to wait for its completion.
+    """
+
+    @property
+    def finalStep(self) -> int:
+        """
+        The value the timeline will reach when the submission finishes.
+        """
+        ...
+    @property
+    def forgettable(self) -> bool:
+        """
+        True, if the Submission does not manage any internal resources. Either
+        way, it can be discarded without waiting, i.e. fire and forget.
+        """
+        ...
+    def onFinished(self, callback: Callable[[], None]) -> None:
+        """
+        Registers a callback to run once the submission finished. See
+        Timeline.onValue for details.
+        """
+        ...
+    @property
+    def timeline(self) -> hephaistos.pyhephaistos.Timeline:
+        """
+        The timeline this submission was issued with.
+        """
+        ...
+    def wait(self) -> None:
+        """
+        Blocks the caller until the submission finishes.
+        """
+        ...
+    def waitAsync(self) -> Awaitable[None]:
+        """
+        Returns an asyncio future resolving once the submission finished. Must
+        be called from within a running event loop. See Timeline.waitAsync for
+        details.
+        """
+        ...
+    def waitTimeout(self, ns: int) -> bool:
+        """
+        Blocks the caller until the submission finished or the specified time
+        elapsed. Returns True in the first, False in the second case.
+        """
+        ...
+
+class Subroutine:
+    """
+    Subroutines are reusable sequences of commands that can be submitted
+    multiple times to the device. Recording sequence of commands require non
+    negligible CPU time and may be amortized by reusing sequences via Subroutines.
+    """
+
+    @property
+    def nestable(self) -> bool:
+        """
+        True, if the subroutine only consists of parts and can thus be nested
+        inside other subroutines
+        """
+        ...
+    @property
+    def simultaneousUse(self) -> bool:
+        """
+        True, if the subroutine can be used simultaneous
+        """
+        ...
+
+class SubroutinePart:
+    """
+    Part of a subroutine recorded independently of others. Multiple parts can
+    be recorded in parallel on different threads and then assembled into
+    subroutines without re-recording them.
+    """
+
+    ...
+
+class TaskGraph:
+    """
+    Graph of tasks and their dependencies, which can be submitted multiple
+    times. Independent tasks on the same queue share a step, tasks on different
+    queues may run concurrently and only waits not implied by others are
+    issued. Each submission starts after the previous one finished.
+    """
+
+    def Submit(self) -> hephaistos.pyhephaistos.Submission:
+        """
+        Submits the graph. The first call finalizes it, after which no tasks
+        and dependencies can be added anymore.
+        """
+        ...
+    def __init__(self) -> None: ...
+    def __len__(self) -> int: ...
+    def addDependency(self, before: int, after: int) -> None:
+        """
+        Declares the task after to not start before the task before finished.
+        """
+        ...
+    def addTask(self, cmd: hephaistos.pyhephaistos.Command, queue: hephaistos.pyhephaistos.QueueType = hephaistos.pyhephaistos.QueueType.MAIN) -> int:
+        """
+        Adds a task running the given command on the given queue and returns
+        its index.
+        """
+        ...
+    @overload
+    def addTask(self, subroutine: hephaistos.pyhephaistos.Subroutine, queue: hephaistos.pyhephaistos.QueueType = hephaistos.pyhephaistos.QueueType.MAIN) -> int:
+        """
+        Adds a task running the given subroutine on the given queue and returns
+        its index. The subroutine must have been created for simultaneous use.
+        """
+        ...
+    def getWaitGraph(self) -> hephaistos.pyhephaistos.WaitGraph:
+        """
+        Returns the structured wait graph of the next submission. Finalizes the
+        graph.
+        """
+        ...
+
+class TaskScheduler:
+    """
+    Schedules tasks onto a set of buffered subroutines, each using its own
+    configuration. Tasks rotate through them. Before a task gets submitted, an
+    update function prepares its configuration on a background thread once the
+    previous task using it has finished. With more than two configurations the
+    host can run multiple tasks ahead of the device, smoothing out uneven update
+    times. An optional process function runs on a second background thread
+    after each task finished. Tasks using the same configuration wait on the
+    processing of the previous one. Both functions get called with the GIL
+    acquired, but the bookkeeping runs natively without it. Exceptions raised by
+    them are reported as unraisable.
+
+    Parameters
+    ----------
+    configs: list[Subroutine]
+        Subroutine running tasks per configuration. Requires at least two.
+    update: Callable[[int, int], None]
+        Function called with the config and task index updating the config
+        before its task runs
+    process: Callable[[int, int], None] | None, default=None
+        Function called with the config and task index after its task finished
+    queueSize: int, default=0
+        Maximum amount of tasks waiting on their update. Zero means infinite.
+    """
+
+    def __init__(
+        self,
+        configs: Iterable[hephaistos.pyhephaistos.Subroutine],
+        update: Callable[[int, int], None],
+        process: Optional[Callable[[int, int], None]] = None,
+        *,
+        queueSize: int = 0,
+    ) -> None: ...
+    @property
+    def configCount(self) -> int:
+        """
+        Amount of configurations tasks rotate through
+        """
+        ...
+    @property
+    def finishedTasks(self) -> int:
+        """
+        Amount of finished tasks including their processing
+        """
+        ...
+    @property
+    def pendingTasks(self) -> int:
+        """
+        Amount of scheduled tasks whose configuration has not yet been updated
+        """
+        ...
+    @property
+    def queueSize(self) -> int:
+        """
+        Maximum amount of tasks waiting on their update. Zero means infinite.
+        """
+        ...
+    def schedule(
+        self, count: int, *, timeout: Optional[int] = None
+    ) -> tuple[int, Optional[hephaistos.pyhephaistos.Submission]]:
+        """
+        Schedules the given amount of tasks after previous ones. Blocks while
+        the queue is full. Stops once waiting on the queue times out or the
+        tasks of this call alone would exceed the queue. Returns the amount of
+        tasks actually scheduled and their submission, or None if zero.
+
+        Parameters
+        ----------
+        count: int
+            Amount of tasks to schedule
+        timeout: int | None, default=None
+            Time in nanoseconds to wait for a free spot in the queue per task.
+            Waits indefinitely if None.
+        """
+        ...
+    @property
+    def totalTasks(self) -> int:
+        """
+        Total amount of tasks scheduled
+        """
+        ...
+    def wait(self, task: Optional[int] = None) -> None:
+        """
+        Waits until the given amount of tasks finished or all if None.
+        """
+        ...
+    def waitTimeout(self, task: Optional[int] = None, *, timeout: int) -> bool:
+        """
+        Waits until the given amount of tasks finished, or all if None, for at
+        most timeout nanoseconds. Returns True if they finished, False
+        otherwise.
+        """
+        ...
+
+class Tensor:
+    """
+    Base class for all tensors managing memory allocations on the device
+    """
+
+    @property
+    def address(self) -> int:
+        """
+        The device address of this tensor.
+        """
+        ...
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
+    ) -> None:
+        """
+        Binds the tensor to the program or parameter set at the given binding
+        """
+        ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
+    ) -> None:
+        """
+        Binds the tensor to the program or parameter set at the given binding
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the tensor in bytes.
+        """
+        ...
+
+class TensorMesh:
+    """
+    Mesh whose vertices and indices are read directly from tensors without
+    copying them. Work writing the tensors must have finished before building.
+    """
+
+    def __init__(self) -> None: ...
+    @property
+    def indexCount(self) -> int:
+        """
+        Number of indices
+        """
+        ...
+    @indexCount.setter
+    def indexCount(self, arg: int, /) -> None:
+        """
+        Number of indices
+        """
+        ...
+    @property
+    def indices(self) -> object:
+        """
+        Optional tensor containing the index data
+        """
+        ...
+    @indices.setter
+    def indices(self, arg: object, /) -> None:
+        """
+        Optional tensor containing the index data
+        """
+        ...
+    @property
+    def indicesOffset(self) -> int:
+        """
+        Offset in bytes into the index tensor where the indices start
+        """
+        ...
+    @indicesOffset.setter
+    def indicesOffset(self, arg: int, /) -> None:
+        """
+        Offset in bytes into the index tensor where the indices start
+        """
+        ...
+    @property
+    def shortIndices(self) -> bool:
+        """
+        Whether the indices are 16 bit instead of 32 bit
+        """
+        ...
+    @shortIndices.setter
+    def shortIndices(self, arg: bool, /) -> None:
+        """
+        Whether the indices are 16 bit instead of 32 bit
+        """
+        ...
+    @property
+    def vertexCount(self) -> int:
+        """
+        Number of vertices
+        """
+        ...
+    @vertexCount.setter
+    def vertexCount(self, arg: int, /) -> None:
+        """
+        Number of vertices
+        """
+        ...
+    @property
+    def vertexFormat(self) -> hephaistos.pyhephaistos.VertexFormat:
+        """
+        Format of the position at the start of each vertex
+        """
+        ...
+    @vertexFormat.setter
+    def vertexFormat(self, arg: hephaistos.pyhephaistos.VertexFormat, /) -> None:
+        """
+        Format of the position at the start of each vertex
+        """
+        ...
+    @property
+    def vertexStride(self) -> int:
+        """
+        Stride in bytes between vertices
+        """
+        ...
+    @vertexStride.setter
+    def vertexStride(self, arg: int, /) -> None:
+        """
+        Stride in bytes between vertices
+        """
+        ...
+    @property
+    def vertices(self) -> object:
+        """
+        Tensor containing the vertex data
+        """
+        ...
+    @vertices.setter
+    def vertices(self, arg: hephaistos.pyhephaistos.Tensor, /) -> None:
+        """
+        Tensor containing the vertex data
+        """
+        ...
+    @property
+    def verticesOffset(self) -> int:
+        """
+        Offset in bytes into the vertex tensor where the vertices start
+        """
+        ...
+    @verticesOffset.setter
+    def verticesOffset(self, arg: int, /) -> None:
+        """
+        Offset in bytes into the vertex tensor where the vertices start
+        """
+        ...
+
+class TensorMeshVector:
+    """
+    List of TensorMesh
+    """
+
+    def __init__(self, arg: Iterable[hephaistos.pyhephaistos.TensorMesh], /) -> None:
+        """
+        Construct from an iterable object
+        """
+        ...
+    @overload
+    def __init__(self) -> None:
+        """
+        Default constructor
+        """
+        ...
+    @overload
+    def __init__(self, arg: hephaistos.pyhephaistos.TensorMeshVector) -> None:
+        """
+        Copy constructor
+        """
+        ...
+    def append(self, arg: hephaistos.pyhephaistos.TensorMesh, /) -> None:
+        """
+        Append `arg` to the end of the list.
+        """
+        ...
+    def clear(self) -> None:
+        """
+        Remove all items from list.
+        """
+        ...
+    def extend(self, arg: hephaistos.pyhephaistos.TensorMeshVector, /) -> None:
+        """
+        Extend `self` by appending elements from `arg`.
+        """
+        ...
+    def insert(self, arg0: int, arg1: hephaistos.pyhephaistos.TensorMesh, /) -> None:
+        """
+        Insert object `arg1` before index `arg0`.
+        """
+        ...
+    def pop(self, index: int = -1) -> hephaistos.pyhephaistos.TensorMesh:
+        """
+        Remove and return item at `index` (default last).
+        """
+        ...
+
+class TensorView:
+    """
+    Sub-range of a tensor that can be bound to programs without copying it.
+    Dispatches using disjoint views of the same tensor do not wait on each other.
+    Views must be recreated if the tensor's memory changes, e.g. by growing.
+    """
+    def __init__(
+        self, tensor: hephaistos.pyhephaistos.Tensor, offset: int = 0, size: int = ...
+    ) -> None:
+        """
+        Creates a view of the given tensor starting at offset with the given size in
+        bytes. The offset must be a multiple of minStorageBufferOffsetAlignment.
+        """
+        ...
+    @property
+    def address(self) -> int:
+        """
+        The device address of the start of the view
+        """
+        ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
+    ) -> None:
+        """
+        Binds the view to the program or parameter set at the given binding
+        """
+        ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
+    ) -> None:
+        """
+        Binds the view to the program or parameter set at the given binding
+        """
+        ...
+    @property
+    def offset(self) -> int:
+        """
+        Offset of the view into the tensor in bytes
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        Size of the view in bytes
+        """
+        ...
+
+class TexelBuffer:
+    """
+    Formatted view of a tensor's memory presented inside programs as uniform or
+    storage texel buffer. Reads and writes convert between the format and the
+    shader's type in hardware.
+
+    Parameters
+    ----------
+    tensor: Tensor
+        Tensor to create a view of
+    format: ImageFormat
+        Format of the texels. Must not be block compressed.
+    offset: int, default=0
+        Offset into the tensor in bytes. Must be a multiple of
+        minTexelBufferOffsetAlignment.
+    size: int, default=whole_size
+        Size of the range in bytes. Defaults to the rest of the tensor.
+    """
+
+    def __init__(
+        self,
+        tensor: hephaistos.pyhephaistos.Tensor,
+        format: hephaistos.pyhephaistos.ImageFormat,
+        offset: int = 0,
+        size: int = ...,
+    ) -> None: ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
+    ) -> None:
+        """
+        Binds the texel buffer to the program or parameter set at the given binding
+        """
+        ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
+    ) -> None:
+        """
+        Binds the texel buffer to the program or parameter set at the given binding
+        """
+        ...
+    @property
+    def format(self) -> hephaistos.pyhephaistos.ImageFormat:
+        """
+        Format of the texels
+        """
+        ...
+    @property
+    def offset(self) -> int:
+        """
+        Offset of the range into the tensor in bytes
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        Number of texels in the range
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        Size of the range in bytes
+        """
+        ...
+
+class Texture:
+    """
+    Allocates memory on the device using a memory layout it deems optimal for
+    images and presents it inside programs as texture allowing filtered lookups.
+    The filter methods can specified. Lookup tables, i.e. nearest filtering with
+    unnormalized coordinates, can be bound as sampled image, e.g. texture2D, and
+    read via texelFetch using GL_EXT_samplerless_texture_functions, skipping the
+    sampler.
+
+    Parameters
+    ----------
+    format: ImageFormat
+        Format of the image
+    width: int
+        Width of the image in pixels
+    height: int, default=1
+        Height of the image in pixels
+    depth: int, default=1
+        Depth of the image in pixels
+    mipLevels: int, default=1
+        Number of mip levels. Zero creates the full mip chain
+    layers: int, default=0
+        Number of array layers. Zero creates a plain texture. Arrays require a
+        depth of one.
+    filter: 'nearest'|'n'|'linear'|'l', default='linear'
+        Method used to interpolate between pixels
+    mipmap: 'nearest'|'n'|'linear'|'l', default='linear'
+        Method used to interpolate between mip levels
+    lodBias: float, default=0.0
+        Bias added to the computed level of detail
+    minLod: float, default=0.0
+        Minimum level of detail
+    maxLod: float, default=1000.0
+        Maximum level of detail
+    unnormalized: bool, default=False
+        If True, use coordinates in pixel space rather than normalized ones
+        inside programs
+    modeU: 'repeat'|'r'|'mirrored repeat'|'mr'|'clamp edge'|'ce'|'mirrored clamp edge'|'mce', default='repeat'
+        Method used to handle out of range coordinates in U dimension
+    modeV: 'repeat'|'r'|'mirrored repeat'|'mr'|'clamp edge'|'ce'|'mirrored clamp edge'|'mce', default='repeat'
+        Method used to handle out of range coordinates in V dimension
+    modeW: 'repeat'|'r'|'mirrored repeat'|'mr'|'clamp edge'|'ce'|'mirrored clamp edge'|'mce', default='repeat'
+        Method used to handle out of range coordinates in W dimension
+    """
+
+    def __init__(
+        format: hephaistos.pyhephaistos.ImageFormat,
+        width: int,
+        height: int = 1,
+        depth: int = 1,
+        mipLevels: int = 1,
+        layers: int = 0,
+        *,
+        filter: Literal["nearest", "n", "linear", "l"] = "linear",
+        mipmap: Literal["nearest", "n", "linear", "l"] = "linear",
+        lodBias: float = 0.0,
+        minLod: float = 0.0,
+        maxLod: float = 1000.0,
+        unnormalized: bool = False,
+        modeU: Literal[
+            "repeat",
+            "r",
+            "mirrored repeat",
+            "mr",
+            "clamp edge",
+            "ce",
+            "mirrored clamp edge",
+            "mce",
+        ] = "repeat",
+        modeV: Literal[
+            "repeat",
+            "r",
+            "mirrored repeat",
+            "mr",
+            "clamp edge",
+            "ce",
+            "mirrored clamp edge",
+            "mce",
+        ] = "repeat",
+        modeW: Literal[
+            "repeat",
+            "r",
+            "mirrored repeat",
+            "mr",
+            "clamp edge",
+            "ce",
+            "mirrored clamp edge",
+            "mce",
+        ] = "repeat",
+    ) -> None: ...
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
+        /,
+    ) -> None:
+        """
+        Binds the texture to the program or parameter set at the given binding
+        """
+        ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
+        /,
+    ) -> None:
+        """
+        Binds the texture to the program or parameter set at the given binding
+        """
+        ...
+    @property
+    def depth(self) -> int:
+        """
+        Depth of the texture in pixels
+        """
+        ...
+    @property
+    def format(self) -> hephaistos.pyhephaistos.ImageFormat:
+        """
+        Format of the texture
+        """
+        ...
+    @property
+    def height(self) -> int:
+        """
+        Height of the texture in pixels
+        """
+        ...
+    @property
+    def layers(self) -> int:
+        """
+        Number of array layers. Zero if the texture is not an array.
+        """
+        ...
+    def loadFile(
+        filename: str, **kwargs
+    ) -> hephaistos.pyhephaistos.Texture:
+        """
+        Loads a texture including all of its mip levels from a KTX2 or DDS
+        file without decompressing it. Keyword arguments configure the sampler
+        as in the constructor.
+        """
+        ...
+    def loadMemory(
+        data: bytes, **kwargs
+    ) -> hephaistos.pyhephaistos.Texture:
+        """
+        Loads a texture including all of its mip levels from a KTX2 or DDS
+        file stored in memory without decompressing it. Keyword arguments
+        configure the sampler as in the constructor.
+        """
+        ...
+    @property
+    def mipLevels(self) -> int:
+        """
+        Number of mip levels of the texture
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        Size the texture takes in a linear/compact memory layout in bytes. This
+        can differ from the actual size the texture takes on the device but can
+        be useful to allocate buffers for transferring the texture.
+        """
+        ...
+    @property
+    def width(self) -> int:
+        """
+        Width of the texture in pixels
+        """
+        ...
+
+class Timeline:
+    """
+    Timeline managing the execution of code and commands using an increasing
+    internal counter. Both GPU and CPU can wait and/or increase this counter
+    thus creating a synchronization between them or among themselves. The
+    current value of the counter can be queried allowing an asynchronous method
+    of reporting the progress.
+
+    Parameters
+    ----------
+    value: int, default=0
+        Initial value of the internal counter
+    """
+
+    def __init__(self, initialValue: int) -> None: ...
+    @overload
+    def __init__(self) -> None: ...
+    @property
+    def id(self) -> int:
+        """
+        Id of this timeline
+        """
+        ...
+    def onValue(self, value: int, callback: Callable[[], None]) -> None:
+        """
+        Registers a callback to run once the timeline reaches the given value.
+        Callbacks run on a background thread and should return quickly. Raised
+        exceptions are reported as unraisable. Callbacks still pending when the
+        timeline gets destroyed are dropped.
+
+        Parameters
+        ----------
+        value: int
+            Value the timeline has to reach
+        callback: Callable[[], None]
+            Function to call once the value is reached
+        """
+        ...
+    @property
+    def value(self) -> int:
+        """
+        Returns or sets the current value of the timeline. Note that the value
+        can only increase. Disobeying this requirement results in undefined
+        behavior.
+        """
+        ...
+    @value.setter
+    def value(self, arg: int, /) -> None:
+        """
+        Returns or sets the current value of the timeline. Note that the value
+        can only increase. Disobeying this requirement results in undefined
+        behavior.
+        """
+        ...
+    def wait(self, value: int) -> None:
+        """
+        Waits for the timeline to reach the given value.
+        """
+        ...
+    def waitAsync(self, value: int) -> Awaitable[None]:
+        """
+        Returns an asyncio future resolving once the timeline reaches the given
+        value. Must be called from within a running event loop. Does not block
+        the loop or need an extra thread.
+
+        Parameters
+        ----------
+        value: int
+            Value the timeline has to reach
+        """
+        ...
+    def waitTimeout(self, value: int, timeout: int) -> bool:
+        """
+        Waits for the timeline to reach the given value for a certain amount.
+        Returns True if the value was reached and False if it timed out.
+
+        Parameters
+        ----------
+        value: int
+            Value to wait for
+        timeout: int
+            Time in nanoseconds to wait. May be rounded to the closest internal
+            precision of the device clock.
+        """
+        ...
+
+class Trace:
+    """
+    Host and device events recorded between beginTrace() and endTrace()
+    """
+
+    def addProfilerSamples(
+        self, samples: list[hephaistos.pyhephaistos.ProfilerSample]
+    ) -> None:
+        """
+        Adds samples as returned by Profiler.getSamples() as device events.
+        """
+        ...
+    @property
+    def deviceOffset(self) -> float:
+        """
+        Offset converting device timestamps into the host's steady clock in
+        nanoseconds
+        """
+        ...
+    @property
+    def events(self) -> list[hephaistos.pyhephaistos.TraceEvent]:
+        """
+        Recorded events
+        """
+        ...
+    @property
+    def startTime(self) -> float:
+        """
+        Time at which tracing started on the host's steady clock in nanoseconds
+        """
+        ...
+    def toChromeTrace(self) -> str:
+        """
+        Writes the trace in the Chrome trace event JSON format, which can be
+        opened by chrome://tracing or the Perfetto UI.
+        """
+        ...
+    def toPerfetto(self) -> bytes:
+        """
+        Writes the trace in the Perfetto protobuf format.
+        """
+        ...
+
+class TraceEvent:
+    """
+    Single event of a Trace
+    """
+
+    @property
+    def category(self) -> str:
+        """
+        Category of the event, e.g. 'submit', 'wait', 'update' or 'device'
+        """
+        ...
+    @property
+    def duration(self) -> float:
+        """
+        Duration of the event in nanoseconds. Zero for instant events.
+        """
+        ...
+    @property
+    def name(self) -> str:
+        """
+        Name of the event, e.g. the scope name for device events
+        """
+        ...
+    @property
+    def start(self) -> float:
+        """
+        Start of the event on the host's steady clock in nanoseconds
+        """
+        ...
+    @property
+    def thread(self) -> int:
+        """
+        Track the event belongs to. Zero for events on the device, otherwise
+        the index of the host thread starting at one.
+        """
+        ...
+
+class TraceRaysCommand:
+    """
+    Command for tracing rays using a RayTracingProgram
+    """
+
+    @property
+    def depth(self) -> int:
+        """
+        Amount of rays in Z dimension
+        """
+        ...
+    @depth.setter
+    def depth(self, arg: int, /) -> None: ...
+    @property
+    def height(self) -> int:
+        """
+        Amount of rays in Y dimension
+        """
+        ...
+    @height.setter
+    def height(self, arg: int, /) -> None: ...
+    @property
+    def width(self) -> int:
+        """
+        Amount of rays in X dimension
+        """
+        ...
+    @width.setter
+    def width(self, arg: int, /) -> None: ...
+
+class TuningResult:
+    """
+    Result of tuning a program
+    """
+
+    @property
+    def index(self) -> int:
+        """
+        Index of the fastest candidate
+        """
+        ...
+    @property
+    def specialization(self) -> bytes:
+        """
+        Specialization of the fastest candidate
+        """
+        ...
+    @property
+    def times(self) -> list[float]:
+        """
+        Median time in nanoseconds of each candidate. Infinite for candidates
+        which failed. Empty if the result was read from the cache.
+        """
+        ...
+
+class TypeSupport:
+    """List of supported extended types, e.g. float64"""
+
+    @property
+    def float64(self) -> bool: ...
+    @property
+    def float16(self) -> bool: ...
+    @property
+    def int64(self) -> bool: ...
+    @property
+    def int16(self) -> bool: ...
+    @property
+    def int8(self) -> bool: ...
+
+
+class UniformRing:
+    """
+    Ring of small uniform blocks in persistently mapped memory for per dispatch
+    parameters. Each push writes the next block, which gets bound by subsequent
+    calls to bindParameter. Dispatches keep the block current at binding. Blocks
+    are reused after capacity pushes, thus the capacity must exceed the amount of
+    blocks used by pending work.
+    """
+
+    def __init__(self, blockSize: int, capacity: int = 64) -> None:
+        """
+        Creates a new ring of capacity blocks each blockSize bytes large.
+        """
+        ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
+    ) -> None:
+        """
+        Binds the current block to the program or parameter set at the given binding
+        """
+        ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
+    ) -> None:
+        """
+        Binds the current block to the program or parameter set at the given binding
+        """
+        ...
+    @property
+    def blockSize(self) -> int:
+        """
+        Size of a single block in bytes
+        """
+        ...
+    @property
+    def capacity(self) -> int:
+        """
+        Amount of blocks in the ring
+        """
+        ...
+    @property
+    def current(self) -> int:
+        """
+        Index of the current block
+        """
+        ...
+    def push(self, data: bytes) -> int:
+        """
+        Writes data into the next block, makes it the current one and returns its
+        index.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        Size of the whole ring in bytes including padding between blocks
+        """
+        ...
+
+class UnsignedIntBuffer:
+    """
+    Buffer representing memory allocated on the host holding an array of type
+    uint32 and given size which can be accessed as numpy array or via the buffer
+    protocol, e.g. memoryview(buffer), without copies.
+
+    Parameters
+    ----------
+    size: int
+        Number of elements
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(self, size: int) -> None: ...
+    def numpy(self) -> numpy.typing.NDArray:
+        """
+        Returns a numpy array using this buffer's memory.
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        The number of elements in this buffer.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the buffer in bytes.
+        """
+        ...
+
+class UnsignedIntTensor:
+    """
+    Tensor representing memory allocated on the device holding an array of type
+    uint32 and given size. If mapped can be accessed from the host using its
+    memory address. Mapping can optionally be requested but will be ignored if
+    the device does not support it. Query its support after creation via
+    isMapped. Mapped tensors support the buffer protocol, e.g.
+    memoryview(tensor).
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
+        """
+        Creates a new tensor and fills it with the provided data
+
+        Parameters
+        ----------
+        array: NDArray
+            Numpy array containing the data used to fill the tensor.
+            Its type must match the tensor's.
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(self, size: int, mapped: bool = False) -> None:
+        """
+        Creates a new tensor of given size.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(
+        self,
+        size: int,
+        hints: hephaistos.pyhephaistos.AllocationHints,
+        mapped: bool = False,
+    ) -> None:
+        """
+        Creates a new tensor of given size using the given allocation hints.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        hints: AllocationHints
+            Hints for allocating the memory
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
+        """
+        Creates a new tensor and fills it with the provided data
+
+        Parameters
+        ----------
+        addr: int
+            Address of the data used to fill the tensor
+        n: int
+            Number of bytes to copy from addr
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @property
+    def address(self) -> int:
+        """
+        The device address of this tensor.
+        """
+        ...
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
+    ) -> None:
+        """
+        Binds the tensor to the program or parameter set at the given binding
+        """
+        ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
+    ) -> None:
+        """
+        Binds the tensor to the program or parameter set at the given binding
+        """
+        ...
+    def flush(self, offset: int = 0, size: int | None = None, /) -> None:
+        """
+        Makes writes in mapped memory from the host available to the device.
+        Only needed if isNonCoherent is True.
+
+        Parameters
+        ----------
+        offset: int, default=0
+            Offset in amount of elements into mapped memory to flush
+        size: int|None, default=None
+            Number of elements to flush starting at offset.
+            If None, flushes all remaining elements.
+        """
+        ...
+    def invalidate(self, offset: int = 0, size: int | None = None, /) -> None:
+        """
+        Makes writes in mapped memory from the device available to the host.
+        Only needed if isNonCoherent is True.
+
+        Parameters
+        ----------
+        offset: int, default=0
+            Offset in amount of elements into mapped memory to invalidate
+        size: int | None, default=None
+            Number of elements to invalidate starting at offset.
+            If None, invalidates all remaining elements.
+        """
+        ...
+    @property
+    def isAllocated(self) -> bool:
+        """
+        True, if the tensor's memory was allocated. Only False for lazily
+        allocated tensors not used yet.
+        """
+        ...
+    @property
+    def isMapped(self) -> bool:
+        """
+        True, if the underlying memory is writable by the CPU.
+        """
+        ...
+    @property
+    def isNonCoherent(self) -> bool:
+        """
+        Wether calls to flush() and invalidate() are necessary to make changes
+        in mapped memory between devices and host available
+        """
+        ...
+    @property
+    def isPooled(self) -> bool:
+        """
+        True, if the tensor is sub-allocated from a shared buffer.
+        """
+        ...
+    @property
+    def memory(self) -> int:
+        """
+        Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
+        """
+        ...
+    def retrieve(self, addr: int, n: int, offset: int = 0, /) -> None:
+        """
+        Retrieves n elements from the tensor at the given offset and stores it
+        in dst.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy to
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        
+        Note
+        ----
+        This operation is only guaranteed to succeed on mapped tensors.
+        """
+        ...
+    def retrieveAsync(self, buffer: hephaistos.pyhephaistos.Buffer, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Copies data from the tensor at the given offset into the buffer without
+        waiting for the transfer to finish. The copy is ordered after previously
+        submitted work.
+
+        Parameters
+        ----------
+        buffer: Buffer
+            Buffer to copy to. Its size determines the amount of data copied
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        The number of elements in this tensor.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the tensor in bytes.
+        """
+        ...
+    def update(self, addr: int, n: int, offset: int = 0, /) -> None:
+        """
+        Updates the tensor at the given offset with n elements stored at addr.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        
+        Note
+        ----
+        This operation is only guaranteed to succeed on mapped tensors.
+        """
+        ...
+    def updateAsync(self, addr: int, n: int, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Updates the tensor at the given offset with n elements from addr without
+        waiting for the transfer to finish. The data is staged before returning,
+        thus the memory at addr can be reused directly. The copy is ordered after
+        previously submitted work.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in number of elements where the copy starts
+        """
+        ...
+
+class UnsignedLongBuffer:
+    """
+    Buffer representing memory allocated on the host holding an array of type
+    uint64 and given size which can be accessed as numpy array or via the buffer
+    protocol, e.g. memoryview(buffer), without copies.
+
+    Parameters
+    ----------
+    size: int
+        Number of elements
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(self, size: int) -> None: ...
+    def numpy(self) -> numpy.typing.NDArray:
+        """
+        Returns a numpy array using this buffer's memory.
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        The number of elements in this buffer.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the buffer in bytes.
+        """
+        ...
+
+class UnsignedLongTensor:
+    """
+    Tensor representing memory allocated on the device holding an array of type
+    uint64 and given size. If mapped can be accessed from the host using its
+    memory address. Mapping can optionally be requested but will be ignored if
+    the device does not support it. Query its support after creation via
+    isMapped. Mapped tensors support the buffer protocol, e.g.
+    memoryview(tensor).
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
+        """
+        Creates a new tensor and fills it with the provided data
+
+        Parameters
+        ----------
+        array: NDArray
+            Numpy array containing the data used to fill the tensor.
+            Its type must match the tensor's.
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(self, size: int, mapped: bool = False) -> None:
+        """
+        Creates a new tensor of given size.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(
+        self,
+        size: int,
+        hints: hephaistos.pyhephaistos.AllocationHints,
+        mapped: bool = False,
+    ) -> None:
+        """
+        Creates a new tensor of given size using the given allocation hints.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        hints: AllocationHints
+            Hints for allocating the memory
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
+        """
+        Creates a new tensor and fills it with the provided data
+
+        Parameters
+        ----------
+        addr: int
+            Address of the data used to fill the tensor
+        n: int
+            Number of bytes to copy from addr
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @property
+    def address(self) -> int:
+        """
+        The device address of this tensor.
+        """
+        ...
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
+    ) -> None:
+        """
+        Binds the tensor to the program or parameter set at the given binding
+        """
+        ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
+    ) -> None:
+        """
+        Binds the tensor to the program or parameter set at the given binding
+        """
+        ...
+    def flush(self, offset: int = 0, size: int | None = None, /) -> None:
+        """
+        Makes writes in mapped memory from the host available to the device.
+        Only needed if isNonCoherent is True.
+
+        Parameters
+        ----------
+        offset: int, default=0
+            Offset in amount of elements into mapped memory to flush
+        size: int|None, default=None
+            Number of elements to flush starting at offset.
+            If None, flushes all remaining elements.
+        """
+        ...
+    def invalidate(self, offset: int = 0, size: int | None = None, /) -> None:
+        """
+        Makes writes in mapped memory from the device available to the host.
+        Only needed if isNonCoherent is True.
+
+        Parameters
+        ----------
+        offset: int, default=0
+            Offset in amount of elements into mapped memory to invalidate
+        size: int | None, default=None
+            Number of elements to invalidate starting at offset.
+            If None, invalidates all remaining elements.
+        """
+        ...
+    @property
+    def isAllocated(self) -> bool:
+        """
+        True, if the tensor's memory was allocated. Only False for lazily
+        allocated tensors not used yet.
+        """
+        ...
+    @property
+    def isMapped(self) -> bool:
+        """
+        True, if the underlying memory is writable by the CPU.
+        """
+        ...
+    @property
+    def isNonCoherent(self) -> bool:
+        """
+        Wether calls to flush() and invalidate() are necessary to make changes
+        in mapped memory between devices and host available
+        """
+        ...
+    @property
+    def isPooled(self) -> bool:
+        """
+        True, if the tensor is sub-allocated from a shared buffer.
+        """
+        ...
+    @property
+    def memory(self) -> int:
+        """
+        Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
+        """
+        ...
+    def retrieve(self, addr: int, n: int, offset: int = 0, /) -> None:
+        """
+        Retrieves n elements from the tensor at the given offset and stores it
+        in dst.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy to
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        
+        Note
+        ----
+        This operation is only guaranteed to succeed on mapped tensors.
+        """
+        ...
+    def retrieveAsync(self, buffer: hephaistos.pyhephaistos.Buffer, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Copies data from the tensor at the given offset into the buffer without
+        waiting for the transfer to finish. The copy is ordered after previously
+        submitted work.
+
+        Parameters
+        ----------
+        buffer: Buffer
+            Buffer to copy to. Its size determines the amount of data copied
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        The number of elements in this tensor.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the tensor in bytes.
+        """
+        ...
+    def update(self, addr: int, n: int, offset: int = 0, /) -> None:
+        """
+        Updates the tensor at the given offset with n elements stored at addr.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        
+        Note
+        ----
+        This operation is only guaranteed to succeed on mapped tensors.
+        """
+        ...
+    def updateAsync(self, addr: int, n: int, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Updates the tensor at the given offset with n elements from addr without
+        waiting for the transfer to finish. The data is staged before returning,
+        thus the memory at addr can be reused directly. The copy is ordered after
+        previously submitted work.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in number of elements where the copy starts
+        """
+        ...
+
+class UnsignedShortBuffer:
+    """
+    Buffer representing memory allocated on the host holding an array of type
+    uint16 and given size which can be accessed as numpy array or via the buffer
+    protocol, e.g. memoryview(buffer), without copies.
+
+    Parameters
+    ----------
+    size: int
+        Number of elements
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(self, size: int) -> None: ...
+    def numpy(self) -> numpy.typing.NDArray:
+        """
+        Returns a numpy array using this buffer's memory.
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        The number of elements in this buffer.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the buffer in bytes.
+        """
+        ...
+
+class UnsignedShortTensor:
+    """
+    Tensor representing memory allocated on the device holding an array of type
+    uint16 and given size. If mapped can be accessed from the host using its
+    memory address. Mapping can optionally be requested but will be ignored if
+    the device does not support it. Query its support after creation via
+    isMapped. Mapped tensors support the buffer protocol, e.g.
+    memoryview(tensor).
+    """
+
+    def __buffer__(self, flags: int, /) -> memoryview: ...
+    def __init__(self, array: numpy.typing.NDArray, mapped: bool = False) -> None:
+        """
+        Creates a new tensor and fills it with the provided data
+
+        Parameters
+        ----------
+        array: NDArray
+            Numpy array containing the data used to fill the tensor.
+            Its type must match the tensor's.
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(self, size: int, mapped: bool = False) -> None:
+        """
+        Creates a new tensor of given size.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(
+        self,
+        size: int,
+        hints: hephaistos.pyhephaistos.AllocationHints,
+        mapped: bool = False,
+    ) -> None:
+        """
+        Creates a new tensor of given size using the given allocation hints.
+
+        Parameters
+        ----------
+        size: int
+            Number of elements
+        hints: AllocationHints
+            Hints for allocating the memory
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @overload
+    def __init__(self, addr: int, n: int, mapped: bool = False) -> None:
+        """
+        Creates a new tensor and fills it with the provided data
+
+        Parameters
+        ----------
+        addr: int
+            Address of the data used to fill the tensor
+        n: int
+            Number of bytes to copy from addr
+        mapped: bool, default=False
+            If True, tries to map memory to host address space
+        """
+        ...
+    @property
+    def address(self) -> int:
+        """
+        The device address of this tensor.
+        """
+        ...
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: str,
+    ) -> None:
+        """
+        Binds the tensor to the program or parameter set at the given binding
+        """
+        ...
+    @overload
+    def bindParameter(
+        self,
+        program: hephaistos.pyhephaistos.Program | hephaistos.pyhephaistos.ParameterSet,
+        binding: int,
+    ) -> None:
+        """
+        Binds the tensor to the program or parameter set at the given binding
+        """
+        ...
+    def flush(self, offset: int = 0, size: int | None = None, /) -> None:
+        """
+        Makes writes in mapped memory from the host available to the device.
+        Only needed if isNonCoherent is True.
+
+        Parameters
+        ----------
+        offset: int, default=0
+            Offset in amount of elements into mapped memory to flush
+        size: int|None, default=None
+            Number of elements to flush starting at offset.
+            If None, flushes all remaining elements.
+        """
+        ...
+    def invalidate(self, offset: int = 0, size: int | None = None, /) -> None:
+        """
+        Makes writes in mapped memory from the device available to the host.
+        Only needed if isNonCoherent is True.
+
+        Parameters
+        ----------
+        offset: int, default=0
+            Offset in amount of elements into mapped memory to invalidate
+        size: int | None, default=None
+            Number of elements to invalidate starting at offset.
+            If None, invalidates all remaining elements.
+        """
+        ...
+    @property
+    def isAllocated(self) -> bool:
+        """
+        True, if the tensor's memory was allocated. Only False for lazily
+        allocated tensors not used yet.
+        """
+        ...
+    @property
+    def isMapped(self) -> bool:
+        """
+        True, if the underlying memory is writable by the CPU.
+        """
+        ...
+    @property
+    def isNonCoherent(self) -> bool:
+        """
+        Wether calls to flush() and invalidate() are necessary to make changes
+        in mapped memory between devices and host available
+        """
+        ...
+    @property
+    def isPooled(self) -> bool:
+        """
+        True, if the tensor is sub-allocated from a shared buffer.
+        """
+        ...
+    @property
+    def memory(self) -> int:
+        """
+        Mapped memory address of the tensor as seen from the CPU. Zero if not mapped.
+        """
+        ...
+    def retrieve(self, addr: int, n: int, offset: int = 0, /) -> None:
+        """
+        Retrieves n elements from the tensor at the given offset and stores it
+        in dst.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy to
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        
+        Note
+        ----
+        This operation is only guaranteed to succeed on mapped tensors.
+        """
+        ...
+    def retrieveAsync(self, buffer: hephaistos.pyhephaistos.Buffer, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Copies data from the tensor at the given offset into the buffer without
+        waiting for the transfer to finish. The copy is ordered after previously
+        submitted work.
+
+        Parameters
+        ----------
+        buffer: Buffer
+            Buffer to copy to. Its size determines the amount of data copied
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        """
+        ...
+    @property
+    def size(self) -> int:
+        """
+        The number of elements in this tensor.
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the tensor in bytes.
+        """
+        ...
+    def update(self, addr: int, n: int, offset: int = 0, /) -> None:
+        """
+        Updates the tensor at the given offset with n elements stored at addr.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in amount of elements where the copy starts
+        
+        Note
+        ----
+        This operation is only guaranteed to succeed on mapped tensors.
+        """
+        ...
+    def updateAsync(self, addr: int, n: int, offset: int = 0) -> hephaistos.pyhephaistos.Submission:
+        """
+        Updates the tensor at the given offset with n elements from addr without
+        waiting for the transfer to finish. The data is staged before returning,
+        thus the memory at addr can be reused directly. The copy is ordered after
+        previously submitted work.
+
+        Parameters
+        ----------
+        addr: int
+            Address of memory to copy from
+        n: int
+            Amount of elements to copy
+        offset: int, default=0
+            Offset into the tensor in number of elements where the copy starts
+        """
+        ...
+
+class UpdateGeometryCommand:
+    """
+    Command for refitting a geometry to new vertex positions read from a tensor
+    """
+
+    def __init__(
+        self,
+        store: hephaistos.pyhephaistos.GeometryStore,
+        idx: int,
+        vertices: hephaistos.pyhephaistos.Tensor,
+        offset: int = 0,
+    ) -> None: ...
+
+class UpdateImageCommand:
+    """
+    Command for copying data from the given buffer into the image
+    """
+
+    def __init__(
+        self,
+        src: hephaistos.pyhephaistos.Buffer,
+        dst: hephaistos.pyhephaistos.Image,
+        region: hephaistos.pyhephaistos.ImageRegion = ImageRegion(),
+    ) -> None: ...
+
+class UpdateTensorCommand:
+    """
+    Command for copying the src buffer into the destination tensor
+    """
+
+    def __init__(
+        self,
+        src: hephaistos.pyhephaistos.Buffer,
+        dst: hephaistos.pyhephaistos.Tensor,
+        bufferOffset: Optional[int] = None,
+        tensorOffset: Optional[int] = None,
+        size: Optional[int] = None,
+        unsafe: bool = False,
+    ) -> None: ...
+
+class UpdateTextureCommand:
+    """
+    Command for copying data from the given buffer into the texture
+    """
+
+    def __init__(
+        self,
+        src: hephaistos.pyhephaistos.Buffer,
+        dst: hephaistos.pyhephaistos.Texture,
+        region: hephaistos.pyhephaistos.ImageRegion = ImageRegion(),
+    ) -> None: ...
+
+class UploadBuffer:
+    """
+    Buffer optimized for uploading data to the device. Allocated for sequential
+    writes preferring device local memory visible to the host, e.g. via
+    resizable BAR. Such memory is usually write-combined, thus should only be
+    filled via write() and never be read from the host.
+    """
+
+    def __init__(self, size: int) -> None:
+        """
+        Allocates a new upload buffer of the given size in bytes
+        """
+        ...
+    @property
+    def deviceLocal(self) -> bool:
+        """
+        True, if the buffer lives in device local memory
+        """
+        ...
+    @property
+    def size_bytes(self) -> int:
+        """
+        The size of the buffer in bytes.
+        """
+        ...
+    def write(self, data: numpy.typing.NDArray, offset: int = 0) -> None:
+        """
+        Writes the data into the buffer using non-temporal stores if available.
+
+        Parameters
+        ----------
+        data: ndarray
+            C contiguous array holding the data to write
+        offset: int, default=0
+            Offset into the buffer in bytes
+        """
+        ...
+
+class VertexFormat:
+    """
+    Format of the vertex positions in a mesh
+    """
+
+    FLOAT16: VertexFormat
+    """
+    Four 16 bit floats. The fourth component is ignored.
+    """
+
+    FLOAT32: VertexFormat
+    """
+    Three 32 bit floats
+    """
+
+    SNORM16: VertexFormat
+    """
+    Four 16 bit signed normalized integers. The fourth component is ignored.
+    """
+
+class WaitGraph:
+    """
+    Structured representation of the steps recorded by a SequenceBuilder
+    """
+
+    def analyze(self, durations: list[float]) -> hephaistos.pyhephaistos.WaitGraphTiming:
+        """
+        Estimates the timing of the wait graph from the steps' durations in
+        nanoseconds, e.g. measured using a StopWatch, including critical path
+        and idle gaps.
+
+        Steps start once all values they wait on are signaled and the previous
+        step on the same queue finished. Values not signaled by any step in the
+        graph are assumed to be available from the start.
+
+        Parameters
+        ----------
+        durations: list[float]
+            Duration of each step in nanoseconds
+        """
+        ...
+    @property
+    def steps(self) -> list[hephaistos.pyhephaistos.WaitGraphStep]:
+        """
+        Steps in submission order
+        """
+        ...
+    def toDot(self) -> str:
+        """
+        Creates a representation of the wait graph in the DOT language.
+        """
+        ...
+    def toJson(self) -> str:
+        """
+        Creates a JSON representation of the wait graph.
+        """
+        ...
+
+class WaitGraphStep:
+    """
+    Single step in a wait graph, i.e. one submission to a queue
+    """
+
+    @property
+    def commandBufferCount(self) -> int:
+        """
+        Number of command buffers and subroutines submitted
+        """
+        ...
+    @property
+    def queue(self) -> hephaistos.pyhephaistos.QueueType:
+        """
+        Queue the step runs on
+        """
+        ...
+    @property
+    def signal(self) -> hephaistos.pyhephaistos.WaitGraphValue:
+        """
+        Timeline value signaled once the step finished
+        """
+        ...
+    @property
+    def waits(self) -> list[hephaistos.pyhephaistos.WaitGraphValue]:
+        """
+        Timeline values the step waits on before it starts
+        """
+        ...
+
+class WaitGraphTiming:
+    """
+    Estimated timing of a wait graph's steps in nanoseconds relative to the
+    start of the earliest step
+    """
+
+    @property
+    def criticalPath(self) -> list[int]:
+        """
+        Indices of the steps on the critical path in execution order
+        """
+        ...
+    @property
+    def duration(self) -> float:
+        """
+        Estimated total time until all steps finished
+        """
+        ...
+    @property
+    def finish(self) -> list[float]:
+        """
+        Estimated finish time per step
+        """
+        ...
+    @property
+    def idle(self) -> list[float]:
+        """
+        Time the step's queue idled right before the step started
+        """
+        ...
+    @property
+    def start(self) -> list[float]:
+        """
+        Estimated start time per step
+        """
+        ...
+
+class WaitGraphValue:
+    """
+    Value of a timeline a step in a wait graph waits on or signals
+    """
+
+    @property
+    def timeline(self) -> int:
+        """
+        Id of the timeline
+        """
+        ...
+    @property
+    def value(self) -> int:
+        """
+        Value waited on or signaled
+        """
+        ...
+
+class WorkQueue:
+    """
+    Device side queue of 32 bit work items processed by persistent workgroups.
+    Programs include the built-in header "hephaistos/workqueue.glsl" and loop
+    popping items via workQueuePop() until the queue is empty, pushing follow
+    up work via workQueuePush(). Items pushed in a round are popped in the next
+    one, while each round only dispatches as many workgroups as fit onto the
+    device at once. Programs must be passed the queue's address, e.g. via push
+    constants.
+
+    Parameters
+    ----------
+    capacity: int
+        Amount of items each half of the queue can hold
+    """
+
+    def __init__(self, capacity: int) -> None: ...
+    @property
+    def address(self) -> int:
+        """
+        Device address of the queue
+        """
+        ...
+    @property
+    def capacity(self) -> int:
+        """
+        Amount of items each half of the queue can hold
+        """
+        ...
+    def getOccupancy(self, program: hephaistos.pyhephaistos.Program) -> int:
+        """
+        Returns the amount of workgroups of the given program resident on the
+        device at once.
+        """
+        ...
+    def launch(
+        self,
+        program: hephaistos.pyhephaistos.Program,
+        push: bytes = b"",
+        *,
+        rounds: int = 16,
+        maxGroups: int = 0,
+    ) -> hephaistos.pyhephaistos.WorkQueueCommand:
+        """
+        Creates a command running the given program until the queue drains.
+        Captures the program's bindings on creation.
+
+        Parameters
+        ----------
+        program: Program
+            Program processing the items
+        push: bytes, default=b''
+            Data pushed to each dispatch
+        rounds: int, default=16
+            Maximum amount of rounds
+        maxGroups: int, default=0
+            Maximum amount of workgroups per round. Zero uses the occupancy of
+            the program.
+        """
+        ...
+    @overload
+    def seed(self, count: int, first: int = 0) -> hephaistos.pyhephaistos.WorkQueueCommand:
+        """
+        Creates a command resetting the queue and filling it with a range of
+        consecutive items.
+
+        Parameters
+        ----------
+        count: int
+            Amount of items
+        first: int, default=0
+            Value of the first item
+        """
+        ...
+    @overload
+    def seed(
+        self, items: hephaistos.pyhephaistos.Tensor, count: Optional[int] = None
+    ) -> hephaistos.pyhephaistos.WorkQueueCommand:
+        """
+        Creates a command resetting the queue and filling it with the items
+        stored in the given tensor.
+
+        Parameters
+        ----------
+        items: Tensor
+            Tensor holding the items as 32 bit unsigned integers
+        count: int | None, default=None
+            Amount of items. Uses the whole tensor if None.
+        """
+        ...
+    @property
+    def tensor(self) -> hephaistos.pyhephaistos.Tensor:
+        """
+        Tensor holding the queue. Starts with a 64 byte header holding the
+        indirect dispatch size, round, head, count of both halves, capacity,
+        overflow and processed items as 32 bit integers.
+        """
+        ...
+
+class WorkQueueCommand:
+    """
+    Command seeding a work queue or running persistent workgroups on it. Runs
+    multiple dispatches synchronized among each other, but not with work
+    recorded before or after.
+    """
+
+def beginConditional(
+    tensor: Tensor, offset: int = 0, inverted: bool = False
+) -> hephaistos.pyhephaistos.BeginConditionalCommand:
+    """
+    Starts a block of dispatches, which are discarded if the 32 bit predicate
+    read from the tensor is zero, or non zero if inverted. Begin and end of a
+    block must be recorded into the same step of a sequence or the same
+    subroutine.
+
+    Parameters
+    ----------
+    tensor: Tensor
+        Tensor from which to read the predicate
+    offset: int, default=0
+        Offset in bytes at which the predicate is stored. Must be a multiple of 4.
+    inverted: bool, default=False
+        If True, the block is discarded if the predicate is non zero
+    """
+    ...
+
+def beginLabel(
+    name: str, color: tuple[float, float, float, float] = (0.0, 0.0, 0.0, 0.0)
+) -> hephaistos.pyhephaistos.BeginLabelCommand:
+    """
+    Opens a labeled region of commands shown in external tools. Regions can be
+    nested and must be closed within the same step of a sequence or the same
+    subroutine. Does nothing if debug labels are not enabled.
+
+    Parameters
+    ----------
+    name: str
+        Name of the region
+    color: tuple[float, float, float, float], default=(0.0, 0.0, 0.0, 0.0)
+        Optional RGBA color of the region
+    """
+    ...
+
+def beginSequence() -> hephaistos.pyhephaistos.SequenceBuilder:
+    """
+    Starts a new sequence.
+    """
+    ...
+
+@overload
+def beginSequence(
+    timeline: hephaistos.pyhephaistos.Timeline, startValue: int = 0
+) -> hephaistos.pyhephaistos.SequenceBuilder:
+    """
+    Starts a new sequence.
+    """
+    ...
+
+def beginSequenceTemplate() -> hephaistos.pyhephaistos.SequenceBuilder:
+    """
+    Starts a new sequence, which can be frozen into a SequenceTemplate.
+    """
+    ...
+
+@overload
+def beginSequenceTemplate(
+    timeline: hephaistos.pyhephaistos.Timeline, startValue: int = 0
+) -> hephaistos.pyhephaistos.SequenceBuilder:
+    """
+    Starts a new sequence, which can be frozen into a SequenceTemplate.
+    """
+    ...
+
+def beginTrace() -> None:
+    """
+    Starts recording submissions, waits and timeline updates from the host on
+    the current context. Also correlates the device's timestamps with the
+    host's clock, so profiler samples can be added to the trace.
+    """
+    ...
+
+def clearTensor(
+    tensor: hephaistos.pyhephaistos.Tensor,
+    offset: Optional[int] = None,
+    size: Optional[int] = None,
+    data: Optional[int] = None,
+    unsafe: bool = False,
+) -> hephaistos.pyhephaistos.ClearTensorCommand:
+    """
+    Creates a command for filling a tensor with constant data over a given range.
+    Defaults to zeroing the complete tensor
+
+    Parameters
+    ----------
+    tensor: Tensor
+        Tensor to be modified
+    offset: None|int, default=None
+        Offset into the Tensor at which to start clearing it.
+        Defaults to the start of the Tensor.
+    size: None|int, default=None
+        Amount of bytes to clear. If None, equals to the range starting at
+        offset until the end of the tensor
+    data: None|int, default=None
+        32 bit integer used to fill the tensor. If None, uses all zeros.
+    unsafe: bool, default=False
+        Wether to omit barrier ensuring read after write ordering.
+    """
+    ...
+
+def collectRetiredResources() -> int:
+    """
+    Destroys retired resources whose work has finished and returns the amount
+    of retired resources still waiting. Note that this may initialize the
+    context.
+    """
+    ...
+
+def compressData(data: numpy.typing.NDArray) -> bytes:
+    """
+    Compresses 32 bit words on the host into the same stream as
+    Primitives.compress(), e.g. to upload sparse data and decompress it on the
+    device.
+
+    Parameters
+    ----------
+    data: ndarray
+        Words to compress. Size in bytes must be a multiple of 4.
+    """
+    ...
+
+def configureDebug(
+    enablePrint: bool = False,
+    enableGPUValidation: bool = False,
+    enableSynchronizationValidation: bool = False,
+    enableThreadSafetyValidation: bool = False,
+    enableAPIValidation: bool = False,
+    enableRobustBufferAccess: bool = False,
+    callback: Callable[[hephaistos.pyhephaistos.DebugMessage], None] = lambda msg: None,
+) -> None:
+    """
+    Configures the current debug state. Must be called before any other library
+    calls except isVulkanAvailable() and isDebugAvailable().
+
+    Parameters
+    ----------
+    enablePrint: bool, default=False
+        Enables the usage of GL_EXT_debug_printf
+    enableGPUValidation: bool, default=False
+        Enable GPU assisted validation
+    enableSynchronizationValidation: bool, default=False
+        Enable synchronization validation between resources
+    enableThreadSafetyValidation: bool, default=False
+        Enable thread safety validation
+    enableAPIValidation: bool, default=False
+        Enables validation of the Vulkan API usage
+    enableRobustBufferAccess: bool, default=False
+        Bounds checks buffer accesses on contexts created afterwards. Costs
+        performance on some devices, thus intended for development only.
+    callback: (DebugMessage) -> None, default=print(message)
+        Callback called for each message. Prints the message by default.
+
+    Note
+    ----
+    Debugging requires the Vulkan Validation Layers to be installed.
+    """
+    ...
+
+@overload
+def convertFromHalf(src: hephaistos.pyhephaistos.HalfBuffer, dst: numpy.typing.NDArray) -> None:
+    """
+    Converts the buffer's half precision floats into the float32 array, which
+    must have the same size. Uses SIMD if available.
+    """
+    ...
+
+@overload
+def convertFromHalf(src: hephaistos.pyhephaistos.HalfTensor, dst: numpy.typing.NDArray) -> None:
+    """
+    Converts the mapped tensor's half precision floats into the float32 array,
+    which must have the same size. Uses SIMD if available.
+    """
+    ...
+
+@overload
+def convertToHalf(src: numpy.typing.NDArray, dst: hephaistos.pyhephaistos.HalfBuffer) -> None:
+    """
+    Converts the float32 array into half precision writing directly into the
+    buffer, which must have the same size. Uses SIMD if available.
+    """
+    ...
+
+@overload
+def convertToHalf(src: numpy.typing.NDArray, dst: hephaistos.pyhephaistos.HalfTensor) -> None:
+    """
+    Converts the float32 array into half precision writing directly into the
+    mapped tensor, which must have the same size. Uses SIMD if available.
+    """
+    ...
+
+def copyImageToTensor(
+    src: hephaistos.pyhephaistos.Image,
+    dst: hephaistos.pyhephaistos.Tensor,
+    region: hephaistos.pyhephaistos.ImageRegion = ImageRegion(),
+) -> hephaistos.pyhephaistos.CopyImageToTensorCommand:
+    """
+    Creates a command for copying the image into the given tensor without the
+    data leaving the device.
+
+    Parameters
+    ----------
+    src: Image
+        Source image
+    dst: Tensor
+        Destination tensor
+    region: ImageRegion, default=ImageRegion()
+        Region to copy. Defaults to the whole image
+    """
+    ...
+
+@overload
+def copyTensor(
+    src: hephaistos.pyhephaistos.Tensor,
+    dst: hephaistos.pyhephaistos.Tensor,
+    srcOffset: Optional[int] = None,
+    dstOffset: Optional[int] = None,
+    size: Optional[int] = None,
+    unsafe: bool = False,
+) -> hephaistos.pyhephaistos.CopyTensorCommand:
+    """
+    Creates a command for copying the src tensor into the destination tensor
+
+    Parameters
+    ----------
+    src: Tensor
+        Source tensor
+    dst: Tensor
+        Destination tensor
+    srcOffset: None|int, default=None
+        Optional offset into the source tensor in bytes
+    dstOffset: None|int, default=None
+        Optional offset into the destination tensor in bytes
+    size: None|int, default=None
+        Amount of data to copy in bytes. If None, equals to the complete source
+    unsafe: bool, default=False
+        Wether to omit barrier ensuring read after write ordering
+    """
+    ...
+
+@overload
+def copyTensor(
+    src: hephaistos.pyhephaistos.Tensor,
+    dst: hephaistos.pyhephaistos.Tensor,
+    regions: list[tuple[int, int, int]],
+    unsafe: bool = False,
+) -> hephaistos.pyhephaistos.CopyTensorCommand:
+    """
+    Creates a command for copying multiple regions of the src tensor into the
+    destination tensor using a single copy. Adjacent regions are merged.
+
+    Parameters
+    ----------
+    src: Tensor
+        Source tensor
+    dst: Tensor
+        Destination tensor
+    regions: list[tuple[int, int, int]]
+        Regions to copy as (srcOffset, dstOffset, size) in bytes
+    unsafe: bool, default=False
+        Wether to omit barrier ensuring read after write ordering
+    """
+    ...
+
+def copyTensorToImage(
+    src: hephaistos.pyhephaistos.Tensor,
+    dst: hephaistos.pyhephaistos.Image,
+    region: hephaistos.pyhephaistos.ImageRegion = ImageRegion(),
+) -> hephaistos.pyhephaistos.CopyTensorToImageCommand:
+    """
+    Creates a command for copying the tensor into the given image without the
+    data leaving the device.
+
+    Parameters
+    ----------
+    src: Tensor
+        Source tensor
+    dst: Image
+        Destination image
+    region: ImageRegion, default=ImageRegion()
+        Region to copy. Defaults to the whole image
+    """
+    ...
+
+def copyTensorToTexture(
+    src: hephaistos.pyhephaistos.Tensor,
+    dst: hephaistos.pyhephaistos.Texture,
+    region: hephaistos.pyhephaistos.ImageRegion = ImageRegion(),
+) -> hephaistos.pyhephaistos.CopyTensorToTextureCommand:
+    """
+    Creates a command for copying the tensor into the given texture without the
+    data leaving the device.
+
+    Parameters
+    ----------
+    src: Tensor
+        Source tensor
+    dst: Texture
+        Destination texture
+    region: ImageRegion, default=ImageRegion()
+        Region to copy. Defaults to the whole image
+    """
+    ...
+
+def createExportableTensor(size: int) -> hephaistos.pyhephaistos.Tensor:
+    """
+    Allocates a new tensor of the given size in bytes in its own dedicated
+    memory, which can be exported to other APIs, e.g. CUDA.
+    """
+    ...
+
+def createExportableTimeline(initialValue: int = 0) -> hephaistos.pyhephaistos.Timeline:
+    """
+    Creates a new timeline, which can be exported to other APIs, e.g. CUDA, to
+    synchronize with work submitted to the context.
+    """
+    ...
+
+def createPrograms(
+    code: list[bytes], specialization: Optional[list[bytes]] = None, threads: int = 0
+) -> list[hephaistos.pyhephaistos.Program]:
+    """
+    Creates multiple programs in parallel sharing the pipeline cache. Returns
+    the programs in the same order as the given code.
+
+    Parameters
+    ----------
+    code: list[bytes]
+        Byte code of the programs
+    specialization: list[bytes] | None, default=None
+        Data used for filling in specialization constants of each program
+    threads: int, default=0
+        Maximum amount of threads to use. Zero uses one per core.
+    """
+    ...
+
+def createSubroutine(
+    commands: list, simultaneous: bool = False, trackHazards: bool = False
+) -> hephaistos.pyhephaistos.Subroutine:
+    """
+    creates a subroutine from the list of commands
+
+    Parameters
+    ----------
+    commands: (Command | SubroutinePart | Subroutine)[]
+        Sequence of commands the Subroutine consists of. Parts and nestable
+        subroutines are included without re-recording them.
+    simultaneous: bool, default=False
+        True, if the subroutine can be submitted while a previous submission
+        has not yet finished. Disobeying this requirement results in undefined
+        behavior.
+    trackHazards: bool, default=False
+        True, if barriers should only be recorded between commands actually
+        depending on each other.
+    """
+    ...
+
+def createSubroutinePart(
+    commands: list, trackHazards: bool = False
+) -> hephaistos.pyhephaistos.SubroutinePart:
+    """
+    creates a subroutine part from the list of commands
+
+    Parameters
+    ----------
+    commands: Command[]
+        Sequence of commands the part consists of
+    trackHazards: bool, default=False
+        True, if barriers should only be recorded between commands actually
+        depending on each other.
+    """
+    ...
+
+def decompressData(stream: numpy.typing.NDArray, data: numpy.typing.NDArray) -> None:
+    """
+    Decompresses a stream created by Primitives.compress() or compressData()
+    on the host.
+
+    Parameters
+    ----------
+    stream: ndarray
+        Compressed stream
+    data: ndarray
+        Destination of the words. Must hold getDecompressedSize() bytes.
+    """
+    ...
+
+def defragmentTensors(
+    callback: Optional[Callable[[int, int, int], None]] = None
+) -> hephaistos.pyhephaistos.DefragmentationResult:
+    """
+    Compacts the memory occupied by tensors and releases empty device memory
+    blocks. Moved tensors keep their content, but their address and mapped
+    memory change. Sub-allocated tensors are never moved. No work using tensors
+    may be pending. Recorded subroutines, sequence templates, task graphs,
+    parameter sets and dispatch lists referencing moved tensors must be
+    recreated.
+
+    Parameters
+    ----------
+    callback: (int, int, int) -> None | None, default=None
+        Called for each moved tensor with its old and new device address and
+        size
+    """
+    ...
+
+def dispatchIndirectList(
+    dispatches: list,
+) -> hephaistos.pyhephaistos.DispatchIndirectListCommand:
+    """
+    Creates a command running the given indirect dispatches in order, while
+    synchronizing the indirect data only once for the whole list.
+
+    Parameters
+    ----------
+    dispatches: DispatchIndirectCommand[]
+        Dispatches to run in the given order
+    """
+    ...
+
+def dumpResources() -> str:
+    """
+    Returns a human readable report of the live resources tracked by the
+    current context summarized by type. Note that this may initialize the
+    context.
+    """
+    ...
+
+def enableAtomics(flags: set, force: bool = False) -> None:
+    """
+    Enables the atomic features contained in the given set by their name. Set
+    force=True if an existing context should be destroyed.
+    """
+    ...
+
+def enableConditionalExecution(force: bool = False) -> None:
+    """
+    Enables conditional execution. (Lazy) context creation fails if not
+    supported. Set force=True if an existing context should be destroyed.
+    """
+    ...
+
+def enableCooperativeMatrix(force: bool = False) -> None:
+    """
+    Enables cooperative matrices in programs. (Lazy) context creation fails if
+    not supported. Set force=True if an existing context should be destroyed.
+    """
+    ...
+
+def enableDebugLabels() -> None:
+    """
+    Enables debug labels and object names if supported, so they show up in
+    external tools. Must be called before any other library calls except
+    isVulkanAvailable() and isDebugAvailable().
+    """
+    ...
+
+def enableDescriptorBuffer(force: bool = False) -> None:
+    """
+    Enables storing descriptors of parameter sets in descriptor buffers, so
+    dispatches using them only bind offsets. (Lazy) context creation fails if
+    not supported. Set force=True if an existing context should be destroyed.
+    """
+    ...
+
+def enableExecutionGraph(force: bool = False) -> None:
+    """
+    Enables the experimental execution graphs. (Lazy) context creation fails if
+    not supported. Set force=True if an existing context should be destroyed.
+    """
+    ...
+
+def enableExternalMemory(force: bool = False) -> None:
+    """
+    Enables exporting memory and timelines. (Lazy) context creation fails if
+    not supported. Set force=True if an existing context should be destroyed.
+    """
+    ...
+
+def enablePackedTypes(flags: set, force: bool = False) -> None:
+    """
+    Enables the packed type features contained in the given set by their name.
+    Set force=True if an existing context should be destroyed.
+    """
+    ...
+
+def enablePerformanceQuery(force: bool = False) -> None:
+    """
+    Enables performance queries. (Lazy) context creation fails if not
+    supported. Set force=True if an existing context should be destroyed.
+    """
+    ...
+
+def enableQueuePriority(priority: hephaistos.pyhephaistos.QueuePriority, force: bool = False) -> None:
+    """
+    Sets the global priority of the context's queues relative to other
+    applications. (Lazy) context creation fails if not supported. Set
+    force=True if an existing context should be destroyed.
+    """
+    ...
+
+def enableRaytracing(force: bool = False, *, pipeline: bool = False) -> None:
+    """
+    Enables ray tracing. (Lazy) context creation fails if not supported. Set
+    force=True if an existing context should be destroyed. Set pipeline=True
+    to also enable ray tracing pipelines used by RayTracingProgram.
+    """
+    ...
+
+def enableResourceHeap(capacity: int = 4096, force: bool = False) -> None:
+    """
+    Enables resource heaps holding up to capacity resources of each type, which
+    programs index into instead of binding parameters. (Lazy) context creation
+    fails if not supported. Set force=True if an existing context should be
+    destroyed.
+    """
+    ...
+
+def enableShaderObject(force: bool = False) -> None:
+    """
+    Enables creating programs as shader objects instead of pipelines, which
+    speeds up program creation. (Lazy) context creation fails if not supported.
+    Set force=True if an existing context should be destroyed.
+    """
+    ...
+
+def endConditional() -> hephaistos.pyhephaistos.EndConditionalCommand:
+    """
+    Ends a block of conditionally executed dispatches.
+    """
+    ...
+
+def endLabel() -> hephaistos.pyhephaistos.EndLabelCommand:
+    """
+    Closes the innermost labeled region.
+    """
+    ...
+
+def endTrace() -> hephaistos.pyhephaistos.Trace:
+    """
+    Stops recording host events and returns the recorded trace.
+    """
+    ...
+
+def enumerateDevices() -> list[hephaistos.pyhephaistos.Device]:
+    """
+    Returns a list of all supported installed devices.
+    """
+    ...
+
+def enumeratePerformanceCounters() -> list[hephaistos.pyhephaistos.PerformanceCounter]:
+    """
+    Enumerates the performance counters available on the current context.
+    """
+    ...
+
+def execute(sub: hephaistos.pyhephaistos.Subroutine) -> None:
+    """
+    Runs the given subroutine synchronous.
+    """
+    ...
+
+@overload
+def execute(cmd: hephaistos.pyhephaistos.Command) -> None:
+    """
+    Runs the given command synchronous.
+    """
+    ...
+
+def executeList(list: list) -> None:
+    """
+    Runs the given of list commands synchronous
+    """
+    ...
+
+@overload
+def executeAsync(sub: hephaistos.pyhephaistos.Subroutine) -> hephaistos.pyhephaistos.Submission:
+    """
+    Runs the given subroutine asynchronous and returns a Submission to wait on.
+    """
+    ...
+
+@overload
+def executeAsync(cmd: hephaistos.pyhephaistos.Command) -> hephaistos.pyhephaistos.Submission:
+    """
+    Runs the given command asynchronous and returns a Submission to wait on.
+    """
+    ...
+
+def executeListAsync(list: list) -> hephaistos.pyhephaistos.Submission:
+    """
+    Runs the given list of commands asynchronous and returns a Submission to wait on.
+    """
+    ...
+
+def exportTensor(tensor: hephaistos.pyhephaistos.Tensor) -> hephaistos.pyhephaistos.ExternalMemory:
+    """
+    Exports the memory of a tensor created by createExportableTensor(). Each
+    call creates a new handle.
+    """
+    ...
+
+def exportTimeline(timeline: hephaistos.pyhephaistos.Timeline) -> int:
+    """
+    Exports the semaphore of a timeline created by createExportableTimeline()
+    and returns its native handle. Each call creates a new handle.
+    """
+    ...
+
+def fillTensor(
+    tensor: hephaistos.pyhephaistos.Tensor,
+    pattern: bytes,
+    offset: Optional[int] = None,
+    size: Optional[int] = None,
+    unsafe: bool = False,
+) -> hephaistos.pyhephaistos.FillTensorCommand:
+    """
+    Creates a command for filling a tensor with a repeated pattern over a given
+    range. Defaults to filling the complete tensor
+
+    Parameters
+    ----------
+    tensor: Tensor
+        Tensor to be modified
+    pattern: bytes
+        Pattern repeated to fill the tensor, e.g. a packed struct. Size must be
+        a multiple of 4.
+    offset: None|int, default=None
+        Offset into the Tensor at which to start filling it.
+        Defaults to the start of the Tensor.
+    size: None|int, default=None
+        Amount of bytes to fill. Must be a multiple of the pattern size. If
+        None, equals to the largest multiple fitting into the rest of the tensor
+    unsafe: bool, default=False
+        Wether to omit barrier ensuring read after write ordering.
+    """
+    ...
+
+def flushMemory() -> hephaistos.pyhephaistos.FlushMemoryCommand:
+    """
+    Returns a command for flushing memory writes.
+    """
+    ...
+
+def generateMipmaps(
+    texture: hephaistos.pyhephaistos.Texture,
+) -> hephaistos.pyhephaistos.GenerateMipmapsCommand:
+    """
+    Creates a command for generating the mip chain of the texture from its
+    first level. Formats not supporting linear filtering are downsampled using
+    nearest filtering.
+
+    Parameters
+    ----------
+    texture: Texture
+        Texture whose mip levels to generate
+    """
+    ...
+
+def getAtomicsProperties(id: int) -> hephaistos.pyhephaistos.AtomicsProperties:
+    """
+    Returns the atomic capabilities of the device given by its id
+    """
+    ...
+
+def getBlockExtent(format: hephaistos.pyhephaistos.ImageFormat) -> int:
+    """
+    Returns the width and height of a single block in pixels, i.e. 1 for
+    uncompressed formats
+    """
+    ...
+
+def getClockCorrelation() -> hephaistos.pyhephaistos.ClockCorrelation:
+    """
+    Correlates the device's timestamps with the host's steady clock. Uses
+    calibrated timestamps if supported, otherwise submits and waits on a single
+    timestamp.
+    """
+    ...
+
+def getCompressedSize(stream: numpy.typing.NDArray) -> int:
+    """
+    Returns the size in bytes of a compressed stream. Only reads its header,
+    i.e. the first 8 bytes.
+    """
+    ...
+
+def getContextStatistics() -> hephaistos.pyhephaistos.ContextStatistics:
+    """
+    Returns the counters of the work issued on the current context. Note that
+    this may initialize the context.
+    """
+    ...
+
+def getCooperativeMatrixProperties(
+    id: int,
+) -> list[hephaistos.pyhephaistos.CooperativeMatrixProperties]:
+    """
+    Returns the cooperative matrix configurations the device given by its id
+    supports. Empty if cooperative matrices are not supported.
+    """
+    ...
+
+def getCurrentDevice() -> hephaistos.pyhephaistos.Device:
+    """
+    Returns the currently active device. Note that this may initialize the context.
+    """
+    ...
+
+def getDecompressedSize(stream: numpy.typing.NDArray) -> int:
+    """
+    Returns the size in bytes of the data stored in a compressed stream. Only
+    reads its header, i.e. the first 8 bytes.
+    """
+    ...
+
+def getDeviceLimits(id: Optional[int] = None) -> hephaistos.pyhephaistos.DeviceLimits:
+    """
+    Returns the limits of the given or, if None, the currently active device.
+    Note that the latter may initialize the context.
+    """
+    ...
+
+def getDeviceNumaNode() -> int:
+    """
+    Returns the NUMA node the current device is attached to or -1 if unknown.
+    Note that this may initialize the context.
+    """
+    ...
+
+def getFloatControlsProperties() -> hephaistos.pyhephaistos.FloatControlsProperties:
+    """
+    Queries the float controls supported by the current context. Note that
+    this may initialize the context.
+    """
+    ...
+
+def getLiveResources() -> list[hephaistos.pyhephaistos.ResourceInfo]:
+    """
+    Returns the live resources tracked by the current context in order of
+    creation. Note that this may initialize the context.
+    """
+    ...
+
+def getMaxCompressedSize(count: int) -> int:
+    """
+    Returns the size in bytes a compressed stream of the given amount of 32
+    bit words occupies at most
+    """
+    ...
+
+def getMemoryModelFeatures() -> hephaistos.pyhephaistos.MemoryModelFeatures:
+    """
+    Queries the features of the Vulkan memory model enabled on the current
+    context. Note that this may initialize the context.
+    """
+    ...
+
+def getProgramRobustness() -> hephaistos.pyhephaistos.BufferRobustness:
+    """
+    Returns the robustness of programs created on the current context. Note
+    that this may initialize the context.
+    """
+    ...
+
+def getQueuePriority() -> hephaistos.pyhephaistos.QueuePriority:
+    """
+    Returns the global priority of the current context's queues. Might be
+    MEDIUM if the process lacks the privileges for the requested one. Note
+    that this may initialize the context.
+    """
+    ...
+
+def getStreamChunkSize(
+    bytesPerItem: int, slots: int = 3, memoryFraction: float = 0.5
+) -> int:
+    """
+    Derives the amount of items per chunk fitting into the remaining device
+    memory budget. Note that this may initialize the context.
+
+    Parameters
+    ----------
+    bytesPerItem: int
+        Device memory occupied per item and slot
+    slots: int, default=3
+        Amount of chunks in flight
+    memoryFraction: float, default=0.5
+        Fraction of the remaining budget to occupy
+    """
+    ...
+
+def getWaitSpinTime() -> int:
+    """
+    Returns how long waits on the current context poll before blocking in
+    nanoseconds. Note that this may initialize the context.
+    """
+    ...
+
+def hasDedicatedQueue(type: hephaistos.pyhephaistos.QueueType) -> bool:
+    """
+    Returns True, if the current context has a dedicated queue of the given type. Work targeting a missing queue runs on the main queue instead. Note that this may initialize the context.
+    """
+    ...
+
+def getElementSize(format: hephaistos.pyhephaistos.ImageFormat) -> int:
+    """
+    Returns the size of a single channel in bytes
+    """
+    ...
+
+def getEnabledAtomics() -> hephaistos.pyhephaistos.AtomicsProperties:
+    """
+    Returns the in the current context enabled atomic features
+    """
+    ...
+
+def getEnabledPackedTypes() -> hephaistos.pyhephaistos.PackedTypesProperties:
+    """
+    Returns the in the current context enabled packed type features
+    """
+    ...
+
+def getHostMemoryImportAlignment() -> int:
+    """
+    Returns the alignment in bytes address and size of imported host memory must
+    adhere to. Zero if importing is not supported.
+    """
+    ...
+
+def getImageSize(
+    format: hephaistos.pyhephaistos.ImageFormat,
+    width: int,
+    height: int = 1,
+    depth: int = 1,
+) -> int:
+    """
+    Returns the size of an image in bytes in a linear memory layout
+    """
+    ...
+
+def getMemoryStatistics() -> hephaistos.pyhephaistos.MemoryStatistics:
+    """
+    Returns the current memory usage and budget of the current context.
+    Collecting the statistics iterates all allocations and thus should not be
+    done too frequently. Note that this may initialize the context.
+    """
+    ...
+
+def getPackedTypesProperties(id: int) -> hephaistos.pyhephaistos.PackedTypesProperties:
+    """
+    Returns the packed type capabilities of the device given by its id
+    """
+    ...
+
+def getPipelineCacheFile() -> pathlib.Path:
+    """
+    Returns the file the pipeline cache is persisted in. Empty if none was set.
+    """
+    ...
+
+def getSubgroupProperties(arg: int, /) -> hephaistos.pyhephaistos.SubgroupProperties:
+    """
+    Returns the properties specific to subgroups (waves).
+    """
+    ...
+
+@overload
+def getSubgroupProperties() -> hephaistos.pyhephaistos.SubgroupProperties:
+    """
+    Returns the properties specific to subgroups (waves).
+    """
+    ...
+
+def getSubmissionLimit() -> int:
+    """
+    Returns the limit of submissions in flight on the current context; zero if
+    unlimited. Note that this may initialize the context.
+    """
+    ...
+
+def getSubmissionsInFlight() -> int:
+    """
+    Returns the amount of submissions counting towards the limit that have not
+    finished yet. Note that this may initialize the context.
+    """
+    ...
+
+def getSupportedTypes(id: Optional[int], /) -> hephaistos.pyhephaistos.TypeSupport:
+    """
+    Queries the supported extended types
+
+    Parameters
+    ----------
+    id: int | None, default=None
+        Id of the device to query. If None, uses the one the current context
+        was created on
+    """
+    ...
+
+def getTensorAutoMapping() -> bool:
+    """
+    Returns True, if tensors are mapped automatically on devices with unified
+    memory.
+    """
+    ...
+
+def getTensorLazyAllocation() -> bool:
+    """
+    Returns True, if tensors are allocated on their first use.
+    """
+    ...
+
+def getTensorPoolThreshold() -> int:
+    """
+    Returns the maximum size in bytes of tensors sub-allocated from shared
+    buffers. Zero if pooling is disabled.
+    """
+    ...
+
+def importTensor(
+    memory: hephaistos.pyhephaistos.ExternalMemory, size: Optional[int] = None
+) -> hephaistos.pyhephaistos.Tensor:
+    """
+    Creates a tensor using memory exported by another process on the same
+    device, sharing it without copies. On Linux, a successful import takes
+    ownership of the file descriptor. Import tensors with the same size they
+    were exported with.
+
+    Parameters
+    ----------
+    memory: ExternalMemory
+        Memory exported via exportTensor()
+    size: None|int, default=None
+        Size of the tensor in bytes. If None, uses the remaining memory after
+        the offset.
+    """
+    ...
+
+def importTimeline(handle: int) -> hephaistos.pyhephaistos.Timeline:
+    """
+    Creates a timeline using a semaphore exported by another process via
+    exportTimeline(). On Linux, a successful import takes ownership of the file
+    descriptor.
+    """
+    ...
+
+def insertLabel(
+    name: str, color: tuple[float, float, float, float] = (0.0, 0.0, 0.0, 0.0)
+) -> hephaistos.pyhephaistos.InsertLabelCommand:
+    """
+    Inserts a single label between commands shown in external tools. Does
+    nothing if debug labels are not enabled.
+
+    Parameters
+    ----------
+    name: str
+        Text of the label
+    color: tuple[float, float, float, float], default=(0.0, 0.0, 0.0, 0.0)
+        Optional RGBA color of the label
+    """
+    ...
+
+def isCalibratedTimestampsSupported() -> bool:
+    """
+    Returns True, if the current context supports calibrated timestamps. Note
+    that this may initialize the context.
+    """
+    ...
+
+def isCompressed(format: hephaistos.pyhephaistos.ImageFormat) -> bool:
+    """
+    Returns True, if the format is block compressed
+    """
+    ...
+
+def isConditionalExecutionEnabled() -> bool:
+    """
+    Checks wether conditional execution was enabled. Note that this creates the
+    context.
+    """
+    ...
+
+def isConditionalExecutionSupported(id: Optional[int] = None) -> bool:
+    """
+    Checks wether any or the given device supports conditional execution.
+    """
+    ...
+
+def isCooperativeMatrixEnabled() -> bool:
+    """
+    Checks wether cooperative matrices were enabled. Note that this creates the
+    context.
+    """
+    ...
+
+def isCooperativeMatrixSupported(id: Optional[int] = None) -> bool:
+    """
+    Checks wether any or the given device supports cooperative matrices.
+    """
+    ...
+
+def isDebugAvailable() -> bool:
+    """
+    Returns True if debugging is supported on this system.
+    This requires the Vulkan Validation Layers to be installed.
+    """
+    ...
+
+def isDebugLabelsEnabled() -> bool:
+    """
+    Checks whether debug labels and object names are enabled
+    """
+    ...
+
+def isDeferredDestructionEnabled() -> bool:
+    """
+    Returns True, if the current context defers the destruction of resources.
+    Note that this may initialize the context.
+    """
+    ...
+
+def isDescriptorBufferEnabled() -> bool:
+    """
+    Checks wether descriptor buffers were enabled. Note that this creates the
+    context.
+    """
+    ...
+
+def isDescriptorBufferSupported(id: Optional[int] = None) -> bool:
+    """
+    Checks wether any or the given device supports descriptor buffers.
+    """
+    ...
+
+def isDescriptorSetCacheEnabled() -> bool:
+    """
+    Returns True, if programs created on the current context bind cached
+    descriptor sets. Note that this may initialize the context.
+    """
+    ...
+
+def isDeviceSuitable(arg: int, /) -> bool:
+    """
+    Returns True if the device given by its id supports all enabled extensions
+    """
+    ...
+
+def isExecutionGraphEnabled() -> bool:
+    """
+    Checks wether execution graphs were enabled. Note that this creates the
+    context.
+    """
+    ...
+
+def isExecutionGraphSupported(id: Optional[int] = None) -> bool:
+    """
+    Checks wether any or the given device supports execution graphs.
+    """
+    ...
+
+def isExternalMemoryEnabled() -> bool:
+    """
+    Checks wether external memory was enabled. Note that this creates the
+    context.
+    """
+    ...
+
+def isExternalMemorySupported(id: Optional[int] = None) -> bool:
+    """
+    Checks wether any or the given device supports exporting memory and
+    timelines.
+    """
+    ...
+
+def isHostMemoryImportSupported() -> bool:
+    """
+    Returns True, if the current context supports importing host memory, e.g.
+    numpy arrays, into buffers. Note that this may initialize the context.
+    """
+    ...
+
+def isMemoryBudgetSupported() -> bool:
+    """
+    Returns True, if the current context tracks memory budgets reported by the
+    driver. Otherwise budgets are estimated from the heap sizes. Note that this
+    may initialize the context.
+    """
+    ...
+
+def isMemoryPrioritySupported() -> bool:
+    """
+    Returns True, if the current context supports memory priorities. Otherwise,
+    AllocationHints.priority is ignored. Note that this may initialize the
+    context.
+    """
+    ...
+
+def isPartiallyBoundEnabled() -> bool:
+    """
+    Checks wether array bindings can be bound partially. Note that this creates
+    the context.
+    """
+    ...
+
+def isPerformanceQueryEnabled() -> bool:
+    """
+    Checks wether performance queries were enabled. Note that this creates the
+    context.
+    """
+    ...
+
+def isPerformanceQuerySupported(id: Optional[int] = None) -> bool:
+    """
+    Checks wether any or the given device supports performance queries.
+    """
+    ...
+
+def isPipelineStatisticsSupported() -> bool:
+    """
+    Returns True, if the current context supports pipeline statistics. Note
+    that this may initialize the context.
+    """
+    ...
+
+def isProgramRobustnessSupported() -> bool:
+    """
+    Returns True, if programs can override the robustness of the current
+    context. Note that this may initialize the context.
+    """
+    ...
+
+def isQueuePrioritySupported(id: Optional[int] = None) -> bool:
+    """
+    Checks wether any or the given device supports setting the global queue
+    priority.
+    """
+    ...
+
+def isRaytracingEnabled() -> bool:
+    """
+    Checks wether ray tracing was enabled. Note that this creates the context.
+    """
+    ...
+
+def isRaytracingPipelineEnabled() -> bool:
+    """
+    Checks wether ray tracing pipelines were enabled. Note that this creates
+    the context.
+    """
+    ...
+
+def isRaytracingPipelineSupported(id: Optional[int] = None) -> bool:
+    """
+    Checks wether any or the given device supports ray tracing pipelines.
+    """
+    ...
+
+def isRaytracingSupported(id: Optional[int] = None) -> bool:
+    """
+    Checks wether any or the given device supports ray tracing.
+    """
+    ...
+
+def isResourceHeapEnabled() -> bool:
+    """
+    Checks wether resource heaps were enabled. Note that this creates the
+    context.
+    """
+    ...
+
+def isResourceHeapSupported(id: Optional[int] = None) -> bool:
+    """
+    Checks wether any or the given device supports resource heaps.
+    """
+    ...
+
+def isResourceTrackingEnabled() -> bool:
+    """
+    Returns True, if the current context tracks its live resources. Note that
+    this may initialize the context.
+    """
+    ...
+
+def isRobustBufferAccessEnabled() -> bool:
+    """
+    Checks whether the current context accesses buffers robustly. Note that
+    this may initialize the context.
+    """
+    ...
+
+def isShaderObjectEnabled() -> bool:
+    """
+    Checks wether shader objects were enabled. Note that this creates the
+    context.
+    """
+    ...
+
+def isShaderObjectSupported(id: Optional[int] = None) -> bool:
+    """
+    Checks wether any or the given device supports shader objects.
+    """
+    ...
+
+def isSparseResidencySupported() -> bool:
+    """
+    Returns True, if sparse tensors can be used while only partially committed.
+    Otherwise, they must be committed completely before use. Note that this may
+    initialize the context.
+    """
+    ...
+
+def isSparseTensorSupported() -> bool:
+    """
+    Returns True, if the current context supports sparse tensors. Note that
+    this may initialize the context.
+    """
+    ...
+
+def isSparseTextureFormatSupported(format: hephaistos.pyhephaistos.ImageFormat) -> bool:
+    """
+    Returns True, if the current context supports sparse textures of the given
+    format. Note that this may initialize the context.
+    """
+    ...
+
+def isSparseTextureSupported() -> bool:
+    """
+    Returns True, if the current context supports sparse 3D textures. Note that
+    this may initialize the context.
+    """
+    ...
+
+def isTexelBufferFormatSupported(
+    format: hephaistos.pyhephaistos.ImageFormat, storage: bool = True
+) -> bool:
+    """
+    Returns True, if the current context supports texel buffers of the given
+    format. If storage is True, queries support for writing, otherwise for read
+    only access. Note that this may initialize the context.
+    """
+    ...
+
+def isTextureFormatSupported(format: hephaistos.pyhephaistos.ImageFormat) -> bool:
+    """
+    Returns True, if the current context supports textures of the given
+    format. Note that this may initialize the context.
+    """
+    ...
+
+def isTracing() -> bool:
+    """
+    Returns True, if host events are recorded on the current context. Note that
+    this may initialize the context.
+    """
+    ...
+
+def isUnifiedMemorySupported() -> bool:
+    """
+    Returns True, if the device local memory of the current context is directly
+    accessible by the host, i.e. the device is integrated or supports resizable
+    BAR. Note that this may initialize the context.
+    """
+    ...
+
+def isVulkanAvailable() -> bool:
+    """
+    Returns True if Vulkan is available on this system.
+    """
+    ...
+
+def loadPipelineCache(path: os.PathLike) -> bool:
+    """
+    Merges pipeline cache data previously saved to the given file into the
+    current context. Returns False if the file does not exist or its data was
+    created by a different driver or device. Note that this may initialize the
+    context.
+    """
+    ...
+
+def philox4x32(
+    counter: tuple[int, int, int, int], key: tuple[int, int]
+) -> tuple[int, int, int, int]:
+    """
+    Evaluates the Philox4x32-10 generator on the host. A stream's numbers are
+    the components of the blocks with counter (draw, substream, stream low,
+    stream high) and the seed split into low and high word as key.
+    """
+    ...
+
+def rebuildAccelerationStructure(
+    accelerationStructure: hephaistos.pyhephaistos.AccelerationStructure,
+    instances: hephaistos.pyhephaistos.Tensor,
+    count: int,
+    offset: int = 0,
+    update: bool = False,
+) -> hephaistos.pyhephaistos.RebuildAccelerationStructureCommand:
+    """
+    Creates a command for rebuilding the acceleration structure on the device
+    from instances stored in a tensor using the layout of
+    VkAccelerationStructureInstanceKHR.
+
+    Parameters
+    ----------
+    accelerationStructure: AccelerationStructure
+        Acceleration structure to rebuild. Must have been created with
+        maxInstances.
+    instances: Tensor
+        Tensor containing the instances
+    count: int
+        Number of instances to build from
+    offset: int, default=0
+        Offset in bytes into the tensor where the instances start
+    update: bool, default=False
+        If True, updates the acceleration structure instead of rebuilding it.
+        Must use the same count as the last rebuild.
+    """
+    ...
+
+def replayCapture(
+    capture: hephaistos.pyhephaistos.Capture,
+    *,
+    warmup: int = 1,
+    iterations: int = 10,
+    resetTensors: bool = True,
+) -> list[float]:
+    """
+    Replays the capture on the current device and returns the duration of each
+    timed run in nanoseconds, measured from the start of the first to the end of
+    the last step.
+
+    Parameters
+    ----------
+    capture: Capture
+        Capture to replay
+    warmup: int, default=1
+        Amount of untimed runs
+    iterations: int, default=10
+        Amount of timed runs
+    resetTensors: bool, default=True
+        Restore the captured tensor contents before each run. Restoring is not
+        measured.
+    """
+    ...
+
+def requireTypes(types: set, force: bool = False, /) -> None:
+    """
+    Forces the given types as specified by in the set by their names (f64, f16,
+    i64, i16, i8), effectively marking devices, which do not support them as
+    unsupported. Set force=True if an existing context should be destroyed.
+    """
+
+def retrieveImage(
+    src: hephaistos.pyhephaistos.Image,
+    dst: hephaistos.pyhephaistos.Buffer,
+    region: hephaistos.pyhephaistos.ImageRegion = ImageRegion(),
+) -> hephaistos.pyhephaistos.RetrieveImageCommand:
+    """
+    Creates a command for copying the image back into the given buffer.
+
+    Parameters
+    ----------
+    src: Image
+        Source image
+    dst: Buffer
+        Destination buffer
+    region: ImageRegion, default=ImageRegion()
+        Region to copy. Defaults to the whole image
+    """
+    ...
+
+@overload
+def retrieveTensor(
+    src: hephaistos.pyhephaistos.Tensor,
+    dst: hephaistos.pyhephaistos.Buffer,
+    bufferOffset: Optional[int] = None,
+    tensorOffset: Optional[int] = None,
+    size: Optional[int] = None,
+    unsafe: bool = False,
+) -> hephaistos.pyhephaistos.RetrieveTensorCommand:
+    """
+    Creates a command for copying the src tensor back to the destination buffer
+
+    Parameters
+    ----------
+    src: Tensor
+        Source tensor
+    dst: Buffer
+        Destination buffer
+    bufferOffset: None|int, default=None
+        Optional offset into the buffer in bytes
+    tensorOffset: None|int, default=None
+        Optional offset into the tensor in bytes
+    size: None|int, default=None
+        Amount of data to copy in bytes. If None, equals to the complete buffer
+    unsafe: bool, default=False
+        Wether to omit barrier ensuring read after write ordering
+    """
+    ...
+
+@overload
+def retrieveTensor(
+    src: hephaistos.pyhephaistos.Tensor,
+    dst: hephaistos.pyhephaistos.Buffer,
+    regions: list[tuple[int, int, int]],
+    unsafe: bool = False,
+) -> hephaistos.pyhephaistos.RetrieveTensorCommand:
+    """
+    Creates a command for copying multiple regions of the src tensor back to the
+    destination buffer using a single copy. Adjacent
+    regions are merged.
+
+    Parameters
+    ----------
+    src: Tensor
+        Source tensor
+    dst: Buffer
+        Destination buffer
+    regions: list[tuple[int, int, int]]
+        Regions to copy as (bufferOffset, tensorOffset, size) in bytes
+    unsafe: bool, default=False
+        Wether to omit barrier ensuring read after write ordering
     """
     ...
 
-def clearTensor(
-    tensor: hephaistos.pyhephaistos.Tensor,
-    offset: Optional[int] = None,
+def retrieveTensorChunked(
+    src: hephaistos.pyhephaistos.Tensor,
+    dst: hephaistos.pyhephaistos.Buffer,
+    chunkSize: int,
+    bufferOffset: int = 0,
+    tensorOffset: int = 0,
     size: Optional[int] = None,
-    data: Optional[int] = None,
-    unsafe: bool = False,
-) -> hephaistos.pyhephaistos.ClearTensorCommand:
+) -> list[hephaistos.pyhephaistos.RetrieveTensorCommand]:
     """
-    Creates a command for filling a tensor with constant data over a given range.
-    Defaults to zeroing the complete tensor
+    Splits a copy from the src tensor to the destination buffer into commands
+    copying one chunk each. Recording each in its own step lets every chunk
+    signal its own timeline value.
 
     Parameters
     ----------
-    tensor: Tensor
-        Tensor to be modified
-    offset: None|int, default=None
-        Offset into the Tensor at which to start clearing it.
-        Defaults to the start of the Tensor.
+    src: Tensor
+        Source tensor
+    dst: Buffer
+        Destination buffer
+    chunkSize: int
+        Size of each chunk in bytes. The last one may be smaller.
+    bufferOffset: int, default=0
+        Offset into the buffer in bytes
+    tensorOffset: int, default=0
+        Offset into the tensor in bytes
     size: None|int, default=None
-        Amount of bytes to clear. If None, equals to the range starting at
-        offset until the end of the tensor
-    data: None|int, default=None
-        32 bit integer used to fill the tensor. If None, uses all zeros.
-    unsafe: bool, default=False
-        Wether to omit barrier ensuring read after write ordering.
+        Amount of data to copy in bytes. If None, equals to the complete buffer
     """
     ...
 
-def configureDebug(
-    enablePrint: bool = False,
-    enableGPUValidation: bool = False,
-    enableSynchronizationValidation: bool = False,
-    enableThreadSafetyValidation: bool = False,
-    enableAPIValidation: bool = False,
-    callback: Callable[[hephaistos.pyhephaistos.DebugMessage], None] = lambda msg: None,
+def retrieveTensorStreamed(
+    src: hephaistos.pyhephaistos.Tensor,
+    dst: hephaistos.pyhephaistos.Buffer,
+    chunkSize: int,
+    callback: Callable[[int, memoryview], None],
+    bufferOffset: int = 0,
+    tensorOffset: int = 0,
+    size: Optional[int] = None,
 ) -> None:
     """
-    Configures the current debug state. Must be called before any other library
-    calls except isVulkanAvailable() and isDebugAvailable().
+    Retrieves the src tensor in chunks and calls the callback with the offset of
+    each chunk relative to the copied region and a memoryview of its data as
+    soon as it arrived, while later chunks are still being copied. Blocks until
+    all chunks were consumed.
 
     Parameters
     ----------
-    enablePrint: bool, default=False
-        Enables the usage of GL_EXT_debug_printf
-    enableGPUValidation: bool, default=False
-        Enable GPU assisted validation
-    enableSynchronizationValidation: bool, default=False
-        Enable synchronization validation between resources
-    enableThreadSafetyValidation: bool, default=False
-        Enable thread safety validation
-    enableAPIValidation: bool, default=False
-        Enables validation of the Vulkan API usage
-    callback: (DebugMessage) -> None, default=print(message)
-        Callback called for each message. Prints the message by default.
-
-    Note
-    ----
-    Debugging requires the Vulkan Validation Layers to be installed.
+    src: Tensor
+        Source tensor
+    dst: Buffer
+        Destination buffer
+    chunkSize: int
+        Size of each chunk in bytes. The last one may be smaller.
+    callback: (int, memoryview) -> None
+        Callback consuming each chunk in order
+    bufferOffset: int, default=0
+        Offset into the buffer in bytes
+    tensorOffset: int, default=0
+        Offset into the tensor in bytes
+    size: None|int, default=None
+        Amount of data to copy in bytes. If None, equals to the complete buffer
     """
     ...
 
-def createSubroutine(
-    commands: list, simultaneous: bool = False
-) -> hephaistos.pyhephaistos.Subroutine:
+def saveMeshes(path: os.PathLike, meshes: hephaistos.pyhephaistos.MeshVector) -> None:
     """
-    creates a subroutine from the list of commands
+    Saves the meshes in a binary mesh file, which can be loaded by
+    GeometryStore.
 
     Parameters
     ----------
-    commands: Command[]
-        Sequence of commands the Subroutine consists of
-    simultaneous: bool, default=False
-        True, if the subroutine can be submitted while a previous submission
-        has not yet finished. Disobeying this requirement results in undefined
-        behavior.
+    path: str | PathLike
+        Path of the file to write
+    meshes: Mesh[]
+        Meshes to save
     """
     ...
 
-def enableAtomics(flags: set, force: bool = False) -> None:
+def savePipelineCache(path: os.PathLike) -> None:
     """
-    Enables the atomic features contained in the given set by their name. Set
-    force=True if an existing context should be destroyed.
+    Saves the pipeline cache data of the current context to the given file.
+    Note that this may initialize the context.
     """
     ...
 
-def enableRaytracing(force: bool = False) -> None:
+def selectDevice(id: int, force: bool = False) -> None:
     """
-    Enables ray tracing. (Lazy) context creation fails if not supported. Set
-    force=True if an existing context should be destroyed.
+    Sets the device on which the context will be initialized. Set force=True if
+    an existing context should be destroyed.
     """
     ...
 
-def enumerateDevices() -> list[hephaistos.pyhephaistos.Device]:
+def setDebugName(program: hephaistos.pyhephaistos.Program, name: str) -> None:
     """
-    Returns a list of all supported installed devices.
+    Names the program's pipeline and shader in external tools. Does nothing if
+    debug labels are not enabled.
     """
     ...
 
-def execute(sub: hephaistos.pyhephaistos.Subroutine) -> None:
+@overload
+def setDebugName(tensor: hephaistos.pyhephaistos.Tensor, name: str) -> None:
     """
-    Runs the given subroutine synchronous.
+    Names the tensor's buffer in external tools. Does nothing if debug labels
+    are not enabled or the tensor is sub-allocated from a shared buffer.
     """
     ...
 
 @overload
-def execute(cmd: hephaistos.pyhephaistos.Command) -> None:
+def setDebugName(image: hephaistos.pyhephaistos.Image, name: str) -> None:
     """
-    Runs the given command synchronous.
+    Names the image in external tools. Does nothing if debug labels are not
+    enabled.
     """
     ...
 
-def executeList(list: list) -> None:
+def setDeferredDestruction(enable: bool) -> None:
     """
-    Runs the given of list commands synchronous
+    Enables or disables deferred destruction on the current context. While
+    enabled, destroyed resources are retired until all work submitted before
+    finished instead of being destroyed immediately. Note that this may
+    initialize the context.
     """
     ...
 
-def flushMemory() -> hephaistos.pyhephaistos.FlushMemoryCommand:
+def setDescriptorSetCache(enable: bool) -> None:
     """
-    Returns a command for flushing memory writes.
+    Sets whether programs created afterwards on the current context bind
+    cached descriptor sets, one per unique combination of parameters, instead
+    of pushing them on each dispatch. Programs with more bindings than the
+    device can push always use cached sets. Cached sets are dropped once any
+    resource gets destroyed. Note that this may initialize the context.
     """
     ...
 
-def getAtomicsProperties(id: int) -> hephaistos.pyhephaistos.AtomicsProperties:
+def setPipelineCacheFile(path: os.PathLike) -> bool:
     """
-    Returns the atomic capabilities of the device given by its id
+    Persists the pipeline cache of the current context in the given file, i.e.
+    loads its data if present and writes it back once the context gets
+    destroyed. An empty path disables writing it back. Returns True, if
+    existing data was loaded. Note that this may initialize the context.
     """
     ...
 
-def getCurrentDevice() -> hephaistos.pyhephaistos.Device:
+def setProgramRobustness(robustness: hephaistos.pyhephaistos.BufferRobustness) -> None:
     """
-    Returns the currently active device. Note that this may initialize the context.
+    Sets the robustness of programs created afterwards on the current context,
+    e.g. to disable bounds checks for validated programs. Reloading a program
+    applies the current robustness. Note that this may initialize the context.
     """
     ...
 
-def getElementSize(format: hephaistos.pyhephaistos.ImageFormat) -> int:
+def setResourceTag(buffer: hephaistos.pyhephaistos.Buffer, tag: str) -> None:
     """
-    Returns the size of a single channel in bytes
+    Assigns a tag to the buffer shown in resource reports
     """
     ...
 
-def getEnabledAtomics() -> hephaistos.pyhephaistos.AtomicsProperties:
+@overload
+def setResourceTag(tensor: hephaistos.pyhephaistos.Tensor, tag: str) -> None:
     """
-    Returns the in the current context enabled atomic features
+    Assigns a tag to the tensor shown in resource reports
     """
     ...
 
-def getSubgroupProperties(arg: int, /) -> hephaistos.pyhephaistos.SubgroupProperties:
+@overload
+def setResourceTag(image: hephaistos.pyhephaistos.Image, tag: str) -> None:
     """
-    Returns the properties specific to subgroups (waves).
+    Assigns a tag to the image shown in resource reports
     """
     ...
 
 @overload
-def getSubgroupProperties() -> hephaistos.pyhephaistos.SubgroupProperties:
+def setResourceTag(texture: hephaistos.pyhephaistos.Texture, tag: str) -> None:
     """
-    Returns the properties specific to subgroups (waves).
+    Assigns a tag to the texture shown in resource reports
     """
     ...
 
-def getSupportedTypes(id: Optional[int], /) -> hephaistos.pyhephaistos.TypeSupport:
+@overload
+def setResourceTag(program: hephaistos.pyhephaistos.Program, tag: str) -> None:
     """
-    Queries the supported extended types
-
-    Parameters
-    ----------
-    id: int | None, default=None
-        Id of the device to query. If None, uses the one the current context
-        was created on
+    Assigns a tag to the program shown in resource reports
     """
     ...
 
-def isDebugAvailable() -> bool:
+def setResourceTracking(enable: bool) -> None:
     """
-    Returns True if debugging is supported on this system.
-    This requires the Vulkan Validation Layers to be installed.
+    Enables or disables the accounting of live resources on the current
+    context. Resources created before enabling it are not recorded. Disabling
+    it discards all records. While enabled, replacing the context with live
+    resources issues a ResourceWarning. Note that this may initialize the
+    context.
     """
     ...
 
-def isDeviceSuitable(arg: int, /) -> bool:
+def setSubmissionLimit(limit: int) -> None:
     """
-    Returns True if the device given by its id supports all enabled extensions
+    Limits the amount of submissions in flight on the current context. Once
+    reached, submitting further work blocks until enough previous work
+    finished. Zero disables the limit. Note that this may initialize the
+    context.
     """
     ...
 
-def isRaytracingEnabled() -> bool:
+def setTensorAutoMapping(enable: bool) -> None:
     """
-    Checks wether ray tracing was enabled. Note that this creates the context.
+    Enables mapping all tensors created afterwards if the device supports
+    unified memory, as mapped memory still resides on the device. Their content
+    can then be accessed directly via their memory address. Disabled by default.
     """
     ...
 
-def isRaytracingSupported(id: Optional[int] = None) -> bool:
+def setTensorLazyAllocation(enable: bool) -> None:
     """
-    Checks wether any or the given device supports ray tracing.
+    Enables deferring the allocation of tensors created afterwards until their
+    first use, e.g. being bound to a program or recorded into a command. Data
+    passed on creation is kept on the host until then. Disabled by default.
     """
     ...
 
-def isVulkanAvailable() -> bool:
+def setTensorPoolThreshold(threshold: int) -> None:
     """
-    Returns True if Vulkan is available on this system.
+    Enables sub-allocating tensors created afterwards, whose size in bytes does
+    not exceed the threshold, from shared buffers. Avoids hitting the driver's
+    allocation limit when creating many small tensors. Zero disables pooling,
+    which is the default.
     """
     ...
 
-def requireTypes(types: set, force: bool = False, /) -> None:
+def setWaitSpinTime(nanoseconds: int) -> None:
     """
-    Forces the given types as specified by in the set by their names (f64, f16,
-    i64, i16, i8), effectively marking devices, which do not support them as
-    unsupported. Set force=True if an existing context should be destroyed.
+    Sets how long waits on the current context poll before blocking, which
+    avoids the wake up latency of blocking waits on some drivers at the cost of
+    CPU time. Zero blocks right away. Note that this may initialize the context.
     """
+    ...
 
-def retrieveImage(
-    src: hephaistos.pyhephaistos.Image, dst: hephaistos.pyhephaistos.Buffer
-) -> hephaistos.pyhephaistos.RetrieveImageCommand:
+def specializeCode(code: bytes, specialization: bytes) -> bytes:
     """
-    Creates a command for copying the image back into the given buffer.
+    Folds specialization constants into the given SPIR-V code, so drivers can
+    optimize it as if the values were hardcoded. Data is interpreted the same
+    way as the specialization of Program. Constants without data keep their
+    default value.
 
     Parameters
     ----------
-    src: Image
-        Source image
-    dst: Buffer
-        Destination buffer
+    code: bytes
+        SPIR-V byte code
+    specialization: bytes
+        Data used for filling in specialization constants
     """
     ...
 
-def retrieveTensor(
-    src: hephaistos.pyhephaistos.Tensor,
-    dst: hephaistos.pyhephaistos.Buffer,
-    bufferOffset: Optional[int] = None,
-    tensorOffset: Optional[int] = None,
-    size: Optional[int] = None,
-    unsafe: bool = False,
-) -> hephaistos.pyhephaistos.RetrieveTensorCommand:
+def submitBatch(list: list) -> list[hephaistos.pyhephaistos.Submission]:
     """
-    Creates a command for copying the src tensor back to the destination buffer
-
-    Parameters
-    ----------
-    src: Tensor
-        Source tensor
-    dst: Buffer
-        Destination buffer
-    bufferOffset: None|int, default=None
-        Optional offset into the buffer in bytes
-    tensorOffset: None|int, default=None
-        Optional offset into the tensor in bytes
-    size: None|int, default=None
-        Amount of data to copy in bytes. If None, equals to the complete buffer
-    unsafe: bool, default=False
-        Wether to omit barrier ensuring read after write ordering
+    Submits the recorded steps of all given sequences at once, merging them
+    into a single batch per queue. Returns a Submission per sequence in the
+    given order. All sequences must have been created on the same context.
     """
     ...
 
-def selectDevice(id: int, force: bool = False) -> None:
+def suitableDeviceAvailable() -> bool:
     """
-    Sets the device on which the context will be initialized. Set force=True if
-    an existing context should be destroyed.
+    Returns True, if there is a device available supporting all enabled extensions
     """
     ...
 
-def suitableDeviceAvailable() -> bool:
+def tuneProgram(
+    code: bytes,
+    candidates: list[bytes],
+    dispatch: Callable[
+        [hephaistos.pyhephaistos.Program, int], hephaistos.pyhephaistos.DispatchCommand
+    ],
+    warmup: int = 1,
+    repetitions: int = 5,
+    cacheFile: Optional[os.PathLike] = None,
+) -> hephaistos.pyhephaistos.TuningResult:
+    """
+    Finds the fastest specialization of the given program on the current device
+    by timing the dispatch returned by the callback for each candidate.
+    Candidates throwing while being created or benchmarked are skipped.
+
+    Parameters
+    ----------
+    code: bytes
+        Byte code of the program
+    candidates: list[bytes]
+        Specializations to choose from, e.g. different workgroup sizes
+    dispatch: Callable[[Program, int], DispatchCommand]
+        Called with the program and index of each candidate. Must bind the
+        parameters and return a representative dispatch.
+    warmup: int, default=1
+        Amount of untimed runs per candidate
+    repetitions: int, default=5
+        Amount of timed runs per candidate, of which the median is used
+    cacheFile: pathlib.Path | None, default=None
+        File to cache results in per device, code and candidates
     """
-    Returns True, if there is a device available supporting all enabled extensions
+    ...
+
+def updateGeometry(
+    store: hephaistos.pyhephaistos.GeometryStore,
+    idx: int,
+    vertices: hephaistos.pyhephaistos.Tensor,
+    offset: int = 0,
+) -> hephaistos.pyhephaistos.UpdateGeometryCommand:
+    """
+    Creates a command for refitting the geometry to new vertex positions.
+    Acceleration structures referencing it must be rebuilt afterwards.
+
+    Parameters
+    ----------
+    store: GeometryStore
+        Store containing the geometry. Must have been created with allowUpdate.
+    idx: int
+        Index of the geometry to update
+    vertices: Tensor
+        Tensor containing the new vertex positions using the same layout as the mesh
+    offset: int, default=0
+        Offset in bytes into the tensor where the vertices start
     """
     ...
 
 def updateImage(
-    src: hephaistos.pyhephaistos.Buffer, dst: hephaistos.pyhephaistos.Image
+    src: hephaistos.pyhephaistos.Buffer,
+    dst: hephaistos.pyhephaistos.Image,
+    region: hephaistos.pyhephaistos.ImageRegion = ImageRegion(),
 ) -> hephaistos.pyhephaistos.UpdateImageCommand:
     """
     Creates a command for copying data from the given buffer into the image.
@@ -3901,9 +12515,12 @@ def updateImage(
         Source buffer
     dst: Image
         Destination image
+    region: ImageRegion, default=ImageRegion()
+        Region to copy. Defaults to the whole image
     """
     ...
 
+@overload
 def updateTensor(
     src: hephaistos.pyhephaistos.Buffer,
     dst: hephaistos.pyhephaistos.Tensor,
@@ -3932,8 +12549,105 @@ def updateTensor(
     """
     ...
 
+@overload
+def updateTensor(
+    src: hephaistos.pyhephaistos.Buffer,
+    dst: hephaistos.pyhephaistos.Tensor,
+    regions: list[tuple[int, int, int]],
+    unsafe: bool = False,
+) -> hephaistos.pyhephaistos.UpdateTensorCommand:
+    """
+    Creates a command for copying multiple regions of the src buffer into the
+    destination tensor using a single copy. Adjacent
+    regions are merged.
+
+    Parameters
+    ----------
+    src: Buffer
+        Source Buffer
+    dst: Tensor
+        Destination Tensor
+    regions: list[tuple[int, int, int]]
+        Regions to copy as (bufferOffset, tensorOffset, size) in bytes
+    unsafe: bool, default=False
+        Wether to omit barrier ensuring read after write ordering
+    """
+    ...
+
+def updateTensorBatch(
+    src: hephaistos.pyhephaistos.Buffer,
+    dst: hephaistos.pyhephaistos.Tensor,
+    regions: numpy.typing.NDArray,
+    unsafe: bool = False,
+) -> hephaistos.pyhephaistos.UpdateTensorCommand:
+    """
+    Creates a command for copying multiple regions of the src buffer into the
+    destination tensor using a single copy. Same as updateTensor() but reads
+    the regions directly from an array without walking a list.
+
+    Parameters
+    ----------
+    src: Buffer
+        Source Buffer
+    dst: Tensor
+        Destination Tensor
+    regions: ndarray[uint64]
+        Regions to copy as rows of (bufferOffset, tensorOffset, size) in bytes
+        with shape (n, 3)
+    unsafe: bool, default=False
+        Wether to omit barriers ensuring read after write ordering
+    """
+    ...
+
+def updateTensorChunked(
+    src: hephaistos.pyhephaistos.Buffer,
+    dst: hephaistos.pyhephaistos.Tensor,
+    chunkSize: int,
+    bufferOffset: int = 0,
+    tensorOffset: int = 0,
+    size: Optional[int] = None,
+) -> list[hephaistos.pyhephaistos.UpdateTensorCommand]:
+    """
+    Splits a copy from the src buffer to the destination tensor into commands
+    copying one chunk each. Recording each in its own step lets every chunk
+    signal its own timeline value.
+
+    Parameters
+    ----------
+    src: Buffer
+        Source buffer
+    dst: Tensor
+        Destination tensor
+    chunkSize: int
+        Size of each chunk in bytes. The last one may be smaller.
+    bufferOffset: int, default=0
+        Offset into the buffer in bytes
+    tensorOffset: int, default=0
+        Offset into the tensor in bytes
+    size: None|int, default=None
+        Amount of data to copy in bytes. If None, equals to the complete buffer
+    """
+    ...
+
+def updateTensors(
+    updates: list[tuple[hephaistos.pyhephaistos.Tensor, int, int, int]],
+) -> None:
+    """
+    Updates multiple tensors at once, blocking only until all transfers
+    finished. Packs the staged data of all updates and copies them using a
+    single submission. All tensors must belong to the same context.
+
+    Parameters
+    ----------
+    updates: list[tuple[Tensor, int, int, int]]
+        Updates as (tensor, addr, size, offset) with size and offset in bytes
+    """
+    ...
+
 def updateTexture(
-    src: hephaistos.pyhephaistos.Buffer, dst: hephaistos.pyhephaistos.Texture
+    src: hephaistos.pyhephaistos.Buffer,
+    dst: hephaistos.pyhephaistos.Texture,
+    region: hephaistos.pyhephaistos.ImageRegion = ImageRegion(),
 ) -> hephaistos.pyhephaistos.UpdateTextureCommand:
     """
     Creates a command for copying data from the given buffer into the texture.
@@ -3944,5 +12658,38 @@ def updateTexture(
         Source buffer
     dst: Texture
         Destination texture
+    region: ImageRegion, default=ImageRegion()
+        Region to copy. Defaults to the whole image
+    """
+    ...
+
+def waitAll(list: list) -> None:
+    """
+    Blocks the caller until all given submissions or (Timeline, value) tuples
+    finished. All of them must have been created on the same context.
+    """
+    ...
+
+def waitAllTimeout(list: list, ns: int) -> bool:
+    """
+    Blocks the caller until all given submissions or (Timeline, value) tuples
+    finished or the specified time elapsed. Returns True in the first, False
+    in the second case.
+    """
+    ...
+
+def waitAny(list: list) -> int:
+    """
+    Blocks the caller until any of the given submissions or (Timeline, value)
+    tuples finished and returns its index. All of them must have been created
+    on the same context.
+    """
+    ...
+
+def waitAnyTimeout(list: list, ns: int) -> Optional[int]:
+    """
+    Blocks the caller until any of the given submissions or (Timeline, value)
+    tuples finished or the specified time elapsed. Returns the index of the
+    finished one in the first, None in the second case.
     """
     ...
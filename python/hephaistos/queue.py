@@ -1,18 +1,430 @@
 from __future__ import annotations
 
+import json
 import numpy as np
+import os
+import struct
 import warnings
+import zlib
+from concurrent.futures import ThreadPoolExecutor
 from contextlib import ExitStack
 
-from ctypes import Structure, c_uint32, pointer, sizeof
-from hephaistos import Buffer, ByteTensor, Command, RawBuffer, Tensor, clearTensor
+from ctypes import (
+    Structure,
+    c_double,
+    c_bool,
+    c_float,
+    c_int16,
+    c_int32,
+    c_int64,
+    c_uint16,
+    c_uint32,
+    c_uint64,
+    pointer,
+    sizeof,
+)
+from hephaistos import (
+    Buffer,
+    ByteTensor,
+    Command,
+    Primitives,
+    RawBuffer,
+    SortKeyType,
+    Tensor,
+    clearTensor,
+)
 from hephaistos.util import printSize
 from numpy import ndarray
 from numpy.ctypeslib import as_array
 
 from numpy.typing import NDArray
 from os import PathLike
-from typing import Any, BinaryIO, Dict, Optional, Set, Type, Union
+from typing import (
+    Any,
+    BinaryIO,
+    Callable,
+    Dict,
+    Iterable,
+    Iterator,
+    List,
+    Optional,
+    Set,
+    Tuple,
+    Type,
+    Union,
+)
+
+
+def _createSoA(item: Type[Structure], capacity: int) -> Type[Structure]:
+    """Creates the structure of arrays holding capacity many items"""
+
+    class SoA(Structure):
+        _fields_ = [
+            (
+                (name, t._type_ * capacity * t._length_)  # handle arrays
+                if hasattr(t, "_length_")  # check if array
+                else (name, t * capacity)
+            )  # handle scalar
+            for name, t in item._fields_  # iterate over all fields
+        ]
+
+    return SoA
+
+
+QUEUE_ENCODINGS = ("half", "snorm16", "unorm16", "flag")
+"""Packed encodings supported by QueueLayout"""
+
+_GLSL_TYPES = {
+    c_bool: "bool",
+    c_float: "float",
+    c_double: "double",
+    c_int16: "int16_t",
+    c_uint16: "uint16_t",
+    c_int32: "int",
+    c_uint32: "uint",
+    c_int64: "int64_t",
+    c_uint64: "uint64_t",
+}
+
+_FLAG_TYPES = (c_bool, c_int32, c_uint32)
+
+
+def _elementType(t: Any) -> Any:
+    """Returns the element type of array fields or the type itself otherwise"""
+    return t._type_ if hasattr(t, "_length_") else t
+
+
+class QueueLayout:
+    """
+    Describes how the fields of a queue item are stored. Fields may declare a
+    packed encoding reducing the memory and bandwidth a queue requires. From
+    the outside, encoded fields keep the type declared by the item:
+    `QueueView` decodes them on access, while the GLSL accessors returned by
+    `glsl` decode them on the device.
+
+    Supported encodings are:
+
+    - "half": float stored as 16 bit floating point number
+    - "snorm16": float in [-1,1] stored as 16 bit signed normalized integer
+    - "unorm16": float in [0,1] stored as 16 bit unsigned normalized integer
+    - "flag": integer or bool stored as a single bit. All flags of an item
+      share a single 32 bit column.
+
+    Layouts can be passed everywhere a queue expects an item.
+
+    Parameters
+    ----------
+    item: Structure
+        Structure describing a single item
+    encodings: { field: str } | None, default=None
+        Encoding of each packed field. Fields not listed are stored as is.
+    flagsName: str, default="flags"
+        Name of the column holding the flags in memory and GLSL
+
+    Example
+    -------
+    >>> class Photon(Structure):
+    ...     _fields_ = [
+    ...         ("position", c_float * 3),
+    ...         ("direction", c_float * 3),
+    ...         ("wavelength", c_float),
+    ...         ("alive", c_uint32),
+    ...     ]
+    >>> layout = QueueLayout(
+    ...     Photon, {"direction": "snorm16", "wavelength": "half", "alive": "flag"}
+    ... )
+    >>> queue = QueueTensor(layout, 1 << 20)
+    """
+
+    def __init__(
+        self,
+        item: Type[Structure],
+        encodings: Optional[Dict[str, str]] = None,
+        *,
+        flagsName: str = "flags",
+    ) -> None:
+        encodings = dict(encodings or {})
+        fields = dict(item._fields_)
+        self._item = item
+        self._encodings = encodings
+        self._flagsName = flagsName
+        self._bits = {}
+
+        # check encodings
+        for name, encoding in encodings.items():
+            if name not in fields:
+                raise ValueError(f"Item has no field {name}!")
+            if encoding not in QUEUE_ENCODINGS:
+                raise ValueError(f'Unknown encoding "{encoding}"!')
+            t = fields[name]
+            if encoding == "flag":
+                if t not in _FLAG_TYPES:
+                    raise ValueError(f"Field {name} cannot be encoded as flag!")
+            elif _elementType(t) is not c_float:
+                raise ValueError(f"Field {name} must be a float to use {encoding}!")
+        if flagsName in fields and "flag" in encodings.values():
+            raise ValueError(f"Flags column {flagsName} collides with a field!")
+
+        # build the structure describing the stored item
+        storage = []
+        for name, t in item._fields_:
+            encoding = encodings.get(name)
+            if encoding is None:
+                storage.append((name, t))
+            elif encoding == "flag":
+                if not self._bits:
+                    storage.append((flagsName, c_uint32))
+                if len(self._bits) >= 32:
+                    raise ValueError("Items can have at most 32 flags!")
+                self._bits[name] = len(self._bits)
+            else:
+                base = c_int16 if encoding == "snorm16" else c_uint16
+                length = getattr(t, "_length_", None)
+                storage.append((name, base if length is None else base * length))
+        self._storage = type(
+            f"{item.__name__}Packed", (Structure,), {"_fields_": storage}
+        )
+
+    @property
+    def item(self) -> Type[Structure]:
+        """Structure describing a single item"""
+        return self._item
+
+    @property
+    def storage(self) -> Type[Structure]:
+        """Structure describing a single item as it is stored in memory"""
+        return self._storage
+
+    @property
+    def encodings(self) -> Dict[str, str]:
+        """Encoding of each packed field"""
+        return dict(self._encodings)
+
+    @property
+    def flagsName(self) -> str:
+        """Name of the column holding the flags"""
+        return self._flagsName
+
+    def column(self, field: str) -> str:
+        """Returns the name of the column in memory storing the given field"""
+        return self._flagsName if field in self._bits else field
+
+    def isEncoded(self, field: str) -> bool:
+        """True, if the given field is stored in a packed encoding"""
+        return field in self._encodings
+
+    def decode(self, field: str, raw: NDArray) -> NDArray:
+        """Decodes the stored values of the given field"""
+        encoding = self._encodings.get(field)
+        if encoding is None:
+            return raw
+        elif encoding == "half":
+            return raw.view(np.float16).astype(np.float32)
+        elif encoding == "snorm16":
+            return np.maximum(raw / np.float32(32767.0), np.float32(-1.0))
+        elif encoding == "unorm16":
+            return raw / np.float32(65535.0)
+        else:
+            dtype = np.dtype(dict(self._item._fields_)[field])
+            return ((raw >> self._bits[field]) & 1).astype(dtype)
+
+    def encode(self, field: str, raw: NDArray, value: Any) -> NDArray:
+        """
+        Encodes value into the stored values of the given field. raw holds the
+        currently stored values, which flags need for keeping their neighbours.
+        """
+        encoding = self._encodings.get(field)
+        if encoding is None:
+            return value
+        elif encoding == "flag":
+            bit = np.uint32(1 << self._bits[field])
+            value = np.asarray(value) != 0
+            return (raw & ~bit) | np.where(value, bit, np.uint32(0))
+        value = np.asarray(value, np.float32)
+        if encoding == "half":
+            return value.astype(np.float16).view(np.uint16)
+        elif encoding == "snorm16":
+            return np.round(np.clip(value, -1.0, 1.0) * 32767.0).astype(np.int16)
+        else:
+            return np.round(np.clip(value, 0.0, 1.0) * 65535.0).astype(np.uint16)
+
+    def glsl(
+        self,
+        capacity: int,
+        name: Optional[str] = None,
+        *,
+        header: Optional[str] = None,
+        skipCounter: bool = False,
+    ) -> str:
+        """
+        Generates GLSL code declaring the queue as buffer reference together
+        with accessors packing and unpacking its items. For a queue named
+        `Queue` the following functions are declared:
+
+        - `Queue_load(q, i)` / `Queue_store(q, i, item)` for whole items
+        - `Queue_get_<field>(q, i)` / `Queue_set_<field>(q, i, value)` for
+          single fields. Array fields take the element index after i.
+
+        Also declares the item as struct using the name of its Structure.
+
+        Parameters
+        ----------
+        capacity: int
+            Maximum number of items the queue can hold
+        name: str | None, default=None
+            Name of the buffer reference type. Defaults to the item's name
+            followed by "Queue".
+        header: str | None, default=None
+            Name of the GLSL struct used as header if there is one. Its layout
+            must match the header's Structure.
+        skipCounter: bool, default=False
+            True, if the queue does not contain a counter
+        """
+        item = self._item.__name__
+        name = f"{item}Queue" if name is None else name
+
+        def glslType(t) -> str:
+            if t not in _GLSL_TYPES:
+                raise ValueError(f"Type {t.__name__} has no GLSL counterpart!")
+            return _GLSL_TYPES[t]
+
+        # split fields into element type and optional length
+        fields = []
+        for field, t in self._item._fields_:
+            length = getattr(t, "_length_", None)
+            fields.append((field, glslType(_elementType(t)), length))
+        storage = []
+        for column, t in self._storage._fields_:
+            length = getattr(t, "_length_", None)
+            storage.append((column, glslType(_elementType(t)), length))
+
+        lines = ["#extension GL_EXT_buffer_reference : require"]
+        types = {t for _, t, _ in storage}
+        if types & {"int16_t", "uint16_t"}:
+            lines.append("#extension GL_EXT_shader_16bit_storage : require")
+        if types & {"int64_t", "uint64_t"}:
+            lines.append(
+                "#extension GL_EXT_shader_explicit_arithmetic_types_int64 : require"
+            )
+        lines.append("")
+
+        # item struct
+        lines.append(f"struct {item} {{")
+        for field, t, length in fields:
+            lines.append(f"    {t} {field}{'' if length is None else f'[{length}]'};")
+        lines += ["};", ""]
+
+        # queue block
+        lines.append(f"layout(buffer_reference, std430) buffer {name} {{")
+        if header is not None:
+            lines.append(f"    {header} header;")
+        if not skipCounter:
+            lines.append("    uint count;")
+        for column, t, length in storage:
+            if self._encodings.get(column) == "half":
+                t = "float16_t"
+            dims = f"[{capacity}]" if length is None else f"[{length}][{capacity}]"
+            lines.append(f"    {t} {column}{dims};")
+        lines += ["};", ""]
+
+        # field accessors
+        for field, t, length in fields:
+            encoding = self._encodings.get(field)
+            if length is None:
+                index, params = "[i]", "uint i"
+            else:
+                index, params = "[j][i]", "uint i, uint j"
+            ref = f"q.{self.column(field)}{index}"
+            if encoding is None:
+                load, store = ref, f"{ref} = value"
+            elif encoding == "half":
+                load, store = f"float({ref})", f"{ref} = float16_t(value)"
+            elif encoding == "snorm16":
+                load = f"max(float(int({ref})) / 32767.0, -1.0)"
+                store = (
+                    f"{ref} = int16_t(int(round(clamp(value, -1.0, 1.0) * 32767.0)))"
+                )
+            elif encoding == "unorm16":
+                load = f"float(uint({ref})) / 65535.0"
+                store = (
+                    f"{ref} = uint16_t(uint(round(clamp(value, 0.0, 1.0) * 65535.0)))"
+                )
+            else:
+                bit = self._bits[field]
+                isSet = "value" if t == "bool" else "value != 0"
+                load = f"{t}(({ref} >> {bit}) & 1u)"
+                store = (
+                    f"{ref} = ({ref} & ~(1u << {bit})) | (({isSet}) ? 1u << {bit} : 0u)"
+                )
+            lines += [
+                f"{t} {name}_get_{field}({name} q, {params}) {{",
+                f"    return {load};",
+                "}",
+                f"void {name}_set_{field}({name} q, {params}, {t} value) {{",
+                f"    {store};",
+                "}",
+            ]
+        lines.append("")
+
+        # item accessors
+        lines += [f"{item} {name}_load({name} q, uint i) {{", f"    {item} item;"]
+        for field, t, length in fields:
+            if length is None:
+                lines.append(f"    item.{field} = {name}_get_{field}(q, i);")
+            else:
+                lines += [
+                    f"    for (uint j = 0; j < {length}; ++j)",
+                    f"        item.{field}[j] = {name}_get_{field}(q, i, j);",
+                ]
+        lines += ["    return item;", "}"]
+        lines.append(f"void {name}_store({name} q, uint i, {item} item) {{")
+        flags = []
+        for field, t, length in fields:
+            if field in self._bits:
+                # write all flags at once
+                isSet = f"item.{field}" if t == "bool" else f"item.{field} != 0"
+                flags.append(f"(({isSet}) ? 1u << {self._bits[field]} : 0u)")
+            elif length is None:
+                lines.append(f"    {name}_set_{field}(q, i, item.{field});")
+            else:
+                lines += [
+                    f"    for (uint j = 0; j < {length}; ++j)",
+                    f"        {name}_set_{field}(q, i, j, item.{field}[j]);",
+                ]
+        if flags:
+            lines.append(f"    q.{self._flagsName}[i] = " + " | ".join(flags) + ";")
+        lines += ["}", ""]
+
+        return "\n".join(lines)
+
+    def __eq__(self, other: object) -> bool:
+        if not isinstance(other, QueueLayout):
+            return NotImplemented
+        return (
+            self._item is other._item
+            and self._encodings == other._encodings
+            and self._flagsName == other._flagsName
+        )
+
+    def __hash__(self) -> int:
+        return hash((self._item, self._flagsName, tuple(self._encodings.items())))
+
+    def __repr__(self) -> str:
+        return f"QueueLayout: {self._item.__name__} {self._encodings}"
+
+
+def _splitLayout(
+    item: Union[Type[Structure], QueueLayout]
+) -> Tuple[Type[Structure], Optional[QueueLayout]]:
+    """Returns the item and the optional layout describing its storage"""
+    if isinstance(item, QueueLayout):
+        return item.item, item
+    return item, None
+
+
+def _storageOf(item: Union[Type[Structure], QueueLayout]) -> Type[Structure]:
+    """Returns the structure describing the item as it is stored in memory"""
+    return item.storage if isinstance(item, QueueLayout) else item
 
 
 class QueueView:
@@ -33,9 +445,9 @@ class QueueView:
     ----------
     data: int
         address of the memory the view should point at
-    item: Structure
+    item: Structure | QueueLayout
         Structure describing a single item. Used internally to create a
-        structure of arrays.
+        structure of arrays. Pass a QueueLayout for packed items.
     capacity: int
         Maximum number of items the queue can hold
     skipCounter: bool, default=False
@@ -47,6 +459,10 @@ class QueueView:
     ----
     Manipulating data in the queue does not update the counter, which is zero
     right after initialization.
+
+    Fields using a packed encoding are returned as decoded copies. Assign to
+    them as a whole, e.g. `view["x"] = values`, or via `assign` instead of
+    writing into the returned array.
     """
 
     Counter = c_uint32
@@ -55,14 +471,14 @@ class QueueView:
     def __init__(
         self,
         data: int,
-        item: Type[Structure],
+        item: Union[Type[Structure], QueueLayout],
         capacity: int,
         *,
         skipCounter: bool = False,
         header: Optional[Type[Structure]] = None,
     ) -> None:
         # store item type
-        self._item = item
+        self._item, self._layout = _splitLayout(item)
         self._capacity = capacity
         self._counter = None
         self._header = None
@@ -76,33 +492,26 @@ class QueueView:
             data += sizeof(self.Counter)
 
         # create SoA and use it to create data access
-        class SoA(Structure):
-            _fields_ = [
-                (
-                    (name, t._type_ * capacity * t._length_)  # handle arrays
-                    if hasattr(t, "_length_")  # check if array
-                    else (name, t * capacity)
-                )  # handle scalar
-                for name, t in item._fields_  # iterate over all fields
-            ]
-
-        self._data = SoA.from_address(data)
-        # create arrays for each field
+        storage = _storageOf(item)
+        self._data = _createSoA(storage, capacity).from_address(data)
+        # create arrays for each column
         self._fields = {
             # use transpose to align the first index on both scalar and arrays
             # i.e. each array element is treated as its own field from the
             # perspective of the memory
             name: as_array(getattr(self._data, name)).T
-            for name, _ in item._fields_
+            for name, _ in storage._fields_
         }
         # create set of field names (don't want to expose dict_keys)
-        self._field_names = set(self._fields.keys())
+        self._field_names = {name for name, _ in self._item._fields_}
+        # structured view of the whole block; only created on demand
+        self._array = None
 
     def __len__(self) -> int:
         return self._capacity
 
     def __contains__(self, key: str) -> bool:
-        return key in self._fields
+        return key in self._field_names
 
     def __getitem__(self, key: Any) -> Union[QueueSubView, NDArray]:
         if isinstance(key, (int, ndarray, slice)):
@@ -111,14 +520,27 @@ class QueueView:
             raise KeyError("Unsupported key type")
         if key not in self:
             raise KeyError(f"No field with name {key}")
-        return self._fields[key]
+        if self._layout is None:
+            return self._fields[key]
+        return self._layout.decode(key, self._fields[self._layout.column(key)])
 
     def __setitem__(self, key: str, value: Any) -> None:
         if not isinstance(key, str):
             raise KeyError("Unsupported key type")
+        self.assign(key, value)
+
+    def assign(self, key: str, value: Any, index: Any = slice(None)) -> None:
+        """
+        Writes value into the given items of a field encoding it if needed.
+        Equivalent to `view[key][index] = value` for fields stored as is.
+        """
         if key not in self:
             raise KeyError(f"No field with name {key}")
-        self._fields[key][:] = value
+        if self._layout is None or not self._layout.isEncoded(key):
+            self._fields[key][index] = value
+            return
+        column = self._fields[self._layout.column(key)]
+        column[index] = self._layout.encode(key, column[index], value)
 
     @property
     def capacity(self) -> int:
@@ -160,6 +582,30 @@ class QueueView:
         """Structure describing the items of the queue"""
         return self._item
 
+    @property
+    def layout(self) -> Optional[QueueLayout]:
+        """Layout of packed items. None if items are stored as is"""
+        return self._layout
+
+    @property
+    def dtype(self) -> np.dtype:
+        """Structured numpy dtype of a single item"""
+        return np.dtype(self._item)
+
+    @property
+    def array(self) -> NDArray:
+        """
+        Zero-copy structured numpy array spanning the whole queue data. It is
+        zero dimensional with one field per item field holding all its values,
+        i.e. it mirrors the structure of arrays layout in memory. Unlike the
+        per field access, array fields keep their memory layout and thus have
+        the shape (length, capacity). Packed fields are not decoded.
+        """
+        if self._array is None:
+            self._array = np.frombuffer(self._data, np.dtype(type(self._data)))
+            self._array = self._array.reshape(())
+        return self._array
+
     def __repr__(self) -> str:
         return f"QueueView: {self.item.__name__}[{self.capacity}]"
 
@@ -199,7 +645,15 @@ class QueueSubView:
             raise KeyError("Unsupported key type")
         if key not in self:
             raise KeyError(f"No field with name {key}")
-        self._orig[key][self._mask] = value
+        if isinstance(self._orig, QueueView):
+            self._orig.assign(key, value, self._mask)
+        elif self.layout is not None and self.layout.isEncoded(key):
+            # decoded fields are copies -> write them back as a whole
+            values = self._orig[key]
+            values[self._mask] = value
+            self._orig[key] = values
+        else:
+            self._orig[key][self._mask] = value
 
     @property
     def fields(self) -> Set[str]:
@@ -216,6 +670,16 @@ class QueueSubView:
         """Structure describing the items of the queue"""
         return self._orig.item
 
+    @property
+    def layout(self) -> Optional[QueueLayout]:
+        """Layout of packed items. None if items are stored as is"""
+        return self._orig.layout
+
+    @property
+    def dtype(self) -> np.dtype:
+        """Structured numpy dtype of a single item"""
+        return self._orig.dtype
+
     def __repr__(self) -> str:
         return f"QueueSubView: {self.item.__name__}[{self._count}]"
 
@@ -228,6 +692,20 @@ def dumpQueue(queue: Union[QueueView, QueueSubView]) -> Dict[str, NDArray]:
     return {field: queue[field][: queue.count].copy() for field in queue.fields}
 
 
+def dumpQueueStructured(queue: Union[QueueView, QueueSubView]) -> NDArray:
+    """
+    Creates a structured numpy array containing a copy of the items in the
+    queue using the queue's item as dtype, i.e. an array of structures.
+    """
+    n = queue.count if isinstance(queue, QueueView) else len(queue)
+    if isinstance(queue, QueueView):
+        n = min(n, queue.capacity)
+    result = np.empty(n, np.dtype(queue.item))
+    for field in queue.fields:
+        result[field] = queue[field][:n]
+    return result
+
+
 def updateQueue(
     queue: Union[QueueView, QueueSubView],
     data: Dict[str, NDArray],
@@ -263,7 +741,7 @@ def updateQueue(
             warnings.warn(f'Field "{field}" truncated to queue\'s capacity')
         # store data
         n = min(queue.capacity, len(arr))
-        queue[field][:n] = arr[:n]
+        queue.assign(field, arr[:n], slice(n))
         counts.append(n)
     # check all fields had the same size
     if len(counts) > 0 and not all(c == counts[0] for c in counts):
@@ -274,7 +752,7 @@ def updateQueue(
 
 
 def queueSize(
-    item: Union[Type[Structure], int],
+    item: Union[Type[Structure], QueueLayout, int],
     capacity: int,
     *,
     header: Optional[Type[Structure]] = None,
@@ -285,8 +763,9 @@ def queueSize(
 
     Parameters
     ----------
-    item: Structure | int
-        Either a Structure describing a single item or the size of it
+    item: Structure | QueueLayout | int
+        Either a Structure or QueueLayout describing a single item or the
+        size of it
     capacity: int
         Maximum number of items the queue can hold
     header: Structure | None, default = None
@@ -294,7 +773,7 @@ def queueSize(
     skipCounter: bool, default=False
         True, if the queue should not contain a counter
     """
-    itemSize = item if isinstance(item, int) else sizeof(item)
+    itemSize = item if isinstance(item, int) else sizeof(_storageOf(item))
     size = itemSize * capacity
     if header is not None:
         size += sizeof(header)
@@ -306,7 +785,7 @@ def queueSize(
 
 def as_queue(
     buffer: Buffer,
-    item: Type[Structure],
+    item: Union[Type[Structure], QueueLayout],
     *,
     offset: int = 0,
     size: Optional[int] = None,
@@ -320,8 +799,8 @@ def as_queue(
     ----------
     buffer: Buffer
         Buffer containing the Queue
-    item: Structure
-        Structure describing a single item
+    item: Structure | QueueLayout
+        Structure or layout describing a single item
     offset: int, default=0
         Offset in bytes into the buffer the view should start at
     size: int | None, default=None
@@ -344,7 +823,7 @@ def as_queue(
         size -= sizeof(header)
     if not skipCounter:
         size -= sizeof(QueueView.Counter)
-    item_size = sizeof(item)
+    item_size = sizeof(_storageOf(item))
     if size < 0 or size % item_size:
         raise ValueError("The size of the buffer does not match any queue size!")
     capacity = size // item_size
@@ -360,8 +839,8 @@ class QueueBuffer(RawBuffer):
 
     Parameters
     ----------
-    item: Structure
-        Structure describing a single item
+    item: Structure | QueueLayout
+        Structure or layout describing a single item
     capacity: int
         Maximum number of items the queue can hold
     header: Structure | None, default=None
@@ -372,7 +851,7 @@ class QueueBuffer(RawBuffer):
 
     def __init__(
         self,
-        item: Type[Structure],
+        item: Union[Type[Structure], QueueLayout],
         capacity: int,
         *,
         header: Optional[Type[Structure]] = None,
@@ -400,6 +879,11 @@ class QueueBuffer(RawBuffer):
         """Structure describing the items of the queue"""
         return self.view.item
 
+    @property
+    def layout(self) -> Optional[QueueLayout]:
+        """Layout of packed items. None if items are stored as is"""
+        return self.view.layout
+
     @property
     def view(self) -> QueueView:
         """View of the queue stored inside this buffer"""
@@ -416,8 +900,8 @@ class QueueTensor(ByteTensor):
 
     Parameters
     ----------
-    item: Structure
-        Structure describing a single item
+    item: Structure | QueueLayout
+        Structure or layout describing a single item
     capacity: int
         Maximum number of items the queue can hold
     header: Structure | None, default=None
@@ -428,7 +912,7 @@ class QueueTensor(ByteTensor):
 
     def __init__(
         self,
-        item: Type[Structure],
+        item: Union[Type[Structure], QueueLayout],
         capacity: int,
         *,
         header: Optional[Type[Structure]] = None,
@@ -437,7 +921,7 @@ class QueueTensor(ByteTensor):
         super().__init__(
             queueSize(item, capacity, header=header, skipCounter=skipCounter)
         )
-        self._item = item
+        self._item, self._layout = _splitLayout(item)
         self._capacity = capacity
         self._header = header
         self._hasCounter = not skipCounter
@@ -462,6 +946,34 @@ class QueueTensor(ByteTensor):
         """Structure describing the items of the queue"""
         return self._item
 
+    @property
+    def layout(self) -> Optional[QueueLayout]:
+        """Layout of packed items. None if items are stored as is"""
+        return self._layout
+
+    def glsl(self, name: Optional[str] = None, *, header: Optional[str] = None) -> str:
+        """
+        Generates GLSL code declaring this queue as buffer reference together
+        with accessors for its items. See `QueueLayout.glsl`.
+
+        Parameters
+        ----------
+        name: str | None, default=None
+            Name of the buffer reference type. Defaults to the item's name
+            followed by "Queue".
+        header: str | None, default=None
+            Name of the GLSL struct used as header. Defaults to the name of the
+            header's Structure. Ignored if there is no header.
+        """
+        layout = self._layout if self._layout is not None else QueueLayout(self._item)
+        if self._header is None:
+            header = None
+        elif header is None:
+            header = self._header.__name__
+        return layout.glsl(
+            self._capacity, name, header=header, skipCounter=not self._hasCounter
+        )
+
     def __repr__(self) -> str:
         name, cap = self.item.__name__, self.capacity
         return f"QueueBuffer: {name}[{cap}] ({printSize(self.size_bytes)})"
@@ -486,15 +998,667 @@ def clearQueue(
     return clearTensor(queue, size=sizeof(QueueView.Counter), offset=offset)
 
 
+def _queueColumns(queue: QueueTensor) -> List[Tuple[int, int]]:
+    """Returns offset and stride of each column of the queue's items"""
+    offset = 0 if queue.header is None else sizeof(queue.header)
+    offset += sizeof(QueueView.Counter) if queue.hasCounter else 0
+    storage = _storageOf(queue.layout or queue.item)
+    soa = _createSoA(storage, queue.capacity)
+    columns = []
+    for name, t in storage._fields_:
+        fieldOffset = offset + getattr(soa, name).offset
+        # each element of an array field is its own column
+        if hasattr(t, "_length_"):
+            stride = sizeof(t._type_)
+            columns += [
+                (fieldOffset + i * stride * queue.capacity, stride)
+                for i in range(t._length_)
+            ]
+        else:
+            columns.append((fieldOffset, sizeof(t)))
+    return columns
+
+
+def compactQueue(
+    primitives: Primitives,
+    src: QueueTensor,
+    dst: QueueTensor,
+    flags: Tensor,
+    *,
+    count: Optional[int] = None,
+) -> Command:
+    """
+    Returns a command moving each item of src whose flag is non zero into dst
+    while preserving their order, e.g. to drop items rejected by a filter.
+    Updates the counter of dst if present.
+
+    Parameters
+    ----------
+    primitives: Primitives
+        Library running the compaction
+    src: QueueTensor
+        Queue holding the items to compact
+    dst: QueueTensor
+        Queue receiving the kept items. Must use the same item type and
+        layout.
+    flags: Tensor
+        Tensor holding an uint32 flag per item of src
+    count: int | None, default=None
+        Number of items to process. Defaults to the capacity of src or the
+        number of flags whichever is smaller.
+
+    Note
+    ----
+    The count of src is only known on the device. Flags of items past it must
+    therefore be zero.
+    """
+    if src.item is not dst.item or src.layout != dst.layout:
+        raise ValueError("Both queues must use the same item type!")
+    if count is None:
+        count = min(src.capacity, flags.size_bytes // 4)
+    if count > src.capacity or count > dst.capacity:
+        raise ValueError("count exceeds the queue's capacity!")
+
+    columns = [
+        (srcOffset, dstOffset, stride)
+        for (srcOffset, stride), (dstOffset, _) in zip(
+            _queueColumns(src), _queueColumns(dst)
+        )
+    ]
+
+    countTensor = dst if dst.hasCounter else None
+    countOffset = 0 if dst.header is None else sizeof(dst.header)
+    return primitives.compact(
+        flags,
+        src,
+        dst,
+        columns,
+        count=count,
+        countTensor=countTensor,
+        countOffset=countOffset,
+    )
+
+
+_SORT_KEY_TYPES = {
+    c_int32: SortKeyType.INT32,
+    c_uint32: SortKeyType.UINT32,
+    c_float: SortKeyType.FLOAT32,
+    c_int64: SortKeyType.INT64,
+    c_uint64: SortKeyType.UINT64,
+    c_double: SortKeyType.FLOAT64,
+}
+
+
+def sortQueue(
+    primitives: Primitives,
+    src: QueueTensor,
+    dst: QueueTensor,
+    key: str,
+    *,
+    count: Optional[int] = None,
+) -> Command:
+    """
+    Returns a command moving the items of src into dst sorted by the given
+    field, e.g. by detector id before accumulating. The sort is stable. If both
+    queues have a counter, only counted items get sorted and the count is
+    copied into dst.
+
+    Parameters
+    ----------
+    primitives: Primitives
+        Library running the sort
+    src: QueueTensor
+        Queue holding the items to sort
+    dst: QueueTensor
+        Queue receiving the sorted items. Must use the same item type and
+        layout.
+    key: str
+        Name of the scalar field to sort by. Must be a 32 or 64 bit integer or
+        floating point number stored without packed encoding.
+    count: int | None, default=None
+        Maximum number of items to sort. Defaults to the capacity of src.
+    """
+    if src.item is not dst.item or src.layout != dst.layout:
+        raise ValueError("Both queues must use the same item type!")
+    storage = _storageOf(src.layout or src.item)
+    fields = dict(storage._fields_)
+    if key not in dict(src.item._fields_):
+        raise ValueError(f"Item has no field {key}!")
+    if src.layout is not None and src.layout.isEncoded(key):
+        raise ValueError(f"Field {key} cannot be used as sort key!")
+    if fields[key] not in _SORT_KEY_TYPES:
+        raise ValueError(f"Field {key} cannot be used as sort key!")
+    if count is None:
+        count = src.capacity
+    if count > src.capacity or count > dst.capacity:
+        raise ValueError("count exceeds the queue's capacity!")
+
+    srcHeader = 0 if src.header is None else sizeof(src.header)
+    dstHeader = 0 if dst.header is None else sizeof(dst.header)
+    countOffset = None
+    if src.hasCounter and dst.hasCounter:
+        if srcHeader != dstHeader:
+            raise ValueError("Both queues must use the same layout!")
+        countOffset = srcHeader
+
+    srcColumns = _queueColumns(src)
+    names = [
+        name
+        for name, t in storage._fields_
+        for _ in range(t._length_ if hasattr(t, "_length_") else 1)
+    ]
+    keyOffset = srcColumns[names.index(key)][0]
+    columns = [
+        (srcOffset, dstOffset, stride)
+        for (srcOffset, stride), (dstOffset, _) in zip(srcColumns, _queueColumns(dst))
+    ]
+    return primitives.sortColumns(
+        src,
+        dst,
+        _SORT_KEY_TYPES[fields[key]],
+        keyOffset,
+        columns,
+        count,
+        countOffset=countOffset,
+    )
+
+
+QUEUE_FILE_MAGIC = b"HPQUEUE\x01"
+"""Magic bytes marking the start and end of a chunked queue file"""
+
+DEFAULT_CHUNK_SIZE = 1 << 20
+"""Default maximum number of items per chunk in a queue file"""
+
+
+def _getCodec(
+    codec: str, level: Optional[int]
+) -> Tuple[Callable[[bytes], bytes], Callable[[bytes, int], bytes]]:
+    """Returns functions for compressing and decompressing chunks"""
+    if codec == "none":
+        return (lambda data: data, lambda data, size: data)
+    elif codec == "zlib":
+        lvl = zlib.Z_DEFAULT_COMPRESSION if level is None else level
+        return (lambda data: zlib.compress(data, lvl), lambda data, size: zlib.decompress(data))
+    elif codec == "zstd":
+        import zstandard
+
+        lvl = 3 if level is None else level
+        return (
+            lambda data: zstandard.ZstdCompressor(level=lvl).compress(data),
+            lambda data, size: zstandard.ZstdDecompressor().decompress(
+                data, max_output_size=size
+            ),
+        )
+    elif codec == "lz4":
+        import lz4.frame
+
+        lvl = 0 if level is None else level
+        return (
+            lambda data: lz4.frame.compress(data, compression_level=lvl),
+            lambda data, size: lz4.frame.decompress(data),
+        )
+    else:
+        raise ValueError(f'Unknown codec "{codec}"!')
+
+
+def _fieldLayout(item: Type[Structure]) -> Dict[str, Tuple[np.dtype, Tuple[int, ...]]]:
+    """Returns the element type and shape of each field of a queue item"""
+    layout = {}
+    for name, t in item._fields_:
+        dtype = np.dtype(t)
+        layout[name] = (dtype.base, dtype.shape)
+    return layout
+
+
+class QueueWriter:
+    """
+    Writes queues into a chunked columnar file. Each call to `write` appends
+    items split into chunks of at most `chunkSize` items, with each field of a
+    chunk stored and compressed on its own in parallel. This allows to stream
+    queues of arbitrary size, e.g. straight out of a `QueueBuffer` after each
+    batch, without collecting all items in memory first. The index describing
+    the chunks is written on `close`.
+
+    Parameters
+    ----------
+    file: str | bytes | PathLike | BinaryIO
+        Either a path-like object specifying the path to the file or a binary
+        stream the data is written into.
+    item: Structure
+        Structure describing a single item
+    header: Structure | bytes | None, default=None
+        Optional header stored alongside the items
+    codec: "zlib" | "zstd" | "lz4" | "none", default="zlib"
+        Compression applied to each chunk. "zstd" and "lz4" require the
+        zstandard and lz4 packages respectively. "none" stores the raw data,
+        which can be memory mapped by `QueueReader`.
+    level: int | None, default=None
+        Compression level. Uses the codec's default if None.
+    chunkSize: int, default=DEFAULT_CHUNK_SIZE
+        Maximum number of items per chunk
+    threads: int, default=0
+        Number of threads used for compression. Zero uses all cores.
+    append: bool, default=False
+        If True and file is a path to an existing queue file, appends to it
+        instead of overwriting it. The item, codec and chunk size must match.
+    """
+
+    def __init__(
+        self,
+        file: Union[str, bytes, PathLike, BinaryIO],
+        item: Type[Structure],
+        *,
+        header: Union[Structure, bytes, None] = None,
+        codec: str = "zlib",
+        level: Optional[int] = None,
+        chunkSize: int = DEFAULT_CHUNK_SIZE,
+        threads: int = 0,
+        append: bool = False,
+    ) -> None:
+        if chunkSize <= 0:
+            raise ValueError("chunkSize must be positive!")
+        self._item = item
+        self._layout = _fieldLayout(item)
+        self._codec = codec
+        self._compress, _ = _getCodec(codec, level)
+        self._chunkSize = chunkSize
+        self._header = None if header is None else bytes(header)
+        self._chunks: List[Dict[str, Any]] = []
+        self._count = 0
+        self._threads = threads if threads > 0 else (os.cpu_count() or 1)
+        self._executor = ThreadPoolExecutor(self._threads)
+        self._stack = ExitStack()
+
+        isPath = isinstance(file, (str, bytes, PathLike))
+        if append and isPath and os.path.exists(file):
+            self._file = self._stack.enter_context(open(file, "r+b"))
+            self._base = 0
+            index, indexStart = _readIndex(self._file, self._base)
+            if (
+                index["codec"] != codec
+                or index["chunkSize"] != chunkSize
+                or [f[0] for f in index["fields"]] != list(self._layout)
+            ):
+                self._executor.shutdown()
+                self._stack.close()
+                raise ValueError("Cannot append to a queue file with a different format!")
+            if header is None and index["header"] is not None:
+                self._header = bytes.fromhex(index["header"])
+            self._chunks = index["chunks"]
+            self._count = index["count"]
+            # overwrite the index
+            self._file.seek(indexStart)
+            self._file.truncate()
+            self._pos = indexStart
+        else:
+            if isPath:
+                file = self._stack.enter_context(open(file, "wb"))
+            self._file = file
+            self._base = file.tell()
+            file.write(QUEUE_FILE_MAGIC)
+            self._pos = self._base + len(QUEUE_FILE_MAGIC)
+
+    @property
+    def codec(self) -> str:
+        """Codec used for compressing chunks"""
+        return self._codec
+
+    @property
+    def chunkSize(self) -> int:
+        """Maximum number of items per chunk"""
+        return self._chunkSize
+
+    @property
+    def count(self) -> int:
+        """Total number of items written"""
+        return self._count
+
+    def write(
+        self,
+        data: Union[QueueView, QueueSubView, QueueBuffer, Dict[str, NDArray]],
+        count: Optional[int] = None,
+    ) -> None:
+        """
+        Appends items to the file. Data can be either a queue or a dictionary
+        mapping field names to arrays of the same length.
+
+        Parameters
+        ----------
+        data: QueueView | QueueSubView | QueueBuffer | { field: NDArray }
+            Items to append
+        count: int | None, default=None
+            Number of items to append. If None, uses the queue's count or the
+            length of the arrays.
+        """
+        if isinstance(data, QueueBuffer):
+            data = data.view
+        if isinstance(data, dict):
+            fields = data
+            if count is None:
+                count = min((len(arr) for arr in fields.values()), default=0)
+        else:
+            fields = {name: data[name] for name in data.fields}
+            if count is None:
+                count = (
+                    min(data.count, data.capacity)
+                    if isinstance(data, QueueView)
+                    else len(data)
+                )
+        missing = set(self._layout) - set(fields)
+        if missing:
+            raise ValueError(f"Missing fields: {', '.join(sorted(missing))}")
+
+        # compress a window of chunks in parallel to bound memory usage
+        window = 2 * self._threads
+        starts = list(range(0, count, self._chunkSize))
+        for w in range(0, len(starts), window):
+            pending = []
+            for start in starts[w : w + window]:
+                n = min(self._chunkSize, count - start)
+                futures = {}
+                for name, (dtype, _) in self._layout.items():
+                    chunk = np.ascontiguousarray(fields[name][start : start + n], dtype)
+                    futures[name] = self._executor.submit(self._compress, chunk.tobytes())
+                pending.append((n, futures))
+            for n, futures in pending:
+                entry = {"start": self._count, "count": n, "fields": {}}
+                for name, future in futures.items():
+                    payload = future.result()
+                    self._file.write(payload)
+                    entry["fields"][name] = [self._pos - self._base, len(payload)]
+                    self._pos += len(payload)
+                self._chunks.append(entry)
+                self._count += n
+
+    def close(self) -> None:
+        """Writes the index and closes the file if it was opened by the writer"""
+        if self._file is None:
+            return
+        index = {
+            "version": 1,
+            "item": self._item.__name__,
+            "fields": [
+                [name, dtype.str, list(shape)]
+                for name, (dtype, shape) in self._layout.items()
+            ],
+            "codec": self._codec,
+            "chunkSize": self._chunkSize,
+            "count": self._count,
+            "header": None if self._header is None else self._header.hex(),
+            "chunks": self._chunks,
+        }
+        data = json.dumps(index).encode()
+        self._file.write(data)
+        self._file.write(struct.pack("<Q", len(data)))
+        self._file.write(QUEUE_FILE_MAGIC)
+        self._file.flush()
+        self._executor.shutdown()
+        self._stack.close()
+        self._file = None
+
+    def __enter__(self) -> QueueWriter:
+        return self
+
+    def __exit__(self, *args) -> None:
+        self.close()
+
+
+def _readIndex(file: BinaryIO, base: int) -> Tuple[Dict[str, Any], int]:
+    """Reads the index at the end of a queue file and returns it with its position"""
+    tail = struct.calcsize("<Q") + len(QUEUE_FILE_MAGIC)
+    file.seek(0, os.SEEK_END)
+    end = file.tell()
+    if end - base < len(QUEUE_FILE_MAGIC) + tail:
+        raise ValueError("File is not a valid queue file!")
+    file.seek(end - tail)
+    footer = file.read(tail)
+    if footer[-len(QUEUE_FILE_MAGIC) :] != QUEUE_FILE_MAGIC:
+        raise ValueError("File is not a valid queue file or was not closed properly!")
+    (size,) = struct.unpack("<Q", footer[: -len(QUEUE_FILE_MAGIC)])
+    indexStart = end - tail - size
+    file.seek(indexStart)
+    return json.loads(file.read(size)), indexStart
+
+
+class QueueReader:
+    """
+    Reads queues from a chunked columnar file created by `QueueWriter`.
+    Supports reading only a range of items and streaming the data chunk by
+    chunk. Chunks are decompressed in parallel.
+
+    Parameters
+    ----------
+    file: str | bytes | PathLike | BinaryIO
+        Either a path-like object specifying the path to the file or a seekable
+        binary stream containing the data.
+    threads: int, default=0
+        Number of threads used for decompression. Zero uses all cores.
+    mmap: bool, default=True
+        Whether to memory map chunks of uncompressed files instead of reading
+        them. Only applies if file is a path. Mapped arrays are read only.
+    """
+
+    def __init__(
+        self,
+        file: Union[str, bytes, PathLike, BinaryIO],
+        *,
+        threads: int = 0,
+        mmap: bool = True,
+    ) -> None:
+        self._stack = ExitStack()
+        self._path = None
+        if isinstance(file, (str, bytes, PathLike)):
+            self._path = file
+            file = self._stack.enter_context(open(file, "rb"))
+        self._file = file
+        self._base = file.tell()
+        if file.read(len(QUEUE_FILE_MAGIC)) != QUEUE_FILE_MAGIC:
+            self._stack.close()
+            raise ValueError("File is not a valid queue file!")
+        self._index, _ = _readIndex(file, self._base)
+        self._layout = {
+            name: (np.dtype(dtype), tuple(shape))
+            for name, dtype, shape in self._index["fields"]
+        }
+        self._chunks = self._index["chunks"]
+        self._decompress = _getCodec(self.codec, None)[1]
+        self._mmap = mmap and self._path is not None and self.codec == "none"
+        self._threads = threads if threads > 0 else (os.cpu_count() or 1)
+        self._executor = ThreadPoolExecutor(self._threads)
+
+    @property
+    def codec(self) -> str:
+        """Codec used for compressing chunks"""
+        return self._index["codec"]
+
+    @property
+    def chunkSize(self) -> int:
+        """Maximum number of items per chunk"""
+        return self._index["chunkSize"]
+
+    @property
+    def count(self) -> int:
+        """Total number of items stored"""
+        return self._index["count"]
+
+    def __len__(self) -> int:
+        return self.count
+
+    @property
+    def fields(self) -> Set[str]:
+        """Set of field names"""
+        return set(self._layout)
+
+    @property
+    def header(self) -> Optional[bytes]:
+        """Raw bytes of the stored header. None if no header was stored"""
+        header = self._index["header"]
+        return None if header is None else bytes.fromhex(header)
+
+    def _readField(self, chunk: Dict[str, Any], name: str) -> NDArray:
+        """Reads a single field of the given chunk"""
+        dtype, shape = self._layout[name]
+        offset, size = chunk["fields"][name]
+        shape = (chunk["count"],) + shape
+        if self._mmap:
+            return np.memmap(
+                self._path, dtype, "r", offset=self._base + offset, shape=shape
+            )
+        # reading is serialized, decompression runs in parallel
+        self._file.seek(self._base + offset)
+        data = self._file.read(size)
+        return self._executor.submit(self._decompress, data, dtype.itemsize * int(np.prod(shape)))
+
+    def _finish(self, chunk: Dict[str, Any], name: str, data: Any) -> NDArray:
+        """Turns the result of _readField into an array"""
+        if isinstance(data, np.ndarray):
+            return data
+        dtype, shape = self._layout[name]
+        return np.frombuffer(data.result(), dtype).reshape((chunk["count"],) + shape)
+
+    def iterChunks(
+        self,
+        fields: Optional[Iterable[str]] = None,
+        start: int = 0,
+        stop: Optional[int] = None,
+    ) -> Iterator[Tuple[int, Dict[str, NDArray]]]:
+        """
+        Iterates over the chunks overlapping the given range of items, yielding
+        the position of the first item and the data of the requested fields
+        trimmed to the range. Decompresses the next chunks in the background.
+        """
+        names = list(self._layout) if fields is None else list(fields)
+        for name in names:
+            if name not in self._layout:
+                raise KeyError(f"No field with name {name}")
+        stop = self.count if stop is None else min(stop, self.count)
+        chunks = [
+            c for c in self._chunks if c["start"] < stop and c["start"] + c["count"] > start
+        ]
+        window = 2 * self._threads
+        for w in range(0, len(chunks), window):
+            pending = [
+                (c, {name: self._readField(c, name) for name in names})
+                for c in chunks[w : w + window]
+            ]
+            for chunk, data in pending:
+                lo = max(start - chunk["start"], 0)
+                hi = min(stop - chunk["start"], chunk["count"])
+                yield chunk["start"] + lo, {
+                    name: self._finish(chunk, name, d)[lo:hi] for name, d in data.items()
+                }
+
+    def read(
+        self,
+        fields: Optional[Iterable[str]] = None,
+        start: int = 0,
+        stop: Optional[int] = None,
+    ) -> Dict[str, NDArray]:
+        """
+        Reads the given range of items of the requested fields. Reads all
+        fields if fields is None.
+        """
+        parts: Dict[str, List[NDArray]] = {}
+        for _, data in self.iterChunks(fields, start, stop):
+            for name, arr in data.items():
+                parts.setdefault(name, []).append(arr)
+        names = list(self._layout) if fields is None else list(fields)
+        result = {}
+        for name in names:
+            dtype, shape = self._layout[name]
+            chunks = parts.get(name, [])
+            if len(chunks) == 1:
+                result[name] = chunks[0]
+            elif chunks:
+                result[name] = np.concatenate(chunks)
+            else:
+                result[name] = np.empty((0,) + shape, dtype)
+        return result
+
+    def readInto(
+        self,
+        queue: Union[QueueView, QueueSubView, QueueBuffer],
+        start: int = 0,
+        stop: Optional[int] = None,
+        *,
+        offset: int = 0,
+        updateCount: bool = True,
+    ) -> int:
+        """
+        Streams the given range of items chunk by chunk into the queue starting
+        at the given offset without assembling them in memory first. Fields
+        unknown to the queue are skipped. Returns the number of items read.
+
+        Parameters
+        ----------
+        queue: QueueView | QueueSubView | QueueBuffer
+            Queue to write the items into
+        start: int, default=0
+            Position of the first item to read
+        stop: int | None, default=None
+            Position after the last item to read. Reads until the end if None.
+        offset: int, default=0
+            Position in the queue to write the first item to
+        updateCount: bool, default=True
+            Whether to update the queue's count. Ignored if queue has no counter.
+        """
+        if isinstance(queue, QueueBuffer):
+            queue = queue.view
+        fields = [name for name in self._layout if name in queue.fields]
+        for name in self._layout:
+            if name not in queue.fields:
+                warnings.warn(f'Skipping unknown field "{name}"')
+        capacity = queue.capacity if isinstance(queue, QueueView) else len(queue)
+        stop = self.count if stop is None else min(stop, self.count)
+        if stop - start > capacity - offset:
+            warnings.warn("Items truncated to queue's capacity")
+            stop = start + capacity - offset
+        if isinstance(queue, QueueSubView):
+            # masked fields are copies -> write them back as a whole
+            n = 0
+            for name, arr in self.read(fields, start, stop).items():
+                values = queue[name]
+                values[offset : offset + len(arr)] = arr
+                queue[name] = values
+                n = len(arr)
+            return n
+
+        n = 0
+        for pos, data in self.iterChunks(fields, start, stop):
+            for name, arr in data.items():
+                begin = offset + pos - start
+                queue.assign(name, arr, slice(begin, begin + len(arr)))
+                n = pos - start + len(arr)
+        if isinstance(queue, QueueView) and queue.hasCounter and updateCount:
+            queue.count = offset + n
+        return n
+
+    def close(self) -> None:
+        """Closes the file if it was opened by the reader"""
+        self._executor.shutdown()
+        self._stack.close()
+
+    def __enter__(self) -> QueueReader:
+        return self
+
+    def __exit__(self, *args) -> None:
+        self.close()
+
+
 def saveQueue(
     file: Union[str, bytes, PathLike, BinaryIO],
     queue: Union[QueueView, QueueSubView, QueueBuffer],
     *,
     compressed: bool = True,
     skipHeader: bool = False,
+    codec: Optional[str] = None,
+    chunkSize: int = DEFAULT_CHUNK_SIZE,
+    threads: int = 0,
 ) -> None:
     """
-    Saves the given queue under the given path or into the given stream.
+    Saves the given queue under the given path or into the given stream using
+    the chunked format of `QueueWriter`. Only the items up to the queue's count
+    are saved.
 
     Parameters
     ----------
@@ -504,30 +1668,32 @@ def saveQueue(
     queue: QueueView | QueueSubView | QueueBuffer
         Buffer to save
     compressed: bool = True
-        Whether to compress the data.
+        Whether to compress the data. Ignored if codec is given.
     skipHeader: bool = False
         Whether to skip the header during serialization.
         Ignored if there is no header.
+    codec: "zlib" | "zstd" | "lz4" | "none" | None, default=None
+        Compression applied to each chunk. If None, uses "zlib" or "none"
+        depending on compressed.
+    chunkSize: int, default=DEFAULT_CHUNK_SIZE
+        Maximum number of items per chunk
+    threads: int, default=0
+        Number of threads used for compression. Zero uses all cores.
     """
     if isinstance(queue, QueueBuffer):
         queue = queue.view
-    # save guard for open files
-    with ExitStack() as stack:
-        # checking for IO is a bit weird so we check for path like and just
-        # treat it like a file otherwise
-        if isinstance(file, (str, bytes, PathLike)):
-            file = stack.enter_context(open(file, "wb"))
-
-        # write header if necessary
-        if queue.header is not None and not skipHeader:
-            file.write(bytes(queue.header))
-
-        # collect field and save them
-        data = {field: queue[field] for field in queue.fields}
-        if compressed:
-            np.savez_compressed(file, **data)
-        else:
-            np.savez(file, **data)
+    if codec is None:
+        codec = "zlib" if compressed else "none"
+    header = None if skipHeader else queue.header
+    with QueueWriter(
+        file,
+        queue.item,
+        header=header,
+        codec=codec,
+        chunkSize=chunkSize,
+        threads=threads,
+    ) as writer:
+        writer.write(queue)
 
 
 def loadQueue(
@@ -536,9 +1702,11 @@ def loadQueue(
     *,
     skipHeader: bool = False,
     updateCount: bool = True,
+    threads: int = 0,
 ) -> None:
     """
-    Updates the given queue with the data from the given file or path.
+    Updates the given queue with the data from the given file or path. Also
+    supports files written by earlier versions storing the whole queue.
 
     Parameters
     ----------
@@ -547,10 +1715,12 @@ def loadQueue(
         itself containing the data to be loaded.
     queue: QueueView | QueueSubview | QueueBuffer
         Queue the data will be loaded into
-    compressed: bool = True
-        Whether to compress the data.
+    skipHeader: bool = False
+        Whether to skip loading the header. Ignored if there is no header.
     updateCount: bool = True
         Whether to update the queue's count. Ignored if queue has no counter.
+    threads: int, default=0
+        Number of threads used for decompression. Zero uses all cores.
     """
     if isinstance(queue, QueueBuffer):
         queue = queue.view
@@ -561,6 +1731,19 @@ def loadQueue(
         if isinstance(file, (str, bytes, PathLike)):
             file = stack.enter_context(open(file, "rb"))
 
+        start = file.tell()
+        if file.read(len(QUEUE_FILE_MAGIC)) == QUEUE_FILE_MAGIC:
+            file.seek(start)
+            reader = stack.enter_context(QueueReader(file, threads=threads))
+            header = reader.header
+            if queue.header is not None and not skipHeader and header is not None:
+                # looks quirky, but essentially just a copying new data into header
+                pointer(queue.header)[0] = type(queue.header).from_buffer_copy(header)
+            reader.readInto(queue, updateCount=updateCount)
+            return
+
+        # legacy format: raw header followed by npz archive
+        file.seek(start)
         # read header if necessary
         if queue.header is not None and not skipHeader:
             data = file.read(sizeof(queue.header))
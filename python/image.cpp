@@ -1,9 +1,20 @@
 #include <nanobind/nanobind.h>
 #include <nanobind/ndarray.h>
+#include <nanobind/stl/filesystem.h>
+#include <nanobind/stl/optional.h>
 #include <nanobind/stl/string_view.h>
+#include <nanobind/stl/tuple.h>
+#include <nanobind/stl/vector.h>
 
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <optional>
 #include <string_view>
+#include <tuple>
 #include <unordered_map>
+#include <vector>
 
 #include <hephaistos/image.hpp>
 #include <hephaistos/program.hpp>
@@ -18,6 +29,18 @@ using namespace nb::literals;
 
 namespace {
 
+//sparse tiles as (x, y, z, level)
+using Tile = std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>;
+
+hp::SparseTile toSparseTile(const Tile& tile) {
+    return { std::get<0>(tile), std::get<1>(tile), std::get<2>(tile), std::get<3>(tile) };
+}
+std::vector<hp::SparseTile> toSparseTiles(const std::vector<Tile>& tiles) {
+    std::vector<hp::SparseTile> result(tiles.size());
+    std::transform(tiles.begin(), tiles.end(), result.begin(), toSparseTile);
+    return result;
+}
+
 bool processBool(const char* value) {
     static std::unordered_map<std::string_view, bool> map = {
         { "True"sv,  true },
@@ -46,6 +69,20 @@ hp::Filter processFilter(const char* value) {
         throw std::runtime_error("Could not parse filter!");
 }
 
+hp::MipmapMode processMipmapMode(const char* value) {
+    static std::unordered_map<std::string_view, hp::MipmapMode> map = {
+        { "nearest"sv, hp::MipmapMode::NEAREST },
+        { "n"sv,       hp::MipmapMode::NEAREST },
+        { "linear"sv,  hp::MipmapMode::LINEAR },
+        { "l"sv,       hp::MipmapMode::LINEAR }
+    };
+
+    if (auto it = map.find(std::string_view(value)); it != map.end())
+        return it->second;
+    else
+        throw std::runtime_error("Could not parse mipmap mode!");
+}
+
 hp::AddressMode processMode(const char* value) {
     static std::unordered_map<std::string_view, hp::AddressMode> map = {
         { "repeat"sv,              hp::AddressMode::REPEAT },
@@ -71,7 +108,11 @@ hp::Sampler buildSampler(const nb::kwargs& kwargs) {
         { "norm"sv, 2 },
         { "modeU"sv, 3 },
         { "modeV"sv, 4 },
-        { "modeW"sv, 5 }
+        { "modeW"sv, 5 },
+        { "mipmap"sv, 6 },
+        { "lodBias"sv, 7 },
+        { "minLod"sv, 8 },
+        { "maxLod"sv, 9 }
     };
 
     hp::Sampler sampler{};
@@ -104,6 +145,18 @@ hp::Sampler buildSampler(const nb::kwargs& kwargs) {
         case 5: //modeW
             sampler.addressModeW = processMode(value);
             break;
+        case 6: //mipmap
+            sampler.mipmapMode = processMipmapMode(value);
+            break;
+        case 7: //lodBias
+            sampler.lodBias = std::stof(value);
+            break;
+        case 8: //minLod
+            sampler.minLod = std::stof(value);
+            break;
+        case 9: //maxLod
+            sampler.maxLod = std::stof(value);
+            break;
         }
     }
 
@@ -112,9 +165,27 @@ hp::Sampler buildSampler(const nb::kwargs& kwargs) {
 
 }
 
+//keeps the image buffer alive until it is saved
+struct PendingSave {
+    std::future<void> future;
+    nb::object buffer;
+
+    PendingSave(std::future<void> future, nb::object buffer)
+        : future(std::move(future)), buffer(std::move(buffer))
+    {}
+    PendingSave(PendingSave&&) noexcept = default;
+    ~PendingSave() {
+        if (future.valid()) {
+            nb::gil_scoped_release release;
+            future.wait();
+        }
+    }
+};
+
 //array shape of image buffer: [width, height, 4]
 using image_shape = nb::shape<-1, -1, 4>;
-using image_array = nb::ndarray<uint8_t, nb::numpy, image_shape>;
+//dtype depends on the image buffer's format
+using image_array = nb::ndarray<nb::numpy, image_shape>;
 
 void registerImageModule(nb::module_& m) {
     nb::enum_<hp::ImageFormat>(m, "ImageFormat",
@@ -124,6 +195,7 @@ void registerImageModule(nb::module_& m) {
         .value("R8G8B8A8_UINT",       hp::ImageFormat::R8G8B8A8_UINT)
         .value("R8G8B8A8_SINT",       hp::ImageFormat::R8G8B8A8_SINT)
         .value("R16G16B16A16_UINT",   hp::ImageFormat::R16G16B16A16_UINT)
+        .value("R16G16B16A16_UNORM",  hp::ImageFormat::R16G16B16A16_UNORM)
         .value("R16G16B16A16_SINT",   hp::ImageFormat::R16G16B16A16_SINT)
         .value("R32_UINT",            hp::ImageFormat::R32_UINT)
         .value("R32_SINT",            hp::ImageFormat::R32_SINT)
@@ -134,9 +206,42 @@ void registerImageModule(nb::module_& m) {
         .value("R32G32B32A32_UINT",   hp::ImageFormat::R32G32B32A32_UINT)
         .value("R32G32B32A32_SINT",   hp::ImageFormat::R32G32B32A32_SINT)
         .value("R32G32B32A32_SFLOAT", hp::ImageFormat::R32G32B32A32_SFLOAT)
+        .value("BC1_RGBA_UNORM",      hp::ImageFormat::BC1_RGBA_UNORM)
+        .value("BC3_UNORM",           hp::ImageFormat::BC3_UNORM)
+        .value("BC4_UNORM",           hp::ImageFormat::BC4_UNORM)
+        .value("BC4_SNORM",           hp::ImageFormat::BC4_SNORM)
+        .value("BC5_UNORM",           hp::ImageFormat::BC5_UNORM)
+        .value("BC5_SNORM",           hp::ImageFormat::BC5_SNORM)
+        .value("BC6H_UFLOAT",         hp::ImageFormat::BC6H_UFLOAT)
+        .value("BC6H_SFLOAT",         hp::ImageFormat::BC6H_SFLOAT)
+        .value("BC7_UNORM",           hp::ImageFormat::BC7_UNORM)
+        .value("ETC2_R8G8B8A8_UNORM", hp::ImageFormat::ETC2_R8G8B8A8_UNORM)
+        .value("ASTC_4x4_UNORM",      hp::ImageFormat::ASTC_4x4_UNORM)
         .export_values();
     m.def("getElementSize", &hp::getElementSize, "format"_a,
         "Returns the size of a single channel in bytes");
+    m.def("isCompressed", &hp::isCompressed, "format"_a,
+        "Returns True, if the format is block compressed");
+    m.def("getBlockExtent", &hp::getBlockExtent, "format"_a,
+        "Returns the width and height of a single block in pixels, i.e. 1 for "
+        "uncompressed formats");
+    m.def("getImageSize", &hp::getImageSize,
+        "format"_a, "width"_a, "height"_a = 1, "depth"_a = 1,
+        "Returns the size of an image in bytes in a linear memory layout");
+    m.def("isTextureFormatSupported",
+        [](hp::ImageFormat format) {
+            return hp::isTextureFormatSupported(getCurrentContext(), format);
+        }, "format"_a,
+        "Returns True, if the current context supports textures of the given "
+        "format. Note that this may initialize the context.");
+
+    m.def("isTexelBufferFormatSupported",
+        [](hp::ImageFormat format, bool storage) {
+            return hp::isTexelBufferFormatSupported(getCurrentContext(), format, storage);
+        }, "format"_a, "storage"_a = true,
+        "Returns True, if the current context supports texel buffers of the given "
+        "format. If storage is True, queries support for writing, otherwise for "
+        "read only access. Note that this may initialize the context.");
 
     nb::class_<hp::Image>(m, "Image",
             "Allocates memory on the device using a memory layout it deems "
@@ -150,13 +255,30 @@ void registerImageModule(nb::module_& m) {
             "height: int, default=1\n"
             "    Height of the image in pixels\n"
             "depth: int, default=1\n"
-            "    Depth of the image in pixels\n")
+            "    Depth of the image in pixels\n"
+            "layers: int, default=0\n"
+            "    Number of array layers. Zero creates a plain image. Arrays "
+                "require a depth of one.\n"
+            "hints: None|AllocationHints, default=None\n"
+            "    Optional hints for allocating the image's memory\n")
         .def("__init__",
             [](hp::Image* image, hp::ImageFormat format,
-                uint32_t width, uint32_t height, uint32_t depth)
+                uint32_t width, uint32_t height, uint32_t depth, uint32_t layers,
+                std::optional<hp::AllocationHints> hints)
             {
-                new (image) hp::Image(getCurrentContext(), format, width, height, depth);
-            }, "format"_a, "width"_a, "height"_a = 1, "depth"_a = 1)
+                if (layers && depth != 1)
+                    throw nb::value_error("Array images must have a depth of one!");
+                if (layers) {
+                    new (image) hp::Image(getCurrentContext(), format,
+                        width, height, hp::ArrayLayers{ layers },
+                        hints.value_or(hp::AllocationHints{}));
+                }
+                else {
+                    new (image) hp::Image(getCurrentContext(), format,
+                        width, height, depth, hints.value_or(hp::AllocationHints{}));
+                }
+            }, "format"_a, "width"_a, "height"_a = 1, "depth"_a = 1, "layers"_a = 0,
+            "hints"_a.none() = nb::none())
         .def_prop_ro("width",
             [](const hp::Image& img) -> uint32_t { return img.getWidth(); },
             "With of the image in pixels")
@@ -166,6 +288,9 @@ void registerImageModule(nb::module_& m) {
         .def_prop_ro("depth",
             [](const hp::Image& img) -> uint32_t { return img.getDepth(); },
             "Depth of the image in pixels")
+        .def_prop_ro("layers",
+            [](const hp::Image& img) -> uint32_t { return img.getLayers(); },
+            "Number of array layers. Zero if the image is not an array.")
         .def_prop_ro("format",
             [](const hp::Image& img) -> hp::ImageFormat { return img.getFormat(); },
             "Format of the image")
@@ -179,16 +304,29 @@ void registerImageModule(nb::module_& m) {
                 { img.bindParameter(p.getBinding(b)); },
             "program"_a, "binding"_a,
             "Binds the image to the program at the given binding")
+        .def("bindParameter",
+            [](const hp::Image& img, hp::ParameterSet& p, uint32_t b)
+                { img.bindParameter(p.getBinding(b)); },
+            "set"_a, "binding"_a,
+            "Binds the image to the parameter set at the given binding")
         .def("bindParameter",
             [](const hp::Image& img, hp::Program& p, std::string_view b)
                 { img.bindParameter(p.getBinding(b)); },
             "program"_a, "binding"_a,
-            "Binds the image to the program at the given binding");
+            "Binds the image to the program at the given binding")
+        .def("bindParameter",
+            [](const hp::Image& img, hp::ParameterSet& p, std::string_view b)
+                { img.bindParameter(p.getBinding(b)); },
+            "set"_a, "binding"_a,
+            "Binds the image to the parameter set at the given binding");
     
     nb::class_<hp::Texture>(m, "Texture",
             "Allocates memory on the device using a memory layout it deems "
             "optimal for images and presents it inside programs as texture "
-            "allowing filtered lookups. The filter methods can specified"
+            "allowing filtered lookups. The filter methods can specified. Lookup "
+            "tables, i.e. nearest filtering with unnormalized coordinates, can be "
+            "bound as sampled image, e.g. texture2D, and read via texelFetch using "
+            "GL_EXT_samplerless_texture_functions, skipping the sampler."
             "\n\nParameters\n----------\n"
             "format: ImageFormat\n"
             "    Format of the image\n"
@@ -198,8 +336,21 @@ void registerImageModule(nb::module_& m) {
             "    Height of the image in pixels\n"
             "depth: int, default=1\n"
             "    Depth of the image in pixels\n"
+            "mipLevels: int, default=1\n"
+            "    Number of mip levels. Zero creates the full mip chain\n"
+            "layers: int, default=0\n"
+            "    Number of array layers. Zero creates a plain texture. Arrays "
+                "require a depth of one.\n"
             "filter: 'nearest'|'n'|'linear'|'l', default='linear'\n"
             "    Method used to interpolate between pixels\n"
+            "mipmap: 'nearest'|'n'|'linear'|'l', default='linear'\n"
+            "    Method used to interpolate between mip levels\n"
+            "lodBias: float, default=0.0\n"
+            "    Bias added to the computed level of detail\n"
+            "minLod: float, default=0.0\n"
+            "    Minimum level of detail\n"
+            "maxLod: float, default=1000.0\n"
+            "    Maximum level of detail\n"
             "unnormalized: bool, default=False\n"
             "    If True, use coordinates in pixel space rather than normalized "
                 "ones inside programs\n"
@@ -211,14 +362,24 @@ void registerImageModule(nb::module_& m) {
             "    Method used to handle out of range coordinates in W dimension\n")
         .def("__init__",
             [](hp::Texture* texture, hp::ImageFormat format,
-               uint32_t width, uint32_t height, uint32_t depth, nb::kwargs kwargs)
+               uint32_t width, uint32_t height, uint32_t depth,
+               uint32_t mipLevels, uint32_t layers, nb::kwargs kwargs)
                 {
+                    if (layers && depth != 1)
+                        throw nb::value_error("Array textures must have a depth of one!");
                     auto sampler = buildSampler(kwargs);
-                    new (texture) hp::Texture(getCurrentContext(),
-                        format, width, height, depth, sampler);
+                    if (layers) {
+                        new (texture) hp::Texture(getCurrentContext(),
+                            format, width, height, hp::ArrayLayers{ layers },
+                            sampler, mipLevels);
+                    }
+                    else {
+                        new (texture) hp::Texture(getCurrentContext(),
+                            format, width, height, depth, sampler, mipLevels);
+                    }
                 },
             "format"_a, "width"_a, "height"_a = 1, "depth"_a = 1,
-            "kwargs"_a = nb::kwargs())
+            "mipLevels"_a = 1, "layers"_a = 0, "kwargs"_a = nb::kwargs())
         .def_prop_ro("width",
             [](const hp::Texture& tex) -> uint32_t { return tex.getWidth(); },
             "Width of the texture in pixels")
@@ -231,63 +392,364 @@ void registerImageModule(nb::module_& m) {
         .def_prop_ro("format",
             [](const hp::Texture& tex) -> hp::ImageFormat { return tex.getFormat(); },
             "Format of the texture")
+        .def_prop_ro("mipLevels",
+            [](const hp::Texture& tex) -> uint32_t { return tex.getMipLevels(); },
+            "Number of mip levels of the texture")
+        .def_prop_ro("layers",
+            [](const hp::Texture& tex) -> uint32_t { return tex.getLayers(); },
+            "Number of array layers. Zero if the texture is not an array.")
         .def_prop_ro("size_bytes",
             [](const hp::Texture& tex) -> uint64_t { return tex.size_bytes(); },
             "Size the texture takes in a linear/compact memory layout in bytes. "
             "This can differ from the actual size the texture takes on the device "
             "but can be useful to allocate buffers for transferring the texture.")
+        .def_static("loadFile",
+            [](const char* filename, nb::kwargs kwargs) -> hp::Texture {
+                return hp::Texture::load(getCurrentContext(), filename, buildSampler(kwargs));
+            }, "filename"_a, "kwargs"_a = nb::kwargs(),
+            "Loads a texture including all of its mip levels from a KTX2 or DDS "
+            "file without decompressing it. Keyword arguments configure the "
+            "sampler as in the constructor.")
+        .def_static("loadMemory",
+            [](nb::bytes data, nb::kwargs kwargs) -> hp::Texture {
+                return hp::Texture::load(
+                    getCurrentContext(),
+                    std::span<const std::byte>{
+                        reinterpret_cast<const std::byte*>(data.c_str()),
+                        data.size()
+                    }, buildSampler(kwargs));
+            }, "data"_a, "kwargs"_a = nb::kwargs(),
+            "Loads a texture including all of its mip levels from a KTX2 or DDS "
+            "file stored in memory without decompressing it. Keyword arguments "
+            "configure the sampler as in the constructor.")
         .def("bindParameter",
             [](const hp::Texture& tex, hp::Program& p, uint32_t b)
                 { tex.bindParameter(p.getBinding(b)); },
             "program"_a, "binding"_a,
             "Binds the texture to the program at the given binding")
+        .def("bindParameter",
+            [](const hp::Texture& tex, hp::ParameterSet& p, uint32_t b)
+                { tex.bindParameter(p.getBinding(b)); },
+            "set"_a, "binding"_a,
+            "Binds the texture to the parameter set at the given binding")
         .def("bindParameter",
             [](const hp::Texture& tex, hp::Program& p, std::string_view b)
                 { tex.bindParameter(p.getBinding(b)); },
             "program"_a, "binding"_a,
-            "Binds the texture to the program at the given binding");
+            "Binds the texture to the program at the given binding")
+        .def("bindParameter",
+            [](const hp::Texture& tex, hp::ParameterSet& p, std::string_view b)
+                { tex.bindParameter(p.getBinding(b)); },
+            "set"_a, "binding"_a,
+            "Binds the texture to the parameter set at the given binding");
+
+    m.def("isSparseTextureSupported",
+        []() { return hp::isSparseTextureSupported(getCurrentContext()); },
+        "Returns True, if the current context supports sparse 3D textures. Note "
+        "that this may initialize the context.");
+    m.def("isSparseTextureFormatSupported",
+        [](hp::ImageFormat format) {
+            return hp::isSparseTextureFormatSupported(getCurrentContext(), format);
+        }, "format"_a,
+        "Returns True, if the current context supports sparse textures of the "
+        "given format. Note that this may initialize the context.");
+    nb::class_<hp::SparseTexture, hp::Texture>(m, "SparseTexture",
+            "3D texture reserving its image without backing it by memory. Memory "
+            "is committed in tiles given as (x, y, z, level) in units of tiles, "
+            "while the mip tail is always committed. Programs record the tiles "
+            "their lookups touch via sparseFeedbackMark() declared in the built-in "
+            "header hephaistos/sparse.glsl, which can be read back via "
+            "fetchAccessedTiles()."
+            "\n\nParameters\n----------\n"
+            "format: ImageFormat\n"
+            "    Format of the image\n"
+            "width: int\n"
+            "    Width of the image in pixels\n"
+            "height: int\n"
+            "    Height of the image in pixels\n"
+            "depth: int\n"
+            "    Depth of the image in pixels\n"
+            "mipLevels: int, default=1\n"
+            "    Number of mip levels. Zero creates the full mip chain\n"
+            "kwargs\n"
+            "    Sampler configuration as in Texture\n")
+        .def("__init__",
+            [](hp::SparseTexture* texture, hp::ImageFormat format,
+               uint32_t width, uint32_t height, uint32_t depth,
+               uint32_t mipLevels, nb::kwargs kwargs)
+                {
+                    new (texture) hp::SparseTexture(getCurrentContext(),
+                        format, width, height, depth, buildSampler(kwargs), mipLevels);
+                },
+            "format"_a, "width"_a, "height"_a, "depth"_a,
+            "mipLevels"_a = 1, "kwargs"_a = nb::kwargs())
+        .def_prop_ro("tileWidth", &hp::SparseTexture::getTileWidth,
+            "Width of a tile in texels")
+        .def_prop_ro("tileHeight", &hp::SparseTexture::getTileHeight,
+            "Height of a tile in texels")
+        .def_prop_ro("tileDepth", &hp::SparseTexture::getTileDepth,
+            "Depth of a tile in texels")
+        .def_prop_ro("tileSize", &hp::SparseTexture::getTileSize,
+            "Size in bytes of the memory backing a single tile")
+        .def_prop_ro("tiledLevels", &hp::SparseTexture::getTiledLevels,
+            "Number of mip levels committed in tiles")
+        .def_prop_ro("tileCount", &hp::SparseTexture::getTileCount,
+            "Total number of tiles across all tiled mip levels")
+        .def_prop_ro("size_committed", &hp::SparseTexture::size_committed,
+            "Number of bytes currently committed excluding the mip tail")
+        .def("getTileGrid",
+            [](const hp::SparseTexture& t, uint32_t level) {
+                auto grid = t.getTileGrid(level);
+                return std::make_tuple(grid.x, grid.y, grid.z);
+            }, "level"_a = 0,
+            "Returns the number of tiles of the given mip level as (x, y, z)")
+        .def("isCommitted",
+            [](const hp::SparseTexture& t, const Tile& tile) {
+                return t.isCommitted(toSparseTile(tile));
+            }, "tile"_a,
+            "Returns True, if the given tile is backed by memory")
+        .def("commit",
+            [](hp::SparseTexture& t, const std::vector<Tile>& tiles) {
+                auto sparse = toSparseTiles(tiles);
+                nb::gil_scoped_release release;
+                t.commit(sparse);
+            }, "tiles"_a,
+            "Backs the given tiles with memory. The content of newly committed "
+            "tiles is undefined.")
+        .def("decommit",
+            [](hp::SparseTexture& t, const std::vector<Tile>& tiles) {
+                auto sparse = toSparseTiles(tiles);
+                nb::gil_scoped_release release;
+                t.decommit(sparse);
+            }, "tiles"_a,
+            "Releases the memory backing the given tiles. Work using them must "
+            "have finished.")
+        .def("decommitAll",
+            [](hp::SparseTexture& t) {
+                nb::gil_scoped_release release;
+                t.decommitAll();
+            }, "Releases the memory of all tiles")
+        .def_prop_ro("feedback",
+            [](const hp::SparseTexture& t) {
+                auto feedback = t.getFeedback();
+                return nb::bytes(reinterpret_cast<const char*>(&feedback), sizeof(feedback));
+            },
+            "Location of the access feedback as bytes matching SparseFeedback in "
+            "hephaistos/sparse.glsl, e.g. to pass it as push constant")
+        .def("fetchAccessedTiles",
+            [](hp::SparseTexture& t, bool reset) {
+                std::vector<hp::SparseTile> accessed;
+                {
+                    nb::gil_scoped_release release;
+                    accessed = t.fetchAccessedTiles(reset);
+                }
+                std::vector<Tile> result(accessed.size());
+                std::transform(accessed.begin(), accessed.end(), result.begin(),
+                    [](const hp::SparseTile& tile) {
+                        return Tile{ tile.x, tile.y, tile.z, tile.level };
+                    });
+                return result;
+            }, "reset"_a = true,
+            "Returns the tiles accessed since the feedback was last reset and "
+            "optionally resets it. Work writing to the feedback must have finished.");
+
+    nb::class_<hp::TexelBuffer>(m, "TexelBuffer",
+            "Formatted view of a tensor's memory presented inside programs as "
+            "uniform or storage texel buffer. Reads and writes convert between "
+            "the format and the shader's type in hardware."
+            "\n\nParameters\n----------\n"
+            "tensor: Tensor\n"
+            "    Tensor to create a view of\n"
+            "format: ImageFormat\n"
+            "    Format of the texels. Must not be block compressed.\n"
+            "offset: int, default=0\n"
+            "    Offset into the tensor in bytes. Must be a multiple of "
+                "minTexelBufferOffsetAlignment.\n"
+            "size: int, default=whole_size\n"
+            "    Size of the range in bytes. Defaults to the rest of the tensor.\n")
+        .def(nb::init<const hp::Tensor<std::byte>&, hp::ImageFormat, uint64_t, uint64_t>(),
+            "tensor"_a, "format"_a, "offset"_a = 0, "size"_a = hp::whole_size,
+            nb::keep_alive<1, 2>())
+        .def_prop_ro("format", &hp::TexelBuffer::getFormat, "Format of the texels")
+        .def_prop_ro("offset", &hp::TexelBuffer::offset,
+            "Offset of the range into the tensor in bytes")
+        .def_prop_ro("size", &hp::TexelBuffer::size, "Number of texels in the range")
+        .def_prop_ro("size_bytes", &hp::TexelBuffer::size_bytes,
+            "Size of the range in bytes")
+        .def("bindParameter",
+            [](const hp::TexelBuffer& t, hp::Program& p, uint32_t b)
+                { t.bindParameter(p.getBinding(b)); },
+            "program"_a, "binding"_a,
+            "Binds the texel buffer to the program at the given binding")
+        .def("bindParameter",
+            [](const hp::TexelBuffer& t, hp::ParameterSet& p, uint32_t b)
+                { t.bindParameter(p.getBinding(b)); },
+            "set"_a, "binding"_a,
+            "Binds the texel buffer to the parameter set at the given binding")
+        .def("bindParameter",
+            [](const hp::TexelBuffer& t, hp::Program& p, std::string_view b)
+                { t.bindParameter(p.getBinding(b)); },
+            "program"_a, "binding"_a,
+            "Binds the texel buffer to the program at the given binding")
+        .def("bindParameter",
+            [](const hp::TexelBuffer& t, hp::ParameterSet& p, std::string_view b)
+                { t.bindParameter(p.getBinding(b)); },
+            "set"_a, "binding"_a,
+            "Binds the texel buffer to the parameter set at the given binding");
+
+    nb::enum_<hp::ImageFileFormat>(m, "ImageFileFormat",
+            "File format images are saved in")
+        .value("AUTO", hp::ImageFileFormat::AUTO,
+            "PNG for 8 bit and 16 bit images, Radiance HDR for floating point ones")
+        .value("PNG", hp::ImageFileFormat::PNG,
+            "PNG using the image's bit depth. Supports 8 bit and 16 bit images.")
+        .value("HDR", hp::ImageFileFormat::HDR,
+            "Radiance HDR dropping the alpha channel. Supports floating point images.")
+        .value("PPM", hp::ImageFileFormat::PPM,
+            "Binary PPM dropping the alpha channel. Supports 8 bit and 16 bit images.")
+        .value("QOI", hp::ImageFileFormat::QOI,
+            "Quite OK Image format. Supports 8 bit images.")
+        .value("TIFF", hp::ImageFileFormat::TIFF,
+            "Uncompressed TIFF. Supports all image buffer formats.");
+
+    nb::class_<PendingSave>(m, "PendingSave",
+            "Handle to an image saved in the background. Waits for the save to "
+            "finish when destroyed.")
+        .def("isReady", [](const PendingSave& p) {
+                return !p.future.valid() ||
+                    p.future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            }, "Checks whether the image finished saving")
+        .def("wait", [](PendingSave& p) {
+                if (!p.future.valid())
+                    return;
+                nb::gil_scoped_release release;
+                p.future.get();
+            }, "Blocks until the image finished saving and raises errors occurred "
+            "while saving.");
 
     nb::class_<hp::ImageBuffer, hp::Buffer<std::byte>>(m, "ImageBuffer",
             "Utility class allocating memory on the host side in linear memory "
-            "layout allowing easy manipulating of 2D 32bit RGBA image data that "
+            "layout allowing easy manipulating of 2D RGBA image data that "
             "can later be copied to an image or texture. Provides additional "
             "methods for loading and saving image data from and to disk in "
-            "various file formats."
+            "various file formats. Supports the formats R8G8B8A8_UNORM, "
+            "R16G16B16A16_UNORM and R32G32B32A32_SFLOAT."
             "\n\nParameters\n----------\n"
             "width: int\n"
             "    Width of the image in pixels\n"
             "height: int\n"
-            "    Height of the image in pixels\n")
+            "    Height of the image in pixels\n"
+            "format: ImageFormat, default=ImageFormat.R8G8B8A8_UNORM\n"
+            "    Format of the image\n")
         .def("__init__",
-            [](hp::ImageBuffer* ib, uint32_t width, uint32_t height) {
-                new (ib) hp::ImageBuffer(getCurrentContext(), width, height);
-            }, "width"_a, "height"_a)
+            [](hp::ImageBuffer* ib, uint32_t width, uint32_t height, hp::ImageFormat format) {
+                new (ib) hp::ImageBuffer(getCurrentContext(), width, height, format);
+            }, "width"_a, "height"_a, "format"_a = hp::ImageBuffer::DefaultFormat)
         .def_prop_ro("width", [](const hp::ImageBuffer& ib) { return ib.getWidth(); },
             "Width of the image in pixels")
         .def_prop_ro("height", [](const hp::ImageBuffer& ib) { return ib.getHeight(); },
             "Height of the image in pixels")
+        .def_prop_ro("format", [](const hp::ImageBuffer& ib) { return ib.getFormat(); },
+            "Format of the image")
         //TODO: This is somehow broken, but I don't get a proper error...
         //.def("createImage", &hp::ImageBuffer::createImage, "copy"_a = true)
         //.def("createImage", [](const hp::ImageBuffer& ib, bool copy) -> hp::Image { return ib.createImage(copy); }, "copy"_a = true)
         //.def("createImage", [](const hp::ImageBuffer& ib) -> hp::Image { return hp::Image(getCurrentContext(), hp::ImageFormat::R8G8B8A8_UNORM, ib.getWidth(), ib.getHeight()); })
-        .def("save", &hp::ImageBuffer::save, "filename"_a,
-            "Saves the image under the given filepath")
-        .def_static("loadFile", [](const char* filename) -> hp::ImageBuffer {
-                return hp::ImageBuffer::load(getCurrentContext(), filename);
-            }, "filename"_a,
-            "Loads the image at the given filepath and returns a new ImageBuffer")
-        .def_static("loadMemory", [](nb::bytes data) -> hp::ImageBuffer {
+        .def("save",
+            [](const hp::ImageBuffer& ib, const std::filesystem::path& filename,
+                hp::ImageFileFormat fileFormat, int32_t compressionLevel)
+            {
+                nb::gil_scoped_release release;
+                ib.save(filename, { fileFormat, compressionLevel });
+            }, "filename"_a, "fileFormat"_a = hp::ImageFileFormat::AUTO,
+            "compressionLevel"_a = -1,
+            "Saves the image under the given filepath. By default, 8 and 16 bit "
+            "images are saved as PNG, floating point ones as Radiance HDR without alpha."
+            "\n\nParameters\n----------\n"
+            "filename: str | PathLike\n"
+            "    Path to where to save the image\n"
+            "fileFormat: ImageFileFormat, default=ImageFileFormat.AUTO\n"
+            "    File format the image is saved in\n"
+            "compressionLevel: int, default=-1\n"
+            "    Compression level of PNG images from 0 to 9. Negative uses the default.\n")
+        .def("saveAsync",
+            [](nb::handle self, const std::filesystem::path& filename,
+                hp::ImageFileFormat fileFormat, int32_t compressionLevel)
+            {
+                auto& ib = nb::cast<const hp::ImageBuffer&>(self);
+                return PendingSave{
+                    ib.saveAsync(filename, { fileFormat, compressionLevel }),
+                    nb::borrow(self)
+                };
+            }, "filename"_a, "fileFormat"_a = hp::ImageFileFormat::AUTO,
+            "compressionLevel"_a = -1,
+            "Saves the image in the background and returns a handle to wait on. "
+            "The image must not be changed until the save finished."
+            "\n\nParameters\n----------\n"
+            "filename: str | PathLike\n"
+            "    Path to where to save the image\n"
+            "fileFormat: ImageFileFormat, default=ImageFileFormat.AUTO\n"
+            "    File format the image is saved in\n"
+            "compressionLevel: int, default=-1\n"
+            "    Compression level of PNG images from 0 to 9. Negative uses the default.\n")
+        .def("encode",
+            [](const hp::ImageBuffer& ib, hp::ImageFileFormat fileFormat, int32_t compressionLevel) {
+                std::vector<std::byte> data;
+                {
+                    nb::gil_scoped_release release;
+                    data = hp::encodeImage(ib.getMemory(), ib.getWidth(), ib.getHeight(),
+                        ib.getFormat(), { fileFormat, compressionLevel });
+                }
+                return nb::bytes(reinterpret_cast<const char*>(data.data()), data.size());
+            }, "fileFormat"_a = hp::ImageFileFormat::AUTO, "compressionLevel"_a = -1,
+            "Encodes the image in the given file format and returns it as bytes."
+            "\n\nParameters\n----------\n"
+            "fileFormat: ImageFileFormat, default=ImageFileFormat.AUTO\n"
+            "    File format the image is encoded in\n"
+            "compressionLevel: int, default=-1\n"
+            "    Compression level of PNG images from 0 to 9. Negative uses the default.\n")
+        .def_static("loadFile",
+            [](const char* filename, hp::ImageFormat format) -> hp::ImageBuffer {
+                return hp::ImageBuffer::load(getCurrentContext(), filename, format);
+            }, "filename"_a, "format"_a = hp::ImageBuffer::DefaultFormat,
+            "Loads the image at the given filepath and returns a new ImageBuffer "
+            "using the given format")
+        .def_static("loadFiles",
+            [](const std::vector<std::filesystem::path>& filenames, hp::ImageFormat format)
+                -> std::vector<hp::ImageBuffer>
+            {
+                auto futures = hp::ImageBuffer::loadAsync(getCurrentContext(), filenames, format);
+                std::vector<hp::ImageBuffer> result;
+                result.reserve(futures.size());
+                {
+                    nb::gil_scoped_release release;
+                    for (auto& future : futures)
+                        result.push_back(future.get());
+                }
+                return result;
+            }, "filenames"_a, "format"_a = hp::ImageBuffer::DefaultFormat,
+            "Loads the images at the given filepaths in parallel and returns them "
+            "as a list of new ImageBuffers in the same order.\n"
+            "\nParameters\n----------\n"
+            "filenames: list[str | PathLike]\n"
+            "    Paths to the images to load\n"
+            "format: ImageFormat, default=ImageFormat.R8G8B8A8_UNORM\n"
+            "    Format of the loaded images")
+        .def_static("loadMemory",
+            [](nb::bytes data, hp::ImageFormat format) -> hp::ImageBuffer {
                 return hp::ImageBuffer::load(
                     getCurrentContext(),
                     std::span<const std::byte>{
                         reinterpret_cast<const std::byte*>(data.c_str()),
                         data.size()
-                    });
-            }, "data"_a,
+                    }, format);
+            }, "data"_a, "format"_a = hp::ImageBuffer::DefaultFormat,
             "Loads serialized image data from memory and returns a new ImageBuffer\n"
             "\nParameters\n----------\n"
             "data: bytes\n"
-            "    Binary data containing the image data")
+            "    Binary data containing the image data\n"
+            "format: ImageFormat, default=ImageFormat.R8G8B8A8_UNORM\n"
+            "    Format of the loaded image")
         .def("numpy",
             [](const hp::ImageBuffer& buffer) -> image_array {
                 size_t shape[3] = {
@@ -295,43 +757,155 @@ void registerImageModule(nb::module_& m) {
                     buffer.getWidth(),
                     4
                 };
+                nb::dlpack::dtype dtype;
+                switch (buffer.getFormat()) {
+                case hp::ImageFormat::R16G16B16A16_UNORM:
+                    dtype = nb::dtype<uint16_t>();
+                    break;
+                case hp::ImageFormat::R32G32B32A32_SFLOAT:
+                    dtype = nb::dtype<float>();
+                    break;
+                default:
+                    dtype = nb::dtype<uint8_t>();
+                    break;
+                }
                 return image_array(static_cast<void*>(
-                    buffer.getMemory().data()), 3, shape);
+                    buffer.getMemory().data()), 3, shape, nb::handle(), nullptr, dtype);
             }, nb::rv_policy::reference_internal,
             "Returns a numpy array that allows to manipulate the data handled "
             "by this ImageBuffer");
     
+    nb::class_<hp::ImageRegion>(m, "ImageRegion",
+            "Region of an image taking part in a copy. Describes a box inside one "
+            "mip level of an image as well as the layout of the corresponding "
+            "data inside the buffer. The default selects the whole first mip "
+            "level tightly packed at the start of the buffer.")
+        .def("__init__", [](hp::ImageRegion* r,
+            uint32_t x, uint32_t y, uint32_t z,
+            uint32_t width, uint32_t height, uint32_t depth,
+            uint32_t mipLevel, uint32_t layer, uint32_t layerCount,
+            uint64_t bufferOffset,
+            uint32_t bufferRowLength, uint32_t bufferImageHeight
+        ) {
+            new (r) hp::ImageRegion{
+                x, y, z, width, height, depth, mipLevel, layer, layerCount,
+                bufferOffset, bufferRowLength, bufferImageHeight
+            };
+        }, "x"_a = 0, "y"_a = 0, "z"_a = 0,
+            "width"_a = 0, "height"_a = 0, "depth"_a = 0,
+            "mipLevel"_a = 0, "layer"_a = 0, "layerCount"_a = 0, "bufferOffset"_a = 0,
+            "bufferRowLength"_a = 0, "bufferImageHeight"_a = 0)
+        .def_rw("x", &hp::ImageRegion::x, "Offset of the region in X dimension in pixels")
+        .def_rw("y", &hp::ImageRegion::y, "Offset of the region in Y dimension in pixels")
+        .def_rw("z", &hp::ImageRegion::z, "Offset of the region in Z dimension in pixels")
+        .def_rw("width", &hp::ImageRegion::width,
+            "Width of the region in pixels. Zero extends it to the image's edge.")
+        .def_rw("height", &hp::ImageRegion::height,
+            "Height of the region in pixels. Zero extends it to the image's edge.")
+        .def_rw("depth", &hp::ImageRegion::depth,
+            "Depth of the region in pixels. Zero extends it to the image's edge.")
+        .def_rw("mipLevel", &hp::ImageRegion::mipLevel,
+            "Mip level the region is located in")
+        .def_rw("layer", &hp::ImageRegion::layer, "First array layer of the region")
+        .def_rw("layerCount", &hp::ImageRegion::layerCount,
+            "Number of array layers. Zero extends it to the last layer.")
+        .def_rw("bufferOffset", &hp::ImageRegion::bufferOffset,
+            "Offset into the buffer in bytes. Must be a multiple of the pixel size.")
+        .def_rw("bufferRowLength", &hp::ImageRegion::bufferRowLength,
+            "Length of a row in the buffer in pixels. Zero means tightly packed.")
+        .def_rw("bufferImageHeight", &hp::ImageRegion::bufferImageHeight,
+            "Number of rows per slice in the buffer. Zero means tightly packed.");
+
     nb::class_<hp::RetrieveImageCommand, hp::Command>(m, "RetrieveImageCommand",
             "Command for copying the image back into the given buffer")
-        .def(nb::init<const hp::Image&, const hp::Buffer<std::byte>&>(),
-            "src"_a, "dst"_a);
-    m.def("retrieveImage", &hp::retrieveImage, "src"_a, "dst"_a,
+        .def(nb::init<const hp::Image&, const hp::Buffer<std::byte>&, const hp::ImageRegion&>(),
+            "src"_a, "dst"_a, "region"_a = hp::ImageRegion{});
+    m.def("retrieveImage", &hp::retrieveImage, "src"_a, "dst"_a, "region"_a = hp::ImageRegion{},
         "Creates a command for copying the image back into the given buffer."
         "\n\nParameters\n----------\n",
         "src: Image\n"
         "    Source image\n"
         "dst: Buffer\n"
-        "    Destination buffer\n");
+        "    Destination buffer\n"
+        "region: ImageRegion, default=ImageRegion()\n"
+        "    Region to copy. Defaults to the whole image\n");
     nb::class_<hp::UpdateImageCommand, hp::Command>(m, "UpdateImageCommand",
             "Command for copying data from the given buffer into the image")
-        .def(nb::init<const hp::Buffer<std::byte>&, const hp::Image&>(),
-            "src"_a, "dst"_a);
-    m.def("updateImage", &hp::updateImage, "src"_a, "dst"_a,
+        .def(nb::init<const hp::Buffer<std::byte>&, const hp::Image&, const hp::ImageRegion&>(),
+            "src"_a, "dst"_a, "region"_a = hp::ImageRegion{});
+    m.def("updateImage", &hp::updateImage, "src"_a, "dst"_a, "region"_a = hp::ImageRegion{},
         "Creates a command for copying data from the given buffer into the image."
         "\n\nParameters\n----------\n",
         "src: Buffer\n"
         "    Source buffer\n"
         "dst: Image\n"
-        "    Destination image\n");
+        "    Destination image\n"
+        "region: ImageRegion, default=ImageRegion()\n"
+        "    Region to copy. Defaults to the whole image\n");
     nb::class_<hp::UpdateTextureCommand, hp::Command>(m, "UpdateTextureCommand",
             "Command for copying data from the given buffer into the texture")
-        .def(nb::init<const hp::Buffer<std::byte>&, const hp::Texture&>(),
-            "src"_a, "dst"_a);
-    m.def("updateTexture", &hp::updateTexture, "src"_a, "dst"_a,
+        .def(nb::init<const hp::Buffer<std::byte>&, const hp::Texture&, const hp::ImageRegion&>(),
+            "src"_a, "dst"_a, "region"_a = hp::ImageRegion{});
+    m.def("updateTexture", &hp::updateTexture, "src"_a, "dst"_a, "region"_a = hp::ImageRegion{},
         "Creates a command for copying data from the given buffer into the texture."
         "\n\nParameters\n----------\n",
         "src: Buffer\n"
         "    Source buffer\n"
         "dst: Texture\n"
-        "    Destination texture\n");
+        "    Destination texture\n"
+        "region: ImageRegion, default=ImageRegion()\n"
+        "    Region to copy. Defaults to the whole image\n");
+    nb::class_<hp::CopyImageToTensorCommand, hp::Command>(m, "CopyImageToTensorCommand",
+            "Command for copying the image into the given tensor on the device")
+        .def(nb::init<const hp::Image&, const hp::Tensor<std::byte>&, const hp::ImageRegion&>(),
+            "src"_a, "dst"_a, "region"_a = hp::ImageRegion{});
+    m.def("copyImageToTensor", &hp::copyImageToTensor, "src"_a, "dst"_a, "region"_a = hp::ImageRegion{},
+        "Creates a command for copying the image into the given tensor without "
+        "the data leaving the device."
+        "\n\nParameters\n----------\n",
+        "src: Image\n"
+        "    Source image\n"
+        "dst: Tensor\n"
+        "    Destination tensor\n"
+        "region: ImageRegion, default=ImageRegion()\n"
+        "    Region to copy. Defaults to the whole image\n");
+    nb::class_<hp::CopyTensorToImageCommand, hp::Command>(m, "CopyTensorToImageCommand",
+            "Command for copying the tensor into the given image on the device")
+        .def(nb::init<const hp::Tensor<std::byte>&, const hp::Image&, const hp::ImageRegion&>(),
+            "src"_a, "dst"_a, "region"_a = hp::ImageRegion{});
+    m.def("copyTensorToImage", &hp::copyTensorToImage, "src"_a, "dst"_a, "region"_a = hp::ImageRegion{},
+        "Creates a command for copying the tensor into the given image without "
+        "the data leaving the device."
+        "\n\nParameters\n----------\n",
+        "src: Tensor\n"
+        "    Source tensor\n"
+        "dst: Image\n"
+        "    Destination image\n"
+        "region: ImageRegion, default=ImageRegion()\n"
+        "    Region to copy. Defaults to the whole image\n");
+    nb::class_<hp::CopyTensorToTextureCommand, hp::Command>(m, "CopyTensorToTextureCommand",
+            "Command for copying the tensor into the given texture on the device")
+        .def(nb::init<const hp::Tensor<std::byte>&, const hp::Texture&, const hp::ImageRegion&>(),
+            "src"_a, "dst"_a, "region"_a = hp::ImageRegion{});
+    m.def("copyTensorToTexture", &hp::copyTensorToTexture, "src"_a, "dst"_a, "region"_a = hp::ImageRegion{},
+        "Creates a command for copying the tensor into the given texture without "
+        "the data leaving the device."
+        "\n\nParameters\n----------\n",
+        "src: Tensor\n"
+        "    Source tensor\n"
+        "dst: Texture\n"
+        "    Destination texture\n"
+        "region: ImageRegion, default=ImageRegion()\n"
+        "    Region to copy. Defaults to the whole image\n");
+
+    nb::class_<hp::GenerateMipmapsCommand, hp::Command>(m, "GenerateMipmapsCommand",
+            "Command for generating the mip chain of the texture from its first level")
+        .def(nb::init<const hp::Texture&>(), "texture"_a);
+    m.def("generateMipmaps", &hp::generateMipmaps, "texture"_a,
+        "Creates a command for generating the mip chain of the texture from its "
+        "first level. Formats not supporting linear filtering are downsampled "
+        "using nearest filtering."
+        "\n\nParameters\n----------\n",
+        "texture: Texture\n"
+        "    Texture whose mip levels to generate\n");
 }
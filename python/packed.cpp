@@ -0,0 +1,64 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/string.h>
+#include <nanobind/stl/string_view.h>
+
+#include <sstream>
+
+#include <hephaistos/packed.hpp>
+
+#include "context.hpp"
+
+namespace hp = hephaistos;
+namespace nb = nanobind;
+using namespace nb::literals;
+
+void registerPackedModule(nb::module_& m) {
+    nb::class_<hp::PackedTypesProperties>(m, "PackedTypesProperties",
+            "List of packed 16 and 8 bit type features a device supports or are enabled")
+        .def_ro("storageBuffer16BitAccess", &hp::PackedTypesProperties::storageBuffer16BitAccess)
+        .def_ro("uniformAndStorageBuffer16BitAccess", &hp::PackedTypesProperties::uniformAndStorageBuffer16BitAccess)
+        .def_ro("storagePushConstant16", &hp::PackedTypesProperties::storagePushConstant16)
+        .def_ro("storageBuffer8BitAccess", &hp::PackedTypesProperties::storageBuffer8BitAccess)
+        .def_ro("uniformAndStorageBuffer8BitAccess", &hp::PackedTypesProperties::uniformAndStorageBuffer8BitAccess)
+        .def_ro("storagePushConstant8", &hp::PackedTypesProperties::storagePushConstant8)
+        .def_ro("integerDotProduct", &hp::PackedTypesProperties::integerDotProduct)
+        .def("__repr__", [](const hp::PackedTypesProperties& p){
+            std::ostringstream str;
+            str << std::boolalpha;
+            str << "storageBuffer16BitAccess:           " << !!p.storageBuffer16BitAccess << '\n';
+            str << "uniformAndStorageBuffer16BitAccess: " << !!p.uniformAndStorageBuffer16BitAccess << '\n';
+            str << "storagePushConstant16:              " << !!p.storagePushConstant16 << '\n';
+            str << "storageBuffer8BitAccess:            " << !!p.storageBuffer8BitAccess << '\n';
+            str << "uniformAndStorageBuffer8BitAccess:  " << !!p.uniformAndStorageBuffer8BitAccess << '\n';
+            str << "storagePushConstant8:               " << !!p.storagePushConstant8 << '\n';
+            str << "integerDotProduct:                  " << !!p.integerDotProduct;
+            return str.str();
+        });
+
+    m.def("getPackedTypesProperties", [](uint32_t id) -> hp::PackedTypesProperties {
+        auto& devices = getDevices();
+        if (id >= devices.size())
+            throw std::runtime_error("There is no device with the selected id!");
+        return hp::getPackedTypesProperties(devices[id]);
+    }, "id"_a, "Returns the packed type capabilities of the device given by its id");
+    m.def("getEnabledPackedTypes", []() -> hp::PackedTypesProperties {
+        return hp::getEnabledPackedTypes(getCurrentContext());
+    }, "Returns the in the current context enabled packed type features");
+
+    m.def("enablePackedTypes", [](const nb::set& flags, bool force) {
+        //build packed types properties
+        hp::PackedTypesProperties props{
+            .storageBuffer16BitAccess = flags.contains("storageBuffer16BitAccess"),
+            .uniformAndStorageBuffer16BitAccess = flags.contains("uniformAndStorageBuffer16BitAccess"),
+            .storagePushConstant16 = flags.contains("storagePushConstant16"),
+            .storageBuffer8BitAccess = flags.contains("storageBuffer8BitAccess"),
+            .uniformAndStorageBuffer8BitAccess = flags.contains("uniformAndStorageBuffer8BitAccess"),
+            .storagePushConstant8 = flags.contains("storagePushConstant8"),
+            .integerDotProduct = flags.contains("integerDotProduct")
+        };
+        //add extension
+        addExtension(hp::createPackedTypesExtension(props), force);
+    }, "flags"_a, "force"_a = false,
+    "Enables the packed type features contained in the given set by their name. "
+    "Set force=True if an existing context should be destroyed.");
+}
@@ -0,0 +1,124 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/optional.h>
+#include <nanobind/stl/string.h>
+#include <nanobind/stl/vector.h>
+
+#include <stdexcept>
+
+#include <hephaistos/performance.hpp>
+
+#include "context.hpp"
+
+namespace hp = hephaistos;
+namespace nb = nanobind;
+using namespace nb::literals;
+
+namespace {
+
+bool isPerformanceQuerySupported(std::optional<uint32_t> id) {
+    auto& devices = getDevices();
+    if (id) {
+        if (id >= devices.size())
+            throw std::runtime_error("There is no device with the selected id!");
+        return hp::isPerformanceQuerySupported(devices[*id]);
+    }
+    else {
+        //check if any device is supported
+        for (auto& dev : devices) {
+            if (hp::isPerformanceQuerySupported(dev))
+                return true;
+        }
+        return false;
+    }
+}
+
+}
+
+void registerPerformanceModule(nb::module_& m) {
+    m.def("isPerformanceQuerySupported", &isPerformanceQuerySupported,
+        "id"_a.none() = nb::none(),
+        "Checks wether any or the given device supports performance queries.");
+    m.def("isPerformanceQueryEnabled",
+        []() -> bool { return hp::isPerformanceQueryEnabled(getCurrentContext()); },
+        "Checks wether performance queries were enabled. Note that this creates the context.");
+    m.def("enablePerformanceQuery",
+        [](bool force) { addExtension(hp::createPerformanceQueryExtension(), force); },
+        "force"_a = false,
+        "Enables performance queries. (Lazy) context creation fails if not supported. "
+        "Set force=True if an existing context should be destroyed.");
+
+    nb::enum_<hp::PerformanceCounterUnit>(m, "PerformanceCounterUnit",
+            "Unit of a performance counter")
+        .value("GENERIC", hp::PerformanceCounterUnit::GENERIC, "Unitless value")
+        .value("PERCENTAGE", hp::PerformanceCounterUnit::PERCENTAGE, "Percentage")
+        .value("NANOSECONDS", hp::PerformanceCounterUnit::NANOSECONDS, "Nanoseconds")
+        .value("BYTES", hp::PerformanceCounterUnit::BYTES, "Bytes")
+        .value("BYTES_PER_SECOND", hp::PerformanceCounterUnit::BYTES_PER_SECOND, "Bytes per second")
+        .value("KELVIN", hp::PerformanceCounterUnit::KELVIN, "Temperature in Kelvin")
+        .value("WATTS", hp::PerformanceCounterUnit::WATTS, "Power in Watts")
+        .value("VOLTS", hp::PerformanceCounterUnit::VOLTS, "Voltage in Volts")
+        .value("AMPS", hp::PerformanceCounterUnit::AMPS, "Current in Ampere")
+        .value("HERTZ", hp::PerformanceCounterUnit::HERTZ, "Frequency in Hertz")
+        .value("CYCLES", hp::PerformanceCounterUnit::CYCLES, "Clock cycles");
+
+    nb::class_<hp::PerformanceCounter>(m, "PerformanceCounter",
+            "Description of a hardware performance counter")
+        .def_ro("name", &hp::PerformanceCounter::name,
+            "Name of the counter as reported by the driver")
+        .def_ro("category", &hp::PerformanceCounter::category,
+            "Category the counter belongs to")
+        .def_ro("description", &hp::PerformanceCounter::description,
+            "Description of the counter")
+        .def_ro("unit", &hp::PerformanceCounter::unit,
+            "Unit of the counter's value")
+        .def("__repr__", [](const hp::PerformanceCounter& c) {
+            return "PerformanceCounter('" + c.name + "')";
+        });
+
+    nb::class_<hp::PerformanceCounterResult>(m, "PerformanceCounterResult",
+            "Value of a performance counter measured by a PerformanceQuery")
+        .def_ro("name", &hp::PerformanceCounterResult::name, "Name of the counter")
+        .def_ro("value", &hp::PerformanceCounterResult::value, "Measured value")
+        .def_ro("unit", &hp::PerformanceCounterResult::unit, "Unit of the value");
+
+    m.def("enumeratePerformanceCounters",
+        []() { return hp::enumeratePerformanceCounters(getCurrentContext()); },
+        "Enumerates the performance counters available on the current context.");
+
+    nb::class_<hp::PerformanceQuery>(m, "PerformanceQuery",
+            "Measures hardware performance counters over a list of commands. The "
+            "commands are executed once per pass the selected counters require.")
+        .def("__init__",
+            [](hp::PerformanceQuery* q, const std::vector<std::string>& counters) {
+                nb::gil_scoped_release release;
+                new (q) hp::PerformanceQuery(getCurrentContext(), counters);
+            }, "counters"_a,
+            "Creates a new query measuring the given counters."
+            "\n\nParameters\n----------\n"
+            "counters: list[str]\n"
+            "    Names of the counters to measure\n")
+        .def_prop_ro("counters",
+            [](const hp::PerformanceQuery& q) {
+                auto counters = q.getCounters();
+                return std::vector<hp::PerformanceCounter>(counters.begin(), counters.end());
+            }, "Counters measured by this query")
+        .def_prop_ro("passCount", &hp::PerformanceQuery::getPassCount,
+            "Amount of passes needed to measure all counters")
+        .def("measure",
+            [](hp::PerformanceQuery& q, nb::list list) {
+                //minimize time with GIL -> collect commands
+                std::vector<const hp::Command*> commands(list.size());
+                auto i = 0u;
+                for (nb::handle h : list)
+                    commands[i++] = nb::cast<const hp::Command*>(h);
+
+                //release GIL
+                nb::gil_scoped_release release;
+                return q.measure([&commands](hp::vulkan::Command& cmd) {
+                    for (auto c : commands)
+                        c->record(cmd);
+                });
+            }, "list"_a,
+            "Runs the given list of commands once per pass and returns the value "
+            "of each counter.");
+}
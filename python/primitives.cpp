@@ -0,0 +1,607 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/ndarray.h>
+#include <nanobind/stl/optional.h>
+#include <nanobind/stl/tuple.h>
+#include <nanobind/stl/vector.h>
+
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include <hephaistos/primitives.hpp>
+#include <hephaistos/program.hpp>
+#include "context.hpp"
+
+namespace hp = hephaistos;
+namespace nb = nanobind;
+using namespace nb::literals;
+
+namespace {
+
+//typed tensors are only known to Python -> resolve type via their class
+hp::ElementType resolveType(nb::handle tensor, std::optional<hp::ElementType> type) {
+    if (type)
+        return *type;
+    auto module = nb::module_::import_("hephaistos.pyhephaistos");
+    if (nb::isinstance(tensor, module.attr("IntTensor")))
+        return hp::ElementType::INT32;
+    if (nb::isinstance(tensor, module.attr("UnsignedIntTensor")))
+        return hp::ElementType::UINT32;
+    if (nb::isinstance(tensor, module.attr("FloatTensor")))
+        return hp::ElementType::FLOAT32;
+    throw std::invalid_argument("Cannot deduce element type of tensor. Specify it explicitly!");
+}
+
+hp::SortKeyType resolveKeyType(nb::handle tensor, std::optional<hp::SortKeyType> type) {
+    if (type)
+        return *type;
+    switch (resolveType(tensor, std::nullopt)) {
+    case hp::ElementType::INT32:
+        return hp::SortKeyType::INT32;
+    case hp::ElementType::UINT32:
+        return hp::SortKeyType::UINT32;
+    case hp::ElementType::FLOAT32:
+        return hp::SortKeyType::FLOAT32;
+    }
+    throw std::logic_error("Unknown element type!");
+}
+
+std::vector<hp::CompactColumn> toColumns(
+    const std::vector<std::tuple<uint64_t, uint64_t, uint32_t>>& columns)
+{
+    std::vector<hp::CompactColumn> result;
+    result.reserve(columns.size());
+    for (auto& [srcOffset, dstOffset, stride] : columns)
+        result.push_back({ srcOffset, dstOffset, stride });
+    return result;
+}
+
+//Wrapper around hephaistos::IndirectPass holding
+//references to keep the program, tensor and push data alive
+struct PyIndirectPass {
+    nb::object program;
+    nb::object count;
+    uint64_t countOffset;
+    uint32_t itemsPerGroup;
+    uint32_t maxGroups;
+    nb::bytes push;
+
+    operator hp::IndirectPass() const {
+        return {
+            .program = nb::cast<const hp::Program&>(program),
+            .count = nb::cast<const hp::Tensor<std::byte>&>(count),
+            .countOffset = countOffset,
+            .itemsPerGroup = itemsPerGroup,
+            .maxGroups = maxGroups,
+            .pushData = {
+                reinterpret_cast<const std::byte*>(push.c_str()),
+                push.size()
+            }
+        };
+    }
+};
+
+uint32_t toCount(std::optional<uint32_t> count) {
+    return count.value_or(std::numeric_limits<uint32_t>::max());
+}
+
+using RawArray = nb::ndarray<nb::ro, nb::c_contig, nb::device::cpu>;
+using RawOutArray = nb::ndarray<nb::c_contig, nb::device::cpu>;
+
+std::span<const std::byte> asBytes(const RawArray& array) {
+    return { static_cast<const std::byte*>(array.data()), array.nbytes() };
+}
+
+}
+
+void registerPrimitivesModule(nb::module_& m) {
+    nb::enum_<hp::ElementType>(m, "ElementType",
+            "Type of the elements processed by a primitive")
+        .value("INT32", hp::ElementType::INT32)
+        .value("UINT32", hp::ElementType::UINT32)
+        .value("FLOAT32", hp::ElementType::FLOAT32);
+    nb::enum_<hp::ReduceOperation>(m, "ReduceOperation",
+            "Associative operation used to combine elements")
+        .value("ADD", hp::ReduceOperation::ADD)
+        .value("MIN", hp::ReduceOperation::MIN)
+        .value("MAX", hp::ReduceOperation::MAX);
+    nb::enum_<hp::HistogramStrategy>(m, "HistogramStrategy",
+            "Strategy used to accumulate a histogram")
+        .value("AUTO", hp::HistogramStrategy::AUTO,
+            "Picks the strategy based on the bins and enabled atomics")
+        .value("GLOBAL", hp::HistogramStrategy::GLOBAL,
+            "Accumulates directly into the output using buffer atomics")
+        .value("SHARED", hp::HistogramStrategy::SHARED,
+            "Accumulates into a private copy of the bins per workgroup in shared "
+            "memory, which gets merged into the output afterwards")
+        .value("SUBGROUP", hp::HistogramStrategy::SUBGROUP,
+            "Like SHARED, but first combines items of a subgroup falling into the "
+            "same bin. Lowers contention on few very full bins. Falls back to "
+            "buffer atomics if the bins exceed shared memory.")
+        .value("DETERMINISTIC", hp::HistogramStrategy::DETERMINISTIC,
+            "Sums the items of each workgroup per bin in a fixed order and merges "
+            "these partial bins in order afterwards. Produces bit-identical float "
+            "bins across runs and needs no atomics, but its cost grows with the "
+            "amount of bins.");
+    nb::enum_<hp::SortKeyType>(m, "SortKeyType",
+            "Type of the keys sorted by a primitive")
+        .value("INT32", hp::SortKeyType::INT32)
+        .value("UINT32", hp::SortKeyType::UINT32)
+        .value("FLOAT32", hp::SortKeyType::FLOAT32)
+        .value("INT64", hp::SortKeyType::INT64)
+        .value("UINT64", hp::SortKeyType::UINT64)
+        .value("FLOAT64", hp::SortKeyType::FLOAT64);
+
+    nb::class_<PyIndirectPass>(m, "IndirectPass",
+            "Single pass of an indirect dispatch chain. The amount of workgroups is "
+            "derived on the device from an item count, e.g. written by the previous "
+            "pass, by dividing it by the items processed per workgroup. The "
+            "program's bindings are captured when creating the chain."
+            "\n\nParameters\n----------\n"
+            "program: Program\n"
+            "    Program to dispatch\n"
+            "count: Tensor\n"
+            "    Tensor holding the amount of items as uint32\n"
+            "countOffset: int, default=0\n"
+            "    Offset in bytes of the amount inside count\n"
+            "itemsPerGroup: int, default=0\n"
+            "    Items processed per workgroup. Zero uses the program's local size in X.\n"
+            "maxGroups: int, default=2**32-1\n"
+            "    Upper limit of the amount of workgroups\n"
+            "push: bytes, default=b''\n"
+            "    Data used as push constant\n")
+        .def("__init__",
+            [](PyIndirectPass* p, nb::handle program, nb::handle count, uint64_t countOffset,
+                uint32_t itemsPerGroup, uint32_t maxGroups, nb::bytes push)
+            {
+                //fail early on wrong types
+                nb::cast<const hp::Program&>(program);
+                nb::cast<const hp::Tensor<std::byte>&>(count);
+                new (p) PyIndirectPass{
+                    nb::borrow<nb::object>(program), nb::borrow<nb::object>(count),
+                    countOffset, itemsPerGroup, maxGroups, std::move(push)
+                };
+            }, "program"_a, "count"_a, "countOffset"_a = 0, nb::kw_only(),
+            "itemsPerGroup"_a = 0, "maxGroups"_a = std::numeric_limits<uint32_t>::max(),
+            "push"_a = nb::bytes())
+        .def_prop_ro("program", [](const PyIndirectPass& p) { return p.program; },
+            "Program to dispatch")
+        .def_prop_ro("count", [](const PyIndirectPass& p) { return p.count; },
+            "Tensor holding the amount of items as uint32")
+        .def_ro("countOffset", &PyIndirectPass::countOffset,
+            "Offset in bytes of the amount inside count")
+        .def_ro("itemsPerGroup", &PyIndirectPass::itemsPerGroup,
+            "Items processed per workgroup. Zero uses the program's local size in X.")
+        .def_ro("maxGroups", &PyIndirectPass::maxGroups,
+            "Upper limit of the amount of workgroups");
+
+    nb::class_<hp::PrimitiveCommand, hp::Command>(m, "PrimitiveCommand",
+        "Command running a parallel primitive. Runs multiple dispatches synchronized "
+        "among each other, but not with work recorded before or after. Owns its "
+        "scratch memory, thus may only run once at a time.");
+
+    nb::class_<hp::Primitives>(m, "Primitives",
+            "Library of common parallel primitives on tensors of 32 bit elements: "
+            "prefix sums, reductions and stream compaction, as well as radix sort of "
+            "32 and 64 bit keys and histograms. Programs are compiled on first use. "
+            "Scans run in a single pass using decoupled look-back, sorting in one "
+            "pass per 8 bit digit using look-back per digit. Histograms privatize "
+            "their bins in shared memory where possible. Workgroups use subgroup "
+            "arithmetic and ballots if supported by the device, thus float sums may "
+            "differ in their last bits between runs unless created deterministic. "
+            "The element type is "
+            "deduced from typed tensors, i.e. IntTensor, UnsignedIntTensor and "
+            "FloatTensor, unless given explicitly."
+            "\n\nParameters\n----------\n"
+            "localSize: int, default=0\n"
+            "    Threads per workgroup. Zero picks one based on the device.\n"
+            "itemsPerThread: int, default=0\n"
+            "    Elements processed per thread. Zero picks a default.\n"
+            "useSubgroups: bool, default=True\n"
+            "    Whether to use subgroup arithmetic where supported\n"
+            "deterministic: bool, default=False\n"
+            "    If True, reductions combine elements in a fixed order independent of "
+            "the subgroup size and float histograms default to "
+            "HistogramStrategy.DETERMINISTIC, making their results bit-reproducible "
+            "on the same device and options.\n")
+        .def("__init__",
+            [](hp::Primitives* p, uint32_t localSize, uint32_t itemsPerThread,
+                bool useSubgroups, bool deterministic)
+            {
+                new (p) hp::Primitives(getCurrentContext(), {
+                    .localSize = localSize,
+                    .itemsPerThread = itemsPerThread,
+                    .useSubgroups = useSubgroups,
+                    .deterministic = deterministic
+                });
+            }, nb::kw_only(), "localSize"_a = 0, "itemsPerThread"_a = 0,
+            "useSubgroups"_a = true, "deterministic"_a = false)
+        .def_prop_ro("localSize", [](const hp::Primitives& p) { return p.getLocalSize(); },
+            "Threads per workgroup")
+        .def_prop_ro("tileSize", [](const hp::Primitives& p) { return p.getTileSize(); },
+            "Elements processed per workgroup")
+        .def_prop_ro("usesSubgroups", [](const hp::Primitives& p) { return p.usesSubgroups(); },
+            "True, if the programs use subgroup arithmetic")
+        .def_prop_ro("isDeterministic", [](const hp::Primitives& p) { return p.isDeterministic(); },
+            "True, if reductions and float histograms are deterministic")
+        .def("inclusiveScan",
+            [](const hp::Primitives& p,
+                nb::handle input,
+                nb::handle output,
+                std::optional<hp::ElementType> type,
+                hp::ReduceOperation op,
+                std::optional<uint32_t> count)
+            {
+                auto& in = nb::cast<const hp::Tensor<std::byte>&>(input);
+                auto& out = !output.is_none() ? nb::cast<const hp::Tensor<std::byte>&>(output) : in;
+                return p.inclusiveScan(in, out, resolveType(input, type), op, toCount(count));
+            }, "input"_a, "output"_a.none() = nb::none(), nb::kw_only(),
+            "type"_a.none() = nb::none(), "op"_a = hp::ReduceOperation::ADD,
+            "count"_a.none() = nb::none(),
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(), nb::keep_alive<0, 3>(),
+            "Creates a command computing the inclusive scan of the input."
+            "\n\nParameters\n----------\n"
+            "input: Tensor\n"
+            "    Tensor holding the elements to scan\n"
+            "output: Tensor | None, default=None\n"
+            "    Tensor the scan is written to. Scans in place if None.\n"
+            "type: ElementType | None, default=None\n"
+            "    Type of the elements. Deduced from input if None.\n"
+            "op: ReduceOperation, default=ReduceOperation.ADD\n"
+            "    Operation combining the elements\n"
+            "count: int | None, default=None\n"
+            "    Amount of elements. Uses the whole input if None.\n")
+        .def("exclusiveScan",
+            [](const hp::Primitives& p,
+                nb::handle input,
+                nb::handle output,
+                std::optional<hp::ElementType> type,
+                hp::ReduceOperation op,
+                std::optional<uint32_t> count)
+            {
+                auto& in = nb::cast<const hp::Tensor<std::byte>&>(input);
+                auto& out = !output.is_none() ? nb::cast<const hp::Tensor<std::byte>&>(output) : in;
+                return p.exclusiveScan(in, out, resolveType(input, type), op, toCount(count));
+            }, "input"_a, "output"_a.none() = nb::none(), nb::kw_only(),
+            "type"_a.none() = nb::none(), "op"_a = hp::ReduceOperation::ADD,
+            "count"_a.none() = nb::none(),
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(), nb::keep_alive<0, 3>(),
+            "Creates a command computing the exclusive scan of the input."
+            "\n\nParameters\n----------\n"
+            "input: Tensor\n"
+            "    Tensor holding the elements to scan\n"
+            "output: Tensor | None, default=None\n"
+            "    Tensor the scan is written to. Scans in place if None.\n"
+            "type: ElementType | None, default=None\n"
+            "    Type of the elements. Deduced from input if None.\n"
+            "op: ReduceOperation, default=ReduceOperation.ADD\n"
+            "    Operation combining the elements\n"
+            "count: int | None, default=None\n"
+            "    Amount of elements. Uses the whole input if None.\n")
+        .def("reduce",
+            [](const hp::Primitives& p,
+                nb::handle input,
+                const hp::Tensor<std::byte>& output,
+                std::optional<hp::ElementType> type,
+                hp::ReduceOperation op,
+                std::optional<uint32_t> count)
+            {
+                auto& in = nb::cast<const hp::Tensor<std::byte>&>(input);
+                return p.reduce(in, output, resolveType(input, type), op, toCount(count));
+            }, "input"_a, "output"_a, nb::kw_only(),
+            "type"_a.none() = nb::none(), "op"_a = hp::ReduceOperation::ADD,
+            "count"_a.none() = nb::none(),
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(), nb::keep_alive<0, 3>(),
+            "Creates a command reducing the input to a single element written to the "
+            "first element of output."
+            "\n\nParameters\n----------\n"
+            "input: Tensor\n"
+            "    Tensor holding the elements to reduce\n"
+            "output: Tensor\n"
+            "    Tensor receiving the result\n"
+            "type: ElementType | None, default=None\n"
+            "    Type of the elements. Deduced from input if None.\n"
+            "op: ReduceOperation, default=ReduceOperation.ADD\n"
+            "    Operation combining the elements\n"
+            "count: int | None, default=None\n"
+            "    Amount of elements. Uses the whole input if None.\n")
+        .def("compact",
+            [](const hp::Primitives& p,
+                const hp::Tensor<std::byte>& flags,
+                const hp::Tensor<std::byte>& src,
+                const hp::Tensor<std::byte>& dst,
+                const std::vector<std::tuple<uint64_t, uint64_t, uint32_t>>& columns,
+                std::optional<uint32_t> count,
+                const hp::Tensor<std::byte>* countTensor,
+                uint64_t countOffset)
+            {
+                return p.compact(flags, src, dst, toColumns(columns),
+                    toCount(count), countTensor, countOffset);
+            }, "flags"_a, "src"_a, "dst"_a, "columns"_a, nb::kw_only(),
+            "count"_a.none() = nb::none(), "countTensor"_a.none() = nb::none(),
+            "countOffset"_a = 0,
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(), nb::keep_alive<0, 3>(),
+            nb::keep_alive<0, 4>(), nb::keep_alive<0, 7>(),
+            "Creates a command moving each item whose flag is non zero from src to "
+            "dst while preserving their order. Items may span multiple columns, e.g. "
+            "the fields of a structure of arrays, which are moved alike."
+            "\n\nParameters\n----------\n"
+            "flags: Tensor\n"
+            "    Tensor holding a uint32 flag per item\n"
+            "src: Tensor\n"
+            "    Tensor holding the items to compact\n"
+            "dst: Tensor\n"
+            "    Tensor receiving the kept items. Must differ from src.\n"
+            "columns: list[tuple[int, int, int]]\n"
+            "    Offset in bytes into src and dst as well as the size in bytes of a\n"
+            "    single item per column. Must be multiples of 4.\n"
+            "count: int | None, default=None\n"
+            "    Amount of items. Uses the size of flags if None.\n"
+            "countTensor: Tensor | None, default=None\n"
+            "    Tensor receiving the amount of kept items\n"
+            "countOffset: int, default=0\n"
+            "    Offset in bytes the amount is written to\n")
+        .def("getHistogramStrategy",
+            [](const hp::Primitives& p, hp::ElementType type, uint32_t binCount,
+                hp::HistogramStrategy strategy)
+            {
+                return p.getHistogramStrategy(type, binCount, strategy);
+            }, "type"_a, "binCount"_a, "strategy"_a = hp::HistogramStrategy::AUTO,
+            "Returns the strategy used for histograms of the given type and amount "
+            "of bins."
+            "\n\nParameters\n----------\n"
+            "type: ElementType\n"
+            "    Type of the bins\n"
+            "binCount: int\n"
+            "    Amount of bins\n"
+            "strategy: HistogramStrategy, default=HistogramStrategy.AUTO\n"
+            "    Requested strategy\n")
+        .def("histogram",
+            [](const hp::Primitives& p,
+                const hp::Tensor<std::byte>& indices,
+                nb::handle histogram,
+                const hp::Tensor<std::byte>* weights,
+                std::optional<hp::ElementType> type,
+                std::optional<uint32_t> count,
+                hp::HistogramStrategy strategy)
+            {
+                auto& hist = nb::cast<const hp::Tensor<std::byte>&>(histogram);
+                return p.histogram(indices, hist, resolveType(histogram, type),
+                    weights, toCount(count), strategy);
+            }, "indices"_a, "histogram"_a, nb::kw_only(),
+            "weights"_a.none() = nb::none(), "type"_a.none() = nb::none(),
+            "count"_a.none() = nb::none(), "strategy"_a = hp::HistogramStrategy::AUTO,
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(), nb::keep_alive<0, 3>(),
+            nb::keep_alive<0, 4>(),
+            "Creates a command adding one or the item's weight to the bin given by "
+            "the item's index. Items with indices outside of the histogram are "
+            "skipped. Previous contents of the histogram are kept, i.e. multiple "
+            "commands accumulate. Float bins require the corresponding atomic add "
+            "being enabled."
+            "\n\nParameters\n----------\n"
+            "indices: Tensor\n"
+            "    Tensor holding an uint32 bin index per item\n"
+            "histogram: Tensor\n"
+            "    Tensor holding the bins. Its size defines their amount.\n"
+            "weights: Tensor | None, default=None\n"
+            "    Optional tensor holding a weight per item\n"
+            "type: ElementType | None, default=None\n"
+            "    Type of the bins and weights. Deduced from histogram if None.\n"
+            "count: int | None, default=None\n"
+            "    Amount of items. Uses the size of indices if None.\n"
+            "strategy: HistogramStrategy, default=HistogramStrategy.AUTO\n"
+            "    Strategy used to accumulate the bins\n")
+        .def("sort",
+            [](const hp::Primitives& p,
+                nb::handle keys,
+                const hp::Tensor<std::byte>* values,
+                std::optional<hp::SortKeyType> type,
+                std::optional<uint32_t> count,
+                uint32_t valueStride)
+            {
+                auto& k = nb::cast<const hp::Tensor<std::byte>&>(keys);
+                return p.sort(k, resolveKeyType(keys, type), toCount(count), values, valueStride);
+            }, "keys"_a, "values"_a.none() = nb::none(), nb::kw_only(),
+            "type"_a.none() = nb::none(), "count"_a.none() = nb::none(),
+            "valueStride"_a = 4,
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(), nb::keep_alive<0, 3>(),
+            "Creates a command sorting the keys in place. The sort is stable and "
+            "moves optional values alike."
+            "\n\nParameters\n----------\n"
+            "keys: Tensor\n"
+            "    Tensor holding the keys to sort\n"
+            "values: Tensor | None, default=None\n"
+            "    Optional tensor holding a value per key\n"
+            "type: SortKeyType | None, default=None\n"
+            "    Type of the keys. Deduced from keys if None.\n"
+            "count: int | None, default=None\n"
+            "    Amount of keys. Uses the whole tensor if None.\n"
+            "valueStride: int, default=4\n"
+            "    Size in bytes of a single value. Must be a multiple of 4.\n")
+        .def("sortIndices",
+            [](const hp::Primitives& p,
+                nb::handle keys,
+                const hp::Tensor<std::byte>& indices,
+                std::optional<hp::SortKeyType> type,
+                std::optional<uint32_t> count)
+            {
+                auto& k = nb::cast<const hp::Tensor<std::byte>&>(keys);
+                return p.sortIndices(k, indices, resolveKeyType(keys, type), toCount(count));
+            }, "keys"_a, "indices"_a, nb::kw_only(),
+            "type"_a.none() = nb::none(), "count"_a.none() = nb::none(),
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(), nb::keep_alive<0, 3>(),
+            "Creates a command writing the index of the key for each position in "
+            "sorted order, i.e. a stable argsort. The keys are left unchanged."
+            "\n\nParameters\n----------\n"
+            "keys: Tensor\n"
+            "    Tensor holding the keys to sort\n"
+            "indices: Tensor\n"
+            "    Tensor receiving an uint32 index per key\n"
+            "type: SortKeyType | None, default=None\n"
+            "    Type of the keys. Deduced from keys if None.\n"
+            "count: int | None, default=None\n"
+            "    Amount of keys. Uses the whole tensor if None.\n")
+        .def("sortColumns",
+            [](const hp::Primitives& p,
+                const hp::Tensor<std::byte>& src,
+                const hp::Tensor<std::byte>& dst,
+                hp::SortKeyType type,
+                uint64_t keyOffset,
+                const std::vector<std::tuple<uint64_t, uint64_t, uint32_t>>& columns,
+                uint32_t count,
+                std::optional<uint64_t> countOffset)
+            {
+                return p.sortColumns(src, dst, type, keyOffset, toColumns(columns),
+                    count, countOffset);
+            }, "src"_a, "dst"_a, "type"_a, "keyOffset"_a, "columns"_a, "count"_a,
+            nb::kw_only(), "countOffset"_a.none() = nb::none(),
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(), nb::keep_alive<0, 3>(),
+            "Creates a command moving items from src to dst ordered by a key column "
+            "inside src, e.g. sorting the structure of arrays of a queue by one of "
+            "its fields. The sort is stable."
+            "\n\nParameters\n----------\n"
+            "src: Tensor\n"
+            "    Tensor holding the items to sort\n"
+            "dst: Tensor\n"
+            "    Tensor receiving the sorted items. Must differ from src.\n"
+            "type: SortKeyType\n"
+            "    Type of the keys\n"
+            "keyOffset: int\n"
+            "    Offset in bytes of the key column inside src\n"
+            "columns: list[tuple[int, int, int]]\n"
+            "    Offset in bytes into src and dst as well as the size in bytes of a\n"
+            "    single item per column moved to dst. Must be multiples of 4.\n"
+            "count: int\n"
+            "    Amount of items\n"
+            "countOffset: int | None, default=None\n"
+            "    Optional offset in bytes of an uint32 inside src limiting the amount\n"
+            "    of items, e.g. the counter of a queue. Copied to dst at the same offset.\n")
+        .def("copyPrefix",
+            [](const hp::Primitives& p,
+                const hp::Tensor<std::byte>& src,
+                const hp::Tensor<std::byte>& dst,
+                uint64_t countOffset,
+                const std::vector<std::tuple<uint64_t, uint64_t, uint32_t>>& columns,
+                uint32_t capacity)
+            {
+                return p.copyPrefix(src, dst, countOffset, toColumns(columns), capacity);
+            }, "src"_a, "dst"_a, "countOffset"_a, "columns"_a, "capacity"_a,
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(), nb::keep_alive<0, 3>(),
+            "Creates a command reading the amount of items from an uint32 inside src, "
+            "e.g. the counter of a queue, and copying only that many items of each "
+            "column to dst, clamped to the capacity. The amount is copied into dst at "
+            "the same offset. If dst is mapped, only the live prefix is written to "
+            "host visible memory, i.e. a queue is read back in a single submission."
+            "\n\nParameters\n----------\n"
+            "src: Tensor\n"
+            "    Tensor holding the count and the items\n"
+            "dst: Tensor\n"
+            "    Tensor receiving the count and the items. Must differ from src.\n"
+            "countOffset: int\n"
+            "    Offset in bytes of the uint32 count inside src and dst\n"
+            "columns: list[tuple[int, int, int]]\n"
+            "    Offset in bytes into src and dst as well as the size in bytes of a\n"
+            "    single item per column. Must be multiples of 4.\n"
+            "capacity: int\n"
+            "    Maximum amount of items\n")
+        .def("compress",
+            [](const hp::Primitives& p,
+                const hp::Tensor<std::byte>& input,
+                const hp::Tensor<std::byte>& output,
+                std::optional<uint32_t> count)
+            {
+                return p.compress(input, output, toCount(count));
+            }, "input"_a, "output"_a, nb::kw_only(), "count"_a.none() = nb::none(),
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(), nb::keep_alive<0, 3>(),
+            "Creates a command compressing 32 bit words by eliminating zero words, "
+            "suited for sparse data before retrieving it. The stream starts with the "
+            "amount of words and of non zero words as uint32 followed by a mask of "
+            "the non zero words per block of 32 words and the non zero words in "
+            "order. Use getCompressedSize() on its header to retrieve only the "
+            "compressed part and decompressData() to decode it on the host."
+            "\n\nParameters\n----------\n"
+            "input: Tensor\n"
+            "    Tensor holding the words to compress\n"
+            "output: Tensor\n"
+            "    Tensor receiving the stream. Must differ from input and hold at least\n"
+            "    getMaxCompressedSize() bytes.\n"
+            "count: int | None, default=None\n"
+            "    Amount of words. Uses the whole input if None.\n")
+        .def("decompress",
+            [](const hp::Primitives& p,
+                const hp::Tensor<std::byte>& input,
+                const hp::Tensor<std::byte>& output,
+                std::optional<uint32_t> count)
+            {
+                return p.decompress(input, output, toCount(count));
+            }, "input"_a, "output"_a, nb::kw_only(), "count"_a.none() = nb::none(),
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(), nb::keep_alive<0, 3>(),
+            "Creates a command decompressing a stream created by compress() or "
+            "compressData() into a tensor overwriting its previous contents."
+            "\n\nParameters\n----------\n"
+            "input: Tensor\n"
+            "    Tensor holding the compressed stream\n"
+            "output: Tensor\n"
+            "    Tensor receiving the words. Must differ from input.\n"
+            "count: int | None, default=None\n"
+            "    Amount of words. Must match the stream. Uses the whole output if None.\n")
+        .def("indirectChain",
+            [](const hp::Primitives& p, const std::vector<PyIndirectPass>& passes) {
+                std::vector<hp::IndirectPass> plainPasses(passes.begin(), passes.end());
+                return p.indirectChain(plainPasses);
+            }, "passes"_a, nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(),
+            "Creates a command running a chain of indirect dispatches. Before each "
+            "pass a built-in kernel reads the pass' item count and writes its "
+            "dispatch arguments, dividing the count by the items per workgroup "
+            "rounding up and clamping it to the pass' maximum and the device's "
+            "limit. Thus each pass may size the next one without a round trip to "
+            "the host. Passes are only separated by a single barrier each."
+            "\n\nParameters\n----------\n"
+            "passes: list[IndirectPass]\n"
+            "    Passes to run in the given order\n");
+
+    m.def("getMaxCompressedSize", &hp::getMaxCompressedSize, "count"_a,
+        "Returns the size in bytes a compressed stream of the given amount of 32 "
+        "bit words occupies at most");
+    m.def("getCompressedSize",
+        [](RawArray stream) { return hp::getCompressedSize(asBytes(stream)); },
+        "stream"_a,
+        "Returns the size in bytes of a compressed stream. Only reads its header, "
+        "i.e. the first 8 bytes.");
+    m.def("getDecompressedSize",
+        [](RawArray stream) { return hp::getDecompressedSize(asBytes(stream)); },
+        "stream"_a,
+        "Returns the size in bytes of the data stored in a compressed stream. Only "
+        "reads its header, i.e. the first 8 bytes.");
+    m.def("compressData",
+        [](RawArray data) {
+            std::vector<std::byte> stream;
+            {
+                nb::gil_scoped_release release;
+                stream = hp::compressData(asBytes(data));
+            }
+            return nb::bytes(reinterpret_cast<const char*>(stream.data()), stream.size());
+        }, "data"_a,
+        "Compresses 32 bit words on the host into the same stream as "
+        "Primitives.compress(), e.g. to upload sparse data and decompress it on "
+        "the device."
+        "\n\nParameters\n----------\n"
+        "data: ndarray\n"
+        "    Words to compress. Size in bytes must be a multiple of 4.\n");
+    m.def("decompressData",
+        [](RawArray stream, RawOutArray data) {
+            nb::gil_scoped_release release;
+            hp::decompressData(asBytes(stream),
+                { static_cast<std::byte*>(data.data()), data.nbytes() });
+        }, "stream"_a, "data"_a,
+        "Decompresses a stream created by Primitives.compress() or compressData() "
+        "on the host."
+        "\n\nParameters\n----------\n"
+        "stream: ndarray\n"
+        "    Compressed stream\n"
+        "data: ndarray\n"
+        "    Destination of the words. Must hold getDecompressedSize() bytes.\n");
+}
@@ -1,5 +1,8 @@
 #include <nanobind/nanobind.h>
+#include <nanobind/ndarray.h>
+#include <nanobind/stl/filesystem.h>
 #include <nanobind/stl/optional.h>
+#include <nanobind/stl/shared_ptr.h>
 #include <nanobind/stl/string.h>
 #include <nanobind/stl/string_view.h>
 #include <nanobind/stl/vector.h>
@@ -7,7 +10,11 @@
 #include <algorithm>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 
+#include <hephaistos/command.hpp>
+#include <hephaistos/compiler.hpp>
+#include <hephaistos/image.hpp>
 #include <hephaistos/program.hpp>
 #include "context.hpp"
 
@@ -25,14 +32,105 @@ hp::SubgroupProperties getSubgroupProperties(uint32_t i) {
     return hp::getSubgroupProperties(devices[i]);
 }
 
+bool isDescriptorBufferSupported(std::optional<uint32_t> id) {
+    auto& devices = getDevices();
+    if (id) {
+        if (id >= devices.size())
+            throw std::runtime_error("There is no device with the selected id!");
+        return hp::isDescriptorBufferSupported(devices[*id]);
+    }
+    else {
+        //check if any device is supported
+        for (auto& dev : devices) {
+            if (hp::isDescriptorBufferSupported(dev))
+                return true;
+        }
+        return false;
+    }
+}
+
+bool isShaderObjectSupported(std::optional<uint32_t> id) {
+    auto& devices = getDevices();
+    if (id) {
+        if (id >= devices.size())
+            throw std::runtime_error("There is no device with the selected id!");
+        return hp::isShaderObjectSupported(devices[*id]);
+    }
+    else {
+        //check if any device is supported
+        for (auto& dev : devices) {
+            if (hp::isShaderObjectSupported(dev))
+                return true;
+        }
+        return false;
+    }
+}
+
+bool isResourceHeapSupported(std::optional<uint32_t> id) {
+    auto& devices = getDevices();
+    if (id) {
+        if (id >= devices.size())
+            throw std::runtime_error("There is no device with the selected id!");
+        return hp::isResourceHeapSupported(devices[*id]);
+    }
+    else {
+        //check if any device is supported
+        for (auto& dev : devices) {
+            if (hp::isResourceHeapSupported(dev))
+                return true;
+        }
+        return false;
+    }
+}
+
+using GroupCountArray = nb::ndarray<const uint32_t, nb::shape<-1, 3>, nb::c_contig, nb::device::cpu>;
+using PushArray = nb::ndarray<nb::ro, nb::c_contig, nb::device::cpu>;
+
+//creates one dispatch per row of the group counts; each dispatch references
+//its row of the push data, thus the arrays must outlive the recording
+std::vector<hp::DispatchCommand> createDispatchBatch(
+    const hp::Program& program,
+    const GroupCountArray& groupCounts,
+    const std::optional<PushArray>& push)
+{
+    auto count = groupCounts.shape(0);
+    size_t pushSize = 0;
+    auto pushData = static_cast<const std::byte*>(nullptr);
+    if (push) {
+        if (push->ndim() == 0 || push->shape(0) != count)
+            throw std::invalid_argument("Push data must have one row per dispatch!");
+        pushSize = count ? push->nbytes() / count : 0;
+        pushData = static_cast<const std::byte*>(push->data());
+    }
+
+    std::vector<hp::DispatchCommand> dispatches;
+    dispatches.reserve(count);
+    auto groups = groupCounts.data();
+    for (auto i = 0u; i < count; ++i, groups += 3) {
+        dispatches.push_back(program.dispatch(
+            std::span<const std::byte>{ pushData + i * pushSize, pushSize },
+            groups[0], groups[1], groups[2]));
+    }
+    return dispatches;
+}
+
 void printBindingType(std::ostringstream& str, hp::ParameterType type) {
     switch(type) {
     case hp::ParameterType::COMBINED_IMAGE_SAMPLER:
         str << "COMBINED_IMAGE_SAMPLER";
         break;
+    case hp::ParameterType::SAMPLED_IMAGE:
+        str << "SAMPLED_IMAGE";
+        break;
     case hp::ParameterType::STORAGE_IMAGE:
         str << "STORAGE_IMAGE";
         break;
+    case hp::ParameterType::UNIFORM_TEXEL_BUFFER:
+        str << "UNIFORM_TEXEL_BUFFER";
+        break;
+    case hp::ParameterType::STORAGE_TEXEL_BUFFER:
+        str << "STORAGE_TEXEL_BUFFER";
+        break;
     case hp::ParameterType::UNIFORM_BUFFER:
         str << "UNIFORM_BUFFER";
         break;
@@ -63,6 +161,14 @@ void registerProgramModule(nb::module_& m) {
             "List of subgroup properties and supported operations")
         .def_ro("subgroupSize", &hp::SubgroupProperties::subgroupSize,
             "Threads per subgroup")
+        .def_ro("minSubgroupSize", &hp::SubgroupProperties::minSubgroupSize,
+            "Minimum threads per subgroup a program may run with")
+        .def_ro("maxSubgroupSize", &hp::SubgroupProperties::maxSubgroupSize,
+            "Maximum threads per subgroup a program may run with")
+        .def_ro("requiredSubgroupSizeSupport", &hp::SubgroupProperties::requiredSubgroupSizeSupport,
+            "Support for requiring a subgroup size in programs")
+        .def_ro("fullSubgroupsSupport", &hp::SubgroupProperties::fullSubgroupsSupport,
+            "Support for requiring full subgroups in programs")
         .def_ro("basicSupport", &hp::SubgroupProperties::basicSupport,
             "Support for GL_KHR_shader_subgroup_basic")
         .def_ro("voteSupport", &hp::SubgroupProperties::voteSupport,
@@ -86,6 +192,10 @@ void registerProgramModule(nb::module_& m) {
         .def("__repr__", [](const hp::SubgroupProperties& props) {
             std::ostringstream str;
             str << "subgroupSize:            " << props.subgroupSize << '\n';
+            str << "minSubgroupSize:         " << props.minSubgroupSize << '\n';
+            str << "maxSubgroupSize:         " << props.maxSubgroupSize << '\n';
+            str << "requiredSubgroupSize:    " << props.requiredSubgroupSizeSupport << '\n';
+            str << "fullSubgroups:           " << props.fullSubgroupsSupport << '\n';
             str << "basicSupport:            " << props.basicSupport << '\n';
             str << "voteSupport:             " << props.voteSupport << '\n';
             str << "arithmeticSupport:       " << props.arithmeticSupport << '\n';
@@ -107,7 +217,10 @@ void registerProgramModule(nb::module_& m) {
 
     nb::enum_<hp::ParameterType>(m, "ParameterType", "Type of parameter")
         .value("COMBINED_IMAGE_SAMPLER", hp::ParameterType::COMBINED_IMAGE_SAMPLER)
+        .value("SAMPLED_IMAGE", hp::ParameterType::SAMPLED_IMAGE)
         .value("STORAGE_IMAGE", hp::ParameterType::STORAGE_IMAGE)
+        .value("UNIFORM_TEXEL_BUFFER", hp::ParameterType::UNIFORM_TEXEL_BUFFER)
+        .value("STORAGE_TEXEL_BUFFER", hp::ParameterType::STORAGE_TEXEL_BUFFER)
         .value("UNIFORM_BUFFER", hp::ParameterType::UNIFORM_BUFFER)
         .value("STORAGE_BUFFER", hp::ParameterType::STORAGE_BUFFER)
         .value("ACCELERATION_STRUCTURE", hp::ParameterType::ACCELERATION_STRUCTURE);
@@ -115,8 +228,46 @@ void registerProgramModule(nb::module_& m) {
     nb::class_<hp::ImageBindingTraits>(m, "ImageBindingTraits",
             "Properties a binding expects from a bound image")
         .def_ro("format", &hp::ImageBindingTraits::format, "Expected image format")
-        .def_ro("dims", &hp::ImageBindingTraits::dims, "Image dimensions");
+        .def_ro("dims", &hp::ImageBindingTraits::dims, "Image dimensions")
+        .def_ro("arrayed", &hp::ImageBindingTraits::arrayed, "Whether the image is an array");
     
+    nb::enum_<hp::MemberType>(m, "MemberType", "Base type of a block member")
+        .value("STRUCT", hp::MemberType::STRUCT)
+        .value("BOOL", hp::MemberType::BOOL)
+        .value("INT", hp::MemberType::INT)
+        .value("UINT", hp::MemberType::UINT)
+        .value("FLOAT", hp::MemberType::FLOAT);
+
+    nb::class_<hp::BlockMember>(m, "BlockMember",
+            "Layout of a single member of a buffer or push constant block")
+        .def_ro("name", &hp::BlockMember::name, "Name of the member. Might be empty.")
+        .def_ro("offset", &hp::BlockMember::offset,
+            "Offset in bytes relative to the enclosing block or struct")
+        .def_ro("size", &hp::BlockMember::size,
+            "Size in bytes including all array elements. Zero for runtime arrays.")
+        .def_ro("type", &hp::BlockMember::type, "Base type of the member")
+        .def_ro("width", &hp::BlockMember::width,
+            "Size of a single scalar in bits. Zero for structs.")
+        .def_ro("components", &hp::BlockMember::components,
+            "Amount of vector components or matrix rows")
+        .def_ro("columns", &hp::BlockMember::columns,
+            "Amount of matrix columns; one if not a matrix")
+        .def_ro("matrixStride", &hp::BlockMember::matrixStride,
+            "Bytes between consecutive columns, or rows if row major")
+        .def_ro("rowMajor", &hp::BlockMember::rowMajor,
+            "Whether the matrix is stored in row major order")
+        .def_ro("arrayDims", &hp::BlockMember::arrayDims,
+            "Size of each array dimension, outermost first. Zero denotes a runtime array.")
+        .def_ro("arrayStride", &hp::BlockMember::arrayStride,
+            "Bytes between consecutive array elements")
+        .def_ro("members", &hp::BlockMember::members,
+            "Members of a struct in declaration order")
+        .def("__repr__", [](const hp::BlockMember& b) {
+            std::ostringstream str;
+            str << b.offset << ": " << b.name << " (" << b.size << " bytes)";
+            return str.str();
+        });
+
     nb::class_<hp::BindingTraits>(m, "BindingTraits",
             "Properties of binding found in programs")
         .def_ro("name", &hp::BindingTraits::name, "Name of the binding. Might be empty.")
@@ -126,6 +277,8 @@ void registerProgramModule(nb::module_& m) {
             "Properties of the image if one is expected")
         .def_ro("count", &hp::BindingTraits::count,
             "Number of elements in binding, i.e. array size")
+        .def_ro("members", &hp::BindingTraits::members,
+            "Layout of the block members. Only set for uniform and storage buffers.")
         .def("__repr__", [](const hp::BindingTraits& b){
             std::ostringstream str;
             printBinding(str, b);
@@ -145,6 +298,35 @@ void registerProgramModule(nb::module_& m) {
             return str.str();
         });
 
+    nb::class_<hp::ProgramStatistic>(m, "ProgramStatistic",
+            "Statistic about a compiled program reported by the driver")
+        .def_ro("name", &hp::ProgramStatistic::name, "Name of the statistic")
+        .def_ro("description", &hp::ProgramStatistic::description,
+            "Description of the statistic")
+        .def_ro("value", &hp::ProgramStatistic::value, "Value of the statistic")
+        .def("__repr__", [](const hp::ProgramStatistic& s) {
+            return s.name + ": " + std::to_string(s.value);
+        });
+
+    nb::class_<hp::ProgramStatistics>(m, "ProgramStatistics",
+            "Resource usage and expected occupancy of a program. The occupancy "
+            "assumes 2048 resident threads per compute unit and the device's "
+            "shared memory limit per compute unit and does not account for "
+            "registers.")
+        .def_ro("sharedMemorySize", &hp::ProgramStatistics::sharedMemorySize,
+            "Bytes of shared memory used by a single workgroup. Arrays sized by "
+            "specialization constants use their default size.")
+        .def_ro("registerCount", &hp::ProgramStatistics::registerCount,
+            "Registers used per thread if reported by the driver")
+        .def_ro("residentGroups", &hp::ProgramStatistics::residentGroups,
+            "Workgroups expected to be resident on a compute unit at once")
+        .def_ro("occupancy", &hp::ProgramStatistics::occupancy,
+            "Fraction of a compute unit's thread slots filled by resident workgroups")
+        .def_ro("driverStatistics", &hp::ProgramStatistics::driverStatistics,
+            "Statistics reported by the driver. Empty if "
+            "VK_KHR_pipeline_executable_properties is not supported or the program "
+            "was created as shader object.");
+
     nb::class_<hp::DispatchCommand, hp::Command>(m, "DispatchCommand",
             "Command for executing a program using the given group size")
         .def_rw("groupCountX", &hp::DispatchCommand::groupCountX,
@@ -161,6 +343,24 @@ void registerProgramModule(nb::module_& m) {
             "Tensor from which to read the group size")
         .def_rw("offset", &hp::DispatchIndirectCommand::offset,
             "Offset into the Tensor in bytes on where to start reading");
+
+    nb::class_<hp::DispatchIndirectListCommand, hp::Command>(m, "DispatchIndirectListCommand",
+            "Command for running a list of indirect dispatches at once. Programs running "
+            "earlier can decide which dispatches run by writing zero groups for the others.");
+    m.def("dispatchIndirectList",
+        [](nb::list list) -> hp::DispatchIndirectListCommand {
+            std::vector<hp::DispatchIndirectCommand> dispatches;
+            dispatches.reserve(list.size());
+            for (auto item : list)
+                dispatches.push_back(nb::cast<const hp::DispatchIndirectCommand&>(item));
+            return hp::DispatchIndirectListCommand(std::move(dispatches));
+        }, nb::keep_alive<0,1>(), //dispatches keep their push data and tensors alive
+        "dispatches"_a,
+        "Creates a command running the given indirect dispatches in order, while "
+        "synchronizing the indirect data only once for the whole list."
+        "\n\nParameters\n----------\n"
+        "dispatches: DispatchIndirectCommand[]\n"
+        "    Dispatches to run in the given order\n");
     
     nb::class_<hp::Program>(m, "Program",
             "Encapsulates a shader program enabling introspection into its "
@@ -181,7 +381,23 @@ void registerProgramModule(nb::module_& m) {
             "code: bytes\n"
             "    Byte code of the program\n")
         .def("__init__",
-            [](hp::Program* p, nb::bytes code, nb::bytes spec) {
+            [](hp::Program* p, nb::bytes code, std::optional<nb::bytes> spec,
+                uint32_t subgroupSize, bool fullSubgroups, std::optional<nb::bytes> bin)
+            {
+                std::span<const std::byte> specialization{};
+                if (spec) {
+                    specialization = {
+                        reinterpret_cast<const std::byte*>(spec->c_str()),
+                        spec->size()
+                    };
+                }
+                std::span<const std::byte> binary{};
+                if (bin) {
+                    binary = {
+                        reinterpret_cast<const std::byte*>(bin->c_str()),
+                        bin->size()
+                    };
+                }
                 nb::gil_scoped_release release;
                 new (p) hp::Program(
                     getCurrentContext(),
@@ -189,24 +405,43 @@ void registerProgramModule(nb::module_& m) {
                         reinterpret_cast<const uint32_t*>(code.c_str()),
                         code.size() / 4
                     },
-                    std::span<const std::byte>{
-                        reinterpret_cast<const std::byte*>(spec.c_str()),
-                        spec.size()
-                    }
+                    specialization,
+                    hp::SubgroupRequirements{
+                        .size = subgroupSize,
+                        .fullSubgroups = fullSubgroups
+                    },
+                    binary
                 );
-            }, "code"_a, "specialization"_a,
+            }, "code"_a, "specialization"_a.none() = nb::none(),
+            "subgroupSize"_a = 0, "fullSubgroups"_a = false,
+            "binary"_a.none() = nb::none(),
             "Creates a new program using the shader's byte code"
             "\n\nParameters\n----------\n"
             "code: bytes\n"
             "    Byte code of the program\n"
-            "specialization: bytes\n"
-            "    Data used for filling in specialization constants")
+            "specialization: bytes | None, default=None\n"
+            "    Data used for filling in specialization constants\n"
+            "subgroupSize: int, default=0\n"
+            "    Threads per subgroup the program must run with. Zero lets the driver choose.\n"
+            "fullSubgroups: bool, default=False\n"
+            "    If True, all subgroups of a workgroup must be full\n"
+            "binary: bytes | None, default=None\n"
+            "    Shader object binary retrieved via getShaderBinary() used instead of\n"
+            "    compiling the code. Ignored if incompatible or shader objects are disabled.\n")
         .def_prop_ro("localSize",
             [](const hp::Program& p) { return p.getLocalSize(); },
             "Returns the size of the local work group.")
         .def_prop_ro("bindings",
             [](const hp::Program& p){ return p.listBindings(); },
             "Returns a list of all bindings.")
+        .def_prop_ro("pushConstantSize", &hp::Program::getPushConstantSize,
+            "Size of the push constant block in bytes. Zero if not used.")
+        .def_prop_ro("pushConstantMembers",
+            [](const hp::Program& p) { return p.getPushConstantMembers(); },
+            "Layout of the push constant block members.")
+        .def_prop_ro("usesDescriptorSetCache", &hp::Program::usesDescriptorSetCache,
+            "True, if the program binds cached descriptor sets instead of "
+            "pushing its parameters.")
         .def("isBindingBound", [](const hp::Program& p, uint32_t i){
                 return p.isBindingBound(i);
             }, "i"_a, "Checks wether the i-th binding is bound")
@@ -249,6 +484,133 @@ void registerProgramModule(nb::module_& m) {
             "    Number of groups to dispatch in Y dimension\n"
             "z: int, default=1\n"
             "    Number of groups to dispatch in Z dimension\n")
+        .def("dispatchElements",
+            [](const hp::Program& p, uint32_t nx, uint32_t ny, uint32_t nz)
+                -> hp::DispatchCommand
+                { return p.dispatchElements(nx, ny, nz); },
+            "nx"_a, "ny"_a = 1, "nz"_a = 1,
+            "Dispatches a program execution covering the given amount of elements. "
+            "The amount of workgroups is derived from the local size, rounding up. "
+            "Shaders must thus check for out of bounds invocations."
+            "\n\nParameters\n----------\n"
+            "nx: int\n"
+            "    Number of elements in X dimension\n"
+            "ny: int, default=1\n"
+            "    Number of elements in Y dimension\n"
+            "nz: int, default=1\n"
+            "    Number of elements in Z dimension\n")
+        .def("dispatchElementsPush",
+            [](const hp::Program& p, nb::bytes push, uint32_t nx, uint32_t ny, uint32_t nz)
+                -> hp::DispatchCommand
+                {
+                    return p.dispatchElements(
+                        std::span<const std::byte>{
+                            reinterpret_cast<const std::byte*>(push.c_str()),
+                            push.size()
+                        },
+                        nx, ny, nz
+                    );
+                }, nb::keep_alive<0,2>(), //keep push bytes as long alive as the dispatch command
+            "push"_a, "nx"_a, "ny"_a = 1, "nz"_a = 1,
+            "Dispatches a program execution with the given push data covering the "
+            "given amount of elements."
+            "\n\nParameters\n----------\n"
+            "push: bytes\n"
+            "   Data pushed to the dispatch as bytes\n"
+            "nx: int\n"
+            "    Number of elements in X dimension\n"
+            "ny: int, default=1\n"
+            "    Number of elements in Y dimension\n"
+            "nz: int, default=1\n"
+            "    Number of elements in Z dimension\n")
+        .def("dispatch",
+            [](const hp::Program& p, const hp::ParameterSet& s, uint32_t x, uint32_t y, uint32_t z)
+                -> hp::DispatchCommand
+                { return p.dispatch(s, x, y, z); },
+            nb::keep_alive<0,2>(), //dispatch references the set
+            "set"_a, "x"_a = 1, "y"_a = 1, "z"_a = 1,
+            "Dispatches a program execution with the given amount of workgroups using "
+            "the parameters of the given set, which are read once the dispatch runs. "
+            "Updating the set thus does not require recording the dispatch again."
+            "\n\nParameters\n----------\n"
+            "set: ParameterSet\n"
+            "    Set providing the parameters\n"
+            "x: int, default=1\n"
+            "    Number of groups to dispatch in X dimension\n"
+            "y: int, default=1\n"
+            "    Number of groups to dispatch in Y dimension\n"
+            "z: int, default=1\n"
+            "    Number of groups to dispatch in Z dimension\n")
+        .def("dispatchPush",
+            [](const hp::Program& p, const hp::ParameterSet& s, nb::bytes push, uint32_t x, uint32_t y, uint32_t z)
+                -> hp::DispatchCommand
+                {
+                    return p.dispatch(s,
+                        std::span<const std::byte>{
+                            reinterpret_cast<const std::byte*>(push.c_str()),
+                            push.size()
+                        },
+                        x, y, z
+                    );
+                }, nb::keep_alive<0,2>(), nb::keep_alive<0,3>(),
+            "set"_a, "push"_a, "x"_a = 1, "y"_a = 1, "z"_a = 1,
+            "Dispatches a program execution with the given push data and amount of workgroups "
+            "using the parameters of the given set."
+            "\n\nParameters\n----------\n"
+            "set: ParameterSet\n"
+            "    Set providing the parameters\n"
+            "push: bytes\n"
+            "   Data pushed to the dispatch as bytes\n"
+            "x: int, default=1\n"
+            "    Number of groups to dispatch in X dimension\n"
+            "y: int, default=1\n"
+            "    Number of groups to dispatch in Y dimension\n"
+            "z: int, default=1\n"
+            "    Number of groups to dispatch in Z dimension\n")
+        .def("dispatch",
+            [](const hp::Program& p, const hp::ResourceHeap& h, uint32_t x, uint32_t y, uint32_t z)
+                -> hp::DispatchCommand
+                { return p.dispatch(h, x, y, z); },
+            nb::keep_alive<0,2>(), //dispatch references the heap
+            "heap"_a, "x"_a = 1, "y"_a = 1, "z"_a = 1,
+            "Dispatches a program execution with the given amount of workgroups using "
+            "the resources of the given heap instead of bound parameters."
+            "\n\nParameters\n----------\n"
+            "heap: ResourceHeap\n"
+            "    Heap providing the resources\n"
+            "x: int, default=1\n"
+            "    Number of groups to dispatch in X dimension\n"
+            "y: int, default=1\n"
+            "    Number of groups to dispatch in Y dimension\n"
+            "z: int, default=1\n"
+            "    Number of groups to dispatch in Z dimension\n")
+        .def("dispatchPush",
+            [](const hp::Program& p, const hp::ResourceHeap& h, nb::bytes push, uint32_t x, uint32_t y, uint32_t z)
+                -> hp::DispatchCommand
+                {
+                    return p.dispatch(h,
+                        std::span<const std::byte>{
+                            reinterpret_cast<const std::byte*>(push.c_str()),
+                            push.size()
+                        },
+                        x, y, z
+                    );
+                }, nb::keep_alive<0,2>(), nb::keep_alive<0,3>(),
+            "heap"_a, "push"_a, "x"_a = 1, "y"_a = 1, "z"_a = 1,
+            "Dispatches a program execution with the given push data and amount of workgroups "
+            "using the resources of the given heap. The push data usually contains the "
+            "indices of the resources to use."
+            "\n\nParameters\n----------\n"
+            "heap: ResourceHeap\n"
+            "    Heap providing the resources\n"
+            "push: bytes\n"
+            "   Data pushed to the dispatch as bytes\n"
+            "x: int, default=1\n"
+            "    Number of groups to dispatch in X dimension\n"
+            "y: int, default=1\n"
+            "    Number of groups to dispatch in Y dimension\n"
+            "z: int, default=1\n"
+            "    Number of groups to dispatch in Z dimension\n")
         .def("dispatchIndirect",
             [](const hp::Program& p, const hp::Tensor<std::byte>& tensor, uint64_t offset)
                 -> hp::DispatchIndirectCommand
@@ -286,6 +648,99 @@ void registerProgramModule(nb::module_& m) {
             "    Tensor from which to read the amount of workgroups\n"
             "offset: int, default=0\n"
             "    Offset at which to start reading\n")
+        .def("dispatchBatch",
+            [](const hp::Program& p, const GroupCountArray& groupCounts,
+                std::optional<PushArray> push, bool simultaneous, bool trackHazards)
+                -> hp::Subroutine
+                {
+                    auto dispatches = createDispatchBatch(p, groupCounts, push);
+                    nb::gil_scoped_release release;
+                    hp::SubroutineBuilder builder(getCurrentContext(), simultaneous);
+                    if (trackHazards)
+                        builder.trackHazards();
+                    for (auto& dispatch : dispatches)
+                        builder.addCommand(dispatch);
+                    return builder.finish();
+                },
+            "groupCounts"_a, "push"_a.none() = nb::none(), nb::kw_only(),
+            "simultaneous"_a = false, "trackHazards"_a = false,
+            "Records a dispatch for each row of the given arrays into a new "
+            "subroutine using a single call. Much faster than creating each "
+            "dispatch on its own when issuing many of them."
+            "\n\nParameters\n----------\n"
+            "groupCounts: ndarray[uint32]\n"
+            "    Amount of workgroups in X, Y and Z dimension per dispatch as array\n"
+            "    of shape (n, 3)\n"
+            "push: ndarray | None, default=None\n"
+            "    Push data of each dispatch as C contiguous array with one row per\n"
+            "    dispatch, e.g. a structured array\n"
+            "simultaneous: bool, default=False\n"
+            "    True, if the subroutine can be submitted while a previous submission\n"
+            "    has not yet finished\n"
+            "trackHazards: bool, default=False\n"
+            "    True, if barriers should only be recorded between dispatches actually\n"
+            "    depending on each other\n")
+        .def("dispatchBatch",
+            [](const hp::Program& p, hp::SequenceBuilder& sequence,
+                const GroupCountArray& groupCounts, std::optional<PushArray> push)
+                -> hp::SequenceBuilder&
+                {
+                    auto dispatches = createDispatchBatch(p, groupCounts, push);
+                    nb::gil_scoped_release release;
+                    for (auto& dispatch : dispatches)
+                        sequence.And(dispatch);
+                    return sequence;
+                },
+            "sequence"_a, "groupCounts"_a, "push"_a.none() = nb::none(),
+            nb::rv_policy::reference,
+            "Issues a dispatch for each row of the given arrays in the current step "
+            "of the sequence using a single call. Returns the sequence."
+            "\n\nParameters\n----------\n"
+            "sequence: SequenceBuilder\n"
+            "    Sequence to record the dispatches into\n"
+            "groupCounts: ndarray[uint32]\n"
+            "    Amount of workgroups in X, Y and Z dimension per dispatch as array\n"
+            "    of shape (n, 3)\n"
+            "push: ndarray | None, default=None\n"
+            "    Push data of each dispatch as C contiguous array with one row per\n"
+            "    dispatch, e.g. a structured array\n")
+        .def("reload",
+            [](hp::Program& p, nb::bytes code, std::optional<nb::bytes> spec) {
+                std::span<const std::byte> specialization{};
+                if (spec) {
+                    specialization = {
+                        reinterpret_cast<const std::byte*>(spec->c_str()),
+                        spec->size()
+                    };
+                }
+                nb::gil_scoped_release release;
+                p.reload(
+                    std::span<const uint32_t>{
+                        reinterpret_cast<const uint32_t*>(code.c_str()),
+                        code.size() / 4
+                    },
+                    specialization
+                );
+            }, "code"_a, "specialization"_a.none() = nb::none(),
+            "Replaces the program's code. Bound parameters are kept if the new code "
+            "declares the same bindings, otherwise they get reset. The previous code "
+            "stays alive, so pending submissions and recorded subroutines still use it."
+            "\n\nParameters\n----------\n"
+            "code: bytes\n"
+            "    Byte code of the program\n"
+            "specialization: bytes | None, default=None\n"
+            "    Data used for filling in specialization constants\n")
+        .def("getShaderBinary",
+            [](const hp::Program& p) -> nb::bytes {
+                auto binary = p.getShaderBinary();
+                return nb::bytes(binary.data(), binary.size());
+            },
+            "Returns the binary of the program's shader object, which can be passed "
+            "on creating the same program again to skip compilation. Only available "
+            "if shader objects are enabled.")
+        .def("getStatistics", &hp::Program::getStatistics,
+            "Returns the resource usage and expected occupancy. Queries the "
+            "driver's statistics on each call.")
         .def("__repr__", [](const hp::Program& p) {
             std::ostringstream str;
             auto& ls = p.getLocalSize();
@@ -294,7 +749,403 @@ void registerProgramModule(nb::module_& m) {
                 printBinding(str, b);
             return str.str();
         });
-    
+
+    m.def("isDescriptorBufferSupported", &isDescriptorBufferSupported,
+        "id"_a.none() = nb::none(),
+        "Checks wether any or the given device supports descriptor buffers.");
+    m.def("isDescriptorBufferEnabled",
+        []() -> bool { return hp::isDescriptorBufferEnabled(getCurrentContext()); },
+        "Checks wether descriptor buffers were enabled. Note that this creates the context.");
+    m.def("enableDescriptorBuffer",
+        [](bool force) { addExtension(hp::createDescriptorBufferExtension(), force); },
+        "force"_a = false,
+        "Enables storing descriptors of parameter sets in descriptor buffers, so "
+        "dispatches using them only bind offsets. (Lazy) context creation fails if not "
+        "supported. Set force=True if an existing context should be destroyed.");
+
+    m.def("isShaderObjectSupported", &isShaderObjectSupported,
+        "id"_a.none() = nb::none(),
+        "Checks wether any or the given device supports shader objects.");
+    m.def("isShaderObjectEnabled",
+        []() -> bool { return hp::isShaderObjectEnabled(getCurrentContext()); },
+        "Checks wether shader objects were enabled. Note that this creates the context.");
+    m.def("enableShaderObject",
+        [](bool force) { addExtension(hp::createShaderObjectExtension(), force); },
+        "force"_a = false,
+        "Enables creating programs as shader objects instead of pipelines, which "
+        "speeds up program creation. (Lazy) context creation fails if not "
+        "supported. Set force=True if an existing context should be destroyed.");
+
+    m.def("isResourceHeapSupported", &isResourceHeapSupported,
+        "id"_a.none() = nb::none(),
+        "Checks wether any or the given device supports resource heaps.");
+    m.def("isResourceHeapEnabled",
+        []() -> bool { return hp::isResourceHeapEnabled(getCurrentContext()); },
+        "Checks wether resource heaps were enabled. Note that this creates the context.");
+    m.def("enableResourceHeap",
+        [](uint32_t capacity, bool force) { addExtension(hp::createResourceHeapExtension(capacity), force); },
+        "capacity"_a = 4096, "force"_a = false,
+        "Enables resource heaps holding up to capacity resources of each type, which "
+        "programs index into instead of binding parameters. (Lazy) context creation "
+        "fails if not supported. Set force=True if an existing context should be destroyed.");
+
+    m.def("isPartiallyBoundEnabled",
+        []() -> bool { return hp::isPartiallyBoundEnabled(getCurrentContext()); },
+        "Checks wether array bindings can be bound partially. Note that this creates the context.");
+
+    m.def("createPrograms",
+        [](const std::vector<nb::bytes>& code,
+            std::optional<std::vector<nb::bytes>> specialization,
+            uint32_t threads
+        ) {
+            if (specialization && specialization->size() != code.size())
+                throw std::runtime_error("Amount of specializations must match amount of programs!");
+            std::vector<hp::ProgramSource> sources(code.size());
+            for (auto i = 0u; i < code.size(); ++i) {
+                sources[i].code = {
+                    reinterpret_cast<const uint32_t*>(code[i].c_str()),
+                    code[i].size() / 4
+                };
+                if (specialization) {
+                    sources[i].specialization = {
+                        reinterpret_cast<const std::byte*>((*specialization)[i].c_str()),
+                        (*specialization)[i].size()
+                    };
+                }
+            }
+            std::vector<hp::Program> programs;
+            {
+                nb::gil_scoped_release release;
+                programs = hp::createPrograms(getCurrentContext(), sources, threads);
+            }
+            nb::list result;
+            for (auto& program : programs)
+                result.append(nb::cast(std::move(program)));
+            return result;
+        }, "code"_a, "specialization"_a.none() = nb::none(), "threads"_a = 0,
+        "Creates multiple programs in parallel sharing the pipeline cache. Returns the "
+        "programs in the same order as the given code."
+        "\n\nParameters\n----------\n"
+        "code: list[bytes]\n"
+        "    Byte code of the programs\n"
+        "specialization: list[bytes] | None, default=None\n"
+        "    Data used for filling in specialization constants of each program\n"
+        "threads: int, default=0\n"
+        "    Maximum amount of threads to use. Zero uses one per core.\n");
+
+    nb::class_<hp::ProgramBundle>(m, "ProgramBundle",
+            "Collection of named programs including their reflection, which can be "
+            "saved to a file and created all at once later on. Programs created from "
+            "a bundle skip reflecting their code and get compiled in parallel against "
+            "the context's pipeline cache.")
+        .def(nb::init<>(), "Creates a new empty bundle")
+        .def("__init__",
+            [](hp::ProgramBundle* b, const std::filesystem::path& path) {
+                new (b) hp::ProgramBundle(path);
+            }, "path"_a, "Loads a bundle from a file written by save()")
+        .def_static("fromBytes",
+            [](nb::bytes data) {
+                return hp::ProgramBundle(std::span<const std::byte>{
+                    reinterpret_cast<const std::byte*>(data.c_str()),
+                    data.size()
+                });
+            }, "data"_a, "Loads a bundle from data created by serialize()")
+        .def("__len__", &hp::ProgramBundle::size)
+        .def("__contains__", &hp::ProgramBundle::contains, "name"_a)
+        .def_prop_ro("names", &hp::ProgramBundle::getNames,
+            "Names of all programs in the order they were added")
+        .def("add",
+            [](hp::ProgramBundle& b, std::string name, nb::bytes code,
+                std::optional<nb::bytes> spec, uint32_t subgroupSize, bool fullSubgroups)
+            {
+                std::span<const std::byte> specialization{};
+                if (spec) {
+                    specialization = {
+                        reinterpret_cast<const std::byte*>(spec->c_str()),
+                        spec->size()
+                    };
+                }
+                b.add(std::move(name),
+                    std::span<const uint32_t>{
+                        reinterpret_cast<const uint32_t*>(code.c_str()),
+                        code.size() / 4
+                    },
+                    specialization,
+                    hp::SubgroupRequirements{
+                        .size = subgroupSize,
+                        .fullSubgroups = fullSubgroups
+                    });
+            }, "name"_a, "code"_a, "specialization"_a.none() = nb::none(),
+            "subgroupSize"_a = 0, "fullSubgroups"_a = false,
+            "Adds a program to the bundle. Reflects the code right away."
+            "\n\nParameters\n----------\n"
+            "name: str\n"
+            "    Name used to identify the program\n"
+            "code: bytes\n"
+            "    Byte code of the program\n"
+            "specialization: bytes | None, default=None\n"
+            "    Data used for filling in specialization constants\n"
+            "subgroupSize: int, default=0\n"
+            "    Threads per subgroup the program must run with. Zero lets the driver choose.\n"
+            "fullSubgroups: bool, default=False\n"
+            "    If True, all subgroups of a workgroup must be full\n")
+        .def("getLocalSize",
+            [](const hp::ProgramBundle& b, std::string_view name) { return b.getLocalSize(name); },
+            "name"_a, "Returns the local size of the given program")
+        .def("getBindings",
+            [](const hp::ProgramBundle& b, std::string_view name) {
+                auto traits = b.getBindingTraits(name);
+                return std::vector<hp::BindingTraits>(traits.begin(), traits.end());
+            }, "name"_a, "Returns the traits of all bindings of the given program")
+        .def("createProgram",
+            [](const hp::ProgramBundle& b, std::string_view name) {
+                nb::gil_scoped_release release;
+                return b.createProgram(getCurrentContext(), name);
+            }, "name"_a, "Creates the program of the given name")
+        .def("createPrograms",
+            [](const hp::ProgramBundle& b, uint32_t threads) {
+                std::vector<hp::Program> programs;
+                {
+                    nb::gil_scoped_release release;
+                    programs = b.createPrograms(getCurrentContext(), threads);
+                }
+                nb::list result;
+                for (auto& program : programs)
+                    result.append(nb::cast(std::move(program)));
+                return result;
+            }, "threads"_a = 0,
+            "Creates all programs of the bundle in parallel and returns them in the "
+            "order they were added."
+            "\n\nParameters\n----------\n"
+            "threads: int, default=0\n"
+            "    Maximum amount of threads to use. Zero uses one per core.\n")
+        .def("warmUp",
+            [](const hp::ProgramBundle& b, uint32_t threads) {
+                nb::gil_scoped_release release;
+                b.warmUp(getCurrentContext(), threads).get();
+            }, "threads"_a = 0,
+            "Compiles all programs, leaving them in the context's pipeline cache, so "
+            "programs created afterwards skip compiling. Blocks until finished, but "
+            "releases the GIL, thus can be run on a separate thread."
+            "\n\nParameters\n----------\n"
+            "threads: int, default=0\n"
+            "    Maximum amount of threads to use. Zero uses one per core.\n")
+        .def("serialize",
+            [](const hp::ProgramBundle& b) {
+                auto data = b.serialize();
+                return nb::bytes(reinterpret_cast<const char*>(data.data()), data.size());
+            }, "Serializes the bundle into bytes")
+        .def("save", &hp::ProgramBundle::save, "path"_a,
+            "Saves the bundle to the given file");
+
+    nb::class_<hp::ProgramFamily>(m, "ProgramFamily",
+            "Family of programs sharing the same code but differing in their "
+            "specialization. Creates a variant for each distinct specialization on "
+            "its first request and returns the same one afterwards."
+            "\n\nParameters\n----------\n"
+            "code: bytes\n"
+            "    Byte code shared by all variants\n"
+            "subgroupSize: int, default=0\n"
+            "    Threads per subgroup the variants must run with. Zero lets the driver choose.\n"
+            "fullSubgroups: bool, default=False\n"
+            "    If True, all subgroups of a workgroup must be full\n")
+        .def("__init__",
+            [](hp::ProgramFamily* f, nb::bytes code, uint32_t subgroupSize, bool fullSubgroups) {
+                new (f) hp::ProgramFamily(getCurrentContext(),
+                    std::span<const uint32_t>{
+                        reinterpret_cast<const uint32_t*>(code.c_str()),
+                        code.size() / 4
+                    },
+                    hp::SubgroupRequirements{
+                        .size = subgroupSize,
+                        .fullSubgroups = fullSubgroups
+                    });
+            }, "code"_a, "subgroupSize"_a = 0, "fullSubgroups"_a = false)
+        .def("__len__", &hp::ProgramFamily::size)
+        .def("getVariant",
+            [](hp::ProgramFamily& f, std::optional<nb::bytes> spec) -> hp::Program& {
+                std::span<const std::byte> specialization{};
+                if (spec) {
+                    specialization = {
+                        reinterpret_cast<const std::byte*>(spec->c_str()),
+                        spec->size()
+                    };
+                }
+                nb::gil_scoped_release release;
+                return f.getVariant(specialization);
+            }, "specialization"_a.none() = nb::none(), nb::rv_policy::reference_internal,
+            "Returns the variant for the given specialization data, creating it on "
+            "the first request."
+            "\n\nParameters\n----------\n"
+            "specialization: bytes | None, default=None\n"
+            "    Data used for filling in specialization constants\n")
+        .def("clear", &hp::ProgramFamily::clear,
+            "Destroys all variants. Previously returned ones must not be used anymore.");
+
+    nb::class_<hp::ProgramCacheStatistics>(m, "ProgramCacheStatistics",
+            "Counters of a ProgramCache")
+        .def_ro("hits", &hp::ProgramCacheStatistics::hits,
+            "Requests served by a cached program")
+        .def_ro("misses", &hp::ProgramCacheStatistics::misses,
+            "Requests creating a new program")
+        .def_ro("evictions", &hp::ProgramCacheStatistics::evictions,
+            "Programs dropped to stay within the limits");
+
+    nb::class_<hp::ProgramCache>(m, "ProgramCache",
+            "Cache of programs keyed by their code, specialization and subgroup "
+            "requirements. Returns the same program for identical requests and drops "
+            "the least recently used ones once it exceeds its limits. Programs are "
+            "shared between requests including their bound parameters."
+            "\n\nParameters\n----------\n"
+            "maxPrograms: int, default=256\n"
+            "    Maximum amount of cached programs. Zero means no limit.\n"
+            "maxCodeSize: int, default=0\n"
+            "    Maximum total size of the cached code in bytes. Zero means no limit.\n")
+        .def("__init__",
+            [](hp::ProgramCache* c, uint32_t maxPrograms, uint64_t maxCodeSize) {
+                new (c) hp::ProgramCache(getCurrentContext(), {
+                    .maxPrograms = maxPrograms,
+                    .maxCodeSize = maxCodeSize
+                });
+            }, "maxPrograms"_a = 256, "maxCodeSize"_a = 0)
+        .def("__len__", &hp::ProgramCache::size)
+        .def_prop_ro("codeSize", &hp::ProgramCache::getCodeSize,
+            "Total size of the cached programs' code in bytes")
+        .def_prop_ro("statistics", &hp::ProgramCache::getStatistics,
+            "Hits, misses and evictions counted so far")
+        .def_prop_ro("maxPrograms",
+            [](const hp::ProgramCache& c) { return c.getLimits().maxPrograms; },
+            "Maximum amount of cached programs. Zero means no limit.")
+        .def_prop_ro("maxCodeSize",
+            [](const hp::ProgramCache& c) { return c.getLimits().maxCodeSize; },
+            "Maximum total size of the cached code in bytes. Zero means no limit.")
+        .def("setLimits",
+            [](hp::ProgramCache& c, uint32_t maxPrograms, uint64_t maxCodeSize) {
+                c.setLimits({ .maxPrograms = maxPrograms, .maxCodeSize = maxCodeSize });
+            }, "maxPrograms"_a, "maxCodeSize"_a = 0,
+            "Sets the limits of the cache dropping the least recently used programs "
+            "until they are met."
+            "\n\nParameters\n----------\n"
+            "maxPrograms: int\n"
+            "    Maximum amount of cached programs. Zero means no limit.\n"
+            "maxCodeSize: int, default=0\n"
+            "    Maximum total size of the cached code in bytes. Zero means no limit.\n")
+        .def("get",
+            [](hp::ProgramCache& c, nb::bytes code, std::optional<nb::bytes> spec,
+                uint32_t subgroupSize, bool fullSubgroups)
+            {
+                std::span<const std::byte> specialization{};
+                if (spec) {
+                    specialization = {
+                        reinterpret_cast<const std::byte*>(spec->c_str()),
+                        spec->size()
+                    };
+                }
+                nb::gil_scoped_release release;
+                return c.get(
+                    std::span<const uint32_t>{
+                        reinterpret_cast<const uint32_t*>(code.c_str()),
+                        code.size() / 4
+                    },
+                    specialization,
+                    hp::SubgroupRequirements{
+                        .size = subgroupSize,
+                        .fullSubgroups = fullSubgroups
+                    });
+            }, "code"_a, "specialization"_a.none() = nb::none(),
+            "subgroupSize"_a = 0, "fullSubgroups"_a = false,
+            "Returns the program for the given code and specialization, creating it "
+            "if it is not cached."
+            "\n\nParameters\n----------\n"
+            "code: bytes\n"
+            "    Compiled shader byte code\n"
+            "specialization: bytes | None, default=None\n"
+            "    Data used for filling in specialization constants\n"
+            "subgroupSize: int, default=0\n"
+            "    Threads per subgroup the program must run with. Zero lets the driver choose.\n"
+            "fullSubgroups: bool, default=False\n"
+            "    If True, all subgroups of a workgroup must be full\n")
+        .def("compile",
+            [](hp::ProgramCache& c, const hp::Compiler& compiler, std::string_view source,
+                std::optional<nb::bytes> spec)
+            {
+                std::span<const std::byte> specialization{};
+                if (spec) {
+                    specialization = {
+                        reinterpret_cast<const std::byte*>(spec->c_str()),
+                        spec->size()
+                    };
+                }
+                nb::gil_scoped_release release;
+                return c.compile(compiler, source, specialization);
+            }, "compiler"_a, "source"_a, "specialization"_a.none() = nb::none(),
+            "Returns the program compiled from the given GLSL source code. Skips "
+            "compiling if the same source was compiled with the same compiler settings "
+            "for a program still in the cache."
+            "\n\nParameters\n----------\n"
+            "compiler: Compiler\n"
+            "    Compiler used for compiling the source code\n"
+            "source: str\n"
+            "    GLSL source code\n"
+            "specialization: bytes | None, default=None\n"
+            "    Data used for filling in specialization constants\n")
+        .def("clear", &hp::ProgramCache::clear,
+            "Drops all cached programs. Programs still referenced stay alive.");
+
+    nb::class_<hp::ParameterSet>(m, "ParameterSet",
+            "Set of parameters a program can be dispatched with. Dispatches using "
+            "a set read its parameters once they run, allowing to change them "
+            "without recording the dispatch again. Changes take effect after "
+            "calling update(), which must not happen while work using the set "
+            "is still pending.")
+        .def("__init__",
+            [](hp::ParameterSet* s, const hp::Program& p) { new (s) hp::ParameterSet(p); },
+            nb::keep_alive<1,2>(), "program"_a,
+            "Creates a new parameter set for the given program")
+        .def_prop_ro("bindings",
+            [](const hp::ParameterSet& s){ return s.listBindings(); },
+            "Returns a list of all bindings.")
+        .def("update", &hp::ParameterSet::update,
+            "Writes the bound parameters to the device. Throws if not all bindings are bound.");
+
+    nb::class_<hp::ResourceHeap>(m, "ResourceHeap",
+            "Large set of resources programs can index into. Provides storage buffers "
+            "at binding 0, storage images at binding 1 and combined image samplers at "
+            "binding 2, sharing a single index space. Resources are not tracked for hazards.")
+        .def("__init__",
+            [](hp::ResourceHeap* h) { new (h) hp::ResourceHeap(getCurrentContext()); },
+            "Creates a new empty resource heap")
+        .def_prop_ro("capacity", &hp::ResourceHeap::capacity,
+            "Maximum amount of resources in the heap")
+        .def_prop_ro("size", &hp::ResourceHeap::size,
+            "Amount of resources currently in the heap")
+        .def("add", [](hp::ResourceHeap& h, const hp::Tensor<std::byte>& t) { return h.add(t); },
+            nb::keep_alive<1,2>(), "tensor"_a,
+            "Adds the tensor to the heap and returns its index")
+        .def("add", [](hp::ResourceHeap& h, const hp::TensorView& v) { return h.add(v); },
+            nb::keep_alive<1,2>(), "view"_a,
+            "Adds the tensor view to the heap and returns its index")
+        .def("add", [](hp::ResourceHeap& h, const hp::Image& i) { return h.add(i); },
+            nb::keep_alive<1,2>(), "image"_a,
+            "Adds the image to the heap and returns its index")
+        .def("add", [](hp::ResourceHeap& h, const hp::Texture& t) { return h.add(t); },
+            nb::keep_alive<1,2>(), "texture"_a,
+            "Adds the texture to the heap and returns its index")
+        .def("set", [](hp::ResourceHeap& h, uint32_t i, const hp::Tensor<std::byte>& t) { h.set(i, t); },
+            nb::keep_alive<1,3>(), "index"_a, "tensor"_a,
+            "Replaces the resource at the given index with the tensor")
+        .def("set", [](hp::ResourceHeap& h, uint32_t i, const hp::TensorView& v) { h.set(i, v); },
+            nb::keep_alive<1,3>(), "index"_a, "view"_a,
+            "Replaces the resource at the given index with the tensor view")
+        .def("set", [](hp::ResourceHeap& h, uint32_t i, const hp::Image& img) { h.set(i, img); },
+            nb::keep_alive<1,3>(), "index"_a, "image"_a,
+            "Replaces the resource at the given index with the image")
+        .def("set", [](hp::ResourceHeap& h, uint32_t i, const hp::Texture& t) { h.set(i, t); },
+            nb::keep_alive<1,3>(), "index"_a, "texture"_a,
+            "Replaces the resource at the given index with the texture")
+        .def("remove", &hp::ResourceHeap::remove, "index"_a,
+            "Removes the resource at the given index, which might be reused by later additions");
+
     nb::class_<hp::FlushMemoryCommand, hp::Command>(m, "FlushMemoryCommand",
             "Command for flushing memory writes")
         .def("__init__",
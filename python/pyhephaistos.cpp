@@ -4,29 +4,55 @@ namespace nb = nanobind;
 
 //declare register functions
 void registerBufferModule(nb::module_&);
+void registerCaptureModule(nb::module_&);
 void registerCommandModule(nb::module_&);
 void registerCompilerModule(nb::module_&);
+void registerConditionalModule(nb::module_&);
 void registerContextModule(nb::module_&);
+void registerCooperativeModule(nb::module_&);
+void registerExternalModule(nb::module_&);
 void registerImageModule(nb::module_&);
+void registerPackedModule(nb::module_&);
+void registerPerformanceModule(nb::module_&);
+void registerPrimitivesModule(nb::module_&);
+void registerRandomModule(nb::module_&);
 void registerProgramModule(nb::module_&);
 void registerRaytracing(nb::module_&);
+void registerSchedulerModule(nb::module_&);
 void registerStopWatchModule(nb::module_&);
+void registerTraceModule(nb::module_&);
+void registerTuningModule(nb::module_&);
 void registerAtomicModule(nb::module_&);
 void registerTypeModule(nb::module_&);
 void registerDebugModule(nb::module_&);
+void registerWorkQueueModule(nb::module_&);
+void registerGraphModule(nb::module_&);
 
 NB_MODULE(pyhephaistos, m) {
     registerContextModule(m);
     registerCommandModule(m);
     registerCompilerModule(m);
     registerProgramModule(m);
+    registerSchedulerModule(m);
     registerBufferModule(m);
     registerImageModule(m);
     registerStopWatchModule(m);
+    registerTraceModule(m);
+    registerTuningModule(m);
+    registerCaptureModule(m);
     registerRaytracing(m);
+    registerConditionalModule(m);
+    registerExternalModule(m);
     registerAtomicModule(m);
+    registerCooperativeModule(m);
+    registerPackedModule(m);
+    registerPerformanceModule(m);
+    registerPrimitivesModule(m);
+    registerRandomModule(m);
     registerTypeModule(m);
     registerDebugModule(m);
+    registerWorkQueueModule(m);
+    registerGraphModule(m);
 
 #ifdef WARN_LEAKS
     nb::set_leak_warnings(false);
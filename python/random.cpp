@@ -0,0 +1,46 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/array.h>
+
+#include <hephaistos/random.hpp>
+
+namespace hp = hephaistos;
+namespace nb = nanobind;
+using namespace nb::literals;
+
+void registerRandomModule(nb::module_& m) {
+    nb::class_<hp::RandomStreamAllocator>(m, "RandomStreamAllocator",
+            "Allocates disjoint ranges of random streams. Random numbers are "
+            "generated by the counter-based generator Philox4x32-10 deriving each "
+            "number from the seed, the index of its stream and its position inside "
+            "it. Programs therefore need no stored state, but streams must not be "
+            "reused across dispatches. Inside programs, streams are created via "
+            "createRandomStream() declared in the built-in header "
+            "\"hephaistos/random.glsl\" available to all compilations. Pass the "
+            "allocated range to them using RandomStreams from hephaistos.glsl. "
+            "Allocation is thread safe."
+            "\n\nParameters\n----------\n"
+            "seed: int\n"
+            "    Seed of all allocated streams\n"
+            "offset: int, default=0\n"
+            "    Index of the first stream allocated\n")
+        .def(nb::init<uint64_t, uint64_t>(), "seed"_a, "offset"_a = 0)
+        .def_prop_ro("seed", [](const hp::RandomStreamAllocator& a) { return a.getSeed(); },
+            "Seed of all allocated streams")
+        .def_prop_ro("allocated", [](const hp::RandomStreamAllocator& a) { return a.getAllocated(); },
+            "Amount of streams allocated so far")
+        .def("allocate", [](hp::RandomStreamAllocator& a, uint64_t count) {
+                return a.allocate(count).offset;
+            }, "count"_a,
+            "Allocates the given amount of streams and returns the index of the "
+            "first one.")
+        .def("reset", &hp::RandomStreamAllocator::reset, "offset"_a = 0,
+            "Resets the allocation to the given stream index. Streams allocated "
+            "before get reused, thus repeating their numbers.");
+
+    m.def("philox4x32", [](std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key) {
+            return hp::philox4x32(counter, key);
+        }, "counter"_a, "key"_a,
+        "Evaluates the Philox4x32-10 generator on the host. A stream's numbers are "
+        "the components of the blocks with counter (draw, substream, stream low, "
+        "stream high) and the seed split into low and high word as key.");
+}
@@ -1,10 +1,12 @@
 #include <nanobind/nanobind.h>
 #include <nanobind/ndarray.h>
 #include <nanobind/stl/bind_vector.h>
+#include <nanobind/stl/filesystem.h>
 #include <nanobind/stl/optional.h>
 #include <nanobind/stl/string_view.h>
 
 #include <cstring>
+#include <limits>
 
 #include <hephaistos/program.hpp>
 #include <hephaistos/raytracing.hpp>
@@ -19,29 +21,42 @@ namespace {
 
 auto RaytracingExtension = hp::createRaytracingExtension();
 
-bool isRaytracingSupported(std::optional<uint32_t> id) {
+bool isSupported(std::optional<uint32_t> id, bool(*check)(const hp::DeviceHandle&)) {
     auto& devices = getDevices();
     if (id) {
         if (id >= devices.size())
             throw std::runtime_error("There is no device with the selected id!");
-        return hp::isRaytracingSupported(devices[*id]);
+        return check(devices[*id]);
     }
     else {
         //check if any device is supported
         for (auto& dev : devices) {
-            if (hp::isRaytracingSupported(dev))
+            if (check(dev))
                 return true;
         }
         return false;
     }
 }
 
+bool isRaytracingSupported(std::optional<uint32_t> id) {
+    return isSupported(id, &hp::isRaytracingSupported);
+}
+bool isRaytracingPipelineSupported(std::optional<uint32_t> id) {
+    return isSupported(id, &hp::isRaytracingPipelineSupported);
+}
+
+std::span<const uint32_t> asCode(const nb::bytes& code) {
+    return { reinterpret_cast<const uint32_t*>(code.c_str()), code.size() / 4 };
+}
+
 }
 
 using VertexArray = nb::ndarray<float, nb::numpy,
     nb::shape<-1, -1>, nb::c_contig, nb::device::cpu>;
 using IndexArray = nb::ndarray<uint32_t, nb::numpy,
     nb::shape<-1, 3>, nb::c_contig, nb::device::cpu>;
+using BoxArray = nb::ndarray<float, nb::numpy,
+    nb::shape<-1, 6>, nb::c_contig, nb::device::cpu>;
 using TransformArray = nb::ndarray<float,
     nb::shape<3,4>, nb::c_contig, nb::device::cpu>;
 using TransformArrayOut = nb::ndarray<float, nb::numpy,
@@ -54,10 +69,31 @@ struct NumpyMesh : public hp::Mesh {
     VertexArray vertexArray;
     IndexArray indexArray;
 };
+//Wrapper around hephaistos::TensorMesh with extra
+//handles to keep the referenced tensors alive
+struct PyTensorMesh : public hp::TensorMesh {
+    nb::object verticesRef = nb::none();
+    nb::object indicesRef = nb::none();
+};
+//Wrapper around hephaistos::BoundingBoxes with an extra
+//numpy handle to keep the referenced data alive
+struct NumpyBoundingBoxes : public hp::BoundingBoxes {
+    BoxArray boxArray;
+};
+//Hit group holding the compiled code as bytes
+struct PyHitGroup {
+    nb::bytes closestHit;
+    nb::bytes anyHit;
+    nb::bytes intersection;
+};
 
 void registerRaytracing(nb::module_& m) {
+    nb::bind_vector<std::vector<NumpyBoundingBoxes>>(m, "BoundingBoxesVector",
+        "List of BoundingBoxes");
     nb::bind_vector<std::vector<NumpyMesh>>(m, "MeshVector",
         "List of Mesh");
+    nb::bind_vector<std::vector<PyTensorMesh>>(m, "TensorMeshVector",
+        "List of TensorMesh");
     nb::bind_vector<std::vector<hp::Geometry>>(m, "GeometryVector",
         "List of Geometry");
     nb::bind_vector<std::vector<hp::GeometryInstance>>(m, "GeometryInstanceVector",
@@ -69,11 +105,19 @@ void registerRaytracing(nb::module_& m) {
     m.def("isRaytracingEnabled",
         []() -> bool { return hp::isRaytracingEnabled(getCurrentContext()); },
         "Checks wether ray tracing was enabled. Note that this creates the context.");
+    m.def("isRaytracingPipelineSupported", &isRaytracingPipelineSupported,
+        "id"_a.none() = nb::none(),
+        "Checks wether any or the given device supports ray tracing pipelines.");
+    m.def("isRaytracingPipelineEnabled",
+        []() -> bool { return hp::isRaytracingPipelineEnabled(getCurrentContext()); },
+        "Checks wether ray tracing pipelines were enabled. Note that this creates the context.");
     m.def("enableRaytracing",
-        [](bool force) { addExtension(hp::createRaytracingExtension(), force); },
-        "force"_a = false,
+        [](bool force, bool pipeline) {
+            addExtension(hp::createRaytracingExtension(pipeline), force);
+        }, "force"_a = false, nb::kw_only(), "pipeline"_a = false,
         "Enables ray tracing. (Lazy) context creation fails if not supported. "
-        "Set force=True if an existing context should be destroyed.");
+        "Set force=True if an existing context should be destroyed. Set "
+        "pipeline=True to also enable ray tracing pipelines used by RayTracingProgram.");
     
     nb::class_<NumpyMesh>(m, "Mesh",
             "Representation of a geometric shape consisting of triangles defined "
@@ -97,15 +141,71 @@ void registerRaytracing(nb::module_& m) {
                 mesh.indices = { indices.data(), indices.size() };
             },
             "Optional numpy array holding the indices referencing vertices to create triangles.");
+
+    nb::enum_<hp::VertexFormat>(m, "VertexFormat",
+            "Format of the vertex positions in a mesh")
+        .value("FLOAT32", hp::VertexFormat::FLOAT32,
+            "Three 32 bit floats")
+        .value("FLOAT16", hp::VertexFormat::FLOAT16,
+            "Four 16 bit floats. The fourth component is ignored.")
+        .value("SNORM16", hp::VertexFormat::SNORM16,
+            "Four 16 bit signed normalized integers. The fourth component is ignored.");
+    nb::class_<PyTensorMesh>(m, "TensorMesh",
+            "Mesh whose vertices and indices are read directly from tensors "
+            "without copying them. Work writing the tensors must have finished "
+            "before building.")
+        .def(nb::init<>())
+        .def_prop_rw("vertices",
+            [](const PyTensorMesh& mesh) -> nb::object { return mesh.verticesRef; },
+            [](PyTensorMesh& mesh, nb::handle_t<hp::Tensor<std::byte>> vertices) {
+                mesh.verticesRef = nb::borrow(vertices);
+                mesh.vertices = nb::cast<const hp::Tensor<std::byte>*>(vertices);
+            }, "Tensor containing the vertex data")
+        .def_rw("verticesOffset", &PyTensorMesh::verticesOffset,
+            "Offset in bytes into the vertex tensor where the vertices start")
+        .def_rw("vertexCount", &PyTensorMesh::vertexCount,
+            "Number of vertices")
+        .def_rw("vertexStride", &PyTensorMesh::vertexStride,
+            "Stride in bytes between vertices")
+        .def_rw("vertexFormat", &PyTensorMesh::vertexFormat,
+            "Format of the position at the start of each vertex")
+        .def_prop_rw("indices",
+            [](const PyTensorMesh& mesh) -> nb::object { return mesh.indicesRef; },
+            [](PyTensorMesh& mesh, nb::object indices) {
+                mesh.indices = indices.is_none() ?
+                    nullptr : nb::cast<const hp::Tensor<std::byte>*>(indices);
+                mesh.indicesRef = indices;
+            }, "Optional tensor containing the index data")
+        .def_rw("indicesOffset", &PyTensorMesh::indicesOffset,
+            "Offset in bytes into the index tensor where the indices start")
+        .def_rw("indexCount", &PyTensorMesh::indexCount,
+            "Number of indices")
+        .def_rw("shortIndices", &PyTensorMesh::shortIndices,
+            "Whether the indices are 16 bit instead of 32 bit");
+
+    nb::class_<NumpyBoundingBoxes>(m, "BoundingBoxes",
+            "Procedural geometry consisting of axis aligned bounding boxes. "
+            "Ray queries report boxes hit as candidates to be intersected "
+            "analytically in the shader. BoundingBoxes are used to build Geometries.")
+        .def(nb::init<>())
+        .def_prop_rw("boxes",
+            [](const NumpyBoundingBoxes& b) -> BoxArray { return b.boxArray; },
+            [](NumpyBoundingBoxes& b, BoxArray boxes) {
+                b.boxArray = boxes;
+                size_t bytes = sizeof(float) * boxes.size();
+                b.boxes = { reinterpret_cast<std::byte*>(boxes.data()), bytes };
+            },
+            "Numpy array holding one box per row given by its minimum followed "
+            "by its maximum x, y and z coordinate.");
     
     nb::class_<hp::Geometry>(m, "Geometry",
             "Underlying structure Acceleration Structures use to trace rays "
-            "against constructed from Meshes.")
+            "against constructed from Meshes or BoundingBoxes.")
         .def(nb::init<>())
         .def_rw("blas_address", &hp::Geometry::blas_address,
             "device address of the underlying blas")
         .def_rw("vertices_address", &hp::Geometry::vertices_address,
-            "device address of the vertex buffer or zero if it was discarded")
+            "device address of the vertex or box buffer or zero if it was discarded")
         .def_rw("indices_address", &hp::Geometry::indices_address,
             "device address of the index buffer, or zero if it was discarded or is non existent");
     
@@ -135,25 +235,107 @@ void registerRaytracing(nb::module_& m) {
             [](hp::GeometryInstance& gi, uint8_t m) { gi.mask = m; },
             "Mask of this instance used for masking ray traces.");
     
+    nb::enum_<hp::BuildPreference>(m, "BuildPreference",
+            "What acceleration structure builds should optimize for")
+        .value("FAST_TRACE", hp::BuildPreference::FAST_TRACE,
+            "Prefers higher trace performance over build time")
+        .value("FAST_BUILD", hp::BuildPreference::FAST_BUILD,
+            "Prefers faster builds over trace performance");
+    nb::class_<hp::BuildOptions>(m, "BuildOptions",
+            "Options for building acceleration structures")
+        .def("__init__", [](hp::BuildOptions* o,
+            hp::BuildPreference preference, bool compact, bool allowUpdate, bool lowMemory,
+            hp::QueueType queue
+        ) {
+            new (o) hp::BuildOptions{ preference, compact, allowUpdate, lowMemory, queue };
+        }, "preference"_a = hp::BuildPreference::FAST_TRACE, "compact"_a = true,
+            "allowUpdate"_a = false, "lowMemory"_a = false, "queue"_a = hp::QueueType::MAIN)
+        .def_rw("preference", &hp::BuildOptions::preference,
+            "What the build should optimize for")
+        .def_rw("compact", &hp::BuildOptions::compact,
+            "Whether to compact the acceleration structures after building. Only "
+            "applies to GeometryStore.")
+        .def_rw("allowUpdate", &hp::BuildOptions::allowUpdate,
+            "Whether the acceleration structures can be updated later on")
+        .def_rw("lowMemory", &hp::BuildOptions::lowMemory,
+            "Reduces the memory needed for building at the cost of build time and "
+            "trace performance")
+        .def_rw("queue", &hp::BuildOptions::queue,
+            "Queue the initial build and compaction run on. Building on COMPUTE "
+            "keeps the main queue free for other work. TRANSFER is rejected with "
+            "a ValueError.");
+    nb::class_<hp::BuildSizes>(m, "BuildSizes",
+            "Memory sizes of built acceleration structures")
+        .def_ro("built", &hp::BuildSizes::built,
+            "Size in bytes as built")
+        .def_ro("compacted", &hp::BuildSizes::compacted,
+            "Size in bytes after compaction. Same as built if not compacted.");
+
     nb::class_<hp::GeometryStore>(m, "GeometryStore",
             "Handles the creation of Geometries using Meshes and their lifetime "
             "\n\nParameters\n----------\n"
             "meshes: Mesh[]\n"
             "    List of meshes used for creating Geometries\n"
-            "keepMeshData: bool, default=True\n",
-            "    If True, keeps the mesh data on the GPU after building Geometries.")
+            "keepMeshData: bool, default=True\n"
+            "    If True, keeps the mesh data on the GPU after building Geometries.\n"
+            "options: BuildOptions, default=BuildOptions()\n"
+            "    Options used for building. allowUpdate implies keepMeshData.")
         .def("__init__",
-            [](hp::GeometryStore* gs, std::vector<NumpyMesh> meshes, bool keepMeshData) {
+            [](hp::GeometryStore* gs, std::vector<NumpyMesh> meshes, bool keepMeshData,
+                const hp::BuildOptions& options)
+            {
                 nb::gil_scoped_release release;
                 //we need to transform numpy meshes to hp::Meshes
                 //before passing to the constructor
                 std::vector<hp::Mesh> plainMeshes(meshes.size());
                 for (auto i = 0u; i < meshes.size(); ++i)
                     plainMeshes[i] = meshes[i];
-                new (gs) hp::GeometryStore(getCurrentContext(), plainMeshes, keepMeshData);
-            }, "meshes"_a, "keepMeshData"_a = true,
+                new (gs) hp::GeometryStore(getCurrentContext(), plainMeshes, keepMeshData, options);
+            }, "meshes"_a, "keepMeshData"_a = true, "options"_a = hp::BuildOptions{},
             "Creates a geometry store responsible for managing the BLAS/geometries "
             "used to create and run acceleration structures.")
+        .def("__init__",
+            [](hp::GeometryStore* gs, std::vector<PyTensorMesh> meshes,
+                const hp::BuildOptions& options)
+            {
+                nb::gil_scoped_release release;
+                std::vector<hp::TensorMesh> plainMeshes(meshes.begin(), meshes.end());
+                new (gs) hp::GeometryStore(getCurrentContext(), plainMeshes, options);
+            }, "meshes"_a, "options"_a = hp::BuildOptions{},
+            "Creates a geometry store from meshes whose data is read directly "
+            "from tensors.")
+        .def("__init__",
+            [](hp::GeometryStore* gs, std::vector<NumpyBoundingBoxes> boxes, bool keepBoxData,
+                const hp::BuildOptions& options)
+            {
+                nb::gil_scoped_release release;
+                std::vector<hp::BoundingBoxes> plainBoxes(boxes.begin(), boxes.end());
+                new (gs) hp::GeometryStore(getCurrentContext(), plainBoxes, keepBoxData, options);
+            }, "boxes"_a, "keepBoxData"_a = true, "options"_a = hp::BuildOptions{},
+            "Creates a geometry store from procedural geometry. The box data is "
+            "accessible via the geometries' vertices_address.")
+        .def("__init__",
+            [](hp::GeometryStore* gs, nb::bytes serialized, std::vector<NumpyMesh> meshes,
+                const hp::BuildOptions& options)
+            {
+                std::span<const std::byte> data{
+                    static_cast<const std::byte*>(serialized.data()), serialized.size() };
+                nb::gil_scoped_release release;
+                std::vector<hp::Mesh> plainMeshes(meshes.begin(), meshes.end());
+                new (gs) hp::GeometryStore(getCurrentContext(), data, plainMeshes, options);
+            }, "serialized"_a, "meshes"_a, "options"_a = hp::BuildOptions{},
+            "Loads the geometries from data returned by serialize(). Falls back to "
+            "building them from the meshes if the data is incompatible with the device.")
+        .def("__init__",
+            [](hp::GeometryStore* gs, const std::filesystem::path& path, bool keepMeshData,
+                const hp::BuildOptions& options)
+            {
+                nb::gil_scoped_release release;
+                new (gs) hp::GeometryStore(getCurrentContext(), path, keepMeshData, options);
+            }, "path"_a, "keepMeshData"_a = true, "options"_a = hp::BuildOptions{},
+            "Creates a geometry store from a mesh file written by saveMeshes(). "
+            "Streams the mesh data in chunks from the mapped file to the GPU "
+            "without loading it into host memory as a whole.")
         .def_prop_ro("geometries",
             [](const hp::GeometryStore& gs) -> const std::vector<hp::Geometry>& {
                 return gs.geometries();
@@ -161,12 +343,59 @@ void registerRaytracing(nb::module_& m) {
         .def_prop_ro("size",
             [](const hp::GeometryStore& gs) -> size_t { return gs.size(); },
             "Number of geometries stored")
+        .def_prop_ro("updatable",
+            [](const hp::GeometryStore& gs) -> bool { return gs.updatable(); },
+            "Whether the geometries can be refit to new vertex positions")
+        .def_prop_ro("buildSizes", &hp::GeometryStore::buildSizes,
+            "Sizes of all geometries before and after compaction")
+        .def_prop_ro("deserialized", &hp::GeometryStore::deserialized,
+            "Whether the geometries were loaded from serialized data")
+        .def("serialize",
+            [](const hp::GeometryStore& gs) -> nb::bytes {
+                std::vector<std::byte> result;
+                {
+                    nb::gil_scoped_release release;
+                    result = gs.serialize();
+                }
+                return nb::bytes(reinterpret_cast<const char*>(result.data()), result.size());
+            }, "Serializes the geometries, so they can be loaded later on without "
+            "building them. The data is only compatible with the same device and driver.")
         .def("createInstance",
             [](const hp::GeometryStore& gs, size_t idx) -> hp::GeometryInstance {
                 nb::gil_scoped_release release;
                 return gs.createInstance(idx);
             }, "idx"_a, "Creates a new instance of the specified geometry",
             nb::rv_policy::reference_internal);
+
+    nb::class_<hp::UpdateGeometryCommand, hp::Command>(m, "UpdateGeometryCommand",
+            "Command for refitting a geometry to new vertex positions read from a tensor")
+        .def(nb::init<const hp::GeometryStore&, size_t, const hp::Tensor<std::byte>&, uint64_t>(),
+            "store"_a, "idx"_a, "vertices"_a, "offset"_a = 0);
+    m.def("saveMeshes",
+        [](const std::filesystem::path& path, std::vector<NumpyMesh> meshes) {
+            nb::gil_scoped_release release;
+            std::vector<hp::Mesh> plainMeshes(meshes.begin(), meshes.end());
+            hp::saveMeshes(path, plainMeshes);
+        }, "path"_a, "meshes"_a,
+        "Saves the meshes in a binary mesh file, which can be loaded by GeometryStore."
+        "\n\nParameters\n----------\n"
+        "path: str | PathLike\n"
+        "    Path of the file to write\n"
+        "meshes: Mesh[]\n"
+        "    Meshes to save\n");
+    m.def("updateGeometry", &hp::updateGeometry,
+        "store"_a, "idx"_a, "vertices"_a, "offset"_a = 0,
+        "Creates a command for refitting the geometry to new vertex positions. "
+        "Acceleration structures referencing it must be rebuilt afterwards."
+        "\n\nParameters\n----------\n"
+        "store: GeometryStore\n"
+        "    Store containing the geometry. Must have been created with allowUpdate.\n"
+        "idx: int\n"
+        "    Index of the geometry to update\n"
+        "vertices: Tensor\n"
+        "    Tensor containing the new vertex positions using the same layout as the mesh\n"
+        "offset: int, default=0\n"
+        "    Offset in bytes into the tensor where the vertices start\n");
     
     nb::class_<hp::AccelerationStructure>(m, "AccelerationStructure",
             "Acceleration Structure used by programs to trace rays against a scene. "
@@ -174,19 +403,266 @@ void registerRaytracing(nb::module_& m) {
             "\n\nParameters\n---------\n"
             "instances: GeometryInstance[]\n"
             "    list of instances the structure consists of")
-        .def("__init__", [](hp::AccelerationStructure* as, std::vector<hp::GeometryInstance> instances) {
+        .def("__init__", [](hp::AccelerationStructure* as,
+            std::vector<hp::GeometryInstance> instances, const hp::BuildOptions& options)
+        {
             nb::gil_scoped_release release;
-            new (as) hp::AccelerationStructure(getCurrentContext(), instances);
-        }, "instances"_a,
+            new (as) hp::AccelerationStructure(getCurrentContext(), instances, options);
+        }, "instances"_a, "options"_a = hp::BuildOptions{},
         "Creates an acceleration structure for consumption in shaders from the given geometry instances.")
+        .def("__init__", [](hp::AccelerationStructure* as,
+            uint32_t maxInstances, const hp::BuildOptions& options)
+        {
+            nb::gil_scoped_release release;
+            new (as) hp::AccelerationStructure(getCurrentContext(), maxInstances, options);
+        }, "maxInstances"_a, "options"_a = hp::BuildOptions{},
+        "Creates an empty acceleration structure to be built on the device from up to "
+        "maxInstances instances. If options.allowUpdate is True, it can also be updated "
+        "instead of rebuilt.")
+        .def_prop_ro("maxInstances", &hp::AccelerationStructure::maxInstances,
+            "Maximum number of instances the acceleration structure can be built from")
+        .def_prop_ro("size_bytes", &hp::AccelerationStructure::size_bytes,
+            "Size of the acceleration structure in bytes")
         .def("bindParameter",
             [](const hp::AccelerationStructure& as, hp::Program& p, uint32_t b) {
                 as.bindParameter(p.getBinding(b));
             }, "program"_a, "binding"_a,
             "Binds the acceleration structure to the program at the given binding")
+        .def("bindParameter",
+            [](const hp::AccelerationStructure& as, hp::ParameterSet& p, uint32_t b) {
+                as.bindParameter(p.getBinding(b));
+            }, "set"_a, "binding"_a,
+            "Binds the acceleration structure to the parameter set at the given binding")
         .def("bindParameter",
             [](const hp::AccelerationStructure& as, hp::Program& p, std::string_view b) {
                 as.bindParameter(p.getBinding(b));
             }, "program"_a, "binding"_a,
-            "Binds the acceleration structure to the program at the given binding");
+            "Binds the acceleration structure to the program at the given binding")
+        .def("bindParameter",
+            [](const hp::AccelerationStructure& as, hp::ParameterSet& p, std::string_view b) {
+                as.bindParameter(p.getBinding(b));
+            }, "set"_a, "binding"_a,
+            "Binds the acceleration structure to the parameter set at the given binding");
+
+    nb::enum_<hp::RayCastMode>(m, "RayCastMode",
+            "Determines which hit a RayCaster reports")
+        .value("CLOSEST", hp::RayCastMode::CLOSEST,
+            "Reports the closest hit along the ray")
+        .value("ANY", hp::RayCastMode::ANY,
+            "Reports the first hit found and stops traversal")
+        .value("COUNT", hp::RayCastMode::COUNT,
+            "Counts all hits along the ray while reporting the closest one");
+
+    nb::class_<hp::CastRaysCommand, hp::Command>(m, "CastRaysCommand",
+        "Command casting a tensor of rays. Not synchronized with work recorded "
+        "before or after unless hazard tracking is used.");
+
+    nb::class_<hp::RayCaster>(m, "RayCaster",
+            "Casts batches of rays against an acceleration structure using a built-in "
+            "ray query kernel. Rays are read as structs of (vec3 origin, float tMin, "
+            "vec3 direction, float tMax) and a hit is written for each as struct of "
+            "(float t, uint instanceIndex, uint customIndex, uint primitiveIndex, "
+            "vec2 barycentrics, uint geometryIndex, uint count), i.e. 32 bytes each. "
+            "Missed rays have an instanceIndex of 0xFFFFFFFF. Only triangle geometries "
+            "are considered. Requires ray tracing to be enabled."
+            "\n\nParameters\n----------\n"
+            "localSize: int, default=0\n"
+            "    Threads per workgroup. Zero picks one based on the device.\n"
+            "raysPerThread: int, default=0\n"
+            "    Rays cast per thread. Zero picks a default.\n")
+        .def("__init__",
+            [](hp::RayCaster* c, uint32_t localSize, uint32_t raysPerThread) {
+                new (c) hp::RayCaster(getCurrentContext(), {
+                    .localSize = localSize,
+                    .raysPerThread = raysPerThread
+                });
+            }, nb::kw_only(), "localSize"_a = 0, "raysPerThread"_a = 0)
+        .def_prop_ro("localSize", [](const hp::RayCaster& c) { return c.getLocalSize(); },
+            "Threads per workgroup")
+        .def_prop_ro("raysPerThread", [](const hp::RayCaster& c) { return c.getRaysPerThread(); },
+            "Rays cast per thread")
+        .def("castRays",
+            [](const hp::RayCaster& c,
+                const hp::AccelerationStructure& accelerationStructure,
+                const hp::Tensor<std::byte>& rays,
+                const hp::Tensor<std::byte>& hits,
+                hp::RayCastMode mode,
+                std::optional<uint32_t> count)
+            {
+                return c.castRays(accelerationStructure, rays, hits, mode,
+                    count.value_or(std::numeric_limits<uint32_t>::max()));
+            }, "accelerationStructure"_a, "rays"_a, "hits"_a,
+            "mode"_a = hp::RayCastMode::CLOSEST, nb::kw_only(), "count"_a.none() = nb::none(),
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(),
+            nb::keep_alive<0, 3>(), nb::keep_alive<0, 4>(),
+            "Creates a command casting rays against the acceleration structure."
+            "\n\nParameters\n----------\n"
+            "accelerationStructure: AccelerationStructure\n"
+            "    Scene to cast the rays against\n"
+            "rays: Tensor\n"
+            "    Tensor holding the rays\n"
+            "hits: Tensor\n"
+            "    Tensor receiving a hit per ray\n"
+            "mode: RayCastMode, default=RayCastMode.CLOSEST\n"
+            "    Determines which hit gets reported\n"
+            "count: int | None, default=None\n"
+            "    Amount of rays. Uses the whole ray tensor if None.\n");
+
+    nb::class_<PyHitGroup>(m, "HitGroup",
+            "Shaders forming a hit group of a RayTracingProgram. Each stage is "
+            "optional. Groups with an intersection shader are procedural, while "
+            "groups without one are used for triangles.")
+        .def(nb::init<nb::bytes, nb::bytes, nb::bytes>(),
+            "closestHit"_a = nb::bytes(), "anyHit"_a = nb::bytes(),
+            "intersection"_a = nb::bytes())
+        .def_rw("closestHit", &PyHitGroup::closestHit,
+            "Compiled closest hit shader. Empty if none.")
+        .def_rw("anyHit", &PyHitGroup::anyHit,
+            "Compiled any hit shader. Empty if none.")
+        .def_rw("intersection", &PyHitGroup::intersection,
+            "Compiled intersection shader. Empty for triangle geometries.");
+
+    nb::class_<hp::TraceRaysCommand, hp::Command>(m, "TraceRaysCommand",
+            "Command for tracing rays using a RayTracingProgram")
+        .def_rw("width", &hp::TraceRaysCommand::width,
+            "Amount of rays in X dimension")
+        .def_rw("height", &hp::TraceRaysCommand::height,
+            "Amount of rays in Y dimension")
+        .def_rw("depth", &hp::TraceRaysCommand::depth,
+            "Amount of rays in Z dimension");
+
+    nb::class_<hp::RayTracingProgram>(m, "RayTracingProgram",
+            "Program running on the ray tracing pipeline. All shaders share a "
+            "single set of bindings and push constants. Requires ray tracing "
+            "pipelines to be enabled via enableRaytracing(pipeline=True)."
+            "\n\nParameters\n----------\n"
+            "rayGen: bytes\n"
+            "    Compiled ray generation shader\n"
+            "miss: list[bytes], default=[]\n"
+            "    Compiled miss shaders. Their index is used by traceRayEXT()\n"
+            "hitGroups: list[HitGroup], default=[]\n"
+            "    Hit groups selected via sbtRecordOffset and the instance's offset\n"
+            "specialization: bytes, default=b''\n"
+            "    Data used for filling in specialization constants of all shaders\n"
+            "maxRecursionDepth: int, default=1\n"
+            "    Maximum depth of recursive traceRayEXT() calls\n")
+        .def("__init__",
+            [](hp::RayTracingProgram* p, nb::bytes rayGen, nb::list miss,
+                nb::list hitGroups, nb::bytes specialization,
+                uint32_t maxRecursionDepth)
+            {
+                //lists keep the code alive while creating the program
+                hp::RayTracingShaders shaders{ .rayGen = asCode(rayGen) };
+                for (auto code : miss)
+                    shaders.miss.push_back(asCode(nb::cast<nb::bytes>(code)));
+                for (auto item : hitGroups) {
+                    auto& group = nb::cast<const PyHitGroup&>(item);
+                    shaders.hitGroups.push_back({
+                        .closestHit = asCode(group.closestHit),
+                        .anyHit = asCode(group.anyHit),
+                        .intersection = asCode(group.intersection)
+                    });
+                }
+                std::span<const std::byte> spec{
+                    reinterpret_cast<const std::byte*>(specialization.c_str()),
+                    specialization.size()
+                };
+                nb::gil_scoped_release release;
+                new (p) hp::RayTracingProgram(getCurrentContext(),
+                    shaders, spec, maxRecursionDepth);
+            }, "rayGen"_a, "miss"_a = nb::list(),
+            "hitGroups"_a = nb::list(), nb::kw_only(),
+            "specialization"_a = nb::bytes(), "maxRecursionDepth"_a = 1)
+        .def_prop_ro("bindings",
+            [](const hp::RayTracingProgram& p) {
+                nb::list bindings;
+                for (auto& b : p.listBindings())
+                    bindings.append(nb::cast(b));
+                return bindings;
+            }, "Returns a list of all bindings shared by the shaders.")
+        .def_prop_ro("missCount", &hp::RayTracingProgram::getMissCount,
+            "Amount of miss shaders")
+        .def_prop_ro("hitGroupCount", &hp::RayTracingProgram::getHitGroupCount,
+            "Amount of hit groups")
+        .def("isBindingBound", [](const hp::RayTracingProgram& p, uint32_t i) {
+                return p.isBindingBound(i);
+            }, "i"_a, "Checks wether the i-th binding is bound")
+        .def("bindParameter",
+            [](hp::RayTracingProgram& p, const hp::Tensor<std::byte>& t, uint32_t b) {
+                t.bindParameter(p.getBinding(b));
+            }, "tensor"_a, "binding"_a,
+            "Binds the tensor to the given binding")
+        .def("bindParameter",
+            [](hp::RayTracingProgram& p, const hp::Tensor<std::byte>& t, std::string_view b) {
+                t.bindParameter(p.getBinding(b));
+            }, "tensor"_a, "binding"_a,
+            "Binds the tensor to the given binding")
+        .def("bindParameter",
+            [](hp::RayTracingProgram& p, const hp::AccelerationStructure& as, uint32_t b) {
+                as.bindParameter(p.getBinding(b));
+            }, "accelerationStructure"_a, "binding"_a,
+            "Binds the acceleration structure to the given binding")
+        .def("bindParameter",
+            [](hp::RayTracingProgram& p, const hp::AccelerationStructure& as, std::string_view b) {
+                as.bindParameter(p.getBinding(b));
+            }, "accelerationStructure"_a, "binding"_a,
+            "Binds the acceleration structure to the given binding")
+        .def("traceRays",
+            [](const hp::RayTracingProgram& p, uint32_t w, uint32_t h, uint32_t d)
+                -> hp::TraceRaysCommand
+                { return p.traceRays(w, h, d); },
+            "width"_a, "height"_a = 1, "depth"_a = 1,
+            "Traces rays using the current bindings launching one ray generation "
+            "invocation per element of the given grid."
+            "\n\nParameters\n----------\n"
+            "width: int\n"
+            "    Amount of rays in X dimension\n"
+            "height: int, default=1\n"
+            "    Amount of rays in Y dimension\n"
+            "depth: int, default=1\n"
+            "    Amount of rays in Z dimension\n")
+        .def("traceRaysPush",
+            [](const hp::RayTracingProgram& p, nb::bytes push, uint32_t w, uint32_t h, uint32_t d)
+                -> hp::TraceRaysCommand
+                {
+                    return p.traceRays(
+                        std::span<const std::byte>{
+                            reinterpret_cast<const std::byte*>(push.c_str()),
+                            push.size()
+                        },
+                        w, h, d
+                    );
+                }, nb::keep_alive<0,2>(), //keep push bytes as long alive as the command
+            "push"_a, "width"_a, "height"_a = 1, "depth"_a = 1,
+            "Traces rays using the current bindings and the given push data."
+            "\n\nParameters\n----------\n"
+            "push: bytes\n"
+            "   Data pushed to all shaders as bytes\n"
+            "width: int\n"
+            "    Amount of rays in X dimension\n"
+            "height: int, default=1\n"
+            "    Amount of rays in Y dimension\n"
+            "depth: int, default=1\n"
+            "    Amount of rays in Z dimension\n");
+
+    nb::class_<hp::RebuildAccelerationStructureCommand, hp::Command>(m, "RebuildAccelerationStructureCommand",
+            "Command for rebuilding an acceleration structure from instances stored in a tensor")
+        .def(nb::init<const hp::AccelerationStructure&, const hp::Tensor<std::byte>&, uint32_t, uint64_t, bool>(),
+            "accelerationStructure"_a, "instances"_a, "count"_a, "offset"_a = 0, "update"_a = false);
+    m.def("rebuildAccelerationStructure", &hp::rebuildAccelerationStructure,
+        "accelerationStructure"_a, "instances"_a, "count"_a, "offset"_a = 0, "update"_a = false,
+        "Creates a command for rebuilding the acceleration structure on the device "
+        "from instances stored in a tensor using the layout of VkAccelerationStructureInstanceKHR."
+        "\n\nParameters\n----------\n"
+        "accelerationStructure: AccelerationStructure\n"
+        "    Acceleration structure to rebuild. Must have been created with maxInstances.\n"
+        "instances: Tensor\n"
+        "    Tensor containing the instances\n"
+        "count: int\n"
+        "    Number of instances to build from\n"
+        "offset: int, default=0\n"
+        "    Offset in bytes into the tensor where the instances start\n"
+        "update: bool, default=False\n"
+        "    If True, updates the acceleration structure instead of rebuilding it. "
+        "Must use the same count as the last rebuild.\n");
 }
@@ -0,0 +1,407 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/ndarray.h>
+#include <nanobind/stl/optional.h>
+
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <hephaistos/scheduler.hpp>
+#include <hephaistos/stream.hpp>
+
+#include "context.hpp"
+
+namespace hp = hephaistos;
+namespace nb = nanobind;
+using namespace nb::literals;
+
+namespace {
+
+//Wraps a Python callable so it can be called from the scheduler's threads
+hp::TaskFunction wrapTask(nb::callable callable) {
+    //the callable may only be released while holding the GIL
+    auto deleter = [](nb::callable* c) {
+        nb::gil_scoped_acquire acquire;
+        delete c;
+    };
+    std::shared_ptr<nb::callable> holder(new nb::callable(std::move(callable)), deleter);
+    return [holder](uint32_t config, uint64_t task) {
+        nb::gil_scoped_acquire acquire;
+        try {
+            (*holder)(config, task);
+        }
+        catch (nb::python_error& e) {
+            e.discard_as_unraisable("task");
+        }
+    };
+}
+
+//Collects the subroutines of each config from a Python list
+std::vector<std::reference_wrapper<const hp::Subroutine>> toConfigs(nb::handle configs) {
+    std::vector<std::reference_wrapper<const hp::Subroutine>> result;
+    for (nb::handle h : configs)
+        result.push_back(nb::cast<const hp::Subroutine&>(h));
+    return result;
+}
+
+//Exposes chunk memory to Python without copies
+nb::object toMemoryView(std::span<std::byte> chunk, bool writable) {
+    return nb::steal(PyMemoryView_FromMemory(
+        reinterpret_cast<char*>(chunk.data()),
+        static_cast<Py_ssize_t>(chunk.size()),
+        writable ? PyBUF_WRITE : PyBUF_READ));
+}
+
+//The scheduler's threads need the GIL to finish pending tasks
+// -> wait on them without holding it before joining the threads
+class PyTaskScheduler : public hp::TaskScheduler {
+public:
+    PyTaskScheduler(nb::list configs, hp::TaskFunction update, hp::TaskFunction process, uint32_t queueSize)
+        : hp::TaskScheduler(toConfigs(configs), std::move(update), std::move(process), queueSize)
+        , configs(std::move(configs))
+    {}
+    ~PyTaskScheduler() {
+        nb::gil_scoped_release release;
+        wait();
+    }
+
+private:
+    //keeps the subroutines alive
+    nb::list configs;
+};
+
+}
+
+void registerSchedulerModule(nb::module_& m) {
+    nb::class_<PyTaskScheduler>(m, "TaskScheduler",
+            "Schedules tasks onto a set of buffered subroutines, each using its own "
+            "configuration. Tasks rotate through them. Before a task gets submitted, "
+            "an update function prepares its configuration on a background thread "
+            "once the previous task using it has finished. With more than two "
+            "configurations the host can run multiple tasks ahead of the device, "
+            "smoothing out uneven update times. An optional process function runs "
+            "on a second background thread after each task finished. Tasks using "
+            "the same configuration wait on the processing of the previous one. "
+            "Both functions get called with the GIL acquired, but the bookkeeping "
+            "runs natively without it. Exceptions raised by them are reported as "
+            "unraisable."
+            "\n\nParameters\n----------\n"
+            "configs: list[Subroutine]\n"
+            "    Subroutine running tasks per configuration. Requires at least two.\n"
+            "update: Callable[[int, int], None]\n"
+            "    Function called with the config and task index updating the config "
+                "before its task runs\n"
+            "process: Callable[[int, int], None] | None, default=None\n"
+            "    Function called with the config and task index after its task "
+                "finished\n"
+            "queueSize: int, default=0\n"
+            "    Maximum amount of tasks waiting on their update. Zero means infinite.\n")
+        .def("__init__",
+            [](PyTaskScheduler* s,
+                nb::iterable configs,
+                nb::callable update,
+                std::optional<nb::callable> process,
+                uint32_t queueSize)
+            {
+                auto processFn = process ? wrapTask(std::move(*process)) : hp::TaskFunction{};
+                //copy, so later changes to the iterable do not matter
+                nb::list copy;
+                for (nb::handle h : configs)
+                    copy.append(h);
+                new (s) PyTaskScheduler(std::move(copy),
+                    wrapTask(std::move(update)), std::move(processFn), queueSize);
+            },
+            "configs"_a, "update"_a, "process"_a.none() = nb::none(),
+            nb::kw_only(), "queueSize"_a = 0)
+        .def_prop_ro("configCount", [](const PyTaskScheduler& s) { return s.getConfigCount(); },
+            "Amount of configurations tasks rotate through")
+        .def_prop_ro("queueSize", [](const PyTaskScheduler& s) { return s.getQueueSize(); },
+            "Maximum amount of tasks waiting on their update. Zero means infinite.")
+        .def_prop_ro("totalTasks", [](const PyTaskScheduler& s) { return s.getTotalTasks(); },
+            "Total amount of tasks scheduled")
+        .def_prop_ro("pendingTasks", [](const PyTaskScheduler& s) { return s.getPendingTasks(); },
+            "Amount of scheduled tasks whose configuration has not yet been updated")
+        .def_prop_ro("finishedTasks", [](const PyTaskScheduler& s) { return s.getFinishedTasks(); },
+            "Amount of finished tasks including their processing")
+        .def("schedule", [](PyTaskScheduler& s, uint32_t count, std::optional<uint64_t> timeout) {
+                hp::ScheduleResult result;
+                {
+                    nb::gil_scoped_release release;
+                    result = s.schedule(count, timeout.value_or(std::numeric_limits<uint64_t>::max()));
+                }
+                if (!result.submission)
+                    return nb::make_tuple(0, nb::none());
+                return nb::make_tuple(result.count, std::move(*result.submission));
+            }, "count"_a, nb::kw_only(), "timeout"_a.none() = nb::none(),
+            "Schedules the given amount of tasks after previous ones. Blocks while "
+            "the queue is full. Stops once waiting on the queue times out or the "
+            "tasks of this call alone would exceed the queue. Returns the amount of "
+            "tasks actually scheduled and their submission, or None if zero."
+            "\n\nParameters\n----------\n"
+            "count: int\n"
+            "    Amount of tasks to schedule\n"
+            "timeout: int | None, default=None\n"
+            "    Time in nanoseconds to wait for a free spot in the queue per task. "
+                "Waits indefinitely if None.\n")
+        .def("wait", [](const PyTaskScheduler& s, std::optional<uint64_t> task) {
+                nb::gil_scoped_release release;
+                if (task)
+                    s.wait(*task);
+                else
+                    s.wait();
+            }, "task"_a.none() = nb::none(),
+            "Waits until the given amount of tasks finished or all if None.")
+        .def("waitTimeout", [](const PyTaskScheduler& s, std::optional<uint64_t> task, uint64_t timeout) {
+                nb::gil_scoped_release release;
+                return s.wait(task.value_or(s.getTotalTasks()), timeout);
+            }, "task"_a.none() = nb::none(), nb::kw_only(), "timeout"_a,
+            "Waits until the given amount of tasks finished, or all if None, for at "
+            "most timeout nanoseconds. Returns True if they finished, False otherwise.");
+
+    nb::class_<hp::StreamExecutor>(m, "StreamExecutor",
+            "Streams datasets larger than device memory through the device in chunks. "
+            "Each chunk is uploaded, processed by a per slot subroutine and its output "
+            "downloaded again. Chunks rotate through multiple slots, each with its own "
+            "device memory and timeline, so the upload of one chunk, the compute of the "
+            "previous and the download of the one before may run concurrently. "
+            "Transfers run on the dedicated transfer queue where available. Create the "
+            "subroutines after the executor using the tensors of each slot."
+            "\n\nParameters\n----------\n"
+            "inputItemSize: int\n"
+            "    Size of a single input item in bytes\n"
+            "outputItemSize: int\n"
+            "    Size of a single output item in bytes\n"
+            "chunkSize: int, default=0\n"
+            "    Items per chunk. Zero derives it from the memory budget.\n"
+            "slots: int, default=3\n"
+            "    Amount of chunks in flight\n"
+            "memoryFraction: float, default=0.5\n"
+            "    Fraction of the remaining device memory budget the slots may occupy "
+                "when deriving the chunk size\n"
+            "useTransferQueue: bool, default=True\n"
+            "    If True, runs transfers on the dedicated transfer queue if there is one\n")
+        .def("__init__",
+            [](hp::StreamExecutor* e,
+                uint64_t inputItemSize,
+                uint64_t outputItemSize,
+                uint64_t chunkSize,
+                uint32_t slots,
+                float memoryFraction,
+                bool useTransferQueue)
+            {
+                new (e) hp::StreamExecutor(getCurrentContext(), inputItemSize, outputItemSize, {
+                    .chunkSize = chunkSize,
+                    .slots = slots,
+                    .memoryFraction = memoryFraction,
+                    .useTransferQueue = useTransferQueue
+                });
+            },
+            "inputItemSize"_a, "outputItemSize"_a, nb::kw_only(),
+            "chunkSize"_a = 0, "slots"_a = 3, "memoryFraction"_a = 0.5f,
+            "useTransferQueue"_a = true)
+        .def_prop_ro("chunkSize", &hp::StreamExecutor::getChunkSize,
+            "Maximum amount of items per chunk")
+        .def_prop_ro("slotCount", &hp::StreamExecutor::getSlotCount,
+            "Amount of slots chunks rotate through")
+        .def_prop_ro("inputItemSize", &hp::StreamExecutor::getInputItemSize,
+            "Size of a single input item in bytes")
+        .def_prop_ro("outputItemSize", &hp::StreamExecutor::getOutputItemSize,
+            "Size of a single output item in bytes")
+        .def("getInput",
+            [](const hp::StreamExecutor& e, uint32_t slot) -> const hp::Tensor<std::byte>& {
+                return e.getSlot(slot).input;
+            }, "slot"_a, nb::rv_policy::reference_internal,
+            "Returns the tensor holding the input items of the given slot")
+        .def("getOutput",
+            [](const hp::StreamExecutor& e, uint32_t slot) -> const hp::Tensor<std::byte>& {
+                return e.getSlot(slot).output;
+            }, "slot"_a, nb::rv_policy::reference_internal,
+            "Returns the tensor receiving the output items of the given slot")
+        .def("getCount",
+            [](const hp::StreamExecutor& e, uint32_t slot) -> const hp::Tensor<std::byte>& {
+                return e.getSlot(slot).count;
+            }, "slot"_a, nb::rv_policy::reference_internal,
+            "Returns the tensor holding the amount of items in the given slot's chunk "
+            "as a single uint32")
+        .def("run",
+            [](hp::StreamExecutor& e, nb::iterable compute, nb::callable source, nb::callable sink) {
+                //keep the subroutines alive
+                nb::list subroutines;
+                for (nb::handle h : compute)
+                    subroutines.append(h);
+                auto configs = toConfigs(subroutines);
+                hp::ChunkSource src = [&source](std::span<std::byte> chunk, uint64_t index) {
+                    nb::gil_scoped_acquire acquire;
+                    return nb::cast<uint64_t>(source(toMemoryView(chunk, true), index));
+                };
+                hp::ChunkSink dst = [&sink](std::span<const std::byte> chunk, uint64_t index) {
+                    nb::gil_scoped_acquire acquire;
+                    auto memory = std::span<std::byte>(
+                        const_cast<std::byte*>(chunk.data()), chunk.size());
+                    sink(toMemoryView(memory, false), index);
+                };
+                nb::gil_scoped_release release;
+                return e.run(configs, src, dst);
+            }, "compute"_a, "source"_a, "sink"_a,
+            "Streams chunks from source through the device into sink and returns the "
+            "amount of chunks processed. Blocks until the source ran dry and the sink "
+            "consumed all chunks. Exceptions raised by source or sink stop the stream."
+            "\n\nParameters\n----------\n"
+            "compute: list[Subroutine]\n"
+            "    Subroutine processing the chunk in each slot\n"
+            "source: Callable[[memoryview, int], int]\n"
+            "    Function called with the writable memory and index of the next chunk "
+                "returning the amount of items written. Returning zero ends the stream.\n"
+            "sink: Callable[[memoryview, int], None]\n"
+            "    Function called in order with the output items and index of a "
+                "finished chunk. The memory is only valid during the call.\n");
+
+    m.def("getStreamChunkSize",
+        [](uint64_t bytesPerItem, uint32_t slots, float memoryFraction) {
+            return hp::getStreamChunkSize(getCurrentContext(), bytesPerItem, slots, memoryFraction);
+        }, "bytesPerItem"_a, "slots"_a = 3, "memoryFraction"_a = 0.5f,
+        "Derives the amount of items per chunk fitting into the remaining device "
+        "memory budget. Note that this may initialize the context."
+        "\n\nParameters\n----------\n"
+        "bytesPerItem: int\n"
+        "    Device memory occupied per item and slot\n"
+        "slots: int, default=3\n"
+        "    Amount of chunks in flight\n"
+        "memoryFraction: float, default=0.5\n"
+        "    Fraction of the remaining budget to occupy\n");
+
+    nb::class_<hp::StreamingUploader>(m, "StreamingUploader",
+            "Uploads data to tensors through a ring of staging buffers. Hands out the "
+            "memory of the next free staging buffer via next(), which gets copied into "
+            "a tensor by the following call to upload(). Each buffer is recycled once "
+            "its upload finished, so the host can fill the next buffers while previous "
+            "uploads are still in flight."
+            "\n\nParameters\n----------\n"
+            "bufferSize: int\n"
+            "    Size of each staging buffer in bytes\n"
+            "bufferCount: int, default=2\n"
+            "    Amount of staging buffers\n"
+            "queue: QueueType, default=QueueType.TRANSFER\n"
+            "    Queue to run uploads on. Falls back to the main queue if there is no "
+                "dedicated one.\n")
+        .def("__init__",
+            [](hp::StreamingUploader* u, uint64_t bufferSize, uint32_t bufferCount, hp::QueueType queue) {
+                new (u) hp::StreamingUploader(getCurrentContext(), bufferSize, bufferCount, queue);
+            }, "bufferSize"_a, "bufferCount"_a = 2, nb::kw_only(),
+            "queue"_a = hp::QueueType::TRANSFER)
+        .def_prop_ro("bufferSize", &hp::StreamingUploader::getBufferSize,
+            "Size of each staging buffer in bytes")
+        .def_prop_ro("bufferCount", &hp::StreamingUploader::getBufferCount,
+            "Amount of staging buffers")
+        .def_prop_ro("timeline", &hp::StreamingUploader::getTimeline,
+            nb::rv_policy::reference_internal, "Timeline the uploads signal")
+        .def("next", [](hp::StreamingUploader& u) {
+                std::span<std::byte> memory;
+                {
+                    nb::gil_scoped_release release;
+                    memory = u.next();
+                }
+                return toMemoryView(memory, true);
+            }, "Returns the writable memory of the next free staging buffer. Blocks "
+            "until the upload previously using it finished.")
+        .def("upload",
+            [](hp::StreamingUploader& u, const hp::Tensor<std::byte>& dst,
+                uint64_t dstOffset, std::optional<uint64_t> size)
+            {
+                return u.upload(dst, dstOffset, size.value_or(hp::whole_size));
+            }, "dst"_a, "dstOffset"_a = 0, "size"_a.none() = nb::none(),
+            "Uploads the memory returned by next() into the given tensor and returns "
+            "the submission."
+            "\n\nParameters\n----------\n"
+            "dst: Tensor\n"
+            "    Tensor to copy to\n"
+            "dstOffset: int, default=0\n"
+            "    Offset into dst in bytes\n"
+            "size: int | None, default=None\n"
+            "    Amount of bytes to copy. If None, copies the whole buffer clamped to "
+                "the remaining size of dst.\n")
+        .def("upload",
+            [](hp::StreamingUploader& u, nb::ndarray<nb::ro, nb::c_contig, nb::device::cpu> data,
+                const hp::Tensor<std::byte>& dst, uint64_t dstOffset)
+            {
+                std::span<const std::byte> bytes(
+                    static_cast<const std::byte*>(data.data()), data.nbytes());
+                nb::gil_scoped_release release;
+                u.upload(bytes, dst, dstOffset);
+            }, "data"_a, "dst"_a, "dstOffset"_a = 0,
+            "Uploads the given data into the tensor, splitting it across staging "
+            "buffers if needed. Only blocks while waiting on free staging buffers.")
+        .def("wait", [](const hp::StreamingUploader& u) {
+                nb::gil_scoped_release release;
+                u.wait();
+            }, "Blocks until all uploads finished");
+
+    nb::class_<hp::StreamingDownloader>(m, "StreamingDownloader",
+            "Downloads data from tensors through a ring of staging buffers. download() "
+            "copies a tensor region into the next staging buffer without waiting, while "
+            "fetch() waits for the oldest pending download and returns its memory. "
+            "Multiple downloads can be in flight at once, up to the amount of staging "
+            "buffers."
+            "\n\nParameters\n----------\n"
+            "bufferSize: int\n"
+            "    Size of each staging buffer in bytes\n"
+            "bufferCount: int, default=2\n"
+            "    Amount of staging buffers\n"
+            "queue: QueueType, default=QueueType.TRANSFER\n"
+            "    Queue to run downloads on. Falls back to the main queue if there is no "
+                "dedicated one.\n")
+        .def("__init__",
+            [](hp::StreamingDownloader* d, uint64_t bufferSize, uint32_t bufferCount, hp::QueueType queue) {
+                new (d) hp::StreamingDownloader(getCurrentContext(), bufferSize, bufferCount, queue);
+            }, "bufferSize"_a, "bufferCount"_a = 2, nb::kw_only(),
+            "queue"_a = hp::QueueType::TRANSFER)
+        .def_prop_ro("bufferSize", &hp::StreamingDownloader::getBufferSize,
+            "Size of each staging buffer in bytes")
+        .def_prop_ro("bufferCount", &hp::StreamingDownloader::getBufferCount,
+            "Amount of staging buffers")
+        .def_prop_ro("pendingCount", &hp::StreamingDownloader::getPendingCount,
+            "Amount of downloads not yet fetched")
+        .def_prop_ro("timeline", &hp::StreamingDownloader::getTimeline,
+            nb::rv_policy::reference_internal, "Timeline the downloads signal")
+        .def("download",
+            [](hp::StreamingDownloader& d, const hp::Tensor<std::byte>& src,
+                uint64_t srcOffset, std::optional<uint64_t> size)
+            {
+                return d.download(src, srcOffset, size.value_or(hp::whole_size));
+            }, "src"_a, "srcOffset"_a = 0, "size"_a.none() = nb::none(),
+            "Downloads a region of the given tensor into the next staging buffer and "
+            "returns the submission. Raises if all staging buffers hold downloads not "
+            "yet fetched."
+            "\n\nParameters\n----------\n"
+            "src: Tensor\n"
+            "    Tensor to copy from\n"
+            "srcOffset: int, default=0\n"
+            "    Offset into src in bytes\n"
+            "size: int | None, default=None\n"
+            "    Amount of bytes to copy. If None, copies the whole buffer clamped to "
+                "the remaining size of src.\n")
+        .def("download",
+            [](hp::StreamingDownloader& d, const hp::Tensor<std::byte>& src,
+                nb::ndarray<nb::c_contig, nb::device::cpu> data, uint64_t srcOffset)
+            {
+                std::span<std::byte> bytes(static_cast<std::byte*>(data.data()), data.nbytes());
+                nb::gil_scoped_release release;
+                d.download(src, bytes, srcOffset);
+            }, "src"_a, "data"_a, "srcOffset"_a = 0,
+            "Downloads a region of the given tensor into the given array, splitting it "
+            "across staging buffers if needed. Blocks until the data has been copied. "
+            "Requires no pending downloads.")
+        .def("fetch", [](hp::StreamingDownloader& d) {
+                std::span<const std::byte> memory;
+                {
+                    nb::gil_scoped_release release;
+                    memory = d.fetch();
+                }
+                return toMemoryView(std::span<std::byte>(
+                    const_cast<std::byte*>(memory.data()), memory.size()), false);
+            }, "Waits for the oldest pending download and returns its data as read only "
+            "memoryview. The memory stays valid until its staging buffer gets used by "
+            "another download.");
+}
@@ -1,4 +1,5 @@
 #include <nanobind/nanobind.h>
+#include <nanobind/stl/string.h>
 #include <nanobind/stl/vector.h>
 
 #include <hephaistos/stopwatch.hpp>
@@ -27,5 +28,135 @@ void registerStopWatchModule(nb::module_& m) {
             "Calculates the elapsed time between the timestamps the device recorded "
             "during its execution of the start() end stop() command in nanoseconds. "
             "If wait is true, blocks the call until both timestamps are recorded, "
-            "otherwise returns NaN if they are not yet available.");
+            "otherwise returns NaN if they are not yet available.")
+        .def("getStartTime", &hp::StopWatch::getStartTime, "wait"_a = false,
+            "Returns the host time at which the device executed start() on the "
+            "steady clock in nanoseconds, e.g. to measure how long work waited "
+            "before starting. If wait is true, blocks the call until the timestamp "
+            "is recorded, otherwise returns NaN if it is not yet available.");
+
+    m.def("isCalibratedTimestampsSupported",
+        []() { return hp::isCalibratedTimestampsSupported(getCurrentContext()); },
+        "Returns True, if the current context supports calibrated timestamps. "
+        "Note that this may initialize the context.");
+
+    nb::class_<hp::ClockCorrelation>(m, "ClockCorrelation",
+            "Correlation between device timestamps and the host's steady clock")
+        .def_ro("deviceOffset", &hp::ClockCorrelation::deviceOffset,
+            "Offset in nanoseconds converting device timestamps into steady clock time")
+        .def_ro("maxDeviation", &hp::ClockCorrelation::maxDeviation,
+            "Maximum deviation of the correlation in nanoseconds");
+    m.def("getClockCorrelation",
+        []() {
+            nb::gil_scoped_release release;
+            return hp::getClockCorrelation(getCurrentContext());
+        },
+        "Correlates the device's timestamps with the host's steady clock. Uses "
+        "calibrated timestamps if supported, otherwise submits and waits on a "
+        "single timestamp.");
+
+    m.def("isPipelineStatisticsSupported",
+        []() { return hp::isPipelineStatisticsSupported(getCurrentContext()); },
+        "Returns True, if the current context supports pipeline statistics. Note "
+        "that this may initialize the context.");
+
+    nb::class_<hp::PipelineStatisticsResult>(m, "PipelineStatisticsResult",
+            "Statistics recorded by PipelineStatistics")
+        .def_ro("invocations", &hp::PipelineStatisticsResult::invocations,
+            "Amount of compute shader invocations between start() and stop()")
+        .def_ro("elapsedTime", &hp::PipelineStatisticsResult::elapsedTime,
+            "Elapsed time between start() and stop() in nanoseconds")
+        .def_prop_ro("invocationsPerSecond",
+            [](const hp::PipelineStatisticsResult& r) {
+                return r.invocations / r.elapsedTime * 1e9;
+            }, "Amount of compute shader invocations per second");
+
+    nb::class_<hp::PipelineStatistics>(m, "PipelineStatistics",
+            "Counts compute shader invocations between commands execution. "
+            "start() and stop() must be recorded into the same step of a sequence.")
+        .def("__init__",
+            [](hp::PipelineStatistics* s) {
+                nb::gil_scoped_release release;
+                new (s) hp::PipelineStatistics(getCurrentContext());
+            },
+            "Creates a new query for counting compute shader invocations between "
+            "commands.")
+        .def("start", &hp::PipelineStatistics::start, nb::rv_policy::reference_internal,
+            "Returns the command to start the query.")
+        .def("stop", &hp::PipelineStatistics::stop, nb::rv_policy::reference_internal,
+            "Returns the command to stop the query.")
+        .def("reset", &hp::PipelineStatistics::reset, "Resets the query.")
+        .def("getResult", &hp::PipelineStatistics::getResult, "wait"_a = false,
+            "Returns the amount of compute shader invocations and elapsed time in "
+            "nanoseconds between start() and stop(). If wait is True, blocks the "
+            "call until the results are available, otherwise returns zero "
+            "invocations and NaN if they are not yet available.");
+
+    nb::class_<hp::ProfilerScopeCommand, hp::Command>(m, "ProfilerScopeCommand",
+            "Command starting or ending a named scope of a Profiler")
+        .def_ro("name", &hp::ProfilerScopeCommand::name,
+            "Name of the scope to begin or empty to end the innermost open scope");
+
+    nb::class_<hp::ProfilerSample>(m, "ProfilerSample",
+            "Single measurement of a scope recorded by a Profiler")
+        .def_ro("name", &hp::ProfilerSample::name,
+            "Path of the scope, i.e. the names of all enclosing scopes and its own joined by '/'")
+        .def_ro("depth", &hp::ProfilerSample::depth,
+            "Amount of scopes enclosing this one")
+        .def_ro("frame", &hp::ProfilerSample::frame,
+            "Frame during which the scope was recorded")
+        .def_ro("start", &hp::ProfilerSample::start,
+            "Device timestamp at which the scope started in nanoseconds")
+        .def_ro("duration", &hp::ProfilerSample::duration,
+            "Elapsed time between start and end of the scope in nanoseconds");
+
+    nb::class_<hp::ProfilerScopeStatistics>(m, "ProfilerScopeStatistics",
+            "Aggregated measurements of all scopes sharing the same path")
+        .def_ro("name", &hp::ProfilerScopeStatistics::name,
+            "Path of the scope, i.e. the names of all enclosing scopes and its own joined by '/'")
+        .def_ro("depth", &hp::ProfilerScopeStatistics::depth,
+            "Amount of scopes enclosing this one")
+        .def_ro("count", &hp::ProfilerScopeStatistics::count,
+            "Total amount of measurements since the last reset")
+        .def_ro("min", &hp::ProfilerScopeStatistics::min,
+            "Shortest duration within the sample window in nanoseconds")
+        .def_ro("mean", &hp::ProfilerScopeStatistics::mean,
+            "Mean duration within the sample window in nanoseconds")
+        .def_ro("p99", &hp::ProfilerScopeStatistics::p99,
+            "99th percentile of the duration within the sample window in nanoseconds");
+
+    nb::class_<hp::Profiler>(m, "Profiler",
+            "Hierarchical profiler measuring named scopes on the device. Results "
+            "are gathered without waiting on the device and kept in a ring of frames.")
+        .def("__init__",
+            [](hp::Profiler* p, uint32_t frameCount) {
+                nb::gil_scoped_release release;
+                new (p) hp::Profiler(getCurrentContext(), frameCount);
+            }, "frameCount"_a = 3,
+            "Creates a new profiler keeping a ring of frameCount frames."
+            "\n\nParameters\n----------\n"
+            "frameCount: int, default=3\n"
+            "    Amount of frames kept in the ring. Should exceed the amount of "
+            "frames the device lags behind the host.\n")
+        .def("beginScope", &hp::Profiler::beginScope, "name"_a, nb::keep_alive<0, 1>(),
+            "Returns the command starting a new scope nested inside the innermost "
+            "scope still open while recording. The name must not be empty or contain '/'.")
+        .def("endScope", &hp::Profiler::endScope, nb::keep_alive<0, 1>(),
+            "Returns the command ending the innermost open scope.")
+        .def_prop_ro("currentFrame", &hp::Profiler::getCurrentFrame,
+            "The current frame number")
+        .def_prop_ro("frameCount", &hp::Profiler::getFrameCount,
+            "Amount of frames kept in the ring")
+        .def("nextFrame", &hp::Profiler::nextFrame,
+            "Collects available results, recycles the oldest frame and returns "
+            "the new frame number. Raises if scopes are still open.")
+        .def("collect", &hp::Profiler::collect,
+            "Reads all results available without waiting on the device.")
+        .def("getSamples", &hp::Profiler::getSamples,
+            "Returns the collected measurements of the frames still in the ring "
+            "ordered by frame and start time.")
+        .def("getStatistics", &hp::Profiler::getStatistics,
+            "Returns min, mean and 99th percentile of the durations per scope path.")
+        .def("resetStatistics", &hp::Profiler::resetStatistics,
+            "Clears the aggregated measurements.");
 }
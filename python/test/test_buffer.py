@@ -0,0 +1,42 @@
+import hephaistos as hp
+
+
+def test_bufferProtocol():
+    buffer = hp.IntBuffer(16)
+    view = memoryview(buffer)
+    assert view.format == "i"
+    assert view.itemsize == 4
+    assert view.shape == (16,)
+    assert view.nbytes == 64
+    assert not view.readonly
+
+    raw = memoryview(hp.RawBuffer(64))
+    assert raw.format == "B"
+    assert raw.shape == (64,)
+
+    # writes through the view reach the device
+    for i in range(16):
+        view[i] = 3 * i
+    tensor = hp.IntTensor(16)
+    result = hp.IntBuffer(16)
+    hp.execute(hp.updateTensor(buffer, tensor))
+    hp.execute(hp.retrieveTensor(tensor, result))
+    assert memoryview(result).tolist() == [3 * i for i in range(16)]
+
+    # tensors are only accessible if mapped
+    try:
+        memoryview(tensor)
+        assert False
+    except BufferError:
+        pass
+    mapped = hp.IntTensor(16, mapped=True)
+    if mapped.isMapped:
+        view = memoryview(mapped)
+        assert view.format == "i"
+        assert view.shape == (16,)
+        assert not view.readonly
+        for i in range(16):
+            view[i] = -i
+        mapped.flush()
+        hp.execute(hp.retrieveTensor(mapped, result))
+        assert memoryview(result).tolist() == [-i for i in range(16)]
@@ -0,0 +1,88 @@
+import asyncio
+import hephaistos as hp
+import numpy as np
+
+
+batchSource = """
+#version 460
+
+layout(local_size_x = 32) in;
+
+layout(binding = 0) buffer Data { int data[]; };
+
+layout(push_constant) uniform Push {
+    uint offset;
+    int value;
+};
+
+void main() {
+    data[offset + gl_GlobalInvocationID.x] += value;
+}
+"""
+
+
+def test_batch():
+    program = hp.Program(hp.Compiler().compile(batchSource))
+    tensor = hp.IntTensor(256)
+    program.bindParams(Data=tensor)
+    buffer = hp.IntBuffer(256)
+    buffer.numpy()[:] = np.arange(256)
+    result = hp.IntBuffer(256)
+
+    # copy blocks of 32 items in reversed order
+    regions = np.array([[k * 128, (7 - k) * 128, 128] for k in range(8)], np.uint64)
+    # one dispatch per quarter, each adding a different value
+    groups = np.array([[2, 1, 1]] * 4, np.uint32)
+    push = np.array([[j * 64, j + 1] for j in range(4)], np.int32)
+    batch = program.dispatchBatch(groups, push)
+
+    hp.beginSequence().And(hp.updateTensorBatch(buffer, tensor, regions)).Then(
+        batch
+    ).Then(hp.retrieveTensor(tensor, result)).Submit().wait()
+
+    # check result
+    expected = np.arange(256).reshape(8, 32)[::-1].flatten()
+    expected += np.arange(256) // 64 + 1
+    assert np.all(result.numpy() == expected)
+
+    # issue the same dispatches directly into a sequence
+    sequence = hp.beginSequence()
+    program.dispatchBatch(sequence, groups, push)
+    sequence.Then(hp.retrieveTensor(tensor, result)).Submit().wait()
+    expected += np.arange(256) // 64 + 1
+    assert np.all(result.numpy() == expected)
+
+    # push data must match the amount of dispatches
+    try:
+        program.dispatchBatch(groups, push[:2])
+        assert False
+    except ValueError:
+        pass
+
+
+def test_waitAsync():
+    tensor = hp.IntTensor(64)
+    buffer = hp.IntBuffer(64)
+    timeline = hp.Timeline()
+
+    async def run() -> None:
+        submission = (
+            hp.beginSequence(timeline)
+            .And(hp.clearTensor(tensor, data=7))
+            .Then(hp.retrieveTensor(tensor, buffer))
+            .Submit()
+        )
+        await submission.waitAsync()
+        assert timeline.value >= submission.finalStep
+
+        # timelines can be awaited for values signaled later on
+        value = submission.finalStep + 1
+        waiter = asyncio.ensure_future(timeline.waitAsync(value))
+        await asyncio.sleep(0)
+        assert not waiter.done()
+        timeline.value = value
+        await waiter
+
+    asyncio.run(run())
+    # results are visible once awaited
+    assert np.all(buffer.numpy() == 7)
@@ -197,3 +197,70 @@ def test_composite():
     assert a.m[0][:] == (3.0, 3.0, 3.0, 3.0)
     assert a.m[1][:] == (-1.0, -2.0, -3.0, -4.0)
     assert a.m[2][:] == (3.0, 3.0, 3.0, 3.0)
+
+
+def test_RandomStreams():
+    import hephaistos as hp
+    from ctypes import sizeof
+
+    allocator = hp.RandomStreamAllocator(42, 5)
+    streams = RandomStreams(allocator.seed, allocator.allocate(10))
+    assert sizeof(streams) == 16
+    assert streams.seed == 42
+    assert streams.offset == 5
+    assert allocator.allocate(3) == 15
+    assert allocator.allocated == 18
+
+    # known answer of Random123
+    assert hp.philox4x32((0, 0, 0, 0), (0, 0)) == (
+        0x6627E8D5,
+        0xE169C58D,
+        0xBC57AC4C,
+        0x9B00DBD8,
+    )
+
+
+def test_createStructure():
+    import hephaistos as hp
+    from ctypes import sizeof
+
+    source = """
+#version 460
+#extension GL_EXT_scalar_block_layout : require
+
+layout(local_size_x = 1) in;
+
+struct Item {
+    uint id;
+    vec2 pos;
+};
+
+layout(scalar, binding = 0) buffer Data {
+    vec3 dir;
+    Item items[2];
+    uint tail[];
+};
+
+layout(scalar, push_constant) uniform Push {
+    float scale;
+    vec3 offset;
+} push;
+
+void main() {
+    dir = push.offset * push.scale;
+    tail[items[1].id] = uint(items[0].pos.x);
+}
+"""
+    program = hp.Program(hp.Compiler().compile(source))
+    Data = createStructure(program.bindings[0].members, name="Data")
+    assert sizeof(Data) == 36
+    assert Data.items.offset == 12
+    assert Data.tail.offset == 36
+    data = Data()
+    data.items[1].pos.y = 2.0
+    assert data.items[1].pos[:] == (0.0, 2.0)
+
+    Push = createPushStructure(program)
+    assert sizeof(Push) == 16
+    assert Push.offset.offset == 4
+    assert isinstance(Push().offset, vec3)
@@ -58,8 +58,8 @@ class PipelineTestStage(pl.PipelineStage):
 
     name = "test"
 
-    def __init__(self) -> None:
-        super().__init__({"Params": self.Params})
+    def __init__(self, *, nConfigs: int = 2) -> None:
+        super().__init__({"Params": self.Params}, nConfigs=nConfigs)
         # load shader
         code = None
         shader_path = join(dirname(__file__), "shader/pipeline_test.spv")
@@ -143,3 +143,313 @@ def test_scheduler():
         m, b = m2[i], b2[i]
         expected = np.arange(256) * m + b
         assert np.all(results[i + len(m1)] == expected)
+
+
+def test_scheduler_profile():
+    # create profiling pipeline
+    comp = PipelineTestStage()
+    retr = pl.RetrieveTensorStage(comp.tensor)
+    pipeline = pl.Pipeline([comp, retr], profile=True)
+    assert pipeline.profiling
+    assert all(np.isnan(t) for t in pipeline.stageTimes.values())
+
+    # profiling must not alter the results
+    results = []
+
+    def process(i: int, n: int):
+        results.append(retr.view(i, np.int32).copy())
+
+    scheduler = pl.PipelineScheduler(pipeline, processFn=process)
+    tasks = [{"m": x, "b": 10 * x} for x in range(6)]
+    scheduler.schedule(tasks)
+    scheduler.wait()
+    for n, result in enumerate(results):
+        assert np.all(result == np.arange(256) * n + 10 * n)
+
+    # every stage got measured
+    profile = scheduler.profile
+    assert set(profile.stageTimes.keys()) == {"test", "retrieve"}
+    assert all(t >= 0.0 for t in profile.stageTimes.values())
+    assert profile.updateTime > 0.0
+
+    scheduler.resetProfile()
+    profile = scheduler.profile
+    assert np.isnan(profile.updateTime)
+    assert all(np.isnan(t) for t in profile.stageTimes.values())
+
+
+def test_scheduler_configs():
+    # create pipeline with triple buffered configurations
+    comp = PipelineTestStage(nConfigs=3)
+    retr = pl.RetrieveTensorStage(comp.tensor, nConfigs=3)
+    pipeline = pl.Pipeline([comp, retr])
+    assert pipeline.nConfigs == 3
+
+    # stages must agree on the number of configurations
+    try:
+        pl.Pipeline([comp, pl.RetrieveTensorStage(comp.tensor)])
+        assert False
+    except ValueError:
+        pass
+
+    # create processing function
+    results = []
+    configs = []
+
+    def process(i: int, n: int):
+        configs.append(i)
+        results.append(retr.view(i, np.int32).copy())
+
+    # create scheduler
+    scheduler = pl.PipelineScheduler(pipeline, processFn=process)
+
+    # schedule tasks
+    m = [3 * x - 7 for x in range(10)]
+    b = [20 * x + 1 for x in range(10)]
+    tasks = [{"m": m[i], "b": b[i]} for i in range(len(m))]
+    scheduler.schedule(tasks)
+    scheduler.wait()
+
+    # check tasks rotated through all configurations
+    assert configs == [i % 3 for i in range(len(tasks))]
+    for i in range(len(tasks)):
+        expected = np.arange(256) * m[i] + b[i]
+        assert np.all(results[i] == expected)
+
+
+class FusedSampleStage(pl.FusableStage):
+    class Params(Structure):
+        _fields_ = [("m", c_int32)]
+
+    name = "sample"
+    functionName = "sampleValue"
+    outputType = "int"
+    workSize = 256
+    sourceCode = """
+layout(binding = 0) uniform SampleParams { int m; };
+int sampleValue(uint idx) { return int(idx) * m; }
+"""
+
+    def __init__(self) -> None:
+        super().__init__({"SampleParams": self.Params})
+
+
+class FusedTransformStage(pl.FusableStage):
+    class Params(Structure):
+        _fields_ = [("b", c_int32)]
+
+    name = "transform"
+    functionName = "transformValue"
+    inputType = "int"
+    outputType = "int"
+    sourceCode = """
+layout(binding = 1) uniform TransformParams { int b; };
+int transformValue(uint idx, int value) { return value + b; }
+"""
+
+    def __init__(self) -> None:
+        super().__init__({"TransformParams": self.Params})
+
+
+class FusedStoreStage(pl.FusableStage):
+    name = "store"
+    functionName = "storeValue"
+    inputType = "int"
+    sourceCode = """
+layout(binding = 2) writeonly buffer FusedOutput { int fusedOut[]; };
+void storeValue(uint idx, int value) { fusedOut[idx] = value; }
+"""
+
+    def __init__(self) -> None:
+        super().__init__()
+        self.tensor = hp.IntTensor(256)
+
+    def bindParams(self, program: hp.Program, i: int) -> None:
+        super().bindParams(program, i)
+        program.bindParams(FusedOutput=self.tensor)
+
+
+def test_stage_fusion():
+    # create pipeline with fused stages
+    store = FusedStoreStage()
+    retr = pl.RetrieveTensorStage(store.tensor)
+    pipeline = pl.Pipeline(
+        [FusedSampleStage(), FusedTransformStage(), store, retr]
+    )
+    assert len(pipeline.fusedSources) == 1
+    assert "storeValue(idx, value1);" in pipeline.fusedSources[0]
+
+    # run pipeline
+    pipeline.setParams(m=3, b=-12)
+    pipeline.run(0)
+
+    # check result
+    expected = np.arange(256) * 3 - 12
+    assert np.all(retr.view(0, np.int32) == expected)
+
+    # types must be compatible
+    try:
+        pl.fuseStageSource([FusedSampleStage(), FusedStoreStage(), store])
+        assert False
+    except ValueError:
+        pass
+
+
+def test_scheduler_packed():
+    # create pipeline
+    comp = PipelineTestStage()
+    retr = pl.RetrieveTensorStage(comp.tensor)
+    pipeline = pl.Pipeline([comp, retr])
+
+    # create processing function
+    results = []
+
+    def process(i: int, n: int):
+        results.append(retr.view(i, np.int32).copy())
+
+    # create scheduler
+    scheduler = pl.PipelineScheduler(pipeline, processFn=process)
+
+    # pack params of all tasks at once
+    m = np.arange(8, dtype=np.int32) * 3 - 5
+    b = np.arange(8, dtype=np.int32) * 11
+    packed = pipeline.packParams({"test__m": m, "b": b})
+    assert len(packed) == len(m)
+
+    # schedule both packed and structured array
+    tasks = np.zeros(4, dtype=[("m", np.int32), ("b", np.int32)])
+    tasks["m"] = [7, 8, 9, 10]
+    tasks["b"] = [-1, -2, -3, -4]
+    scheduler.schedulePacked(packed)
+    scheduler.schedulePacked(tasks)
+    scheduler.wait()
+
+    # check results
+    allM = list(m) + list(tasks["m"])
+    allB = list(b) + list(tasks["b"])
+    assert len(results) == len(allM)
+    for i in range(len(allM)):
+        expected = np.arange(256) * allM[i] + allB[i]
+        assert np.all(results[i] == expected)
+
+
+class StreamCopyStage(pl.PipelineStage):
+    name = "copy"
+
+    def __init__(self, executor: hp.StreamExecutor) -> None:
+        super().__init__(nConfigs=executor.slotCount)
+        self._executor = executor
+
+    def run(self, i: int) -> List:
+        return [
+            hp.copyTensor(self._executor.getInput(i), self._executor.getOutput(i))
+        ]
+
+
+def test_streamPipeline():
+    # stream more items than fit into the slots at once
+    executor = hp.StreamExecutor(4, 4, chunkSize=100)
+    assert executor.chunkSize == 100
+    pipeline = pl.Pipeline([StreamCopyStage(executor)])
+    data = np.arange(1234, dtype=np.int32)
+    results = []
+
+    def source(chunk: memoryview, n: int) -> int:
+        items = data[n * 100 : (n + 1) * 100]
+        np.frombuffer(chunk, np.int32)[: len(items)] = items
+        return len(items)
+
+    def sink(chunk: memoryview, n: int) -> None:
+        results.append(np.frombuffer(chunk, np.int32).copy())
+
+    nChunks = pl.streamPipeline(executor, pipeline, source, sink)
+
+    # check result
+    assert nChunks == 13
+    assert len(results[-1]) == 34
+    assert np.all(np.concatenate(results) == data)
+
+
+class TransientProduceStage(pl.PipelineStage):
+    name = "produce"
+
+    def __init__(self) -> None:
+        super().__init__()
+        # alive while produced and read by the next stage
+        self.declareTransient("a", 1024)
+
+    def run(self, i: int) -> List:
+        return [hp.clearTensor(self.getTransient("a", i), data=10 * (i + 1))]
+
+
+class TransientRelayStage(pl.PipelineStage):
+    name = "relay"
+
+    def __init__(self, src: pl.PipelineStage) -> None:
+        super().__init__()
+        self._src = src
+        # overlaps with both "a" and "c"
+        self.declareTransient("b", 512)
+
+    def run(self, i: int) -> List:
+        a, b = self._src.getTransient("a", i), self.getTransient("b", i)
+        return [hp.copyTensor(a, b, size=512)]
+
+
+class TransientPadStage(pl.PipelineStage):
+    name = "pad"
+
+    def __init__(self, src: pl.PipelineStage) -> None:
+        super().__init__()
+        self._src = src
+        # lifetime past the last stage gets clamped; may alias "a"
+        self.declareTransient("c", 1024, lastUse=10)
+
+    def run(self, i: int) -> List:
+        b, c = self._src.getTransient("b", i), self.getTransient("c", i)
+        return [hp.clearTensor(c, data=0xFFFFFFFF), hp.copyTensor(b, c)]
+
+
+class TransientStoreStage(pl.PipelineStage):
+    name = "store"
+
+    def __init__(self, src: pl.PipelineStage) -> None:
+        super().__init__()
+        self._src = src
+        self.tensor = hp.IntTensor(256)
+
+    def run(self, i: int) -> List:
+        return [hp.copyTensor(self._src.getTransient("c", i), self.tensor)]
+
+
+def test_transients():
+    # transients are only available inside a pipeline
+    produce = TransientProduceStage()
+    assert produce.transients == {"a": (1024, 1)}
+    try:
+        produce.getTransient("a", 0)
+        assert False
+    except RuntimeError:
+        pass
+
+    # create pipeline
+    relay = TransientRelayStage(produce)
+    pad = TransientPadStage(relay)
+    store = TransientStoreStage(pad)
+    retr = pl.RetrieveTensorStage(store.tensor)
+    pipeline = pl.Pipeline([produce, relay, pad, store, retr])
+
+    # "a" and "c" do not overlap and share memory in each configuration
+    declared, aliased = pipeline.transientMemory
+    assert declared == 2 * (1024 + 512 + 1024)
+    assert aliased == 2 * (1024 + 512)
+
+    # run both configurations
+    pipeline.run(0)
+    pipeline.run(1)
+
+    # check result
+    for i in range(2):
+        expected = np.full(256, -1)
+        expected[:128] = 10 * (i + 1)
+        assert np.all(retr.view(i, np.int32) == expected)
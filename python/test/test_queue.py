@@ -138,3 +138,160 @@ def test_queueSerialization(tmp_path):
     assert copy.count == queue.count
     assert copy.header.u == queue.header.u
     assert copy.header.f == queue.header.f
+
+
+def test_queueChunkedSerialization(tmp_path):
+    file = tmp_path / "chunked.bin"
+
+    buffer = QueueBuffer(Item, 100, header=Header)
+    queue = buffer.view
+    queue.header.u = 17
+    queue["a"][:] = np.arange(100).astype(np.uint32)
+    queue["b"][:] = np.arange(100)
+    queue["v"][:] = np.arange(300).reshape((-1, 3))
+
+    # stream two batches with appending in between
+    queue.count = 60
+    with QueueWriter(file, Item, header=queue.header, chunkSize=16) as writer:
+        writer.write(buffer)
+    queue.count = 100
+    with QueueWriter(file, Item, chunkSize=16, append=True) as writer:
+        writer.write(queue[60:])
+
+    with QueueReader(file) as reader:
+        assert reader.count == 100
+        assert reader.fields == queue.fields
+        assert reader.codec == "zlib"
+        assert Header.from_buffer_copy(reader.header).u == 17
+        part = reader.read(["a", "v"], start=30, stop=70)
+        assert set(part.keys()) == {"a", "v"}
+        assert (part["a"] == queue["a"][30:70]).all()
+        assert (part["v"] == queue["v"][30:70]).all()
+        chunks = list(reader.iterChunks(["b"]))
+        assert sum(len(data["b"]) for _, data in chunks) == 100
+
+    # uncompressed files get memory mapped
+    saveQueue(file, buffer, compressed=False, chunkSize=32)
+    with QueueReader(file) as reader:
+        assert reader.codec == "none"
+        assert (reader.read(start=90)["b"] == queue["b"][90:]).all()
+
+    copyBuf = QueueBuffer(Item, 100, header=Header)
+    loadQueue(file, copyBuf)
+    copy = copyBuf.view
+    assert copy.count == 100
+    assert (copy["v"] == queue["v"]).all()
+    assert copy.header.u == 17
+
+
+def test_queueStructured():
+    buffer = QueueBuffer(Item, 100)
+    queue = buffer.view
+    queue["a"][:] = np.arange(100).astype(np.uint32)
+    queue["v"][:] = np.arange(300).reshape((-1, 3))
+    queue.count = 40
+
+    assert queue.dtype == np.dtype(Item)
+    assert queue.dtype.names == ("a", "b", "v")
+
+    # zero copy: writes are visible on both sides
+    arr = queue.array
+    assert arr.shape == ()
+    assert (arr["a"] == queue["a"]).all()
+    assert (arr["v"].T == queue["v"]).all()
+    arr["b"][:] = 2.5
+    assert (queue["b"] == 2.5).all()
+
+    items = dumpQueueStructured(queue)
+    assert items.dtype == np.dtype(Item)
+    assert len(items) == 40
+    assert (items["a"] == np.arange(40)).all()
+    assert (items["v"] == queue["v"][:40]).all()
+    assert len(dumpQueueStructured(queue[10:20])) == 10
+
+
+def test_packedQueue():
+    layout = QueueLayout(Item, {"a": "flag", "b": "half", "v": "snorm16"})
+    assert sizeof(layout.storage) == 12
+    assert queueSize(layout, 100) == 1200 + sizeof(QueueView.Counter)
+    buffer = QueueBuffer(layout, 100)
+    assert buffer.size_bytes == queueSize(layout, 100)
+    queue = buffer.view
+    assert queue.fields == {"a", "b", "v"}
+    assert queue.dtype == np.dtype(Item)
+
+    values = np.linspace(-1.0, 1.0, 300).reshape((-1, 3))
+    queue["a"] = np.arange(100) % 2
+    queue["b"] = np.arange(100)
+    queue["v"] = values
+    assert (queue["a"] == np.arange(100) % 2).all()
+    assert (queue["b"] == np.arange(100)).all()
+    assert np.abs(queue["v"] - values).max() <= 1.0 / 32767
+
+    # encoded fields are copies -> write through sub views
+    queue[10:20]["b"] = 0.5
+    assert (queue["b"][10:20] == 0.5).all()
+    queue[queue["a"] == 0]["a"] = 1
+    assert (queue["a"] == 1).all()
+
+    queue.count = 100
+    copy = QueueBuffer(layout, 100).view
+    updateQueue(copy, dumpQueue(queue))
+    for field in queue.fields:
+        assert (copy[field] == queue[field]).all()
+
+    code = QueueTensor(layout, 100, header=Header).glsl()
+    assert "float16_t b[100];" in code
+    assert "int16_t v[3][100];" in code
+    assert "uint flags[100];" in code
+    assert "Item ItemQueue_load(ItemQueue q, uint i)" in code
+
+
+def test_compactQueue():
+    import hephaistos as hp
+
+    buffer = QueueBuffer(Item, 100, header=Header)
+    queue = buffer.view
+    queue["a"][:] = np.arange(100).astype(np.uint32)
+    queue["v"][:] = np.arange(300).reshape((-1, 3))
+    src = QueueTensor(Item, 100, header=Header)
+    dst = QueueTensor(Item, 100, header=Header)
+    keep = (np.arange(100) % 3 == 0).astype(np.uint32)
+    flags = hp.UnsignedIntTensor(keep)
+
+    primitives = hp.Primitives()
+    hp.execute(hp.updateTensor(buffer, src))
+    hp.execute(compactQueue(primitives, src, dst, flags))
+    copyBuf = QueueBuffer(Item, 100, header=Header)
+    hp.execute(hp.retrieveTensor(dst, copyBuf))
+
+    copy = copyBuf.view
+    assert copy.count == 34
+    assert (copy["a"][:34] == np.arange(0, 100, 3)).all()
+    assert (copy["v"][:34] == queue["v"][::3]).all()
+
+
+def test_sortQueue():
+    import hephaistos as hp
+
+    buffer = QueueBuffer(Item, 100, header=Header)
+    queue = buffer.view
+    queue["a"][:] = np.arange(100).astype(np.uint32)
+    queue["b"][:] = (np.arange(100) * 37) % 11 - 5.0
+    queue["v"][:] = np.arange(300).reshape((-1, 3))
+    queue.count = 80
+    src = QueueTensor(Item, 100, header=Header)
+    dst = QueueTensor(Item, 100, header=Header)
+
+    primitives = hp.Primitives()
+    hp.execute(hp.updateTensor(buffer, src))
+    hp.execute(sortQueue(primitives, src, dst, "b"))
+    copyBuf = QueueBuffer(Item, 100, header=Header)
+    hp.execute(hp.retrieveTensor(dst, copyBuf))
+
+    copy = copyBuf.view
+    order = np.argsort(queue["b"][:80], kind="stable")
+    assert copy.count == 80
+    assert (copy["b"][:80] == queue["b"][:80][order]).all()
+    assert (copy["a"][:80] == order).all()
+    assert (copy["v"][:80] == queue["v"][:80][order]).all()
@@ -0,0 +1,62 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/string.h>
+#include <nanobind/stl/vector.h>
+
+#include <hephaistos/trace.hpp>
+#include "context.hpp"
+
+namespace hp = hephaistos;
+namespace nb = nanobind;
+using namespace nb::literals;
+
+void registerTraceModule(nb::module_& m) {
+    nb::class_<hp::TraceEvent>(m, "TraceEvent",
+            "Single event of a Trace")
+        .def_ro("name", &hp::TraceEvent::name,
+            "Name of the event, e.g. the scope name for device events")
+        .def_ro("category", &hp::TraceEvent::category,
+            "Category of the event, e.g. 'submit', 'wait', 'update' or 'device'")
+        .def_ro("thread", &hp::TraceEvent::thread,
+            "Track the event belongs to. Zero for events on the device, otherwise "
+            "the index of the host thread starting at one.")
+        .def_ro("start", &hp::TraceEvent::start,
+            "Start of the event on the host's steady clock in nanoseconds")
+        .def_ro("duration", &hp::TraceEvent::duration,
+            "Duration of the event in nanoseconds. Zero for instant events.");
+
+    nb::class_<hp::Trace>(m, "Trace",
+            "Host and device events recorded between beginTrace() and endTrace()")
+        .def_ro("events", &hp::Trace::events, "Recorded events")
+        .def_ro("startTime", &hp::Trace::startTime,
+            "Time at which tracing started on the host's steady clock in nanoseconds")
+        .def_ro("deviceOffset", &hp::Trace::deviceOffset,
+            "Offset converting device timestamps into the host's steady clock "
+            "in nanoseconds")
+        .def("addProfilerSamples",
+            [](hp::Trace& trace, const std::vector<hp::ProfilerSample>& samples) {
+                hp::addProfilerSamples(trace, samples);
+            }, "samples"_a,
+            "Adds samples as returned by Profiler.getSamples() as device events.")
+        .def("toChromeTrace", [](const hp::Trace& trace) { return hp::writeChromeTrace(trace); },
+            "Writes the trace in the Chrome trace event JSON format, which can be "
+            "opened by chrome://tracing or the Perfetto UI.")
+        .def("toPerfetto",
+            [](const hp::Trace& trace) -> nb::bytes {
+                auto data = hp::writePerfettoTrace(trace);
+                return nb::bytes(reinterpret_cast<const char*>(data.data()), data.size());
+            }, "Writes the trace in the Perfetto protobuf format.");
+
+    m.def("beginTrace",
+        []() {
+            nb::gil_scoped_release release;
+            hp::beginTrace(getCurrentContext());
+        },
+        "Starts recording submissions, waits and timeline updates from the host "
+        "on the current context. Also correlates the device's timestamps with the "
+        "host's clock, so profiler samples can be added to the trace.");
+    m.def("endTrace", []() { return hp::endTrace(getCurrentContext()); },
+        "Stops recording host events and returns the recorded trace.");
+    m.def("isTracing", []() { return hp::isTracing(getCurrentContext()); },
+        "Returns True, if host events are recorded on the current context. Note "
+        "that this may initialize the context.");
+}
@@ -0,0 +1,77 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/filesystem.h>
+#include <nanobind/stl/optional.h>
+#include <nanobind/stl/vector.h>
+
+#include <hephaistos/tuning.hpp>
+#include "context.hpp"
+
+namespace hp = hephaistos;
+namespace nb = nanobind;
+using namespace nb::literals;
+
+void registerTuningModule(nb::module_& m) {
+    nb::class_<hp::TuningResult>(m, "TuningResult",
+            "Result of tuning a program")
+        .def_ro("index", &hp::TuningResult::index,
+            "Index of the fastest candidate")
+        .def_prop_ro("specialization",
+            [](const hp::TuningResult& r) {
+                return nb::bytes(reinterpret_cast<const char*>(r.specialization.data()),
+                    r.specialization.size());
+            }, "Specialization of the fastest candidate")
+        .def_ro("times", &hp::TuningResult::times,
+            "Median time in nanoseconds of each candidate. Infinite for candidates "
+            "which failed. Empty if the result was read from the cache.");
+
+    m.def("tuneProgram",
+        [](nb::bytes code,
+            const std::vector<nb::bytes>& candidates,
+            nb::callable dispatch,
+            uint32_t warmup,
+            uint32_t repetitions,
+            std::optional<std::filesystem::path> cacheFile
+        ) -> hp::TuningResult {
+            std::vector<std::vector<std::byte>> data(candidates.size());
+            for (auto i = 0u; i < candidates.size(); ++i) {
+                auto p = reinterpret_cast<const std::byte*>(candidates[i].c_str());
+                data[i].assign(p, p + candidates[i].size());
+            }
+            //dispatches might reference push data owned by the returned object
+            std::vector<nb::object> keepAlive;
+            return hp::tuneProgram(getCurrentContext(),
+                std::span<const uint32_t>{
+                    reinterpret_cast<const uint32_t*>(code.c_str()),
+                    code.size() / 4
+                },
+                std::span<const std::vector<std::byte>>{ data },
+                [&dispatch, &keepAlive](hp::Program& program, uint32_t candidate) {
+                    auto result = dispatch(nb::cast(&program, nb::rv_policy::reference), candidate);
+                    keepAlive.push_back(result);
+                    return nb::cast<hp::DispatchCommand>(result);
+                },
+                hp::TuningOptions{
+                    .warmup = warmup,
+                    .repetitions = repetitions,
+                    .cacheFile = cacheFile.value_or(std::filesystem::path{})
+                });
+        }, "code"_a, "candidates"_a, "dispatch"_a,
+        "warmup"_a = 1, "repetitions"_a = 5, "cacheFile"_a.none() = nb::none(),
+        "Finds the fastest specialization of the given program on the current device "
+        "by timing the dispatch returned by the callback for each candidate. Candidates "
+        "throwing while being created or benchmarked are skipped."
+        "\n\nParameters\n----------\n"
+        "code: bytes\n"
+        "    Byte code of the program\n"
+        "candidates: list[bytes]\n"
+        "    Specializations to choose from, e.g. different workgroup sizes\n"
+        "dispatch: Callable[[Program, int], DispatchCommand]\n"
+        "    Called with the program and index of each candidate. Must bind the\n"
+        "    parameters and return a representative dispatch.\n"
+        "warmup: int, default=1\n"
+        "    Amount of untimed runs per candidate\n"
+        "repetitions: int, default=5\n"
+        "    Amount of timed runs per candidate, of which the median is used\n"
+        "cacheFile: pathlib.Path | None, default=None\n"
+        "    File to cache results in per device, code and candidates\n");
+}
@@ -0,0 +1,96 @@
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/optional.h>
+
+#include <optional>
+
+#include <hephaistos/workqueue.hpp>
+#include "context.hpp"
+
+namespace hp = hephaistos;
+namespace nb = nanobind;
+using namespace nb::literals;
+
+void registerWorkQueueModule(nb::module_& m) {
+    nb::class_<hp::WorkQueueCommand, hp::Command>(m, "WorkQueueCommand",
+        "Command seeding a work queue or running persistent workgroups on it. "
+        "Runs multiple dispatches synchronized among each other, but not with "
+        "work recorded before or after.");
+
+    nb::class_<hp::WorkQueue>(m, "WorkQueue",
+            "Device side queue of 32 bit work items processed by persistent "
+            "workgroups. Programs include the built-in header "
+            "\"hephaistos/workqueue.glsl\" and loop popping items via "
+            "workQueuePop() until the queue is empty, pushing follow up work via "
+            "workQueuePush(). Items pushed in a round are popped in the next one, "
+            "while each round only dispatches as many workgroups as fit onto the "
+            "device at once. Programs must be passed the queue's address, e.g. "
+            "via push constants."
+            "\n\nParameters\n----------\n"
+            "capacity: int\n"
+            "    Amount of items each half of the queue can hold\n")
+        .def("__init__",
+            [](hp::WorkQueue* q, uint32_t capacity) {
+                nb::gil_scoped_release release;
+                new (q) hp::WorkQueue(getCurrentContext(), capacity);
+            }, "capacity"_a)
+        .def_prop_ro("address", [](const hp::WorkQueue& q) { return q.getAddress(); },
+            "Device address of the queue")
+        .def_prop_ro("capacity", [](const hp::WorkQueue& q) { return q.getCapacity(); },
+            "Amount of items each half of the queue can hold")
+        .def_prop_ro("tensor", [](const hp::WorkQueue& q) -> const hp::Tensor<std::byte>& {
+                return q.getTensor();
+            }, nb::rv_policy::reference_internal,
+            "Tensor holding the queue. Starts with a 64 byte header holding the "
+            "indirect dispatch size, round, head, count of both halves, capacity, "
+            "overflow and processed items as 32 bit integers.")
+        .def("getOccupancy", &hp::WorkQueue::getOccupancy, "program"_a,
+            "Returns the amount of workgroups of the given program resident on "
+            "the device at once.")
+        .def("launch",
+            [](const hp::WorkQueue& q, const hp::Program& program, nb::bytes push,
+                uint32_t rounds, uint32_t maxGroups)
+            {
+                return q.launch(program,
+                    std::span<const std::byte>{
+                        reinterpret_cast<const std::byte*>(push.c_str()),
+                        push.size()
+                    }, rounds, maxGroups);
+            }, "program"_a, "push"_a = nb::bytes(), nb::kw_only(),
+            "rounds"_a = 16, "maxGroups"_a = 0,
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(),
+            "Creates a command running the given program until the queue drains. "
+            "Captures the program's bindings on creation."
+            "\n\nParameters\n----------\n"
+            "program: Program\n"
+            "    Program processing the items\n"
+            "push: bytes, default=b''\n"
+            "    Data pushed to each dispatch\n"
+            "rounds: int, default=16\n"
+            "    Maximum amount of rounds\n"
+            "maxGroups: int, default=0\n"
+            "    Maximum amount of workgroups per round. Zero uses the occupancy "
+            "of the program.\n")
+        .def("seed",
+            [](const hp::WorkQueue& q, uint32_t count, uint32_t first) {
+                return q.seed(count, first);
+            }, "count"_a, "first"_a = 0, nb::keep_alive<0, 1>(),
+            "Creates a command resetting the queue and filling it with a range of "
+            "consecutive items."
+            "\n\nParameters\n----------\n"
+            "count: int\n"
+            "    Amount of items\n"
+            "first: int, default=0\n"
+            "    Value of the first item\n")
+        .def("seed",
+            [](const hp::WorkQueue& q, const hp::Tensor<std::byte>& items, std::optional<uint32_t> count) {
+                return q.seed(items, count);
+            }, "items"_a, "count"_a.none() = nb::none(),
+            nb::keep_alive<0, 1>(), nb::keep_alive<0, 2>(),
+            "Creates a command resetting the queue and filling it with the items "
+            "stored in the given tensor."
+            "\n\nParameters\n----------\n"
+            "items: Tensor\n"
+            "    Tensor holding the items as 32 bit unsigned integers\n"
+            "count: int | None, default=None\n"
+            "    Amount of items. Uses the whole tensor if None.\n");
+}
@@ -188,7 +188,7 @@ AtomicsProperties getAtomicsProperties(const DeviceHandle& device) {
 }
 
 const AtomicsProperties& getEnabledAtomics(const ContextHandle& context) {
-    auto& ext = context->extensions;
+    auto& ext = *context->extensions;
     auto pExt = std::find_if(ext.begin(), ext.end(),
         [](const ExtensionHandle& h) -> bool {
             return h->getExtensionName() == ExtensionName;
@@ -1,8 +1,25 @@
 #include "hephaistos/buffer.hpp"
+#include "hephaistos/conditional.hpp"
+#include "hephaistos/raytracing.hpp"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+#include "vk/hazard.hpp"
 #include "vk/util.hpp"
 #include "vk/types.hpp"
 #include "vk/result.hpp"
@@ -28,10 +45,12 @@ const vulkan::Buffer& Buffer<std::byte>::getBuffer() const noexcept {
 Buffer<std::byte>::Buffer(Buffer<std::byte>&& other) noexcept
     : Resource(std::move(other))
     , buffer(std::move(other.buffer))
+    , memory(std::exchange(other.memory, {}))
 {}
 Buffer<std::byte>& Buffer<std::byte>::operator=(Buffer<std::byte>&& other) noexcept {
     Resource::operator=(std::move(other));
     buffer = std::move(other.buffer);
+    memory = std::exchange(other.memory, {});
     return *this;
 }
 
@@ -46,6 +65,7 @@ Buffer<std::byte>::Buffer(ContextHandle context, uint64_t size)
     memory = std::span<std::byte>(
         static_cast<std::byte*>(buffer->allocInfo.pMappedData),
         size);
+    trackResource("Buffer", size);
 }
 Buffer<std::byte>::Buffer(ContextHandle context, std::span<const std::byte> data)
     : Buffer<std::byte>(std::move(context), data.size())
@@ -54,18 +74,607 @@ Buffer<std::byte>::Buffer(ContextHandle context, std::span<const std::byte> data
     std::copy(data.begin(), data.end(), memory.begin());
 }
 
+Buffer<std::byte>::Buffer(
+    ContextHandle context, std::span<std::byte> memory, import_host_memory_t)
+    : Resource(std::move(context))
+    , buffer(vulkan::createEmptyBuffer())
+    , memory(memory)
+{
+    auto alignment = getHostMemoryImportAlignment(getContext());
+    if (alignment == 0)
+        throw std::runtime_error("Importing host memory is not supported!");
+    if (memory.empty() ||
+        reinterpret_cast<uintptr_t>(memory.data()) % alignment != 0 ||
+        memory.size_bytes() % alignment != 0)
+    {
+        throw std::logic_error(
+            "Address and size of imported host memory must be multiples of the import alignment!");
+    }
+
+    buffer = vulkan::createImportedBuffer(
+        getContext(), memory.data(), memory.size_bytes(),
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    trackResource("Buffer", memory.size_bytes());
+}
+
+Buffer<std::byte>::Buffer(
+    ContextHandle context, BufferHandle buffer, std::span<std::byte> memory)
+    : Resource(std::move(context))
+    , buffer(std::move(buffer))
+    , memory(memory)
+{
+    trackResource("Buffer", memory.size_bytes());
+}
+
+BufferHandle Buffer<std::byte>::exchangeBuffer(
+    BufferHandle buffer, std::span<std::byte> memory) noexcept
+{
+    std::swap(this->buffer, buffer);
+    this->memory = memory;
+    return buffer;
+}
+
 Buffer<std::byte>::~Buffer() = default;
 
+bool isHostMemoryImportSupported(const ContextHandle& context) {
+    return context->hostImportAlignment != 0;
+}
+uint64_t getHostMemoryImportAlignment(const ContextHandle& context) {
+    return context->hostImportAlignment;
+}
+
+/******************************** UPLOAD BUFFER *******************************/
+
+namespace {
+
+//copies using non-temporal stores, which write combined memory prefers
+void streamCopy(std::byte* dst, const std::byte* src, size_t size) {
+#if defined(__x86_64__) || defined(_M_X64)
+    //streaming stores need aligned destinations
+    auto head = std::min(size, static_cast<size_t>(
+        (16 - reinterpret_cast<uintptr_t>(dst) % 16) % 16));
+    std::memcpy(dst, src, head);
+    dst += head; src += head; size -= head;
+
+    auto blocks = size / 64;
+    for (size_t i = 0; i < blocks; ++i, dst += 64, src += 64) {
+        auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+        auto c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32));
+        auto d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst), a);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + 48), d);
+    }
+    //make streamed data visible before the copy gets submitted
+    _mm_sfence();
+    std::memcpy(dst, src, size % 64);
+#else
+    std::memcpy(dst, src, size);
+#endif
+}
+
+}
+
+bool UploadBuffer::isDeviceLocal() const {
+    auto& buffer = getBuffer();
+    VkMemoryPropertyFlags flags;
+    vmaGetAllocationMemoryProperties(getContext()->allocator, buffer.allocation, &flags);
+    return (flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) != 0;
+}
+
+void UploadBuffer::write(std::span<const std::byte> data, uint64_t offset) {
+    auto memory = getMemory();
+    if (offset > memory.size() || data.size() > memory.size() - offset)
+        throw std::logic_error("Written data is not contained within the buffer!");
+    streamCopy(memory.data() + offset, data.data(), data.size());
+}
+
+UploadBuffer::UploadBuffer(UploadBuffer&& other) noexcept = default;
+UploadBuffer& UploadBuffer::operator=(UploadBuffer&& other) noexcept = default;
+
+UploadBuffer::UploadBuffer(ContextHandle context, uint64_t size)
+    : Buffer<std::byte>(std::move(context), vulkan::createEmptyBuffer(), {})
+{
+    //prefers device local memory visible to the host, i.e. resizable BAR
+    auto buffer = vulkan::createBuffer(getContext(), size,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        VmaAllocationCreateInfo{
+            .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+                VMA_ALLOCATION_CREATE_MAPPED_BIT,
+            .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE
+        });
+    std::span<std::byte> memory{
+        static_cast<std::byte*>(buffer->allocInfo.pMappedData), size };
+    exchangeBuffer(std::move(buffer), memory);
+    trackResource("UploadBuffer", size);
+}
+UploadBuffer::UploadBuffer(ContextHandle context, std::span<const std::byte> data)
+    : UploadBuffer(std::move(context), data.size())
+{
+    write(data);
+}
+
+UploadBuffer::~UploadBuffer() = default;
+
+/****************************** MAPPED FILE BUFFER ****************************/
+
+namespace {
+
+constexpr VkBufferUsageFlags buffer_usage =
+    VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+}
+
+struct MappedFileBuffer::pImp {
+    void* view = nullptr;
+    uint64_t length = 0;
+
+    ~pImp() {
+        if (view)
+            vulkan::unmapFile(view, length);
+    }
+};
+
+bool MappedFileBuffer::isImported() const noexcept {
+    return _pImp && _pImp->view;
+}
+
+MappedFileBuffer::MappedFileBuffer(MappedFileBuffer&& other) noexcept = default;
+MappedFileBuffer& MappedFileBuffer::operator=(MappedFileBuffer&& other) noexcept {
+    //release the old buffer before unmapping the memory it imported
+    Buffer<std::byte>::operator=(std::move(other));
+    _pImp = std::move(other._pImp);
+    return *this;
+}
+
+MappedFileBuffer::MappedFileBuffer(ContextHandle context,
+    const std::filesystem::path& path,
+    uint64_t offset, uint64_t size)
+    : Buffer<std::byte>(std::move(context), vulkan::createEmptyBuffer(), {})
+    , _pImp(std::make_unique<pImp>())
+{
+    auto fileSize = static_cast<uint64_t>(std::filesystem::file_size(path));
+    if (offset > fileSize)
+        throw std::logic_error("Mapped region is not contained within the file!");
+    if (size == whole_size)
+        size = fileSize - offset;
+    if (size == 0)
+        throw std::logic_error("Mapped region must not be empty!");
+    if (offset + size > fileSize)
+        throw std::logic_error("Mapped region is not contained within the file!");
+
+    //import the mapped pages if possible
+    auto alignment = getHostMemoryImportAlignment(getContext());
+    if (alignment != 0) {
+        auto page = vulkan::getMappingGranularity();
+        auto granularity = std::max(alignment, page);
+        auto mapOffset = offset / granularity * granularity;
+        auto head = offset - mapOffset;
+        auto length = (head + size + alignment - 1) / alignment * alignment;
+        //pages past the end of the file can not be accessed
+        auto mappable = (fileSize + page - 1) / page * page;
+        void* view = nullptr;
+        if (mapOffset + length <= mappable)
+            view = vulkan::mapFile(path, mapOffset, length);
+
+        if (view) {
+            try {
+                auto buffer = vulkan::createImportedBuffer(
+                    getContext(), view, length, buffer_usage);
+                //region starts inside the first page
+                buffer->offset = head;
+                exchangeBuffer(std::move(buffer),
+                    { static_cast<std::byte*>(view) + head, size });
+                _pImp->view = view;
+                _pImp->length = length;
+                trackResource("Buffer", size);
+                return;
+            }
+            catch (const std::runtime_error&) {
+                //driver refused the mapping -> fall back to reading it
+                vulkan::unmapFile(view, length);
+            }
+        }
+    }
+
+    //read region into host memory instead
+    auto buffer = vulkan::createBuffer(getContext(), size, buffer_usage,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    std::span<std::byte> memory{
+        static_cast<std::byte*>(buffer->allocInfo.pMappedData), size };
+    std::ifstream file(path, std::ios::binary);
+    file.seekg(static_cast<std::streamoff>(offset));
+    file.read(reinterpret_cast<char*>(memory.data()), static_cast<std::streamsize>(size));
+    if (!file)
+        throw std::runtime_error("Failed to read the file!");
+    exchangeBuffer(std::move(buffer), memory);
+    trackResource("Buffer", size);
+}
+
+MappedFileBuffer::~MappedFileBuffer() {
+    //destroy the buffer before unmapping the memory it imported
+    exchangeBuffer(vulkan::createEmptyBuffer(), {});
+}
+
+/******************************** PINNED BUFFER *******************************/
+
+int32_t getDeviceNumaNode(const ContextHandle& context) {
+    return context->numaNode;
+}
+
+struct PinnedBuffer::pImp {
+    void* memory = nullptr;
+    uint64_t length = 0;
+    int32_t node = -1;
+    HugePages hugePages = HugePages::NONE;
+
+    ~pImp() {
+        if (memory)
+            vulkan::freePages(memory, length);
+    }
+};
+
+bool PinnedBuffer::isImported() const noexcept {
+    return _pImp && _pImp->memory;
+}
+int32_t PinnedBuffer::getNumaNode() const noexcept {
+    return _pImp ? _pImp->node : -1;
+}
+HugePages PinnedBuffer::getHugePages() const noexcept {
+    return _pImp ? _pImp->hugePages : HugePages::NONE;
+}
+
+PinnedBuffer::PinnedBuffer(PinnedBuffer&& other) noexcept = default;
+PinnedBuffer& PinnedBuffer::operator=(PinnedBuffer&& other) noexcept {
+    //release the old buffer before freeing the memory it imported
+    Buffer<std::byte>::operator=(std::move(other));
+    _pImp = std::move(other._pImp);
+    return *this;
+}
+
+PinnedBuffer::PinnedBuffer(ContextHandle context, uint64_t size,
+    const HostAllocationPolicy& policy)
+    : Buffer<std::byte>(std::move(context), vulkan::createEmptyBuffer(), {})
+    , _pImp(std::make_unique<pImp>())
+{
+    if (size == 0)
+        throw std::logic_error("Size of a pinned buffer must not be zero!");
+
+    auto alignment = getHostMemoryImportAlignment(getContext());
+    if (alignment != 0) {
+        auto huge = policy.hugePages != HugePages::NONE;
+        auto hugeSize = huge ? vulkan::getHugePageSize() : 0;
+        if (policy.hugePages == HugePages::EXPLICIT && hugeSize == 0)
+            throw std::runtime_error("Huge pages are not supported!");
+        auto page = std::max({ alignment, vulkan::getMappingGranularity(), hugeSize });
+        auto length = (size + page - 1) / page * page;
+
+        auto memory = vulkan::allocatePages(length,
+            policy.hugePages == HugePages::TRANSPARENT && hugeSize != 0,
+            policy.hugePages == HugePages::EXPLICIT);
+        if (!memory) {
+            if (policy.hugePages == HugePages::EXPLICIT)
+                throw std::runtime_error("Allocating huge pages failed!");
+            throw std::bad_alloc();
+        }
+        //pages are placed on first touch, i.e. when the driver pins them
+        auto node = getDeviceNumaNode(getContext());
+        if (!policy.localNumaNode || !vulkan::bindPagesToNode(memory, length, node))
+            node = -1;
+
+        try {
+            auto buffer = vulkan::createImportedBuffer(
+                getContext(), memory, length, buffer_usage);
+            exchangeBuffer(std::move(buffer), { static_cast<std::byte*>(memory), size });
+            _pImp->memory = memory;
+            _pImp->length = length;
+            _pImp->node = node;
+            _pImp->hugePages = hugeSize != 0 ? policy.hugePages : HugePages::NONE;
+            trackResource("Buffer", size);
+            return;
+        }
+        catch (const std::runtime_error&) {
+            //driver refused the memory -> fall back to a regular buffer
+            vulkan::freePages(memory, length);
+        }
+    }
+
+    auto buffer = vulkan::createBuffer(getContext(), size, buffer_usage,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    std::span<std::byte> memory{
+        static_cast<std::byte*>(buffer->allocInfo.pMappedData), size };
+    exchangeBuffer(std::move(buffer), memory);
+    trackResource("Buffer", size);
+}
+
+PinnedBuffer::~PinnedBuffer() {
+    //destroy the buffer before freeing the memory it imported
+    exchangeBuffer(vulkan::createEmptyBuffer(), {});
+}
+
 /********************************** TENSOR ************************************/
 
 struct Tensor<std::byte>::Parameter {
     uint64_t address;
     VkDescriptorBufferInfo buffer;
+
+    //lazy tensors allocate on first use with the settings given on creation
+    std::once_flag allocateOnce;
+    std::atomic<bool> allocated = true;
+    AllocationHints hints;
+    bool mapped = false;
+    //initial data kept until allocated
+    std::vector<std::byte> data;
+};
+
+namespace {
+
+//stages that might have accessed tensors before or after a transfer
+constexpr VkPipelineStageFlags2KHR TensorAccessStages =
+    VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR |
+    VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT_KHR;
+
+constexpr auto TRANSFER_OUT_OF_TENSOR =
+    "Transfer region is not contained within the tensor!";
+
+//copies a staged range into the tensor ordered with other tensor accesses
+void recordStagedUpdate(const vulkan::Context& context, const vulkan::Command& cmd,
+    const vulkan::StagingLease& staging, const vulkan::Buffer& buffer,
+    VkDeviceSize dstOffset, VkDeviceSize size)
+{
+    vulkan::pipelineBarrier(context, cmd, {
+        .srcStage = TensorAccessStages,
+        .srcAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+        .dstStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+        .dstAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+        .buffer = buffer.buffer,
+        .offset = dstOffset,
+        .size = size
+    });
+    VkBufferCopy region{
+        .srcOffset = staging.getOffset(),
+        .dstOffset = dstOffset,
+        .size = size
+    };
+    context.fnTable.vkCmdCopyBuffer(cmd.buffer,
+        staging.getBuffer(), buffer.buffer, 1, &region);
+    vulkan::pipelineBarrier(context, cmd, {
+        .srcStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+        .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+        .dstStage = TensorAccessStages,
+        .dstAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+        .buffer = buffer.buffer,
+        .offset = dstOffset,
+        .size = size
+    });
+}
+
+bool isHostVisible(const vulkan::Buffer& buffer) {
+    //sparse buffers have no single allocation and are never host visible
+    if (!buffer.allocation)
+        return false;
+    VkMemoryPropertyFlags flags;
+    vmaGetAllocationMemoryProperties(
+        buffer.context.allocator,
+        buffer.allocation,
+        &flags);
+    return (flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
+//writes directly into host visible memory, otherwise blocks until the data
+//was copied via the context's staging ring
+void uploadToBuffer(const ContextHandle& handle, const vulkan::Buffer& buffer,
+    std::span<const std::byte> src, uint64_t offset)
+{
+    vulkan::count(handle->counters.bytesUploaded, src.size_bytes());
+
+    if (isHostVisible(buffer)) {
+        vulkan::checkResult(vmaCopyMemoryToAllocation(
+            handle->allocator,
+            static_cast<const void*>(src.data()),
+            buffer.allocation,
+            buffer.offset + offset,
+            src.size_bytes()
+        ));
+        return;
+    }
+
+    //device local memory -> copy via the context's staging ring in chunks
+    auto& context = *handle;
+    while (!src.empty()) {
+        auto size = std::min<uint64_t>(src.size_bytes(), vulkan::StagingLease::MaxSize);
+        vulkan::StagingLease staging(handle, size);
+        std::copy_n(src.begin(), size, staging.getMemory().begin());
+        staging.flush();
+
+        vulkan::oneTimeSubmit(context, [&](VkCommandBuffer cmd) {
+            recordStagedUpdate(context, { .buffer = cmd }, staging, buffer, buffer.offset + offset, size);
+        });
+
+        src = src.subspan(size);
+        offset += size;
+    }
+}
+
+}
+
+void setTensorPoolThreshold(const ContextHandle& context, uint64_t threshold) {
+    std::lock_guard<std::mutex> lock(context->bufferPoolMutex);
+    context->bufferPoolThreshold = threshold;
+}
+uint64_t getTensorPoolThreshold(const ContextHandle& context) {
+    std::lock_guard<std::mutex> lock(context->bufferPoolMutex);
+    return context->bufferPoolThreshold;
+}
+void setTensorAutoMapping(const ContextHandle& context, bool enable) {
+    std::lock_guard<std::mutex> lock(context->bufferPoolMutex);
+    context->tensorAutoMapping = enable;
+}
+bool getTensorAutoMapping(const ContextHandle& context) {
+    std::lock_guard<std::mutex> lock(context->bufferPoolMutex);
+    return context->tensorAutoMapping;
+}
+void setTensorLazyAllocation(const ContextHandle& context, bool enable) {
+    std::lock_guard<std::mutex> lock(context->bufferPoolMutex);
+    context->tensorLazyAllocation = enable;
+}
+bool getTensorLazyAllocation(const ContextHandle& context) {
+    std::lock_guard<std::mutex> lock(context->bufferPoolMutex);
+    return context->tensorLazyAllocation;
+}
+
+namespace {
+
+uint64_t getAddress(const vulkan::Context& context, VkBuffer buffer) {
+    VkBufferDeviceAddressInfo addressInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+        .buffer = buffer
+    };
+    return context.fnTable.vkGetBufferDeviceAddress(context.device, &addressInfo);
+}
+
+//new location of a buffer during a defragmentation pass
+struct Relocation {
+    vulkan::Buffer* buffer;
+    VkBuffer newBuffer;
 };
 
-uint64_t Tensor<std::byte>::address() const noexcept {
+//Copies the buffers of a single pass to their new locations and swaps them
+//in. Moves of allocations not belonging to relocatable buffers are ignored.
+void relocate(const vulkan::Context& context, VmaDefragmentationPassMoveInfo& pass,
+    std::vector<Relocation>& relocations)
+{
+    for (auto i = 0u; i < pass.moveCount; ++i) {
+        auto& move = pass.pMoves[i];
+        VmaAllocationInfo info;
+        vmaGetAllocationInfo(context.allocator, move.srcAllocation, &info);
+        auto buffer = static_cast<vulkan::Buffer*>(info.pUserData);
+        if (!buffer || !buffer->relocated) {
+            move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+            continue;
+        }
+
+        //create buffer at new location
+        auto bufferInfo = vulkan::getBufferCreateInfo(context, buffer->size, buffer->usage);
+        VkBuffer newBuffer;
+        vulkan::checkResult(context.fnTable.vkCreateBuffer(
+            context.device, &bufferInfo, nullptr, &newBuffer));
+        relocations.push_back({ buffer, newBuffer });
+        vulkan::checkResult(vmaBindBufferMemory(
+            context.allocator, move.dstTmpAllocation, newBuffer));
+    }
+    if (relocations.empty())
+        return;
+
+    //copy everything in a single submission
+    vulkan::oneTimeSubmit(context, [&](VkCommandBuffer cmd) {
+        vulkan::GlobalBarrier before{
+            .srcStage = TensorAccessStages,
+            .srcAccess = VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+            .dstStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            .dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR
+        };
+        vulkan::pipelineBarrier(context, cmd, {}, { &before, 1 });
+        for (auto& r : relocations) {
+            VkBufferCopy region{ .size = r.buffer->size };
+            context.fnTable.vkCmdCopyBuffer(cmd, r.buffer->buffer, r.newBuffer, 1, &region);
+        }
+        vulkan::GlobalBarrier after{
+            .srcStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            .dstStage = TensorAccessStages,
+            .dstAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR
+        };
+        vulkan::pipelineBarrier(context, cmd, {}, { &after, 1 });
+    });
+}
+
+}
+
+DefragmentationResult defragmentTensors(
+    const ContextHandle& context, const RelocationCallback& callback)
+{
+    VmaDefragmentationInfo info{
+        .flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT
+    };
+    VmaDefragmentationContext defrag;
+    vulkan::checkResult(vmaBeginDefragmentation(context->allocator, &info, &defrag));
+
+    std::vector<Relocation> relocations;
+    struct Moved {
+        uint64_t oldAddress;
+        uint64_t newAddress;
+        uint64_t size;
+    };
+    std::vector<Moved> moved;
+    try {
+        while (true) {
+            VmaDefragmentationPassMoveInfo pass;
+            auto result = vmaBeginDefragmentationPass(context->allocator, defrag, &pass);
+            if (result == VK_SUCCESS)
+                break;
+            if (result != VK_INCOMPLETE)
+                vulkan::checkResult(result);
+
+            relocate(*context, pass, relocations);
+            //allocations got swapped -> old buffers point to freed memory
+            result = vmaEndDefragmentationPass(context->allocator, defrag, &pass);
+            moved.clear();
+            for (auto& r : relocations) {
+                auto& buffer = *r.buffer;
+                auto hasAddress = buffer.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+                if (hasAddress)
+                    moved.push_back({ getAddress(*context, buffer.buffer), 0, buffer.size });
+                context->fnTable.vkDestroyBuffer(context->device, buffer.buffer, nullptr);
+                buffer.buffer = r.newBuffer;
+                vmaGetAllocationInfo(context->allocator, buffer.allocation, &buffer.allocInfo);
+                buffer.relocated(buffer);
+                if (hasAddress)
+                    moved.back().newAddress = getAddress(*context, buffer.buffer);
+            }
+            relocations.clear();
+            //notify only after everything got swapped in case the callback throws
+            if (callback) {
+                for (auto& m : moved)
+                    callback(m.oldAddress, m.newAddress, m.size);
+            }
+            if (result == VK_SUCCESS)
+                break;
+            if (result != VK_INCOMPLETE)
+                vulkan::checkResult(result);
+        }
+    }
+    catch (...) {
+        //buffers not yet swapped in are still unused
+        for (auto& r : relocations)
+            context->fnTable.vkDestroyBuffer(context->device, r.newBuffer, nullptr);
+        vmaEndDefragmentation(context->allocator, defrag, nullptr);
+        throw;
+    }
+
+    VmaDefragmentationStats stats;
+    vmaEndDefragmentation(context->allocator, defrag, &stats);
+    return {
+        .bytesMoved = stats.bytesMoved,
+        .bytesFreed = stats.bytesFreed,
+        .tensorsMoved = stats.allocationsMoved,
+        .blocksFreed = stats.deviceMemoryBlocksFreed
+    };
+}
+
+uint64_t Tensor<std::byte>::address() const {
+    allocate();
     return parameter->address;
 }
+bool Tensor<std::byte>::isAllocated() const noexcept {
+    return parameter->allocated.load(std::memory_order_acquire);
+}
+bool Tensor<std::byte>::isPooled() const {
+    allocate();
+    return buffer->block != nullptr;
+}
 
 std::span<std::byte> Tensor<std::byte>::getMemory() const {
     if (!isMapped()) return {};
@@ -73,10 +682,14 @@ std::span<std::byte> Tensor<std::byte>::getMemory() const {
     return { static_cast<std::byte*>(buffer->allocInfo.pMappedData), _size };
 }
 
-bool Tensor<std::byte>::isMapped() const noexcept {
+bool Tensor<std::byte>::isMapped() const {
+    allocate();
     return buffer->allocInfo.pMappedData != nullptr;
 }
-bool Tensor<std::byte>::isNonCoherent() const noexcept {
+bool Tensor<std::byte>::isNonCoherent() const {
+    allocate();
+    if (!buffer->allocation)
+        return false;
     VkMemoryPropertyFlags flags;
     vmaGetAllocationMemoryProperties(
         getContext()->allocator,
@@ -84,36 +697,227 @@ bool Tensor<std::byte>::isNonCoherent() const noexcept {
         &flags);
     return (flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) == 0;
 }
+
 void Tensor<std::byte>::update(std::span<const std::byte> src, uint64_t offset) {
-    vulkan::checkResult(vmaCopyMemoryToAllocation(
-        getContext()->allocator,
-        static_cast<const void*>(src.data()),
-        buffer->allocation,
-        offset,
-        src.size_bytes()
-    ));
+    if (offset + src.size_bytes() > _size)
+        throw std::logic_error(TRANSFER_OUT_OF_TENSOR);
+    allocate();
+    uploadToBuffer(getContext(), *buffer, src, offset);
+}
+Submission Tensor<std::byte>::updateAsync(std::span<const std::byte> src, uint64_t offset) {
+    if (offset + src.size_bytes() > _size)
+        throw std::logic_error(TRANSFER_OUT_OF_TENSOR);
+    allocate();
+    //still hand out something to wait on
+    if (src.empty())
+        return executeAsync(getContext(), [](vulkan::Command&) {});
+    vulkan::count(getContext()->counters.bytesUploaded, src.size_bytes());
+
+    //always staged, so the copy is ordered with work still using the tensor
+    //each chunk gets its own submission, so the ring can recycle earlier
+    //ones while later chunks get staged
+    auto& context = *getContext();
+    std::optional<Submission> submission;
+    while (!src.empty()) {
+        auto size = std::min<uint64_t>(src.size_bytes(), vulkan::StagingLease::MaxSize);
+        auto staging = std::make_shared<vulkan::StagingLease>(getContext(), size);
+        std::copy_n(src.begin(), size, staging->getMemory().begin());
+        staging->flush();
+
+        submission = executeAsync(getContext(), [&](vulkan::Command& cmd) {
+            cmd.stage |= VK_PIPELINE_STAGE_2_COPY_BIT_KHR;
+            recordStagedUpdate(context, cmd, *staging, *buffer, buffer->offset + offset, size);
+        });
+        //staging range can be reused once the copy finished
+        submission->onFinished([staging]() {});
+
+        src = src.subspan(size);
+        offset += size;
+    }
+    //later submissions on the same queue only finish after earlier ones
+    return std::move(*submission);
+}
+
+void updateTensors(std::span<const TensorUpdate> updates) {
+    if (updates.empty())
+        return;
+    auto& handle = updates.front().tensor.get().getContext();
+    for (auto& update : updates) {
+        auto& tensor = update.tensor.get();
+        if (update.offset + update.data.size_bytes() > tensor.size_bytes())
+            throw std::logic_error(TRANSFER_OUT_OF_TENSOR);
+        if (tensor.getContext() != handle)
+            throw std::logic_error("All tensors of a batched update must belong to the same context!");
+    }
+
+    //host visible tensors can be written directly
+    struct Pending {
+        const vulkan::Buffer* buffer;
+        std::span<const std::byte> data;
+        uint64_t offset;
+    };
+    std::vector<Pending> pending;
+    uint64_t total = 0;
+    for (auto& update : updates) {
+        auto& tensor = update.tensor.get();
+        auto& buffer = tensor.getBuffer();
+        if (isHostVisible(buffer)) {
+            tensor.update(update.data, update.offset);
+        }
+        else if (!update.data.empty()) {
+            pending.push_back({ &buffer, update.data, buffer.offset + update.offset });
+            total += update.data.size_bytes();
+        }
+    }
+    if (pending.empty())
+        return;
+    auto& context = *handle;
+    vulkan::count(context.counters.bytesUploaded, total);
+
+    //pack as many updates as fit into a single lease and copy them at once;
+    //updates larger than the remaining space get split
+    std::vector<std::pair<VkBuffer, VkBufferCopy>> copies;
+    auto next = pending.begin();
+    while (next != pending.end()) {
+        auto size = std::min<uint64_t>(total, vulkan::StagingLease::MaxSize);
+        vulkan::StagingLease staging(handle, size);
+        auto memory = staging.getMemory();
+
+        copies.clear();
+        uint64_t used = 0;
+        while (used < size) {
+            auto chunk = std::min<uint64_t>(next->data.size_bytes(), size - used);
+            std::copy_n(next->data.begin(), chunk, memory.begin() + used);
+            copies.push_back({ next->buffer->buffer, VkBufferCopy{
+                .srcOffset = staging.getOffset() + used,
+                .dstOffset = next->offset,
+                .size = chunk
+            }});
+
+            used += chunk;
+            next->data = next->data.subspan(chunk);
+            next->offset += chunk;
+            if (next->data.empty())
+                ++next;
+        }
+        staging.flush();
+        total -= size;
+
+        vulkan::oneTimeSubmit(context, [&](VkCommandBuffer cmd) {
+            vulkan::GlobalBarrier before{
+                .srcStage = TensorAccessStages,
+                .srcAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+                .dstStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+                .dstAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR
+            };
+            vulkan::pipelineBarrier(context, cmd, {}, { &before, 1 });
+            for (auto& [buffer, region] : copies) {
+                context.fnTable.vkCmdCopyBuffer(cmd,
+                    staging.getBuffer(), buffer, 1, &region);
+            }
+            vulkan::GlobalBarrier after{
+                .srcStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+                .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+                .dstStage = TensorAccessStages,
+                .dstAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR
+            };
+            vulkan::pipelineBarrier(context, cmd, {}, { &after, 1 });
+        });
+    }
 }
+
 void Tensor<std::byte>::flush(uint64_t offset, uint64_t size) {
+    allocate();
+    //whole size would also include neighbours in a shared buffer
+    if (size == whole_size)
+        size = _size - offset;
     vulkan::checkResult(vmaFlushAllocation(
         getContext()->allocator,
         buffer->allocation,
-        offset, size
+        buffer->offset + offset, size
     ));
 }
 void Tensor<std::byte>::retrieve(std::span<std::byte> dst, uint64_t offset) {
-    vulkan::checkResult(vmaCopyAllocationToMemory(
-        getContext()->allocator,
-        buffer->allocation,
-        offset,
-        static_cast<void*>(dst.data()),
-        dst.size_bytes()
-    ));
+    if (offset + dst.size_bytes() > _size)
+        throw std::logic_error(TRANSFER_OUT_OF_TENSOR);
+    allocate();
+    vulkan::count(getContext()->counters.bytesDownloaded, dst.size_bytes());
+
+    if (isHostVisible(*buffer)) {
+        vulkan::checkResult(vmaCopyAllocationToMemory(
+            getContext()->allocator,
+            buffer->allocation,
+            buffer->offset + offset,
+            static_cast<void*>(dst.data()),
+            dst.size_bytes()
+        ));
+        return;
+    }
+
+    //device local memory -> copy via the context's staging ring in chunks
+    auto& context = *getContext();
+    while (!dst.empty()) {
+        auto size = std::min<uint64_t>(dst.size_bytes(), vulkan::StagingLease::MaxSize);
+        vulkan::StagingLease staging(getContext(), size);
+
+        auto srcOffset = buffer->offset + offset;
+        vulkan::oneTimeSubmit(context, [&](VkCommandBuffer cmd) {
+            vulkan::pipelineBarrier(context, cmd, {
+                .srcStage = TensorAccessStages,
+                .srcAccess = VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+                .dstStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+                .dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR,
+                .buffer = buffer->buffer,
+                .offset = srcOffset,
+                .size = size
+            });
+            VkBufferCopy region{
+                .srcOffset = srcOffset,
+                .dstOffset = staging.getOffset(),
+                .size = size
+            };
+            context.fnTable.vkCmdCopyBuffer(cmd,
+                buffer->buffer, staging.getBuffer(), 1, &region);
+            vulkan::pipelineBarrier(context, cmd, {
+                .srcStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+                .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+                .dstStage = VK_PIPELINE_STAGE_2_HOST_BIT_KHR,
+                .dstAccess = VK_ACCESS_2_HOST_READ_BIT_KHR,
+                .buffer = staging.getBuffer(),
+                .offset = staging.getOffset(),
+                .size = size
+            });
+        });
+
+        staging.invalidate();
+        auto memory = staging.getMemory();
+        std::copy(memory.begin(), memory.end(), dst.begin());
+
+        dst = dst.subspan(size);
+        offset += size;
+    }
+}
+Submission Tensor<std::byte>::retrieveAsync(const Buffer<std::byte>& dst, uint64_t offset) {
+    if (offset + dst.size_bytes() > _size)
+        throw std::logic_error(TRANSFER_OUT_OF_TENSOR);
+    if (dst.size_bytes() == 0)
+        return executeAsync(getContext(), [](vulkan::Command&) {});
+
+    //host buffers are device accessible -> no staging needed
+    return executeAsync(getContext(), RetrieveTensorCommand(*this, dst, {
+        .tensorOffset = offset,
+        .size = dst.size_bytes()
+    }));
 }
 void Tensor<std::byte>::invalidate(uint64_t offset, uint64_t size) {
+    allocate();
+    //whole size would also include neighbours in a shared buffer
+    if (size == whole_size)
+        size = _size - offset;
     vulkan::checkResult(vmaInvalidateAllocation(
         getContext()->allocator,
         buffer->allocation,
-        offset, size
+        buffer->offset + offset, size
     ));
 }
 
@@ -123,11 +927,13 @@ uint64_t Tensor<std::byte>::size_bytes() const noexcept {
 size_t Tensor<std::byte>::size() const noexcept {
     return static_cast<size_t>(_size);
 }
-const vulkan::Buffer& Tensor<std::byte>::getBuffer() const noexcept {
+const vulkan::Buffer& Tensor<std::byte>::getBuffer() const {
+    allocate();
     return *buffer;
 }
 
 void Tensor<std::byte>::bindParameter(VkWriteDescriptorSet& binding) const {
+    allocate();
     binding.pNext            = nullptr;
     binding.pImageInfo       = nullptr;
     binding.pTexelBufferView = nullptr;
@@ -155,37 +961,69 @@ constexpr VkBufferUsageFlags tensor_usage =
     VK_BUFFER_USAGE_TRANSFER_DST_BIT |
     VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
     VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+    VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT |
+    VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT |
     VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
     VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
 
+//predicates of conditional execution and geometry updates are read from
+//tensors, but the usages are only allowed if the extensions are enabled
+VkBufferUsageFlags getTensorUsage(const ContextHandle& context) {
+    auto usage = tensor_usage;
+    if (isConditionalExecutionEnabled(context))
+        usage |= VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT;
+    if (isRaytracingEnabled(context))
+        usage |= VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+    return usage;
+}
+
 constexpr VmaAllocationCreateFlags tensor_mapped_flags =
     VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
     VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT |
     VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
+bool isDefaultHints(const AllocationHints& hints) {
+    AllocationHints defaults{};
+    return hints.priority == defaults.priority &&
+        hints.placement == defaults.placement &&
+        hints.dedicated == defaults.dedicated;
+}
+
+BufferHandle createTensorBuffer(const ContextHandle& context,
+    uint64_t size, const AllocationHints& hints, bool mapped)
+{
+    auto usage = getTensorUsage(context);
+    //mapping is free if the device local memory is host visible anyway
+    if (context->unifiedMemory && getTensorAutoMapping(context))
+        mapped = true;
+    VmaAllocationCreateFlags flags = mapped ? tensor_mapped_flags : 0;
+    //pooled buffers share their memory and thus its placement
+    if (isDefaultHints(hints))
+        return vulkan::createPooledBuffer(context, size, usage, flags);
+    return vulkan::createBuffer(context, size, usage,
+        vulkan::getAllocationCreateInfo(*context, hints, flags, VMA_MEMORY_USAGE_AUTO));
+}
+
 }
 
 Tensor<std::byte>::Tensor(ContextHandle context, uint64_t size, bool mapped)
+    : Tensor<std::byte>(std::move(context), size, AllocationHints{}, mapped)
+{}
+Tensor<std::byte>::Tensor(ContextHandle context, uint64_t size,
+    const AllocationHints& hints, bool mapped)
     : Resource(std::move(context))
     , _size(size)
-    , buffer(vulkan::createBuffer(
-        getContext(), size,
-        tensor_usage,
-        mapped ? tensor_mapped_flags : 0))
+    , buffer(vulkan::createEmptyBuffer())
     , parameter(std::make_unique<Parameter>())
 {
-    parameter->buffer = VkDescriptorBufferInfo{
-        .buffer = buffer->buffer,
-        .offset = 0,
-        .range = VK_WHOLE_SIZE
-    };
+    parameter->allocated = false;
+    parameter->hints = hints;
+    parameter->mapped = mapped;
+    //lazy tensors get allocated on first use
+    if (!getTensorLazyAllocation(getContext()))
+        allocate();
 
-    VkBufferDeviceAddressInfo addressInfo{
-        .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
-        .buffer = buffer->buffer
-    };
-    parameter->address = getContext()->fnTable.vkGetBufferDeviceAddress(
-        getContext()->device, &addressInfo);
+    trackResource("Tensor", size);
 }
 Tensor<std::byte>::Tensor(const Buffer<std::byte>& source, bool mapped)
     : Tensor<std::byte>(source.getContext(), source.size_bytes(), mapped)
@@ -198,106 +1036,905 @@ Tensor<std::byte>::Tensor(const Buffer<std::byte>& source, bool mapped)
     });
 }
 Tensor<std::byte>::Tensor(ContextHandle context, std::span<const std::byte> data, bool mapped)
-    : Tensor<std::byte>(Buffer<std::byte>(std::move(context), data), mapped)
-{}
+    : Tensor<std::byte>(std::move(context), data.size_bytes(), AllocationHints{}, mapped)
+{
+    //lazy tensors upload once allocated
+    if (!isAllocated())
+        parameter->data.assign(data.begin(), data.end());
+    else if (!data.empty())
+        uploadToBuffer(getContext(), *buffer, data, 0);
+}
+Tensor<std::byte>::Tensor(ContextHandle context, BufferHandle handle, uint64_t size)
+    : Resource(std::move(context))
+    , _size(size)
+    , buffer(std::move(handle))
+    , parameter(std::make_unique<Parameter>())
+{
+    //range of a larger buffer -> bind by offset
+    parameter->buffer = VkDescriptorBufferInfo{
+        .buffer = buffer->buffer,
+        .offset = buffer->offset,
+        .range = size
+    };
+    parameter->address = getAddress(*getContext(), buffer->buffer) + buffer->offset;
+    trackResource("Tensor", size);
+}
 Tensor<std::byte>::~Tensor() = default;
 
-/*********************************** COMMANDS *************************************/
+void Tensor<std::byte>::allocate() const {
+    if (parameter->allocated.load(std::memory_order_acquire))
+        return;
 
-namespace {
+    //bindings on multiple threads may race for the first use
+    std::call_once(parameter->allocateOnce, [this]() {
+        auto& p = *parameter;
+        buffer = createTensorBuffer(getContext(), _size, p.hints, p.mapped);
 
-constexpr auto DIFFERENT_CONTEXT_ERROR_STR =
-    "Source and destination of a copy command must originate from the same context!";
-constexpr auto SIZE_MISMATCH_ERROR_STR =
-    "Source and destination copy region must have the same size!";
-constexpr auto COPY_REGION_OUT_OF_SOURCE =
-    "Copy region is not contained within the source!";
-constexpr auto COPY_REGION_OUT_OF_DESTINATION =
-    "Copy region is not contained within the destination!";
+        //pooled tensors are bound by offset
+        p.buffer = VkDescriptorBufferInfo{
+            .buffer = buffer->buffer,
+            .offset = buffer->offset,
+            .range = buffer->block ? _size : VK_WHOLE_SIZE
+        };
+        p.address = getAddress(*getContext(), buffer->buffer) + buffer->offset;
 
+        //dedicated tensors may be moved by defragmentation
+        //(parameter lives on the heap, thus stays valid after moving the tensor)
+        if (!buffer->block) {
+            buffer->relocated = [parameter = &p](const vulkan::Buffer& buffer) {
+                parameter->buffer.buffer = buffer.buffer;
+                parameter->address = getAddress(buffer.context, buffer.buffer);
+            };
+        }
+
+        if (!p.data.empty()) {
+            uploadToBuffer(getContext(), *buffer, p.data, 0);
+            p.data = {};
+        }
+        p.allocated.store(true, std::memory_order_release);
+    });
 }
 
-void RetrieveTensorCommand::record(vulkan::Command& cmd) const {
-    //alias for shorter code
-    auto& src = source.get();
-    auto& dst = destination.get();
-    //Check for src and dst to be from the same context
-    if (src.getContext().get() != dst.getContext().get())
-        throw std::logic_error(DIFFERENT_CONTEXT_ERROR_STR);
-    auto& context = src.getContext();
-    //check both have the same size
-    auto srcSize = (size == whole_size ? src.size_bytes() - sourceOffset : size);
-    auto dstSize = (size == whole_size ? dst.size_bytes() - destinationOffset : size);
-    if (srcSize != dstSize)
-        throw std::logic_error(SIZE_MISMATCH_ERROR_STR);
-    //shadow size with actual value
-    auto size = srcSize;
-    //boundary check
-    if (size + sourceOffset > src.size_bytes())
-        throw std::logic_error(COPY_REGION_OUT_OF_SOURCE);
-    if (size + destinationOffset > dst.size_bytes())
-        throw std::logic_error(COPY_REGION_OUT_OF_DESTINATION);
-
-    //we're acting on the transfer stage
-    cmd.stage |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+BufferHandle Tensor<std::byte>::exchangeBuffer(BufferHandle handle) {
+    std::swap(buffer, handle);
+    parameter->buffer.buffer = buffer->buffer;
+    parameter->buffer.offset = buffer->offset;
+    parameter->address = getAddress(*getContext(), buffer->buffer) + buffer->offset;
+    setSize(_size);
+    return handle;
+}
+void Tensor<std::byte>::setSize(uint64_t size) noexcept {
+    _size = size;
+    //empty ranges are not allowed -> bind the whole allocation instead
+    parameter->buffer.range = size > 0 ? size : buffer->size;
+}
 
-    //ensure writing to tensor is finished
-    if (!unsafe) {
-        std::array<VkBufferMemoryBarrier, 2> barriers{
-            VkBufferMemoryBarrier{
-                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-                .srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT,
-                .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
-                .buffer = src.getBuffer().buffer,
-                .offset = sourceOffset,
-                .size = size
-            },
-            VkBufferMemoryBarrier{
-                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-                .srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
-                .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
-                .buffer = dst.getBuffer().buffer,
-                .offset = destinationOffset,
-                .size = size
-            }
-        };
-        context->fnTable.vkCmdPipelineBarrier(cmd.buffer,
-            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_DEPENDENCY_BY_REGION_BIT,
-            0, nullptr,
-            static_cast<uint32_t>(barriers.size()), barriers.data(),
-            0, nullptr);
-    }
+/******************************** TENSOR VIEW *********************************/
 
-    //actually copy the buffer
-    VkBufferCopy copyRegion{
-        .srcOffset = sourceOffset,
-        .dstOffset = destinationOffset,
-        .size = size
+struct TensorView::Parameter {
+    uint64_t address;
+    VkDescriptorBufferInfo buffer;
+};
+
+uint64_t TensorView::address() const noexcept {
+    return parameter->address;
+}
+uint64_t TensorView::offset() const noexcept {
+    return _offset;
+}
+uint64_t TensorView::size_bytes() const noexcept {
+    return parameter->buffer.range;
+}
+const Tensor<std::byte>& TensorView::getTensor() const noexcept {
+    return tensor.get();
+}
+
+void TensorView::bindParameter(VkWriteDescriptorSet& binding) const {
+    binding.pNext            = nullptr;
+    binding.pImageInfo       = nullptr;
+    binding.pTexelBufferView = nullptr;
+    binding.pBufferInfo      = &parameter->buffer;
+}
+
+TensorView::TensorView(const TensorView& other)
+    : tensor(other.tensor)
+    , _offset(other._offset)
+    , parameter(std::make_unique<Parameter>(*other.parameter))
+{}
+TensorView& TensorView::operator=(const TensorView& other) {
+    tensor = other.tensor;
+    _offset = other._offset;
+    //keep own parameter, as programs may still reference it
+    *parameter = *other.parameter;
+    return *this;
+}
+
+TensorView::TensorView(TensorView&& other) noexcept = default;
+TensorView& TensorView::operator=(TensorView&& other) noexcept = default;
+
+TensorView::TensorView(const Tensor<std::byte>& tensor, uint64_t offset, uint64_t size)
+    : tensor(std::cref(tensor))
+    , _offset(offset)
+    , parameter(std::make_unique<Parameter>())
+{
+    if (offset > tensor.size_bytes())
+        throw std::logic_error("View is not contained within the tensor!");
+    if (size == whole_size)
+        size = tensor.size_bytes() - offset;
+    if (size == 0)
+        throw std::logic_error("Views must not be empty!");
+    if (offset + size > tensor.size_bytes())
+        throw std::logic_error("View is not contained within the tensor!");
+
+    auto& buffer = tensor.getBuffer();
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(buffer.context.physicalDevice, &props);
+    //tensors have aligned offsets, so just check the view's one
+    if (offset % props.limits.minStorageBufferOffsetAlignment != 0)
+        throw std::logic_error(
+            "Offset of views must be a multiple of minStorageBufferOffsetAlignment!");
+
+    parameter->buffer = VkDescriptorBufferInfo{
+        .buffer = buffer.buffer,
+        .offset = buffer.offset + offset,
+        .range = size
     };
-    context->fnTable.vkCmdCopyBuffer(cmd.buffer,
-        src.getBuffer().buffer,
-        dst.getBuffer().buffer,
-        1, &copyRegion);
+    parameter->address = tensor.address() + offset;
+}
+TensorView::~TensorView() = default;
 
-    //barrier to ensure transfer finished
-    if (!unsafe) {
-        VkBufferMemoryBarrier barrier{
-            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
-            .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
-            .buffer = dst.getBuffer().buffer,
-            .offset = destinationOffset,
+/****************************** SCRATCH ALLOCATOR *****************************/
+
+struct ScratchAllocator::pImp {
+    struct Declaration {
+        uint64_t size;
+        uint32_t firstStep;
+        uint32_t lastStep;
+        uint64_t offset;
+    };
+    std::vector<Declaration> declarations;
+    uint64_t declaredBytes = 0;
+
+    bool allocated = false;
+    //must outlive the tensors aliasing it
+    BufferHandle memory = vulkan::createEmptyBuffer();
+    std::vector<Tensor<std::byte>> tensors;
+};
+
+size_t ScratchAllocator::declare(uint64_t size, uint32_t firstStep, uint32_t lastStep) {
+    if (_pImp->allocated)
+        throw std::logic_error("Cannot declare scratch tensors after allocation!");
+    if (size == 0)
+        throw std::logic_error("Scratch tensors must not be empty!");
+    if (firstStep > lastStep)
+        throw std::logic_error("Lifetime of scratch tensor must not end before it starts!");
+
+    _pImp->declarations.push_back({ size, firstStep, lastStep, 0 });
+    _pImp->declaredBytes += size;
+    return _pImp->declarations.size() - 1;
+}
+
+void ScratchAllocator::allocate() {
+    if (_pImp->allocated)
+        throw std::logic_error("Scratch tensors were already allocated!");
+
+    auto& context = getContext();
+    auto& decls = _pImp->declarations;
+    auto alignment = vulkan::getBufferOffsetAlignment(*context);
+    auto align = [alignment](uint64_t value) {
+        return (value + alignment - 1) / alignment * alignment;
+    };
+
+    //place largest tensors first, each at the lowest offset not
+    //overlapping any already placed tensor alive at the same time
+    std::vector<size_t> order(decls.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+        [&decls](size_t a, size_t b) { return decls[a].size > decls[b].size; });
+    uint64_t total = 0;
+    std::vector<size_t> placed, conflicts;
+    for (auto i : order) {
+        auto& decl = decls[i];
+        conflicts.clear();
+        std::copy_if(placed.begin(), placed.end(), std::back_inserter(conflicts),
+            [&](size_t j) {
+                return decls[j].firstStep <= decl.lastStep && decl.firstStep <= decls[j].lastStep;
+            });
+        std::sort(conflicts.begin(), conflicts.end(),
+            [&decls](size_t a, size_t b) { return decls[a].offset < decls[b].offset; });
+
+        uint64_t offset = 0;
+        for (auto j : conflicts) {
+            if (offset + decl.size <= decls[j].offset)
+                break;
+            offset = std::max(offset, align(decls[j].offset + decls[j].size));
+        }
+        decl.offset = offset;
+        total = std::max(total, offset + decl.size);
+        placed.push_back(i);
+    }
+
+    //create shared memory and let the tensors alias it
+    if (total > 0) {
+        auto usage = getTensorUsage(context);
+        _pImp->memory = vulkan::createBuffer(context, total, usage, 0);
+        auto& memory = *_pImp->memory;
+        _pImp->tensors.reserve(decls.size());
+        for (auto& decl : decls) {
+            //the shared buffer is owned by the allocator
+            BufferHandle handle{ new vulkan::Buffer({
+                memory.buffer, memory.allocation, memory.allocInfo,
+                decl.offset, nullptr, nullptr, decl.size, usage, {}, false, *context
+            }), [](vulkan::Buffer* buffer) { delete buffer; } };
+            handle->allocInfo.size = decl.size;
+            if (memory.allocInfo.pMappedData) {
+                handle->allocInfo.pMappedData =
+                    static_cast<std::byte*>(memory.allocInfo.pMappedData) + decl.offset;
+            }
+            _pImp->tensors.emplace_back(context, std::move(handle), decl.size);
+        }
+    }
+    _pImp->allocated = true;
+}
+
+bool ScratchAllocator::isAllocated() const noexcept {
+    return _pImp->allocated;
+}
+
+Tensor<std::byte>& ScratchAllocator::get(size_t id) const {
+    if (!_pImp->allocated)
+        throw std::logic_error("Scratch tensors are only available after allocation!");
+    if (id >= _pImp->tensors.size())
+        throw std::out_of_range("There is no scratch tensor with the given id!");
+    return _pImp->tensors[id];
+}
+
+size_t ScratchAllocator::size() const noexcept {
+    return _pImp->declarations.size();
+}
+uint64_t ScratchAllocator::size_bytes() const noexcept {
+    return _pImp->memory ? _pImp->memory->size : 0;
+}
+uint64_t ScratchAllocator::declared_bytes() const noexcept {
+    return _pImp->declaredBytes;
+}
+
+ScratchAllocator::ScratchAllocator(ScratchAllocator&& other) noexcept = default;
+ScratchAllocator& ScratchAllocator::operator=(ScratchAllocator&& other) noexcept = default;
+
+ScratchAllocator::ScratchAllocator(ContextHandle context)
+    : Resource(std::move(context))
+    , _pImp(std::make_unique<pImp>())
+{}
+ScratchAllocator::~ScratchAllocator() = default;
+
+/******************************** UNIFORM RING ********************************/
+
+struct UniformRing::pImp {
+    BufferHandle memory = vulkan::createEmptyBuffer();
+    uint64_t blockSize;
+    //distance between blocks satisfying the offset alignment
+    uint64_t stride;
+    uint32_t current;
+    //one per block, so bound programs keep referencing their block
+    std::vector<VkDescriptorBufferInfo> blocks;
+};
+
+uint32_t UniformRing::push(std::span<const std::byte> data) {
+    if (data.size_bytes() > _pImp->blockSize)
+        throw std::logic_error("Data exceeds the block size of the uniform ring!");
+
+    auto next = (_pImp->current + 1) % capacity();
+    auto& memory = *_pImp->memory;
+    auto offset = next * _pImp->stride;
+    std::memcpy(
+        static_cast<std::byte*>(memory.allocInfo.pMappedData) + offset,
+        data.data(), data.size_bytes());
+    //no-op on coherent memory
+    vulkan::checkResult(vmaFlushAllocation(getContext()->allocator,
+        memory.allocation, memory.offset + offset, data.size_bytes()));
+
+    _pImp->current = next;
+    return next;
+}
+
+uint32_t UniformRing::current() const noexcept {
+    return _pImp->current;
+}
+uint32_t UniformRing::capacity() const noexcept {
+    return static_cast<uint32_t>(_pImp->blocks.size());
+}
+uint64_t UniformRing::blockSize() const noexcept {
+    return _pImp->blockSize;
+}
+uint64_t UniformRing::size_bytes() const noexcept {
+    return _pImp->memory->size;
+}
+
+void UniformRing::bindParameter(VkWriteDescriptorSet& binding) const {
+    binding.pNext            = nullptr;
+    binding.pImageInfo       = nullptr;
+    binding.pTexelBufferView = nullptr;
+    binding.pBufferInfo      = &_pImp->blocks[_pImp->current];
+}
+
+UniformRing::UniformRing(UniformRing&& other) noexcept = default;
+UniformRing& UniformRing::operator=(UniformRing&& other) noexcept = default;
+
+UniformRing::UniformRing(ContextHandle context, uint64_t blockSize, uint32_t capacity)
+    : Resource(std::move(context))
+    , _pImp(std::make_unique<pImp>())
+{
+    if (blockSize == 0 || capacity == 0)
+        throw std::logic_error("Block size and capacity of uniform rings must not be zero!");
+    auto& con = getContext();
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(con->physicalDevice, &props);
+    if (blockSize > props.limits.maxUniformBufferRange)
+        throw std::logic_error("Block size exceeds the device's maxUniformBufferRange!");
+
+    auto alignment = vulkan::getBufferOffsetAlignment(*con);
+    _pImp->blockSize = blockSize;
+    _pImp->stride = (blockSize + alignment - 1) / alignment * alignment;
+    _pImp->memory = vulkan::createBuffer(con,
+        _pImp->stride * capacity,
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+    //first push writes the first block
+    _pImp->current = capacity - 1;
+    _pImp->blocks.resize(capacity);
+    auto& memory = *_pImp->memory;
+    for (auto i = 0u; i < capacity; ++i) {
+        _pImp->blocks[i] = VkDescriptorBufferInfo{
+            .buffer = memory.buffer,
+            .offset = memory.offset + i * _pImp->stride,
+            .range = blockSize
+        };
+    }
+}
+UniformRing::~UniformRing() = default;
+
+/******************************* ARGUMENT BLOCK *******************************/
+
+struct ArgumentBlock::pImp {
+    UniformRing ring;
+    std::vector<std::byte> data;
+    std::vector<std::reference_wrapper<const Tensor<std::byte>>> tensors;
+};
+
+ArgumentBlock& ArgumentBlock::add(const Tensor<std::byte>& tensor) {
+    auto address = tensor.address();
+    addBytes(std::as_bytes(std::span<const uint64_t>(&address, 1)), 8);
+    _pImp->tensors.push_back(tensor);
+    return *this;
+}
+ArgumentBlock& ArgumentBlock::add(const TensorView& view) {
+    auto address = view.address();
+    addBytes(std::as_bytes(std::span<const uint64_t>(&address, 1)), 8);
+    _pImp->tensors.push_back(view.getTensor());
+    return *this;
+}
+ArgumentBlock& ArgumentBlock::addBytes(std::span<const std::byte> data, uint64_t alignment) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+        throw std::logic_error("Alignment must be a power of two!");
+    auto& block = _pImp->data;
+    auto offset = (block.size() + alignment - 1) & ~(alignment - 1);
+    if (offset + data.size_bytes() > _pImp->ring.blockSize())
+        throw std::logic_error("Arguments exceed the block size of the argument block!");
+
+    block.resize(offset, std::byte{ 0 });
+    block.insert(block.end(), data.begin(), data.end());
+    return *this;
+}
+
+std::span<const std::byte> ArgumentBlock::data() const noexcept {
+    return _pImp->data;
+}
+uint64_t ArgumentBlock::size_bytes() const noexcept {
+    return _pImp->data.size();
+}
+std::span<const std::reference_wrapper<const Tensor<std::byte>>>
+ArgumentBlock::getTensors() const noexcept {
+    return _pImp->tensors;
+}
+const UniformRing& ArgumentBlock::getRing() const noexcept {
+    return _pImp->ring;
+}
+
+uint32_t ArgumentBlock::commit() {
+    return _pImp->ring.push(_pImp->data);
+}
+void ArgumentBlock::clear() noexcept {
+    _pImp->data.clear();
+    _pImp->tensors.clear();
+}
+
+void ArgumentBlock::bindParameter(VkWriteDescriptorSet& binding) const {
+    _pImp->ring.bindParameter(binding);
+}
+
+ArgumentBlock::ArgumentBlock(ArgumentBlock&& other) noexcept = default;
+ArgumentBlock& ArgumentBlock::operator=(ArgumentBlock&& other) noexcept = default;
+
+ArgumentBlock::ArgumentBlock(ContextHandle context, uint64_t blockSize, uint32_t capacity)
+    : _pImp(std::make_unique<pImp>(UniformRing(std::move(context), blockSize, capacity)))
+{}
+ArgumentBlock::~ArgumentBlock() = default;
+
+/******************************* SPARSE TENSOR ********************************/
+
+bool isSparseTensorSupported(const ContextHandle& context) {
+    return context->sparseBinding;
+}
+bool isSparseResidencySupported(const ContextHandle& context) {
+    return context->sparseResidency;
+}
+
+struct SparseTensor::pImp {
+    VkDeviceSize pageSize;
+    uint32_t memoryTypeBits;
+    //memory backing each page; null if not committed
+    std::vector<VmaAllocation> pages;
+    size_t committed = 0;
+};
+
+namespace {
+
+constexpr auto RANGE_OUT_OF_TENSOR =
+    "Range is not contained within the tensor!";
+
+BufferHandle createSparseBuffer(const ContextHandle& context, uint64_t size) {
+    if (!context->sparseBinding)
+        throw std::runtime_error("Sparse tensors are not supported by the device!");
+
+    auto usage = getTensorUsage(context);
+    auto info = vulkan::getBufferCreateInfo(*context, size, usage);
+    info.flags = VK_BUFFER_CREATE_SPARSE_BINDING_BIT;
+    if (context->sparseResidency)
+        info.flags |= VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT;
+
+    //memory is bound page wise by the sparse tensor
+    BufferHandle buffer{
+        new vulkan::Buffer({0,0,{},0,nullptr,nullptr,size,usage,{},false,*context}),
+        vulkan::destroyBuffer
+    };
+    vulkan::checkResult(context->fnTable.vkCreateBuffer(
+        context->device, &info, nullptr, &buffer->buffer));
+    return buffer;
+}
+
+//binding sparse memory is a queue operation -> wait for it on the host
+void bindSparse(const vulkan::Context& context, VkBuffer buffer,
+    std::span<const VkSparseMemoryBind> binds)
+{
+    VkSparseBufferMemoryBindInfo bufferBind{
+        .buffer = buffer,
+        .bindCount = static_cast<uint32_t>(binds.size()),
+        .pBinds = binds.data()
+    };
+    vulkan::bindSparseSync(context, {
+        .sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO,
+        .bufferBindCount = 1,
+        .pBufferBinds = &bufferBind
+    });
+}
+
+}
+
+uint64_t SparseTensor::getPageSize() const noexcept {
+    return _pImp->pageSize;
+}
+uint64_t SparseTensor::size_committed() const noexcept {
+    return _pImp->committed * _pImp->pageSize;
+}
+
+bool SparseTensor::isCommitted(uint64_t offset, uint64_t size) const {
+    if (size == whole_size)
+        size = size_bytes() - offset;
+    if (offset + size > size_bytes())
+        throw std::logic_error(RANGE_OUT_OF_TENSOR);
+    if (size == 0)
+        return true;
+
+    auto first = _pImp->pages.begin() + offset / _pImp->pageSize;
+    auto last = _pImp->pages.begin() + (offset + size - 1) / _pImp->pageSize + 1;
+    return std::none_of(first, last,
+        [](VmaAllocation page) { return page == nullptr; });
+}
+
+void SparseTensor::commit(uint64_t offset, uint64_t size) {
+    if (size == whole_size)
+        size = size_bytes() - offset;
+    if (offset + size > size_bytes())
+        throw std::logic_error(RANGE_OUT_OF_TENSOR);
+    if (size == 0)
+        return;
+
+    //collect missing pages overlapping the range
+    auto pageSize = _pImp->pageSize;
+    std::vector<size_t> missing;
+    for (auto i = offset / pageSize; i <= (offset + size - 1) / pageSize; ++i) {
+        if (!_pImp->pages[i])
+            missing.push_back(i);
+    }
+    if (missing.empty())
+        return;
+
+    //allocate memory
+    auto& context = *getContext();
+    VkMemoryRequirements requirements{
+        .size = pageSize,
+        .alignment = pageSize,
+        .memoryTypeBits = _pImp->memoryTypeBits
+    };
+    VmaAllocationCreateInfo allocInfo{
+        .preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+    };
+    std::vector<VmaAllocation> allocations(missing.size());
+    std::vector<VmaAllocationInfo> infos(missing.size());
+    vulkan::checkResult(vmaAllocateMemoryPages(
+        context.allocator, &requirements, &allocInfo,
+        missing.size(), allocations.data(), infos.data()));
+
+    //bind it
+    std::vector<VkSparseMemoryBind> binds(missing.size());
+    for (size_t i = 0; i < missing.size(); ++i) {
+        binds[i] = VkSparseMemoryBind{
+            .resourceOffset = missing[i] * pageSize,
+            .size = pageSize,
+            .memory = infos[i].deviceMemory,
+            .memoryOffset = infos[i].offset
+        };
+    }
+    try {
+        bindSparse(context, getBuffer().buffer, binds);
+    }
+    catch (...) {
+        vmaFreeMemoryPages(context.allocator, allocations.size(), allocations.data());
+        throw;
+    }
+
+    for (size_t i = 0; i < missing.size(); ++i)
+        _pImp->pages[missing[i]] = allocations[i];
+    _pImp->committed += missing.size();
+}
+
+void SparseTensor::decommit(uint64_t offset, uint64_t size) {
+    if (size == whole_size)
+        size = size_bytes() - offset;
+    if (offset + size > size_bytes())
+        throw std::logic_error(RANGE_OUT_OF_TENSOR);
+
+    //collect committed pages contained in the range
+    //the last page may extend past the end of the tensor
+    auto pageSize = _pImp->pageSize;
+    auto first = (offset + pageSize - 1) / pageSize;
+    auto last = offset + size == size_bytes() ?
+        _pImp->pages.size() : (offset + size) / pageSize;
+    std::vector<size_t> released;
+    for (auto i = first; i < last; ++i) {
+        if (_pImp->pages[i])
+            released.push_back(i);
+    }
+    if (released.empty())
+        return;
+
+    //unbind memory
+    auto& context = *getContext();
+    std::vector<VkSparseMemoryBind> binds(released.size());
+    std::vector<VmaAllocation> allocations(released.size());
+    for (size_t i = 0; i < released.size(); ++i) {
+        binds[i] = VkSparseMemoryBind{
+            .resourceOffset = released[i] * pageSize,
+            .size = pageSize
+        };
+        allocations[i] = std::exchange(_pImp->pages[released[i]], nullptr);
+    }
+    _pImp->committed -= released.size();
+    bindSparse(context, getBuffer().buffer, binds);
+
+    vmaFreeMemoryPages(context.allocator, allocations.size(), allocations.data());
+}
+
+SparseTensor::SparseTensor(SparseTensor&& other) noexcept = default;
+SparseTensor& SparseTensor::operator=(SparseTensor&& other) noexcept = default;
+
+SparseTensor::SparseTensor(ContextHandle context, uint64_t size)
+    : Tensor<std::byte>(context, createSparseBuffer(context, size), size)
+    , _pImp(std::make_unique<pImp>())
+{
+    //the alignment is the size of a sparse block
+    VkMemoryRequirements requirements;
+    getContext()->fnTable.vkGetBufferMemoryRequirements(
+        getContext()->device, getBuffer().buffer, &requirements);
+    _pImp->pageSize = requirements.alignment;
+    _pImp->memoryTypeBits = requirements.memoryTypeBits;
+    _pImp->pages.resize(requirements.size / requirements.alignment, nullptr);
+}
+SparseTensor::~SparseTensor() {
+    //moved from tensors have no pages
+    if (!_pImp)
+        return;
+
+    std::vector<VmaAllocation> allocations;
+    std::copy_if(_pImp->pages.begin(), _pImp->pages.end(), std::back_inserter(allocations),
+        [](VmaAllocation page) { return page != nullptr; });
+    //buffer gets destroyed afterwards and cannot be used in between
+    vmaFreeMemoryPages(getContext()->allocator, allocations.size(), allocations.data());
+}
+
+/****************************** GROWABLE TENSOR *******************************/
+
+struct GrowableTensor::pImp {
+    Tensor<std::byte> slot;
+};
+
+namespace {
+
+//avoid creating empty buffers
+constexpr uint64_t MinGrowableCapacity = 256;
+
+}
+
+uint64_t GrowableTensor::capacity() const noexcept {
+    return getBuffer().size;
+}
+const Tensor<std::byte>& GrowableTensor::getAddressSlot() const noexcept {
+    return _pImp->slot;
+}
+
+void GrowableTensor::reserve(uint64_t capacity) {
+    if (capacity <= this->capacity())
+        return;
+    capacity = std::max(capacity, 2 * this->capacity());
+
+    //copy content on the device and update the address slot in one go
+    auto& context = *getContext();
+    auto newBuffer = vulkan::createPooledBuffer(
+        getContext(), capacity, getTensorUsage(getContext()), 0);
+    auto& oldBuffer = getBuffer();
+    auto& slot = _pImp->slot.getBuffer();
+    auto newAddress = getAddress(context, newBuffer->buffer) + newBuffer->offset;
+    vulkan::oneTimeSubmit(context, [&](VkCommandBuffer cmd) {
+        vulkan::GlobalBarrier before{
+            .srcStage = TensorAccessStages,
+            .srcAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+            .dstStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT_KHR,
+            .dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR
+        };
+        vulkan::pipelineBarrier(context, cmd, {}, { &before, 1 });
+        if (size_bytes() > 0) {
+            VkBufferCopy region{
+                .srcOffset = oldBuffer.offset,
+                .dstOffset = newBuffer->offset,
+                .size = size_bytes()
+            };
+            context.fnTable.vkCmdCopyBuffer(cmd,
+                oldBuffer.buffer, newBuffer->buffer, 1, &region);
+        }
+        context.fnTable.vkCmdUpdateBuffer(cmd,
+            slot.buffer, slot.offset, sizeof(uint64_t), &newAddress);
+        vulkan::GlobalBarrier after{
+            .srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT_KHR,
+            .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            .dstStage = TensorAccessStages,
+            .dstAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR
+        };
+        vulkan::pipelineBarrier(context, cmd, {}, { &after, 1 });
+    });
+
+    //the fence waited on also covered all earlier work on the main queue
+    // -> old buffer can be released right away
+    exchangeBuffer(std::move(newBuffer));
+    trackResource("Tensor", this->capacity());
+}
+
+void GrowableTensor::resize(uint64_t size) {
+    reserve(size);
+    setSize(size);
+}
+
+GrowableTensor::GrowableTensor(GrowableTensor&& other) noexcept = default;
+GrowableTensor& GrowableTensor::operator=(GrowableTensor&& other) noexcept = default;
+
+GrowableTensor::GrowableTensor(ContextHandle context, uint64_t size, uint64_t capacity)
+    : Tensor<std::byte>(context, vulkan::createPooledBuffer(
+        context, std::max({ size, capacity, MinGrowableCapacity }),
+        getTensorUsage(context), 0), size)
+    , _pImp(new pImp{ Tensor<std::byte>(context, sizeof(uint64_t)) })
+{
+    setSize(size);
+    auto address = this->address();
+    _pImp->slot.update({ reinterpret_cast<const std::byte*>(&address), sizeof(uint64_t) });
+    trackResource("Tensor", this->capacity());
+}
+GrowableTensor::~GrowableTensor() = default;
+
+/*********************************** COMMANDS *************************************/
+
+namespace {
+
+constexpr auto DIFFERENT_CONTEXT_ERROR_STR =
+    "Source and destination of a copy command must originate from the same context!";
+constexpr auto SIZE_MISMATCH_ERROR_STR =
+    "Source and destination copy region must have the same size!";
+constexpr auto COPY_REGION_OUT_OF_SOURCE =
+    "Copy region is not contained within the source!";
+constexpr auto COPY_REGION_OUT_OF_DESTINATION =
+    "Copy region is not contained within the destination!";
+
+//copy regions resolved against a pair of buffers
+struct ResolvedCopy {
+    std::vector<VkBufferCopy> regions;
+    //ranges spanning all regions, used for barriers
+    VkDeviceSize srcBegin, srcEnd;
+    VkDeviceSize dstBegin, dstEnd;
+    //total amount of bytes copied
+    VkDeviceSize bytes;
+};
+
+//source and destination offset of a region
+std::pair<uint64_t, uint64_t> getOffsets(const CopyRegion& region, bool fromTensor) {
+    if (fromTensor)
+        return { region.tensorOffset, region.bufferOffset };
+    else
+        return { region.bufferOffset, region.tensorOffset };
+}
+std::pair<uint64_t, uint64_t> getOffsets(const TensorCopyRegion& region, bool) {
+    return { region.sourceOffset, region.destinationOffset };
+}
+
+//resolves whole sizes, checks boundaries and merges adjacent regions
+//offsets of the resolved regions include the ones of the buffers
+template<class Region>
+ResolvedCopy resolveCopy(std::span<const Region> regions, bool fromTensor,
+    const vulkan::Buffer& src, uint64_t srcSize,
+    const vulkan::Buffer& dst, uint64_t dstSize)
+{
+    ResolvedCopy result{};
+    result.regions.reserve(regions.size());
+    for (auto& region : regions) {
+        auto [srcOffset, dstOffset] = getOffsets(region, fromTensor);
+        //check both have the same size
+        auto srcRemaining = (region.size == whole_size ? srcSize - srcOffset : region.size);
+        auto dstRemaining = (region.size == whole_size ? dstSize - dstOffset : region.size);
+        if (srcRemaining != dstRemaining)
+            throw std::logic_error(SIZE_MISMATCH_ERROR_STR);
+        auto size = srcRemaining;
+        //boundary check
+        if (size + srcOffset > srcSize)
+            throw std::logic_error(COPY_REGION_OUT_OF_SOURCE);
+        if (size + dstOffset > dstSize)
+            throw std::logic_error(COPY_REGION_OUT_OF_DESTINATION);
+        //empty copies are not allowed
+        if (size == 0)
+            continue;
+
+        //tensors might be sub-allocated from a shared buffer
+        result.bytes += size;
+        result.regions.push_back(VkBufferCopy{
+            .srcOffset = srcOffset + src.offset,
+            .dstOffset = dstOffset + dst.offset,
             .size = size
+        });
+    }
+    if (result.regions.empty())
+        return result;
+
+    //merge regions adjacent in both source and destination
+    auto& copies = result.regions;
+    std::sort(copies.begin(), copies.end(),
+        [](const VkBufferCopy& a, const VkBufferCopy& b) { return a.srcOffset < b.srcOffset; });
+    auto merged = copies.begin();
+    for (auto it = std::next(merged); it != copies.end(); ++it) {
+        if (it->srcOffset == merged->srcOffset + merged->size &&
+            it->dstOffset == merged->dstOffset + merged->size)
+        {
+            merged->size += it->size;
+        }
+        else {
+            *(++merged) = *it;
+        }
+    }
+    copies.erase(std::next(merged), copies.end());
+
+    result.srcBegin = copies.front().srcOffset;
+    result.srcEnd = copies.back().srcOffset + copies.back().size;
+    result.dstBegin = copies.front().dstOffset;
+    result.dstEnd = copies.front().dstOffset + copies.front().size;
+    for (auto& copy : copies) {
+        result.dstBegin = std::min(result.dstBegin, copy.dstOffset);
+        result.dstEnd = std::max(result.dstEnd, copy.dstOffset + copy.size);
+    }
+
+    return result;
+}
+
+}
+
+void RetrieveTensorCommand::record(vulkan::Command& cmd) const {
+    //alias for shorter code
+    auto& src = source.get();
+    auto& dst = destination.get();
+    //Check for src and dst to be from the same context
+    if (!vulkan::isSameDevice(src.getContext().get(), dst.getContext().get()))
+        throw std::logic_error(DIFFERENT_CONTEXT_ERROR_STR);
+    auto& context = src.getContext();
+    auto copy = resolveCopy<CopyRegion>(regions, true,
+        src.getBuffer(), src.size_bytes(), dst.getBuffer(), dst.size_bytes());
+    if (copy.regions.empty())
+        return;
+    vulkan::count(context->counters.bytesDownloaded, copy.bytes);
+    auto srcBuffer = src.getBuffer().buffer;
+    auto dstBuffer = dst.getBuffer().buffer;
+
+    //we're acting on the copy stage
+    cmd.stage |= VK_PIPELINE_STAGE_2_COPY_BIT_KHR;
+
+    //ensure writing to tensor is finished
+    if (cmd.tracker) {
+        //let the tracker decide which barriers are actually needed
+        for (auto& region : copy.regions) {
+            cmd.tracker->buffer(srcBuffer, region.srcOffset, region.size,
+                VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+            cmd.tracker->buffer(dstBuffer, region.dstOffset, region.size,
+                VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+        }
+        if (unsafe)
+            cmd.tracker->commit();
+        else
+            cmd.tracker->barrier(*context, cmd);
+    }
+    else if (!unsafe) {
+        std::array<vulkan::BufferBarrier, 2> barriers{
+            vulkan::BufferBarrier{
+                .srcStage = TensorAccessStages,
+                .srcAccess = VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+                .dstStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+                .dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR,
+                .buffer = srcBuffer,
+                .offset = copy.srcBegin,
+                .size = copy.srcEnd - copy.srcBegin
+            },
+            vulkan::BufferBarrier{
+                .srcStage = VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT_KHR,
+                .srcAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+                .dstStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+                .dstAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+                .buffer = dstBuffer,
+                .offset = copy.dstBegin,
+                .size = copy.dstEnd - copy.dstBegin
+            }
         };
-        context->fnTable.vkCmdPipelineBarrier(cmd.buffer,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_PIPELINE_STAGE_HOST_BIT,
-            VK_DEPENDENCY_BY_REGION_BIT,
-            0, nullptr,
-            1, &barrier,
-            0, nullptr);
+        vulkan::pipelineBarrier(*context, cmd, barriers);
+    }
+
+    //actually copy the buffer
+    context->fnTable.vkCmdCopyBuffer(cmd.buffer, srcBuffer, dstBuffer,
+        static_cast<uint32_t>(copy.regions.size()), copy.regions.data());
+
+    //barrier to ensure transfer finished
+    if (cmd.tracker) {
+        //merged with others at the end of the command buffer
+        if (!unsafe) {
+            for (auto& region : copy.regions) {
+                cmd.tracker->hostRead(dstBuffer, region.dstOffset, region.size,
+                    VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+            }
+        }
+    }
+    else if (!unsafe) {
+        vulkan::pipelineBarrier(*context, cmd, {
+            .srcStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            .dstStage = VK_PIPELINE_STAGE_2_HOST_BIT_KHR,
+            .dstAccess = VK_ACCESS_2_HOST_READ_BIT_KHR,
+            .buffer = dstBuffer,
+            .offset = copy.dstBegin,
+            .size = copy.dstEnd - copy.dstBegin
+        });
     }
 }
 
@@ -311,13 +1948,18 @@ RetrieveTensorCommand::RetrieveTensorCommand(
     const Tensor<std::byte>& src,
     const Buffer<std::byte>& dst,
     const CopyRegion& region)
+    : RetrieveTensorCommand(src, dst, { &region, 1 }, region.unsafe)
+{}
+RetrieveTensorCommand::RetrieveTensorCommand(
+    const Tensor<std::byte>& src,
+    const Buffer<std::byte>& dst,
+    std::span<const CopyRegion> regions,
+    bool unsafe)
     : Command()
     , source(std::cref(src))
     , destination(std::cref(dst))
-    , sourceOffset(region.tensorOffset)
-    , destinationOffset(region.bufferOffset)
-    , size(region.size)
-    , unsafe(region.unsafe)
+    , regions(regions.begin(), regions.end())
+    , unsafe(unsafe)
 {}
 RetrieveTensorCommand::~RetrieveTensorCommand() = default;
 
@@ -326,87 +1968,73 @@ void UpdateTensorCommand::record(vulkan::Command& cmd) const {
     auto& src = source.get();
     auto& dst = destination.get();
     //Check for src and dst to be from the same context
-    if (src.getContext().get() != dst.getContext().get())
+    if (!vulkan::isSameDevice(src.getContext().get(), dst.getContext().get()))
         throw std::logic_error(DIFFERENT_CONTEXT_ERROR_STR);
     auto& context = src.getContext();
-    //check both have the same size
-    auto srcSize = (size == whole_size ? src.size_bytes() - sourceOffset : size);
-    auto dstSize = (size == whole_size ? dst.size_bytes() - destinationOffset : size);
-    if (srcSize != dstSize)
-        throw std::logic_error(SIZE_MISMATCH_ERROR_STR);
-    //shadow size with actual size
-    auto size = srcSize;
-    //boundary check
-    if (size + sourceOffset > src.size_bytes())
-        throw std::logic_error(COPY_REGION_OUT_OF_SOURCE);
-    if (size + destinationOffset > dst.size_bytes())
-        throw std::logic_error(COPY_REGION_OUT_OF_DESTINATION);
-
-    //we're acting on the transfer stage
-    cmd.stage |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+    auto copy = resolveCopy<CopyRegion>(regions, false,
+        src.getBuffer(), src.size_bytes(), dst.getBuffer(), dst.size_bytes());
+    if (copy.regions.empty())
+        return;
+    vulkan::count(context->counters.bytesUploaded, copy.bytes);
+    auto srcBuffer = src.getBuffer().buffer;
+    auto dstBuffer = dst.getBuffer().buffer;
+
+    //we're acting on the copy stage
+    cmd.stage |= VK_PIPELINE_STAGE_2_COPY_BIT_KHR;
 
     //ensure tensor is safe to update
-    if (!unsafe) {
-        VkBufferMemoryBarrier barrier{
-            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-            .srcAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
-            .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
-            .buffer = dst.getBuffer().buffer,
-            .offset = destinationOffset,
-            .size = size
-        };
-        context->fnTable.vkCmdPipelineBarrier(cmd.buffer,
-            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_DEPENDENCY_BY_REGION_BIT,
-            0, nullptr,
-            1, &barrier,
-            0, nullptr);
-        barrier = VkBufferMemoryBarrier{
-                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-                .srcAccessMask = VK_ACCESS_HOST_WRITE_BIT,
-                .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
-                .buffer = src.getBuffer().buffer,
-                .offset = sourceOffset,
-                .size = size
+    if (cmd.tracker) {
+        //host writes are visible to the device on submit
+        // -> only the tensor needs tracking
+        for (auto& region : copy.regions) {
+            cmd.tracker->buffer(dstBuffer, region.dstOffset, region.size,
+                VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+        }
+        if (unsafe)
+            cmd.tracker->commit();
+        else
+            cmd.tracker->barrier(*context, cmd);
+    }
+    else if (!unsafe) {
+        std::array<vulkan::BufferBarrier, 2> barriers{
+            vulkan::BufferBarrier{
+                .srcStage = TensorAccessStages,
+                .srcAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+                .dstStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+                .dstAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+                .buffer = dstBuffer,
+                .offset = copy.dstBegin,
+                .size = copy.dstEnd - copy.dstBegin
+            },
+            vulkan::BufferBarrier{
+                .srcStage = VK_PIPELINE_STAGE_2_HOST_BIT_KHR,
+                .srcAccess = VK_ACCESS_2_HOST_WRITE_BIT_KHR,
+                .dstStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+                .dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR,
+                .buffer = srcBuffer,
+                .offset = copy.srcBegin,
+                .size = copy.srcEnd - copy.srcBegin
+            }
         };
-        context->fnTable.vkCmdPipelineBarrier(cmd.buffer,
-            VK_PIPELINE_STAGE_HOST_BIT,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_DEPENDENCY_BY_REGION_BIT,
-            0, nullptr,
-            1, &barrier,
-            0, nullptr);
+        vulkan::pipelineBarrier(*context, cmd, barriers);
     }
 
     //actually copy the buffer
-    VkBufferCopy copyRegion{
-        .srcOffset = sourceOffset,
-        .dstOffset = destinationOffset,
-        .size = size
-    };
-    context->fnTable.vkCmdCopyBuffer(cmd.buffer,
-        src.getBuffer().buffer,
-        dst.getBuffer().buffer,
-        1, &copyRegion);
+    context->fnTable.vkCmdCopyBuffer(cmd.buffer, srcBuffer, dstBuffer,
+        static_cast<uint32_t>(copy.regions.size()), copy.regions.data());
 
     //barrier to ensure transfer finished
-    if (!unsafe) {
-        VkBufferMemoryBarrier barrier{
-            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
-            .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
-            .buffer = dst.getBuffer().buffer,
-            .offset = destinationOffset,
-            .size = size
-        };
-        context->fnTable.vkCmdPipelineBarrier(cmd.buffer,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_DEPENDENCY_BY_REGION_BIT,
-            0, nullptr,
-            1, &barrier,
-            0, nullptr);
+    //(the tracker issues it once the tensor gets used)
+    if (!cmd.tracker && !unsafe) {
+        vulkan::pipelineBarrier(*context, cmd, {
+            .srcStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            .dstStage = TensorAccessStages,
+            .dstAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+            .buffer = dstBuffer,
+            .offset = copy.dstBegin,
+            .size = copy.dstEnd - copy.dstBegin
+        });
     }
 }
 
@@ -420,41 +2048,256 @@ UpdateTensorCommand::UpdateTensorCommand(
     const Buffer<std::byte>& src,
     const Tensor<std::byte>& dst,
     const CopyRegion& region)
+    : UpdateTensorCommand(src, dst, { &region, 1 }, region.unsafe)
+{}
+UpdateTensorCommand::UpdateTensorCommand(
+    const Buffer<std::byte>& src,
+    const Tensor<std::byte>& dst,
+    std::span<const CopyRegion> regions,
+    bool unsafe)
     : Command()
     , source(std::cref(src))
     , destination(std::cref(dst))
-    , sourceOffset(region.bufferOffset)
-    , destinationOffset(region.tensorOffset)
-    , size(region.size)
-    , unsafe(region.unsafe)
+    , regions(regions.begin(), regions.end())
+    , unsafe(unsafe)
 {}
 UpdateTensorCommand::~UpdateTensorCommand() = default;
 
+namespace {
+
+//splits the region into consecutive regions of at most chunkSize bytes
+std::vector<CopyRegion> splitRegion(const CopyRegion& region, uint64_t chunkSize,
+    uint64_t tensorSize, uint64_t bufferSize)
+{
+    if (chunkSize == 0)
+        throw std::logic_error("Chunk size must not be zero!");
+    auto size = region.size;
+    if (size == whole_size) {
+        if (region.tensorOffset > tensorSize || region.bufferOffset > bufferSize)
+            throw std::logic_error(SIZE_MISMATCH_ERROR_STR);
+        size = tensorSize - region.tensorOffset;
+        if (size != bufferSize - region.bufferOffset)
+            throw std::logic_error(SIZE_MISMATCH_ERROR_STR);
+    }
+
+    std::vector<CopyRegion> chunks;
+    chunks.reserve((size + chunkSize - 1) / chunkSize);
+    for (uint64_t offset = 0; offset < size; offset += chunkSize) {
+        chunks.push_back({
+            .bufferOffset = region.bufferOffset + offset,
+            .tensorOffset = region.tensorOffset + offset,
+            .size = std::min(chunkSize, size - offset),
+            .unsafe = region.unsafe
+        });
+    }
+    return chunks;
+}
+
+}
+
+std::vector<RetrieveTensorCommand> retrieveTensorChunked(
+    const Tensor<std::byte>& src,
+    const Buffer<std::byte>& dst,
+    uint64_t chunkSize,
+    const CopyRegion& region)
+{
+    std::vector<RetrieveTensorCommand> commands;
+    for (auto& chunk : splitRegion(region, chunkSize, src.size_bytes(), dst.size_bytes()))
+        commands.emplace_back(src, dst, chunk);
+    return commands;
+}
+
+std::vector<UpdateTensorCommand> updateTensorChunked(
+    const Buffer<std::byte>& src,
+    const Tensor<std::byte>& dst,
+    uint64_t chunkSize,
+    const CopyRegion& region)
+{
+    std::vector<UpdateTensorCommand> commands;
+    for (auto& chunk : splitRegion(region, chunkSize, dst.size_bytes(), src.size_bytes()))
+        commands.emplace_back(src, dst, chunk);
+    return commands;
+}
+
+void retrieveTensorStreamed(
+    const Tensor<std::byte>& src,
+    const Buffer<std::byte>& dst,
+    uint64_t chunkSize,
+    const ChunkCallback& callback,
+    const CopyRegion& region)
+{
+    auto commands = retrieveTensorChunked(src, dst, chunkSize, region);
+    if (commands.empty())
+        return;
+
+    //each chunk signals the timeline in its own step
+    Timeline timeline(src.getContext());
+    auto builder = beginSequence(timeline);
+    builder.And(commands.front());
+    for (auto i = 1u; i < commands.size(); ++i)
+        builder.Then(commands[i]);
+    auto submission = builder.Submit();
+
+    //dst must not be released while chunks are still in flight
+    try {
+        auto memory = dst.getMemory();
+        for (auto i = 0u; i < commands.size(); ++i) {
+            timeline.waitValue(i + 1);
+            auto& chunk = commands[i].regions.front();
+            callback(chunk.bufferOffset - region.bufferOffset,
+                memory.subspan(chunk.bufferOffset, chunk.size));
+        }
+    }
+    catch (...) {
+        submission.wait();
+        throw;
+    }
+    submission.wait();
+}
+
+void CopyTensorCommand::record(vulkan::Command& cmd) const {
+    //to shorten the code
+    auto& src = source.get();
+    auto& dst = destination.get();
+    //Check for src and dst to be from the same context
+    if (!vulkan::isSameDevice(src.getContext().get(), dst.getContext().get()))
+        throw std::logic_error(DIFFERENT_CONTEXT_ERROR_STR);
+    auto& context = src.getContext();
+    auto copy = resolveCopy<TensorCopyRegion>(regions, false,
+        src.getBuffer(), src.size_bytes(), dst.getBuffer(), dst.size_bytes());
+    if (copy.regions.empty())
+        return;
+    auto srcBuffer = src.getBuffer().buffer;
+    auto dstBuffer = dst.getBuffer().buffer;
+
+    //sub-allocated tensors and self copies share the same buffer
+    if (srcBuffer == dstBuffer) {
+        for (auto& a : copy.regions) {
+            for (auto& b : copy.regions) {
+                if (a.srcOffset < b.dstOffset + b.size && b.dstOffset < a.srcOffset + a.size)
+                    throw std::logic_error("Source and destination copy regions must not overlap!");
+            }
+        }
+    }
+
+    //we're acting on the copy stage
+    cmd.stage |= VK_PIPELINE_STAGE_2_COPY_BIT_KHR;
+
+    //ensure both tensors are safe to access
+    if (cmd.tracker) {
+        for (auto& region : copy.regions) {
+            cmd.tracker->buffer(srcBuffer, region.srcOffset, region.size,
+                VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+            cmd.tracker->buffer(dstBuffer, region.dstOffset, region.size,
+                VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+        }
+        if (unsafe)
+            cmd.tracker->commit();
+        else
+            cmd.tracker->barrier(*context, cmd);
+    }
+    else if (!unsafe) {
+        std::array<vulkan::BufferBarrier, 2> barriers{
+            vulkan::BufferBarrier{
+                .srcStage = TensorAccessStages,
+                .srcAccess = VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+                .dstStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+                .dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR,
+                .buffer = srcBuffer,
+                .offset = copy.srcBegin,
+                .size = copy.srcEnd - copy.srcBegin
+            },
+            vulkan::BufferBarrier{
+                .srcStage = TensorAccessStages,
+                .srcAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+                .dstStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+                .dstAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+                .buffer = dstBuffer,
+                .offset = copy.dstBegin,
+                .size = copy.dstEnd - copy.dstBegin
+            }
+        };
+        vulkan::pipelineBarrier(*context, cmd, barriers);
+    }
+
+    //actually copy the buffer
+    context->fnTable.vkCmdCopyBuffer(cmd.buffer, srcBuffer, dstBuffer,
+        static_cast<uint32_t>(copy.regions.size()), copy.regions.data());
+
+    //barrier to ensure transfer finished
+    //(the tracker issues it once the tensor gets used)
+    if (!cmd.tracker && !unsafe) {
+        vulkan::pipelineBarrier(*context, cmd, {
+            .srcStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            .dstStage = TensorAccessStages,
+            .dstAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+            .buffer = dstBuffer,
+            .offset = copy.dstBegin,
+            .size = copy.dstEnd - copy.dstBegin
+        });
+    }
+}
+
+CopyTensorCommand::CopyTensorCommand(const CopyTensorCommand& other) = default;
+CopyTensorCommand& CopyTensorCommand::operator=(const CopyTensorCommand& other) = default;
+
+CopyTensorCommand::CopyTensorCommand(CopyTensorCommand&& other) noexcept = default;
+CopyTensorCommand& CopyTensorCommand::operator=(CopyTensorCommand&& other) noexcept = default;
+
+CopyTensorCommand::CopyTensorCommand(
+    const Tensor<std::byte>& src,
+    const Tensor<std::byte>& dst,
+    const TensorCopyRegion& region)
+    : CopyTensorCommand(src, dst, { &region, 1 }, region.unsafe)
+{}
+CopyTensorCommand::CopyTensorCommand(
+    const Tensor<std::byte>& src,
+    const Tensor<std::byte>& dst,
+    std::span<const TensorCopyRegion> regions,
+    bool unsafe)
+    : Command()
+    , source(std::cref(src))
+    , destination(std::cref(dst))
+    , regions(regions.begin(), regions.end())
+    , unsafe(unsafe)
+{}
+CopyTensorCommand::~CopyTensorCommand() = default;
+
 
 void ClearTensorCommand::record(vulkan::Command& cmd) const {
     //to shorten things
     auto& context = tensor.get().getContext();
     auto buffer = tensor.get().getBuffer().buffer; //ptr -> by value
+    //tensors might be sub-allocated from a shared buffer
+    // -> resolve whole size ourselves, rounded down like the driver would
+    auto size = this->size;
+    if (size == whole_size)
+        size = (tensor.get().size_bytes() - offset) & ~uint64_t(3);
+    auto offset = this->offset + tensor.get().getBuffer().offset;
 
-    //we're acting on the transfer stage
-    cmd.stage |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+    //we're acting on the clear stage
+    cmd.stage |= VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR;
 
     //ensure tensor is safe to update
-    if (!unsafe) {
-        VkBufferMemoryBarrier barrier{
-            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-            .srcAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
-            .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+    if (cmd.tracker) {
+        cmd.tracker->buffer(buffer, offset, size,
+            VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+        if (unsafe)
+            cmd.tracker->commit();
+        else
+            cmd.tracker->barrier(*context, cmd);
+    }
+    else if (!unsafe) {
+        vulkan::pipelineBarrier(*context, cmd, {
+            .srcStage = TensorAccessStages,
+            .srcAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+            .dstStage = VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR,
+            .dstAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
             .buffer = buffer,
-            .size = VK_WHOLE_SIZE
-        };
-        context->fnTable.vkCmdPipelineBarrier(cmd.buffer,
-            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_DEPENDENCY_BY_REGION_BIT,
-            0, nullptr,
-            1, &barrier,
-            0, nullptr);
+            .offset = offset,
+            .size = size
+        });
     }
 
     //fill buffer
@@ -462,21 +2305,17 @@ void ClearTensorCommand::record(vulkan::Command& cmd) const {
         buffer, offset, size, data);
 
     //barrier to ensure transfer finished
-    if (!unsafe) {
-        VkBufferMemoryBarrier barrier{
-            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
-            .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
+    //(the tracker issues it once the tensor gets used)
+    if (!cmd.tracker && !unsafe) {
+        vulkan::pipelineBarrier(*context, cmd, {
+            .srcStage = VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR,
+            .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            .dstStage = TensorAccessStages,
+            .dstAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
             .buffer = buffer,
-            .size = VK_WHOLE_SIZE
-        };
-        context->fnTable.vkCmdPipelineBarrier(cmd.buffer,
-            VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
-            VK_DEPENDENCY_BY_REGION_BIT,
-            0, nullptr,
-            1, &barrier,
-            0, nullptr);
+            .offset = offset,
+            .size = size
+        });
     }
 }
 
@@ -496,4 +2335,139 @@ ClearTensorCommand::ClearTensorCommand(const Tensor<std::byte>& tensor, const Pa
 {}
 ClearTensorCommand::~ClearTensorCommand() = default;
 
+namespace {
+
+//largest amount of data vkCmdUpdateBuffer accepts
+constexpr uint64_t MaxPatternSize = 65536;
+//amount of data written directly before replicating it on the device
+constexpr uint64_t FillSeedSize = 4096;
+
+constexpr VkPipelineStageFlags2KHR FillStages =
+    VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR | VK_PIPELINE_STAGE_2_COPY_BIT_KHR;
+
+}
+
+void FillTensorCommand::record(vulkan::Command& cmd) const {
+    //to shorten things
+    auto& context = tensor.get().getContext();
+    auto buffer = tensor.get().getBuffer().buffer; //ptr -> by value
+    uint64_t patternSize = pattern.size();
+    //resolve whole size ourselves, rounded down to a multiple of the pattern
+    auto size = this->size;
+    if (size == whole_size)
+        size = (tensor.get().size_bytes() - offset) / patternSize * patternSize;
+    if (size == 0)
+        return;
+    auto offset = this->offset + tensor.get().getBuffer().offset;
+
+    //we're acting on the clear and copy stage
+    cmd.stage |= FillStages;
+
+    //ensure tensor is safe to update
+    if (cmd.tracker) {
+        cmd.tracker->buffer(buffer, offset, size, FillStages,
+            VK_ACCESS_2_TRANSFER_READ_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+        if (unsafe)
+            cmd.tracker->commit();
+        else
+            cmd.tracker->barrier(*context, cmd);
+    }
+    else if (!unsafe) {
+        vulkan::pipelineBarrier(*context, cmd, {
+            .srcStage = TensorAccessStages,
+            .srcAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+            .dstStage = FillStages,
+            .dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            .buffer = buffer,
+            .offset = offset,
+            .size = size
+        });
+    }
+
+    if (patternSize == 4) {
+        //fill buffer handles 4 byte patterns natively
+        uint32_t data;
+        std::memcpy(&data, pattern.data(), 4);
+        context->fnTable.vkCmdFillBuffer(cmd.buffer, buffer, offset, size, data);
+    }
+    else {
+        //write a seed of repeated patterns into the command buffer...
+        auto seedSize = std::min(size,
+            std::max(FillSeedSize / patternSize, uint64_t(1)) * patternSize);
+        std::vector<std::byte> seed(seedSize);
+        for (uint64_t pos = 0; pos < seedSize; pos += patternSize)
+            std::memcpy(seed.data() + pos, pattern.data(), patternSize);
+        context->fnTable.vkCmdUpdateBuffer(cmd.buffer,
+            buffer, offset, seedSize, seed.data());
+
+        //...and double the filled region by copying it until done
+        for (auto filled = seedSize; filled < size;) {
+            vulkan::pipelineBarrier(*context, cmd, {
+                .srcStage = FillStages,
+                .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+                .dstStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+                .dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR,
+                .buffer = buffer,
+                .offset = offset,
+                .size = filled
+            });
+            VkBufferCopy region{
+                .srcOffset = offset,
+                .dstOffset = offset + filled,
+                .size = std::min(filled, size - filled)
+            };
+            context->fnTable.vkCmdCopyBuffer(cmd.buffer, buffer, buffer, 1, &region);
+            filled += region.size;
+        }
+    }
+
+    //barrier to ensure transfer finished
+    //(the tracker issues it once the tensor gets used)
+    if (!cmd.tracker && !unsafe) {
+        vulkan::pipelineBarrier(*context, cmd, {
+            .srcStage = FillStages,
+            .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            .dstStage = TensorAccessStages,
+            .dstAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+            .buffer = buffer,
+            .offset = offset,
+            .size = size
+        });
+    }
+}
+
+FillTensorCommand::FillTensorCommand(const FillTensorCommand& other) = default;
+FillTensorCommand& FillTensorCommand::operator=(const FillTensorCommand& other) = default;
+
+FillTensorCommand::FillTensorCommand(FillTensorCommand&& other) noexcept = default;
+FillTensorCommand& FillTensorCommand::operator=(FillTensorCommand&& other) noexcept = default;
+
+FillTensorCommand::FillTensorCommand(
+    const Tensor<std::byte>& tensor,
+    std::span<const std::byte> pattern,
+    const Params& params)
+    : Command()
+    , tensor(std::cref(tensor))
+    , offset(params.offset)
+    , size(params.size)
+    , pattern(pattern.begin(), pattern.end())
+    , unsafe(params.unsafe)
+{
+    if (pattern.empty() || pattern.size() % 4 != 0)
+        throw std::logic_error("Size of the pattern must be a non zero multiple of 4!");
+    if (pattern.size() > MaxPatternSize)
+        throw std::logic_error("Pattern must be at most 65536 bytes!");
+    if (offset % 4 != 0)
+        throw std::logic_error("Offset must be a multiple of 4!");
+    if (offset > tensor.size_bytes())
+        throw std::logic_error("Offset is outside the tensor!");
+    if (size != whole_size) {
+        if (size % pattern.size() != 0)
+            throw std::logic_error("Size must be a multiple of the pattern size!");
+        if (offset + size > tensor.size_bytes())
+            throw std::logic_error("Region is not contained within the tensor!");
+    }
+}
+FillTensorCommand::~FillTensorCommand() = default;
+
 }
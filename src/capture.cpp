@@ -0,0 +1,324 @@
+#include "hephaistos/capture.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "hephaistos/command.hpp"
+#include "hephaistos/program.hpp"
+#include "hephaistos/stopwatch.hpp"
+
+namespace hephaistos {
+
+namespace {
+
+//magic identifying capture files; last byte is the format version
+constexpr std::array<char, 8> CaptureMagic = { 'H', 'P', 'C', 'A', 'P', 'T', '\0', '\1' };
+
+class CaptureWriter {
+public:
+    template<class T> requires std::is_trivially_copyable_v<T>
+    void write(const T& value) {
+        auto bytes = std::as_bytes(std::span<const T>{ &value, 1 });
+        data.insert(data.end(), bytes.begin(), bytes.end());
+    }
+    template<class T>
+    void writeArray(std::span<const T> values) {
+        write(static_cast<uint64_t>(values.size()));
+        auto bytes = std::as_bytes(values);
+        data.insert(data.end(), bytes.begin(), bytes.end());
+    }
+
+    std::vector<std::byte> data;
+};
+
+class CaptureReader {
+public:
+    template<class T> requires std::is_trivially_copyable_v<T>
+    T read() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+    template<class T>
+    std::vector<T> readArray() {
+        auto count = read<uint64_t>();
+        if (count > data.size() / sizeof(T))
+            throw std::runtime_error("Invalid capture!");
+        std::vector<T> values(count);
+        std::memcpy(values.data(), take(count * sizeof(T)).data(), count * sizeof(T));
+        return values;
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return data.empty(); }
+
+    explicit CaptureReader(std::span<const std::byte> data)
+        : data(data)
+    {}
+
+private:
+    std::span<const std::byte> take(size_t size) {
+        if (size > data.size())
+            throw std::runtime_error("Invalid capture!");
+        auto result = data.first(size);
+        data = data.subspan(size);
+        return result;
+    }
+
+    std::span<const std::byte> data;
+};
+
+}
+
+struct Capture::pImp {
+    struct ProgramEntry {
+        std::vector<uint32_t> code;
+        std::vector<std::byte> specialization;
+    };
+
+    std::vector<ProgramEntry> programs;
+    std::vector<std::vector<std::byte>> tensors;
+    //the last step is the one currently recorded
+    std::vector<std::vector<CaptureDispatch>> steps;
+
+    void validate(const CaptureDispatch& dispatch) const {
+        if (dispatch.program >= programs.size())
+            throw std::out_of_range("Dispatch references an unknown program!");
+        auto unknown = std::any_of(dispatch.tensors.begin(), dispatch.tensors.end(),
+            [this](uint32_t t) { return t >= tensors.size(); });
+        if (unknown)
+            throw std::out_of_range("Dispatch references an unknown tensor!");
+    }
+};
+
+uint32_t Capture::addProgram(std::span<const uint32_t> code,
+    std::span<const std::byte> specialization)
+{
+    if (code.empty())
+        throw std::logic_error("Program code must not be empty!");
+    _pImp->programs.push_back({
+        .code = { code.begin(), code.end() },
+        .specialization = { specialization.begin(), specialization.end() }
+    });
+    return static_cast<uint32_t>(_pImp->programs.size() - 1);
+}
+uint32_t Capture::addTensor(std::span<const std::byte> data) {
+    if (data.empty())
+        throw std::logic_error("Captured tensors must not be empty!");
+    _pImp->tensors.emplace_back(data.begin(), data.end());
+    return static_cast<uint32_t>(_pImp->tensors.size() - 1);
+}
+uint32_t Capture::addTensor(const Tensor<std::byte>& tensor) {
+    Buffer<std::byte> buffer(tensor.getContext(), tensor.size_bytes());
+    execute(tensor.getContext(), retrieveTensor(tensor, buffer));
+    return addTensor(buffer.getMemory());
+}
+
+Capture& Capture::dispatch(CaptureDispatch dispatch) {
+    _pImp->validate(dispatch);
+    if (_pImp->steps.empty())
+        _pImp->steps.emplace_back();
+    _pImp->steps.back().push_back(std::move(dispatch));
+    return *this;
+}
+Capture& Capture::nextStep() {
+    //empty steps would only add a submission
+    if (!_pImp->steps.empty() && !_pImp->steps.back().empty())
+        _pImp->steps.emplace_back();
+    return *this;
+}
+
+uint32_t Capture::getProgramCount() const noexcept {
+    return static_cast<uint32_t>(_pImp->programs.size());
+}
+uint32_t Capture::getTensorCount() const noexcept {
+    return static_cast<uint32_t>(_pImp->tensors.size());
+}
+std::span<const uint32_t> Capture::getCode(uint32_t program) const {
+    return _pImp->programs.at(program).code;
+}
+std::span<const std::byte> Capture::getSpecialization(uint32_t program) const {
+    return _pImp->programs.at(program).specialization;
+}
+std::span<const std::byte> Capture::getTensorData(uint32_t tensor) const {
+    return _pImp->tensors.at(tensor);
+}
+const std::vector<std::vector<CaptureDispatch>>& Capture::getSteps() const noexcept {
+    return _pImp->steps;
+}
+
+std::vector<std::byte> Capture::serialize() const {
+    CaptureWriter writer;
+    writer.write(CaptureMagic);
+    writer.write(static_cast<uint64_t>(_pImp->programs.size()));
+    for (auto& program : _pImp->programs) {
+        writer.writeArray<uint32_t>(program.code);
+        writer.writeArray<std::byte>(program.specialization);
+    }
+    writer.write(static_cast<uint64_t>(_pImp->tensors.size()));
+    for (auto& tensor : _pImp->tensors)
+        writer.writeArray<std::byte>(tensor);
+    writer.write(static_cast<uint64_t>(_pImp->steps.size()));
+    for (auto& step : _pImp->steps) {
+        writer.write(static_cast<uint64_t>(step.size()));
+        for (auto& dispatch : step) {
+            writer.write(dispatch.program);
+            writer.writeArray<uint32_t>(dispatch.tensors);
+            writer.writeArray<std::byte>(dispatch.push);
+            writer.write(dispatch.groupCountX);
+            writer.write(dispatch.groupCountY);
+            writer.write(dispatch.groupCountZ);
+        }
+    }
+    return std::move(writer.data);
+}
+
+void Capture::save(const std::filesystem::path& path) const {
+    auto data = serialize();
+
+    //write to temporary file first, so other processes never read partial data
+    auto tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()),
+            static_cast<std::streamsize>(data.size()));
+        if (!file)
+            throw std::runtime_error("Failed to write capture!");
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        throw std::runtime_error("Failed to write capture!");
+    }
+}
+
+Capture::Capture(Capture&&) noexcept = default;
+Capture& Capture::operator=(Capture&&) noexcept = default;
+
+Capture::Capture()
+    : _pImp(std::make_unique<pImp>())
+{}
+Capture::Capture(std::span<const std::byte> data)
+    : _pImp(std::make_unique<pImp>())
+{
+    CaptureReader reader(data);
+    if (reader.read<std::array<char, 8>>() != CaptureMagic)
+        throw std::runtime_error("Invalid capture!");
+
+    auto programCount = reader.read<uint64_t>();
+    for (auto i = 0u; i < programCount; ++i) {
+        auto code = reader.readArray<uint32_t>();
+        auto specialization = reader.readArray<std::byte>();
+        _pImp->programs.push_back({ std::move(code), std::move(specialization) });
+    }
+    auto tensorCount = reader.read<uint64_t>();
+    for (auto i = 0u; i < tensorCount; ++i)
+        _pImp->tensors.push_back(reader.readArray<std::byte>());
+    auto stepCount = reader.read<uint64_t>();
+    for (auto i = 0u; i < stepCount; ++i) {
+        auto& step = _pImp->steps.emplace_back();
+        auto dispatchCount = reader.read<uint64_t>();
+        for (auto j = 0u; j < dispatchCount; ++j) {
+            CaptureDispatch dispatch{};
+            dispatch.program = reader.read<uint32_t>();
+            dispatch.tensors = reader.readArray<uint32_t>();
+            dispatch.push = reader.readArray<std::byte>();
+            dispatch.groupCountX = reader.read<uint32_t>();
+            dispatch.groupCountY = reader.read<uint32_t>();
+            dispatch.groupCountZ = reader.read<uint32_t>();
+            //report corrupted indices as invalid file
+            try {
+                _pImp->validate(dispatch);
+            }
+            catch (const std::out_of_range&) {
+                throw std::runtime_error("Invalid capture!");
+            }
+            step.push_back(std::move(dispatch));
+        }
+    }
+    if (!reader.empty())
+        throw std::runtime_error("Invalid capture!");
+}
+Capture::Capture(const std::filesystem::path& path)
+    : Capture()
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Failed to open capture!");
+    std::vector<char> chars{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    *this = Capture(std::as_bytes(std::span<const char>(chars)));
+}
+Capture::~Capture() = default;
+
+std::vector<double> replayCapture(
+    const ContextHandle& context, const Capture& capture,
+    const ReplayOptions& options)
+{
+    if (options.iterations == 0)
+        throw std::logic_error("At least one iteration is needed for replaying!");
+
+    //create resources once; staging buffers keep the captured contents
+    std::vector<Program> programs;
+    programs.reserve(capture.getProgramCount());
+    for (auto i = 0u; i < capture.getProgramCount(); ++i)
+        programs.emplace_back(context, capture.getCode(i), capture.getSpecialization(i));
+    std::vector<Buffer<std::byte>> staging;
+    std::vector<Tensor<std::byte>> tensors;
+    staging.reserve(capture.getTensorCount());
+    tensors.reserve(capture.getTensorCount());
+    for (auto i = 0u; i < capture.getTensorCount(); ++i) {
+        staging.emplace_back(context, capture.getTensorData(i));
+        tensors.emplace_back(staging.back());
+    }
+
+    //dispatches capture the bindings on creation
+    std::vector<std::vector<DispatchCommand>> steps;
+    for (auto& step : capture.getSteps()) {
+        auto& commands = steps.emplace_back();
+        for (auto& dispatch : step) {
+            auto& program = programs[dispatch.program];
+            for (auto i = 0u; i < dispatch.tensors.size(); ++i)
+                program.bindParameter(tensors[dispatch.tensors[i]], i);
+            commands.push_back(program.dispatch(std::span<const std::byte>(dispatch.push),
+                dispatch.groupCountX, dispatch.groupCountY, dispatch.groupCountZ));
+        }
+    }
+
+    StopWatch watch(context);
+    auto run = [&]() {
+        watch.reset();
+        auto builder = beginSequence(context);
+        if (options.resetTensors) {
+            for (auto i = 0u; i < tensors.size(); ++i)
+                builder.And(updateTensor(staging[i], tensors[i]));
+            builder.NextStep();
+        }
+        builder.And(watch.start());
+        for (auto& step : steps) {
+            builder.NextStep();
+            for (auto& command : step)
+                builder.And(command);
+        }
+        builder.Then(watch.stop())
+            .Submit().wait();
+        return watch.getElapsedTime(true);
+    };
+
+    for (auto i = 0u; i < options.warmup; ++i)
+        static_cast<void>(run());
+    std::vector<double> times(options.iterations);
+    for (auto& time : times)
+        time = run();
+    return times;
+}
+
+}
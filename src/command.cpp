@@ -1,14 +1,22 @@
 #include "hephaistos/command.hpp"
 
 #include <algorithm>
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <vector>
 
 #include "volk.h"
 
+#include "vk/completion.hpp"
+#include "vk/hazard.hpp"
 #include "vk/result.hpp"
 #include "vk/types.hpp"
 #include "vk/util.hpp"
+#include "vk/workers.hpp"
 
 namespace hephaistos {
 
@@ -19,8 +27,14 @@ Command::~Command() = default;
 bool Subroutine::simultaneousUse() const {
     return simultaneous_use;
 }
+bool Subroutine::nestable() const {
+    return parts_only;
+}
 const vulkan::Command& Subroutine::getCommandBuffer() const {
-    return *cmdBuffer;
+    return cmdBuffer->cmd;
+}
+const std::vector<std::shared_ptr<vulkan::SubroutinePart>>& Subroutine::getParts() const {
+    return parts;
 }
 
 Subroutine::Subroutine(Subroutine&&) noexcept = default;
@@ -28,18 +42,25 @@ Subroutine& Subroutine::operator=(Subroutine&&) noexcept = default;
 
 Subroutine::Subroutine(
     ContextHandle context,
-    std::unique_ptr<vulkan::Command> cmdBuffer,
-    bool simultaneous_use)
+    std::unique_ptr<vulkan::SubroutineBuffer> cmdBuffer,
+    std::vector<std::shared_ptr<vulkan::SubroutinePart>> parts,
+    bool simultaneous_use,
+    bool parts_only)
     : Resource(std::move(context))
     , cmdBuffer(std::move(cmdBuffer))
+    , parts(std::move(parts))
     , simultaneous_use(simultaneous_use)
-{}
+    , parts_only(parts_only)
+{
+    trackResource("Subroutine", 0);
+}
 Subroutine::~Subroutine() {
+    //destroying the pool frees the command buffer
     if (cmdBuffer) {
         auto& context = *getContext();
-        context.fnTable.vkFreeCommandBuffers(
-            context.device, context.subroutinePool,
-            1, &cmdBuffer->buffer);
+        vulkan::retireResource(context, [&context, pool = cmdBuffer->pool]() {
+            context.fnTable.vkDestroyCommandPool(context.device, pool, nullptr);
+        });
     }
 }
 
@@ -51,20 +72,85 @@ SubroutineBuilder& SubroutineBuilder::addCommand(const Command& command) & {
     if (!*this)
         throw std::runtime_error("SubroutineBuilder has already finished!");
 
-    command.record(*cmdBuffer);
+    command.record(cmdBuffer->cmd);
+    parts_only = false;
     return *this;
 }
 SubroutineBuilder SubroutineBuilder::addCommand(const Command& command) && {
     static_cast<SubroutineBuilder&>(*this).addCommand(command);
     return std::move(*this);
 }
+SubroutineBuilder& SubroutineBuilder::addPart(const SubroutinePart& part) & {
+    if (!*this)
+        throw std::runtime_error("SubroutineBuilder has already finished!");
+
+    auto& _part = part.getPart();
+    context->fnTable.vkCmdExecuteCommands(cmdBuffer->cmd.buffer, 1, &_part->cmd.buffer);
+    cmdBuffer->cmd.stage |= _part->cmd.stage;
+    //executing secondary buffers makes the bound state undefined
+    cmdBuffer->cmd.bound = {};
+    parts.push_back(_part);
+    return *this;
+}
+SubroutineBuilder SubroutineBuilder::addPart(const SubroutinePart& part) && {
+    static_cast<SubroutineBuilder&>(*this).addPart(part);
+    return std::move(*this);
+}
+SubroutineBuilder& SubroutineBuilder::addSubroutine(const Subroutine& subroutine) & {
+    if (!*this)
+        throw std::runtime_error("SubroutineBuilder has already finished!");
+    //primary command buffers cannot be executed inside others
+    if (!subroutine.nestable())
+        throw std::logic_error("Only subroutines assembled from parts can be nested!");
+
+    //secondary buffers are recorded with simultaneous use -> can be shared
+    std::vector<VkCommandBuffer> buffers;
+    buffers.reserve(subroutine.getParts().size());
+    for (auto& part : subroutine.getParts()) {
+        buffers.push_back(part->cmd.buffer);
+        parts.push_back(part);
+    }
+    if (!buffers.empty()) {
+        context->fnTable.vkCmdExecuteCommands(cmdBuffer->cmd.buffer,
+            static_cast<uint32_t>(buffers.size()), buffers.data());
+        cmdBuffer->cmd.bound = {};
+    }
+    cmdBuffer->cmd.stage |= subroutine.getCommandBuffer().stage;
+    return *this;
+}
+SubroutineBuilder SubroutineBuilder::addSubroutine(const Subroutine& subroutine) && {
+    static_cast<SubroutineBuilder&>(*this).addSubroutine(subroutine);
+    return std::move(*this);
+}
+SubroutineBuilder& SubroutineBuilder::trackHazards() & {
+    if (!*this)
+        throw std::runtime_error("SubroutineBuilder has already finished!");
+
+    if (!tracker) {
+        tracker = std::make_unique<vulkan::HazardTracker>();
+        cmdBuffer->cmd.tracker = tracker.get();
+    }
+    return *this;
+}
+SubroutineBuilder SubroutineBuilder::trackHazards() && {
+    static_cast<SubroutineBuilder&>(*this).trackHazards();
+    return std::move(*this);
+}
 Subroutine SubroutineBuilder::finish() {
     if (!*this)
         throw std::runtime_error("SubroutineBuilder has already finished!");
 
+    //make tracked writes visible to the host
+    if (tracker) {
+        tracker->finish(*context, cmdBuffer->cmd);
+        cmdBuffer->cmd.tracker = nullptr;
+        tracker.reset();
+    }
+
     //end recording & build subroutine
-    vulkan::checkResult(context->fnTable.vkEndCommandBuffer(cmdBuffer->buffer));
-    return Subroutine(std::move(context), std::move(cmdBuffer), simultaneous_use);
+    vulkan::checkResult(context->fnTable.vkEndCommandBuffer(cmdBuffer->cmd.buffer));
+    return Subroutine(std::move(context), std::move(cmdBuffer),
+        std::move(parts), simultaneous_use, parts_only);
 }
 
 SubroutineBuilder::SubroutineBuilder(SubroutineBuilder&&) noexcept = default;
@@ -72,17 +158,32 @@ SubroutineBuilder& SubroutineBuilder::operator=(SubroutineBuilder&&) noexcept =
 
 SubroutineBuilder::SubroutineBuilder(ContextHandle context, bool simultaneous_use)
     : context(std::move(context))
-    , cmdBuffer(std::make_unique<vulkan::Command>())
+    , cmdBuffer(std::make_unique<vulkan::SubroutineBuffer>())
+    , parts()
     , simultaneous_use(simultaneous_use)
+    , parts_only(true)
 {
+    //each subroutine gets its own pool, so they can be recorded in parallel
+    VkCommandPoolCreateInfo poolInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .queueFamilyIndex = this->context->queueFamily
+    };
+    vulkan::checkResult(this->context->fnTable.vkCreateCommandPool(
+        this->context->device, &poolInfo, nullptr, &cmdBuffer->pool));
+
     //Allocate command buffer
     VkCommandBufferAllocateInfo allocInfo{
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-        .commandPool = this->context->subroutinePool,
+        .commandPool = cmdBuffer->pool,
         .commandBufferCount = 1
     };
-    vulkan::checkResult(this->context->fnTable.vkAllocateCommandBuffers(
-        this->context->device, &allocInfo, &cmdBuffer->buffer));
+    auto result = this->context->fnTable.vkAllocateCommandBuffers(
+        this->context->device, &allocInfo, &cmdBuffer->cmd.buffer);
+    if (result != VK_SUCCESS) {
+        this->context->fnTable.vkDestroyCommandPool(
+            this->context->device, cmdBuffer->pool, nullptr);
+        vulkan::checkResult(result);
+    }
 
     //start recording
     VkCommandBufferBeginInfo beginInfo{
@@ -91,15 +192,125 @@ SubroutineBuilder::SubroutineBuilder(ContextHandle context, bool simultaneous_us
     if (simultaneous_use)
         beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
     vulkan::checkResult(this->context->fnTable.vkBeginCommandBuffer(
-        cmdBuffer->buffer, &beginInfo));
+        cmdBuffer->cmd.buffer, &beginInfo));
 }
 SubroutineBuilder::~SubroutineBuilder() {
-    if (cmdBuffer) {
-        context->fnTable.vkFreeCommandBuffers(
-            context->device, context->subroutinePool,
-            1, &cmdBuffer->buffer);
+    if (cmdBuffer)
+        context->fnTable.vkDestroyCommandPool(context->device, cmdBuffer->pool, nullptr);
+}
+
+/****************************** SUBROUTINE PART *******************************/
+
+const std::shared_ptr<vulkan::SubroutinePart>& SubroutinePart::getPart() const {
+    return part;
+}
+
+SubroutinePart::SubroutinePart(SubroutinePart&&) noexcept = default;
+SubroutinePart& SubroutinePart::operator=(SubroutinePart&&) noexcept = default;
+
+SubroutinePart::SubroutinePart(
+    ContextHandle context, std::shared_ptr<vulkan::SubroutinePart> part)
+    : Resource(std::move(context))
+    , part(std::move(part))
+{}
+//part may still be used by subroutines -> destroyed with the last reference
+SubroutinePart::~SubroutinePart() = default;
+
+SubroutinePartBuilder::operator bool() const {
+    return static_cast<bool>(part);
+}
+
+SubroutinePartBuilder& SubroutinePartBuilder::addCommand(const Command& command) & {
+    if (!*this)
+        throw std::runtime_error("SubroutinePartBuilder has already finished!");
+
+    command.record(part->cmd);
+    return *this;
+}
+SubroutinePartBuilder SubroutinePartBuilder::addCommand(const Command& command) && {
+    static_cast<SubroutinePartBuilder&>(*this).addCommand(command);
+    return std::move(*this);
+}
+SubroutinePartBuilder& SubroutinePartBuilder::trackHazards() & {
+    if (!*this)
+        throw std::runtime_error("SubroutinePartBuilder has already finished!");
+
+    if (!tracker) {
+        tracker = std::make_unique<vulkan::HazardTracker>();
+        part->cmd.tracker = tracker.get();
     }
+    return *this;
 }
+SubroutinePartBuilder SubroutinePartBuilder::trackHazards() && {
+    static_cast<SubroutinePartBuilder&>(*this).trackHazards();
+    return std::move(*this);
+}
+SubroutinePart SubroutinePartBuilder::finish() {
+    if (!*this)
+        throw std::runtime_error("SubroutinePartBuilder has already finished!");
+
+    //make tracked writes visible to the host
+    if (tracker) {
+        tracker->finish(*context, part->cmd);
+        part->cmd.tracker = nullptr;
+        tracker.reset();
+    }
+
+    //end recording & build part
+    vulkan::checkResult(context->fnTable.vkEndCommandBuffer(part->cmd.buffer));
+    return SubroutinePart(std::move(context), std::move(part));
+}
+
+SubroutinePartBuilder::SubroutinePartBuilder(SubroutinePartBuilder&&) noexcept = default;
+SubroutinePartBuilder& SubroutinePartBuilder::operator=(SubroutinePartBuilder&&) noexcept = default;
+
+SubroutinePartBuilder::SubroutinePartBuilder(ContextHandle context)
+    : context(std::move(context))
+    , part()
+{
+    //the pool is destroyed together with the part, which might outlive us
+    auto& _context = this->context;
+    part = std::shared_ptr<vulkan::SubroutinePart>(
+        new vulkan::SubroutinePart{ VK_NULL_HANDLE, {} },
+        [_context](vulkan::SubroutinePart* p) {
+            if (p->pool)
+                _context->fnTable.vkDestroyCommandPool(_context->device, p->pool, nullptr);
+            delete p;
+        });
+
+    //each part gets its own pool, so they can be recorded in parallel
+    VkCommandPoolCreateInfo poolInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .queueFamilyIndex = _context->queues[static_cast<size_t>(QueueType::MAIN)].family
+    };
+    vulkan::checkResult(_context->fnTable.vkCreateCommandPool(
+        _context->device, &poolInfo, nullptr, &part->pool));
+
+    //Allocate command buffer
+    VkCommandBufferAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = part->pool,
+        .level = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+        .commandBufferCount = 1
+    };
+    vulkan::checkResult(_context->fnTable.vkAllocateCommandBuffers(
+        _context->device, &allocInfo, &part->cmd.buffer));
+
+    //start recording
+    //parts can be shared by multiple subroutines -> always simultaneous use
+    VkCommandBufferInheritanceInfo inheritInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO
+    };
+    VkCommandBufferBeginInfo beginInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+        .pInheritanceInfo = &inheritInfo
+    };
+    vulkan::checkResult(_context->fnTable.vkBeginCommandBuffer(
+        part->cmd.buffer, &beginInfo));
+}
+//unfinished part is destroyed together with its shared pointer
+SubroutinePartBuilder::~SubroutinePartBuilder() = default;
 
 /********************************* TIMELINE ***********************************/
 
@@ -116,6 +327,7 @@ uint64_t Timeline::getValue() const {
 }
 void Timeline::setValue(uint64_t value) {
     auto& context = getContext();
+    vulkan::traceInstant(*context, "Signal", "update");
     VkSemaphoreSignalInfo info{
         .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO,
         .semaphore = timeline->semaphore,
@@ -129,6 +341,9 @@ void Timeline::waitValue(uint64_t value) const {
 }
 bool Timeline::waitValue(uint64_t value, uint64_t timeout) const {
     auto& context = getContext();
+    vulkan::TraceScope trace(*context, "Wait", "wait");
+    if (vulkan::spinWait(*context, { &timeline->semaphore, 1 }, { &value, 1 }, false, timeout))
+        return true;
     VkSemaphoreWaitInfo info{
         .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
         .semaphoreCount = 1,
@@ -149,9 +364,20 @@ bool Timeline::waitValue(uint64_t value, uint64_t timeout) const {
     }
 }
 
+void Timeline::onValue(uint64_t value, std::function<void()> callback) const {
+    vulkan::addCompletion(*getContext(), timeline->semaphore, value, std::move(callback));
+}
+
+TimelineAwaiter Timeline::awaitValue(uint64_t value, Executor executor) const {
+    return TimelineAwaiter(*this, value, std::move(executor));
+}
+
 vulkan::Timeline& Timeline::getTimeline() const {
     return *timeline;
 }
+std::unique_ptr<vulkan::Timeline> Timeline::releaseTimeline() {
+    return std::move(timeline);
+}
 
 Timeline::Timeline(Timeline&& other) noexcept
     : Resource(std::move(other))
@@ -181,28 +407,82 @@ Timeline::Timeline(ContextHandle context, uint64_t initialValue)
     vulkan::checkResult(_context->fnTable.vkCreateSemaphore(
         _context->device, &info, nullptr, &timeline->semaphore));
 }
+Timeline::Timeline(ContextHandle context, std::unique_ptr<vulkan::Timeline> timeline)
+    : Resource(std::move(context))
+    , timeline(std::move(timeline))
+{}
 Timeline::~Timeline() {
     if (timeline) {
         auto& context = getContext();
-        context->fnTable.vkDestroySemaphore(
-            context->device, timeline->semaphore, nullptr);
+        if (timeline->pooled) {
+            //new owner must not see our callbacks
+            vulkan::removeCompletions(*context, timeline->semaphore);
+            //return to context for reuse
+            std::lock_guard<std::mutex> lock(context->timelinePoolMutex);
+            context->timelinePool.push_back(timeline->semaphore);
+        }
+        else {
+            //retired work and callbacks might still reference the semaphore
+            vulkan::reclaimSequences(*context, timeline->semaphore);
+            vulkan::removeCompletions(*context, timeline->semaphore);
+            vulkan::forgetSignals(*context, timeline->semaphore);
+            context->fnTable.vkDestroySemaphore(
+                context->device, timeline->semaphore, nullptr);
+        }
     }
 }
 
+bool TimelineAwaiter::await_ready() const {
+    return value == 0 || timeline.getValue() >= value;
+}
+
+void TimelineAwaiter::await_suspend(std::coroutine_handle<> handle) const {
+    timeline.onValue(value, [handle, executor = executor]() {
+        if (executor)
+            executor(handle);
+        else
+            handle.resume();
+    });
+}
+
+TimelineAwaiter::TimelineAwaiter(
+    const Timeline& timeline, uint64_t value, Executor executor)
+    : timeline(timeline)
+    , value(value)
+    , executor(std::move(executor))
+{}
+
 /******************************** SUBMISSION *********************************/
 
+namespace {
+
+constexpr size_t toIndex(QueueType type) {
+    return static_cast<size_t>(type);
+}
+
+}
+
 struct SubmissionResources {
-    VkCommandPool pool;
-    std::vector<VkCommandBuffer> commands;
+    //command pools and their buffers per queue type; unused ones are null
+    std::array<VkCommandPool, vulkan::QueueTypeCount> pools = {};
+    std::array<std::vector<VkCommandBuffer>, vulkan::QueueTypeCount> commands = {};
     //Handle used to manage lifetime of implicit timeline
     std::unique_ptr<Timeline> exclusiveTimeline = nullptr;
+
+    bool empty() const noexcept {
+        return std::all_of(pools.begin(), pools.end(),
+            [](VkCommandPool pool) { return pool == VK_NULL_HANDLE; });
+    }
 };
 
 const Timeline& Submission::getTimeline() const { return timeline.get(); }
 uint64_t Submission::getFinalStep() const { return finalStep; }
 
 bool Submission::forgettable() const noexcept {
-    return !resources || resources->commands.empty();
+    //exclusive timelines must outlive the work signaling them, but are
+    //retired together with the command pools
+    return !resources ||
+        (resources->empty() && !resources->exclusiveTimeline);
 }
 
 void Submission::wait() const {
@@ -212,6 +492,19 @@ void Submission::wait() const {
 bool Submission::wait(uint64_t timeout) const {
     return (finalStep == 0 || timeline.get().waitValue(finalStep, timeout));
 }
+TimelineAwaiter Submission::awaitFinished(Executor executor) const {
+    return TimelineAwaiter(timeline.get(), finalStep, std::move(executor));
+}
+TimelineAwaiter Submission::operator co_await() const {
+    return awaitFinished();
+}
+void Submission::onFinished(std::function<void()> callback) const {
+    //nothing to wait for
+    if (finalStep == 0)
+        callback();
+    else
+        timeline.get().onValue(finalStep, std::move(callback));
+}
 
 Submission::Submission(Submission&& other) noexcept
     : finalStep(other.finalStep)
@@ -237,26 +530,122 @@ Submission::Submission(const Timeline& timeline, uint64_t finalStep, std::unique
     , resources(std::move(resources))
 {}
 Submission::~Submission() {
-    //reset pool if there is one
-    if (!forgettable()) {
-        //ensure we're save to reset pool by waiting submission to finish
-        wait();
-
-        auto& context = timeline.get().getContext();
-        //free command buffers
-        context->fnTable.vkFreeCommandBuffers(
-            context->device,
-            resources->pool,
-            static_cast<uint32_t>(resources->commands.size()),
-            resources->commands.data());
-        //reset pool
-        vulkan::checkResult(context->fnTable.vkResetCommandPool(
-            context->device,
-            resources->pool,
-            VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT));
-        //return to context
-        context->sequencePool.push(resources->pool);
+    if (forgettable())
+        return;
+
+    //hand resources to the context, which recycles them once the work
+    //finished, so we do not have to wait here
+    auto& context = *timeline.get().getContext();
+    vulkan::RetiredSequence retired{
+        .semaphore = timeline.get().getTimeline().semaphore,
+        .value = finalStep,
+        .pools = resources->pools,
+        .commands = std::move(resources->commands)
+    };
+    if (resources->exclusiveTimeline)
+        retired.timeline = resources->exclusiveTimeline->releaseTimeline();
+    vulkan::retireSequence(context, std::move(retired));
+}
+
+/*********************************** WAIT ************************************/
+
+namespace {
+
+std::vector<TimelineValue> toTimelineValues(std::span<const Submission> submissions) {
+    std::vector<TimelineValue> values;
+    values.reserve(submissions.size());
+    for (auto& submission : submissions)
+        values.push_back({ submission.getTimeline(), submission.getFinalStep() });
+    return values;
+}
+
+//returns the index of the first reached value or values.size() if none
+size_t findReached(std::span<const TimelineValue> values) {
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (values[i].value == 0 || values[i].timeline.get().getValue() >= values[i].value)
+            return i;
     }
+    return values.size();
+}
+
+//waits on all values with a single call, returns false on timeout
+bool waitValues(std::span<const TimelineValue> values, bool any, uint64_t timeout) {
+    if (values.empty())
+        return true;
+
+    auto& context = values.front().timeline.get().getContext();
+    std::vector<VkSemaphore> semaphores;
+    std::vector<uint64_t> steps;
+    semaphores.reserve(values.size());
+    steps.reserve(values.size());
+    for (auto& value : values) {
+        if (value.timeline.get().getContext() != context)
+            throw std::logic_error("All timelines must have been created on the same context!");
+        semaphores.push_back(value.timeline.get().getTimeline().semaphore);
+        steps.push_back(value.value);
+    }
+
+    VkSemaphoreWaitInfo info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .flags = any ? VK_SEMAPHORE_WAIT_ANY_BIT : VkSemaphoreWaitFlags(0),
+        .semaphoreCount = static_cast<uint32_t>(semaphores.size()),
+        .pSemaphores = semaphores.data(),
+        .pValues = steps.data()
+    };
+    if (vulkan::spinWait(*context, semaphores, steps, any, timeout))
+        return true;
+    auto result = context->fnTable.vkWaitSemaphores(
+        context->device, &info, timeout);
+
+    switch (result) {
+    case VK_SUCCESS:
+        return true;
+    case VK_TIMEOUT:
+        return false;
+    default:
+        vulkan::checkResult(result); //will throw
+        return false;
+    }
+}
+
+}
+
+void waitAll(std::span<const TimelineValue> values) {
+    static_cast<void>(waitAll(values, UINT64_MAX));
+}
+bool waitAll(std::span<const TimelineValue> values, uint64_t timeout) {
+    return waitValues(values, false, timeout);
+}
+void waitAll(std::span<const Submission> submissions) {
+    static_cast<void>(waitAll(submissions, UINT64_MAX));
+}
+bool waitAll(std::span<const Submission> submissions, uint64_t timeout) {
+    return waitAll(toTimelineValues(submissions), timeout);
+}
+
+size_t waitAny(std::span<const TimelineValue> values) {
+    return *waitAny(values, UINT64_MAX);
+}
+std::optional<size_t> waitAny(std::span<const TimelineValue> values, uint64_t timeout) {
+    if (values.empty())
+        throw std::logic_error("Cannot wait for any of an empty list!");
+
+    //skip the driver if one already finished
+    auto index = findReached(values);
+    if (index < values.size())
+        return index;
+
+    if (!waitValues(values, true, timeout))
+        return std::nullopt;
+    index = findReached(values);
+    //timeline values only increase, so one must have been reached
+    return index < values.size() ? std::optional<size_t>(index) : std::nullopt;
+}
+size_t waitAny(std::span<const Submission> submissions) {
+    return *waitAny(submissions, UINT64_MAX);
+}
+std::optional<size_t> waitAny(std::span<const Submission> submissions, uint64_t timeout) {
+    return waitAny(toTimelineValues(submissions), timeout);
 }
 
 /********************************* SEQUENCE **********************************/
@@ -268,53 +657,156 @@ constexpr VkCommandBufferBeginInfo BeginInfo{
     .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
     .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
 };
+//templates resubmit their command buffers, possibly while still pending;
+//the timeline ensures they never actually run concurrently
+constexpr VkCommandBufferBeginInfo ReusableBeginInfo{
+    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+    .flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT
+};
 
 constexpr VkPipelineStageFlags EmptyStage =
     VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
 
-VkCommandPool fetchCommandPool(const vulkan::Context& context) {
-    //fetch used pool or create new
-    VkCommandPool pool;
-    if (context.sequencePool.empty()) {
-        //create new
-        VkCommandPoolCreateInfo info{
-            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-            .queueFamilyIndex = context.queueFamily
-        };
-        vulkan::checkResult(context.fnTable.vkCreateCommandPool(
-            context.device, &info, nullptr, &pool));
+//pooled timelines keep their value, thus work continues from there
+std::unique_ptr<Timeline> fetchTimeline(const ContextHandle& context) {
+    //lazily recycle finished work, which might return timelines
+    vulkan::reclaimSequences(*context);
+
+    //try to reuse a pooled timeline
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    {
+        std::lock_guard<std::mutex> lock(context->timelinePoolMutex);
+        if (!context->timelinePool.empty()) {
+            semaphore = context->timelinePool.back();
+            context->timelinePool.pop_back();
+        }
+    }
+
+    if (semaphore) {
+        return std::make_unique<Timeline>(context,
+            std::unique_ptr<vulkan::Timeline>(new vulkan::Timeline{ semaphore, true }));
     }
     else {
-        pool = context.sequencePool.front();
-        context.sequencePool.pop();
+        //none available -> create new one, which returns to the pool
+        auto timeline = std::make_unique<Timeline>(context);
+        timeline->getTimeline().pooled = true;
+        return timeline;
     }
-    return pool;
 }
 
+void returnSubmissionSlots(const vulkan::Context& context, uint32_t count) {
+    {
+        std::lock_guard<std::mutex> lock(context.submissionMutex);
+        context.submissionsInFlight -= count;
+    }
+    context.submissionCondition.notify_all();
+}
+
+//slots of the context's submission limit taken for the duration of a submit.
+//Slots not handed to a submission are returned on destruction.
+class SubmissionSlots {
+public:
+    //false if the limit is reached and the slots were not waited for
+    [[nodiscard]] bool acquired() const noexcept {
+        return !full;
+    }
+
+    //hands one slot to the submission, which returns it once finished
+    void release(const Submission& submission) {
+        if (count == 0)
+            return;
+        --count;
+        auto pContext = context;
+        submission.onFinished([pContext]() { returnSubmissionSlots(*pContext, 1); });
+    }
+
+    SubmissionSlots(const SubmissionSlots&) = delete;
+    SubmissionSlots& operator=(const SubmissionSlots&) = delete;
+
+    SubmissionSlots(const vulkan::Context& context, uint32_t amount, bool block)
+        : context(&context)
+    {
+        std::unique_lock<std::mutex> lock(context.submissionMutex);
+        auto available = [&context, amount]() {
+            //batches larger than the limit need an idle context
+            return context.submissionLimit == 0 || context.submissionsInFlight == 0 ||
+                context.submissionsInFlight + amount <= context.submissionLimit;
+        };
+        if (!block && !available()) {
+            full = true;
+            return;
+        }
+        context.submissionCondition.wait(lock, available);
+        if (context.submissionLimit != 0) {
+            context.submissionsInFlight += amount;
+            count = amount;
+        }
+    }
+    ~SubmissionSlots() {
+        if (count > 0)
+            returnSubmissionSlots(*context, count);
+    }
+
+private:
+    const vulkan::Context* context;
+    uint32_t count = 0;
+    bool full = false;
+};
+
+}
+
+void setSubmissionLimit(const ContextHandle& context, uint32_t limit) {
+    {
+        std::lock_guard<std::mutex> lock(context->submissionMutex);
+        context->submissionLimit = limit;
+    }
+    //a larger limit might free waiting producers
+    context->submissionCondition.notify_all();
+}
+uint32_t getSubmissionLimit(const ContextHandle& context) {
+    std::lock_guard<std::mutex> lock(context->submissionMutex);
+    return context->submissionLimit;
+}
+uint32_t getSubmissionsInFlight(const ContextHandle& context) {
+    std::lock_guard<std::mutex> lock(context->submissionMutex);
+    return context->submissionsInFlight;
 }
 
 struct SequenceBuilder::pImp {
-    //for recording commands
-    VkCommandPool pool;
+    //for recording commands; pools are fetched lazily per queue type
+    std::array<VkCommandPool, vulkan::QueueTypeCount> pools = {};
     vulkan::Command recordingCmd = {};
-    std::vector<VkCommandBuffer> recordedBuffers = {};
+    std::array<std::vector<VkCommandBuffer>, vulkan::QueueTypeCount> recordedBuffers = {};
+
+    //queue used for new steps and queue of each recorded step
+    QueueType currentQueue = QueueType::MAIN;
+    std::vector<QueueType> stepQueues = {};
+
+    //tracks hazards within the recording command buffer if enabled
+    bool trackHazards = false;
+    vulkan::HazardTracker tracker = {};
 
     void finishRecording() {
         //any buffer to finish?
         if (!recordingCmd.buffer)
             return;
 
+        //make tracked writes visible to the host
+        if (recordingCmd.tracker)
+            tracker.finish(context, recordingCmd);
+
         //end recording
         vulkan::checkResult(context.fnTable.vkEndCommandBuffer(
             recordingCmd.buffer));
         commandBuffers.push_back(recordingCmd.buffer);
-        recordedBuffers.push_back(recordingCmd.buffer);
+        recordedBuffers[toIndex(stepQueues.back())].push_back(recordingCmd.buffer);
         waitStages.back() |= recordingCmd.stage;
         //reset recording command buffer
         recordingCmd = {};
     }
 
-    std::vector<VkPipelineStageFlags> waitStages = {};
+    //stages used by each step's commands
+    std::vector<VkPipelineStageFlags2KHR> waitStages = {};
     std::vector<VkCommandBuffer> commandBuffers = {};
 
     std::vector<uint64_t> waitValues = {};
@@ -325,6 +817,41 @@ struct SequenceBuilder::pImp {
     std::vector<VkTimelineSemaphoreSubmitInfo> timelineInfos = {};
     //the value to wait for in the next batch
     uint64_t currentValue = 0;
+    //the value the first step waits for
+    uint64_t startValue = 0;
+
+    //filled by prepare(); legacy submits use the vectors above instead
+    std::vector<VkSemaphoreSubmitInfoKHR> waitInfos = {};
+    std::vector<VkSemaphoreSubmitInfoKHR> signalInfos = {};
+    std::vector<VkCommandBufferSubmitInfoKHR> cmdInfos = {};
+    std::vector<VkSubmitInfo2KHR> submitInfos2 = {};
+    //wait stages duplicated to match the semaphores for legacy submits
+    std::vector<VkPipelineStageFlags> semaphoreStages = {};
+
+    //whether command buffers are recorded to be submitted multiple times
+    bool reusable = false;
+
+    //functions run on the host between steps; each waits on and signals
+    //our own timeline
+    struct HostStep {
+        uint64_t waitValue;
+        uint64_t signalValue;
+        std::function<void()> callback;
+    };
+    std::vector<HostStep> hostSteps = {};
+
+    //builds the final submit infos; recording must have finished
+    void prepare();
+    //submits the prepared infos to their queues
+    void submit() const;
+    //hands the resources of submitted work over to a Submission
+    Submission release();
+    //issues the recorded work handing it one of the slots
+    Submission submitWork(SubmissionSlots& slots);
+    //shifts all values of our own timeline by the given amount
+    void offset(uint64_t delta);
+    //registers the host steps once their values are submitted
+    void scheduleHostSteps() const;
 
     //Handle to manage lifetime of implicit timeline
     std::unique_ptr<Timeline> exclusiveTimeline;
@@ -334,21 +861,22 @@ struct SequenceBuilder::pImp {
     const vulkan::Context& context;
 
     pImp(Timeline& timeline, uint64_t value)
-        : pool(fetchCommandPool(*timeline.getContext()))
-        , currentValue(value)
+        : currentValue(value)
+        , startValue(value)
         , exclusiveTimeline(nullptr)
         , timeline(timeline)
         , semaphore(timeline.getTimeline().semaphore)
         , context(*timeline.getContext())
     {}
 
-    pImp(ContextHandle context)
-        : pool(fetchCommandPool(*context))
-        , exclusiveTimeline(std::make_unique<Timeline>(std::move(context)))
+    pImp(const ContextHandle& context)
+        : exclusiveTimeline(fetchTimeline(context))
         , timeline(*exclusiveTimeline)
         , semaphore(exclusiveTimeline->getTimeline().semaphore)
         , context(*timeline.getContext())
-    {}
+    {
+        currentValue = startValue = timeline.getValue();
+    }
 };
 
 SequenceBuilder::operator bool() const {
@@ -361,17 +889,27 @@ SequenceBuilder& SequenceBuilder::And(const Command& command) & {
 
     //Check if we already started a command buffer
     if (!_pImp->recordingCmd.buffer) {
+        //fetch pool of the step's queue if not done yet
+        auto queue = _pImp->stepQueues.back();
+        auto& pool = _pImp->pools[toIndex(queue)];
+        if (!pool)
+            pool = vulkan::fetchSequencePool(_pImp->context, queue);
+
         //allocate and start a new command buffer
         VkCommandBufferAllocateInfo allocInfo{
             .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-            .commandPool = _pImp->pool,
+            .commandPool = pool,
             .commandBufferCount = 1
         };
         vulkan::checkResult(_pImp->context.fnTable.vkAllocateCommandBuffers(
             _pImp->context.device, &allocInfo, &_pImp->recordingCmd.buffer));
         //start recording
         vulkan::checkResult(_pImp->context.fnTable.vkBeginCommandBuffer(
-            _pImp->recordingCmd.buffer, &BeginInfo));
+            _pImp->recordingCmd.buffer,
+            _pImp->reusable ? &ReusableBeginInfo : &BeginInfo));
+        if (_pImp->trackHazards)
+            _pImp->recordingCmd.tracker = &_pImp->tracker;
+        _pImp->recordingCmd.queueFlags = _pImp->context.queues[toIndex(queue)].flags;
 
         //mark submission
         _pImp->submitInfos.back().commandBufferCount += 1;
@@ -387,6 +925,14 @@ SequenceBuilder& SequenceBuilder::And(const Subroutine& subroutine) & {
     if (!*this)
         throw std::runtime_error("SequenceBuilder has already finished!");
 
+    //subroutines are allocated for the main queue's family
+    auto queue = _pImp->stepQueues.back();
+    if (_pImp->context.queues[toIndex(queue)].family != _pImp->context.queueFamily)
+        throw std::logic_error("Subroutines can only run on queues of the main queue family!");
+    //reusable sequences may resubmit while still pending
+    if (_pImp->reusable && !subroutine.simultaneousUse())
+        throw std::logic_error("Reusable sequences can only contain subroutines with simultaneous use!");
+
     //add command buffer
     auto& cmd = subroutine.getCommandBuffer();
     _pImp->commandBuffers.push_back(cmd.buffer);
@@ -424,6 +970,7 @@ SequenceBuilder& SequenceBuilder::NextStep() & {
     _pImp->signalValues.push_back(_pImp->currentValue);
     _pImp->signalSemaphores.push_back(_pImp->semaphore);
     _pImp->waitStages.push_back(0);
+    _pImp->stepQueues.push_back(_pImp->currentQueue);
 
     return *this;
 }
@@ -440,6 +987,33 @@ SequenceBuilder& SequenceBuilder::Then(const Subroutine& subroutine) & {
     return *this;
 }
 
+SequenceBuilder& SequenceBuilder::OnQueue(QueueType queue) & {
+    if (!*this)
+        throw std::runtime_error("SequenceBuilder has already finished!");
+
+    //check if we have an open submission
+    if (_pImp->submitInfos.back().commandBufferCount > 0)
+        NextStep();
+
+    //update current and all following steps
+    _pImp->currentQueue = queue;
+    _pImp->stepQueues.back() = queue;
+
+    return *this;
+}
+
+SequenceBuilder& SequenceBuilder::TrackHazards() & {
+    if (!*this)
+        throw std::runtime_error("SequenceBuilder has already finished!");
+
+    //takes effect immediately if there is an open command buffer
+    _pImp->trackHazards = true;
+    if (_pImp->recordingCmd.buffer)
+        _pImp->recordingCmd.tracker = &_pImp->tracker;
+
+    return *this;
+}
+
 SequenceBuilder& SequenceBuilder::WaitFor(uint64_t value) & {
     if (!*this)
         throw std::runtime_error("SequenceBuilder has already finished!");
@@ -486,6 +1060,27 @@ SequenceBuilder& SequenceBuilder::WaitFor(const Timeline& timeline, uint64_t val
     return *this;
 }
 
+SequenceBuilder& SequenceBuilder::ThenHost(std::function<void()> callback) & {
+    if (!*this)
+        throw std::runtime_error("SequenceBuilder has already finished!");
+    if (!callback)
+        throw std::logic_error("Host steps require a function to run!");
+
+    //the host waits on the current step even if it is empty
+    _pImp->finishRecording();
+    _pImp->hostSteps.push_back({
+        .waitValue = _pImp->currentValue,
+        .signalValue = _pImp->currentValue + 1,
+        .callback = std::move(callback)
+    });
+    _pImp->currentValue += 1;
+
+    //following work waits on the host's signal
+    NextStep();
+
+    return *this;
+}
+
 SequenceBuilder SequenceBuilder::And(const Command& command) && {
     static_cast<SequenceBuilder&>(*this).And(command);
     return std::move(*this);
@@ -506,6 +1101,18 @@ SequenceBuilder SequenceBuilder::Then(const Subroutine& subroutine) && {
     static_cast<SequenceBuilder&>(*this).Then(subroutine);
     return std::move(*this);
 }
+SequenceBuilder SequenceBuilder::ThenHost(std::function<void()> callback) && {
+    static_cast<SequenceBuilder&>(*this).ThenHost(std::move(callback));
+    return std::move(*this);
+}
+SequenceBuilder SequenceBuilder::OnQueue(QueueType queue) && {
+    static_cast<SequenceBuilder&>(*this).OnQueue(queue);
+    return std::move(*this);
+}
+SequenceBuilder SequenceBuilder::TrackHazards() && {
+    static_cast<SequenceBuilder&>(*this).TrackHazards();
+    return std::move(*this);
+}
 SequenceBuilder SequenceBuilder::WaitFor(uint64_t value) && {
     static_cast<SequenceBuilder&>(*this).WaitFor(value);
     return std::move(*this);
@@ -515,83 +1122,328 @@ SequenceBuilder SequenceBuilder::WaitFor(const Timeline& timeline, uint64_t valu
     return std::move(*this);
 }
 
+void SequenceBuilder::pImp::prepare() {
+    auto submitCount = submitInfos.size();
+
+    if (context.synchronization2) {
+        //synchronization2 supports per semaphore stage masks
+        // -> steps only wait and signal in the stages they actually use
+        waitInfos.resize(waitValues.size());
+        signalInfos.resize(submitCount);
+        cmdInfos.resize(commandBuffers.size());
+        submitInfos2.resize(submitCount);
+
+        auto pWait = waitInfos.data();
+        auto pCmd = cmdInfos.data();
+        auto iWait = 0u, iCmd = 0u;
+        for (auto i = 0u; i < submitCount; ++i) {
+            auto& info = submitInfos[i];
+            //empty steps have no stages -> use all
+            auto stages = waitStages[i];
+            if (stages == 0)
+                stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR;
+
+            for (auto j = 0u; j < info.waitSemaphoreCount; ++j, ++iWait) {
+                waitInfos[iWait] = VkSemaphoreSubmitInfoKHR{
+                    .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR,
+                    .semaphore = waitSemaphores[iWait],
+                    .value = waitValues[iWait],
+                    .stageMask = stages
+                };
+            }
+            for (auto j = 0u; j < info.commandBufferCount; ++j, ++iCmd) {
+                cmdInfos[iCmd] = VkCommandBufferSubmitInfoKHR{
+                    .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO_KHR,
+                    .commandBuffer = commandBuffers[iCmd]
+                };
+            }
+            signalInfos[i] = VkSemaphoreSubmitInfoKHR{
+                .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR,
+                .semaphore = semaphore,
+                .value = signalValues[i],
+                .stageMask = stages
+            };
+
+            submitInfos2[i] = VkSubmitInfo2KHR{
+                .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR,
+                .waitSemaphoreInfoCount = info.waitSemaphoreCount,
+                .pWaitSemaphoreInfos = pWait,
+                .commandBufferInfoCount = info.commandBufferCount,
+                .pCommandBufferInfos = pCmd,
+                .signalSemaphoreInfoCount = 1,
+                .pSignalSemaphoreInfos = &signalInfos[i]
+            };
+            pWait += info.waitSemaphoreCount;
+            pCmd += info.commandBufferCount;
+        }
+    }
+    else {
+        //update submit infos
+        //since the vectors may change their memory location as they grow
+        //we can only now fill in the pointers in the submission infos
+
+        //also duplicate waitStages to match size of semaphores
+        semaphoreStages.resize(waitValues.size());
+
+        auto pWaitStage = semaphoreStages.data();
+        auto pWaitValue = waitValues.data();
+        auto pWaitSemaphore = waitSemaphores.data();
+        auto pSignalValue = signalValues.data();
+        auto pCmd = commandBuffers.data();
+
+        auto pTimeline = timelineInfos.data();
+        auto pSubmit = submitInfos.data();
+
+        for (auto i = 0u; i < submitCount; ++i, ++pTimeline, ++pSubmit) {
+            //edge case: empty submission can't have waitStage=0
+            //  -> use TOP_OF_PIPE
+            auto stage = vulkan::toLegacyStage(waitStages[i]);
+            if (stage == 0)
+                stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            //duplicate wait stages
+            std::fill_n(pWaitStage, pSubmit->waitSemaphoreCount, stage);
+
+            //fix timeline info
+            pTimeline->pSignalSemaphoreValues = pSignalValue;
+            pTimeline->pWaitSemaphoreValues = pWaitValue;
+            pSignalValue += pTimeline->signalSemaphoreValueCount;
+            pWaitValue += pTimeline->waitSemaphoreValueCount;
+
+            //fix submit info
+            pSubmit->pNext = pTimeline;
+            pSubmit->pCommandBuffers = pCmd;
+            pSubmit->pWaitSemaphores = pWaitSemaphore;
+            pSubmit->pWaitDstStageMask = pWaitStage;
+            pCmd += pSubmit->commandBufferCount;
+            pWaitSemaphore += pSubmit->waitSemaphoreCount;
+            pWaitStage += pSubmit->waitSemaphoreCount;
+        }
+    }
+}
+
+void SequenceBuilder::pImp::submit() const {
+    //submit consecutive steps on the same queue as one batch
+    //steps on different queues are synchronized via the timeline
+    auto submitCount = submitInfos.size();
+    for (size_t first = 0; first < submitCount;) {
+        auto queue = stepQueues[first];
+        auto last = first + 1;
+        while (last < submitCount &&
+            context.queues[toIndex(stepQueues[last])].queue ==
+            context.queues[toIndex(queue)].queue)
+        {
+            ++last;
+        }
+
+        auto count = static_cast<uint32_t>(last - first);
+        if (context.synchronization2) {
+            vulkan::queueSubmit2(context, queue, count,
+                submitInfos2.data() + first, nullptr);
+        }
+        else {
+            vulkan::queueSubmit(context, queue, count,
+                submitInfos.data() + first, nullptr);
+        }
+        first = last;
+    }
+}
+
+void SequenceBuilder::pImp::offset(uint64_t delta) {
+    //waits on foreign timelines stay as they are
+    for (auto i = 0u; i < waitValues.size(); ++i) {
+        if (waitSemaphores[i] != semaphore)
+            continue;
+        waitValues[i] += delta;
+        if (!waitInfos.empty())
+            waitInfos[i].value += delta;
+    }
+    for (auto i = 0u; i < signalValues.size(); ++i) {
+        signalValues[i] += delta;
+        if (!signalInfos.empty())
+            signalInfos[i].value += delta;
+    }
+    for (auto& step : hostSteps) {
+        step.waitValue += delta;
+        step.signalValue += delta;
+    }
+    startValue += delta;
+    currentValue += delta;
+}
+
+void SequenceBuilder::pImp::scheduleHostSteps() const {
+    if (hostSteps.empty())
+        return;
+
+    //the completion service is owned by the context, thus must not keep it
+    //alive itself
+    std::weak_ptr<vulkan::Context> weakContext = timeline.getContext();
+    for (auto& step : hostSteps) {
+        vulkan::addCompletion(context, semaphore, step.waitValue,
+            [weakContext, semaphore = semaphore, value = step.signalValue,
+                callback = step.callback]()
+            {
+                auto handle = weakContext.lock();
+                if (!handle)
+                    return;
+                //keep the completion thread free for other callbacks
+                static_cast<void>(vulkan::WorkerPool::get().submit(
+                    [handle = std::move(handle), semaphore, value, callback]() {
+                        //a failing step must not dead lock the sequence
+                        try {
+                            callback();
+                        }
+                        catch (...) {}
+                        VkSemaphoreSignalInfo info{
+                            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO,
+                            .semaphore = semaphore,
+                            .value = value
+                        };
+                        static_cast<void>(handle->fnTable.vkSignalSemaphore(
+                            handle->device, &info));
+                    }));
+            });
+    }
+}
+
 Submission SequenceBuilder::Submit() {
     if (!*this)
         throw std::runtime_error("SequenceBuilder has already finished!");
+    SubmissionSlots slots(_pImp->context, 1, true);
+    auto submission = _pImp->submitWork(slots);
+    //free _pImp to prevent multiple submission
+    _pImp.reset();
+    return submission;
+}
+
+std::optional<Submission> SequenceBuilder::TrySubmit() {
+    if (!*this)
+        throw std::runtime_error("SequenceBuilder has already finished!");
+    SubmissionSlots slots(_pImp->context, 1, false);
+    if (!slots.acquired())
+        return std::nullopt;
+    auto submission = _pImp->submitWork(slots);
+    //free _pImp to prevent multiple submission
+    _pImp.reset();
+    return submission;
+}
+
+Submission SequenceBuilder::pImp::submitWork(SubmissionSlots& slots) {
+    vulkan::TraceScope trace(context, "Submit", "submit");
 
     //finish previous command buffer
-    _pImp->finishRecording();
+    finishRecording();
+    //issue work
+    prepare();
+    submit();
+    scheduleHostSteps();
+
+    auto submission = release();
+    slots.release(submission);
+    return submission;
+}
 
-    //update submit infos
-    //since the vectors may change their memory location as they grow
-    //we can only now fill in the pointers in the submission infos
-
-    //also duplicate waitStages to match size of semaphores
-    auto semaphoreCount = _pImp->waitValues.size();
-    std::vector<VkPipelineStageFlags> waitStages(semaphoreCount);
-
-    auto pWaitStage = waitStages.data();
-    auto pWaitValue = _pImp->waitValues.data();
-    auto pWaitSemaphore = _pImp->waitSemaphores.data();
-    auto pSignalValue = _pImp->signalValues.data();
-    auto pCmd = _pImp->commandBuffers.data();
-
-    auto pTimeline = _pImp->timelineInfos.data();
-    auto pSubmit = _pImp->submitInfos.data();
-
-    auto submitCount = _pImp->submitInfos.size();
-    for (auto i = 0u; i < submitCount; ++i, ++pTimeline, ++pSubmit) {
-        //edge case: empty submission can't have waitStage=0
-        //  -> use TOP_OF_PIPE
-        if (_pImp->waitStages[i] == 0)
-            _pImp->waitStages[i] = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        //duplicate wait stages
-        std::fill_n(pWaitStage, pSubmit->waitSemaphoreCount, _pImp->waitStages[i]);
-
-        //fix timeline info
-        pTimeline->pSignalSemaphoreValues = pSignalValue;
-        pTimeline->pWaitSemaphoreValues = pWaitValue;
-        pSignalValue += pTimeline->signalSemaphoreValueCount;
-        pWaitValue += pTimeline->waitSemaphoreValueCount;
-
-        //fix submit info
-        pSubmit->pNext = pTimeline;
-        pSubmit->pCommandBuffers = pCmd;
-        pSubmit->pWaitSemaphores = pWaitSemaphore;
-        pSubmit->pWaitDstStageMask = pWaitStage;
-        pCmd += pSubmit->commandBufferCount;
-        pWaitSemaphore += pSubmit->waitSemaphoreCount;
-        pWaitStage += pSubmit->waitSemaphoreCount;
-    }
-
-    //submit
-    vulkan::checkResult(_pImp->context.fnTable.vkQueueSubmit(
-        _pImp->context.queue, submitCount, _pImp->submitInfos.data(), nullptr));
-
-    //if there are no recorded command buffers we can already give the pool back
-    if (_pImp->recordedBuffers.empty()) {
-        _pImp->context.sequencePool.push(_pImp->pool);
-        _pImp->pool = VK_NULL_HANDLE;
-    }
-
-    //prepare submission
-    auto resource = std::unique_ptr<SubmissionResources>(
-        new SubmissionResources{
-            _pImp->pool,
-            std::move(_pImp->recordedBuffers),
-            std::move(_pImp->exclusiveTimeline)
+Submission SequenceBuilder::pImp::release() {
+    auto resource = std::unique_ptr<SubmissionResources>(new SubmissionResources{});
+    for (auto i = 0u; i < vulkan::QueueTypeCount; ++i) {
+        auto pool = pools[i];
+        if (!pool)
+            continue;
+        //if there are no recorded command buffers we can already give the pool back
+        if (recordedBuffers[i].empty()) {
+            vulkan::returnSequencePool(context, static_cast<QueueType>(i), pool, {});
         }
-    );
-    auto& timeline = _pImp->timeline;
-    auto finalStep = _pImp->currentValue;
-    //free _pImp to prevent multiple submission
-    _pImp.reset();
+        else {
+            resource->pools[i] = pool;
+            resource->commands[i] = std::move(recordedBuffers[i]);
+        }
+        pools[i] = VK_NULL_HANDLE;
+    }
+    resource->exclusiveTimeline = std::move(exclusiveTimeline);
     //build and return submission responsible for the resources lifetime
     return Submission{
-        timeline, finalStep, std::move(resource)
+        timeline, currentValue, std::move(resource)
     };
 }
 
+std::vector<Submission> submitBatch(std::span<SequenceBuilder> sequences) {
+    std::vector<Submission> submissions;
+    if (sequences.empty())
+        return submissions;
+    for (auto& sequence : sequences) {
+        if (!sequence)
+            throw std::runtime_error("SequenceBuilder has already finished!");
+    }
+    auto& context = sequences.front()._pImp->context;
+    for (auto& sequence : sequences) {
+        if (&sequence._pImp->context != &context)
+            throw std::logic_error("Cannot batch sequences of different contexts!");
+    }
+    SubmissionSlots slots(context, static_cast<uint32_t>(sequences.size()), true);
+    vulkan::TraceScope trace(context, "SubmitBatch", "submit");
+
+    //gather all steps per queue while keeping their order; queue types
+    //falling back to the same queue share a batch
+    std::array<std::vector<VkSubmitInfo>, vulkan::QueueTypeCount> infos = {};
+    std::array<std::vector<VkSubmitInfo2KHR>, vulkan::QueueTypeCount> infos2 = {};
+    auto batchIndex = [&context](QueueType queue) {
+        auto i = 0u;
+        while (context.queues[i].queue != context.queues[toIndex(queue)].queue)
+            ++i;
+        return i;
+    };
+    for (auto& sequence : sequences) {
+        auto& imp = *sequence._pImp;
+        imp.finishRecording();
+        imp.prepare();
+        for (auto i = 0u; i < imp.submitInfos.size(); ++i) {
+            auto batch = batchIndex(imp.stepQueues[i]);
+            if (context.synchronization2)
+                infos2[batch].push_back(imp.submitInfos2[i]);
+            else
+                infos[batch].push_back(imp.submitInfos[i]);
+        }
+    }
+
+    //issue work; steps on different queues are synchronized via timelines,
+    //which allow waits to be submitted before their signals
+    for (auto i = 0u; i < vulkan::QueueTypeCount; ++i) {
+        auto queue = static_cast<QueueType>(i);
+        if (!infos2[i].empty()) {
+            vulkan::queueSubmit2(context, queue,
+                static_cast<uint32_t>(infos2[i].size()), infos2[i].data(), nullptr);
+        }
+        if (!infos[i].empty()) {
+            vulkan::queueSubmit(context, queue,
+                static_cast<uint32_t>(infos[i].size()), infos[i].data(), nullptr);
+        }
+    }
+
+    submissions.reserve(sequences.size());
+    for (auto& sequence : sequences) {
+        sequence._pImp->scheduleHostSteps();
+        submissions.push_back(sequence._pImp->release());
+        slots.release(submissions.back());
+        //free _pImp to prevent multiple submission
+        sequence._pImp.reset();
+    }
+    return submissions;
+}
+
+SequenceTemplate SequenceBuilder::Freeze() {
+    if (!*this)
+        throw std::runtime_error("SequenceBuilder has already finished!");
+    if (!_pImp->reusable)
+        throw std::logic_error("Only reusable sequences can be frozen!");
+
+    //finish previous command buffer
+    _pImp->finishRecording();
+    //the infos stay valid as the template never alters the recorded steps
+    _pImp->prepare();
+
+    //hand over to template; also prevents further recording
+    return SequenceTemplate(std::move(_pImp));
+}
+
 std::string SequenceBuilder::printWaitGraph() const {
     if (!*this)
         throw std::runtime_error("SequenceBuilder has already finished!");
@@ -616,43 +1468,763 @@ std::string SequenceBuilder::printWaitGraph() const {
     return out.str();
 }
 
+WaitGraph SequenceBuilder::getWaitGraph() const {
+    if (!*this)
+        throw std::runtime_error("SequenceBuilder has already finished!");
+
+    //same conversion as Timeline::getId()
+    auto toId = [](VkSemaphore semaphore) {
+        return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(semaphore));
+    };
+
+    WaitGraph graph;
+    auto n = _pImp->submitInfos.size();
+    graph.steps.reserve(n);
+    auto pWait = _pImp->waitValues.data();
+    auto pWaitSem = _pImp->waitSemaphores.data();
+    for (auto i = 0u; i < n; ++i) {
+        WaitGraphStep step{
+            .queue = _pImp->stepQueues[i],
+            .commandBufferCount = _pImp->submitInfos[i].commandBufferCount,
+            .signal = { toId(_pImp->signalSemaphores[i]), _pImp->signalValues[i] }
+        };
+        auto nWaits = _pImp->timelineInfos[i].waitSemaphoreValueCount;
+        step.waits.reserve(nWaits);
+        for (auto ii = 0u; ii < nWaits; ++ii)
+            step.waits.push_back({ toId(*(pWaitSem++)), *(pWait++) });
+        graph.steps.push_back(std::move(step));
+    }
+    return graph;
+}
+
 SequenceBuilder::SequenceBuilder(SequenceBuilder&& other) noexcept = default;
 SequenceBuilder& SequenceBuilder::operator=(SequenceBuilder&& other) noexcept = default;
 
-SequenceBuilder::SequenceBuilder(Timeline& timeline, uint64_t startValue)
+SequenceBuilder::SequenceBuilder(Timeline& timeline, uint64_t startValue, bool reusable)
     : _pImp(new pImp(timeline, startValue))
 {
     //init pImp
+    _pImp->reusable = reusable;
     NextStep();
 }
-SequenceBuilder::SequenceBuilder(ContextHandle context)
+SequenceBuilder::SequenceBuilder(ContextHandle context, bool reusable)
     : _pImp(new pImp(context))
 {
     //init pImp
+    _pImp->reusable = reusable;
     NextStep();
 }
 SequenceBuilder::~SequenceBuilder() {
     if (_pImp) {
-        //free recorded command buffers
-        if (!_pImp->recordedBuffers.empty()) {
-            _pImp->context.fnTable.vkFreeCommandBuffers(
-                _pImp->context.device, _pImp->pool,
-                static_cast<uint32_t>(_pImp->recordedBuffers.size()),
-                _pImp->recordedBuffers.data());
-        }
-        //free currently recording command buffer
+        //currently recording command buffer belongs to the last step
         if (_pImp->recordingCmd.buffer) {
-            _pImp->context.fnTable.vkFreeCommandBuffers(
-                _pImp->context.device, _pImp->pool,
-                1, &_pImp->recordingCmd.buffer);
+            _pImp->recordedBuffers[toIndex(_pImp->stepQueues.back())]
+                .push_back(_pImp->recordingCmd.buffer);
+        }
+        //free command buffers and return pools to context
+        for (auto i = 0u; i < vulkan::QueueTypeCount; ++i) {
+            if (_pImp->pools[i]) {
+                vulkan::returnSequencePool(_pImp->context, static_cast<QueueType>(i),
+                    _pImp->pools[i], _pImp->recordedBuffers[i]);
+            }
+        }
+    }
+}
+
+/******************************** WAIT GRAPH **********************************/
+
+namespace {
+
+constexpr std::array<const char*, vulkan::QueueTypeCount> QueueNames = {
+    "MAIN", "TRANSFER", "COMPUTE"
+};
+
+//calls func with the index of each step before the given one, which signals
+//a value satisfying the wait
+template<class Func>
+void forEachSignaling(const WaitGraph& graph, size_t step,
+    const WaitGraphValue& wait, Func&& func)
+{
+    for (size_t j = 0; j < step; ++j) {
+        auto& signal = graph.steps[j].signal;
+        if (signal.timeline == wait.timeline && signal.value >= wait.value)
+            func(j);
+    }
+}
+
+}
+
+std::string printDot(const WaitGraph& graph) {
+    std::stringstream out;
+    out << "digraph WaitGraph {\n";
+    for (size_t i = 0; i < graph.steps.size(); ++i) {
+        auto& step = graph.steps[i];
+        out << "    step" << i << " [label=\"Step " << i << "\\n"
+            << QueueNames[toIndex(step.queue)] << "\\n("
+            << step.commandBufferCount << ")\"];\n";
+
+        for (auto& wait : step.waits) {
+            //the lowest value satisfying the wait is reached first
+            std::optional<size_t> source;
+            forEachSignaling(graph, i, wait, [&](size_t j) {
+                if (!source || graph.steps[j].signal.value < graph.steps[*source].signal.value)
+                    source = j;
+            });
+
+            if (source) {
+                out << "    step" << *source << " -> step" << i;
+            }
+            else {
+                //value is signaled outside of this graph
+                out << "    t" << wait.timeline << '_' << wait.value
+                    << " [shape=box, label=\"" << wait.timeline << '(' << wait.value << ")\"];\n"
+                    << "    t" << wait.timeline << '_' << wait.value << " -> step" << i;
+            }
+            out << " [label=\"" << wait.timeline << '(' << wait.value << ")\"];\n";
+        }
+    }
+    out << "}\n";
+    return out.str();
+}
+
+std::string printJson(const WaitGraph& graph) {
+    auto printValue = [](std::stringstream& out, const WaitGraphValue& value) {
+        out << "{\"timeline\":" << value.timeline << ",\"value\":" << value.value << '}';
+    };
+
+    std::stringstream out;
+    out << "{\"steps\":[";
+    for (size_t i = 0; i < graph.steps.size(); ++i) {
+        auto& step = graph.steps[i];
+        if (i > 0) out << ',';
+        out << "{\"queue\":\"" << QueueNames[toIndex(step.queue)] << '"'
+            << ",\"commandBufferCount\":" << step.commandBufferCount
+            << ",\"waits\":[";
+        for (size_t ii = 0; ii < step.waits.size(); ++ii) {
+            if (ii > 0) out << ',';
+            printValue(out, step.waits[ii]);
         }
-        //reset pool
-        vulkan::checkResult(_pImp->context.fnTable.vkResetCommandPool(
-            _pImp->context.device, _pImp->pool,
-            VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT));
-        //return pool to context
-        _pImp->context.sequencePool.push(_pImp->pool);
+        out << "],\"signal\":";
+        printValue(out, step.signal);
+        out << '}';
     }
+    out << "]}";
+    return out.str();
+}
+
+WaitGraphTiming analyzeWaitGraph(
+    const WaitGraph& graph, std::span<const double> durations)
+{
+    auto n = graph.steps.size();
+    if (durations.size() != n)
+        throw std::logic_error("Number of durations must match the number of steps!");
+    for (auto duration : durations) {
+        //also catches NaN from timestamps not yet available
+        if (!(duration >= 0.0))
+            throw std::logic_error("Durations must be non-negative numbers!");
+    }
+
+    WaitGraphTiming timing{
+        .start = std::vector<double>(n),
+        .finish = std::vector<double>(n),
+        .idle = std::vector<double>(n),
+        .criticalPath = {},
+        .duration = 0.0
+    };
+    //step that determined the start of each step
+    std::vector<std::optional<size_t>> limiting(n);
+    std::array<std::optional<size_t>, vulkan::QueueTypeCount> lastOnQueue = {};
+    for (size_t i = 0; i < n; ++i) {
+        auto& step = graph.steps[i];
+
+        //steps on the same queue run in submission order
+        auto& last = lastOnQueue[toIndex(step.queue)];
+        double queueFree = last ? timing.finish[*last] : 0.0;
+        double start = queueFree;
+        limiting[i] = last;
+
+        for (auto& wait : step.waits) {
+            //value is available once the first step signaling it finished
+            std::optional<size_t> source;
+            forEachSignaling(graph, i, wait, [&](size_t j) {
+                if (!source || timing.finish[j] < timing.finish[*source])
+                    source = j;
+            });
+            if (source && timing.finish[*source] > start) {
+                start = timing.finish[*source];
+                limiting[i] = source;
+            }
+        }
+
+        timing.start[i] = start;
+        timing.finish[i] = start + durations[i];
+        timing.idle[i] = start - queueFree;
+        last = i;
+    }
+
+    //walk back from the step finishing last
+    if (n > 0) {
+        auto it = std::max_element(timing.finish.begin(), timing.finish.end());
+        timing.duration = *it;
+        std::optional<size_t> current = static_cast<size_t>(it - timing.finish.begin());
+        while (current) {
+            timing.criticalPath.push_back(*current);
+            current = limiting[*current];
+        }
+        std::reverse(timing.criticalPath.begin(), timing.criticalPath.end());
+    }
+
+    return timing;
+}
+
+/***************************** SEQUENCE TEMPLATE ******************************/
+
+const Timeline& SequenceTemplate::getTimeline() const {
+    return _pImp->timeline;
+}
+uint64_t SequenceTemplate::getNextStartValue() const {
+    //continue where the previous submission stopped
+    return submitted ? _pImp->currentValue : _pImp->startValue;
+}
+
+Submission SequenceTemplate::Submit() {
+    return Submit(getNextStartValue());
+}
+Submission SequenceTemplate::Submit(uint64_t startValue) {
+    //waiting on an implicit timeline beyond its value would dead lock
+    if (_pImp->exclusiveTimeline && startValue != getNextStartValue())
+        throw std::logic_error("Sequence templates with an implicit timeline can not choose their start value!");
+    //previous submissions must have signaled before the next one starts
+    if (startValue < getNextStartValue() && submitted)
+        throw std::logic_error("Start value must not be lower than the final step of the previous submission!");
+
+    SubmissionSlots slots(_pImp->context, 1, true);
+    vulkan::TraceScope trace(_pImp->context, "SubmitTemplate", "submit");
+    //only the values change, everything else is reused
+    _pImp->offset(startValue - _pImp->startValue);
+    _pImp->submit();
+    _pImp->scheduleHostSteps();
+    submitted = true;
+
+    //template keeps the resources -> nothing to manage
+    Submission submission{ _pImp->timeline, _pImp->currentValue, nullptr };
+    slots.release(submission);
+    return submission;
+}
+
+SequenceTemplate::SequenceTemplate(SequenceTemplate&& other) noexcept
+    : _pImp(std::move(other._pImp))
+    , submitted(other.submitted)
+{}
+SequenceTemplate& SequenceTemplate::operator=(SequenceTemplate&& other) noexcept {
+    //previous resources are released by other's destructor
+    std::swap(_pImp, other._pImp);
+    std::swap(submitted, other.submitted);
+    return *this;
+}
+
+SequenceTemplate::SequenceTemplate(std::unique_ptr<SequenceBuilder::pImp> pImp)
+    : _pImp(std::move(pImp))
+    , submitted(false)
+{}
+SequenceTemplate::~SequenceTemplate() {
+    if (_pImp) {
+        //recycle resources once the last submission finished
+        vulkan::RetiredSequence retired{
+            .semaphore = _pImp->semaphore,
+            .value = submitted ? _pImp->currentValue : 0,
+            .pools = _pImp->pools,
+            .commands = std::move(_pImp->recordedBuffers)
+        };
+        if (_pImp->exclusiveTimeline)
+            retired.timeline = _pImp->exclusiveTimeline->releaseTimeline();
+        vulkan::retireSequence(_pImp->context, std::move(retired));
+    }
+}
+
+/******************************** TASK GRAPH **********************************/
+
+struct TaskGraph::pImp {
+    struct Task {
+        VkCommandBuffer buffer;
+        VkPipelineStageFlags2KHR stage;
+        QueueType queue;
+        std::vector<size_t> dependencies;
+    };
+    std::vector<Task> tasks = {};
+
+    //for recording commands; pools are fetched lazily per queue type
+    std::array<VkCommandPool, vulkan::QueueTypeCount> pools = {};
+    std::array<std::vector<VkCommandBuffer>, vulkan::QueueTypeCount> recordedBuffers = {};
+
+    //value of a lane's timeline relative to the end of the previous submission
+    struct Value {
+        size_t lane;
+        uint64_t value;
+    };
+    struct Step {
+        std::vector<Value> waits;
+        std::vector<VkCommandBuffer> buffers;
+        VkPipelineStageFlags2KHR stage;
+    };
+    //queues aliasing the same device queue share a lane
+    struct Lane {
+        QueueType queue;
+        std::unique_ptr<Timeline> timeline;
+        //value reached once the previous submission finished
+        uint64_t base;
+        //step i signals base + i + 1
+        std::vector<Step> steps;
+    };
+    std::vector<Lane> lanes = {};
+    //lane whose last step finishes the whole graph
+    size_t finalLane = 0;
+
+    bool finalized = false;
+    bool submitted = false;
+
+    //maps the tasks onto steps; called once before the first submission
+    void finalize();
+
+    ContextHandle contextHandle;
+    const vulkan::Context& context;
+
+    pImp(ContextHandle context)
+        : contextHandle(std::move(context))
+        , context(*contextHandle)
+    {}
+};
+
+void TaskGraph::pImp::finalize() {
+    if (finalized)
+        return;
+    if (tasks.empty())
+        throw std::logic_error("TaskGraph does not contain any tasks!");
+
+    //start over in case a previous attempt failed
+    lanes.clear();
+    finalLane = 0;
+
+    //assign lanes
+    auto taskCount = tasks.size();
+    std::vector<size_t> taskLanes(taskCount);
+    for (auto i = 0u; i < taskCount; ++i) {
+        auto queue = context.queues[toIndex(tasks[i].queue)].queue;
+        auto it = std::find_if(lanes.begin(), lanes.end(),
+            [this, queue](const Lane& lane) {
+                return context.queues[toIndex(lane.queue)].queue == queue;
+            });
+        if (it == lanes.end()) {
+            lanes.push_back(Lane{
+                .queue = tasks[i].queue,
+                .timeline = std::make_unique<Timeline>(contextHandle),
+                .base = 0
+            });
+            it = lanes.end() - 1;
+        }
+        taskLanes[i] = static_cast<size_t>(it - lanes.begin());
+        //prefer the main queue to finish the graph
+        if (tasks[i].queue == QueueType::MAIN)
+            finalLane = taskLanes[i];
+    }
+    auto laneCount = lanes.size();
+
+    //For each lane and step, the value of each lane known to be reached once
+    //the step finished. Signals on a queue include all work submitted earlier,
+    //thus this includes what previous steps on the same lane knew.
+    //Value 0 denotes the end of the previous submission, which every step
+    //depends on via the final lane.
+    std::vector<std::vector<std::vector<uint64_t>>> known(laneCount,
+        { std::vector<uint64_t>(laneCount, 0) });
+    //reduces the latest required value of each lane to the waits not
+    //already implied by another one and returns what they imply
+    auto reduce = [&](const std::vector<uint64_t>& required, std::vector<Value>& waits) {
+        std::vector<uint64_t> pre(laneCount, 0);
+        for (auto i = 0u; i < laneCount; ++i) {
+            if (required[i] == 0)
+                continue;
+            auto implied = false;
+            for (auto j = 0u; j < laneCount && !implied; ++j) {
+                implied = j != i && required[j] > 0 &&
+                    known[j][required[j]][i] >= required[i];
+            }
+            if (implied)
+                continue;
+
+            waits.push_back({ i, required[i] });
+            auto& k = known[i][required[i]];
+            std::transform(pre.begin(), pre.end(), k.begin(), pre.begin(),
+                [](uint64_t a, uint64_t b) { return std::max(a, b); });
+        }
+        //nothing to wait for -> wait for the previous submission
+        if (waits.empty())
+            waits.push_back({ finalLane, 0 });
+        return pre;
+    };
+    //finishes a step on the given lane
+    auto addStep = [&](size_t lane, Step step, std::vector<uint64_t> pre) {
+        auto& k = known[lane];
+        std::transform(pre.begin(), pre.end(), k.back().begin(), pre.begin(),
+            [](uint64_t a, uint64_t b) { return std::max(a, b); });
+        pre[lane] = k.size();
+        k.push_back(std::move(pre));
+        lanes[lane].steps.push_back(std::move(step));
+        return lanes[lane].steps.size();
+    };
+
+    //schedule in rounds: all tasks, whose dependencies are scheduled, run in
+    //the same step of their lane
+    std::vector<size_t> pending(taskCount);
+    std::vector<std::vector<size_t>> dependents(taskCount);
+    std::vector<size_t> ready;
+    for (auto i = 0u; i < taskCount; ++i) {
+        pending[i] = tasks[i].dependencies.size();
+        for (auto d : tasks[i].dependencies)
+            dependents[d].push_back(i);
+        if (pending[i] == 0)
+            ready.push_back(i);
+    }
+    std::vector<uint64_t> taskValues(taskCount, 0);
+    size_t scheduled = 0;
+    while (!ready.empty()) {
+        std::vector<std::vector<size_t>> laneTasks(laneCount);
+        for (auto t : ready)
+            laneTasks[taskLanes[t]].push_back(t);
+        ready.clear();
+
+        for (auto lane = 0u; lane < laneCount; ++lane) {
+            if (laneTasks[lane].empty())
+                continue;
+
+            Step step{ .stage = 0 };
+            std::vector<uint64_t> required(laneCount, 0);
+            for (auto t : laneTasks[lane]) {
+                step.buffers.push_back(tasks[t].buffer);
+                step.stage |= tasks[t].stage;
+                for (auto d : tasks[t].dependencies) {
+                    auto& r = required[taskLanes[d]];
+                    r = std::max(r, taskValues[d]);
+                }
+            }
+            auto pre = reduce(required, step.waits);
+            auto value = addStep(lane, std::move(step), std::move(pre));
+
+            for (auto t : laneTasks[lane]) {
+                taskValues[t] = value;
+                for (auto d : dependents[t]) {
+                    if (--pending[d] == 0)
+                        ready.push_back(d);
+                }
+            }
+            scheduled += laneTasks[lane].size();
+        }
+    }
+    if (scheduled != taskCount)
+        throw std::logic_error("TaskGraph contains a cycle!");
+
+    //join the other lanes if the final one does not already depend on them
+    std::vector<uint64_t> required(laneCount, 0);
+    auto join = false;
+    for (auto i = 0u; i < laneCount; ++i) {
+        auto last = lanes[i].steps.size();
+        if (i != finalLane && known[finalLane].back()[i] < last) {
+            required[i] = last;
+            join = true;
+        }
+    }
+    if (join) {
+        Step step{ .stage = 0 };
+        auto pre = reduce(required, step.waits);
+        addStep(finalLane, std::move(step), std::move(pre));
+    }
+
+    finalized = true;
+}
+
+size_t TaskGraph::size() const noexcept {
+    return _pImp ? _pImp->tasks.size() : 0;
+}
+
+size_t TaskGraph::addTask(const Command& command, QueueType queue) {
+    if (_pImp->finalized)
+        throw std::logic_error("TaskGraph has already been submitted!");
+
+    //fetch pool of the queue if not done yet
+    auto& pool = _pImp->pools[toIndex(queue)];
+    if (!pool)
+        pool = vulkan::fetchSequencePool(_pImp->context, queue);
+
+    //allocate and record a new command buffer
+    VkCommandBufferAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = pool,
+        .commandBufferCount = 1
+    };
+    vulkan::Command cmd{};
+    cmd.queueFlags = _pImp->context.queues[toIndex(queue)].flags;
+    vulkan::checkResult(_pImp->context.fnTable.vkAllocateCommandBuffers(
+        _pImp->context.device, &allocInfo, &cmd.buffer));
+    _pImp->recordedBuffers[toIndex(queue)].push_back(cmd.buffer);
+    vulkan::checkResult(_pImp->context.fnTable.vkBeginCommandBuffer(
+        cmd.buffer, &ReusableBeginInfo));
+    command.record(cmd);
+    vulkan::checkResult(_pImp->context.fnTable.vkEndCommandBuffer(cmd.buffer));
+
+    _pImp->tasks.push_back({ cmd.buffer, cmd.stage, queue });
+    return _pImp->tasks.size() - 1;
+}
+
+size_t TaskGraph::addTask(const Subroutine& subroutine, QueueType queue) {
+    if (_pImp->finalized)
+        throw std::logic_error("TaskGraph has already been submitted!");
+    //subroutines are allocated for the main queue's family
+    if (_pImp->context.queues[toIndex(queue)].family != _pImp->context.queueFamily)
+        throw std::logic_error("Subroutines can only run on queues of the main queue family!");
+    //graphs may resubmit while still pending
+    if (!subroutine.simultaneousUse())
+        throw std::logic_error("TaskGraph can only contain subroutines with simultaneous use!");
+
+    auto& cmd = subroutine.getCommandBuffer();
+    _pImp->tasks.push_back({ cmd.buffer, cmd.stage, queue });
+    return _pImp->tasks.size() - 1;
+}
+
+void TaskGraph::addDependency(size_t before, size_t after) {
+    if (_pImp->finalized)
+        throw std::logic_error("TaskGraph has already been submitted!");
+    if (before >= _pImp->tasks.size() || after >= _pImp->tasks.size())
+        throw std::out_of_range("Task index out of range!");
+    if (before == after)
+        throw std::logic_error("Task can not depend on itself!");
+
+    auto& dependencies = _pImp->tasks[after].dependencies;
+    if (std::find(dependencies.begin(), dependencies.end(), before) == dependencies.end())
+        dependencies.push_back(before);
+}
+
+Submission TaskGraph::Submit() {
+    _pImp->finalize();
+    SubmissionSlots slots(_pImp->context, 1, true);
+    vulkan::TraceScope trace(_pImp->context, "SubmitTaskGraph", "submit");
+
+    auto& lanes = _pImp->lanes;
+    auto& context = _pImp->context;
+    auto toSemaphore = [&lanes](size_t lane) {
+        return lanes[lane].timeline->getTimeline().semaphore;
+    };
+
+    //count infos up front, so pointers into them stay valid
+    size_t stepCount = 0, waitCount = 0, cmdCount = 0;
+    for (auto& lane : lanes) {
+        stepCount += lane.steps.size();
+        for (auto& step : lane.steps) {
+            waitCount += step.waits.size();
+            cmdCount += step.buffers.size();
+        }
+    }
+
+    if (context.synchronization2) {
+        std::vector<VkSemaphoreSubmitInfoKHR> waitInfos;
+        std::vector<VkSemaphoreSubmitInfoKHR> signalInfos;
+        std::vector<VkCommandBufferSubmitInfoKHR> cmdInfos;
+        std::vector<VkSubmitInfo2KHR> submitInfos;
+        waitInfos.reserve(waitCount);
+        signalInfos.reserve(stepCount);
+        cmdInfos.reserve(cmdCount);
+        submitInfos.reserve(stepCount);
+
+        for (auto i = 0u; i < lanes.size(); ++i) {
+            auto& lane = lanes[i];
+            auto first = submitInfos.size();
+            for (auto j = 0u; j < lane.steps.size(); ++j) {
+                auto& step = lane.steps[j];
+                //empty steps have no stages -> use all
+                auto stages = step.stage;
+                if (stages == 0)
+                    stages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR;
+
+                auto pWait = waitInfos.data() + waitInfos.size();
+                for (auto& wait : step.waits) {
+                    waitInfos.push_back(VkSemaphoreSubmitInfoKHR{
+                        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR,
+                        .semaphore = toSemaphore(wait.lane),
+                        .value = lanes[wait.lane].base + wait.value,
+                        .stageMask = stages
+                    });
+                }
+                auto pCmd = cmdInfos.data() + cmdInfos.size();
+                for (auto buffer : step.buffers) {
+                    cmdInfos.push_back(VkCommandBufferSubmitInfoKHR{
+                        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO_KHR,
+                        .commandBuffer = buffer
+                    });
+                }
+                signalInfos.push_back(VkSemaphoreSubmitInfoKHR{
+                    .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR,
+                    .semaphore = toSemaphore(i),
+                    .value = lane.base + j + 1,
+                    .stageMask = stages
+                });
+
+                submitInfos.push_back(VkSubmitInfo2KHR{
+                    .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR,
+                    .waitSemaphoreInfoCount = static_cast<uint32_t>(step.waits.size()),
+                    .pWaitSemaphoreInfos = pWait,
+                    .commandBufferInfoCount = static_cast<uint32_t>(step.buffers.size()),
+                    .pCommandBufferInfos = pCmd,
+                    .signalSemaphoreInfoCount = 1,
+                    .pSignalSemaphoreInfos = &signalInfos.back()
+                });
+            }
+            //waits on steps of later lanes are fine for timelines
+            vulkan::queueSubmit2(context, lane.queue,
+                static_cast<uint32_t>(lane.steps.size()),
+                submitInfos.data() + first, nullptr);
+        }
+    }
+    else {
+        std::vector<VkSemaphore> waitSemaphores;
+        std::vector<uint64_t> waitValues;
+        std::vector<VkPipelineStageFlags> waitStages;
+        std::vector<VkSemaphore> signalSemaphores;
+        std::vector<uint64_t> signalValues;
+        std::vector<VkCommandBuffer> commandBuffers;
+        std::vector<VkTimelineSemaphoreSubmitInfo> timelineInfos;
+        std::vector<VkSubmitInfo> submitInfos;
+        waitSemaphores.reserve(waitCount);
+        waitValues.reserve(waitCount);
+        waitStages.reserve(waitCount);
+        signalSemaphores.reserve(stepCount);
+        signalValues.reserve(stepCount);
+        commandBuffers.reserve(cmdCount);
+        timelineInfos.reserve(stepCount);
+        submitInfos.reserve(stepCount);
+
+        for (auto i = 0u; i < lanes.size(); ++i) {
+            auto& lane = lanes[i];
+            auto first = submitInfos.size();
+            for (auto j = 0u; j < lane.steps.size(); ++j) {
+                auto& step = lane.steps[j];
+                //edge case: empty submission can't have waitStage=0
+                //  -> use TOP_OF_PIPE
+                auto stage = vulkan::toLegacyStage(step.stage);
+                if (stage == 0)
+                    stage = EmptyStage;
+
+                auto waitOffset = waitValues.size();
+                for (auto& wait : step.waits) {
+                    waitSemaphores.push_back(toSemaphore(wait.lane));
+                    waitValues.push_back(lanes[wait.lane].base + wait.value);
+                    waitStages.push_back(stage);
+                }
+                auto cmdOffset = commandBuffers.size();
+                commandBuffers.insert(commandBuffers.end(),
+                    step.buffers.begin(), step.buffers.end());
+                signalSemaphores.push_back(toSemaphore(i));
+                signalValues.push_back(lane.base + j + 1);
+
+                auto count = static_cast<uint32_t>(step.waits.size());
+                timelineInfos.push_back(VkTimelineSemaphoreSubmitInfo{
+                    .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+                    .waitSemaphoreValueCount = count,
+                    .pWaitSemaphoreValues = waitValues.data() + waitOffset,
+                    .signalSemaphoreValueCount = 1,
+                    .pSignalSemaphoreValues = &signalValues.back()
+                });
+                submitInfos.push_back(VkSubmitInfo{
+                    .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                    .pNext = &timelineInfos.back(),
+                    .waitSemaphoreCount = count,
+                    .pWaitSemaphores = waitSemaphores.data() + waitOffset,
+                    .pWaitDstStageMask = waitStages.data() + waitOffset,
+                    .commandBufferCount = static_cast<uint32_t>(step.buffers.size()),
+                    .pCommandBuffers = commandBuffers.data() + cmdOffset,
+                    .signalSemaphoreCount = 1,
+                    .pSignalSemaphores = &signalSemaphores.back()
+                });
+            }
+            vulkan::queueSubmit(context, lane.queue,
+                static_cast<uint32_t>(lane.steps.size()),
+                submitInfos.data() + first, nullptr);
+        }
+    }
+
+    //next submission continues where this one ends
+    for (auto& lane : lanes)
+        lane.base += lane.steps.size();
+    _pImp->submitted = true;
+
+    //graph keeps the resources -> nothing to manage
+    auto& last = lanes[_pImp->finalLane];
+    Submission submission{ *last.timeline, last.base, nullptr };
+    slots.release(submission);
+    return submission;
+}
+
+WaitGraph TaskGraph::getWaitGraph() {
+    _pImp->finalize();
+
+    WaitGraph graph;
+    for (auto& lane : _pImp->lanes) {
+        for (auto j = 0u; j < lane.steps.size(); ++j) {
+            auto& step = lane.steps[j];
+            WaitGraphStep graphStep{
+                .queue = lane.queue,
+                .commandBufferCount = static_cast<uint32_t>(step.buffers.size()),
+                .signal = { lane.timeline->getId(), lane.base + j + 1 }
+            };
+            for (auto& wait : step.waits) {
+                auto& waitLane = _pImp->lanes[wait.lane];
+                graphStep.waits.push_back({
+                    waitLane.timeline->getId(), waitLane.base + wait.value });
+            }
+            graph.steps.push_back(std::move(graphStep));
+        }
+    }
+    return graph;
+}
+
+TaskGraph::TaskGraph(TaskGraph&& other) noexcept = default;
+TaskGraph& TaskGraph::operator=(TaskGraph&& other) noexcept {
+    //previous resources are released by other's destructor
+    std::swap(_pImp, other._pImp);
+    return *this;
+}
+
+TaskGraph::TaskGraph(ContextHandle context)
+    : _pImp(new pImp(std::move(context)))
+{}
+TaskGraph::~TaskGraph() {
+    if (!_pImp)
+        return;
+
+    auto& context = _pImp->context;
+    if (!_pImp->submitted) {
+        //nothing in flight -> give pools back right away
+        for (auto i = 0u; i < vulkan::QueueTypeCount; ++i) {
+            if (_pImp->pools[i]) {
+                vulkan::returnSequencePool(context, static_cast<QueueType>(i),
+                    _pImp->pools[i], _pImp->recordedBuffers[i]);
+            }
+        }
+        return;
+    }
+
+    //the other lanes' timelines are destroyed right away, thus their
+    //signals must have happened
+    auto& last = _pImp->lanes[_pImp->finalLane];
+    if (_pImp->lanes.size() > 1)
+        last.timeline->waitValue(last.base);
+
+    //recycle resources once the last submission finished
+    vulkan::RetiredSequence retired{
+        .semaphore = last.timeline->getTimeline().semaphore,
+        .value = last.base,
+        .pools = _pImp->pools,
+        .commands = std::move(_pImp->recordedBuffers)
+    };
+    retired.timeline = last.timeline->releaseTimeline();
+    vulkan::retireSequence(context, std::move(retired));
 }
 
 void execute(const ContextHandle& context, const Command& command) {
@@ -664,22 +2236,20 @@ void execute(const ContextHandle& context, const Command& command) {
 }
 
 void execute(const ContextHandle& context, const Subroutine& subroutine) {
+    //fetch fence to wait on
+    vulkan::OneTimeSubmitLease lease(*context);
+    auto fence = lease.get().fence;
+
     //submit with fence, so we can wait for it to finish
     VkSubmitInfo submitInfo{
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
         .commandBufferCount = 1,
         .pCommandBuffers = &subroutine.getCommandBuffer().buffer
     };
-    vulkan::checkResult(context->fnTable.vkQueueSubmit(
-        context->queue, 1, &submitInfo, context->oneTimeSubmitFence));
+    vulkan::queueSubmit(*context, 1, &submitInfo, fence);
 
     //wait for it to finish
-    vulkan::checkResult(context->fnTable.vkWaitForFences(
-        context->device, 1, &context->oneTimeSubmitFence, VK_TRUE, UINT64_MAX));
-
-    //reset fence for next use
-    vulkan::checkResult(context->fnTable.vkResetFences(
-        context->device, 1, &context->oneTimeSubmitFence));
+    vulkan::waitForFence(*context, fence);
 }
 
 void execute(const ContextHandle& context,
@@ -691,4 +2261,87 @@ void execute(const ContextHandle& context,
     });
 }
 
+/******************************* ASYNC EXECUTE ********************************/
+
+namespace {
+
+Submission submitAsync(const ContextHandle& context,
+    VkCommandPool pool, VkCommandBuffer buffer)
+{
+    //pooled timelines keep their value -> continue from there
+    auto timeline = fetchTimeline(context);
+    auto semaphore = timeline->getTimeline().semaphore;
+    auto finalStep = timeline->getValue() + 1;
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues = &finalStep
+    };
+    VkSubmitInfo submitInfo{
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = &timelineInfo,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &buffer,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &semaphore
+    };
+    vulkan::queueSubmit(*context, 1, &submitInfo, nullptr);
+    vulkan::count(context->counters.oneTimeSubmits);
+
+    //only command buffers recorded by us are managed by the submission
+    auto resources = std::unique_ptr<SubmissionResources>(new SubmissionResources{});
+    if (pool) {
+        resources->pools[toIndex(QueueType::MAIN)] = pool;
+        resources->commands[toIndex(QueueType::MAIN)].push_back(buffer);
+    }
+    resources->exclusiveTimeline = std::move(timeline);
+    auto& timelineRef = *resources->exclusiveTimeline;
+    return Submission{ timelineRef, finalStep, std::move(resources) };
+}
+
+}
+
+Submission executeAsync(const ContextHandle& context, const Command& command) {
+    return executeAsync(context, [&command](vulkan::Command& cmd) {
+        command.record(cmd);
+    });
+}
+
+Submission executeAsync(const ContextHandle& context, const Subroutine& subroutine) {
+    return submitAsync(context, VK_NULL_HANDLE, subroutine.getCommandBuffer().buffer);
+}
+
+Submission executeAsync(const ContextHandle& context,
+    const std::function<void(vulkan::Command& cmd)>& emitter)
+{
+    auto pool = vulkan::fetchSequencePool(*context, QueueType::MAIN);
+    VkCommandBuffer buffer = VK_NULL_HANDLE;
+    try {
+        //allocate and record command buffer
+        VkCommandBufferAllocateInfo allocInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = pool,
+            .commandBufferCount = 1
+        };
+        vulkan::checkResult(context->fnTable.vkAllocateCommandBuffers(
+            context->device, &allocInfo, &buffer));
+        vulkan::checkResult(context->fnTable.vkBeginCommandBuffer(
+            buffer, &BeginInfo));
+        vulkan::Command wrapper{ buffer, 0 };
+        emitter(wrapper);
+        vulkan::checkResult(context->fnTable.vkEndCommandBuffer(buffer));
+
+        return submitAsync(context, pool, buffer);
+    }
+    catch (...) {
+        //give resources back before rethrowing
+        std::vector<VkCommandBuffer> commands;
+        if (buffer)
+            commands.push_back(buffer);
+        vulkan::returnSequencePool(*context, QueueType::MAIN, pool, commands);
+        throw;
+    }
+}
+
 }
@@ -1,22 +1,185 @@
 #include "hephaistos/compiler.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string.h>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
+#ifndef HEPHAISTOS_NO_COMPILER
+#include <glslang/build_info.h>
 #include <glslang/Include/glslang_c_interface.h>
 #include <glslang/Public/resource_limits_c.h>
+#endif
+//needed for HasResultAndType()
+#define SPV_ENABLE_UTILITY_CODE
+#include <SPIRV/spirv.hpp>
+
+#include "hephaistos/graph.hpp"
+#include "hephaistos/image.hpp"
+#include "hephaistos/random.hpp"
+#include "hephaistos/workqueue.hpp"
+
+#include "vk/workers.hpp"
 
 namespace hephaistos {
 
 namespace {
 
-using CompilerContext = std::pair<const Compiler::HeaderMap*, const std::vector<std::filesystem::path>* >;
+//FNV-1a
+constexpr uint64_t HashSeed = 14695981039346656037ull;
+uint64_t hashBytes(std::string_view data, uint64_t hash = HashSeed) {
+    for (auto c : data) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+//length prefix prevents different splits of the same bytes to collide
+uint64_t hashField(std::string_view data, uint64_t hash) {
+    auto size = static_cast<uint64_t>(data.size());
+    hash = hashBytes({ reinterpret_cast<const char*>(&size), sizeof(size) }, hash);
+    return hashBytes(data, hash);
+}
+
+//first matching file in the include directories; empty if none
+std::filesystem::path findInclude(
+    const std::vector<std::filesystem::path>& dirs,
+    std::string_view header_name
+) {
+    for (auto& dir : dirs) {
+        auto path = dir / header_name;
+        if (std::filesystem::exists(path) && std::filesystem::is_regular_file(path))
+            return path;
+    }
+    return {};
+}
+
+struct IncludeFile {
+    std::string name;
+    std::filesystem::path path;
+    std::filesystem::file_time_type time;
+    std::string data;
+    uint64_t hash;
+};
+using IncludeHandle = std::shared_ptr<const IncludeFile>;
+
+IncludeHandle loadInclude(std::string name, std::filesystem::path path) {
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(path, ec);
+    if (ec)
+        return nullptr;
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return nullptr;
+    std::string data{
+        std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>()
+    };
+    if (file.bad())
+        return nullptr;
+    auto hash = hashBytes(data);
+    return std::make_shared<const IncludeFile>(IncludeFile{
+        std::move(name), std::move(path), time, std::move(data), hash
+    });
+}
+
+}
+
+//resolved include files and their content; shared with pending async compiles
+struct Compiler::IncludeCache {
+    std::mutex mutex;
+    std::unordered_map<std::string, IncludeHandle, string_hash, std::equal_to<>> files;
+
+    //returns the file the name resolves to; nullptr if none
+    IncludeHandle find(
+        const std::vector<std::filesystem::path>& dirs,
+        std::string_view name
+    ) {
+        //cached entries stay valid as long as the file did not change
+        IncludeHandle cached;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = files.find(name);
+            if (it != files.end())
+                cached = it->second;
+        }
+        if (cached) {
+            std::error_code ec;
+            auto time = std::filesystem::last_write_time(cached->path, ec);
+            if (!ec && time == cached->time)
+                return cached;
+        }
+
+        //resolve and load outside the lock to not block other threads
+        auto path = findInclude(dirs, name);
+        if (path.empty())
+            return nullptr;
+        auto file = loadInclude(std::string(name), std::move(path));
+        if (file) {
+            std::lock_guard<std::mutex> lock(mutex);
+            files.insert_or_assign(file->name, file);
+        }
+        return file;
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        files.clear();
+    }
+};
+
+#ifndef HEPHAISTOS_NO_COMPILER
+
+namespace {
+
+//glslang must be initialized once per process. Pairing it with the lifetime
+//of compilers breaks on moved ones, so keep it alive until exit instead.
+void initializeProcess() {
+    static struct Process {
+        Process() { glslang_initialize_process(); }
+        ~Process() { glslang_finalize_process(); }
+    } process;
+}
+
+//include files loaded from disk and the hash of their content
+using Dependencies = std::vector<std::pair<std::string, uint64_t>>;
+
+struct CompilerContext {
+    const Compiler::HeaderMap* headers;
+    const std::vector<std::filesystem::path>* includeDirs;
+    Compiler::IncludeCache* includeCache;
+    //keeps included files alive until glslang is done
+    std::vector<IncludeHandle> included;
+    //only recorded if results get cached
+    Dependencies* dependencies;
+};
 
 using Shader = std::unique_ptr<glslang_shader_t, decltype(&glslang_shader_delete)>;
-using Program = std::unique_ptr<glslang_program_t, decltype(&glslang_program_delete)>;
+using LinkedProgram = std::unique_ptr<glslang_program_t, decltype(&glslang_program_delete)>;
+
+//headers shipped with the library available to all compilations
+const Compiler::HeaderMap& getBuiltinHeaders() {
+    static const Compiler::HeaderMap headers = {
+        { "hephaistos/graph.glsl", std::string(getExecutionGraphSource()) },
+        { "hephaistos/random.glsl", std::string(getRandomSource()) },
+        { "hephaistos/sparse.glsl", std::string(getSparseFeedbackSource()) },
+        { "hephaistos/workqueue.glsl", std::string(getWorkQueueSource()) }
+    };
+    return headers;
+}
 
 glsl_include_result_t* resolve_include_map(
     void* context,
@@ -24,20 +187,20 @@ glsl_include_result_t* resolve_include_map(
     const char* includer_name,
     size_t include_depth
 ) {
-    auto headers = static_cast<CompilerContext*>(context)->first;
-    if (!headers)
-        return nullptr;
-    auto pHeader = headers->find(header_name);
-    if (pHeader != headers->end()) {
-        auto result = new glsl_include_result_t;
-        result->header_name = pHeader->first.c_str();
-        result->header_data = pHeader->second.c_str();
-        result->header_length = pHeader->second.size();
-        return result;
-    }
-    else {
-        return nullptr;
+    //user provided headers shadow built-in ones
+    auto headers = static_cast<CompilerContext*>(context)->headers;
+    auto pHeader = headers ? headers->find(header_name) : getBuiltinHeaders().end();
+    if (!headers || pHeader == headers->end()) {
+        pHeader = getBuiltinHeaders().find(header_name);
+        if (pHeader == getBuiltinHeaders().end())
+            return nullptr;
     }
+
+    auto result = new glsl_include_result_t;
+    result->header_name = pHeader->first.c_str();
+    result->header_data = pHeader->second.c_str();
+    result->header_length = pHeader->second.size();
+    return result;
 }
 
 glsl_include_result_t* resolve_include_dirs(
@@ -46,42 +209,24 @@ glsl_include_result_t* resolve_include_dirs(
     const char* includer_name,
     size_t include_depth
 ) {
-    auto& dirs = *static_cast<CompilerContext*>(context)->second;
-    //check all directories
-    for (auto& dir : dirs) {
-        auto path = dir / header_name;
-        if (std::filesystem::exists(path) && std::filesystem::is_regular_file(path)) {
-            auto result = new glsl_include_result_t;
-            size_t size = std::filesystem::file_size(path);
-            auto data = new char[size];
-            //load data
-            std::ifstream file(path, std::ios::binary);
-            if (file.read(data, size)) {
-                result->header_name = strdup(header_name);
-                result->header_length = size;
-                result->header_data = data;
-                return result;
-            }
-            else {
-                //error -> clean up
-                delete[] data;
-                return result;
-            }
-        }
-    }
+    auto ctx = static_cast<CompilerContext*>(context);
+    auto file = ctx->includeCache->find(*ctx->includeDirs, header_name);
+    if (!file)
+        return resolve_include_map(context, header_name, includer_name, include_depth);
 
-    //nothing found
-    return nullptr;
+    auto result = new glsl_include_result_t;
+    result->header_name = file->name.c_str();
+    result->header_data = file->data.c_str();
+    result->header_length = file->data.size();
+    //remember for validating cached results
+    if (ctx->dependencies)
+        ctx->dependencies->emplace_back(file->name, file->hash);
+    ctx->included.push_back(std::move(file));
+    return result;
 }
 
 int free_include_result(void* context, glsl_include_result_t* result) {
-    //check if local or loaded from disk
-    auto headers = static_cast<CompilerContext*>(context)->first;
-    if (!headers || !headers->contains(result->header_name)) {
-        //from disk -> free resources allocated in result
-        delete[] result->header_name;
-        delete[] result->header_data;
-    }
+    //data is owned by either the header map or the context
     delete result;
     return 0;
 }
@@ -104,15 +249,269 @@ void compile_error(const char* reason, glslang_program_t* program) {
     throw std::runtime_error(sstream.str());
 }
 
-std::vector<uint32_t> compileImpl(std::string_view code, void* callbacks_ctx = nullptr) {
+//removes instructions only carrying debug information
+void stripDebugInfo(std::vector<uint32_t>& code) {
+    auto out = code.begin() + 5;
+    for (auto in = out; in != code.end();) {
+        auto count = *in >> spv::WordCountShift;
+        switch (spv::Op(*in & spv::OpCodeMask)) {
+        case spv::OpSourceContinued:
+        case spv::OpSource:
+        case spv::OpSourceExtension:
+        case spv::OpName:
+        case spv::OpMemberName:
+        case spv::OpString:
+        case spv::OpLine:
+        case spv::OpNoLine:
+        case spv::OpModuleProcessed:
+            break;
+        default:
+            out = std::copy(in, in + count, out);
+            break;
+        }
+        in += count;
+    }
+    code.erase(out, code.end());
+}
+
+//float controls 2 is newer than the bundled SPIR-V header
+constexpr uint32_t ExecutionModeFPFastMathDefault = 6028;
+constexpr uint32_t CapabilityFloatControls2 = 6029;
+//NotNaN | NotInf | NSZ | AllowRecip | AllowContract | AllowReassoc | AllowTransform
+constexpr uint32_t FastMathFlags = 0x0007000F;
+
+void emitInstruction(std::vector<uint32_t>& out, spv::Op op,
+    std::initializer_list<uint32_t> operands)
+{
+    out.push_back((static_cast<uint32_t>(operands.size() + 1) << spv::WordCountShift) | op);
+    out.insert(out.end(), operands.begin(), operands.end());
+}
+
+//adds the execution modes and decorations requested by the float options
+void applyFloatOptions(std::vector<uint32_t>& code, const CompileOptions& options) {
+    if (options.denormMode == DenormMode::DEFAULT && !options.relaxedPrecision && !options.fastMath)
+        return;
+
+    //collect entry points and float types
+    std::vector<uint32_t> entryPoints;
+    std::vector<std::pair<uint32_t, uint32_t>> floatTypes; //id, width
+    std::unordered_set<uint32_t> relaxedTypes;
+    uint32_t uintType = 0;
+    for (size_t i = 5; i < code.size(); i += code[i] >> spv::WordCountShift) {
+        auto inst = code.data() + i;
+        switch (spv::Op(inst[0] & spv::OpCodeMask)) {
+        case spv::OpEntryPoint:
+            entryPoints.push_back(inst[2]);
+            break;
+        case spv::OpTypeFloat:
+            floatTypes.emplace_back(inst[1], inst[2]);
+            if (inst[2] == 32)
+                relaxedTypes.insert(inst[1]);
+            break;
+        case spv::OpTypeVector:
+        case spv::OpTypeMatrix:
+            if (relaxedTypes.contains(inst[2]))
+                relaxedTypes.insert(inst[1]);
+            break;
+        case spv::OpTypeInt:
+            if (inst[2] == 32 && inst[3] == 0)
+                uintType = inst[1];
+            break;
+        default:
+            break;
+        }
+    }
+
+    //new instructions per section of the module
+    std::vector<uint32_t> capabilities, extensions, modes, decorations, globals;
+    auto bound = code[3];
+    if (options.denormMode != DenormMode::DEFAULT && !floatTypes.empty()) {
+        auto flush = options.denormMode == DenormMode::FLUSH_TO_ZERO;
+        emitInstruction(capabilities, spv::OpCapability, {
+            flush ? spv::CapabilityDenormFlushToZero : spv::CapabilityDenormPreserve });
+        for (auto entry : entryPoints) {
+            for (auto [id, width] : floatTypes) {
+                emitInstruction(modes, spv::OpExecutionMode, { entry,
+                    flush ? spv::ExecutionModeDenormFlushToZero : spv::ExecutionModeDenormPreserve,
+                    width });
+            }
+        }
+    }
+    if (options.fastMath && !floatTypes.empty()) {
+        emitInstruction(capabilities, spv::OpCapability, { CapabilityFloatControls2 });
+        //literal strings are null terminated and padded to whole words
+        std::string_view name = "SPV_KHR_float_controls2";
+        std::vector<uint32_t> words(name.size() / 4 + 1, 0);
+        std::memcpy(words.data(), name.data(), name.size());
+        extensions.push_back((static_cast<uint32_t>(words.size() + 1) << spv::WordCountShift) | spv::OpExtension);
+        extensions.insert(extensions.end(), words.begin(), words.end());
+        //flags are passed as constant
+        if (!uintType) {
+            uintType = bound++;
+            emitInstruction(globals, spv::OpTypeInt, { uintType, 32, 0 });
+        }
+        auto flags = bound++;
+        emitInstruction(globals, spv::OpConstant, { uintType, flags, FastMathFlags });
+        for (auto entry : entryPoints) {
+            for (auto [id, width] : floatTypes) {
+                emitInstruction(modes, spv::OpExecutionModeId, {
+                    entry, ExecutionModeFPFastMathDefault, id, flags });
+            }
+        }
+    }
+    if (options.relaxedPrecision) {
+        //decorate all float results inside functions
+        auto inFunction = false;
+        for (size_t i = 5; i < code.size(); i += code[i] >> spv::WordCountShift) {
+            auto inst = code.data() + i;
+            auto op = spv::Op(inst[0] & spv::OpCodeMask);
+            inFunction |= op == spv::OpFunction;
+            bool hasResult, hasType;
+            spv::HasResultAndType(op, &hasResult, &hasType);
+            if (inFunction && hasResult && hasType && relaxedTypes.contains(inst[1]))
+                emitInstruction(decorations, spv::OpDecorate, { inst[2], spv::DecorationRelaxedPrecision });
+        }
+    }
+    code[3] = bound;
+
+    //sections follow a fixed order -> insert each at the end of its own
+    enum Section { CAPABILITIES, EXTENSIONS, IMPORTS, MODES, ANNOTATIONS, GLOBALS, FUNCTIONS };
+    auto getSection = [](spv::Op op) -> Section {
+        switch (op) {
+        case spv::OpCapability:
+            return CAPABILITIES;
+        case spv::OpExtension:
+            return EXTENSIONS;
+        case spv::OpExtInstImport:
+            return IMPORTS;
+        case spv::OpMemoryModel:
+        case spv::OpEntryPoint:
+        case spv::OpExecutionMode:
+        case spv::OpExecutionModeId:
+            return MODES;
+        case spv::OpString:
+        case spv::OpSourceExtension:
+        case spv::OpSource:
+        case spv::OpSourceContinued:
+        case spv::OpName:
+        case spv::OpMemberName:
+        case spv::OpModuleProcessed:
+        case spv::OpDecorate:
+        case spv::OpMemberDecorate:
+        case spv::OpDecorationGroup:
+        case spv::OpGroupDecorate:
+        case spv::OpGroupMemberDecorate:
+        case spv::OpDecorateId:
+        case spv::OpDecorateString:
+        case spv::OpMemberDecorateString:
+            return ANNOTATIONS;
+        case spv::OpFunction:
+            return FUNCTIONS;
+        default:
+            return GLOBALS;
+        }
+    };
+    std::vector<uint32_t> imports;
+    const std::vector<uint32_t>* inserts[] = {
+        &capabilities, &extensions, &imports, &modes, &decorations, &globals
+    };
+
+    std::vector<uint32_t> result(code.begin(), code.begin() + 5);
+    result.reserve(code.size() + capabilities.size() + extensions.size() +
+        modes.size() + decorations.size() + globals.size());
+    auto section = 0;
+    for (size_t i = 5; i < code.size();) {
+        auto count = code[i] >> spv::WordCountShift;
+        auto op = spv::Op(code[i] & spv::OpCodeMask);
+        //debug lines may appear anywhere
+        auto next = op == spv::OpLine || op == spv::OpNoLine
+            ? section : static_cast<int>(getSection(op));
+        for (; section < next; ++section) {
+            if (section < FUNCTIONS)
+                result.insert(result.end(), inserts[section]->begin(), inserts[section]->end());
+        }
+        result.insert(result.end(), code.begin() + i, code.begin() + i + count);
+        i += count;
+    }
+    for (; section < FUNCTIONS; ++section)
+        result.insert(result.end(), inserts[section]->begin(), inserts[section]->end());
+    code = std::move(result);
+}
+
+//Extensions must be requested after the version directive, which the preamble
+//cannot do -> insert them right after it and restore the line numbers
+std::string insertExtensions(std::string_view code, const CompileOptions& options) {
+    //built-in headers must be includable without requesting the extension
+    std::string extensions = "#extension GL_GOOGLE_include_directive : enable\n";
+    if (options.vulkanMemoryModel) {
+        extensions += "#pragma use_vulkan_memory_model\n";
+        extensions += "#extension GL_KHR_memory_scope_semantics : enable\n";
+    }
+
+    auto version = code.find("#version");
+    if (version == std::string_view::npos)
+        return extensions + "#line 1\n" + std::string(code);
+    auto end = code.find('\n', version);
+    if (end == std::string_view::npos)
+        return std::string(code) + '\n' + extensions;
+    auto line = std::count(code.begin(), code.begin() + end, '\n') + 2;
+    return std::string(code.substr(0, end + 1)) + extensions +
+        "#line " + std::to_string(line) + '\n' + std::string(code.substr(end + 1));
+}
+
+std::vector<uint32_t> compileImpl(
+    std::string_view code,
+    const CompileOptions& options,
+    void* callbacks_ctx = nullptr
+) {
+    auto client = GLSLANG_TARGET_VULKAN_1_2;
+    auto target = GLSLANG_TARGET_SPV_1_4;
+    switch (options.target) {
+    case CompileTarget::VULKAN_1_2:
+        break;
+    case CompileTarget::VULKAN_1_2_SPIRV_1_5:
+        target = GLSLANG_TARGET_SPV_1_5;
+        break;
+    case CompileTarget::VULKAN_1_3:
+        client = GLSLANG_TARGET_VULKAN_1_3;
+        target = GLSLANG_TARGET_SPV_1_6;
+        break;
+    default:
+        throw std::logic_error("Unknown compile target!");
+    }
+
+    auto stage = GLSLANG_STAGE_COMPUTE;
+    switch (options.stage) {
+    case ShaderStage::COMPUTE:
+        break;
+    case ShaderStage::RAYGEN:
+        stage = GLSLANG_STAGE_RAYGEN;
+        break;
+    case ShaderStage::MISS:
+        stage = GLSLANG_STAGE_MISS;
+        break;
+    case ShaderStage::CLOSEST_HIT:
+        stage = GLSLANG_STAGE_CLOSESTHIT;
+        break;
+    case ShaderStage::ANY_HIT:
+        stage = GLSLANG_STAGE_ANYHIT;
+        break;
+    case ShaderStage::INTERSECTION:
+        stage = GLSLANG_STAGE_INTERSECT;
+        break;
+    default:
+        throw std::logic_error("Unknown shader stage!");
+    }
+
+    auto source = insertExtensions(code, options);
     glslang_input_t input = {
         .language = GLSLANG_SOURCE_GLSL,
-        .stage = GLSLANG_STAGE_COMPUTE,
+        .stage = stage,
         .client = GLSLANG_CLIENT_VULKAN,
-        .client_version = GLSLANG_TARGET_VULKAN_1_2,
+        .client_version = client,
         .target_language = GLSLANG_TARGET_SPV,
-        .target_language_version = GLSLANG_TARGET_SPV_1_4,
-        .code = code.data(),
+        .target_language_version = target,
+        .code = source.c_str(),
         .default_version = 460,
         .default_profile = GLSLANG_NO_PROFILE,
         .force_default_version_and_profile = false,
@@ -127,12 +526,19 @@ std::vector<uint32_t> compileImpl(std::string_view code, void* callbacks_ctx = n
 
     glslang_shader_set_options(shader, GLSLANG_SHADER_AUTO_MAP_BINDINGS);
 
+    //defines are passed as preamble; must outlive the shader's processing
+    std::string preamble;
+    for (auto& [name, value] : options.defines)
+        preamble += "#define " + name + ' ' + value + '\n';
+    if (!preamble.empty())
+        glslang_shader_set_preamble(shader, preamble.c_str());
+
     if (!glslang_shader_preprocess(shader, &input))
         compile_error("GLSL Preprocessing failed!", shader);
     if (!glslang_shader_parse(shader, &input))
         compile_error("GLSL Parsing failed!", shader);
 
-    Program programHandle{ glslang_program_create(), glslang_program_delete };
+    LinkedProgram programHandle{ glslang_program_create(), glslang_program_delete };
     auto program = programHandle.get();
     glslang_program_add_shader(program, shader);
 
@@ -145,45 +551,523 @@ std::vector<uint32_t> compileImpl(std::string_view code, void* callbacks_ctx = n
     glslang_spv_options_t spv_options{
         .optimize_size = true
     };
-    glslang_program_SPIRV_generate_with_options(program, GLSLANG_STAGE_COMPUTE, &spv_options);
+    glslang_program_SPIRV_generate_with_options(program, stage, &spv_options);
     auto size = glslang_program_SPIRV_get_size(program);
     std::vector<uint32_t> result(size);
     glslang_program_SPIRV_get(program, result.data());
+    if (options.stripDebugInfo)
+        stripDebugInfo(result);
+    applyFloatOptions(result, options);
+
+    return result;
+}
+
+//bump if the options passed to glslang or the file layout change
+constexpr uint32_t CacheVersion = 2;
+constexpr uint32_t CacheMagic = 0x43535048; //"HPSC"
+
+//key of a cache entry; headers are hashed sorted by name to be independent of
+//the map's iteration order
+uint64_t hashKey(
+    std::string_view code,
+    const Compiler::HeaderMap* headers,
+    const std::vector<std::filesystem::path>& includeDirs,
+    const CompileOptions& options
+) {
+    auto hash = HashSeed;
+    uint32_t versions[] = {
+        CacheVersion,
+        GLSLANG_VERSION_MAJOR, GLSLANG_VERSION_MINOR, GLSLANG_VERSION_PATCH
+    };
+    hash = hashBytes({ reinterpret_cast<const char*>(versions), sizeof(versions) }, hash);
+    hash = hashField(GLSLANG_VERSION_FLAVOR, hash);
+    hash = hashField(code, hash);
+    uint32_t flags[] = {
+        static_cast<uint32_t>(options.target),
+        static_cast<uint32_t>(options.stripDebugInfo),
+        static_cast<uint32_t>(options.stage),
+        static_cast<uint32_t>(options.denormMode),
+        static_cast<uint32_t>(options.relaxedPrecision),
+        static_cast<uint32_t>(options.fastMath),
+        static_cast<uint32_t>(options.vulkanMemoryModel)
+    };
+    hash = hashBytes({ reinterpret_cast<const char*>(flags), sizeof(flags) }, hash);
+    for (auto& [name, value] : options.defines) {
+        hash = hashField(name, hash);
+        hash = hashField(value, hash);
+    }
+    for (auto& dir : includeDirs)
+        hash = hashField(dir.generic_string(), hash);
+    //built-in headers are sorted by name as well
+    std::vector<const Compiler::HeaderMap::value_type*> builtins;
+    for (auto& header : getBuiltinHeaders())
+        builtins.push_back(&header);
+    std::sort(builtins.begin(), builtins.end(),
+        [](auto a, auto b) { return a->first < b->first; });
+    for (auto header : builtins) {
+        hash = hashField(header->first, hash);
+        hash = hashField(header->second, hash);
+    }
+    if (headers) {
+        std::vector<const Compiler::HeaderMap::value_type*> sorted;
+        sorted.reserve(headers->size());
+        for (auto& header : *headers)
+            sorted.push_back(&header);
+        std::sort(sorted.begin(), sorted.end(),
+            [](auto a, auto b) { return a->first < b->first; });
+        for (auto header : sorted) {
+            hash = hashField(header->first, hash);
+            hash = hashField(header->second, hash);
+        }
+    }
+    return hash;
+}
+
+std::filesystem::path getCachePath(const std::filesystem::path& dir, uint64_t key) {
+    char name[21];
+    snprintf(name, sizeof(name), "%016llx.spv", static_cast<unsigned long long>(key));
+    return dir / name;
+}
+
+template<class T>
+bool readValue(std::ifstream& file, T& value) {
+    return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+template<class T>
+void writeValue(std::ofstream& file, const T& value) {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+//returns the cached code if the entry exists and its dependencies are unchanged
+std::optional<std::vector<uint32_t>> loadCache(
+    const std::filesystem::path& path,
+    const std::vector<std::filesystem::path>& includeDirs,
+    Compiler::IncludeCache& includeCache
+) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return std::nullopt;
+
+    uint32_t magic, version, depCount;
+    if (!readValue(file, magic) || magic != CacheMagic ||
+        !readValue(file, version) || version != CacheVersion ||
+        !readValue(file, depCount))
+    {
+        return std::nullopt;
+    }
+
+    //check include files loaded from disk did not change
+    for (uint32_t i = 0; i < depCount; ++i) {
+        uint32_t nameLength;
+        uint64_t hash;
+        if (!readValue(file, nameLength))
+            return std::nullopt;
+        std::string name(nameLength, '\0');
+        if (!file.read(name.data(), nameLength) || !readValue(file, hash))
+            return std::nullopt;
+
+        auto dep = includeCache.find(includeDirs, name);
+        if (!dep || dep->hash != hash)
+            return std::nullopt;
+    }
+
+    uint64_t codeSize;
+    if (!readValue(file, codeSize))
+        return std::nullopt;
+    std::vector<uint32_t> code(codeSize);
+    if (!file.read(reinterpret_cast<char*>(code.data()), codeSize * sizeof(uint32_t)))
+        return std::nullopt;
+    return code;
+}
+
+void storeCache(
+    const std::filesystem::path& path,
+    const Dependencies& dependencies,
+    const std::vector<uint32_t>& code
+) {
+    //write to a temporary file first, so concurrent readers never see
+    //partially written entries
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    if (ec)
+        return;
+    std::ostringstream tmpName;
+    tmpName << path.filename().string() << '.' << std::this_thread::get_id() << ".tmp";
+    auto tmp = path.parent_path() / tmpName.str();
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return;
+        writeValue(file, CacheMagic);
+        writeValue(file, CacheVersion);
+        writeValue(file, static_cast<uint32_t>(dependencies.size()));
+        for (auto& [name, hash] : dependencies) {
+            writeValue(file, static_cast<uint32_t>(name.size()));
+            file.write(name.data(), name.size());
+            writeValue(file, hash);
+        }
+        writeValue(file, static_cast<uint64_t>(code.size()));
+        file.write(reinterpret_cast<const char*>(code.data()), code.size() * sizeof(uint32_t));
+        if (!file) {
+            file.close();
+            std::filesystem::remove(tmp, ec);
+            return;
+        }
+    }
+    std::filesystem::rename(tmp, path, ec);
+    if (ec)
+        std::filesystem::remove(tmp, ec);
+}
 
+std::vector<uint32_t> compileCached(
+    std::string_view code,
+    const Compiler::HeaderMap* headers,
+    const std::vector<std::filesystem::path>& includeDirs,
+    const CompileOptions& options,
+    const std::filesystem::path& cacheDir,
+    Compiler::IncludeCache& includeCache
+) {
+    if (cacheDir.empty()) {
+        CompilerContext context{ headers, &includeDirs, &includeCache, {}, nullptr };
+        return compileImpl(code, options, &context);
+    }
+
+    auto path = getCachePath(cacheDir, hashKey(code, headers, includeDirs, options));
+    if (auto cached = loadCache(path, includeDirs, includeCache))
+        return std::move(*cached);
+
+    Dependencies dependencies;
+    CompilerContext context{ headers, &includeDirs, &includeCache, {}, &dependencies };
+    auto result = compileImpl(code, options, &context);
+    storeCache(path, dependencies, result);
     return result;
 }
 
 }
 
+#else
+
+namespace {
+
+void initializeProcess() {}
+
+//lean builds only run code compiled ahead of time, see hephaistos_add_shaders()
+std::vector<uint32_t> compileCached(
+    std::string_view,
+    const Compiler::HeaderMap*,
+    const std::vector<std::filesystem::path>&,
+    const CompileOptions&,
+    const std::filesystem::path&,
+    Compiler::IncludeCache&
+) {
+    throw std::runtime_error("Hephaistos was built without the runtime compiler!");
+}
+uint64_t hashKey(
+    std::string_view,
+    const Compiler::HeaderMap*,
+    const std::vector<std::filesystem::path>&,
+    const CompileOptions&
+) {
+    throw std::runtime_error("Hephaistos was built without the runtime compiler!");
+}
+
+}
+
+#endif
+
+uint64_t Compiler::getCacheKey(std::string_view code) const {
+    return hashKey(code, nullptr, includeDirs, options);
+}
+uint64_t Compiler::getCacheKey(std::string_view code, const HeaderMap& headers) const {
+    return hashKey(code, &headers, includeDirs, options);
+}
+
 std::vector<uint32_t> Compiler::compile(std::string_view code) const {
-    CompilerContext context(nullptr, &includeDirs);
-    return compileImpl(code, &context);
+    return compileCached(code, nullptr, includeDirs, options, cacheDir, *includeCache);
 }
 std::vector<uint32_t> Compiler::compile(std::string_view code, const HeaderMap& headers) const {
-    CompilerContext context(&headers, &includeDirs);
-    return compileImpl(code, &context);
+    return compileCached(code, &headers, includeDirs, options, cacheDir, *includeCache);
+}
+
+std::vector<std::vector<uint32_t>> Compiler::compileMany(
+    std::span<const std::string_view> codes, uint32_t threads) const
+{
+    return compileMany(codes, nullptr, threads);
+}
+std::vector<std::vector<uint32_t>> Compiler::compileMany(
+    std::span<const std::string_view> codes,
+    const HeaderMap& headers,
+    uint32_t threads) const
+{
+    return compileMany(codes, &headers, threads);
+}
+std::vector<std::vector<uint32_t>> Compiler::compileMany(
+    std::span<const std::string_view> codes,
+    const HeaderMap* headers,
+    uint32_t threads) const
+{
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    threads = std::min(threads, static_cast<uint32_t>(codes.size()));
+
+    std::vector<std::vector<uint32_t>> results(codes.size());
+    std::atomic<size_t> next = 0;
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto work = [&]() {
+        for (auto i = next++; i < codes.size(); i = next++) {
+            try {
+                results[i] = compileCached(codes[i], headers, includeDirs, options, cacheDir, *includeCache);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+    };
+    //the calling thread participates as well
+    std::vector<std::thread> workers;
+    for (auto i = 1u; i < threads; ++i)
+        workers.emplace_back(work);
+    work();
+    for (auto& worker : workers)
+        worker.join();
+    if (error)
+        std::rethrow_exception(error);
+
+    return results;
+}
+
+std::future<std::vector<uint32_t>> Compiler::compileAsync(std::string code) const {
+    return vulkan::WorkerPool::get().submit(
+        [code = std::move(code), dirs = includeDirs, options = options,
+            cache = cacheDir, includes = includeCache]()
+        {
+            return compileCached(code, nullptr, dirs, options, cache, *includes);
+        });
+}
+std::future<std::vector<uint32_t>> Compiler::compileAsync(std::string code, HeaderMap headers) const {
+    return vulkan::WorkerPool::get().submit(
+        [code = std::move(code), headers = std::move(headers),
+            dirs = includeDirs, options = options,
+            cache = cacheDir, includes = includeCache]()
+        {
+            return compileCached(code, &headers, dirs, options, cache, *includes);
+        });
+}
+
+PendingProgram Compiler::buildProgramAsync(
+    ContextHandle context,
+    std::string code,
+    std::vector<std::byte> specialization) const
+{
+    return PendingProgram(vulkan::WorkerPool::get().submit(
+        [context = std::move(context), code = std::move(code),
+            specialization = std::move(specialization), dirs = includeDirs,
+            options = options, cache = cacheDir, includes = includeCache]()
+        {
+            auto spirv = compileCached(code, nullptr, dirs, options, cache, *includes);
+            return Program(context, spirv, std::span<const std::byte>(specialization));
+        }));
+}
+PendingProgram Compiler::buildProgramAsync(
+    ContextHandle context,
+    std::string code,
+    HeaderMap headers,
+    std::vector<std::byte> specialization) const
+{
+    return PendingProgram(vulkan::WorkerPool::get().submit(
+        [context = std::move(context), code = std::move(code),
+            headers = std::move(headers), specialization = std::move(specialization),
+            dirs = includeDirs, options = options, cache = cacheDir,
+            includes = includeCache]()
+        {
+            auto spirv = compileCached(code, &headers, dirs, options, cache, *includes);
+            return Program(context, spirv, std::span<const std::byte>(specialization));
+        }));
 }
 
 void Compiler::addIncludeDir(std::filesystem::path path) {
     includeDirs.emplace_back(std::move(path));
+    includeCache->clear();
 }
 void Compiler::popIncludeDir() {
     includeDirs.pop_back();
+    includeCache->clear();
 }
 void Compiler::clearIncludeDir() {
     includeDirs.clear();
+    includeCache->clear();
+}
+
+void Compiler::preloadIncludes() {
+    //earlier directories take precedence
+    std::unordered_set<std::string> seen;
+    for (auto& dir : includeDirs) {
+        std::error_code ec;
+        for (auto it = std::filesystem::recursive_directory_iterator(dir, ec);
+            !ec && it != std::filesystem::recursive_directory_iterator();
+            it.increment(ec))
+        {
+            if (!it->is_regular_file())
+                continue;
+            auto name = std::filesystem::relative(it->path(), dir).generic_string();
+            if (seen.insert(name).second)
+                includeCache->find(includeDirs, name);
+        }
+    }
+}
+
+void Compiler::setOptions(CompileOptions options) {
+    this->options = std::move(options);
+}
+const CompileOptions& Compiler::getOptions() const noexcept {
+    return options;
+}
+
+void Compiler::setCacheDir(std::filesystem::path dir) {
+    cacheDir = std::move(dir);
+}
+const std::filesystem::path& Compiler::getCacheDir() const noexcept {
+    return cacheDir;
 }
 
+std::vector<uint32_t> specializeCode(
+    std::span<const uint32_t> code, std::span<const std::byte> specialization)
+{
+    if (code.size() < 5 || code[0] != spv::MagicNumber)
+        throw std::runtime_error("Code is not valid SPIR-V!");
+
+    //iterates over all instructions after the header
+    auto forEach = [code](auto&& func) {
+        for (size_t i = 5; i < code.size();) {
+            auto count = code[i] >> spv::WordCountShift;
+            if (count == 0 || i + count > code.size())
+                throw std::runtime_error("Code is not valid SPIR-V!");
+            func(spv::Op(code[i] & spv::OpCodeMask), code.subspan(i, count));
+            i += count;
+        }
+    };
+
+    //map spec constants to their id
+    std::unordered_map<uint32_t, uint32_t> specIds;
+    std::unordered_set<uint32_t> foldable;
+    forEach([&](spv::Op op, std::span<const uint32_t> inst) {
+        if (op == spv::OpDecorate && inst.size() >= 4 && inst[2] == spv::DecorationSpecId)
+            specIds[inst[1]] = inst[3];
+        //only 32 bit values match the data layout
+        if (op == spv::OpSpecConstantTrue || op == spv::OpSpecConstantFalse ||
+            (op == spv::OpSpecConstant && inst.size() == 4))
+        {
+            foldable.insert(inst[2]);
+        }
+    });
+
+    //data is ordered by constant id like in Program
+    std::vector<uint32_t> ids;
+    for (auto& [result, id] : specIds)
+        ids.push_back(id);
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    auto slots = std::min(ids.size(), specialization.size_bytes() / 4);
+    std::unordered_map<uint32_t, uint32_t> values;
+    for (size_t i = 0; i < slots; ++i) {
+        uint32_t value;
+        memcpy(&value, specialization.data() + 4 * i, 4);
+        values[ids[i]] = value;
+    }
+    //resolves the value of a folded constant
+    auto findValue = [&](uint32_t result) -> const uint32_t* {
+        auto id = specIds.find(result);
+        if (id == specIds.end() || !foldable.contains(result))
+            return nullptr;
+        auto value = values.find(id->second);
+        return value != values.end() ? &value->second : nullptr;
+    };
+
+    std::vector<uint32_t> result(code.begin(), code.begin() + 5);
+    result.reserve(code.size());
+    std::unordered_set<uint32_t> constants;
+    forEach([&](spv::Op op, std::span<const uint32_t> inst) {
+        auto emit = [&](spv::Op newOp) {
+            result.push_back((static_cast<uint32_t>(inst.size()) << spv::WordCountShift) | newOp);
+            result.insert(result.end(), inst.begin() + 1, inst.end());
+        };
+        switch (op) {
+        case spv::OpDecorate:
+            //folded constants must not be decorated with a spec id anymore
+            if (inst.size() >= 4 && inst[2] == spv::DecorationSpecId && findValue(inst[1]))
+                return;
+            break;
+        case spv::OpConstantTrue:
+        case spv::OpConstantFalse:
+        case spv::OpConstant:
+        case spv::OpConstantComposite:
+        case spv::OpConstantNull:
+            constants.insert(inst[2]);
+            break;
+        case spv::OpSpecConstantTrue:
+        case spv::OpSpecConstantFalse:
+            if (auto value = findValue(inst[2])) {
+                constants.insert(inst[2]);
+                emit(*value ? spv::OpConstantTrue : spv::OpConstantFalse);
+                return;
+            }
+            break;
+        case spv::OpSpecConstant:
+            if (auto value = findValue(inst[2])) {
+                constants.insert(inst[2]);
+                emit(spv::OpConstant);
+                result.back() = *value;
+                return;
+            }
+            break;
+        case spv::OpSpecConstantComposite:
+            if (std::all_of(inst.begin() + 3, inst.end(),
+                [&](uint32_t id) { return constants.contains(id); }))
+            {
+                constants.insert(inst[2]);
+                emit(spv::OpConstantComposite);
+                return;
+            }
+            break;
+        default:
+            break;
+        }
+        result.insert(result.end(), inst.begin(), inst.end());
+    });
+
+    return result;
+}
+
+bool PendingProgram::isReady() const {
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+void PendingProgram::wait() const {
+    future.wait();
+}
+Program PendingProgram::get() {
+    return future.get();
+}
+
+PendingProgram::PendingProgram(PendingProgram&&) noexcept = default;
+PendingProgram& PendingProgram::operator=(PendingProgram&&) noexcept = default;
+
+PendingProgram::PendingProgram(std::future<Program> future)
+    : future(std::move(future))
+{}
+PendingProgram::~PendingProgram() = default;
+
 Compiler& Compiler::operator=(Compiler&&) noexcept = default;
 Compiler::Compiler(Compiler&&) noexcept = default;
 
 Compiler::Compiler()
+    : includeCache(std::make_shared<IncludeCache>())
 {
-    glslang_initialize_process();
+    initializeProcess();
 }
 
-Compiler::~Compiler() {
-    glslang_finalize_process();
-}
+Compiler::~Compiler() = default;
 
 }
@@ -0,0 +1,162 @@
+#include "hephaistos/conditional.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include "volk.h"
+
+#include "vk/hazard.hpp"
+#include "vk/types.hpp"
+#include "vk/util.hpp"
+
+namespace hephaistos {
+
+/********************************** EXTENSION *********************************/
+
+namespace {
+
+constexpr auto ExtensionName = "ConditionalExecution";
+
+//! MUST BE SORTED FOR std::includes !//
+constexpr auto DeviceExtensions = std::to_array({
+    VK_EXT_CONDITIONAL_RENDERING_EXTENSION_NAME
+});
+
+}
+
+bool isConditionalExecutionSupported(const DeviceHandle& device) {
+    //nullcheck
+    if (!device)
+        return false;
+
+    //Check extension support
+    if (!std::includes(
+        device->supportedExtensions.begin(),
+        device->supportedExtensions.end(),
+        DeviceExtensions.begin(),
+        DeviceExtensions.end()))
+    {
+        return false;
+    }
+
+    //Query features
+    VkPhysicalDeviceConditionalRenderingFeaturesEXT conditionalFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT
+    };
+    VkPhysicalDeviceFeatures2 features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &conditionalFeatures
+    };
+    vkGetPhysicalDeviceFeatures2(device->device, &features);
+
+    return conditionalFeatures.conditionalRendering == VK_TRUE;
+}
+bool isConditionalExecutionEnabled(const ContextHandle& context) {
+    //to shorten things
+    auto& ext = *context->extensions;
+    return std::find_if(ext.begin(), ext.end(),
+        [](const ExtensionHandle& h) -> bool {
+            return h->getExtensionName() == ExtensionName;
+        }) != ext.end();
+}
+
+class ConditionalExecutionExtension : public Extension {
+public:
+    bool isDeviceSupported(const DeviceHandle& device) const override {
+        return isConditionalExecutionSupported(device);
+    }
+    std::string_view getExtensionName() const override {
+        return ExtensionName;
+    }
+    std::span<const char* const> getDeviceExtensions() const override {
+        return DeviceExtensions;
+    }
+    void* chain(void* pNext) override {
+        conditionalFeatures.pNext = pNext;
+        return static_cast<void*>(&conditionalFeatures);
+    }
+
+    ConditionalExecutionExtension() = default;
+    virtual ~ConditionalExecutionExtension() = default;
+
+private:
+    VkPhysicalDeviceConditionalRenderingFeaturesEXT conditionalFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_CONDITIONAL_RENDERING_FEATURES_EXT,
+        .conditionalRendering = VK_TRUE
+    };
+};
+ExtensionHandle createConditionalExecutionExtension() {
+    return std::make_unique<ConditionalExecutionExtension>();
+}
+
+/********************************** COMMANDS **********************************/
+
+void BeginConditionalCommand::record(vulkan::Command& cmd) const {
+    auto& _tensor = tensor.get();
+    auto& context = *_tensor.getContext();
+    auto buffer = _tensor.getBuffer().buffer;
+    //tensor might be sub-allocated from a shared buffer
+    auto offset = this->offset + _tensor.getBuffer().offset;
+
+    cmd.stage |= VK_PIPELINE_STAGE_2_CONDITIONAL_RENDERING_BIT_EXT;
+
+    //ensure the predicate is complete
+    if (cmd.tracker) {
+        cmd.tracker->buffer(buffer, offset, 4,
+            VK_PIPELINE_STAGE_2_CONDITIONAL_RENDERING_BIT_EXT,
+            VK_ACCESS_2_CONDITIONAL_RENDERING_READ_BIT_EXT);
+        cmd.tracker->barrier(context, cmd);
+    }
+    else {
+        vulkan::pipelineBarrier(context, cmd, vulkan::BufferBarrier{
+            .srcStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+            .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+            .dstStage = VK_PIPELINE_STAGE_2_CONDITIONAL_RENDERING_BIT_EXT,
+            .dstAccess = VK_ACCESS_2_CONDITIONAL_RENDERING_READ_BIT_EXT,
+            .buffer = buffer,
+            .offset = offset,
+            .size = 4
+        });
+    }
+
+    VkConditionalRenderingBeginInfoEXT info{
+        .sType = VK_STRUCTURE_TYPE_CONDITIONAL_RENDERING_BEGIN_INFO_EXT,
+        .buffer = buffer,
+        .offset = offset,
+        .flags = inverted ? VK_CONDITIONAL_RENDERING_INVERTED_BIT_EXT : 0u
+    };
+    context.fnTable.vkCmdBeginConditionalRenderingEXT(cmd.buffer, &info);
+}
+
+BeginConditionalCommand::BeginConditionalCommand(const BeginConditionalCommand&) = default;
+BeginConditionalCommand& BeginConditionalCommand::operator=(const BeginConditionalCommand&) = default;
+
+BeginConditionalCommand::BeginConditionalCommand(
+    const Tensor<std::byte>& tensor, uint64_t offset, bool inverted)
+    : tensor(std::cref(tensor))
+    , offset(offset)
+    , inverted(inverted)
+{
+    if (!isConditionalExecutionEnabled(tensor.getContext()))
+        throw std::logic_error("Conditional execution is not enabled!");
+    if (offset % 4 != 0)
+        throw std::logic_error("Offset of the predicate must be a multiple of 4!");
+    if (offset + 4 > tensor.size_bytes())
+        throw std::logic_error("Predicate is not contained within the tensor!");
+}
+BeginConditionalCommand::~BeginConditionalCommand() = default;
+
+void EndConditionalCommand::record(vulkan::Command& cmd) const {
+    context.get().fnTable.vkCmdEndConditionalRenderingEXT(cmd.buffer);
+}
+
+EndConditionalCommand::EndConditionalCommand(const EndConditionalCommand&) = default;
+EndConditionalCommand& EndConditionalCommand::operator=(const EndConditionalCommand&) = default;
+
+EndConditionalCommand::EndConditionalCommand(const ContextHandle& context)
+    : context(*context)
+{}
+EndConditionalCommand::~EndConditionalCommand() = default;
+
+}
@@ -2,13 +2,23 @@
 
 #include <algorithm>
 #include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 #include "hephaistos/handles.hpp"
+#include "vk/completion.hpp"
 #include "vk/instance.hpp"
+#include "vk/layout.hpp"
 #include "vk/result.hpp"
 #include "vk/types.hpp"
+#include "vk/util.hpp"
 
 namespace hephaistos {
 
@@ -22,7 +32,8 @@ bool isVulkanAvailable() {
 namespace {
 
 constexpr VkQueueFlags QueueFlags = VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
-constexpr float QueuePriority = 1.0f;
+//at most two queues per family
+constexpr auto QueuePriorities = std::to_array({ 1.0f, 1.0f });
 
 constexpr auto DeviceExtensions = std::to_array({
     VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME,
@@ -35,47 +46,8 @@ void destroyDevice(vulkan::Device* device) {
     vulkan::returnInstance();
 }
 
-DeviceHandle createDevice(VkPhysicalDevice device) {
-    //increment instance ref count
-    vulkan::getInstance();
-
-    //query extensions
-    uint32_t count;
-    vulkan::checkResult(vkEnumerateDeviceExtensionProperties(device, nullptr, &count, nullptr));
-    std::vector<VkExtensionProperties> extensions(count);
-    vulkan::checkResult(vkEnumerateDeviceExtensionProperties(device, nullptr, &count, extensions.data()));
-
-    //allocate handle
-    DeviceHandle result{
-        new vulkan::Device{ device, std::vector<std::string>(count) },
-        destroyDevice
-    };
-
-    //copy extensions
-    std::transform(extensions.begin(), extensions.end(), result->supportedExtensions.begin(),
-        [](VkExtensionProperties prop) -> std::string { return std::string(prop.extensionName); });
-    //sort extensions for std::includes
-    std::sort(result->supportedExtensions.begin(), result->supportedExtensions.end());
-
-    //done
-    return result;
-};
-
-DeviceInfo createInfo(VkPhysicalDevice device) {
-    //retrieve props
-    VkPhysicalDeviceProperties props;
-    vkGetPhysicalDeviceProperties(device, &props);
-
-    //return and build info
-    return {
-        .name       = props.deviceName,
-        .isDiscrete = props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU
-    };
-}
-
-}
-
-bool isDeviceSuitable(const DeviceHandle& device, std::span<const ExtensionHandle> extensions) {
+//checks the requirements of hephaistos itself
+bool meetsRequirements(VkPhysicalDevice device, const std::vector<std::string>& extensions) {
     //Check for the following things:
     //    - Compute queue
     //    - feature support
@@ -90,7 +62,7 @@ bool isDeviceSuitable(const DeviceHandle& device, std::span<const ExtensionHandl
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
             .pNext = &features12
         };
-        vkGetPhysicalDeviceFeatures2(device->device, &features);
+        vkGetPhysicalDeviceFeatures2(device, &features);
         //timeline sempahore feature
         if (!features12.timelineSemaphore)
             return false;
@@ -108,9 +80,9 @@ bool isDeviceSuitable(const DeviceHandle& device, std::span<const ExtensionHandl
     //check for compute queue
     {
         uint32_t count;
-        vkGetPhysicalDeviceQueueFamilyProperties(device->device, &count, nullptr);
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &count, nullptr);
         std::vector<VkQueueFamilyProperties> props(count);
-        vkGetPhysicalDeviceQueueFamilyProperties(device->device, &count, props.data());
+        vkGetPhysicalDeviceQueueFamilyProperties(device, &count, props.data());
         bool found = false;
         for (auto& queue : props) {
             if ((queue.queueFlags & QueueFlags) == QueueFlags) {
@@ -124,14 +96,245 @@ bool isDeviceSuitable(const DeviceHandle& device, std::span<const ExtensionHandl
 
     //Check for internal extension support
     if (!DeviceExtensions.empty() && !std::includes(
-        device->supportedExtensions.begin(),
-        device->supportedExtensions.end(),
-        DeviceExtensions.begin(),
-        DeviceExtensions.end()))
+        extensions.begin(), extensions.end(),
+        DeviceExtensions.begin(), DeviceExtensions.end()))
     {
         return false;
     }
 
+    //Everything checked
+    return true;
+}
+
+//querying devices dominates the start up of short running applications
+// -> query each one once per instance
+struct CachedDevice {
+    VkPhysicalDevice device;
+    //sorted for std::includes
+    std::vector<std::string> extensions;
+    //outcome of meetsRequirements()
+    bool suitable;
+};
+std::mutex deviceCacheMutex;
+std::vector<CachedDevice> deviceCache;
+//generation of the instance the cache was filled from; zero if empty
+uint64_t deviceCacheGeneration = 0;
+
+//returns the cached physical devices of the current instance
+//caller must hold a reference to the instance, so the cache stays valid
+const std::vector<CachedDevice>& getCachedDevices() {
+    std::lock_guard<std::mutex> lock(deviceCacheMutex);
+    auto generation = vulkan::getInstanceGeneration();
+    if (deviceCacheGeneration == generation)
+        return deviceCache;
+
+    //the old devices were part of an already destroyed instance
+    deviceCache.clear();
+    auto instance = vulkan::getInstance();
+    uint32_t count;
+    vkEnumeratePhysicalDevices(instance, &count, nullptr);
+    std::vector<VkPhysicalDevice> devices(count);
+    vkEnumeratePhysicalDevices(instance, &count, devices.data());
+    vulkan::returnInstance();
+
+    for (auto device : devices) {
+        uint32_t extCount;
+        vulkan::checkResult(vkEnumerateDeviceExtensionProperties(device, nullptr, &extCount, nullptr));
+        std::vector<VkExtensionProperties> props(extCount);
+        vulkan::checkResult(vkEnumerateDeviceExtensionProperties(device, nullptr, &extCount, props.data()));
+
+        CachedDevice cached{ device, std::vector<std::string>(extCount), false };
+        std::transform(props.begin(), props.end(), cached.extensions.begin(),
+            [](const VkExtensionProperties& prop) { return std::string(prop.extensionName); });
+        std::sort(cached.extensions.begin(), cached.extensions.end());
+        cached.suitable = meetsRequirements(device, cached.extensions);
+        deviceCache.push_back(std::move(cached));
+    }
+    deviceCacheGeneration = generation;
+    return deviceCache;
+}
+
+const CachedDevice& getCachedDevice(VkPhysicalDevice device) {
+    auto& devices = getCachedDevices();
+    auto it = std::find_if(devices.begin(), devices.end(),
+        [device](const CachedDevice& cached) { return cached.device == device; });
+    if (it == devices.end())
+        throw std::logic_error("Device does not belong to the current instance!");
+    return *it;
+}
+
+DeviceHandle createDevice(VkPhysicalDevice device) {
+    //increment instance ref count
+    vulkan::getInstance();
+    DeviceHandle result{
+        new vulkan::Device{ device, {} },
+        destroyDevice
+    };
+    result->supportedExtensions = getCachedDevice(device).extensions;
+    return result;
+};
+
+std::string getVendorName(uint32_t vendorID) {
+    switch (vendorID) {
+    case 0x1002: return "AMD";
+    case 0x1010: return "ImgTec";
+    case 0x106B: return "Apple";
+    case 0x10DE: return "NVIDIA";
+    case 0x13B5: return "ARM";
+    case 0x1414: return "Microsoft";
+    case 0x5143: return "Qualcomm";
+    case 0x8086: return "Intel";
+    case VK_VENDOR_ID_MESA: return "Mesa";
+    default: return "Unknown";
+    }
+}
+
+DeviceInfo createInfo(VkPhysicalDevice device) {
+    //compute unit counts are only reported via vendor extensions
+    auto& extensions = getCachedDevice(device).extensions;
+    auto hasExtension = [&extensions](std::string_view name) {
+        return std::binary_search(extensions.begin(), extensions.end(), name);
+    };
+
+    //retrieve props
+    VkPhysicalDeviceShaderCorePropertiesAMD amdCores{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_CORE_PROPERTIES_AMD
+    };
+    VkPhysicalDeviceShaderSMBuiltinsPropertiesNV nvCores{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_SM_BUILTINS_PROPERTIES_NV
+    };
+    VkPhysicalDeviceSubgroupProperties subgroup{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES
+    };
+    VkPhysicalDeviceDriverProperties driver{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DRIVER_PROPERTIES,
+        .pNext = &subgroup
+    };
+    VkPhysicalDeviceIDProperties id{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES,
+        .pNext = &driver
+    };
+    VkPhysicalDeviceProperties2 props2{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &id
+    };
+    if (hasExtension(VK_AMD_SHADER_CORE_PROPERTIES_EXTENSION_NAME)) {
+        amdCores.pNext = props2.pNext;
+        props2.pNext = &amdCores;
+    }
+    if (hasExtension(VK_NV_SHADER_SM_BUILTINS_EXTENSION_NAME)) {
+        nvCores.pNext = props2.pNext;
+        props2.pNext = &nvCores;
+    }
+    vkGetPhysicalDeviceProperties2(device, &props2);
+    auto& props = props2.properties;
+
+    uint32_t computeUnits = 0;
+    if (hasExtension(VK_AMD_SHADER_CORE_PROPERTIES_EXTENSION_NAME)) {
+        computeUnits = amdCores.shaderEngineCount *
+            amdCores.shaderArraysPerEngineCount *
+            amdCores.computeUnitsPerShaderArray;
+    }
+    if (hasExtension(VK_NV_SHADER_SM_BUILTINS_EXTENSION_NAME))
+        computeUnits = nvCores.shaderSMCount;
+
+    //largest device local heap, i.e. VRAM on discrete devices
+    VkPhysicalDeviceMemoryProperties memory;
+    vkGetPhysicalDeviceMemoryProperties(device, &memory);
+    uint64_t deviceMemory = 0;
+    for (auto i = 0u; i < memory.memoryHeapCount; ++i) {
+        auto& heap = memory.memoryHeaps[i];
+        if (heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+            deviceMemory = std::max<uint64_t>(deviceMemory, heap.size);
+    }
+
+    std::string driverInfo = driver.driverName;
+    if (driver.driverInfo[0] != '\0') {
+        driverInfo += ' ';
+        driverInfo += driver.driverInfo;
+    }
+
+    //return and build info
+    DeviceInfo info{
+        .name       = props.deviceName,
+        .isDiscrete = props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU,
+        .vendor     = getVendorName(props.vendorID),
+        .vendorID   = props.vendorID,
+        .deviceID   = props.deviceID,
+        .uuid       = {},
+        .driverVersion = props.driverVersion,
+        .driverInfo = std::move(driverInfo),
+        .deviceMemory = deviceMemory,
+        .computeUnits = computeUnits,
+        .subgroupSize = subgroup.subgroupSize,
+        .maxWorkGroupInvocations = props.limits.maxComputeWorkGroupInvocations,
+        .maxSharedMemorySize = props.limits.maxComputeSharedMemorySize
+    };
+    std::copy(std::begin(id.deviceUUID), std::end(id.deviceUUID), info.uuid.begin());
+    return info;
+}
+
+DeviceLimits createLimits(VkPhysicalDevice device) {
+    VkPhysicalDeviceMaintenance3Properties maintenance3{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_3_PROPERTIES
+    };
+    VkPhysicalDeviceProperties2 props2{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &maintenance3
+    };
+    vkGetPhysicalDeviceProperties2(device, &props2);
+    auto& limits = props2.properties.limits;
+
+    VkPhysicalDeviceMemoryProperties memory;
+    vkGetPhysicalDeviceMemoryProperties(device, &memory);
+    std::vector<uint64_t> heapSizes(memory.memoryHeapCount);
+    for (auto i = 0u; i < memory.memoryHeapCount; ++i)
+        heapSizes[i] = memory.memoryHeaps[i].size;
+
+    DeviceLimits result{
+        .maxWorkGroupCount       = {},
+        .maxWorkGroupSize        = {},
+        .maxWorkGroupInvocations = limits.maxComputeWorkGroupInvocations,
+        .maxSharedMemorySize     = limits.maxComputeSharedMemorySize,
+        .maxStorageBufferRange   = limits.maxStorageBufferRange,
+        .maxUniformBufferRange   = limits.maxUniformBufferRange,
+        .maxPushConstantsSize    = limits.maxPushConstantsSize,
+        .maxMemoryAllocationSize = maintenance3.maxMemoryAllocationSize,
+        .heapSizes               = std::move(heapSizes),
+        .timestampPeriod         = limits.timestampPeriod
+    };
+    std::copy(
+        std::begin(limits.maxComputeWorkGroupCount),
+        std::end(limits.maxComputeWorkGroupCount),
+        result.maxWorkGroupCount.begin());
+    std::copy(
+        std::begin(limits.maxComputeWorkGroupSize),
+        std::end(limits.maxComputeWorkGroupSize),
+        result.maxWorkGroupSize.begin());
+    return result;
+}
+
+//true, if device a is expected to outperform device b
+bool isFaster(const DeviceInfo& a, const DeviceInfo& b) {
+    //discrete devices always beat integrated ones
+    if (a.isDiscrete != b.isDiscrete)
+        return a.isDiscrete;
+    //estimate throughput by the amount of lanes, if both report it
+    uint64_t lanesA = uint64_t(a.computeUnits) * a.subgroupSize;
+    uint64_t lanesB = uint64_t(b.computeUnits) * b.subgroupSize;
+    if (lanesA && lanesB && lanesA != lanesB)
+        return lanesA > lanesB;
+    //bigger devices usually come with more memory
+    return a.deviceMemory > b.deviceMemory;
+}
+
+}
+
+bool isDeviceSuitable(const DeviceHandle& device, std::span<const ExtensionHandle> extensions) {
+    //requirements of hephaistos itself are checked once per device
+    if (!getCachedDevice(device->device).suitable)
+        return false;
+
     //check for external extension support
     for (auto& ext : extensions) {
         if (!ext->isDeviceSupported(device))
@@ -144,18 +347,12 @@ bool isDeviceSuitable(const DeviceHandle& device, std::span<const ExtensionHandl
 
 std::vector<DeviceHandle> enumerateDevices() {
     //get instance
-    auto instance = vulkan::getInstance();
-
-    //get all devices
-    uint32_t count;
-    vkEnumeratePhysicalDevices(instance, &count, nullptr);
-    std::vector<VkPhysicalDevice> devices(count);
-    vkEnumeratePhysicalDevices(instance, &count, devices.data());
+    vulkan::getInstance();
 
     //transform supported devices
     std::vector<DeviceHandle> result;
-    for (auto device : devices) {
-        result.push_back(createDevice(device));
+    for (auto& cached : getCachedDevices()) {
+        result.push_back(createDevice(cached.device));
     }
 
     //we only needed the instance for the enumerate command
@@ -178,22 +375,321 @@ DeviceInfo getDeviceInfo(const ContextHandle& context) {
     return createInfo(context->physicalDevice);
 }
 
+DeviceLimits getDeviceLimits(const DeviceHandle& device) {
+    return createLimits(device->device);
+}
+
+DeviceLimits getDeviceLimits(const ContextHandle& context) {
+    return createLimits(context->physicalDevice);
+}
+
+bool hasDedicatedQueue(const ContextHandle& context, QueueType type) {
+    if (type == QueueType::MAIN)
+        return true;
+    return context->queues[static_cast<size_t>(type)].queue != context->queue;
+}
+
+namespace {
+
+constexpr auto QueuePriorityExtensionName = "QueuePriority";
+
+VkQueueGlobalPriorityKHR toVkPriority(QueuePriority priority) {
+    switch (priority) {
+    case QueuePriority::LOW: return VK_QUEUE_GLOBAL_PRIORITY_LOW_KHR;
+    case QueuePriority::HIGH: return VK_QUEUE_GLOBAL_PRIORITY_HIGH_KHR;
+    case QueuePriority::REALTIME: return VK_QUEUE_GLOBAL_PRIORITY_REALTIME_KHR;
+    default: return VK_QUEUE_GLOBAL_PRIORITY_MEDIUM_KHR;
+    }
+}
+
+class QueuePriorityExtension : public Extension {
+public:
+    bool isDeviceSupported(const DeviceHandle& device) const override {
+        return isQueuePrioritySupported(device);
+    }
+    std::string_view getExtensionName() const override {
+        return QueuePriorityExtensionName;
+    }
+    std::span<const char* const> getDeviceExtensions() const override {
+        //KHR or EXT variant gets picked during context creation
+        return {};
+    }
+    void* chain(void* pNext) override {
+        //priority is chained to the queues instead
+        return pNext;
+    }
+
+    QueuePriority priority;
+
+    QueuePriorityExtension(QueuePriority priority)
+        : priority(priority)
+    {}
+    virtual ~QueuePriorityExtension() = default;
+};
+
+}
+
+bool isQueuePrioritySupported(const DeviceHandle& device) {
+    if (!device)
+        return false;
+    auto& ext = device->supportedExtensions;
+    return std::binary_search(ext.begin(), ext.end(),
+            std::string_view(VK_KHR_GLOBAL_PRIORITY_EXTENSION_NAME)) ||
+        std::binary_search(ext.begin(), ext.end(),
+            std::string_view(VK_EXT_GLOBAL_PRIORITY_EXTENSION_NAME));
+}
+QueuePriority getQueuePriority(const ContextHandle& context) {
+    return context->queuePriority;
+}
+ExtensionHandle createQueuePriorityExtension(QueuePriority priority) {
+    return std::make_unique<QueuePriorityExtension>(priority);
+}
+
+bool isMemoryBudgetSupported(const ContextHandle& context) {
+    return context->memoryBudget;
+}
+bool isMemoryPrioritySupported(const ContextHandle& context) {
+    return context->memoryPriority;
+}
+bool isUnifiedMemorySupported(const ContextHandle& context) {
+    return context->unifiedMemory;
+}
+
+MemoryStatistics getMemoryStatistics(const ContextHandle& context) {
+    const VkPhysicalDeviceMemoryProperties* props;
+    vmaGetMemoryProperties(context->allocator, &props);
+    std::vector<VmaBudget> budgets(props->memoryHeapCount);
+    vmaGetHeapBudgets(context->allocator, budgets.data());
+    VmaTotalStatistics stats;
+    vmaCalculateStatistics(context->allocator, &stats);
+
+    MemoryStatistics result{
+        .heaps = std::vector<HeapStatistics>(props->memoryHeapCount),
+        .blockCount = stats.total.statistics.blockCount,
+        .blockBytes = stats.total.statistics.blockBytes,
+        .allocationCount = stats.total.statistics.allocationCount,
+        .allocationBytes = stats.total.statistics.allocationBytes
+    };
+    for (auto i = 0u; i < props->memoryHeapCount; ++i) {
+        auto& heap = stats.memoryHeap[i];
+        result.heaps[i] = HeapStatistics{
+            .deviceLocal = (props->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+            .size = props->memoryHeaps[i].size,
+            .usage = budgets[i].usage,
+            .budget = budgets[i].budget,
+            .blockCount = heap.statistics.blockCount,
+            .blockBytes = heap.statistics.blockBytes,
+            .allocationCount = heap.statistics.allocationCount,
+            .allocationBytes = heap.statistics.allocationBytes,
+            .largestFreeRange = heap.unusedRangeSizeMax
+        };
+    }
+    return result;
+}
+
+ContextStatistics getContextStatistics(const ContextHandle& context) {
+    auto& counters = context->counters;
+    auto load = [](const std::atomic<uint64_t>& counter) {
+        return counter.load(std::memory_order_relaxed);
+    };
+    return {
+        .submissions = load(counters.submissions),
+        .commandBuffers = load(counters.commandBuffers),
+        .oneTimeSubmits = load(counters.oneTimeSubmits),
+        .bytesUploaded = load(counters.bytesUploaded),
+        .bytesDownloaded = load(counters.bytesDownloaded),
+        .dispatches = load(counters.dispatches),
+        .barriers = load(counters.barriers),
+        .pipelineCacheHits = load(counters.pipelineCacheHits),
+        .pipelineCacheMisses = load(counters.pipelineCacheMisses)
+    };
+}
+
+/******************************** PIPELINE CACHE *****************************/
+
+namespace {
+
+//checks the data was created by the same driver on the same device
+bool isPipelineCacheCompatible(VkPhysicalDevice device, const std::vector<char>& data) {
+    VkPipelineCacheHeaderVersionOne header;
+    if (data.size() < sizeof(header))
+        return false;
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(device, &props);
+    return header.headerSize >= sizeof(header) &&
+        header.headerSize <= data.size() &&
+        header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+        header.vendorID == props.vendorID &&
+        header.deviceID == props.deviceID &&
+        std::equal(
+            std::begin(header.pipelineCacheUUID),
+            std::end(header.pipelineCacheUUID),
+            std::begin(props.pipelineCacheUUID));
+}
+
+bool mergePipelineCache(const vulkan::Context& context, const std::vector<char>& data) {
+    if (!isPipelineCacheCompatible(context.physicalDevice, data))
+        return false;
+
+    //the context's cache may already contain pipelines -> merge
+    VkPipelineCacheCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = data.size(),
+        .pInitialData = data.data()
+    };
+    VkPipelineCache cache;
+    vulkan::checkResult(context.fnTable.vkCreatePipelineCache(
+        context.device, &info, nullptr, &cache));
+    auto result = context.fnTable.vkMergePipelineCaches(
+        context.device, context.cache, 1, &cache);
+    context.fnTable.vkDestroyPipelineCache(context.device, cache, nullptr);
+    vulkan::checkResult(result);
+
+    return true;
+}
+
+std::vector<char> getPipelineCacheData(const vulkan::Context& context) {
+    size_t size;
+    vulkan::checkResult(context.fnTable.vkGetPipelineCacheData(
+        context.device, context.cache, &size, nullptr));
+    std::vector<char> data(size);
+    vulkan::checkResult(context.fnTable.vkGetPipelineCacheData(
+        context.device, context.cache, &size, data.data()));
+    data.resize(size);
+    return data;
+}
+
+bool loadPipelineCache(const vulkan::Context& context, const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    std::vector<char> data{
+        std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>()
+    };
+    return mergePipelineCache(context, data);
+}
+
+void savePipelineCache(const vulkan::Context& context, const std::filesystem::path& path) {
+    auto data = getPipelineCacheData(context);
+    auto size = data.size();
+
+    //write to temporary file first, so other processes never read partial data
+    auto tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(size));
+        if (!file)
+            throw std::runtime_error("Failed to write pipeline cache!");
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        throw std::runtime_error("Failed to write pipeline cache!");
+    }
+}
+
+}
+
+namespace {
+
+//shared contexts use the pipeline cache of their primary context
+vulkan::Context& getCacheOwner(const ContextHandle& context) {
+    return context->parent ? *context->parent : *context;
+}
+
+}
+
+bool loadPipelineCache(const ContextHandle& context, const std::filesystem::path& path) {
+    auto& owner = getCacheOwner(context);
+    std::lock_guard<std::mutex> lock(owner.cacheMutex);
+    return loadPipelineCache(owner, path);
+}
+void savePipelineCache(const ContextHandle& context, const std::filesystem::path& path) {
+    auto& owner = getCacheOwner(context);
+    std::lock_guard<std::mutex> lock(owner.cacheMutex);
+    savePipelineCache(owner, path);
+}
+
+bool setPipelineCacheFile(const ContextHandle& context, const std::filesystem::path& path) {
+    auto& owner = getCacheOwner(context);
+    std::lock_guard<std::mutex> lock(owner.cacheMutex);
+    owner.cacheFile = path;
+    return !path.empty() && loadPipelineCache(owner, path);
+}
+std::filesystem::path getPipelineCacheFile(const ContextHandle& context) {
+    auto& owner = getCacheOwner(context);
+    std::lock_guard<std::mutex> lock(owner.cacheMutex);
+    return owner.cacheFile;
+}
+
+bool sharePipelineCache(const ContextHandle& source, const ContextHandle& destination) {
+    auto& src = getCacheOwner(source);
+    auto& dst = getCacheOwner(destination);
+    if (&src == &dst)
+        return true;
+
+    //copy first, so both locks are never held at once
+    std::vector<char> data;
+    {
+        std::lock_guard<std::mutex> lock(src.cacheMutex);
+        data = getPipelineCacheData(src);
+    }
+    std::lock_guard<std::mutex> lock(dst.cacheMutex);
+    return mergePipelineCache(dst, data);
+}
+
 /*********************************** CONTEXT *********************************/
 
 namespace {
 
+//releases what a shared context owns; the rest belongs to its primary one
+void destroySharedContext(vulkan::Context* context) {
+    vulkan::destroyCompletionService(*context);
+    vulkan::destroyRetiredResources(*context);
+    vulkan::destroyStagingRing(*context);
+    vulkan::destroyScratchArena(*context);
+    vulkan::destroyBufferPools(*context);
+    if (context->exportPool)
+        vmaDestroyPool(context->allocator, context->exportPool);
+    context->layoutCache.reset();
+    vulkan::destroySamplers(*context);
+    vulkan::destroyOneTimeSubmitSlots(*context);
+    vulkan::destroySequencePools(*context);
+    for (auto semaphore : context->timelinePool)
+        context->fnTable.vkDestroySemaphore(context->device, semaphore, nullptr);
+    //might destroy the primary context
+    context->parent.reset();
+}
+
 void destroyContext(vulkan::Context* context) {
+    vulkan::destroyCompletionService(*context);
+    vulkan::destroyRetiredResources(*context);
+    //persist pipeline cache if requested; a deleter must not throw
+    if (!context->cacheFile.empty()) {
+        try {
+            savePipelineCache(*context, context->cacheFile);
+        }
+        catch (...) {}
+    }
+    vulkan::destroyStagingRing(*context);
+    vulkan::destroyScratchArena(*context);
+    vulkan::destroyBufferPools(*context);
+    if (context->exportPool)
+        vmaDestroyPool(context->allocator, context->exportPool);
     if (context->allocator)
         vmaDestroyAllocator(context->allocator);
+    context->layoutCache.reset();
+    vulkan::destroySamplers(*context);
     context->fnTable.vkDestroyPipelineCache(context->device, context->cache, nullptr);
-    context->fnTable.vkDestroyFence(context->device, context->oneTimeSubmitFence, nullptr);
-    context->fnTable.vkDestroyCommandPool(context->device, context->oneTimeSubmitPool, nullptr);
-    context->fnTable.vkDestroyCommandPool(context->device, context->subroutinePool, nullptr);
-    while (!context->sequencePool.empty()) {
-        context->fnTable.vkDestroyCommandPool(
-            context->device, context->sequencePool.front(), nullptr);
-        context->sequencePool.pop();
-    }
+    vulkan::destroyOneTimeSubmitSlots(*context);
+    vulkan::destroySequencePools(*context);
+    for (auto semaphore : context->timelinePool)
+        context->fnTable.vkDestroySemaphore(context->device, semaphore, nullptr);
     context->fnTable.vkDestroyDevice(context->device, nullptr);
     vulkan::returnInstance();
 }
@@ -206,9 +702,18 @@ ContextHandle createContext(
     //Allocate memory
     ContextHandle context{ new vulkan::Context, destroyContext };
     context->physicalDevice = device;
+    context->debugUtils = vulkan::isDebugUtilsEnabled();
 
     //query queue family
     uint32_t family = 0;
+    //sparse binding is only done on the main queue
+    bool sparseQueue = false;
+    //queues to create per family
+    std::vector<VkDeviceQueueCreateInfo> queueInfos;
+    //(family, index) of each queue type
+    std::array<std::pair<uint32_t, uint32_t>, vulkan::QueueTypeCount> queueIndices;
+    //capabilities of each queue type's family
+    std::array<VkQueueFlags, vulkan::QueueTypeCount> queueFlags;
     {
         uint32_t count;
         vkGetPhysicalDeviceQueueFamilyProperties(device, &count, nullptr);
@@ -218,25 +723,110 @@ ContextHandle createContext(
             if (props[family].queueFlags & QueueFlags)
                 break;
         }
+
+        sparseQueue = (props[family].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT) != 0;
+
+        //by default every queue aliases the main one
+        queueIndices.fill({ family, 0 });
+        std::vector<uint32_t> queueCounts(count, 0);
+        queueCounts[family] = 1;
+
+        //look for a transfer only family (DMA engines)
+        for (uint32_t i = 0; i < count; ++i) {
+            auto flags = props[i].queueFlags;
+            if (i != family && (flags & VK_QUEUE_TRANSFER_BIT) &&
+                !(flags & (VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT)))
+            {
+                queueIndices[static_cast<size_t>(QueueType::TRANSFER)] = { i, 0 };
+                queueCounts[i] = 1;
+                break;
+            }
+        }
+        //look for an additional compute queue
+        //prefer the main family to not need concurrent sharing
+        auto& compute = queueIndices[static_cast<size_t>(QueueType::COMPUTE)];
+        if (props[family].queueCount > 1) {
+            compute = { family, 1 };
+            queueCounts[family] = 2;
+        }
+        else {
+            for (uint32_t i = 0; i < count; ++i) {
+                if (queueCounts[i] == 0 &&
+                    (props[i].queueFlags & QueueFlags) == QueueFlags)
+                {
+                    compute = { i, 0 };
+                    queueCounts[i] = 1;
+                    break;
+                }
+            }
+        }
+
+        for (auto i = 0u; i < vulkan::QueueTypeCount; ++i)
+            queueFlags[i] = props[queueIndices[i].first].queueFlags;
+
+        //collect create infos
+        for (uint32_t i = 0; i < count; ++i) {
+            if (queueCounts[i] == 0)
+                continue;
+            queueInfos.push_back(VkDeviceQueueCreateInfo{
+                .sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+                .queueFamilyIndex = i,
+                .queueCount       = queueCounts[i],
+                .pQueuePriorities = QueuePriorities.data()
+            });
+            context->queueFamilies.push_back(i);
+        }
     }
     context->queueFamily = family;
 
     //Create logical device
     {
         //check for certain shader subgroup features
+        VkPhysicalDeviceSynchronization2FeaturesKHR sync2{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR
+        };
         VkPhysicalDeviceShaderSubgroupUniformControlFlowFeaturesKHR controlFlow{
-            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_SUBGROUP_UNIFORM_CONTROL_FLOW_FEATURES_KHR
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_SUBGROUP_UNIFORM_CONTROL_FLOW_FEATURES_KHR,
+            .pNext = &sync2
         };
         VkPhysicalDeviceShaderMaximalReconvergenceFeaturesKHR reconvergence{
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_MAXIMAL_RECONVERGENCE_FEATURES_KHR,
             .pNext = &controlFlow
         };
+        VkPhysicalDeviceSubgroupSizeControlFeaturesEXT sizeControl{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_FEATURES_EXT,
+            .pNext = &reconvergence
+        };
+        VkPhysicalDevicePipelineExecutablePropertiesFeaturesKHR executableInfo{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_EXECUTABLE_PROPERTIES_FEATURES_KHR,
+            .pNext = &sizeControl
+        };
+        VkPhysicalDeviceRobustness2FeaturesEXT robustness2{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ROBUSTNESS_2_FEATURES_EXT,
+            .pNext = &executableInfo
+        };
+        VkPhysicalDevicePipelineRobustnessFeaturesEXT pipelineRobustness{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_ROBUSTNESS_FEATURES_EXT,
+            .pNext = &robustness2
+        };
+        VkPhysicalDeviceShaderFloatControls2FeaturesKHR floatControls2{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT_CONTROLS_2_FEATURES_KHR,
+            .pNext = &pipelineRobustness
+        };
+        VkPhysicalDeviceVulkanMemoryModelFeatures memoryModel{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_MEMORY_MODEL_FEATURES,
+            .pNext = &floatControls2
+        };
         //Check for extended arithmetic type support (e.f. float64)
         //and enable them by default
         //(since we can't reasonable chain basic feature set)
+        VkPhysicalDeviceMemoryPriorityFeaturesEXT memoryPriority{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT,
+            .pNext = &memoryModel
+        };
         VkPhysicalDeviceVulkan12Features features12{
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
-            .pNext = &reconvergence
+            .pNext = &memoryPriority
         };
         VkPhysicalDeviceFeatures2 features2{
             .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
@@ -269,7 +859,26 @@ ContextHandle createContext(
                 allDeviceExtensions.end(),
                 extNames.begin(), extNames.end());
             //save extension
-            context->extensions.emplace_back(std::move(ext));
+            context->extensions->emplace_back(std::move(ext));
+        }
+        //global queue priority is chained to the queues instead of the device
+        VkDeviceQueueGlobalPriorityCreateInfoKHR globalPriority{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_GLOBAL_PRIORITY_CREATE_INFO_KHR
+        };
+        for (auto& ext : *context->extensions) {
+            if (ext->getExtensionName() != QueuePriorityExtensionName)
+                continue;
+            auto priority = static_cast<QueuePriorityExtension*>(ext.get())->priority;
+            auto& supported = getCachedDevice(device).extensions;
+            auto name = std::binary_search(supported.begin(), supported.end(),
+                std::string_view(VK_KHR_GLOBAL_PRIORITY_EXTENSION_NAME))
+                ? VK_KHR_GLOBAL_PRIORITY_EXTENSION_NAME
+                : VK_EXT_GLOBAL_PRIORITY_EXTENSION_NAME;
+            allDeviceExtensions.push_back(name);
+            globalPriority.globalPriority = toVkPriority(priority);
+            for (auto& queueInfo : queueInfos)
+                queueInfo.pNext = &globalPriority;
+            context->queuePriority = priority;
         }
 
         //chain optional features if available
@@ -285,13 +894,153 @@ ContextHandle createContext(
             allDeviceExtensions.push_back(
                 VK_KHR_SHADER_MAXIMAL_RECONVERGENCE_EXTENSION_NAME);
         }
-        //obligatory features
-        VkDeviceQueueCreateInfo queueInfo{
-            .sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
-            .queueFamilyIndex = family,
-            .queueCount       = 1,
-            .pQueuePriorities = &QueuePriority
+        if (sizeControl.subgroupSizeControl) {
+            sizeControl.pNext = pNext;
+            pNext = static_cast<void*>(&sizeControl);
+            allDeviceExtensions.push_back(
+                VK_EXT_SUBGROUP_SIZE_CONTROL_EXTENSION_NAME);
+            context->subgroupSizeControl = true;
+            context->computeFullSubgroups = sizeControl.computeFullSubgroups == VK_TRUE;
+        }
+        if (memoryPriority.memoryPriority) {
+            memoryPriority.pNext = pNext;
+            pNext = static_cast<void*>(&memoryPriority);
+            allDeviceExtensions.push_back(
+                VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME);
+            context->memoryPriority = true;
+        }
+        if (executableInfo.pipelineExecutableInfo) {
+            executableInfo.pNext = pNext;
+            pNext = static_cast<void*>(&executableInfo);
+            allDeviceExtensions.push_back(
+                VK_KHR_PIPELINE_EXECUTABLE_PROPERTIES_EXTENSION_NAME);
+            context->pipelineExecutableInfo = true;
+        }
+        //robustness costs performance, thus only enabled if requested
+        auto robustBufferAccess = vulkan::isRobustBufferAccessRequested() &&
+            features2.features.robustBufferAccess;
+        if (robustBufferAccess && robustness2.robustBufferAccess2) {
+            robustness2 = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ROBUSTNESS_2_FEATURES_EXT,
+                .pNext = pNext,
+                .robustBufferAccess2 = VK_TRUE
+            };
+            pNext = static_cast<void*>(&robustness2);
+            allDeviceExtensions.push_back(
+                VK_EXT_ROBUSTNESS_2_EXTENSION_NAME);
+        }
+        if (pipelineRobustness.pipelineRobustness) {
+            pipelineRobustness.pNext = pNext;
+            pNext = static_cast<void*>(&pipelineRobustness);
+            allDeviceExtensions.push_back(
+                VK_EXT_PIPELINE_ROBUSTNESS_EXTENSION_NAME);
+            context->pipelineRobustness = true;
+        }
+        //only changes code compiled with fast math
+        if (floatControls2.shaderFloatControls2) {
+            floatControls2.pNext = pNext;
+            pNext = static_cast<void*>(&floatControls2);
+            allDeviceExtensions.push_back(
+                VK_KHR_SHADER_FLOAT_CONTROLS_2_EXTENSION_NAME);
+            context->floatControls2 = true;
+        }
+        //core since Vulkan 1.2, thus no extension to enable; only affects
+        //code compiled for the Vulkan memory model
+        if (memoryModel.vulkanMemoryModel) {
+            memoryModel.pNext = pNext;
+            pNext = static_cast<void*>(&memoryModel);
+            context->vulkanMemoryModel = true;
+            context->memoryModelDeviceScope =
+                memoryModel.vulkanMemoryModelDeviceScope == VK_TRUE;
+            context->memoryModelAvailabilityVisibilityChains =
+                memoryModel.vulkanMemoryModelAvailabilityVisibilityChains == VK_TRUE;
+        }
+        //enable optional extensions without features if available
+        {
+            uint32_t count;
+            vulkan::checkResult(vkEnumerateDeviceExtensionProperties(device, nullptr, &count, nullptr));
+            std::vector<VkExtensionProperties> props(count);
+            vulkan::checkResult(vkEnumerateDeviceExtensionProperties(device, nullptr, &count, props.data()));
+            auto isSupported = [&props](std::string_view name) -> bool {
+                return std::any_of(props.begin(), props.end(),
+                    [name](const VkExtensionProperties& p) {
+                        return p.extensionName == name;
+                    });
+            };
+            //budget tracking is purely informational
+            if (isSupported(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+                allDeviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+                context->memoryBudget = true;
+            }
+            //allows buffers to use host memory allocated by the user
+            if (isSupported(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME)) {
+                allDeviceExtensions.push_back(VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
+                VkPhysicalDeviceExternalMemoryHostPropertiesEXT hostProps{
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_MEMORY_HOST_PROPERTIES_EXT
+                };
+                VkPhysicalDeviceProperties2 props2{
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                    .pNext = &hostProps
+                };
+                vkGetPhysicalDeviceProperties2(device, &props2);
+                context->hostImportAlignment = hostProps.minImportedHostPointerAlignment;
+            }
+            //locates the device for placing host memory on its NUMA node
+            if (isSupported(VK_EXT_PCI_BUS_INFO_EXTENSION_NAME)) {
+                allDeviceExtensions.push_back(VK_EXT_PCI_BUS_INFO_EXTENSION_NAME);
+                VkPhysicalDevicePCIBusInfoPropertiesEXT pciProps{
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PCI_BUS_INFO_PROPERTIES_EXT
+                };
+                VkPhysicalDeviceProperties2 props2{
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                    .pNext = &pciProps
+                };
+                vkGetPhysicalDeviceProperties2(device, &props2);
+                context->numaNode = vulkan::getPciNumaNode(pciProps.pciDomain,
+                    pciProps.pciBus, pciProps.pciDevice, pciProps.pciFunction);
+            }
+            //reports pipeline cache hits for the context's statistics
+            if (isSupported(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME)) {
+                allDeviceExtensions.push_back(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+                context->pipelineCreationFeedback = true;
+            }
+            //correlates device timestamps with the host's steady clock
+            auto calibrated = VK_KHR_CALIBRATED_TIMESTAMPS_EXTENSION_NAME;
+            if (!isSupported(calibrated))
+                calibrated = VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME;
+            if (isSupported(calibrated) && vulkan::hasHostTimeDomain(device)) {
+                allDeviceExtensions.push_back(calibrated);
+                context->calibratedTimestamps = true;
+            }
+        }
+        if (sync2.synchronization2) {
+            sync2.pNext = pNext;
+            pNext = static_cast<void*>(&sync2);
+            allDeviceExtensions.push_back(
+                VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+            context->synchronization2 = true;
+        }
+        //arrays bound with fewer arguments than they hold; resource heaps
+        //already chain the indexing features, which must appear only once
+        VkPhysicalDeviceDescriptorIndexingFeatures indexing{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES
         };
+        if (features12.descriptorBindingPartiallyBound) {
+            auto chained = static_cast<VkBaseOutStructure*>(pNext);
+            while (chained && chained->sType != indexing.sType)
+                chained = chained->pNext;
+            if (chained) {
+                reinterpret_cast<VkPhysicalDeviceDescriptorIndexingFeatures*>(chained)
+                    ->descriptorBindingPartiallyBound = VK_TRUE;
+            }
+            else {
+                indexing.pNext = pNext;
+                indexing.descriptorBindingPartiallyBound = VK_TRUE;
+                pNext = static_cast<void*>(&indexing);
+            }
+            context->partiallyBound = true;
+        }
+        //obligatory features
         VkPhysicalDeviceTimelineSemaphoreFeatures timeline{
             .sType             = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
             .pNext             = pNext, //chain external extensions
@@ -319,64 +1068,69 @@ ContextHandle createContext(
             .bufferDeviceAddress = VK_TRUE
         };
         VkPhysicalDeviceFeatures features{
+            .robustBufferAccess = robustBufferAccess ? VK_TRUE : VK_FALSE,
+            //compressed texture formats
+            .textureCompressionETC2     = features2.features.textureCompressionETC2,
+            .textureCompressionASTC_LDR = features2.features.textureCompressionASTC_LDR,
+            .textureCompressionBC       = features2.features.textureCompressionBC,
+            .pipelineStatisticsQuery = features2.features.pipelineStatisticsQuery,
+            //array bindings indexed with dynamically uniform values
+            .shaderUniformBufferArrayDynamicIndexing = features2.features.shaderUniformBufferArrayDynamicIndexing,
+            .shaderSampledImageArrayDynamicIndexing  = features2.features.shaderSampledImageArrayDynamicIndexing,
+            .shaderStorageBufferArrayDynamicIndexing = features2.features.shaderStorageBufferArrayDynamicIndexing,
+            .shaderStorageImageArrayDynamicIndexing  = features2.features.shaderStorageImageArrayDynamicIndexing,
             .shaderFloat64 = features2.features.shaderFloat64,
             .shaderInt64   = features2.features.shaderInt64,
-            .shaderInt16   = features2.features.shaderInt16
+            .shaderInt16   = features2.features.shaderInt16,
+            //sparse tensors
+            .sparseBinding         = sparseQueue ? features2.features.sparseBinding : VK_FALSE,
+            .sparseResidencyBuffer = sparseQueue ? features2.features.sparseResidencyBuffer : VK_FALSE,
+            //sparse textures
+            .sparseResidencyImage3D = sparseQueue ? features2.features.sparseResidencyImage3D : VK_FALSE
         };
+        context->sparseBinding = features.sparseBinding;
+        context->sparseResidency = features.sparseBinding && features.sparseResidencyBuffer;
+        context->sparseTexture = features.sparseBinding && features.sparseResidencyImage3D;
+        context->pipelineStatistics = features.pipelineStatisticsQuery;
+        context->robustBufferAccess = robustBufferAccess;
         VkDeviceCreateInfo deviceInfo{
             .sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
             .pNext                   = &addressFeatures,
-            .queueCreateInfoCount    = 1,
-            .pQueueCreateInfos       = &queueInfo,
+            .queueCreateInfoCount    = static_cast<uint32_t>(queueInfos.size()),
+            .pQueueCreateInfos       = queueInfos.data(),
             .enabledExtensionCount   = static_cast<uint32_t>(allDeviceExtensions.size()),
             .ppEnabledExtensionNames = allDeviceExtensions.data(),
             .pEnabledFeatures        = &features
         };
-        vulkan::checkResult(vkCreateDevice(device, &deviceInfo, nullptr, &context->device));
+        auto result = vkCreateDevice(device, &deviceInfo, nullptr, &context->device);
+        //elevated priorities may need privileges -> fall back to the default one
+        if (result == VK_ERROR_NOT_PERMITTED_KHR && context->queuePriority != QueuePriority::MEDIUM) {
+            for (auto& queueInfo : queueInfos)
+                queueInfo.pNext = nullptr;
+            context->queuePriority = QueuePriority::MEDIUM;
+            result = vkCreateDevice(device, &deviceInfo, nullptr, &context->device);
+        }
+        vulkan::checkResult(result);
     }
 
     //load device functions
     volkLoadDeviceTable(&context->fnTable, context->device);
-    //get queue
-    context->fnTable.vkGetDeviceQueue(context->device, family, 0, &context->queue);
-
-    //create command pool for subroutines
-    {
-        VkCommandPoolCreateInfo poolInfo{
-            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-            .queueFamilyIndex = family
-        };
-        vulkan::checkResult(context->fnTable.vkCreateCommandPool(
-            context->device, &poolInfo, nullptr, &context->subroutinePool));
-    }
-    //create command pool for internal one time submits
-    {
-        VkCommandPoolCreateInfo poolInfo{
-            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-            .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
-            .queueFamilyIndex = family
-        };
-        vulkan::checkResult(context->fnTable.vkCreateCommandPool(
-            context->device, &poolInfo, nullptr, &context->oneTimeSubmitPool));
-    }
-    //create command buffer for one time submits
-    {
-        VkCommandBufferAllocateInfo bufInfo{
-            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-            .commandPool = context->oneTimeSubmitPool,
-            .commandBufferCount = 1
-        };
-        vulkan::checkResult(context->fnTable.vkAllocateCommandBuffers(
-            context->device, &bufInfo, &context->oneTimeSubmitBuffer));
-    }
-    //create fence for synchronizing internal one time submits
-    {
-        VkFenceCreateInfo fenceInfo{
-            .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO
-        };
-        vulkan::checkResult(context->fnTable.vkCreateFence(
-            context->device, &fenceInfo, nullptr, &context->oneTimeSubmitFence));
+    //get queues
+    for (auto i = 0u; i < vulkan::QueueTypeCount; ++i) {
+        auto [queueFamily, queueIndex] = queueIndices[i];
+        auto& queue = context->queues[i];
+        queue.family = queueFamily;
+        queue.flags = queueFlags[i];
+        context->fnTable.vkGetDeviceQueue(
+            context->device, queueFamily, queueIndex, &queue.queue);
+        //aliased queues must share the mutex
+        queue.mutex = &context->queueMutexes[i];
+        for (auto j = 0u; j < i; ++j) {
+            if (context->queues[j].queue == queue.queue)
+                queue.mutex = context->queues[j].mutex;
+        }
     }
+    context->queue = context->queues[static_cast<size_t>(QueueType::MAIN)].queue;
 
     //Create pipeline cache
     {
@@ -386,6 +1140,8 @@ ContextHandle createContext(
         vulkan::checkResult(context->fnTable.vkCreatePipelineCache(
             context->device, &cacheInfo, nullptr, &context->cache));
     }
+    //Create layout cache
+    context->layoutCache = std::make_unique<vulkan::LayoutCache>(*context);
 
     //Create allocator
     {
@@ -416,8 +1172,13 @@ ContextHandle createContext(
             .vkGetDeviceImageMemoryRequirements      = context->fnTable.vkGetDeviceImageMemoryRequirementsKHR
         };
 
+        VmaAllocatorCreateFlags flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+        if (context->memoryBudget)
+            flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+        if (context->memoryPriority)
+            flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT;
         VmaAllocatorCreateInfo info{
-            .flags            = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+            .flags            = flags,
             .physicalDevice   = device,
             .device           = context->device,
             .pVulkanFunctions = &functions,
@@ -428,40 +1189,129 @@ ContextHandle createContext(
         vulkan::checkResult(vmaCreateAllocator(&info, &context->allocator));
     }
 
+    //Detect device local memory the host can access directly, i.e. the device
+    //is integrated or supports resizable BAR
+    {
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(device, &props);
+        VkPhysicalDeviceMemoryProperties memProps;
+        vkGetPhysicalDeviceMemoryProperties(device, &memProps);
+
+        constexpr VkMemoryPropertyFlags unifiedFlags =
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        //without resizable BAR only a small window is host visible
+        constexpr VkDeviceSize BarWindowSize = 256 * 1024 * 1024;
+        for (auto i = 0u; i < memProps.memoryTypeCount; ++i) {
+            auto& type = memProps.memoryTypes[i];
+            if ((type.propertyFlags & unifiedFlags) != unifiedFlags)
+                continue;
+            if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU ||
+                memProps.memoryHeaps[type.heapIndex].size > BarWindowSize)
+            {
+                context->unifiedMemory = true;
+            }
+        }
+    }
+
+    //dispatches exceeding the limits get split
+    {
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(device, &props);
+        std::copy(
+            std::begin(props.limits.maxComputeWorkGroupCount),
+            std::end(props.limits.maxComputeWorkGroupCount),
+            context->maxWorkGroupCount.begin());
+    }
+
     //Done
     return context;
 }
 
 }
 
+ContextHandle createSharedContext(const ContextHandle& context) {
+    if (!context)
+        throw std::runtime_error("Context is empty!");
+    //always share with the primary context, so chains do not build up
+    auto& primary = context->parent ? context->parent : context;
+
+    ContextHandle shared{ new vulkan::Context, destroySharedContext };
+    shared->parent = primary;
+    shared->physicalDevice = primary->physicalDevice;
+    shared->device = primary->device;
+    shared->queue = primary->queue;
+    shared->cache = primary->cache;
+    shared->extensions = primary->extensions;
+    shared->synchronization2 = primary->synchronization2;
+    shared->memoryBudget = primary->memoryBudget;
+    shared->memoryPriority = primary->memoryPriority;
+    shared->subgroupSizeControl = primary->subgroupSizeControl;
+    shared->computeFullSubgroups = primary->computeFullSubgroups;
+    shared->unifiedMemory = primary->unifiedMemory;
+    shared->hostImportAlignment = primary->hostImportAlignment;
+    shared->numaNode = primary->numaNode;
+    shared->sparseBinding = primary->sparseBinding;
+    shared->sparseResidency = primary->sparseResidency;
+    shared->sparseTexture = primary->sparseTexture;
+    shared->pipelineStatistics = primary->pipelineStatistics;
+    shared->calibratedTimestamps = primary->calibratedTimestamps;
+    shared->debugUtils = primary->debugUtils;
+    shared->pipelineCreationFeedback = primary->pipelineCreationFeedback;
+    shared->pipelineExecutableInfo = primary->pipelineExecutableInfo;
+    shared->robustBufferAccess = primary->robustBufferAccess;
+    shared->pipelineRobustness = primary->pipelineRobustness;
+    shared->partiallyBound = primary->partiallyBound;
+    shared->floatControls2 = primary->floatControls2;
+    shared->vulkanMemoryModel = primary->vulkanMemoryModel;
+    shared->memoryModelDeviceScope = primary->memoryModelDeviceScope;
+    shared->memoryModelAvailabilityVisibilityChains =
+        primary->memoryModelAvailabilityVisibilityChains;
+    shared->queuePriority = primary->queuePriority;
+    shared->maxWorkGroupCount = primary->maxWorkGroupCount;
+    shared->queueFamily = primary->queueFamily;
+    //queues are fixed on device creation -> submit to the primary ones
+    //guarded by the same mutexes
+    shared->queues = primary->queues;
+    shared->queueFamilies = primary->queueFamilies;
+    shared->allocator = primary->allocator;
+    shared->fnTable = primary->fnTable;
+
+    //layouts reference the context they were created on
+    shared->layoutCache = std::make_unique<vulkan::LayoutCache>(*shared);
+
+    //Done
+    return shared;
+}
+
+bool isSharingDevice(const ContextHandle& first, const ContextHandle& second) {
+    return vulkan::isSameDevice(first.get(), second.get());
+}
+
 ContextHandle createContext(std::span<ExtensionHandle> extensions) {
     //new handle -> refs to instance
     auto instance = vulkan::getInstance();
 
-    //enumerate devices
-    uint32_t count;
-    vkEnumeratePhysicalDevices(instance, &count, nullptr);
-    std::vector<VkPhysicalDevice> devices(count);
-    vkEnumeratePhysicalDevices(instance, &count, devices.data());
-
-    //select first suitable discrete GPU
-    VkPhysicalDevice fallback = nullptr;
-    VkPhysicalDeviceProperties props;
-    for (auto device : devices) {
-        if (isDeviceSuitable(createDevice(device), extensions)) {
-            //Remember last suitable device if no discrete present
-            fallback = device;
-            vkGetPhysicalDeviceProperties(device, &props);
-            if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
-                return createContext(instance, device, extensions);
+    //select the fastest suitable device
+    VkPhysicalDevice best = nullptr;
+    DeviceInfo bestInfo;
+    for (auto& cached : getCachedDevices()) {
+        auto device = cached.device;
+        if (!cached.suitable || !isDeviceSuitable(createDevice(device), extensions))
+            continue;
+        auto info = createInfo(device);
+        if (!best || isFaster(info, bestInfo)) {
+            best = device;
+            bestInfo = std::move(info);
         }
     }
 
-    //no discrete gpu
-    if (fallback)
-        return createContext(instance, fallback, extensions);
-    else
+    if (best) {
+        return createContext(instance, best, extensions);
+    }
+    else {
+        vulkan::returnInstance();
         throw std::runtime_error("No suitable device available!");
+    }
 }
 
 ContextHandle createContext(
@@ -479,17 +1329,226 @@ ContextHandle createContext(
 
 /*********************************** RESOURCE ********************************/
 
+namespace {
+
+//moves the record of a resource to its new address
+void moveResourceRecord(const vulkan::Context& context, const Resource* from, const Resource* to) {
+    if (!context.resourceTracking)
+        return;
+    std::lock_guard<std::mutex> lock(context.resourceMutex);
+    auto node = context.resources.extract(from);
+    if (!node.empty()) {
+        node.key() = to;
+        context.resources.insert(std::move(node));
+    }
+}
+
+void eraseResourceRecord(const vulkan::Context& context, const Resource* resource) {
+    if (!context.resourceTracking)
+        return;
+    std::lock_guard<std::mutex> lock(context.resourceMutex);
+    context.resources.erase(resource);
+}
+
+}
+
+void setDeferredDestruction(const ContextHandle& context, bool enable) {
+    context->deferredDestruction = enable;
+}
+
+bool isDeferredDestructionEnabled(const ContextHandle& context) {
+    return context->deferredDestruction;
+}
+
+size_t collectRetiredResources(const ContextHandle& context) {
+    return vulkan::collectRetiredResources(*context);
+}
+
+void setWaitSpinTime(const ContextHandle& context, uint64_t nanoseconds) {
+    context->waitSpinTime = nanoseconds;
+}
+
+uint64_t getWaitSpinTime(const ContextHandle& context) {
+    return context->waitSpinTime;
+}
+
+bool isProgramRobustnessSupported(const ContextHandle& context) {
+    return context->pipelineRobustness;
+}
+
+void setProgramRobustness(const ContextHandle& context, BufferRobustness robustness) {
+    if (robustness != BufferRobustness::DEFAULT && !context->pipelineRobustness)
+        throw std::runtime_error("Program robustness is not supported by the device!");
+    context->programRobustness = robustness;
+}
+
+BufferRobustness getProgramRobustness(const ContextHandle& context) {
+    return context->programRobustness;
+}
+
+FloatControlsProperties getFloatControlsProperties(const ContextHandle& context) {
+    VkPhysicalDeviceFloatControlsProperties controls{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FLOAT_CONTROLS_PROPERTIES
+    };
+    VkPhysicalDeviceProperties2 props{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &controls
+    };
+    vkGetPhysicalDeviceProperties2(context->physicalDevice, &props);
+    return {
+        .denormFlushToZeroFloat16 = controls.shaderDenormFlushToZeroFloat16 == VK_TRUE,
+        .denormFlushToZeroFloat32 = controls.shaderDenormFlushToZeroFloat32 == VK_TRUE,
+        .denormFlushToZeroFloat64 = controls.shaderDenormFlushToZeroFloat64 == VK_TRUE,
+        .denormPreserveFloat16 = controls.shaderDenormPreserveFloat16 == VK_TRUE,
+        .denormPreserveFloat32 = controls.shaderDenormPreserveFloat32 == VK_TRUE,
+        .denormPreserveFloat64 = controls.shaderDenormPreserveFloat64 == VK_TRUE,
+        .fastMath = context->floatControls2
+    };
+}
+
+MemoryModelFeatures getMemoryModelFeatures(const ContextHandle& context) {
+    return {
+        .vulkanMemoryModel = context->vulkanMemoryModel,
+        .deviceScope = context->memoryModelDeviceScope,
+        .availabilityVisibilityChains = context->memoryModelAvailabilityVisibilityChains
+    };
+}
+
+void setDescriptorSetCache(const ContextHandle& context, bool enable) {
+    context->descriptorSetCache = enable;
+}
+
+bool isDescriptorSetCacheEnabled(const ContextHandle& context) {
+    return context->descriptorSetCache;
+}
+
+void setResourceTracking(const ContextHandle& context, bool enable) {
+    std::lock_guard<std::mutex> lock(context->resourceMutex);
+    context->resourceTracking = enable;
+    if (!enable)
+        context->resources.clear();
+}
+
+bool isResourceTrackingEnabled(const ContextHandle& context) {
+    return context->resourceTracking;
+}
+
+void setResourceTag(const Resource& resource, std::string_view tag) {
+    auto& context = resource.getContext();
+    if (!context || !context->resourceTracking)
+        return;
+    std::lock_guard<std::mutex> lock(context->resourceMutex);
+    auto it = context->resources.find(&resource);
+    if (it != context->resources.end())
+        it->second.tag = tag;
+}
+
+std::vector<ResourceInfo> getLiveResources(const ContextHandle& context) {
+    std::vector<const vulkan::ResourceRecord*> records;
+    std::lock_guard<std::mutex> lock(context->resourceMutex);
+    records.reserve(context->resources.size());
+    for (auto& [_, record] : context->resources)
+        records.push_back(&record);
+    std::sort(records.begin(), records.end(),
+        [](auto a, auto b) { return a->id < b->id; });
+
+    std::vector<ResourceInfo> result;
+    result.reserve(records.size());
+    for (auto record : records) {
+        result.push_back({
+            .type = record->type,
+            .size = record->size,
+            .tag = record->tag
+        });
+    }
+    return result;
+}
+
+std::string dumpResources(const ContextHandle& context) {
+    auto resources = getLiveResources(context);
+
+    //summarize by type
+    struct Summary {
+        uint64_t count = 0;
+        uint64_t size = 0;
+    };
+    std::map<std::string, Summary> summaries;
+    Summary total;
+    for (auto& resource : resources) {
+        auto& summary = summaries[resource.type];
+        summary.count++;
+        summary.size += resource.size;
+        total.count++;
+        total.size += resource.size;
+    }
+
+    std::ostringstream out;
+    out << "Live resources: " << total.count << " (" << total.size << " bytes)\n";
+    for (auto& [type, summary] : summaries)
+        out << "  " << type << ": " << summary.count << " (" << summary.size << " bytes)\n";
+    for (auto& resource : resources) {
+        out << "  - " << resource.type << ", " << resource.size << " bytes";
+        if (!resource.tag.empty())
+            out << ", \"" << resource.tag << '"';
+        out << '\n';
+    }
+    return out.str();
+}
+
 const ContextHandle& Resource::getContext() const noexcept {
     return context;
 }
 
-Resource::Resource(Resource&& other) noexcept = default;
-Resource& Resource::operator=(Resource&& other) noexcept = default;
+void Resource::trackResource(const char* type, uint64_t size) {
+    if (!context || !context->resourceTracking)
+        return;
+    std::lock_guard<std::mutex> lock(context->resourceMutex);
+    auto it = context->resources.find(this);
+    if (it != context->resources.end()) {
+        it->second.type = type;
+        it->second.size = size;
+    }
+}
+
+Resource::Resource(Resource&& other) noexcept
+    : context(std::move(other.context))
+{
+    if (context)
+        moveResourceRecord(*context, &other, this);
+}
+Resource& Resource::operator=(Resource&& other) noexcept {
+    if (this != &other) {
+        if (context) {
+            eraseResourceRecord(*context, this);
+            ++context->resourceGeneration;
+        }
+        context = std::move(other.context);
+        if (context)
+            moveResourceRecord(*context, &other, this);
+    }
+    return *this;
+}
 
 Resource::Resource(ContextHandle context)
     : context(std::move(context))
-{}
+{
+    if (!this->context || !this->context->resourceTracking)
+        return;
+    auto& ctx = *this->context;
+    std::lock_guard<std::mutex> lock(ctx.resourceMutex);
+    ctx.resources[this] = {
+        .type = "Resource",
+        .size = 0,
+        .tag = {},
+        .id = ctx.nextResourceId++
+    };
+}
 
-Resource::~Resource() = default;
+Resource::~Resource() {
+    if (context) {
+        eraseResourceRecord(*context, this);
+        ++context->resourceGeneration;
+    }
+}
 
 }
@@ -0,0 +1,138 @@
+#include "hephaistos/cooperative.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include "volk.h"
+
+#include "vk/result.hpp"
+#include "vk/types.hpp"
+
+namespace hephaistos {
+
+namespace {
+
+constexpr auto ExtensionName = "CooperativeMatrix";
+
+constexpr auto DeviceExtensions = std::to_array({
+    VK_KHR_COOPERATIVE_MATRIX_EXTENSION_NAME
+});
+
+}
+
+std::vector<CooperativeMatrixProperties> getCooperativeMatrixProperties(
+    const DeviceHandle& device)
+{
+    //nullcheck
+    if (!device)
+        return {};
+
+    //function is only available if the extension is supported
+    if (!std::includes(
+        device->supportedExtensions.begin(),
+        device->supportedExtensions.end(),
+        DeviceExtensions.begin(),
+        DeviceExtensions.end()))
+    {
+        return {};
+    }
+
+    uint32_t count;
+    vulkan::checkResult(vkGetPhysicalDeviceCooperativeMatrixPropertiesKHR(
+        device->device, &count, nullptr));
+    std::vector<VkCooperativeMatrixPropertiesKHR> props(count, {
+        .sType = VK_STRUCTURE_TYPE_COOPERATIVE_MATRIX_PROPERTIES_KHR
+    });
+    vulkan::checkResult(vkGetPhysicalDeviceCooperativeMatrixPropertiesKHR(
+        device->device, &count, props.data()));
+
+    std::vector<CooperativeMatrixProperties> result(count);
+    std::transform(props.begin(), props.end(), result.begin(),
+        [](const VkCooperativeMatrixPropertiesKHR& p) -> CooperativeMatrixProperties {
+            return {
+                .MSize = p.MSize,
+                .NSize = p.NSize,
+                .KSize = p.KSize,
+                .AType = static_cast<ComponentType>(p.AType),
+                .BType = static_cast<ComponentType>(p.BType),
+                .CType = static_cast<ComponentType>(p.CType),
+                .ResultType = static_cast<ComponentType>(p.ResultType),
+                .saturatingAccumulation = !!p.saturatingAccumulation,
+                .scope = static_cast<MatrixScope>(p.scope)
+            };
+        });
+    return result;
+}
+
+bool isCooperativeMatrixSupported(const DeviceHandle& device) {
+    //nullcheck
+    if (!device)
+        return false;
+
+    //Check extension support
+    if (!std::includes(
+        device->supportedExtensions.begin(),
+        device->supportedExtensions.end(),
+        DeviceExtensions.begin(),
+        DeviceExtensions.end()))
+    {
+        return false;
+    }
+
+    //Check features
+    VkPhysicalDeviceVulkanMemoryModelFeatures modelFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_MEMORY_MODEL_FEATURES
+    };
+    VkPhysicalDeviceCooperativeMatrixFeaturesKHR matrixFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COOPERATIVE_MATRIX_FEATURES_KHR,
+        .pNext = &modelFeatures
+    };
+    VkPhysicalDeviceFeatures2 features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &matrixFeatures
+    };
+    vkGetPhysicalDeviceFeatures2(device->device, &features);
+    return matrixFeatures.cooperativeMatrix && modelFeatures.vulkanMemoryModel;
+}
+bool isCooperativeMatrixEnabled(const ContextHandle& context) {
+    //to shorten things
+    auto& ext = *context->extensions;
+    return std::find_if(ext.begin(), ext.end(),
+        [](const ExtensionHandle& h) -> bool {
+            return h->getExtensionName() == ExtensionName;
+        }) != ext.end();
+}
+
+class CooperativeMatrixExtension : public Extension {
+public:
+    bool isDeviceSupported(const DeviceHandle& device) const override {
+        return isCooperativeMatrixSupported(device);
+    }
+    std::string_view getExtensionName() const override {
+        return ExtensionName;
+    }
+    std::span<const char* const> getDeviceExtensions() const override {
+        return DeviceExtensions;
+    }
+    //the memory model is enabled by the context itself if supported
+    void* chain(void* pNext) override {
+        matrixFeatures.pNext = pNext;
+        return static_cast<void*>(&matrixFeatures);
+    }
+
+    CooperativeMatrixExtension()
+        : matrixFeatures{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_COOPERATIVE_MATRIX_FEATURES_KHR,
+            .cooperativeMatrix = VK_TRUE
+        }
+    {}
+    virtual ~CooperativeMatrixExtension() = default;
+
+private:
+    VkPhysicalDeviceCooperativeMatrixFeaturesKHR matrixFeatures;
+};
+ExtensionHandle createCooperativeMatrixExtension() {
+    return std::make_unique<CooperativeMatrixExtension>();
+}
+
+}
@@ -6,7 +6,10 @@
 
 #include "volk.h"
 
+#include "hephaistos/image.hpp"
 #include "vk/instance.hpp"
+#include "vk/types.hpp"
+#include "vk/util.hpp"
 
 namespace hephaistos {
 
@@ -87,6 +90,103 @@ void configureDebug(DebugOptions options, DebugCallback callback) {
 	PFN_vkDebugUtilsMessengerCallbackEXT pCallback;
 	pCallback = debugCallback ? transformCallback : nullptr;
 	vulkan::setInstanceDebugState(enable, disable, pCallback);
+	vulkan::setRobustBufferAccess(options.enableRobustBufferAccess);
+}
+
+void enableDebugLabels() {
+	vulkan::setInstanceDebugLabels();
+}
+
+bool isDebugLabelsEnabled(const ContextHandle& context) {
+	return context->debugUtils;
+}
+
+bool isRobustBufferAccessEnabled(const ContextHandle& context) {
+	return context->robustBufferAccess;
+}
+
+namespace {
+
+VkDebugUtilsLabelEXT getLabel(const std::string& name, const std::array<float, 4>& color) {
+	return {
+		.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
+		.pLabelName = name.c_str(),
+		.color = { color[0], color[1], color[2], color[3] }
+	};
+}
+
+}
+
+void BeginLabelCommand::record(vulkan::Command& cmd) const {
+	if (!context.get().debugUtils)
+		return;
+	auto label = getLabel(name, color);
+	vkCmdBeginDebugUtilsLabelEXT(cmd.buffer, &label);
+}
+
+BeginLabelCommand::BeginLabelCommand(const BeginLabelCommand&) = default;
+BeginLabelCommand& BeginLabelCommand::operator=(const BeginLabelCommand&) = default;
+
+BeginLabelCommand::BeginLabelCommand(const ContextHandle& context,
+	std::string_view name, std::array<float, 4> color)
+	: context(*context)
+	, name(name)
+	, color(color)
+{}
+BeginLabelCommand::~BeginLabelCommand() = default;
+
+void EndLabelCommand::record(vulkan::Command& cmd) const {
+	if (context.get().debugUtils)
+		vkCmdEndDebugUtilsLabelEXT(cmd.buffer);
+}
+
+EndLabelCommand::EndLabelCommand(const EndLabelCommand&) = default;
+EndLabelCommand& EndLabelCommand::operator=(const EndLabelCommand&) = default;
+
+EndLabelCommand::EndLabelCommand(const ContextHandle& context)
+	: context(*context)
+{}
+EndLabelCommand::~EndLabelCommand() = default;
+
+void InsertLabelCommand::record(vulkan::Command& cmd) const {
+	if (!context.get().debugUtils)
+		return;
+	auto label = getLabel(name, color);
+	vkCmdInsertDebugUtilsLabelEXT(cmd.buffer, &label);
+}
+
+InsertLabelCommand::InsertLabelCommand(const InsertLabelCommand&) = default;
+InsertLabelCommand& InsertLabelCommand::operator=(const InsertLabelCommand&) = default;
+
+InsertLabelCommand::InsertLabelCommand(const ContextHandle& context,
+	std::string_view name, std::array<float, 4> color)
+	: context(*context)
+	, name(name)
+	, color(color)
+{}
+InsertLabelCommand::~InsertLabelCommand() = default;
+
+void setDebugName(const Tensor<std::byte>& tensor, std::string_view name) {
+	auto& context = *tensor.getContext();
+	auto& buffer = tensor.getBuffer();
+	//do not rename buffers shared by several tensors
+	if (!context.debugUtils || buffer.block)
+		return;
+	std::string _name(name);
+	vulkan::setObjectName(context, VK_OBJECT_TYPE_BUFFER,
+		reinterpret_cast<uint64_t>(buffer.buffer), _name.c_str());
+}
+
+void setDebugName(const Image& image, std::string_view name) {
+	auto& context = *image.getContext();
+	if (!context.debugUtils)
+		return;
+	auto& _image = image.getImage();
+	std::string _name(name);
+	vulkan::setObjectName(context, VK_OBJECT_TYPE_IMAGE,
+		reinterpret_cast<uint64_t>(_image.image), _name.c_str());
+	vulkan::setObjectName(context, VK_OBJECT_TYPE_IMAGE_VIEW,
+		reinterpret_cast<uint64_t>(_image.view), _name.c_str());
 }
 
 }
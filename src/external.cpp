@@ -0,0 +1,371 @@
+#include "hephaistos/external.hpp"
+#include "hephaistos/conditional.hpp"
+#include "hephaistos/raytracing.hpp"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <stdexcept>
+
+#include "volk.h"
+//platform types without changing volk's function table
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <vulkan/vulkan_win32.h>
+#endif
+
+#include "vk/result.hpp"
+#include "vk/types.hpp"
+
+namespace hephaistos {
+
+/********************************** EXTENSION *********************************/
+
+namespace {
+
+constexpr auto ExtensionName = "ExternalMemory";
+
+//! MUST BE SORTED FOR std::includes !//
+#ifdef _WIN32
+constexpr auto DeviceExtensions = std::to_array({
+    VK_KHR_EXTERNAL_MEMORY_WIN32_EXTENSION_NAME,
+    VK_KHR_EXTERNAL_SEMAPHORE_WIN32_EXTENSION_NAME
+});
+constexpr auto MemoryHandleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT;
+constexpr auto SemaphoreHandleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_WIN32_BIT;
+#else
+constexpr auto DeviceExtensions = std::to_array({
+    VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME,
+    VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME
+});
+constexpr auto MemoryHandleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+constexpr auto SemaphoreHandleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT;
+#endif
+
+constexpr VkBufferUsageFlags tensor_usage =
+    VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+    VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+    VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+    VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT |
+    VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT |
+    VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT |
+    VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+    VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+
+}
+
+bool isExternalMemorySupported(const DeviceHandle& device) {
+    //nullcheck
+    if (!device)
+        return false;
+
+    //Check extension support
+    if (!std::includes(
+        device->supportedExtensions.begin(),
+        device->supportedExtensions.end(),
+        DeviceExtensions.begin(),
+        DeviceExtensions.end()))
+    {
+        return false;
+    }
+
+    //Check tensors can be exported
+    VkPhysicalDeviceExternalBufferInfo bufferInfo{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_BUFFER_INFO,
+        .usage = tensor_usage,
+        .handleType = MemoryHandleType
+    };
+    VkExternalBufferProperties bufferProps{
+        .sType = VK_STRUCTURE_TYPE_EXTERNAL_BUFFER_PROPERTIES
+    };
+    vkGetPhysicalDeviceExternalBufferProperties(device->device, &bufferInfo, &bufferProps);
+    if (!(bufferProps.externalMemoryProperties.externalMemoryFeatures &
+        VK_EXTERNAL_MEMORY_FEATURE_EXPORTABLE_BIT))
+    {
+        return false;
+    }
+
+    //Check timelines can be exported
+    VkSemaphoreTypeCreateInfo typeInfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE
+    };
+    VkPhysicalDeviceExternalSemaphoreInfo semaphoreInfo{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_SEMAPHORE_INFO,
+        .pNext = &typeInfo,
+        .handleType = SemaphoreHandleType
+    };
+    VkExternalSemaphoreProperties semaphoreProps{
+        .sType = VK_STRUCTURE_TYPE_EXTERNAL_SEMAPHORE_PROPERTIES
+    };
+    vkGetPhysicalDeviceExternalSemaphoreProperties(device->device, &semaphoreInfo, &semaphoreProps);
+    return (semaphoreProps.externalSemaphoreFeatures &
+        VK_EXTERNAL_SEMAPHORE_FEATURE_EXPORTABLE_BIT) != 0;
+}
+bool isExternalMemoryEnabled(const ContextHandle& context) {
+    //to shorten things
+    auto& ext = *context->extensions;
+    return std::find_if(ext.begin(), ext.end(),
+        [](const ExtensionHandle& h) -> bool {
+            return h->getExtensionName() == ExtensionName;
+        }) != ext.end();
+}
+
+class ExternalMemoryExtension : public Extension {
+public:
+    bool isDeviceSupported(const DeviceHandle& device) const override {
+        return isExternalMemorySupported(device);
+    }
+    std::string_view getExtensionName() const override {
+        return ExtensionName;
+    }
+    std::span<const char* const> getDeviceExtensions() const override {
+        return DeviceExtensions;
+    }
+    void* chain(void* pNext) override {
+        //no features to enable
+        return pNext;
+    }
+
+    ExternalMemoryExtension() = default;
+    virtual ~ExternalMemoryExtension() = default;
+};
+ExtensionHandle createExternalMemoryExtension() {
+    return std::make_unique<ExternalMemoryExtension>();
+}
+
+/*********************************** MEMORY ***********************************/
+
+Tensor<std::byte> createExportableTensor(const ContextHandle& context, uint64_t size) {
+    if (!isExternalMemoryEnabled(context))
+        throw std::logic_error("External memory is not enabled!");
+
+    //predicates of conditional execution and geometry updates are read from tensors
+    auto usage = tensor_usage;
+    if (isConditionalExecutionEnabled(context))
+        usage |= VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT;
+    if (isRaytracingEnabled(context))
+        usage |= VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+    VkExternalMemoryBufferCreateInfo externalInfo{
+        .sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO,
+        .handleTypes = MemoryHandleType
+    };
+    auto bufferInfo = vulkan::getBufferCreateInfo(*context, size, usage);
+    bufferInfo.pNext = &externalInfo;
+
+    //exportable memory needs its own pool to chain the export info
+    {
+        std::lock_guard<std::mutex> lock(context->bufferPoolMutex);
+        if (!context->exportPool) {
+            VmaAllocationCreateInfo allocInfo{
+                .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE
+            };
+            uint32_t memoryType;
+            vulkan::checkResult(vmaFindMemoryTypeIndexForBufferInfo(
+                context->allocator, &bufferInfo, &allocInfo, &memoryType));
+
+            context->exportInfo = VkExportMemoryAllocateInfo{
+                .sType = VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO,
+                .handleTypes = MemoryHandleType
+            };
+            VmaPoolCreateInfo poolInfo{
+                .memoryTypeIndex = memoryType,
+                .pMemoryAllocateNext = &context->exportInfo
+            };
+            vulkan::checkResult(vmaCreatePool(
+                context->allocator, &poolInfo, &context->exportPool));
+        }
+    }
+
+    BufferHandle buffer{
+        new vulkan::Buffer({0,0,{},0,nullptr,nullptr,size,usage,{},true,*context}),
+        vulkan::destroyBuffer
+    };
+    //importers usually expect dedicated allocations
+    VmaAllocationCreateInfo allocInfo{
+        .flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+        .pool = context->exportPool,
+        .pUserData = buffer.get()
+    };
+    vulkan::checkResult(vmaCreateBuffer(
+        context->allocator,
+        &bufferInfo,
+        &allocInfo,
+        &buffer->buffer,
+        &buffer->allocation,
+        &buffer->allocInfo));
+
+    return Tensor<std::byte>(context, std::move(buffer), size);
+}
+
+ExternalMemory exportTensor(const Tensor<std::byte>& tensor) {
+    auto& buffer = tensor.getBuffer();
+    if (!buffer.exportable)
+        throw std::logic_error("Tensor was not created exportable!");
+    auto& context = buffer.context;
+
+    ExternalHandle handle;
+#ifdef _WIN32
+    VkMemoryGetWin32HandleInfoKHR info{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_GET_WIN32_HANDLE_INFO_KHR,
+        .memory = buffer.allocInfo.deviceMemory,
+        .handleType = MemoryHandleType
+    };
+    auto getHandle = reinterpret_cast<PFN_vkGetMemoryWin32HandleKHR>(
+        vkGetDeviceProcAddr(context.device, "vkGetMemoryWin32HandleKHR"));
+    HANDLE result;
+    vulkan::checkResult(getHandle(context.device, &info, &result));
+    handle = reinterpret_cast<ExternalHandle>(result);
+#else
+    VkMemoryGetFdInfoKHR info{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR,
+        .memory = buffer.allocInfo.deviceMemory,
+        .handleType = MemoryHandleType
+    };
+    int fd;
+    vulkan::checkResult(context.fnTable.vkGetMemoryFdKHR(context.device, &info, &fd));
+    handle = fd;
+#endif
+
+    return {
+        .handle = handle,
+        .size = buffer.allocInfo.size,
+        .offset = buffer.allocInfo.offset + buffer.offset
+    };
+}
+
+Tensor<std::byte> importTensor(
+    const ContextHandle& context, const ExternalMemory& memory, uint64_t size)
+{
+    if (!isExternalMemoryEnabled(context))
+        throw std::logic_error("External memory is not enabled!");
+    if (memory.offset >= memory.size)
+        throw std::logic_error("Offset is not contained within the imported memory!");
+    if (size == whole_size)
+        size = memory.size - memory.offset;
+
+    auto usage = tensor_usage;
+    if (isConditionalExecutionEnabled(context))
+        usage |= VK_BUFFER_USAGE_CONDITIONAL_RENDERING_BIT_EXT;
+    if (isRaytracingEnabled(context))
+        usage |= VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+#ifdef _WIN32
+    VkImportMemoryWin32HandleInfoKHR importInfo{
+        .sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_WIN32_HANDLE_INFO_KHR,
+        .handleType = MemoryHandleType,
+        .handle = reinterpret_cast<HANDLE>(memory.handle)
+    };
+#else
+    VkImportMemoryFdInfoKHR importInfo{
+        .sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_FD_INFO_KHR,
+        .handleType = MemoryHandleType,
+        .fd = static_cast<int>(memory.handle)
+    };
+#endif
+    auto buffer = vulkan::createExternalBuffer(context, size, usage,
+        MemoryHandleType, &importInfo, memory.size, memory.offset);
+
+    return Tensor<std::byte>(context, std::move(buffer), size);
+}
+
+/********************************** TIMELINE **********************************/
+
+Timeline createExportableTimeline(const ContextHandle& context, uint64_t initialValue) {
+    if (!isExternalMemoryEnabled(context))
+        throw std::logic_error("External memory is not enabled!");
+
+    VkExportSemaphoreCreateInfo exportInfo{
+        .sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO,
+        .handleTypes = SemaphoreHandleType
+    };
+    VkSemaphoreTypeCreateInfo type{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .pNext = &exportInfo,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = initialValue
+    };
+    VkSemaphoreCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &type
+    };
+    auto timeline = std::make_unique<vulkan::Timeline>();
+    timeline->exportable = true;
+    vulkan::checkResult(context->fnTable.vkCreateSemaphore(
+        context->device, &info, nullptr, &timeline->semaphore));
+
+    return Timeline(context, std::move(timeline));
+}
+
+ExternalHandle exportTimeline(const Timeline& timeline) {
+    auto& semaphore = timeline.getTimeline();
+    if (!semaphore.exportable)
+        throw std::logic_error("Timeline was not created exportable!");
+    auto& context = timeline.getContext();
+
+#ifdef _WIN32
+    VkSemaphoreGetWin32HandleInfoKHR info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_WIN32_HANDLE_INFO_KHR,
+        .semaphore = semaphore.semaphore,
+        .handleType = SemaphoreHandleType
+    };
+    auto getHandle = reinterpret_cast<PFN_vkGetSemaphoreWin32HandleKHR>(
+        vkGetDeviceProcAddr(context->device, "vkGetSemaphoreWin32HandleKHR"));
+    HANDLE result;
+    vulkan::checkResult(getHandle(context->device, &info, &result));
+    return reinterpret_cast<ExternalHandle>(result);
+#else
+    VkSemaphoreGetFdInfoKHR info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR,
+        .semaphore = semaphore.semaphore,
+        .handleType = SemaphoreHandleType
+    };
+    int fd;
+    vulkan::checkResult(context->fnTable.vkGetSemaphoreFdKHR(context->device, &info, &fd));
+    return fd;
+#endif
+}
+
+Timeline importTimeline(const ContextHandle& context, ExternalHandle handle) {
+    if (!isExternalMemoryEnabled(context))
+        throw std::logic_error("External memory is not enabled!");
+
+    VkSemaphoreTypeCreateInfo type{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE
+    };
+    VkSemaphoreCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &type
+    };
+    auto timeline = std::make_unique<vulkan::Timeline>();
+    vulkan::checkResult(context->fnTable.vkCreateSemaphore(
+        context->device, &info, nullptr, &timeline->semaphore));
+    //wrap early, so the semaphore gets destroyed if the import fails
+    Timeline result(context, std::move(timeline));
+    auto semaphore = result.getTimeline().semaphore;
+
+#ifdef _WIN32
+    VkImportSemaphoreWin32HandleInfoKHR importInfo{
+        .sType = VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_WIN32_HANDLE_INFO_KHR,
+        .semaphore = semaphore,
+        .handleType = SemaphoreHandleType,
+        .handle = reinterpret_cast<HANDLE>(handle)
+    };
+    auto import = reinterpret_cast<PFN_vkImportSemaphoreWin32HandleKHR>(
+        vkGetDeviceProcAddr(context->device, "vkImportSemaphoreWin32HandleKHR"));
+    vulkan::checkResult(import(context->device, &importInfo));
+#else
+    VkImportSemaphoreFdInfoKHR importInfo{
+        .sType = VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_FD_INFO_KHR,
+        .semaphore = semaphore,
+        .handleType = SemaphoreHandleType,
+        .fd = static_cast<int>(handle)
+    };
+    vulkan::checkResult(context->fnTable.vkImportSemaphoreFdKHR(context->device, &importInfo));
+#endif
+
+    return result;
+}
+
+}
@@ -0,0 +1,485 @@
+#include "hephaistos/graph.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "hephaistos/workqueue.hpp"
+
+#include "vk/hazard.hpp"
+#include "vk/kernel.hpp"
+#include "vk/types.hpp"
+#include "vk/util.hpp"
+
+namespace hephaistos {
+
+/********************************** EXTENSION *********************************/
+
+namespace {
+
+constexpr auto ExtensionName = "ExecutionGraph";
+
+}
+
+bool isExecutionGraphSupported(const DeviceHandle& device) {
+    //emulation only relies on buffer device address and indirect dispatches,
+    //which every supported device has
+    return static_cast<bool>(device);
+}
+bool isExecutionGraphEnabled(const ContextHandle& context) {
+    //to shorten things
+    auto& ext = *context->extensions;
+    return std::find_if(ext.begin(), ext.end(),
+        [](const ExtensionHandle& h) -> bool {
+            return h->getExtensionName() == ExtensionName;
+        }) != ext.end();
+}
+
+class ExecutionGraphExtension : public Extension {
+public:
+    bool isDeviceSupported(const DeviceHandle& device) const override {
+        return isExecutionGraphSupported(device);
+    }
+    std::string_view getExtensionName() const override {
+        return ExtensionName;
+    }
+    std::span<const char* const> getDeviceExtensions() const override {
+        return {};
+    }
+    void* chain(void* pNext) override {
+        return pNext;
+    }
+
+    ExecutionGraphExtension() = default;
+    virtual ~ExecutionGraphExtension() = default;
+};
+ExtensionHandle createExecutionGraphExtension() {
+    return std::make_unique<ExecutionGraphExtension>();
+}
+
+namespace {
+
+/******************************** SHADER CODE *********************************/
+
+constexpr char ExecutionGraphSource[] = R"(#ifndef _INCLUDE_HEPHAISTOS_GRAPH
+#define _INCLUDE_HEPHAISTOS_GRAPH
+
+#include "hephaistos/workqueue.glsl"
+
+#extension GL_EXT_buffer_reference_uvec2 : require
+
+//Graph of nodes each owning a work queue of records. Programs pop the
+//records of their own node and enqueue follow up work to any node, which
+//gets processed in the next round. Include this header directly after the
+//version directive.
+//
+//Programs loop until their node drained:
+//  uint record;
+//  while (graphPop(graph, NODE, record)) {
+//      ...
+//      graphEnqueue(graph, OTHER_NODE, next);
+//  }
+
+layout(buffer_reference, std430, buffer_reference_align = 8) buffer ExecutionGraph {
+    uint nodeCount;
+    uint _reserved;
+    //address of each node's queue; plain addresses as reflection cannot
+    //handle arrays of references
+    uvec2 nodes[];
+};
+
+//returns the queue of the given node
+WorkQueue graphNode(ExecutionGraph graph, uint node) {
+    return WorkQueue(graph.nodes[node]);
+}
+
+//pops the next record of the given node; returns false if it drained
+bool graphPop(ExecutionGraph graph, uint node, out uint record) {
+    return workQueuePop(graphNode(graph, node), record);
+}
+
+//enqueues a record processed by the given node in the next round; returns
+//false if it was dropped as the node's queue was full
+bool graphEnqueue(ExecutionGraph graph, uint node, uint record) {
+    return workQueuePush(graphNode(graph, node), record);
+}
+
+#endif
+)";
+
+//resets all nodes and fills the first half of one
+constexpr char SeedSource[] = R"(#version 460
+
+#include "hephaistos/graph.glsl"
+
+layout(local_size_x = 64) in;
+
+layout(buffer_reference, std430, buffer_reference_align = 4) readonly buffer Records { uint v[]; };
+
+layout(push_constant) uniform Push {
+    ExecutionGraph graph;
+    Records records;
+    uint node;
+    uint first;
+    uint count;
+    uint capacity;
+    uint fromRecords;
+    uint _padding;
+};
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i < graph.nodeCount) {
+        WorkQueue queue = graphNode(graph, i);
+        queue.dispatchSize = uvec3(0u, 1u, 1u);
+        queue.round = 0u;
+        queue.head = 0u;
+        queue.count[0] = i == node ? count : 0u;
+        queue.count[1] = 0u;
+        queue.capacity = capacity;
+        queue.overflow = 0u;
+        queue.processed = 0u;
+    }
+    if (i < count)
+        graphNode(graph, node).items[i] = fromRecords != 0u ? records.v[i] : first + i;
+}
+)";
+
+//swaps the halves of all nodes after a round and sizes their next dispatch
+constexpr char RefillSource[] = R"(#version 460
+
+#include "hephaistos/graph.glsl"
+
+layout(local_size_x = 64) in;
+
+//items per group and max groups of each node
+layout(buffer_reference, std430, buffer_reference_align = 8) readonly buffer Limits { uvec2 v[]; };
+
+layout(push_constant) uniform Push {
+    ExecutionGraph graph;
+    Limits limits;
+    uint advance;
+    uint _padding;
+};
+
+void main() {
+    uint n = gl_GlobalInvocationID.x;
+    if (n >= graph.nodeCount)
+        return;
+    WorkQueue queue = graphNode(graph, n);
+    uvec2 limit = limits.v[n];
+
+    uint r = queue.round & 1u;
+    if (advance != 0u) {
+        uint w = r ^ 1u;
+        queue.processed += min(queue.head, queue.count[r]);
+        queue.count[r] = 0u;
+        queue.count[w] = min(queue.count[w], queue.capacity);
+        queue.head = 0u;
+        queue.round += 1u;
+        r = w;
+    }
+    uint groups = (queue.count[r] + limit.x - 1u) / limit.x;
+    queue.dispatchSize = uvec3(min(groups, limit.y), 1u, 1u);
+}
+)";
+
+constexpr uint32_t GraphLocalSize = 64;
+//compute units assumed if the device does not report them
+constexpr uint32_t DefaultComputeUnits = 32;
+
+struct SeedPush {
+    uint64_t graph;
+    uint64_t records;
+    uint32_t node;
+    uint32_t first;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t fromRecords;
+    uint32_t _padding;
+};
+
+struct RefillPush {
+    uint64_t graph;
+    uint64_t limits;
+    uint32_t advance;
+    uint32_t _padding;
+};
+
+}
+
+/*************************** EXECUTION GRAPH COMMAND **************************/
+
+struct ExecutionGraphCommand::State {
+    ContextHandle context;
+    //tensors accessed via their address; declared to the hazard tracker
+    std::vector<std::reference_wrapper<const Tensor<std::byte>>> tensors;
+
+    //seed: single dispatch of the seed program
+    const Program* seed = nullptr;
+    uint32_t seedGroups = 0;
+    SeedPush seedPush = {};
+
+    //launch: refill followed by rounds of all nodes
+    const Program* refill = nullptr;
+    uint32_t refillGroups = 0;
+    RefillPush refillPush = {};
+    uint32_t rounds = 0;
+    //owns the push data referenced by dispatches
+    std::vector<std::byte> push;
+    std::optional<DispatchIndirectListCommand> dispatches;
+};
+
+void ExecutionGraphCommand::record(vulkan::Command& cmd) const {
+    auto& context = *state->context;
+
+    //queues are accessed via their address and thus unknown to the dispatches
+    if (cmd.tracker) {
+        for (auto& tensor : state->tensors) {
+            auto& buffer = tensor.get().getBuffer();
+            cmd.tracker->buffer(buffer.buffer, buffer.offset, tensor.get().size_bytes(),
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+        }
+        cmd.tracker->barrier(context, cmd);
+    }
+
+    if (state->seed) {
+        DispatchCommand(state->seed->getProgram(), state->seedGroups, 1, 1,
+            { reinterpret_cast<const std::byte*>(&state->seedPush), sizeof(SeedPush) })
+            .record(cmd);
+        return;
+    }
+
+    //nodes of the same round only touch different halves of the queues and
+    //thus run without barriers in between, while rounds depend on each other
+    vulkan::GlobalBarrier toRound{
+        .srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+        .srcAccess = VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        .dstStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR |
+            VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR,
+        .dstAccess = VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR |
+            VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR
+    };
+    vulkan::GlobalBarrier toRefill{
+        .srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+        .srcAccess = VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        .dstStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+        .dstAccess = VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR
+    };
+    auto refill = [&](bool advance) {
+        auto push = state->refillPush;
+        push.advance = advance ? 1u : 0u;
+        DispatchCommand(state->refill->getProgram(), state->refillGroups, 1, 1,
+            { reinterpret_cast<const std::byte*>(&push), sizeof(RefillPush) })
+            .record(cmd);
+    };
+
+    //size the first round
+    refill(false);
+    for (auto i = 0u; i < state->rounds; ++i) {
+        vulkan::pipelineBarrier(context, cmd, {}, { &toRound, 1 });
+        state->dispatches->record(cmd);
+        vulkan::pipelineBarrier(context, cmd, {}, { &toRefill, 1 });
+        refill(true);
+    }
+}
+
+ExecutionGraphCommand::ExecutionGraphCommand(const ExecutionGraphCommand&) = default;
+ExecutionGraphCommand& ExecutionGraphCommand::operator=(const ExecutionGraphCommand&) = default;
+
+ExecutionGraphCommand::ExecutionGraphCommand(ExecutionGraphCommand&&) noexcept = default;
+ExecutionGraphCommand& ExecutionGraphCommand::operator=(ExecutionGraphCommand&&) noexcept = default;
+
+ExecutionGraphCommand::~ExecutionGraphCommand() = default;
+
+ExecutionGraphCommand::ExecutionGraphCommand(std::shared_ptr<const State> state)
+    : state(std::move(state))
+{}
+
+/******************************* EXECUTION GRAPH ******************************/
+
+struct ExecutionGraph::pImp {
+    ContextHandle context;
+    uint32_t capacity;
+    //size of a single queue in bytes
+    uint64_t stride;
+    std::vector<GraphNode> nodes;
+    Tensor<std::byte> queues;
+    //node count, queue addresses and limits of each node
+    Tensor<std::byte> table;
+    Program seed;
+    Program refill;
+
+    static std::vector<std::byte> createTable(
+        const ContextHandle& context,
+        std::span<const GraphNode> nodes,
+        uint64_t queues, uint64_t stride)
+    {
+        auto units = getDeviceInfo(context).computeUnits;
+        if (units == 0)
+            units = DefaultComputeUnits;
+
+        auto n = static_cast<uint32_t>(nodes.size());
+        std::vector<std::byte> data(8 + 16ull * n);
+        std::memcpy(data.data(), &n, 4);
+        auto addresses = data.data() + 8;
+        auto limits = addresses + 8ull * n;
+        for (auto i = 0u; i < n; ++i) {
+            auto address = queues + i * stride;
+            std::memcpy(addresses + 8ull * i, &address, 8);
+
+            auto& program = nodes[i].program.get();
+            auto& local = program.getLocalSize();
+            uint32_t limit[2] = {
+                std::max(local.x * local.y * local.z, 1u),
+                nodes[i].maxGroups
+            };
+            if (limit[1] == 0)
+                limit[1] = units * program.getStatistics().residentGroups;
+            std::memcpy(limits + 8ull * i, limit, 8);
+        }
+        return data;
+    }
+
+    pImp(ContextHandle context, std::span<const GraphNode> nodes, uint32_t capacity)
+        : context(std::move(context))
+        , capacity(capacity)
+        , stride(sizeof(WorkQueueHeader) + 8ull * capacity)
+        , nodes(nodes.begin(), nodes.end())
+        , queues(this->context, stride * std::max<size_t>(nodes.size(), 1))
+        , table(this->context, createTable(this->context, nodes, queues.address(), stride))
+        , seed(vulkan::compileKernel(this->context, SeedSource))
+        , refill(vulkan::compileKernel(this->context, RefillSource))
+    {}
+};
+
+uint32_t ExecutionGraph::getNodeCount() const noexcept {
+    return static_cast<uint32_t>(_pImp->nodes.size());
+}
+uint32_t ExecutionGraph::getCapacity() const noexcept {
+    return _pImp->capacity;
+}
+uint64_t ExecutionGraph::getAddress() const noexcept {
+    return _pImp->table.address();
+}
+const Tensor<std::byte>& ExecutionGraph::getTensor() const noexcept {
+    return _pImp->queues;
+}
+uint64_t ExecutionGraph::getQueueOffset(uint32_t node) const {
+    if (node >= getNodeCount())
+        throw std::out_of_range("Node index out of range!");
+    return node * _pImp->stride;
+}
+
+ExecutionGraphCommand ExecutionGraph::seed(uint32_t node, uint32_t count, uint32_t first) const {
+    if (node >= getNodeCount())
+        throw std::out_of_range("Node index out of range!");
+    if (count > _pImp->capacity)
+        throw std::out_of_range("Seed exceeds the capacity of the node!");
+
+    auto state = std::make_shared<ExecutionGraphCommand::State>();
+    state->context = _pImp->context;
+    state->tensors.push_back(_pImp->queues);
+    state->tensors.push_back(_pImp->table);
+    state->seed = &_pImp->seed;
+    auto threads = std::max(count, getNodeCount());
+    state->seedGroups = std::max((threads + GraphLocalSize - 1) / GraphLocalSize, 1u);
+    state->seedPush = {
+        .graph = getAddress(),
+        .records = 0,
+        .node = node,
+        .first = first,
+        .count = count,
+        .capacity = _pImp->capacity,
+        .fromRecords = 0,
+        ._padding = 0
+    };
+    return ExecutionGraphCommand(std::move(state));
+}
+
+ExecutionGraphCommand ExecutionGraph::seed(
+    uint32_t node, const Tensor<std::byte>& records, std::optional<uint32_t> count) const
+{
+    auto n = count.value_or(static_cast<uint32_t>(
+        std::min<uint64_t>(records.size_bytes() / 4, _pImp->capacity + 1ull)));
+    if (node >= getNodeCount())
+        throw std::out_of_range("Node index out of range!");
+    if (4ull * n > records.size_bytes())
+        throw std::out_of_range("Seed exceeds the size of the records tensor!");
+    if (n > _pImp->capacity)
+        throw std::out_of_range("Seed exceeds the capacity of the node!");
+
+    auto state = std::make_shared<ExecutionGraphCommand::State>();
+    state->context = _pImp->context;
+    state->tensors.push_back(_pImp->queues);
+    state->tensors.push_back(_pImp->table);
+    state->tensors.push_back(records);
+    state->seed = &_pImp->seed;
+    auto threads = std::max(n, getNodeCount());
+    state->seedGroups = std::max((threads + GraphLocalSize - 1) / GraphLocalSize, 1u);
+    state->seedPush = {
+        .graph = getAddress(),
+        .records = records.address(),
+        .node = node,
+        .first = 0,
+        .count = n,
+        .capacity = _pImp->capacity,
+        .fromRecords = 1,
+        ._padding = 0
+    };
+    return ExecutionGraphCommand(std::move(state));
+}
+
+ExecutionGraphCommand ExecutionGraph::launch(
+    std::span<const std::byte> push, uint32_t rounds) const
+{
+    auto n = getNodeCount();
+    auto state = std::make_shared<ExecutionGraphCommand::State>();
+    state->context = _pImp->context;
+    state->tensors.push_back(_pImp->queues);
+    state->tensors.push_back(_pImp->table);
+    state->refill = &_pImp->refill;
+    state->refillGroups = (n + GraphLocalSize - 1) / GraphLocalSize;
+    state->refillPush = {
+        .graph = getAddress(),
+        .limits = getAddress() + 8 + 8ull * n,
+        .advance = 0,
+        ._padding = 0
+    };
+    state->rounds = rounds;
+    state->push.assign(push.begin(), push.end());
+
+    std::vector<DispatchIndirectCommand> dispatches;
+    dispatches.reserve(n);
+    for (auto i = 0u; i < n; ++i) {
+        dispatches.push_back(_pImp->nodes[i].program.get().dispatchIndirect(
+            std::span<const std::byte>(state->push), _pImp->queues, i * _pImp->stride));
+    }
+    state->dispatches.emplace(std::move(dispatches));
+    return ExecutionGraphCommand(std::move(state));
+}
+
+ExecutionGraph::ExecutionGraph(ExecutionGraph&& other) noexcept = default;
+ExecutionGraph& ExecutionGraph::operator=(ExecutionGraph&& other) noexcept = default;
+
+ExecutionGraph::ExecutionGraph(
+    ContextHandle context, std::span<const GraphNode> nodes, uint32_t capacity)
+{
+    if (!isExecutionGraphEnabled(context))
+        throw std::logic_error("Execution graphs are not enabled!");
+    if (nodes.empty())
+        throw std::logic_error("Execution graph requires at least one node!");
+    if (capacity == 0)
+        throw std::logic_error("Execution graph requires a capacity of at least one!");
+    _pImp = std::make_unique<pImp>(std::move(context), nodes, capacity);
+}
+ExecutionGraph::~ExecutionGraph() = default;
+
+std::string_view getExecutionGraphSource() noexcept {
+    return ExecutionGraphSource;
+}
+
+}
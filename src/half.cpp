@@ -0,0 +1,177 @@
+#include "hephaistos/half.hpp"
+
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define HEPHAISTOS_HALF_NEON
+#include <arm_neon.h>
+#elif defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define HEPHAISTOS_HALF_F16C
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+//MSVC allows intrinsics without enabling them for the whole file
+#define HEPHAISTOS_TARGET_F16C
+#else
+#include <cpuid.h>
+#define HEPHAISTOS_TARGET_F16C __attribute__((target("avx,f16c")))
+#endif
+#endif
+
+namespace hephaistos {
+
+//bit tricks from the FP16 library by Marat Dukhan; both need the default
+//rounding mode and no fast math
+
+half toHalf(float value) noexcept {
+    constexpr auto scaleToInf = 0x1.0p+112f;
+    constexpr auto scaleToZero = 0x1.0p-110f;
+    auto base = (std::fabs(value) * scaleToInf) * scaleToZero;
+
+    auto w = std::bit_cast<uint32_t>(value);
+    auto shl1W = w + w;
+    auto sign = w & 0x80000000u;
+    auto bias = shl1W & 0xFF000000u;
+    if (bias < 0x71000000u)
+        bias = 0x71000000u;
+
+    //let the addition round the mantissa
+    base = std::bit_cast<float>((bias >> 1) + 0x07800000u) + base;
+    auto bits = std::bit_cast<uint32_t>(base);
+    auto expBits = (bits >> 13) & 0x00007C00u;
+    auto mantissaBits = bits & 0x00000FFFu;
+    auto nonsign = expBits + mantissaBits;
+    //NaN stays NaN
+    return { static_cast<uint16_t>((sign >> 16) | (shl1W > 0xFF000000u ? 0x7E00u : nonsign)) };
+}
+
+float fromHalf(half value) noexcept {
+    auto w = static_cast<uint32_t>(value.bits) << 16;
+    auto sign = w & 0x80000000u;
+    auto twoW = w + w;
+
+    //normalized values: move exponent and mantissa in place and rescale
+    constexpr auto expOffset = 0xE0u << 23;
+    constexpr auto expScale = 0x1.0p-112f;
+    auto normalized = std::bit_cast<float>((twoW >> 4) + expOffset) * expScale;
+    //denormalized values: use the mantissa as fraction of a magic number
+    constexpr auto magicMask = 126u << 23;
+    auto denormalized = std::bit_cast<float>((twoW >> 17) | magicMask) - 0.5f;
+
+    constexpr auto denormalizedCutoff = 1u << 27;
+    return std::bit_cast<float>(sign | (twoW < denormalizedCutoff
+        ? std::bit_cast<uint32_t>(denormalized)
+        : std::bit_cast<uint32_t>(normalized)));
+}
+
+namespace {
+
+#if defined(HEPHAISTOS_HALF_F16C)
+
+bool isF16CSupported() {
+    //F16C uses VEX encoding, thus the OS must save the AVX state too
+    unsigned int info[4] = {};
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 1);
+    for (auto i = 0; i < 4; ++i)
+        info[i] = static_cast<unsigned int>(regs[i]);
+#else
+    if (!__get_cpuid(1, &info[0], &info[1], &info[2], &info[3]))
+        return false;
+#endif
+    constexpr auto OSXSave = 1u << 27;
+    constexpr auto AVX = 1u << 28;
+    constexpr auto F16C = 1u << 29;
+    if ((info[2] & (OSXSave | AVX | F16C)) != (OSXSave | AVX | F16C))
+        return false;
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    auto xcr0 = _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    auto xcr0 = (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    //XMM and YMM state
+    return (xcr0 & 0x6) == 0x6;
+}
+
+const bool HasF16C = isF16CSupported();
+
+//returns the amount of converted values; the rest is left to the caller
+HEPHAISTOS_TARGET_F16C
+size_t convertToHalfSimd(const float* src, half* dst, size_t count) {
+    if (!HasF16C)
+        return 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto v = _mm256_loadu_ps(src + i);
+        auto h = _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), h);
+    }
+    return i;
+}
+HEPHAISTOS_TARGET_F16C
+size_t convertFromHalfSimd(const half* src, float* dst, size_t count) {
+    if (!HasF16C)
+        return 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+    }
+    return i;
+}
+
+#elif defined(HEPHAISTOS_HALF_NEON)
+
+size_t convertToHalfSimd(const float* src, half* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto h = vcvt_f16_f32(vld1q_f32(src + i));
+        vst1_u16(reinterpret_cast<uint16_t*>(dst + i), vreinterpret_u16_f16(h));
+    }
+    return i;
+}
+size_t convertFromHalfSimd(const half* src, float* dst, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        auto h = vreinterpret_f16_u16(vld1_u16(reinterpret_cast<const uint16_t*>(src + i)));
+        vst1q_f32(dst + i, vcvt_f32_f16(h));
+    }
+    return i;
+}
+
+#else
+
+size_t convertToHalfSimd(const float*, half*, size_t) {
+    return 0;
+}
+size_t convertFromHalfSimd(const half*, float*, size_t) {
+    return 0;
+}
+
+#endif
+
+}
+
+void convertToHalf(std::span<const float> src, std::span<half> dst) {
+    if (src.size() != dst.size())
+        throw std::logic_error("Source and destination must have the same size!");
+    auto i = convertToHalfSimd(src.data(), dst.data(), src.size());
+    for (; i < src.size(); ++i)
+        dst[i] = toHalf(src[i]);
+}
+
+void convertFromHalf(std::span<const half> src, std::span<float> dst) {
+    if (src.size() != dst.size())
+        throw std::logic_error("Source and destination must have the same size!");
+    auto i = convertFromHalfSimd(src.data(), dst.data(), src.size());
+    for (; i < src.size(); ++i)
+        dst[i] = fromHalf(src[i]);
+}
+
+}
@@ -1,16 +1,74 @@
 #include "hephaistos/image.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
 #include "volk.h"
 #include "vk_mem_alloc.h"
 
+namespace {
+
+//stbi allocates the decoded image itself. To skip copying it afterwards, the
+//first allocation of its exact size is served from the destination memory.
+//Intermediate buffers of the same size may claim it too, thus the result gets
+//copied if it ended up elsewhere.
+struct DecodeTarget {
+    void* memory = nullptr;
+    size_t size = 0;
+    bool claimed = false;
+};
+thread_local DecodeTarget decodeTarget;
+
+void* decodeMalloc(size_t size) {
+    auto& target = decodeTarget;
+    if (target.memory && !target.claimed && size == target.size) {
+        target.claimed = true;
+        return target.memory;
+    }
+    return std::malloc(size);
+}
+void decodeFree(void* ptr) {
+    auto& target = decodeTarget;
+    if (ptr && ptr == target.memory) {
+        target.claimed = false;
+        return;
+    }
+    std::free(ptr);
+}
+void* decodeRealloc(void* ptr, size_t size) {
+    auto& target = decodeTarget;
+    if (!ptr || ptr != target.memory)
+        return std::realloc(ptr, size);
+
+    //move out of the destination memory
+    auto result = std::malloc(size);
+    if (result)
+        std::memcpy(result, ptr, std::min(size, target.size));
+    target.claimed = false;
+    return result;
+}
+
+}
+
+#define STBI_MALLOC(size) decodeMalloc(size)
+#define STBI_FREE(ptr) decodeFree(ptr)
+#define STBI_REALLOC(ptr, size) decodeRealloc(ptr, size)
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "stb_image_write.h"
 
+#include "vk/hazard.hpp"
 #include "vk/result.hpp"
 #include "vk/types.hpp"
 #include "vk/util.hpp"
+#include "vk/workers.hpp"
 
 namespace hephaistos {
 
@@ -27,6 +85,7 @@ uint64_t getElementSize(ImageFormat format) {
         ELEMENT_SIZE(R8G8B8A8_UINT)
         ELEMENT_SIZE(R8G8B8A8_SINT)
         ELEMENT_SIZE(R16G16B16A16_UINT)
+        ELEMENT_SIZE(R16G16B16A16_UNORM)
         ELEMENT_SIZE(R16G16B16A16_SINT)
         ELEMENT_SIZE(R32_UINT)
         ELEMENT_SIZE(R32_SINT)
@@ -37,6 +96,20 @@ uint64_t getElementSize(ImageFormat format) {
         ELEMENT_SIZE(R32G32B32A32_UINT)
         ELEMENT_SIZE(R32G32B32A32_SINT)
         ELEMENT_SIZE(R32G32B32A32_SFLOAT)
+    //compressed formats: size of a 4x4 block
+    case ImageFormat::BC1_RGBA_UNORM:
+    case ImageFormat::BC4_UNORM:
+    case ImageFormat::BC4_SNORM:
+        return 8;
+    case ImageFormat::BC3_UNORM:
+    case ImageFormat::BC5_UNORM:
+    case ImageFormat::BC5_SNORM:
+    case ImageFormat::BC6H_UFLOAT:
+    case ImageFormat::BC6H_SFLOAT:
+    case ImageFormat::BC7_UNORM:
+    case ImageFormat::ETC2_R8G8B8A8_UNORM:
+    case ImageFormat::ASTC_4x4_UNORM:
+        return 16;
     default:
         throw std::runtime_error("Unknown image format");
     }
@@ -44,6 +117,40 @@ uint64_t getElementSize(ImageFormat format) {
 
 #undef ELEMENT_SIZE
 
+bool isCompressed(ImageFormat format) {
+    switch (format) {
+    case ImageFormat::BC1_RGBA_UNORM:
+    case ImageFormat::BC3_UNORM:
+    case ImageFormat::BC4_UNORM:
+    case ImageFormat::BC4_SNORM:
+    case ImageFormat::BC5_UNORM:
+    case ImageFormat::BC5_SNORM:
+    case ImageFormat::BC6H_UFLOAT:
+    case ImageFormat::BC6H_SFLOAT:
+    case ImageFormat::BC7_UNORM:
+    case ImageFormat::ETC2_R8G8B8A8_UNORM:
+    case ImageFormat::ASTC_4x4_UNORM:
+        return true;
+    default:
+        return false;
+    }
+}
+
+uint32_t getBlockExtent(ImageFormat format) {
+    //all supported compressed formats use 4x4 blocks
+    return isCompressed(format) ? 4 : 1;
+}
+
+uint64_t getImageSize(ImageFormat format,
+    uint32_t width, uint32_t height, uint32_t depth)
+{
+    uint64_t block = getBlockExtent(format);
+    return getElementSize(format) *
+        ((width + block - 1) / block) *
+        ((height + block - 1) / block) *
+        depth;
+}
+
 /*********************************** IMAGE ************************************/
 
 struct Image::Parameter {
@@ -54,9 +161,10 @@ uint32_t Image::getWidth() const noexcept { return width; }
 uint32_t Image::getHeight() const noexcept { return height; } 
 uint32_t Image::getDepth() const noexcept { return depth; } 
 ImageFormat Image::getFormat() const noexcept { return format; }
+uint32_t Image::getLayers() const noexcept { return layers; }
 const vulkan::Image& Image::getImage() const noexcept { return *image; }
 uint64_t Image::size_bytes() const noexcept {
-    return getElementSize(format) * width * height * depth;
+    return getImageSize(format, width, height, depth) * std::max(layers, 1u);
 }
 
 void Image::bindParameter(VkWriteDescriptorSet& binding) const {
@@ -74,6 +182,7 @@ Image::Image(Image&& other) noexcept
     , width(other.width)
     , height(other.height)
     , depth(other.depth)
+    , layers(other.layers)
 {}
 Image& Image::operator=(Image&& other) noexcept {
     Resource::operator=(std::move(other));
@@ -83,26 +192,55 @@ Image& Image::operator=(Image&& other) noexcept {
     width = other.width;
     height = other.height;
     depth = other.depth;
+    layers = other.layers;
     return *this;
 }
 
+namespace {
+
+//compressed formats cannot be written by shaders
+VkFormat toStorageFormat(ImageFormat format) {
+    if (isCompressed(format))
+        throw std::logic_error("Compressed formats are only supported by textures!");
+    return static_cast<VkFormat>(format);
+}
+
+}
+
+Image::Image(ContextHandle context, ImageFormat format,
+    uint32_t width, uint32_t height, uint32_t depth,
+    const AllocationHints& hints
+)
+    : Image(std::move(context), format, width, height, depth, 0, hints)
+{}
+Image::Image(ContextHandle context, ImageFormat format,
+    uint32_t width, uint32_t height, ArrayLayers layers,
+    const AllocationHints& hints
+)
+    : Image(std::move(context), format, width, height, 1, layers.count, hints)
+{}
 Image::Image(ContextHandle context, ImageFormat format,
-    uint32_t width, uint32_t height, uint32_t depth
+    uint32_t width, uint32_t height, uint32_t depth, uint32_t layers,
+    const AllocationHints& hints
 )
     : Resource(std::move(context))
     , image(vulkan::createImage(
         getContext(),
-        static_cast<VkFormat>(format),
+        toStorageFormat(format),
         width, height, depth,
         VK_IMAGE_USAGE_STORAGE_BIT |
         VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-        VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+        VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        1, layers,
+        vulkan::getAllocationCreateInfo(*getContext(), hints, 0,
+            VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE)
     ))
     , parameter(std::make_unique<Parameter>())
     , format(format)
     , width(width)
     , height(height)
     , depth(depth)
+    , layers(layers)
 {
     //transition image from undefined to general
     auto& con = *getContext();
@@ -114,9 +252,10 @@ Image::Image(ContextHandle context, ImageFormat format,
             .image = image,
             .subresourceRange = VkImageSubresourceRange{
                 VK_IMAGE_ASPECT_COLOR_BIT,
-                0, 1, 0, 1
+                0, 1, 0, VK_REMAINING_ARRAY_LAYERS
             }
         };
+        vulkan::count(con.counters.barriers);
         con.fnTable.vkCmdPipelineBarrier(cmdBuffer,
             VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
@@ -130,6 +269,7 @@ Image::Image(ContextHandle context, ImageFormat format,
         .imageView = image->view,
         .imageLayout = VK_IMAGE_LAYOUT_GENERAL
     };
+    trackResource("Image", size_bytes());
 }
 Image::~Image() = default;
 
@@ -167,6 +307,45 @@ bool isFilterSupported(
     return isFilterSupported(getDevice(context), format, filter);
 }
 
+bool isTextureFormatSupported(const DeviceHandle& device, ImageFormat format) {
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(device->device,
+        static_cast<VkFormat>(format), &props);
+
+    VkFormatFeatureFlags flags =
+        VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT |
+        VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+    return (props.optimalTilingFeatures & flags) == flags;
+}
+bool isTextureFormatSupported(const ContextHandle& context, ImageFormat format) {
+    return isTextureFormatSupported(getDevice(context), format);
+}
+
+uint32_t getMaxMipLevels(uint32_t width, uint32_t height, uint32_t depth) {
+    auto extent = std::max({ width, height, depth, 1u });
+    uint32_t levels = 1;
+    while (extent >>= 1)
+        ++levels;
+    return levels;
+}
+
+namespace {
+
+constexpr VkImageUsageFlags TextureUsage =
+    VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+    VK_IMAGE_USAGE_TRANSFER_SRC_BIT | //needed for generating mips
+    VK_IMAGE_USAGE_SAMPLED_BIT;
+
+//zero requests the full chain
+uint32_t getMipLevelCount(uint32_t mipLevels,
+    uint32_t width, uint32_t height, uint32_t depth)
+{
+    auto max = getMaxMipLevels(width, height, depth);
+    return mipLevels == 0 ? max : std::min(mipLevels, max);
+}
+
+}
+
 struct Texture::Parameter {
     VkSampler sampler;
     VkDescriptorImageInfo info;
@@ -176,9 +355,11 @@ uint32_t Texture::getWidth() const noexcept { return width; }
 uint32_t Texture::getHeight() const noexcept { return height; }
 uint32_t Texture::getDepth() const noexcept { return depth; }
 ImageFormat Texture::getFormat() const noexcept { return format; }
+uint32_t Texture::getMipLevels() const noexcept { return mipLevels; }
+uint32_t Texture::getLayers() const noexcept { return layers; }
 const vulkan::Image& Texture::getImage() const noexcept { return *image; }
 uint64_t Texture::size_bytes() const noexcept {
-    return getElementSize(format) * width * height * depth;
+    return getImageSize(format, width, height, depth) * std::max(layers, 1u);
 }
 
 void Texture::bindParameter(VkWriteDescriptorSet& binding) const {
@@ -190,14 +371,19 @@ void Texture::bindParameter(VkWriteDescriptorSet& binding) const {
 
 Texture::Texture(Texture&& other) noexcept
     : Resource(std::move(other))
-    , image(std::move(image))
+    , image(std::move(other.image))
     , parameter(std::move(other.parameter))
     , format(other.format)
     , width(other.width)
     , height(other.height)
     , depth(other.depth)
+    , mipLevels(other.mipLevels)
+    , layers(other.layers)
 {}
 Texture& Texture::operator=(Texture&& other) noexcept {
+    //give back our sampler before taking over the other one
+    if (parameter)
+        vulkan::releaseSampler(*getContext(), parameter->sampler);
     Resource::operator=(std::move(other));
     image = std::move(other.image);
     parameter = std::move(other.parameter);
@@ -205,6 +391,8 @@ Texture& Texture::operator=(Texture&& other) noexcept {
     width = other.width;
     height = other.height;
     depth = other.depth;
+    mipLevels = other.mipLevels;
+    layers = other.layers;
     return *this;
 }
 
@@ -212,328 +400,1957 @@ Texture::Texture(
     ContextHandle context,
     ImageFormat format,
     uint32_t width,
-    const Sampler& sampler
+    const Sampler& sampler,
+    uint32_t mipLevels
+)
+    : Texture(std::move(context), format, width, 1, 1, sampler, mipLevels)
+{}
+Texture::Texture(
+    ContextHandle context,
+    ImageFormat format,
+    uint32_t width,
+    uint32_t height,
+    const Sampler& sampler,
+    uint32_t mipLevels
+)
+    : Texture(std::move(context), format, width, height, 1, sampler, mipLevels)
+{}
+Texture::Texture(
+    ContextHandle context,
+    ImageFormat format,
+    uint32_t width,
+    uint32_t height,
+    uint32_t depth,
+    const Sampler& sampler,
+    uint32_t mipLevels
+)
+    : Texture(std::move(context), format, width, height, depth, 0, sampler, mipLevels)
+{}
+Texture::Texture(
+    ContextHandle context,
+    ImageFormat format,
+    uint32_t width,
+    uint32_t height,
+    ArrayLayers layers,
+    const Sampler& sampler,
+    uint32_t mipLevels
 )
-    : Texture(std::move(context), format, width, 1, 1, sampler)
+    : Texture(std::move(context), format, width, height, 1, layers.count, sampler, mipLevels)
 {}
 Texture::Texture(
     ContextHandle context,
     ImageFormat format,
     uint32_t width,
     uint32_t height,
-    const Sampler& sampler
+    uint32_t depth,
+    uint32_t layers,
+    const Sampler& sampler,
+    uint32_t mipLevels
 )
-    : Texture(std::move(context), format, width, height, 1, sampler)
+    : Texture(context,
+        vulkan::createImage(
+            context,
+            static_cast<VkFormat>(format),
+            width, height, depth,
+            TextureUsage,
+            getMipLevelCount(mipLevels, width, height, depth),
+            layers),
+        format, width, height, depth, layers, sampler, mipLevels)
 {}
 Texture::Texture(
     ContextHandle context,
+    ImageHandle handle,
     ImageFormat format,
     uint32_t width,
     uint32_t height,
     uint32_t depth,
-    const Sampler& sampler
+    uint32_t layers,
+    const Sampler& sampler,
+    uint32_t mipLevels
 )
     : Resource(std::move(context))
-    , image(vulkan::createImage(
-        getContext(),
-        static_cast<VkFormat>(format),
-        width, height, depth,
-        VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-        VK_IMAGE_USAGE_SAMPLED_BIT
-    ))
+    , image(std::move(handle))
     , parameter(std::make_unique<Parameter>())
     , format(format)
     , width(width)
     , height(height)
     , depth(depth)
+    , mipLevels(getMipLevelCount(mipLevels, width, height, depth))
+    , layers(layers)
 {
+    //transition all levels from undefined to shader read, so partial updates
+    //can keep the remaining content
+    auto& con = *getContext();
+    oneTimeSubmit(con, [&image = image->image, &con](VkCommandBuffer cmdBuffer) {
+        VkImageMemoryBarrier barrier{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .image = image,
+            .subresourceRange = VkImageSubresourceRange{
+                VK_IMAGE_ASPECT_COLOR_BIT,
+                0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS
+            }
+        };
+        vulkan::count(con.counters.barriers);
+        con.fnTable.vkCmdPipelineBarrier(cmdBuffer,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_DEPENDENCY_BY_REGION_BIT,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier);
+    });
+
     //create sampler
     VkSamplerCreateInfo info{
         .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
         .magFilter = static_cast<VkFilter>(sampler.filter),
         .minFilter = static_cast<VkFilter>(sampler.filter),
-        .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR, //Really Needed?
+        .mipmapMode = static_cast<VkSamplerMipmapMode>(sampler.mipmapMode),
         .addressModeU = static_cast<VkSamplerAddressMode>(sampler.addressModeU),
         .addressModeV = static_cast<VkSamplerAddressMode>(sampler.addressModeV),
         .addressModeW = static_cast<VkSamplerAddressMode>(sampler.addressModeW),
+        .mipLodBias = sampler.lodBias,
+        .minLod = sampler.minLod,
+        .maxLod = sampler.maxLod,
         .unnormalizedCoordinates = sampler.unnormalizedCoordinates
     };
-    vulkan::checkResult(getContext()->fnTable.vkCreateSampler(
-        getContext()->device, &info, nullptr, &parameter->sampler));
+    //unnormalized coordinates only allow sampling the base level
+    if (sampler.unnormalizedCoordinates) {
+        info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        info.mipLodBias = 0.0f;
+        info.minLod = 0.0f;
+        info.maxLod = 0.0f;
+    }
+    //textures with the same configuration share their sampler
+    parameter->sampler = vulkan::acquireSampler(*getContext(), info);
 
     parameter->info = VkDescriptorImageInfo{
         .sampler = parameter->sampler,
         .imageView = image->view,
         .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
     };
+    trackResource("Texture", size_bytes());
 }
 
 Texture::~Texture() {
-    auto& con = *getContext();
-    con.fnTable.vkDestroySampler(con.device, parameter->sampler, nullptr);
+    //moved from textures have no sampler
+    if (parameter)
+        vulkan::releaseSampler(*getContext(), parameter->sampler);
 }
 
-/******************************** IMAGE BUFFER ********************************/
+/******************************* SPARSE TEXTURE *******************************/
 
-uint32_t ImageBuffer::getWidth() const { return width; }
-uint32_t ImageBuffer::getHeight() const { return height; }
+namespace {
 
-Image ImageBuffer::createImage(bool copy) const {
-    Image result(getContext(), Format, width, height, 1);
+constexpr char SparseFeedbackSource[] = R"(#ifndef _INCLUDE_HEPHAISTOS_SPARSE
+#define _INCLUDE_HEPHAISTOS_SPARSE
 
-    //copy image via one time submit -> thus synchronous
-    if (copy) {
-        UpdateImageCommand copyCommand(*this, result);
-        vulkan::oneTimeSubmit(*getContext(), [&copyCommand](VkCommandBuffer cmd) {
-            //package into vulkan::command
-            vulkan::Command command{ cmd, 0 };
-            copyCommand.record(command);
-        });
-    }
+#extension GL_EXT_buffer_reference : require
 
-    return result;
+//Access feedback of sparse textures. Programs mark the tiles their lookups
+//touch, which the host reads back via SparseTexture::fetchAccessedTiles() to
+//decide which tiles to commit. Include this header directly after the
+//version directive and pass SparseTexture::getFeedback() e.g. as push
+//constant:
+//  vec4 value = textureLod(volume, uvw, lod);
+//  sparseFeedbackMark(feedback, uvw, lod);
+
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer SparseFeedbackTiles {
+    uint tiles[];
+};
+
+struct SparseFeedback {
+    SparseFeedbackTiles tiles;
+    //size of the first mip level in texels
+    uint width, height, depth;
+    //size of a tile in texels
+    uint tileWidth, tileHeight, tileDepth;
+    //mip levels committed in tiles; the mip tail is always resident
+    uint levels;
+    uint _reserved;
+};
+
+uvec3 sparseFeedbackLevelSize(SparseFeedback f, uint level) {
+    return max(uvec3(f.width, f.height, f.depth) >> level, uvec3(1u));
+}
+uvec3 sparseFeedbackTileGrid(SparseFeedback f, uint level) {
+    uvec3 tile = uvec3(f.tileWidth, f.tileHeight, f.tileDepth);
+    return (sparseFeedbackLevelSize(f, level) + tile - 1u) / tile;
 }
 
-Texture ImageBuffer::createTexture(const Sampler& sampler, bool copy) const {
-    Texture result(getContext(), Format, width, height, sampler);
+//marks the tile containing the given texel of the given level as accessed
+void sparseFeedbackMark(SparseFeedback f, uvec3 texel, uint level) {
+    if (level >= f.levels)
+        return;
 
-    //copy image via one time submit -> synchronous
-    if (copy) {
-        UpdateTextureCommand copyCommand(*this, result);
-        vulkan::oneTimeSubmit(*getContext(), [&copyCommand](VkCommandBuffer cmd) {
-            //package into vulkan::command
-            vulkan::Command command{ cmd, 0 };
-            copyCommand.record(command);
-        });
+    //tiles are ordered by level, then z, y and x
+    uint index = 0u;
+    for (uint l = 0u; l < level; ++l) {
+        uvec3 grid = sparseFeedbackTileGrid(f, l);
+        index += grid.x * grid.y * grid.z;
+    }
+    uvec3 grid = sparseFeedbackTileGrid(f, level);
+    texel = min(texel, sparseFeedbackLevelSize(f, level) - 1u);
+    uvec3 tile = texel / uvec3(f.tileWidth, f.tileHeight, f.tileDepth);
+    index += (tile.z * grid.y + tile.y) * grid.x + tile.x;
+
+    //skip the write if already marked to save bandwidth
+    if (f.tiles.tiles[index] == 0u)
+        f.tiles.tiles[index] = 1u;
+}
+//marks the tiles a lookup at the given normalized coordinates and level of
+//detail reads, i.e. both levels interpolated in between
+void sparseFeedbackMark(SparseFeedback f, vec3 uvw, float lod) {
+    lod = max(lod, 0.0);
+    uint level = uint(lod);
+    uvw = clamp(uvw, 0.0, 1.0);
+    sparseFeedbackMark(f, uvec3(uvw * vec3(sparseFeedbackLevelSize(f, level))), level);
+    if (fract(lod) > 0.0) {
+        sparseFeedbackMark(f, uvec3(uvw * vec3(sparseFeedbackLevelSize(f, level + 1u))), level + 1u);
     }
-
-    return result;
 }
 
-ImageBuffer ImageBuffer::load(ContextHandle context, const char* filename) {
-    //load image
-    //unfortunately, stbi wants to allocate its own memory, so we have an extra copy...
-    int x, y, n;
-    unsigned char* data = stbi_load(filename, &x, &y, &n, STBI_rgb_alpha);
-    ImageBuffer result(std::move(context), x, y);
-    auto mem = result.getMemory();
+#endif
+)";
 
-    //copy image and free data
-    memcpy(mem.data(), data, result.size_bytes());
-    stbi_image_free(data);
+constexpr VkImageCreateFlags SparseTextureFlags =
+    VK_IMAGE_CREATE_SPARSE_BINDING_BIT | VK_IMAGE_CREATE_SPARSE_RESIDENCY_BIT;
 
-    //done
-    return result;
+std::vector<VkSparseImageFormatProperties> getSparseFormatProperties(
+    const vulkan::Context& context, ImageFormat format)
+{
+    uint32_t count = 0;
+    vkGetPhysicalDeviceSparseImageFormatProperties(context.physicalDevice,
+        static_cast<VkFormat>(format), VK_IMAGE_TYPE_3D, VK_SAMPLE_COUNT_1_BIT,
+        TextureUsage, VK_IMAGE_TILING_OPTIMAL, &count, nullptr);
+    std::vector<VkSparseImageFormatProperties> props(count);
+    vkGetPhysicalDeviceSparseImageFormatProperties(context.physicalDevice,
+        static_cast<VkFormat>(format), VK_IMAGE_TYPE_3D, VK_SAMPLE_COUNT_1_BIT,
+        TextureUsage, VK_IMAGE_TILING_OPTIMAL, &count, props.data());
+    return props;
 }
-ImageBuffer ImageBuffer::load(ContextHandle context, std::span<const std::byte> memory) {
-    int x, y, n;
-    auto data = stbi_load_from_memory(
-        reinterpret_cast<const unsigned char*>(memory.data()),
-        static_cast<int>(memory.size_bytes()),
-        &x, &y, &n, STBI_rgb_alpha);
-    ImageBuffer result(context, x, y);
-    auto mem = result.getMemory();
 
-    memcpy(mem.data(), data, mem.size_bytes());
-    stbi_image_free(data);
+ImageHandle createSparseImage(
+    const ContextHandle& context,
+    ImageFormat format,
+    uint32_t width, uint32_t height, uint32_t depth,
+    uint32_t mipLevels)
+{
+    if (!context->sparseTexture)
+        throw std::runtime_error("Sparse textures are not supported by the device!");
+    if (!isSparseTextureFormatSupported(context, format))
+        throw std::runtime_error("Format is not supported for sparse textures!");
+
+    //memory is bound tile wise by the sparse texture
+    ImageHandle result{ new vulkan::Image({ 0, 0, nullptr, *context }), vulkan::destroyImage };
+    VkImageCreateInfo imageInfo{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .flags = SparseTextureFlags,
+        .imageType = VK_IMAGE_TYPE_3D,
+        .format = static_cast<VkFormat>(format),
+        .extent = { width, height, depth },
+        .mipLevels = mipLevels,
+        .arrayLayers = 1,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = TextureUsage
+    };
+    if (context->queueFamilies.size() > 1) {
+        imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        imageInfo.queueFamilyIndexCount = static_cast<uint32_t>(context->queueFamilies.size());
+        imageInfo.pQueueFamilyIndices = context->queueFamilies.data();
+    }
+    vulkan::checkResult(context->fnTable.vkCreateImage(
+        context->device, &imageInfo, nullptr, &result->image));
+
+    VkImageViewCreateInfo viewInfo{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image = result->image,
+        .viewType = VK_IMAGE_VIEW_TYPE_3D,
+        .format = static_cast<VkFormat>(format),
+        .subresourceRange = {
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            0, mipLevels, 0, 1
+        }
+    };
+    vulkan::checkResult(context->fnTable.vkCreateImageView(
+        context->device, &viewInfo, nullptr, &result->view));
 
     return result;
 }
 
-void ImageBuffer::save(const char* filename) const {
-    stbi_write_png(filename,
-        getWidth(), getHeight(), STBI_rgb_alpha,
-        getMemory().data(), getWidth() * 4);
+void bindSparse(const vulkan::Context& context, VkImage image,
+    std::span<const VkSparseImageMemoryBind> binds,
+    std::span<const VkSparseMemoryBind> opaqueBinds = {})
+{
+    VkSparseImageMemoryBindInfo imageBind{
+        .image = image,
+        .bindCount = static_cast<uint32_t>(binds.size()),
+        .pBinds = binds.data()
+    };
+    VkSparseImageOpaqueMemoryBindInfo opaqueBind{
+        .image = image,
+        .bindCount = static_cast<uint32_t>(opaqueBinds.size()),
+        .pBinds = opaqueBinds.data()
+    };
+    vulkan::bindSparseSync(context, {
+        .sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO,
+        .imageOpaqueBindCount = opaqueBinds.empty() ? 0u : 1u,
+        .pImageOpaqueBinds = &opaqueBind,
+        .imageBindCount = binds.empty() ? 0u : 1u,
+        .pImageBinds = &imageBind
+    });
 }
 
-ImageBuffer::ImageBuffer(ImageBuffer&& other) noexcept
-    : Buffer<ElementType>(std::move(other))
-    , width(other.width)
-    , height(other.height)
-{}
-ImageBuffer& ImageBuffer::operator=(ImageBuffer&& other) noexcept {
-    Buffer<ElementType>::operator=(std::move(other));
-    width = other.width;
-    height = other.height;
-    return *this;
 }
 
-ImageBuffer::ImageBuffer(ContextHandle context, uint32_t width, uint32_t height)
-    : Buffer<ElementType>(std::move(context), width * height)
-    , width(width)
-    , height(height)
-{}
-ImageBuffer::~ImageBuffer() = default;
-
-/************************************ COPY ************************************/
+bool isSparseTextureSupported(const ContextHandle& context) {
+    return context->sparseTexture;
+}
+bool isSparseTextureFormatSupported(const ContextHandle& context, ImageFormat format) {
+    if (!context->sparseTexture || format == ImageFormat::UNKNOWN)
+        return false;
+    if (!isTextureFormatSupported(context, format))
+        return false;
+    return !getSparseFormatProperties(*context, format).empty();
+}
 
-namespace {
+struct SparseTexture::pImp {
+    //size of the first level and of a tile in texels
+    VkExtent3D extent;
+    VkExtent3D granularity;
+    VkDeviceSize tileSize;
+    uint32_t memoryTypeBits;
+    //tile grid and index of the first tile per tiled level
+    std::vector<SparseTile> grids;
+    std::vector<uint32_t> offsets;
+    //memory backing each tile; null if not committed
+    std::vector<VmaAllocation> tiles;
+    size_t committed = 0;
+    //memory of the mip tail, committed for the texture's lifetime
+    VmaAllocation tail = nullptr;
+
+    Tensor<uint32_t> feedback;
+
+    uint32_t getIndex(const SparseTile& tile) const {
+        if (tile.level >= grids.size())
+            throw std::logic_error("Tile is not part of a tiled mip level!");
+        auto& grid = grids[tile.level];
+        if (tile.x >= grid.x || tile.y >= grid.y || tile.z >= grid.z)
+            throw std::logic_error("Tile is outside the texture!");
+        return offsets[tile.level] + (tile.z * grid.y + tile.y) * grid.x + tile.x;
+    }
+    SparseTile getTile(uint32_t index) const {
+        auto level = static_cast<uint32_t>(
+            std::upper_bound(offsets.begin(), offsets.end(), index) - offsets.begin() - 1);
+        auto& grid = grids[level];
+        index -= offsets[level];
+        return { index % grid.x, index / grid.x % grid.y, index / (grid.x * grid.y), level };
+    }
+    //region of the tile without memory; tiles at the border are clipped
+    VkSparseImageMemoryBind getBind(const SparseTile& tile) const {
+        auto& g = granularity;
+        VkOffset3D offset{
+            static_cast<int32_t>(tile.x * g.width),
+            static_cast<int32_t>(tile.y * g.height),
+            static_cast<int32_t>(tile.z * g.depth)
+        };
+        return {
+            .subresource = { VK_IMAGE_ASPECT_COLOR_BIT, tile.level, 0 },
+            .offset = offset,
+            .extent = {
+                std::min(g.width, std::max(extent.width >> tile.level, 1u) - tile.x * g.width),
+                std::min(g.height, std::max(extent.height >> tile.level, 1u) - tile.y * g.height),
+                std::min(g.depth, std::max(extent.depth >> tile.level, 1u) - tile.z * g.depth)
+            }
+        };
+    }
 
-constexpr auto DIFFERENT_CONTEXT_ERROR_STR =
-    "Source and destination of a copy command must originate from the same context!";
-constexpr auto SIZE_MISMATCH_ERROR_STR =
-    "Source and destination must have the same size!";
+    explicit pImp(Tensor<uint32_t> feedback)
+        : feedback(std::move(feedback))
+    {}
+    ~pImp() {
+        std::vector<VmaAllocation> allocations;
+        std::copy_if(tiles.begin(), tiles.end(), std::back_inserter(allocations),
+            [](VmaAllocation tile) { return tile != nullptr; });
+        if (tail)
+            allocations.push_back(tail);
+        //image gets destroyed afterwards and cannot be used in between
+        vmaFreeMemoryPages(feedback.getContext()->allocator,
+            allocations.size(), allocations.data());
+    }
+};
 
+uint32_t SparseTexture::getTileWidth() const noexcept {
+    return _pImp->granularity.width;
+}
+uint32_t SparseTexture::getTileHeight() const noexcept {
+    return _pImp->granularity.height;
+}
+uint32_t SparseTexture::getTileDepth() const noexcept {
+    return _pImp->granularity.depth;
+}
+uint64_t SparseTexture::getTileSize() const noexcept {
+    return _pImp->tileSize;
+}
+uint32_t SparseTexture::getTiledLevels() const noexcept {
+    return static_cast<uint32_t>(_pImp->grids.size());
+}
+SparseTile SparseTexture::getTileGrid(uint32_t level) const {
+    if (level >= _pImp->grids.size())
+        throw std::logic_error("Mip level is not tiled!");
+    return _pImp->grids[level];
+}
+uint32_t SparseTexture::getTileCount() const noexcept {
+    return static_cast<uint32_t>(_pImp->tiles.size());
+}
+uint64_t SparseTexture::size_committed() const noexcept {
+    return _pImp->committed * _pImp->tileSize;
+}
+bool SparseTexture::isCommitted(const SparseTile& tile) const {
+    return _pImp->tiles[_pImp->getIndex(tile)] != nullptr;
 }
 
-void RetrieveImageCommand::record(vulkan::Command& cmd) const {
-    //alias for shorter code
-    auto& src = Source.get();
-    auto& dst = Destination.get();
-    //Check for src and dst to be from the same context
-    if (src.getContext().get() != dst.getContext().get())
-        throw std::logic_error(DIFFERENT_CONTEXT_ERROR_STR);
-    auto& context = src.getContext();
-    //check both have the same size
-    if (src.size_bytes() != dst.size_bytes())
-        throw std::logic_error(SIZE_MISMATCH_ERROR_STR);
-    auto size = src.size_bytes();
+void SparseTexture::commit(std::span<const SparseTile> tiles) {
+    //collect missing tiles; validate all before allocating anything
+    std::vector<uint32_t> missing;
+    for (auto& tile : tiles) {
+        auto index = _pImp->getIndex(tile);
+        if (!_pImp->tiles[index] &&
+            std::find(missing.begin(), missing.end(), index) == missing.end())
+        {
+            missing.push_back(index);
+        }
+    }
+    if (missing.empty())
+        return;
+
+    //allocate memory
+    auto& context = *getContext();
+    VkMemoryRequirements requirements{
+        .size = _pImp->tileSize,
+        .alignment = _pImp->tileSize,
+        .memoryTypeBits = _pImp->memoryTypeBits
+    };
+    VmaAllocationCreateInfo allocInfo{
+        .preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+    };
+    std::vector<VmaAllocation> allocations(missing.size());
+    std::vector<VmaAllocationInfo> infos(missing.size());
+    vulkan::checkResult(vmaAllocateMemoryPages(
+        context.allocator, &requirements, &allocInfo,
+        missing.size(), allocations.data(), infos.data()));
+
+    //bind it
+    std::vector<VkSparseImageMemoryBind> binds(missing.size());
+    for (size_t i = 0; i < missing.size(); ++i) {
+        binds[i] = _pImp->getBind(_pImp->getTile(missing[i]));
+        binds[i].memory = infos[i].deviceMemory;
+        binds[i].memoryOffset = infos[i].offset;
+    }
+    try {
+        bindSparse(context, getImage().image, binds);
+    }
+    catch (...) {
+        vmaFreeMemoryPages(context.allocator, allocations.size(), allocations.data());
+        throw;
+    }
 
-    //we're acting on the transfer stage
-    cmd.stage |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+    for (size_t i = 0; i < missing.size(); ++i)
+        _pImp->tiles[missing[i]] = allocations[i];
+    _pImp->committed += missing.size();
+}
 
-    //ensure writing to image finished and prepare image as transfer src
-    VkImageMemoryBarrier barrier{
-        .sType            = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-        .srcAccessMask    = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
-        .dstAccessMask    = VK_ACCESS_TRANSFER_READ_BIT,
-        .oldLayout        = VK_IMAGE_LAYOUT_GENERAL,
-        .newLayout        = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-        .image            = src.getImage().image,
-        .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
-    };
-    context->fnTable.vkCmdPipelineBarrier(cmd.buffer,
-        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_DEPENDENCY_BY_REGION_BIT,
-        0, nullptr,
-        0, nullptr,
-        1, &barrier);
+void SparseTexture::decommit(std::span<const SparseTile> tiles) {
+    std::vector<uint32_t> released;
+    for (auto& tile : tiles) {
+        auto index = _pImp->getIndex(tile);
+        if (_pImp->tiles[index] &&
+            std::find(released.begin(), released.end(), index) == released.end())
+        {
+            released.push_back(index);
+        }
+    }
+    if (released.empty())
+        return;
+
+    //unbind memory
+    auto& context = *getContext();
+    std::vector<VkSparseImageMemoryBind> binds(released.size());
+    std::vector<VmaAllocation> allocations(released.size());
+    for (size_t i = 0; i < released.size(); ++i) {
+        binds[i] = _pImp->getBind(_pImp->getTile(released[i]));
+        allocations[i] = std::exchange(_pImp->tiles[released[i]], nullptr);
+    }
+    _pImp->committed -= released.size();
+    bindSparse(context, getImage().image, binds);
 
-    //issue copy
-    VkBufferImageCopy copy{
-        .imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0 ,1 },
-        .imageExtent = { src.getWidth(), src.getHeight(), src.getDepth() }
-    };
-    context->fnTable.vkCmdCopyImageToBuffer(cmd.buffer,
-        src.getImage().image,
-        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-        dst.getBuffer().buffer,
-        1, &copy);
+    vmaFreeMemoryPages(context.allocator, allocations.size(), allocations.data());
+}
 
-    //ensure transfer finished and return image layout
-    barrier = VkImageMemoryBarrier{
-        .sType            = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-        .srcAccessMask    = VK_ACCESS_TRANSFER_READ_BIT,
-        .dstAccessMask    = VK_ACCESS_MEMORY_WRITE_BIT, //TODO: Not entirely shure about that one
-        .oldLayout        = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-        .newLayout        = VK_IMAGE_LAYOUT_GENERAL,
-        .image            = src.getImage().image,
-        .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
-    };
-    VkBufferMemoryBarrier bufferBarrier{
-        .sType         = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
-        .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
-        .buffer        = dst.getBuffer().buffer,
-        .size          = VK_WHOLE_SIZE
+void SparseTexture::decommitAll() {
+    std::vector<SparseTile> tiles;
+    for (uint32_t i = 0; i < _pImp->tiles.size(); ++i) {
+        if (_pImp->tiles[i])
+            tiles.push_back(_pImp->getTile(i));
+    }
+    decommit(tiles);
+}
+
+SparseFeedback SparseTexture::getFeedback() const noexcept {
+    return {
+        .address = _pImp->feedback.address(),
+        .width = getWidth(),
+        .height = getHeight(),
+        .depth = getDepth(),
+        .tileWidth = getTileWidth(),
+        .tileHeight = getTileHeight(),
+        .tileDepth = getTileDepth(),
+        .levels = getTiledLevels()
     };
-    context->fnTable.vkCmdPipelineBarrier(cmd.buffer,
-        VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_PIPELINE_STAGE_HOST_BIT,
-        VK_DEPENDENCY_BY_REGION_BIT,
-        0, nullptr,
-        1, &bufferBarrier,
-        1, &barrier);
+}
+const Tensor<uint32_t>& SparseTexture::getFeedbackTensor() const noexcept {
+    return _pImp->feedback;
 }
 
-RetrieveImageCommand::RetrieveImageCommand(const RetrieveImageCommand& other) = default;
-RetrieveImageCommand& RetrieveImageCommand::operator=(const RetrieveImageCommand& other) = default;
+std::vector<SparseTile> SparseTexture::fetchAccessedTiles(bool reset) {
+    std::vector<uint32_t> words(_pImp->feedback.size());
+    _pImp->feedback.retrieve(std::span<uint32_t>(words));
 
-RetrieveImageCommand::RetrieveImageCommand(RetrieveImageCommand&& other) noexcept = default;
-RetrieveImageCommand& RetrieveImageCommand::operator=(RetrieveImageCommand&& other) noexcept = default;
+    std::vector<SparseTile> result;
+    for (uint32_t i = 0; i < _pImp->tiles.size(); ++i) {
+        if (words[i])
+            result.push_back(_pImp->getTile(i));
+    }
 
-RetrieveImageCommand::RetrieveImageCommand(const Image& src, const Buffer<std::byte>& dst)
-    : Command()
-    , Source(std::cref(src))
-    , Destination(std::cref(dst))
-{}
-RetrieveImageCommand::~RetrieveImageCommand() = default;
+    if (reset && !result.empty()) {
+        std::fill(words.begin(), words.end(), 0u);
+        _pImp->feedback.update(std::span<const uint32_t>(words));
+    }
+    return result;
+}
 
-void UpdateImageCommand::record(vulkan::Command& cmd) const {
-    //alias for shorter code
-    auto& src = Source.get();
-    auto& dst = Destination.get();
-    //Check for src and dst to be from the same context
-    if (src.getContext().get() != dst.getContext().get())
-        throw std::logic_error(DIFFERENT_CONTEXT_ERROR_STR);
-    auto& context = src.getContext();
-    //check both have the same size
-    if (src.size_bytes() != dst.size_bytes())
-        throw std::logic_error(SIZE_MISMATCH_ERROR_STR);
-    auto size = src.size_bytes();
+SparseTexture::SparseTexture(SparseTexture&& other) noexcept = default;
+SparseTexture& SparseTexture::operator=(SparseTexture&& other) noexcept = default;
 
-    //we're acting on the transfer stage
+SparseTexture::SparseTexture(
+    ContextHandle context,
+    ImageFormat format,
+    uint32_t width,
+    uint32_t height,
+    uint32_t depth,
+    const Sampler& sampler,
+    uint32_t mipLevels
+)
+    : Texture(context,
+        createSparseImage(context, format, width, height, depth,
+            getMipLevelCount(mipLevels, width, height, depth)),
+        format, width, height, depth, 0, sampler, mipLevels)
+    , _pImp(nullptr)
+{
+    auto& con = *getContext();
+    auto image = getImage().image;
+
+    //the alignment is the size of a tile in bytes
+    VkMemoryRequirements requirements;
+    con.fnTable.vkGetImageMemoryRequirements(con.device, image, &requirements);
+    uint32_t count = 0;
+    con.fnTable.vkGetImageSparseMemoryRequirements(con.device, image, &count, nullptr);
+    std::vector<VkSparseImageMemoryRequirements> sparseRequirements(count);
+    con.fnTable.vkGetImageSparseMemoryRequirements(
+        con.device, image, &count, sparseRequirements.data());
+    auto pSparse = std::find_if(sparseRequirements.begin(), sparseRequirements.end(),
+        [](const VkSparseImageMemoryRequirements& r) {
+            return (r.formatProperties.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT) != 0;
+        });
+    if (pSparse == sparseRequirements.end())
+        throw std::runtime_error("Format is not supported for sparse textures!");
+    auto& sparse = *pSparse;
+
+    //levels not in the mip tail are committed in tiles
+    auto granularity = sparse.formatProperties.imageGranularity;
+    auto tiledLevels = std::min(sparse.imageMipTailFirstLod, getMipLevels());
+    std::vector<SparseTile> grids(tiledLevels);
+    std::vector<uint32_t> offsets(tiledLevels);
+    uint32_t tileCount = 0;
+    for (uint32_t level = 0; level < tiledLevels; ++level) {
+        grids[level] = {
+            (std::max(width >> level, 1u) + granularity.width - 1) / granularity.width,
+            (std::max(height >> level, 1u) + granularity.height - 1) / granularity.height,
+            (std::max(depth >> level, 1u) + granularity.depth - 1) / granularity.depth,
+            level
+        };
+        offsets[level] = tileCount;
+        tileCount += grids[level].x * grids[level].y * grids[level].z;
+    }
+
+    //feedback starts cleared; keep at least one word to get an address
+    std::vector<uint32_t> zeros(std::max(tileCount, 1u), 0u);
+    _pImp = std::make_unique<pImp>(Tensor<uint32_t>(getContext(),
+        std::span<const uint32_t>(zeros), true));
+    _pImp->extent = { width, height, depth };
+    _pImp->granularity = granularity;
+    _pImp->tileSize = requirements.alignment;
+    _pImp->memoryTypeBits = requirements.memoryTypeBits;
+    _pImp->grids = std::move(grids);
+    _pImp->offsets = std::move(offsets);
+    _pImp->tiles.resize(tileCount, nullptr);
+
+    //commit the mip tail, which cannot be split into tiles
+    if (sparse.imageMipTailFirstLod < getMipLevels() && sparse.imageMipTailSize > 0) {
+        VkMemoryRequirements tailRequirements{
+            .size = sparse.imageMipTailSize,
+            .alignment = requirements.alignment,
+            .memoryTypeBits = requirements.memoryTypeBits
+        };
+        VmaAllocationCreateInfo allocInfo{
+            .preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
+        };
+        VmaAllocationInfo info;
+        vulkan::checkResult(vmaAllocateMemory(con.allocator,
+            &tailRequirements, &allocInfo, &_pImp->tail, &info));
+        VkSparseMemoryBind bind{
+            .resourceOffset = sparse.imageMipTailOffset,
+            .size = sparse.imageMipTailSize,
+            .memory = info.deviceMemory,
+            .memoryOffset = info.offset
+        };
+        bindSparse(con, image, {}, { &bind, 1 });
+    }
+}
+SparseTexture::~SparseTexture() = default;
+
+std::string_view getSparseFeedbackSource() noexcept {
+    return SparseFeedbackSource;
+}
+
+/******************************** TEXEL BUFFER ********************************/
+
+bool isTexelBufferFormatSupported(
+    const DeviceHandle& device, ImageFormat format, bool storage)
+{
+    if (format == ImageFormat::UNKNOWN || isCompressed(format))
+        return false;
+
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(device->device,
+        static_cast<VkFormat>(format), &props);
+    auto flag = storage ?
+        VK_FORMAT_FEATURE_STORAGE_TEXEL_BUFFER_BIT :
+        VK_FORMAT_FEATURE_UNIFORM_TEXEL_BUFFER_BIT;
+    return (props.bufferFeatures & flag) != 0;
+}
+bool isTexelBufferFormatSupported(
+    const ContextHandle& context, ImageFormat format, bool storage)
+{
+    return isTexelBufferFormatSupported(getDevice(context), format, storage);
+}
+
+struct TexelBuffer::Parameter {
+    VkBufferView view;
+    //range of the tensor's buffer the view covers; programs ignore it for
+    //texel buffers, but use it for tracking hazards
+    VkDescriptorBufferInfo buffer;
+};
+
+ImageFormat TexelBuffer::getFormat() const noexcept {
+    return format;
+}
+uint64_t TexelBuffer::offset() const noexcept {
+    return _offset;
+}
+uint64_t TexelBuffer::size() const noexcept {
+    return parameter->buffer.range / getElementSize(format);
+}
+uint64_t TexelBuffer::size_bytes() const noexcept {
+    return parameter->buffer.range;
+}
+const Tensor<std::byte>& TexelBuffer::getTensor() const noexcept {
+    return tensor.get();
+}
+
+void TexelBuffer::bindParameter(VkWriteDescriptorSet& binding) const {
+    binding.pNext            = nullptr;
+    binding.pImageInfo       = nullptr;
+    binding.pBufferInfo      = &parameter->buffer;
+    binding.pTexelBufferView = &parameter->view;
+}
+
+TexelBuffer::TexelBuffer(TexelBuffer&& other) noexcept = default;
+TexelBuffer& TexelBuffer::operator=(TexelBuffer&& other) noexcept {
+    if (parameter) {
+        auto& con = *getContext();
+        con.fnTable.vkDestroyBufferView(con.device, parameter->view, nullptr);
+    }
+    Resource::operator=(std::move(other));
+    tensor = other.tensor;
+    format = other.format;
+    _offset = other._offset;
+    parameter = std::move(other.parameter);
+    return *this;
+}
+
+TexelBuffer::TexelBuffer(
+    const Tensor<std::byte>& tensor, ImageFormat format, uint64_t offset, uint64_t size
+)
+    : Resource(tensor.getContext())
+    , tensor(std::cref(tensor))
+    , format(format)
+    , _offset(offset)
+    , parameter(std::make_unique<Parameter>())
+{
+    if (format == ImageFormat::UNKNOWN || isCompressed(format))
+        throw std::logic_error("Texel buffers do not support block compressed formats!");
+    if (offset > tensor.size_bytes())
+        throw std::logic_error("Texel buffer is not contained within the tensor!");
+    if (size == whole_size)
+        size = tensor.size_bytes() - offset;
+    if (size == 0)
+        throw std::logic_error("Texel buffers must not be empty!");
+    if (offset + size > tensor.size_bytes())
+        throw std::logic_error("Texel buffer is not contained within the tensor!");
+    auto texelSize = getElementSize(format);
+    if (size % texelSize != 0)
+        throw std::logic_error("Size of texel buffers must be a multiple of the texel size!");
+
+    auto& context = *getContext();
+    auto& buffer = tensor.getBuffer();
+    if (!(buffer.usage & VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT))
+        throw std::logic_error("Tensor does not support being used as texel buffer!");
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(context.physicalDevice, &props);
+    //unlike views, the tensor's offset matters as well
+    if ((buffer.offset + offset) % props.limits.minTexelBufferOffsetAlignment != 0)
+        throw std::logic_error(
+            "Offset of texel buffers must be a multiple of minTexelBufferOffsetAlignment!");
+    if (size / texelSize > props.limits.maxTexelBufferElements)
+        throw std::logic_error("Texel buffer exceeds maxTexelBufferElements!");
+    if (!isTexelBufferFormatSupported(getContext(), format, false) &&
+        !isTexelBufferFormatSupported(getContext(), format, true))
+    {
+        throw std::runtime_error("Format is not supported for texel buffers!");
+    }
+
+    VkBufferViewCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO,
+        .buffer = buffer.buffer,
+        .format = static_cast<VkFormat>(format),
+        .offset = buffer.offset + offset,
+        .range = size
+    };
+    vulkan::checkResult(context.fnTable.vkCreateBufferView(
+        context.device, &info, nullptr, &parameter->view));
+    parameter->buffer = VkDescriptorBufferInfo{
+        .buffer = buffer.buffer,
+        .offset = buffer.offset + offset,
+        .range = size
+    };
+}
+TexelBuffer::~TexelBuffer() {
+    //moved from texel buffers have no view
+    if (parameter) {
+        auto& con = *getContext();
+        con.fnTable.vkDestroyBufferView(con.device, parameter->view, nullptr);
+    }
+}
+
+/******************************** IMAGE BUFFER ********************************/
+
+bool ImageBuffer::isFormatSupported(ImageFormat format) noexcept {
+    switch (format) {
+    case ImageFormat::R8G8B8A8_UNORM:
+    case ImageFormat::R16G16B16A16_UNORM:
+    case ImageFormat::R32G32B32A32_SFLOAT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+uint32_t ImageBuffer::getWidth() const { return width; }
+uint32_t ImageBuffer::getHeight() const { return height; }
+ImageFormat ImageBuffer::getFormat() const { return format; }
+
+Image ImageBuffer::createImage(bool copy) const {
+    Image result(getContext(), format, width, height, 1);
+
+    //copy image via one time submit -> thus synchronous
+    if (copy) {
+        UpdateImageCommand copyCommand(*this, result);
+        vulkan::oneTimeSubmit(*getContext(), [&copyCommand](VkCommandBuffer cmd) {
+            //package into vulkan::command
+            vulkan::Command command{ cmd, 0 };
+            copyCommand.record(command);
+        });
+    }
+
+    return result;
+}
+
+Texture ImageBuffer::createTexture(const Sampler& sampler, bool copy) const {
+    Texture result(getContext(), format, width, height, sampler);
+
+    //copy image via one time submit -> synchronous
+    if (copy) {
+        UpdateTextureCommand copyCommand(*this, result);
+        vulkan::oneTimeSubmit(*getContext(), [&copyCommand](VkCommandBuffer cmd) {
+            //package into vulkan::command
+            vulkan::Command command{ cmd, 0 };
+            copyCommand.record(command);
+        });
+    }
+
+    return result;
+}
+
+namespace {
+
+constexpr auto LOAD_ERROR_STR = "Failed to load image: ";
+
+//decodes an image of the given size directly into a new ImageBuffer
+template<class Decoder>
+ImageBuffer decodeImage(ContextHandle context,
+    int width, int height, ImageFormat format, Decoder&& decode)
+{
+    ImageBuffer result(std::move(context), width, height, format);
+    auto mem = result.getMemory();
+
+    decodeTarget = { mem.data(), mem.size_bytes(), false };
+    int x, y, n;
+    void* data = decode(&x, &y, &n);
+    decodeTarget = {};
+    if (!data)
+        throw std::runtime_error(std::string(LOAD_ERROR_STR) + stbi_failure_reason());
+
+    //copy if the result did not end up in the buffer
+    if (data != mem.data()) {
+        std::memcpy(mem.data(), data, mem.size_bytes());
+        stbi_image_free(data);
+    }
+
+    return result;
+}
+
+using Bytes = std::vector<unsigned char>;
+
+void put16BE(Bytes& out, uint32_t value) {
+    out.push_back(static_cast<unsigned char>(value >> 8));
+    out.push_back(static_cast<unsigned char>(value));
+}
+void put32BE(Bytes& out, uint32_t value) {
+    put16BE(out, value >> 16);
+    put16BE(out, value);
+}
+void put16LE(Bytes& out, uint32_t value) {
+    out.push_back(static_cast<unsigned char>(value));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+}
+void put32LE(Bytes& out, uint32_t value) {
+    put16LE(out, value);
+    put16LE(out, value >> 16);
+}
+
+unsigned char paeth(int a, int b, int c) {
+    auto p = a + b - c;
+    auto pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc)
+        return static_cast<unsigned char>(a);
+    return static_cast<unsigned char>(pb <= pc ? b : c);
+}
+
+//zlib stream of stored blocks, i.e. without compression
+Bytes storeZlib(const Bytes& data) {
+    Bytes out = { 0x78, 0x01 };
+    constexpr size_t MaxBlock = 65535;
+    size_t offset = 0;
+    do {
+        auto size = std::min(MaxBlock, data.size() - offset);
+        out.push_back(offset + size == data.size() ? 1 : 0);
+        put16LE(out, static_cast<uint32_t>(size));
+        put16LE(out, static_cast<uint32_t>(~size & 0xFFFF));
+        out.insert(out.end(), data.begin() + offset, data.begin() + offset + size);
+        offset += size;
+    } while (offset < data.size());
+    //adler32; sums do not overflow within 5552 bytes, so reduce per chunk
+    uint32_t a = 1, b = 0;
+    for (size_t i = 0; i < data.size(); i += 5552) {
+        auto end = std::min(data.size(), i + 5552);
+        for (auto j = i; j < end; ++j) {
+            a += data[j];
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    put32BE(out, (b << 16) | a);
+    return out;
+}
+
+//stb's PNG writer only supports 8 bit and reads its compression level from a
+//global, thus assemble PNGs using its compressor
+Bytes encodePng(const unsigned char* data, uint32_t width, uint32_t height,
+    uint32_t depth, int32_t level)
+{
+    //scanlines start with their filter type followed by big endian samples
+    auto pixelSize = depth / 2;
+    auto rowSize = static_cast<size_t>(width) * pixelSize;
+    Bytes rows(rowSize * height);
+    if (depth == 16) {
+        auto samples = reinterpret_cast<const uint16_t*>(data);
+        for (size_t i = 0; i < rows.size() / 2; ++i) {
+            rows[2 * i] = static_cast<unsigned char>(samples[i] >> 8);
+            rows[2 * i + 1] = static_cast<unsigned char>(samples[i] & 0xFF);
+        }
+    }
+    else {
+        std::memcpy(rows.data(), data, rows.size());
+    }
+
+    //pick the filter minimizing the sum of absolute differences per line
+    //like stb does; skipped without compression
+    auto stride = rowSize + 1;
+    Bytes raw(stride * height);
+    Bytes candidate(rowSize);
+    for (size_t y = 0; y < height; ++y) {
+        auto row = rows.data() + y * rowSize;
+        auto prev = y > 0 ? row - rowSize : nullptr;
+        auto line = raw.data() + y * stride;
+        line[0] = 0;
+        std::memcpy(line + 1, row, rowSize);
+        if (level == 0)
+            continue;
+
+        auto best = std::numeric_limits<uint64_t>::max();
+        for (unsigned char type = 0; type < 5; ++type) {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < rowSize; ++i) {
+                int a = i >= pixelSize ? row[i - pixelSize] : 0;
+                int b = prev ? prev[i] : 0;
+                int c = prev && i >= pixelSize ? prev[i - pixelSize] : 0;
+                int predicted = 0;
+                switch (type) {
+                case 1: predicted = a; break;
+                case 2: predicted = b; break;
+                case 3: predicted = (a + b) / 2; break;
+                case 4: predicted = paeth(a, b, c); break;
+                }
+                candidate[i] = static_cast<unsigned char>(row[i] - predicted);
+                sum += std::abs(static_cast<signed char>(candidate[i]));
+            }
+            if (sum < best) {
+                best = sum;
+                line[0] = type;
+                std::memcpy(line + 1, candidate.data(), rowSize);
+            }
+        }
+    }
+
+    Bytes zdata;
+    if (level == 0) {
+        zdata = storeZlib(raw);
+    }
+    else {
+        int zlen;
+        auto compressed = stbi_zlib_compress(raw.data(), static_cast<int>(raw.size()),
+            &zlen, level < 0 ? 8 : level);
+        if (!compressed)
+            throw std::runtime_error("Failed to save image!");
+        zdata.assign(compressed, compressed + zlen);
+        STBIW_FREE(compressed);
+    }
+
+    Bytes png = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    auto chunk = [&png](const char* type, const unsigned char* data, uint32_t size) {
+        put32BE(png, size);
+        auto start = png.size();
+        png.insert(png.end(), type, type + 4);
+        png.insert(png.end(), data, data + size);
+        put32BE(png, stbiw__crc32(png.data() + start, static_cast<int>(size + 4)));
+    };
+    Bytes header;
+    put32BE(header, width);
+    put32BE(header, height);
+    header.push_back(static_cast<unsigned char>(depth));
+    header.push_back(6); //RGBA
+    header.insert(header.end(), { 0, 0, 0 }); //compression, filter, interlace
+    chunk("IHDR", header.data(), static_cast<uint32_t>(header.size()));
+    chunk("IDAT", zdata.data(), static_cast<uint32_t>(zdata.size()));
+    chunk("IEND", nullptr, 0);
+    return png;
+}
+
+Bytes encodeHdr(const float* data, uint32_t width, uint32_t height) {
+    Bytes out;
+    auto success = stbi_write_hdr_to_func([](void* context, void* data, int size) {
+            auto bytes = static_cast<unsigned char*>(data);
+            static_cast<Bytes*>(context)->insert(
+                static_cast<Bytes*>(context)->end(), bytes, bytes + size);
+        }, &out, width, height, STBI_rgb_alpha, data);
+    if (!success)
+        throw std::runtime_error("Failed to save image!");
+    return out;
+}
+
+Bytes encodePpm(const unsigned char* data, uint32_t width, uint32_t height, uint32_t depth) {
+    auto header = "P6\n" + std::to_string(width) + ' ' + std::to_string(height) +
+        (depth == 16 ? "\n65535\n" : "\n255\n");
+    Bytes out(header.begin(), header.end());
+    auto pixels = static_cast<size_t>(width) * height;
+    out.reserve(out.size() + pixels * 3 * depth / 8);
+    for (size_t i = 0; i < pixels; ++i) {
+        for (size_t c = 0; c < 3; ++c) {
+            //samples are big endian
+            if (depth == 16)
+                put16BE(out, reinterpret_cast<const uint16_t*>(data)[i * 4 + c]);
+            else
+                out.push_back(data[i * 4 + c]);
+        }
+    }
+    return out;
+}
+
+//see https://qoiformat.org/qoi-specification.pdf
+Bytes encodeQoi(const unsigned char* data, uint32_t width, uint32_t height) {
+    Bytes out = { 'q', 'o', 'i', 'f' };
+    put32BE(out, width);
+    put32BE(out, height);
+    out.push_back(4); //RGBA
+    out.push_back(0); //sRGB with linear alpha
+
+    std::array<std::array<unsigned char, 4>, 64> seen{};
+    std::array<unsigned char, 4> prev = { 0, 0, 0, 255 };
+    uint32_t run = 0;
+    auto pixels = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < pixels; ++i) {
+        std::array<unsigned char, 4> px;
+        std::memcpy(px.data(), data + i * 4, 4);
+        if (px == prev) {
+            if (++run == 62 || i + 1 == pixels) {
+                out.push_back(static_cast<unsigned char>(0xC0 | (run - 1)));
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0) {
+            out.push_back(static_cast<unsigned char>(0xC0 | (run - 1)));
+            run = 0;
+        }
+
+        auto index = (px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64;
+        if (seen[index] == px) {
+            out.push_back(static_cast<unsigned char>(index));
+        }
+        else if (px[3] == prev[3]) {
+            seen[index] = px;
+            auto dr = static_cast<signed char>(px[0] - prev[0]);
+            auto dg = static_cast<signed char>(px[1] - prev[1]);
+            auto db = static_cast<signed char>(px[2] - prev[2]);
+            auto drg = static_cast<signed char>(dr - dg);
+            auto dbg = static_cast<signed char>(db - dg);
+            if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                out.push_back(static_cast<unsigned char>(
+                    0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+            }
+            else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+                out.push_back(static_cast<unsigned char>(0x80 | (dg + 32)));
+                out.push_back(static_cast<unsigned char>((drg + 8) << 4 | (dbg + 8)));
+            }
+            else {
+                out.insert(out.end(), { 0xFE, px[0], px[1], px[2] });
+            }
+        }
+        else {
+            seen[index] = px;
+            out.insert(out.end(), { 0xFF, px[0], px[1], px[2], px[3] });
+        }
+        prev = px;
+    }
+    out.insert(out.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+    return out;
+}
+
+//little endian baseline TIFF with a single uncompressed strip
+Bytes encodeTiff(const unsigned char* data, uint32_t width, uint32_t height,
+    uint32_t depth, bool floating)
+{
+    auto imageSize = static_cast<uint32_t>(static_cast<uint64_t>(width) * height * depth / 2);
+    //header, bits per sample and sample format per channel, then the image
+    constexpr uint32_t BitsOffset = 8;
+    constexpr uint32_t SampleFormatOffset = BitsOffset + 8;
+    constexpr uint32_t DataOffset = SampleFormatOffset + 8;
+    auto ifdOffset = DataOffset + imageSize;
+    Bytes out = { 'I', 'I', 42, 0 };
+    put32LE(out, ifdOffset);
+    for (auto i = 0; i < 4; ++i)
+        put16LE(out, depth);
+    for (auto i = 0; i < 4; ++i)
+        put16LE(out, floating ? 3 : 1); //float or uint
+    out.insert(out.end(), data, data + imageSize);
+
+    //entries must be sorted by tag
+    struct Entry { uint16_t tag; uint16_t type; uint32_t value; };
+    constexpr uint16_t Short = 3, Long = 4;
+    auto entries = std::to_array<Entry>({
+        { 256, Long, width },           //ImageWidth
+        { 257, Long, height },          //ImageLength
+        { 258, Short, BitsOffset },     //BitsPerSample, 4 values
+        { 259, Short, 1 },              //Compression: none
+        { 262, Short, 2 },              //PhotometricInterpretation: RGB
+        { 273, Long, DataOffset },      //StripOffsets
+        { 277, Short, 4 },              //SamplesPerPixel
+        { 278, Long, height },          //RowsPerStrip
+        { 279, Long, imageSize },       //StripByteCounts
+        { 284, Short, 1 },              //PlanarConfiguration: chunky
+        { 338, Short, 2 },              //ExtraSamples: unassociated alpha
+        { 339, Short, SampleFormatOffset } //SampleFormat, 4 values
+    });
+    put16LE(out, static_cast<uint32_t>(entries.size()));
+    for (auto& entry : entries) {
+        //per channel values do not fit into the entry -> stored at offset
+        auto perChannel = entry.tag == 258 || entry.tag == 339;
+        put16LE(out, entry.tag);
+        put16LE(out, entry.type);
+        put32LE(out, perChannel ? 4 : 1);
+        if (entry.type == Short && !perChannel) {
+            put16LE(out, entry.value);
+            put16LE(out, 0);
+        }
+        else {
+            put32LE(out, entry.value);
+        }
+    }
+    put32LE(out, 0); //no further IFD
+    return out;
+}
+
+[[noreturn]] void throwUnsupportedFileFormat() {
+    throw std::runtime_error("The file format does not support the image's format!");
+}
+
+}
+
+std::vector<std::byte> encodeImage(
+    std::span<const std::byte> data, uint32_t width, uint32_t height,
+    ImageFormat format, const ImageSaveOptions& options)
+{
+    if (!ImageBuffer::isFormatSupported(format))
+        throw std::runtime_error("Unsupported image buffer format!");
+    if (width == 0 || height == 0)
+        throw std::runtime_error("Images must not be empty!");
+    if (data.size_bytes() < uint64_t(getElementSize(format)) * width * height)
+        throw std::runtime_error("Image data is smaller than the image!");
+
+    auto pixels = reinterpret_cast<const unsigned char*>(data.data());
+    auto depth = getElementSize(format) * 2;
+    auto fileFormat = options.fileFormat;
+    if (fileFormat == ImageFileFormat::AUTO) {
+        fileFormat = format == ImageFormat::R32G32B32A32_SFLOAT
+            ? ImageFileFormat::HDR : ImageFileFormat::PNG;
+    }
+    Bytes result;
+    switch (fileFormat) {
+    case ImageFileFormat::PNG:
+        if (depth > 16)
+            throwUnsupportedFileFormat();
+        result = encodePng(pixels, width, height, depth, std::min(options.compressionLevel, 9));
+        break;
+    case ImageFileFormat::HDR:
+        if (depth != 32)
+            throwUnsupportedFileFormat();
+        result = encodeHdr(reinterpret_cast<const float*>(pixels), width, height);
+        break;
+    case ImageFileFormat::PPM:
+        if (depth > 16)
+            throwUnsupportedFileFormat();
+        result = encodePpm(pixels, width, height, depth);
+        break;
+    case ImageFileFormat::QOI:
+        if (depth != 8)
+            throwUnsupportedFileFormat();
+        result = encodeQoi(pixels, width, height);
+        break;
+    case ImageFileFormat::TIFF:
+        result = encodeTiff(pixels, width, height, depth, depth == 32);
+        break;
+    default:
+        throw std::runtime_error("Unknown image file format!");
+    }
+
+    std::vector<std::byte> bytes(result.size());
+    std::memcpy(bytes.data(), result.data(), result.size());
+    return bytes;
+}
+
+void saveImage(const std::filesystem::path& filename,
+    std::span<const std::byte> data, uint32_t width, uint32_t height,
+    ImageFormat format, const ImageSaveOptions& options)
+{
+    auto encoded = encodeImage(data, width, height, format, options);
+    std::ofstream file(filename, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+    if (!file)
+        throw std::runtime_error("Failed to save image!");
+}
+
+std::future<void> saveImageAsync(std::filesystem::path filename,
+    std::span<const std::byte> data, uint32_t width, uint32_t height,
+    ImageFormat format, const ImageSaveOptions& options)
+{
+    //fail early instead of in the future
+    if (!ImageBuffer::isFormatSupported(format))
+        throw std::runtime_error("Unsupported image buffer format!");
+
+    return vulkan::WorkerPool::get().submit(
+        [filename = std::move(filename), data, width, height, format, options]() {
+            saveImage(filename, data, width, height, format, options);
+        });
+}
+
+ImageBuffer ImageBuffer::load(ContextHandle context, const char* filename, ImageFormat format) {
+    //query size first to allocate the buffer the image gets decoded into
+    int x, y, n;
+    if (!stbi_info(filename, &x, &y, &n))
+        throw std::runtime_error(std::string(LOAD_ERROR_STR) + stbi_failure_reason());
+
+    return decodeImage(std::move(context), x, y, format,
+        [filename, format](int* x, int* y, int* n) -> void* {
+            switch (format) {
+            case ImageFormat::R16G16B16A16_UNORM:
+                return stbi_load_16(filename, x, y, n, STBI_rgb_alpha);
+            case ImageFormat::R32G32B32A32_SFLOAT:
+                return stbi_loadf(filename, x, y, n, STBI_rgb_alpha);
+            default:
+                return stbi_load(filename, x, y, n, STBI_rgb_alpha);
+            }
+        });
+}
+ImageBuffer ImageBuffer::load(ContextHandle context,
+    std::span<const std::byte> memory, ImageFormat format)
+{
+    auto buffer = reinterpret_cast<const unsigned char*>(memory.data());
+    auto size = static_cast<int>(memory.size_bytes());
+    int x, y, n;
+    if (!stbi_info_from_memory(buffer, size, &x, &y, &n))
+        throw std::runtime_error(std::string(LOAD_ERROR_STR) + stbi_failure_reason());
+
+    return decodeImage(std::move(context), x, y, format,
+        [buffer, size, format](int* x, int* y, int* n) -> void* {
+            switch (format) {
+            case ImageFormat::R16G16B16A16_UNORM:
+                return stbi_load_16_from_memory(buffer, size, x, y, n, STBI_rgb_alpha);
+            case ImageFormat::R32G32B32A32_SFLOAT:
+                return stbi_loadf_from_memory(buffer, size, x, y, n, STBI_rgb_alpha);
+            default:
+                return stbi_load_from_memory(buffer, size, x, y, n, STBI_rgb_alpha);
+            }
+        });
+}
+std::vector<std::future<ImageBuffer>> ImageBuffer::loadAsync(
+    ContextHandle context,
+    std::span<const std::filesystem::path> filenames,
+    ImageFormat format)
+{
+    //fail early instead of in every future
+    if (!isFormatSupported(format))
+        throw std::runtime_error("Unsupported image buffer format!");
+
+    std::vector<std::future<ImageBuffer>> result;
+    result.reserve(filenames.size());
+    for (auto& filename : filenames) {
+        result.push_back(vulkan::WorkerPool::get().submit(
+            [context, filename = filename.string(), format]() {
+                return ImageBuffer::load(context, filename.c_str(), format);
+            }));
+    }
+    return result;
+}
+
+void ImageBuffer::save(const char* filename) const {
+    saveImage(filename, getMemory(), width, height, format);
+}
+void ImageBuffer::save(const std::filesystem::path& filename, const ImageSaveOptions& options) const {
+    saveImage(filename, getMemory(), width, height, format, options);
+}
+std::future<void> ImageBuffer::saveAsync(
+    std::filesystem::path filename, const ImageSaveOptions& options) const
+{
+    return saveImageAsync(std::move(filename), getMemory(), width, height, format, options);
+}
+
+ImageBuffer::ImageBuffer(ImageBuffer&& other) noexcept
+    : Buffer<std::byte>(std::move(other))
+    , width(other.width)
+    , height(other.height)
+    , format(other.format)
+{}
+ImageBuffer& ImageBuffer::operator=(ImageBuffer&& other) noexcept {
+    Buffer<std::byte>::operator=(std::move(other));
+    width = other.width;
+    height = other.height;
+    format = other.format;
+    return *this;
+}
+
+ImageBuffer::ImageBuffer(ContextHandle context,
+    uint32_t width, uint32_t height, ImageFormat format
+)
+    : Buffer<std::byte>(std::move(context),
+        isFormatSupported(format) ? getElementSize(format) * width * height :
+        throw std::runtime_error("Unsupported image buffer format!"))
+    , width(width)
+    , height(height)
+    , format(format)
+{}
+ImageBuffer::~ImageBuffer() = default;
+
+/****************************** TEXTURE FILES *********************************/
+
+namespace {
+
+//location of a single mip level inside the file
+struct LevelData {
+    uint64_t offset;
+    uint64_t size;
+};
+//parsed header of a texture file
+struct TextureData {
+    ImageFormat format;
+    uint32_t width, height, depth;
+    std::vector<LevelData> levels;
+};
+
+[[noreturn]] void throwLoadError(const char* reason) {
+    throw std::runtime_error(std::string(LOAD_ERROR_STR) + reason);
+}
+
+template<class T>
+T readValue(std::span<const std::byte> memory, uint64_t offset) {
+    if (offset + sizeof(T) > memory.size_bytes())
+        throwLoadError("Unexpected end of file");
+    T value;
+    std::memcpy(&value, memory.data() + offset, sizeof(T));
+    return value;
+}
+
+//throws for formats without ImageFormat counterpart
+ImageFormat checkFormat(uint32_t vkFormat) {
+    auto format = static_cast<ImageFormat>(vkFormat);
+    try {
+        static_cast<void>(getElementSize(format));
+    }
+    catch (const std::runtime_error&) {
+        throwLoadError("Unsupported texture format");
+    }
+    return format;
+}
+
+constexpr std::array<uint8_t, 12> KTX2_IDENTIFIER = {
+    0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+};
+constexpr uint32_t DDS_MAGIC = 0x20534444; // "DDS "
+
+constexpr uint32_t makeFourCC(const char (&code)[5]) {
+    return static_cast<uint32_t>(code[0]) |
+        static_cast<uint32_t>(code[1]) << 8 |
+        static_cast<uint32_t>(code[2]) << 16 |
+        static_cast<uint32_t>(code[3]) << 24;
+}
+
+bool isKTX2(std::span<const std::byte> memory) {
+    return memory.size_bytes() >= KTX2_IDENTIFIER.size() &&
+        std::memcmp(memory.data(), KTX2_IDENTIFIER.data(), KTX2_IDENTIFIER.size()) == 0;
+}
+
+TextureData parseKTX2(std::span<const std::byte> memory) {
+    //header following the identifier
+    auto vkFormat = readValue<uint32_t>(memory, 12);
+    auto width = readValue<uint32_t>(memory, 20);
+    auto height = readValue<uint32_t>(memory, 24);
+    auto depth = readValue<uint32_t>(memory, 28);
+    auto layerCount = readValue<uint32_t>(memory, 32);
+    auto faceCount = readValue<uint32_t>(memory, 36);
+    auto levelCount = readValue<uint32_t>(memory, 40);
+    auto supercompression = readValue<uint32_t>(memory, 44);
+
+    if (vkFormat == 0)
+        throwLoadError("Basis universal textures are not supported");
+    if (supercompression != 0)
+        throwLoadError("Supercompressed textures are not supported");
+    if (layerCount > 1 || faceCount != 1)
+        throwLoadError("Texture arrays and cube maps are not supported");
+    if (width == 0)
+        throwLoadError("Invalid texture size");
+
+    TextureData data{
+        checkFormat(vkFormat),
+        width, std::max(height, 1u), std::max(depth, 1u)
+    };
+    //level index starts after the data format, key/value and supercompression
+    //global data offsets; zero levels request generating them at runtime
+    levelCount = std::max(levelCount, 1u);
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        uint64_t entry = 80 + 24ull * level;
+        data.levels.push_back({
+            readValue<uint64_t>(memory, entry),
+            readValue<uint64_t>(memory, entry + 8)
+        });
+    }
+    return data;
+}
+
+ImageFormat fromDXGI(uint32_t dxgiFormat) {
+    switch (dxgiFormat) {
+    case 2: return ImageFormat::R32G32B32A32_SFLOAT;
+    case 3: return ImageFormat::R32G32B32A32_UINT;
+    case 4: return ImageFormat::R32G32B32A32_SINT;
+    case 11: return ImageFormat::R16G16B16A16_UNORM;
+    case 12: return ImageFormat::R16G16B16A16_UINT;
+    case 14: return ImageFormat::R16G16B16A16_SINT;
+    case 16: return ImageFormat::R32G32_SFLOAT;
+    case 17: return ImageFormat::R32G32_UINT;
+    case 18: return ImageFormat::R32G32_SINT;
+    case 28: return ImageFormat::R8G8B8A8_UNORM;
+    case 30: return ImageFormat::R8G8B8A8_UINT;
+    case 31: return ImageFormat::R8G8B8A8_SNORM;
+    case 32: return ImageFormat::R8G8B8A8_SINT;
+    case 41: return ImageFormat::R32_SFLOAT;
+    case 42: return ImageFormat::R32_UINT;
+    case 43: return ImageFormat::R32_SINT;
+    case 71: return ImageFormat::BC1_RGBA_UNORM;
+    case 77: return ImageFormat::BC3_UNORM;
+    case 80: return ImageFormat::BC4_UNORM;
+    case 81: return ImageFormat::BC4_SNORM;
+    case 83: return ImageFormat::BC5_UNORM;
+    case 84: return ImageFormat::BC5_SNORM;
+    case 95: return ImageFormat::BC6H_UFLOAT;
+    case 96: return ImageFormat::BC6H_SFLOAT;
+    case 98: return ImageFormat::BC7_UNORM;
+    default:
+        throwLoadError("Unsupported texture format");
+    }
+}
+
+ImageFormat fromFourCC(uint32_t fourCC) {
+    switch (fourCC) {
+    case makeFourCC("DXT1"): return ImageFormat::BC1_RGBA_UNORM;
+    case makeFourCC("DXT5"): return ImageFormat::BC3_UNORM;
+    case makeFourCC("ATI1"):
+    case makeFourCC("BC4U"): return ImageFormat::BC4_UNORM;
+    case makeFourCC("BC4S"): return ImageFormat::BC4_SNORM;
+    case makeFourCC("ATI2"):
+    case makeFourCC("BC5U"): return ImageFormat::BC5_UNORM;
+    case makeFourCC("BC5S"): return ImageFormat::BC5_SNORM;
+    default:
+        throwLoadError("Unsupported texture format");
+    }
+}
+
+TextureData parseDDS(std::span<const std::byte> memory) {
+    constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+    constexpr uint32_t DDSD_DEPTH = 0x800000;
+    constexpr uint32_t DDPF_FOURCC = 0x4;
+    constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+
+    auto flags = readValue<uint32_t>(memory, 8);
+    auto height = readValue<uint32_t>(memory, 12);
+    auto width = readValue<uint32_t>(memory, 16);
+    auto depth = readValue<uint32_t>(memory, 24);
+    auto mipCount = readValue<uint32_t>(memory, 28);
+    auto formatFlags = readValue<uint32_t>(memory, 80);
+    auto fourCC = readValue<uint32_t>(memory, 84);
+    auto caps2 = readValue<uint32_t>(memory, 112);
+
+    if (caps2 & DDSCAPS2_CUBEMAP)
+        throwLoadError("Texture arrays and cube maps are not supported");
+    if (!(formatFlags & DDPF_FOURCC))
+        throwLoadError("Unsupported texture format");
+    if (width == 0)
+        throwLoadError("Invalid texture size");
+
+    //the extended header stores the format as DXGI_FORMAT
+    uint64_t offset = 128;
+    ImageFormat format;
+    if (fourCC == makeFourCC("DX10")) {
+        if (readValue<uint32_t>(memory, 140) > 1)
+            throwLoadError("Texture arrays and cube maps are not supported");
+        format = fromDXGI(readValue<uint32_t>(memory, 128));
+        offset += 20;
+    }
+    else {
+        format = fromFourCC(fourCC);
+    }
+
+    TextureData data{
+        format,
+        width, std::max(height, 1u),
+        (flags & DDSD_DEPTH) ? std::max(depth, 1u) : 1u
+    };
+    //levels are tightly packed one after another
+    auto levelCount = (flags & DDSD_MIPMAPCOUNT) ? std::max(mipCount, 1u) : 1u;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        auto size = getImageSize(format,
+            std::max(data.width >> level, 1u),
+            std::max(data.height >> level, 1u),
+            std::max(data.depth >> level, 1u));
+        data.levels.push_back({ offset, size });
+        offset += size;
+    }
+    return data;
+}
+
+}
+
+Texture Texture::load(ContextHandle context,
+    const char* filename, const Sampler& sampler)
+{
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file)
+        throwLoadError("Could not open file");
+    std::vector<std::byte> memory(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(memory.data()), memory.size());
+    if (!file)
+        throwLoadError("Could not read file");
+
+    return load(std::move(context), memory, sampler);
+}
+Texture Texture::load(ContextHandle context,
+    std::span<const std::byte> memory, const Sampler& sampler)
+{
+    TextureData data;
+    if (isKTX2(memory))
+        data = parseKTX2(memory);
+    else if (readValue<uint32_t>(memory, 0) == DDS_MAGIC)
+        data = parseDDS(memory);
+    else
+        throwLoadError("Unknown texture file type");
+
+    //validate levels before allocating anything
+    auto levelCount = static_cast<uint32_t>(data.levels.size());
+    if (levelCount > getMaxMipLevels(data.width, data.height, data.depth))
+        throwLoadError("Too many mip levels");
+    uint64_t total = 0;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        auto& entry = data.levels[level];
+        auto expected = getImageSize(data.format,
+            std::max(data.width >> level, 1u),
+            std::max(data.height >> level, 1u),
+            std::max(data.depth >> level, 1u));
+        if (entry.size != expected)
+            throwLoadError("Mip level size does not match its extent");
+        if (entry.offset > memory.size_bytes() ||
+            entry.size > memory.size_bytes() - entry.offset)
+        {
+            throwLoadError("Unexpected end of file");
+        }
+        total += entry.size;
+    }
+
+    //stage the payload as is and upload all levels at once
+    Texture result(context, data.format,
+        data.width, data.height, data.depth, sampler, levelCount);
+    Buffer<std::byte> staging(context, total);
+    std::vector<UpdateTextureCommand> uploads;
+    uploads.reserve(levelCount);
+    uint64_t offset = 0;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        auto& entry = data.levels[level];
+        std::memcpy(staging.getMemory().data() + offset,
+            memory.data() + entry.offset, entry.size);
+        //explicit extent as the staging buffer is larger than a single level
+        uploads.emplace_back(staging, result, ImageRegion{
+            .width = std::max(data.width >> level, 1u),
+            .height = std::max(data.height >> level, 1u),
+            .depth = std::max(data.depth >> level, 1u),
+            .mipLevel = level,
+            .bufferOffset = offset
+        });
+        offset += entry.size;
+    }
+    vulkan::oneTimeSubmit(*context, [&uploads](VkCommandBuffer cmd) {
+        //package into vulkan::command
+        vulkan::Command command{ cmd, 0 };
+        for (auto& upload : uploads)
+            upload.record(command);
+    });
+
+    return result;
+}
+
+/************************************ COPY ************************************/
+
+namespace {
+
+constexpr auto DIFFERENT_CONTEXT_ERROR_STR =
+    "Source and destination of a copy command must originate from the same context!";
+constexpr auto SIZE_MISMATCH_ERROR_STR =
+    "Source and destination must have the same size!";
+constexpr auto REGION_ERROR_STR =
+    "Copy region exceeds the image or buffer!";
+
+//translates the region into a copy checking it stays inside image and buffer
+VkBufferImageCopy getImageCopy(
+    const ImageRegion& region,
+    uint32_t width, uint32_t height, uint32_t depth,
+    uint32_t mipLevels, uint32_t layers,
+    ImageFormat format, const vulkan::Buffer& buffer, uint64_t bufferSize,
+    uint64_t imageSize)
+{
+    //the whole image must match the buffer exactly as before
+    if (region == ImageRegion{} && imageSize != bufferSize)
+        throw std::logic_error(SIZE_MISMATCH_ERROR_STR);
+
+    //dimension of the selected mip level
+    if (region.mipLevel >= mipLevels)
+        throw std::logic_error(REGION_ERROR_STR);
+    width = std::max(width >> region.mipLevel, 1u);
+    height = std::max(height >> region.mipLevel, 1u);
+    depth = std::max(depth >> region.mipLevel, 1u);
+
+    //zero extents span to the edge
+    if (region.x >= width || region.y >= height || region.z >= depth)
+        throw std::logic_error(REGION_ERROR_STR);
+    VkExtent3D extent{
+        region.width ? region.width : width - region.x,
+        region.height ? region.height : height - region.y,
+        region.depth ? region.depth : depth - region.z
+    };
+    if (extent.width > width - region.x ||
+        extent.height > height - region.y ||
+        extent.depth > depth - region.z)
+    {
+        throw std::logic_error(REGION_ERROR_STR);
+    }
+
+    //layers are laid out in the buffer like depth slices
+    layers = std::max(layers, 1u);
+    if (region.layer >= layers)
+        throw std::logic_error(REGION_ERROR_STR);
+    auto layerCount = region.layerCount ? region.layerCount : layers - region.layer;
+    if (layerCount > layers - region.layer)
+        throw std::logic_error(REGION_ERROR_STR);
+    uint64_t slices = uint64_t(extent.depth) * layerCount;
+
+    //compressed formats are copied in whole blocks, except at the edges
+    uint32_t block = getBlockExtent(format);
+    if (region.x % block || region.y % block ||
+        (extent.width % block && region.x + extent.width != width) ||
+        (extent.height % block && region.y + extent.height != height))
+    {
+        throw std::logic_error(REGION_ERROR_STR);
+    }
+    auto blocks = [block](uint64_t pixels) { return (pixels + block - 1) / block; };
+
+    //check the buffer holds the region
+    auto elementSize = getElementSize(format);
+    uint64_t rowLength = region.bufferRowLength ? region.bufferRowLength : extent.width;
+    uint64_t imageHeight = region.bufferImageHeight ? region.bufferImageHeight : extent.height;
+    if (rowLength < extent.width || imageHeight < extent.height ||
+        region.bufferRowLength % block || region.bufferImageHeight % block ||
+        region.bufferOffset % elementSize != 0)
+    {
+        throw std::logic_error(REGION_ERROR_STR);
+    }
+    auto size = elementSize * (
+        blocks(rowLength) * blocks(imageHeight) * (slices - 1) +
+        blocks(rowLength) * (blocks(extent.height) - 1) +
+        blocks(extent.width));
+    if (region.bufferOffset + size > bufferSize)
+        throw std::logic_error(REGION_ERROR_STR);
+
+    return VkBufferImageCopy{
+        .bufferOffset      = buffer.offset + region.bufferOffset,
+        .bufferRowLength   = region.bufferRowLength,
+        .bufferImageHeight = region.bufferImageHeight,
+        .imageSubresource  = {
+            VK_IMAGE_ASPECT_COLOR_BIT, region.mipLevel, region.layer, layerCount
+        },
+        .imageOffset       = {
+            static_cast<int32_t>(region.x),
+            static_cast<int32_t>(region.y),
+            static_cast<int32_t>(region.z)
+        },
+        .imageExtent       = extent
+    };
+}
+
+//amount of bytes transferred by the given copy
+uint64_t getCopySize(const VkBufferImageCopy& copy, ImageFormat format) {
+    uint64_t block = getBlockExtent(format);
+    auto& extent = copy.imageExtent;
+    return getElementSize(format) *
+        ((extent.width + block - 1) / block) *
+        ((extent.height + block - 1) / block) *
+        extent.depth * copy.imageSubresource.layerCount;
+}
+
+//records copying the image in general layout into the buffer; the tensor
+//variant keeps the result on the device, otherwise it is made host visible
+void recordImageToBuffer(
+    vulkan::Command& cmd, const vulkan::Context& context,
+    const vulkan::Image& image, const vulkan::Buffer& buffer, uint64_t size,
+    const VkBufferImageCopy& copy, bool hostRead)
+{
+    //we're acting on the transfer stage
     cmd.stage |= VK_PIPELINE_STAGE_TRANSFER_BIT;
 
+    //images stay in the general layout, which copies support as well
+    if (cmd.tracker) {
+        //only sync against actual hazards
+        cmd.tracker->image(image.view,
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+        cmd.tracker->buffer(buffer.buffer, buffer.offset, size,
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+        cmd.tracker->barrier(context, cmd);
+    }
+    else {
+        //ensure writing to image finished
+        vulkan::GlobalBarrier barrier{
+            .srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+            .srcAccess = VK_ACCESS_2_SHADER_WRITE_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            .dstStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            .dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR
+        };
+        vulkan::pipelineBarrier(context, cmd, {}, { &barrier, 1 });
+    }
+
+    //issue copy
+    context.fnTable.vkCmdCopyImageToBuffer(cmd.buffer,
+        image.image,
+        VK_IMAGE_LAYOUT_GENERAL,
+        buffer.buffer,
+        1, &copy);
+
+    //make the result available to the host
+    //(otherwise the tracker issues it once the tensor gets used)
+    if (cmd.tracker) {
+        if (hostRead) {
+            cmd.tracker->hostRead(buffer.buffer, buffer.offset, size,
+                VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+        }
+        return;
+    }
+    //also ensure the transfer finished before the image gets written again
+    vulkan::GlobalBarrier barrier{
+        .srcStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+        .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+        .dstStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+        .dstAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR
+    };
+    if (hostRead) {
+        vulkan::BufferBarrier bufferBarrier{
+            .srcStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            .dstStage = VK_PIPELINE_STAGE_2_HOST_BIT_KHR,
+            .dstAccess = VK_ACCESS_2_HOST_READ_BIT_KHR,
+            .buffer = buffer.buffer
+        };
+        vulkan::pipelineBarrier(context, cmd, { &bufferBarrier, 1 }, { &barrier, 1 });
+    }
+    else {
+        vulkan::pipelineBarrier(context, cmd, {}, { &barrier, 1 });
+    }
+}
+
+//records copying the buffer into the image in general layout
+void recordBufferToImage(
+    vulkan::Command& cmd, const vulkan::Context& context,
+    const vulkan::Buffer& buffer, uint64_t size, const vulkan::Image& image,
+    const VkBufferImageCopy& copy)
+{
+    //we're acting on the transfer stage
+    cmd.stage |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+    //images stay in the general layout, which copies support as well
+    if (cmd.tracker) {
+        //only sync against actual hazards
+        cmd.tracker->buffer(buffer.buffer, buffer.offset, size,
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+        cmd.tracker->image(image.view,
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+        cmd.tracker->barrier(context, cmd);
+    }
+    else {
+        //make sure the image and the tensor are safe to use
+        vulkan::GlobalBarrier barrier{
+            .srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+            .srcAccess = VK_ACCESS_2_SHADER_WRITE_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            .dstStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            .dstAccess = VK_ACCESS_2_TRANSFER_READ_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR
+        };
+        vulkan::pipelineBarrier(context, cmd, {}, { &barrier, 1 });
+    }
+
+    //issue copy
+    context.fnTable.vkCmdCopyBufferToImage(cmd.buffer,
+        buffer.buffer,
+        image.image,
+        VK_IMAGE_LAYOUT_GENERAL,
+        1, &copy);
+
+    //make sure the image is ready for subsequent commands
+    //(the tracker issues it once the image gets used)
+    if (!cmd.tracker) {
+        vulkan::GlobalBarrier barrier{
+            .srcStage = VK_PIPELINE_STAGE_2_COPY_BIT_KHR,
+            .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            .dstStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+            .dstAccess = VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR
+        };
+        vulkan::pipelineBarrier(context, cmd, {}, { &barrier, 1 });
+    }
+}
+
+//records copying the buffer into a mip level of the texture
+void recordBufferToTexture(
+    vulkan::Command& cmd, const vulkan::Context& context,
+    const vulkan::Buffer& buffer, uint64_t size, const Texture& texture,
+    const VkBufferImageCopy& copy)
+{
+    auto level = copy.imageSubresource.mipLevel;
+    //previous content can be discarded if the whole level gets overwritten
+    auto whole =
+        copy.imageExtent.width == std::max(texture.getWidth() >> level, 1u) &&
+        copy.imageExtent.height == std::max(texture.getHeight() >> level, 1u) &&
+        copy.imageExtent.depth == std::max(texture.getDepth() >> level, 1u) &&
+        copy.imageSubresource.layerCount == std::max(texture.getLayers(), 1u);
+
+    //we're acting on the transfer stage
+    cmd.stage |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+    //the tracker keeps the level as transfer destination until it gets
+    //sampled, so consecutive uploads do not bounce between layouts
+    if (cmd.tracker) {
+        cmd.tracker->buffer(buffer.buffer, buffer.offset, size,
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+        cmd.tracker->texture(texture.getImage().image, texture.getImage().view, level, 1,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            VK_PIPELINE_STAGE_2_COPY_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            whole);
+        cmd.tracker->barrier(context, cmd);
+        context.fnTable.vkCmdCopyBufferToImage(cmd.buffer,
+            buffer.buffer,
+            texture.getImage().image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1, &copy);
+        return;
+    }
+
     //make ensure image is safe to write and prepare it for the transfer
     VkImageMemoryBarrier barrier{
-        .sType            = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-        .srcAccessMask    = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
-        .dstAccessMask    = VK_ACCESS_TRANSFER_WRITE_BIT,
-        .oldLayout        = VK_IMAGE_LAYOUT_GENERAL,
-        .newLayout        = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        .image            = dst.getImage().image,
-        .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_SHADER_READ_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout = whole ?
+            VK_IMAGE_LAYOUT_UNDEFINED : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .image = texture.getImage().image,
+        .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, VK_REMAINING_ARRAY_LAYERS }
     };
-    context->fnTable.vkCmdPipelineBarrier(cmd.buffer,
-        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+    vulkan::count(context.counters.barriers);
+    context.fnTable.vkCmdPipelineBarrier(cmd.buffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
         VK_PIPELINE_STAGE_TRANSFER_BIT,
         VK_DEPENDENCY_BY_REGION_BIT,
         0, nullptr,
         0, nullptr,
         1, &barrier);
 
-    //issue copy
-    VkBufferImageCopy copy{
-        .imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0 ,1 },
-        .imageExtent = { dst.getWidth(), dst.getHeight(), dst.getDepth() }
-    };
-    context->fnTable.vkCmdCopyBufferToImage(cmd.buffer,
-        src.getBuffer().buffer,
-        dst.getImage().image,
+    //issue copy. Other mip levels are left untouched, i.e. need to be
+    //generated via GenerateMipmapsCommand
+    context.fnTable.vkCmdCopyBufferToImage(cmd.buffer,
+        buffer.buffer,
+        texture.getImage().image,
         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
         1, &copy);
 
     //make sure the image is ready and transfer to shader comp layout
     barrier = VkImageMemoryBarrier{
-        .sType            = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-        .srcAccessMask    = VK_ACCESS_TRANSFER_WRITE_BIT,
-        .dstAccessMask    = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT,
-        .oldLayout        = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        .newLayout        = VK_IMAGE_LAYOUT_GENERAL,
-        .image            = dst.getImage().image,
-        .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        .image = texture.getImage().image,
+        .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, VK_REMAINING_ARRAY_LAYERS }
     };
-    context->fnTable.vkCmdPipelineBarrier(cmd.buffer,
+    vulkan::count(context.counters.barriers);
+    context.fnTable.vkCmdPipelineBarrier(cmd.buffer,
         VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
         VK_DEPENDENCY_BY_REGION_BIT,
         0, nullptr,
         0, nullptr,
         1, &barrier);
 }
 
+}
+
+void RetrieveImageCommand::record(vulkan::Command& cmd) const {
+    //alias for shorter code
+    auto& src = Source.get();
+    auto& dst = Destination.get();
+    //Check for src and dst to be from the same context
+    if (!vulkan::isSameDevice(src.getContext().get(), dst.getContext().get()))
+        throw std::logic_error(DIFFERENT_CONTEXT_ERROR_STR);
+    //check region fits into both
+    auto copy = getImageCopy(Region,
+        src.getWidth(), src.getHeight(), src.getDepth(), 1, src.getLayers(),
+        src.getFormat(), dst.getBuffer(), dst.size_bytes(), src.size_bytes());
+    vulkan::count(src.getContext()->counters.bytesDownloaded,
+        getCopySize(copy, src.getFormat()));
+    recordImageToBuffer(cmd, *src.getContext(),
+        src.getImage(), dst.getBuffer(), dst.size_bytes(), copy, true);
+}
+
+RetrieveImageCommand::RetrieveImageCommand(const RetrieveImageCommand& other) = default;
+RetrieveImageCommand& RetrieveImageCommand::operator=(const RetrieveImageCommand& other) = default;
+
+RetrieveImageCommand::RetrieveImageCommand(RetrieveImageCommand&& other) noexcept = default;
+RetrieveImageCommand& RetrieveImageCommand::operator=(RetrieveImageCommand&& other) noexcept = default;
+
+RetrieveImageCommand::RetrieveImageCommand(
+    const Image& src, const Buffer<std::byte>& dst, const ImageRegion& region
+)
+    : Command()
+    , Source(std::cref(src))
+    , Destination(std::cref(dst))
+    , Region(region)
+{}
+RetrieveImageCommand::~RetrieveImageCommand() = default;
+
+void UpdateImageCommand::record(vulkan::Command& cmd) const {
+    //alias for shorter code
+    auto& src = Source.get();
+    auto& dst = Destination.get();
+    //Check for src and dst to be from the same context
+    if (!vulkan::isSameDevice(src.getContext().get(), dst.getContext().get()))
+        throw std::logic_error(DIFFERENT_CONTEXT_ERROR_STR);
+    //check region fits into both
+    auto copy = getImageCopy(Region,
+        dst.getWidth(), dst.getHeight(), dst.getDepth(), 1, dst.getLayers(),
+        dst.getFormat(), src.getBuffer(), src.size_bytes(), dst.size_bytes());
+    vulkan::count(src.getContext()->counters.bytesUploaded,
+        getCopySize(copy, dst.getFormat()));
+    recordBufferToImage(cmd, *src.getContext(),
+        src.getBuffer(), src.size_bytes(), dst.getImage(), copy);
+}
+
 UpdateImageCommand::UpdateImageCommand(const UpdateImageCommand& other) = default;
 UpdateImageCommand& UpdateImageCommand::operator=(const UpdateImageCommand& other) = default;
 
 UpdateImageCommand::UpdateImageCommand(UpdateImageCommand&& other) noexcept = default;
 UpdateImageCommand& UpdateImageCommand::operator=(UpdateImageCommand&& other) noexcept = default;
 
-UpdateImageCommand::UpdateImageCommand(const Buffer<std::byte>& src, const Image& dst)
+UpdateImageCommand::UpdateImageCommand(
+    const Buffer<std::byte>& src, const Image& dst, const ImageRegion& region
+)
     : Command()
     , Source(std::cref(src))
     , Destination(std::cref(dst))
+    , Region(region)
 {}
 UpdateImageCommand::~UpdateImageCommand() = default;
 
@@ -542,76 +2359,280 @@ void UpdateTextureCommand::record(vulkan::Command& cmd) const {
     auto& src = Source.get();
     auto& dst = Destination.get();
     //Check for src and dst to be from the same context
-    if (src.getContext().get() != dst.getContext().get())
+    if (!vulkan::isSameDevice(src.getContext().get(), dst.getContext().get()))
         throw std::logic_error(DIFFERENT_CONTEXT_ERROR_STR);
-    auto& context = src.getContext();
-    //check both have the same size
-    if (src.size_bytes() != dst.size_bytes())
-        throw std::logic_error(SIZE_MISMATCH_ERROR_STR);
-    auto size = src.size_bytes();
+    //check region fits into both
+    auto copy = getImageCopy(Region,
+        dst.getWidth(), dst.getHeight(), dst.getDepth(),
+        dst.getMipLevels(), dst.getLayers(),
+        dst.getFormat(), src.getBuffer(), src.size_bytes(), dst.size_bytes());
+    vulkan::count(src.getContext()->counters.bytesUploaded,
+        getCopySize(copy, dst.getFormat()));
+    recordBufferToTexture(cmd, *src.getContext(),
+        src.getBuffer(), src.size_bytes(), dst, copy);
+}
+
+UpdateTextureCommand::UpdateTextureCommand(const UpdateTextureCommand& other) = default;
+UpdateTextureCommand& UpdateTextureCommand::operator=(const UpdateTextureCommand& other) = default;
+
+UpdateTextureCommand::UpdateTextureCommand(UpdateTextureCommand&& other) noexcept = default;
+UpdateTextureCommand& UpdateTextureCommand::operator=(UpdateTextureCommand&& other) noexcept = default;
+
+UpdateTextureCommand::UpdateTextureCommand(
+    const Buffer<std::byte>& src, const Texture& dst, const ImageRegion& region
+)
+    : Command()
+    , Source(std::cref(src))
+    , Destination(std::cref(dst))
+    , Region(region)
+{}
+UpdateTextureCommand::~UpdateTextureCommand() = default;
+
+void CopyImageToTensorCommand::record(vulkan::Command& cmd) const {
+    //alias for shorter code
+    auto& src = Source.get();
+    auto& dst = Destination.get();
+    //Check for src and dst to be from the same context
+    if (!vulkan::isSameDevice(src.getContext().get(), dst.getContext().get()))
+        throw std::logic_error(DIFFERENT_CONTEXT_ERROR_STR);
+    //check region fits into both
+    auto copy = getImageCopy(Region,
+        src.getWidth(), src.getHeight(), src.getDepth(), 1, src.getLayers(),
+        src.getFormat(), dst.getBuffer(), dst.size_bytes(), src.size_bytes());
+    recordImageToBuffer(cmd, *src.getContext(),
+        src.getImage(), dst.getBuffer(), dst.size_bytes(), copy, false);
+}
+
+CopyImageToTensorCommand::CopyImageToTensorCommand(const CopyImageToTensorCommand& other) = default;
+CopyImageToTensorCommand& CopyImageToTensorCommand::operator=(const CopyImageToTensorCommand& other) = default;
+
+CopyImageToTensorCommand::CopyImageToTensorCommand(CopyImageToTensorCommand&& other) noexcept = default;
+CopyImageToTensorCommand& CopyImageToTensorCommand::operator=(CopyImageToTensorCommand&& other) noexcept = default;
+
+CopyImageToTensorCommand::CopyImageToTensorCommand(
+    const Image& src, const Tensor<std::byte>& dst, const ImageRegion& region
+)
+    : Command()
+    , Source(std::cref(src))
+    , Destination(std::cref(dst))
+    , Region(region)
+{}
+CopyImageToTensorCommand::~CopyImageToTensorCommand() = default;
+
+void CopyTensorToImageCommand::record(vulkan::Command& cmd) const {
+    //alias for shorter code
+    auto& src = Source.get();
+    auto& dst = Destination.get();
+    //Check for src and dst to be from the same context
+    if (!vulkan::isSameDevice(src.getContext().get(), dst.getContext().get()))
+        throw std::logic_error(DIFFERENT_CONTEXT_ERROR_STR);
+    //check region fits into both
+    auto copy = getImageCopy(Region,
+        dst.getWidth(), dst.getHeight(), dst.getDepth(), 1, dst.getLayers(),
+        dst.getFormat(), src.getBuffer(), src.size_bytes(), dst.size_bytes());
+    recordBufferToImage(cmd, *src.getContext(),
+        src.getBuffer(), src.size_bytes(), dst.getImage(), copy);
+}
+
+CopyTensorToImageCommand::CopyTensorToImageCommand(const CopyTensorToImageCommand& other) = default;
+CopyTensorToImageCommand& CopyTensorToImageCommand::operator=(const CopyTensorToImageCommand& other) = default;
+
+CopyTensorToImageCommand::CopyTensorToImageCommand(CopyTensorToImageCommand&& other) noexcept = default;
+CopyTensorToImageCommand& CopyTensorToImageCommand::operator=(CopyTensorToImageCommand&& other) noexcept = default;
+
+CopyTensorToImageCommand::CopyTensorToImageCommand(
+    const Tensor<std::byte>& src, const Image& dst, const ImageRegion& region
+)
+    : Command()
+    , Source(std::cref(src))
+    , Destination(std::cref(dst))
+    , Region(region)
+{}
+CopyTensorToImageCommand::~CopyTensorToImageCommand() = default;
+
+void CopyTensorToTextureCommand::record(vulkan::Command& cmd) const {
+    //alias for shorter code
+    auto& src = Source.get();
+    auto& dst = Destination.get();
+    //Check for src and dst to be from the same context
+    if (!vulkan::isSameDevice(src.getContext().get(), dst.getContext().get()))
+        throw std::logic_error(DIFFERENT_CONTEXT_ERROR_STR);
+    //check region fits into both
+    auto copy = getImageCopy(Region,
+        dst.getWidth(), dst.getHeight(), dst.getDepth(),
+        dst.getMipLevels(), dst.getLayers(),
+        dst.getFormat(), src.getBuffer(), src.size_bytes(), dst.size_bytes());
+    recordBufferToTexture(cmd, *src.getContext(),
+        src.getBuffer(), src.size_bytes(), dst, copy);
+}
+
+CopyTensorToTextureCommand::CopyTensorToTextureCommand(const CopyTensorToTextureCommand& other) = default;
+CopyTensorToTextureCommand& CopyTensorToTextureCommand::operator=(const CopyTensorToTextureCommand& other) = default;
+
+CopyTensorToTextureCommand::CopyTensorToTextureCommand(CopyTensorToTextureCommand&& other) noexcept = default;
+CopyTensorToTextureCommand& CopyTensorToTextureCommand::operator=(CopyTensorToTextureCommand&& other) noexcept = default;
+
+CopyTensorToTextureCommand::CopyTensorToTextureCommand(
+    const Tensor<std::byte>& src, const Texture& dst, const ImageRegion& region
+)
+    : Command()
+    , Source(std::cref(src))
+    , Destination(std::cref(dst))
+    , Region(region)
+{}
+CopyTensorToTextureCommand::~CopyTensorToTextureCommand() = default;
+
+/********************************** MIPMAPS ***********************************/
+
+void GenerateMipmapsCommand::record(vulkan::Command& cmd) const {
+    //alias for shorter code
+    auto& texture = Target.get();
+    auto& context = texture.getContext();
+    auto image = texture.getImage().image;
+    auto levels = texture.getMipLevels();
+    auto layers = std::max(texture.getLayers(), 1u);
+    //nothing to generate
+    if (levels <= 1)
+        return;
+
+    //check the format supports blitting
+    VkFormatProperties props;
+    vkGetPhysicalDeviceFormatProperties(getDevice(context)->device,
+        static_cast<VkFormat>(texture.getFormat()), &props);
+    VkFormatFeatureFlags blitFlags =
+        VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+    if ((props.optimalTilingFeatures & blitFlags) != blitFlags)
+        throw std::runtime_error("Texture format does not support generating mipmaps!");
+    //integer formats usually lack linear filtering -> fall back to nearest
+    auto filter = (props.optimalTilingFeatures &
+        VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) ?
+        VK_FILTER_LINEAR : VK_FILTER_NEAREST;
 
     //we're acting on the transfer stage
     cmd.stage |= VK_PIPELINE_STAGE_TRANSFER_BIT;
 
-    //make ensure image is safe to write and prepare it for the transfer
-    VkImageMemoryBarrier barrier{
-        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-        .srcAccessMask = VK_ACCESS_SHADER_READ_BIT,
-        .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
-        .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        .image = dst.getImage().image,
-        .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
+    //successively downsample each level from the previous one
+    auto extent = [&texture](uint32_t level) -> VkOffset3D {
+        return {
+            static_cast<int32_t>(std::max(texture.getWidth() >> level, 1u)),
+            static_cast<int32_t>(std::max(texture.getHeight() >> level, 1u)),
+            static_cast<int32_t>(std::max(texture.getDepth() >> level, 1u))
+        };
+    };
+    auto blit = [&](uint32_t level) {
+        VkImageBlit region{
+            .srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, layers },
+            .srcOffsets = { { 0, 0, 0 }, extent(level - 1) },
+            .dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, layers },
+            .dstOffsets = { { 0, 0, 0 }, extent(level) }
+        };
+        context->fnTable.vkCmdBlitImage(cmd.buffer,
+            image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            1, &region, filter);
     };
+
+    //the tracker transitions the levels lazily leaving them in their transfer
+    //layouts until they get sampled
+    if (cmd.tracker) {
+        auto view = texture.getImage().view;
+        for (uint32_t level = 1; level < levels; ++level) {
+            cmd.tracker->texture(image, view, level - 1, 1,
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                VK_PIPELINE_STAGE_2_BLIT_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+            cmd.tracker->texture(image, view, level, 1,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_PIPELINE_STAGE_2_BLIT_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+                true);
+            cmd.tracker->barrier(*context, cmd);
+            blit(level);
+        }
+        return;
+    }
+
+    //make the first level a transfer source and the remaining ones destinations
+    std::array<VkImageMemoryBarrier, 2> barriers{ {
+        {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .image = image,
+            .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, VK_REMAINING_ARRAY_LAYERS }
+        },
+        {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_SHADER_READ_BIT,
+            .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .image = image,
+            .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 1, levels - 1, 0, VK_REMAINING_ARRAY_LAYERS }
+        }
+    } };
+    vulkan::count(context->counters.barriers);
     context->fnTable.vkCmdPipelineBarrier(cmd.buffer,
-        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
         VK_PIPELINE_STAGE_TRANSFER_BIT,
-        VK_DEPENDENCY_BY_REGION_BIT,
+        0,
         0, nullptr,
         0, nullptr,
-        1, &barrier);
+        static_cast<uint32_t>(barriers.size()), barriers.data());
 
-    //issue copy
-    VkBufferImageCopy copy{
-        .imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0 ,1 },
-        .imageExtent = { dst.getWidth(), dst.getHeight(), dst.getDepth() }
-    };
-    context->fnTable.vkCmdCopyBufferToImage(cmd.buffer,
-        src.getBuffer().buffer,
-        dst.getImage().image,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        1, &copy);
+    for (uint32_t level = 1; level < levels; ++level) {
+        blit(level);
 
-    //make sure the image is ready and transfer to shader comp layout
-    barrier = VkImageMemoryBarrier{
+        //written level becomes the source of the next one
+        VkImageMemoryBarrier barrier{
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .image = image,
+            .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, level, 1, 0, VK_REMAINING_ARRAY_LAYERS }
+        };
+        vulkan::count(context->counters.barriers);
+        context->fnTable.vkCmdPipelineBarrier(cmd.buffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            0, nullptr,
+            0, nullptr,
+            1, &barrier);
+    }
+
+    //all levels are now transfer sources -> return them to shader read
+    VkImageMemoryBarrier barrier{
         .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
         .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
-        .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
         .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-        .image = dst.getImage().image,
-        .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
+        .image = image,
+        .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, levels, 0, VK_REMAINING_ARRAY_LAYERS }
     };
+    vulkan::count(context->counters.barriers);
     context->fnTable.vkCmdPipelineBarrier(cmd.buffer,
         VK_PIPELINE_STAGE_TRANSFER_BIT,
         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        VK_DEPENDENCY_BY_REGION_BIT,
+        0,
         0, nullptr,
         0, nullptr,
         1, &barrier);
 }
 
-UpdateTextureCommand::UpdateTextureCommand(const UpdateTextureCommand& other) = default;
-UpdateTextureCommand& UpdateTextureCommand::operator=(const UpdateTextureCommand& other) = default;
+GenerateMipmapsCommand::GenerateMipmapsCommand(const GenerateMipmapsCommand& other) = default;
+GenerateMipmapsCommand& GenerateMipmapsCommand::operator=(const GenerateMipmapsCommand& other) = default;
 
-UpdateTextureCommand::UpdateTextureCommand(UpdateTextureCommand&& other) noexcept = default;
-UpdateTextureCommand& UpdateTextureCommand::operator=(UpdateTextureCommand&& other) noexcept = default;
+GenerateMipmapsCommand::GenerateMipmapsCommand(GenerateMipmapsCommand&& other) noexcept = default;
+GenerateMipmapsCommand& GenerateMipmapsCommand::operator=(GenerateMipmapsCommand&& other) noexcept = default;
 
-UpdateTextureCommand::UpdateTextureCommand(const Buffer<std::byte>& src, const Texture& dst)
+GenerateMipmapsCommand::GenerateMipmapsCommand(const Texture& texture)
     : Command()
-    , Source(std::cref(src))
-    , Destination(std::cref(dst))
+    , Target(std::cref(texture))
 {}
-UpdateTextureCommand::~UpdateTextureCommand() = default;
+GenerateMipmapsCommand::~GenerateMipmapsCommand() = default;
 
 }
@@ -0,0 +1,153 @@
+#include "hephaistos/multidevice.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace hephaistos {
+
+/********************************* DEVICE GROUP *******************************/
+
+uint32_t DeviceGroup::size() const noexcept {
+    return static_cast<uint32_t>(contexts.size());
+}
+const ContextHandle& DeviceGroup::getContext(uint32_t index) const {
+    if (index >= contexts.size())
+        throw std::out_of_range("There is no device with the given index in the group!");
+    return contexts[index];
+}
+std::span<const ContextHandle> DeviceGroup::getContexts() const noexcept {
+    return contexts;
+}
+
+DeviceGroup::DeviceGroup(const DeviceGroup&) = default;
+DeviceGroup& DeviceGroup::operator=(const DeviceGroup&) = default;
+
+DeviceGroup::DeviceGroup(DeviceGroup&&) noexcept = default;
+DeviceGroup& DeviceGroup::operator=(DeviceGroup&&) noexcept = default;
+
+DeviceGroup::DeviceGroup(std::vector<ContextHandle> contexts)
+    : contexts(std::move(contexts))
+{
+    if (this->contexts.empty())
+        throw std::logic_error("A device group needs at least one context!");
+    if (std::any_of(this->contexts.begin(), this->contexts.end(),
+        [](const ContextHandle& context) { return !context; }))
+    {
+        throw std::logic_error("Cannot create a device group from an empty context!");
+    }
+}
+
+DeviceGroup::DeviceGroup(const ExtensionFactory& extensions, uint32_t maxDevices)
+    : contexts()
+{
+    auto createExtensions = [&extensions]() {
+        return extensions ? extensions() : std::vector<ExtensionHandle>{};
+    };
+
+    //filter suitable devices; discrete ones first, otherwise keep the order
+    auto devices = enumerateDevices();
+    std::vector<DeviceHandle> suitable;
+    for (auto& device : devices) {
+        if (isDeviceSuitable(device, createExtensions()))
+            suitable.push_back(std::move(device));
+    }
+    std::stable_partition(suitable.begin(), suitable.end(),
+        [](const DeviceHandle& device) { return getDeviceInfo(device).isDiscrete; });
+    if (suitable.empty())
+        throw std::runtime_error("There is no suitable device!");
+    if (maxDevices > 0 && suitable.size() > maxDevices)
+        suitable.erase(suitable.begin() + maxDevices, suitable.end());
+
+    contexts.reserve(suitable.size());
+    for (auto& device : suitable) {
+        auto deviceExtensions = createExtensions();
+        contexts.push_back(createContext(device, deviceExtensions));
+    }
+}
+
+DeviceGroup::~DeviceGroup() = default;
+
+/*********************************** PROGRAMS *********************************/
+
+std::vector<Program> createPrograms(
+    const DeviceGroup& group,
+    std::span<const uint32_t> code,
+    std::span<const std::byte> specialization)
+{
+    auto contexts = group.getContexts();
+    std::vector<Program> programs;
+    programs.reserve(contexts.size());
+    for (auto& context : contexts) {
+        //identical devices can skip the compilation the first one did
+        if (!programs.empty())
+            sharePipelineCache(contexts.front(), context);
+        programs.emplace_back(context, code, specialization);
+    }
+    return programs;
+}
+
+/********************************* DISTRIBUTE *********************************/
+
+std::vector<uint32_t> distribute(
+    const DeviceGroup& group, uint32_t count,
+    const std::function<void(uint32_t device, uint32_t item)>& task,
+    LoadBalancing balancing)
+{
+    auto deviceCount = group.size();
+    std::vector<uint32_t> processed(deviceCount, 0);
+    if (count == 0)
+        return processed;
+
+    //first exception stops handing out further items
+    std::atomic<uint32_t> next = 0;
+    std::atomic<bool> failed = false;
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto run = [&](uint32_t device) {
+        //static: contiguous equally sized ranges
+        auto begin = static_cast<uint32_t>(uint64_t(count) * device / deviceCount);
+        auto end = static_cast<uint32_t>(uint64_t(count) * (device + 1) / deviceCount);
+        try {
+            while (!failed) {
+                uint32_t item;
+                if (balancing == LoadBalancing::STATIC) {
+                    if (begin >= end)
+                        break;
+                    item = begin++;
+                }
+                else {
+                    item = next.fetch_add(1, std::memory_order_relaxed);
+                    if (item >= count)
+                        break;
+                }
+                task(device, item);
+                ++processed[device];
+            }
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+                error = std::current_exception();
+            failed = true;
+        }
+    };
+
+    //the calling thread serves the first device
+    std::vector<std::thread> threads;
+    threads.reserve(deviceCount - 1);
+    for (auto device = 1u; device < deviceCount; ++device)
+        threads.emplace_back(run, device);
+    run(0);
+    for (auto& thread : threads)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+    return processed;
+}
+
+}
@@ -0,0 +1,593 @@
+#include "hephaistos/neighbours.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "hephaistos/compiler.hpp"
+#include "hephaistos/primitives.hpp"
+#include "hephaistos/program.hpp"
+
+#include "vk/hazard.hpp"
+#include "vk/types.hpp"
+
+namespace hephaistos {
+
+namespace {
+
+/******************************** SHADER CODE *********************************/
+
+//shared by all kernels; expects LOCAL_SIZE to be defined
+constexpr char CommonSource[] = R"(
+#version 460
+#extension GL_EXT_buffer_reference : require
+
+layout(local_size_x = LOCAL_SIZE) in;
+
+struct Point {
+    vec3 position;
+    uint index;
+};
+struct Neighbour {
+    uint index;
+    float distance;
+};
+
+layout(buffer_reference, std430, buffer_reference_align = 4) readonly buffer Floats { float v[]; };
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer Words { uint v[]; };
+layout(buffer_reference, std430, buffer_reference_align = 8) buffer Boxes { float v[]; };
+layout(buffer_reference, std430, buffer_reference_align = 8) buffer Neighbours { Neighbour v[]; };
+layout(buffer_reference, std430, buffer_reference_align = 16) buffer Points { Point v[]; };
+
+uint hashCell(ivec3 c, uint mask) {
+    return ((uint(c.x) * 73856093u) ^ (uint(c.y) * 19349663u) ^ (uint(c.z) * 83492791u)) & mask;
+}
+)";
+
+//expects STAGE to be defined: 0 writes boxes, 1 cell keys, 2 the sorted grid
+constexpr char BuildSource[] = R"(
+layout(push_constant) uniform Push {
+    Floats points;
+    Points positions;
+    Boxes boxes;
+    Words keys;
+    Words indices;
+    //start and end of each bucket in sorted order
+    Words cells;
+    uint stride;
+    uint count;
+    float radius;
+    float invCell;
+    uint mask;
+};
+
+vec3 load(uint i) {
+    uint j = i * stride;
+    return vec3(points.v[j], points.v[j + 1u], points.v[j + 2u]);
+}
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= count)
+        return;
+
+#if STAGE == 0
+    vec3 p = load(i);
+    positions.v[i] = Point(p, i);
+    vec3 lo = p - radius, hi = p + radius;
+    boxes.v[6u * i + 0u] = lo.x;
+    boxes.v[6u * i + 1u] = lo.y;
+    boxes.v[6u * i + 2u] = lo.z;
+    boxes.v[6u * i + 3u] = hi.x;
+    boxes.v[6u * i + 4u] = hi.y;
+    boxes.v[6u * i + 5u] = hi.z;
+#elif STAGE == 1
+    keys.v[i] = hashCell(ivec3(floor(load(i) * invCell)), mask);
+#else
+    uint idx = indices.v[i];
+    uint key = keys.v[idx];
+    positions.v[i] = Point(load(idx), idx);
+    if (i == 0u || keys.v[indices.v[i - 1u]] != key)
+        cells.v[2u * key] = i;
+    if (i == count - 1u || keys.v[indices.v[i + 1u]] != key)
+        cells.v[2u * key + 1u] = i + 1u;
+#endif
+}
+)";
+
+//expects METHOD (0 ray tracing, 1 grid) and MODE (0 radius, 1 nearest) to
+//be defined
+constexpr char QuerySource[] = R"(
+#if METHOD == 0
+#extension GL_EXT_ray_query : require
+layout(binding = 0) uniform accelerationStructureEXT tlas;
+#endif
+
+layout(push_constant) uniform Push {
+    Floats queries;
+    Words counts;
+    Neighbours neighbours;
+    Points positions;
+    Words cells;
+    uint count;
+    uint maxNeighbours;
+    float radius;
+    float invCell;
+    uint mask;
+};
+
+//orders by distance, ties broken by index
+bool before(float d, uint i, Neighbour n) {
+    return d < n.distance || (d == n.distance && i < n.index);
+}
+
+void visit(Point p, vec3 q, uint base, inout uint found) {
+    float d = distance(p.position, q);
+    if (d > radius)
+        return;
+#if MODE == 0
+    if (found < maxNeighbours)
+        neighbours.v[base + found] = Neighbour(p.index, d);
+    found++;
+#else
+    //insertion into the sorted list of the nearest ones so far
+    uint pos;
+    if (found < maxNeighbours)
+        pos = found++;
+    else if (before(d, p.index, neighbours.v[base + maxNeighbours - 1u]))
+        pos = maxNeighbours - 1u;
+    else
+        return;
+    for (; pos > 0u && before(d, p.index, neighbours.v[base + pos - 1u]); --pos)
+        neighbours.v[base + pos] = neighbours.v[base + pos - 1u];
+    neighbours.v[base + pos] = Neighbour(p.index, d);
+#endif
+}
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= count)
+        return;
+    vec3 q = vec3(queries.v[3u * i], queries.v[3u * i + 1u], queries.v[3u * i + 2u]);
+    uint base = i * maxNeighbours;
+    uint found = 0u;
+
+#if METHOD == 0
+    //boxes containing the query are reported as candidates of a ray of
+    //negligible length; as none is committed, all of them get visited
+    rayQueryEXT query;
+    rayQueryInitializeEXT(query, tlas, gl_RayFlagsNoneEXT, 0xFF,
+        q, 0.0, vec3(1.0, 0.0, 0.0), 1e-16);
+    while (rayQueryProceedEXT(query)) {
+        if (rayQueryGetIntersectionTypeEXT(query, false) ==
+            gl_RayQueryCandidateIntersectionAABBEXT)
+        {
+            visit(positions.v[rayQueryGetIntersectionPrimitiveIndexEXT(query, false)],
+                q, base, found);
+        }
+    }
+#else
+    //neighbours lie at most one cell apart; cells sharing a bucket are only
+    //visited once
+    ivec3 cell = ivec3(floor(q * invCell));
+    uint visited[27];
+    uint nVisited = 0u;
+    for (int dz = -1; dz <= 1; ++dz) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                uint h = hashCell(cell + ivec3(dx, dy, dz), mask);
+                bool seen = false;
+                for (uint k = 0u; k < nVisited; ++k)
+                    seen = seen || visited[k] == h;
+                if (seen)
+                    continue;
+                visited[nVisited++] = h;
+
+                uint end = cells.v[2u * h + 1u];
+                for (uint j = cells.v[2u * h]; j < end; ++j)
+                    visit(positions.v[j], q, base, found);
+            }
+        }
+    }
+#endif
+
+    counts.v[i] = found;
+}
+)";
+
+struct BuildPush {
+    uint64_t points;
+    uint64_t positions;
+    uint64_t boxes;
+    uint64_t keys;
+    uint64_t indices;
+    uint64_t cells;
+    uint32_t stride;
+    uint32_t count;
+    float radius;
+    float invCell;
+    uint32_t mask;
+    uint32_t padding;
+};
+
+struct QueryPush {
+    uint64_t queries;
+    uint64_t counts;
+    uint64_t neighbours;
+    uint64_t positions;
+    uint64_t cells;
+    uint32_t count;
+    uint32_t maxNeighbours;
+    float radius;
+    float invCell;
+    uint32_t mask;
+    uint32_t padding;
+};
+
+enum class BuildStage {
+    BOXES,
+    KEYS,
+    CELLS
+};
+
+//position and original index of each point
+constexpr uint64_t PointSize = 16;
+constexpr uint64_t BoxSize = 6 * sizeof(float);
+
+}
+
+/******************************* NEIGHBOUR INDEX ******************************/
+
+struct NeighbourIndex::pImp {
+    NeighbourMethod method;
+    float radius;
+    uint32_t count;
+    Tensor<std::byte> positions;
+
+    //ray tracing; the store holds the blas referenced by the tlas
+    std::optional<GeometryStore> store;
+    std::optional<AccelerationStructure> tlas;
+
+    //grid
+    std::optional<Tensor<std::byte>> cells;
+    uint32_t mask = 0;
+};
+
+NeighbourMethod NeighbourIndex::getMethod() const noexcept {
+    return _pImp->method;
+}
+float NeighbourIndex::getRadius() const noexcept {
+    return _pImp->radius;
+}
+uint32_t NeighbourIndex::getCount() const noexcept {
+    return _pImp->count;
+}
+
+NeighbourIndex::NeighbourIndex(NeighbourIndex&& other) noexcept = default;
+NeighbourIndex& NeighbourIndex::operator=(NeighbourIndex&& other) noexcept = default;
+
+NeighbourIndex::NeighbourIndex(std::unique_ptr<pImp> imp)
+    : _pImp(std::move(imp))
+{}
+NeighbourIndex::~NeighbourIndex() = default;
+
+/*************************** NEIGHBOUR QUERY COMMAND **************************/
+
+struct NeighbourQueryCommand::State {
+    std::array<std::byte, sizeof(QueryPush)> push;
+    //empty if there are no queries
+    std::optional<DispatchCommand> dispatch;
+    //tensors accessed via their address; declared to the hazard tracker
+    std::reference_wrapper<const Tensor<std::byte>> queries;
+    std::reference_wrapper<const Tensor<std::byte>> counts;
+    std::reference_wrapper<const Tensor<std::byte>> neighbours;
+    uint64_t queriesSize;
+    uint64_t countsSize;
+    uint64_t neighboursSize;
+};
+
+void NeighbourQueryCommand::record(vulkan::Command& cmd) const {
+    if (!state->dispatch)
+        return;
+
+    //dispatch will place the barrier
+    if (cmd.tracker) {
+        auto& queries = state->queries.get().getBuffer();
+        auto& counts = state->counts.get().getBuffer();
+        auto& neighbours = state->neighbours.get().getBuffer();
+        cmd.tracker->buffer(queries.buffer, queries.offset, state->queriesSize,
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+            VK_ACCESS_2_SHADER_READ_BIT_KHR);
+        cmd.tracker->buffer(counts.buffer, counts.offset, state->countsSize,
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+            VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+        if (state->neighboursSize > 0) {
+            //nearest queries also read back their list
+            cmd.tracker->buffer(neighbours.buffer, neighbours.offset, state->neighboursSize,
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+        }
+    }
+    state->dispatch->record(cmd);
+}
+
+NeighbourQueryCommand::NeighbourQueryCommand(const NeighbourQueryCommand&) = default;
+NeighbourQueryCommand& NeighbourQueryCommand::operator=(const NeighbourQueryCommand&) = default;
+
+NeighbourQueryCommand::NeighbourQueryCommand(NeighbourQueryCommand&&) noexcept = default;
+NeighbourQueryCommand& NeighbourQueryCommand::operator=(NeighbourQueryCommand&&) noexcept = default;
+
+NeighbourQueryCommand::NeighbourQueryCommand(std::shared_ptr<const State> state)
+    : state(std::move(state))
+{}
+NeighbourQueryCommand::~NeighbourQueryCommand() = default;
+
+/****************************** NEIGHBOUR SEARCH ******************************/
+
+struct NeighbourSearch::pImp {
+    ContextHandle context;
+    NeighbourMethod method;
+    uint32_t localSize;
+    BuildOptions buildOptions;
+    //sorts the grid
+    std::optional<Primitives> primitives;
+
+    //programs are compiled on first use; the mutex also guards binding the
+    //acceleration structure until the dispatch took its snapshot
+    std::mutex mutex;
+    Compiler compiler;
+    std::array<std::unique_ptr<Program>, 3> buildPrograms;
+    std::array<std::unique_ptr<Program>, 2> queryPrograms;
+
+    Program& compile(std::unique_ptr<Program>& program, std::string source,
+        std::initializer_list<std::pair<std::string, std::string>> defines)
+    {
+        if (program)
+            return *program;
+
+        CompileOptions options;
+        options.defines = { { "LOCAL_SIZE", std::to_string(localSize) } };
+        options.defines.insert(options.defines.end(), defines.begin(), defines.end());
+        compiler.setOptions(options);
+        program = std::make_unique<Program>(context, compiler.compile(source));
+        return *program;
+    }
+    Program& getBuildProgram(BuildStage stage) {
+        return compile(buildPrograms[static_cast<size_t>(stage)],
+            std::string(CommonSource) + BuildSource,
+            { { "STAGE", std::to_string(static_cast<int>(stage)) } });
+    }
+    Program& getQueryProgram(bool nearest) {
+        return compile(queryPrograms[nearest ? 1 : 0],
+            std::string(CommonSource) + QuerySource, {
+                { "METHOD", method == NeighbourMethod::RAYTRACING ? "0" : "1" },
+                { "MODE", nearest ? "1" : "0" }
+            });
+    }
+
+    NeighbourQueryCommand query(
+        const NeighbourIndex::pImp& index,
+        const Tensor<std::byte>& queries,
+        const Tensor<std::byte>& counts,
+        const Tensor<std::byte>& neighbours,
+        uint32_t maxNeighbours,
+        uint32_t count,
+        bool nearest);
+
+    pImp(ContextHandle context, const NeighbourSearchOptions& options)
+        : context(std::move(context))
+        , method(options.method)
+        , localSize(options.localSize)
+        , buildOptions(options.buildOptions)
+    {
+        auto raytracing = isRaytracingEnabled(this->context);
+        if (method == NeighbourMethod::AUTO)
+            method = raytracing ? NeighbourMethod::RAYTRACING : NeighbourMethod::GRID;
+        if (method == NeighbourMethod::RAYTRACING && !raytracing)
+            throw std::logic_error("Ray tracing is not enabled!");
+        if (method == NeighbourMethod::GRID)
+            primitives.emplace(this->context);
+
+        auto info = getDeviceInfo(this->context);
+        if (localSize == 0) {
+            //queries diverge a lot; keep the workgroups small
+            auto props = getSubgroupProperties(this->context);
+            localSize = props.maxSubgroupSize > 0 ? 2 * props.maxSubgroupSize : 64;
+            localSize = std::min(localSize, info.maxWorkGroupInvocations);
+        }
+        if (localSize > info.maxWorkGroupInvocations)
+            throw std::logic_error("Local size exceeds the device's limit!");
+    }
+};
+
+NeighbourMethod NeighbourSearch::getMethod() const noexcept {
+    return _pImp->method;
+}
+uint32_t NeighbourSearch::getLocalSize() const noexcept {
+    return _pImp->localSize;
+}
+
+NeighbourIndex NeighbourSearch::build(
+    const Tensor<std::byte>& points,
+    float radius,
+    uint32_t count,
+    uint32_t stride) const
+{
+    if (!(radius > 0.0f))
+        throw std::logic_error("Radius must be positive!");
+    if (stride < 3 * sizeof(float) || stride % 4)
+        throw std::logic_error("Point stride must be a multiple of 4 and hold at least 3 floats!");
+    auto size = points.size_bytes();
+    auto maxCount = size < 3 * sizeof(float) ? 0 : (size - 3 * sizeof(float)) / stride + 1;
+    if (count == std::numeric_limits<uint32_t>::max())
+        count = static_cast<uint32_t>(std::min<uint64_t>(maxCount, count));
+    if (count > maxCount)
+        throw std::out_of_range("Count exceeds the size of the point tensor!");
+    if (count == 0)
+        throw std::logic_error("Cannot build a neighbour index without points!");
+
+    auto& context = _pImp->context;
+    auto imp = std::make_unique<NeighbourIndex::pImp>(NeighbourIndex::pImp{
+        .method = _pImp->method,
+        .radius = radius,
+        .count = count,
+        .positions = Tensor<std::byte>(context, PointSize * count)
+    });
+    auto groups = (count + _pImp->localSize - 1) / _pImp->localSize;
+    BuildPush push{
+        .points = points.address(),
+        .positions = imp->positions.address(),
+        .stride = stride / 4,
+        .count = count,
+        .radius = radius,
+        .invCell = 1.0f / radius
+    };
+
+    if (imp->method == NeighbourMethod::RAYTRACING) {
+        //only needed during the build
+        Tensor<std::byte> boxes(context, BoxSize * count);
+        push.boxes = boxes.address();
+        const Program* program;
+        {
+            std::lock_guard<std::mutex> lock(_pImp->mutex);
+            program = &_pImp->getBuildProgram(BuildStage::BOXES);
+        }
+        execute(context, program->dispatch(push, groups));
+
+        TensorBoundingBoxes box{ .boxes = &boxes, .count = count };
+        imp->store.emplace(context, std::span<const TensorBoundingBoxes>(&box, 1),
+            _pImp->buildOptions);
+        imp->tlas.emplace(context, imp->store->createInstance(0), _pImp->buildOptions);
+    }
+    else {
+        //hash table with at least as many buckets as points
+        auto buckets = std::bit_ceil(count);
+        imp->mask = buckets - 1;
+        imp->cells.emplace(context, 8ull * buckets);
+        Tensor<std::byte> keys(context, 4ull * count);
+        Tensor<std::byte> indices(context, 4ull * count);
+        push.keys = keys.address();
+        push.indices = indices.address();
+        push.cells = imp->cells->address();
+        push.mask = imp->mask;
+
+        const Program *keysProgram, *cellsProgram;
+        {
+            std::lock_guard<std::mutex> lock(_pImp->mutex);
+            keysProgram = &_pImp->getBuildProgram(BuildStage::KEYS);
+            cellsProgram = &_pImp->getBuildProgram(BuildStage::CELLS);
+        }
+        beginSequence(context)
+            .And(clearTensor(*imp->cells, {}))
+            .And(keysProgram->dispatch(push, groups))
+            .Then(_pImp->primitives->sortIndices(keys, indices, SortKeyType::UINT32, count))
+            .Then(cellsProgram->dispatch(push, groups))
+            .Submit().wait();
+    }
+
+    return NeighbourIndex(std::move(imp));
+}
+
+NeighbourQueryCommand NeighbourSearch::pImp::query(
+    const NeighbourIndex::pImp& index,
+    const Tensor<std::byte>& queries,
+    const Tensor<std::byte>& counts,
+    const Tensor<std::byte>& neighbours,
+    uint32_t maxNeighbours,
+    uint32_t count,
+    bool nearest)
+{
+    if (index.method != method)
+        throw std::logic_error("Neighbour index was built using a different method!");
+    auto maxCount = queries.size_bytes() / (3 * sizeof(float));
+    if (count == std::numeric_limits<uint32_t>::max())
+        count = static_cast<uint32_t>(std::min<uint64_t>(maxCount, count));
+    if (count > maxCount)
+        throw std::out_of_range("Count exceeds the size of the query tensor!");
+    if (uint64_t(count) * maxNeighbours > std::numeric_limits<uint32_t>::max())
+        throw std::out_of_range("Too many neighbours per query!");
+    if (counts.size_bytes() < 4ull * count)
+        throw std::logic_error("Counts tensor is too small!");
+    auto neighboursSize = sizeof(Neighbour) * uint64_t(count) * maxNeighbours;
+    if (neighbours.size_bytes() < neighboursSize)
+        throw std::logic_error("Neighbours tensor is too small!");
+
+    auto state = std::make_shared<NeighbourQueryCommand::State>(NeighbourQueryCommand::State{
+        .push = {},
+        .dispatch = std::nullopt,
+        .queries = std::cref(queries),
+        .counts = std::cref(counts),
+        .neighbours = std::cref(neighbours),
+        .queriesSize = 3 * sizeof(float) * uint64_t(count),
+        .countsSize = 4ull * count,
+        .neighboursSize = neighboursSize
+    });
+    QueryPush push{
+        .queries = queries.address(),
+        .counts = counts.address(),
+        .neighbours = neighboursSize > 0 ? neighbours.address() : 0,
+        .positions = index.positions.address(),
+        .cells = index.cells ? index.cells->address() : 0,
+        .count = count,
+        .maxNeighbours = maxNeighbours,
+        .radius = index.radius,
+        .invCell = 1.0f / index.radius,
+        .mask = index.mask
+    };
+    std::memcpy(state->push.data(), &push, sizeof(push));
+
+    if (count > 0) {
+        auto groups = (count + localSize - 1) / localSize;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& program = getQueryProgram(nearest);
+        if (index.tlas)
+            program.bindParameter(*index.tlas, 0);
+        state->dispatch.emplace(program.dispatch(
+            std::span<const std::byte>(state->push), groups));
+    }
+    return NeighbourQueryCommand(std::move(state));
+}
+
+NeighbourQueryCommand NeighbourSearch::queryRadius(
+    const NeighbourIndex& index,
+    const Tensor<std::byte>& queries,
+    const Tensor<std::byte>& counts,
+    const Tensor<std::byte>& neighbours,
+    uint32_t maxNeighbours,
+    uint32_t count) const
+{
+    return _pImp->query(*index._pImp, queries, counts, neighbours,
+        maxNeighbours, count, false);
+}
+
+NeighbourQueryCommand NeighbourSearch::queryNearest(
+    const NeighbourIndex& index,
+    const Tensor<std::byte>& queries,
+    const Tensor<std::byte>& counts,
+    const Tensor<std::byte>& neighbours,
+    uint32_t k,
+    uint32_t count) const
+{
+    if (k == 0)
+        throw std::logic_error("At least one neighbour must be requested!");
+    return _pImp->query(*index._pImp, queries, counts, neighbours, k, count, true);
+}
+
+NeighbourSearch::NeighbourSearch(NeighbourSearch&& other) noexcept = default;
+NeighbourSearch& NeighbourSearch::operator=(NeighbourSearch&& other) noexcept = default;
+
+NeighbourSearch::NeighbourSearch(ContextHandle context, const NeighbourSearchOptions& options)
+    : _pImp(std::make_unique<pImp>(std::move(context), options))
+{}
+NeighbourSearch::~NeighbourSearch() = default;
+
+}
@@ -0,0 +1,156 @@
+#include "hephaistos/packed.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include "volk.h"
+
+#include "vk/types.hpp"
+
+namespace hephaistos {
+
+namespace {
+
+constexpr auto ExtensionName = "PackedTypes";
+
+//16 and 8 bit storage are part of Vulkan 1.2,
+//only integer dot product needs an extension
+constexpr auto DotProductExtensions = std::to_array({
+    VK_KHR_SHADER_INTEGER_DOT_PRODUCT_EXTENSION_NAME
+});
+
+constexpr PackedTypesProperties NoPackedTypes{};
+
+bool isDotProductExtensionSupported(const DeviceHandle& device) {
+    return std::includes(
+        device->supportedExtensions.begin(),
+        device->supportedExtensions.end(),
+        DotProductExtensions.begin(),
+        DotProductExtensions.end());
+}
+
+}
+
+class PackedTypesExtension : public Extension {
+public:
+    const PackedTypesProperties props;
+
+    bool isDeviceSupported(const DeviceHandle& device) const override {
+        auto supported = getPackedTypesProperties(device);
+        return
+            (supported.storageBuffer16BitAccess || !props.storageBuffer16BitAccess) &&
+            (supported.uniformAndStorageBuffer16BitAccess || !props.uniformAndStorageBuffer16BitAccess) &&
+            (supported.storagePushConstant16 || !props.storagePushConstant16) &&
+            (supported.storageBuffer8BitAccess || !props.storageBuffer8BitAccess) &&
+            (supported.uniformAndStorageBuffer8BitAccess || !props.uniformAndStorageBuffer8BitAccess) &&
+            (supported.storagePushConstant8 || !props.storagePushConstant8) &&
+            (supported.integerDotProduct || !props.integerDotProduct);
+    }
+    std::string_view getExtensionName() const override {
+        return ExtensionName;
+    }
+    std::span<const char* const> getDeviceExtensions() const override {
+        if (props.integerDotProduct)
+            return DotProductExtensions;
+        else
+            return {};
+    }
+    void* chain(void* pNext) override {
+        storage16Feat.pNext = pNext;
+        return this->pNext;
+    }
+
+    PackedTypesExtension(const PackedTypesProperties& props);
+    virtual ~PackedTypesExtension() = default;
+
+private:
+    void* pNext;
+
+    VkPhysicalDevice16BitStorageFeatures storage16Feat;
+    VkPhysicalDevice8BitStorageFeatures storage8Feat;
+    VkPhysicalDeviceShaderIntegerDotProductFeaturesKHR dotFeat;
+};
+
+PackedTypesProperties getPackedTypesProperties(const DeviceHandle& device) {
+    //nullcheck
+    if (!device)
+        return {};
+
+    //query features
+    VkPhysicalDeviceShaderIntegerDotProductFeaturesKHR dotFeat{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_INTEGER_DOT_PRODUCT_FEATURES_KHR
+    };
+    VkPhysicalDevice8BitStorageFeatures storage8Feat{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_8BIT_STORAGE_FEATURES
+    };
+    VkPhysicalDevice16BitStorageFeatures storage16Feat{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES,
+        .pNext = &storage8Feat
+    };
+    //only chain dot product if the extension is available
+    bool dotExt = isDotProductExtensionSupported(device);
+    if (dotExt)
+        storage8Feat.pNext = &dotFeat;
+    VkPhysicalDeviceFeatures2 feat{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &storage16Feat
+    };
+    vkGetPhysicalDeviceFeatures2(device->device, &feat);
+
+    //copy features
+    //double negate to make the compiler happy (implicit narrowing)...
+    return {
+        !!storage16Feat.storageBuffer16BitAccess,
+        !!storage16Feat.uniformAndStorageBuffer16BitAccess,
+        !!storage16Feat.storagePushConstant16,
+        !!storage8Feat.storageBuffer8BitAccess,
+        !!storage8Feat.uniformAndStorageBuffer8BitAccess,
+        !!storage8Feat.storagePushConstant8,
+        dotExt && dotFeat.shaderIntegerDotProduct
+    };
+}
+
+const PackedTypesProperties& getEnabledPackedTypes(const ContextHandle& context) {
+    auto& ext = *context->extensions;
+    auto pExt = std::find_if(ext.begin(), ext.end(),
+        [](const ExtensionHandle& h) -> bool {
+            return h->getExtensionName() == ExtensionName;
+        });
+    if (pExt == ext.end())
+        return NoPackedTypes;
+    else
+        return dynamic_cast<PackedTypesExtension*>(pExt->get())->props;
+}
+
+PackedTypesExtension::PackedTypesExtension(const PackedTypesProperties& props)
+    : props(props)
+    , pNext(nullptr)
+{
+    //fill feature structs
+    storage16Feat = VkPhysicalDevice16BitStorageFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES,
+        .storageBuffer16BitAccess = props.storageBuffer16BitAccess,
+        .uniformAndStorageBuffer16BitAccess = props.uniformAndStorageBuffer16BitAccess,
+        .storagePushConstant16 = props.storagePushConstant16
+    };
+    pNext = &storage16Feat;
+    storage8Feat = VkPhysicalDevice8BitStorageFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_8BIT_STORAGE_FEATURES,
+        .pNext = pNext,
+        .storageBuffer8BitAccess = props.storageBuffer8BitAccess,
+        .uniformAndStorageBuffer8BitAccess = props.uniformAndStorageBuffer8BitAccess,
+        .storagePushConstant8 = props.storagePushConstant8
+    };
+    pNext = static_cast<void*>(&storage8Feat);
+    dotFeat = VkPhysicalDeviceShaderIntegerDotProductFeaturesKHR{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_INTEGER_DOT_PRODUCT_FEATURES_KHR,
+        .pNext = pNext,
+        .shaderIntegerDotProduct = props.integerDotProduct
+    };
+    if (props.integerDotProduct)
+        pNext = static_cast<void*>(&dotFeat);
+}
+ExtensionHandle createPackedTypesExtension(const PackedTypesProperties& properties) {
+    return std::make_unique<PackedTypesExtension>(properties);
+}
+}
@@ -0,0 +1,387 @@
+#include "hephaistos/performance.hpp"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <stdexcept>
+
+#include "volk.h"
+
+#include "vk/result.hpp"
+#include "vk/types.hpp"
+#include "vk/util.hpp"
+
+namespace hephaistos {
+
+/********************************** EXTENSION *********************************/
+
+namespace {
+
+constexpr auto ExtensionName = "PerformanceQuery";
+
+//! MUST BE SORTED FOR std::includes !//
+constexpr auto DeviceExtensions = std::to_array({
+    VK_KHR_PERFORMANCE_QUERY_EXTENSION_NAME
+});
+
+}
+
+bool isPerformanceQuerySupported(const DeviceHandle& device) {
+    //nullcheck
+    if (!device)
+        return false;
+
+    //Check extension support
+    if (!std::includes(
+        device->supportedExtensions.begin(),
+        device->supportedExtensions.end(),
+        DeviceExtensions.begin(),
+        DeviceExtensions.end()))
+    {
+        return false;
+    }
+
+    //Query features
+    VkPhysicalDevicePerformanceQueryFeaturesKHR performanceFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PERFORMANCE_QUERY_FEATURES_KHR
+    };
+    VkPhysicalDeviceFeatures2 features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &performanceFeatures
+    };
+    vkGetPhysicalDeviceFeatures2(device->device, &features);
+
+    return performanceFeatures.performanceCounterQueryPools == VK_TRUE;
+}
+bool isPerformanceQueryEnabled(const ContextHandle& context) {
+    //to shorten things
+    auto& ext = *context->extensions;
+    return std::find_if(ext.begin(), ext.end(),
+        [](const ExtensionHandle& h) -> bool {
+            return h->getExtensionName() == ExtensionName;
+        }) != ext.end();
+}
+
+class PerformanceQueryExtension : public Extension {
+public:
+    bool isDeviceSupported(const DeviceHandle& device) const override {
+        return isPerformanceQuerySupported(device);
+    }
+    std::string_view getExtensionName() const override {
+        return ExtensionName;
+    }
+    std::span<const char* const> getDeviceExtensions() const override {
+        return DeviceExtensions;
+    }
+    void* chain(void* pNext) override {
+        performanceFeatures.pNext = pNext;
+        return static_cast<void*>(&performanceFeatures);
+    }
+
+    PerformanceQueryExtension() = default;
+    virtual ~PerformanceQueryExtension() = default;
+
+private:
+    VkPhysicalDevicePerformanceQueryFeaturesKHR performanceFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PERFORMANCE_QUERY_FEATURES_KHR,
+        .performanceCounterQueryPools = VK_TRUE
+    };
+};
+ExtensionHandle createPerformanceQueryExtension() {
+    return std::make_unique<PerformanceQueryExtension>();
+}
+
+/********************************** COUNTERS **********************************/
+
+namespace {
+
+struct CounterInfo {
+    std::vector<VkPerformanceCounterKHR> counters;
+    std::vector<VkPerformanceCounterDescriptionKHR> descriptions;
+};
+
+CounterInfo queryCounters(const vulkan::Context& context) {
+    uint32_t count;
+    vulkan::checkResult(vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR(
+        context.physicalDevice, context.queueFamily, &count, nullptr, nullptr));
+    CounterInfo info{
+        .counters = std::vector<VkPerformanceCounterKHR>(count, {
+            .sType = VK_STRUCTURE_TYPE_PERFORMANCE_COUNTER_KHR
+        }),
+        .descriptions = std::vector<VkPerformanceCounterDescriptionKHR>(count, {
+            .sType = VK_STRUCTURE_TYPE_PERFORMANCE_COUNTER_DESCRIPTION_KHR
+        })
+    };
+    vulkan::checkResult(vkEnumeratePhysicalDeviceQueueFamilyPerformanceQueryCountersKHR(
+        context.physicalDevice, context.queueFamily, &count,
+        info.counters.data(), info.descriptions.data()));
+    return info;
+}
+
+PerformanceCounter toCounter(
+    const VkPerformanceCounterKHR& counter,
+    const VkPerformanceCounterDescriptionKHR& description)
+{
+    return {
+        .name = description.name,
+        .category = description.category,
+        .description = description.description,
+        .unit = static_cast<PerformanceCounterUnit>(counter.unit)
+    };
+}
+
+double toDouble(const VkPerformanceCounterResultKHR& result, VkPerformanceCounterStorageKHR storage) {
+    switch (storage) {
+    case VK_PERFORMANCE_COUNTER_STORAGE_INT32_KHR:
+        return static_cast<double>(result.int32);
+    case VK_PERFORMANCE_COUNTER_STORAGE_INT64_KHR:
+        return static_cast<double>(result.int64);
+    case VK_PERFORMANCE_COUNTER_STORAGE_UINT32_KHR:
+        return static_cast<double>(result.uint32);
+    case VK_PERFORMANCE_COUNTER_STORAGE_UINT64_KHR:
+        return static_cast<double>(result.uint64);
+    case VK_PERFORMANCE_COUNTER_STORAGE_FLOAT32_KHR:
+        return static_cast<double>(result.float32);
+    case VK_PERFORMANCE_COUNTER_STORAGE_FLOAT64_KHR:
+        return result.float64;
+    default:
+        return 0.0;
+    }
+}
+
+//holds the profiling lock until destroyed
+class ProfilingLock {
+public:
+    ProfilingLock(const ProfilingLock&) = delete;
+    ProfilingLock& operator=(const ProfilingLock&) = delete;
+
+    explicit ProfilingLock(const vulkan::Context& context)
+        : context(context)
+    {
+        VkAcquireProfilingLockInfoKHR info{
+            .sType = VK_STRUCTURE_TYPE_ACQUIRE_PROFILING_LOCK_INFO_KHR,
+            .timeout = UINT64_MAX
+        };
+        vulkan::checkResult(context.fnTable.vkAcquireProfilingLockKHR(
+            context.device, &info));
+    }
+    ~ProfilingLock() {
+        context.fnTable.vkReleaseProfilingLockKHR(context.device);
+    }
+
+private:
+    const vulkan::Context& context;
+};
+
+}
+
+std::vector<PerformanceCounter> enumeratePerformanceCounters(const ContextHandle& context) {
+    if (!isPerformanceQueryEnabled(context))
+        throw std::runtime_error("Performance queries are not enabled!");
+
+    auto info = queryCounters(*context);
+    std::vector<PerformanceCounter> result;
+    result.reserve(info.counters.size());
+    for (auto i = 0u; i < info.counters.size(); ++i)
+        result.push_back(toCounter(info.counters[i], info.descriptions[i]));
+    return result;
+}
+
+/******************************* PERFORMANCE QUERY ****************************/
+
+struct PerformanceQuery::pImp {
+    const vulkan::Context& context;
+
+    std::vector<PerformanceCounter> counters;
+    std::vector<VkPerformanceCounterStorageKHR> storages;
+    uint32_t passCount;
+
+    //passes resubmit the same command buffer, so it cannot be a one time submit
+    std::mutex mutex;
+    VkQueryPool queryPool;
+    VkCommandPool commandPool;
+    VkCommandBuffer commandBuffer;
+    VkFence fence;
+
+    pImp(const vulkan::Context& context, std::span<const std::string> names)
+        : context(context)
+        , passCount(0)
+        , queryPool(nullptr)
+        , commandPool(nullptr)
+        , commandBuffer(nullptr)
+        , fence(nullptr)
+    {
+        //resolve counter names
+        auto info = queryCounters(context);
+        std::vector<uint32_t> indices;
+        indices.reserve(names.size());
+        for (auto& name : names) {
+            auto it = std::find_if(info.descriptions.begin(), info.descriptions.end(),
+                [&name](const VkPerformanceCounterDescriptionKHR& d) { return name == d.name; });
+            if (it == info.descriptions.end())
+                throw std::runtime_error("Unknown performance counter: " + name);
+            auto idx = static_cast<uint32_t>(it - info.descriptions.begin());
+            indices.push_back(idx);
+            counters.push_back(toCounter(info.counters[idx], *it));
+            storages.push_back(info.counters[idx].storage);
+        }
+
+        VkQueryPoolPerformanceCreateInfoKHR performanceInfo{
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_PERFORMANCE_CREATE_INFO_KHR,
+            .queueFamilyIndex = context.queueFamily,
+            .counterIndexCount = static_cast<uint32_t>(indices.size()),
+            .pCounterIndices = indices.data()
+        };
+        vkGetPhysicalDeviceQueueFamilyPerformanceQueryPassesKHR(
+            context.physicalDevice, &performanceInfo, &passCount);
+
+        //create resources
+        VkQueryPoolCreateInfo queryInfo{
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .pNext = &performanceInfo,
+            .queryType = VK_QUERY_TYPE_PERFORMANCE_QUERY_KHR,
+            .queryCount = 1
+        };
+        VkCommandPoolCreateInfo poolInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+            .queueFamilyIndex = context.queueFamily
+        };
+        VkFenceCreateInfo fenceInfo{
+            .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO
+        };
+        auto result = context.fnTable.vkCreateQueryPool(
+            context.device, &queryInfo, nullptr, &queryPool);
+        if (result == VK_SUCCESS) {
+            result = context.fnTable.vkCreateCommandPool(
+                context.device, &poolInfo, nullptr, &commandPool);
+        }
+        if (result == VK_SUCCESS) {
+            VkCommandBufferAllocateInfo bufInfo{
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                .commandPool = commandPool,
+                .commandBufferCount = 1
+            };
+            result = context.fnTable.vkAllocateCommandBuffers(
+                context.device, &bufInfo, &commandBuffer);
+        }
+        if (result == VK_SUCCESS) {
+            result = context.fnTable.vkCreateFence(
+                context.device, &fenceInfo, nullptr, &fence);
+        }
+        if (result != VK_SUCCESS) {
+            destroy();
+            vulkan::checkResult(result); //will throw
+        }
+    }
+
+    std::vector<PerformanceCounterResult> measure(
+        const std::function<void(vulkan::Command& cmd)>& emitter)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        context.fnTable.vkResetQueryPool(context.device, queryPool, 0, 1);
+        vulkan::checkResult(context.fnTable.vkResetCommandPool(
+            context.device, commandPool, 0));
+
+        //the lock must be held while recording and executing the query
+        ProfilingLock profilingLock(context);
+
+        //record once; the query must start the command buffer
+        VkCommandBufferBeginInfo beginInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO
+        };
+        vulkan::checkResult(context.fnTable.vkBeginCommandBuffer(
+            commandBuffer, &beginInfo));
+        context.fnTable.vkCmdBeginQuery(commandBuffer, queryPool, 0, 0);
+        vulkan::Command wrapper{ commandBuffer, 0 };
+        emitter(wrapper);
+        context.fnTable.vkCmdEndQuery(commandBuffer, queryPool, 0);
+        vulkan::checkResult(context.fnTable.vkEndCommandBuffer(commandBuffer));
+
+        //submit once per pass
+        for (auto pass = 0u; pass < passCount; ++pass) {
+            VkPerformanceQuerySubmitInfoKHR passInfo{
+                .sType = VK_STRUCTURE_TYPE_PERFORMANCE_QUERY_SUBMIT_INFO_KHR,
+                .counterPassIndex = pass
+            };
+            VkSubmitInfo submitInfo{
+                .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+                .pNext = &passInfo,
+                .commandBufferCount = 1,
+                .pCommandBuffers = &commandBuffer
+            };
+            vulkan::queueSubmit(context, 1, &submitInfo, fence);
+            vulkan::checkResult(context.fnTable.vkWaitForFences(
+                context.device, 1, &fence, VK_TRUE, UINT64_MAX));
+            vulkan::checkResult(context.fnTable.vkResetFences(
+                context.device, 1, &fence));
+        }
+
+        //fetch results
+        std::vector<VkPerformanceCounterResultKHR> values(counters.size());
+        vulkan::checkResult(context.fnTable.vkGetQueryPoolResults(
+            context.device, queryPool, 0, 1,
+            values.size() * sizeof(VkPerformanceCounterResultKHR), values.data(),
+            values.size() * sizeof(VkPerformanceCounterResultKHR),
+            VK_QUERY_RESULT_WAIT_BIT));
+
+        std::vector<PerformanceCounterResult> result;
+        result.reserve(counters.size());
+        for (auto i = 0u; i < counters.size(); ++i) {
+            result.push_back({
+                .name = counters[i].name,
+                .value = toDouble(values[i], storages[i]),
+                .unit = counters[i].unit
+            });
+        }
+        return result;
+    }
+
+    void destroy() {
+        if (fence)
+            context.fnTable.vkDestroyFence(context.device, fence, nullptr);
+        //destroying the pool also frees the command buffer
+        if (commandPool)
+            context.fnTable.vkDestroyCommandPool(context.device, commandPool, nullptr);
+        if (queryPool)
+            context.fnTable.vkDestroyQueryPool(context.device, queryPool, nullptr);
+    }
+    ~pImp() {
+        destroy();
+    }
+};
+
+std::span<const PerformanceCounter> PerformanceQuery::getCounters() const noexcept {
+    return _pImp->counters;
+}
+uint32_t PerformanceQuery::getPassCount() const noexcept {
+    return _pImp->passCount;
+}
+
+std::vector<PerformanceCounterResult> PerformanceQuery::measure(
+    const std::function<void(vulkan::Command& cmd)>& emitter)
+{
+    return _pImp->measure(emitter);
+}
+std::vector<PerformanceCounterResult> PerformanceQuery::measure(const Command& command) {
+    return _pImp->measure([&command](vulkan::Command& cmd) {
+        command.record(cmd);
+    });
+}
+
+PerformanceQuery::PerformanceQuery(PerformanceQuery&& other) noexcept = default;
+PerformanceQuery& PerformanceQuery::operator=(PerformanceQuery&& other) noexcept = default;
+
+PerformanceQuery::PerformanceQuery(ContextHandle context, std::span<const std::string> counters)
+    : Resource(std::move(context))
+    , _pImp()
+{
+    if (!isPerformanceQueryEnabled(getContext()))
+        throw std::runtime_error("Performance queries are not enabled!");
+    if (counters.empty())
+        throw std::logic_error("At least one performance counter must be specified!");
+    _pImp = std::make_unique<pImp>(*getContext(), counters);
+}
+PerformanceQuery::~PerformanceQuery() = default;
+
+}
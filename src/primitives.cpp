@@ -0,0 +1,2152 @@
+#include "hephaistos/primitives.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "volk.h"
+
+#include "hephaistos/atomic.hpp"
+#include "hephaistos/compiler.hpp"
+#include "hephaistos/context.hpp"
+#include "hephaistos/program.hpp"
+
+#include "vk/hazard.hpp"
+#include "vk/types.hpp"
+#include "vk/util.hpp"
+
+namespace hephaistos {
+
+namespace {
+
+/******************************** SHADER CODE *********************************/
+
+//shared by all kernels; expects T, OP, IDENTITY, TO_BITS, FROM_BITS,
+//LOCAL_SIZE and ITEMS to be defined
+constexpr char CommonSource[] = R"(
+#extension GL_EXT_buffer_reference : require
+#ifdef USE_SUBGROUPS
+#extension GL_KHR_shader_subgroup_basic : require
+#extension GL_KHR_shader_subgroup_arithmetic : require
+#endif
+#ifdef USE_BALLOT
+#extension GL_KHR_shader_subgroup_ballot : require
+#endif
+#ifdef USE_SHUFFLE
+#extension GL_KHR_shader_subgroup_basic : require
+#extension GL_KHR_shader_subgroup_shuffle : require
+#endif
+#ifdef USE_ATOMIC_FLOAT
+#extension GL_EXT_shader_atomic_float : require
+#endif
+
+layout(local_size_x = LOCAL_SIZE) in;
+
+#if OP == 0
+#define COMBINE(a, b) ((a) + (b))
+#define SUBGROUP_INCLUSIVE subgroupInclusiveAdd
+#define SUBGROUP_EXCLUSIVE subgroupExclusiveAdd
+#elif OP == 1
+#define COMBINE(a, b) min(a, b)
+#define SUBGROUP_INCLUSIVE subgroupInclusiveMin
+#define SUBGROUP_EXCLUSIVE subgroupExclusiveMin
+#else
+#define COMBINE(a, b) max(a, b)
+#define SUBGROUP_INCLUSIVE subgroupInclusiveMax
+#define SUBGROUP_EXCLUSIVE subgroupExclusiveMax
+#endif
+
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer Data { T v[]; };
+
+shared T sharedData[LOCAL_SIZE];
+
+//exclusive scan of one value per thread across the workgroup
+T workgroupExclusiveScan(T x, out T aggregate) {
+#ifdef USE_SUBGROUPS
+    T incl = SUBGROUP_INCLUSIVE(x);
+    T excl = SUBGROUP_EXCLUSIVE(x);
+    if (gl_SubgroupInvocationID == gl_SubgroupSize - 1u)
+        sharedData[gl_SubgroupID] = incl;
+    barrier();
+    //scan subgroup totals; host ensures they fit into a single subgroup
+    if (gl_SubgroupID == 0u) {
+        T s = gl_SubgroupInvocationID < gl_NumSubgroups ?
+            sharedData[gl_SubgroupInvocationID] : IDENTITY;
+        s = SUBGROUP_INCLUSIVE(s);
+        if (gl_SubgroupInvocationID < gl_NumSubgroups)
+            sharedData[gl_SubgroupInvocationID] = s;
+    }
+    barrier();
+    aggregate = sharedData[gl_NumSubgroups - 1u];
+    T prefix = gl_SubgroupID > 0u ? sharedData[gl_SubgroupID - 1u] : IDENTITY;
+    barrier();
+    return COMBINE(prefix, excl);
+#else
+    uint t = gl_LocalInvocationID.x;
+    sharedData[t] = x;
+    barrier();
+    for (uint d = 1u; d < LOCAL_SIZE; d <<= 1u) {
+        T y = t >= d ? sharedData[t - d] : IDENTITY;
+        barrier();
+        sharedData[t] = COMBINE(y, sharedData[t]);
+        barrier();
+    }
+    aggregate = sharedData[LOCAL_SIZE - 1u];
+    T prefix = t > 0u ? sharedData[t - 1u] : IDENTITY;
+    barrier();
+    return prefix;
+#endif
+}
+)";
+
+//single pass scan using decoupled look-back
+constexpr char ScanSource[] = R"(
+layout(buffer_reference, std430, buffer_reference_align = 4) coherent buffer State { uint v[]; };
+
+layout(push_constant) uniform Push {
+    Data inData;
+    Data outData;
+    //tile counter followed by flag, aggregate and inclusive prefix per tile
+    State state;
+    Data total;
+    uint count;
+    uint mode;
+};
+
+#define MODE_EXCLUSIVE 1u
+#define MODE_FLAGS 2u
+#define MODE_TOTAL 4u
+
+#define FLAG_AGGREGATE 1u
+#define FLAG_INCLUSIVE 2u
+
+shared uint tileId;
+shared T tilePrefix;
+
+T load(uint i) {
+    if (i >= count)
+        return IDENTITY;
+    T x = inData.v[i];
+    if ((mode & MODE_FLAGS) != 0u)
+        x = x != T(0) ? T(1) : T(0);
+    return x;
+}
+
+void main() {
+    uint t = gl_LocalInvocationID.x;
+    //tiles are assigned in launch order, so look-back only waits on tiles
+    //which already started and thus always finishes
+    if (t == 0u)
+        tileId = atomicAdd(state.v[0], 1u);
+    barrier();
+    uint tile = tileId;
+    uint base = tile * (LOCAL_SIZE * ITEMS) + t * ITEMS;
+
+    //thread local scan
+    T items[ITEMS];
+    T sum = IDENTITY;
+    for (uint i = 0u; i < ITEMS; ++i) {
+        sum = COMBINE(sum, load(base + i));
+        items[i] = sum;
+    }
+    T aggregate;
+    T threadPrefix = workgroupExclusiveScan(sum, aggregate);
+
+    //publish aggregate and look back on previous tiles
+    if (t == 0u) {
+        uint slot = 1u + 3u * tile;
+        T prefix = IDENTITY;
+        if (tile > 0u) {
+            state.v[slot + 1u] = TO_BITS(aggregate);
+            memoryBarrierBuffer();
+            atomicExchange(state.v[slot], FLAG_AGGREGATE);
+
+            for (uint p = tile; p > 0u; --p) {
+                uint prev = 1u + 3u * (p - 1u);
+                uint flag;
+                do {
+                    flag = atomicOr(state.v[prev], 0u);
+                } while (flag == 0u);
+                memoryBarrierBuffer();
+                if (flag == FLAG_INCLUSIVE) {
+                    prefix = COMBINE(FROM_BITS(state.v[prev + 2u]), prefix);
+                    break;
+                }
+                prefix = COMBINE(FROM_BITS(state.v[prev + 1u]), prefix);
+            }
+        }
+        state.v[slot + 2u] = TO_BITS(COMBINE(prefix, aggregate));
+        memoryBarrierBuffer();
+        atomicExchange(state.v[slot], FLAG_INCLUSIVE);
+        tilePrefix = prefix;
+    }
+    barrier();
+
+    //empty scans still write their total
+    if ((mode & MODE_TOTAL) != 0u && count == 0u && t == 0u)
+        total.v[0] = IDENTITY;
+
+    //write result
+    T prefix = COMBINE(tilePrefix, threadPrefix);
+    bool exclusive = (mode & MODE_EXCLUSIVE) != 0u;
+    for (uint i = 0u; i < ITEMS; ++i) {
+        uint idx = base + i;
+        if (idx >= count)
+            break;
+        T incl = COMBINE(prefix, items[i]);
+        if (exclusive)
+            outData.v[idx] = i > 0u ? COMBINE(prefix, items[i - 1u]) : prefix;
+        else
+            outData.v[idx] = incl;
+        if ((mode & MODE_TOTAL) != 0u && idx == count - 1u)
+            total.v[0] = incl;
+    }
+}
+)";
+
+//reduces each tile to a single element
+constexpr char ReduceSource[] = R"(
+layout(push_constant) uniform Push {
+    Data inData;
+    Data outData;
+    uint count;
+};
+
+#ifdef DETERMINISTIC
+//pairwise tree over one value per thread: each step halves the live range
+//[0, 2d) by combining element t with t + d. Once the range fits into a
+//subgroup, shuffles continue with the same pairing, thus the result does
+//not depend on the subgroup size. TREE_SIZE is half the local size rounded
+//up to a power of two.
+T workgroupTreeReduce(T x) {
+    uint t = gl_LocalInvocationID.x;
+    sharedData[t] = x;
+    barrier();
+#ifdef USE_SHUFFLE
+    uint last = gl_SubgroupSize;
+#else
+    uint last = 1u;
+#endif
+    uint d = TREE_SIZE;
+    for (; d >= last; d >>= 1u) {
+        if (t < d && t + d < LOCAL_SIZE)
+            sharedData[t] = COMBINE(sharedData[t], sharedData[t + d]);
+        barrier();
+    }
+#ifdef USE_SHUFFLE
+    if (gl_SubgroupID == 0u) {
+        uint lane = gl_SubgroupInvocationID;
+        T v = lane < LOCAL_SIZE ? sharedData[lane] : IDENTITY;
+        for (; d > 0u; d >>= 1u) {
+            T y = subgroupShuffleXor(v, d);
+            if (lane < d && lane + d < LOCAL_SIZE)
+                v = COMBINE(v, y);
+        }
+        if (lane == 0u)
+            sharedData[0] = v;
+    }
+    barrier();
+#endif
+    return sharedData[0];
+}
+#endif
+
+void main() {
+    uint t = gl_LocalInvocationID.x;
+    uint base = gl_WorkGroupID.x * (LOCAL_SIZE * ITEMS) + t;
+
+    //strided access for coalesced loads
+    T sum = IDENTITY;
+    for (uint i = 0u; i < ITEMS; ++i) {
+        uint idx = base + i * LOCAL_SIZE;
+        if (idx < count)
+            sum = COMBINE(sum, inData.v[idx]);
+    }
+#ifdef DETERMINISTIC
+    T aggregate = workgroupTreeReduce(sum);
+#else
+    T aggregate;
+    workgroupExclusiveScan(sum, aggregate);
+#endif
+
+    if (t == 0u)
+        outData.v[gl_WorkGroupID.x] = aggregate;
+}
+)";
+
+//moves kept items of a single column to their compacted position
+constexpr char ScatterSource[] = R"(
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer Words { uint v[]; };
+
+layout(push_constant) uniform Push {
+    Words flags;
+    Words offsets;
+    Words src;
+    Words dst;
+    uint count;
+    uint words;
+};
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= count || flags.v[i] == 0u)
+        return;
+
+    uint from = i * words;
+    uint to = offsets.v[i] * words;
+    for (uint w = 0u; w < words; ++w)
+        dst.v[to + w] = src.v[from + w];
+}
+)";
+
+//shared by the sorting kernels
+constexpr char SortCommonSource[] = R"(
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer Words { uint v[]; };
+layout(buffer_reference, std430, buffer_reference_align = 4) coherent buffer State { uint v[]; };
+
+#define KEY_SIGNED 1u
+#define KEY_FLOAT 2u
+
+#define FLAG_COUNT 1u
+#define FLAG_INDEX 2u
+
+uvec2 loadKey(Words keys, uint i, uint keyWords) {
+    return keyWords == 2u ?
+        uvec2(keys.v[2u * i], keys.v[2u * i + 1u]) :
+        uvec2(keys.v[i], 0u);
+}
+
+//maps keys to unsigned integers of the same order
+uvec2 orderedKey(uvec2 k, uint keyWords, uint keyKind) {
+    uint top = keyWords == 2u ? k.y : k.x;
+    bool negative = (top & 0x80000000u) != 0u;
+    uint mask = 0u, lowMask = 0u;
+    if (keyKind == KEY_SIGNED) {
+        mask = 0x80000000u;
+    }
+    else if (keyKind == KEY_FLOAT) {
+        mask = negative ? 0xFFFFFFFFu : 0x80000000u;
+        lowMask = negative ? 0xFFFFFFFFu : 0u;
+    }
+    return keyWords == 2u ? uvec2(k.x ^ lowMask, k.y ^ mask) : uvec2(k.x ^ mask, 0u);
+}
+
+uint digitOf(uvec2 k, uint shift) {
+    uint w = shift < 32u ? k.x : k.y;
+    return (w >> (shift & 31u)) & 0xFFu;
+}
+)";
+
+//counts the digits of all passes at once
+constexpr char HistogramSource[] = R"(
+layout(push_constant) uniform Push {
+    Words keys;
+    Words hist;
+    Words countPtr;
+    uint count;
+    uint keyWords;
+    uint keyKind;
+    uint flags;
+};
+
+shared uint localHist[8 * 256];
+
+void main() {
+    uint t = gl_LocalInvocationID.x;
+    uint passes = 4u * keyWords;
+    for (uint i = t; i < passes * 256u; i += LOCAL_SIZE)
+        localHist[i] = 0u;
+    barrier();
+
+    uint n = (flags & FLAG_COUNT) != 0u ? min(count, countPtr.v[0]) : count;
+    uint base = gl_WorkGroupID.x * (LOCAL_SIZE * ITEMS) + t;
+    for (uint i = 0u; i < ITEMS; ++i) {
+        uint idx = base + i * LOCAL_SIZE;
+        if (idx >= n)
+            break;
+        uvec2 k = orderedKey(loadKey(keys, idx, keyWords), keyWords, keyKind);
+        for (uint p = 0u; p < passes; ++p)
+            atomicAdd(localHist[p * 256u + digitOf(k, 8u * p)], 1u);
+    }
+    barrier();
+
+    for (uint i = t; i < passes * 256u; i += LOCAL_SIZE) {
+        if (localHist[i] > 0u)
+            atomicAdd(hist.v[i], localHist[i]);
+    }
+}
+)";
+
+//turns the histogram of each pass into the offset of each digit
+constexpr char DigitScanSource[] = R"(
+layout(push_constant) uniform Push {
+    Words hist;
+};
+
+void main() {
+    uint t = gl_LocalInvocationID.x;
+    uint offset = gl_WorkGroupID.x * 256u;
+    uint carry = 0u;
+    for (uint d = 0u; d < 256u; d += LOCAL_SIZE) {
+        uint idx = d + t;
+        uint x = idx < 256u ? hist.v[offset + idx] : 0u;
+        uint aggregate;
+        uint prefix = workgroupExclusiveScan(x, aggregate);
+        if (idx < 256u)
+            hist.v[offset + idx] = carry + prefix;
+        carry += aggregate;
+    }
+}
+)";
+
+//moves keys and values to their position by the digit of a single pass
+//using decoupled look-back per digit
+constexpr char OnesweepSource[] = R"(
+layout(push_constant) uniform Push {
+    Words keysIn;
+    Words keysOut;
+    Words valuesIn;
+    Words valuesOut;
+    //offset of each digit of this pass
+    Words offsets;
+    //tile counter followed by flag and count per digit and tile
+    State state;
+    Words countPtr;
+    uint count;
+    uint shift;
+    uint keyWords;
+    uint keyKind;
+    uint valueWords;
+    uint flags;
+};
+
+#define FLAG_AGGREGATE 0x40000000u
+#define FLAG_INCLUSIVE 0x80000000u
+#define VALUE_MASK 0x3FFFFFFFu
+//digit of keys past the end, which never get moved
+#define NO_DIGIT 256u
+
+shared uint tileId;
+//running count of each digit inside the tile
+shared uint digitCount[256];
+shared uint digitOffset[256];
+#ifndef USE_BALLOT
+shared uint roundDigits[LOCAL_SIZE];
+#endif
+
+//returns the position of the key among the ones with the same digit in the
+//tile so far, keeping the order of their indices
+uint rank(uint d) {
+    bool valid = d != NO_DIGIT;
+#ifdef USE_BALLOT
+    //find the threads in the subgroup sharing the same digit
+    uvec4 match = subgroupBallot(true);
+    for (uint b = 0u; b < 9u; ++b) {
+        bool bit = ((d >> b) & 1u) != 0u;
+        uvec4 ballot = subgroupBallot(bit);
+        match &= bit ? ballot : ~ballot;
+    }
+    uint r = subgroupBallotExclusiveBitCount(match);
+    uint n = subgroupBallotBitCount(match);
+
+    //subgroups update the running count one after another
+    uint result = 0u;
+    for (uint s = 0u; s < gl_NumSubgroups; ++s) {
+        if (gl_SubgroupID == s) {
+            uint first = valid ? digitCount[d] : 0u;
+            subgroupMemoryBarrierShared();
+            subgroupBarrier();
+            if (valid && r == 0u)
+                digitCount[d] = first + n;
+            result = first + r;
+        }
+        barrier();
+    }
+    return result;
+#else
+    uint t = gl_LocalInvocationID.x;
+    roundDigits[t] = d;
+    barrier();
+
+    uint r = 0u;
+    bool last = true;
+    if (valid) {
+        for (uint j = 0u; j < t; ++j)
+            r += roundDigits[j] == d ? 1u : 0u;
+        for (uint j = t + 1u; j < LOCAL_SIZE; ++j) {
+            if (roundDigits[j] == d) {
+                last = false;
+                break;
+            }
+        }
+    }
+    uint result = valid ? digitCount[d] + r : 0u;
+    barrier();
+    if (valid && last)
+        digitCount[d] = result + 1u;
+    barrier();
+    return result;
+#endif
+}
+
+void main() {
+    uint t = gl_LocalInvocationID.x;
+    //tiles are assigned in launch order, so look-back only waits on tiles
+    //which already started and thus always finishes
+    if (t == 0u)
+        tileId = atomicAdd(state.v[0], 1u);
+    for (uint d = t; d < 256u; d += LOCAL_SIZE)
+        digitCount[d] = 0u;
+    barrier();
+    uint tile = tileId;
+    uint base = tile * (LOCAL_SIZE * ITEMS) + t;
+    uint n = (flags & FLAG_COUNT) != 0u ? min(count, countPtr.v[0]) : count;
+
+    //rank keys in rounds of consecutive keys, so the sort stays stable
+    uvec2 keys[ITEMS];
+    uint digits[ITEMS];
+    uint ranks[ITEMS];
+    for (uint i = 0u; i < ITEMS; ++i) {
+        uint idx = base + i * LOCAL_SIZE;
+        bool valid = idx < n;
+        keys[i] = valid ? loadKey(keysIn, idx, keyWords) : uvec2(0u);
+        digits[i] = valid ?
+            digitOf(orderedKey(keys[i], keyWords, keyKind), shift) : NO_DIGIT;
+        ranks[i] = rank(digits[i]);
+    }
+    barrier();
+
+    //publish digit counts and look back on previous tiles
+    for (uint d = t; d < 256u; d += LOCAL_SIZE) {
+        uint aggregate = digitCount[d];
+        uint prefix = 0u;
+        if (tile > 0u) {
+            atomicExchange(state.v[1u + 256u * tile + d], FLAG_AGGREGATE | aggregate);
+            for (uint p = tile; p > 0u; --p) {
+                uint s;
+                do {
+                    s = atomicOr(state.v[1u + 256u * (p - 1u) + d], 0u);
+                } while (s == 0u);
+                prefix += s & VALUE_MASK;
+                if ((s & FLAG_INCLUSIVE) != 0u)
+                    break;
+            }
+        }
+        atomicExchange(state.v[1u + 256u * tile + d], FLAG_INCLUSIVE | (prefix + aggregate));
+        digitOffset[d] = offsets.v[d] + prefix;
+    }
+    barrier();
+
+    //move keys and values
+    for (uint i = 0u; i < ITEMS; ++i) {
+        if (digits[i] == NO_DIGIT)
+            break;
+        uint idx = base + i * LOCAL_SIZE;
+        uint dst = digitOffset[digits[i]] + ranks[i];
+        keysOut.v[keyWords * dst] = keys[i].x;
+        if (keyWords == 2u)
+            keysOut.v[2u * dst + 1u] = keys[i].y;
+        if ((flags & FLAG_INDEX) != 0u) {
+            valuesOut.v[dst] = idx;
+        }
+        else {
+            for (uint w = 0u; w < valueWords; ++w)
+                valuesOut.v[dst * valueWords + w] = valuesIn.v[idx * valueWords + w];
+        }
+    }
+}
+)";
+
+//moves the items of a single column to the position given by their index
+constexpr char GatherSource[] = R"(
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer Words { uint v[]; };
+
+layout(push_constant) uniform Push {
+    Words indices;
+    Words src;
+    Words dst;
+    Words srcCount;
+    Words dstCount;
+    uint count;
+    uint words;
+    uint hasCount;
+};
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    uint n = hasCount != 0u ? min(count, srcCount.v[0]) : count;
+    if (hasCount != 0u && i == 0u)
+        dstCount.v[0] = n;
+    if (i >= n)
+        return;
+
+    uint from = indices.v[i] * words;
+    uint to = i * words;
+    for (uint w = 0u; w < words; ++w)
+        dst.v[to + w] = src.v[from + w];
+}
+)";
+
+//accumulates items into bins, optionally privatized in shared memory
+constexpr char BinningSource[] = R"(
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer Words { uint v[]; };
+
+layout(push_constant) uniform Push {
+    Words indices;
+    Data weights;
+    Data hist;
+    uint count;
+    uint bins;
+    uint hasWeights;
+};
+
+#ifdef SHARED_BINS
+shared T localBins[SHARED_BINS];
+#endif
+
+void accumulate(uint bin, T w) {
+#ifdef SHARED_BINS
+    atomicAdd(localBins[bin], w);
+#else
+    atomicAdd(hist.v[bin], w);
+#endif
+}
+
+void main() {
+    uint t = gl_LocalInvocationID.x;
+#ifdef SHARED_BINS
+    for (uint b = t; b < bins; b += LOCAL_SIZE)
+        localBins[b] = T(0);
+    barrier();
+#endif
+
+    uint base = gl_WorkGroupID.x * (LOCAL_SIZE * ITEMS) + t;
+    for (uint i = 0u; i < ITEMS; ++i) {
+        uint idx = base + i * LOCAL_SIZE;
+        if (idx >= count)
+            break;
+        uint bin = indices.v[idx];
+        if (bin >= bins)
+            continue;
+        T w = hasWeights != 0u ? weights.v[idx] : T(1);
+#ifdef AGGREGATE
+        //combine invocations of the subgroup hitting the same bin, one bin
+        //after another, so only a single one issues the atomic
+        for (;;) {
+            uint first = subgroupBroadcastFirst(bin);
+            if (bin == first) {
+                T sum = subgroupAdd(w);
+                if (subgroupElect())
+                    accumulate(bin, sum);
+                break;
+            }
+        }
+#else
+        accumulate(bin, w);
+#endif
+    }
+
+#ifdef SHARED_BINS
+    //merge private bins
+    barrier();
+    for (uint b = t; b < bins; b += LOCAL_SIZE) {
+        T x = localBins[b];
+        if (x != T(0))
+            atomicAdd(hist.v[b], x);
+    }
+#endif
+}
+)";
+
+//sums the items of each bin per workgroup in a fixed order; workgroups loop
+//over multiple tiles to bound the amount of partial bins
+constexpr char PartialBinsSource[] = R"(
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer Words { uint v[]; };
+
+layout(push_constant) uniform Push {
+    Words indices;
+    Data weights;
+    Data partials;
+    uint count;
+    uint bins;
+    uint hasWeights;
+};
+
+shared uint tileBins[LOCAL_SIZE];
+
+void main() {
+    uint t = gl_LocalInvocationID.x;
+    uint tiles = (count + LOCAL_SIZE * ITEMS - 1u) / (LOCAL_SIZE * ITEMS);
+
+    //each thread owns a bin per block of LOCAL_SIZE bins and walks all
+    //items of the workgroup in order
+    for (uint first = 0u; first < bins; first += LOCAL_SIZE) {
+        uint b = first + t;
+        T sum = T(0);
+        for (uint tile = gl_WorkGroupID.x; tile < tiles; tile += gl_NumWorkGroups.x) {
+            for (uint i = 0u; i < ITEMS; ++i) {
+                uint idx = (tile * ITEMS + i) * LOCAL_SIZE + t;
+                bool valid = idx < count;
+                tileBins[t] = valid ? indices.v[idx] : 0xFFFFFFFFu;
+                sharedData[t] = valid && hasWeights != 0u ? weights.v[idx] : T(1);
+                barrier();
+                for (uint j = 0u; j < LOCAL_SIZE; ++j) {
+                    if (tileBins[j] == b)
+                        sum += sharedData[j];
+                }
+                barrier();
+            }
+        }
+        if (b < bins)
+            partials.v[gl_WorkGroupID.x * bins + b] = sum;
+    }
+}
+)";
+
+//adds the partial bins of all workgroups in order to the histogram
+constexpr char MergeBinsSource[] = R"(
+layout(push_constant) uniform Push {
+    Data partials;
+    Data hist;
+    uint bins;
+    uint groups;
+};
+
+void main() {
+    uint b = gl_GlobalInvocationID.x;
+    if (b >= bins)
+        return;
+    T sum = T(0);
+    for (uint g = 0u; g < groups; ++g)
+        sum += partials.v[g * bins + b];
+    hist.v[b] += sum;
+}
+)";
+
+//copies the items of a single column up to a count read on the device
+constexpr char CopyPrefixSource[] = R"(
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer Words { uint v[]; };
+
+layout(push_constant) uniform Push {
+    Words src;
+    Words dst;
+    Words srcCount;
+    Words dstCount;
+    uint capacity;
+    uint words;
+};
+
+void main() {
+    uint n = min(srcCount.v[0], capacity);
+    if (gl_GlobalInvocationID.x == 0u)
+        dstCount.v[0] = n;
+
+    //grid stride loop, as the amount of groups is fixed on the host
+    uint total = n * words;
+    uint stride = gl_NumWorkGroups.x * LOCAL_SIZE;
+    for (uint i = gl_GlobalInvocationID.x; i < total; i += stride)
+        dst.v[i] = src.v[i];
+}
+)";
+
+//compressed streams start with two header words, the amount of words and
+//the amount of packed non zero words, followed by a mask of the non zero
+//words per block of 32 words and the packed words themselves
+
+//writes the mask of each block, or reads it if decoding, and its popcount
+constexpr char BlockMaskSource[] = R"(
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer Words { uint v[]; };
+
+layout(push_constant) uniform Push {
+    Words words;
+    Words stream;
+    Words counts;
+    uint count;
+    uint decode;
+};
+
+void main() {
+    uint b = gl_GlobalInvocationID.x;
+    if (decode == 0u && b == 0u) {
+        stream.v[0] = count;
+        stream.v[1] = 0u;
+    }
+    uint blocks = (count + 31u) / 32u;
+    if (b >= blocks)
+        return;
+
+    uint mask = 0u;
+    if (decode != 0u) {
+        mask = stream.v[2u + b];
+    }
+    else {
+        uint base = b * 32u;
+        uint n = min(count - base, 32u);
+        for (uint i = 0u; i < n; ++i) {
+            if (words.v[base + i] != 0u)
+                mask |= 1u << i;
+        }
+        stream.v[2u + b] = mask;
+    }
+    counts.v[b] = uint(bitCount(mask));
+}
+)";
+
+//moves the non zero words between their position and the packed stream
+constexpr char PackSource[] = R"(
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer Words { uint v[]; };
+
+layout(push_constant) uniform Push {
+    Words words;
+    Words stream;
+    Words offsets;
+    uint count;
+    uint decode;
+    //size of the stream in words; guards against corrupted streams
+    uint limit;
+};
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i >= count)
+        return;
+
+    uint b = i / 32u;
+    uint bit = i % 32u;
+    uint mask = stream.v[2u + b];
+    bool set = (mask & (1u << bit)) != 0u;
+    uint packed = 2u + (count + 31u) / 32u + offsets.v[b] +
+        uint(bitCount(mask & ((1u << bit) - 1u)));
+    if (decode != 0u)
+        words.v[i] = set && packed < limit ? stream.v[packed] : 0u;
+    else if (set)
+        stream.v[packed] = words.v[i];
+}
+)";
+
+//writes the indirect dispatch arguments of the next pass of a chain
+//(does not use the common source)
+constexpr char IndirectArgsSource[] = R"(
+#extension GL_EXT_buffer_reference : require
+
+layout(local_size_x = 1) in;
+
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer Words { uint v[]; };
+
+layout(push_constant) uniform Push {
+    Words count;
+    Words args;
+    uint divisor;
+    uint maxGroups;
+};
+
+void main() {
+    uint n = count.v[0];
+    //round up without overflowing
+    uint groups = n / divisor + uint(n % divisor != 0u);
+    args.v[0] = min(groups, maxGroups);
+    args.v[1] = 1u;
+    args.v[2] = 1u;
+}
+)";
+
+/******************************************************************************/
+
+enum class Kernel {
+    SCAN,
+    REDUCE,
+    SCATTER,
+    HISTOGRAM,
+    DIGIT_SCAN,
+    ONESWEEP,
+    GATHER,
+    BINNING,
+    BINNING_SUBGROUP,
+    PARTIAL_BINS,
+    MERGE_BINS,
+    INDIRECT_ARGS,
+    BLOCK_MASK,
+    PACK,
+    COPY_PREFIX
+};
+
+struct ScanPush {
+    uint64_t input;
+    uint64_t output;
+    uint64_t state;
+    uint64_t total;
+    uint32_t count;
+    uint32_t mode;
+};
+constexpr uint32_t MODE_EXCLUSIVE = 1;
+constexpr uint32_t MODE_FLAGS = 2;
+constexpr uint32_t MODE_TOTAL = 4;
+
+struct ReducePush {
+    uint64_t input;
+    uint64_t output;
+    uint32_t count;
+    uint32_t padding;
+};
+
+struct ScatterPush {
+    uint64_t flags;
+    uint64_t offsets;
+    uint64_t src;
+    uint64_t dst;
+    uint32_t count;
+    uint32_t words;
+};
+
+struct HistogramPush {
+    uint64_t keys;
+    uint64_t hist;
+    uint64_t countPtr;
+    uint32_t count;
+    uint32_t keyWords;
+    uint32_t keyKind;
+    uint32_t flags;
+};
+
+struct DigitScanPush {
+    uint64_t hist;
+};
+
+struct OnesweepPush {
+    uint64_t keysIn;
+    uint64_t keysOut;
+    uint64_t valuesIn;
+    uint64_t valuesOut;
+    uint64_t offsets;
+    uint64_t state;
+    uint64_t countPtr;
+    uint32_t count;
+    uint32_t shift;
+    uint32_t keyWords;
+    uint32_t keyKind;
+    uint32_t valueWords;
+    uint32_t flags;
+};
+constexpr uint32_t KEY_SIGNED = 1;
+constexpr uint32_t KEY_FLOAT = 2;
+constexpr uint32_t FLAG_COUNT = 1;
+constexpr uint32_t FLAG_INDEX = 2;
+
+struct GatherPush {
+    uint64_t indices;
+    uint64_t src;
+    uint64_t dst;
+    uint64_t srcCount;
+    uint64_t dstCount;
+    uint32_t count;
+    uint32_t words;
+    uint32_t hasCount;
+    uint32_t padding;
+};
+
+struct IndirectArgsPush {
+    uint64_t count;
+    uint64_t args;
+    uint32_t divisor;
+    uint32_t maxGroups;
+};
+
+//indirect arguments of each pass are placed at this stride inside scratch
+constexpr uint64_t IndirectArgsStride = 16;
+
+struct BinningPush {
+    uint64_t indices;
+    uint64_t weights;
+    uint64_t hist;
+    uint32_t count;
+    uint32_t bins;
+    uint32_t hasWeights;
+    uint32_t padding;
+};
+
+struct MergeBinsPush {
+    uint64_t partials;
+    uint64_t hist;
+    uint32_t bins;
+    uint32_t groups;
+};
+
+//upper limit of groups summing partial bins; each loops over multiple tiles
+constexpr uint32_t MaxPartialGroups = 256;
+
+struct BlockMaskPush {
+    uint64_t words;
+    uint64_t stream;
+    uint64_t counts;
+    uint32_t count;
+    uint32_t decode;
+};
+
+struct PackPush {
+    uint64_t words;
+    uint64_t stream;
+    uint64_t offsets;
+    uint32_t count;
+    uint32_t decode;
+    uint32_t limit;
+    uint32_t padding;
+};
+
+struct CopyPrefixPush {
+    uint64_t src;
+    uint64_t dst;
+    uint64_t srcCount;
+    uint64_t dstCount;
+    uint32_t capacity;
+    uint32_t words;
+};
+
+//upper limit of groups copying a prefix; each loops over the remaining items
+constexpr uint32_t MaxCopyGroups = 1024;
+
+//header words of a compressed stream
+constexpr uint64_t CompressedHeaderWords = 2;
+
+//smallest private histogram compiled, avoiding a program per bin count
+constexpr uint32_t MinSharedBins = 256;
+
+//look-back stores counts next to their flags in a single word
+constexpr uint32_t MaxSortCount = 1u << 30;
+
+constexpr uint32_t DefaultLocalSize = 256;
+constexpr uint32_t DefaultItemsPerThread = 8;
+
+std::string getIdentity(ElementType type, ReduceOperation op) {
+    if (op == ReduceOperation::ADD)
+        return "T(0)";
+    bool isMin = op == ReduceOperation::MIN;
+    switch (type) {
+    case ElementType::INT32:
+        return isMin ? "2147483647" : "(-2147483647 - 1)";
+    case ElementType::UINT32:
+        return isMin ? "0xFFFFFFFFu" : "0u";
+    case ElementType::FLOAT32:
+        return isMin ? "uintBitsToFloat(0x7F800000u)" : "uintBitsToFloat(0xFF800000u)";
+    }
+    throw std::logic_error("Unknown element type!");
+}
+
+uint32_t divideCeil(uint64_t n, uint64_t d) {
+    return static_cast<uint32_t>((n + d - 1) / d);
+}
+
+uint32_t resolveCount(const Tensor<std::byte>& tensor, uint32_t count, uint32_t stride = 4) {
+    auto size = tensor.size_bytes() / stride;
+    if (count == std::numeric_limits<uint32_t>::max())
+        return static_cast<uint32_t>(std::min<uint64_t>(size, count));
+    if (count > size)
+        throw std::out_of_range("Count exceeds the size of the tensor!");
+    return count;
+}
+
+void checkColumns(std::span<const CompactColumn> columns,
+    const Tensor<std::byte>& src, const Tensor<std::byte>& dst, uint32_t count)
+{
+    for (auto& column : columns) {
+        if (column.stride == 0 || column.stride % 4 != 0 ||
+            column.srcOffset % 4 != 0 || column.dstOffset % 4 != 0)
+        {
+            throw std::logic_error("Columns must be aligned to 4 bytes!");
+        }
+        if (column.srcOffset + uint64_t(column.stride) * count > src.size_bytes() ||
+            column.dstOffset + uint64_t(column.stride) * count > dst.size_bytes())
+        {
+            throw std::out_of_range("Column exceeds the size of the tensor!");
+        }
+    }
+}
+
+uint32_t getKeyWords(SortKeyType type) {
+    switch (type) {
+    case SortKeyType::INT64:
+    case SortKeyType::UINT64:
+    case SortKeyType::FLOAT64:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+uint32_t getKeyKind(SortKeyType type) {
+    switch (type) {
+    case SortKeyType::INT32:
+    case SortKeyType::INT64:
+        return KEY_SIGNED;
+    case SortKeyType::FLOAT32:
+    case SortKeyType::FLOAT64:
+        return KEY_FLOAT;
+    default:
+        return 0;
+    }
+}
+
+}
+
+/***************************** PRIMITIVE COMMAND ******************************/
+
+struct PrimitiveCommand::State {
+    struct Step {
+        const Program* program;
+        uint32_t groups;
+        std::array<std::byte, 96> push;
+        uint32_t pushSize;
+        //dispatched instead if set; its arguments are written by a prior step
+        std::optional<DispatchIndirectCommand> indirect = std::nullopt;
+    };
+
+    ContextHandle context;
+    std::vector<Step> steps;
+    //tensors accessed via their address; declared to the hazard tracker
+    std::vector<std::reference_wrapper<const Tensor<std::byte>>> tensors;
+    //memory used between steps; the first clearSize bytes are zeroed first
+    std::optional<Tensor<std::byte>> scratch;
+    uint64_t clearSize = 0;
+
+    template<class T>
+    void add(const Program& program, uint32_t groups, const T& push) {
+        static_assert(sizeof(T) <= sizeof(Step::push));
+        Step step{ &program, groups, {}, sizeof(T) };
+        std::memcpy(step.push.data(), &push, sizeof(T));
+        steps.push_back(step);
+    }
+    void addIndirect(DispatchIndirectCommand dispatch) {
+        steps.push_back({ nullptr, 0, {}, 0, std::move(dispatch) });
+    }
+};
+
+void PrimitiveCommand::record(vulkan::Command& cmd) const {
+    auto& context = *state->context;
+
+    if (state->clearSize > 0) {
+        ClearTensorCommand(*state->scratch, { .offset = 0, .size = state->clearSize })
+            .record(cmd);
+    }
+
+    //tensors are accessed via their address and thus unknown to the dispatches
+    if (cmd.tracker) {
+        auto track = [&cmd](const Tensor<std::byte>& tensor) {
+            auto& buffer = tensor.getBuffer();
+            cmd.tracker->buffer(buffer.buffer, buffer.offset, tensor.size_bytes(),
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+        };
+        for (auto& tensor : state->tensors)
+            track(tensor);
+        if (state->scratch)
+            track(*state->scratch);
+        cmd.tracker->barrier(context, cmd);
+    }
+
+    //steps depend on each other
+    vulkan::GlobalBarrier barrier{
+        .srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+        .srcAccess = VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        .dstStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+        .dstAccess = VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR
+    };
+    //indirect steps additionally read their arguments written before
+    vulkan::GlobalBarrier indirectBarrier = barrier;
+    indirectBarrier.dstStage |= VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR;
+    indirectBarrier.dstAccess |= VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR;
+    for (auto i = 0u; i < state->steps.size(); ++i) {
+        auto& step = state->steps[i];
+        if (i > 0) {
+            vulkan::pipelineBarrier(context, cmd, {},
+                { step.indirect ? &indirectBarrier : &barrier, 1 });
+        }
+        if (step.indirect) {
+            step.indirect->record(cmd, false);
+            continue;
+        }
+        DispatchCommand(step.program->getProgram(), step.groups, 1, 1,
+            { step.push.data(), step.pushSize }).record(cmd);
+    }
+}
+
+PrimitiveCommand::PrimitiveCommand(const PrimitiveCommand&) = default;
+PrimitiveCommand& PrimitiveCommand::operator=(const PrimitiveCommand&) = default;
+
+PrimitiveCommand::PrimitiveCommand(PrimitiveCommand&&) noexcept = default;
+PrimitiveCommand& PrimitiveCommand::operator=(PrimitiveCommand&&) noexcept = default;
+
+PrimitiveCommand::PrimitiveCommand(std::shared_ptr<const State> state)
+    : state(std::move(state))
+{}
+PrimitiveCommand::~PrimitiveCommand() = default;
+
+/********************************* PRIMITIVES *********************************/
+
+struct Primitives::pImp {
+    ContextHandle context;
+    uint32_t localSize;
+    uint32_t items;
+    bool subgroups;
+    bool ballot;
+    bool shuffle;
+    bool deterministic;
+    //largest histogram privatized in shared memory
+    uint32_t maxSharedBins;
+    SubgroupRequirements subgroupRequirements;
+
+    //programs are compiled on first use
+    std::mutex mutex;
+    Compiler compiler;
+    std::map<std::tuple<Kernel, ElementType, ReduceOperation, uint32_t>,
+        std::unique_ptr<Program>> programs;
+
+    //sharedBins sizes the private histogram of binning kernels; zero if none
+    const Program& getProgram(Kernel kernel, ElementType type, ReduceOperation op,
+        uint32_t sharedBins = 0)
+    {
+        //scatter and sorting only handle words
+        bool binning = kernel == Kernel::BINNING || kernel == Kernel::BINNING_SUBGROUP;
+        bool merging = kernel == Kernel::PARTIAL_BINS || kernel == Kernel::MERGE_BINS;
+        if (kernel != Kernel::SCAN && kernel != Kernel::REDUCE && !binning && !merging)
+            type = ElementType::UINT32;
+        if (kernel != Kernel::SCAN && kernel != Kernel::REDUCE)
+            op = ReduceOperation::ADD;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto key = std::make_tuple(kernel, type, op, sharedBins);
+        auto it = programs.find(key);
+        if (it != programs.end())
+            return *it->second;
+
+        std::vector<std::pair<std::string, std::string>> defines;
+        switch (type) {
+        case ElementType::INT32:
+            defines.emplace_back("T", "int");
+            defines.emplace_back("TO_BITS(x)", "uint(x)");
+            defines.emplace_back("FROM_BITS(x)", "int(x)");
+            break;
+        case ElementType::UINT32:
+            defines.emplace_back("T", "uint");
+            defines.emplace_back("TO_BITS(x)", "(x)");
+            defines.emplace_back("FROM_BITS(x)", "(x)");
+            break;
+        case ElementType::FLOAT32:
+            defines.emplace_back("T", "float");
+            defines.emplace_back("TO_BITS(x)", "floatBitsToUint(x)");
+            defines.emplace_back("FROM_BITS(x)", "uintBitsToFloat(x)");
+            break;
+        }
+        defines.emplace_back("OP", std::to_string(static_cast<int>(op)));
+        defines.emplace_back("IDENTITY", getIdentity(type, op));
+        defines.emplace_back("LOCAL_SIZE", std::to_string(localSize));
+        defines.emplace_back("ITEMS", std::to_string(items));
+        if (subgroups)
+            defines.emplace_back("USE_SUBGROUPS", "1");
+        if (ballot && (kernel == Kernel::ONESWEEP || kernel == Kernel::BINNING_SUBGROUP))
+            defines.emplace_back("USE_BALLOT", "1");
+        if (binning && type == ElementType::FLOAT32)
+            defines.emplace_back("USE_ATOMIC_FLOAT", "1");
+        if (kernel == Kernel::BINNING_SUBGROUP)
+            defines.emplace_back("AGGREGATE", "1");
+        if (sharedBins > 0)
+            defines.emplace_back("SHARED_BINS", std::to_string(sharedBins));
+        if (deterministic && kernel == Kernel::REDUCE) {
+            defines.emplace_back("DETERMINISTIC", "1");
+            defines.emplace_back("TREE_SIZE", std::to_string(std::bit_ceil(localSize) / 2));
+            if (shuffle)
+                defines.emplace_back("USE_SHUFFLE", "1");
+        }
+        compiler.setOptions({ .defines = std::move(defines) });
+
+        std::string source = "#version 460\n";
+        if (kernel != Kernel::INDIRECT_ARGS)
+            source += CommonSource;
+        switch (kernel) {
+        case Kernel::SCAN: source += ScanSource; break;
+        case Kernel::REDUCE: source += ReduceSource; break;
+        case Kernel::SCATTER: source += ScatterSource; break;
+        case Kernel::HISTOGRAM:
+            source += SortCommonSource;
+            source += HistogramSource;
+            break;
+        case Kernel::DIGIT_SCAN:
+            source += SortCommonSource;
+            source += DigitScanSource;
+            break;
+        case Kernel::ONESWEEP:
+            source += SortCommonSource;
+            source += OnesweepSource;
+            break;
+        case Kernel::GATHER: source += GatherSource; break;
+        case Kernel::BINNING:
+        case Kernel::BINNING_SUBGROUP:
+            source += BinningSource;
+            break;
+        case Kernel::PARTIAL_BINS: source += PartialBinsSource; break;
+        case Kernel::MERGE_BINS: source += MergeBinsSource; break;
+        case Kernel::INDIRECT_ARGS: source += IndirectArgsSource; break;
+        case Kernel::BLOCK_MASK: source += BlockMaskSource; break;
+        case Kernel::PACK: source += PackSource; break;
+        case Kernel::COPY_PREFIX: source += CopyPrefixSource; break;
+        }
+        auto code = compiler.compile(source);
+
+        auto program = std::make_unique<Program>(context, code,
+            std::span<const std::byte>{}, subgroupRequirements);
+        auto& result = *program;
+        programs.emplace(key, std::move(program));
+        return result;
+    }
+
+    //appends a scan of the given range to the state
+    void scan(PrimitiveCommand::State& state,
+        uint64_t input, uint64_t output, uint64_t total,
+        uint32_t count, ElementType type, ReduceOperation op, uint32_t mode)
+    {
+        auto tiles = divideCeil(count, localSize * items);
+        //tile counter + (flag, aggregate, inclusive) per tile
+        state.clearSize = 4ull * (1ull + 3ull * tiles);
+        state.add(getProgram(Kernel::SCAN, type, op), tiles, ScanPush{
+            .input = input,
+            .output = output,
+            .state = state.scratch->address(),
+            .total = total,
+            .count = count,
+            .mode = mode
+        });
+    }
+
+    PrimitiveCommand scanCommand(
+        const Tensor<std::byte>& input, const Tensor<std::byte>& output,
+        ElementType type, ReduceOperation op, uint32_t count, bool exclusive)
+    {
+        count = resolveCount(input, count);
+        if (output.size_bytes() < 4ull * count)
+            throw std::logic_error("Output tensor is too small!");
+
+        auto state = std::make_shared<PrimitiveCommand::State>();
+        state->context = context;
+        state->tensors = { std::cref(input), std::cref(output) };
+        if (count > 0) {
+            auto tiles = divideCeil(count, localSize * items);
+            state->scratch.emplace(context, 4ull * (1ull + 3ull * tiles));
+            scan(*state, input.address(), output.address(), 0,
+                count, type, op, exclusive ? MODE_EXCLUSIVE : 0);
+        }
+        return PrimitiveCommand(std::move(state));
+    }
+
+    struct SortArgs {
+        //keys read by the first pass
+        uint64_t keys;
+        //keys written by the last pass; zero for scratch memory
+        uint64_t keysOut;
+        //values read by the first pass; unused if indices is true
+        uint64_t values;
+        //values written by the last pass; zero for scratch memory
+        uint64_t valuesOut;
+        uint32_t valueWords;
+        //if true, uses the index of each key as its value
+        bool indices;
+        //optional address of an uint32 limiting the amount of keys
+        uint64_t countPtr;
+    };
+
+    //appends a radix sort to the state and allocates its scratch memory;
+    //returns the address of the sorted values
+    uint64_t sort(PrimitiveCommand::State& state, const SortArgs& args,
+        SortKeyType type, uint32_t count)
+    {
+        auto keyWords = getKeyWords(type);
+        auto keyKind = getKeyKind(type);
+        auto valueWords = args.indices ? 1u : args.valueWords;
+        auto passes = 4u * keyWords;
+        auto tiles = divideCeil(count, localSize * items);
+        uint32_t flags = args.countPtr ? FLAG_COUNT : 0u;
+
+        //scratch: histograms, look-back state per pass, then ping-pong
+        //memory for keys and values
+        auto histSize = 4ull * 256ull * passes;
+        auto stateSize = 4ull * (1ull + 256ull * tiles);
+        auto keySize = 4ull * keyWords * count;
+        auto valueSize = 4ull * valueWords * count;
+        state.clearSize = histSize + passes * stateSize;
+        state.scratch.emplace(context, state.clearSize + 2 * keySize + 2 * valueSize);
+        auto hist = state.scratch->address();
+        auto keyTmp = hist + state.clearSize;
+        auto valueTmp = keyTmp + 2 * keySize;
+
+        state.add(getProgram(Kernel::HISTOGRAM, ElementType::UINT32, ReduceOperation::ADD),
+            tiles, HistogramPush{
+                .keys = args.keys,
+                .hist = hist,
+                .countPtr = args.countPtr,
+                .count = count,
+                .keyWords = keyWords,
+                .keyKind = keyKind,
+                .flags = flags
+            });
+        state.add(getProgram(Kernel::DIGIT_SCAN, ElementType::UINT32, ReduceOperation::ADD),
+            passes, DigitScanPush{ .hist = hist });
+
+        auto& onesweep = getProgram(Kernel::ONESWEEP, ElementType::UINT32, ReduceOperation::ADD);
+        uint64_t valuesOut = 0;
+        for (auto p = 0u; p < passes; ++p) {
+            bool last = p == passes - 1;
+            auto keysIn = p == 0 ? args.keys : keyTmp + ((p - 1) % 2) * keySize;
+            auto keysOut = last && args.keysOut ? args.keysOut : keyTmp + (p % 2) * keySize;
+            auto valuesIn = p == 0 ? args.values : valueTmp + ((p - 1) % 2) * valueSize;
+            valuesOut = last && args.valuesOut ? args.valuesOut : valueTmp + (p % 2) * valueSize;
+            state.add(onesweep, tiles, OnesweepPush{
+                .keysIn = keysIn,
+                .keysOut = keysOut,
+                .valuesIn = valuesIn,
+                .valuesOut = valuesOut,
+                .offsets = hist + 4ull * 256ull * p,
+                .state = hist + histSize + p * stateSize,
+                .countPtr = args.countPtr,
+                .count = count,
+                .shift = 8u * p,
+                .keyWords = keyWords,
+                .keyKind = keyKind,
+                .valueWords = valueWords,
+                .flags = flags | (p == 0 && args.indices ? FLAG_INDEX : 0u)
+            });
+        }
+        return valuesOut;
+    }
+
+    HistogramStrategy resolveStrategy(ElementType type, uint32_t binCount,
+        HistogramStrategy strategy) const
+    {
+        auto& atomics = getEnabledAtomics(context);
+        bool isFloat = type == ElementType::FLOAT32;
+        //integer bins are exact with atomics as well
+        if (strategy == HistogramStrategy::DETERMINISTIC ||
+            (strategy == HistogramStrategy::AUTO && deterministic && isFloat))
+        {
+            return HistogramStrategy::DETERMINISTIC;
+        }
+        if (isFloat && !atomics.bufferFloat32AtomicAdd)
+            throw std::logic_error("Float histograms require bufferFloat32AtomicAdd!");
+        bool fitsShared = binCount <= maxSharedBins &&
+            (!isFloat || atomics.sharedFloat32AtomicAdd);
+
+        switch (strategy) {
+        case HistogramStrategy::AUTO:
+            if (fitsShared)
+                return HistogramStrategy::SHARED;
+            return ballot ? HistogramStrategy::SUBGROUP : HistogramStrategy::GLOBAL;
+        case HistogramStrategy::SHARED:
+            if (!fitsShared)
+                throw std::logic_error("Histogram cannot be privatized in shared memory!");
+            return strategy;
+        case HistogramStrategy::SUBGROUP:
+            if (!ballot)
+                throw std::logic_error("Subgroup histograms require subgroup ballots!");
+            return strategy;
+        default:
+            return strategy;
+        }
+    }
+
+    pImp(ContextHandle context, const PrimitivesOptions& options)
+        : context(std::move(context))
+        , localSize(options.localSize)
+        , items(options.itemsPerThread ? options.itemsPerThread : DefaultItemsPerThread)
+        , subgroups(false)
+        , ballot(false)
+        , shuffle(false)
+        , deterministic(options.deterministic)
+        , maxSharedBins(0)
+        , subgroupRequirements()
+    {
+        auto info = getDeviceInfo(this->context);
+        auto props = getSubgroupProperties(this->context);
+        if (localSize == 0) {
+            localSize = std::min(DefaultLocalSize, info.maxWorkGroupInvocations);
+            //keep subgroups full
+            if (props.maxSubgroupSize > 0 && localSize >= props.maxSubgroupSize)
+                localSize -= localSize % props.maxSubgroupSize;
+        }
+        if (localSize > info.maxWorkGroupInvocations)
+            throw std::logic_error("Local size exceeds the device's limit!");
+
+        //subgroup totals must fit into a single subgroup
+        auto minSize = std::max(props.minSubgroupSize, 1u);
+        subgroups = options.useSubgroups &&
+            props.basicSupport && props.arithmeticSupport &&
+            localSize / minSize <= minSize;
+        ballot = subgroups && props.ballotSupport;
+        shuffle = options.useSubgroups && props.basicSupport && props.shuffleSupport;
+
+        //leave room for other shared memory and more than one workgroup per
+        //compute unit
+        maxSharedBins = std::bit_floor(info.maxSharedMemorySize / 8);
+        if (subgroups && props.fullSubgroupsSupport && localSize % props.maxSubgroupSize == 0)
+            subgroupRequirements.fullSubgroups = true;
+    }
+};
+
+uint32_t Primitives::getLocalSize() const noexcept {
+    return _pImp->localSize;
+}
+uint32_t Primitives::getTileSize() const noexcept {
+    return _pImp->localSize * _pImp->items;
+}
+bool Primitives::usesSubgroups() const noexcept {
+    return _pImp->subgroups;
+}
+bool Primitives::isDeterministic() const noexcept {
+    return _pImp->deterministic;
+}
+
+PrimitiveCommand Primitives::inclusiveScan(
+    const Tensor<std::byte>& input,
+    const Tensor<std::byte>& output,
+    ElementType type,
+    ReduceOperation op,
+    uint32_t count) const
+{
+    return _pImp->scanCommand(input, output, type, op, count, false);
+}
+
+PrimitiveCommand Primitives::exclusiveScan(
+    const Tensor<std::byte>& input,
+    const Tensor<std::byte>& output,
+    ElementType type,
+    ReduceOperation op,
+    uint32_t count) const
+{
+    return _pImp->scanCommand(input, output, type, op, count, true);
+}
+
+PrimitiveCommand Primitives::reduce(
+    const Tensor<std::byte>& input,
+    const Tensor<std::byte>& output,
+    ElementType type,
+    ReduceOperation op,
+    uint32_t count) const
+{
+    count = resolveCount(input, count);
+    if (count == 0)
+        throw std::logic_error("Cannot reduce an empty tensor!");
+    if (output.size_bytes() < 4)
+        throw std::logic_error("Output tensor is too small!");
+
+    auto state = std::make_shared<PrimitiveCommand::State>();
+    state->context = _pImp->context;
+    state->tensors = { std::cref(input), std::cref(output) };
+    auto& program = _pImp->getProgram(Kernel::REDUCE, type, op);
+    auto tile = getTileSize();
+
+    //partial results ping-pong between two halves of the scratch memory
+    auto first = divideCeil(count, tile);
+    auto second = first > 1 ? divideCeil(first, tile) : 0;
+    if (first > 1)
+        state->scratch.emplace(_pImp->context, 4ull * (first + second));
+    uint64_t halves[2] = { 0, 0 };
+    if (state->scratch) {
+        halves[0] = state->scratch->address();
+        halves[1] = halves[0] + 4ull * first;
+    }
+
+    auto src = input.address();
+    auto n = count;
+    for (auto pass = 0u; ; ++pass) {
+        auto groups = divideCeil(n, tile);
+        auto dst = groups == 1 ? output.address() : halves[pass % 2];
+        state->add(program, groups, ReducePush{
+            .input = src,
+            .output = dst,
+            .count = n
+        });
+        if (groups == 1)
+            break;
+        src = dst;
+        n = groups;
+    }
+
+    return PrimitiveCommand(std::move(state));
+}
+
+PrimitiveCommand Primitives::compact(
+    const Tensor<std::byte>& flags,
+    const Tensor<std::byte>& src,
+    const Tensor<std::byte>& dst,
+    std::span<const CompactColumn> columns,
+    uint32_t count,
+    const Tensor<std::byte>* countTensor,
+    uint64_t countOffset) const
+{
+    count = resolveCount(flags, count);
+    if (&src == &dst)
+        throw std::logic_error("Cannot compact a tensor in place!");
+    checkColumns(columns, src, dst, count);
+    if (countTensor && (countOffset % 4 != 0 || countOffset + 4 > countTensor->size_bytes()))
+        throw std::out_of_range("Count offset is out of range!");
+
+    auto state = std::make_shared<PrimitiveCommand::State>();
+    state->context = _pImp->context;
+    state->tensors = { std::cref(flags), std::cref(src), std::cref(dst) };
+    if (countTensor)
+        state->tensors.push_back(std::cref(*countTensor));
+    if (count == 0) {
+        //nothing to move, but the count must still be reset
+        if (countTensor) {
+            auto& program = _pImp->getProgram(Kernel::SCAN, ElementType::UINT32, ReduceOperation::ADD);
+            state->scratch.emplace(_pImp->context, 4ull);
+            state->clearSize = 4;
+            state->add(program, 1, ScanPush{
+                .input = flags.address(),
+                .output = flags.address(),
+                .state = state->scratch->address(),
+                .total = countTensor->address() + countOffset,
+                .count = 0,
+                .mode = MODE_TOTAL
+            });
+        }
+        return PrimitiveCommand(std::move(state));
+    }
+
+    //scratch: scan state followed by the offsets of each item
+    auto tiles = divideCeil(count, getTileSize());
+    auto stateSize = 4ull * (1ull + 3ull * tiles);
+    state->scratch.emplace(_pImp->context, stateSize + 4ull * count);
+    auto offsets = state->scratch->address() + stateSize;
+
+    //offsets are the exclusive scan of the flags
+    auto mode = MODE_EXCLUSIVE | MODE_FLAGS;
+    uint64_t total = 0;
+    if (countTensor) {
+        mode |= MODE_TOTAL;
+        total = countTensor->address() + countOffset;
+    }
+    _pImp->scan(*state, flags.address(), offsets, total,
+        count, ElementType::UINT32, ReduceOperation::ADD, mode);
+
+    //move columns
+    auto& scatter = _pImp->getProgram(Kernel::SCATTER, ElementType::UINT32, ReduceOperation::ADD);
+    auto groups = divideCeil(count, _pImp->localSize);
+    for (auto& column : columns) {
+        state->add(scatter, groups, ScatterPush{
+            .flags = flags.address(),
+            .offsets = offsets,
+            .src = src.address() + column.srcOffset,
+            .dst = dst.address() + column.dstOffset,
+            .count = count,
+            .words = column.stride / 4
+        });
+    }
+
+    return PrimitiveCommand(std::move(state));
+}
+
+PrimitiveCommand Primitives::sort(
+    const Tensor<std::byte>& keys,
+    SortKeyType type,
+    uint32_t count,
+    const Tensor<std::byte>* values,
+    uint32_t valueStride) const
+{
+    count = resolveCount(keys, count, 4 * getKeyWords(type));
+    if (count >= MaxSortCount)
+        throw std::out_of_range("Too many keys to sort!");
+    if (values) {
+        if (valueStride == 0 || valueStride % 4 != 0)
+            throw std::logic_error("Values must be aligned to 4 bytes!");
+        if (values->size_bytes() < uint64_t(valueStride) * count)
+            throw std::logic_error("Values tensor is too small!");
+    }
+
+    auto state = std::make_shared<PrimitiveCommand::State>();
+    state->context = _pImp->context;
+    state->tensors = { std::cref(keys) };
+    if (values)
+        state->tensors.push_back(std::cref(*values));
+    if (count > 0) {
+        _pImp->sort(*state, {
+            .keys = keys.address(),
+            .keysOut = keys.address(),
+            .values = values ? values->address() : 0,
+            .valuesOut = values ? values->address() : 0,
+            .valueWords = values ? valueStride / 4 : 0,
+            .indices = false,
+            .countPtr = 0
+        }, type, count);
+    }
+    return PrimitiveCommand(std::move(state));
+}
+
+PrimitiveCommand Primitives::sortIndices(
+    const Tensor<std::byte>& keys,
+    const Tensor<std::byte>& indices,
+    SortKeyType type,
+    uint32_t count) const
+{
+    count = resolveCount(keys, count, 4 * getKeyWords(type));
+    if (count >= MaxSortCount)
+        throw std::out_of_range("Too many keys to sort!");
+    if (indices.size_bytes() < 4ull * count)
+        throw std::logic_error("Indices tensor is too small!");
+
+    auto state = std::make_shared<PrimitiveCommand::State>();
+    state->context = _pImp->context;
+    state->tensors = { std::cref(keys), std::cref(indices) };
+    if (count > 0) {
+        _pImp->sort(*state, {
+            .keys = keys.address(),
+            .keysOut = 0,
+            .values = 0,
+            .valuesOut = indices.address(),
+            .valueWords = 1,
+            .indices = true,
+            .countPtr = 0
+        }, type, count);
+    }
+    return PrimitiveCommand(std::move(state));
+}
+
+PrimitiveCommand Primitives::sortColumns(
+    const Tensor<std::byte>& src,
+    const Tensor<std::byte>& dst,
+    SortKeyType type,
+    uint64_t keyOffset,
+    std::span<const CompactColumn> columns,
+    uint32_t count,
+    std::optional<uint64_t> countOffset) const
+{
+    if (&src == &dst)
+        throw std::logic_error("Cannot sort columns in place!");
+    if (count >= MaxSortCount)
+        throw std::out_of_range("Too many items to sort!");
+    if (keyOffset % 4 != 0)
+        throw std::logic_error("Key column must be aligned to 4 bytes!");
+    if (keyOffset + 4ull * getKeyWords(type) * count > src.size_bytes())
+        throw std::out_of_range("Key column exceeds the size of the tensor!");
+    checkColumns(columns, src, dst, count);
+    if (countOffset && (*countOffset % 4 != 0 ||
+        *countOffset + 4 > src.size_bytes() || *countOffset + 4 > dst.size_bytes()))
+    {
+        throw std::out_of_range("Count offset is out of range!");
+    }
+
+    auto state = std::make_shared<PrimitiveCommand::State>();
+    state->context = _pImp->context;
+    state->tensors = { std::cref(src), std::cref(dst) };
+    if (count == 0 && !countOffset)
+        return PrimitiveCommand(std::move(state));
+
+    //sort indices, then gather each column
+    uint64_t srcCount = countOffset ? src.address() + *countOffset : 0;
+    uint64_t indices = 0;
+    if (count > 0) {
+        indices = _pImp->sort(*state, {
+            .keys = src.address() + keyOffset,
+            .keysOut = 0,
+            .values = 0,
+            .valuesOut = 0,
+            .valueWords = 1,
+            .indices = true,
+            .countPtr = srcCount
+        }, type, count);
+    }
+
+    auto& gather = _pImp->getProgram(Kernel::GATHER, ElementType::UINT32, ReduceOperation::ADD);
+    //always run a group, so the count gets written
+    auto groups = std::max(divideCeil(count, _pImp->localSize), 1u);
+    for (auto& column : columns) {
+        state->add(gather, groups, GatherPush{
+            .indices = indices,
+            .src = src.address() + column.srcOffset,
+            .dst = dst.address() + column.dstOffset,
+            .srcCount = srcCount,
+            .dstCount = countOffset ? dst.address() + *countOffset : 0,
+            .count = count,
+            .words = column.stride / 4,
+            .hasCount = countOffset ? 1u : 0u
+        });
+    }
+    return PrimitiveCommand(std::move(state));
+}
+
+HistogramStrategy Primitives::getHistogramStrategy(
+    ElementType type, uint32_t binCount, HistogramStrategy strategy) const
+{
+    return _pImp->resolveStrategy(type, binCount, strategy);
+}
+
+PrimitiveCommand Primitives::histogram(
+    const Tensor<std::byte>& indices,
+    const Tensor<std::byte>& histogram,
+    ElementType type,
+    const Tensor<std::byte>* weights,
+    uint32_t count,
+    HistogramStrategy strategy) const
+{
+    count = resolveCount(indices, count);
+    if (weights && weights->size_bytes() < 4ull * count)
+        throw std::logic_error("Weights tensor is too small!");
+    auto bins = static_cast<uint32_t>(std::min<uint64_t>(
+        histogram.size_bytes() / 4, std::numeric_limits<uint32_t>::max()));
+    if (bins == 0)
+        throw std::logic_error("Histogram has no bins!");
+    strategy = _pImp->resolveStrategy(type, bins, strategy);
+
+    auto state = std::make_shared<PrimitiveCommand::State>();
+    state->context = _pImp->context;
+    state->tensors = { std::cref(indices), std::cref(histogram) };
+    if (weights)
+        state->tensors.push_back(std::cref(*weights));
+    if (count == 0)
+        return PrimitiveCommand(std::move(state));
+
+    if (strategy == HistogramStrategy::DETERMINISTIC) {
+        //partial bins of each group are merged in order by a second pass
+        auto groups = std::min(divideCeil(count, getTileSize()), MaxPartialGroups);
+        state->scratch.emplace(_pImp->context, 4ull * groups * bins);
+        auto partials = state->scratch->address();
+        state->add(_pImp->getProgram(Kernel::PARTIAL_BINS, type, ReduceOperation::ADD),
+            groups, BinningPush{
+                .indices = indices.address(),
+                .weights = weights ? weights->address() : 0,
+                .hist = partials,
+                .count = count,
+                .bins = bins,
+                .hasWeights = weights ? 1u : 0u
+            });
+        state->add(_pImp->getProgram(Kernel::MERGE_BINS, type, ReduceOperation::ADD),
+            divideCeil(bins, getLocalSize()), MergeBinsPush{
+                .partials = partials,
+                .hist = histogram.address(),
+                .bins = bins,
+                .groups = groups
+            });
+        return PrimitiveCommand(std::move(state));
+    }
+
+    //round private histograms up to limit the amount of programs
+    uint32_t sharedBins = 0;
+    auto& atomics = getEnabledAtomics(_pImp->context);
+    if (strategy == HistogramStrategy::SHARED ||
+        (strategy == HistogramStrategy::SUBGROUP && bins <= _pImp->maxSharedBins &&
+            (type != ElementType::FLOAT32 || atomics.sharedFloat32AtomicAdd)))
+    {
+        sharedBins = std::min(std::bit_ceil(std::max(bins, MinSharedBins)), _pImp->maxSharedBins);
+    }
+    auto kernel = strategy == HistogramStrategy::SUBGROUP ?
+        Kernel::BINNING_SUBGROUP : Kernel::BINNING;
+    auto& program = _pImp->getProgram(kernel, type, ReduceOperation::ADD, sharedBins);
+
+    state->add(program, divideCeil(count, getTileSize()), BinningPush{
+        .indices = indices.address(),
+        .weights = weights ? weights->address() : 0,
+        .hist = histogram.address(),
+        .count = count,
+        .bins = bins,
+        .hasWeights = weights ? 1u : 0u
+    });
+    return PrimitiveCommand(std::move(state));
+}
+
+PrimitiveCommand Primitives::indirectChain(std::span<const IndirectPass> passes) const {
+    auto state = std::make_shared<PrimitiveCommand::State>();
+    state->context = _pImp->context;
+    if (passes.empty())
+        return PrimitiveCommand(std::move(state));
+
+    auto& fixup = _pImp->getProgram(Kernel::INDIRECT_ARGS,
+        ElementType::UINT32, ReduceOperation::ADD);
+    auto limit = _pImp->context->maxWorkGroupCount[0];
+    state->scratch.emplace(_pImp->context, IndirectArgsStride * passes.size());
+    for (auto i = 0u; i < passes.size(); ++i) {
+        auto& pass = passes[i];
+        auto& count = pass.count.get();
+        if (pass.countOffset % 4 != 0 || pass.countOffset + 4 > count.size_bytes())
+            throw std::out_of_range("Count offset is out of range!");
+        auto divisor = pass.itemsPerGroup;
+        if (divisor == 0)
+            divisor = pass.program.get().getLocalSize().x;
+        state->tensors.push_back(pass.count);
+
+        auto argsOffset = IndirectArgsStride * i;
+        state->add(fixup, 1, IndirectArgsPush{
+            .count = count.address() + pass.countOffset,
+            .args = state->scratch->address() + argsOffset,
+            .divisor = divisor,
+            .maxGroups = std::min(pass.maxGroups, limit)
+        });
+        state->addIndirect(DispatchIndirectCommand(pass.program.get().getProgram(),
+            *state->scratch, argsOffset, pass.pushData));
+    }
+
+    return PrimitiveCommand(std::move(state));
+}
+
+PrimitiveCommand Primitives::copyPrefix(
+    const Tensor<std::byte>& src,
+    const Tensor<std::byte>& dst,
+    uint64_t countOffset,
+    std::span<const CompactColumn> columns,
+    uint32_t capacity) const
+{
+    if (&src == &dst)
+        throw std::logic_error("Cannot copy a prefix onto itself!");
+    checkColumns(columns, src, dst, capacity);
+    if (countOffset % 4 != 0 || countOffset + 4 > src.size_bytes() || countOffset + 4 > dst.size_bytes())
+        throw std::out_of_range("Count offset is out of range!");
+    for (auto& column : columns) {
+        if (uint64_t(capacity) * (column.stride / 4) > std::numeric_limits<uint32_t>::max())
+            throw std::out_of_range("Column exceeds the amount of words a prefix can copy!");
+    }
+
+    auto state = std::make_shared<PrimitiveCommand::State>();
+    state->context = _pImp->context;
+    state->tensors = { std::cref(src), std::cref(dst) };
+
+    //always run a group, so the count gets written
+    auto& copy = _pImp->getProgram(Kernel::COPY_PREFIX, ElementType::UINT32, ReduceOperation::ADD);
+    auto maxGroups = std::min(MaxCopyGroups, _pImp->context->maxWorkGroupCount[0]);
+    for (auto& column : columns) {
+        auto words = column.stride / 4;
+        auto groups = std::clamp(divideCeil(uint64_t(capacity) * words, _pImp->localSize), 1u, maxGroups);
+        state->add(copy, groups, CopyPrefixPush{
+            .src = src.address() + column.srcOffset,
+            .dst = dst.address() + column.dstOffset,
+            .srcCount = src.address() + countOffset,
+            .dstCount = dst.address() + countOffset,
+            .capacity = capacity,
+            .words = words
+        });
+    }
+    return PrimitiveCommand(std::move(state));
+}
+
+PrimitiveCommand Primitives::compress(
+    const Tensor<std::byte>& input,
+    const Tensor<std::byte>& output,
+    uint32_t count) const
+{
+    count = resolveCount(input, count);
+    if (&input == &output)
+        throw std::logic_error("Cannot compress a tensor in place!");
+    if (output.size_bytes() < getMaxCompressedSize(count))
+        throw std::logic_error("Output tensor is too small!");
+
+    auto state = std::make_shared<PrimitiveCommand::State>();
+    state->context = _pImp->context;
+    state->tensors = { std::cref(input), std::cref(output) };
+
+    //scratch: scan state followed by the popcount of each block, which gets
+    //scanned in place into the offsets of their packed words
+    auto blocks = divideCeil(count, 32);
+    auto tiles = divideCeil(blocks, getTileSize());
+    auto stateSize = 4ull * (1ull + 3ull * tiles);
+    uint64_t counts = 0;
+    if (count > 0) {
+        state->scratch.emplace(_pImp->context, stateSize + 4ull * blocks);
+        counts = state->scratch->address() + stateSize;
+    }
+
+    //always run a group, so the header gets written
+    auto& mask = _pImp->getProgram(Kernel::BLOCK_MASK, ElementType::UINT32, ReduceOperation::ADD);
+    state->add(mask, std::max(divideCeil(blocks, _pImp->localSize), 1u), BlockMaskPush{
+        .words = input.address(),
+        .stream = output.address(),
+        .counts = counts,
+        .count = count,
+        .decode = 0
+    });
+    if (count == 0)
+        return PrimitiveCommand(std::move(state));
+
+    //total amount of packed words goes into the header
+    _pImp->scan(*state, counts, counts, output.address() + 4,
+        blocks, ElementType::UINT32, ReduceOperation::ADD, MODE_EXCLUSIVE | MODE_TOTAL);
+
+    auto& pack = _pImp->getProgram(Kernel::PACK, ElementType::UINT32, ReduceOperation::ADD);
+    state->add(pack, divideCeil(count, _pImp->localSize), PackPush{
+        .words = input.address(),
+        .stream = output.address(),
+        .offsets = counts,
+        .count = count,
+        .decode = 0,
+        .limit = 0
+    });
+    return PrimitiveCommand(std::move(state));
+}
+
+PrimitiveCommand Primitives::decompress(
+    const Tensor<std::byte>& input,
+    const Tensor<std::byte>& output,
+    uint32_t count) const
+{
+    count = resolveCount(output, count);
+    if (&input == &output)
+        throw std::logic_error("Cannot decompress a tensor in place!");
+    auto blocks = divideCeil(count, 32);
+    if (input.size_bytes() < 4ull * (CompressedHeaderWords + blocks))
+        throw std::logic_error("Input tensor is too small!");
+
+    auto state = std::make_shared<PrimitiveCommand::State>();
+    state->context = _pImp->context;
+    state->tensors = { std::cref(input), std::cref(output) };
+    if (count == 0)
+        return PrimitiveCommand(std::move(state));
+
+    auto tiles = divideCeil(blocks, getTileSize());
+    auto stateSize = 4ull * (1ull + 3ull * tiles);
+    state->scratch.emplace(_pImp->context, stateSize + 4ull * blocks);
+    auto counts = state->scratch->address() + stateSize;
+
+    auto& mask = _pImp->getProgram(Kernel::BLOCK_MASK, ElementType::UINT32, ReduceOperation::ADD);
+    state->add(mask, divideCeil(blocks, _pImp->localSize), BlockMaskPush{
+        .words = 0,
+        .stream = input.address(),
+        .counts = counts,
+        .count = count,
+        .decode = 1
+    });
+    _pImp->scan(*state, counts, counts, 0,
+        blocks, ElementType::UINT32, ReduceOperation::ADD, MODE_EXCLUSIVE);
+
+    auto& pack = _pImp->getProgram(Kernel::PACK, ElementType::UINT32, ReduceOperation::ADD);
+    state->add(pack, divideCeil(count, _pImp->localSize), PackPush{
+        .words = output.address(),
+        .stream = input.address(),
+        .offsets = counts,
+        .count = count,
+        .decode = 1,
+        .limit = static_cast<uint32_t>(std::min<uint64_t>(
+            input.size_bytes() / 4, std::numeric_limits<uint32_t>::max()))
+    });
+    return PrimitiveCommand(std::move(state));
+}
+
+Primitives::Primitives(Primitives&& other) noexcept = default;
+Primitives& Primitives::operator=(Primitives&& other) noexcept = default;
+
+Primitives::Primitives(ContextHandle context, const PrimitivesOptions& options)
+    : _pImp(std::make_unique<pImp>(std::move(context), options))
+{}
+Primitives::~Primitives() = default;
+
+/******************************** COMPRESSION *********************************/
+
+namespace {
+
+//streams may live in unaligned memory
+uint32_t loadWord(const std::byte* ptr) {
+    uint32_t word;
+    std::memcpy(&word, ptr, 4);
+    return word;
+}
+void storeWord(std::byte* ptr, uint32_t word) {
+    std::memcpy(ptr, &word, 4);
+}
+
+uint64_t checkHeader(std::span<const std::byte> stream, uint32_t& count, uint32_t& packed) {
+    if (stream.size() < 4 * CompressedHeaderWords)
+        throw std::logic_error("Compressed stream is too small!");
+    count = loadWord(stream.data());
+    packed = loadWord(stream.data() + 4);
+    if (packed > count)
+        throw std::logic_error("Compressed stream is corrupted!");
+    return 4ull * (CompressedHeaderWords + divideCeil(count, 32) + packed);
+}
+
+}
+
+uint64_t getCompressedSize(std::span<const std::byte> stream) {
+    uint32_t count, packed;
+    return checkHeader(stream, count, packed);
+}
+
+uint64_t getDecompressedSize(std::span<const std::byte> stream) {
+    uint32_t count, packed;
+    checkHeader(stream, count, packed);
+    return 4ull * count;
+}
+
+std::vector<std::byte> compressData(std::span<const std::byte> data) {
+    if (data.size() % 4 != 0)
+        throw std::logic_error("Data must consist of whole 32 bit words!");
+    if (data.size() / 4 > std::numeric_limits<uint32_t>::max())
+        throw std::out_of_range("Data is too large to compress!");
+    auto count = static_cast<uint32_t>(data.size() / 4);
+    auto blocks = divideCeil(count, 32);
+
+    std::vector<std::byte> stream(getMaxCompressedSize(count));
+    auto masks = stream.data() + 4 * CompressedHeaderWords;
+    auto packed = masks + 4ull * blocks;
+    auto out = packed;
+    for (auto b = 0u; b < blocks; ++b) {
+        auto n = std::min(count - 32 * b, 32u);
+        auto src = data.data() + 128ull * b;
+        uint32_t mask = 0;
+        for (auto i = 0u; i < n; ++i) {
+            auto word = loadWord(src + 4 * i);
+            if (word != 0) {
+                mask |= 1u << i;
+                storeWord(out, word);
+                out += 4;
+            }
+        }
+        storeWord(masks + 4 * b, mask);
+    }
+
+    storeWord(stream.data(), count);
+    storeWord(stream.data() + 4, static_cast<uint32_t>((out - packed) / 4));
+    stream.resize(out - stream.data());
+    return stream;
+}
+
+void decompressData(std::span<const std::byte> stream, std::span<std::byte> data) {
+    uint32_t count, packedCount;
+    auto size = checkHeader(stream, count, packedCount);
+    if (stream.size() < size)
+        throw std::logic_error("Compressed stream is truncated!");
+    if (data.size() < 4ull * count)
+        throw std::logic_error("Destination is too small!");
+
+    auto blocks = divideCeil(count, 32);
+    auto masks = stream.data() + 4 * CompressedHeaderWords;
+    auto packed = masks + 4ull * blocks;
+    auto end = packed + 4ull * packedCount;
+    for (auto b = 0u; b < blocks; ++b) {
+        auto n = std::min(count - 32 * b, 32u);
+        auto dst = data.data() + 128ull * b;
+        auto mask = loadWord(masks + 4 * b);
+        if (n < 32 && (mask >> n) != 0)
+            throw std::logic_error("Compressed stream is corrupted!");
+        //sparse and dense blocks take fast paths
+        if (mask == 0) {
+            std::memset(dst, 0, 4 * n);
+            continue;
+        }
+        auto words = static_cast<uint32_t>(std::popcount(mask));
+        if (words > (end - packed) / 4)
+            throw std::logic_error("Compressed stream is corrupted!");
+        if (words == n) {
+            std::memcpy(dst, packed, 4 * n);
+            packed += 4 * n;
+            continue;
+        }
+        std::memset(dst, 0, 4 * n);
+        for (; mask != 0; mask &= mask - 1) {
+            auto i = std::countr_zero(mask);
+            std::memcpy(dst + 4 * i, packed, 4);
+            packed += 4;
+        }
+    }
+}
+
+}
@@ -2,16 +2,37 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cctype>
 #include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <map>
+#include <mutex>
+#include <numeric>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
 
 #include "volk.h"
 #include "spirv_reflect.h"
 
+#include "hephaistos/compiler.hpp"
+#include "hephaistos/debug.hpp"
+#include "hephaistos/raytracing.hpp"
+#include "vk/hazard.hpp"
+#include "vk/layout.hpp"
 #include "vk/result.hpp"
 #include "vk/types.hpp"
+#include "vk/util.hpp"
 
 namespace hephaistos {
 
@@ -28,23 +49,42 @@ SubgroupProperties getSubgroupProperties(VkPhysicalDevice device) {
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_MAXIMAL_RECONVERGENCE_FEATURES_KHR,
         .pNext = &controlFlow
     };
+    VkPhysicalDeviceSubgroupSizeControlFeaturesEXT sizeControl{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_FEATURES_EXT,
+        .pNext = &reconvergence
+    };
     VkPhysicalDeviceFeatures2 features{
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
-        .pNext = &reconvergence
+        .pNext = &sizeControl
     };
     vkGetPhysicalDeviceFeatures2(device, &features);
+    VkPhysicalDeviceSubgroupSizeControlPropertiesEXT sizeProps{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_SIZE_CONTROL_PROPERTIES_EXT
+    };
     VkPhysicalDeviceSubgroupProperties subgroupProps{
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES,
+        .pNext = &sizeProps
     };
     VkPhysicalDeviceProperties2 props{
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
         .pNext = &subgroupProps
     };
     vkGetPhysicalDeviceProperties2(device, &props);
+    //without size control the size is fixed
+    auto sizeControlSupport = sizeControl.subgroupSizeControl == VK_TRUE;
+    if (!sizeControlSupport) {
+        sizeProps.minSubgroupSize = subgroupProps.subgroupSize;
+        sizeProps.maxSubgroupSize = subgroupProps.subgroupSize;
+    }
 
     //build struct
     return SubgroupProperties{
         .subgroupSize            = subgroupProps.subgroupSize,
+        .minSubgroupSize         = sizeProps.minSubgroupSize,
+        .maxSubgroupSize         = sizeProps.maxSubgroupSize,
+        .requiredSubgroupSizeSupport = sizeControlSupport &&
+            (sizeProps.requiredSubgroupSizeStages & VK_SHADER_STAGE_COMPUTE_BIT) != 0,
+        .fullSubgroupsSupport    = sizeControlSupport && sizeControl.computeFullSubgroups == VK_TRUE,
         .basicSupport            = !!(subgroupProps.supportedOperations & VK_SUBGROUP_FEATURE_BASIC_BIT),
         .voteSupport             = !!(subgroupProps.supportedOperations & VK_SUBGROUP_FEATURE_VOTE_BIT),
         .arithmeticSupport       = !!(subgroupProps.supportedOperations & VK_SUBGROUP_FEATURE_ARITHMETIC_BIT),
@@ -67,20 +107,402 @@ SubgroupProperties getSubgroupProperties(const ContextHandle& context) {
     return getSubgroupProperties(context->physicalDevice);
 }
 
+/****************************** DESCRIPTOR BUFFER *****************************/
+
+namespace {
+
+constexpr auto DescriptorBufferExtensionName = "DescriptorBuffer";
+
+//! MUST BE SORTED FOR std::includes !//
+constexpr auto DescriptorBufferDeviceExtensions = std::to_array({
+    VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME
+});
+
+bool isDescriptorBufferEnabled(const vulkan::Context& context) {
+    //to shorten things
+    auto& ext = *context.extensions;
+    return std::find_if(ext.begin(), ext.end(),
+        [](const ExtensionHandle& h) -> bool {
+            return h->getExtensionName() == DescriptorBufferExtensionName;
+        }) != ext.end();
+}
+
+}
+
+bool isDescriptorBufferSupported(const DeviceHandle& device) {
+    //nullcheck
+    if (!device)
+        return false;
+
+    //Check extension support
+    if (!std::includes(
+        device->supportedExtensions.begin(),
+        device->supportedExtensions.end(),
+        DescriptorBufferDeviceExtensions.begin(),
+        DescriptorBufferDeviceExtensions.end()))
+    {
+        return false;
+    }
+
+    //Query features; the extension depends on synchronization2
+    VkPhysicalDeviceSynchronization2FeaturesKHR sync2{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR
+    };
+    VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptorFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+        .pNext = &sync2
+    };
+    VkPhysicalDeviceFeatures2 features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &descriptorFeatures
+    };
+    vkGetPhysicalDeviceFeatures2(device->device, &features);
+
+    return descriptorFeatures.descriptorBuffer == VK_TRUE &&
+        sync2.synchronization2 == VK_TRUE;
+}
+bool isDescriptorBufferEnabled(const ContextHandle& context) {
+    return isDescriptorBufferEnabled(*context);
+}
+
+class DescriptorBufferExtension : public Extension {
+public:
+    bool isDeviceSupported(const DeviceHandle& device) const override {
+        return isDescriptorBufferSupported(device);
+    }
+    std::string_view getExtensionName() const override {
+        return DescriptorBufferExtensionName;
+    }
+    std::span<const char* const> getDeviceExtensions() const override {
+        return DescriptorBufferDeviceExtensions;
+    }
+    void* chain(void* pNext) override {
+        descriptorFeatures.pNext = pNext;
+        return static_cast<void*>(&descriptorFeatures);
+    }
+
+    DescriptorBufferExtension() = default;
+    virtual ~DescriptorBufferExtension() = default;
+
+private:
+    VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptorFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+        .descriptorBuffer = VK_TRUE
+    };
+};
+ExtensionHandle createDescriptorBufferExtension() {
+    return std::make_unique<DescriptorBufferExtension>();
+}
+
+/******************************** SHADER OBJECT *******************************/
+
+namespace {
+
+constexpr auto ShaderObjectExtensionName = "ShaderObject";
+
+//shader objects depend on dynamic rendering, which is core only since 1.3
+//! MUST BE SORTED FOR std::includes !//
+constexpr auto ShaderObjectDeviceExtensions = std::to_array({
+    VK_EXT_SHADER_OBJECT_EXTENSION_NAME,
+    VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME
+});
+
+bool isShaderObjectEnabled(const vulkan::Context& context) {
+    //to shorten things
+    auto& ext = *context.extensions;
+    return std::find_if(ext.begin(), ext.end(),
+        [](const ExtensionHandle& h) -> bool {
+            return h->getExtensionName() == ShaderObjectExtensionName;
+        }) != ext.end();
+}
+
+}
+
+bool isShaderObjectSupported(const DeviceHandle& device) {
+    //nullcheck
+    if (!device)
+        return false;
+
+    //Check extension support
+    if (!std::includes(
+        device->supportedExtensions.begin(),
+        device->supportedExtensions.end(),
+        ShaderObjectDeviceExtensions.begin(),
+        ShaderObjectDeviceExtensions.end()))
+    {
+        return false;
+    }
+
+    //Query features
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR renderingFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR
+    };
+    VkPhysicalDeviceShaderObjectFeaturesEXT objectFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT,
+        .pNext = &renderingFeatures
+    };
+    VkPhysicalDeviceFeatures2 features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &objectFeatures
+    };
+    vkGetPhysicalDeviceFeatures2(device->device, &features);
+
+    return objectFeatures.shaderObject == VK_TRUE &&
+        renderingFeatures.dynamicRendering == VK_TRUE;
+}
+bool isShaderObjectEnabled(const ContextHandle& context) {
+    return isShaderObjectEnabled(*context);
+}
+
+class ShaderObjectExtension : public Extension {
+public:
+    bool isDeviceSupported(const DeviceHandle& device) const override {
+        return isShaderObjectSupported(device);
+    }
+    std::string_view getExtensionName() const override {
+        return ShaderObjectExtensionName;
+    }
+    std::span<const char* const> getDeviceExtensions() const override {
+        return ShaderObjectDeviceExtensions;
+    }
+    void* chain(void* pNext) override {
+        renderingFeatures.pNext = pNext;
+        return static_cast<void*>(&objectFeatures);
+    }
+
+    ShaderObjectExtension() = default;
+    virtual ~ShaderObjectExtension() = default;
+
+private:
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR renderingFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
+        .dynamicRendering = VK_TRUE
+    };
+    VkPhysicalDeviceShaderObjectFeaturesEXT objectFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT,
+        .pNext = &renderingFeatures,
+        .shaderObject = VK_TRUE
+    };
+};
+ExtensionHandle createShaderObjectExtension() {
+    return std::make_unique<ShaderObjectExtension>();
+}
+
+/******************************* RESOURCE HEAP ********************************/
+
+namespace {
+
+constexpr auto ResourceHeapExtensionName = "ResourceHeap";
+
+//descriptor indexing is core since Vulkan 1.2 -> no device extensions
+class ResourceHeapExtension : public Extension {
+public:
+    bool isDeviceSupported(const DeviceHandle& device) const override {
+        if (!isResourceHeapSupported(device))
+            return false;
+
+        //check the heap fits into the limits
+        VkPhysicalDeviceDescriptorIndexingProperties indexingProps{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES
+        };
+        VkPhysicalDeviceProperties2 props{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &indexingProps
+        };
+        vkGetPhysicalDeviceProperties2(device->device, &props);
+        return
+            indexingProps.maxPerStageDescriptorUpdateAfterBindStorageBuffers >= capacity &&
+            indexingProps.maxPerStageDescriptorUpdateAfterBindStorageImages >= capacity &&
+            indexingProps.maxPerStageDescriptorUpdateAfterBindSampledImages >= capacity &&
+            indexingProps.maxPerStageDescriptorUpdateAfterBindSamplers >= capacity &&
+            indexingProps.maxPerStageUpdateAfterBindResources >= 3ull * capacity;
+    }
+    std::string_view getExtensionName() const override {
+        return ResourceHeapExtensionName;
+    }
+    std::span<const char* const> getDeviceExtensions() const override {
+        return {};
+    }
+    void* chain(void* pNext) override {
+        indexingFeatures.pNext = pNext;
+        return static_cast<void*>(&indexingFeatures);
+    }
+
+    uint32_t getCapacity() const noexcept {
+        return capacity;
+    }
+
+    explicit ResourceHeapExtension(uint32_t capacity)
+        : capacity(capacity)
+    {}
+    virtual ~ResourceHeapExtension() = default;
+
+private:
+    uint32_t capacity;
+    VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES,
+        .shaderSampledImageArrayNonUniformIndexing = VK_TRUE,
+        .shaderStorageBufferArrayNonUniformIndexing = VK_TRUE,
+        .shaderStorageImageArrayNonUniformIndexing = VK_TRUE,
+        .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+        .descriptorBindingStorageImageUpdateAfterBind = VK_TRUE,
+        .descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE,
+        .descriptorBindingUpdateUnusedWhilePending = VK_TRUE,
+        .descriptorBindingPartiallyBound = VK_TRUE,
+        .runtimeDescriptorArray = VK_TRUE
+    };
+};
+
+//returns null if resource heaps are not enabled
+const ResourceHeapExtension* getResourceHeapExtension(const vulkan::Context& context) {
+    auto& ext = *context.extensions;
+    auto it = std::find_if(ext.begin(), ext.end(),
+        [](const ExtensionHandle& h) -> bool {
+            return h->getExtensionName() == ResourceHeapExtensionName;
+        });
+    return it != ext.end() ? static_cast<const ResourceHeapExtension*>(it->get()) : nullptr;
+}
+
+}
+
+bool isResourceHeapSupported(const DeviceHandle& device) {
+    //nullcheck
+    if (!device)
+        return false;
+
+    //Query features
+    VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES
+    };
+    VkPhysicalDeviceFeatures2 features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &indexingFeatures
+    };
+    vkGetPhysicalDeviceFeatures2(device->device, &features);
+
+    return indexingFeatures.shaderSampledImageArrayNonUniformIndexing == VK_TRUE &&
+        indexingFeatures.shaderStorageBufferArrayNonUniformIndexing == VK_TRUE &&
+        indexingFeatures.shaderStorageImageArrayNonUniformIndexing == VK_TRUE &&
+        indexingFeatures.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE &&
+        indexingFeatures.descriptorBindingStorageImageUpdateAfterBind == VK_TRUE &&
+        indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE &&
+        indexingFeatures.descriptorBindingUpdateUnusedWhilePending == VK_TRUE &&
+        indexingFeatures.descriptorBindingPartiallyBound == VK_TRUE &&
+        indexingFeatures.runtimeDescriptorArray == VK_TRUE;
+}
+bool isResourceHeapEnabled(const ContextHandle& context) {
+    return getResourceHeapExtension(*context) != nullptr;
+}
+
+bool isPartiallyBoundEnabled(const ContextHandle& context) {
+    return context->partiallyBound;
+}
+
+ExtensionHandle createResourceHeapExtension(uint32_t capacity) {
+    if (capacity == 0)
+        throw std::logic_error("Capacity of resource heaps must not be zero!");
+    return std::make_unique<ResourceHeapExtension>(capacity);
+}
+
 /********************************** DISPATCH **********************************/
 
 namespace vulkan {
 
+//contiguous infos of an array binding written from multiple arguments at once
+struct ParamArray {
+    std::vector<VkDescriptorBufferInfo> buffers;
+    std::vector<VkDescriptorImageInfo> images;
+    std::vector<VkBufferView> views;
+    std::vector<VkAccelerationStructureKHR> structures;
+    VkWriteDescriptorSetAccelerationStructureKHR structureWrite{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR
+    };
+};
+
 struct Program {
+    //layouts are owned by the context's layout cache
     VkDescriptorSetLayout descriptorSetLayout = nullptr;
     VkPipelineLayout pipeLayout = nullptr;
     VkShaderModule shader = nullptr;
+    //either a pipeline or a shader object if enabled
     VkPipeline pipeline = nullptr;
+    VkShaderEXT shaderObject = nullptr;
     uint32_t set = 0;
 
     LocalSize localSize{};
+    //bytes of shared memory used by a single workgroup
+    uint32_t sharedMemorySize = 0;
 
     std::vector<VkWriteDescriptorSet> boundParams;
+    //infos of params bound via bindParameterArray(); null for others.
+    //Replaced on each bind, as snapshots keep the ones they point into.
+    std::vector<std::shared_ptr<const ParamArray>> paramArrays;
+    //copy of boundParams shared by dispatches, so they do not have to copy
+    //and check them each time. Reset whenever a binding might change.
+    mutable std::shared_ptr<const std::vector<VkWriteDescriptorSet>> paramSnapshot;
+    mutable std::mutex paramMutex;
+
+    //needed to create the pipeline for parameter sets
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    VkPushConstantRange push{};
+    std::vector<BlockMember> pushMembers;
+    std::string entryPoint;
+    std::vector<VkSpecializationMapEntry> specMap;
+    std::vector<std::byte> specData;
+    //subgroup requirements; zero size if none
+    VkPipelineShaderStageCreateFlags stageFlags = 0;
+    VkPipelineShaderStageRequiredSubgroupSizeCreateInfoEXT subgroupSize{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_REQUIRED_SUBGROUP_SIZE_CREATE_INFO_EXT
+    };
+    //chained to all pipelines unless following the device
+    VkPipelineRobustnessCreateInfoEXT robustness{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_ROBUSTNESS_CREATE_INFO_EXT
+    };
+
+    //variant without push descriptors used by parameter sets;
+    //only created once the first set is created. Layouts are cached.
+    mutable VkDescriptorSetLayout setLayout = nullptr;
+    mutable VkPipelineLayout setPipeLayout = nullptr;
+    mutable VkPipeline setPipeline = nullptr;
+    //variant using the layout of resource heaps instead of the bindings;
+    //only created once the program is dispatched with a heap
+    mutable VkDescriptorSetLayout heapLayout = nullptr;
+    mutable VkPipelineLayout heapPipeLayout = nullptr;
+    mutable VkPipeline heapPipeline = nullptr;
+    mutable std::mutex setMutex;
+
+    //if set, the layout has no push descriptors and params are written into
+    //cached sets instead, one per unique combination of params keyed by the
+    //hash of their handles. Sets get allocated from pools owned by the
+    //program and are guarded by setMutex together with the pools.
+    bool cachedSets = false;
+    struct CachedSet {
+        //handles are kept to rule out hash collisions
+        std::vector<uint64_t> handles;
+        VkDescriptorSet set;
+    };
+    mutable std::unordered_multimap<uint64_t, CachedSet> setCache;
+    //resource generation the cached sets are valid for
+    mutable uint64_t setCacheGeneration = 0;
+    mutable std::vector<VkDescriptorPool> setPools;
+    //sets left in the last pool
+    mutable uint32_t setPoolFree = 0;
+    //set of the latest params snapshot skipping the lookup
+    mutable std::weak_ptr<const std::vector<VkWriteDescriptorSet>> lastParams;
+    mutable VkDescriptorSet lastSet = nullptr;
+
+    //handles replaced by reloading the code. Kept alive until destruction,
+    //since pending submissions or recorded subroutines may still use them.
+    struct Retired {
+        VkShaderModule shader;
+        VkPipeline pipeline;
+        VkShaderEXT shaderObject;
+        VkPipeline setPipeline;
+        VkDescriptorSetLayout heapLayout;
+        VkPipelineLayout heapPipeLayout;
+        VkPipeline heapPipeline;
+    };
+    std::vector<Retired> retired;
 
     const Context& context;
 
@@ -89,6 +511,82 @@ struct Program {
     {}
 };
 
+struct ParameterSet {
+    VkDescriptorPool pool = nullptr;
+    VkDescriptorSet set = nullptr;
+
+    //used instead of pool and set if descriptor buffers are enabled
+    BufferHandle descriptors = createEmptyBuffer();
+    //address of the whole buffer the descriptors are sub-allocated from
+    VkDeviceAddress descriptorAddress = 0;
+    //offset and stride of each param's descriptors in descriptors
+    std::vector<std::pair<VkDeviceSize, VkDeviceSize>> descriptorLayout;
+
+    std::vector<VkWriteDescriptorSet> params;
+    //infos of params bound via bindParameterArray(); null for others
+    std::vector<std::shared_ptr<const ParamArray>> arrays;
+
+    const Program& program;
+
+    ParameterSet(const Program& program)
+        : program(program)
+    {}
+};
+
+struct ResourceHeap {
+    VkDescriptorSetLayout layout = nullptr;
+    VkDescriptorPool pool = nullptr;
+    VkDescriptorSet set = nullptr;
+    uint32_t capacity = 0;
+
+    //type of the resource at each index handed out so far;
+    //VK_DESCRIPTOR_TYPE_MAX_ENUM marks free ones
+    std::vector<VkDescriptorType> types;
+    std::vector<uint32_t> freeList;
+};
+
+//binding of each descriptor type in a resource heap
+constexpr auto HeapBindings = std::to_array({
+    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+    VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+    VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+});
+
+//heaps and programs each create their own layout, which are compatible
+//as they are identically defined
+VkDescriptorSetLayout createHeapLayout(const Context& context, uint32_t capacity) {
+    std::array<VkDescriptorSetLayoutBinding, HeapBindings.size()> bindings;
+    std::array<VkDescriptorBindingFlags, HeapBindings.size()> flags;
+    for (auto i = 0u; i < HeapBindings.size(); ++i) {
+        bindings[i] = VkDescriptorSetLayoutBinding{
+            .binding         = i,
+            .descriptorType  = HeapBindings[i],
+            .descriptorCount = capacity,
+            .stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT
+        };
+        flags[i] =
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+            VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+            VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+    }
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount = static_cast<uint32_t>(flags.size()),
+        .pBindingFlags = flags.data()
+    };
+    VkDescriptorSetLayoutCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = &flagsInfo,
+        .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+        .bindingCount = static_cast<uint32_t>(bindings.size()),
+        .pBindings = bindings.data()
+    };
+    VkDescriptorSetLayout layout;
+    checkResult(context.fnTable.vkCreateDescriptorSetLayout(
+        context.device, &info, nullptr, &layout));
+    return layout;
+}
+
 bool isDescriptorSetEmpty(const VkWriteDescriptorSet& set) {
     return set.pNext == nullptr &&
         set.pImageInfo == nullptr &&
@@ -96,7 +594,362 @@ bool isDescriptorSetEmpty(const VkWriteDescriptorSet& set) {
         set.pTexelBufferView == nullptr;
 }
 
-void checkAllBound(const std::vector<VkWriteDescriptorSet> boundParams) {
+//descriptor count of a single argument bound to a binding of the given
+//size: runtime arrays stay unbound, other arrays get their first element
+uint32_t getSingleCount(uint32_t count) {
+    return std::min(count, 1u);
+}
+
+//writes the infos of all args into the first elements of an array binding
+//of the given size using a single write pointing into the returned array
+std::shared_ptr<const ParamArray> writeParamArray(const Context& context,
+    VkWriteDescriptorSet& write, uint32_t count, std::span<const Argument* const> args)
+{
+    if (count == 0)
+        throw std::logic_error("Runtime arrays can only be bound using a ResourceHeap!");
+    if (args.empty() || args.size() > count)
+        throw std::logic_error("Amount of arguments must be between one and the size of the array!");
+    if (args.size() < count && !context.partiallyBound)
+        throw std::logic_error("Binding fewer arguments than the array holds requires partially bound descriptors!");
+
+    auto array = std::make_shared<ParamArray>();
+    for (auto arg : args) {
+        if (!arg)
+            throw std::logic_error("Arguments must not be null!");
+        VkWriteDescriptorSet element{
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .descriptorCount = 1,
+            .descriptorType = write.descriptorType
+        };
+        arg->bindParameter(element);
+
+        //arguments do not know their type -> check the infos they provide
+        auto matches = false;
+        switch (write.descriptorType) {
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            matches = element.pBufferInfo && !element.pTexelBufferView;
+            if (matches)
+                array->buffers.push_back(*element.pBufferInfo);
+            break;
+        case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+        case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+        case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            matches = element.pImageInfo != nullptr;
+            if (matches)
+                array->images.push_back(*element.pImageInfo);
+            break;
+        case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+        case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            //the range is needed for hazard tracking
+            matches = element.pTexelBufferView && element.pBufferInfo;
+            if (matches) {
+                array->views.push_back(*element.pTexelBufferView);
+                array->buffers.push_back(*element.pBufferInfo);
+            }
+            break;
+        case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+            matches = element.pNext != nullptr;
+            if (matches) {
+                auto structure = static_cast<const VkWriteDescriptorSetAccelerationStructureKHR*>(
+                    element.pNext);
+                array->structures.push_back(structure->pAccelerationStructures[0]);
+            }
+            break;
+        default:
+            throw std::logic_error("Unsupported descriptor type!");
+        }
+        if (!matches)
+            throw std::logic_error("Argument does not match the type of the binding!");
+    }
+
+    write.descriptorCount = static_cast<uint32_t>(args.size());
+    write.pNext            = nullptr;
+    write.pImageInfo       = array->images.empty() ? nullptr : array->images.data();
+    write.pBufferInfo      = array->buffers.empty() ? nullptr : array->buffers.data();
+    write.pTexelBufferView = array->views.empty() ? nullptr : array->views.data();
+    if (!array->structures.empty()) {
+        array->structureWrite.accelerationStructureCount = write.descriptorCount;
+        array->structureWrite.pAccelerationStructures = array->structures.data();
+        write.pNext = &array->structureWrite;
+    }
+    return array;
+}
+
+//declares the accesses of the bound params, assuming storage ones are
+//read and written as we do not know better
+void trackParams(HazardTracker& tracker, const std::vector<VkWriteDescriptorSet>& params,
+    VkPipelineStageFlags2 stage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR)
+{
+    constexpr auto storageAccess =
+        VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR;
+    for (auto& param : params) {
+        for (auto i = 0u; i < param.descriptorCount; ++i) {
+            switch (param.descriptorType) {
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER: {
+                auto& info = param.pBufferInfo[i];
+                tracker.buffer(info.buffer, info.offset, info.range, stage,
+                    param.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ?
+                    storageAccess : VK_ACCESS_2_UNIFORM_READ_BIT_KHR);
+                break;
+            }
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                tracker.image(param.pImageInfo[i].imageView, stage, storageAccess);
+                break;
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+                //might still be in the layout of a previous transfer
+                tracker.sampled(param.pImageInfo[i].imageView, stage);
+                break;
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER: {
+                //texel buffers provide their range alongside the view
+                auto& info = param.pBufferInfo[i];
+                tracker.buffer(info.buffer, info.offset, info.range, stage,
+                    param.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER ?
+                    storageAccess : VK_ACCESS_2_SHADER_READ_BIT_KHR);
+                break;
+            }
+            default:
+                //acceleration structures are read only and geometry
+                //updates synchronize with ray queries themselves
+                break;
+            }
+        }
+    }
+}
+
+//robustness chained to pipelines if the program overrides the device
+const void* getRobustnessInfo(const Program& program) {
+    auto& robustness = program.robustness;
+    return robustness.storageBuffers == VK_PIPELINE_ROBUSTNESS_BUFFER_BEHAVIOR_DEVICE_DEFAULT_EXT
+        ? nullptr : &robustness;
+}
+
+//creates a pipeline of the program's shader using the given layout
+void createVariantPipeline(const Program& program,
+    VkPipelineLayout pipeLayout, VkPipelineCreateFlags flags, VkPipeline& pipeline)
+{
+    auto& context = program.context;
+
+    VkSpecializationInfo specInfo{
+        .mapEntryCount = static_cast<uint32_t>(program.specMap.size()),
+        .pMapEntries   = program.specMap.data(),
+        .dataSize      = program.specData.size(),
+        .pData         = program.specData.data()
+    };
+    VkComputePipelineCreateInfo pipeInfo{
+        .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        .pNext = getRobustnessInfo(program),
+        .flags = flags | VK_PIPELINE_CREATE_DISPATCH_BASE_BIT,
+        .stage = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .pNext = program.subgroupSize.requiredSubgroupSize ? &program.subgroupSize : nullptr,
+            .flags = program.stageFlags,
+            .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+            .module = program.shader,
+            .pName = program.entryPoint.c_str(),
+            .pSpecializationInfo = program.specMap.empty() ? nullptr : &specInfo
+        },
+        .layout = pipeLayout
+    };
+    createComputePipeline(context, pipeInfo, pipeline);
+}
+
+void createSetPipeline(const Program& program) {
+    std::lock_guard<std::mutex> lock(program.setMutex);
+    if (program.setPipeline)
+        return;
+    auto& context = program.context;
+    auto descriptorBuffer = isDescriptorBufferEnabled(context);
+
+    auto layout = context.layoutCache->getLayout(program.bindings,
+        descriptorBuffer ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0u,
+        program.push.size);
+    program.setLayout = layout.setLayout;
+    program.setPipeLayout = layout.pipeLayout;
+
+    createVariantPipeline(program, program.setPipeLayout,
+        descriptorBuffer ? VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0u,
+        program.setPipeline);
+}
+
+void createHeapPipeline(const Program& program, uint32_t capacity) {
+    std::lock_guard<std::mutex> lock(program.setMutex);
+    if (program.heapPipeline)
+        return;
+    auto& context = program.context;
+
+    //the heap replaces the program's bindings -> check they match
+    for (auto& param : program.boundParams) {
+        if (param.dstBinding >= HeapBindings.size() ||
+            HeapBindings[param.dstBinding] != param.descriptorType)
+        {
+            std::ostringstream stream;
+            stream << "Binding " << param.dstBinding
+                << " does not match the layout of resource heaps!";
+            throw std::logic_error(stream.str());
+        }
+        if (param.descriptorCount > capacity)
+            throw std::logic_error("Binding exceeds the capacity of resource heaps!");
+    }
+
+    program.heapLayout = createHeapLayout(context, capacity);
+    VkPipelineLayoutCreateInfo layoutInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = 1,
+        .pSetLayouts = &program.heapLayout,
+        .pushConstantRangeCount = program.push.size ? 1u : 0u,
+        .pPushConstantRanges = &program.push
+    };
+    checkResult(context.fnTable.vkCreatePipelineLayout(
+        context.device, &layoutInfo, nullptr, &program.heapPipeLayout));
+    createVariantPipeline(program, program.heapPipeLayout, 0, program.heapPipeline);
+}
+
+//binds the pipeline unless it is already bound. Descriptors and push constants
+//only stay valid while the layout does not change
+void bindPipeline(const Context& context, Command& cmd,
+    VkPipeline pipeline, VkPipelineLayout layout)
+{
+    auto& bound = cmd.bound;
+    if (bound.pipeline != pipeline) {
+        context.fnTable.vkCmdBindPipeline(cmd.buffer,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            pipeline);
+        bound.pipeline = pipeline;
+        bound.shader = nullptr;
+    }
+    if (bound.layout != layout) {
+        bound.layout = layout;
+        bound.set = nullptr;
+        bound.descriptorOffset = ~VkDeviceSize(0);
+        bound.params.reset();
+        bound.push.clear();
+    }
+}
+
+//binds the program's shader object or pipeline used for pushed descriptors
+void bindProgram(const Context& context, Command& cmd, const Program& program) {
+    if (!program.shaderObject) {
+        bindPipeline(context, cmd, program.pipeline, program.pipeLayout);
+        return;
+    }
+
+    auto& bound = cmd.bound;
+    if (bound.shader != program.shaderObject) {
+        VkShaderStageFlagBits stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        context.fnTable.vkCmdBindShadersEXT(cmd.buffer,
+            1, &stage, &program.shaderObject);
+        bound.shader = program.shaderObject;
+        bound.pipeline = nullptr;
+    }
+    if (bound.layout != program.pipeLayout) {
+        bound.layout = program.pipeLayout;
+        bound.set = nullptr;
+        bound.descriptorOffset = ~VkDeviceSize(0);
+        bound.params.reset();
+        bound.push.clear();
+    }
+}
+
+void bindSet(const Context& context, Command& cmd, uint32_t index, VkDescriptorSet set) {
+    auto& bound = cmd.bound;
+    if (bound.set == set)
+        return;
+
+    context.fnTable.vkCmdBindDescriptorSets(cmd.buffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        bound.layout,
+        index,
+        1, &set,
+        0, nullptr);
+    bound.set = set;
+    bound.params.reset();
+}
+
+//sets stored in descriptor buffers share a few large buffers
+// -> usually only the offset changes between dispatches
+void bindDescriptorBuffer(const Context& context, Command& cmd, uint32_t index,
+    const ParameterSet& set)
+{
+    auto& bound = cmd.bound;
+    auto& buffer = *set.descriptors;
+    if (bound.descriptorBuffer != set.descriptorAddress) {
+        VkDescriptorBufferBindingInfoEXT info{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+            .address = set.descriptorAddress,
+            .usage = buffer.usage
+        };
+        context.fnTable.vkCmdBindDescriptorBuffersEXT(cmd.buffer, 1, &info);
+        bound.descriptorBuffer = set.descriptorAddress;
+        bound.descriptorOffset = ~VkDeviceSize(0);
+    }
+    if (bound.descriptorOffset != buffer.offset) {
+        uint32_t bufferIndex = 0;
+        VkDeviceSize offset = buffer.offset;
+        context.fnTable.vkCmdSetDescriptorBufferOffsetsEXT(cmd.buffer,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            bound.layout,
+            index,
+            1, &bufferIndex, &offset);
+        bound.descriptorOffset = offset;
+    }
+    bound.set = nullptr;
+    bound.params.reset();
+}
+
+void pushParams(const Context& context, Command& cmd, uint32_t index,
+    const std::shared_ptr<const std::vector<VkWriteDescriptorSet>>& params)
+{
+    //infos are owned by the bound resources, thus comparing addresses suffices
+    auto& bound = cmd.bound;
+    auto same = !bound.set && bound.params && (bound.params == params || std::equal(
+        params->begin(), params->end(),
+        bound.params->begin(), bound.params->end(),
+        [](const VkWriteDescriptorSet& l, const VkWriteDescriptorSet& r) {
+            return l.dstBinding == r.dstBinding &&
+                l.dstArrayElement == r.dstArrayElement &&
+                l.descriptorCount == r.descriptorCount &&
+                l.descriptorType == r.descriptorType &&
+                l.pNext == r.pNext &&
+                l.pImageInfo == r.pImageInfo &&
+                l.pBufferInfo == r.pBufferInfo &&
+                l.pTexelBufferView == r.pTexelBufferView;
+        }));
+    //nothing to push for programs without bindings
+    if (same || params->empty())
+        return;
+
+    context.fnTable.vkCmdPushDescriptorSetKHR(cmd.buffer,
+        VK_PIPELINE_BIND_POINT_COMPUTE,
+        bound.layout,
+        index,
+        static_cast<uint32_t>(params->size()),
+        params->data());
+    bound.set = nullptr;
+    bound.params = params;
+}
+
+void pushConstants(const Context& context, Command& cmd, std::span<const std::byte> data) {
+    auto& bound = cmd.bound;
+    if (data.empty() || std::equal(
+        data.begin(), data.end(), bound.push.begin(), bound.push.end()))
+    {
+        return;
+    }
+
+    context.fnTable.vkCmdPushConstants(cmd.buffer,
+        bound.layout,
+        VK_SHADER_STAGE_COMPUTE_BIT,
+        0,
+        static_cast<uint32_t>(data.size_bytes()),
+        data.data());
+    bound.push.assign(data.begin(), data.end());
+}
+
+void checkAllBound(const std::vector<VkWriteDescriptorSet>& boundParams) {
     if (std::any_of(
         boundParams.begin(),
         boundParams.end(),
@@ -116,68 +969,403 @@ void checkAllBound(const std::vector<VkWriteDescriptorSet> boundParams) {
     }
 }
 
+//runtime arrays are only backed by resource heaps
+void checkNoRuntimeArrays(const std::vector<VkWriteDescriptorSet>& boundParams) {
+    if (std::any_of(boundParams.begin(), boundParams.end(),
+        [](const VkWriteDescriptorSet& p) { return p.descriptorCount == 0; }))
+    {
+        throw std::logic_error("Programs using runtime arrays can only be dispatched using a ResourceHeap!");
+    }
 }
 
-void DispatchCommand::record(vulkan::Command& cmd) const {
-    auto& prog = program.get();
-    auto& context = prog.context;
-
-    //we're working in the compute stage
-    cmd.stage |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+//works for both compute and ray tracing programs
+template<class P>
+std::shared_ptr<const std::vector<VkWriteDescriptorSet>> snapshotParams(const P& program) {
+    std::lock_guard<std::mutex> lock(program.paramMutex);
+    if (!program.paramSnapshot) {
+        checkNoRuntimeArrays(program.boundParams);
+        //sanity check: all params are bound (will throw if not)
+        checkAllBound(program.boundParams);
+        //the params may point into arrays replaced by later binds
+        struct Snapshot {
+            std::vector<VkWriteDescriptorSet> params;
+            std::vector<std::shared_ptr<const ParamArray>> arrays;
+        };
+        auto snapshot = std::make_shared<Snapshot>(program.boundParams);
+        if constexpr (std::is_same_v<P, Program>)
+            snapshot->arrays = program.paramArrays;
+        program.paramSnapshot = std::shared_ptr<const std::vector<VkWriteDescriptorSet>>(
+            snapshot, &snapshot->params);
+    }
+    return program.paramSnapshot;
+}
+//the caller is about to change a binding
+template<class P>
+void resetSnapshot(const P& program) {
+    std::lock_guard<std::mutex> lock(program.paramMutex);
+    program.paramSnapshot.reset();
+}
 
-    //bind pipeline
-    context.fnTable.vkCmdBindPipeline(cmd.buffer,
-        VK_PIPELINE_BIND_POINT_COMPUTE,
-        prog.pipeline);
+//amount of sets allocated from a single pool of cached sets
+constexpr uint32_t SetPoolSize = 32;
 
-    //bind params
-    context.fnTable.vkCmdPushDescriptorSetKHR(cmd.buffer,
-        VK_PIPELINE_BIND_POINT_COMPUTE,
-        prog.pipeLayout,
-        prog.set,
-        static_cast<uint32_t>(params.size()),
-        params.data());
+template<class T>
+uint64_t handleKey(T handle) {
+    //handles are pointers on 64 bit and integers on 32 bit platforms
+    if constexpr (std::is_pointer_v<T>)
+        return reinterpret_cast<uintptr_t>(handle);
+    else
+        return static_cast<uint64_t>(handle);
+}
 
-    //push constant if there is any
-    if (!pushData.empty()) {
-        context.fnTable.vkCmdPushConstants(cmd.buffer,
-            prog.pipeLayout,
-            VK_SHADER_STAGE_COMPUTE_BIT,
-            0,
-            static_cast<uint32_t>(pushData.size_bytes()),
-            pushData.data());
+//lists everything the descriptors written by params depend on
+std::vector<uint64_t> listHandles(const std::vector<VkWriteDescriptorSet>& params) {
+    std::vector<uint64_t> handles;
+    for (auto& param : params) {
+        handles.push_back(param.dstBinding);
+        handles.push_back(param.descriptorType);
+        for (auto i = 0u; i < param.descriptorCount; ++i) {
+            if (param.descriptorType == VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR) {
+                auto write = static_cast<const VkWriteDescriptorSetAccelerationStructureKHR*>(
+                    param.pNext);
+                handles.push_back(handleKey(write->pAccelerationStructures[i]));
+                continue;
+            }
+            if (param.pTexelBufferView)
+                handles.push_back(handleKey(param.pTexelBufferView[i]));
+            if (param.pBufferInfo) {
+                auto& info = param.pBufferInfo[i];
+                handles.push_back(handleKey(info.buffer));
+                handles.push_back(info.offset);
+                handles.push_back(info.range);
+            }
+            if (param.pImageInfo) {
+                auto& info = param.pImageInfo[i];
+                handles.push_back(handleKey(info.sampler));
+                handles.push_back(handleKey(info.imageView));
+                handles.push_back(info.imageLayout);
+            }
+        }
     }
-
-    //dispatch
-    context.fnTable.vkCmdDispatch(cmd.buffer,
-        groupCountX, groupCountY, groupCountZ);
+    return handles;
 }
 
-DispatchCommand::DispatchCommand(const DispatchCommand&) = default;
-DispatchCommand& DispatchCommand::operator=(const DispatchCommand&) = default;
+uint64_t hashHandles(const std::vector<uint64_t>& handles) {
+    uint64_t hash = 14695981039346656037ull;
+    for (auto handle : handles) {
+        hash ^= handle;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
 
-DispatchCommand::DispatchCommand(DispatchCommand&&) noexcept = default;
-DispatchCommand& DispatchCommand::operator=(DispatchCommand&&) noexcept = default;
+VkDescriptorSet allocateCachedSet(const Program& program) {
+    auto& context = program.context;
+    if (program.setPoolFree == 0) {
+        std::vector<VkDescriptorPoolSize> sizes;
+        for (auto& binding : program.bindings) {
+            auto it = std::find_if(sizes.begin(), sizes.end(),
+                [&binding](const VkDescriptorPoolSize& s) { return s.type == binding.descriptorType; });
+            if (it != sizes.end())
+                it->descriptorCount += binding.descriptorCount * SetPoolSize;
+            else
+                sizes.push_back({ binding.descriptorType, binding.descriptorCount * SetPoolSize });
+        }
+        VkDescriptorPoolCreateInfo poolInfo{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .maxSets = SetPoolSize,
+            .poolSizeCount = static_cast<uint32_t>(sizes.size()),
+            .pPoolSizes = sizes.data()
+        };
+        VkDescriptorPool pool;
+        checkResult(context.fnTable.vkCreateDescriptorPool(
+            context.device, &poolInfo, nullptr, &pool));
+        program.setPools.push_back(pool);
+        program.setPoolFree = SetPoolSize;
+    }
 
-DispatchCommand::DispatchCommand(
-    const vulkan::Program& program,
-    uint32_t x, uint32_t y, uint32_t z,
-    std::span<const std::byte> push
-)
-    : groupCountX(x)
-    , groupCountY(y)
-    , groupCountZ(z)
-    , pushData(push)
-    , program(std::cref(program))
-    , params(program.boundParams)
-{
-    //sanity check: all params are bound (will throw if not)
-    vulkan::checkAllBound(program.boundParams);
+    VkDescriptorSetAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = program.setPools.back(),
+        .descriptorSetCount = 1,
+        .pSetLayouts = &program.descriptorSetLayout
+    };
+    VkDescriptorSet set;
+    checkResult(context.fnTable.vkAllocateDescriptorSets(
+        context.device, &allocInfo, &set));
+    --program.setPoolFree;
+    return set;
 }
-DispatchCommand::~DispatchCommand() = default;
 
-void DispatchIndirectCommand::record(vulkan::Command& cmd) const {
-    auto buffer = tensor.get().getBuffer().buffer;
+//returns the set containing the given params, which gets written on the
+//first use; null if the program pushes its params instead
+VkDescriptorSet fetchCachedSet(const Program& program,
+    const std::shared_ptr<const std::vector<VkWriteDescriptorSet>>& params)
+{
+    if (!program.cachedSets || params->empty())
+        return nullptr;
+    auto& context = program.context;
+
+    std::lock_guard<std::mutex> lock(program.setMutex);
+    //destroyed handles might get reused -> start over
+    auto generation = context.resourceGeneration.load();
+    if (program.setCacheGeneration != generation) {
+        program.setCache.clear();
+        program.setCacheGeneration = generation;
+        program.lastParams.reset();
+    }
+    //consecutive dispatches usually share the program's snapshot
+    if (program.lastSet && program.lastParams.lock() == params)
+        return program.lastSet;
+
+    auto handles = listHandles(*params);
+    auto hash = hashHandles(handles);
+    VkDescriptorSet set = nullptr;
+    auto [begin, end] = program.setCache.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        if (it->second.handles == handles) {
+            set = it->second.set;
+            break;
+        }
+    }
+    if (!set) {
+        set = allocateCachedSet(program);
+        std::vector<VkWriteDescriptorSet> writes(params->begin(), params->end());
+        for (auto& write : writes)
+            write.dstSet = set;
+        context.fnTable.vkUpdateDescriptorSets(context.device,
+            static_cast<uint32_t>(writes.size()), writes.data(),
+            0, nullptr);
+        program.setCache.emplace(hash, Program::CachedSet{ std::move(handles), set });
+    }
+
+    program.lastParams = params;
+    program.lastSet = set;
+    return set;
+}
+
+//binds either the cached set containing the params or pushes them
+void bindParams(const Context& context, Command& cmd, const Program& program,
+    const std::shared_ptr<const std::vector<VkWriteDescriptorSet>>& params)
+{
+    if (!program.cachedSets)
+        pushParams(context, cmd, program.set, params);
+    else if (auto set = fetchCachedSet(program, params))
+        bindSet(context, cmd, program.set, set);
+}
+
+}
+
+void DispatchCommand::record(vulkan::Command& cmd) const {
+    auto& prog = program.get();
+    auto& context = prog.context;
+
+    //we're working in the compute stage
+    cmd.stage |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+    //bind pipeline & params; skipped if already bound by a previous dispatch
+    if (set) {
+        //parameter sets are only read during execution
+        vulkan::bindPipeline(context, cmd, prog.setPipeline, prog.setPipeLayout);
+        if (set->descriptors)
+            vulkan::bindDescriptorBuffer(context, cmd, prog.set, *set);
+        else
+            vulkan::bindSet(context, cmd, prog.set, set->set);
+    }
+    else if (heap) {
+        //heaps are updated after bind -> same as sets
+        vulkan::bindPipeline(context, cmd, prog.heapPipeline, prog.heapPipeLayout);
+        vulkan::bindSet(context, cmd, prog.set, heap->set);
+    }
+    else {
+        vulkan::bindProgram(context, cmd, prog);
+        vulkan::bindParams(context, cmd, prog, params);
+    }
+
+    //push constant if there is any
+    vulkan::pushConstants(context, cmd, pushData);
+
+    //only sync against actual hazards if tracking
+    //(params of sets and heaps are unknown at this point and thus not tracked,
+    //but any texture they sample has to be in the shader read only layout)
+    if (cmd.tracker) {
+        if (params)
+            vulkan::trackParams(*cmd.tracker, *params);
+        else
+            cmd.tracker->sampledAll(VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR);
+        cmd.tracker->barrier(context, cmd);
+    }
+
+    //dispatch; split into multiple ones if exceeding the limits
+    vulkan::count(context.counters.dispatches);
+    auto& limits = context.maxWorkGroupCount;
+    if (groupCountX <= limits[0] && groupCountY <= limits[1] && groupCountZ <= limits[2]) {
+        context.fnTable.vkCmdDispatch(cmd.buffer,
+            groupCountX, groupCountY, groupCountZ);
+        return;
+    }
+    //64 bit to not overflow near the end of the range
+    for (uint64_t z = 0; z < groupCountZ; z += limits[2]) {
+        for (uint64_t y = 0; y < groupCountY; y += limits[1]) {
+            for (uint64_t x = 0; x < groupCountX; x += limits[0]) {
+                context.fnTable.vkCmdDispatchBase(cmd.buffer,
+                    static_cast<uint32_t>(x),
+                    static_cast<uint32_t>(y),
+                    static_cast<uint32_t>(z),
+                    static_cast<uint32_t>(std::min<uint64_t>(groupCountX - x, limits[0])),
+                    static_cast<uint32_t>(std::min<uint64_t>(groupCountY - y, limits[1])),
+                    static_cast<uint32_t>(std::min<uint64_t>(groupCountZ - z, limits[2])));
+            }
+        }
+    }
+}
+
+DispatchCommand& DispatchCommand::copyPushData() & {
+    //already owned
+    if (pushData.empty() || pushData.data() == inlinePush.data() ||
+        (heapPush && pushData.data() == heapPush.get()))
+    {
+        return *this;
+    }
+
+    if (pushData.size() <= InlinePushSize) {
+        std::copy(pushData.begin(), pushData.end(), inlinePush.begin());
+        pushData = { inlinePush.data(), pushData.size() };
+    }
+    else {
+        std::shared_ptr<std::byte[]> copy(new std::byte[pushData.size()]);
+        std::copy(pushData.begin(), pushData.end(), copy.get());
+        heapPush = copy;
+        pushData = { heapPush.get(), pushData.size() };
+    }
+    return *this;
+}
+DispatchCommand DispatchCommand::copyPushData() && {
+    copyPushData();
+    return std::move(*this);
+}
+
+void DispatchCommand::rebasePushData(const DispatchCommand& other) noexcept {
+    if (!other.pushData.empty() && other.pushData.data() == other.inlinePush.data())
+        pushData = { inlinePush.data(), other.pushData.size() };
+}
+
+DispatchCommand::DispatchCommand(const DispatchCommand& other)
+    : groupCountX(other.groupCountX)
+    , groupCountY(other.groupCountY)
+    , groupCountZ(other.groupCountZ)
+    , pushData(other.pushData)
+    , program(other.program)
+    , params(other.params)
+    , set(other.set)
+    , heap(other.heap)
+    , inlinePush(other.inlinePush)
+    , heapPush(other.heapPush)
+{
+    rebasePushData(other);
+}
+DispatchCommand& DispatchCommand::operator=(const DispatchCommand& other) {
+    groupCountX = other.groupCountX;
+    groupCountY = other.groupCountY;
+    groupCountZ = other.groupCountZ;
+    pushData = other.pushData;
+    program = other.program;
+    params = other.params;
+    set = other.set;
+    heap = other.heap;
+    inlinePush = other.inlinePush;
+    heapPush = other.heapPush;
+    rebasePushData(other);
+    return *this;
+}
+
+DispatchCommand::DispatchCommand(DispatchCommand&& other) noexcept
+    : groupCountX(other.groupCountX)
+    , groupCountY(other.groupCountY)
+    , groupCountZ(other.groupCountZ)
+    , pushData(other.pushData)
+    , program(other.program)
+    , params(std::move(other.params))
+    , set(other.set)
+    , heap(other.heap)
+    , inlinePush(other.inlinePush)
+    , heapPush(std::move(other.heapPush))
+{
+    rebasePushData(other);
+}
+DispatchCommand& DispatchCommand::operator=(DispatchCommand&& other) noexcept {
+    groupCountX = other.groupCountX;
+    groupCountY = other.groupCountY;
+    groupCountZ = other.groupCountZ;
+    pushData = other.pushData;
+    program = other.program;
+    params = std::move(other.params);
+    set = other.set;
+    heap = other.heap;
+    inlinePush = other.inlinePush;
+    heapPush = std::move(other.heapPush);
+    rebasePushData(other);
+    return *this;
+}
+
+DispatchCommand::DispatchCommand(
+    const vulkan::Program& program,
+    uint32_t x, uint32_t y, uint32_t z,
+    std::span<const std::byte> push
+)
+    : groupCountX(x)
+    , groupCountY(y)
+    , groupCountZ(z)
+    , pushData(push)
+    , program(std::cref(program))
+    , params(vulkan::snapshotParams(program))
+    , set(nullptr)
+    , heap(nullptr)
+{}
+DispatchCommand::DispatchCommand(
+    const vulkan::Program& program,
+    const vulkan::ParameterSet& set,
+    uint32_t x, uint32_t y, uint32_t z,
+    std::span<const std::byte> push
+)
+    : groupCountX(x)
+    , groupCountY(y)
+    , groupCountZ(z)
+    , pushData(push)
+    , program(std::cref(program))
+    , params()
+    , set(&set)
+    , heap(nullptr)
+{
+    if (&set.program != &program)
+        throw std::logic_error("ParameterSet was created for a different program!");
+}
+DispatchCommand::DispatchCommand(
+    const vulkan::Program& program,
+    const vulkan::ResourceHeap& heap,
+    uint32_t x, uint32_t y, uint32_t z,
+    std::span<const std::byte> push
+)
+    : groupCountX(x)
+    , groupCountY(y)
+    , groupCountZ(z)
+    , pushData(push)
+    , program(std::cref(program))
+    , params()
+    , set(nullptr)
+    , heap(&heap)
+{
+    vulkan::createHeapPipeline(program, heap.capacity);
+}
+DispatchCommand::~DispatchCommand() = default;
+
+void DispatchIndirectCommand::record(vulkan::Command& cmd) const {
+    record(cmd, true);
+}
+void DispatchIndirectCommand::record(vulkan::Command& cmd, bool sync) const {
+    auto buffer = tensor.get().getBuffer().buffer;
+    //tensor might be sub-allocated from a shared buffer
+    auto offset = this->offset + tensor.get().getBuffer().offset;
     auto& prog = program.get();
     auto& context = prog.context;
 
@@ -186,46 +1374,42 @@ void DispatchIndirectCommand::record(vulkan::Command& cmd) const {
         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 
-    //bind pipeline
-    context.fnTable.vkCmdBindPipeline(cmd.buffer,
-        VK_PIPELINE_BIND_POINT_COMPUTE,
-        prog.pipeline);
-
-    //bind params
-    context.fnTable.vkCmdPushDescriptorSetKHR(cmd.buffer,
-        VK_PIPELINE_BIND_POINT_COMPUTE,
-        prog.pipeLayout,
-        prog.set,
-        static_cast<uint32_t>(params.size()),
-        params.data());
+    //bind pipeline & params; skipped if already bound by a previous dispatch
+    vulkan::bindProgram(context, cmd, prog);
+    vulkan::bindParams(context, cmd, prog, params);
 
     //push constant if there is any
-    if (!pushData.empty()) {
-        context.fnTable.vkCmdPushConstants(cmd.buffer,
-            prog.pipeLayout,
-            VK_SHADER_STAGE_COMPUTE_BIT,
-            0,
-            static_cast<uint32_t>(pushData.size_bytes()),
-            pushData.data());
+    vulkan::pushConstants(context, cmd, pushData);
+
+    if (cmd.tracker) {
+        //only sync against actual hazards
+        vulkan::trackParams(*cmd.tracker, *params);
+        cmd.tracker->buffer(buffer, offset, 12, // 3 * int
+            VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR,
+            VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR);
+        cmd.tracker->barrier(context, cmd);
+    }
+    else if (sync) {
+        //barrier to ensure indirect data is complete
+        VkBufferMemoryBarrier barrier{
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+            .buffer = buffer,
+            .offset = offset,
+            .size = 12 // 3 * int
+        };
+        vulkan::count(context.counters.barriers);
+        context.fnTable.vkCmdPipelineBarrier(cmd.buffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0,
+            0, nullptr,
+            1, &barrier,
+            0, nullptr);
     }
-
-    //barrier to ensure indirect data is complete
-    VkBufferMemoryBarrier barrier{
-        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT,
-        .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
-        .buffer = buffer,
-        .offset = offset,
-        .size = 12 // 3 * int
-    };
-    context.fnTable.vkCmdPipelineBarrier(cmd.buffer,
-        VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0,
-        0, nullptr,
-        1, &barrier,
-        0, nullptr);
 
     //disptach indirect
+    vulkan::count(context.counters.dispatches);
     context.fnTable.vkCmdDispatchIndirect(cmd.buffer, buffer, offset);
 }
 
@@ -244,13 +1428,63 @@ DispatchIndirectCommand::DispatchIndirectCommand(
     , offset(offset)
     , pushData(push)
     , program(std::cref(program))
-    , params(program.boundParams)
-{
-    //sanity check: all params are bound (will throw if not)
-    vulkan::checkAllBound(program.boundParams);
-}
+    , params(vulkan::snapshotParams(program))
+{}
 DispatchIndirectCommand::~DispatchIndirectCommand() = default;
 
+void DispatchIndirectListCommand::record(vulkan::Command& cmd) const {
+    if (dispatches.empty())
+        return;
+
+    //tracked dispatches synchronize each on their own
+    if (!cmd.tracker) {
+        //one barrier per buffer covering all indirect data read from it
+        std::vector<vulkan::BufferBarrier> barriers;
+        for (auto& dispatch : dispatches) {
+            auto& tensorBuffer = dispatch.tensor.get().getBuffer();
+            auto buffer = tensorBuffer.buffer;
+            auto begin = tensorBuffer.offset + dispatch.offset;
+            auto end = begin + 12; // 3 * int
+            auto it = std::find_if(barriers.begin(), barriers.end(),
+                [buffer](const vulkan::BufferBarrier& b) { return b.buffer == buffer; });
+            if (it == barriers.end()) {
+                barriers.push_back({
+                    .srcStage = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                    .srcAccess = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+                    .dstStage = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR,
+                    .dstAccess = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR,
+                    .buffer = buffer,
+                    .offset = begin,
+                    .size = end - begin
+                });
+            }
+            else {
+                auto first = std::min(it->offset, begin);
+                auto last = std::max(it->offset + it->size, end);
+                it->offset = first;
+                it->size = last - first;
+            }
+        }
+        vulkan::pipelineBarrier(dispatches.front().program.get().context,
+            cmd.buffer, barriers);
+    }
+
+    for (auto& dispatch : dispatches)
+        dispatch.record(cmd, false);
+}
+
+DispatchIndirectListCommand::DispatchIndirectListCommand(const DispatchIndirectListCommand&) = default;
+DispatchIndirectListCommand& DispatchIndirectListCommand::operator=(const DispatchIndirectListCommand&) = default;
+
+DispatchIndirectListCommand::DispatchIndirectListCommand(DispatchIndirectListCommand&&) noexcept = default;
+DispatchIndirectListCommand& DispatchIndirectListCommand::operator=(DispatchIndirectListCommand&&) noexcept = default;
+
+DispatchIndirectListCommand::DispatchIndirectListCommand(
+    std::vector<DispatchIndirectCommand> dispatches)
+    : dispatches(std::move(dispatches))
+{}
+DispatchIndirectListCommand::~DispatchIndirectListCommand() = default;
+
 /*********************************** PROGRAM **********************************/
 
 namespace {
@@ -307,15 +1541,17 @@ ImageFormat castImageFormat(SpvImageFormat format) {
     case SpvImageFormatRg32ui:
         return ImageFormat::R32G32_UINT;
     case SpvImageFormatR32f:
-        return ImageFormat::R32G32_SFLOAT;
+        return ImageFormat::R32_SFLOAT;
     case SpvImageFormatR32i:
-        return ImageFormat::R32G32_SINT;
+        return ImageFormat::R32_SINT;
     case SpvImageFormatR32ui:
-        return ImageFormat::R32G32B32A32_UINT;
+        return ImageFormat::R32_UINT;
     case SpvImageFormatRgba16i:
         return ImageFormat::R16G16B16A16_SINT;
     case SpvImageFormatRgba16ui:
         return ImageFormat::R16G16B16A16_UINT;
+    case SpvImageFormatRgba16:
+        return ImageFormat::R16G16B16A16_UNORM;
     case SpvImageFormatRgba8:
         return ImageFormat::R8G8B8A8_UNORM;
     case SpvImageFormatRgba8Snorm:
@@ -337,11 +1573,270 @@ uint8_t castDimension(SpvDim dim) {
         return 2;
     case SpvDim3D:
         return 3;
+    case SpvDimBuffer:
+        return 1;
     default:
         return 0; //Unknown
     }
 }
 
+//sums the size of all workgroup variables. SPIRV-Reflect does not expose
+//them, so we walk the instructions ourselves
+uint32_t getSharedMemorySize(std::span<const uint32_t> code) {
+    std::unordered_map<uint32_t, uint64_t> sizes;
+    std::unordered_map<uint32_t, uint32_t> constants;
+    std::unordered_map<uint32_t, uint32_t> pointees;
+    uint64_t total = 0;
+    //skip header
+    for (size_t i = 5; i < code.size();) {
+        auto op = code[i] & 0xFFFFu;
+        auto count = code[i] >> 16;
+        if (count == 0 || i + count > code.size())
+            throw std::runtime_error("Invalid shader code: Malformed instruction!");
+        auto args = code.subspan(i + 1, count - 1);
+        i += count;
+
+        auto typeSize = [&sizes](uint32_t id) -> uint64_t {
+            auto it = sizes.find(id);
+            return it != sizes.end() ? it->second : 0;
+        };
+        switch (op) {
+        case SpvOpTypeBool:
+            sizes[args[0]] = 4;
+            break;
+        case SpvOpTypeInt:
+        case SpvOpTypeFloat:
+            sizes[args[0]] = args[1] / 8;
+            break;
+        case SpvOpTypeVector:
+        case SpvOpTypeMatrix:
+            sizes[args[0]] = typeSize(args[1]) * args[2];
+            break;
+        case SpvOpTypeArray: {
+            auto length = constants.find(args[2]);
+            sizes[args[0]] = typeSize(args[1]) *
+                (length != constants.end() ? length->second : 0);
+            break;
+        }
+        case SpvOpTypeStruct: {
+            uint64_t size = 0;
+            for (auto member : args.subspan(1))
+                size += typeSize(member);
+            sizes[args[0]] = size;
+            break;
+        }
+        case SpvOpTypePointer:
+            pointees[args[0]] = args[2];
+            break;
+        //spec constants sizing arrays use their default value
+        case SpvOpConstant:
+        case SpvOpSpecConstant:
+            constants[args[1]] = args[2];
+            break;
+        case SpvOpVariable:
+            if (args[2] == SpvStorageClassWorkgroup)
+                total += typeSize(pointees[args[0]]);
+            break;
+        //types and globals are declared before any function
+        case SpvOpFunction:
+            i = code.size();
+            break;
+        }
+    }
+    return static_cast<uint32_t>(std::min<uint64_t>(total, UINT32_MAX));
+}
+
+BlockMember reflectMember(const SpvReflectBlockVariable& var) {
+    //the block variable misses the dimension of runtime arrays
+    auto& array = var.type_description ? var.type_description->traits.array : var.array;
+    BlockMember member{
+        .name = var.name ? var.name : "",
+        .offset = var.offset,
+        .size = var.size,
+        .type = MemberType::STRUCT,
+        .width = var.numeric.scalar.width,
+        .components = 1,
+        .columns = 1,
+        .matrixStride = 0,
+        .rowMajor = (var.decoration_flags & SPV_REFLECT_DECORATION_ROW_MAJOR) != 0,
+        .arrayStride = array.stride
+    };
+    auto flags = var.type_description ? var.type_description->type_flags : 0u;
+    //buffer references are plain device addresses on the host;
+    //do not follow them as they may refer to themselves
+    if (flags & SPV_REFLECT_TYPE_FLAG_REF) {
+        member.type = MemberType::UINT;
+        member.width = 64;
+    }
+    else if (flags & SPV_REFLECT_TYPE_FLAG_STRUCT) {
+        member.width = 0;
+        member.members.reserve(var.member_count);
+        for (auto i = 0u; i < var.member_count; ++i)
+            member.members.push_back(reflectMember(var.members[i]));
+    }
+    else if (flags & SPV_REFLECT_TYPE_FLAG_FLOAT) {
+        member.type = MemberType::FLOAT;
+    }
+    else if (flags & SPV_REFLECT_TYPE_FLAG_INT) {
+        member.type = var.numeric.scalar.signedness ? MemberType::INT : MemberType::UINT;
+    }
+    else if (flags & SPV_REFLECT_TYPE_FLAG_BOOL) {
+        member.type = MemberType::BOOL;
+    }
+
+    if (flags & SPV_REFLECT_TYPE_FLAG_MATRIX) {
+        member.components = var.numeric.matrix.row_count;
+        member.columns = var.numeric.matrix.column_count;
+        member.matrixStride = var.numeric.matrix.stride;
+    }
+    else if (flags & SPV_REFLECT_TYPE_FLAG_VECTOR) {
+        member.components = var.numeric.vector.component_count;
+    }
+
+    member.arrayDims.assign(array.dims, array.dims + array.dims_count);
+    if (std::find(member.arrayDims.begin(), member.arrayDims.end(),
+        static_cast<uint32_t>(SPV_REFLECT_ARRAY_DIM_RUNTIME)) != member.arrayDims.end())
+    {
+        member.size = 0;
+    }
+    return member;
+}
+
+std::vector<BlockMember> reflectMembers(const SpvReflectBlockVariable& block) {
+    std::vector<BlockMember> members;
+    members.reserve(block.member_count);
+    for (auto i = 0u; i < block.member_count; ++i)
+        members.push_back(reflectMember(block.members[i]));
+    return members;
+}
+
+vulkan::Reflection reflect(std::span<const uint32_t> code) {
+    //create reflection module
+    SpvReflectShaderModule reflectModule;
+    spvCheckResult(spvReflectCreateShaderModule2(
+        SPV_REFLECT_MODULE_FLAG_NO_COPY,
+        code.size_bytes(), code.data(),
+        &reflectModule));
+
+    //save local size
+    //we assume that there is exactly one entry_point
+    vulkan::Reflection result{
+        .localSize = {
+            .x = reflectModule.entry_points->local_size.x,
+            .y = reflectModule.entry_points->local_size.y,
+            .z = reflectModule.entry_points->local_size.z
+        },
+        .entryPoint = reflectModule.entry_point_name,
+        .pushSize = 0
+    };
+
+    try {
+        //We only support a single descriptor set
+        if (reflectModule.descriptor_set_count > 1)
+            throw std::logic_error("Programs are only allowed to have a single descriptor set!");
+        //reflect bindings
+        if (reflectModule.descriptor_set_count == 1) {
+            auto& set = reflectModule.descriptor_sets[0];
+
+            //count actually used params
+            auto pBinding = *set.bindings;
+            auto pBindingEnd = pBinding + set.binding_count;
+            auto param_count = static_cast<uint32_t>(std::count_if(pBinding, pBindingEnd,
+                [](const SpvReflectDescriptorBinding& b) -> bool { return b.accessed != 0; }
+            ));
+
+            //reserve binding slots
+            result.bindings.resize(param_count);
+            result.params.resize(param_count);
+            result.traits.resize(param_count);
+
+            //Create bindings
+            std::unordered_set<uint32_t> bindingSet;
+            for (auto i = -1; pBinding != pBindingEnd; ++pBinding) {
+                //if the file was compiled with auto binding mapping, unused bindings get mapped to 0
+                //since this might result in multiple bindigs pointing to the same, overwriting each
+                //other, we HAVE to skip unused ones. While this will later produce errors if the
+                //user wants to bind an unused parameter, he still can check the bindings of the
+                //program to see which bindings he can actually use
+                if (!pBinding->accessed)
+                    continue;
+                else
+                    ++i;
+
+                //save binding number to set so we can later check if there were any duplicates
+                if (bindingSet.contains(pBinding->binding))
+                    throw std::runtime_error("Invalid shader code: A binding number has been assigned to multiple inputs!");
+                else
+                    bindingSet.insert(pBinding->binding);
+
+                //runtime arrays (count of zero) are only backed by resource heaps,
+                //but the other pipelines still need a slot for them
+                result.bindings[i] = VkDescriptorSetLayoutBinding{
+                    .binding         = pBinding->binding,
+                    .descriptorType  = static_cast<VkDescriptorType>(pBinding->descriptor_type),
+                    .descriptorCount = std::max(pBinding->count, 1u),
+                    .stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT
+                };
+                result.params[i] = VkWriteDescriptorSet{
+                    .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                    .dstBinding = pBinding->binding,
+                    .descriptorCount = pBinding->count,
+                    .descriptorType = static_cast<VkDescriptorType>(pBinding->descriptor_type)
+                };
+
+                auto& traits = result.traits[i];
+                traits = {
+                    .name = pBinding->name ? pBinding->name : "",
+                    .binding = pBinding->binding,
+                    .type = static_cast<ParameterType>(pBinding->descriptor_type),
+                    .count = pBinding->count
+                };
+
+                switch (pBinding->descriptor_type) {
+                case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+                    traits.imageTraits = ImageBindingTraits{
+                        .format = castImageFormat(pBinding->image.image_format),
+                        .dims = castDimension(pBinding->image.dim),
+                        .arrayed = pBinding->image.arrayed != 0
+                    };
+                    break;
+                case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+                case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+                    auto name = pBinding->type_description->type_name;
+                    traits.name = name ? name : "";
+                    traits.members = reflectMembers(pBinding->block);
+                    break;
+                }
+            }
+        }
+
+        //read push constant size
+        if (reflectModule.push_constant_block_count > 1)
+            throw std::logic_error("Multiple push constant found, but only up to one is supported!");
+        if (reflectModule.push_constant_block_count == 1) {
+            result.pushSize = reflectModule.push_constant_blocks->size;
+            result.pushMembers = reflectMembers(*reflectModule.push_constant_blocks);
+        }
+    }
+    catch (...) {
+        spvReflectDestroyShaderModule(&reflectModule);
+        throw;
+    }
+
+    //reflection might have ids out of order -> sort them
+    result.specIds.resize(reflectModule.spec_constant_count);
+    for (auto i = 0u; i < reflectModule.spec_constant_count; ++i)
+        result.specIds[i] = reflectModule.spec_constants[i].constant_id;
+    std::sort(result.specIds.begin(), result.specIds.end());
+    result.sharedMemorySize = getSharedMemorySize(code);
+
+    //we're done reflecting
+    spvReflectDestroyShaderModule(&reflectModule);
+    return result;
+}
+
 }
 
 const LocalSize& Program::getLocalSize() const noexcept {
@@ -389,11 +1884,44 @@ bool Program::isBindingBound(std::string_view name) const {
 const std::vector<BindingTraits>& Program::listBindings() const noexcept {
     return bindingTraits;
 }
+uint32_t Program::getPushConstantSize() const noexcept {
+    return program->push.size;
+}
+const std::vector<BlockMember>& Program::getPushConstantMembers() const noexcept {
+    return program->pushMembers;
+}
+bool Program::usesDescriptorSetCache() const noexcept {
+    return program->cachedSets;
+}
+
+void Program::bindParameterArray(std::span<const Argument* const> params, uint32_t binding) {
+    if (binding >= program->boundParams.size())
+        throw std::runtime_error("There is no binding point at specified number! Binding: " + std::to_string(binding));
+
+    vulkan::resetSnapshot(*program);
+    program->paramArrays[binding] = vulkan::writeParamArray(*getContext(),
+        program->boundParams[binding], bindingTraits[binding].count, params);
+}
+void Program::bindParameterArray(std::span<const Argument* const> params, std::string_view binding) {
+    const auto& b = bindingTraits;
+    auto it = std::find_if(b.begin(), b.end(), [binding](const BindingTraits& t) -> bool {
+        return t.name == binding;
+    });
+
+    if (it == b.end())
+        throw std::runtime_error("There is no binding point at specified location! Binding name: " + std::string(binding));
+
+    bindParameterArray(params, static_cast<uint32_t>(std::distance(b.begin(), it)));
+}
 
 VkWriteDescriptorSet& Program::getBinding(uint32_t i) {
     if (i >= program->boundParams.size())
         throw std::runtime_error("There is no binding point at specified number! Binding: " + std::to_string(i));
 
+    vulkan::resetSnapshot(*program);
+    //a single argument replaces previously bound arrays
+    program->paramArrays[i].reset();
+    program->boundParams[i].descriptorCount = vulkan::getSingleCount(bindingTraits[i].count);
     return program->boundParams[i];
 }
 VkWriteDescriptorSet& Program::getBinding(std::string_view name) {
@@ -405,8 +1933,7 @@ VkWriteDescriptorSet& Program::getBinding(std::string_view name) {
     if (it == b.end())
         throw std::runtime_error("There is no binding point at specified location! Binding name: " + std::string(name));
 
-    auto i = std::distance(b.begin(), it);
-    return program->boundParams[i];
+    return getBinding(static_cast<uint32_t>(std::distance(b.begin(), it)));
 }
 
 DispatchCommand Program::dispatch(std::span<const std::byte> push, uint32_t x, uint32_t y, uint32_t z) const {
@@ -415,6 +1942,38 @@ DispatchCommand Program::dispatch(std::span<const std::byte> push, uint32_t x, u
 DispatchCommand Program::dispatch(uint32_t x, uint32_t y, uint32_t z) const {
     return dispatch({}, x, y, z);
 }
+DispatchCommand Program::dispatchElements(std::span<const std::byte> push,
+    uint32_t nx, uint32_t ny, uint32_t nz) const
+{
+    //round up; uses 64 bit to not overflow
+    auto& ls = program->localSize;
+    if (ls.x == 0 || ls.y == 0 || ls.z == 0)
+        throw std::logic_error("Local size of the program is not known!");
+    auto groups = [](uint32_t n, uint32_t size) -> uint32_t {
+        return static_cast<uint32_t>((uint64_t(n) + size - 1) / size);
+    };
+    return DispatchCommand(*program,
+        groups(nx, ls.x), groups(ny, ls.y), groups(nz, ls.z), push);
+}
+DispatchCommand Program::dispatchElements(uint32_t nx, uint32_t ny, uint32_t nz) const {
+    return dispatchElements({}, nx, ny, nz);
+}
+DispatchCommand Program::dispatch(const ParameterSet& set,
+    std::span<const std::byte> push, uint32_t x, uint32_t y, uint32_t z) const
+{
+    return DispatchCommand(*program, set.getParameterSet(), x, y, z, push);
+}
+DispatchCommand Program::dispatch(const ParameterSet& set, uint32_t x, uint32_t y, uint32_t z) const {
+    return dispatch(set, {}, x, y, z);
+}
+DispatchCommand Program::dispatch(const ResourceHeap& heap,
+    std::span<const std::byte> push, uint32_t x, uint32_t y, uint32_t z) const
+{
+    return DispatchCommand(*program, heap.getResourceHeap(), x, y, z, push);
+}
+DispatchCommand Program::dispatch(const ResourceHeap& heap, uint32_t x, uint32_t y, uint32_t z) const {
+    return dispatch(heap, {}, x, y, z);
+}
 
 DispatchIndirectCommand Program::dispatchIndirect(
     std::span<const std::byte> push, const Tensor<std::byte>& tensor, uint64_t offset) const
@@ -425,174 +1984,284 @@ DispatchIndirectCommand Program::dispatchIndirect(const Tensor<std::byte>& tenso
     return DispatchIndirectCommand(*program, tensor, offset, {});
 }
 
+const vulkan::Program& Program::getProgram() const noexcept {
+    return *program;
+}
+
+void setDebugName(const Program& program, std::string_view name) {
+    auto& context = *program.getContext();
+    if (!context.debugUtils)
+        return;
+    auto& p = program.getProgram();
+    std::string _name(name);
+    vulkan::setObjectName(context, VK_OBJECT_TYPE_SHADER_MODULE,
+        reinterpret_cast<uint64_t>(p.shader), _name.c_str());
+    vulkan::setObjectName(context, VK_OBJECT_TYPE_PIPELINE,
+        reinterpret_cast<uint64_t>(p.pipeline), _name.c_str());
+    vulkan::setObjectName(context, VK_OBJECT_TYPE_SHADER_EXT,
+        reinterpret_cast<uint64_t>(p.shaderObject), _name.c_str());
+    //variants are created lazily; name the ones that exist
+    std::lock_guard<std::mutex> lock(p.setMutex);
+    vulkan::setObjectName(context, VK_OBJECT_TYPE_PIPELINE,
+        reinterpret_cast<uint64_t>(p.setPipeline), _name.c_str());
+    vulkan::setObjectName(context, VK_OBJECT_TYPE_PIPELINE,
+        reinterpret_cast<uint64_t>(p.heapPipeline), _name.c_str());
+}
+
+std::vector<std::byte> Program::getShaderBinary() const {
+    if (!program->shaderObject)
+        throw std::logic_error("Program was not created as shader object! Is the extension enabled?");
+
+    auto& context = getContext();
+    size_t size = 0;
+    vulkan::checkResult(context->fnTable.vkGetShaderBinaryDataEXT(
+        context->device, program->shaderObject, &size, nullptr));
+    std::vector<std::byte> result(size);
+    vulkan::checkResult(context->fnTable.vkGetShaderBinaryDataEXT(
+        context->device, program->shaderObject, &size, result.data()));
+    result.resize(size);
+    return result;
+}
+
+namespace {
+
+//threads resident per compute unit assumed for the occupancy
+constexpr uint32_t ResidentThreadsPerUnit = 2048;
+
+double getStatisticValue(const VkPipelineExecutableStatisticKHR& stat) {
+    switch (stat.format) {
+    case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_BOOL32_KHR:
+        return stat.value.b32 ? 1.0 : 0.0;
+    case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_INT64_KHR:
+        return static_cast<double>(stat.value.i64);
+    case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_UINT64_KHR:
+        return static_cast<double>(stat.value.u64);
+    case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_FLOAT64_KHR:
+        return stat.value.f64;
+    default:
+        return 0.0;
+    }
+}
+
+//drivers name them differently, e.g. "VGPRs" or "Register Count"
+bool isRegisterStatistic(std::string_view name) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower.find("vgpr") != std::string::npos ||
+        (lower.find("register") != std::string::npos &&
+            lower.find("spill") == std::string::npos);
+}
+
+}
+
+ProgramStatistics Program::getStatistics() const {
+    auto& context = getContext();
+    auto& local = program->localSize;
+    auto threads = std::max(local.x * local.y * local.z, 1u);
+    auto sharedLimit = getDeviceInfo(context).maxSharedMemorySize;
+
+    //resident groups are limited by threads and shared memory
+    auto groups = std::max(ResidentThreadsPerUnit / threads, 1u);
+    if (program->sharedMemorySize && sharedLimit)
+        groups = std::max(std::min(groups, sharedLimit / program->sharedMemorySize), 1u);
+    ProgramStatistics result{
+        .sharedMemorySize = program->sharedMemorySize,
+        .residentGroups = groups,
+        .occupancy = std::min(static_cast<float>(groups * threads) / ResidentThreadsPerUnit, 1.0f)
+    };
+    if (!context->pipelineExecutableInfo || !program->pipeline)
+        return result;
+
+    //compute pipelines have a single executable
+    VkPipelineExecutableInfoKHR info{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_INFO_KHR,
+        .pipeline = program->pipeline,
+        .executableIndex = 0
+    };
+    uint32_t count = 0;
+    vulkan::checkResult(context->fnTable.vkGetPipelineExecutableStatisticsKHR(
+        context->device, &info, &count, nullptr));
+    std::vector<VkPipelineExecutableStatisticKHR> stats(count, {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_STATISTIC_KHR
+    });
+    vulkan::checkResult(context->fnTable.vkGetPipelineExecutableStatisticsKHR(
+        context->device, &info, &count, stats.data()));
+    stats.resize(count);
+
+    result.driverStatistics.reserve(count);
+    for (auto& stat : stats) {
+        auto& entry = result.driverStatistics.emplace_back(ProgramStatistic{
+            .name = stat.name,
+            .description = stat.description,
+            .value = getStatisticValue(stat)
+        });
+        if (!result.registerCount && isRegisterStatistic(entry.name))
+            result.registerCount = static_cast<uint32_t>(entry.value);
+    }
+    return result;
+}
+
+void Program::reload(std::span<const uint32_t> code, std::span<const std::byte> specialization) {
+    //build the new code first, so we stay unchanged if it fails
+    SubgroupRequirements subgroup{
+        .size = program->subgroupSize.requiredSubgroupSize,
+        .fullSubgroups = (program->stageFlags &
+            VK_PIPELINE_SHADER_STAGE_CREATE_REQUIRE_FULL_SUBGROUPS_BIT_EXT) != 0
+    };
+    Program next(getContext(), code, specialization, subgroup);
+    auto& prog = *program;
+    auto& other = *next.program;
+
+    //bound params stay valid if the new code has the same signature
+    auto compatible = prog.push.size == other.push.size &&
+        std::equal(prog.bindings.begin(), prog.bindings.end(),
+            other.bindings.begin(), other.bindings.end(),
+            [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+                return a.binding == b.binding &&
+                    a.descriptorType == b.descriptorType &&
+                    a.descriptorCount == b.descriptorCount;
+            });
+
+    std::scoped_lock lock(prog.setMutex, prog.paramMutex);
+    prog.retired.push_back({
+        prog.shader, prog.pipeline, prog.shaderObject, prog.setPipeline,
+        prog.heapLayout, prog.heapPipeLayout, prog.heapPipeline
+    });
+    prog.shader = std::exchange(other.shader, nullptr);
+    prog.pipeline = std::exchange(other.pipeline, nullptr);
+    prog.shaderObject = std::exchange(other.shaderObject, nullptr);
+    prog.localSize = other.localSize;
+    prog.sharedMemorySize = other.sharedMemorySize;
+    prog.robustness = other.robustness;
+    prog.entryPoint = std::move(other.entryPoint);
+    prog.specMap = std::move(other.specMap);
+    prog.specData = std::move(other.specData);
+    //variants get created again on demand
+    prog.setPipeline = nullptr;
+    prog.heapLayout = nullptr;
+    prog.heapPipeLayout = nullptr;
+    prog.heapPipeline = nullptr;
+    //the current mode might differ -> always take over the new layout
+    prog.descriptorSetLayout = other.descriptorSetLayout;
+    prog.pipeLayout = other.pipeLayout;
+    prog.cachedSets = other.cachedSets;
+    //cached sets may not match the new layout; their pools stay alive
+    //as recorded work might still use them
+    prog.setCache.clear();
+    prog.lastParams.reset();
+    prog.lastSet = nullptr;
+    if (!compatible) {
+        prog.setLayout = nullptr;
+        prog.setPipeLayout = nullptr;
+        prog.bindings = std::move(other.bindings);
+        prog.push = other.push;
+        prog.boundParams = std::move(other.boundParams);
+        prog.paramArrays = std::move(other.paramArrays);
+        bindingTraits = std::move(next.bindingTraits);
+    }
+    prog.paramSnapshot.reset();
+}
+
 Program::Program(Program&&) noexcept = default;
 Program& Program::operator=(Program&&) noexcept = default;
 
-Program::Program(ContextHandle context, std::span<const uint32_t> code, std::span<const std::byte> specialization)
+Program::Program(ContextHandle context, std::span<const uint32_t> code,
+    std::span<const std::byte> specialization, const SubgroupRequirements& subgroup,
+    std::span<const std::byte> binary)
     : Resource(std::move(context))
     , program(std::make_unique<vulkan::Program>(*getContext()))
 {
     //context reference
     auto& con = getContext();
+    //pipelines live in driver memory -> report the code size instead
+    trackResource("Program", code.size_bytes());
+
+    //reflect code; programs of the same code share the result
+    auto& cache = *con->layoutCache;
+    auto reflection = cache.findReflection(code);
+    if (!reflection)
+        reflection = cache.addReflection(code, reflect(code));
+    program->localSize = reflection->localSize;
+    program->entryPoint = reflection->entryPoint;
+    program->sharedMemorySize = reflection->sharedMemorySize;
+
+    //check subgroup requirements
+    if (subgroup.size || subgroup.fullSubgroups) {
+        auto props = getSubgroupProperties(con);
+        if (subgroup.size) {
+            if (!con->subgroupSizeControl || !props.requiredSubgroupSizeSupport)
+                throw std::logic_error("Requiring a subgroup size is not supported!");
+            if ((subgroup.size & (subgroup.size - 1)) != 0 ||
+                subgroup.size < props.minSubgroupSize ||
+                subgroup.size > props.maxSubgroupSize)
+            {
+                throw std::logic_error("Required subgroup size is not supported by the device!");
+            }
+            program->subgroupSize.requiredSubgroupSize = subgroup.size;
+        }
+        if (subgroup.fullSubgroups) {
+            if (!con->computeFullSubgroups)
+                throw std::logic_error("Requiring full subgroups is not supported!");
+            //without a required size, the driver may pick any size
+            auto size = subgroup.size ? subgroup.size : props.maxSubgroupSize;
+            if (program->localSize.x % size != 0)
+                throw std::logic_error("Local size in X must be a multiple of the subgroup size to require full subgroups!");
+            program->stageFlags |= VK_PIPELINE_SHADER_STAGE_CREATE_REQUIRE_FULL_SUBGROUPS_BIT_EXT;
+        }
+    }
 
-    //create reflection module
-    SpvReflectShaderModule reflectModule;
-    spvCheckResult(spvReflectCreateShaderModule2(
-        SPV_REFLECT_MODULE_FLAG_NO_COPY,
-        code.size_bytes(), code.data(),
-        &reflectModule));
+    //copy bindings
+    program->boundParams = reflection->params;
+    program->paramArrays.resize(program->boundParams.size());
+    program->bindings = reflection->bindings;
+    bindingTraits = reflection->traits;
+    if (reflection->pushSize) {
+        program->push = VkPushConstantRange{
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .size = reflection->pushSize
+        };
+        program->pushMembers = reflection->pushMembers;
+    }
 
-    //save local size
-    //we assume that there is exactly one entry_point
-    program->localSize = {
-        .x = reflectModule.entry_points->local_size.x,
-        .y = reflectModule.entry_points->local_size.y,
-        .z = reflectModule.entry_points->local_size.z
+    //push descriptors are limited -> fall back to cached sets if exceeded
+    VkPhysicalDevicePushDescriptorPropertiesKHR pushProps{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR
     };
-
-    //create pipeline layout; we fill this as we gather more info
-    VkPipelineLayoutCreateInfo layoutInfo{
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+    VkPhysicalDeviceProperties2 props{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &pushProps
     };
-
-    //We only support a single descriptor set
-    if (reflectModule.descriptor_set_count > 1)
-        throw std::logic_error("Programs are only allowed to have a single descriptor set!");
-    //build descriptor set layout
-    if (reflectModule.descriptor_set_count == 1) {
-        auto& set = reflectModule.descriptor_sets[0];
-
-        //count actually used params
-        auto pBinding = *set.bindings;
-        auto pBindingEnd = pBinding + set.binding_count;
-        auto param_count = static_cast<uint32_t>(std::count_if(pBinding, pBindingEnd,
-            [](const SpvReflectDescriptorBinding& b) -> bool { return b.accessed != 0; }
-        ));
-
-        //reserve binding slots
-        program->boundParams = std::vector<VkWriteDescriptorSet>(param_count);
-        bindingTraits.resize(param_count);
-
-        //Create bindings
-        std::unordered_set<uint32_t> bindingSet;
-        std::vector<VkDescriptorSetLayoutBinding> bindings(param_count);
-        for (auto i = -1; pBinding != pBindingEnd; ++pBinding) {
-            //if the file was compiled with auto binding mapping, unused bindings get mapped to 0
-            //since this might result in multiple bindigs pointing to the same, overwriting each
-            //other, we HAVE to skip unused ones. While this will later produce errors if the
-            //user wants to bind an unused parameter, he still can check the bindings of the
-            //program to see which bindings he can actually use
-            if (!pBinding->accessed)
-                continue;
-            else
-                ++i;
-
-            //save binding number to set so we can later check if there were any duplicates
-            if (bindingSet.contains(pBinding->binding))
-                throw std::runtime_error("Invalid shader code: A binding number has been assigned to multiple inputs!");
-            else
-                bindingSet.insert(pBinding->binding);
-
-            if (pBinding->count == 0)
-                throw std::runtime_error("Unbound arrays are not supported!");
-
-            bindings[i] = VkDescriptorSetLayoutBinding{
-                .binding         = pBinding->binding,
-                .descriptorType  = static_cast<VkDescriptorType>(pBinding->descriptor_type),
-                .descriptorCount = pBinding->count,
-                .stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT
-            };
-            program->boundParams[i] = VkWriteDescriptorSet{
-                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstBinding = pBinding->binding,
-                .descriptorCount = pBinding->count,
-                .descriptorType = static_cast<VkDescriptorType>(pBinding->descriptor_type)
-            };
-
-            bindingTraits[i] = {
-                .name = pBinding->name ? pBinding->name : "",
-                .binding = pBinding->binding,
-                .type = static_cast<ParameterType>(pBinding->descriptor_type),
-                .count = pBinding->count
-            };
-
-            switch (pBinding->descriptor_type) {
-            case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-                bindingTraits[i].imageTraits = ImageBindingTraits{
-                    .format = castImageFormat(pBinding->image.image_format),
-                    .dims = castDimension(pBinding->image.dim)
-                };
-                break;
-            case SPV_REFLECT_DESCRIPTOR_TYPE_STORAGE_BUFFER:
-            case SPV_REFLECT_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
-                auto name = pBinding->type_description->type_name;
-                bindingTraits[i].name = name ? name : "";
-                break;
-            }
-        }
-
-        //Create set layout
-        VkDescriptorSetLayoutCreateInfo info{
-            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-            .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR,
-            .bindingCount = param_count,
-            .pBindings    = bindings.data()
-        };
-        vulkan::checkResult(con->fnTable.vkCreateDescriptorSetLayout(
-            con->device, &info, nullptr, &program->descriptorSetLayout));
-
-        //register in pipeline layout
-        layoutInfo.setLayoutCount = 1;
-        layoutInfo.pSetLayouts = &program->descriptorSetLayout;
-    }
-
-    //read push descriptor
-    VkPushConstantRange push{};
-    if (reflectModule.push_constant_block_count > 1)
-        throw std::logic_error("Multiple push constant found, but only up to one is supported!");
-    if (reflectModule.push_constant_block_count == 1) {
-        //read push size
-        push.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-        push.size = reflectModule.push_constant_blocks->size;
-
-        //register in layout
-        layoutInfo.pushConstantRangeCount = 1;
-        layoutInfo.pPushConstantRanges = &push;
-    }
-
-    //Create pipeline layout
-    vulkan::checkResult(con->fnTable.vkCreatePipelineLayout(
-        con->device, &layoutInfo, nullptr, &program->pipeLayout));
+    vkGetPhysicalDeviceProperties2(con->physicalDevice, &props);
+    auto descriptorCount = std::accumulate(
+        program->bindings.begin(), program->bindings.end(), 0u,
+        [](uint32_t sum, const VkDescriptorSetLayoutBinding& b) { return sum + b.descriptorCount; });
+    program->cachedSets = con->descriptorSetCache || descriptorCount > pushProps.maxPushDescriptors;
+
+    //fetch layout shared by all programs with the same signature
+    auto layout = cache.getLayout(program->bindings,
+        program->cachedSets ? 0u : VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR,
+        reflection->pushSize);
+    program->descriptorSetLayout = layout.setLayout;
+    program->pipeLayout = layout.pipeLayout;
 
     //read specialization constants map
-    auto totalSpecSlots = reflectModule.spec_constant_count;
-    auto specSlots = std::min(totalSpecSlots,
+    auto& specIds = reflection->specIds;
+    auto specSlots = std::min(static_cast<uint32_t>(specIds.size()),
         static_cast<uint32_t>(specialization.size_bytes() / 4));
     std::vector<VkSpecializationMapEntry> specMap(specSlots);
-    if (specSlots > 0) {
-        //reflection might have ids out of order
-        // -> first fetch all ids, than sort them
-        std::vector<uint32_t> specIds(totalSpecSlots);
-        for (auto i = 0u; i < totalSpecSlots; ++i) {
-            specIds[i] = reflectModule.spec_constants[i].constant_id;
-        }
-        std::sort(specIds.begin(), specIds.end());
-        //create map entries only up to certain amount to match provided data
-        //(remaining ones use default values)
-        for (auto i = 0u; i < specSlots; ++i) {
-            //all types allowed for specialization are 4 bytes long
-            //we assume the spec const to be tightly packed
-            specMap[i] = VkSpecializationMapEntry{
-                .constantID = specIds[i],
-                .offset = 4 * i,
-                .size = 4
-            };
-        }
+    //create map entries only up to certain amount to match provided data
+    //(remaining ones use default values)
+    for (auto i = 0u; i < specSlots; ++i) {
+        //all types allowed for specialization are 4 bytes long
+        //we assume the spec const to be tightly packed
+        specMap[i] = VkSpecializationMapEntry{
+            .constantID = specIds[i],
+            .offset = 4 * i,
+            .size = 4
+        };
     }
 
-    //we're done reflecting
-    spvReflectDestroyShaderModule(&reflectModule);
-
     //build specialization info
     VkSpecializationInfo specInfo{
         .mapEntryCount = specSlots,
@@ -610,36 +2279,1150 @@ Program::Program(ContextHandle context, std::span<const uint32_t> code, std::spa
     vulkan::checkResult(con->fnTable.vkCreateShaderModule(
         con->device, &shaderInfo, nullptr, &program->shader));
 
+    //use shader objects instead of pipelines if enabled
+    if (isShaderObjectEnabled(*con)) {
+        VkShaderCreateFlagsEXT shaderFlags = VK_SHADER_CREATE_DISPATCH_BASE_BIT_EXT;
+        if (program->stageFlags & VK_PIPELINE_SHADER_STAGE_CREATE_REQUIRE_FULL_SUBGROUPS_BIT_EXT)
+            shaderFlags |= VK_SHADER_CREATE_REQUIRE_FULL_SUBGROUPS_BIT_EXT;
+        VkShaderCreateInfoEXT objectInfo{
+            .sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT,
+            .pNext = program->subgroupSize.requiredSubgroupSize ? &program->subgroupSize : nullptr,
+            .flags = shaderFlags,
+            .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+            .codeType = VK_SHADER_CODE_TYPE_SPIRV_EXT,
+            .codeSize = code.size_bytes(),
+            .pCode = code.data(),
+            .pName = program->entryPoint.c_str(),
+            .setLayoutCount = 1,
+            .pSetLayouts = &program->descriptorSetLayout,
+            .pushConstantRangeCount = program->push.size ? 1u : 0u,
+            .pPushConstantRanges = &program->push,
+            .pSpecializationInfo = specMap.empty() ? nullptr : &specInfo
+        };
+
+        //try the binary first and fall back to the code if incompatible
+        auto result = VK_ERROR_INCOMPATIBLE_SHADER_BINARY_EXT;
+        if (!binary.empty()) {
+            auto binaryInfo = objectInfo;
+            binaryInfo.codeType = VK_SHADER_CODE_TYPE_BINARY_EXT;
+            binaryInfo.codeSize = binary.size_bytes();
+            binaryInfo.pCode = binary.data();
+            result = con->fnTable.vkCreateShadersEXT(
+                con->device, 1, &binaryInfo, nullptr, &program->shaderObject);
+        }
+        if (result == VK_ERROR_INCOMPATIBLE_SHADER_BINARY_EXT) {
+            result = con->fnTable.vkCreateShadersEXT(
+                con->device, 1, &objectInfo, nullptr, &program->shaderObject);
+        }
+        vulkan::checkResult(result);
+
+        //keep for parameter sets
+        program->specMap = std::move(specMap);
+        program->specData.assign(specialization.begin(), specialization.end());
+        return;
+    }
+
     //Shader stage create info
     VkPipelineShaderStageCreateInfo stageInfo{
             .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .pNext = program->subgroupSize.requiredSubgroupSize ? &program->subgroupSize : nullptr,
+            .flags = program->stageFlags,
             .stage = VK_SHADER_STAGE_COMPUTE_BIT,
             .module = program->shader,
-            .pName = reflectModule.entry_point_name,
+            .pName = program->entryPoint.c_str(),
             .pSpecializationInfo = specMap.empty() ? nullptr : &specInfo
     };
 
+    //override the device's robustness if requested
+    auto robustness = con->programRobustness.load();
+    if (robustness != BufferRobustness::DEFAULT) {
+        auto behavior = robustness == BufferRobustness::ENABLED
+            ? VK_PIPELINE_ROBUSTNESS_BUFFER_BEHAVIOR_ROBUST_BUFFER_ACCESS_EXT
+            : VK_PIPELINE_ROBUSTNESS_BUFFER_BEHAVIOR_DISABLED_EXT;
+        program->robustness.storageBuffers = behavior;
+        program->robustness.uniformBuffers = behavior;
+    }
+
     //create compute pipeline
+    //dispatch base allows splitting dispatches exceeding the group count limits
     VkComputePipelineCreateInfo pipeInfo{
         .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        .pNext = vulkan::getRobustnessInfo(*program),
+        .flags = VK_PIPELINE_CREATE_DISPATCH_BASE_BIT,
         .stage = stageInfo,
         .layout = program->pipeLayout,
     };
-    vulkan::checkResult(con->fnTable.vkCreateComputePipelines(
-        con->device, con->cache,
-        1, &pipeInfo,
-        nullptr, &program->pipeline));
+    //keep statistics around for getStatistics()
+    if (con->pipelineExecutableInfo)
+        pipeInfo.flags |= VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR;
+    vulkan::createComputePipeline(*con, pipeInfo, program->pipeline);
+
+    //keep for parameter sets
+    program->specMap = std::move(specMap);
+    program->specData.assign(specialization.begin(), specialization.end());
 }
+Program::Program(ContextHandle context, std::span<const uint32_t> code,
+    std::span<const std::byte> specialization, const SubgroupRequirements& subgroup)
+    : Program(std::move(context), code, specialization, subgroup, {})
+{}
+Program::Program(ContextHandle context, std::span<const uint32_t> code, std::span<const std::byte> specialization)
+    : Program(std::move(context), code, specialization, {}, {})
+{}
 Program::Program(ContextHandle context, std::span<const uint32_t> code)
-    : Program(std::move(context), code, {})
+    : Program(std::move(context), code, {}, {}, {})
 {}
 Program::~Program() {
-    auto& context = getContext();
     if (program) {
-        context->fnTable.vkDestroyPipeline(context->device, program->pipeline, nullptr);
-        context->fnTable.vkDestroyShaderModule(context->device, program->shader, nullptr);
-        context->fnTable.vkDestroyPipelineLayout(context->device, program->pipeLayout, nullptr);
-        context->fnTable.vkDestroyDescriptorSetLayout(context->device, program->descriptorSetLayout, nullptr);
+        //work might still use the pipelines -> let the context decide when
+        auto& context = *getContext();
+        vulkan::retireResource(context, [
+            &context, program = std::shared_ptr<vulkan::Program>(std::move(program))
+        ]() {
+            context.fnTable.vkDestroyPipeline(context.device, program->pipeline, nullptr);
+            if (program->shaderObject)
+                context.fnTable.vkDestroyShaderEXT(context.device, program->shaderObject, nullptr);
+            context.fnTable.vkDestroyShaderModule(context.device, program->shader, nullptr);
+            //layouts are owned by the layout cache, except the heap ones
+            if (program->setPipeline)
+                context.fnTable.vkDestroyPipeline(context.device, program->setPipeline, nullptr);
+            if (program->heapPipeline) {
+                context.fnTable.vkDestroyPipeline(context.device, program->heapPipeline, nullptr);
+                context.fnTable.vkDestroyPipelineLayout(context.device, program->heapPipeLayout, nullptr);
+                context.fnTable.vkDestroyDescriptorSetLayout(context.device, program->heapLayout, nullptr);
+            }
+            //also frees the cached sets
+            for (auto pool : program->setPools)
+                context.fnTable.vkDestroyDescriptorPool(context.device, pool, nullptr);
+            for (auto& old : program->retired) {
+                context.fnTable.vkDestroyPipeline(context.device, old.pipeline, nullptr);
+                if (old.shaderObject)
+                    context.fnTable.vkDestroyShaderEXT(context.device, old.shaderObject, nullptr);
+                context.fnTable.vkDestroyShaderModule(context.device, old.shader, nullptr);
+                context.fnTable.vkDestroyPipeline(context.device, old.setPipeline, nullptr);
+                context.fnTable.vkDestroyPipeline(context.device, old.heapPipeline, nullptr);
+                context.fnTable.vkDestroyPipelineLayout(context.device, old.heapPipeLayout, nullptr);
+                context.fnTable.vkDestroyDescriptorSetLayout(context.device, old.heapLayout, nullptr);
+            }
+        });
+    }
+}
+
+std::vector<Program> createPrograms(
+    const ContextHandle& context,
+    std::span<const ProgramSource> sources,
+    uint32_t threads)
+{
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    threads = std::min(threads, static_cast<uint32_t>(sources.size()));
+
+    //programs have no empty state -> construct into optionals
+    std::vector<std::optional<Program>> programs(sources.size());
+    std::atomic<size_t> next = 0;
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    auto work = [&]() {
+        for (auto i = next++; i < sources.size(); i = next++) {
+            try {
+                programs[i].emplace(context, sources[i].code,
+                    sources[i].specialization, sources[i].subgroup,
+                    sources[i].binary);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+    };
+    //the calling thread participates as well
+    std::vector<std::thread> workers;
+    for (auto i = 1u; i < threads; ++i)
+        workers.emplace_back(work);
+    work();
+    for (auto& worker : workers)
+        worker.join();
+    if (error)
+        std::rethrow_exception(error);
+
+    std::vector<Program> result;
+    result.reserve(programs.size());
+    for (auto& program : programs)
+        result.push_back(std::move(*program));
+    return result;
+}
+
+/******************************* PROGRAM BUNDLE *******************************/
+
+namespace {
+
+//identifies bundle files; the last byte is the format version
+constexpr std::array<char, 8> BundleMagic = { 'H', 'P', 'B', 'U', 'N', 'D', 'L', 2 };
+
+class BundleWriter {
+public:
+    template<class T> requires std::is_trivially_copyable_v<T>
+    void write(const T& value) {
+        auto bytes = reinterpret_cast<const std::byte*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+    template<class T>
+    void writeArray(std::span<const T> values) {
+        write(static_cast<uint64_t>(values.size()));
+        auto bytes = std::as_bytes(values);
+        data.insert(data.end(), bytes.begin(), bytes.end());
+    }
+    void writeString(std::string_view str) {
+        writeArray(std::span<const char>(str.data(), str.size()));
+    }
+
+    std::vector<std::byte> data;
+};
+
+class BundleReader {
+public:
+    template<class T> requires std::is_trivially_copyable_v<T>
+    T read() {
+        T value;
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+        return value;
+    }
+    template<class T>
+    std::vector<T> readArray() {
+        auto count = read<uint64_t>();
+        if (count > data.size() / sizeof(T))
+            throw std::runtime_error("Invalid program bundle!");
+        std::vector<T> values(count);
+        std::memcpy(values.data(), take(count * sizeof(T)).data(), count * sizeof(T));
+        return values;
+    }
+    std::string readString() {
+        auto chars = readArray<char>();
+        return { chars.begin(), chars.end() };
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return data.empty(); }
+
+    explicit BundleReader(std::span<const std::byte> data)
+        : data(data)
+    {}
+
+private:
+    std::span<const std::byte> take(size_t size) {
+        if (size > data.size())
+            throw std::runtime_error("Invalid program bundle!");
+        auto result = data.first(size);
+        data = data.subspan(size);
+        return result;
+    }
+
+    std::span<const std::byte> data;
+};
+
+void writeMembers(BundleWriter& writer, const std::vector<BlockMember>& members) {
+    writer.write(static_cast<uint64_t>(members.size()));
+    for (auto& member : members) {
+        writer.writeString(member.name);
+        writer.write(member.offset);
+        writer.write(member.size);
+        writer.write(member.type);
+        writer.write(member.width);
+        writer.write(member.components);
+        writer.write(member.columns);
+        writer.write(member.matrixStride);
+        writer.write(static_cast<uint8_t>(member.rowMajor));
+        writer.writeArray<uint32_t>(member.arrayDims);
+        writer.write(member.arrayStride);
+        writeMembers(writer, member.members);
+    }
+}
+
+std::vector<BlockMember> readMembers(BundleReader& reader) {
+    //no reserve: a corrupted count throws once the data runs out
+    std::vector<BlockMember> members;
+    auto count = reader.read<uint64_t>();
+    for (auto i = 0u; i < count; ++i) {
+        BlockMember member{};
+        member.name = reader.readString();
+        member.offset = reader.read<uint32_t>();
+        member.size = reader.read<uint32_t>();
+        member.type = reader.read<MemberType>();
+        member.width = reader.read<uint32_t>();
+        member.components = reader.read<uint32_t>();
+        member.columns = reader.read<uint32_t>();
+        member.matrixStride = reader.read<uint32_t>();
+        member.rowMajor = reader.read<uint8_t>() != 0;
+        member.arrayDims = reader.readArray<uint32_t>();
+        member.arrayStride = reader.read<uint32_t>();
+        member.members = readMembers(reader);
+        members.push_back(std::move(member));
+    }
+    return members;
+}
+
+}
+
+struct ProgramBundle::pImp {
+    struct Entry {
+        std::string name;
+        std::vector<uint32_t> code;
+        std::vector<std::byte> specialization;
+        SubgroupRequirements subgroup;
+        std::shared_ptr<const vulkan::Reflection> reflection;
+    };
+    std::vector<Entry> entries;
+
+    const Entry& find(std::string_view name) const {
+        auto it = std::find_if(entries.begin(), entries.end(),
+            [name](const Entry& e) { return e.name == name; });
+        if (it == entries.end())
+            throw std::out_of_range("There is no program with the given name in the bundle: " + std::string(name));
+        return *it;
+    }
+
+    //seeds the context with the stored reflections so creating programs
+    //skips reflecting their code
+    void seed(const vulkan::Context& context) const {
+        auto& cache = *context.layoutCache;
+        for (auto& entry : entries) {
+            if (!cache.findReflection(entry.code))
+                cache.addReflection(entry.code, *entry.reflection);
+        }
+    }
+
+    std::vector<ProgramSource> getSources() const {
+        std::vector<ProgramSource> sources;
+        sources.reserve(entries.size());
+        for (auto& entry : entries) {
+            sources.push_back({
+                .code = entry.code,
+                .specialization = entry.specialization,
+                .subgroup = entry.subgroup
+            });
+        }
+        return sources;
+    }
+};
+
+size_t ProgramBundle::size() const noexcept {
+    return _pImp->entries.size();
+}
+std::vector<std::string> ProgramBundle::getNames() const {
+    std::vector<std::string> names;
+    names.reserve(_pImp->entries.size());
+    for (auto& entry : _pImp->entries)
+        names.push_back(entry.name);
+    return names;
+}
+bool ProgramBundle::contains(std::string_view name) const noexcept {
+    auto& entries = _pImp->entries;
+    return std::any_of(entries.begin(), entries.end(),
+        [name](const pImp::Entry& e) { return e.name == name; });
+}
+const LocalSize& ProgramBundle::getLocalSize(std::string_view name) const {
+    return _pImp->find(name).reflection->localSize;
+}
+std::span<const BindingTraits> ProgramBundle::getBindingTraits(std::string_view name) const {
+    return _pImp->find(name).reflection->traits;
+}
+
+void ProgramBundle::add(std::string name, std::span<const uint32_t> code,
+    std::span<const std::byte> specialization, const SubgroupRequirements& subgroup)
+{
+    if (contains(name))
+        throw std::logic_error("The bundle already contains a program with the given name: " + name);
+
+    _pImp->entries.push_back({
+        .name = std::move(name),
+        .code = { code.begin(), code.end() },
+        .specialization = { specialization.begin(), specialization.end() },
+        .subgroup = subgroup,
+        .reflection = std::make_shared<const vulkan::Reflection>(reflect(code))
+    });
+}
+
+Program ProgramBundle::createProgram(const ContextHandle& context, std::string_view name) const {
+    auto& entry = _pImp->find(name);
+    auto& cache = *context->layoutCache;
+    if (!cache.findReflection(entry.code))
+        cache.addReflection(entry.code, *entry.reflection);
+    return Program(context, entry.code, entry.specialization, entry.subgroup);
+}
+std::vector<Program> ProgramBundle::createPrograms(
+    const ContextHandle& context, uint32_t threads) const
+{
+    _pImp->seed(*context);
+    auto sources = _pImp->getSources();
+    return hephaistos::createPrograms(context, sources, threads);
+}
+std::future<void> ProgramBundle::warmUp(const ContextHandle& context, uint32_t threads) const {
+    return std::async(std::launch::async, [this, context, threads]() {
+        //dropping the programs keeps their pipelines in the cache
+        static_cast<void>(createPrograms(context, threads));
+    });
+}
+
+std::vector<std::byte> ProgramBundle::serialize() const {
+    BundleWriter writer;
+    writer.write(BundleMagic);
+    writer.write(static_cast<uint64_t>(_pImp->entries.size()));
+    for (auto& entry : _pImp->entries) {
+        writer.writeString(entry.name);
+        writer.writeArray<uint32_t>(entry.code);
+        writer.writeArray<std::byte>(entry.specialization);
+        writer.write(entry.subgroup.size);
+        writer.write(static_cast<uint8_t>(entry.subgroup.fullSubgroups));
+
+        //bindings and parameters are derived from the traits on loading
+        auto& reflection = *entry.reflection;
+        writer.write(reflection.localSize);
+        writer.writeString(reflection.entryPoint);
+        writer.write(reflection.pushSize);
+        writeMembers(writer, reflection.pushMembers);
+        writer.writeArray<uint32_t>(reflection.specIds);
+        writer.write(static_cast<uint64_t>(reflection.traits.size()));
+        for (auto& traits : reflection.traits) {
+            writer.writeString(traits.name);
+            writer.write(traits.binding);
+            writer.write(traits.type);
+            writer.write(traits.count);
+            writer.write(static_cast<uint8_t>(traits.imageTraits.has_value()));
+            if (traits.imageTraits) {
+                writer.write(traits.imageTraits->format);
+                writer.write(traits.imageTraits->dims);
+                writer.write(static_cast<uint8_t>(traits.imageTraits->arrayed));
+            }
+            writeMembers(writer, traits.members);
+        }
+    }
+    return std::move(writer.data);
+}
+
+void ProgramBundle::save(const std::filesystem::path& path) const {
+    auto data = serialize();
+
+    //write to temporary file first, so other processes never read partial data
+    auto tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()),
+            static_cast<std::streamsize>(data.size()));
+        if (!file)
+            throw std::runtime_error("Failed to write program bundle!");
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        throw std::runtime_error("Failed to write program bundle!");
+    }
+}
+
+ProgramBundle::ProgramBundle(ProgramBundle&&) noexcept = default;
+ProgramBundle& ProgramBundle::operator=(ProgramBundle&&) noexcept = default;
+
+ProgramBundle::ProgramBundle()
+    : _pImp(std::make_unique<pImp>())
+{}
+ProgramBundle::ProgramBundle(std::span<const std::byte> data)
+    : _pImp(std::make_unique<pImp>())
+{
+    BundleReader reader(data);
+    if (reader.read<std::array<char, 8>>() != BundleMagic)
+        throw std::runtime_error("Invalid program bundle!");
+
+    auto count = reader.read<uint64_t>();
+    for (auto i = 0u; i < count; ++i) {
+        pImp::Entry entry{};
+        entry.name = reader.readString();
+        entry.code = reader.readArray<uint32_t>();
+        entry.specialization = reader.readArray<std::byte>();
+        entry.subgroup.size = reader.read<uint32_t>();
+        entry.subgroup.fullSubgroups = reader.read<uint8_t>() != 0;
+
+        vulkan::Reflection reflection{};
+        reflection.localSize = reader.read<LocalSize>();
+        reflection.entryPoint = reader.readString();
+        reflection.pushSize = reader.read<uint32_t>();
+        reflection.pushMembers = readMembers(reader);
+        reflection.specIds = reader.readArray<uint32_t>();
+        auto traitCount = reader.read<uint64_t>();
+        for (auto j = 0u; j < traitCount; ++j) {
+            BindingTraits traits{};
+            traits.name = reader.readString();
+            traits.binding = reader.read<uint32_t>();
+            traits.type = reader.read<ParameterType>();
+            traits.count = reader.read<uint32_t>();
+            if (reader.read<uint8_t>()) {
+                ImageBindingTraits image{};
+                image.format = reader.read<ImageFormat>();
+                image.dims = reader.read<uint8_t>();
+                image.arrayed = reader.read<uint8_t>() != 0;
+                traits.imageTraits = image;
+            }
+            traits.members = readMembers(reader);
+
+            //same as derived by reflect()
+            auto type = static_cast<VkDescriptorType>(traits.type);
+            reflection.bindings.push_back(VkDescriptorSetLayoutBinding{
+                .binding         = traits.binding,
+                .descriptorType  = type,
+                .descriptorCount = std::max(traits.count, 1u),
+                .stageFlags      = VK_SHADER_STAGE_COMPUTE_BIT
+            });
+            reflection.params.push_back(VkWriteDescriptorSet{
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstBinding = traits.binding,
+                .descriptorCount = traits.count,
+                .descriptorType = type
+            });
+            reflection.traits.push_back(std::move(traits));
+        }
+        //derived from the code to keep the format unchanged
+        reflection.sharedMemorySize = getSharedMemorySize(entry.code);
+        entry.reflection = std::make_shared<const vulkan::Reflection>(std::move(reflection));
+
+        if (contains(entry.name))
+            throw std::runtime_error("Invalid program bundle!");
+        _pImp->entries.push_back(std::move(entry));
+    }
+    if (!reader.empty())
+        throw std::runtime_error("Invalid program bundle!");
+}
+ProgramBundle::ProgramBundle(const std::filesystem::path& path)
+    : _pImp(std::make_unique<pImp>())
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Failed to read program bundle!");
+    std::vector<char> data{
+        std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>()
+    };
+    *this = ProgramBundle(std::as_bytes(std::span<const char>(data)));
+}
+ProgramBundle::~ProgramBundle() = default;
+
+/******************************* PROGRAM FAMILY *******************************/
+
+struct ProgramFamily::pImp {
+    ContextHandle context;
+    std::vector<uint32_t> code;
+    SubgroupRequirements subgroup;
+
+    //variants keyed by their specialization data
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, std::unique_ptr<Program>> variants;
+};
+
+size_t ProgramFamily::size() const {
+    std::lock_guard<std::mutex> lock(_pImp->mutex);
+    return _pImp->variants.size();
+}
+
+Program& ProgramFamily::getVariant(std::span<const std::byte> specialization) {
+    std::string key(reinterpret_cast<const char*>(specialization.data()), specialization.size());
+    {
+        std::lock_guard<std::mutex> lock(_pImp->mutex);
+        auto it = _pImp->variants.find(key);
+        if (it != _pImp->variants.end())
+            return *it->second;
+    }
+
+    //compile without holding the lock, so other variants can be fetched
+    auto program = std::make_unique<Program>(
+        _pImp->context, _pImp->code, specialization, _pImp->subgroup);
+    std::lock_guard<std::mutex> lock(_pImp->mutex);
+    //another thread might have been faster -> keep theirs
+    auto it = _pImp->variants.try_emplace(std::move(key), std::move(program)).first;
+    return *it->second;
+}
+
+void ProgramFamily::clear() {
+    std::lock_guard<std::mutex> lock(_pImp->mutex);
+    _pImp->variants.clear();
+}
+
+ProgramFamily::ProgramFamily(ProgramFamily&&) noexcept = default;
+ProgramFamily& ProgramFamily::operator=(ProgramFamily&&) noexcept = default;
+
+ProgramFamily::ProgramFamily(ContextHandle context, std::span<const uint32_t> code,
+    const SubgroupRequirements& subgroup)
+    : _pImp(std::make_unique<pImp>())
+{
+    _pImp->context = std::move(context);
+    _pImp->code.assign(code.begin(), code.end());
+    _pImp->subgroup = subgroup;
+}
+ProgramFamily::~ProgramFamily() = default;
+
+/******************************** PROGRAM CACHE *******************************/
+
+namespace {
+
+//FNV-1a over code, specialization and subgroup requirements; only used to
+//find candidates, which are compared afterwards
+uint64_t hashProgramKey(
+    std::span<const uint32_t> code,
+    std::span<const std::byte> specialization,
+    const SubgroupRequirements& subgroup)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (auto word : code) {
+        hash ^= word;
+        hash *= 1099511628211ull;
+    }
+    for (auto byte : specialization) {
+        hash ^= static_cast<uint8_t>(byte);
+        hash *= 1099511628211ull;
+    }
+    hash ^= subgroup.size | (uint64_t(subgroup.fullSubgroups) << 32);
+    hash *= 1099511628211ull;
+    return hash;
+}
+
+}
+
+struct ProgramCache::pImp {
+    struct Entry {
+        uint64_t hash;
+        //code is kept to rule out hash collisions
+        std::shared_ptr<const std::vector<uint32_t>> code;
+        std::vector<std::byte> specialization;
+        SubgroupRequirements subgroup;
+        std::shared_ptr<Program> program;
+    };
+
+    ContextHandle context;
+    ProgramCacheLimits limits;
+
+    mutable std::mutex mutex;
+    //most recently used first
+    std::list<Entry> entries;
+    std::unordered_multimap<uint64_t, std::list<Entry>::iterator> index;
+    uint64_t codeSize = 0;
+    ProgramCacheStatistics statistics = {};
+    //compiled code keyed by the compiler's cache key; expires once no cached
+    //program uses it anymore
+    std::unordered_map<uint64_t, std::weak_ptr<const std::vector<uint32_t>>> sources;
+
+    std::list<Entry>::iterator find(uint64_t hash,
+        std::span<const uint32_t> code,
+        std::span<const std::byte> specialization,
+        const SubgroupRequirements& subgroup)
+    {
+        auto [begin, end] = index.equal_range(hash);
+        for (auto it = begin; it != end; ++it) {
+            auto& entry = *it->second;
+            if (std::ranges::equal(*entry.code, code) &&
+                std::ranges::equal(entry.specialization, specialization) &&
+                entry.subgroup.size == subgroup.size &&
+                entry.subgroup.fullSubgroups == subgroup.fullSubgroups)
+            {
+                return it->second;
+            }
+        }
+        return entries.end();
+    }
+
+    void evict() {
+        auto exceeds = [this]() {
+            return (limits.maxPrograms && entries.size() > limits.maxPrograms) ||
+                (limits.maxCodeSize && codeSize > limits.maxCodeSize);
+        };
+        while (!entries.empty() && exceeds()) {
+            auto last = std::prev(entries.end());
+            auto [begin, end] = index.equal_range(last->hash);
+            for (auto it = begin; it != end; ++it) {
+                if (it->second == last) {
+                    index.erase(it);
+                    break;
+                }
+            }
+            codeSize -= last->code->size() * sizeof(uint32_t);
+            entries.erase(last);
+            ++statistics.evictions;
+        }
+        //drop expired sources
+        std::erase_if(sources, [](const auto& s) { return s.second.expired(); });
+    }
+
+    std::shared_ptr<Program> get(
+        std::shared_ptr<const std::vector<uint32_t>> code,
+        std::span<const std::byte> specialization,
+        const SubgroupRequirements& subgroup)
+    {
+        auto hash = hashProgramKey(*code, specialization, subgroup);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = find(hash, *code, specialization, subgroup);
+            if (it != entries.end()) {
+                entries.splice(entries.begin(), entries, it);
+                ++statistics.hits;
+                return it->program;
+            }
+        }
+
+        //create without holding the lock, so other programs can be fetched
+        auto program = std::make_shared<Program>(context, *code, specialization, subgroup);
+        std::lock_guard<std::mutex> lock(mutex);
+        //another thread might have been faster -> keep theirs
+        auto it = find(hash, *code, specialization, subgroup);
+        if (it != entries.end()) {
+            entries.splice(entries.begin(), entries, it);
+            ++statistics.hits;
+            return it->program;
+        }
+        ++statistics.misses;
+        codeSize += code->size() * sizeof(uint32_t);
+        entries.push_front({
+            hash,
+            std::move(code),
+            { specialization.begin(), specialization.end() },
+            subgroup,
+            program
+        });
+        index.emplace(hash, entries.begin());
+        evict();
+        return program;
+    }
+};
+
+size_t ProgramCache::size() const {
+    std::lock_guard<std::mutex> lock(_pImp->mutex);
+    return _pImp->entries.size();
+}
+uint64_t ProgramCache::getCodeSize() const {
+    std::lock_guard<std::mutex> lock(_pImp->mutex);
+    return _pImp->codeSize;
+}
+ProgramCacheStatistics ProgramCache::getStatistics() const {
+    std::lock_guard<std::mutex> lock(_pImp->mutex);
+    return _pImp->statistics;
+}
+
+ProgramCacheLimits ProgramCache::getLimits() const {
+    std::lock_guard<std::mutex> lock(_pImp->mutex);
+    return _pImp->limits;
+}
+void ProgramCache::setLimits(const ProgramCacheLimits& limits) {
+    std::lock_guard<std::mutex> lock(_pImp->mutex);
+    _pImp->limits = limits;
+    _pImp->evict();
+}
+
+std::shared_ptr<Program> ProgramCache::get(
+    std::span<const uint32_t> code,
+    std::span<const std::byte> specialization,
+    const SubgroupRequirements& subgroup)
+{
+    return _pImp->get(
+        std::make_shared<const std::vector<uint32_t>>(code.begin(), code.end()),
+        specialization, subgroup);
+}
+
+std::shared_ptr<Program> ProgramCache::compile(
+    const Compiler& compiler,
+    std::string_view source,
+    std::span<const std::byte> specialization,
+    const SubgroupRequirements& subgroup)
+{
+    auto key = compiler.getCacheKey(source);
+    std::shared_ptr<const std::vector<uint32_t>> code;
+    {
+        std::lock_guard<std::mutex> lock(_pImp->mutex);
+        auto it = _pImp->sources.find(key);
+        if (it != _pImp->sources.end())
+            code = it->second.lock();
+    }
+    if (!code) {
+        code = std::make_shared<const std::vector<uint32_t>>(compiler.compile(source));
+        std::lock_guard<std::mutex> lock(_pImp->mutex);
+        _pImp->sources[key] = code;
+    }
+    return _pImp->get(std::move(code), specialization, subgroup);
+}
+
+void ProgramCache::clear() {
+    std::lock_guard<std::mutex> lock(_pImp->mutex);
+    _pImp->entries.clear();
+    _pImp->index.clear();
+    _pImp->sources.clear();
+    _pImp->codeSize = 0;
+}
+
+ProgramCache::ProgramCache(ProgramCache&&) noexcept = default;
+ProgramCache& ProgramCache::operator=(ProgramCache&&) noexcept = default;
+
+ProgramCache::ProgramCache(ContextHandle context, const ProgramCacheLimits& limits)
+    : _pImp(std::make_unique<pImp>())
+{
+    _pImp->context = std::move(context);
+    _pImp->limits = limits;
+}
+ProgramCache::~ProgramCache() = default;
+
+/******************************** PARAMETER SET *******************************/
+
+void ParameterSet::bindParameterArray(std::span<const Argument* const> params, uint32_t binding) {
+    if (binding >= set->params.size())
+        throw std::runtime_error("There is no binding point at specified number! Binding: " + std::to_string(binding));
+
+    set->arrays[binding] = vulkan::writeParamArray(*getContext(),
+        set->params[binding], bindingTraits[binding].count, params);
+}
+void ParameterSet::bindParameterArray(std::span<const Argument* const> params, std::string_view binding) {
+    const auto& b = bindingTraits;
+    auto it = std::find_if(b.begin(), b.end(), [binding](const BindingTraits& t) -> bool {
+        return t.name == binding;
+    });
+
+    if (it == b.end())
+        throw std::runtime_error("There is no binding point at specified location! Binding name: " + std::string(binding));
+
+    bindParameterArray(params, static_cast<uint32_t>(std::distance(b.begin(), it)));
+}
+
+VkWriteDescriptorSet& ParameterSet::getBinding(uint32_t i) {
+    if (i >= set->params.size())
+        throw std::runtime_error("There is no binding point at specified number! Binding: " + std::to_string(i));
+
+    //a single argument replaces previously bound arrays
+    set->arrays[i].reset();
+    set->params[i].descriptorCount = vulkan::getSingleCount(bindingTraits[i].count);
+    return set->params[i];
+}
+VkWriteDescriptorSet& ParameterSet::getBinding(std::string_view name) {
+    const auto& b = bindingTraits;
+    auto it = std::find_if(b.begin(), b.end(), [name](const BindingTraits& t) -> bool {
+        return t.name == name;
+    });
+
+    if (it == b.end())
+        throw std::runtime_error("There is no binding point at specified location! Binding name: " + std::string(name));
+
+    return getBinding(static_cast<uint32_t>(std::distance(b.begin(), it)));
+}
+const std::vector<BindingTraits>& ParameterSet::listBindings() const noexcept {
+    return bindingTraits;
+}
+const vulkan::ParameterSet& ParameterSet::getParameterSet() const noexcept {
+    return *set;
+}
+
+void ParameterSet::update() {
+    //sanity check: all params are bound (will throw if not)
+    vulkan::checkAllBound(set->params);
+
+    auto& context = getContext();
+    if (!set->descriptors) {
+        context->fnTable.vkUpdateDescriptorSets(context->device,
+            static_cast<uint32_t>(set->params.size()), set->params.data(),
+            0, nullptr);
+        return;
+    }
+
+    //write descriptors directly into the buffer
+    auto& buffer = *set->descriptors;
+    auto memory = static_cast<std::byte*>(buffer.allocInfo.pMappedData);
+    for (auto i = 0u; i < set->params.size(); ++i) {
+        auto& param = set->params[i];
+        auto [offset, stride] = set->descriptorLayout[i];
+        for (auto j = 0u; j < param.descriptorCount; ++j) {
+            VkDescriptorGetInfoEXT info{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                .type = param.descriptorType
+            };
+            VkDescriptorAddressInfoEXT addressInfo{
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT
+            };
+            switch (param.descriptorType) {
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER: {
+                auto& bufferInfo = param.pBufferInfo[j];
+                VkBufferDeviceAddressInfo deviceAddressInfo{
+                    .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+                    .buffer = bufferInfo.buffer
+                };
+                addressInfo.address = context->fnTable.vkGetBufferDeviceAddress(
+                    context->device, &deviceAddressInfo) + bufferInfo.offset;
+                addressInfo.range = bufferInfo.range;
+                if (param.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+                    info.data.pStorageBuffer = &addressInfo;
+                else
+                    info.data.pUniformBuffer = &addressInfo;
+                break;
+            }
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                info.data.pStorageImage = &param.pImageInfo[j];
+                break;
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+                info.data.pCombinedImageSampler = &param.pImageInfo[j];
+                break;
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+                info.data.pSampledImage = &param.pImageInfo[j];
+                break;
+            case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR: {
+                auto write = static_cast<const VkWriteDescriptorSetAccelerationStructureKHR*>(
+                    param.pNext);
+                VkAccelerationStructureDeviceAddressInfoKHR asInfo{
+                    .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR,
+                    .accelerationStructure = write->pAccelerationStructures[j]
+                };
+                info.data.accelerationStructure =
+                    context->fnTable.vkGetAccelerationStructureDeviceAddressKHR(
+                        context->device, &asInfo);
+                break;
+            }
+            default:
+                throw std::logic_error("Unsupported descriptor type!");
+            }
+            context->fnTable.vkGetDescriptorEXT(context->device,
+                &info, stride, memory + offset + j * stride);
+        }
+    }
+    //memory might not be coherent
+    vulkan::checkResult(vmaFlushAllocation(context->allocator,
+        buffer.allocation, buffer.offset, buffer.size));
+}
+
+ParameterSet::ParameterSet(ParameterSet&&) noexcept = default;
+ParameterSet& ParameterSet::operator=(ParameterSet&&) noexcept = default;
+
+ParameterSet::ParameterSet(const Program& program)
+    : Resource(program.getContext())
+    , set(std::make_unique<vulkan::ParameterSet>(program.getProgram()))
+    , bindingTraits(program.listBindings())
+{
+    auto& context = getContext();
+    auto& prog = program.getProgram();
+    if (prog.bindings.empty())
+        throw std::logic_error("Program does not have any parameters to bind!");
+    vulkan::checkNoRuntimeArrays(prog.boundParams);
+    vulkan::createSetPipeline(prog);
+
+    if (isDescriptorBufferEnabled(*context)) {
+        //sub-allocate the set from a shared descriptor buffer
+        VkDeviceSize size;
+        context->fnTable.vkGetDescriptorSetLayoutSizeEXT(
+            context->device, prog.setLayout, &size);
+        set->descriptors = vulkan::createDescriptorBuffer(context, size);
+        VkBufferDeviceAddressInfo addressInfo{
+            .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+            .buffer = set->descriptors->buffer
+        };
+        set->descriptorAddress = context->fnTable.vkGetBufferDeviceAddress(
+            context->device, &addressInfo);
+
+        VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptorProps{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT
+        };
+        VkPhysicalDeviceProperties2 props{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &descriptorProps
+        };
+        vkGetPhysicalDeviceProperties2(context->physicalDevice, &props);
+        auto getDescriptorSize = [&descriptorProps](VkDescriptorType type) -> VkDeviceSize {
+            switch (type) {
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+                return descriptorProps.storageBufferDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+                return descriptorProps.uniformBufferDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+                return descriptorProps.storageImageDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+                return descriptorProps.combinedImageSamplerDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+                return descriptorProps.sampledImageDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+                return descriptorProps.accelerationStructureDescriptorSize;
+            default:
+                throw std::logic_error("Unsupported descriptor type!");
+            }
+        };
+
+        //params follow the order of the program's bindings
+        set->descriptorLayout.reserve(prog.bindings.size());
+        for (auto& binding : prog.bindings) {
+            VkDeviceSize offset;
+            context->fnTable.vkGetDescriptorSetLayoutBindingOffsetEXT(
+                context->device, prog.setLayout, binding.binding, &offset);
+            set->descriptorLayout.emplace_back(
+                offset, getDescriptorSize(binding.descriptorType));
+        }
+    }
+    else {
+        //pool only needs to fit this set
+        std::vector<VkDescriptorPoolSize> sizes;
+        for (auto& binding : prog.bindings) {
+            auto it = std::find_if(sizes.begin(), sizes.end(),
+                [&binding](const VkDescriptorPoolSize& s) { return s.type == binding.descriptorType; });
+            if (it != sizes.end())
+                it->descriptorCount += binding.descriptorCount;
+            else
+                sizes.push_back({ binding.descriptorType, binding.descriptorCount });
+        }
+        VkDescriptorPoolCreateInfo poolInfo{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .maxSets = 1,
+            .poolSizeCount = static_cast<uint32_t>(sizes.size()),
+            .pPoolSizes = sizes.data()
+        };
+        vulkan::checkResult(context->fnTable.vkCreateDescriptorPool(
+            context->device, &poolInfo, nullptr, &set->pool));
+
+        VkDescriptorSetAllocateInfo allocInfo{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+            .descriptorPool = set->pool,
+            .descriptorSetCount = 1,
+            .pSetLayouts = &prog.setLayout
+        };
+        vulkan::checkResult(context->fnTable.vkAllocateDescriptorSets(
+            context->device, &allocInfo, &set->set));
+    }
+
+    //start with the program's layout, but nothing bound
+    set->arrays.resize(prog.boundParams.size());
+    set->params.reserve(prog.boundParams.size());
+    for (auto& param : prog.boundParams) {
+        set->params.push_back(VkWriteDescriptorSet{
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = set->set,
+            .dstBinding = param.dstBinding,
+            .descriptorCount = param.descriptorCount,
+            .descriptorType = param.descriptorType
+        });
+    }
+}
+ParameterSet::~ParameterSet() {
+    if (set) {
+        auto& context = getContext();
+        //also frees the set; null if descriptor buffers are used
+        context->fnTable.vkDestroyDescriptorPool(context->device, set->pool, nullptr);
+    }
+}
+
+/******************************* RESOURCE HEAP ********************************/
+
+namespace {
+
+//writes the argument's descriptor at the given index and returns its type
+VkDescriptorType writeHeap(const vulkan::Context& context,
+    const vulkan::ResourceHeap& heap, uint32_t index, const Argument& arg)
+{
+    VkWriteDescriptorSet write{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = heap.set,
+        .dstArrayElement = index,
+        .descriptorCount = 1
+    };
+    arg.bindParameter(write);
+
+    //arguments do not know their type -> infer it from the infos
+    //texel buffers also provide a buffer info, so check them first
+    if (write.pTexelBufferView)
+        throw std::logic_error("Only tensors, images and textures can be added to a ResourceHeap!");
+    else if (write.pBufferInfo)
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    else if (write.pImageInfo && write.pImageInfo->sampler)
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    else if (write.pImageInfo)
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    else
+        throw std::logic_error("Only tensors, images and textures can be added to a ResourceHeap!");
+    write.dstBinding = static_cast<uint32_t>(std::distance(vulkan::HeapBindings.begin(),
+        std::find(vulkan::HeapBindings.begin(), vulkan::HeapBindings.end(), write.descriptorType)));
+
+    context.fnTable.vkUpdateDescriptorSets(context.device, 1, &write, 0, nullptr);
+    return write.descriptorType;
+}
+
+}
+
+uint32_t ResourceHeap::capacity() const noexcept {
+    return heap->capacity;
+}
+uint32_t ResourceHeap::size() const noexcept {
+    return static_cast<uint32_t>(heap->types.size() - heap->freeList.size());
+}
+
+uint32_t ResourceHeap::add(const Argument& arg) {
+    //prefer reusing indices to keep the used range small
+    auto reuse = !heap->freeList.empty();
+    if (!reuse && heap->types.size() >= heap->capacity)
+        throw std::logic_error("ResourceHeap is full!");
+    auto index = reuse ? heap->freeList.back() : static_cast<uint32_t>(heap->types.size());
+
+    auto type = writeHeap(*getContext(), *heap, index, arg);
+    if (reuse) {
+        heap->freeList.pop_back();
+        heap->types[index] = type;
+    }
+    else {
+        heap->types.push_back(type);
+    }
+    return index;
+}
+void ResourceHeap::set(uint32_t index, const Argument& arg) {
+    if (index >= heap->types.size() || heap->types[index] == VK_DESCRIPTOR_TYPE_MAX_ENUM)
+        throw std::logic_error("There is no resource at the given index!");
+    heap->types[index] = writeHeap(*getContext(), *heap, index, arg);
+}
+void ResourceHeap::remove(uint32_t index) {
+    if (index >= heap->types.size() || heap->types[index] == VK_DESCRIPTOR_TYPE_MAX_ENUM)
+        throw std::logic_error("There is no resource at the given index!");
+    //descriptors are partially bound -> simply leave the old one
+    heap->types[index] = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+    heap->freeList.push_back(index);
+}
+
+const vulkan::ResourceHeap& ResourceHeap::getResourceHeap() const noexcept {
+    return *heap;
+}
+
+ResourceHeap::ResourceHeap(ResourceHeap&&) noexcept = default;
+ResourceHeap& ResourceHeap::operator=(ResourceHeap&&) noexcept = default;
+
+ResourceHeap::ResourceHeap(ContextHandle context)
+    : Resource(std::move(context))
+    , heap(std::make_unique<vulkan::ResourceHeap>())
+{
+    auto& con = getContext();
+    auto ext = getResourceHeapExtension(*con);
+    if (!ext)
+        throw std::logic_error("Resource heaps are not enabled!");
+    heap->capacity = ext->getCapacity();
+
+    heap->layout = vulkan::createHeapLayout(*con, heap->capacity);
+    std::array<VkDescriptorPoolSize, vulkan::HeapBindings.size()> sizes;
+    for (auto i = 0u; i < sizes.size(); ++i)
+        sizes[i] = { vulkan::HeapBindings[i], heap->capacity };
+    VkDescriptorPoolCreateInfo poolInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets = 1,
+        .poolSizeCount = static_cast<uint32_t>(sizes.size()),
+        .pPoolSizes = sizes.data()
+    };
+    vulkan::checkResult(con->fnTable.vkCreateDescriptorPool(
+        con->device, &poolInfo, nullptr, &heap->pool));
+
+    VkDescriptorSetAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = heap->pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &heap->layout
+    };
+    vulkan::checkResult(con->fnTable.vkAllocateDescriptorSets(
+        con->device, &allocInfo, &heap->set));
+}
+ResourceHeap::~ResourceHeap() {
+    if (heap) {
+        auto& context = getContext();
+        //also frees the set
+        context->fnTable.vkDestroyDescriptorPool(context->device, heap->pool, nullptr);
+        context->fnTable.vkDestroyDescriptorSetLayout(context->device, heap->layout, nullptr);
     }
 }
 
@@ -657,6 +3440,7 @@ const VkMemoryBarrier memoryBarrier {
 
 void FlushMemoryCommand::record(vulkan::Command& cmd) const {
     cmd.stage |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    vulkan::count(context.get().counters.barriers);
     context.get().fnTable.vkCmdPipelineBarrier(cmd.buffer,
         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
@@ -674,4 +3458,476 @@ FlushMemoryCommand::FlushMemoryCommand(const ContextHandle& context)
 {}
 FlushMemoryCommand::~FlushMemoryCommand() = default;
 
+/**************************** RAY TRACING PROGRAM *****************************/
+
+namespace vulkan {
+
+struct RayTracingProgram {
+    //layouts are owned by the context's layout cache
+    VkDescriptorSetLayout descriptorSetLayout = nullptr;
+    VkPipelineLayout pipeLayout = nullptr;
+    std::vector<VkShaderModule> shaders;
+    VkPipeline pipeline = nullptr;
+    uint32_t set = 0;
+
+    //merged bindings of all shaders
+    std::vector<VkWriteDescriptorSet> boundParams;
+    //same as for compute programs
+    mutable std::shared_ptr<const std::vector<VkWriteDescriptorSet>> paramSnapshot;
+    mutable std::mutex paramMutex;
+
+    //shader binding table; records hold only the group handles
+    BufferHandle sbt = createEmptyBuffer();
+    VkStridedDeviceAddressRegionKHR rayGenRegion{};
+    VkStridedDeviceAddressRegionKHR missRegion{};
+    VkStridedDeviceAddressRegionKHR hitRegion{};
+    //unused, as there are no callable shaders
+    VkStridedDeviceAddressRegionKHR callableRegion{};
+
+    uint32_t missCount = 0;
+    uint32_t hitGroupCount = 0;
+
+    const Context& context;
+
+    RayTracingProgram(const Context& context)
+        : context(context)
+    {}
+};
+
+}
+
+namespace {
+
+constexpr VkShaderStageFlags RayTracingStages =
+    VK_SHADER_STAGE_RAYGEN_BIT_KHR |
+    VK_SHADER_STAGE_MISS_BIT_KHR |
+    VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR |
+    VK_SHADER_STAGE_ANY_HIT_BIT_KHR |
+    VK_SHADER_STAGE_INTERSECTION_BIT_KHR;
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}
+
+void TraceRaysCommand::record(vulkan::Command& cmd) const {
+    auto& prog = program.get();
+    auto& context = prog.context;
+    constexpr auto stages =
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT |
+        VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR |
+        VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+    cmd.stage |= VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR;
+
+    //FlushMemoryCommand only covers the compute stage, so without tracking
+    //fence the ray tracing stage against everything around it
+    if (cmd.tracker) {
+        vulkan::trackParams(*cmd.tracker, *params,
+            VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR);
+        cmd.tracker->barrier(context, cmd);
+    }
+    else {
+        vulkan::count(context.counters.barriers);
+        context.fnTable.vkCmdPipelineBarrier(cmd.buffer,
+            stages, VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR, 0,
+            1, &memoryBarrier, 0, nullptr, 0, nullptr);
+    }
+
+    //the bind state only tracks the compute bind point -> bind everything
+    context.fnTable.vkCmdBindPipeline(cmd.buffer,
+        VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR,
+        prog.pipeline);
+    if (!params->empty()) {
+        context.fnTable.vkCmdPushDescriptorSetKHR(cmd.buffer,
+            VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR,
+            prog.pipeLayout,
+            prog.set,
+            static_cast<uint32_t>(params->size()),
+            params->data());
+    }
+    if (!pushData.empty()) {
+        context.fnTable.vkCmdPushConstants(cmd.buffer,
+            prog.pipeLayout,
+            RayTracingStages,
+            0,
+            static_cast<uint32_t>(pushData.size_bytes()),
+            pushData.data());
+    }
+
+    vulkan::count(context.counters.dispatches);
+    context.fnTable.vkCmdTraceRaysKHR(cmd.buffer,
+        &prog.rayGenRegion,
+        &prog.missRegion,
+        &prog.hitRegion,
+        &prog.callableRegion,
+        width, height, depth);
+
+    //push constants and descriptors may have been disturbed
+    cmd.bound = {};
+    if (!cmd.tracker) {
+        vulkan::count(context.counters.barriers);
+        context.fnTable.vkCmdPipelineBarrier(cmd.buffer,
+            VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR, stages, 0,
+            1, &memoryBarrier, 0, nullptr, 0, nullptr);
+    }
+}
+
+TraceRaysCommand::TraceRaysCommand(const TraceRaysCommand&) = default;
+TraceRaysCommand& TraceRaysCommand::operator=(const TraceRaysCommand&) = default;
+
+TraceRaysCommand::TraceRaysCommand(TraceRaysCommand&&) noexcept = default;
+TraceRaysCommand& TraceRaysCommand::operator=(TraceRaysCommand&&) noexcept = default;
+
+TraceRaysCommand::TraceRaysCommand(
+    const vulkan::RayTracingProgram& program,
+    uint32_t width, uint32_t height, uint32_t depth,
+    std::span<const std::byte> push
+)
+    : width(width)
+    , height(height)
+    , depth(depth)
+    , pushData(push)
+    , program(std::cref(program))
+    , params(vulkan::snapshotParams(program))
+{}
+TraceRaysCommand::~TraceRaysCommand() = default;
+
+const BindingTraits& RayTracingProgram::getBindingTraits(uint32_t i) const {
+    if (i >= bindingTraits.size())
+        throw std::runtime_error("There is no binding point at specified number!");
+
+    return bindingTraits[i];
+}
+const BindingTraits& RayTracingProgram::getBindingTraits(std::string_view name) const {
+    const auto& b = bindingTraits;
+    auto it = std::find_if(b.begin(), b.end(), [name](const BindingTraits& t) -> bool {
+        return t.name == name;
+    });
+
+    if (it == b.end())
+        throw std::runtime_error("There is no binding point at specified location!");
+
+    return *it;
+}
+
+bool RayTracingProgram::isBindingBound(uint32_t i) const {
+    if (i >= bindingTraits.size())
+        throw std::runtime_error("There is no binding point at specified number!");
+
+    return !vulkan::isDescriptorSetEmpty(program->boundParams[i]);
+}
+
+const std::vector<BindingTraits>& RayTracingProgram::listBindings() const noexcept {
+    return bindingTraits;
+}
+
+uint32_t RayTracingProgram::getMissCount() const noexcept {
+    return program->missCount;
+}
+uint32_t RayTracingProgram::getHitGroupCount() const noexcept {
+    return program->hitGroupCount;
+}
+
+VkWriteDescriptorSet& RayTracingProgram::getBinding(uint32_t i) {
+    if (i >= program->boundParams.size())
+        throw std::runtime_error("There is no binding point at specified number! Binding: " + std::to_string(i));
+
+    vulkan::resetSnapshot(*program);
+    return program->boundParams[i];
+}
+VkWriteDescriptorSet& RayTracingProgram::getBinding(std::string_view name) {
+    const auto& b = bindingTraits;
+    auto it = std::find_if(b.begin(), b.end(), [name](const BindingTraits& t) -> bool {
+        return t.name == name;
+    });
+
+    if (it == b.end())
+        throw std::runtime_error("There is no binding point at specified location! Binding name: " + std::string(name));
+
+    auto i = std::distance(b.begin(), it);
+    vulkan::resetSnapshot(*program);
+    return program->boundParams[i];
+}
+
+TraceRaysCommand RayTracingProgram::traceRays(std::span<const std::byte> push,
+    uint32_t width, uint32_t height, uint32_t depth) const
+{
+    return TraceRaysCommand(*program, width, height, depth, push);
+}
+TraceRaysCommand RayTracingProgram::traceRays(
+    uint32_t width, uint32_t height, uint32_t depth) const
+{
+    return traceRays({}, width, height, depth);
+}
+
+const vulkan::RayTracingProgram& RayTracingProgram::getProgram() const noexcept {
+    return *program;
+}
+
+RayTracingProgram::RayTracingProgram(RayTracingProgram&&) noexcept = default;
+RayTracingProgram& RayTracingProgram::operator=(RayTracingProgram&&) noexcept = default;
+
+RayTracingProgram::RayTracingProgram(ContextHandle context,
+    const RayTracingShaders& shaders,
+    std::span<const std::byte> specialization,
+    uint32_t maxRecursionDepth)
+    : Resource(std::move(context))
+    , program(std::make_unique<vulkan::RayTracingProgram>(*getContext()))
+{
+    auto& con = getContext();
+    if (!isRaytracingPipelineEnabled(con))
+        throw std::logic_error("Ray tracing pipelines are not enabled!");
+    if (shaders.rayGen.empty())
+        throw std::logic_error("Ray tracing programs require a ray generation shader!");
+
+    //collect stages in the order of their groups: ray gen, miss, hit groups
+    struct Stage {
+        std::span<const uint32_t> code;
+        VkShaderStageFlagBits stage;
+    };
+    std::vector<Stage> stages;
+    stages.push_back({ shaders.rayGen, VK_SHADER_STAGE_RAYGEN_BIT_KHR });
+    for (auto& miss : shaders.miss)
+        stages.push_back({ miss, VK_SHADER_STAGE_MISS_BIT_KHR });
+    std::vector<VkRayTracingShaderGroupCreateInfoKHR> groups(
+        1 + shaders.miss.size() + shaders.hitGroups.size(),
+        VkRayTracingShaderGroupCreateInfoKHR{
+            .sType = VK_STRUCTURE_TYPE_RAY_TRACING_SHADER_GROUP_CREATE_INFO_KHR,
+            .type = VK_RAY_TRACING_SHADER_GROUP_TYPE_GENERAL_KHR,
+            .generalShader = VK_SHADER_UNUSED_KHR,
+            .closestHitShader = VK_SHADER_UNUSED_KHR,
+            .anyHitShader = VK_SHADER_UNUSED_KHR,
+            .intersectionShader = VK_SHADER_UNUSED_KHR
+        });
+    for (auto i = 0u; i < stages.size(); ++i)
+        groups[i].generalShader = i;
+    auto nextGroup = stages.size();
+    for (auto& hit : shaders.hitGroups) {
+        auto& group = groups[nextGroup++];
+        auto addStage = [&stages](std::span<const uint32_t> code, VkShaderStageFlagBits stage) {
+            if (code.empty())
+                return VK_SHADER_UNUSED_KHR;
+            stages.push_back({ code, stage });
+            return static_cast<uint32_t>(stages.size() - 1);
+        };
+        group.type = hit.intersection.empty()
+            ? VK_RAY_TRACING_SHADER_GROUP_TYPE_TRIANGLES_HIT_GROUP_KHR
+            : VK_RAY_TRACING_SHADER_GROUP_TYPE_PROCEDURAL_HIT_GROUP_KHR;
+        group.closestHitShader = addStage(hit.closestHit, VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR);
+        group.anyHitShader = addStage(hit.anyHit, VK_SHADER_STAGE_ANY_HIT_BIT_KHR);
+        group.intersectionShader = addStage(hit.intersection, VK_SHADER_STAGE_INTERSECTION_BIT_KHR);
+    }
+    program->missCount = static_cast<uint32_t>(shaders.miss.size());
+    program->hitGroupCount = static_cast<uint32_t>(shaders.hitGroups.size());
+    auto totalSize = std::accumulate(stages.begin(), stages.end(), size_t(0),
+        [](size_t size, const Stage& s) { return size + s.code.size_bytes(); });
+    trackResource("RayTracingProgram", totalSize);
+
+    //reflect all shaders and merge their bindings; shaders share a layout
+    auto& cache = *con->layoutCache;
+    std::vector<std::shared_ptr<const vulkan::Reflection>> reflections;
+    std::map<uint32_t, size_t> bindingIndices;
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    std::vector<uint32_t> specIds;
+    uint32_t pushSize = 0;
+    for (auto& stage : stages) {
+        auto reflection = cache.findReflection(stage.code);
+        if (!reflection)
+            reflection = cache.addReflection(stage.code, reflect(stage.code));
+        for (auto i = 0u; i < reflection->bindings.size(); ++i) {
+            auto& binding = reflection->bindings[i];
+            auto [it, inserted] = bindingIndices.try_emplace(binding.binding, bindings.size());
+            if (inserted) {
+                bindings.push_back(binding);
+                bindings.back().stageFlags = RayTracingStages;
+                program->boundParams.push_back(reflection->params[i]);
+                bindingTraits.push_back(reflection->traits[i]);
+            }
+            else if (bindings[it->second].descriptorType != binding.descriptorType ||
+                bindings[it->second].descriptorCount != binding.descriptorCount)
+            {
+                throw std::logic_error("Bindings shared between shaders must have the same type!");
+            }
+        }
+        pushSize = std::max(pushSize, reflection->pushSize);
+        specIds.insert(specIds.end(), reflection->specIds.begin(), reflection->specIds.end());
+        reflections.push_back(std::move(reflection));
+    }
+    //keep bindings ordered by their number like reflect() does
+    std::vector<size_t> order(bindings.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&bindings](size_t l, size_t r) {
+        return bindings[l].binding < bindings[r].binding;
+    });
+    {
+        auto sortedBindings = bindings;
+        auto sortedParams = program->boundParams;
+        auto sortedTraits = bindingTraits;
+        for (auto i = 0u; i < order.size(); ++i) {
+            sortedBindings[i] = bindings[order[i]];
+            sortedParams[i] = program->boundParams[order[i]];
+            sortedTraits[i] = bindingTraits[order[i]];
+        }
+        bindings = std::move(sortedBindings);
+        program->boundParams = std::move(sortedParams);
+        bindingTraits = std::move(sortedTraits);
+    }
+
+    //fetch layout shared by all programs with the same signature
+    auto layout = cache.getLayout(bindings,
+        VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR,
+        pushSize, RayTracingStages);
+    program->descriptorSetLayout = layout.setLayout;
+    program->pipeLayout = layout.pipeLayout;
+
+    //all shaders share the specialization data, i.e. the same constant id
+    //refers to the same value in each of them
+    std::sort(specIds.begin(), specIds.end());
+    specIds.erase(std::unique(specIds.begin(), specIds.end()), specIds.end());
+    auto specSlots = std::min(static_cast<uint32_t>(specIds.size()),
+        static_cast<uint32_t>(specialization.size_bytes() / 4));
+    std::vector<VkSpecializationMapEntry> specMap(specSlots);
+    for (auto i = 0u; i < specSlots; ++i) {
+        specMap[i] = VkSpecializationMapEntry{
+            .constantID = specIds[i],
+            .offset = 4 * i,
+            .size = 4
+        };
+    }
+    VkSpecializationInfo specInfo{
+        .mapEntryCount = specSlots,
+        .pMapEntries   = specMap.data(),
+        .dataSize      = specialization.size_bytes(),
+        .pData         = specialization.data()
+    };
+
+    //create a shader module per stage
+    std::vector<VkPipelineShaderStageCreateInfo> stageInfos(stages.size());
+    program->shaders.reserve(stages.size());
+    for (auto i = 0u; i < stages.size(); ++i) {
+        VkShaderModuleCreateInfo shaderInfo{
+            .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+            .codeSize = stages[i].code.size_bytes(),
+            .pCode = stages[i].code.data()
+        };
+        VkShaderModule shader;
+        vulkan::checkResult(con->fnTable.vkCreateShaderModule(
+            con->device, &shaderInfo, nullptr, &shader));
+        program->shaders.push_back(shader);
+
+        stageInfos[i] = VkPipelineShaderStageCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = stages[i].stage,
+            .module = shader,
+            .pName = reflections[i]->entryPoint.c_str(),
+            .pSpecializationInfo = specMap.empty() ? nullptr : &specInfo
+        };
+    }
+
+    //check recursion depth against the device's limit
+    VkPhysicalDeviceRayTracingPipelinePropertiesKHR rtProps{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_PROPERTIES_KHR
+    };
+    VkPhysicalDeviceProperties2 props{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &rtProps
+    };
+    vkGetPhysicalDeviceProperties2(con->physicalDevice, &props);
+    if (maxRecursionDepth > rtProps.maxRayRecursionDepth)
+        throw std::logic_error("Maximum recursion depth exceeds the device's limit!");
+
+    //override the device's robustness if requested
+    VkPipelineRobustnessCreateInfoEXT robustness{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_ROBUSTNESS_CREATE_INFO_EXT
+    };
+    auto robustnessMode = con->programRobustness.load();
+    if (robustnessMode != BufferRobustness::DEFAULT) {
+        auto behavior = robustnessMode == BufferRobustness::ENABLED
+            ? VK_PIPELINE_ROBUSTNESS_BUFFER_BEHAVIOR_ROBUST_BUFFER_ACCESS_EXT
+            : VK_PIPELINE_ROBUSTNESS_BUFFER_BEHAVIOR_DISABLED_EXT;
+        robustness.storageBuffers = behavior;
+        robustness.uniformBuffers = behavior;
+    }
+
+    //create pipeline
+    VkRayTracingPipelineCreateInfoKHR pipeInfo{
+        .sType = VK_STRUCTURE_TYPE_RAY_TRACING_PIPELINE_CREATE_INFO_KHR,
+        .pNext = robustnessMode != BufferRobustness::DEFAULT ? &robustness : nullptr,
+        .stageCount = static_cast<uint32_t>(stageInfos.size()),
+        .pStages = stageInfos.data(),
+        .groupCount = static_cast<uint32_t>(groups.size()),
+        .pGroups = groups.data(),
+        .maxPipelineRayRecursionDepth = maxRecursionDepth,
+        .layout = program->pipeLayout
+    };
+    vulkan::checkResult(con->fnTable.vkCreateRayTracingPipelinesKHR(
+        con->device, nullptr, con->cache, 1, &pipeInfo, nullptr, &program->pipeline));
+
+    //fetch group handles
+    auto handleSize = rtProps.shaderGroupHandleSize;
+    auto groupCount = static_cast<uint32_t>(groups.size());
+    std::vector<std::byte> handles(groupCount * handleSize);
+    vulkan::checkResult(con->fnTable.vkGetRayTracingShaderGroupHandlesKHR(
+        con->device, program->pipeline, 0, groupCount, handles.size(), handles.data()));
+
+    //layout table: each region starts at the base alignment and holds
+    //records of the handle size aligned to the handle alignment
+    auto baseAlignment = rtProps.shaderGroupBaseAlignment;
+    auto stride = alignUp(handleSize, rtProps.shaderGroupHandleAlignment);
+    auto rayGenSize = alignUp(stride, baseAlignment);
+    auto missSize = alignUp(stride * program->missCount, baseAlignment);
+    auto hitSize = alignUp(stride * program->hitGroupCount, baseAlignment);
+    //allocations might not meet the base alignment -> align ourselves
+    program->sbt = vulkan::createBuffer(con,
+        rayGenSize + missSize + hitSize + baseAlignment,
+        VK_BUFFER_USAGE_SHADER_BINDING_TABLE_BIT_KHR |
+        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+        VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    VkBufferDeviceAddressInfo addressInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+        .buffer = program->sbt->buffer
+    };
+    auto bufferAddress = con->fnTable.vkGetBufferDeviceAddress(con->device, &addressInfo);
+    auto address = alignUp(bufferAddress, baseAlignment);
+
+    //copy handles
+    auto table = static_cast<std::byte*>(program->sbt->allocInfo.pMappedData) +
+        (address - bufferAddress);
+    auto copyHandles = [&](VkDeviceSize regionOffset, uint32_t firstGroup, uint32_t count) {
+        for (auto i = 0u; i < count; ++i) {
+            std::memcpy(table + regionOffset + i * stride,
+                handles.data() + (firstGroup + i) * handleSize, handleSize);
+        }
+    };
+    copyHandles(0, 0, 1);
+    copyHandles(rayGenSize, 1, program->missCount);
+    copyHandles(rayGenSize + missSize, 1 + program->missCount, program->hitGroupCount);
+    vulkan::checkResult(vmaFlushAllocation(con->allocator,
+        program->sbt->allocation, 0, VK_WHOLE_SIZE));
+
+    //raygen region must have the same stride as size
+    program->rayGenRegion = { address, rayGenSize, rayGenSize };
+    if (program->missCount)
+        program->missRegion = { address + rayGenSize, stride, missSize };
+    if (program->hitGroupCount)
+        program->hitRegion = { address + rayGenSize + missSize, stride, hitSize };
+}
+RayTracingProgram::~RayTracingProgram() {
+    if (program) {
+        //work might still use the pipeline -> let the context decide when
+        auto& context = *getContext();
+        vulkan::retireResource(context, [
+            &context, program = std::shared_ptr<vulkan::RayTracingProgram>(std::move(program))
+        ]() {
+            context.fnTable.vkDestroyPipeline(context.device, program->pipeline, nullptr);
+            for (auto shader : program->shaders)
+                context.fnTable.vkDestroyShaderModule(context.device, shader, nullptr);
+            //layouts are owned by the layout cache; sbt is freed with the program
+        });
+    }
+}
+
 }
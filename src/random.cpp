@@ -0,0 +1,142 @@
+#include "hephaistos/random.hpp"
+
+namespace hephaistos {
+
+namespace {
+
+//Philox4x32-10 as described by Salmon et al., "Parallel Random Numbers: As
+//Easy as 1, 2, 3", SC'11
+constexpr uint32_t PhiloxM0 = 0xD2511F53u;
+constexpr uint32_t PhiloxM1 = 0xCD9E8D57u;
+constexpr uint32_t PhiloxW0 = 0x9E3779B9u;
+constexpr uint32_t PhiloxW1 = 0xBB67AE85u;
+
+constexpr char RandomSource[] = R"(#ifndef _INCLUDE_HEPHAISTOS_RANDOM
+#define _INCLUDE_HEPHAISTOS_RANDOM
+
+//Counter-based random numbers using Philox4x32-10. Each number is derived
+//from the seed, the index of its stream and its position inside it, thus no
+//state needs to be stored between dispatches. Allocate disjoint ranges of
+//streams per dispatch on the host, e.g. via RandomStreamAllocator.
+
+//range of streams handed to a dispatch; 64 bit values as (low, high)
+struct RandomStreams {
+    uvec2 seed;
+    uvec2 offset;
+};
+
+struct RandomStream {
+    //(draw, substream, stream low, stream high)
+    uvec4 counter;
+    uvec2 key;
+    //last generated block and next unused component
+    uvec4 block;
+    uint next;
+};
+
+uvec4 philox4x32(uvec4 counter, uvec2 key) {
+    for (uint i = 0u; i < 10u; ++i) {
+        uint hi0, lo0, hi1, lo1;
+        umulExtended(0xD2511F53u, counter.x, hi0, lo0);
+        umulExtended(0xCD9E8D57u, counter.z, hi1, lo1);
+        counter = uvec4(hi1 ^ counter.y ^ key.x, lo1, hi0 ^ counter.w ^ key.y, lo0);
+        key += uvec2(0x9E3779B9u, 0xBB67AE85u);
+    }
+    return counter;
+}
+
+//creates the given stream; substreams allow independent sequences per stream
+RandomStream createRandomStream(uvec2 seed, uvec2 stream, uint substream) {
+    RandomStream s;
+    s.counter = uvec4(0u, substream, stream);
+    s.key = seed;
+    s.block = uvec4(0u);
+    s.next = 4u;
+    return s;
+}
+//creates the stream with the given index inside the range
+RandomStream createRandomStream(RandomStreams streams, uint index, uint substream) {
+    uint carry;
+    uint lo = uaddCarry(streams.offset.x, index, carry);
+    return createRandomStream(streams.seed, uvec2(lo, streams.offset.y + carry), substream);
+}
+RandomStream createRandomStream(RandomStreams streams, uint index) {
+    return createRandomStream(streams, index, 0u);
+}
+
+//returns an uniform random 32 bit integer
+uint randomUint(inout RandomStream s) {
+    if (s.next >= 4u) {
+        s.block = philox4x32(s.counter, s.key);
+        s.counter.x++;
+        s.next = 0u;
+    }
+    return s.block[s.next++];
+}
+//returns an uniform random float in [0,1)
+float randomFloat(inout RandomStream s) {
+    return float(randomUint(s) >> 8) * (1.0 / 16777216.0);
+}
+vec2 randomFloat2(inout RandomStream s) {
+    return vec2(randomFloat(s), randomFloat(s));
+}
+vec3 randomFloat3(inout RandomStream s) {
+    return vec3(randomFloat(s), randomFloat(s), randomFloat(s));
+}
+vec4 randomFloat4(inout RandomStream s) {
+    return vec4(randomFloat(s), randomFloat(s), randomFloat(s), randomFloat(s));
+}
+
+#endif
+)";
+
+void mulhilo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo) {
+    auto product = uint64_t(a) * b;
+    hi = static_cast<uint32_t>(product >> 32);
+    lo = static_cast<uint32_t>(product);
+}
+
+}
+
+uint64_t RandomStreamAllocator::getSeed() const noexcept {
+    return seed;
+}
+uint64_t RandomStreamAllocator::getAllocated() const noexcept {
+    return next.load(std::memory_order_relaxed);
+}
+
+RandomStreams RandomStreamAllocator::allocate(uint64_t count) noexcept {
+    return { seed, next.fetch_add(count, std::memory_order_relaxed) };
+}
+void RandomStreamAllocator::reset(uint64_t offset) noexcept {
+    next.store(offset, std::memory_order_relaxed);
+}
+
+RandomStreamAllocator::RandomStreamAllocator(uint64_t seed, uint64_t offset)
+    : seed(seed)
+    , next(offset)
+{}
+RandomStreamAllocator::~RandomStreamAllocator() = default;
+
+std::array<uint32_t, 4> philox4x32(
+    std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key) noexcept
+{
+    for (auto i = 0u; i < 10u; ++i) {
+        uint32_t hi0, lo0, hi1, lo1;
+        mulhilo(PhiloxM0, counter[0], hi0, lo0);
+        mulhilo(PhiloxM1, counter[2], hi1, lo1);
+        counter = {
+            hi1 ^ counter[1] ^ key[0], lo1,
+            hi0 ^ counter[3] ^ key[1], lo0
+        };
+        key[0] += PhiloxW0;
+        key[1] += PhiloxW1;
+    }
+    return counter;
+}
+
+std::string_view getRandomSource() noexcept {
+    return RandomSource;
+}
+
+}
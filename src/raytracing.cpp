@@ -3,12 +3,22 @@
 #include <algorithm>
 #include <array>
 #include <cstring>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
 
 #include "volk.h"
 
+#include "hephaistos/compiler.hpp"
+#include "hephaistos/program.hpp"
+
+#include "vk/hazard.hpp"
 #include "vk/types.hpp"
 #include "vk/result.hpp"
 #include "vk/util.hpp"
+#include "vk/workers.hpp"
 
 namespace hephaistos {
 
@@ -24,6 +34,13 @@ constexpr auto DeviceExtensions = std::to_array({
     VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME,
     VK_KHR_RAY_QUERY_EXTENSION_NAME
 });
+//! MUST BE SORTED FOR std::includes !//
+constexpr auto PipelineDeviceExtensions = std::to_array({
+    VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME,
+    VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME,
+    VK_KHR_RAY_QUERY_EXTENSION_NAME,
+    VK_KHR_RAY_TRACING_PIPELINE_EXTENSION_NAME
+});
 
 }
 
@@ -71,33 +88,72 @@ bool isRaytracingSupported(const DeviceHandle& device) {
 }
 bool isRaytracingEnabled(const ContextHandle& context) {
     //to shorten things
-    auto& ext = context->extensions;
+    auto& ext = *context->extensions;
     return std::find_if(ext.begin(), ext.end(),
         [](const ExtensionHandle& h) -> bool {
             return h->getExtensionName() == ExtensionName;
         }) != ext.end();
 }
+bool isRaytracingPipelineSupported(const DeviceHandle& device) {
+    if (!isRaytracingSupported(device))
+        return false;
+    if (!std::includes(
+        device->supportedExtensions.begin(),
+        device->supportedExtensions.end(),
+        PipelineDeviceExtensions.begin(),
+        PipelineDeviceExtensions.end()))
+    {
+        return false;
+    }
+
+    VkPhysicalDeviceRayTracingPipelineFeaturesKHR pipelineFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_FEATURES_KHR
+    };
+    VkPhysicalDeviceFeatures2 features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &pipelineFeatures
+    };
+    vkGetPhysicalDeviceFeatures2(device->device, &features);
+    return pipelineFeatures.rayTracingPipeline;
+}
 
 class RaytracingExtension : public Extension {
 public:
     bool isDeviceSupported(const DeviceHandle& device) const override {
-        return isRaytracingSupported(device);
+        return pipeline ? isRaytracingPipelineSupported(device) : isRaytracingSupported(device);
     }
     std::string_view getExtensionName() const override {
         return ExtensionName;
     }
     std::span<const char* const> getDeviceExtensions() const override {
+        if (pipeline)
+            return PipelineDeviceExtensions;
         return DeviceExtensions;
     }
     void* chain(void* pNext) override {
+        if (pipeline) {
+            pipelineFeatures.pNext = pNext;
+            pNext = &pipelineFeatures;
+        }
         queryFeatures.pNext = pNext;
         return static_cast<void*>(&accelerationStructureFeatures);
     }
 
-    RaytracingExtension() = default;
+    [[nodiscard]] bool isPipelineEnabled() const noexcept {
+        return pipeline;
+    }
+
+    explicit RaytracingExtension(bool pipeline)
+        : pipeline(pipeline)
+    {}
     virtual ~RaytracingExtension() = default;
 
 private:
+    bool pipeline;
+    VkPhysicalDeviceRayTracingPipelineFeaturesKHR pipelineFeatures{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_FEATURES_KHR,
+        .rayTracingPipeline = VK_TRUE
+    };
     VkPhysicalDeviceRayQueryFeaturesKHR queryFeatures{
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR,
         .rayQuery = VK_TRUE
@@ -108,18 +164,149 @@ private:
         .accelerationStructure = VK_TRUE
     };
 };
-ExtensionHandle createRaytracingExtension() {
-    return std::make_unique<RaytracingExtension>();
+bool isRaytracingPipelineEnabled(const ContextHandle& context) {
+    auto& ext = *context->extensions;
+    return std::any_of(ext.begin(), ext.end(),
+        [](const ExtensionHandle& h) -> bool {
+            if (h->getExtensionName() != ExtensionName)
+                return false;
+            auto raytracing = dynamic_cast<const RaytracingExtension*>(h.get());
+            return raytracing && raytracing->isPipelineEnabled();
+        });
+}
+ExtensionHandle createRaytracingExtension(bool pipeline) {
+    return std::make_unique<RaytracingExtension>(pipeline);
 }
 
 /********************************* GEOMETRIES *********************************/
 
+namespace {
+
+VkBuildAccelerationStructureFlagsKHR getBuildFlags(const BuildOptions& options) {
+    VkBuildAccelerationStructureFlagsKHR flags =
+        options.preference == BuildPreference::FAST_TRACE ?
+        VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR :
+        VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_BUILD_BIT_KHR;
+    if (options.compact)
+        flags |= VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR;
+    if (options.allowUpdate)
+        flags |= VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
+    if (options.lowMemory)
+        flags |= VK_BUILD_ACCELERATION_STRUCTURE_LOW_MEMORY_BIT_KHR;
+    return flags;
+}
+
+//builds need compute capabilities, which transfer only families lack
+void checkBuildQueue(const BuildOptions& options) {
+    if (options.queue == QueueType::TRANSFER)
+        throw std::invalid_argument("Acceleration structures cannot be built on the transfer queue!");
+}
+
+VkDeviceAddress getBufferAddress(const vulkan::Context& context, VkBuffer buffer) {
+    VkBufferDeviceAddressInfo addressInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+        .buffer = buffer
+    };
+    return context.fnTable.vkGetBufferDeviceAddress(context.device, &addressInfo);
+}
+
+//device memory holding the geometry data the build reads from
+struct BuildData {
+    BufferHandle buffer;
+    //host memory uploaded to buffer alongside the build if the data is kept
+    //on the device; empty if the build reads the host memory directly
+    BufferHandle staging;
+    VkDeviceSize size;
+    VkDeviceAddress address;
+    //whether buffer is kept after the build
+    bool keep = false;
+};
+
+//allocates size bytes of build input and fills them on the host
+template<class Func>
+BuildData createBuildData(const ContextHandle& context,
+    VkDeviceSize size, bool keep, const Func& fill)
+{
+    //make data visible to gpu
+    auto hostBuffer = vulkan::createBuffer(context,
+        size,
+        keep ?
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT : 
+        VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
+        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+        VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    fill(static_cast<std::byte*>(hostBuffer->allocInfo.pMappedData));
+
+    BuildData data{
+        .buffer = std::move(hostBuffer),
+        .staging = vulkan::createEmptyBuffer(),
+        .size = size,
+        .keep = keep
+    };
+    if (keep) {
+        //use buffer as staging and upload to gpu local
+        //(the upload is recorded alongside the build to save a round trip)
+        auto gpuBuffer = vulkan::createBuffer(context,
+            size,
+            VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
+            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            0);
+        //replace dataBuffer
+        data.staging = std::move(data.buffer);
+        data.buffer = std::move(gpuBuffer);
+    }
+    data.address = getBufferAddress(*context, data.buffer->buffer);
+
+    return data;
+}
+
+}
+
 struct GeometryStore::Imp {
+    //description of a single blas to build
+    struct Input {
+        VkAccelerationStructureGeometryKHR geometry;
+        uint32_t primitiveCount;
+        //size of the vertex or box data replaced by refits
+        VkDeviceSize dataSize;
+    };
+    //state needed to refit a single blas
+    struct Refit {
+        VkAccelerationStructureGeometryKHR geometry;
+        uint32_t primitiveCount;
+        VkDeviceSize dataSize;
+        VkDeviceSize blasOffset;
+        VkDeviceSize blasSize;
+        VkDeviceSize scratchOffset;
+        VkDeviceSize scratchSize;
+    };
+
     std::vector<Geometry> geometries{};
     std::vector<VkAccelerationStructureKHR> blas{};
+    //empty if not updatable
+    std::vector<Refit> refits{};
+    VkBuildAccelerationStructureFlagsKHR flags = 0;
+    BuildSizes sizes{};
+    //true if loaded from serialized data
+    bool deserialized = false;
 
     BufferHandle dataBuffer = vulkan::createEmptyBuffer();
     BufferHandle blasBuffer = vulkan::createEmptyBuffer();
+    BufferHandle scratchBuffer = vulkan::createEmptyBuffer();
+
+    //builds a blas for each input and fills in their addresses in
+    //geometries, which must already hold the addresses of the kept data
+    void build(const ContextHandle& context, std::span<const Input> inputs,
+        BuildData data, const BuildOptions& options);
+    //builds a blas for each mesh, whose data was already written to data
+    void buildMeshes(const ContextHandle& context, std::span<const Mesh> meshes,
+        BuildData data, const BuildOptions& options);
+    //loads count blas from serialized data; returns false if the data is
+    //malformed or incompatible with the device
+    bool load(const ContextHandle& context, std::span<const std::byte> data, size_t count);
 };
 
 const std::vector<Geometry>& GeometryStore::geometries() const noexcept {
@@ -134,6 +321,18 @@ size_t GeometryStore::size() const noexcept {
     return pImp->geometries.size();
 }
 
+bool GeometryStore::updatable() const noexcept {
+    return !pImp->refits.empty();
+}
+
+bool GeometryStore::deserialized() const noexcept {
+    return pImp->deserialized;
+}
+
+const BuildSizes& GeometryStore::buildSizes() const noexcept {
+    return pImp->sizes;
+}
+
 GeometryInstance GeometryStore::createInstance(
     size_t idx,
     const TransformMatrix& transform,
@@ -154,93 +353,19 @@ GeometryStore& GeometryStore::operator=(GeometryStore&&) noexcept = default;
 GeometryStore::GeometryStore(
     ContextHandle context,
     const Mesh& mesh,
-    bool keepGeometryData)
-    : GeometryStore(std::move(context), { &mesh, 1 }, keepGeometryData)
+    bool keepGeometryData,
+    const BuildOptions& options)
+    : GeometryStore(std::move(context), { &mesh, 1 }, keepGeometryData, options)
 {}
-GeometryStore::GeometryStore(
-    ContextHandle _context,
-    std::span<const Mesh> meshes,
-    bool keepGeometryData)
-    : Resource(std::move(_context))
-    , pImp(std::make_unique<Imp>())
+void GeometryStore::Imp::build(
+    const ContextHandle& context,
+    std::span<const Input> inputs,
+    BuildData data,
+    const BuildOptions& options)
 {
-    auto& context = getContext();
-    auto nMeshes = meshes.size();
-    //Calculate how much memory we'll need for the geometry data
-    uint64_t total_vertices_size = 0;
-    uint64_t total_indices_size = 0;
-    for (auto& m : meshes) {
-        total_vertices_size += m.vertices.size_bytes();
-        total_indices_size += m.indices.size_bytes();
-    }
-    auto hasIndices = total_indices_size > 0;
-    //Not sure if needed, but ensure 4 byte alignment for indices
-    if (hasIndices && total_vertices_size % 4) {
-        total_vertices_size += 4 - (total_vertices_size % 4);
-    }
-    auto data_size = total_vertices_size + total_indices_size;
-
-    //make data visible to gpu
-    auto dataBuffer = vulkan::createBuffer(context,
-        data_size,
-        keepGeometryData ?
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT : 
-        VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
-        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
-        VMA_ALLOCATION_CREATE_MAPPED_BIT);
-    {
-        //copy data to buffer
-        auto p = static_cast<std::byte*>(dataBuffer->allocInfo.pMappedData);
-        for (auto& m : meshes) {
-            std::memcpy(p, m.vertices.data(), m.vertices.size_bytes());
-            p += m.vertices.size_bytes();
-        }
-        if (hasIndices) {
-            //respect padding
-            p = static_cast<std::byte*>(dataBuffer->allocInfo.pMappedData) + total_vertices_size;
-            for (auto& m : meshes) {
-                if (m.indices.empty())
-                    continue;
-                std::memcpy(p, m.indices.data(), m.indices.size_bytes());
-                p += m.indices.size_bytes();
-            }
-        }
-    }
-    if (keepGeometryData) {
-        //use buffer as staging and upload to gpu local
-        auto gpuBuffer = vulkan::createBuffer(context,
-            data_size,
-            VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
-            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
-            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            0);
-        //upload data
-        vulkan::oneTimeSubmit(*context, [&](VkCommandBuffer cmd) {
-            VkBufferCopy copyRegion{
-                .size = data_size
-            };
-            context->fnTable.vkCmdCopyBuffer(
-                cmd, dataBuffer->buffer, gpuBuffer->buffer, 1, &copyRegion);
-        });
-        //replace dataBuffer
-        dataBuffer = std::move(gpuBuffer);
-    }
-
-    //query buffer addresses
-    VkDeviceAddress vertexAddress, indexAddress = 0;
-    {
-        VkBufferDeviceAddressInfo addressInfo{
-            .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
-            .buffer = dataBuffer->buffer
-        };
-        vertexAddress = context->fnTable.vkGetBufferDeviceAddress(
-            context->device, &addressInfo);
-        if (hasIndices) {
-            indexAddress = vertexAddress + total_vertices_size;
-        }
-    }
+    checkBuildQueue(options);
+    auto count = static_cast<uint32_t>(inputs.size());
+    flags = getBuildFlags(options);
 
     //query scratch buffer alignment
     uint32_t scratchAlignment;
@@ -259,345 +384,1452 @@ GeometryStore::GeometryStore(
     //fill blas info
     VkDeviceSize blasTotalSize = 0;
     VkDeviceSize totalScratchSize = 0;
-    auto pVertex = vertexAddress;
-    auto pIndex = indexAddress;
-    std::vector<VkAccelerationStructureGeometryKHR> geometries(nMeshes);
-    std::vector<VkAccelerationStructureBuildGeometryInfoKHR> buildInfo(nMeshes);
-    std::vector<VkAccelerationStructureBuildSizesInfoKHR> sizes(nMeshes);
-    std::vector<VkAccelerationStructureBuildRangeInfoKHR> ranges(nMeshes);
-    for (auto i = 0u; i < nMeshes; ++i) {
-        auto& geometry = meshes[i];
-        uint32_t vertex_count = geometry.vertices.size_bytes() / geometry.vertexStride;
-        auto hasIdx = !geometry.indices.empty();
-        //fill geometry info
-        VkAccelerationStructureGeometryTrianglesDataKHR triangles{
-            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR,
-            .vertexFormat = VK_FORMAT_R32G32B32_SFLOAT,
-            .vertexData = { .deviceAddress = pVertex },
-            .vertexStride = geometry.vertexStride,
-            .maxVertex = vertex_count - 1,
-            .indexType = hasIdx ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_NONE_KHR,
-            .indexData = { .deviceAddress = hasIdx ? pIndex : 0 }
-        };
-        geometries[i] = {
-            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
-            .geometryType = VK_GEOMETRY_TYPE_TRIANGLES_KHR,
-            .geometry = { .triangles = triangles },
-            .flags = VK_GEOMETRY_OPAQUE_BIT_KHR
-        };
-        //update addresses
-        pVertex += meshes[i].vertices.size_bytes();
-        pIndex += meshes[i].indices.size_bytes();
-
+    std::vector<VkAccelerationStructureBuildGeometryInfoKHR> buildInfo(count);
+    std::vector<VkAccelerationStructureBuildSizesInfoKHR> buildSizes(count);
+    std::vector<VkAccelerationStructureBuildRangeInfoKHR> ranges(count);
+    for (auto i = 0u; i < count; ++i) {
         //fill size query
         buildInfo[i] = {
             .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR,
             .type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR,
-            .flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR |
-                     VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR,
+            .flags = flags,
             .geometryCount = 1,
-            .pGeometries = &geometries[i]
+            .pGeometries = &inputs[i].geometry
         };
-        sizes[i] = {
+        buildSizes[i] = {
             .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR
         };
-        //calculate number of triangles
-        uint32_t triangleCount = (hasIdx ? geometry.indices.size() : vertex_count) / 3;
-        ranges[i].primitiveCount = triangleCount;
+        ranges[i].primitiveCount = inputs[i].primitiveCount;
         //fetch build size
         context->fnTable.vkGetAccelerationStructureBuildSizesKHR(
             context->device, VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
-            &buildInfo[i], &triangleCount, &sizes[i]);
+            &buildInfo[i], &inputs[i].primitiveCount, &buildSizes[i]);
 
         //update sizes
-        blasTotalSize += sizes[i].accelerationStructureSize;
+        blasTotalSize += buildSizes[i].accelerationStructureSize;
         if (blasTotalSize % 256) //force allignment
             blasTotalSize += 256 - (blasTotalSize % 256);
-        totalScratchSize += sizes[i].buildScratchSize;
+        totalScratchSize += buildSizes[i].buildScratchSize;
         if (totalScratchSize % scratchAlignment)
             totalScratchSize += scratchAlignment - (totalScratchSize % scratchAlignment);
     }
 
-    //Create scratch buffer
-    auto scratchBuffer = vulkan::createBuffer(context, totalScratchSize,
-        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-        0);
-    VkDeviceAddress scratchAddress;
-    {
-        VkBufferDeviceAddressInfo addressInfo{
-            .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
-            .buffer = scratchBuffer->buffer
-        };
-        scratchAddress = context->fnTable.vkGetBufferDeviceAddress(
-            context->device, &addressInfo);
-    }
     //allocate buffer for acceleration structures
-    auto blasBuffer = vulkan::createBuffer(context, blasTotalSize,
+    auto buffer = vulkan::createBuffer(context, blasTotalSize,
         VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR |
         VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
         VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
 
     //create query pool for compacted blas sizes
-    VkQueryPool queryPool;
-    {
+    auto compact = options.compact;
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    if (compact) {
         VkQueryPoolCreateInfo poolInfo{
             .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
             .queryType = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR,
-            .queryCount = static_cast<uint32_t>(nMeshes)
+            .queryCount = count
         };
         vulkan::checkResult(context->fnTable.vkCreateQueryPool(
             context->device, &poolInfo, nullptr, &queryPool));
-        context->fnTable.vkResetQueryPool(context->device, queryPool, 0, nMeshes);
+        context->fnTable.vkResetQueryPool(context->device, queryPool, 0, count);
     }
 
     //create blas
     VkDeviceSize offset = 0;
-    std::vector<VkAccelerationStructureKHR> accStructures(nMeshes);
-    for (auto i = 0u; i < nMeshes; ++i) {
-        //create acceleration structure
-        VkAccelerationStructureCreateInfoKHR accInfo{
-            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR,
-            .buffer = blasBuffer->buffer,
-            .offset = offset,
-            .size = sizes[i].accelerationStructureSize,
-            .type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR
-        };
-        offset += accInfo.size;
-        if (accInfo.size % 256)
-            offset += 256 - (accInfo.size % 256);
-        vulkan::checkResult(context->fnTable.vkCreateAccelerationStructureKHR(
-            context->device, &accInfo, nullptr, &accStructures[i]));
-        //register
-        buildInfo[i].dstAccelerationStructure = accStructures[i];
-        buildInfo[i].scratchData.deviceAddress = scratchAddress;
-        //update address
-        scratchAddress += sizes[i].buildScratchSize;
-        if (scratchAddress % scratchAlignment)
-            scratchAddress += scratchAlignment - (scratchAddress % scratchAlignment);
+    std::vector<VkAccelerationStructureKHR> accStructures(count);
+    {
+        //sub-allocate scratch memory from the context's arena; hold it only
+        //while building so other builds can reuse it during compaction
+        vulkan::ScratchLease scratch(context, totalScratchSize);
+        auto scratchAddress = scratch.getAddress();
+        for (auto i = 0u; i < count; ++i) {
+            //create acceleration structure
+            VkAccelerationStructureCreateInfoKHR accInfo{
+                .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR,
+                .buffer = buffer->buffer,
+                .offset = offset,
+                .size = buildSizes[i].accelerationStructureSize,
+                .type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR
+            };
+            offset += accInfo.size;
+            if (accInfo.size % 256)
+                offset += 256 - (accInfo.size % 256);
+            vulkan::checkResult(context->fnTable.vkCreateAccelerationStructureKHR(
+                context->device, &accInfo, nullptr, &accStructures[i]));
+            //register
+            buildInfo[i].dstAccelerationStructure = accStructures[i];
+            buildInfo[i].scratchData.deviceAddress = scratchAddress;
+            //update address
+            scratchAddress += buildSizes[i].buildScratchSize;
+            if (scratchAddress % scratchAlignment)
+                scratchAddress += scratchAlignment - (scratchAddress % scratchAlignment);
+        }
+        //build blas
+        vulkan::oneTimeSubmit(*context, options.queue, [&](VkCommandBuffer cmd) {
+            //upload data first
+            if (data.staging) {
+                VkBufferCopy copyRegion{
+                    .size = data.size
+                };
+                context->fnTable.vkCmdCopyBuffer(
+                    cmd, data.staging->buffer, data.buffer->buffer, 1, &copyRegion);
+            }
+            //make the upload or earlier writes to tensor meshes visible
+            VkMemoryBarrier inputBarrier{
+                .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_SHADER_READ_BIT
+            };
+            vulkan::count(context->counters.barriers);
+            context->fnTable.vkCmdPipelineBarrier(cmd,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                0, 1, &inputBarrier, 0, nullptr, 0, nullptr);
+            //build 2d array (second dimension is 1...)
+            std::vector<const VkAccelerationStructureBuildRangeInfoKHR*> pRanges(ranges.size());
+            std::transform(ranges.begin(), ranges.end(), pRanges.begin(),
+                [](const VkAccelerationStructureBuildRangeInfoKHR& i) { return &i; });
+            //issue build
+            context->fnTable.vkCmdBuildAccelerationStructuresKHR(cmd,
+                static_cast<uint32_t>(buildInfo.size()),
+                buildInfo.data(),
+                pRanges.data());
+            if (!compact)
+                return;
+            //memory barrier to ensure queries are valid
+            VkMemoryBarrier barrier{
+                .sType           = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR,
+                .dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR
+            };
+            vulkan::count(context->counters.barriers);
+            context->fnTable.vkCmdPipelineBarrier(cmd,
+                VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                0, 1, &barrier, 0, nullptr, 0, nullptr);
+            //query
+            context->fnTable.vkCmdWriteAccelerationStructuresPropertiesKHR(cmd,
+                count, accStructures.data(),
+                VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR,
+                queryPool, 0);
+        });
     }
-    //build blas
-    vulkan::oneTimeSubmit(*context, [&](VkCommandBuffer cmd) {
-        //build 2d array (second dimension is 1...)
-        std::vector<const VkAccelerationStructureBuildRangeInfoKHR*> pRanges(ranges.size());
-        std::transform(ranges.begin(), ranges.end(), pRanges.begin(),
-            [](const VkAccelerationStructureBuildRangeInfoKHR& i) { return &i; });
-        //issue build
-        context->fnTable.vkCmdBuildAccelerationStructuresKHR(cmd,
-            static_cast<uint32_t>(buildInfo.size()),
-            buildInfo.data(),
-            pRanges.data());
-        //memory barrier to ensure queries are valid
-        VkMemoryBarrier barrier{
-            .sType           = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
-            .srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR,
-            .dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR
-        };
-        context->fnTable.vkCmdPipelineBarrier(cmd,
-            VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
-            VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
-            0, 1, &barrier, 0, nullptr, 0, nullptr);
-        //query
-        context->fnTable.vkCmdWriteAccelerationStructuresPropertiesKHR(cmd,
-            nMeshes, accStructures.data(),
-            VK_QUERY_TYPE_ACCELERATION_STRUCTURE_COMPACTED_SIZE_KHR,
-            queryPool, 0);
-    });
 
-    //query compacted sizes
-    std::vector<VkDeviceSize> compactSizes(nMeshes);
-    context->fnTable.vkGetQueryPoolResults(
-        context->device,
-        queryPool,
-        0, nMeshes,
-        nMeshes * sizeof(VkDeviceSize),
-        compactSizes.data(),
-        sizeof(VkDeviceSize),
-        VK_QUERY_RESULT_WAIT_BIT);
-    //destroy query pool
-    context->fnTable.vkDestroyQueryPool(context->device, queryPool, nullptr);
-    
-    //update blas buffer size
-    blasTotalSize = 0;
-    for (auto size : compactSizes) {
-        blasTotalSize += size;
-        if (size % 256)
-            blasTotalSize += 256 - (size % 256);
-    }
-    //create new compact blas buffer
-    auto compactBlasBuffer = vulkan::createBuffer(context, blasTotalSize,
-        VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR |
-        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
-        VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
-    //create compacted blas
-    offset = 0;
-    std::vector<VkAccelerationStructureKHR> compactAccStructures(nMeshes);
-    for (auto i = 0u; i < nMeshes; ++i) {
-        //create acceleration structure
-        VkAccelerationStructureCreateInfoKHR accInfo{
-            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR,
-            .buffer = compactBlasBuffer->buffer,
-            .offset = offset,
-            .size = compactSizes[i],
-            .type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR
-        };
-        offset += accInfo.size;
-        if (accInfo.size % 256)
-            offset += 256 - (accInfo.size % 256);
-        vulkan::checkResult(context->fnTable.vkCreateAccelerationStructureKHR(
-            context->device, &accInfo, nullptr, &compactAccStructures[i]));
+    //data got uploaded -> staging no longer needed
+    auto keepData = data.keep;
+    data.staging.reset();
+
+    //sizes as built
+    std::vector<VkDeviceSize> finalSizes(count);
+    for (auto i = 0u; i < count; ++i) {
+        finalSizes[i] = buildSizes[i].accelerationStructureSize;
+        sizes.built += finalSizes[i];
     }
-    //copy blas
-    vulkan::oneTimeSubmit(*context, [&](VkCommandBuffer cmd) {
-        VkCopyAccelerationStructureInfoKHR copyInfo{
-            .sType = VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR,
-            .mode  = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR
-        };
-        for (auto i = 0u; i < nMeshes; ++i) {
-            copyInfo.src = accStructures[i];
-            copyInfo.dst = compactAccStructures[i];
-            context->fnTable.vkCmdCopyAccelerationStructureKHR(cmd, &copyInfo);
+    if (compact) {
+        //query compacted sizes
+        context->fnTable.vkGetQueryPoolResults(
+            context->device,
+            queryPool,
+            0, count,
+            count * sizeof(VkDeviceSize),
+            finalSizes.data(),
+            sizeof(VkDeviceSize),
+            VK_QUERY_RESULT_WAIT_BIT);
+        //destroy query pool
+        context->fnTable.vkDestroyQueryPool(context->device, queryPool, nullptr);
+
+        //update blas buffer size
+        blasTotalSize = 0;
+        for (auto size : finalSizes) {
+            blasTotalSize += size;
+            if (size % 256)
+                blasTotalSize += 256 - (size % 256);
         }
-    });
-    //destroy inital blas
-    for (auto i = 0u; i < nMeshes; ++i) {
-        context->fnTable.vkDestroyAccelerationStructureKHR(
-            context->device, accStructures[i], nullptr);
+        //create new compact blas buffer
+        auto compactBuffer = vulkan::createBuffer(context, blasTotalSize,
+            VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR |
+            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+        //create compacted blas
+        offset = 0;
+        std::vector<VkAccelerationStructureKHR> compactAccStructures(count);
+        for (auto i = 0u; i < count; ++i) {
+            //create acceleration structure
+            VkAccelerationStructureCreateInfoKHR accInfo{
+                .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR,
+                .buffer = compactBuffer->buffer,
+                .offset = offset,
+                .size = finalSizes[i],
+                .type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR
+            };
+            offset += accInfo.size;
+            if (accInfo.size % 256)
+                offset += 256 - (accInfo.size % 256);
+            vulkan::checkResult(context->fnTable.vkCreateAccelerationStructureKHR(
+                context->device, &accInfo, nullptr, &compactAccStructures[i]));
+        }
+        //copy blas
+        vulkan::oneTimeSubmit(*context, options.queue, [&](VkCommandBuffer cmd) {
+            VkCopyAccelerationStructureInfoKHR copyInfo{
+                .sType = VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_INFO_KHR,
+                .mode  = VK_COPY_ACCELERATION_STRUCTURE_MODE_COMPACT_KHR
+            };
+            for (auto i = 0u; i < count; ++i) {
+                copyInfo.src = accStructures[i];
+                copyInfo.dst = compactAccStructures[i];
+                context->fnTable.vkCmdCopyAccelerationStructureKHR(cmd, &copyInfo);
+            }
+        });
+        //destroy inital blas
+        for (auto i = 0u; i < count; ++i) {
+            context->fnTable.vkDestroyAccelerationStructureKHR(
+                context->device, accStructures[i], nullptr);
+        }
+        accStructures = std::move(compactAccStructures);
+        buffer = std::move(compactBuffer);
     }
+    for (auto size : finalSizes)
+        sizes.compacted += size;
 
-    //Done -> build result
-    pVertex = vertexAddress;
-    pIndex = indexAddress;
-    std::vector<Geometry> blasResult(nMeshes);
-    for (auto i = 0u; i < nMeshes; ++i) {
-        if (keepGeometryData) {
-            blasResult[i].vertices_address = pVertex;
-            blasResult[i].indices_address = meshes[i].indices.empty() ? 0 : pIndex;
-            pVertex += meshes[i].vertices.size_bytes();
-            pIndex += meshes[i].indices.size_bytes();
+    //remember what is needed to refit the blas later on
+    if (options.allowUpdate) {
+        refits.resize(count);
+        offset = 0;
+        VkDeviceSize scratchSize = 0;
+        for (auto i = 0u; i < count; ++i) {
+            auto& refit = refits[i];
+            refit.geometry = inputs[i].geometry;
+            refit.primitiveCount = inputs[i].primitiveCount;
+            refit.dataSize = inputs[i].dataSize;
+            refit.blasOffset = offset;
+            refit.blasSize = finalSizes[i];
+            offset += finalSizes[i];
+            if (finalSizes[i] % 256)
+                offset += 256 - (finalSizes[i] % 256);
+            //every geometry gets its own scratch memory so they can be
+            //updated without waiting on each other
+            refit.scratchOffset = scratchSize;
+            refit.scratchSize = buildSizes[i].updateScratchSize;
+            scratchSize += buildSizes[i].updateScratchSize;
+            if (scratchSize % scratchAlignment)
+                scratchSize += scratchAlignment - (scratchSize % scratchAlignment);
         }
-        //fetch device address
+        scratchBuffer = vulkan::createBuffer(context, scratchSize,
+            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            0);
+    }
+
+    //Done -> fetch blas addresses
+    for (auto i = 0u; i < count; ++i) {
         VkAccelerationStructureDeviceAddressInfoKHR addressInfo{
             .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR,
-            .accelerationStructure = compactAccStructures[i]
+            .accelerationStructure = accStructures[i]
         };
-        blasResult[i].blas_address = context->fnTable.vkGetAccelerationStructureDeviceAddressKHR(
+        geometries[i].blas_address = context->fnTable.vkGetAccelerationStructureDeviceAddressKHR(
             context->device, &addressInfo);
     }
     //save results
-    pImp->blas = std::move(compactAccStructures);
-    pImp->blasBuffer = std::move(compactBlasBuffer);
-    pImp->geometries = std::move(blasResult);
-    if (keepGeometryData) {
-        pImp->dataBuffer = std::move(dataBuffer);
+    blas = std::move(accStructures);
+    blasBuffer = std::move(buffer);
+    if (keepData) {
+        dataBuffer = std::move(data.buffer);
     }
 }
 
-GeometryStore::~GeometryStore() {
-    if (pImp) {
-        auto& context = *getContext();
-        for (auto acc : pImp->blas) {
-            context.fnTable.vkDestroyAccelerationStructureKHR(
-                context.device, acc, nullptr);
-        }
+namespace {
+
+VkFormat getVertexFormat(VertexFormat format) {
+    switch (format) {
+    case VertexFormat::FLOAT16:
+        return VK_FORMAT_R16G16B16A16_SFLOAT;
+    case VertexFormat::SNORM16:
+        return VK_FORMAT_R16G16B16A16_SNORM;
+    default:
+        return VK_FORMAT_R32G32B32_SFLOAT;
     }
 }
 
-/*************************** ACCELERATION STRUCTURE ***************************/
+//vertex and index data must be aligned to their component size; pad every
+//range to 4 bytes so mixing formats keeps the following ranges aligned
+uint64_t padRange(uint64_t size) {
+    return (size + 3) / 4 * 4;
+}
 
-struct AccelerationStructure::Parameter {
-    VkAccelerationStructureKHR tlas = 0;
-    VkWriteDescriptorSetAccelerationStructureKHR descriptorInfo{};
+uint64_t getIndexSize(const Mesh& mesh) {
+    return mesh.indices.size_bytes() + mesh.indices16.size_bytes();
+}
 
-    BufferHandle tlasBuffer = vulkan::createEmptyBuffer();
-};
+std::span<const std::byte> getIndexData(const Mesh& mesh) {
+    if (!mesh.indices.empty())
+        return std::as_bytes(mesh.indices);
+    else
+        return std::as_bytes(mesh.indices16);
+}
 
-void AccelerationStructure::bindParameter(VkWriteDescriptorSet& binding) const {
-    binding.pNext = &param->descriptorInfo;
-    binding.pBufferInfo = nullptr;
-    binding.pImageInfo = nullptr;
-    binding.pTexelBufferView = nullptr;
+//calls func(data, offset) for each range of mesh data with its offset into
+//the build data, which holds all vertices followed by all indices
+template<class Func>
+void forEachMeshRange(std::span<const Mesh> meshes, const Func& func) {
+    uint64_t offset = 0;
+    for (auto& m : meshes) {
+        func(m.vertices, offset);
+        offset += padRange(m.vertices.size_bytes());
+    }
+    for (auto& m : meshes) {
+        auto indices = getIndexData(m);
+        if (!indices.empty())
+            func(indices, offset);
+        offset += padRange(indices.size_bytes());
+    }
 }
 
-AccelerationStructure::AccelerationStructure(AccelerationStructure&&) noexcept = default;
-AccelerationStructure& AccelerationStructure::operator=(AccelerationStructure&&) noexcept = default;
+//returns the size of the build data needed for the given meshes
+uint64_t getMeshDataSize(std::span<const Mesh> meshes) {
+    uint64_t size = 0;
+    for (auto& m : meshes) {
+        if (!m.indices.empty() && !m.indices16.empty())
+            throw std::logic_error("Mesh must not have both 32 and 16 bit indices!");
+        size += padRange(m.vertices.size_bytes()) + padRange(getIndexSize(m));
+    }
+    return size;
+}
 
-AccelerationStructure::AccelerationStructure(ContextHandle context, const GeometryInstance& instance)
-    : AccelerationStructure(std::move(context), { &instance, 1 })
-{}
-AccelerationStructure::AccelerationStructure(
-    ContextHandle _context,
-    std::span<const GeometryInstance> instances)
-    : Resource(std::move(_context))
-    , param(std::make_unique<Parameter>())
+}
+
+void GeometryStore::Imp::buildMeshes(
+    const ContextHandle& context,
+    std::span<const Mesh> meshes,
+    BuildData data,
+    const BuildOptions& options)
 {
-    auto& context = getContext();
-    //create instance buffer
-    auto instanceBuffer = vulkan::createBuffer(context,
-        instances.size() * sizeof(VkAccelerationStructureInstanceKHR),
-        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
-        VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR,
-        VMA_ALLOCATION_CREATE_MAPPED_BIT |
-        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
-    //get device address
-    VkDeviceAddress instanceBufferAddress;
-    {
-        VkBufferDeviceAddressInfo addressInfo{
-            .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
-            .buffer = instanceBuffer->buffer
+    auto nMeshes = meshes.size();
+    uint64_t total_vertices_size = 0;
+    for (auto& m : meshes)
+        total_vertices_size += padRange(m.vertices.size_bytes());
+
+    //fill geometry info
+    auto pVertex = data.address;
+    auto pIndex = data.address + total_vertices_size;
+    std::vector<Input> inputs(nMeshes);
+    geometries.resize(nMeshes);
+    for (auto i = 0u; i < nMeshes; ++i) {
+        auto& geometry = meshes[i];
+        uint32_t vertex_count = geometry.vertices.size_bytes() / geometry.vertexStride;
+        auto index_count = geometry.indices.size() + geometry.indices16.size();
+        auto hasIdx = index_count > 0;
+        VkAccelerationStructureGeometryTrianglesDataKHR triangles{
+            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR,
+            .vertexFormat = getVertexFormat(geometry.vertexFormat),
+            .vertexData = { .deviceAddress = pVertex },
+            .vertexStride = geometry.vertexStride,
+            .maxVertex = vertex_count - 1,
+            .indexType = !hasIdx ? VK_INDEX_TYPE_NONE_KHR :
+                geometry.indices16.empty() ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16,
+            .indexData = { .deviceAddress = hasIdx ? pIndex : 0 }
         };
-        instanceBufferAddress = context->fnTable.vkGetBufferDeviceAddress(
-            context->device, &addressInfo);
+        inputs[i] = {
+            .geometry = {
+                .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
+                .geometryType = VK_GEOMETRY_TYPE_TRIANGLES_KHR,
+                .geometry = { .triangles = triangles },
+                .flags = VK_GEOMETRY_OPAQUE_BIT_KHR
+            },
+            //calculate number of triangles
+            .primitiveCount = static_cast<uint32_t>(
+                (hasIdx ? index_count : vertex_count) / 3),
+            .dataSize = geometry.vertices.size_bytes()
+        };
+        if (data.keep) {
+            geometries[i].vertices_address = pVertex;
+            geometries[i].indices_address = hasIdx ? pIndex : 0;
+        }
+        //update addresses
+        pVertex += padRange(geometry.vertices.size_bytes());
+        pIndex += padRange(getIndexSize(geometry));
     }
-    //type cast buffer
-    std::span< VkAccelerationStructureInstanceKHR> asInstances{
-        static_cast<VkAccelerationStructureInstanceKHR*>(instanceBuffer->allocInfo.pMappedData),
-        instances.size()
-    };
 
-    //fill instance buffer
-    auto pIn = instances.begin();
-    auto pOut = asInstances.data();
-    for (auto i = 0u; i < instances.size(); ++i, ++pIn, ++pOut) {
-        //copy transformation matrix
-        memcpy(pOut, &pIn->transform, sizeof(VkTransformMatrixKHR));
-        //set rest
-        pOut->instanceCustomIndex = pIn->customIndex;
-        pOut->mask = pIn->mask;
-        pOut->instanceShaderBindingTableRecordOffset = 0;
-        pOut->flags = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR;
-        pOut->accelerationStructureReference = pIn->blas_address;
+    build(context, inputs, std::move(data), options);
+}
+
+GeometryStore::GeometryStore(
+    ContextHandle _context,
+    std::span<const Mesh> meshes,
+    bool keepGeometryData,
+    const BuildOptions& options)
+    : Resource(std::move(_context))
+    , pImp(std::make_unique<Imp>())
+{
+    auto& context = getContext();
+    //updates must provide the same indices as the initial build
+    //-> we have to keep them around
+    keepGeometryData |= options.allowUpdate;
+    //Calculate how much memory we'll need for the geometry data
+    auto data_size = getMeshDataSize(meshes);
+
+    //make data visible to gpu
+    auto data = createBuildData(context, data_size, keepGeometryData,
+        [&](std::byte* mapped) {
+            //copy data to buffer
+            forEachMeshRange(meshes, [mapped](std::span<const std::byte> src, uint64_t offset) {
+                std::memcpy(mapped + offset, src.data(), src.size_bytes());
+            });
+        });
+
+    pImp->buildMeshes(context, meshes, std::move(data), options);
+    trackResource("GeometryStore", pImp->sizes.compacted);
+}
+
+GeometryStore::GeometryStore(
+    ContextHandle _context,
+    std::span<const TensorMesh> meshes,
+    const BuildOptions& options)
+    : Resource(std::move(_context))
+    , pImp(std::make_unique<Imp>())
+{
+    auto& context = getContext();
+    auto nMeshes = meshes.size();
+
+    //fill geometry info
+    std::vector<Imp::Input> inputs(nMeshes);
+    pImp->geometries.resize(nMeshes);
+    for (auto i = 0u; i < nMeshes; ++i) {
+        auto& mesh = meshes[i];
+        //check vertices
+        if (!mesh.vertices || mesh.vertexCount == 0)
+            throw std::logic_error("Tensor mesh must reference vertices!");
+        if (!vulkan::isSameDevice(mesh.vertices->getContext().get(), context.get()))
+            throw std::logic_error("Tensors must originate from the same context as the geometry store!");
+        auto vertexSize = uint64_t(mesh.vertexCount - 1) * mesh.vertexStride +
+            (mesh.vertexFormat == VertexFormat::FLOAT32 ? 3 * sizeof(float) : 4 * sizeof(uint16_t));
+        if (mesh.verticesOffset + vertexSize > mesh.vertices->size_bytes())
+            throw std::logic_error("Tensor does not contain all vertices of the mesh!");
+        auto vertexAddress = mesh.vertices->address() + mesh.verticesOffset;
+        if (vertexAddress % (mesh.vertexFormat == VertexFormat::FLOAT32 ? 4 : 2))
+            throw std::logic_error("Vertex data must be aligned to its component size!");
+        //check indices
+        VkDeviceAddress indexAddress = 0;
+        auto hasIdx = mesh.indices && mesh.indexCount > 0;
+        if (hasIdx) {
+            if (!vulkan::isSameDevice(mesh.indices->getContext().get(), context.get()))
+                throw std::logic_error("Tensors must originate from the same context as the geometry store!");
+            uint64_t indexSize = mesh.shortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+            if (mesh.indicesOffset + mesh.indexCount * indexSize > mesh.indices->size_bytes())
+                throw std::logic_error("Tensor does not contain all indices of the mesh!");
+            indexAddress = mesh.indices->address() + mesh.indicesOffset;
+            if (indexAddress % indexSize)
+                throw std::logic_error("Index data must be aligned to the index size!");
+        }
+
+        VkAccelerationStructureGeometryTrianglesDataKHR triangles{
+            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR,
+            .vertexFormat = getVertexFormat(mesh.vertexFormat),
+            .vertexData = { .deviceAddress = vertexAddress },
+            .vertexStride = mesh.vertexStride,
+            .maxVertex = mesh.vertexCount - 1,
+            .indexType = !hasIdx ? VK_INDEX_TYPE_NONE_KHR :
+                mesh.shortIndices ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32,
+            .indexData = { .deviceAddress = indexAddress }
+        };
+        inputs[i] = {
+            .geometry = {
+                .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
+                .geometryType = VK_GEOMETRY_TYPE_TRIANGLES_KHR,
+                .geometry = { .triangles = triangles },
+                .flags = VK_GEOMETRY_OPAQUE_BIT_KHR
+            },
+            //calculate number of triangles
+            .primitiveCount = (hasIdx ? mesh.indexCount : mesh.vertexCount) / 3,
+            .dataSize = vertexSize
+        };
+        pImp->geometries[i].vertices_address = vertexAddress;
+        pImp->geometries[i].indices_address = indexAddress;
     }
 
-    //Create tlas geometry
-    VkAccelerationStructureGeometryKHR tlasGeometry{
+    //data already resides on the device -> nothing to upload
+    pImp->build(context, inputs, {
+        .buffer = vulkan::createEmptyBuffer(),
+        .staging = vulkan::createEmptyBuffer(),
+        .size = 0,
+        .address = 0
+    }, options);
+    trackResource("GeometryStore", pImp->sizes.compacted);
+}
+
+GeometryStore::GeometryStore(
+    ContextHandle context,
+    const BoundingBoxes& boxes,
+    bool keepBoxData,
+    const BuildOptions& options)
+    : GeometryStore(std::move(context), { &boxes, 1 }, keepBoxData, options)
+{}
+GeometryStore::GeometryStore(
+    ContextHandle _context,
+    std::span<const BoundingBoxes> boxes,
+    bool keepBoxData,
+    const BuildOptions& options)
+    : Resource(std::move(_context))
+    , pImp(std::make_unique<Imp>())
+{
+    auto& context = getContext();
+    auto count = boxes.size();
+    //refits read the new boxes from a tensor, but keep the layout
+    keepBoxData |= options.allowUpdate;
+    //boxes must be 8 byte aligned -> so must be every stride and size
+    uint64_t data_size = 0;
+    for (auto& b : boxes) {
+        if (b.stride < 6 * sizeof(float) || b.stride % 8)
+            throw std::logic_error("Box stride must be a multiple of 8 and hold at least 6 floats!");
+        data_size += b.boxes.size_bytes();
+        if (data_size % 8)
+            data_size += 8 - (data_size % 8);
+    }
+
+    //make data visible to gpu
+    auto data = createBuildData(context, data_size, keepBoxData,
+        [&](std::byte* p) {
+            for (auto& b : boxes) {
+                std::memcpy(p, b.boxes.data(), b.boxes.size_bytes());
+                p += b.boxes.size_bytes();
+                if (b.boxes.size_bytes() % 8)
+                    p += 8 - (b.boxes.size_bytes() % 8);
+            }
+        });
+
+    //fill geometry info
+    auto pBoxes = data.address;
+    std::vector<Imp::Input> inputs(count);
+    pImp->geometries.resize(count);
+    for (auto i = 0u; i < count; ++i) {
+        auto& b = boxes[i];
+        VkAccelerationStructureGeometryAabbsDataKHR aabbs{
+            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_AABBS_DATA_KHR,
+            .data = { .deviceAddress = pBoxes },
+            .stride = b.stride
+        };
+        inputs[i] = {
+            .geometry = {
+                .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
+                .geometryType = VK_GEOMETRY_TYPE_AABBS_KHR,
+                .geometry = { .aabbs = aabbs },
+                .flags = VK_GEOMETRY_OPAQUE_BIT_KHR
+            },
+            .primitiveCount = static_cast<uint32_t>(b.boxes.size_bytes() / b.stride),
+            .dataSize = b.boxes.size_bytes()
+        };
+        if (keepBoxData)
+            pImp->geometries[i].vertices_address = pBoxes;
+        //update address
+        pBoxes += b.boxes.size_bytes();
+        if (b.boxes.size_bytes() % 8)
+            pBoxes += 8 - (b.boxes.size_bytes() % 8);
+    }
+
+    pImp->build(context, inputs, std::move(data), options);
+    trackResource("GeometryStore", pImp->sizes.compacted);
+}
+
+GeometryStore::GeometryStore(
+    ContextHandle _context,
+    std::span<const TensorBoundingBoxes> boxes,
+    const BuildOptions& options)
+    : Resource(std::move(_context))
+    , pImp(std::make_unique<Imp>())
+{
+    auto& context = getContext();
+    auto count = boxes.size();
+
+    //fill geometry info
+    std::vector<Imp::Input> inputs(count);
+    pImp->geometries.resize(count);
+    for (auto i = 0u; i < count; ++i) {
+        auto& b = boxes[i];
+        if (!b.boxes || b.count == 0)
+            throw std::logic_error("Tensor bounding boxes must reference boxes!");
+        if (!vulkan::isSameDevice(b.boxes->getContext().get(), context.get()))
+            throw std::logic_error("Tensors must originate from the same context as the geometry store!");
+        if (b.stride < 6 * sizeof(float) || b.stride % 8)
+            throw std::logic_error("Box stride must be a multiple of 8 and hold at least 6 floats!");
+        auto dataSize = uint64_t(b.count - 1) * b.stride + 6 * sizeof(float);
+        if (b.offset + dataSize > b.boxes->size_bytes())
+            throw std::logic_error("Tensor does not contain all boxes!");
+        auto address = b.boxes->address() + b.offset;
+        if (address % 8)
+            throw std::logic_error("Box data must be 8 byte aligned!");
+
+        VkAccelerationStructureGeometryAabbsDataKHR aabbs{
+            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_AABBS_DATA_KHR,
+            .data = { .deviceAddress = address },
+            .stride = b.stride
+        };
+        inputs[i] = {
+            .geometry = {
+                .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
+                .geometryType = VK_GEOMETRY_TYPE_AABBS_KHR,
+                .geometry = { .aabbs = aabbs },
+                .flags = VK_GEOMETRY_OPAQUE_BIT_KHR
+            },
+            .primitiveCount = b.count,
+            .dataSize = dataSize
+        };
+        pImp->geometries[i].vertices_address = address;
+    }
+
+    //data already resides on the device -> nothing to upload
+    pImp->build(context, inputs, {
+        .buffer = vulkan::createEmptyBuffer(),
+        .staging = vulkan::createEmptyBuffer(),
+        .size = 0,
+        .address = 0
+    }, options);
+    trackResource("GeometryStore", pImp->sizes.compacted);
+}
+
+std::future<GeometryStore> GeometryStore::buildAsync(
+    ContextHandle context,
+    std::span<const Mesh> meshes,
+    bool keepMeshData,
+    const BuildOptions& options)
+{
+    return vulkan::WorkerPool::get().submit(
+        [context = std::move(context), meshes = std::vector<Mesh>(meshes.begin(), meshes.end()),
+            keepMeshData, options]()
+        {
+            return GeometryStore(context, meshes, keepMeshData, options);
+        });
+}
+
+GeometryStore::~GeometryStore() {
+    if (pImp) {
+        auto& context = *getContext();
+        for (auto acc : pImp->blas) {
+            context.fnTable.vkDestroyAccelerationStructureKHR(
+                context.device, acc, nullptr);
+        }
+    }
+}
+
+/******************************** SERIALIZATION *******************************/
+
+namespace {
+
+//Serialized geometry stores start with this header followed by the size of
+//each blob and the blobs as returned by the driver
+struct SerializedHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t count;
+};
+constexpr uint32_t SerializedMagic = 0x53414850; //"PHAS"
+constexpr uint32_t SerializedVersion = 1;
+
+//blobs start with the driver and compatibility UUID, followed by the
+//serialized and the deserialized size
+constexpr size_t BlobHeaderSize = 2 * VK_UUID_SIZE + 3 * sizeof(uint64_t);
+constexpr size_t BlobDeserializedSizeOffset = 2 * VK_UUID_SIZE + sizeof(uint64_t);
+//serialized memory must be 256 byte aligned
+constexpr VkDeviceSize BlobAlignment = 256;
+
+VkDeviceSize alignBlob(VkDeviceSize size) {
+    return (size + BlobAlignment - 1) / BlobAlignment * BlobAlignment;
+}
+
+}
+
+std::vector<std::byte> GeometryStore::serialize() const {
+    auto& context = getContext();
+    auto count = static_cast<uint32_t>(pImp->blas.size());
+    if (count == 0)
+        return {};
+
+    //query serialization sizes
+    VkQueryPool queryPool;
+    VkQueryPoolCreateInfo poolInfo{
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .queryType = VK_QUERY_TYPE_ACCELERATION_STRUCTURE_SERIALIZATION_SIZE_KHR,
+        .queryCount = count
+    };
+    vulkan::checkResult(context->fnTable.vkCreateQueryPool(
+        context->device, &poolInfo, nullptr, &queryPool));
+    context->fnTable.vkResetQueryPool(context->device, queryPool, 0, count);
+    vulkan::oneTimeSubmit(*context, [&](VkCommandBuffer cmd) {
+        context->fnTable.vkCmdWriteAccelerationStructuresPropertiesKHR(cmd,
+            count, pImp->blas.data(),
+            VK_QUERY_TYPE_ACCELERATION_STRUCTURE_SERIALIZATION_SIZE_KHR,
+            queryPool, 0);
+    });
+    std::vector<uint64_t> blobSizes(count);
+    context->fnTable.vkGetQueryPoolResults(
+        context->device,
+        queryPool,
+        0, count,
+        count * sizeof(uint64_t),
+        blobSizes.data(),
+        sizeof(uint64_t),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+    context->fnTable.vkDestroyQueryPool(context->device, queryPool, nullptr);
+
+    //create host buffer to serialize into
+    VkDeviceSize totalSize = 0;
+    for (auto size : blobSizes)
+        totalSize += alignBlob(size);
+    //allocate extra space to align the start address
+    auto buffer = vulkan::createBuffer(context,
+        totalSize + BlobAlignment,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT |
+        VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    auto address = getBufferAddress(*context, buffer->buffer);
+    auto padding = alignBlob(address) - address;
+
+    //serialize
+    vulkan::oneTimeSubmit(*context, [&](VkCommandBuffer cmd) {
+        VkCopyAccelerationStructureToMemoryInfoKHR copyInfo{
+            .sType = VK_STRUCTURE_TYPE_COPY_ACCELERATION_STRUCTURE_TO_MEMORY_INFO_KHR,
+            .mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_SERIALIZE_KHR
+        };
+        auto dst = address + padding;
+        for (auto i = 0u; i < count; ++i) {
+            copyInfo.src = pImp->blas[i];
+            copyInfo.dst.deviceAddress = dst;
+            context->fnTable.vkCmdCopyAccelerationStructureToMemoryKHR(cmd, &copyInfo);
+            dst += alignBlob(blobSizes[i]);
+        }
+        //make result visible to host
+        VkMemoryBarrier barrier{
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_HOST_READ_BIT
+        };
+        vulkan::count(context->counters.barriers);
+        context->fnTable.vkCmdPipelineBarrier(cmd,
+            VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+            VK_PIPELINE_STAGE_HOST_BIT,
+            0, 1, &barrier, 0, nullptr, 0, nullptr);
+    });
+    vulkan::checkResult(vmaInvalidateAllocation(
+        context->allocator, buffer->allocation, 0, VK_WHOLE_SIZE));
+
+    //assemble result
+    SerializedHeader header{
+        .magic = SerializedMagic,
+        .version = SerializedVersion,
+        .count = count
+    };
+    auto resultSize = sizeof(SerializedHeader) + count * sizeof(uint64_t);
+    for (auto size : blobSizes)
+        resultSize += size;
+    std::vector<std::byte> result(resultSize);
+    auto pOut = result.data();
+    std::memcpy(pOut, &header, sizeof(SerializedHeader));
+    pOut += sizeof(SerializedHeader);
+    std::memcpy(pOut, blobSizes.data(), count * sizeof(uint64_t));
+    pOut += count * sizeof(uint64_t);
+    auto pIn = static_cast<const std::byte*>(buffer->allocInfo.pMappedData) + padding;
+    for (auto size : blobSizes) {
+        std::memcpy(pOut, pIn, size);
+        pOut += size;
+        pIn += alignBlob(size);
+    }
+
+    return result;
+}
+
+bool GeometryStore::Imp::load(
+    const ContextHandle& context,
+    std::span<const std::byte> data,
+    size_t count)
+{
+    //check header
+    SerializedHeader header;
+    if (count == 0 || data.size() < sizeof(SerializedHeader))
+        return false;
+    std::memcpy(&header, data.data(), sizeof(SerializedHeader));
+    if (header.magic != SerializedMagic ||
+        header.version != SerializedVersion ||
+        header.count != count)
+    {
+        return false;
+    }
+    data = data.subspan(sizeof(SerializedHeader));
+    if (data.size() < count * sizeof(uint64_t))
+        return false;
+    std::vector<uint64_t> blobSizes(count);
+    std::memcpy(blobSizes.data(), data.data(), count * sizeof(uint64_t));
+    data = data.subspan(count * sizeof(uint64_t));
+
+    //locate blobs and check they were created by a compatible device
+    std::vector<std::span<const std::byte>> blobs(count);
+    std::vector<VkDeviceSize> blasSizes(count);
+    for (auto i = 0u; i < count; ++i) {
+        if (blobSizes[i] < BlobHeaderSize || blobSizes[i] > data.size())
+            return false;
+        blobs[i] = data.first(blobSizes[i]);
+        data = data.subspan(blobSizes[i]);
+
+        VkAccelerationStructureVersionInfoKHR versionInfo{
+            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_VERSION_INFO_KHR,
+            .pVersionData = reinterpret_cast<const uint8_t*>(blobs[i].data())
+        };
+        VkAccelerationStructureCompatibilityKHR compatibility;
+        context->fnTable.vkGetDeviceAccelerationStructureCompatibilityKHR(
+            context->device, &versionInfo, &compatibility);
+        if (compatibility != VK_ACCELERATION_STRUCTURE_COMPATIBILITY_COMPATIBLE_KHR)
+            return false;
+        std::memcpy(&blasSizes[i], blobs[i].data() + BlobDeserializedSizeOffset, sizeof(uint64_t));
+    }
+
+    //upload blobs
+    VkDeviceSize uploadSize = 0;
+    for (auto& blob : blobs)
+        uploadSize += alignBlob(blob.size());
+    //allocate extra space to align the start address
+    auto uploadBuffer = vulkan::createBuffer(context,
+        uploadSize + BlobAlignment,
+        VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
+        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+        VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    auto uploadAddress = getBufferAddress(*context, uploadBuffer->buffer);
+    auto padding = alignBlob(uploadAddress) - uploadAddress;
+    {
+        auto p = static_cast<std::byte*>(uploadBuffer->allocInfo.pMappedData) + padding;
+        for (auto& blob : blobs) {
+            std::memcpy(p, blob.data(), blob.size());
+            p += alignBlob(blob.size());
+        }
+    }
+    vulkan::checkResult(vmaFlushAllocation(
+        context->allocator, uploadBuffer->allocation, 0, VK_WHOLE_SIZE));
+
+    //create blas
+    VkDeviceSize blasTotalSize = 0;
+    for (auto size : blasSizes)
+        blasTotalSize += alignBlob(size);
+    auto buffer = vulkan::createBuffer(context, blasTotalSize,
+        VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR |
+        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE);
+    VkDeviceSize offset = 0;
+    for (auto i = 0u; i < count; ++i) {
+        VkAccelerationStructureCreateInfoKHR accInfo{
+            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR,
+            .buffer = buffer->buffer,
+            .offset = offset,
+            .size = blasSizes[i],
+            .type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR
+        };
+        offset += alignBlob(blasSizes[i]);
+        VkAccelerationStructureKHR acc;
+        vulkan::checkResult(context->fnTable.vkCreateAccelerationStructureKHR(
+            context->device, &accInfo, nullptr, &acc));
+        blas.push_back(acc);
+    }
+
+    //deserialize
+    vulkan::oneTimeSubmit(*context, [&](VkCommandBuffer cmd) {
+        VkCopyMemoryToAccelerationStructureInfoKHR copyInfo{
+            .sType = VK_STRUCTURE_TYPE_COPY_MEMORY_TO_ACCELERATION_STRUCTURE_INFO_KHR,
+            .mode = VK_COPY_ACCELERATION_STRUCTURE_MODE_DESERIALIZE_KHR
+        };
+        auto src = uploadAddress + padding;
+        for (auto i = 0u; i < count; ++i) {
+            copyInfo.src.deviceAddress = src;
+            copyInfo.dst = blas[i];
+            context->fnTable.vkCmdCopyMemoryToAccelerationStructureKHR(cmd, &copyInfo);
+            src += alignBlob(blobs[i].size());
+        }
+    });
+
+    //Done -> fetch blas addresses
+    geometries.resize(count);
+    for (auto i = 0u; i < count; ++i) {
+        VkAccelerationStructureDeviceAddressInfoKHR addressInfo{
+            .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR,
+            .accelerationStructure = blas[i]
+        };
+        geometries[i].blas_address = context->fnTable.vkGetAccelerationStructureDeviceAddressKHR(
+            context->device, &addressInfo);
+        sizes.built += blasSizes[i];
+    }
+    sizes.compacted = sizes.built;
+    blasBuffer = std::move(buffer);
+    deserialized = true;
+
+    return true;
+}
+
+GeometryStore::GeometryStore(
+    ContextHandle _context,
+    std::span<const std::byte> serialized,
+    std::span<const Mesh> meshes,
+    const BuildOptions& options)
+    : Resource(std::move(_context))
+    , pImp(std::make_unique<Imp>())
+{
+    //serialized geometries cannot be updated as we lack the mesh data
+    if (!options.allowUpdate && pImp->load(getContext(), serialized, meshes.size())) {
+        trackResource("GeometryStore", pImp->sizes.compacted);
+        return;
+    }
+    //fall back to building
+    *this = GeometryStore(getContext(), meshes, false, options);
+}
+
+/********************************* MESH FILES *********************************/
+
+namespace {
+
+constexpr std::array<char, 8> MeshFileMagic = { 'H', 'P', 'M', 'E', 'S', 'H', '\0', '\1' };
+
+struct MeshFileHeader {
+    std::array<char, 8> magic;
+    uint64_t count;
+};
+struct MeshFileEntry {
+    uint64_t verticesOffset;
+    uint64_t verticesSize;
+    uint32_t vertexStride;
+    uint32_t vertexFormat;
+    uint64_t indicesOffset;
+    uint64_t indexCount;
+    uint32_t indexSize;
+    uint32_t padding;
+};
+static_assert(sizeof(MeshFileHeader) == 16);
+static_assert(sizeof(MeshFileEntry) == 48);
+
+//true, if the range [offset, offset + size) lies within length bytes
+bool inBounds(uint64_t offset, uint64_t size, uint64_t length) {
+    return offset <= length && size <= length - offset;
+}
+
+//read only view of a binary mesh container mapped into memory
+class MeshFile {
+public:
+    //meshes referencing the mapped memory
+    std::vector<Mesh> meshes;
+
+    MeshFile(const MeshFile&) = delete;
+    MeshFile& operator=(const MeshFile&) = delete;
+
+    explicit MeshFile(const std::filesystem::path& path) {
+        length = static_cast<uint64_t>(std::filesystem::file_size(path));
+        if (length < sizeof(MeshFileHeader))
+            throw std::runtime_error("Invalid mesh file!");
+        view = vulkan::mapFile(path, 0, length);
+        if (!view)
+            throw std::runtime_error("Failed to read mesh file!");
+        auto data = static_cast<const std::byte*>(view);
+
+        MeshFileHeader header;
+        std::memcpy(&header, data, sizeof(MeshFileHeader));
+        if (header.magic != MeshFileMagic ||
+            header.count > (length - sizeof(MeshFileHeader)) / sizeof(MeshFileEntry))
+        {
+            throw std::runtime_error("Invalid mesh file!");
+        }
+
+        meshes.resize(header.count);
+        for (auto i = 0u; i < header.count; ++i) {
+            MeshFileEntry entry;
+            std::memcpy(&entry,
+                data + sizeof(MeshFileHeader) + i * sizeof(MeshFileEntry),
+                sizeof(MeshFileEntry));
+            //mapping is page aligned -> offsets must respect component sizes
+            auto format = static_cast<VertexFormat>(entry.vertexFormat);
+            auto alignment = format == VertexFormat::FLOAT32 ? 4u : 2u;
+            if (entry.vertexFormat > static_cast<uint32_t>(VertexFormat::SNORM16) ||
+                entry.vertexStride == 0 || entry.vertexStride % alignment ||
+                entry.verticesOffset % alignment ||
+                !inBounds(entry.verticesOffset, entry.verticesSize, length))
+            {
+                throw std::runtime_error("Invalid mesh file!");
+            }
+            if ((entry.indexSize != 0 && entry.indexSize != 2 && entry.indexSize != 4) ||
+                (entry.indexSize == 0 && entry.indexCount != 0) ||
+                (entry.indexSize != 0 && entry.indicesOffset % entry.indexSize) ||
+                entry.indexCount > length ||
+                !inBounds(entry.indicesOffset, entry.indexCount * entry.indexSize, length))
+            {
+                throw std::runtime_error("Invalid mesh file!");
+            }
+
+            auto& mesh = meshes[i];
+            mesh.vertices = { data + entry.verticesOffset, entry.verticesSize };
+            mesh.vertexStride = entry.vertexStride;
+            mesh.vertexFormat = format;
+            auto indices = data + entry.indicesOffset;
+            if (entry.indexSize == 4)
+                mesh.indices = { reinterpret_cast<const uint32_t*>(indices), entry.indexCount };
+            else if (entry.indexSize == 2)
+                mesh.indices16 = { reinterpret_cast<const uint16_t*>(indices), entry.indexCount };
+        }
+    }
+    ~MeshFile() {
+        if (view)
+            vulkan::unmapFile(view, length);
+    }
+
+private:
+    void* view = nullptr;
+    uint64_t length = 0;
+};
+
+//streams the mesh data through the staging ring into device local memory,
+//packing as many ranges into each lease as fit
+BuildData streamBuildData(const ContextHandle& context,
+    std::span<const Mesh> meshes, bool keep)
+{
+    auto size = getMeshDataSize(meshes);
+    auto buffer = vulkan::createBuffer(context,
+        size,
+        VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR |
+        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        0);
+
+    //padding is not staged
+    uint64_t remaining = 0;
+    forEachMeshRange(meshes, [&remaining](std::span<const std::byte> src, uint64_t) {
+        remaining += src.size_bytes();
+    });
+    vulkan::count(context->counters.bytesUploaded, remaining);
+
+    std::optional<vulkan::StagingLease> staging;
+    std::vector<VkBufferCopy> regions;
+    uint64_t used = 0;
+    auto submit = [&]() {
+        staging->flush();
+        vulkan::oneTimeSubmit(*context, [&](VkCommandBuffer cmd) {
+            context->fnTable.vkCmdCopyBuffer(cmd,
+                staging->getBuffer(), buffer->buffer,
+                static_cast<uint32_t>(regions.size()), regions.data());
+        });
+        //ring can recycle the chunk for the next one
+        staging.reset();
+        regions.clear();
+        used = 0;
+    };
+    forEachMeshRange(meshes, [&](std::span<const std::byte> src, uint64_t offset) {
+        while (!src.empty()) {
+            if (!staging)
+                staging.emplace(context, std::min(remaining, vulkan::StagingLease::MaxSize));
+            auto memory = staging->getMemory();
+            auto chunk = std::min<uint64_t>(src.size_bytes(), memory.size() - used);
+            std::memcpy(memory.data() + used, src.data(), chunk);
+            regions.push_back({
+                .srcOffset = staging->getOffset() + used,
+                .dstOffset = offset,
+                .size = chunk
+            });
+            used += chunk;
+            remaining -= chunk;
+            offset += chunk;
+            src = src.subspan(chunk);
+            if (used == memory.size())
+                submit();
+        }
+    });
+    if (staging)
+        submit();
+
+    auto address = getBufferAddress(*context, buffer->buffer);
+    return {
+        .buffer = std::move(buffer),
+        .staging = vulkan::createEmptyBuffer(),
+        .size = size,
+        .address = address,
+        .keep = keep
+    };
+}
+
+}
+
+void saveMeshes(const std::filesystem::path& path, std::span<const Mesh> meshes) {
+    //data follows the table; align it to the largest component size
+    std::vector<MeshFileEntry> entries(meshes.size());
+    uint64_t offset = sizeof(MeshFileHeader) + meshes.size() * sizeof(MeshFileEntry);
+    for (auto i = 0u; i < meshes.size(); ++i) {
+        auto& mesh = meshes[i];
+        if (!mesh.indices.empty() && !mesh.indices16.empty())
+            throw std::logic_error("Mesh must not have both 32 and 16 bit indices!");
+        auto indices = getIndexData(mesh);
+        entries[i] = {
+            .verticesOffset = offset,
+            .verticesSize = mesh.vertices.size_bytes(),
+            .vertexStride = mesh.vertexStride,
+            .vertexFormat = static_cast<uint32_t>(mesh.vertexFormat),
+            .indicesOffset = offset + padRange(mesh.vertices.size_bytes()),
+            .indexCount = mesh.indices.size() + mesh.indices16.size(),
+            .indexSize = !mesh.indices.empty() ? 4u : !mesh.indices16.empty() ? 2u : 0u
+        };
+        offset = entries[i].indicesOffset + padRange(indices.size_bytes());
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    MeshFileHeader header{ .magic = MeshFileMagic, .count = meshes.size() };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(MeshFileHeader));
+    file.write(reinterpret_cast<const char*>(entries.data()),
+        static_cast<std::streamsize>(entries.size() * sizeof(MeshFileEntry)));
+    constexpr char zeros[4] = {};
+    auto writePadded = [&file, &zeros](std::span<const std::byte> data) {
+        file.write(reinterpret_cast<const char*>(data.data()),
+            static_cast<std::streamsize>(data.size_bytes()));
+        file.write(zeros, static_cast<std::streamsize>(
+            padRange(data.size_bytes()) - data.size_bytes()));
+    };
+    for (auto& mesh : meshes) {
+        writePadded(mesh.vertices);
+        writePadded(getIndexData(mesh));
+    }
+    if (!file)
+        throw std::runtime_error("Failed to write mesh file!");
+}
+
+GeometryStore::GeometryStore(
+    ContextHandle _context,
+    const std::filesystem::path& path,
+    bool keepMeshData,
+    const BuildOptions& options)
+    : Resource(std::move(_context))
+    , pImp(std::make_unique<Imp>())
+{
+    auto& context = getContext();
+    //updates must provide the same indices as the initial build
+    keepMeshData |= options.allowUpdate;
+
+    MeshFile file(path);
+    if (file.meshes.empty())
+        throw std::runtime_error("Mesh file does not contain any meshes!");
+    auto data = streamBuildData(context, file.meshes, keepMeshData);
+
+    pImp->buildMeshes(context, file.meshes, std::move(data), options);
+    trackResource("GeometryStore", pImp->sizes.compacted);
+}
+
+/****************************** UPDATE GEOMETRY *******************************/
+
+namespace {
+
+//blas are read by builds of tlas referencing them and by ray queries
+constexpr VkPipelineStageFlags2KHR BlasAccessStages =
+    VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR |
+    VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
+//tensors are accessed by shaders and transfers
+constexpr VkPipelineStageFlags2KHR TensorAccessStages =
+    VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR |
+    VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT_KHR;
+constexpr VkAccessFlags2KHR BuildAccess =
+    VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR |
+    VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+
+//buffer range accessed by a build
+struct BuildRange {
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    VkAccessFlags2KHR access;
+};
+
+//records a single acceleration structure build inside a sequence
+void recordBuild(vulkan::Command& cmd, const vulkan::Context& context,
+    const VkAccelerationStructureBuildGeometryInfoKHR& buildInfo,
+    uint32_t primitiveCount, std::initializer_list<BuildRange> ranges)
+{
+    //we're acting on the build stage
+    cmd.stage |= VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR;
+
+    //ensure inputs are written and previous builds finished
+    if (cmd.tracker) {
+        for (auto& range : ranges) {
+            cmd.tracker->buffer(range.buffer, range.offset, range.size,
+                VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, range.access);
+        }
+        cmd.tracker->barrier(context, cmd);
+        //ray queries read acceleration structures without declaring it
+        vulkan::pipelineBarrier(context, cmd, {}, std::to_array({
+            vulkan::GlobalBarrier{
+                .srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                .dstStage = VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR
+            }
+        }));
+    }
+    else {
+        vulkan::pipelineBarrier(context, cmd, {}, std::to_array({
+            vulkan::GlobalBarrier{
+                .srcStage = TensorAccessStages | BlasAccessStages,
+                .srcAccess = VK_ACCESS_2_MEMORY_WRITE_BIT_KHR |
+                             VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR,
+                .dstStage = VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+                .dstAccess = VK_ACCESS_2_SHADER_READ_BIT_KHR | BuildAccess
+            }
+        }));
+    }
+
+    //build
+    VkAccelerationStructureBuildRangeInfoKHR range{
+        .primitiveCount = primitiveCount
+    };
+    auto pRange = &range;
+    context.fnTable.vkCmdBuildAccelerationStructuresKHR(
+        cmd.buffer, 1, &buildInfo, &pRange);
+
+    //make the build visible to anything reading the acceleration structure.
+    //The tracker does not know about these reads, so we always record it.
+    //Also orders the input reads before later writes to them.
+    vulkan::pipelineBarrier(context, cmd, {}, std::to_array({
+        vulkan::GlobalBarrier{
+            .srcStage = VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR,
+            .srcAccess = VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR,
+            .dstStage = TensorAccessStages | BlasAccessStages,
+            .dstAccess = VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR
+        }
+    }));
+}
+
+}
+
+void UpdateGeometryCommand::record(vulkan::Command& cmd) const {
+    //to shorten the code
+    auto& geometries = store.get();
+    auto& tensor = vertices.get();
+    if (!vulkan::isSameDevice(geometries.getContext().get(), tensor.getContext().get()))
+        throw std::logic_error("Geometry store and tensor must originate from the same context!");
+    auto& context = geometries.getContext();
+    auto& imp = *geometries.pImp;
+    if (imp.refits.empty())
+        throw std::logic_error("Geometry store was not created with allowUpdate!");
+    if (index >= imp.refits.size())
+        throw std::out_of_range("Geometry index out of range!");
+    auto& refit = imp.refits[index];
+    if (offset + refit.dataSize > tensor.size_bytes())
+        throw std::logic_error("Tensor does not contain all vertices of the geometry!");
+    auto dataAddress = tensor.address() + offset;
+
+    //build info
+    auto geometry = refit.geometry;
+    if (geometry.geometryType == VK_GEOMETRY_TYPE_AABBS_KHR) {
+        if (dataAddress % 8)
+            throw std::logic_error("Box data must be 8 byte aligned!");
+        geometry.geometry.aabbs.data.deviceAddress = dataAddress;
+    }
+    else {
+        //16 bit formats only need 2 byte alignment
+        auto alignment =
+            geometry.geometry.triangles.vertexFormat == VK_FORMAT_R32G32B32_SFLOAT ? 4 : 2;
+        if (dataAddress % alignment)
+            throw std::logic_error("Vertex data must be aligned to its component size!");
+        geometry.geometry.triangles.vertexData.deviceAddress = dataAddress;
+    }
+    auto blas = imp.blas[index];
+    VkAccelerationStructureBuildGeometryInfoKHR buildInfo{
+        .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR,
+        .type = VK_ACCELERATION_STRUCTURE_TYPE_BOTTOM_LEVEL_KHR,
+        .flags = imp.flags,
+        .mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR,
+        .srcAccelerationStructure = blas,
+        .dstAccelerationStructure = blas,
+        .geometryCount = 1,
+        .pGeometries = &geometry
+    };
+    buildInfo.scratchData.deviceAddress =
+        getBufferAddress(*context, imp.scratchBuffer->buffer) + refit.scratchOffset;
+
+    //refit
+    auto& tensorBuffer = tensor.getBuffer();
+    recordBuild(cmd, *context, buildInfo, refit.primitiveCount, {
+        { tensorBuffer.buffer, tensorBuffer.offset + offset, refit.dataSize,
+            VK_ACCESS_2_SHADER_READ_BIT_KHR },
+        { imp.blasBuffer->buffer, refit.blasOffset, refit.blasSize, BuildAccess },
+        { imp.scratchBuffer->buffer, refit.scratchOffset, refit.scratchSize, BuildAccess }
+    });
+}
+
+UpdateGeometryCommand::UpdateGeometryCommand(const UpdateGeometryCommand& other) = default;
+UpdateGeometryCommand& UpdateGeometryCommand::operator=(const UpdateGeometryCommand& other) = default;
+
+UpdateGeometryCommand::UpdateGeometryCommand(UpdateGeometryCommand&& other) noexcept = default;
+UpdateGeometryCommand& UpdateGeometryCommand::operator=(UpdateGeometryCommand&& other) noexcept = default;
+
+UpdateGeometryCommand::UpdateGeometryCommand(
+    const GeometryStore& store,
+    size_t idx,
+    const Tensor<std::byte>& vertices,
+    uint64_t offset)
+    : store(store)
+    , index(idx)
+    , vertices(vertices)
+    , offset(offset)
+{}
+UpdateGeometryCommand::~UpdateGeometryCommand() = default;
+
+/*************************** ACCELERATION STRUCTURE ***************************/
+
+void writeInstances(std::span<const GeometryInstance> instances, std::span<std::byte> dst) {
+    static_assert(sizeof(VkAccelerationStructureInstanceKHR) == GeometryInstanceSize);
+    if (dst.size_bytes() < instances.size() * GeometryInstanceSize)
+        throw std::logic_error("Destination is too small to hold all instances!");
+
+    auto pOut = dst.data();
+    for (auto& instance : instances) {
+        VkAccelerationStructureInstanceKHR out{};
+        //copy transformation matrix
+        memcpy(&out.transform, &instance.transform, sizeof(VkTransformMatrixKHR));
+        //set rest
+        out.instanceCustomIndex = instance.customIndex;
+        out.mask = instance.mask;
+        out.instanceShaderBindingTableRecordOffset = 0;
+        out.flags = VK_GEOMETRY_INSTANCE_TRIANGLE_FACING_CULL_DISABLE_BIT_KHR;
+        out.accelerationStructureReference = instance.blas_address;
+        memcpy(pOut, &out, GeometryInstanceSize);
+        pOut += GeometryInstanceSize;
+    }
+}
+
+struct AccelerationStructure::Parameter {
+    VkAccelerationStructureKHR tlas = 0;
+    VkWriteDescriptorSetAccelerationStructureKHR descriptorInfo{};
+    uint32_t maxInstances = 0;
+    uint64_t size = 0;
+    VkBuildAccelerationStructureFlagsKHR flags = 0;
+
+    BufferHandle tlasBuffer = vulkan::createEmptyBuffer();
+    //only kept if the tlas can be rebuilt
+    BufferHandle scratchBuffer = vulkan::createEmptyBuffer();
+};
+
+void AccelerationStructure::bindParameter(VkWriteDescriptorSet& binding) const {
+    binding.pNext = &param->descriptorInfo;
+    binding.pBufferInfo = nullptr;
+    binding.pImageInfo = nullptr;
+    binding.pTexelBufferView = nullptr;
+}
+
+uint32_t AccelerationStructure::maxInstances() const noexcept {
+    return param->maxInstances;
+}
+uint64_t AccelerationStructure::size_bytes() const noexcept {
+    return param->size;
+}
+
+void AccelerationStructure::record(vulkan::Command& cmd,
+    const vulkan::Buffer& instances, uint64_t offset, uint32_t count, bool update) const
+{
+    auto& context = *getContext();
+    //sub-allocated buffers start at an offset
+    offset += instances.offset;
+    VkAccelerationStructureGeometryKHR geometry{
         .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
         .geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR,
         .flags = VK_GEOMETRY_OPAQUE_BIT_KHR
     };
-    tlasGeometry.geometry.instances = VkAccelerationStructureGeometryInstancesDataKHR{
+    geometry.geometry.instances = VkAccelerationStructureGeometryInstancesDataKHR{
         .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR,
         .arrayOfPointers = VK_FALSE,
-        .data = { .deviceAddress = instanceBufferAddress }
+        .data = { .deviceAddress = getBufferAddress(context, instances.buffer) + offset }
+    };
+    VkAccelerationStructureBuildGeometryInfoKHR buildInfo{
+        .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR,
+        .type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR,
+        .flags = param->flags,
+        .mode = update ?
+            VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR :
+            VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR,
+        .srcAccelerationStructure = update ? param->tlas : VK_NULL_HANDLE,
+        .dstAccelerationStructure = param->tlas,
+        .geometryCount = 1,
+        .pGeometries = &geometry,
+        .scratchData = { .deviceAddress = getBufferAddress(context, param->scratchBuffer->buffer) }
     };
+    recordBuild(cmd, context, buildInfo, count, {
+        { instances.buffer, offset, uint64_t(count) * GeometryInstanceSize,
+            VK_ACCESS_2_SHADER_READ_BIT_KHR },
+        { param->tlasBuffer->buffer, 0, VK_WHOLE_SIZE, BuildAccess },
+        { param->scratchBuffer->buffer, 0, VK_WHOLE_SIZE, BuildAccess }
+    });
+}
+
+AccelerationStructure::AccelerationStructure(AccelerationStructure&&) noexcept = default;
+AccelerationStructure& AccelerationStructure::operator=(AccelerationStructure&&) noexcept = default;
+
+AccelerationStructure::AccelerationStructure(
+    ContextHandle context,
+    const GeometryInstance& instance,
+    const BuildOptions& options)
+    : AccelerationStructure(std::move(context), { &instance, 1 }, options)
+{}
+AccelerationStructure::AccelerationStructure(
+    ContextHandle _context,
+    std::span<const GeometryInstance> instances,
+    const BuildOptions& options)
+    : AccelerationStructure(std::move(_context),
+        static_cast<uint32_t>(instances.size()), options)
+{
+    auto& context = getContext();
+    //create instance buffer
+    auto instanceBuffer = vulkan::createBuffer(context,
+        instances.size() * sizeof(VkAccelerationStructureInstanceKHR),
+        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
+        VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR,
+        VMA_ALLOCATION_CREATE_MAPPED_BIT |
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+    //fill instance buffer
+    writeInstances(instances, {
+        static_cast<std::byte*>(instanceBuffer->allocInfo.pMappedData),
+        instances.size() * GeometryInstanceSize
+    });
+
+    //build tlas on device
+    vulkan::oneTimeSubmit(*context, options.queue, [&](VkCommandBuffer buffer) {
+        vulkan::Command cmd{ .buffer = buffer };
+        record(cmd, *instanceBuffer, 0, param->maxInstances, false);
+    });
+    //built once -> no need for scratch memory anymore
+    param->scratchBuffer.reset();
+}
+AccelerationStructure::AccelerationStructure(
+    ContextHandle _context,
+    uint32_t maxInstances,
+    const BuildOptions& options)
+    : Resource(std::move(_context))
+    , param(std::make_unique<Parameter>())
+{
+    checkBuildQueue(options);
+    auto& context = getContext();
+    param->maxInstances = maxInstances;
+    //tlas are small and rebuilt often -> not worth compacting
+    param->flags = getBuildFlags(options) &
+        ~VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_COMPACTION_BIT_KHR;
 
     //get size info
+    VkAccelerationStructureGeometryKHR tlasGeometry{
+        .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR,
+        .geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR,
+        .flags = VK_GEOMETRY_OPAQUE_BIT_KHR
+    };
+    tlasGeometry.geometry.instances = VkAccelerationStructureGeometryInstancesDataKHR{
+        .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR,
+        .arrayOfPointers = VK_FALSE
+    };
     VkAccelerationStructureBuildGeometryInfoKHR tlasGeometryInfo{
         .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR,
         .type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR,
-        .flags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR,
+        .flags = param->flags,
         .geometryCount = 1,
         .pGeometries = &tlasGeometry
     };
-    uint32_t primitiveCount = static_cast<uint32_t>(instances.size());
     VkAccelerationStructureBuildSizesInfoKHR tlasSizeInfo{
         .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_SIZES_INFO_KHR,
     };
     context->fnTable.vkGetAccelerationStructureBuildSizesKHR(
         context->device,
         VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR,
-        &tlasGeometryInfo, &primitiveCount, &tlasSizeInfo);
+        &tlasGeometryInfo, &maxInstances, &tlasSizeInfo);
 
     //create buffer for tlas
+    param->size = tlasSizeInfo.accelerationStructureSize;
     param->tlasBuffer = vulkan::createBuffer(context,
         tlasSizeInfo.accelerationStructureSize,
         VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR |
@@ -612,35 +1844,13 @@ AccelerationStructure::AccelerationStructure(
     };
     vulkan::checkResult(context->fnTable.vkCreateAccelerationStructureKHR(
         context->device, &accInfo, nullptr, &param->tlas));
-    tlasGeometryInfo.dstAccelerationStructure = param->tlas;
 
-    //create scratch buffer
-    auto scratchBuffer = vulkan::createBuffer(context,
-        tlasSizeInfo.buildScratchSize,
+    //create scratch buffer large enough for both builds and updates
+    param->scratchBuffer = vulkan::createBuffer(context,
+        std::max(tlasSizeInfo.buildScratchSize, tlasSizeInfo.updateScratchSize),
         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
         VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
         0);
-    //get device address
-    {
-        VkBufferDeviceAddressInfo addressInfo{
-            .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
-            .buffer = scratchBuffer->buffer
-        };
-        tlasGeometryInfo.scratchData.deviceAddress =
-            context->fnTable.vkGetBufferDeviceAddress(context->device, &addressInfo);
-    }
-
-    //range info
-    VkAccelerationStructureBuildRangeInfoKHR tlasRangeInfo{
-        .primitiveCount = static_cast<uint32_t>(instances.size())
-    };
-    auto pRangeInfo = &tlasRangeInfo;
-
-    //build tlas one device
-    vulkan::oneTimeSubmit(*context, [&context, &tlasGeometryInfo, &pRangeInfo](VkCommandBuffer cmd) {
-        context->fnTable.vkCmdBuildAccelerationStructuresKHR(cmd,
-        1, &tlasGeometryInfo, &pRangeInfo);
-    });
 
     //build descriptor info
     param->descriptorInfo = VkWriteDescriptorSetAccelerationStructureKHR{
@@ -648,6 +1858,66 @@ AccelerationStructure::AccelerationStructure(
         .accelerationStructureCount = 1,
         .pAccelerationStructures = &param->tlas
     };
+    trackResource("AccelerationStructure", size_bytes());
+}
+
+void RebuildAccelerationStructureCommand::record(vulkan::Command& cmd) const {
+    //to shorten the code
+    auto& structure = accelerationStructure.get();
+    auto& tensor = instances.get();
+    if (!vulkan::isSameDevice(structure.getContext().get(), tensor.getContext().get()))
+        throw std::logic_error("Acceleration structure and tensor must originate from the same context!");
+    auto& param = *structure.param;
+    if (!param.scratchBuffer)
+        throw std::logic_error("Acceleration structure was not created for rebuilds!");
+    if (count > param.maxInstances)
+        throw std::logic_error("Instance count exceeds the capacity of the acceleration structure!");
+    if (update && !(param.flags & VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR))
+        throw std::logic_error("Acceleration structure was not created with allowUpdate!");
+    if (offset + uint64_t(count) * GeometryInstanceSize > tensor.size_bytes())
+        throw std::logic_error("Tensor does not contain all instances!");
+    if ((tensor.address() + offset) % 16)
+        throw std::logic_error("Instance data must be 16 byte aligned!");
+
+    structure.record(cmd, tensor.getBuffer(), offset, count, update);
+}
+
+RebuildAccelerationStructureCommand::RebuildAccelerationStructureCommand(
+    const RebuildAccelerationStructureCommand& other) = default;
+RebuildAccelerationStructureCommand& RebuildAccelerationStructureCommand::operator=(
+    const RebuildAccelerationStructureCommand& other) = default;
+
+RebuildAccelerationStructureCommand::RebuildAccelerationStructureCommand(
+    RebuildAccelerationStructureCommand&& other) noexcept = default;
+RebuildAccelerationStructureCommand& RebuildAccelerationStructureCommand::operator=(
+    RebuildAccelerationStructureCommand&& other) noexcept = default;
+
+RebuildAccelerationStructureCommand::RebuildAccelerationStructureCommand(
+    const AccelerationStructure& accelerationStructure,
+    const Tensor<std::byte>& instances,
+    uint32_t count,
+    uint64_t offset,
+    bool update)
+    : accelerationStructure(accelerationStructure)
+    , instances(instances)
+    , count(count)
+    , offset(offset)
+    , update(update)
+{}
+RebuildAccelerationStructureCommand::~RebuildAccelerationStructureCommand() = default;
+
+std::future<AccelerationStructure> AccelerationStructure::buildAsync(
+    ContextHandle context,
+    std::span<const GeometryInstance> instances,
+    const BuildOptions& options)
+{
+    return vulkan::WorkerPool::get().submit(
+        [context = std::move(context),
+            instances = std::vector<GeometryInstance>(instances.begin(), instances.end()),
+            options]()
+        {
+            return AccelerationStructure(context, instances, options);
+        });
 }
 
 AccelerationStructure::~AccelerationStructure() {
@@ -658,4 +1928,261 @@ AccelerationStructure::~AccelerationStructure() {
     }
 }
 
+/********************************* RAY CASTER *********************************/
+
+namespace {
+
+//expects LOCAL_SIZE, RAYS and MODE to be defined
+constexpr char RayCastSource[] = R"(
+#version 460
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_ray_query : require
+
+layout(local_size_x = LOCAL_SIZE) in;
+
+struct Ray {
+    vec3 origin;
+    float tMin;
+    vec3 direction;
+    float tMax;
+};
+struct Hit {
+    float t;
+    uint instanceIndex;
+    uint customIndex;
+    uint primitiveIndex;
+    vec2 barycentrics;
+    uint geometryIndex;
+    uint count;
+};
+
+layout(buffer_reference, std430, buffer_reference_align = 16) readonly buffer Rays { Ray v[]; };
+layout(buffer_reference, std430, buffer_reference_align = 16) writeonly buffer Hits { Hit v[]; };
+
+layout(binding = 0) uniform accelerationStructureEXT tlas;
+
+layout(push_constant) uniform Push {
+    Rays rays;
+    Hits hits;
+    uint count;
+};
+
+#define MISS 0xFFFFFFFFu
+
+//the intersection getters require committed to be a constant expression
+#define FILL(NAME, COMMITTED) \
+void NAME(rayQueryEXT query, inout Hit hit) { \
+    hit.t = rayQueryGetIntersectionTEXT(query, COMMITTED); \
+    hit.instanceIndex = rayQueryGetIntersectionInstanceIdEXT(query, COMMITTED); \
+    hit.customIndex = rayQueryGetIntersectionInstanceCustomIndexEXT(query, COMMITTED); \
+    hit.primitiveIndex = rayQueryGetIntersectionPrimitiveIndexEXT(query, COMMITTED); \
+    hit.barycentrics = rayQueryGetIntersectionBarycentricsEXT(query, COMMITTED); \
+    hit.geometryIndex = rayQueryGetIntersectionGeometryIndexEXT(query, COMMITTED); \
+}
+FILL(fillCommitted, true)
+FILL(fillCandidate, false)
+
+void main() {
+    uint first = gl_WorkGroupID.x * LOCAL_SIZE * RAYS + gl_LocalInvocationID.x;
+    for (uint k = 0; k < RAYS; ++k) {
+        uint i = first + k * LOCAL_SIZE;
+        if (i >= count)
+            return;
+
+        Ray ray = rays.v[i];
+        Hit hit = Hit(ray.tMax, MISS, 0, 0, vec2(0.0), 0, 0);
+        rayQueryEXT query;
+#if MODE == 2
+        //visit every triangle as candidate without committing it, as that
+        //would cull the ones further away
+        rayQueryInitializeEXT(query, tlas, gl_RayFlagsNoOpaqueEXT, 0xFF,
+            ray.origin, ray.tMin, ray.direction, ray.tMax);
+        while (rayQueryProceedEXT(query)) {
+            if (rayQueryGetIntersectionTypeEXT(query, false) !=
+                gl_RayQueryCandidateIntersectionTriangleEXT)
+            {
+                continue;
+            }
+            hit.count++;
+            if (hit.instanceIndex == MISS || rayQueryGetIntersectionTEXT(query, false) < hit.t)
+                fillCandidate(query, hit);
+        }
+#else
+        //opaque triangles are committed during traversal, while candidates
+        //of bounding boxes are skipped
+#if MODE == 1
+        uint flags = gl_RayFlagsOpaqueEXT | gl_RayFlagsTerminateOnFirstHitEXT;
+#else
+        uint flags = gl_RayFlagsOpaqueEXT;
+#endif
+        rayQueryInitializeEXT(query, tlas, flags, 0xFF,
+            ray.origin, ray.tMin, ray.direction, ray.tMax);
+        while (rayQueryProceedEXT(query)) {}
+        if (rayQueryGetIntersectionTypeEXT(query, true) ==
+            gl_RayQueryCommittedIntersectionTriangleEXT)
+        {
+            fillCommitted(query, hit);
+            hit.count = 1;
+        }
+#endif
+        hits.v[i] = hit;
+    }
+}
+)";
+
+struct RayCastPush {
+    uint64_t rays;
+    uint64_t hits;
+    uint32_t count;
+    uint32_t padding;
+};
+
+constexpr uint32_t DefaultRaysPerThread = 1;
+
+}
+
+struct CastRaysCommand::State {
+    std::array<std::byte, sizeof(RayCastPush)> push;
+    //empty if there are no rays to cast
+    std::optional<DispatchCommand> dispatch;
+    //tensors accessed via their address; declared to the hazard tracker
+    std::reference_wrapper<const Tensor<std::byte>> rays;
+    std::reference_wrapper<const Tensor<std::byte>> hits;
+    uint64_t raysSize;
+    uint64_t hitsSize;
+};
+
+void CastRaysCommand::record(vulkan::Command& cmd) const {
+    if (!state->dispatch)
+        return;
+
+    //dispatch will place the barrier
+    if (cmd.tracker) {
+        auto& rays = state->rays.get().getBuffer();
+        auto& hits = state->hits.get().getBuffer();
+        cmd.tracker->buffer(rays.buffer, rays.offset, state->raysSize,
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+            VK_ACCESS_2_SHADER_READ_BIT_KHR);
+        cmd.tracker->buffer(hits.buffer, hits.offset, state->hitsSize,
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+            VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    }
+    state->dispatch->record(cmd);
+}
+
+CastRaysCommand::CastRaysCommand(const CastRaysCommand&) = default;
+CastRaysCommand& CastRaysCommand::operator=(const CastRaysCommand&) = default;
+
+CastRaysCommand::CastRaysCommand(CastRaysCommand&&) noexcept = default;
+CastRaysCommand& CastRaysCommand::operator=(CastRaysCommand&&) noexcept = default;
+
+CastRaysCommand::CastRaysCommand(std::shared_ptr<const State> state)
+    : state(std::move(state))
+{}
+CastRaysCommand::~CastRaysCommand() = default;
+
+struct RayCaster::pImp {
+    ContextHandle context;
+    uint32_t localSize;
+    uint32_t raysPerThread;
+
+    //programs are compiled on first use; the mutex also guards binding the
+    //acceleration structure until the dispatch took its snapshot
+    std::mutex mutex;
+    Compiler compiler;
+    std::array<std::unique_ptr<Program>, 3> programs;
+
+    Program& getProgram(RayCastMode mode) {
+        auto& program = programs[static_cast<size_t>(mode)];
+        if (program)
+            return *program;
+
+        compiler.setOptions({ .defines = {
+            { "LOCAL_SIZE", std::to_string(localSize) },
+            { "RAYS", std::to_string(raysPerThread) },
+            { "MODE", std::to_string(static_cast<int>(mode)) }
+        }});
+        program = std::make_unique<Program>(context, compiler.compile(RayCastSource));
+        return *program;
+    }
+
+    pImp(ContextHandle context, const RayCasterOptions& options)
+        : context(std::move(context))
+        , localSize(options.localSize)
+        , raysPerThread(options.raysPerThread ? options.raysPerThread : DefaultRaysPerThread)
+    {
+        if (!isRaytracingEnabled(this->context))
+            throw std::logic_error("Ray tracing is not enabled!");
+
+        auto info = getDeviceInfo(this->context);
+        if (localSize == 0) {
+            //two subgroups hide some of the divergence while keeping enough
+            //workgroups in flight
+            auto props = getSubgroupProperties(this->context);
+            localSize = props.maxSubgroupSize > 0 ? 2 * props.maxSubgroupSize : 64;
+            localSize = std::min(localSize, info.maxWorkGroupInvocations);
+        }
+        if (localSize > info.maxWorkGroupInvocations)
+            throw std::logic_error("Local size exceeds the device's limit!");
+    }
+};
+
+uint32_t RayCaster::getLocalSize() const noexcept {
+    return _pImp->localSize;
+}
+uint32_t RayCaster::getRaysPerThread() const noexcept {
+    return _pImp->raysPerThread;
+}
+
+CastRaysCommand RayCaster::castRays(
+    const AccelerationStructure& accelerationStructure,
+    const Tensor<std::byte>& rays,
+    const Tensor<std::byte>& hits,
+    RayCastMode mode,
+    uint32_t count) const
+{
+    auto maxCount = rays.size_bytes() / sizeof(Ray);
+    if (count == std::numeric_limits<uint32_t>::max())
+        count = static_cast<uint32_t>(std::min<uint64_t>(maxCount, count));
+    if (count > maxCount)
+        throw std::out_of_range("Count exceeds the size of the ray tensor!");
+    if (hits.size_bytes() < sizeof(RayHit) * uint64_t(count))
+        throw std::logic_error("Hit tensor is too small!");
+
+    auto state = std::make_shared<CastRaysCommand::State>(CastRaysCommand::State{
+        .push = {},
+        .dispatch = std::nullopt,
+        .rays = std::cref(rays),
+        .hits = std::cref(hits),
+        .raysSize = sizeof(Ray) * uint64_t(count),
+        .hitsSize = sizeof(RayHit) * uint64_t(count)
+    });
+    RayCastPush push{
+        .rays = rays.address(),
+        .hits = hits.address(),
+        .count = count
+    };
+    std::memcpy(state->push.data(), &push, sizeof(push));
+
+    if (count > 0) {
+        auto perGroup = uint64_t(_pImp->localSize) * _pImp->raysPerThread;
+        auto groups = static_cast<uint32_t>((count + perGroup - 1) / perGroup);
+
+        std::lock_guard<std::mutex> lock(_pImp->mutex);
+        auto& program = _pImp->getProgram(mode);
+        program.bindParameter(accelerationStructure, 0);
+        state->dispatch.emplace(program.dispatch(
+            std::span<const std::byte>(state->push), groups));
+    }
+    return CastRaysCommand(std::move(state));
+}
+
+RayCaster::RayCaster(RayCaster&& other) noexcept = default;
+RayCaster& RayCaster::operator=(RayCaster&& other) noexcept = default;
+
+RayCaster::RayCaster(ContextHandle context, const RayCasterOptions& options)
+    : _pImp(std::make_unique<pImp>(std::move(context), options))
+{}
+RayCaster::~RayCaster() = default;
+
 }
@@ -0,0 +1,229 @@
+#include "hephaistos/scheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace hephaistos {
+
+struct TaskScheduler::pImp {
+    //buffered configurations tasks rotate through
+    std::vector<std::reference_wrapper<const Subroutine>> configs;
+    TaskFunction update;
+    TaskFunction process;
+    uint32_t queueSize;
+
+    //pipeline: tasks finished on the device
+    //update: configurations prepared by the update thread
+    //process: tasks processed by the process thread
+    Timeline pipelineTimeline;
+    Timeline updateTimeline;
+    std::optional<Timeline> processTimeline;
+
+    //guards the counters below; schedule() itself is serialized separately
+    mutable std::mutex mutex;
+    std::mutex scheduleMutex;
+    std::condition_variable workCondition;
+    std::condition_variable queueCondition;
+    uint64_t totalTasks = 0;
+    uint64_t updatedTasks = 0;
+    uint64_t processedTasks = 0;
+    bool stop = false;
+
+    std::thread updateThread;
+    std::thread processThread;
+
+    //runs func for each task once it got scheduled; finishes pending tasks
+    //before stopping
+    template<class F>
+    void work(uint64_t& counter, F&& func) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            workCondition.wait(lock, [&]() { return stop || counter < totalTasks; });
+            if (counter >= totalTasks)
+                return;
+            auto task = counter;
+            lock.unlock();
+            func(task);
+            lock.lock();
+            ++counter;
+            queueCondition.notify_all();
+        }
+    }
+
+    void runUpdate() {
+        work(updatedTasks, [this](uint64_t task) {
+            //wait for the task previously using the same config to finish
+            auto count = configs.size();
+            if (task >= count)
+                pipelineTimeline.waitValue(task - count + 1);
+            //user provided function -> must not prevent advancing the timeline
+            try {
+                update(static_cast<uint32_t>(task % count), task);
+            }
+            catch (...) {}
+            updateTimeline.setValue(task + 1);
+        });
+    }
+
+    void runProcess() {
+        work(processedTasks, [this](uint64_t task) {
+            pipelineTimeline.waitValue(task + 1);
+            try {
+                process(static_cast<uint32_t>(task % configs.size()), task);
+            }
+            catch (...) {}
+            processTimeline->setValue(task + 1);
+        });
+    }
+
+    const Timeline& getFinishedTimeline() const {
+        return processTimeline ? *processTimeline : pipelineTimeline;
+    }
+
+    pImp(
+        std::vector<std::reference_wrapper<const Subroutine>> configs,
+        TaskFunction update,
+        TaskFunction process,
+        uint32_t queueSize)
+        : configs(std::move(configs))
+        , update(std::move(update))
+        , process(std::move(process))
+        , queueSize(queueSize)
+        , pipelineTimeline(this->configs.front().get().getContext())
+        , updateTimeline(this->configs.front().get().getContext())
+        , processTimeline()
+    {
+        if (this->process)
+            processTimeline.emplace(this->configs.front().get().getContext());
+        //start threads last, as they access the members above
+        updateThread = std::thread(&pImp::runUpdate, this);
+        if (this->process)
+            processThread = std::thread(&pImp::runProcess, this);
+    }
+    ~pImp() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        workCondition.notify_all();
+        updateThread.join();
+        if (processThread.joinable())
+            processThread.join();
+    }
+};
+
+uint64_t TaskScheduler::getTotalTasks() const {
+    std::lock_guard<std::mutex> lock(_pImp->mutex);
+    return _pImp->totalTasks;
+}
+uint64_t TaskScheduler::getPendingTasks() const {
+    std::lock_guard<std::mutex> lock(_pImp->mutex);
+    return _pImp->totalTasks - _pImp->updatedTasks;
+}
+uint64_t TaskScheduler::getFinishedTasks() const {
+    return _pImp->getFinishedTimeline().getValue();
+}
+uint32_t TaskScheduler::getQueueSize() const noexcept {
+    return _pImp->queueSize;
+}
+uint32_t TaskScheduler::getConfigCount() const noexcept {
+    return static_cast<uint32_t>(_pImp->configs.size());
+}
+
+ScheduleResult TaskScheduler::schedule(uint32_t count, uint64_t timeout) {
+    std::lock_guard<std::mutex> scheduleLock(_pImp->scheduleMutex);
+
+    //reserve free spots in the queue
+    uint32_t n = 0;
+    uint64_t first;
+    {
+        std::unique_lock<std::mutex> lock(_pImp->mutex);
+        first = _pImp->totalTasks;
+        auto queueSize = _pImp->queueSize;
+        auto hasSpace = [&]() {
+            return first + n - _pImp->updatedTasks < queueSize;
+        };
+        for (; n < count; ++n) {
+            //tasks of this call only get consumed after submission
+            if (queueSize == 0)
+                continue;
+            if (n >= queueSize)
+                break;
+            if (timeout == std::numeric_limits<uint64_t>::max())
+                _pImp->queueCondition.wait(lock, hasSpace);
+            else if (!_pImp->queueCondition.wait_for(lock, std::chrono::nanoseconds(timeout), hasSpace))
+                break;
+        }
+    }
+    if (n == 0)
+        return { 0, std::nullopt };
+
+    //record tasks
+    auto& configs = _pImp->configs;
+    uint64_t configCount = configs.size();
+    auto builder = beginSequence(_pImp->pipelineTimeline, first);
+    for (auto task = first; task < first + n; ++task) {
+        //wait on previous task
+        builder.WaitFor(_pImp->pipelineTimeline, task);
+        //wait on update thread
+        builder.WaitFor(_pImp->updateTimeline, task + 1);
+        //processing of the task previously using the same config must have
+        //finished before its results get overwritten
+        if (_pImp->processTimeline && task >= configCount)
+            builder.WaitFor(*_pImp->processTimeline, task - configCount + 1);
+        builder.And(configs[task % configCount].get());
+    }
+    auto submission = builder.Submit();
+
+    //wake up workers
+    {
+        std::lock_guard<std::mutex> lock(_pImp->mutex);
+        _pImp->totalTasks += n;
+    }
+    _pImp->workCondition.notify_all();
+
+    return { n, std::move(submission) };
+}
+
+void TaskScheduler::wait() const {
+    wait(getTotalTasks());
+}
+void TaskScheduler::wait(uint64_t task) const {
+    _pImp->getFinishedTimeline().waitValue(task);
+}
+bool TaskScheduler::wait(uint64_t task, uint64_t timeout) const {
+    return _pImp->getFinishedTimeline().waitValue(task, timeout);
+}
+
+TaskScheduler::TaskScheduler(TaskScheduler&& other) noexcept = default;
+TaskScheduler& TaskScheduler::operator=(TaskScheduler&& other) noexcept = default;
+
+TaskScheduler::TaskScheduler(
+    std::vector<std::reference_wrapper<const Subroutine>> configs,
+    TaskFunction update,
+    TaskFunction process,
+    uint32_t queueSize)
+    : _pImp()
+{
+    if (configs.size() < 2)
+        throw std::logic_error("TaskScheduler requires at least two configurations!");
+    auto& context = configs.front().get().getContext();
+    if (std::any_of(configs.begin(), configs.end(),
+        [&context](const Subroutine& config) { return config.getContext() != context; }))
+    {
+        throw std::logic_error("All configurations must be created on the same context!");
+    }
+    if (!update)
+        throw std::logic_error("TaskScheduler requires an update function!");
+    _pImp = std::make_unique<pImp>(
+        std::move(configs), std::move(update), std::move(process), queueSize);
+}
+
+TaskScheduler::~TaskScheduler() = default;
+
+}
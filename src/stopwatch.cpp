@@ -1,12 +1,19 @@
 #include "hephaistos/stopwatch.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <deque>
 #include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
 
 #include "volk.h"
 
 #include "vk/result.hpp"
 #include "vk/types.hpp"
+#include "vk/util.hpp"
 
 namespace hephaistos {
 
@@ -40,14 +47,92 @@ public:
     virtual ~TimeStampCommand() = default;
 };
 
+//brackets the statistics query with timestamps
+class StatisticsCommand : public Command {
+public:
+    const vulkan::Context& context;
+    bool begin;
+    VkQueryPool timestampPool;
+    VkQueryPool statisticsPool;
+
+    void record(vulkan::Command& cmd) const override {
+        if (begin) {
+            cmd.stage |= VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            context.fnTable.vkCmdWriteTimestamp(cmd.buffer,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, timestampPool, 0);
+            context.fnTable.vkCmdBeginQuery(cmd.buffer,
+                statisticsPool, 0, 0);
+        }
+        else {
+            cmd.stage |= VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+            context.fnTable.vkCmdEndQuery(cmd.buffer,
+                statisticsPool, 0);
+            context.fnTable.vkCmdWriteTimestamp(cmd.buffer,
+                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestampPool, 1);
+        }
+    }
+
+    StatisticsCommand(const vulkan::Context& context, bool begin)
+        : context(context)
+        , begin(begin)
+        , timestampPool(nullptr)
+        , statisticsPool(nullptr)
+    {}
+    virtual ~StatisticsCommand() = default;
+};
+
+//returns NaN if not both timestamps are available
+double readElapsedTime(const vulkan::Context& context, VkQueryPool queryPool,
+    const vulkan::TimestampProperties& props, bool wait)
+{
+    VkQueryResultFlags flags =
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT;
+    if (wait)
+        flags |= VK_QUERY_RESULT_WAIT_BIT;
+
+    struct Result {
+        uint64_t timestamp;
+        uint64_t valid;
+    };
+    std::array<Result, 2> queries;
+
+    auto result = context.fnTable.vkGetQueryPoolResults(
+        context.device,
+        queryPool,
+        0, 2,
+        2 * sizeof(Result),
+        queries.data(),
+        sizeof(Result),
+        flags);
+    if (result < 0)
+        vulkan::checkResult(result); //will throw
+
+    if (queries[0].valid && queries[1].valid) {
+        auto delta = queries[1].timestamp - queries[0].timestamp;
+        delta >>= (64 - props.validBits);
+        return delta * static_cast<double>(props.period);
+    }
+    else {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+}
+
+bool isCalibratedTimestampsSupported(const ContextHandle& context) {
+    return context->calibratedTimestamps;
+}
+
+ClockCorrelation getClockCorrelation(const ContextHandle& context) {
+    auto calibration = vulkan::getClockCalibration(*context, true);
+    return { calibration.offset, calibration.deviation };
 }
 
 struct StopWatch::pImp {
     const vulkan::Context& context;
 
     VkQueryPool queryPool;
-    uint32_t validBits;
-    float period;
+    vulkan::TimestampProperties props;
 
     TimeStampCommand startCommand;
     TimeStampCommand endCommand;
@@ -55,21 +140,10 @@ struct StopWatch::pImp {
     pImp(const vulkan::Context& context)
         : context(context)
         , queryPool(nullptr)
+        , props(vulkan::getTimestampProperties(context))
         , startCommand(context, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, nullptr, 0)
         , endCommand(context, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, nullptr, 1)
     {
-        //query timestamp period
-        VkPhysicalDeviceProperties devProps;
-        vkGetPhysicalDeviceProperties(context.physicalDevice, &devProps);
-        period = devProps.limits.timestampPeriod;
-
-        //query timestamp valid bits
-        uint32_t n;
-        vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &n, nullptr);
-        std::vector<VkQueueFamilyProperties> qProps(n);
-        vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &n, qProps.data());
-        validBits = qProps[context.queueFamily].timestampValidBits;
-
         //create query pool
         VkQueryPoolCreateInfo info{
             .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
@@ -110,36 +184,29 @@ void StopWatch::reset() {
 }
 
 double StopWatch::getElapsedTime(bool wait) const {
+    return readElapsedTime(_pImp->context, _pImp->queryPool, _pImp->props, wait);
+}
+double StopWatch::getStartTime(bool wait) const {
     VkQueryResultFlags flags =
         VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT;
     if (wait)
         flags |= VK_QUERY_RESULT_WAIT_BIT;
 
-    struct Result {
-        uint64_t timestamp;
-        uint64_t valid;
-    };
-    std::array<Result, 2> queries;
-
-    auto result = _pImp->context.fnTable.vkGetQueryPoolResults(
-        _pImp->context.device,
-        _pImp->queryPool,
-        0, 2,
-        2 * sizeof(Result),
-        queries.data(),
-        sizeof(Result),
-        flags);
+    std::array<uint64_t, 2> query;
+    auto& context = _pImp->context;
+    auto result = context.fnTable.vkGetQueryPoolResults(
+        context.device, _pImp->queryPool,
+        0, 1, sizeof(query), query.data(), sizeof(query), flags);
     if (result < 0)
         vulkan::checkResult(result); //will throw
-    
-    if (queries[0].valid && queries[1].valid) {
-        auto delta = queries[1].timestamp - queries[0].timestamp;
-        delta >>= (64 - _pImp->validBits);
-        return delta * static_cast<double>(_pImp->period);
-    }
-    else {
+    if (!query[1])
         return std::numeric_limits<double>::quiet_NaN();
-    }
+
+    auto validBits = _pImp->props.validBits;
+    auto timestamp = validBits < 64 ?
+        query[0] & ((uint64_t(1) << validBits) - 1) : query[0];
+    auto offset = vulkan::getClockCalibration(context).offset;
+    return timestamp * static_cast<double>(_pImp->props.period) + offset;
 }
 
 StopWatch::StopWatch(StopWatch&& other) noexcept = default;
@@ -151,4 +218,414 @@ StopWatch::StopWatch(ContextHandle context)
 {}
 StopWatch::~StopWatch() = default;
 
+/***************************** PIPELINE STATISTICS ****************************/
+
+bool isPipelineStatisticsSupported(const ContextHandle& context) {
+    return context->pipelineStatistics;
+}
+
+struct PipelineStatistics::pImp {
+    const vulkan::Context& context;
+
+    VkQueryPool timestampPool;
+    VkQueryPool statisticsPool;
+    vulkan::TimestampProperties props;
+
+    StatisticsCommand startCommand;
+    StatisticsCommand endCommand;
+
+    pImp(const vulkan::Context& context)
+        : context(context)
+        , timestampPool(nullptr)
+        , statisticsPool(nullptr)
+        , props(vulkan::getTimestampProperties(context))
+        , startCommand(context, true)
+        , endCommand(context, false)
+    {
+        //create query pools
+        VkQueryPoolCreateInfo timestampInfo{
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = 2
+        };
+        vulkan::checkResult(context.fnTable.vkCreateQueryPool(
+            context.device, &timestampInfo, nullptr, &timestampPool));
+        VkQueryPoolCreateInfo statisticsInfo{
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS,
+            .queryCount = 1,
+            .pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT
+        };
+        auto result = context.fnTable.vkCreateQueryPool(
+            context.device, &statisticsInfo, nullptr, &statisticsPool);
+        if (result != VK_SUCCESS) {
+            context.fnTable.vkDestroyQueryPool(
+                context.device, timestampPool, nullptr);
+            vulkan::checkResult(result);
+        }
+
+        //before use we have to reset them once
+        reset();
+
+        //register query pools in commands
+        startCommand.timestampPool = timestampPool;
+        startCommand.statisticsPool = statisticsPool;
+        endCommand.timestampPool = timestampPool;
+        endCommand.statisticsPool = statisticsPool;
+    }
+    void reset() {
+        context.fnTable.vkResetQueryPool(context.device, timestampPool, 0, 2);
+        context.fnTable.vkResetQueryPool(context.device, statisticsPool, 0, 1);
+    }
+    ~pImp() {
+        context.fnTable.vkDestroyQueryPool(
+            context.device, statisticsPool, nullptr);
+        context.fnTable.vkDestroyQueryPool(
+            context.device, timestampPool, nullptr);
+    }
+};
+
+const Command& PipelineStatistics::start() {
+    return _pImp->startCommand;
+}
+const Command& PipelineStatistics::stop() {
+    return _pImp->endCommand;
+}
+
+void PipelineStatistics::reset() {
+    _pImp->reset();
+}
+
+PipelineStatisticsResult PipelineStatistics::getResult(bool wait) const {
+    VkQueryResultFlags flags =
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT;
+    if (wait)
+        flags |= VK_QUERY_RESULT_WAIT_BIT;
+
+    //only a single statistic is queried
+    std::array<uint64_t, 2> query;
+    auto result = _pImp->context.fnTable.vkGetQueryPoolResults(
+        _pImp->context.device,
+        _pImp->statisticsPool,
+        0, 1,
+        sizeof(query),
+        query.data(),
+        sizeof(query),
+        flags);
+    if (result < 0)
+        vulkan::checkResult(result); //will throw
+
+    auto elapsed = readElapsedTime(
+        _pImp->context, _pImp->timestampPool, _pImp->props, wait);
+    if (!query[1])
+        return { 0, std::numeric_limits<double>::quiet_NaN() };
+    return { query[0], elapsed };
+}
+
+PipelineStatistics::PipelineStatistics(PipelineStatistics&& other) noexcept = default;
+PipelineStatistics& PipelineStatistics::operator=(PipelineStatistics&& other) noexcept = default;
+
+PipelineStatistics::PipelineStatistics(ContextHandle context)
+    : Resource(std::move(context))
+    , _pImp()
+{
+    if (!isPipelineStatisticsSupported(getContext()))
+        throw std::runtime_error("Pipeline statistics are not supported by the device!");
+    _pImp = std::make_unique<pImp>(*getContext());
+}
+PipelineStatistics::~PipelineStatistics() = default;
+
+/********************************** PROFILER **********************************/
+
+namespace {
+
+//queries per pool; scopes use pairs, so they never straddle two pools
+constexpr uint32_t ProfilerPoolSize = 256;
+//amount of most recent measurements per scope used for aggregation
+constexpr size_t ProfilerSampleWindow = 1024;
+
+struct ProfilerScope {
+    std::string name;
+    uint32_t depth;
+    uint32_t query;
+    bool closed;
+    bool collected;
+};
+
+struct ProfilerFrame {
+    uint64_t number = 0;
+    std::vector<VkQueryPool> pools;
+    std::vector<ProfilerScope> scopes;
+    std::vector<ProfilerSample> samples;
+};
+
+struct ProfilerAggregate {
+    uint32_t depth;
+    uint64_t count;
+    std::deque<double> window;
+};
+
+}
+
+struct Profiler::pImp {
+    const vulkan::Context& context;
+    vulkan::TimestampProperties props;
+
+    std::mutex mutex;
+    uint64_t frame;
+    std::vector<ProfilerFrame> frames;
+    std::vector<size_t> stack;
+    std::map<std::string, ProfilerAggregate> statistics;
+
+    ProfilerFrame& current() {
+        return frames[frame % frames.size()];
+    }
+
+    uint32_t allocate(ProfilerFrame& f) {
+        auto query = static_cast<uint32_t>(f.scopes.size() * 2);
+        if (query >= f.pools.size() * ProfilerPoolSize) {
+            VkQueryPoolCreateInfo info{
+                .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                .queryType = VK_QUERY_TYPE_TIMESTAMP,
+                .queryCount = ProfilerPoolSize
+            };
+            VkQueryPool pool;
+            vulkan::checkResult(context.fnTable.vkCreateQueryPool(
+                context.device, &info, nullptr, &pool));
+            context.fnTable.vkResetQueryPool(
+                context.device, pool, 0, ProfilerPoolSize);
+            f.pools.push_back(pool);
+        }
+        return query;
+    }
+
+    void collect(ProfilerFrame& f) {
+        if (std::all_of(f.scopes.begin(), f.scopes.end(),
+            [](const ProfilerScope& s) { return s.collected || !s.closed; }))
+        {
+            return;
+        }
+
+        //read all used queries at once; unavailable ones are simply skipped
+        struct Result {
+            uint64_t timestamp;
+            uint64_t valid;
+        };
+        std::vector<Result> results(f.scopes.size() * 2);
+        for (size_t i = 0; i < f.pools.size(); ++i) {
+            auto first = static_cast<uint32_t>(i * ProfilerPoolSize);
+            auto count = std::min<uint32_t>(
+                ProfilerPoolSize, static_cast<uint32_t>(results.size()) - first);
+            auto result = context.fnTable.vkGetQueryPoolResults(
+                context.device,
+                f.pools[i],
+                0, count,
+                count * sizeof(Result),
+                results.data() + first,
+                sizeof(Result),
+                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+            if (result < 0)
+                vulkan::checkResult(result); //will throw
+        }
+
+        auto mask = props.validBits >= 64 ?
+            ~uint64_t(0) : (uint64_t(1) << props.validBits) - 1;
+        for (auto& scope : f.scopes) {
+            if (scope.collected || !scope.closed)
+                continue;
+            auto& start = results[scope.query];
+            auto& end = results[scope.query + 1];
+            if (!start.valid || !end.valid)
+                continue;
+
+            auto duration = ((end.timestamp - start.timestamp) & mask)
+                * static_cast<double>(props.period);
+            f.samples.push_back({
+                .name = scope.name,
+                .depth = scope.depth,
+                .frame = f.number,
+                .start = (start.timestamp & mask) * static_cast<double>(props.period),
+                .duration = duration
+            });
+            scope.collected = true;
+
+            auto& aggregate = statistics.try_emplace(
+                scope.name, ProfilerAggregate{ scope.depth, 0, {} }).first->second;
+            aggregate.count++;
+            aggregate.window.push_back(duration);
+            if (aggregate.window.size() > ProfilerSampleWindow)
+                aggregate.window.pop_front();
+        }
+    }
+
+    void collect() {
+        for (auto& f : frames)
+            collect(f);
+    }
+
+    pImp(const vulkan::Context& context, uint32_t frameCount)
+        : context(context)
+        , props(vulkan::getTimestampProperties(context))
+        , frame(0)
+        , frames(frameCount)
+    {}
+    ~pImp() {
+        for (auto& f : frames) {
+            for (auto pool : f.pools)
+                context.fnTable.vkDestroyQueryPool(context.device, pool, nullptr);
+        }
+    }
+};
+
+void ProfilerScopeCommand::record(vulkan::Command& cmd) const {
+    auto& imp = *profiler.get()._pImp;
+    auto& context = imp.context;
+    std::lock_guard lock(imp.mutex);
+    auto& f = imp.current();
+
+    if (!name.empty()) {
+        auto query = imp.allocate(f);
+        auto path = imp.stack.empty() ? name :
+            f.scopes[imp.stack.back()].name + '/' + name;
+        f.scopes.push_back({
+            .name = std::move(path),
+            .depth = static_cast<uint32_t>(imp.stack.size()),
+            .query = query,
+            .closed = false,
+            .collected = false
+        });
+        imp.stack.push_back(f.scopes.size() - 1);
+
+        //reset inside the command buffer so recordings can be submitted again
+        auto pool = f.pools[query / ProfilerPoolSize];
+        cmd.stage |= VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        context.fnTable.vkCmdResetQueryPool(cmd.buffer,
+            pool, query % ProfilerPoolSize, 2);
+        context.fnTable.vkCmdWriteTimestamp(cmd.buffer,
+            VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pool, query % ProfilerPoolSize);
+    }
+    else {
+        if (imp.stack.empty())
+            throw std::logic_error("There is no open profiler scope to end!");
+        auto& scope = f.scopes[imp.stack.back()];
+        imp.stack.pop_back();
+        scope.closed = true;
+
+        auto query = scope.query + 1;
+        cmd.stage |= VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        context.fnTable.vkCmdWriteTimestamp(cmd.buffer,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            f.pools[query / ProfilerPoolSize], query % ProfilerPoolSize);
+    }
+}
+
+ProfilerScopeCommand::ProfilerScopeCommand(const ProfilerScopeCommand&) = default;
+ProfilerScopeCommand& ProfilerScopeCommand::operator=(const ProfilerScopeCommand&) = default;
+
+ProfilerScopeCommand::ProfilerScopeCommand(Profiler& profiler, std::string name)
+    : Command()
+    , profiler(profiler)
+    , name(std::move(name))
+{}
+ProfilerScopeCommand::~ProfilerScopeCommand() = default;
+
+ProfilerScopeCommand Profiler::beginScope(std::string_view name) {
+    if (name.empty() || name.find('/') != std::string_view::npos)
+        throw std::logic_error("Scope names must not be empty or contain '/'!");
+    return ProfilerScopeCommand(*this, std::string(name));
+}
+ProfilerScopeCommand Profiler::endScope() {
+    return ProfilerScopeCommand(*this, {});
+}
+
+uint64_t Profiler::getCurrentFrame() const noexcept {
+    return _pImp->frame;
+}
+uint32_t Profiler::getFrameCount() const noexcept {
+    return static_cast<uint32_t>(_pImp->frames.size());
+}
+
+uint64_t Profiler::nextFrame() {
+    std::lock_guard lock(_pImp->mutex);
+    if (!_pImp->stack.empty())
+        throw std::logic_error("Cannot advance the frame while scopes are still open!");
+    _pImp->collect();
+
+    //recycle the oldest frame; results not available by now are discarded
+    auto& f = _pImp->frames[++_pImp->frame % _pImp->frames.size()];
+    for (auto pool : f.pools) {
+        _pImp->context.fnTable.vkResetQueryPool(
+            _pImp->context.device, pool, 0, ProfilerPoolSize);
+    }
+    f.number = _pImp->frame;
+    f.scopes.clear();
+    f.samples.clear();
+
+    return _pImp->frame;
+}
+
+void Profiler::collect() {
+    std::lock_guard lock(_pImp->mutex);
+    _pImp->collect();
+}
+
+std::vector<ProfilerSample> Profiler::getSamples() {
+    std::lock_guard lock(_pImp->mutex);
+    _pImp->collect();
+
+    std::vector<ProfilerSample> samples;
+    auto count = _pImp->frames.size();
+    auto oldest = _pImp->frame + 1 >= count ? _pImp->frame + 1 - count : 0;
+    for (auto i = oldest; i <= _pImp->frame; ++i) {
+        auto& f = _pImp->frames[i % count];
+        auto first = samples.insert(samples.end(), f.samples.begin(), f.samples.end());
+        std::stable_sort(first, samples.end(),
+            [](const ProfilerSample& a, const ProfilerSample& b) { return a.start < b.start; });
+    }
+    return samples;
+}
+
+std::vector<ProfilerScopeStatistics> Profiler::getStatistics() {
+    std::lock_guard lock(_pImp->mutex);
+    _pImp->collect();
+
+    std::vector<ProfilerScopeStatistics> result;
+    result.reserve(_pImp->statistics.size());
+    for (auto& [name, aggregate] : _pImp->statistics) {
+        std::vector<double> sorted(aggregate.window.begin(), aggregate.window.end());
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (auto d : sorted)
+            sum += d;
+        auto p99 = static_cast<size_t>(std::ceil(0.99 * sorted.size()));
+        result.push_back({
+            .name = name,
+            .depth = aggregate.depth,
+            .count = aggregate.count,
+            .min = sorted.front(),
+            .mean = sum / sorted.size(),
+            .p99 = sorted[p99 > 0 ? p99 - 1 : 0]
+        });
+    }
+    return result;
+}
+
+void Profiler::resetStatistics() {
+    std::lock_guard lock(_pImp->mutex);
+    _pImp->statistics.clear();
+}
+
+Profiler::Profiler(Profiler&& other) noexcept = default;
+Profiler& Profiler::operator=(Profiler&& other) noexcept = default;
+
+Profiler::Profiler(ContextHandle context, uint32_t frameCount)
+    : Resource(std::move(context))
+    , _pImp()
+{
+    if (frameCount == 0)
+        throw std::logic_error("A profiler needs at least one frame!");
+    _pImp = std::make_unique<pImp>(*getContext(), frameCount);
+}
+Profiler::~Profiler() = default;
+
 }
@@ -0,0 +1,422 @@
+#include "hephaistos/stream.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+#include "hephaistos/context.hpp"
+
+namespace hephaistos {
+
+namespace {
+
+struct Slot {
+    //staging memory on the host
+    Buffer<std::byte> stagingInput;
+    Buffer<std::byte> stagingOutput;
+    Buffer<uint32_t> stagingCount;
+    //memory on the device
+    Tensor<std::byte> input;
+    Tensor<std::byte> output;
+    Tensor<uint32_t> count;
+    //each slot runs on its own timeline, so chunks in different slots
+    //may overlap
+    Timeline timeline;
+
+    Slot(const ContextHandle& context, uint64_t inputSize, uint64_t outputSize)
+        : stagingInput(context, inputSize)
+        , stagingOutput(context, outputSize)
+        , stagingCount(context, 1)
+        , input(context, inputSize)
+        , output(context, outputSize)
+        , count(context, 1)
+        , timeline(context)
+    {}
+};
+
+
+//ring of staging buffers each released once the timeline passes its last use
+struct StagingRing {
+    std::vector<Buffer<std::byte>> buffers;
+    std::vector<uint64_t> release;
+    uint64_t bufferSize;
+    QueueType queue;
+    Timeline timeline;
+    //value the last transfer signals; transfers are chained in order
+    uint64_t lastValue = 0;
+
+    Buffer<std::byte>& get(uint64_t n) {
+        return buffers[n % buffers.size()];
+    }
+    void waitFree(uint64_t n) {
+        timeline.waitValue(release[n % buffers.size()]);
+    }
+    template<class T>
+    Submission submit(uint64_t n, const T& command) {
+        auto submission = beginSequence(timeline, lastValue)
+            .OnQueue(queue)
+            .And(command)
+            .Submit();
+        lastValue = submission.getFinalStep();
+        release[n % buffers.size()] = lastValue;
+        return submission;
+    }
+    void wait() const {
+        timeline.waitValue(lastValue);
+    }
+
+    StagingRing(const ContextHandle& context, uint64_t size, uint32_t count, QueueType queue)
+        : buffers()
+        , release(count, 0)
+        , bufferSize(size)
+        , queue(queue)
+        , timeline(context)
+    {
+        if (size == 0 || count == 0)
+            throw std::logic_error("Staging buffers must not be empty!");
+        buffers.reserve(count);
+        for (auto i = 0u; i < count; ++i)
+            buffers.emplace_back(context, size);
+    }
+};
+
+//resolves the amount of bytes to copy between a staging buffer and a tensor
+uint64_t clampCopySize(uint64_t size, uint64_t bufferSize, uint64_t tensorSize, uint64_t offset) {
+    if (offset > tensorSize)
+        throw std::out_of_range("Offset exceeds the size of the tensor!");
+    if (size == whole_size)
+        return std::min(bufferSize, tensorSize - offset);
+    if (size > bufferSize || size > tensorSize - offset)
+        throw std::out_of_range("Copy exceeds the staging buffer or tensor!");
+    return size;
+}
+
+}
+
+struct StreamExecutor::pImp {
+    uint64_t chunkSize;
+    uint64_t inputItemSize;
+    uint64_t outputItemSize;
+    bool useTransferQueue;
+
+    std::vector<std::unique_ptr<Slot>> slots;
+};
+
+uint64_t StreamExecutor::getChunkSize() const noexcept {
+    return _pImp->chunkSize;
+}
+uint32_t StreamExecutor::getSlotCount() const noexcept {
+    return static_cast<uint32_t>(_pImp->slots.size());
+}
+uint64_t StreamExecutor::getInputItemSize() const noexcept {
+    return _pImp->inputItemSize;
+}
+uint64_t StreamExecutor::getOutputItemSize() const noexcept {
+    return _pImp->outputItemSize;
+}
+
+StreamSlot StreamExecutor::getSlot(uint32_t slot) const {
+    if (slot >= _pImp->slots.size())
+        throw std::out_of_range("Slot index out of range!");
+    auto& s = *_pImp->slots[slot];
+    return { s.input, s.output, s.count };
+}
+
+uint64_t StreamExecutor::run(
+    const std::vector<std::reference_wrapper<const Subroutine>>& compute,
+    const ChunkSource& source,
+    const ChunkSink& sink)
+{
+    auto& slots = _pImp->slots;
+    uint64_t slotCount = slots.size();
+    if (compute.size() != slotCount)
+        throw std::logic_error("Expected one compute subroutine per slot!");
+    if (!source || !sink)
+        throw std::logic_error("StreamExecutor requires a source and a sink!");
+
+    //record each slot once: upload -> compute -> download
+    auto transferQueue = _pImp->useTransferQueue ? QueueType::TRANSFER : QueueType::MAIN;
+    std::vector<SequenceTemplate> templates;
+    templates.reserve(slotCount);
+    for (auto i = 0u; i < slotCount; ++i) {
+        auto& slot = *slots[i];
+        templates.push_back(beginSequenceTemplate(slot.timeline, slot.timeline.getValue())
+            .OnQueue(transferQueue)
+            .And(updateTensor(slot.stagingInput, slot.input))
+            .And(updateTensor(slot.stagingCount, slot.count))
+            .OnQueue(QueueType::MAIN)
+            .And(compute[i].get())
+            .OnQueue(transferQueue)
+            .And(retrieveTensor(slot.output, slot.stagingOutput))
+            .Freeze());
+    }
+
+    //chunks in flight per slot
+    std::vector<std::optional<Submission>> pending(slotCount);
+    std::vector<uint64_t> counts(slotCount);
+    auto finish = [&](uint64_t chunk) {
+        auto i = chunk % slotCount;
+        pending[i]->wait();
+        pending[i].reset();
+        auto mem = slots[i]->stagingOutput.getMemory();
+        sink(mem.subspan(0, counts[i] * _pImp->outputItemSize), chunk);
+    };
+
+    uint64_t chunk = 0;
+    try {
+        for (;; ++chunk) {
+            auto i = chunk % slotCount;
+            auto& slot = *slots[i];
+            //consume the chunk previously using this slot
+            if (pending[i])
+                finish(chunk - slotCount);
+
+            auto count = source(slot.stagingInput.getMemory(), chunk);
+            if (count == 0)
+                break;
+            if (count > _pImp->chunkSize)
+                throw std::out_of_range("Source returned more items than fit into a chunk!");
+            counts[i] = count;
+            slot.stagingCount.getMemory()[0] = static_cast<uint32_t>(count);
+            pending[i] = templates[i].Submit();
+        }
+        //drain the remaining chunks in order
+        for (auto c = chunk - std::min(chunk, slotCount - 1); c < chunk; ++c)
+            finish(c);
+    }
+    catch (...) {
+        //templates must outlive their submissions
+        for (auto& s : pending) {
+            if (s) s->wait();
+        }
+        throw;
+    }
+
+    return chunk;
+}
+
+StreamExecutor::StreamExecutor(StreamExecutor&& other) noexcept = default;
+StreamExecutor& StreamExecutor::operator=(StreamExecutor&& other) noexcept = default;
+
+StreamExecutor::StreamExecutor(
+    ContextHandle context,
+    uint64_t inputItemSize,
+    uint64_t outputItemSize,
+    const StreamOptions& options)
+    : _pImp(std::make_unique<pImp>())
+{
+    if (inputItemSize == 0 || outputItemSize == 0)
+        throw std::logic_error("Item sizes must not be zero!");
+    if (options.slots == 0)
+        throw std::logic_error("StreamExecutor requires at least one slot!");
+
+    auto chunkSize = options.chunkSize;
+    if (chunkSize == 0) {
+        chunkSize = getStreamChunkSize(context,
+            inputItemSize + outputItemSize, options.slots, options.memoryFraction);
+    }
+    //counts are stored as uint32 and each tensor must fit into a single
+    //allocation as well as binding
+    auto limits = getDeviceLimits(context);
+    auto maxTensorSize = std::min(
+        limits.maxMemoryAllocationSize, uint64_t(limits.maxStorageBufferRange));
+    chunkSize = std::min({
+        chunkSize,
+        uint64_t(std::numeric_limits<uint32_t>::max()),
+        std::max(maxTensorSize / std::max(inputItemSize, outputItemSize), uint64_t(1))
+    });
+
+    _pImp->chunkSize = chunkSize;
+    _pImp->inputItemSize = inputItemSize;
+    _pImp->outputItemSize = outputItemSize;
+    _pImp->useTransferQueue = options.useTransferQueue;
+    for (auto i = 0u; i < options.slots; ++i) {
+        _pImp->slots.push_back(std::make_unique<Slot>(
+            context, chunkSize * inputItemSize, chunkSize * outputItemSize));
+    }
+}
+
+StreamExecutor::~StreamExecutor() = default;
+
+struct StreamingUploader::pImp {
+    StagingRing ring;
+    //amount of uploads issued so far
+    uint64_t count = 0;
+
+    pImp(const ContextHandle& context, uint64_t size, uint32_t bufferCount, QueueType queue)
+        : ring(context, size, bufferCount, queue)
+    {}
+};
+
+uint64_t StreamingUploader::getBufferSize() const noexcept {
+    return _pImp->ring.bufferSize;
+}
+uint32_t StreamingUploader::getBufferCount() const noexcept {
+    return static_cast<uint32_t>(_pImp->ring.buffers.size());
+}
+const Timeline& StreamingUploader::getTimeline() const noexcept {
+    return _pImp->ring.timeline;
+}
+
+std::span<std::byte> StreamingUploader::next() {
+    _pImp->ring.waitFree(_pImp->count);
+    return _pImp->ring.get(_pImp->count).getMemory();
+}
+
+Submission StreamingUploader::upload(
+    const Tensor<std::byte>& dst, uint64_t dstOffset, uint64_t size)
+{
+    auto& ring = _pImp->ring;
+    auto n = _pImp->count;
+    size = clampCopySize(size, ring.bufferSize, dst.size_bytes(), dstOffset);
+    //in case next() was skipped
+    ring.waitFree(n);
+    auto submission = ring.submit(n, updateTensor(ring.get(n), dst,
+        { .bufferOffset = 0, .tensorOffset = dstOffset, .size = size }));
+    ++_pImp->count;
+    return submission;
+}
+
+void StreamingUploader::upload(
+    std::span<const std::byte> data, const Tensor<std::byte>& dst, uint64_t dstOffset)
+{
+    if (dstOffset > dst.size_bytes() || data.size() > dst.size_bytes() - dstOffset)
+        throw std::out_of_range("Data exceeds the size of the tensor!");
+    auto bufferSize = _pImp->ring.bufferSize;
+    for (uint64_t offset = 0; offset < data.size(); offset += bufferSize) {
+        auto size = std::min<uint64_t>(bufferSize, data.size() - offset);
+        auto mem = next();
+        std::memcpy(mem.data(), data.data() + offset, size);
+        upload(dst, dstOffset + offset, size);
+    }
+}
+
+void StreamingUploader::wait() const {
+    _pImp->ring.wait();
+}
+
+StreamingUploader::StreamingUploader(StreamingUploader&& other) noexcept = default;
+StreamingUploader& StreamingUploader::operator=(StreamingUploader&& other) noexcept = default;
+
+StreamingUploader::StreamingUploader(
+    ContextHandle context,
+    uint64_t bufferSize,
+    uint32_t bufferCount,
+    QueueType queue)
+    : _pImp(std::make_unique<pImp>(context, bufferSize, bufferCount, queue))
+{}
+StreamingUploader::~StreamingUploader() {
+    //staging buffers must outlive the uploads
+    if (_pImp) _pImp->ring.wait();
+}
+
+struct StreamingDownloader::pImp {
+    StagingRing ring;
+    //amount of downloads issued and fetched so far
+    uint64_t count = 0;
+    uint64_t fetched = 0;
+    std::vector<uint64_t> sizes;
+
+    pImp(const ContextHandle& context, uint64_t size, uint32_t bufferCount, QueueType queue)
+        : ring(context, size, bufferCount, queue)
+        , sizes(bufferCount, 0)
+    {}
+};
+
+uint64_t StreamingDownloader::getBufferSize() const noexcept {
+    return _pImp->ring.bufferSize;
+}
+uint32_t StreamingDownloader::getBufferCount() const noexcept {
+    return static_cast<uint32_t>(_pImp->ring.buffers.size());
+}
+const Timeline& StreamingDownloader::getTimeline() const noexcept {
+    return _pImp->ring.timeline;
+}
+uint32_t StreamingDownloader::getPendingCount() const noexcept {
+    return static_cast<uint32_t>(_pImp->count - _pImp->fetched);
+}
+
+Submission StreamingDownloader::download(
+    const Tensor<std::byte>& src, uint64_t srcOffset, uint64_t size)
+{
+    auto& ring = _pImp->ring;
+    if (getPendingCount() >= ring.buffers.size())
+        throw std::logic_error("All staging buffers hold downloads not yet fetched!");
+    auto n = _pImp->count;
+    size = clampCopySize(size, ring.bufferSize, src.size_bytes(), srcOffset);
+    auto submission = ring.submit(n, retrieveTensor(src, ring.get(n),
+        { .bufferOffset = 0, .tensorOffset = srcOffset, .size = size }));
+    _pImp->sizes[n % ring.buffers.size()] = size;
+    ++_pImp->count;
+    return submission;
+}
+
+std::span<const std::byte> StreamingDownloader::fetch() {
+    if (getPendingCount() == 0)
+        throw std::logic_error("There are no pending downloads!");
+    auto& ring = _pImp->ring;
+    auto n = _pImp->fetched++;
+    ring.waitFree(n);
+    return ring.get(n).getMemory().subspan(0, _pImp->sizes[n % ring.buffers.size()]);
+}
+
+void StreamingDownloader::download(
+    const Tensor<std::byte>& src, std::span<std::byte> data, uint64_t srcOffset)
+{
+    if (getPendingCount() > 0)
+        throw std::logic_error("Downloading into memory requires no pending downloads!");
+    if (srcOffset > src.size_bytes() || data.size() > src.size_bytes() - srcOffset)
+        throw std::out_of_range("Data exceeds the size of the tensor!");
+
+    //keep all buffers in flight while copying out finished ones
+    auto bufferSize = _pImp->ring.bufferSize;
+    uint64_t issued = 0, copied = 0;
+    while (copied < data.size()) {
+        while (issued < data.size() && getPendingCount() < getBufferCount()) {
+            auto size = std::min<uint64_t>(bufferSize, data.size() - issued);
+            download(src, srcOffset + issued, size);
+            issued += size;
+        }
+        auto chunk = fetch();
+        std::memcpy(data.data() + copied, chunk.data(), chunk.size());
+        copied += chunk.size();
+    }
+}
+
+StreamingDownloader::StreamingDownloader(StreamingDownloader&& other) noexcept = default;
+StreamingDownloader& StreamingDownloader::operator=(StreamingDownloader&& other) noexcept = default;
+
+StreamingDownloader::StreamingDownloader(
+    ContextHandle context,
+    uint64_t bufferSize,
+    uint32_t bufferCount,
+    QueueType queue)
+    : _pImp(std::make_unique<pImp>(context, bufferSize, bufferCount, queue))
+{}
+StreamingDownloader::~StreamingDownloader() {
+    //staging buffers must outlive the downloads
+    if (_pImp) _pImp->ring.wait();
+}
+
+uint64_t getStreamChunkSize(
+    const ContextHandle& context,
+    uint64_t bytesPerItem,
+    uint32_t slots,
+    float memoryFraction)
+{
+    if (bytesPerItem == 0 || slots == 0)
+        throw std::logic_error("Bytes per item and slots must not be zero!");
+
+    //use the device local heap with the most memory left
+    uint64_t available = 0;
+    for (auto& heap : getMemoryStatistics(context).heaps) {
+        if (heap.deviceLocal && heap.budget > heap.usage)
+            available = std::max(available, heap.budget - heap.usage);
+    }
+    auto usable = static_cast<uint64_t>(static_cast<double>(available) * memoryFraction);
+    return std::max(usable / (bytesPerItem * slots), uint64_t(1));
+}
+
+}
@@ -0,0 +1,281 @@
+#include "hephaistos/trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include "vk/types.hpp"
+#include "vk/util.hpp"
+
+namespace hephaistos {
+
+namespace {
+
+void writeJsonString(std::ostream& out, const std::string& str) {
+    out << '"';
+    for (auto c : str) {
+        switch (c) {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\t': out << "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                std::array<char, 8> buf;
+                std::snprintf(buf.data(), buf.size(), "\\u%04x", c);
+                out << buf.data();
+            }
+            else {
+                out << c;
+            }
+        }
+    }
+    out << '"';
+}
+
+std::string getTrackName(uint32_t thread) {
+    if (thread == 0)
+        return "Device";
+    return "Host Thread " + std::to_string(thread);
+}
+
+/********************************** PROTOBUF **********************************/
+
+//minimal writer for the few messages of the Perfetto trace format
+class ProtoWriter {
+public:
+    void varint(uint32_t field, uint64_t value) {
+        tag(field, 0);
+        raw(value);
+    }
+    void string(uint32_t field, const std::string& value) {
+        tag(field, 2);
+        raw(value.size());
+        auto p = reinterpret_cast<const std::byte*>(value.data());
+        data.insert(data.end(), p, p + value.size());
+    }
+    void message(uint32_t field, const ProtoWriter& value) {
+        tag(field, 2);
+        raw(value.data.size());
+        data.insert(data.end(), value.data.begin(), value.data.end());
+    }
+
+    std::vector<std::byte> data;
+
+private:
+    void tag(uint32_t field, uint32_t wireType) {
+        raw((static_cast<uint64_t>(field) << 3) | wireType);
+    }
+    void raw(uint64_t value) {
+        do {
+            auto byte = static_cast<uint8_t>(value & 0x7F);
+            value >>= 7;
+            if (value)
+                byte |= 0x80;
+            data.push_back(static_cast<std::byte>(byte));
+        } while (value);
+    }
+};
+
+//field numbers from perfetto/trace/trace_packet.proto and friends
+constexpr uint32_t TracePacketField = 1;
+constexpr uint32_t PacketTimestamp = 8;
+constexpr uint32_t PacketSequenceId = 10;
+constexpr uint32_t PacketTrackEvent = 11;
+constexpr uint32_t PacketTimestampClock = 58;
+constexpr uint32_t PacketTrackDescriptor = 60;
+constexpr uint32_t DescriptorUuid = 1;
+constexpr uint32_t DescriptorName = 2;
+constexpr uint32_t EventType = 9;
+constexpr uint32_t EventTrackUuid = 11;
+constexpr uint32_t EventCategories = 22;
+constexpr uint32_t EventName = 23;
+
+constexpr uint64_t SliceBegin = 1;
+constexpr uint64_t SliceEnd = 2;
+constexpr uint64_t Instant = 3;
+//BuiltinClock::MONOTONIC, i.e. the steady clock
+constexpr uint64_t MonotonicClock = 3;
+constexpr uint64_t SequenceId = 1;
+//avoid uuid zero, which marks the default track
+constexpr uint64_t TrackUuidBase = 0x6865706800000000ull;
+
+}
+
+void beginTrace(const ContextHandle& context) {
+    //calibrate before tracing, so a fallback submission does not show up
+    auto offset = vulkan::getClockCalibration(*context, true).offset;
+
+    std::lock_guard<std::mutex> lock(context->traceMutex);
+    context->traceLog = std::make_unique<vulkan::TraceLog>(vulkan::TraceLog{
+        .records = {},
+        .threads = {},
+        .start = vulkan::getTraceClock(),
+        .deviceOffset = offset
+    });
+    context->tracing = true;
+}
+
+Trace endTrace(const ContextHandle& context) {
+    std::unique_ptr<vulkan::TraceLog> log;
+    {
+        std::lock_guard<std::mutex> lock(context->traceMutex);
+        context->tracing = false;
+        log = std::move(context->traceLog);
+    }
+    if (!log)
+        throw std::logic_error("Tracing has not been started on this context!");
+
+    Trace trace{
+        .events = {},
+        .startTime = static_cast<double>(log->start),
+        .deviceOffset = log->deviceOffset
+    };
+    trace.events.reserve(log->records.size());
+    for (auto& record : log->records) {
+        trace.events.push_back({
+            .name = record.name,
+            .category = record.category,
+            .thread = record.thread,
+            .start = static_cast<double>(record.start),
+            .duration = static_cast<double>(record.duration)
+        });
+    }
+    return trace;
+}
+
+bool isTracing(const ContextHandle& context) {
+    return context->tracing;
+}
+
+void addProfilerSamples(Trace& trace, std::span<const ProfilerSample> samples) {
+    trace.events.reserve(trace.events.size() + samples.size());
+    for (auto& sample : samples) {
+        trace.events.push_back({
+            .name = sample.name,
+            .category = "device",
+            .thread = 0,
+            .start = sample.start + trace.deviceOffset,
+            .duration = sample.duration
+        });
+    }
+}
+
+std::string writeChromeTrace(const Trace& trace) {
+    std::ostringstream out;
+    out.precision(3);
+    out << std::fixed;
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    //name the tracks
+    std::set<uint32_t> threads;
+    for (auto& event : trace.events)
+        threads.insert(event.thread);
+    bool first = true;
+    for (auto thread : threads) {
+        if (!first)
+            out << ',';
+        first = false;
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+            << ",\"args\":{\"name\":";
+        writeJsonString(out, getTrackName(thread));
+        out << "}}";
+    }
+
+    //timestamps are given in microseconds relative to the trace's start
+    for (auto& event : trace.events) {
+        if (!first)
+            out << ',';
+        first = false;
+        out << "{\"name\":";
+        writeJsonString(out, event.name);
+        out << ",\"cat\":";
+        writeJsonString(out, event.category);
+        out << ",\"pid\":1,\"tid\":" << event.thread
+            << ",\"ts\":" << (event.start - trace.startTime) * 1e-3;
+        if (event.duration > 0.0)
+            out << ",\"ph\":\"X\",\"dur\":" << event.duration * 1e-3 << '}';
+        else
+            out << ",\"ph\":\"i\",\"s\":\"t\"}";
+    }
+
+    out << "]}";
+    return out.str();
+}
+
+std::vector<std::byte> writePerfettoTrace(const Trace& trace) {
+    ProtoWriter result;
+
+    //describe the tracks
+    std::set<uint32_t> threads;
+    for (auto& event : trace.events)
+        threads.insert(event.thread);
+    for (auto thread : threads) {
+        ProtoWriter descriptor;
+        descriptor.varint(DescriptorUuid, TrackUuidBase + thread);
+        descriptor.string(DescriptorName, getTrackName(thread));
+        ProtoWriter packet;
+        packet.message(PacketTrackDescriptor, descriptor);
+        packet.varint(PacketSequenceId, SequenceId);
+        result.message(TracePacketField, packet);
+    }
+
+    //slices on a track must nest, so emit begin and end in timestamp order
+    struct Mark {
+        uint64_t time;
+        uint64_t type;
+        size_t event;
+    };
+    std::vector<Mark> marks;
+    marks.reserve(trace.events.size() * 2);
+    for (auto i = 0u; i < trace.events.size(); ++i) {
+        auto& event = trace.events[i];
+        auto start = static_cast<uint64_t>(std::max(event.start, 0.0));
+        if (event.duration > 0.0) {
+            auto end = static_cast<uint64_t>(std::max(event.start + event.duration, 0.0));
+            marks.push_back({ start, SliceBegin, i });
+            marks.push_back({ end, SliceEnd, i });
+        }
+        else {
+            marks.push_back({ start, Instant, i });
+        }
+    }
+    std::stable_sort(marks.begin(), marks.end(),
+        [&events = trace.events](const Mark& a, const Mark& b) {
+            if (a.time != b.time)
+                return a.time < b.time;
+            //close slices before opening new ones
+            if ((a.type == SliceEnd) != (b.type == SliceEnd))
+                return a.type == SliceEnd;
+            //open outer slices first and close them last
+            auto& ea = events[a.event];
+            auto& eb = events[b.event];
+            if (a.type == SliceEnd)
+                return ea.start > eb.start;
+            return ea.duration > eb.duration;
+        });
+
+    for (auto& mark : marks) {
+        auto& event = trace.events[mark.event];
+        ProtoWriter trackEvent;
+        trackEvent.varint(EventType, mark.type);
+        trackEvent.varint(EventTrackUuid, TrackUuidBase + event.thread);
+        if (mark.type != SliceEnd) {
+            trackEvent.string(EventCategories, event.category);
+            trackEvent.string(EventName, event.name);
+        }
+        ProtoWriter packet;
+        packet.varint(PacketTimestamp, mark.time);
+        packet.varint(PacketSequenceId, SequenceId);
+        packet.message(PacketTrackEvent, trackEvent);
+        packet.varint(PacketTimestampClock, MonotonicClock);
+        result.message(TracePacketField, packet);
+    }
+
+    return std::move(result.data);
+}
+
+}
@@ -0,0 +1,186 @@
+#include "hephaistos/tuning.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "volk.h"
+
+#include "hephaistos/command.hpp"
+#include "hephaistos/stopwatch.hpp"
+
+#include "vk/types.hpp"
+
+namespace hephaistos {
+
+namespace {
+
+//FNV-1a; only used to identify cache entries
+void hashBytes(uint64_t& hash, std::span<const std::byte> data) {
+    for (auto b : data) {
+        hash ^= static_cast<uint64_t>(b);
+        hash *= 0x100000001b3ull;
+    }
+}
+
+//identifies the device, driver, code and candidates of a tuning run
+std::string getCacheKey(
+    const vulkan::Context& context,
+    std::span<const uint32_t> code,
+    std::span<const std::vector<std::byte>> candidates)
+{
+    VkPhysicalDeviceIDProperties idProps{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES
+    };
+    VkPhysicalDeviceProperties2 props{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &idProps
+    };
+    vkGetPhysicalDeviceProperties2(context.physicalDevice, &props);
+
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hashBytes(hash, std::as_bytes(code));
+    for (auto& candidate : candidates) {
+        //include size to distinguish different splits of the same bytes
+        auto size = static_cast<uint64_t>(candidate.size());
+        hashBytes(hash, std::as_bytes(std::span<const uint64_t>{ &size, 1 }));
+        hashBytes(hash, candidate);
+    }
+
+    std::ostringstream stream;
+    stream << std::hex << std::setfill('0');
+    for (auto b : idProps.deviceUUID)
+        stream << std::setw(2) << static_cast<uint32_t>(b);
+    stream << '-' << std::setw(8) << props.properties.driverVersion;
+    stream << '-' << std::setw(16) << hash;
+    return stream.str();
+}
+
+//cache file contains one "key index" pair per line
+std::unordered_map<std::string, uint32_t> readCache(const std::filesystem::path& path) {
+    std::unordered_map<std::string, uint32_t> entries;
+    std::ifstream file(path);
+    std::string key;
+    uint32_t index;
+    while (file >> key >> index)
+        entries[key] = index;
+    return entries;
+}
+
+void writeCache(const std::filesystem::path& path, const std::string& key, uint32_t index) {
+    //keep entries of other programs and devices
+    auto entries = readCache(path);
+    entries[key] = index;
+
+    //write to temporary file first, so other processes never read partial data
+    auto tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::trunc);
+        for (auto& [k, i] : entries)
+            file << k << ' ' << i << '\n';
+        if (!file)
+            throw std::runtime_error("Failed to write tuning cache!");
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        throw std::runtime_error("Failed to write tuning cache!");
+    }
+}
+
+double benchmark(const ContextHandle& context, const DispatchCommand& dispatch,
+    StopWatch& watch, const TuningOptions& options)
+{
+    for (auto i = 0u; i < options.warmup; ++i)
+        execute(context, dispatch);
+
+    std::vector<double> times(options.repetitions);
+    for (auto& time : times) {
+        watch.reset();
+        beginSequence(context)
+            .And(watch.start())
+            .Then(dispatch)
+            .Then(watch.stop())
+            .Submit().wait();
+        time = watch.getElapsedTime(true);
+    }
+    //median is robust against the occasional hiccup
+    auto mid = times.begin() + times.size() / 2;
+    std::nth_element(times.begin(), mid, times.end());
+    return *mid;
+}
+
+}
+
+TuningResult tuneProgram(
+    const ContextHandle& context,
+    std::span<const uint32_t> code,
+    std::span<const std::vector<std::byte>> candidates,
+    const TuningDispatch& dispatch,
+    const TuningOptions& options)
+{
+    if (candidates.empty())
+        throw std::logic_error("There are no candidates to tune!");
+    if (options.repetitions == 0)
+        throw std::logic_error("At least one repetition is needed for tuning!");
+
+    //check for previous results
+    std::string key;
+    if (!options.cacheFile.empty()) {
+        key = getCacheKey(*context, code, candidates);
+        auto entries = readCache(options.cacheFile);
+        auto it = entries.find(key);
+        if (it != entries.end() && it->second < candidates.size()) {
+            return {
+                .index = it->second,
+                .specialization = candidates[it->second]
+            };
+        }
+    }
+
+    StopWatch watch(context);
+    std::vector<double> times(candidates.size(),
+        std::numeric_limits<double>::infinity());
+    std::exception_ptr error;
+    for (auto i = 0u; i < candidates.size(); ++i) {
+        //candidates might exceed device limits -> skip them
+        try {
+            Program program(context, code, candidates[i]);
+            auto cmd = dispatch(program, i);
+            times[i] = benchmark(context, cmd, watch, options);
+        }
+        catch (...) {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+
+    auto best = std::min_element(times.begin(), times.end());
+    if (std::isinf(*best)) {
+        //report why the first one failed
+        if (error)
+            std::rethrow_exception(error);
+        throw std::runtime_error("No candidate could be benchmarked!");
+    }
+    auto index = static_cast<uint32_t>(std::distance(times.begin(), best));
+
+    if (!options.cacheFile.empty())
+        writeCache(options.cacheFile, key, index);
+
+    return {
+        .index = index,
+        .specialization = candidates[index],
+        .times = std::move(times)
+    };
+}
+
+}
@@ -0,0 +1,187 @@
+#include "vk/completion.hpp"
+
+#include <algorithm>
+
+#include "vk/result.hpp"
+
+namespace hephaistos::vulkan {
+
+void CompletionService::add(
+    VkSemaphore semaphore, uint64_t value, std::function<void()> callback)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back({ semaphore, value, std::move(callback) });
+    //worker has to include the new semaphore
+    if (waiting)
+        wake();
+    condition.notify_all();
+}
+
+std::vector<std::function<void()>> CompletionService::remove(VkSemaphore semaphore) {
+    std::vector<std::function<void()>> ready;
+    std::unique_lock<std::mutex> lock(mutex);
+    auto it = std::stable_partition(pending.begin(), pending.end(),
+        [semaphore](const Entry& entry) { return entry.semaphore != semaphore; });
+    if (it == pending.end())
+        return ready;
+
+    //the worker might just not have noticed yet
+    uint64_t value = 0;
+    context.fnTable.vkGetSemaphoreCounterValue(context.device, semaphore, &value);
+    for (auto i = it; i != pending.end(); ++i) {
+        if (i->value <= value)
+            ready.push_back(std::move(i->callback));
+    }
+    pending.erase(it, pending.end());
+
+    //wait for the worker to stop using the semaphore
+    if (waiting) {
+        auto current = generation;
+        wake();
+        condition.wait(lock, [this, current]() { return generation != current; });
+    }
+
+    return ready;
+}
+
+void CompletionService::wake() {
+    VkSemaphoreSignalInfo info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO,
+        .semaphore = wakeSemaphore,
+        .value = ++wakeValue
+    };
+    context.fnTable.vkSignalSemaphore(context.device, &info);
+}
+
+void CompletionService::run() {
+    std::vector<VkSemaphore> semaphores;
+    std::vector<uint64_t> values;
+    std::vector<std::function<void()>> ready;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stop) {
+        if (pending.empty()) {
+            condition.wait(lock, [this]() { return stop || !pending.empty(); });
+            continue;
+        }
+
+        //wait on all pending semaphores at once
+        semaphores.assign(1, wakeSemaphore);
+        values.assign(1, wakeValue + 1);
+        for (auto& entry : pending) {
+            semaphores.push_back(entry.semaphore);
+            values.push_back(entry.value);
+        }
+        VkSemaphoreWaitInfo info{
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .flags = VK_SEMAPHORE_WAIT_ANY_BIT,
+            .semaphoreCount = static_cast<uint32_t>(semaphores.size()),
+            .pSemaphores = semaphores.data(),
+            .pValues = values.data()
+        };
+
+        waiting = true;
+        lock.unlock();
+        auto result = context.fnTable.vkWaitSemaphores(
+            context.device, &info, UINT64_MAX);
+        lock.lock();
+        waiting = false;
+        ++generation;
+        condition.notify_all();
+        //device lost -> nothing will ever finish
+        if (result != VK_SUCCESS && result != VK_TIMEOUT)
+            break;
+
+        //collect finished callbacks
+        auto it = std::stable_partition(pending.begin(), pending.end(),
+            [this](const Entry& entry) {
+                uint64_t value;
+                auto result = context.fnTable.vkGetSemaphoreCounterValue(
+                    context.device, entry.semaphore, &value);
+                return result != VK_SUCCESS || value < entry.value;
+            });
+        for (auto i = it; i != pending.end(); ++i)
+            ready.push_back(std::move(i->callback));
+        pending.erase(it, pending.end());
+
+        //run them without holding the lock, so they can register new ones
+        lock.unlock();
+        for (auto& callback : ready) {
+            //we cannot report errors from here
+            try {
+                callback();
+            }
+            catch (...) {}
+        }
+        ready.clear();
+        lock.lock();
+    }
+}
+
+CompletionService::CompletionService(const Context& context)
+    : pending()
+    , stop(false)
+    , waiting(false)
+    , generation(0)
+    , wakeSemaphore(VK_NULL_HANDLE)
+    , wakeValue(0)
+    , context(context)
+{
+    VkSemaphoreTypeCreateInfo type{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0
+    };
+    VkSemaphoreCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &type
+    };
+    checkResult(context.fnTable.vkCreateSemaphore(
+        context.device, &info, nullptr, &wakeSemaphore));
+
+    worker = std::thread(&CompletionService::run, this);
+}
+
+CompletionService::~CompletionService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+        wake();
+        condition.notify_all();
+    }
+    worker.join();
+
+    context.fnTable.vkDestroySemaphore(context.device, wakeSemaphore, nullptr);
+}
+
+void addCompletion(const Context& context,
+    VkSemaphore semaphore, uint64_t value, std::function<void()> callback)
+{
+    std::lock_guard<std::mutex> lock(context.completionMutex);
+    if (!context.completionService)
+        context.completionService = std::make_unique<CompletionService>(context);
+    context.completionService->add(semaphore, value, std::move(callback));
+}
+
+void removeCompletions(const Context& context, VkSemaphore semaphore) {
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock(context.completionMutex);
+        if (context.completionService)
+            ready = context.completionService->remove(semaphore);
+    }
+    //run outside the lock, so they can register new callbacks
+    for (auto& callback : ready) {
+        try {
+            callback();
+        }
+        catch (...) {}
+    }
+}
+
+void destroyCompletionService(const Context& context) {
+    std::lock_guard<std::mutex> lock(context.completionMutex);
+    context.completionService.reset();
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "vk/types.hpp"
+
+namespace hephaistos::vulkan {
+
+//Runs callbacks on the host once timeline semaphores reach given values.
+//A single background thread waits on all pending semaphores at once,
+//including an internal one used to wake it whenever the pending set changes.
+class CompletionService {
+public:
+    //registers callback to run once semaphore reaches value
+    void add(VkSemaphore semaphore, uint64_t value, std::function<void()> callback);
+    //removes all callbacks on the given semaphore and ensures it is no longer
+    //waited on, e.g. before destroying it. Returns the callbacks whose value
+    //was already reached, but did not run yet; the others are dropped.
+    [[nodiscard]] std::vector<std::function<void()>> remove(VkSemaphore semaphore);
+
+    CompletionService(const CompletionService&) = delete;
+    CompletionService& operator=(const CompletionService&) = delete;
+
+    explicit CompletionService(const Context& context);
+    ~CompletionService();
+
+private:
+    struct Entry {
+        VkSemaphore semaphore;
+        uint64_t value;
+        std::function<void()> callback;
+    };
+
+    void run();
+    //must be called while holding the mutex
+    void wake();
+
+    std::vector<Entry> pending;
+    bool stop;
+    //true while the worker waits on the device
+    bool waiting;
+    //increased each time the worker stops waiting
+    uint64_t generation;
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    VkSemaphore wakeSemaphore;
+    uint64_t wakeValue;
+
+    std::thread worker;
+    const Context& context;
+};
+
+//Registers a callback on the context's completion service, creating it if
+//necessary
+void addCompletion(const Context& context,
+    VkSemaphore semaphore, uint64_t value, std::function<void()> callback);
+//Removes all callbacks on the given semaphore, if there is a completion
+//service. Already reached ones are run on the calling thread.
+void removeCompletions(const Context& context, VkSemaphore semaphore);
+//Stops the completion service. Only called during context destruction.
+void destroyCompletionService(const Context& context);
+
+}
@@ -0,0 +1,318 @@
+#include "vk/hazard.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace hephaistos::vulkan {
+
+namespace {
+
+constexpr VkAccessFlags2KHR WriteAccess =
+    VK_ACCESS_2_SHADER_WRITE_BIT_KHR |
+    VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR |
+    VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR |
+    VK_ACCESS_2_HOST_WRITE_BIT_KHR |
+    VK_ACCESS_2_MEMORY_WRITE_BIT_KHR |
+    VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+
+constexpr VkDeviceSize End = std::numeric_limits<VkDeviceSize>::max();
+
+template<class T>
+uint64_t toKey(T handle) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+}
+VkBuffer toBuffer(uint64_t key) {
+    return reinterpret_cast<VkBuffer>(static_cast<uintptr_t>(key));
+}
+
+VkDeviceSize toEnd(VkDeviceSize offset, VkDeviceSize size) {
+    return size == VK_WHOLE_SIZE ? End : offset + size;
+}
+VkDeviceSize toSize(VkDeviceSize begin, VkDeviceSize end) {
+    return end == End ? VK_WHOLE_SIZE : end - begin;
+}
+
+}
+
+void HazardTracker::buffer(
+    VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+    VkPipelineStageFlags2KHR stage, VkAccessFlags2KHR access)
+{
+    pending.push_back({ toKey(buffer), false, offset, toEnd(offset, size), stage, access });
+}
+void HazardTracker::image(VkImageView view,
+    VkPipelineStageFlags2KHR stage, VkAccessFlags2KHR access)
+{
+    pending.push_back({ toKey(view), true, 0, End, stage, access });
+}
+void HazardTracker::texture(VkImage image, VkImageView view,
+    uint32_t baseLevel, uint32_t levelCount, VkImageLayout layout,
+    VkPipelineStageFlags2KHR stage, VkAccessFlags2KHR access,
+    bool discard)
+{
+    textures.try_emplace(toKey(view), Texture{ image, {} });
+    pendingTextures.push_back({
+        toKey(view), baseLevel, levelCount, layout, stage, access, discard });
+}
+void HazardTracker::sampled(VkImageView view, VkPipelineStageFlags2KHR stage) {
+    //untracked textures are still in the shader read only layout
+    if (!textures.contains(toKey(view))) {
+        untrackedSamples |= stage;
+        return;
+    }
+    pendingTextures.push_back({
+        toKey(view), 0, VK_REMAINING_MIP_LEVELS,
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        stage, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR, false });
+}
+void HazardTracker::sampledAll(VkPipelineStageFlags2KHR stage) {
+    untrackedSamples |= stage;
+    for (auto& [view, texture] : textures) {
+        pendingTextures.push_back({
+            view, 0, VK_REMAINING_MIP_LEVELS,
+            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            stage, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR, false });
+    }
+}
+void HazardTracker::hostRead(
+    VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+    VkPipelineStageFlags2KHR stage, VkAccessFlags2KHR access)
+{
+    hostReads.push_back({
+        .srcStage = stage,
+        .srcAccess = access,
+        .dstStage = VK_PIPELINE_STAGE_2_HOST_BIT_KHR,
+        .dstAccess = VK_ACCESS_2_HOST_READ_BIT_KHR,
+        .buffer = buffer,
+        .offset = offset,
+        .size = size
+    });
+}
+
+void HazardTracker::resolve(bool emit,
+    std::vector<BufferBarrier>& bufferBarriers,
+    GlobalBarrier& globalBarrier)
+{
+    //Determine barriers against the state before this command, so accesses
+    //of the same command do not create hazards with each other
+    for (auto& access : pending) {
+        auto& ranges = access.isImage ? images[access.handle] : buffers[access.handle];
+        bool isWrite = (access.access & WriteAccess) != 0;
+
+        VkPipelineStageFlags2KHR srcStage = 0;
+        VkAccessFlags2KHR srcAccess = 0;
+        for (auto& range : ranges) {
+            if (range.end <= access.begin || range.begin >= access.end)
+                continue;
+            if (isWrite) {
+                //WAW and WAR
+                srcStage |= range.writeStages | range.readStages;
+                srcAccess |= range.writeAccess;
+            }
+            else if (range.writeStages && (
+                (access.stage & ~range.readStages) ||
+                (access.access & ~range.readAccess)))
+            {
+                //RAW not yet visible to this stage
+                srcStage |= range.writeStages;
+                srcAccess |= range.writeAccess;
+            }
+        }
+
+        //merge overlapping ranges into one; the barrier covers all of it
+        Range merged{ access.begin, access.end, 0, 0, 0, 0 };
+        auto it = std::remove_if(ranges.begin(), ranges.end(),
+            [&merged, &access](const Range& range) {
+                if (range.end <= access.begin || range.begin >= access.end)
+                    return false;
+                merged.begin = std::min(merged.begin, range.begin);
+                merged.end = std::max(merged.end, range.end);
+                merged.writeStages |= range.writeStages;
+                merged.writeAccess |= range.writeAccess;
+                merged.readStages |= range.readStages;
+                merged.readAccess |= range.readAccess;
+                return true;
+            });
+        ranges.erase(it, ranges.end());
+
+        if (emit && srcStage) {
+            if (access.isImage) {
+                globalBarrier.srcStage |= srcStage;
+                globalBarrier.srcAccess |= srcAccess;
+                globalBarrier.dstStage |= access.stage;
+                globalBarrier.dstAccess |= access.access;
+            }
+            else {
+                bufferBarriers.push_back({
+                    .srcStage = srcStage,
+                    .srcAccess = srcAccess,
+                    .dstStage = access.stage,
+                    .dstAccess = access.access,
+                    .buffer = toBuffer(access.handle),
+                    .offset = merged.begin,
+                    .size = toSize(merged.begin, merged.end)
+                });
+            }
+        }
+
+        //update state
+        if (isWrite) {
+            merged.writeStages = access.stage;
+            merged.writeAccess = access.access & WriteAccess;
+            merged.readStages = 0;
+            merged.readAccess = 0;
+        }
+        else {
+            merged.readStages |= access.stage;
+            merged.readAccess |= access.access;
+        }
+        ranges.push_back(merged);
+    }
+    pending.clear();
+}
+
+void HazardTracker::resolveTextures(std::vector<ImageBarrier>& barriers) {
+    //levels seen for the first time may still be sampled by earlier commands
+    Level initial{
+        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 0, 0, untrackedSamples,
+        untrackedSamples ? VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR : 0
+    };
+    for (auto& access : pendingTextures) {
+        auto& texture = textures[access.view];
+        size_t end = access.levelCount == VK_REMAINING_MIP_LEVELS ?
+            texture.levels.size() : access.baseLevel + access.levelCount;
+        if (texture.levels.size() < end)
+            texture.levels.resize(end, initial);
+        bool isWrite = (access.access & WriteAccess) != 0;
+
+        for (auto i = access.baseLevel; i < end; ++i) {
+            auto& level = texture.levels[i];
+            bool transition = level.layout != access.layout;
+
+            VkPipelineStageFlags2KHR srcStage = 0;
+            VkAccessFlags2KHR srcAccess = 0;
+            if (isWrite || transition) {
+                //WAW and WAR; layout transitions count as writes
+                srcStage = level.writeStages | level.readStages;
+                srcAccess = level.writeAccess;
+            }
+            else if (level.writeStages && (
+                (access.stage & ~level.readStages) ||
+                (access.access & ~level.readAccess)))
+            {
+                //RAW not yet visible to this stage
+                srcStage = level.writeStages;
+                srcAccess = level.writeAccess;
+            }
+
+            if (transition || srcStage) {
+                ImageBarrier barrier{
+                    .srcStage = srcStage,
+                    .srcAccess = srcAccess,
+                    .dstStage = access.stage,
+                    .dstAccess = access.access,
+                    .oldLayout = access.discard ?
+                        VK_IMAGE_LAYOUT_UNDEFINED : level.layout,
+                    .newLayout = access.layout,
+                    .image = texture.image,
+                    .baseMipLevel = i,
+                    .levelCount = 1
+                };
+                //extend the previous barrier if it only differs in level
+                if (!barriers.empty() &&
+                    barriers.back().image == barrier.image &&
+                    barriers.back().baseMipLevel + barriers.back().levelCount == i &&
+                    barriers.back().srcStage == barrier.srcStage &&
+                    barriers.back().srcAccess == barrier.srcAccess &&
+                    barriers.back().dstStage == barrier.dstStage &&
+                    barriers.back().dstAccess == barrier.dstAccess &&
+                    barriers.back().oldLayout == barrier.oldLayout &&
+                    barriers.back().newLayout == barrier.newLayout)
+                {
+                    ++barriers.back().levelCount;
+                }
+                else {
+                    barriers.push_back(barrier);
+                }
+            }
+
+            //update state
+            level.layout = access.layout;
+            if (isWrite) {
+                level.writeStages = access.stage;
+                level.writeAccess = access.access & WriteAccess;
+                level.readStages = 0;
+                level.readAccess = 0;
+            }
+            else if (transition) {
+                //only ordered against the stage the transition was made for
+                level.writeStages = access.stage;
+                level.writeAccess = 0;
+                level.readStages = access.stage;
+                level.readAccess = access.access;
+            }
+            else {
+                level.readStages |= access.stage;
+                level.readAccess |= access.access;
+            }
+        }
+    }
+    pendingTextures.clear();
+}
+
+void HazardTracker::barrier(const Context& context, const Command& cmd) {
+    std::vector<BufferBarrier> bufferBarriers;
+    GlobalBarrier globalBarrier{};
+    std::vector<ImageBarrier> imageBarriers;
+    resolve(true, bufferBarriers, globalBarrier);
+    resolveTextures(imageBarriers);
+
+    if (globalBarrier.srcStage) {
+        pipelineBarrier(context, cmd, bufferBarriers, { &globalBarrier, 1 }, imageBarriers);
+    }
+    else if (!bufferBarriers.empty() || !imageBarriers.empty()) {
+        pipelineBarrier(context, cmd, bufferBarriers, {}, imageBarriers);
+    }
+}
+
+void HazardTracker::commit() {
+    std::vector<BufferBarrier> bufferBarriers;
+    GlobalBarrier globalBarrier{};
+    resolve(false, bufferBarriers, globalBarrier);
+}
+
+void HazardTracker::finish(const Context& context, const Command& cmd) {
+    //return all textures to the shader read only layout
+    std::vector<ImageBarrier> imageBarriers;
+    for (auto& [view, texture] : textures) {
+        for (uint32_t i = 0; i < texture.levels.size(); ++i) {
+            auto& level = texture.levels[i];
+            if (level.layout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+                continue;
+            imageBarriers.push_back({
+                .srcStage = level.writeStages | level.readStages,
+                .srcAccess = level.writeAccess,
+                .dstStage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR,
+                .dstAccess = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR,
+                .oldLayout = level.layout,
+                .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                .image = texture.image,
+                .baseMipLevel = i,
+                .levelCount = 1
+            });
+        }
+    }
+
+    if (!hostReads.empty() || !imageBarriers.empty())
+        pipelineBarrier(context, cmd, hostReads, {}, imageBarriers);
+
+    buffers.clear();
+    images.clear();
+    textures.clear();
+    untrackedSamples = 0;
+    pending.clear();
+    pendingTextures.clear();
+    hostReads.clear();
+}
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "vk/types.hpp"
+#include "vk/util.hpp"
+
+namespace hephaistos::vulkan {
+
+//Tracks accesses of tensor and image ranges within a single command buffer
+//and only emits barriers for actual hazards (RAW, WAR, WAW).
+//Commands declare their accesses and call barrier() before recording the
+//actual work. All barriers needed by a command are merged into one.
+//Accesses of previous command buffers are assumed to be synchronized, e.g.
+//by the timeline semaphores between steps.
+//Textures additionally get their layout tracked per mip level and are only
+//transitioned once an access requires a different one. Between command
+//buffers they are always in the shader read only layout, which finish()
+//restores.
+class HazardTracker {
+public:
+    //declare access of the next command
+    void buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+        VkPipelineStageFlags2KHR stage, VkAccessFlags2KHR access);
+    //images are tracked as a whole by their view and synchronized using
+    //global barriers as they always stay in the general layout
+    void image(VkImageView view,
+        VkPipelineStageFlags2KHR stage, VkAccessFlags2KHR access);
+    //textures are tracked by their view and transitioned into the given
+    //layout if needed. If discard is true, previous content may be dropped.
+    void texture(VkImage image, VkImageView view,
+        uint32_t baseLevel, uint32_t levelCount, VkImageLayout layout,
+        VkPipelineStageFlags2KHR stage, VkAccessFlags2KHR access,
+        bool discard = false);
+    //declares sampling the texture of the given view in shaders
+    void sampled(VkImageView view, VkPipelineStageFlags2KHR stage);
+    //declares sampling of any texture, e.g. if bound params are unknown
+    void sampledAll(VkPipelineStageFlags2KHR stage);
+    //declares that the given range is read by the host after the work finished
+    void hostRead(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size,
+        VkPipelineStageFlags2KHR stage, VkAccessFlags2KHR access);
+
+    //records needed barriers for all declared accesses
+    void barrier(const Context& context, const Command& cmd);
+    //updates the state without recording barriers, e.g. for unsafe commands
+    //Must not be used for texture accesses as these may need transitions.
+    void commit();
+    //records barriers making writes available to the host and resets state
+    void finish(const Context& context, const Command& cmd);
+
+private:
+    struct Range {
+        VkDeviceSize begin;
+        VkDeviceSize end;
+        VkPipelineStageFlags2KHR writeStages;
+        VkAccessFlags2KHR writeAccess;
+        //stages/access the last write is visible to or read in
+        VkPipelineStageFlags2KHR readStages;
+        VkAccessFlags2KHR readAccess;
+    };
+    struct Access {
+        uint64_t handle;
+        bool isImage;
+        VkDeviceSize begin;
+        VkDeviceSize end;
+        VkPipelineStageFlags2KHR stage;
+        VkAccessFlags2KHR access;
+    };
+
+    struct Level {
+        VkImageLayout layout;
+        VkPipelineStageFlags2KHR writeStages;
+        VkAccessFlags2KHR writeAccess;
+        VkPipelineStageFlags2KHR readStages;
+        VkAccessFlags2KHR readAccess;
+    };
+    struct Texture {
+        VkImage image;
+        std::vector<Level> levels;
+    };
+    struct TextureAccess {
+        uint64_t view;
+        uint32_t baseLevel;
+        uint32_t levelCount;
+        VkImageLayout layout;
+        VkPipelineStageFlags2KHR stage;
+        VkAccessFlags2KHR access;
+        bool discard;
+    };
+
+    void resolve(bool emit,
+        std::vector<BufferBarrier>& buffers, GlobalBarrier& global);
+    void resolveTextures(std::vector<ImageBarrier>& barriers);
+
+    std::unordered_map<uint64_t, std::vector<Range>> buffers;
+    std::unordered_map<uint64_t, std::vector<Range>> images;
+    std::unordered_map<uint64_t, Texture> textures;
+    //stages sampling textures not tracked at that time
+    VkPipelineStageFlags2KHR untrackedSamples = 0;
+    std::vector<Access> pending;
+    std::vector<TextureAccess> pendingTextures;
+    std::vector<BufferBarrier> hostReads;
+};
+
+}
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "volk.h"
@@ -20,11 +21,15 @@ namespace {
 uint32_t instanceReferenceCount = 0;
 VkInstance instance;
 VkDebugUtilsMessengerEXT messenger = VK_NULL_HANDLE;
+uint64_t instanceGeneration = 0;
 
 //Debug state
 PFN_vkDebugUtilsMessengerCallbackEXT debugCallback = nullptr;
 std::vector<VkValidationFeatureEnableEXT> debugEnable = {};
 std::vector< VkValidationFeatureDisableEXT> debugDisable = {};
+bool debugLabels = false;
+bool debugUtilsEnabled = false;
+bool robustBufferAccess = false;
 
 constexpr auto DebugMessageSeverity =
     VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT |
@@ -93,6 +98,22 @@ void setInstanceDebugState(
     debugCallback = callback;
 }
 
+void setInstanceDebugLabels() {
+    debugLabels = true;
+}
+
+bool isDebugUtilsEnabled() {
+    return instanceReferenceCount > 0 && debugUtilsEnabled;
+}
+
+void setRobustBufferAccess(bool enable) {
+    robustBufferAccess = enable;
+}
+
+bool isRobustBufferAccessRequested() {
+    return robustBufferAccess;
+}
+
 VkInstance getInstance() {
 	//singleton check
 	if (instanceReferenceCount++ > 0)
@@ -139,10 +160,26 @@ VkInstance getInstance() {
         //enable validation features
         instInfo.pNext = &validation;
     }
+    //labels only need the extension, which is provided by the loader
+    else if (debugLabels) {
+        uint32_t count;
+        vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+        std::vector<VkExtensionProperties> props(count);
+        vkEnumerateInstanceExtensionProperties(nullptr, &count, props.data());
+        for (const auto& prop : props) {
+            if (std::string_view(prop.extensionName) == VK_EXT_DEBUG_UTILS_EXTENSION_NAME) {
+                instInfo.enabledExtensionCount = static_cast<uint32_t>(InstanceExtensions.size());
+                instInfo.ppEnabledExtensionNames = InstanceExtensions.data();
+                break;
+            }
+        }
+    }
+    debugUtilsEnabled = instInfo.enabledExtensionCount > 0;
 
     //create instance
     vulkan::checkResult(vkCreateInstance(&instInfo, nullptr, &instance));
     volkLoadInstanceOnly(instance);
+    ++instanceGeneration;
 
     //optionally create debug messenger
     if (debugEnabled) {
@@ -163,6 +200,10 @@ VkInstance getInstance() {
     return instance;
 }
 
+uint64_t getInstanceGeneration() {
+    return instanceGeneration;
+}
+
 void returnInstance() {
     //destroy instance if recount reaches zero
     if (--instanceReferenceCount == 0) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <span>
 
 #include "volk.h"
@@ -12,8 +13,18 @@ void setInstanceDebugState(
 	std::span<VkValidationFeatureDisableEXT> disable,
 	PFN_vkDebugUtilsMessengerCallbackEXT callback
 );
+//Debug labels -> enable VK_EXT_debug_utils without validation layers
+void setInstanceDebugLabels();
+//true, if the instance was created with VK_EXT_debug_utils
+bool isDebugUtilsEnabled();
+//Debug -> devices created afterwards enable robust buffer access
+void setRobustBufferAccess(bool enable);
+bool isRobustBufferAccessRequested();
 
 VkInstance getInstance();
 void returnInstance();
+//Incremented every time a new instance is created. Allows caches of
+//physical device data to detect that their handles became invalid.
+uint64_t getInstanceGeneration();
 
 }
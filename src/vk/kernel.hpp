@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string_view>
+
+#include "hephaistos/compiler.hpp"
+#include "hephaistos/program.hpp"
+
+namespace hephaistos::vulkan {
+
+//Compiles one of the library's internal GLSL kernels into a program.
+//Kernels may include the built-in headers.
+inline hephaistos::Program compileKernel(const ContextHandle& context, std::string_view source) {
+    Compiler compiler;
+    return hephaistos::Program(context, compiler.compile(source));
+}
+
+}
@@ -0,0 +1,140 @@
+#include "vk/layout.hpp"
+
+#include <algorithm>
+
+#include "vk/result.hpp"
+
+namespace hephaistos::vulkan {
+
+namespace {
+
+//FNV-1a; only used to find candidates, which are compared afterwards
+uint64_t hashCode(std::span<const uint32_t> code) {
+    uint64_t hash = 14695981039346656037ull;
+    for (auto word : code) {
+        hash ^= word;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+}
+
+std::shared_ptr<const Reflection> LayoutCache::findReflection(
+    std::span<const uint32_t> code) const
+{
+    std::lock_guard<std::mutex> lock(reflectionMutex);
+    auto [begin, end] = reflections.equal_range(hashCode(code));
+    for (auto it = begin; it != end; ++it) {
+        auto& cached = it->second.code;
+        if (std::equal(cached.begin(), cached.end(), code.begin(), code.end()))
+            return it->second.reflection;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<const Reflection> LayoutCache::addReflection(
+    std::span<const uint32_t> code, Reflection reflection)
+{
+    auto hash = hashCode(code);
+    std::lock_guard<std::mutex> lock(reflectionMutex);
+    //another thread might have been faster
+    auto [begin, end] = reflections.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        auto& cached = it->second.code;
+        if (std::equal(cached.begin(), cached.end(), code.begin(), code.end()))
+            return it->second.reflection;
+    }
+
+    auto result = std::make_shared<const Reflection>(std::move(reflection));
+    reflections.emplace(hash, ReflectionEntry{
+        { code.begin(), code.end() }, result });
+    return result;
+}
+
+Layout LayoutCache::getLayout(
+    std::span<const VkDescriptorSetLayoutBinding> bindings,
+    VkDescriptorSetLayoutCreateFlags flags,
+    uint32_t pushSize,
+    VkShaderStageFlags pushStages)
+{
+    //build key; immutable samplers are never used
+    std::vector<uint32_t> key;
+    key.reserve(3 + 4 * bindings.size());
+    key.push_back(flags);
+    key.push_back(pushSize);
+    key.push_back(pushStages);
+    for (auto& binding : bindings) {
+        key.push_back(binding.binding);
+        key.push_back(static_cast<uint32_t>(binding.descriptorType));
+        key.push_back(binding.descriptorCount);
+        key.push_back(binding.stageFlags);
+    }
+
+    std::lock_guard<std::mutex> lock(layoutMutex);
+    auto it = layouts.find(key);
+    if (it != layouts.end())
+        return it->second;
+
+    Layout layout{};
+    if (!bindings.empty()) {
+        //arrays may be bound with fewer arguments than they hold
+        std::vector<VkDescriptorBindingFlags> bindingFlags;
+        for (auto& binding : bindings) {
+            bindingFlags.push_back(context.partiallyBound && binding.descriptorCount > 1
+                ? VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT : 0u);
+        }
+        VkDescriptorSetLayoutBindingFlagsCreateInfo flagsInfo{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+            .bindingCount = static_cast<uint32_t>(bindingFlags.size()),
+            .pBindingFlags = bindingFlags.data()
+        };
+        auto partial = std::any_of(bindingFlags.begin(), bindingFlags.end(),
+            [](VkDescriptorBindingFlags f) { return f != 0; });
+        VkDescriptorSetLayoutCreateInfo setInfo{
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .pNext = partial ? &flagsInfo : nullptr,
+            .flags = flags,
+            .bindingCount = static_cast<uint32_t>(bindings.size()),
+            .pBindings = bindings.data()
+        };
+        checkResult(context.fnTable.vkCreateDescriptorSetLayout(
+            context.device, &setInfo, nullptr, &layout.setLayout));
+    }
+    VkPushConstantRange push{
+        .stageFlags = pushStages,
+        .offset = 0,
+        .size = pushSize
+    };
+    VkPipelineLayoutCreateInfo layoutInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = layout.setLayout ? 1u : 0u,
+        .pSetLayouts = &layout.setLayout,
+        .pushConstantRangeCount = pushSize ? 1u : 0u,
+        .pPushConstantRanges = &push
+    };
+    auto result = context.fnTable.vkCreatePipelineLayout(
+        context.device, &layoutInfo, nullptr, &layout.pipeLayout);
+    if (result != VK_SUCCESS) {
+        context.fnTable.vkDestroyDescriptorSetLayout(
+            context.device, layout.setLayout, nullptr);
+        checkResult(result);
+    }
+
+    layouts.emplace(std::move(key), layout);
+    return layout;
+}
+
+LayoutCache::LayoutCache(const Context& context)
+    : context(context)
+{}
+LayoutCache::~LayoutCache() {
+    for (auto& [key, layout] : layouts) {
+        context.fnTable.vkDestroyPipelineLayout(
+            context.device, layout.pipeLayout, nullptr);
+        context.fnTable.vkDestroyDescriptorSetLayout(
+            context.device, layout.setLayout, nullptr);
+    }
+}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "hephaistos/program.hpp"
+#include "vk/types.hpp"
+
+namespace hephaistos::vulkan {
+
+//Interface of a compute shader as reflected from its SPIR-V code
+struct Reflection {
+    LocalSize localSize;
+    std::string entryPoint;
+    //only accessed bindings; all three share the same order
+    std::vector<VkDescriptorSetLayoutBinding> bindings;
+    std::vector<VkWriteDescriptorSet> params;
+    std::vector<BindingTraits> traits;
+    //zero if there are no push constants
+    uint32_t pushSize;
+    std::vector<BlockMember> pushMembers;
+    //ids of all specialization constants in ascending order
+    std::vector<uint32_t> specIds;
+    //bytes of shared memory used by a single workgroup
+    uint32_t sharedMemorySize = 0;
+};
+
+//Descriptor set layout and the pipeline layout using it
+struct Layout {
+    //null if there are no bindings
+    VkDescriptorSetLayout setLayout;
+    VkPipelineLayout pipeLayout;
+};
+
+//Shares reflections and layouts between programs of the same context, so
+//programs with the same binding signature also share the same layout objects.
+//Entries are kept until the context is destroyed.
+class LayoutCache {
+public:
+    //returns the reflection of previously added identical code or null
+    [[nodiscard]] std::shared_ptr<const Reflection> findReflection(
+        std::span<const uint32_t> code) const;
+    //adds the reflection of the given code and returns the cached one, which
+    //may differ if another thread added the same code in the meantime
+    std::shared_ptr<const Reflection> addReflection(
+        std::span<const uint32_t> code, Reflection reflection);
+
+    //returns a layout matching the given bindings, flags and push constant
+    //size and stages, creating it on the first request
+    [[nodiscard]] Layout getLayout(
+        std::span<const VkDescriptorSetLayoutBinding> bindings,
+        VkDescriptorSetLayoutCreateFlags flags,
+        uint32_t pushSize,
+        VkShaderStageFlags pushStages = VK_SHADER_STAGE_COMPUTE_BIT);
+
+    LayoutCache(const LayoutCache&) = delete;
+    LayoutCache& operator=(const LayoutCache&) = delete;
+
+    explicit LayoutCache(const Context& context);
+    ~LayoutCache();
+
+private:
+    struct ReflectionEntry {
+        //code is kept to rule out hash collisions
+        std::vector<uint32_t> code;
+        std::shared_ptr<const Reflection> reflection;
+    };
+
+    mutable std::mutex reflectionMutex;
+    std::unordered_multimap<uint64_t, ReflectionEntry> reflections;
+    //layouts keyed by flags, push size and the bindings' fields
+    std::mutex layoutMutex;
+    std::map<std::vector<uint32_t>, Layout> layouts;
+
+    const Context& context;
+};
+
+}
@@ -1,27 +1,54 @@
 #include "vk/types.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
 #include "vk/result.hpp"
 #include "vk/util.hpp"
 
 namespace hephaistos::vulkan {
 
-BufferHandle createBuffer(
-    const ContextHandle& context,
-    uint64_t size,
-    VkBufferUsageFlags usage,
-    VmaAllocationCreateFlags flags)
+VkBufferCreateInfo getBufferCreateInfo(
+    const Context& context, uint64_t size, VkBufferUsageFlags usage)
 {
-    BufferHandle result{ new Buffer({0,0,{},*context}), destroyBuffer };
-
     VkBufferCreateInfo bufferInfo{
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
         .size = size,
         .usage = usage,
     };
-    VmaAllocationCreateInfo allocInfo{
+    //share between queue families to not require ownership transfers
+    if (context.queueFamilies.size() > 1) {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = static_cast<uint32_t>(context.queueFamilies.size());
+        bufferInfo.pQueueFamilyIndices = context.queueFamilies.data();
+    }
+    return bufferInfo;
+}
+
+BufferHandle createBuffer(
+    const ContextHandle& context,
+    uint64_t size,
+    VkBufferUsageFlags usage,
+    VmaAllocationCreateFlags flags)
+{
+    return createBuffer(context, size, usage, VmaAllocationCreateInfo{
         .flags = flags,
         .usage = VMA_MEMORY_USAGE_AUTO
-    };
+    });
+}
+BufferHandle createBuffer(
+    const ContextHandle& context,
+    uint64_t size,
+    VkBufferUsageFlags usage,
+    const VmaAllocationCreateInfo& info)
+{
+    BufferHandle result{ new Buffer({0,0,{},0,nullptr,nullptr,size,usage,{},false,*context}), destroyBuffer };
+
+    auto bufferInfo = getBufferCreateInfo(*context, size, usage);
+    auto allocInfo = info;
+    //allows defragmentation to find the buffer
+    allocInfo.pUserData = result.get();
 
     checkResult(vmaCreateBuffer(
         context->allocator,
@@ -33,17 +60,354 @@ BufferHandle createBuffer(
 
     return result;
 }
+
+VmaAllocationCreateInfo getAllocationCreateInfo(
+    const Context& context,
+    const AllocationHints& hints,
+    VmaAllocationCreateFlags flags,
+    VmaMemoryUsage usage)
+{
+    switch (hints.placement) {
+    case MemoryPlacement::PREFER_DEVICE:
+        usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        break;
+    case MemoryPlacement::PREFER_HOST:
+        usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+        break;
+    default:
+        break;
+    }
+    //priorities are assigned per memory block
+    // -> only dedicated allocations can have their own
+    auto priority = std::clamp(hints.priority, 0.0f, 1.0f);
+    if (hints.dedicated || (context.memoryPriority && priority != AllocationHints{}.priority))
+        flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+
+    return {
+        .flags = flags,
+        .usage = usage,
+        .priority = priority
+    };
+}
+
+VkDeviceSize getBufferOffsetAlignment(const Context& context) {
+    //offsets must be valid for any descriptor type and flush ranges must not
+    //overlap neighbours; device addresses are aligned generously
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(context.physicalDevice, &props);
+    auto& limits = props.limits;
+    return std::max({
+        limits.minStorageBufferOffsetAlignment,
+        limits.minUniformBufferOffsetAlignment,
+        limits.minTexelBufferOffsetAlignment,
+        limits.nonCoherentAtomSize,
+        VkDeviceSize{ 16 }
+    });
+}
+
+namespace {
+
+//size of the shared buffers small tensors get sub-allocated from
+constexpr VkDeviceSize BufferChunkSize = 4 * 1024 * 1024;
+
+//sub-allocates from the pool matching usage and flags, creating it with the
+//given alignment if needed; bufferPoolMutex must be held
+BufferHandle allocatePooledBuffer(
+    const ContextHandle& context,
+    uint64_t size,
+    VkBufferUsageFlags usage,
+    VmaAllocationCreateFlags flags,
+    VkDeviceSize alignment)
+{
+    //find pool matching the buffer
+    auto& pools = context->bufferPools;
+    auto pool = std::find_if(pools.begin(), pools.end(),
+        [usage, flags](const BufferPool& p) {
+            return p.usage == usage && p.flags == flags;
+        });
+    if (pool == pools.end()) {
+        pools.push_back(BufferPool{
+            .usage = usage,
+            .flags = flags,
+            .alignment = alignment
+        });
+        pool = pools.end() - 1;
+    }
+
+    VmaVirtualAllocationCreateInfo allocInfo{
+        .size = size,
+        .alignment = pool->alignment
+    };
+    VmaVirtualAllocation allocation = nullptr;
+    VkDeviceSize offset = 0;
+    //try existing chunks first, newest ones are most likely to have space
+    auto chunk = std::find_if(pool->chunks.rbegin(), pool->chunks.rend(),
+        [&](const BufferChunk& c) {
+            return vmaVirtualAllocate(c.block, &allocInfo, &allocation, &offset) == VK_SUCCESS;
+        });
+    if (chunk == pool->chunks.rend()) {
+        //none has space left -> create a new one
+        BufferChunk newChunk{
+            .buffer = createBuffer(context, BufferChunkSize, usage, flags),
+            .block = nullptr
+        };
+        VmaVirtualBlockCreateInfo blockInfo{ .size = BufferChunkSize };
+        checkResult(vmaCreateVirtualBlock(&blockInfo, &newChunk.block));
+        pool->chunks.push_back(std::move(newChunk));
+        chunk = pool->chunks.rbegin();
+        checkResult(vmaVirtualAllocate(chunk->block, &allocInfo, &allocation, &offset));
+    }
+
+    //share the chunk's buffer and memory
+    auto& shared = *chunk->buffer;
+    BufferHandle result{ new Buffer({
+        shared.buffer, shared.allocation, shared.allocInfo,
+        offset, chunk->block, allocation, size, usage, {}, false, *context
+    }), destroyBuffer };
+    result->allocInfo.size = size;
+    if (shared.allocInfo.pMappedData) {
+        result->allocInfo.pMappedData =
+            static_cast<std::byte*>(shared.allocInfo.pMappedData) + offset;
+    }
+
+    return result;
+}
+
+}
+
+BufferHandle createPooledBuffer(
+    const ContextHandle& context,
+    uint64_t size,
+    VkBufferUsageFlags usage,
+    VmaAllocationCreateFlags flags)
+{
+    std::lock_guard<std::mutex> lock(context->bufferPoolMutex);
+    if (size == 0 || size > context->bufferPoolThreshold || size > BufferChunkSize)
+        return createBuffer(context, size, usage, flags);
+    return allocatePooledBuffer(context, size, usage, flags,
+        getBufferOffsetAlignment(*context));
+}
+
+BufferHandle createDescriptorBuffer(const ContextHandle& context, uint64_t size) {
+    constexpr VkBufferUsageFlags usage =
+        VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+        VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT |
+        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    constexpr VmaAllocationCreateFlags flags =
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
+        VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    std::lock_guard<std::mutex> lock(context->bufferPoolMutex);
+    if (size > BufferChunkSize)
+        return createBuffer(context, size, usage, flags);
+
+    //always pooled, so dispatches only have to change offsets
+    VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptorProps{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT
+    };
+    VkPhysicalDeviceProperties2 props{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &descriptorProps
+    };
+    vkGetPhysicalDeviceProperties2(context->physicalDevice, &props);
+    return allocatePooledBuffer(context, size, usage, flags, std::max(
+        getBufferOffsetAlignment(*context),
+        descriptorProps.descriptorBufferOffsetAlignment));
+}
+
+namespace {
+
+void destroyImportedBuffer(Buffer* buffer) {
+    if (!buffer)
+        return;
+
+    //memory is not managed by the allocator
+    auto& context = buffer->context;
+    context.fnTable.vkDestroyBuffer(context.device, buffer->buffer, nullptr);
+    context.fnTable.vkFreeMemory(context.device, buffer->allocInfo.deviceMemory, nullptr);
+    delete buffer;
+}
+
+}
+
+BufferHandle createImportedBuffer(
+    const ContextHandle& context,
+    void* memory,
+    uint64_t size,
+    VkBufferUsageFlags usage)
+{
+    BufferHandle result{
+        new Buffer({0,0,{},0,nullptr,nullptr,size,usage,{},false,*context}),
+        destroyImportedBuffer
+    };
+    auto& fn = context->fnTable;
+
+    //query memory types the pointer can be imported as
+    VkMemoryHostPointerPropertiesEXT pointerProps{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_HOST_POINTER_PROPERTIES_EXT
+    };
+    checkResult(fn.vkGetMemoryHostPointerPropertiesEXT(
+        context->device,
+        VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+        memory, &pointerProps));
+
+    VkExternalMemoryBufferCreateInfo externalInfo{
+        .sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO,
+        .handleTypes = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT
+    };
+    auto bufferInfo = getBufferCreateInfo(*context, size, usage);
+    bufferInfo.pNext = &externalInfo;
+    checkResult(fn.vkCreateBuffer(context->device, &bufferInfo, nullptr, &result->buffer));
+    VkMemoryRequirements requirements;
+    fn.vkGetBufferMemoryRequirements(context->device, result->buffer, &requirements);
+
+    //host buffers are never flushed -> require coherent memory
+    const VkPhysicalDeviceMemoryProperties* memProps;
+    vmaGetMemoryProperties(context->allocator, &memProps);
+    auto typeBits = pointerProps.memoryTypeBits & requirements.memoryTypeBits;
+    constexpr VkMemoryPropertyFlags required =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    uint32_t type = 0;
+    for (; type < memProps->memoryTypeCount; ++type) {
+        if ((typeBits & (1u << type)) &&
+            (memProps->memoryTypes[type].propertyFlags & required) == required)
+        {
+            break;
+        }
+    }
+    if (type == memProps->memoryTypeCount)
+        throw std::runtime_error("The given host memory cannot be imported!");
+
+    VkImportMemoryHostPointerInfoEXT importInfo{
+        .sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_HOST_POINTER_INFO_EXT,
+        .handleType = VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT,
+        .pHostPointer = memory
+    };
+    VkMemoryAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .pNext = &importInfo,
+        .allocationSize = size,
+        .memoryTypeIndex = type
+    };
+    checkResult(fn.vkAllocateMemory(
+        context->device, &allocInfo, nullptr, &result->allocInfo.deviceMemory));
+    checkResult(fn.vkBindBufferMemory(
+        context->device, result->buffer, result->allocInfo.deviceMemory, 0));
+    result->allocInfo.size = size;
+    result->allocInfo.pMappedData = memory;
+
+    return result;
+}
+
+BufferHandle createExternalBuffer(
+    const ContextHandle& context,
+    uint64_t size,
+    VkBufferUsageFlags usage,
+    VkExternalMemoryHandleTypeFlagBits handleType,
+    const void* importInfo,
+    uint64_t allocationSize,
+    uint64_t offset)
+{
+    BufferHandle result{
+        new Buffer({0,0,{},0,nullptr,nullptr,size,usage,{},false,*context}),
+        destroyImportedBuffer
+    };
+    auto& fn = context->fnTable;
+
+    VkExternalMemoryBufferCreateInfo externalInfo{
+        .sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO,
+        .handleTypes = static_cast<VkExternalMemoryHandleTypeFlags>(handleType)
+    };
+    auto bufferInfo = getBufferCreateInfo(*context, size, usage);
+    bufferInfo.pNext = &externalInfo;
+    checkResult(fn.vkCreateBuffer(context->device, &bufferInfo, nullptr, &result->buffer));
+    VkMemoryRequirements requirements;
+    fn.vkGetBufferMemoryRequirements(context->device, result->buffer, &requirements);
+    if (offset % requirements.alignment != 0 || offset + requirements.size > allocationSize)
+        throw std::logic_error("Buffer is not contained within the imported memory!");
+
+    //exported memory is device local; fall back to any compatible type
+    const VkPhysicalDeviceMemoryProperties* memProps;
+    vmaGetMemoryProperties(context->allocator, &memProps);
+    auto type = memProps->memoryTypeCount;
+    for (uint32_t i = 0; i < memProps->memoryTypeCount; ++i) {
+        if (!(requirements.memoryTypeBits & (1u << i)))
+            continue;
+        if (type == memProps->memoryTypeCount)
+            type = i;
+        if (memProps->memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) {
+            type = i;
+            break;
+        }
+    }
+    if (type == memProps->memoryTypeCount)
+        throw std::runtime_error("The given memory cannot be imported!");
+
+    //exported tensors use dedicated allocations, which must be imported as
+    //such; only possible if the buffer spans the whole memory
+    VkMemoryDedicatedAllocateInfo dedicatedInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO,
+        .pNext = importInfo,
+        .buffer = result->buffer
+    };
+    auto dedicated = offset == 0 && requirements.size == allocationSize;
+    VkMemoryAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .pNext = dedicated ? static_cast<const void*>(&dedicatedInfo) : importInfo,
+        .allocationSize = allocationSize,
+        .memoryTypeIndex = type
+    };
+    checkResult(fn.vkAllocateMemory(
+        context->device, &allocInfo, nullptr, &result->allocInfo.deviceMemory));
+    checkResult(fn.vkBindBufferMemory(
+        context->device, result->buffer, result->allocInfo.deviceMemory, offset));
+    result->allocInfo.size = allocationSize;
+    result->allocInfo.offset = offset;
+
+    return result;
+}
+
 void destroyBuffer(Buffer* buffer) {
     if (!buffer)
         return;
-    vmaDestroyBuffer(buffer->context.allocator, buffer->buffer, buffer->allocation);
+
+    //work might still use the buffer -> let the context decide when
+    retireResource(buffer->context, [
+        &context = buffer->context,
+        vkBuffer = buffer->buffer,
+        allocation = buffer->allocation,
+        block = buffer->block,
+        virtualAllocation = buffer->virtualAllocation
+    ]() {
+        if (block) {
+            //give range back to the chunk, which lives until the context dies
+            std::lock_guard<std::mutex> lock(context.bufferPoolMutex);
+            vmaVirtualFree(block, virtualAllocation);
+        }
+        else {
+            vmaDestroyBuffer(context.allocator, vkBuffer, allocation);
+        }
+    });
+}
+
+void destroyBufferPools(const Context& context) {
+    for (auto& pool : context.bufferPools) {
+        for (auto& chunk : pool.chunks) {
+            vmaDestroyVirtualBlock(chunk.block);
+            chunk.buffer.reset();
+        }
+    }
+    context.bufferPools.clear();
 }
 
 ImageHandle createImage(
     const ContextHandle& context,
     VkFormat format,
     uint32_t width, uint32_t height, uint32_t depth,
-    VkImageUsageFlags usage)
+    VkImageUsageFlags usage,
+    uint32_t mipLevels,
+    uint32_t arrayLayers,
+    const VmaAllocationCreateInfo& allocInfo)
 {
     ImageHandle result{ new Image({ 0, 0, {}, *context}), destroyImage };
 
@@ -52,12 +416,16 @@ ImageHandle createImage(
     VkImageViewType viewType = VK_IMAGE_VIEW_TYPE_3D;
     if (depth == 1 && height == 1) {
         imageType = VK_IMAGE_TYPE_1D;
-        viewType = VK_IMAGE_VIEW_TYPE_1D;
+        viewType = arrayLayers ? VK_IMAGE_VIEW_TYPE_1D_ARRAY : VK_IMAGE_VIEW_TYPE_1D;
     }
     else if (depth == 1) {
         imageType = VK_IMAGE_TYPE_2D;
-        viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewType = arrayLayers ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
     }
+    else if (arrayLayers) {
+        throw std::logic_error("3D images cannot have array layers!");
+    }
+    auto layers = std::max(arrayLayers, 1u);
 
     //Create image
     VkImageCreateInfo imageInfo{
@@ -65,15 +433,17 @@ ImageHandle createImage(
         .imageType = imageType,
         .format = format,
         .extent = { width, height, depth },
-        .mipLevels = 1,
-        .arrayLayers = 1,
+        .mipLevels = mipLevels,
+        .arrayLayers = layers,
         .samples = VK_SAMPLE_COUNT_1_BIT,
         .tiling = VK_IMAGE_TILING_OPTIMAL,
         .usage = usage
     };
-    VmaAllocationCreateInfo allocInfo{
-        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE
-    };
+    if (context->queueFamilies.size() > 1) {
+        imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        imageInfo.queueFamilyIndexCount = static_cast<uint32_t>(context->queueFamilies.size());
+        imageInfo.pQueueFamilyIndices = context->queueFamilies.data();
+    }
     checkResult(vmaCreateImage(
         context->allocator, &imageInfo, &allocInfo,
         &result->image, &result->allocation, nullptr));
@@ -86,7 +456,7 @@ ImageHandle createImage(
         .format = format,
         .subresourceRange = {
             VK_IMAGE_ASPECT_COLOR_BIT,
-            0, 1, 0, 1
+            0, mipLevels, 0, layers
         }
     };
     checkResult(context->fnTable.vkCreateImageView(
@@ -99,10 +469,61 @@ void destroyImage(Image* image) {
     if (!image)
         return;
 
-    image->context.fnTable.vkDestroyImageView(
-        image->context.device, image->view, nullptr);
-    vmaDestroyImage(image->context.allocator,
-        image->image, image->allocation);
+    retireResource(image->context, [
+        &context = image->context,
+        vkImage = image->image,
+        view = image->view,
+        allocation = image->allocation
+    ]() {
+        context.fnTable.vkDestroyImageView(context.device, view, nullptr);
+        vmaDestroyImage(context.allocator, vkImage, allocation);
+    });
+}
+
+VkSampler acquireSampler(const Context& context, const VkSamplerCreateInfo& info) {
+    //pNext and flags are never used
+    SamplerKey key{
+        static_cast<uint32_t>(info.magFilter),
+        static_cast<uint32_t>(info.minFilter),
+        static_cast<uint32_t>(info.mipmapMode),
+        static_cast<uint32_t>(info.addressModeU),
+        static_cast<uint32_t>(info.addressModeV),
+        static_cast<uint32_t>(info.addressModeW),
+        std::bit_cast<uint32_t>(info.mipLodBias),
+        std::bit_cast<uint32_t>(info.minLod),
+        std::bit_cast<uint32_t>(info.maxLod),
+        info.unnormalizedCoordinates
+    };
+
+    std::lock_guard<std::mutex> lock(context.samplerMutex);
+    auto it = context.samplers.find(key);
+    if (it != context.samplers.end()) {
+        ++it->second.references;
+        return it->second.sampler;
+    }
+
+    VkSampler sampler;
+    checkResult(context.fnTable.vkCreateSampler(
+        context.device, &info, nullptr, &sampler));
+    context.samplers.emplace(key, SharedSampler{ sampler, 1 });
+    return sampler;
+}
+
+void releaseSampler(const Context& context, VkSampler sampler) {
+    //only a handful of configurations are usually in use
+    std::lock_guard<std::mutex> lock(context.samplerMutex);
+    auto it = std::find_if(context.samplers.begin(), context.samplers.end(),
+        [sampler](const auto& entry) { return entry.second.sampler == sampler; });
+    if (it == context.samplers.end() || --it->second.references > 0)
+        return;
+    context.fnTable.vkDestroySampler(context.device, sampler, nullptr);
+    context.samplers.erase(it);
+}
+
+void destroySamplers(const Context& context) {
+    for (auto& [key, shared] : context.samplers)
+        context.fnTable.vkDestroySampler(context.device, shared.sampler, nullptr);
+    context.samplers.clear();
 }
 
 }
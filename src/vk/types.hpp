@@ -1,8 +1,20 @@
 #pragma once
 
-#include <queue>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "volk.h"
@@ -16,38 +28,399 @@ namespace hephaistos::vulkan {
 struct Buffer {
     VkBuffer buffer;
     VmaAllocation allocation;
+    //pMappedData already includes the offset
     VmaAllocationInfo allocInfo;
+    //offset into buffer and allocation; only non zero if sub-allocated
+    VkDeviceSize offset;
+    //range within a pooled buffer; null if the buffer is dedicated
+    VmaVirtualBlock block;
+    VmaVirtualAllocation virtualAllocation;
+    //creation parameters needed to recreate the buffer after a move
+    VkDeviceSize size;
+    VkBufferUsageFlags usage;
+    //called after defragmentation moved the buffer; only buffers with a
+    //callback are allowed to be moved
+    std::function<void(const Buffer&)> relocated;
+    //true, if the memory can be exported to other APIs
+    bool exportable;
 
     const Context& context;
 };
 
+class HazardTracker;
+class CompletionService;
+class LayoutCache;
+
+//State bound by the last dispatch recorded into a command buffer, so
+//consecutive dispatches can skip binding it again
+struct BindState {
+    VkPipeline pipeline = nullptr;
+    //bound shader object; binding one unbinds the pipeline and vice versa
+    VkShaderEXT shader = nullptr;
+    VkPipelineLayout layout = nullptr;
+    //either a bound parameter set or pushed descriptors
+    VkDescriptorSet set = nullptr;
+    //bound descriptor buffer and offset of the set inside it, if
+    //parameter sets use VK_EXT_descriptor_buffer
+    VkDeviceAddress descriptorBuffer = 0;
+    VkDeviceSize descriptorOffset = ~VkDeviceSize(0);
+    std::shared_ptr<const std::vector<VkWriteDescriptorSet>> params;
+    std::vector<std::byte> push;
+};
+
 struct Command {
     VkCommandBuffer buffer;
     //specifies which stage the commands used so the semaphores
-    //can be more fine grained.
-    VkPipelineStageFlags stage;
+    //can be more fine grained. Uses synchronization2 flags, which
+    //are mapped to legacy ones if not available.
+    VkPipelineStageFlags2KHR stage;
+    //if not null, commands declare their accesses instead of
+    //recording conservative barriers
+    HazardTracker* tracker = nullptr;
+    //must be reset by anything disturbing the bound state,
+    //e.g. executing secondary command buffers
+    BindState bound = {};
+    //capabilities of the queue family the commands get submitted to.
+    //Barriers are restricted to the stages the family supports.
+    VkQueueFlags queueFlags = VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT;
 
     //const Context& context;
 };
 
+//Resources needed to record and submit a single one time submit.
+//Leased from the context so multiple threads can submit in parallel.
+struct OneTimeSubmitSlot {
+    VkCommandPool pool;
+    VkCommandBuffer buffer;
+    VkFence fence;
+};
+
+//Secondary command buffer recorded into its own pool, so multiple parts of
+//a subroutine can be recorded on different threads
+struct SubroutinePart {
+    VkCommandPool pool;
+    Command cmd;
+};
+//primary command buffer of a subroutine; owns its pool, so subroutines can
+//be recorded and destroyed on different threads without locking
+struct SubroutineBuffer {
+    VkCommandPool pool;
+    Command cmd;
+};
+
+constexpr size_t QueueTypeCount = 3;
+
+struct Timeline {
+    VkSemaphore semaphore;
+    //if true, semaphore is returned to the context's pool instead of destroyed
+    bool pooled = false;
+    //true, if the semaphore can be exported to other APIs
+    bool exportable = false;
+};
+
+//Command pools and buffers of submitted sequences, which can be recycled
+//once the semaphore reaches the given value
+struct RetiredSequence {
+    VkSemaphore semaphore;
+    uint64_t value;
+    //unused ones are null
+    std::array<VkCommandPool, QueueTypeCount> pools;
+    std::array<std::vector<VkCommandBuffer>, QueueTypeCount> commands;
+    //timeline only used by this work; released once it finished
+    std::unique_ptr<Timeline> timeline;
+};
+
+//Vulkan objects of a destroyed resource, which get destroyed once all work
+//submitted before finished, i.e. each semaphore reached the given value
+struct RetiredResource {
+    std::vector<std::pair<VkSemaphore, uint64_t>> signals;
+    std::function<void()> destroy;
+};
+
+//Shared buffer small tensors of the same usage are sub-allocated from
+struct BufferChunk {
+    BufferHandle buffer;
+    VmaVirtualBlock block;
+};
+struct BufferPool {
+    VkBufferUsageFlags usage;
+    VmaAllocationCreateFlags flags;
+    //alignment of sub-allocations satisfying all possible usages
+    VkDeviceSize alignment;
+    std::vector<BufferChunk> chunks;
+};
+
+//Sampler shared by all textures with the same configuration
+struct SharedSampler {
+    VkSampler sampler;
+    //number of textures using it; destroyed once it drops to zero
+    uint32_t references;
+};
+//Fields of a sampler create info identifying a shared sampler
+using SamplerKey = std::array<uint32_t, 10>;
+
+//Persistently mapped host memory for staging transfers of tensors not
+//accessible by the host. Ranges are handed out in order, but may be
+//released out of order.
+struct StagingRing {
+    BufferHandle buffer;
+    VkDeviceSize size;
+    //alignment of ranges, so flushing one does not touch its neighbours
+    VkDeviceSize alignment;
+    struct Range {
+        VkDeviceSize begin;
+        VkDeviceSize end;
+        bool released;
+    };
+    //ranges in use in the order they were handed out
+    std::deque<Range> ranges;
+    //notified whenever a range got released
+    std::condition_variable released;
+};
+
+//Device memory shared by acceleration structure builds. Grows to the largest
+//build seen so far and is handed out to a single build at a time.
+struct ScratchArena {
+    BufferHandle buffer;
+    VkDeviceSize size;
+    VkDeviceAddress address;
+    //minAccelerationStructureScratchOffsetAlignment
+    VkDeviceSize alignment;
+};
+
+//Host event recorded while tracing; names are string literals
+struct TraceRecord {
+    const char* name;
+    const char* category;
+    //index of the recording thread starting at 1
+    uint32_t thread;
+    //steady clock in nanoseconds
+    uint64_t start;
+    //zero for instant events
+    uint64_t duration;
+};
+struct TraceLog {
+    std::vector<TraceRecord> records;
+    std::vector<std::thread::id> threads;
+    //steady clock in nanoseconds when tracing started
+    uint64_t start;
+    //offset converting device timestamps into steady clock nanoseconds
+    double deviceOffset;
+};
+
+//Live resource recorded while resource tracking is enabled
+struct ResourceRecord {
+    //string literal; "Resource" until the derived class reports itself
+    const char* type;
+    uint64_t size;
+    std::string tag;
+    //creation order
+    uint64_t id;
+};
+
+//Counters reported by getContextStatistics(). Only ever increased using
+//relaxed atomics, see count() in vk/util.hpp
+struct Counters {
+    std::atomic<uint64_t> submissions = 0;
+    std::atomic<uint64_t> commandBuffers = 0;
+    std::atomic<uint64_t> oneTimeSubmits = 0;
+    std::atomic<uint64_t> bytesUploaded = 0;
+    std::atomic<uint64_t> bytesDownloaded = 0;
+    std::atomic<uint64_t> dispatches = 0;
+    std::atomic<uint64_t> barriers = 0;
+    std::atomic<uint64_t> pipelineCacheHits = 0;
+    std::atomic<uint64_t> pipelineCacheMisses = 0;
+};
+
+//Offset converting device timestamps in nanoseconds into the steady clock
+struct ClockCalibration {
+    double offset;
+    //maximum deviation in nanoseconds
+    double deviation;
+};
+
+struct Queue {
+    VkQueue queue;
+    uint32_t family;
+    //capabilities of the family, e.g. transfer only for DMA engines
+    VkQueueFlags flags;
+    //queues are externally synchronized -> guard every submit
+    //aliased queues share the same mutex
+    std::mutex* mutex;
+};
+
 struct Context {
     VkPhysicalDevice physicalDevice;
     VkDevice device;
     VkQueue queue;
     VkPipelineCache cache;
+    //file the pipeline cache is written to on destruction; empty if none
+    //guarded by cacheMutex together with merging and reading the cache
+    mutable std::mutex cacheMutex;
+    std::filesystem::path cacheFile;
+
+    //primary context owning device, allocator and pipeline cache if this is
+    //a shared one, i.e. created via createSharedContext(); empty otherwise
+    ContextHandle parent;
 
     //List of enabled hephaistos extensions (not vulkan!)
-    std::vector<ExtensionHandle> extensions;
+    //shared contexts reference the ones of their primary context
+    std::shared_ptr<std::vector<ExtensionHandle>> extensions =
+        std::make_shared<std::vector<ExtensionHandle>>();
+    //true, if VK_KHR_synchronization2 is enabled
+    bool synchronization2 = false;
+    //true, if VK_EXT_memory_budget is enabled
+    bool memoryBudget = false;
+    //true, if VK_EXT_memory_priority is enabled
+    bool memoryPriority = false;
+    //true, if VK_EXT_subgroup_size_control is enabled
+    bool subgroupSizeControl = false;
+    //true, if programs can require full subgroups
+    bool computeFullSubgroups = false;
+    //true, if device local memory is host visible without any size
+    //restriction, i.e. the device is integrated or has resizable BAR
+    bool unifiedMemory = false;
+    //alignment of imported host memory; zero if VK_EXT_external_memory_host
+    //is not enabled
+    VkDeviceSize hostImportAlignment = 0;
+    //NUMA node the device is attached to; -1 if unknown
+    int32_t numaNode = -1;
+    //true, if sparse buffers can be bound on the main queue
+    bool sparseBinding = false;
+    //true, if partially bound sparse buffers can be used
+    bool sparseResidency = false;
+    //true, if partially bound sparse 3D images can be used
+    bool sparseTexture = false;
+    //true, if pipeline statistics can be queried
+    bool pipelineStatistics = false;
+    //true, if VK_KHR_calibrated_timestamps or its EXT variant is enabled
+    //and supports the host's steady clock
+    bool calibratedTimestamps = false;
+    //true, if the instance enabled VK_EXT_debug_utils, i.e. commands can
+    //be labeled and objects named
+    bool debugUtils = false;
+    //true, if VK_EXT_pipeline_creation_feedback is enabled, i.e. pipeline
+    //cache hits can be counted
+    bool pipelineCreationFeedback = false;
+    //true, if VK_KHR_pipeline_executable_properties is enabled, i.e. pipelines
+    //capture the driver's statistics
+    bool pipelineExecutableInfo = false;
+    //true, if robustBufferAccess was requested via DebugOptions and enabled
+    bool robustBufferAccess = false;
+    //true, if VK_EXT_pipeline_robustness is enabled, i.e. programs can
+    //override the robustness of the device
+    bool pipelineRobustness = false;
+    //true, if array bindings may be partially bound
+    bool partiallyBound = false;
+    //true, if VK_KHR_shader_float_controls2 is enabled, i.e. programs can
+    //set the default fast math mode
+    bool floatControls2 = false;
+    //true, if the Vulkan memory model is enabled, i.e. programs can use
+    //scoped atomics and barriers of GL_KHR_memory_scope_semantics
+    bool vulkanMemoryModel = false;
+    //true, if the Vulkan memory model supports device scope
+    bool memoryModelDeviceScope = false;
+    //true, if the Vulkan memory model supports availability and visibility
+    //operations in chains
+    bool memoryModelAvailabilityVisibilityChains = false;
+    //global priority of all queues; MEDIUM is the driver's default
+    QueuePriority queuePriority = QueuePriority::MEDIUM;
+    //maximum amount of groups in a single dispatch per dimension
+    std::array<uint32_t, 3> maxWorkGroupCount = { 65535, 65535, 65535 };
 
     uint32_t queueFamily;
-    VkCommandPool subroutinePool;
-    VkCommandPool oneTimeSubmitPool;
-    VkCommandBuffer oneTimeSubmitBuffer;
-    VkFence oneTimeSubmitFence;
+
+    //queues indexed by QueueType; missing ones alias the main queue
+    //shared contexts use the queues and mutexes of their primary context
+    std::array<Queue, QueueTypeCount> queues;
+    mutable std::array<std::mutex, QueueTypeCount> queueMutexes;
+    //distinct families of all queues
+    //if more than one, resources are shared concurrently between them
+    std::vector<uint32_t> queueFamilies;
+
+    //free lists of one time submit slots per queue type as they might
+    //differ in family; grow on demand
+    mutable std::mutex oneTimeSubmitMutex;
+    mutable std::array<std::vector<OneTimeSubmitSlot>, QueueTypeCount> oneTimeSubmitSlots;
 
     //looks like a hack, but this is the only one we need to change
     //would be a bit drastic to remove const Context because of this
-    mutable std::queue<VkCommandPool> sequencePool;
+    //free pools per queue type as they might differ in family; bounded
+    //and guarded by sequencePoolMutex together with the retired sequences
+    mutable std::mutex sequencePoolMutex;
+    mutable std::array<std::vector<VkCommandPool>, QueueTypeCount> sequencePools;
+    mutable std::vector<RetiredSequence> retiredSequences;
+    //free list of timeline semaphores used by async submits and as
+    //implicit timelines of sequences
+    mutable std::mutex timelinePoolMutex;
+    mutable std::vector<VkSemaphore> timelinePool;
+    //pools small tensors get sub-allocated from if their size does not
+    //exceed the threshold; zero disables pooling
+    mutable std::mutex bufferPoolMutex;
+    mutable std::vector<BufferPool> bufferPools;
+    uint64_t bufferPoolThreshold = 0;
+    //if true, tensors are always mapped on devices with unified memory
+    bool tensorAutoMapping = false;
+    //if true, tensors allocate their memory on first use
+    bool tensorLazyAllocation = false;
+    //staging memory for tensors not accessible by the host; created on
+    //first use
+    mutable std::mutex stagingMutex;
+    mutable std::unique_ptr<StagingRing> stagingRing;
+    //scratch memory for acceleration structure builds; created on first use
+    mutable std::mutex scratchMutex;
+    mutable std::unique_ptr<ScratchArena> scratchArena;
+    //pool for tensors exportable to other APIs; created on first use and
+    //guarded by bufferPoolMutex. Export info must outlive the pool.
+    mutable VmaPool exportPool = nullptr;
+    mutable VkExportMemoryAllocateInfo exportInfo;
+    //runs host callbacks on timeline values; created on first use
+    mutable std::mutex completionMutex;
+    mutable std::unique_ptr<CompletionService> completionService;
+    //reflections and layouts shared between programs
+    mutable std::unique_ptr<LayoutCache> layoutCache;
+    //host events are only recorded while tracing is set; the log is
+    //guarded by traceMutex
+    mutable std::atomic<bool> tracing = false;
+    mutable std::mutex traceMutex;
+    mutable std::unique_ptr<TraceLog> traceLog;
+    //latest correlation between device timestamps and the steady clock
+    mutable std::mutex clockMutex;
+    mutable std::optional<ClockCalibration> clockCalibration;
+    //samplers shared between textures; drivers may limit their total count
+    mutable std::mutex samplerMutex;
+    mutable std::map<SamplerKey, SharedSampler> samplers;
+    //live resources are only recorded while resourceTracking is set;
+    //records are guarded by resourceMutex
+    std::atomic<bool> resourceTracking = false;
+    mutable std::mutex resourceMutex;
+    mutable std::unordered_map<const Resource*, ResourceRecord> resources;
+    mutable uint64_t nextResourceId = 0;
+    //if set, destruction of resources is deferred until the work submitted
+    //before finished; the retired resources are guarded by retireMutex
+    //together with the latest value submitted to signal per semaphore
+    mutable std::atomic<bool> deferredDestruction = false;
+    mutable std::mutex retireMutex;
+    mutable std::unordered_map<VkSemaphore, uint64_t> signaledValues;
+    mutable std::vector<RetiredResource> retiredResources;
+    //nanoseconds waits poll before blocking; zero blocks right away
+    std::atomic<uint64_t> waitSpinTime = 0;
+    //robustness of programs created afterwards; DEFAULT follows the device
+    std::atomic<BufferRobustness> programRobustness = BufferRobustness::DEFAULT;
+    //if set, programs created afterwards bind cached descriptor sets
+    //instead of pushing descriptors
+    std::atomic<bool> descriptorSetCache = false;
+    //maximum amount of submissions in flight; zero if unlimited. Submissions
+    //issued while a limit is set take a slot until their work finished
+    uint32_t submissionLimit = 0;
+    mutable uint32_t submissionsInFlight = 0;
+    mutable std::mutex submissionMutex;
+    mutable std::condition_variable submissionCondition;
+    //bumped whenever a resource gets destroyed or replaced; caches keyed by
+    //handles are dropped on change as handles may get reused
+    mutable std::atomic<uint64_t> resourceGeneration = 0;
+    //work issued on the context
+    mutable Counters counters;
 
     VmaAllocator allocator;
 
@@ -67,25 +440,88 @@ struct Image {
     const Context& context;
 };
 
-struct Timeline {
-    VkSemaphore semaphore;
-};
-
+//Create info for buffers on the given context, i.e. shared between all
+//queue families in use
+[[nodiscard]] VkBufferCreateInfo getBufferCreateInfo(
+    const Context& context, uint64_t size, VkBufferUsageFlags usage);
 [[nodiscard]] BufferHandle createBuffer(
     const ContextHandle& handle,
     uint64_t size,
     VkBufferUsageFlags usage,
     VmaAllocationCreateFlags flags);
+//Creates a dedicated buffer using the given allocation info
+[[nodiscard]] BufferHandle createBuffer(
+    const ContextHandle& handle,
+    uint64_t size,
+    VkBufferUsageFlags usage,
+    const VmaAllocationCreateInfo& allocInfo);
+//Translates allocation hints into an allocation info; usage is used for
+//MemoryPlacement::AUTO
+[[nodiscard]] VmaAllocationCreateInfo getAllocationCreateInfo(
+    const Context& context,
+    const AllocationHints& hints,
+    VmaAllocationCreateFlags flags,
+    VmaMemoryUsage usage);
+//Alignment of offsets into buffers shared by multiple tensors
+[[nodiscard]] VkDeviceSize getBufferOffsetAlignment(const Context& context);
+//Sub-allocates the buffer from a shared one of the context's pools if
+//pooling is enabled and the size does not exceed its threshold. Otherwise
+//creates a dedicated one like createBuffer().
+[[nodiscard]] BufferHandle createPooledBuffer(
+    const ContextHandle& handle,
+    uint64_t size,
+    VkBufferUsageFlags usage,
+    VmaAllocationCreateFlags flags);
+//Creates a persistently mapped buffer for storing descriptors using
+//VK_EXT_descriptor_buffer. Small ones share the same buffer.
+[[nodiscard]] BufferHandle createDescriptorBuffer(
+    const ContextHandle& handle, uint64_t size);
+//Creates a buffer backed by the given host memory using
+//VK_EXT_external_memory_host. The memory is not owned by the buffer.
+[[nodiscard]] BufferHandle createImportedBuffer(
+    const ContextHandle& handle,
+    void* memory,
+    uint64_t size,
+    VkBufferUsageFlags usage);
+//Creates a buffer bound to memory exported by another process or API. The
+//handle specific import info gets chained to the allocation. Binds the
+//buffer at the given offset into the imported memory.
+[[nodiscard]] BufferHandle createExternalBuffer(
+    const ContextHandle& handle,
+    uint64_t size,
+    VkBufferUsageFlags usage,
+    VkExternalMemoryHandleTypeFlagBits handleType,
+    const void* importInfo,
+    uint64_t allocationSize,
+    uint64_t offset);
 void destroyBuffer(Buffer* buffer);
 [[nodiscard]] inline BufferHandle createEmptyBuffer() {
     return { nullptr, destroyBuffer };
 }
+//Destroys all pooled buffers. Only called during context destruction.
+void destroyBufferPools(const Context& context);
 
+//Creates an image with a view spanning all mip levels and layers.
+//Zero array layers creates a plain image, otherwise a 1D or 2D array.
 [[nodiscard]] ImageHandle createImage(
     const ContextHandle& context,
     VkFormat format,
     uint32_t width, uint32_t height, uint32_t depth,
-    VkImageUsageFlags usage);
+    VkImageUsageFlags usage,
+    uint32_t mipLevels = 1,
+    uint32_t arrayLayers = 0,
+    const VmaAllocationCreateInfo& allocInfo = {
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE
+    });
 void destroyImage(Image* image);
 
+//Returns a sampler matching the create info, which is shared with all other
+//users requesting the same configuration. Must be returned via releaseSampler.
+[[nodiscard]] VkSampler acquireSampler(
+    const Context& context, const VkSamplerCreateInfo& info);
+//Returns a sampler previously acquired, destroying it if no longer used
+void releaseSampler(const Context& context, VkSampler sampler);
+//Destroys all remaining samplers. Only called during context destruction.
+void destroySamplers(const Context& context);
+
 }
@@ -0,0 +1,1240 @@
+#include "vk/util.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+#include "vk/completion.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+namespace hephaistos::vulkan {
+
+namespace {
+
+//remembers the values submitted work signals, so retired resources can wait
+//on all work submitted before them; only needed while destruction is deferred
+void recordSignals(const Context& context,
+    const void* pNext, uint32_t count, const VkSemaphore* pSemaphores)
+{
+    if (!context.deferredDestruction)
+        return;
+
+    //legacy submits pass the values of timelines via the pNext chain
+    auto next = static_cast<const VkBaseInStructure*>(pNext);
+    while (next && next->sType != VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO)
+        next = next->pNext;
+    if (!next)
+        return;
+    auto info = reinterpret_cast<const VkTimelineSemaphoreSubmitInfo*>(next);
+    count = std::min(count, info->signalSemaphoreValueCount);
+
+    std::lock_guard<std::mutex> lock(context.retireMutex);
+    for (auto i = 0u; i < count; ++i) {
+        auto& value = context.signaledValues[pSemaphores[i]];
+        value = std::max(value, info->pSignalSemaphoreValues[i]);
+    }
+}
+void recordSignals(const Context& context, const VkSubmitInfo2KHR& info) {
+    if (!context.deferredDestruction || info.signalSemaphoreInfoCount == 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(context.retireMutex);
+    for (auto i = 0u; i < info.signalSemaphoreInfoCount; ++i) {
+        auto& signal = info.pSignalSemaphoreInfos[i];
+        auto& value = context.signaledValues[signal.semaphore];
+        value = std::max(value, signal.value);
+    }
+}
+
+}
+
+void queueSubmit(const Context& context,
+    uint32_t count, const VkSubmitInfo* pSubmits, VkFence fence)
+{
+    queueSubmit(context, QueueType::MAIN, count, pSubmits, fence);
+}
+void queueSubmit(const Context& context, QueueType type,
+    uint32_t count, const VkSubmitInfo* pSubmits, VkFence fence)
+{
+    auto& queue = context.queues[static_cast<size_t>(type)];
+    {
+        std::lock_guard<std::mutex> lock(*queue.mutex);
+        checkResult(context.fnTable.vkQueueSubmit(
+            queue.queue, count, pSubmits, fence));
+    }
+
+    uint64_t buffers = 0;
+    for (auto i = 0u; i < count; ++i) {
+        buffers += pSubmits[i].commandBufferCount;
+        recordSignals(context, pSubmits[i].pNext,
+            pSubmits[i].signalSemaphoreCount, pSubmits[i].pSignalSemaphores);
+    }
+    vulkan::count(context.counters.submissions, count);
+    vulkan::count(context.counters.commandBuffers, buffers);
+}
+
+void queueSubmit2(const Context& context, QueueType type,
+    uint32_t count, const VkSubmitInfo2KHR* pSubmits, VkFence fence)
+{
+    auto& queue = context.queues[static_cast<size_t>(type)];
+    {
+        std::lock_guard<std::mutex> lock(*queue.mutex);
+        checkResult(context.fnTable.vkQueueSubmit2KHR(
+            queue.queue, count, pSubmits, fence));
+    }
+
+    uint64_t buffers = 0;
+    for (auto i = 0u; i < count; ++i) {
+        buffers += pSubmits[i].commandBufferInfoCount;
+        recordSignals(context, pSubmits[i]);
+    }
+    vulkan::count(context.counters.submissions, count);
+    vulkan::count(context.counters.commandBuffers, buffers);
+}
+
+void queueBindSparse(const Context& context,
+    uint32_t count, const VkBindSparseInfo* pInfos, VkFence fence)
+{
+    auto& queue = context.queues[static_cast<size_t>(QueueType::MAIN)];
+    {
+        std::lock_guard<std::mutex> lock(*queue.mutex);
+        checkResult(context.fnTable.vkQueueBindSparse(
+            queue.queue, count, pInfos, fence));
+    }
+
+    for (auto i = 0u; i < count; ++i) {
+        recordSignals(context, pInfos[i].pNext,
+            pInfos[i].signalSemaphoreCount, pInfos[i].pSignalSemaphores);
+    }
+}
+
+void bindSparseSync(const Context& context, const VkBindSparseInfo& info) {
+    VkFenceCreateInfo fenceInfo{ .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+    VkFence fence;
+    checkResult(context.fnTable.vkCreateFence(
+        context.device, &fenceInfo, nullptr, &fence));
+    try {
+        queueBindSparse(context, 1, &info, fence);
+    }
+    catch (...) {
+        context.fnTable.vkDestroyFence(context.device, fence, nullptr);
+        throw;
+    }
+    auto result = context.fnTable.vkWaitForFences(
+        context.device, 1, &fence, VK_TRUE, UINT64_MAX);
+    context.fnTable.vkDestroyFence(context.device, fence, nullptr);
+    checkResult(result);
+}
+
+void pipelineBarrier(const Context& context, VkCommandBuffer cmd,
+    std::span<const BufferBarrier> barriers,
+    std::span<const GlobalBarrier> globalBarriers,
+    std::span<const ImageBarrier> imageBarriers)
+{
+    count(context.counters.barriers);
+    if (context.synchronization2) {
+        std::vector<VkBufferMemoryBarrier2KHR> infos(barriers.size());
+        std::transform(barriers.begin(), barriers.end(), infos.begin(),
+            [](const BufferBarrier& barrier) {
+                return VkBufferMemoryBarrier2KHR{
+                    .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR,
+                    .srcStageMask = barrier.srcStage,
+                    .srcAccessMask = barrier.srcAccess,
+                    .dstStageMask = barrier.dstStage,
+                    .dstAccessMask = barrier.dstAccess,
+                    .buffer = barrier.buffer,
+                    .offset = barrier.offset,
+                    .size = barrier.size
+                };
+            });
+        std::vector<VkMemoryBarrier2KHR> globalInfos(globalBarriers.size());
+        std::transform(globalBarriers.begin(), globalBarriers.end(), globalInfos.begin(),
+            [](const GlobalBarrier& barrier) {
+                return VkMemoryBarrier2KHR{
+                    .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR,
+                    .srcStageMask = barrier.srcStage,
+                    .srcAccessMask = barrier.srcAccess,
+                    .dstStageMask = barrier.dstStage,
+                    .dstAccessMask = barrier.dstAccess
+                };
+            });
+        std::vector<VkImageMemoryBarrier2KHR> imageInfos(imageBarriers.size());
+        std::transform(imageBarriers.begin(), imageBarriers.end(), imageInfos.begin(),
+            [](const ImageBarrier& barrier) {
+                return VkImageMemoryBarrier2KHR{
+                    .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR,
+                    .srcStageMask = barrier.srcStage,
+                    .srcAccessMask = barrier.srcAccess,
+                    .dstStageMask = barrier.dstStage,
+                    .dstAccessMask = barrier.dstAccess,
+                    .oldLayout = barrier.oldLayout,
+                    .newLayout = barrier.newLayout,
+                    .image = barrier.image,
+                    .subresourceRange = {
+                        VK_IMAGE_ASPECT_COLOR_BIT,
+                        barrier.baseMipLevel, barrier.levelCount, 0, VK_REMAINING_ARRAY_LAYERS
+                    }
+                };
+            });
+        VkDependencyInfoKHR dependency{
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR,
+            .dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT,
+            .memoryBarrierCount = static_cast<uint32_t>(globalInfos.size()),
+            .pMemoryBarriers = globalInfos.data(),
+            .bufferMemoryBarrierCount = static_cast<uint32_t>(infos.size()),
+            .pBufferMemoryBarriers = infos.data(),
+            .imageMemoryBarrierCount = static_cast<uint32_t>(imageInfos.size()),
+            .pImageMemoryBarriers = imageInfos.data()
+        };
+        context.fnTable.vkCmdPipelineBarrier2KHR(cmd, &dependency);
+    }
+    else {
+        //legacy barriers share stages -> combine them
+        VkPipelineStageFlags srcStage = 0, dstStage = 0;
+        std::vector<VkBufferMemoryBarrier> infos(barriers.size());
+        std::transform(barriers.begin(), barriers.end(), infos.begin(),
+            [&srcStage, &dstStage](const BufferBarrier& barrier) {
+                srcStage |= toLegacyStage(barrier.srcStage);
+                dstStage |= toLegacyStage(barrier.dstStage);
+                return VkBufferMemoryBarrier{
+                    .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                    .srcAccessMask = toLegacyAccess(barrier.srcAccess),
+                    .dstAccessMask = toLegacyAccess(barrier.dstAccess),
+                    .buffer = barrier.buffer,
+                    .offset = barrier.offset,
+                    .size = barrier.size
+                };
+            });
+        std::vector<VkMemoryBarrier> globalInfos(globalBarriers.size());
+        std::transform(globalBarriers.begin(), globalBarriers.end(), globalInfos.begin(),
+            [&srcStage, &dstStage](const GlobalBarrier& barrier) {
+                srcStage |= toLegacyStage(barrier.srcStage);
+                dstStage |= toLegacyStage(barrier.dstStage);
+                return VkMemoryBarrier{
+                    .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                    .srcAccessMask = toLegacyAccess(barrier.srcAccess),
+                    .dstAccessMask = toLegacyAccess(barrier.dstAccess)
+                };
+            });
+        std::vector<VkImageMemoryBarrier> imageInfos(imageBarriers.size());
+        std::transform(imageBarriers.begin(), imageBarriers.end(), imageInfos.begin(),
+            [&srcStage, &dstStage](const ImageBarrier& barrier) {
+                srcStage |= toLegacyStage(barrier.srcStage);
+                dstStage |= toLegacyStage(barrier.dstStage);
+                return VkImageMemoryBarrier{
+                    .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                    .srcAccessMask = toLegacyAccess(barrier.srcAccess),
+                    .dstAccessMask = toLegacyAccess(barrier.dstAccess),
+                    .oldLayout = barrier.oldLayout,
+                    .newLayout = barrier.newLayout,
+                    .image = barrier.image,
+                    .subresourceRange = {
+                        VK_IMAGE_ASPECT_COLOR_BIT,
+                        barrier.baseMipLevel, barrier.levelCount, 0, VK_REMAINING_ARRAY_LAYERS
+                    }
+                };
+            });
+        //legacy barriers do not allow empty stages
+        if (!srcStage)
+            srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        if (!dstStage)
+            dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        context.fnTable.vkCmdPipelineBarrier(cmd,
+            srcStage, dstStage,
+            VK_DEPENDENCY_BY_REGION_BIT,
+            static_cast<uint32_t>(globalInfos.size()), globalInfos.data(),
+            static_cast<uint32_t>(infos.size()), infos.data(),
+            static_cast<uint32_t>(imageInfos.size()), imageInfos.data());
+    }
+}
+
+namespace {
+
+//stages and accesses available on transfer only queue families
+constexpr VkPipelineStageFlags2KHR TransferOnlyStages =
+    VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT_KHR |
+    VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT_KHR |
+    VK_PIPELINE_STAGE_2_HOST_BIT_KHR |
+    VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR |
+    VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT_KHR |
+    VK_PIPELINE_STAGE_2_COPY_BIT_KHR |
+    VK_PIPELINE_STAGE_2_RESOLVE_BIT_KHR |
+    VK_PIPELINE_STAGE_2_BLIT_BIT_KHR |
+    VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR;
+constexpr VkAccessFlags2KHR TransferOnlyAccess =
+    VK_ACCESS_2_TRANSFER_READ_BIT_KHR |
+    VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR |
+    VK_ACCESS_2_HOST_READ_BIT_KHR |
+    VK_ACCESS_2_HOST_WRITE_BIT_KHR |
+    VK_ACCESS_2_MEMORY_READ_BIT_KHR |
+    VK_ACCESS_2_MEMORY_WRITE_BIT_KHR;
+
+template<class T>
+T restrictBarrier(T barrier) {
+    barrier.srcStage &= TransferOnlyStages;
+    barrier.dstStage &= TransferOnlyStages;
+    //accesses without any stage left are invalid
+    barrier.srcAccess = barrier.srcStage ? barrier.srcAccess & TransferOnlyAccess : 0;
+    barrier.dstAccess = barrier.dstStage ? barrier.dstAccess & TransferOnlyAccess : 0;
+    return barrier;
+}
+
+template<class T>
+std::vector<T> restrictBarriers(std::span<const T> barriers) {
+    std::vector<T> result(barriers.size());
+    std::transform(barriers.begin(), barriers.end(), result.begin(), restrictBarrier<T>);
+    return result;
+}
+
+}
+
+void pipelineBarrier(const Context& context, const Command& cmd,
+    std::span<const BufferBarrier> barriers,
+    std::span<const GlobalBarrier> globalBarriers,
+    std::span<const ImageBarrier> imageBarriers)
+{
+    //families supporting compute know every stage we use
+    if (cmd.queueFlags & (VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT)) {
+        pipelineBarrier(context, cmd.buffer, barriers, globalBarriers, imageBarriers);
+        return;
+    }
+
+    auto restricted = restrictBarriers(barriers);
+    auto restrictedGlobal = restrictBarriers(globalBarriers);
+    auto restrictedImages = restrictBarriers(imageBarriers);
+    pipelineBarrier(context, cmd.buffer, restricted, restrictedGlobal, restrictedImages);
+}
+
+namespace {
+
+//upper limit of free pools kept per queue type
+constexpr size_t MaxSequencePools = 16;
+//number of most recently used free pools keeping their memory
+//older ones get trimmed to give their memory back
+constexpr size_t WarmSequencePools = 4;
+
+bool isFinished(const Context& context, const RetiredSequence& sequence) {
+    uint64_t value;
+    auto result = context.fnTable.vkGetSemaphoreCounterValue(
+        context.device, sequence.semaphore, &value);
+    //on error we cannot know -> keep it pending
+    return result == VK_SUCCESS && value >= sequence.value;
+}
+
+void recycle(const Context& context, RetiredSequence& sequence) {
+    for (auto i = 0u; i < QueueTypeCount; ++i) {
+        if (sequence.pools[i]) {
+            returnSequencePool(context, static_cast<QueueType>(i),
+                sequence.pools[i], sequence.commands[i]);
+        }
+    }
+    if (sequence.timeline) {
+        if (sequence.timeline->pooled) {
+            std::lock_guard<std::mutex> lock(context.timelinePoolMutex);
+            context.timelinePool.push_back(sequence.timeline->semaphore);
+        }
+        else {
+            removeCompletions(context, sequence.timeline->semaphore);
+            forgetSignals(context, sequence.timeline->semaphore);
+            context.fnTable.vkDestroySemaphore(
+                context.device, sequence.timeline->semaphore, nullptr);
+        }
+    }
+}
+
+}
+
+VkCommandPool fetchSequencePool(const Context& context, QueueType type) {
+    //lazily recycle finished work
+    reclaimSequences(context);
+    if (context.deferredDestruction)
+        collectRetiredResources(context);
+
+    //reuse the most recently returned pool as it is likely still warm
+    {
+        std::lock_guard<std::mutex> lock(context.sequencePoolMutex);
+        auto& pools = context.sequencePools[static_cast<size_t>(type)];
+        if (!pools.empty()) {
+            auto pool = pools.back();
+            pools.pop_back();
+            return pool;
+        }
+    }
+
+    //none available -> create new
+    VkCommandPool pool;
+    VkCommandPoolCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .queueFamilyIndex = context.queues[static_cast<size_t>(type)].family
+    };
+    checkResult(context.fnTable.vkCreateCommandPool(
+        context.device, &info, nullptr, &pool));
+    return pool;
+}
+
+void returnSequencePool(const Context& context, QueueType type,
+    VkCommandPool pool, const std::vector<VkCommandBuffer>& commands)
+{
+    //free command buffers
+    if (!commands.empty()) {
+        context.fnTable.vkFreeCommandBuffers(
+            context.device, pool,
+            static_cast<uint32_t>(commands.size()),
+            commands.data());
+    }
+    //reset pool but keep its memory for the next sequence
+    context.fnTable.vkResetCommandPool(context.device, pool, 0);
+
+    {
+        std::lock_guard<std::mutex> lock(context.sequencePoolMutex);
+        auto& pools = context.sequencePools[static_cast<size_t>(type)];
+        if (pools.size() < MaxSequencePools) {
+            pools.push_back(pool);
+            //pool falling out of the warm ones gives its memory back
+            if (pools.size() > WarmSequencePools) {
+                context.fnTable.vkTrimCommandPool(context.device,
+                    pools[pools.size() - WarmSequencePools - 1], 0);
+            }
+            return;
+        }
+    }
+    //enough pools around -> destroy it
+    context.fnTable.vkDestroyCommandPool(context.device, pool, nullptr);
+}
+
+void retireSequence(const Context& context, RetiredSequence sequence) {
+    //already done? -> recycle right away
+    if (isFinished(context, sequence)) {
+        recycle(context, sequence);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(context.sequencePoolMutex);
+    context.retiredSequences.push_back(std::move(sequence));
+}
+
+void reclaimSequences(const Context& context, VkSemaphore semaphore) {
+    //collect sequences to recycle while holding the lock...
+    std::vector<RetiredSequence> finished;
+    {
+        std::lock_guard<std::mutex> lock(context.sequencePoolMutex);
+        auto& retired = context.retiredSequences;
+        if (retired.empty())
+            return;
+
+        auto it = std::stable_partition(retired.begin(), retired.end(),
+            [&context, semaphore](const RetiredSequence& sequence) {
+                if (semaphore)
+                    return sequence.semaphore != semaphore;
+                else
+                    return !isFinished(context, sequence);
+            });
+        finished.insert(finished.end(),
+            std::make_move_iterator(it), std::make_move_iterator(retired.end()));
+        retired.erase(it, retired.end());
+    }
+
+    //...but recycle them without it
+    for (auto& sequence : finished) {
+        if (semaphore) {
+            VkSemaphoreWaitInfo info{
+                .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+                .semaphoreCount = 1,
+                .pSemaphores = &sequence.semaphore,
+                .pValues = &sequence.value
+            };
+            context.fnTable.vkWaitSemaphores(context.device, &info, UINT64_MAX);
+        }
+        recycle(context, sequence);
+    }
+}
+
+void retireResource(const Context& context, std::function<void()> destroy) {
+    if (!context.deferredDestruction) {
+        destroy();
+        return;
+    }
+
+    //lazily destroy finished ones first, which also drops reached signals
+    collectRetiredResources(context);
+    {
+        std::lock_guard<std::mutex> lock(context.retireMutex);
+        if (!context.signaledValues.empty()) {
+            context.retiredResources.push_back({
+                .signals = { context.signaledValues.begin(), context.signaledValues.end() },
+                .destroy = std::move(destroy)
+            });
+            return;
+        }
+    }
+    //nothing in flight -> destroy right away
+    destroy();
+}
+
+size_t collectRetiredResources(const Context& context) {
+    //collect finished resources while holding the lock...
+    std::vector<RetiredResource> finished;
+    size_t pending;
+    {
+        std::lock_guard<std::mutex> lock(context.retireMutex);
+        //query each semaphore once and drop the ones whose work finished
+        std::unordered_map<VkSemaphore, uint64_t> reached;
+        for (auto it = context.signaledValues.begin(); it != context.signaledValues.end();) {
+            uint64_t value = 0;
+            auto result = context.fnTable.vkGetSemaphoreCounterValue(
+                context.device, it->first, &value);
+            //on error we cannot know -> keep it pending
+            if (result != VK_SUCCESS)
+                value = 0;
+            reached[it->first] = value;
+            if (value >= it->second)
+                it = context.signaledValues.erase(it);
+            else
+                ++it;
+        }
+
+        auto& retired = context.retiredResources;
+        auto it = std::stable_partition(retired.begin(), retired.end(),
+            [&reached](const RetiredResource& resource) {
+                return std::any_of(resource.signals.begin(), resource.signals.end(),
+                    [&reached](const std::pair<VkSemaphore, uint64_t>& signal) {
+                        //semaphores no longer known have finished
+                        auto it = reached.find(signal.first);
+                        return it != reached.end() && it->second < signal.second;
+                    });
+            });
+        finished.insert(finished.end(),
+            std::make_move_iterator(it), std::make_move_iterator(retired.end()));
+        retired.erase(it, retired.end());
+        pending = retired.size();
+    }
+
+    //...but destroy them without it
+    for (auto& resource : finished)
+        resource.destroy();
+    return pending;
+}
+
+void forgetSignals(const Context& context, VkSemaphore semaphore) {
+    std::lock_guard<std::mutex> lock(context.retireMutex);
+    context.signaledValues.erase(semaphore);
+    for (auto& resource : context.retiredResources) {
+        std::erase_if(resource.signals,
+            [semaphore](const std::pair<VkSemaphore, uint64_t>& signal) {
+                return signal.first == semaphore;
+            });
+    }
+}
+
+void destroyRetiredResources(const Context& context) {
+    std::vector<RetiredResource> retired;
+    {
+        std::lock_guard<std::mutex> lock(context.retireMutex);
+        context.deferredDestruction = false;
+        retired = std::move(context.retiredResources);
+        context.retiredResources.clear();
+        context.signaledValues.clear();
+    }
+    if (retired.empty())
+        return;
+
+    //there might still be work in flight
+    context.fnTable.vkDeviceWaitIdle(context.device);
+    for (auto& resource : retired)
+        resource.destroy();
+}
+
+void destroySequencePools(const Context& context) {
+    //there might still be work in flight
+    context.fnTable.vkDeviceWaitIdle(context.device);
+    for (auto& sequence : context.retiredSequences)
+        recycle(context, sequence);
+    context.retiredSequences.clear();
+
+    for (auto& pools : context.sequencePools) {
+        for (auto pool : pools)
+            context.fnTable.vkDestroyCommandPool(context.device, pool, nullptr);
+        pools.clear();
+    }
+}
+
+OneTimeSubmitLease::OneTimeSubmitLease(const Context& context, QueueType queue)
+    : slot{}
+    , context(context)
+    , queue(queue)
+{
+    count(context.counters.oneTimeSubmits);
+
+    //try to reuse a free slot
+    auto type = static_cast<size_t>(queue);
+    {
+        std::lock_guard<std::mutex> lock(context.oneTimeSubmitMutex);
+        auto& slots = context.oneTimeSubmitSlots[type];
+        if (!slots.empty()) {
+            slot = slots.back();
+            slots.pop_back();
+            return;
+        }
+    }
+
+    //none available -> create a new one
+    VkCommandPoolCreateInfo poolInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = context.queues[type].family
+    };
+    checkResult(context.fnTable.vkCreateCommandPool(
+        context.device, &poolInfo, nullptr, &slot.pool));
+    VkCommandBufferAllocateInfo bufInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = slot.pool,
+        .commandBufferCount = 1
+    };
+    VkFenceCreateInfo fenceInfo{
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO
+    };
+    auto result = context.fnTable.vkAllocateCommandBuffers(
+        context.device, &bufInfo, &slot.buffer);
+    if (result == VK_SUCCESS) {
+        result = context.fnTable.vkCreateFence(
+            context.device, &fenceInfo, nullptr, &slot.fence);
+    }
+    if (result != VK_SUCCESS) {
+        //destroying the pool also frees the command buffer
+        context.fnTable.vkDestroyCommandPool(context.device, slot.pool, nullptr);
+        checkResult(result); //will throw
+    }
+}
+
+OneTimeSubmitLease::~OneTimeSubmitLease() {
+    //reset fence and command buffer (via pool) for next use
+    //we're in a destructor so we can't throw
+    context.fnTable.vkResetFences(context.device, 1, &slot.fence);
+    context.fnTable.vkResetCommandPool(context.device, slot.pool, 0);
+
+    //return to context
+    std::lock_guard<std::mutex> lock(context.oneTimeSubmitMutex);
+    context.oneTimeSubmitSlots[static_cast<size_t>(queue)].push_back(slot);
+}
+
+void destroyOneTimeSubmitSlots(const Context& context) {
+    std::lock_guard<std::mutex> lock(context.oneTimeSubmitMutex);
+    for (auto& slots : context.oneTimeSubmitSlots) {
+        for (auto& slot : slots) {
+            context.fnTable.vkDestroyFence(context.device, slot.fence, nullptr);
+            context.fnTable.vkDestroyCommandPool(context.device, slot.pool, nullptr);
+        }
+        slots.clear();
+    }
+}
+
+namespace {
+
+//capacity of the staging ring; must hold at least one lease of max size
+constexpr VkDeviceSize StagingRingSize = 4 * StagingLease::MaxSize;
+
+//finds space for size bytes at the end of the ring. Must be called while
+//holding the staging mutex.
+bool findStagingSpace(const StagingRing& ring, VkDeviceSize size, VkDeviceSize& offset) {
+    if (ring.ranges.empty()) {
+        offset = 0;
+        return true;
+    }
+
+    auto& front = ring.ranges.front();
+    auto& back = ring.ranges.back();
+    if (back.begin >= front.begin) {
+        //not wrapped yet -> try the end first, then the start of the ring
+        if (back.end + size <= ring.size) {
+            offset = back.end;
+            return true;
+        }
+        if (size <= front.begin) {
+            offset = 0;
+            return true;
+        }
+    }
+    else if (back.end + size <= front.begin) {
+        //wrapped -> only the gap between back and front is free
+        offset = back.end;
+        return true;
+    }
+    return false;
+}
+
+}
+
+VkBuffer StagingLease::getBuffer() const noexcept {
+    return context.stagingRing->buffer->buffer;
+}
+std::span<std::byte> StagingLease::getMemory() const noexcept {
+    auto data = static_cast<std::byte*>(context.stagingRing->buffer->allocInfo.pMappedData);
+    return { data + offset, size };
+}
+
+void StagingLease::flush() const {
+    checkResult(vmaFlushAllocation(context.allocator,
+        context.stagingRing->buffer->allocation, offset, size));
+}
+void StagingLease::invalidate() const {
+    checkResult(vmaInvalidateAllocation(context.allocator,
+        context.stagingRing->buffer->allocation, offset, size));
+}
+
+StagingLease::StagingLease(const ContextHandle& handle, VkDeviceSize size)
+    : offset(0)
+    , size(size)
+    , context(*handle)
+{
+    if (size == 0 || size > MaxSize)
+        throw std::logic_error("Staging lease size must be between 1 and StagingLease::MaxSize!");
+
+    std::unique_lock<std::mutex> lock(context.stagingMutex);
+    //create ring on first use
+    if (!context.stagingRing) {
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(context.physicalDevice, &props);
+        context.stagingRing.reset(new StagingRing{
+            .buffer = createBuffer(
+                handle,
+                StagingRingSize,
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT |
+                VMA_ALLOCATION_CREATE_MAPPED_BIT),
+            .size = StagingRingSize,
+            .alignment = std::max<VkDeviceSize>(props.limits.nonCoherentAtomSize, 16)
+        });
+    }
+    auto& ring = *context.stagingRing;
+
+    //round up so neighbouring ranges never share an atom
+    auto aligned = (size + ring.alignment - 1) / ring.alignment * ring.alignment;
+    //wait until enough space got released
+    ring.released.wait(lock, [&]() {
+        return findStagingSpace(ring, aligned, offset);
+    });
+    ring.ranges.push_back({ offset, offset + aligned, false });
+}
+StagingLease::~StagingLease() {
+    {
+        std::lock_guard<std::mutex> lock(context.stagingMutex);
+        auto& ranges = context.stagingRing->ranges;
+        auto range = std::find_if(ranges.begin(), ranges.end(),
+            [this](const StagingRing::Range& r) { return r.begin == offset && !r.released; });
+        range->released = true;
+        //free all released ranges at the front
+        while (!ranges.empty() && ranges.front().released)
+            ranges.pop_front();
+    }
+    context.stagingRing->released.notify_all();
+}
+
+void destroyStagingRing(const Context& context) {
+    std::lock_guard<std::mutex> lock(context.stagingMutex);
+    context.stagingRing.reset();
+}
+
+VkDeviceAddress ScratchLease::getAddress() const noexcept {
+    return context.scratchArena->address;
+}
+VkBuffer ScratchLease::getBuffer() const noexcept {
+    return context.scratchArena->buffer->buffer;
+}
+VkDeviceSize ScratchLease::getAlignment() const noexcept {
+    return context.scratchArena->alignment;
+}
+
+ScratchLease::ScratchLease(const ContextHandle& handle, VkDeviceSize size)
+    : lock(handle->scratchMutex)
+    , context(*handle)
+{
+    //create arena on first use
+    if (!context.scratchArena) {
+        VkPhysicalDeviceAccelerationStructurePropertiesKHR accProps{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_PROPERTIES_KHR
+        };
+        VkPhysicalDeviceProperties2 props{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+            .pNext = &accProps
+        };
+        vkGetPhysicalDeviceProperties2(context.physicalDevice, &props);
+        context.scratchArena.reset(new ScratchArena{
+            .buffer = createEmptyBuffer(),
+            .size = 0,
+            .address = 0,
+            .alignment = std::max<VkDeviceSize>(
+                accProps.minAccelerationStructureScratchOffsetAlignment, 1)
+        });
+    }
+    auto& arena = *context.scratchArena;
+    if (size <= arena.size)
+        return;
+
+    //Grow arena. The previous lease waited for its build, so the old buffer
+    //is no longer in use. Allocate extra space to align the start address.
+    arena.buffer.reset();
+    arena.size = 0;
+    arena.buffer = createBuffer(
+        handle,
+        size + arena.alignment,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        0);
+    VkBufferDeviceAddressInfo addressInfo{
+        .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+        .buffer = arena.buffer->buffer
+    };
+    auto address = context.fnTable.vkGetBufferDeviceAddress(
+        context.device, &addressInfo);
+    arena.address = (address + arena.alignment - 1) / arena.alignment * arena.alignment;
+    arena.size = size;
+}
+ScratchLease::~ScratchLease() = default;
+
+void destroyScratchArena(const Context& context) {
+    std::lock_guard<std::mutex> lock(context.scratchMutex);
+    context.scratchArena.reset();
+}
+
+TimestampProperties getTimestampProperties(const Context& context) {
+    //query timestamp period
+    VkPhysicalDeviceProperties devProps;
+    vkGetPhysicalDeviceProperties(context.physicalDevice, &devProps);
+
+    //query timestamp valid bits
+    uint32_t n;
+    vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &n, nullptr);
+    std::vector<VkQueueFamilyProperties> qProps(n);
+    vkGetPhysicalDeviceQueueFamilyProperties(context.physicalDevice, &n, qProps.data());
+
+    return {
+        .validBits = qProps[context.queueFamily].timestampValidBits,
+        .period = devProps.limits.timestampPeriod
+    };
+}
+
+uint64_t getTraceClock() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool spinWait(const Context& context,
+    std::span<const VkSemaphore> semaphores, std::span<const uint64_t> values,
+    bool any, uint64_t& timeout)
+{
+    auto budget = std::min<uint64_t>(context.waitSpinTime, timeout);
+    if (budget == 0)
+        return false;
+
+    auto reached = [&](size_t i) {
+        uint64_t current = 0;
+        checkResult(context.fnTable.vkGetSemaphoreCounterValue(
+            context.device, semaphores[i], &current));
+        return current >= values[i];
+    };
+    //blocking waits may take hundreds of microseconds to wake up again
+    auto start = getTraceClock();
+    uint64_t elapsed = 0;
+    do {
+        size_t count = 0;
+        for (size_t i = 0; i < semaphores.size(); ++i)
+            count += reached(i) ? 1 : 0;
+        if (any ? count > 0 : count == semaphores.size())
+            return true;
+        elapsed = getTraceClock() - start;
+    } while (elapsed < budget);
+
+    if (timeout != UINT64_MAX)
+        timeout -= std::min(elapsed, timeout);
+    return false;
+}
+
+void waitForFence(const Context& context, VkFence fence) {
+    auto budget = context.waitSpinTime.load();
+    if (budget > 0) {
+        auto start = getTraceClock();
+        do {
+            auto result = context.fnTable.vkGetFenceStatus(context.device, fence);
+            if (result == VK_SUCCESS)
+                return;
+            if (result != VK_NOT_READY)
+                checkResult(result); //will throw
+        } while (getTraceClock() - start < budget);
+    }
+    checkResult(context.fnTable.vkWaitForFences(
+        context.device, 1, &fence, VK_TRUE, UINT64_MAX));
+}
+
+namespace {
+
+//the time domain matching std::chrono::steady_clock
+#ifdef _WIN32
+constexpr auto HostTimeDomain = VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_KHR;
+#else
+constexpr auto HostTimeDomain = VK_TIME_DOMAIN_CLOCK_MONOTONIC_KHR;
+#endif
+
+uint64_t maskTimestamp(uint64_t timestamp, uint32_t validBits) {
+    if (validBits < 64)
+        timestamp &= (uint64_t(1) << validBits) - 1;
+    return timestamp;
+}
+
+ClockCalibration calibrateClocks(const Context& context) {
+    auto props = getTimestampProperties(context);
+
+    VkCalibratedTimestampInfoKHR infos[2] = {
+        {
+            .sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_KHR,
+            .timeDomain = VK_TIME_DOMAIN_DEVICE_KHR
+        }, {
+            .sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_KHR,
+            .timeDomain = HostTimeDomain
+        }
+    };
+    uint64_t timestamps[2];
+    uint64_t deviation;
+    auto getTimestamps = context.fnTable.vkGetCalibratedTimestampsKHR ?
+        context.fnTable.vkGetCalibratedTimestampsKHR :
+        context.fnTable.vkGetCalibratedTimestampsEXT;
+    checkResult(getTimestamps(context.device, 2, infos, timestamps, &deviation));
+
+    auto host = static_cast<double>(timestamps[1]);
+#ifdef _WIN32
+    //steady_clock scales the performance counter to nanoseconds
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    host *= 1e9 / static_cast<double>(frequency.QuadPart);
+#endif
+    auto device = static_cast<double>(maskTimestamp(timestamps[0], props.validBits));
+    return {
+        .offset = host - device * props.period,
+        .deviation = static_cast<double>(deviation)
+    };
+}
+
+//takes the midpoint of the host time around a submission writing a single
+//timestamp; the deviation is bound by the submission's round trip
+ClockCalibration calibrateClocksBySubmission(const Context& context) {
+    auto props = getTimestampProperties(context);
+
+    VkQueryPoolCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .queryType = VK_QUERY_TYPE_TIMESTAMP,
+        .queryCount = 1
+    };
+    VkQueryPool pool;
+    checkResult(context.fnTable.vkCreateQueryPool(
+        context.device, &info, nullptr, &pool));
+    context.fnTable.vkResetQueryPool(context.device, pool, 0, 1);
+
+    uint64_t timestamp = 0;
+    auto before = getTraceClock();
+    auto result = VK_SUCCESS;
+    try {
+        oneTimeSubmit(context, [&](VkCommandBuffer cmd) {
+            context.fnTable.vkCmdWriteTimestamp(cmd,
+                VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, pool, 0);
+        });
+        result = context.fnTable.vkGetQueryPoolResults(
+            context.device, pool, 0, 1,
+            sizeof(uint64_t), &timestamp, sizeof(uint64_t),
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+    }
+    catch (...) {
+        context.fnTable.vkDestroyQueryPool(context.device, pool, nullptr);
+        throw;
+    }
+    auto after = getTraceClock();
+    context.fnTable.vkDestroyQueryPool(context.device, pool, nullptr);
+    checkResult(result);
+
+    auto host = 0.5 * (static_cast<double>(before) + static_cast<double>(after));
+    auto device = static_cast<double>(maskTimestamp(timestamp, props.validBits));
+    return {
+        .offset = host - device * props.period,
+        .deviation = 0.5 * static_cast<double>(after - before)
+    };
+}
+
+}
+
+bool hasHostTimeDomain(VkPhysicalDevice device) {
+    auto getDomains = vkGetPhysicalDeviceCalibrateableTimeDomainsKHR ?
+        vkGetPhysicalDeviceCalibrateableTimeDomainsKHR :
+        vkGetPhysicalDeviceCalibrateableTimeDomainsEXT;
+    if (!getDomains)
+        return false;
+
+    uint32_t count;
+    if (getDomains(device, &count, nullptr) != VK_SUCCESS)
+        return false;
+    std::vector<VkTimeDomainKHR> domains(count);
+    if (getDomains(device, &count, domains.data()) < 0)
+        return false;
+    return std::find(domains.begin(), domains.end(), VK_TIME_DOMAIN_DEVICE_KHR) != domains.end()
+        && std::find(domains.begin(), domains.end(), HostTimeDomain) != domains.end();
+}
+
+void createComputePipeline(const Context& context,
+    const VkComputePipelineCreateInfo& info, VkPipeline& pipeline)
+{
+    if (!context.pipelineCreationFeedback) {
+        checkResult(context.fnTable.vkCreateComputePipelines(
+            context.device, context.cache, 1, &info, nullptr, &pipeline));
+        return;
+    }
+
+    //chain feedback in front of the caller's extensions
+    VkPipelineCreationFeedbackEXT feedback{};
+    VkPipelineCreationFeedbackCreateInfoEXT feedbackInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT,
+        .pNext = info.pNext,
+        .pPipelineCreationFeedback = &feedback
+    };
+    auto chained = info;
+    chained.pNext = &feedbackInfo;
+    checkResult(context.fnTable.vkCreateComputePipelines(
+        context.device, context.cache, 1, &chained, nullptr, &pipeline));
+
+    //drivers are free to not report anything
+    if (!(feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT))
+        return;
+    if (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT)
+        count(context.counters.pipelineCacheHits);
+    else
+        count(context.counters.pipelineCacheMisses);
+}
+
+void setObjectName(const Context& context,
+    VkObjectType type, uint64_t handle, const char* name)
+{
+    if (!context.debugUtils || handle == 0)
+        return;
+    VkDebugUtilsObjectNameInfoEXT info{
+        .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT,
+        .objectType = type,
+        .objectHandle = handle,
+        .pObjectName = name
+    };
+    checkResult(vkSetDebugUtilsObjectNameEXT(context.device, &info));
+}
+
+ClockCalibration getClockCalibration(const Context& context, bool refresh) {
+    //calibrated timestamps are cheap, so always take fresh ones
+    if (context.calibratedTimestamps) {
+        auto calibration = calibrateClocks(context);
+        std::lock_guard<std::mutex> lock(context.clockMutex);
+        context.clockCalibration = calibration;
+        return calibration;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(context.clockMutex);
+        if (context.clockCalibration && !refresh)
+            return *context.clockCalibration;
+    }
+    auto calibration = calibrateClocksBySubmission(context);
+    std::lock_guard<std::mutex> lock(context.clockMutex);
+    context.clockCalibration = calibration;
+    return calibration;
+}
+
+namespace {
+
+void trace(const Context& context, const char* name, const char* category,
+    uint64_t start, uint64_t duration)
+{
+    std::lock_guard<std::mutex> lock(context.traceMutex);
+    auto& log = context.traceLog;
+    if (!log)
+        return;
+
+    //threads are numbered in the order they first recorded an event
+    auto id = std::this_thread::get_id();
+    auto it = std::find(log->threads.begin(), log->threads.end(), id);
+    if (it == log->threads.end())
+        it = log->threads.insert(it, id);
+    auto thread = static_cast<uint32_t>(it - log->threads.begin()) + 1;
+
+    log->records.push_back({ name, category, thread, start, duration });
+}
+
+}
+
+TraceScope::TraceScope(const Context& context, const char* name, const char* category)
+    : context(context)
+    , name(name)
+    , category(category)
+    , start(context.tracing ? getTraceClock() : 0)
+{}
+TraceScope::~TraceScope() {
+    if (start != 0 && context.tracing)
+        trace(context, name, category, start, getTraceClock() - start);
+}
+
+void traceInstant(const Context& context, const char* name, const char* category) {
+    if (context.tracing)
+        trace(context, name, category, getTraceClock(), 0);
+}
+
+uint64_t getMappingGranularity() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+#else
+    return static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+void* mapFile(const std::filesystem::path& path, uint64_t offset, uint64_t length) {
+#ifdef _WIN32
+    auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+    auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping)
+        return nullptr;
+    //the view keeps the mapping alive
+    auto view = MapViewOfFile(mapping, FILE_MAP_READ,
+        static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset),
+        static_cast<SIZE_T>(length));
+    CloseHandle(mapping);
+    return view;
+#else
+    auto fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    //the mapping keeps the file alive
+    auto view = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(offset));
+    close(fd);
+    return view != MAP_FAILED ? view : nullptr;
+#endif
+}
+void unmapFile(void* view, uint64_t length) {
+#ifdef _WIN32
+    UnmapViewOfFile(view);
+#else
+    munmap(view, length);
+#endif
+}
+
+uint64_t getHugePageSize() {
+#ifdef _WIN32
+    return static_cast<uint64_t>(GetLargePageMinimum());
+#elif defined(__linux__)
+    static const uint64_t size = []() -> uint64_t {
+        std::ifstream file("/proc/meminfo");
+        std::string line;
+        while (std::getline(file, line)) {
+            unsigned long long kb;
+            if (std::sscanf(line.c_str(), "Hugepagesize: %llu kB", &kb) == 1)
+                return kb << 10;
+        }
+        return 0;
+    }();
+    return size;
+#else
+    return 0;
+#endif
+}
+
+void* allocatePages(uint64_t length, bool transparentHuge, bool explicitHuge) {
+#ifdef _WIN32
+    //large pages on windows are always explicit and need SeLockMemoryPrivilege
+    DWORD flags = MEM_RESERVE | MEM_COMMIT;
+    if (explicitHuge)
+        flags |= MEM_LARGE_PAGES;
+    return VirtualAlloc(nullptr, static_cast<SIZE_T>(length), flags, PAGE_READWRITE);
+#else
+    auto flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_HUGETLB
+    if (explicitHuge)
+        flags |= MAP_HUGETLB;
+#else
+    if (explicitHuge)
+        return nullptr;
+#endif
+    if (!transparentHuge || explicitHuge) {
+        auto memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+        return memory != MAP_FAILED ? memory : nullptr;
+    }
+
+    //huge pages must be aligned to their size -> trim an oversized mapping
+    auto hugeSize = getHugePageSize();
+    auto memory = mmap(nullptr, length + hugeSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (memory == MAP_FAILED)
+        return nullptr;
+    auto address = reinterpret_cast<uintptr_t>(memory);
+    auto aligned = hugeSize ? (address + hugeSize - 1) / hugeSize * hugeSize : address;
+    if (aligned != address)
+        munmap(memory, aligned - address);
+    if (auto tail = address + length + hugeSize - (aligned + length))
+        munmap(reinterpret_cast<void*>(aligned + length), tail);
+#ifdef MADV_HUGEPAGE
+    madvise(reinterpret_cast<void*>(aligned), length, MADV_HUGEPAGE);
+#endif
+    return reinterpret_cast<void*>(aligned);
+#endif
+}
+
+void freePages(void* memory, uint64_t length) {
+#ifdef _WIN32
+    VirtualFree(memory, 0, MEM_RELEASE);
+#else
+    munmap(memory, length);
+#endif
+}
+
+bool bindPagesToNode(void* memory, uint64_t length, int32_t node) {
+#if defined(__linux__) && defined(SYS_mbind)
+    //avoid depending on libnuma for a single syscall
+    constexpr int MPOL_PREFERRED = 1;
+    constexpr auto Bits = 8 * sizeof(unsigned long);
+    if (node < 0 || node >= 1024)
+        return false;
+    unsigned long mask[1024 / Bits] = {};
+    mask[node / Bits] = 1ul << (node % Bits);
+    //kernel expects one more than the highest node
+    return syscall(SYS_mbind, memory, length, MPOL_PREFERRED,
+        mask, static_cast<unsigned long>(node + 2), 0u) == 0;
+#else
+    return false;
+#endif
+}
+
+int32_t getPciNumaNode(uint32_t domain, uint32_t bus, uint32_t device, uint32_t function) {
+#ifdef __linux__
+    char path[64];
+    std::snprintf(path, sizeof(path), "/sys/bus/pci/devices/%04x:%02x:%02x.%x/numa_node",
+        domain, bus, device, function);
+    std::ifstream file(path);
+    int32_t node = -1;
+    if (!(file >> node))
+        return -1;
+    //single node systems report -1 as well
+    return node;
+#else
+    return -1;
+#endif
+}
+
+}
@@ -1,46 +1,349 @@
 #pragma once
 
+#include <filesystem>
+#include <span>
+#include <vector>
+
 #include "vk/result.hpp"
 #include "vk/types.hpp"
 
 namespace hephaistos::vulkan {
 
+//Maps synchronization2 stages to their closest legacy equivalent
+constexpr VkPipelineStageFlags toLegacyStage(VkPipelineStageFlags2KHR stage) {
+    //synchronization2 only stages, i.e. above 32 bit
+    constexpr VkPipelineStageFlags2KHR TransferStages2 =
+        VK_PIPELINE_STAGE_2_COPY_BIT_KHR |
+        VK_PIPELINE_STAGE_2_RESOLVE_BIT_KHR |
+        VK_PIPELINE_STAGE_2_BLIT_BIT_KHR |
+        VK_PIPELINE_STAGE_2_CLEAR_BIT_KHR;
+
+    auto result = static_cast<VkPipelineStageFlags>(stage & 0xFFFFFFFFull);
+    if (stage & TransferStages2)
+        result |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+    return result;
+}
+//Maps synchronization2 access flags to their closest legacy equivalent
+constexpr VkAccessFlags toLegacyAccess(VkAccessFlags2KHR access) {
+    //synchronization2 only access flags, i.e. above 32 bit
+    constexpr VkAccessFlags2KHR ShaderReadAccess2 =
+        VK_ACCESS_2_SHADER_SAMPLED_READ_BIT_KHR |
+        VK_ACCESS_2_SHADER_STORAGE_READ_BIT_KHR;
+    constexpr VkAccessFlags2KHR ShaderWriteAccess2 =
+        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT_KHR;
+
+    auto result = static_cast<VkAccessFlags>(access & 0xFFFFFFFFull);
+    if (access & ShaderReadAccess2)
+        result |= VK_ACCESS_SHADER_READ_BIT;
+    if (access & ShaderWriteAccess2)
+        result |= VK_ACCESS_SHADER_WRITE_BIT;
+    return result;
+}
+
+//Increments one of the context's counters
+inline void count(std::atomic<uint64_t>& counter, uint64_t amount = 1) noexcept {
+    counter.fetch_add(amount, std::memory_order_relaxed);
+}
+
+//True, if both are the same context or share their device, i.e. resources
+//of one can be used on the other
+inline bool isSameDevice(const Context* a, const Context* b) noexcept {
+    return a == b || (a && b && a->device == b->device);
+}
+
+//Submits to the context's main queue while holding its lock
+void queueSubmit(const Context& context,
+    uint32_t count, const VkSubmitInfo* pSubmits, VkFence fence);
+//Submits to the context's queue of the given type while holding its lock
+void queueSubmit(const Context& context, QueueType type,
+    uint32_t count, const VkSubmitInfo* pSubmits, VkFence fence);
+
+//Submits to the context's queue of the given type using synchronization2
+//Only available if context.synchronization2 is true
+void queueSubmit2(const Context& context, QueueType type,
+    uint32_t count, const VkSubmitInfo2KHR* pSubmits, VkFence fence);
+
+//Binds sparse memory on the context's main queue while holding its lock
+//Only available if context.sparseBinding is true
+void queueBindSparse(const Context& context,
+    uint32_t count, const VkBindSparseInfo* pInfos, VkFence fence);
+//Binds sparse memory like queueBindSparse and waits for it on the host, so
+//later submissions on any queue see the new binding
+void bindSparseSync(const Context& context, const VkBindSparseInfo& info);
+
+//Buffer memory barrier expressed using synchronization2 flags
+struct BufferBarrier {
+    VkPipelineStageFlags2KHR srcStage;
+    VkAccessFlags2KHR srcAccess;
+    VkPipelineStageFlags2KHR dstStage;
+    VkAccessFlags2KHR dstAccess;
+    VkBuffer buffer;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = VK_WHOLE_SIZE;
+};
+//Global memory barrier expressed using synchronization2 flags
+struct GlobalBarrier {
+    VkPipelineStageFlags2KHR srcStage;
+    VkAccessFlags2KHR srcAccess;
+    VkPipelineStageFlags2KHR dstStage;
+    VkAccessFlags2KHR dstAccess;
+};
+//Image memory barrier of color mip levels across all layers expressed using
+//synchronization2 flags; may include a layout transition
+struct ImageBarrier {
+    VkPipelineStageFlags2KHR srcStage;
+    VkAccessFlags2KHR srcAccess;
+    VkPipelineStageFlags2KHR dstStage;
+    VkAccessFlags2KHR dstAccess;
+    VkImageLayout oldLayout;
+    VkImageLayout newLayout;
+    VkImage image;
+    uint32_t baseMipLevel = 0;
+    uint32_t levelCount = VK_REMAINING_MIP_LEVELS;
+};
+//Records the given barriers using vkCmdPipelineBarrier2 if available.
+//Otherwise falls back to vkCmdPipelineBarrier mapping the flags to their
+//closest legacy equivalent.
+void pipelineBarrier(const Context& context, VkCommandBuffer cmd,
+    std::span<const BufferBarrier> barriers,
+    std::span<const GlobalBarrier> globalBarriers = {},
+    std::span<const ImageBarrier> imageBarriers = {});
+inline void pipelineBarrier(const Context& context, VkCommandBuffer cmd,
+    const BufferBarrier& barrier)
+{
+    pipelineBarrier(context, cmd, { &barrier, 1 });
+}
+//Same as above, but restricts the stages and accesses to the ones supported
+//by the queue family the command gets submitted to, e.g. transfer only
+//families know no shader stages.
+void pipelineBarrier(const Context& context, const Command& cmd,
+    std::span<const BufferBarrier> barriers,
+    std::span<const GlobalBarrier> globalBarriers = {},
+    std::span<const ImageBarrier> imageBarriers = {});
+inline void pipelineBarrier(const Context& context, const Command& cmd,
+    const BufferBarrier& barrier)
+{
+    pipelineBarrier(context, cmd, { &barrier, 1 });
+}
+
+//Fetches a free command pool for sequences on the given queue type or creates
+//a new one. Recycles finished retired sequences first.
+VkCommandPool fetchSequencePool(const Context& context, QueueType type);
+//Frees the command buffers and returns the pool to the context for reuse.
+//The pool must not be in use anymore.
+void returnSequencePool(const Context& context, QueueType type,
+    VkCommandPool pool, const std::vector<VkCommandBuffer>& commands);
+//Hands the resources of submitted work to the context, which recycles them
+//once the work finished without blocking the caller
+void retireSequence(const Context& context, RetiredSequence sequence);
+//Recycles all retired sequences, whose work has finished. If a semaphore is
+//given, waits instead for all work signaling it, e.g. before destroying it.
+void reclaimSequences(const Context& context, VkSemaphore semaphore = VK_NULL_HANDLE);
+//Destroys all sequence pools. Only called during context destruction.
+void destroySequencePools(const Context& context);
+
+//Runs destroy once all work submitted so far finished if deferred
+//destruction is enabled, otherwise right away
+void retireResource(const Context& context, std::function<void()> destroy);
+//Destroys all retired resources, whose work has finished, and returns the
+//amount of ones still pending
+size_t collectRetiredResources(const Context& context);
+//Drops all signals of the given semaphore, e.g. before destroying it. Work
+//signaling it must have finished.
+void forgetSignals(const Context& context, VkSemaphore semaphore);
+//Waits on the device and destroys all retired resources. Disables deferred
+//destruction as it is only called during context destruction.
+void destroyRetiredResources(const Context& context);
+
+//Leases a one time submit slot for the given queue from the context, creating
+//a new one if none is available. The slot is returned to the context once the
+//lease is dropped.
+class OneTimeSubmitLease {
+public:
+    [[nodiscard]] const OneTimeSubmitSlot& get() const noexcept { return slot; }
+
+    OneTimeSubmitLease(const OneTimeSubmitLease&) = delete;
+    OneTimeSubmitLease& operator=(const OneTimeSubmitLease&) = delete;
+
+    explicit OneTimeSubmitLease(const Context& context, QueueType queue = QueueType::MAIN);
+    ~OneTimeSubmitLease();
+
+private:
+    OneTimeSubmitSlot slot;
+    const Context& context;
+    QueueType queue;
+};
+
+//Destroys all one time submit slots. Only called during context destruction.
+void destroyOneTimeSubmitSlots(const Context& context);
+
+//Leases a range of the context's staging ring, creating the ring on first
+//use. Blocks until enough space is available. The range is released once
+//the lease is dropped.
+class StagingLease {
+public:
+    //maximum size of a single lease; larger transfers must be split
+    static constexpr VkDeviceSize MaxSize = 2 * 1024 * 1024;
+
+    [[nodiscard]] VkBuffer getBuffer() const noexcept;
+    [[nodiscard]] VkDeviceSize getOffset() const noexcept { return offset; }
+    [[nodiscard]] std::span<std::byte> getMemory() const noexcept;
+
+    //makes host writes available to the device
+    void flush() const;
+    //makes device writes visible to the host
+    void invalidate() const;
+
+    StagingLease(const StagingLease&) = delete;
+    StagingLease& operator=(const StagingLease&) = delete;
+
+    StagingLease(const ContextHandle& context, VkDeviceSize size);
+    ~StagingLease();
+
+private:
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    const Context& context;
+};
+//Destroys the staging ring. Only called during context destruction.
+void destroyStagingRing(const Context& context);
+
+//Leases the context's scratch arena for a single acceleration structure
+//build, growing it if it is smaller than the requested size. Concurrent
+//builds wait until the lease is dropped, so it must outlive the build.
+class ScratchLease {
+public:
+    //aligned to minAccelerationStructureScratchOffsetAlignment
+    [[nodiscard]] VkDeviceAddress getAddress() const noexcept;
+    [[nodiscard]] VkBuffer getBuffer() const noexcept;
+    //alignment sub-allocations of batched builds must respect
+    [[nodiscard]] VkDeviceSize getAlignment() const noexcept;
+
+    ScratchLease(const ScratchLease&) = delete;
+    ScratchLease& operator=(const ScratchLease&) = delete;
+
+    ScratchLease(const ContextHandle& context, VkDeviceSize size);
+    ~ScratchLease();
+
+private:
+    std::unique_lock<std::mutex> lock;
+    const Context& context;
+};
+//Destroys the scratch arena. Only called during context destruction.
+void destroyScratchArena(const Context& context);
+
+//Timestamp precision of the context's main queue family
+struct TimestampProperties {
+    uint32_t validBits;
+    float period;
+};
+[[nodiscard]] TimestampProperties getTimestampProperties(const Context& context);
+
+//Creates a compute pipeline using the context's pipeline cache and counts
+//whether the driver found it in the cache
+void createComputePipeline(const Context& context,
+    const VkComputePipelineCreateInfo& info, VkPipeline& pipeline);
+
+//Names the object for debuggers and profilers. No-op if the context does
+//not have VK_EXT_debug_utils enabled or the handle is null.
+void setObjectName(const Context& context,
+    VkObjectType type, uint64_t handle, const char* name);
+
+//Steady clock in nanoseconds used for trace events
+[[nodiscard]] uint64_t getTraceClock();
+//True, if the device can calibrate its timestamps against the time domain
+//of the host's steady clock
+[[nodiscard]] bool hasHostTimeDomain(VkPhysicalDevice device);
+//Correlates device timestamps with the steady clock. Uses calibrated
+//timestamps if enabled, otherwise brackets a submission writing a single
+//timestamp and reuses that result unless refresh is set.
+[[nodiscard]] ClockCalibration getClockCalibration(const Context& context, bool refresh = false);
+//Records its lifetime as host event if the context is tracing
+class TraceScope {
+public:
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    //name and category must be string literals
+    TraceScope(const Context& context, const char* name, const char* category);
+    ~TraceScope();
+
+private:
+    const Context& context;
+    const char* name;
+    const char* category;
+    uint64_t start;
+};
+//Records an instant host event if the context is tracing
+void traceInstant(const Context& context, const char* name, const char* category);
+
+//Polls the semaphores for up to the context's spin time before a blocking
+//wait would be issued. Returns true if all values, or any if set, were
+//reached; otherwise the time spent polling is subtracted from timeout.
+[[nodiscard]] bool spinWait(const Context& context,
+    std::span<const VkSemaphore> semaphores, std::span<const uint64_t> values,
+    bool any, uint64_t& timeout);
+//Waits on the fence without timeout, polling it first for the context's
+//spin time
+void waitForFence(const Context& context, VkFence fence);
+
 template<class Func>
-void oneTimeSubmit(Context& context, const Func& func) {
+void oneTimeSubmit(const Context& context, QueueType queue, const Func& func) {
+    TraceScope trace(context, "OneTimeSubmit", "submit");
+    //fetch resources for this submission
+    OneTimeSubmitLease lease(context, queue);
+    auto& slot = lease.get();
+
     //Start recording
     VkCommandBufferBeginInfo beginInfo{
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
         .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
     };
     checkResult(context.fnTable.vkBeginCommandBuffer(
-        context.oneTimeSubmitBuffer, &beginInfo));
+        slot.buffer, &beginInfo));
 
     //record stuff
-    func(context.oneTimeSubmitBuffer);
+    func(slot.buffer);
 
     //End recording
-    checkResult(context.fnTable.vkEndCommandBuffer(context.oneTimeSubmitBuffer));
+    checkResult(context.fnTable.vkEndCommandBuffer(slot.buffer));
 
     //Submit with fence so we can wait for it to finish
     VkSubmitInfo submitInfo{
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
         .commandBufferCount = 1,
-        .pCommandBuffers = &context.oneTimeSubmitBuffer
+        .pCommandBuffers = &slot.buffer
     };
-    checkResult(context.fnTable.vkQueueSubmit(
-        context.queue, 1, &submitInfo, context.oneTimeSubmitFence));
+    queueSubmit(context, queue, 1, &submitInfo, slot.fence);
 
     //wait for it to finish
-    checkResult(context.fnTable.vkWaitForFences(
-        context.device, 1, &context.oneTimeSubmitFence, VK_TRUE, UINT64_MAX));
-    
-    //reset fence for next use
-    checkResult(context.fnTable.vkResetFences(
-        context.device, 1, &context.oneTimeSubmitFence));
-
-    //reset command buffer via pool for next use
-    checkResult(context.fnTable.vkResetCommandPool(
-        context.device, context.oneTimeSubmitPool, 0));
+    waitForFence(context, slot.fence);
+}
+template<class Func>
+void oneTimeSubmit(const Context& context, const Func& func) {
+    oneTimeSubmit(context, QueueType::MAIN, func);
 }
 
+//Granularity of offsets into mapped files
+uint64_t getMappingGranularity();
+//Maps a region of the file read only; returns nullptr on failure
+void* mapFile(const std::filesystem::path& path, uint64_t offset, uint64_t length);
+//Unmaps a region previously returned by mapFile
+void unmapFile(void* view, uint64_t length);
+
+//Size of huge pages used by allocatePages(); zero if not available
+uint64_t getHugePageSize();
+//Allocates page aligned host memory of the given length, which must be a
+//multiple of the page size in use. Transparent huge pages are only hinted,
+//while explicit ones get reserved from the system's pool. Returns nullptr on
+//failure.
+void* allocatePages(uint64_t length, bool transparentHuge, bool explicitHuge);
+//Frees memory previously returned by allocatePages
+void freePages(void* memory, uint64_t length);
+//Prefers placing the not yet touched pages on the given NUMA node. Returns
+//false if not supported.
+bool bindPagesToNode(void* memory, uint64_t length, int32_t node);
+//NUMA node of the PCI device at the given address; -1 if unknown
+int32_t getPciNumaNode(uint32_t domain, uint32_t bus, uint32_t device, uint32_t function);
+
 }
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace hephaistos::vulkan {
+
+//Process wide pool running background tasks on one thread per core
+class WorkerPool {
+public:
+    static WorkerPool& get() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    template<class F>
+    auto submit(F&& func) -> std::future<decltype(func())> {
+        using R = decltype(func());
+        //packaged_task is move only, but std::function requires copies
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(func));
+        auto future = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([task]() { (*task)(); });
+        }
+        condition.notify_one();
+        return future;
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        condition.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+private:
+    WorkerPool() {
+        auto count = std::max(std::thread::hardware_concurrency(), 1u);
+        for (auto i = 0u; i < count; ++i)
+            workers.emplace_back([this]() { run(); });
+    }
+
+    void run() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [this]() { return stop || !tasks.empty(); });
+                //finish pending tasks before stopping
+                if (tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::queue<std::function<void()>> tasks;
+    std::vector<std::thread> workers;
+    bool stop = false;
+};
+
+}
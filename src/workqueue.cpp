@@ -0,0 +1,387 @@
+#include "hephaistos/workqueue.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "hephaistos/context.hpp"
+
+#include "vk/hazard.hpp"
+#include "vk/kernel.hpp"
+#include "vk/types.hpp"
+#include "vk/util.hpp"
+
+namespace hephaistos {
+
+namespace {
+
+/******************************** SHADER CODE *********************************/
+
+constexpr char WorkQueueSource[] = R"(#ifndef _INCLUDE_HEPHAISTOS_WORKQUEUE
+#define _INCLUDE_HEPHAISTOS_WORKQUEUE
+
+#extension GL_EXT_buffer_reference : require
+
+//Queue of work items processed by persistent workgroups. Items are popped
+//from one half of the queue, while follow up work gets pushed to the other.
+//Between rounds the halves are swapped by the host side WorkQueue, thus
+//items pushed in a round are only popped in the next one. Include this
+//header directly after the version directive.
+//
+//Programs loop until the current round drained:
+//  uint item;
+//  while (workQueuePop(queue, item)) {
+//      ...
+//      workQueuePush(queue, next);
+//  }
+
+layout(buffer_reference, std430, buffer_reference_align = 4) buffer WorkQueue {
+    //groups of the next round read by the indirect dispatch
+    uvec3 dispatchSize;
+    uint round;
+    //items popped this round
+    uint head;
+    //items per half
+    uint count[2];
+    //items each half can hold
+    uint capacity;
+    //items dropped as the queue was full
+    uint overflow;
+    //items processed in finished rounds
+    uint processed;
+    uint _reserved[6];
+    //both halves, each holding capacity items
+    uint items[];
+};
+
+//pops the next item of the current round; returns false if it drained
+bool workQueuePop(WorkQueue queue, out uint item) {
+    uint r = queue.round & 1u;
+    uint i = atomicAdd(queue.head, 1u);
+    if (i >= queue.count[r])
+        return false;
+    item = queue.items[r * queue.capacity + i];
+    return true;
+}
+
+//pushes an item processed in the next round; returns false if it was
+//dropped as the queue was full
+bool workQueuePush(WorkQueue queue, uint item) {
+    uint w = (queue.round & 1u) ^ 1u;
+    uint i = atomicAdd(queue.count[w], 1u);
+    if (i >= queue.capacity) {
+        atomicAdd(queue.overflow, 1u);
+        return false;
+    }
+    queue.items[w * queue.capacity + i] = item;
+    return true;
+}
+
+#endif
+)";
+
+//resets the queue and fills the first half
+constexpr char SeedSource[] = R"(#version 460
+
+#include "hephaistos/workqueue.glsl"
+
+layout(local_size_x = 64) in;
+
+layout(buffer_reference, std430, buffer_reference_align = 4) readonly buffer Items { uint v[]; };
+
+layout(push_constant) uniform Push {
+    WorkQueue queue;
+    Items items;
+    uint first;
+    uint count;
+    uint capacity;
+    uint fromItems;
+};
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i == 0u) {
+        queue.dispatchSize = uvec3(0u, 1u, 1u);
+        queue.round = 0u;
+        queue.head = 0u;
+        queue.count[0] = count;
+        queue.count[1] = 0u;
+        queue.capacity = capacity;
+        queue.overflow = 0u;
+        queue.processed = 0u;
+    }
+    if (i < count)
+        queue.items[i] = fromItems != 0u ? items.v[i] : first + i;
+}
+)";
+
+//swaps the halves after a round and sizes the next dispatch
+constexpr char RefillSource[] = R"(#version 460
+
+#include "hephaistos/workqueue.glsl"
+
+layout(local_size_x = 1) in;
+
+layout(push_constant) uniform Push {
+    WorkQueue queue;
+    uint itemsPerGroup;
+    uint maxGroups;
+    uint advance;
+    uint _padding;
+};
+
+void main() {
+    uint r = queue.round & 1u;
+    if (advance != 0u) {
+        uint w = r ^ 1u;
+        queue.processed += min(queue.head, queue.count[r]);
+        queue.count[r] = 0u;
+        queue.count[w] = min(queue.count[w], queue.capacity);
+        queue.head = 0u;
+        queue.round += 1u;
+        r = w;
+    }
+    uint groups = (queue.count[r] + itemsPerGroup - 1u) / itemsPerGroup;
+    queue.dispatchSize = uvec3(min(groups, maxGroups), 1u, 1u);
+}
+)";
+
+constexpr uint32_t SeedLocalSize = 64;
+//compute units assumed if the device does not report them
+constexpr uint32_t DefaultComputeUnits = 32;
+
+struct SeedPush {
+    uint64_t queue;
+    uint64_t items;
+    uint32_t first;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t fromItems;
+};
+
+struct RefillPush {
+    uint64_t queue;
+    uint32_t itemsPerGroup;
+    uint32_t maxGroups;
+    uint32_t advance;
+    uint32_t _padding;
+};
+
+}
+
+/***************************** WORK QUEUE COMMAND *****************************/
+
+struct WorkQueueCommand::State {
+    ContextHandle context;
+    //tensors accessed via their address; declared to the hazard tracker
+    std::vector<std::reference_wrapper<const Tensor<std::byte>>> tensors;
+
+    //seed: single dispatch of the seed program
+    const Program* seed = nullptr;
+    uint32_t seedGroups = 0;
+    SeedPush seedPush = {};
+
+    //launch: refill followed by rounds of the user program
+    const Program* refill = nullptr;
+    RefillPush refillPush = {};
+    uint32_t rounds = 0;
+    //owns the push data referenced by dispatch
+    std::vector<std::byte> push;
+    std::optional<DispatchIndirectCommand> dispatch;
+};
+
+void WorkQueueCommand::record(vulkan::Command& cmd) const {
+    auto& context = *state->context;
+
+    //queue is accessed via its address and thus unknown to the dispatches
+    if (cmd.tracker) {
+        for (auto& tensor : state->tensors) {
+            auto& buffer = tensor.get().getBuffer();
+            cmd.tracker->buffer(buffer.buffer, buffer.offset, tensor.get().size_bytes(),
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+                VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+        }
+        cmd.tracker->barrier(context, cmd);
+    }
+
+    if (state->seed) {
+        DispatchCommand(state->seed->getProgram(), state->seedGroups, 1, 1,
+            { reinterpret_cast<const std::byte*>(&state->seedPush), sizeof(SeedPush) })
+            .record(cmd);
+        return;
+    }
+
+    //rounds depend on each other; the user program may access more memory
+    //via addresses, thus sync all of it
+    vulkan::GlobalBarrier toRound{
+        .srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+        .srcAccess = VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        .dstStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR |
+            VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR,
+        .dstAccess = VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR |
+            VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR
+    };
+    vulkan::GlobalBarrier toRefill{
+        .srcStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+        .srcAccess = VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        .dstStage = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+        .dstAccess = VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR
+    };
+    auto refill = [&](bool advance) {
+        auto push = state->refillPush;
+        push.advance = advance ? 1u : 0u;
+        DispatchCommand(state->refill->getProgram(), 1, 1, 1,
+            { reinterpret_cast<const std::byte*>(&push), sizeof(RefillPush) })
+            .record(cmd);
+    };
+
+    //size the first round
+    refill(false);
+    for (auto i = 0u; i < state->rounds; ++i) {
+        vulkan::pipelineBarrier(context, cmd, {}, { &toRound, 1 });
+        state->dispatch->record(cmd);
+        vulkan::pipelineBarrier(context, cmd, {}, { &toRefill, 1 });
+        refill(true);
+    }
+}
+
+WorkQueueCommand::WorkQueueCommand(const WorkQueueCommand&) = default;
+WorkQueueCommand& WorkQueueCommand::operator=(const WorkQueueCommand&) = default;
+
+WorkQueueCommand::WorkQueueCommand(WorkQueueCommand&&) noexcept = default;
+WorkQueueCommand& WorkQueueCommand::operator=(WorkQueueCommand&&) noexcept = default;
+
+WorkQueueCommand::~WorkQueueCommand() = default;
+
+WorkQueueCommand::WorkQueueCommand(std::shared_ptr<const State> state)
+    : state(std::move(state))
+{}
+
+/********************************* WORK QUEUE *********************************/
+
+struct WorkQueue::pImp {
+    ContextHandle context;
+    uint32_t capacity;
+    Tensor<std::byte> tensor;
+    Program seed;
+    Program refill;
+
+    pImp(ContextHandle context, uint32_t capacity)
+        : context(std::move(context))
+        , capacity(capacity)
+        , tensor(this->context, sizeof(WorkQueueHeader) + 8ull * capacity)
+        , seed(vulkan::compileKernel(this->context, SeedSource))
+        , refill(vulkan::compileKernel(this->context, RefillSource))
+    {}
+};
+
+uint32_t WorkQueue::getCapacity() const noexcept {
+    return _pImp->capacity;
+}
+const Tensor<std::byte>& WorkQueue::getTensor() const noexcept {
+    return _pImp->tensor;
+}
+uint64_t WorkQueue::getAddress() const noexcept {
+    return _pImp->tensor.address();
+}
+
+uint32_t WorkQueue::getOccupancy(const Program& program) const {
+    auto units = getDeviceInfo(_pImp->context).computeUnits;
+    if (units == 0)
+        units = DefaultComputeUnits;
+    return units * program.getStatistics().residentGroups;
+}
+
+WorkQueueCommand WorkQueue::seed(uint32_t count, uint32_t first) const {
+    if (count > _pImp->capacity)
+        throw std::out_of_range("Seed exceeds the capacity of the queue!");
+
+    auto state = std::make_shared<WorkQueueCommand::State>();
+    state->context = _pImp->context;
+    state->tensors.push_back(_pImp->tensor);
+    state->seed = &_pImp->seed;
+    state->seedGroups = std::max((count + SeedLocalSize - 1) / SeedLocalSize, 1u);
+    state->seedPush = {
+        .queue = getAddress(),
+        .items = 0,
+        .first = first,
+        .count = count,
+        .capacity = _pImp->capacity,
+        .fromItems = 0
+    };
+    return WorkQueueCommand(std::move(state));
+}
+
+WorkQueueCommand WorkQueue::seed(
+    const Tensor<std::byte>& items, std::optional<uint32_t> count) const
+{
+    auto n = count.value_or(static_cast<uint32_t>(
+        std::min<uint64_t>(items.size_bytes() / 4, _pImp->capacity + 1ull)));
+    if (4ull * n > items.size_bytes())
+        throw std::out_of_range("Seed exceeds the size of the items tensor!");
+    if (n > _pImp->capacity)
+        throw std::out_of_range("Seed exceeds the capacity of the queue!");
+
+    auto state = std::make_shared<WorkQueueCommand::State>();
+    state->context = _pImp->context;
+    state->tensors.push_back(_pImp->tensor);
+    state->tensors.push_back(items);
+    state->seed = &_pImp->seed;
+    state->seedGroups = std::max((n + SeedLocalSize - 1) / SeedLocalSize, 1u);
+    state->seedPush = {
+        .queue = getAddress(),
+        .items = items.address(),
+        .first = 0,
+        .count = n,
+        .capacity = _pImp->capacity,
+        .fromItems = 1
+    };
+    return WorkQueueCommand(std::move(state));
+}
+
+WorkQueueCommand WorkQueue::launch(
+    const Program& program,
+    std::span<const std::byte> push,
+    uint32_t rounds,
+    uint32_t maxGroups) const
+{
+    auto& local = program.getLocalSize();
+    auto threads = std::max(local.x * local.y * local.z, 1u);
+    if (maxGroups == 0)
+        maxGroups = getOccupancy(program);
+
+    auto state = std::make_shared<WorkQueueCommand::State>();
+    state->context = _pImp->context;
+    state->tensors.push_back(_pImp->tensor);
+    state->refill = &_pImp->refill;
+    state->refillPush = {
+        .queue = getAddress(),
+        .itemsPerGroup = threads,
+        .maxGroups = maxGroups,
+        .advance = 0,
+        ._padding = 0
+    };
+    state->rounds = rounds;
+    state->push.assign(push.begin(), push.end());
+    state->dispatch.emplace(program.dispatchIndirect(
+        std::span<const std::byte>(state->push), _pImp->tensor, 0));
+    return WorkQueueCommand(std::move(state));
+}
+
+WorkQueue::WorkQueue(WorkQueue&& other) noexcept = default;
+WorkQueue& WorkQueue::operator=(WorkQueue&& other) noexcept = default;
+
+WorkQueue::WorkQueue(ContextHandle context, uint32_t capacity)
+    : _pImp(std::make_unique<pImp>(std::move(context), capacity))
+{
+    if (capacity == 0)
+        throw std::logic_error("Work queue requires a capacity of at least one!");
+}
+WorkQueue::~WorkQueue() = default;
+
+std::string_view getWorkQueueSource() noexcept {
+    return WorkQueueSource;
+}
+
+}
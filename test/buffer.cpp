@@ -2,7 +2,12 @@
 
 #include <algorithm>
 #include <array>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <stdexcept>
 #include <tuple>
+#include <vector>
 
 #include <hephaistos/buffer.hpp>
 #include <hephaistos/command.hpp>
@@ -108,6 +113,94 @@ TEST_CASE("mapped tensors can be copied to and from", "[buffer]") {
     REQUIRE(!hasValidationErrorOccurred());
 }
 
+TEST_CASE("non mapped tensors can be copied to and from", "[buffer]") {
+    std::array<int, 10> dst;
+
+    Tensor<int> tensor(getContext(), 10);
+    tensor.update(data);
+    tensor.retrieve(dst);
+
+    REQUIRE(std::equal(data.begin(), data.end(), dst.begin()));
+
+    //larger than a single staging range
+    std::vector<int> large(1'000'000);
+    for (size_t i = 0; i < large.size(); ++i)
+        large[i] = static_cast<int>(i);
+    std::vector<int> largeDst(large.size());
+    Tensor<int> largeTensor(getContext(), large.size());
+    largeTensor.update(large);
+    largeTensor.retrieve(largeDst);
+
+    REQUIRE(large == largeDst);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("tensors can be copied to and from asynchronously", "[buffer]") {
+    Tensor<int> tensor(getContext(), 10);
+    Buffer<int> buffer(getContext(), 10);
+    {
+        //source can be reused right away
+        auto src = data;
+        auto update = tensor.updateAsync(src);
+        src.fill(0);
+        update.wait();
+    }
+    tensor.retrieveAsync(buffer).wait();
+    auto mem = buffer.getMemory();
+    REQUIRE(std::equal(data.begin(), data.end(), mem.begin()));
+
+    //larger than a single staging range and thus split into submissions
+    std::vector<int> large(3'000'000);
+    for (size_t i = 0; i < large.size(); ++i)
+        large[i] = static_cast<int>(i);
+    Tensor<int> largeTensor(getContext(), large.size());
+    Buffer<int> largeBuffer(getContext(), large.size());
+    auto update = largeTensor.updateAsync(large);
+    //queue ordering makes the retrieval wait for the update
+    largeTensor.retrieveAsync(largeBuffer).wait();
+    auto largeMem = largeBuffer.getMemory();
+    REQUIRE(std::equal(large.begin(), large.end(), largeMem.begin()));
+
+    REQUIRE_THROWS(tensor.updateAsync(large));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("multiple tensors can be updated in a single batch", "[buffer]") {
+    Tensor<int> small(getContext(), data.size());
+    Tensor<int> offsetTensor(getContext(), 2 * data.size());
+    //larger than a single staging range and thus split into submissions
+    std::vector<int> large(1'000'000);
+    for (size_t i = 0; i < large.size(); ++i)
+        large[i] = static_cast<int>(i);
+    Tensor<int> largeTensor(getContext(), large.size());
+
+    std::array<TensorUpdate, 3> updates = { {
+        { small, std::as_bytes(std::span(data)) },
+        { largeTensor, std::as_bytes(std::span(large)) },
+        { offsetTensor, std::as_bytes(std::span(data)), sizeof(int) * data.size() }
+    } };
+    updateTensors(updates);
+
+    Buffer<int> buffer(getContext(), data.size());
+    small.retrieveAsync(buffer).wait();
+    REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
+    offsetTensor.retrieveAsync(buffer, data.size()).wait();
+    REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
+    Buffer<int> largeBuffer(getContext(), large.size());
+    largeTensor.retrieveAsync(largeBuffer).wait();
+    auto largeMem = largeBuffer.getMemory();
+    REQUIRE(std::equal(large.begin(), large.end(), largeMem.begin()));
+
+    std::array<TensorUpdate, 1> outside = { {
+        { small, std::as_bytes(std::span(large)) }
+    } };
+    REQUIRE_THROWS_AS(updateTensors(outside), std::logic_error);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
 TEST_CASE("buffers and tensors can be copied into each other", "[buffer]") {
     Buffer<int> bufferIn(getContext(), 10);
     Buffer<int> bufferOut(getContext(), 10);
@@ -118,7 +211,7 @@ TEST_CASE("buffers and tensors can be copied into each other", "[buffer]") {
     beginSequence(timeline)
         .And(updateTensor(bufferIn, tensor))
         .Then(retrieveTensor(tensor, bufferOut))
-        .Submit();
+        .Submit().wait();
     
     REQUIRE(std::equal(data.begin(), data.end(), bufferOut.getMemory().begin()));
 
@@ -139,7 +232,7 @@ TEST_CASE("unsafe copies are supported", "[buffer]") {
     beginSequence(timeline)
         .And(updateTensor(bufferIn, tensor, { .unsafe = true }))
         .Then(retrieveTensor(tensor, bufferOut, { .unsafe = true }))
-        .Submit();
+        .Submit().wait();
 
     REQUIRE(std::equal(data.begin(), data.end(), bufferOut.getMemory().begin()));
 
@@ -158,7 +251,7 @@ TEST_CASE("subregions of buffer and tensors can be copied into each other", "[bu
         .And(updateTensor(bufferIn, tensor, { .bufferOffset = 20, .size = 20 }))
         .And(updateTensor(bufferIn, tensor, { .tensorOffset = 20, .size = 20 }))
         .Then(retrieveTensor(tensor, bufferOut, { .bufferOffset = 8, .tensorOffset = 12, .size = 24 }))
-        .Submit();
+        .Submit().wait();
 
     auto scrambled = std::to_array({
         0, 0, 1500, -45123, 10, -5, 6, 45, 0, 0 
@@ -168,6 +261,97 @@ TEST_CASE("subregions of buffer and tensors can be copied into each other", "[bu
     REQUIRE(!hasValidationErrorOccurred());
 }
 
+TEST_CASE("multiple regions can be copied with a single command", "[buffer]") {
+    Buffer<int> bufferIn(getContext(), 10);
+    Buffer<int> bufferOut(getContext(), 10);
+    Tensor<int> tensor(getContext(), 10);
+
+    std::copy(data.begin(), data.end(), bufferIn.getMemory().data());
+    std::memset(bufferOut.getMemory().data(), 0, 40);
+
+    //first two regions are adjacent and get merged
+    auto scatter = std::to_array<CopyRegion>({
+        { .bufferOffset = 0, .tensorOffset = 24, .size = 8 },
+        { .bufferOffset = 8, .tensorOffset = 32, .size = 8 },
+        { .bufferOffset = 16, .tensorOffset = 0, .size = 12 },
+        { .bufferOffset = 28, .tensorOffset = 12, .size = 12 }
+    });
+    auto gather = std::to_array<CopyRegion>({
+        { .bufferOffset = 4, .tensorOffset = 0, .size = 24 },
+        { .bufferOffset = 28, .tensorOffset = 32, .size = 8 },
+        //empty regions are skipped
+        { .bufferOffset = 0, .tensorOffset = 0, .size = 0 }
+    });
+    beginSequence(getContext())
+        .And(updateTensor(bufferIn, tensor, scatter))
+        .Then(retrieveTensor(tensor, bufferOut, gather))
+        .Submit().wait();
+
+    auto scrambled = std::to_array({
+        0, 12, 122, 2'147'483'647, 789, 1500, -45123, 6, 45, 0
+    });
+    REQUIRE(std::equal(scrambled.begin(), scrambled.end(), bufferOut.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("large copies can be split into chunks", "[buffer]") {
+    Buffer<int> bufferIn(getContext(), 10);
+    Buffer<int> bufferOut(getContext(), 10);
+    Tensor<int> tensor(getContext(), 10);
+    std::copy(data.begin(), data.end(), bufferIn.getMemory().data());
+
+    //last chunk is smaller
+    auto updates = updateTensorChunked(bufferIn, tensor, 12);
+    REQUIRE(updates.size() == 4);
+    REQUIRE(updates.back().regions.front().size == 4);
+    auto builder = beginSequence(getContext());
+    for (auto& update : updates)
+        builder.Then(update);
+    builder.Submit().wait();
+
+    //chunks arrive in order
+    std::vector<uint64_t> offsets;
+    std::vector<std::byte> received;
+    retrieveTensorStreamed(tensor, bufferOut, 12,
+        [&](uint64_t offset, std::span<const std::byte> chunk) {
+            offsets.push_back(offset);
+            received.insert(received.end(), chunk.begin(), chunk.end());
+        });
+    auto expected = std::to_array<uint64_t>({ 0, 12, 24, 36 });
+    REQUIRE(std::equal(offsets.begin(), offsets.end(), expected.begin(), expected.end()));
+    auto bytes = std::as_bytes(std::span<const int>(data));
+    REQUIRE(std::equal(bytes.begin(), bytes.end(), received.begin(), received.end()));
+
+    REQUIRE_THROWS_AS(retrieveTensorChunked(tensor, bufferOut, 0), std::logic_error);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("tensors can be copied into each other on the device", "[buffer]") {
+    Buffer<int> bufferOut(getContext(), 10);
+    Tensor<int> tensorIn(getContext(), data);
+    Tensor<int> tensorOut(getContext(), 10);
+
+    auto regions = std::to_array<TensorCopyRegion>({
+        { .sourceOffset = 0, .destinationOffset = 20, .size = 20 },
+        { .sourceOffset = 20, .destinationOffset = 0, .size = 20 }
+    });
+    beginSequence(getContext())
+        .And(copyTensor(tensorIn, tensorOut, regions))
+        //self copies are fine as long as the regions do not overlap
+        .Then(copyTensor(tensorOut, tensorOut, { .sourceOffset = 0, .destinationOffset = 32, .size = 8 }))
+        .Then(retrieveTensor(tensorOut, bufferOut))
+        .Submit().wait();
+
+    auto swapped = std::to_array({
+        122, 2'147'483'647, 789, 1500, -45123, 10, -5, 6, 122, 2'147'483'647
+    });
+    REQUIRE(std::equal(swapped.begin(), swapped.end(), bufferOut.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
 TEST_CASE("tensors can be initialized with data", "[buffer]") {
     Tensor<int> tensor(getContext(), data);
     Buffer<int> buffer(getContext(), tensor.size());
@@ -181,7 +365,7 @@ TEST_CASE("tensors can be initialized with data", "[buffer]") {
     Timeline timeline(getContext());
     beginSequence(timeline)
         .And(retrieveTensor(tensor, buffer))
-        .Submit();
+        .Submit().wait();
     
     //compare data
     REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
@@ -189,6 +373,79 @@ TEST_CASE("tensors can be initialized with data", "[buffer]") {
     REQUIRE(!hasValidationErrorOccurred());
 }
 
+TEST_CASE("tensors can be allocated using hints", "[buffer]") {
+    Buffer<int> buffer(getContext(), 10);
+    Tensor<int> hot(getContext(), 10, AllocationHints{
+        .priority = 1.0f,
+        .placement = MemoryPlacement::PREFER_DEVICE
+    });
+    Tensor<int> cold(getContext(), 10, AllocationHints{
+        .priority = 0.0f,
+        .placement = MemoryPlacement::PREFER_HOST,
+        .dedicated = true
+    });
+    Tensor<int> pooled(getContext(), 10);
+
+    std::copy(data.begin(), data.end(), buffer.getMemory().begin());
+    beginSequence(getContext())
+        .And(updateTensor(buffer, hot))
+        .Then(copyTensor(hot, cold))
+        .Then(copyTensor(cold, pooled))
+        .Then(retrieveTensor(pooled, buffer))
+        .Submit().wait();
+    REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("tensors can be mapped automatically on unified memory", "[buffer]") {
+    setTensorAutoMapping(getContext(), true);
+    REQUIRE(getTensorAutoMapping(getContext()));
+    Tensor<int> tensor(getContext(), 10);
+    setTensorAutoMapping(getContext(), false);
+
+    REQUIRE(tensor.isMapped() == isUnifiedMemorySupported(getContext()));
+    tensor.update(data);
+    std::array<int, 10> result{};
+    tensor.retrieve(result);
+    REQUIRE(result == data);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("tensors can be allocated on first use", "[buffer]") {
+    setTensorLazyAllocation(getContext(), true);
+    REQUIRE(getTensorLazyAllocation(getContext()));
+    Tensor<int> initialized(getContext(), std::span<const int>(data));
+    Tensor<int> unused(getContext(), 1 << 20);
+    Tensor<int> other(getContext(), 10);
+    setTensorLazyAllocation(getContext(), false);
+    Tensor<int> eager(getContext(), 10);
+
+    REQUIRE(!initialized.isAllocated());
+    REQUIRE(!unused.isAllocated());
+    REQUIRE(!other.isAllocated());
+    REQUIRE(eager.isAllocated());
+    REQUIRE(unused.size() == 1 << 20);
+
+    //recording allocates and uploads the initial data
+    Buffer<int> buffer(getContext(), 10);
+    beginSequence(getContext())
+        .And(copyTensor(initialized, other))
+        .Then(retrieveTensor(other, buffer))
+        .Submit().wait();
+    REQUIRE(initialized.isAllocated());
+    REQUIRE(other.isAllocated());
+    REQUIRE(!unused.isAllocated());
+    REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
+
+    //querying the address allocates as well
+    REQUIRE(unused.address() != 0);
+    REQUIRE(unused.isAllocated());
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
 TEST_CASE("tensors have a device address", "[buffer]") {
     Tensor<int> tensor(getContext(), 16);
 
@@ -207,14 +464,14 @@ TEST_CASE("tensors can be filled with constant data", "[buffer]") {
     beginSequence(getContext())
         .And(clearTensor(tensor, { .data = 5 }))
         .Then(retrieveTensor(tensor, buffer))
-        .Submit();
+        .Submit().wait();
 
     REQUIRE(std::all_of(mem.begin(), mem.end(), [](int i) -> bool { return i == 5; }));
 
     beginSequence(getContext())
         .And(clearTensor(tensor, { .offset = 32, .size = 16, .data = 12 }))
         .Then(retrieveTensor(tensor, buffer))
-        .Submit();
+        .Submit().wait();
 
     std::array<int, 16> data{ {
         5, 5, 5, 5,
@@ -224,3 +481,397 @@ TEST_CASE("tensors can be filled with constant data", "[buffer]") {
     } };
     REQUIRE(std::equal(data.begin(), data.end(), mem.begin()));
 }
+
+TEST_CASE("tensors can be filled with wide patterns", "[buffer]") {
+    struct Item {
+        float value;
+        uint32_t count;
+        uint32_t flags;
+    };
+    //large enough to need multiple copies after the seed
+    constexpr auto N = 4000;
+    Tensor<Item> tensor(getContext(), N);
+    Buffer<Item> buffer(getContext(), N);
+    auto mem = buffer.getMemory();
+
+    Item item{ 1.5f, 7, 0xFFu };
+    beginSequence(getContext())
+        .And(fillTensor(tensor, item))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    REQUIRE(std::all_of(mem.begin(), mem.end(), [](const Item& i) {
+        return i.value == 1.5f && i.count == 7 && i.flags == 0xFFu;
+    }));
+
+    //4 byte patterns and partial ranges
+    uint32_t word = 42;
+    execute(getContext(), fillTensor(tensor, word,
+        { .offset = sizeof(Item), .size = sizeof(Item) }));
+    execute(getContext(), retrieveTensor(tensor, buffer));
+    REQUIRE(mem[0].count == 7);
+    REQUIRE(mem[1].count == 42);
+    REQUIRE(mem[1].flags == 42);
+    REQUIRE(mem[2].count == 7);
+
+    std::array<std::byte, 3> odd{};
+    REQUIRE_THROWS(fillTensor(tensor, std::span<const std::byte>(odd)));
+    REQUIRE_THROWS(fillTensor(tensor, item, { .size = 16 }));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("small tensors can be sub-allocated from shared buffers", "[buffer]") {
+    setTensorPoolThreshold(getContext(), 256);
+    REQUIRE(getTensorPoolThreshold(getContext()) == 256);
+
+    Tensor<int> a(getContext(), 16);
+    Tensor<int> b(getContext(), 16, true);
+    Tensor<int> c(getContext(), 16);
+    Tensor<int> large(getContext(), 128);
+    setTensorPoolThreshold(getContext(), 0);
+    Tensor<int> dedicated(getContext(), 16);
+
+    REQUIRE(a.isPooled());
+    REQUIRE(b.isPooled());
+    REQUIRE(c.isPooled());
+    REQUIRE(!large.isPooled());
+    REQUIRE(!dedicated.isPooled());
+    //tensors sharing a buffer must not share their range
+    REQUIRE(a.address() != c.address());
+
+    if (b.isMapped()) {
+        std::fill(b.getMemory().begin(), b.getMemory().end(), 7);
+        b.flush();
+    }
+
+    Buffer<int> bufferA(getContext(), 16);
+    Buffer<int> bufferC(getContext(), 16);
+    beginSequence(getContext())
+        .And(clearTensor(a, { .data = 3 }))
+        .And(clearTensor(c, { .data = 4 }))
+        .Then(retrieveTensor(a, bufferA))
+        .And(retrieveTensor(c, bufferC))
+        .Submit().wait();
+
+    //clearing one must not touch its neighbours
+    REQUIRE(std::all_of(bufferA.getMemory().begin(), bufferA.getMemory().end(),
+        [](int v) { return v == 3; }));
+    REQUIRE(std::all_of(bufferC.getMemory().begin(), bufferC.getMemory().end(),
+        [](int v) { return v == 4; }));
+    if (b.isMapped()) {
+        b.invalidate();
+        REQUIRE(std::all_of(b.getMemory().begin(), b.getMemory().end(),
+            [](int v) { return v == 7; }));
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("memory statistics track allocations", "[buffer]") {
+    auto before = getMemoryStatistics(getContext());
+    REQUIRE(!before.heaps.empty());
+    for (auto& heap : before.heaps) {
+        REQUIRE(heap.size > 0);
+        REQUIRE(heap.allocationBytes <= heap.blockBytes);
+    }
+
+    Tensor<int> tensor(getContext(), 1'000'000);
+    auto after = getMemoryStatistics(getContext());
+
+    REQUIRE(after.allocationCount == before.allocationCount + 1);
+    REQUIRE(after.allocationBytes >= before.allocationBytes + tensor.size_bytes());
+    REQUIRE(std::any_of(after.heaps.begin(), after.heaps.end(),
+        [](const HeapStatistics& heap) { return heap.usage > 0 && heap.budget > 0; }));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("defragmentation keeps the content of tensors", "[buffer]") {
+    //fragment memory by freeing every other tensor
+    std::vector<Tensor<int>> tensors;
+    for (int i = 0; i < 16; ++i) {
+        std::vector<int> content(16'384, i);
+        tensors.emplace_back(getContext(), content);
+    }
+    std::vector<Tensor<int>> kept;
+    std::vector<uint64_t> addresses;
+    for (size_t i = 0; i < tensors.size(); i += 2) {
+        addresses.push_back(tensors[i].address());
+        kept.push_back(std::move(tensors[i]));
+    }
+    tensors.clear();
+
+    uint32_t moved = 0;
+    auto result = defragmentTensors(getContext(),
+        [&](uint64_t oldAddress, uint64_t newAddress, uint64_t size) {
+            auto it = std::find(addresses.begin(), addresses.end(), oldAddress);
+            REQUIRE(it != addresses.end());
+            *it = newAddress;
+            ++moved;
+        });
+    REQUIRE(moved == result.tensorsMoved);
+
+    for (size_t i = 0; i < kept.size(); ++i) {
+        REQUIRE(kept[i].address() == addresses[i]);
+        std::vector<int> content(kept[i].size());
+        kept[i].retrieve(content);
+        REQUIRE(std::all_of(content.begin(), content.end(),
+            [i](int v) { return v == static_cast<int>(2 * i); }));
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("scratch tensors with disjoint lifetimes share memory", "[buffer]") {
+    ScratchAllocator scratch(getContext());
+    auto a = scratch.declare(4096, 0, 1);
+    auto b = scratch.declare(4096, 1, 3);
+    auto c = scratch.declare(4096, 2, 3);
+    REQUIRE(scratch.size() == 3);
+    REQUIRE(scratch.declared_bytes() == 3 * 4096);
+    REQUIRE_THROWS(scratch.get(a));
+
+    scratch.allocate();
+    REQUIRE(scratch.isAllocated());
+    //a and c never live at the same time
+    REQUIRE(scratch.size_bytes() < scratch.declared_bytes());
+    REQUIRE(scratch.get(a).address() == scratch.get(c).address());
+    REQUIRE(scratch.get(a).address() != scratch.get(b).address());
+    REQUIRE_THROWS(scratch.declare(16, 0, 0));
+
+    Buffer<int> bufferA(getContext(), 1024);
+    Buffer<int> bufferB(getContext(), 1024);
+    Buffer<int> bufferC(getContext(), 1024);
+    beginSequence(getContext())
+        .And(clearTensor(scratch.get(a), { .data = 1 }))
+        .Then(retrieveTensor(scratch.get(a), bufferA))
+        .And(clearTensor(scratch.get(b), { .data = 5 }))
+        .Then(clearTensor(scratch.get(c), { .data = 2 }))
+        .Then(retrieveTensor(scratch.get(b), bufferB))
+        .And(retrieveTensor(scratch.get(c), bufferC))
+        .Submit().wait();
+
+    auto all = [](const Buffer<int>& buffer, int value) {
+        return std::all_of(buffer.getMemory().begin(), buffer.getMemory().end(),
+            [value](int v) { return v == value; });
+    };
+    REQUIRE(all(bufferA, 1));
+    //b must not be overwritten by c
+    REQUIRE(all(bufferB, 5));
+    REQUIRE(all(bufferC, 2));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("buffers can import host memory", "[buffer]") {
+    auto alignment = getHostMemoryImportAlignment(getContext());
+    if (!isHostMemoryImportSupported(getContext())) {
+        REQUIRE(alignment == 0);
+        SKIP("device does not support importing host memory");
+    }
+
+    auto count = alignment / sizeof(int);
+    auto memory = static_cast<int*>(::operator new(alignment, std::align_val_t(alignment)));
+    std::span<int> span(memory, count);
+    for (size_t i = 0; i < count; ++i)
+        span[i] = static_cast<int>(i);
+    {
+        Buffer<int> buffer(getContext(), span, import_host_memory);
+        REQUIRE(buffer.getMemory().data() == memory);
+
+        //device reads from and writes to the imported memory
+        Tensor<int> tensor(buffer);
+        std::fill(span.begin(), span.end(), 0);
+        execute(getContext(), retrieveTensor(tensor, buffer));
+        for (size_t i = 0; i < count; ++i)
+            REQUIRE(span[i] == static_cast<int>(i));
+    }
+
+    //misaligned memory is rejected
+    REQUIRE_THROWS(Buffer<int>(getContext(),
+        std::span<int>(memory + 1, count - 1), import_host_memory));
+    ::operator delete(memory, std::align_val_t(alignment));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("buffers can be backed by mapped files", "[buffer]") {
+    auto path = std::filesystem::temp_directory_path() / "hephaistos_mapped_file.bin";
+    {
+        std::ofstream file(path, std::ios::binary);
+        auto header = std::to_array({ 0xdead, 0xbeef });
+        file.write(reinterpret_cast<const char*>(header.data()), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), sizeof(data));
+    }
+
+    {
+        //skip the header
+        MappedFileBuffer mapped(getContext(), path, 8);
+        REQUIRE(mapped.size_bytes() == 40);
+        Tensor<int> tensor(getContext(), 10);
+        Buffer<int> buffer(getContext(), 10);
+
+        beginSequence(getContext())
+            .And(updateTensor(mapped, tensor))
+            .Then(retrieveTensor(tensor, buffer))
+            .Submit().wait();
+        REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
+
+        REQUIRE_THROWS(MappedFileBuffer(getContext(), path, 8, 48));
+    }
+    std::filesystem::remove(path);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("pinned buffers allocate host memory following a policy", "[buffer]") {
+    auto policies = std::to_array<HostAllocationPolicy>({
+        {},
+        { .localNumaNode = false },
+        { .hugePages = HugePages::TRANSPARENT }
+    });
+    for (auto& policy : policies) {
+        //odd size to cover rounding up to whole pages
+        PinnedBuffer pinned(getContext(), sizeof(data) + 3, policy);
+        REQUIRE(pinned.size_bytes() == sizeof(data) + 3);
+        REQUIRE(pinned.isImported() == isHostMemoryImportSupported(getContext()));
+        if (!policy.localNumaNode || !pinned.isImported())
+            REQUIRE(pinned.getNumaNode() == -1);
+        if (pinned.getNumaNode() >= 0)
+            REQUIRE(pinned.getNumaNode() == getDeviceNumaNode(getContext()));
+        if (policy.hugePages == HugePages::NONE)
+            REQUIRE(pinned.getHugePages() == HugePages::NONE);
+
+        std::copy(data.begin(), data.end(), reinterpret_cast<int*>(pinned.getMemory().data()));
+        Tensor<int> tensor(getContext(), 10);
+        Buffer<int> buffer(getContext(), 10);
+        beginSequence(getContext())
+            .And(updateTensor(pinned, tensor))
+            .Then(retrieveTensor(tensor, buffer))
+            .Submit().wait();
+        REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
+    }
+
+    REQUIRE_THROWS(PinnedBuffer(getContext(), 0));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("upload buffers can be written and copied to tensors", "[buffer]") {
+    //odd size to cover the tail not handled by streaming stores
+    std::vector<uint8_t> values(1000);
+    for (auto i = 0u; i < values.size(); ++i)
+        values[i] = static_cast<uint8_t>(i * 7);
+
+    UploadBuffer upload(getContext(), values.size() + 3);
+    //unaligned offset
+    upload.write(std::as_bytes(std::span(values)), 3);
+    REQUIRE_THROWS(upload.write(std::as_bytes(std::span(values)), 4));
+
+    Tensor<uint8_t> tensor(getContext(), values.size());
+    Buffer<uint8_t> buffer(getContext(), values.size());
+    beginSequence(getContext())
+        .And(updateTensor(upload, tensor, { .bufferOffset = 3, .size = values.size() }))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    REQUIRE(std::equal(values.begin(), values.end(), buffer.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("sparse tensors commit memory on demand", "[buffer]") {
+    if (!isSparseTensorSupported(getContext()))
+        SKIP("device does not support sparse tensors");
+
+    SparseTensor tensor(getContext(), 1024 * 1024 * 4);
+    auto pageSize = tensor.getPageSize();
+    REQUIRE(pageSize > 0);
+    REQUIRE(tensor.size_committed() == 0);
+    REQUIRE(!tensor.isCommitted(0, 4));
+
+    //ranges get extended to whole pages
+    tensor.commit(pageSize + 4, 8);
+    REQUIRE(tensor.size_committed() == pageSize);
+    REQUIRE(tensor.isCommitted(pageSize, pageSize));
+    REQUIRE(!tensor.isCommitted(pageSize, pageSize + 4));
+    //committing again does not allocate more
+    tensor.commit(pageSize, pageSize);
+    REQUIRE(tensor.size_committed() == pageSize);
+
+    //without residency the whole tensor must be committed before use
+    if (!isSparseResidencySupported(getContext()))
+        tensor.commit();
+    Buffer<uint32_t> buffer(getContext(), pageSize / 4);
+    execute(getContext(), clearTensor(tensor, { .offset = pageSize, .size = pageSize, .data = 7 }));
+    execute(getContext(), retrieveTensor(tensor, buffer, { .tensorOffset = pageSize, .size = pageSize }));
+    auto mem = buffer.getMemory();
+    REQUIRE(std::all_of(mem.begin(), mem.end(), [](uint32_t v) { return v == 7; }));
+
+    //only whole pages get released
+    auto committed = tensor.size_committed();
+    tensor.decommit(pageSize + 4, pageSize);
+    REQUIRE(tensor.size_committed() == committed);
+    tensor.decommit();
+    REQUIRE(tensor.size_committed() == 0);
+
+    REQUIRE_THROWS(tensor.commit(tensor.size_bytes(), 4));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("growable tensors keep their content when growing", "[buffer]") {
+    GrowableTensor tensor(getContext(), sizeof(data));
+    REQUIRE(tensor.size_bytes() == sizeof(data));
+    REQUIRE(tensor.capacity() >= sizeof(data));
+    tensor.update(std::as_bytes(std::span(data)));
+
+    //grows at least geometrically
+    auto capacity = tensor.capacity();
+    tensor.resize(capacity + 4);
+    REQUIRE(tensor.size_bytes() == capacity + 4);
+    REQUIRE(tensor.capacity() >= 2 * capacity);
+    //shrinking keeps the memory
+    capacity = tensor.capacity();
+    tensor.resize(sizeof(data));
+    REQUIRE(tensor.capacity() == capacity);
+
+    std::array<int, 10> dst;
+    tensor.retrieve(std::as_writable_bytes(std::span(dst)));
+    REQUIRE(dst == data);
+
+    //address slot follows the tensor
+    Buffer<uint64_t> address(getContext(), 1);
+    execute(getContext(), retrieveTensor(tensor.getAddressSlot(), address));
+    REQUIRE(address.getMemory()[0] == tensor.address());
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("tensor views bind sub-ranges of tensors", "[buffer]") {
+    //minStorageBufferOffsetAlignment is at most 256
+    Tensor<std::byte> tensor(getContext(), 1024);
+
+    TensorView whole(tensor);
+    REQUIRE(whole.offset() == 0);
+    REQUIRE(whole.size_bytes() == 1024);
+    REQUIRE(whole.address() == tensor.address());
+
+    TensorView view(tensor, 256, 512);
+    REQUIRE(view.offset() == 256);
+    REQUIRE(view.size_bytes() == 512);
+    REQUIRE(view.address() == tensor.address() + 256);
+    REQUIRE(&view.getTensor() == &tensor);
+
+    //copies are independent
+    TensorView copy(view);
+    copy = whole;
+    REQUIRE(copy.size_bytes() == 1024);
+    REQUIRE(view.size_bytes() == 512);
+    TensorView moved(std::move(view));
+    REQUIRE(moved.address() == tensor.address() + 256);
+
+    REQUIRE_THROWS(TensorView(tensor, 1024));
+    REQUIRE_THROWS(TensorView(tensor, 768, 512));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
@@ -0,0 +1,77 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#include <hephaistos/buffer.hpp>
+#include <hephaistos/capture.hpp>
+#include <hephaistos/compiler.hpp>
+#include <hephaistos/context.hpp>
+
+#include "validation.hpp"
+
+using namespace hephaistos;
+
+namespace {
+
+ContextHandle getContext() {
+    static ContextHandle context = createEmptyContext();
+    if (!context)
+        context = createContext();
+    return context;
+}
+
+constexpr auto increment_source = R"(
+    #version 460
+
+    layout(local_size_x = 4) in;
+
+    buffer tensor { int values[]; };
+
+    void main() {
+        values[gl_GlobalInvocationID.x] += 1;
+    }
+)";
+
+}
+
+TEST_CASE("captures round trip and can be replayed", "[capture]") {
+    Compiler compiler;
+    auto code = compiler.compile(increment_source);
+    auto data = std::to_array<int32_t>({ 1, 2, 3, 4 });
+    Tensor<int32_t> tensor(getContext(), data);
+
+    Capture capture;
+    auto program = capture.addProgram(code);
+    auto values = capture.addTensor(tensor);
+    capture.dispatch({ .program = program, .tensors = { values } })
+        .nextStep()
+        .nextStep()
+        .dispatch({ .program = program, .tensors = { values } });
+    REQUIRE(capture.getSteps().size() == 2);
+    REQUIRE(std::equal(capture.getTensorData(values).begin(), capture.getTensorData(values).end(),
+        std::as_bytes(std::span(data)).begin()));
+    REQUIRE_THROWS_AS(capture.dispatch({ .program = 1 }), std::out_of_range);
+    REQUIRE_THROWS_AS(capture.dispatch({ .program = 0, .tensors = { 1 } }), std::out_of_range);
+
+    auto path = std::filesystem::temp_directory_path() / "hephaistos_capture_test.bin";
+    capture.save(path);
+    Capture loaded(path);
+    std::filesystem::remove(path);
+    REQUIRE(loaded.serialize() == capture.serialize());
+    REQUIRE(loaded.getProgramCount() == 1);
+    REQUIRE(loaded.getTensorCount() == 1);
+
+    auto times = replayCapture(getContext(), loaded, { .warmup = 1, .iterations = 3 });
+    REQUIRE(times.size() == 3);
+    REQUIRE(std::all_of(times.begin(), times.end(), [](double t) { return t > 0.0; }));
+
+    auto corrupted = capture.serialize();
+    corrupted.pop_back();
+    REQUIRE_THROWS_AS(Capture(std::span<const std::byte>(corrupted)), std::runtime_error);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
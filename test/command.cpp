@@ -2,9 +2,24 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include <hephaistos/buffer.hpp>
 #include <hephaistos/command.hpp>
+#include <hephaistos/debug.hpp>
+#include <hephaistos/image.hpp>
+#include <hephaistos/scheduler.hpp>
+#include <hephaistos/stopwatch.hpp>
+#include <hephaistos/trace.hpp>
 
 #include "validation.hpp"
 
@@ -112,7 +127,7 @@ TEST_CASE("sequences can handle subroutines", "[command]") {
         .And(subA).And(retrieveTensor(tensor, buffer))
         .Then(subB).And(subC)
         .Then(retrieveTensor(tensor, buffer))
-        .Submit();
+        .Submit().wait();
 
     auto data = std::to_array<int>({ 19, 19, 7, 7, 7, 7, 23, 23 });
     REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().data()));
@@ -120,6 +135,69 @@ TEST_CASE("sequences can handle subroutines", "[command]") {
     REQUIRE(!hasValidationErrorOccurred());
 }
 
+TEST_CASE("sequences can be submitted in a single batch", "[command]") {
+    std::vector<Tensor<int>> tensors;
+    std::vector<Buffer<int>> buffers;
+    std::vector<SequenceBuilder> sequences;
+    for (auto i = 0; i < 4; ++i) {
+        tensors.emplace_back(getContext(), 8);
+        buffers.emplace_back(getContext(), 8);
+    }
+    Timeline timeline(getContext());
+    for (auto i = 0; i < 4; ++i) {
+        //one of them on an external timeline
+        auto sequence = i == 3 ? beginSequence(timeline) : beginSequence(getContext());
+        sequences.push_back(std::move(sequence)
+            .And(clearTensor(tensors[i], { .data = i + 1 }))
+            .Then(retrieveTensor(tensors[i], buffers[i])));
+    }
+
+    auto submissions = submitBatch(sequences);
+    REQUIRE(submissions.size() == 4);
+    REQUIRE(std::none_of(sequences.begin(), sequences.end(),
+        [](const SequenceBuilder& s) { return static_cast<bool>(s); }));
+    waitAll(submissions);
+    REQUIRE(timeline.getValue() == submissions.back().getFinalStep());
+
+    for (auto i = 0; i < 4; ++i) {
+        auto mem = buffers[i].getMemory();
+        REQUIRE(std::all_of(mem.begin(), mem.end(), [i](int v) { return v == i + 1; }));
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("sequences can run host steps between device steps", "[command]") {
+    Tensor<int> tensor(getContext(), 8);
+    Buffer<int> counter(getContext(), 8);
+    Buffer<int> params(getContext(), 8);
+    Buffer<int> result(getContext(), 8);
+
+    //host reads the result of the first step and writes the next parameters
+    std::atomic<bool> ran = false;
+    auto submission = beginSequence(getContext())
+        .And(clearTensor(tensor, { .data = 21 }))
+        .Then(retrieveTensor(tensor, counter))
+        .ThenHost([&]() {
+            auto in = counter.getMemory();
+            auto out = params.getMemory();
+            std::transform(in.begin(), in.end(), out.begin(), [](int v) { return 2 * v; });
+            ran = true;
+        })
+        .Then(updateTensor(params, tensor))
+        .Then(retrieveTensor(tensor, result))
+        .Submit();
+    submission.wait();
+
+    REQUIRE(ran);
+    auto mem = result.getMemory();
+    REQUIRE(std::all_of(mem.begin(), mem.end(), [](int v) { return v == 42; }));
+
+    REQUIRE_THROWS_AS(beginSequence(getContext()).ThenHost({}), std::logic_error);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
 TEST_CASE("one time submits can handle a list of commands", "[command]") {
     Tensor<int> tensor(getContext(), 8);
     Buffer<int> buffer(getContext(), 8);
@@ -135,3 +213,992 @@ TEST_CASE("one time submits can handle a list of commands", "[command]") {
 
     REQUIRE(!hasValidationErrorOccurred());
 }
+
+TEST_CASE("one time submits can be issued from multiple threads", "[command]") {
+    constexpr int N = 4;
+    std::vector<Tensor<int>> tensors;
+    std::vector<Buffer<int>> buffers;
+    for (int i = 0; i < N; ++i) {
+        tensors.emplace_back(getContext(), 8);
+        buffers.emplace_back(getContext(), 8);
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < N; ++i) {
+        threads.emplace_back([&tensor = tensors[i], &buffer = buffers[i], i]() {
+            for (int j = 0; j < 8; ++j) {
+                executeList(getContext(),
+                    clearTensor(tensor, { .data = static_cast<uint32_t>(i * 10 + j) }),
+                    retrieveTensor(tensor, buffer));
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    //Catch2 assertions are not thread safe -> check on main thread
+    for (int i = 0; i < N; ++i) {
+        auto mem = buffers[i].getMemory();
+        REQUIRE(std::all_of(mem.begin(), mem.end(),
+            [i](int v) { return v == i * 10 + 7; }));
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("subroutines and sequences can be used from multiple threads", "[command]") {
+    constexpr int N = 4;
+    std::vector<Tensor<int>> tensors;
+    std::vector<Buffer<int>> buffers;
+    for (int i = 0; i < N; ++i) {
+        tensors.emplace_back(getContext(), 8);
+        buffers.emplace_back(getContext(), 8);
+    }
+
+    //threads record and destroy subroutines while others submit
+    std::vector<std::thread> threads;
+    for (int i = 0; i < N; ++i) {
+        threads.emplace_back([&tensor = tensors[i], &buffer = buffers[i], i]() {
+            for (int j = 0; j < 8; ++j) {
+                auto sub = createSubroutine(getContext(),
+                    clearTensor(tensor, { .data = static_cast<uint32_t>(i * 10 + j) }));
+                beginSequence(getContext())
+                    .And(sub)
+                    .Then(retrieveTensor(tensor, buffer))
+                    .Submit().wait();
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    //Catch2 assertions are not thread safe -> check on main thread
+    for (int i = 0; i < N; ++i) {
+        auto mem = buffers[i].getMemory();
+        REQUIRE(std::all_of(mem.begin(), mem.end(),
+            [i](int v) { return v == i * 10 + 7; }));
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("task schedulers rotate tasks through buffered configurations", "[command]") {
+    constexpr uint32_t N = 16;
+    constexpr uint32_t Configs = 3;
+    std::vector<Buffer<int>> inputs, outputs;
+    std::vector<Tensor<int>> tensors;
+    std::vector<Subroutine> subroutines;
+    for (auto i = 0u; i < Configs; ++i) {
+        inputs.emplace_back(getContext(), 1);
+        outputs.emplace_back(getContext(), 1);
+        tensors.emplace_back(getContext(), 1);
+    }
+    for (auto i = 0u; i < Configs; ++i) {
+        subroutines.push_back(createSubroutine(getContext(),
+            updateTensor(inputs[i], tensors[i]), retrieveTensor(tensors[i], outputs[i])));
+    }
+
+    std::vector<int> results(N, -1);
+    {
+        TaskScheduler scheduler({ subroutines.begin(), subroutines.end() },
+            [&inputs](uint32_t config, uint64_t task) {
+                inputs[config].getMemory()[0] = static_cast<int>(task);
+            },
+            [&outputs, &results](uint32_t config, uint64_t task) {
+                results[task] = outputs[config].getMemory()[0];
+            }, 4);
+        REQUIRE(scheduler.getQueueSize() == 4);
+        REQUIRE(scheduler.getConfigCount() == Configs);
+
+        //a single call cannot schedule more tasks than fit into the queue
+        auto result = scheduler.schedule(N);
+        REQUIRE(result.count == 4);
+        REQUIRE(result.submission);
+        auto scheduled = result.count;
+        while (scheduled < N)
+            scheduled += scheduler.schedule(N - scheduled).count;
+        REQUIRE(scheduler.getTotalTasks() == N);
+
+        scheduler.wait();
+        REQUIRE(scheduler.getFinishedTasks() == N);
+        REQUIRE(scheduler.getPendingTasks() == 0);
+    }
+
+    for (auto i = 0u; i < N; ++i)
+        REQUIRE(results[i] == static_cast<int>(i));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("async executes return a submission to wait on", "[command]") {
+    Tensor<int> tensor(getContext(), 8);
+    Buffer<int> buffer(getContext(), 8);
+
+    auto first = executeListAsync(getContext(),
+        clearTensor(tensor, { .data = 13 }),
+        retrieveTensor(tensor, buffer));
+    REQUIRE(!first.forgettable());
+    first.wait();
+    REQUIRE(std::all_of(buffer.getMemory().begin(), buffer.getMemory().end(),
+        [](int v) { return v == 13; }));
+
+    auto sub = createSubroutine(getContext(),
+        clearTensor(tensor, { .data = 17 }),
+        retrieveTensor(tensor, buffer));
+    {
+        auto second = executeAsync(getContext(), sub);
+        REQUIRE(!second.forgettable());
+        REQUIRE(second.getFinalStep() > 0);
+        second.wait();
+    }
+    REQUIRE(std::all_of(buffer.getMemory().begin(), buffer.getMemory().end(),
+        [](int v) { return v == 17; }));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("sequences can run steps on different queues", "[command]") {
+    Tensor<int> tensor(getContext(), 8);
+    Buffer<int> buffer(getContext(), 8);
+
+    beginSequence(getContext())
+        .And(clearTensor(tensor, { .data = 11 }))
+        .OnQueue(QueueType::TRANSFER)
+        .And(retrieveTensor(tensor, buffer))
+        .OnQueue(QueueType::COMPUTE)
+        .And(clearTensor(tensor, { .data = 12 }))
+        .OnQueue(QueueType::MAIN)
+        .Submit().wait();
+    REQUIRE(std::all_of(buffer.getMemory().begin(), buffer.getMemory().end(),
+        [](int v) { return v == 11; }));
+
+    REQUIRE(hasDedicatedQueue(getContext(), QueueType::MAIN));
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("tensors can be transferred on the transfer queue", "[command]") {
+    Tensor<int> tensor(getContext(), 8);
+    Buffer<int> input(getContext(), 8), output(getContext(), 8);
+    auto in = input.getMemory();
+    for (int i = 0; i < 8; ++i)
+        in[i] = 3 * i;
+
+    //barriers must not contain stages a transfer only family lacks
+    beginSequence(getContext())
+        .OnQueue(QueueType::TRANSFER)
+        .And(clearTensor(tensor, { .data = 5 }))
+        .And(updateTensor(input, tensor, { .size = 16 }))
+        .And(retrieveTensor(tensor, output))
+        .Submit().wait();
+    auto out = output.getMemory();
+    for (int i = 0; i < 4; ++i)
+        REQUIRE(out[i] == 3 * i);
+    for (int i = 4; i < 8; ++i)
+        REQUIRE(out[i] == 5);
+
+    //same with tracked hazards
+    beginSequence(getContext())
+        .TrackHazards()
+        .OnQueue(QueueType::TRANSFER)
+        .And(updateTensor(input, tensor))
+        .And(retrieveTensor(tensor, output))
+        .Submit().wait();
+    REQUIRE(std::equal(in.begin(), in.end(), out.begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("device limits are reported", "[command]") {
+    auto limits = getDeviceLimits(getContext());
+    auto info = getDeviceInfo(getContext());
+
+    //minimums guaranteed by the Vulkan spec
+    REQUIRE(limits.maxWorkGroupCount[0] >= 65535);
+    REQUIRE(limits.maxWorkGroupInvocations >= 128);
+    REQUIRE(limits.maxSharedMemorySize >= 16384);
+    REQUIRE(limits.maxPushConstantsSize >= 128);
+    REQUIRE(limits.timestampPeriod > 0.0f);
+    REQUIRE(!limits.heapSizes.empty());
+
+    REQUIRE(limits.maxWorkGroupInvocations == info.maxWorkGroupInvocations);
+    REQUIRE(limits.maxSharedMemorySize == info.maxSharedMemorySize);
+}
+
+TEST_CASE("contexts can lower their global queue priority", "[command]") {
+    auto devices = enumerateDevices();
+    auto device = std::find_if(devices.begin(), devices.end(),
+        [](const DeviceHandle& d) { return isQueuePrioritySupported(d); });
+    if (device == devices.end())
+        SKIP("device does not support global queue priorities");
+
+    //lowering the priority never needs privileges
+    auto extensions = std::to_array({ createQueuePriorityExtension(QueuePriority::LOW) });
+    auto context = createContext(*device, extensions);
+    REQUIRE(getQueuePriority(context) == QueuePriority::LOW);
+    REQUIRE(getQueuePriority(getContext()) == QueuePriority::MEDIUM);
+
+    Tensor<int> tensor(context, 16);
+    Buffer<int> buffer(context, 16);
+    executeList(context, clearTensor(tensor, { .data = 5 }), retrieveTensor(tensor, buffer));
+    REQUIRE(std::all_of(buffer.getMemory().begin(), buffer.getMemory().end(),
+        [](int v) { return v == 5; }));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("hazard tracking keeps commands in order", "[command]") {
+    Tensor<int> tensor(getContext(), 8);
+    Buffer<int> buffer(getContext(), 8);
+    Buffer<int> other(getContext(), 8);
+
+    SECTION("sequences can track hazards") {
+        //write after read within a single step
+        beginSequence(getContext())
+            .TrackHazards()
+            .And(clearTensor(tensor, { .data = 21 }))
+            .And(retrieveTensor(tensor, buffer))
+            .And(clearTensor(tensor, { .data = 22 }))
+            .And(retrieveTensor(tensor, other))
+            .Submit().wait();
+        REQUIRE(std::all_of(buffer.getMemory().begin(), buffer.getMemory().end(),
+            [](int v) { return v == 21; }));
+        REQUIRE(std::all_of(other.getMemory().begin(), other.getMemory().end(),
+            [](int v) { return v == 22; }));
+    }
+
+    SECTION("subroutines can track hazards") {
+        auto sub = SubroutineBuilder(getContext())
+            .trackHazards()
+            .addCommand(clearTensor(tensor, { .data = 23 }))
+            .addCommand(retrieveTensor(tensor, buffer))
+            .finish();
+        execute(getContext(), sub);
+        REQUIRE(std::all_of(buffer.getMemory().begin(), buffer.getMemory().end(),
+            [](int v) { return v == 23; }));
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("sequence templates can be submitted multiple times", "[command]") {
+    Timeline timeline(getContext());
+    Tensor<int> tensor(getContext(), 8);
+    Buffer<int> buffer(getContext(), 8);
+
+    auto sequence = beginSequenceTemplate(timeline, 1)
+        .And(clearTensor(tensor, { .data = 31 }))
+        .Then(retrieveTensor(tensor, buffer))
+        .Freeze();
+    REQUIRE(sequence.getNextStartValue() == 1);
+
+    SECTION("submissions continue on the timeline") {
+        timeline.setValue(1);
+        for (uint64_t i = 0; i < 3; ++i) {
+            auto submission = sequence.Submit();
+            REQUIRE(submission.getFinalStep() == 3 + 2 * i);
+            submission.wait();
+            REQUIRE(std::all_of(buffer.getMemory().begin(), buffer.getMemory().end(),
+                [](int v) { return v == 31; }));
+            std::fill(buffer.getMemory().begin(), buffer.getMemory().end(), 0);
+        }
+        REQUIRE(sequence.getNextStartValue() == 7);
+    }
+
+    SECTION("submissions can start at a later value") {
+        auto first = sequence.Submit(10);
+        REQUIRE(first.getFinalStep() == 12);
+        timeline.setValue(10);
+        first.wait();
+        REQUIRE_THROWS_AS(sequence.Submit(11), std::logic_error);
+    }
+
+    SECTION("only reusable sequences can be frozen") {
+        REQUIRE_THROWS_AS(beginSequence(getContext()).Freeze(), std::logic_error);
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("submissions recycle their resources without waiting", "[command]") {
+    Tensor<int> tensor(getContext(), 8);
+    Buffer<int> buffer(getContext(), 8);
+    Timeline timeline(getContext());
+
+    SECTION("dropping a pending submission does not block") {
+        {
+            //first step waits on the cpu -> still pending when dropped
+            auto submission = beginSequence(timeline, 1)
+                .And(clearTensor(tensor, { .data = 41 }))
+                .Then(retrieveTensor(tensor, buffer))
+                .Submit();
+        }
+        timeline.setValue(1);
+        timeline.waitValue(3);
+        REQUIRE(std::all_of(buffer.getMemory().begin(), buffer.getMemory().end(),
+            [](int v) { return v == 41; }));
+    }
+
+    SECTION("many submissions can be made from multiple threads") {
+        constexpr int N = 4;
+        std::vector<Tensor<int>> tensors;
+        for (int i = 0; i < N; ++i)
+            tensors.emplace_back(getContext(), 8);
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < N; ++i) {
+            threads.emplace_back([&tensors, i]() {
+                for (int j = 0; j < 32; ++j) {
+                    auto submission = beginSequence(getContext())
+                        .And(clearTensor(tensors[i], { .data = 42 }))
+                        .Submit();
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        //new sequences recycle the retired pools
+        for (auto& t : tensors) {
+            beginSequence(getContext())
+                .And(retrieveTensor(t, buffer))
+                .Submit().wait();
+            REQUIRE(std::all_of(buffer.getMemory().begin(), buffer.getMemory().end(),
+                [](int v) { return v == 42; }));
+        }
+    }
+
+    SECTION("implicit timelines are reused with increasing values") {
+        //last reached value per timeline
+        std::map<uint64_t, uint64_t> values;
+        for (int i = 0; i < 8; ++i) {
+            auto submission = beginSequence(getContext())
+                .And(clearTensor(tensor, { .data = i }))
+                .Then(retrieveTensor(tensor, buffer))
+                .Submit();
+            submission.wait();
+            REQUIRE(buffer.getMemory()[0] == i);
+
+            //a reused timeline continues where it stopped
+            auto& last = values[submission.getTimeline().getId()];
+            REQUIRE(submission.getFinalStep() > last);
+            last = submission.getFinalStep();
+        }
+        REQUIRE(values.size() < 8);
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("completion callbacks run once the timeline reaches their value", "[command]") {
+    Timeline timeline(getContext());
+
+    SECTION("callbacks only run after their value got reached") {
+        std::promise<void> first, second;
+        std::atomic<bool> secondRan{ false };
+        timeline.onValue(2, [&]() { secondRan = true; second.set_value(); });
+        timeline.onValue(1, [&]() { first.set_value(); });
+
+        timeline.setValue(1);
+        REQUIRE(first.get_future().wait_for(std::chrono::seconds(5))
+            == std::future_status::ready);
+        REQUIRE(!secondRan);
+
+        timeline.setValue(2);
+        REQUIRE(second.get_future().wait_for(std::chrono::seconds(5))
+            == std::future_status::ready);
+    }
+
+    SECTION("submissions notify when finished") {
+        Tensor<int> tensor(getContext(), 8);
+        std::promise<void> done;
+        auto submission = beginSequence(timeline)
+            .And(clearTensor(tensor, { .data = 7 }))
+            .Submit();
+        submission.onFinished([&]() { done.set_value(); });
+        REQUIRE(done.get_future().wait_for(std::chrono::seconds(5))
+            == std::future_status::ready);
+        REQUIRE(timeline.getValue() >= submission.getFinalStep());
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+namespace {
+
+//minimal eager coroutine for testing awaiters
+struct Job {
+    struct promise_type {
+        Job get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+Job awaitTimeline(const Timeline& timeline, uint64_t value, Executor executor, bool& done) {
+    co_await timeline.awaitValue(value, std::move(executor));
+    done = true;
+}
+
+Job awaitSubmission(const Submission& submission, std::promise<void>& done) {
+    co_await submission;
+    done.set_value();
+}
+
+}
+
+TEST_CASE("coroutines can await timelines and submissions", "[command]") {
+    Timeline timeline(getContext());
+
+    SECTION("awaiting a reached value does not suspend") {
+        timeline.setValue(1);
+        bool done = false;
+        awaitTimeline(timeline, 1, {}, done);
+        REQUIRE(done);
+    }
+
+    SECTION("coroutines resume on the given executor") {
+        std::promise<std::coroutine_handle<>> scheduled;
+        Executor executor = [&scheduled](std::coroutine_handle<> handle) {
+            scheduled.set_value(handle);
+        };
+        bool done = false;
+        awaitTimeline(timeline, 1, executor, done);
+        REQUIRE(!done);
+
+        timeline.setValue(1);
+        auto future = scheduled.get_future();
+        REQUIRE(future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+        REQUIRE(!done);
+        //resume on this thread
+        future.get().resume();
+        REQUIRE(done);
+    }
+
+    SECTION("submissions can be awaited") {
+        Tensor<int> tensor(getContext(), 8);
+        auto submission = beginSequence(timeline, 1)
+            .And(clearTensor(tensor, { .data = 3 }))
+            .Submit();
+        std::promise<void> done;
+        awaitSubmission(submission, done);
+
+        timeline.setValue(1);
+        REQUIRE(done.get_future().wait_for(std::chrono::seconds(5))
+            == std::future_status::ready);
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("multiple timelines can be waited on at once", "[command]") {
+    Timeline first(getContext()), second(getContext());
+    std::vector<TimelineValue> values{ { first, 1 }, { second, 2 } };
+
+    SECTION("waitAll requires all values") {
+        second.setValue(2);
+        REQUIRE(!waitAll(values, 1000));
+        first.setValue(1);
+        REQUIRE(waitAll(values, 1000));
+    }
+
+    SECTION("waitAny returns the index of the reached value") {
+        REQUIRE(!waitAny(values, 1000));
+        second.setValue(2);
+        REQUIRE(waitAny(values, 1000) == 1);
+        first.setValue(1);
+        REQUIRE(waitAny(values) == 0);
+    }
+
+    SECTION("submissions can be waited on together") {
+        Tensor<int> tensorA(getContext(), 8), tensorB(getContext(), 8);
+        std::vector<Submission> submissions;
+        submissions.push_back(beginSequence(first, 1)
+            .And(clearTensor(tensorA, { .data = 1 })).Submit());
+        submissions.push_back(beginSequence(getContext())
+            .And(clearTensor(tensorB, { .data = 2 })).Submit());
+
+        REQUIRE(waitAny(submissions) == 1);
+        first.setValue(1);
+        waitAll(submissions);
+        REQUIRE(first.getValue() >= submissions[0].getFinalStep());
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("subroutines can be assembled from parts recorded in parallel", "[command]") {
+    constexpr int N = 4;
+    std::vector<Tensor<int>> tensors;
+    for (int i = 0; i < N; ++i)
+        tensors.emplace_back(getContext(), 8);
+    Buffer<int> buffer(getContext(), 8);
+
+    //record parts on different threads
+    std::vector<std::optional<SubroutinePart>> parts(N);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < N; ++i) {
+        threads.emplace_back([&parts, &tensors, i]() {
+            parts[i] = SubroutinePartBuilder(getContext())
+                .addCommand(clearTensor(tensors[i], { .data = i + 1 }))
+                .finish();
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    SubroutineBuilder builder(getContext());
+    for (int i = 0; i < N - 1; ++i)
+        builder.addPart(*parts[i]);
+    auto sub = builder.finish();
+    REQUIRE(sub.nestable());
+
+    //nest it without re-recording and drop the parts
+    auto outer = SubroutineBuilder(getContext())
+        .addSubroutine(sub)
+        .addPart(*parts[N - 1])
+        .finish();
+    parts.clear();
+    REQUIRE(outer.nestable());
+    execute(getContext(), outer);
+
+    for (int i = 0; i < N; ++i) {
+        execute(getContext(), retrieveTensor(tensors[i], buffer));
+        REQUIRE(std::all_of(buffer.getMemory().begin(), buffer.getMemory().end(),
+            [i](int v) { return v == i + 1; }));
+    }
+
+    //subroutines containing commands cannot be nested
+    auto direct = createSubroutine(getContext(), clearTensor(tensors[0], {}));
+    REQUIRE(!direct.nestable());
+    REQUIRE_THROWS(SubroutineBuilder(getContext()).addSubroutine(direct));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("wait graphs describe the recorded steps", "[command]") {
+    Timeline timeline(getContext());
+    Timeline other(getContext());
+    Tensor<int> tensor(getContext(), 8);
+    Buffer<int> buffer(getContext(), 8);
+
+    auto builder = beginSequence(timeline);
+    builder.And(clearTensor(tensor, { .data = 5 }))
+        .OnQueue(QueueType::TRANSFER)
+        .WaitFor(other, 2)
+        .And(retrieveTensor(tensor, buffer));
+    auto graph = builder.getWaitGraph();
+
+    REQUIRE(graph.steps.size() == 2);
+    REQUIRE(graph.steps[0].queue == QueueType::MAIN);
+    REQUIRE(graph.steps[0].commandBufferCount == 1);
+    REQUIRE(graph.steps[0].waits.size() == 1);
+    REQUIRE(graph.steps[0].signal.timeline == timeline.getId());
+    REQUIRE(graph.steps[0].signal.value == 1);
+    REQUIRE(graph.steps[1].queue == QueueType::TRANSFER);
+    REQUIRE(graph.steps[1].waits.size() == 2);
+    REQUIRE(graph.steps[1].waits[0].timeline == other.getId());
+    REQUIRE(graph.steps[1].waits[0].value == 2);
+    REQUIRE(graph.steps[1].waits[1].timeline == timeline.getId());
+    REQUIRE(graph.steps[1].waits[1].value == 1);
+    REQUIRE(graph.steps[1].signal.value == 2);
+
+    auto dot = printDot(graph);
+    REQUIRE(dot.find("step0 -> step1") != std::string::npos);
+    auto json = printJson(graph);
+    REQUIRE(json.find("\"queue\":\"TRANSFER\"") != std::string::npos);
+
+    //the other timeline is not signaled within the graph
+    auto timing = analyzeWaitGraph(graph, std::to_array({ 10.0, 5.0 }));
+    REQUIRE(timing.start == std::vector<double>{ 0.0, 10.0 });
+    REQUIRE(timing.idle == std::vector<double>{ 0.0, 10.0 });
+    REQUIRE(timing.criticalPath == std::vector<size_t>{ 0, 1 });
+    REQUIRE(timing.duration == 15.0);
+    REQUIRE_THROWS(analyzeWaitGraph(graph, std::to_array({ 10.0 })));
+
+    auto submission = builder.Submit();
+    other.setValue(2);
+    submission.wait();
+    REQUIRE(std::all_of(buffer.getMemory().begin(), buffer.getMemory().end(),
+        [](int v) { return v == 5; }));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("wait graph analysis finds the critical path across queues", "[command]") {
+    WaitGraph graph{ .steps = {
+        { .queue = QueueType::MAIN, .commandBufferCount = 1, .waits = {}, .signal = { 1, 1 } },
+        { .queue = QueueType::COMPUTE, .commandBufferCount = 1, .waits = {}, .signal = { 2, 1 } },
+        { .queue = QueueType::MAIN, .commandBufferCount = 1,
+          .waits = { { 1, 1 }, { 2, 1 } }, .signal = { 1, 2 } }
+    } };
+
+    auto timing = analyzeWaitGraph(graph, std::to_array({ 10.0, 20.0, 5.0 }));
+    REQUIRE(timing.start == std::vector<double>{ 0.0, 0.0, 20.0 });
+    REQUIRE(timing.finish == std::vector<double>{ 10.0, 20.0, 25.0 });
+    //main queue waits on the compute queue
+    REQUIRE(timing.idle == std::vector<double>{ 0.0, 0.0, 10.0 });
+    REQUIRE(timing.criticalPath == std::vector<size_t>{ 1, 2 });
+    REQUIRE(timing.duration == 25.0);
+}
+
+TEST_CASE("task graphs run dependent tasks across queues", "[command]") {
+    Tensor<int> tensorA(getContext(), 8);
+    Tensor<int> tensorB(getContext(), 8);
+    Buffer<int> bufferA(getContext(), 8);
+    Buffer<int> bufferB(getContext(), 8);
+
+    auto clearA = clearTensor(tensorA, { .data = 3 });
+    auto retrieveA = retrieveTensor(tensorA, bufferA);
+    auto clearB = clearTensor(tensorB, { .data = 4 });
+    auto retrieveB = retrieveTensor(tensorB, bufferB);
+
+    TaskGraph graph(getContext());
+    auto t0 = graph.addTask(clearA);
+    auto t1 = graph.addTask(retrieveA, QueueType::TRANSFER);
+    auto t2 = graph.addTask(clearB, QueueType::COMPUTE);
+    auto t3 = graph.addTask(retrieveB);
+    graph.addDependency(t0, t1);
+    graph.addDependency(t2, t3);
+    REQUIRE(graph.size() == 4);
+
+    SECTION("invalid dependencies are rejected") {
+        REQUIRE_THROWS_AS(graph.addDependency(t0, 4), std::out_of_range);
+        REQUIRE_THROWS_AS(graph.addDependency(t1, t1), std::logic_error);
+        graph.addDependency(t1, t0);
+        REQUIRE_THROWS_AS(graph.Submit(), std::logic_error);
+    }
+
+    SECTION("graphs can be submitted multiple times") {
+        auto waitGraph = graph.getWaitGraph();
+        uint32_t commandCount = 0;
+        for (auto& step : waitGraph.steps)
+            commandCount += step.commandBufferCount;
+        REQUIRE(commandCount == 4);
+        REQUIRE_THROWS_AS(graph.addTask(clearA), std::logic_error);
+
+        for (auto i = 0; i < 3; ++i) {
+            graph.Submit().wait();
+            REQUIRE(std::all_of(bufferA.getMemory().begin(), bufferA.getMemory().end(),
+                [](int v) { return v == 3; }));
+            REQUIRE(std::all_of(bufferB.getMemory().begin(), bufferB.getMemory().end(),
+                [](int v) { return v == 4; }));
+            std::fill(bufferA.getMemory().begin(), bufferA.getMemory().end(), 0);
+            std::fill(bufferB.getMemory().begin(), bufferB.getMemory().end(), 0);
+        }
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("profilers measure nested scopes across frames", "[command]") {
+    Tensor<int> tensor(getContext(), 1024);
+    Buffer<int> buffer(getContext(), 1024);
+    Profiler profiler(getContext(), 2);
+
+    REQUIRE_THROWS_AS(profiler.beginScope("a/b"), std::logic_error);
+    REQUIRE_THROWS_AS(profiler.beginScope(""), std::logic_error);
+
+    for (auto i = 0; i < 4; ++i) {
+        beginSequence(getContext())
+            .And(profiler.beginScope("frame"))
+            .And(profiler.beginScope("clear"))
+            .And(clearTensor(tensor, { .data = i }))
+            .And(profiler.endScope())
+            .Then(profiler.beginScope("retrieve"))
+            .And(retrieveTensor(tensor, buffer))
+            .And(profiler.endScope())
+            .And(profiler.endScope())
+            .Submit().wait();
+        profiler.collect();
+        if (i < 3)
+            REQUIRE(profiler.nextFrame() == i + 1);
+    }
+
+    auto samples = profiler.getSamples();
+    REQUIRE(samples.size() == 6);
+    REQUIRE(samples[0].frame == 2);
+    REQUIRE(samples[0].name == "frame");
+    REQUIRE(samples[0].depth == 0);
+    REQUIRE(samples[1].name == "frame/clear");
+    REQUIRE(samples[1].depth == 1);
+    REQUIRE(samples[5].frame == 3);
+
+    auto statistics = profiler.getStatistics();
+    REQUIRE(statistics.size() == 3);
+    REQUIRE(statistics[0].name == "frame");
+    REQUIRE(statistics[1].name == "frame/clear");
+    REQUIRE(statistics[2].name == "frame/retrieve");
+    for (auto& stats : statistics) {
+        REQUIRE(stats.count == 4);
+        REQUIRE(stats.min <= stats.mean);
+        REQUIRE(stats.mean <= stats.p99);
+    }
+
+    SECTION("frames cannot advance while scopes are open") {
+        beginSequence(getContext()).And(profiler.beginScope("open"));
+        REQUIRE_THROWS_AS(profiler.nextFrame(), std::logic_error);
+        beginSequence(getContext()).And(profiler.endScope());
+        REQUIRE_THROWS_AS(
+            beginSequence(getContext()).And(profiler.endScope()),
+            std::logic_error);
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("traces record host and device events", "[command]") {
+    Tensor<int> tensor(getContext(), 256);
+    Timeline timeline(getContext());
+    Profiler profiler(getContext());
+
+    REQUIRE(!isTracing(getContext()));
+    REQUIRE_THROWS_AS(endTrace(getContext()), std::logic_error);
+
+    beginTrace(getContext());
+    REQUIRE(isTracing(getContext()));
+    beginSequence(timeline)
+        .And(profiler.beginScope("clear"))
+        .And(clearTensor(tensor, { .data = 7 }))
+        .And(profiler.endScope())
+        .Submit();
+    timeline.waitValue(1);
+    timeline.setValue(5);
+    auto trace = endTrace(getContext());
+    REQUIRE(!isTracing(getContext()));
+
+    auto hasEvent = [&trace](const char* name, const char* category) {
+        return std::any_of(trace.events.begin(), trace.events.end(),
+            [&](const TraceEvent& e) { return e.name == name && e.category == category; });
+    };
+    REQUIRE(hasEvent("Submit", "submit"));
+    REQUIRE(hasEvent("Wait", "wait"));
+    REQUIRE(hasEvent("Signal", "update"));
+    REQUIRE(std::all_of(trace.events.begin(), trace.events.end(),
+        [](const TraceEvent& e) { return e.thread == 1; }));
+
+    auto samples = profiler.getSamples();
+    REQUIRE(samples.size() == 1);
+    addProfilerSamples(trace, samples);
+    REQUIRE(hasEvent("clear", "device"));
+    auto& device = trace.events.back();
+    REQUIRE(device.thread == 0);
+    //device timestamps are correlated with the host's clock
+    REQUIRE(device.start > trace.startTime);
+
+    auto json = writeChromeTrace(trace);
+    REQUIRE(json.starts_with("{"));
+    REQUIRE(json.find("\"name\":\"clear\"") != std::string::npos);
+    REQUIRE(json.find("\"ph\":\"X\"") != std::string::npos);
+    auto perfetto = writePerfettoTrace(trace);
+    REQUIRE(!perfetto.empty());
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("device timestamps can be converted into host time", "[command]") {
+    Tensor<int> tensor(getContext(), 256);
+    StopWatch watch(getContext());
+
+    auto correlation = getClockCorrelation(getContext());
+    REQUIRE(correlation.maxDeviation >= 0.0);
+
+    auto before = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    beginSequence(getContext())
+        .And(watch.start())
+        .And(clearTensor(tensor, { .data = 1 }))
+        .And(watch.stop())
+        .Submit().wait();
+    auto after = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+
+    //work started between submission and its completion
+    auto start = watch.getStartTime(true);
+    auto slack = getClockCorrelation(getContext()).maxDeviation + 1e6;
+    REQUIRE(start >= before - slack);
+    REQUIRE(start <= after + slack);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("debug labels annotate recorded commands", "[command]") {
+    //debug is configured globally, which enables labels as well
+    REQUIRE(isDebugLabelsEnabled(getContext()));
+
+    Tensor<int> tensor(getContext(), 1024);
+    Buffer<int> buffer(getContext(), 1024);
+    Image image(getContext(), ImageFormat::R32_SINT, 4, 4);
+    setDebugName(tensor, "tensor");
+    setDebugName(image, "image");
+
+    beginSequence(getContext())
+        .And(beginLabel(getContext(), "frame", { 1.0f, 0.0f, 0.0f, 1.0f }))
+        .And(beginLabel(getContext(), "clear"))
+        .And(clearTensor(tensor, { .data = 7 }))
+        .And(endLabel(getContext()))
+        .And(endLabel(getContext()))
+        .Then(insertLabel(getContext(), "retrieve"))
+        .And(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    REQUIRE(std::all_of(buffer.getMemory().begin(), buffer.getMemory().end(),
+        [](int v) { return v == 7; }));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("resource tracking reports live resources", "[command]") {
+    setResourceTracking(getContext(), true);
+    REQUIRE(isResourceTrackingEnabled(getContext()));
+    auto before = getLiveResources(getContext()).size();
+
+    {
+        Tensor<int> tensor(getContext(), 1024);
+        Buffer<int> buffer(getContext(), 16);
+        setResourceTag(tensor, "weights");
+
+        auto resources = getLiveResources(getContext());
+        REQUIRE(resources.size() == before + 2);
+        auto& info = resources[resources.size() - 2];
+        REQUIRE(info.type == "Tensor");
+        REQUIRE(info.size == 4096);
+        REQUIRE(info.tag == "weights");
+        REQUIRE(resources.back().type == "Buffer");
+
+        auto report = dumpResources(getContext());
+        REQUIRE(report.find("Tensor") != std::string::npos);
+        REQUIRE(report.find("\"weights\"") != std::string::npos);
+    }
+    REQUIRE(getLiveResources(getContext()).size() == before);
+
+    setResourceTracking(getContext(), false);
+    REQUIRE(getLiveResources(getContext()).empty());
+}
+
+TEST_CASE("deferred destruction keeps resources alive until work finished", "[command]") {
+    setDeferredDestruction(getContext(), true);
+    REQUIRE(isDeferredDestructionEnabled(getContext()));
+
+    Timeline timeline(getContext());
+    Buffer<int> buffer(getContext(), 256);
+    auto tensor = std::make_optional<Tensor<int>>(getContext(), 256);
+    auto submission = beginSequence(timeline)
+        .WaitFor(1)
+        .And(clearTensor(*tensor, { .data = 7 }))
+        .Then(retrieveTensor(*tensor, buffer))
+        .Submit();
+
+    //destroy the tensor while still in use
+    tensor.reset();
+    REQUIRE(collectRetiredResources(getContext()) == 1);
+
+    timeline.setValue(1);
+    submission.wait();
+    REQUIRE(collectRetiredResources(getContext()) == 0);
+    auto mem = buffer.getMemory();
+    REQUIRE(std::all_of(mem.begin(), mem.end(), [](int v) { return v == 7; }));
+
+    setDeferredDestruction(getContext(), false);
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("waits can poll before blocking", "[command]") {
+    setWaitSpinTime(getContext(), 200'000);
+    REQUIRE(getWaitSpinTime(getContext()) == 200'000);
+
+    //timeouts shorter than the spin time are respected
+    Timeline timeline(getContext());
+    REQUIRE(!timeline.waitValue(1, 100));
+    timeline.setValue(1);
+    REQUIRE(timeline.waitValue(1, 100));
+
+    Buffer<int> buffer(getContext(), 64);
+    Tensor<int> tensor(getContext(), 64);
+    execute(getContext(), clearTensor(tensor, { .data = 3 }));
+    std::vector<Submission> submissions;
+    submissions.push_back(beginSequence(getContext())
+        .And(retrieveTensor(tensor, buffer))
+        .Submit());
+    submissions.front().wait();
+    auto mem = buffer.getMemory();
+    REQUIRE(std::all_of(mem.begin(), mem.end(), [](int v) { return v == 3; }));
+
+    submissions.push_back(beginSequence(timeline).WaitFor(2).Submit());
+    REQUIRE(waitAny(submissions, 100) == 0);
+    REQUIRE(!waitAll(submissions, 100));
+    timeline.setValue(2);
+    REQUIRE(waitAll(submissions, 1'000'000'000));
+
+    setWaitSpinTime(getContext(), 0);
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("context statistics count issued work", "[command]") {
+    Tensor<int> tensor(getContext(), 256);
+    Buffer<int> buffer(getContext(), 256);
+    auto before = getContextStatistics(getContext());
+
+    executeList(getContext(),
+        updateTensor(buffer, tensor),
+        retrieveTensor(tensor, buffer));
+    auto after = getContextStatistics(getContext());
+
+    REQUIRE(after.submissions == before.submissions + 1);
+    REQUIRE(after.commandBuffers == before.commandBuffers + 1);
+    REQUIRE(after.oneTimeSubmits == before.oneTimeSubmits + 1);
+    REQUIRE(after.bytesUploaded == before.bytesUploaded + 1024);
+    REQUIRE(after.bytesDownloaded == before.bytesDownloaded + 1024);
+    REQUIRE(after.barriers > before.barriers);
+}
+
+TEST_CASE("shared contexts use resources of each other", "[command]") {
+    auto shared = createSharedContext(getContext());
+    REQUIRE(shared != getContext());
+    REQUIRE(isSharingDevice(shared, getContext()));
+    REQUIRE(isSharingDevice(createSharedContext(shared), getContext()));
+    REQUIRE_THROWS_AS(createSharedContext(createEmptyContext()), std::runtime_error);
+
+    //upload on one context, copy and download on the other
+    Buffer<int> buffer(getContext(), 64);
+    Buffer<int> result(shared, 64);
+    for (auto i = 0u; i < buffer.size(); ++i)
+        buffer.getMemory()[i] = static_cast<int>(i) * 3;
+    Tensor<int> tensor(getContext(), 64);
+    Tensor<int> other(shared, 64);
+    execute(getContext(), updateTensor(buffer, tensor));
+    executeList(shared,
+        copyTensor(tensor, other),
+        retrieveTensor(other, result));
+    REQUIRE(std::equal(result.getMemory().begin(), result.getMemory().end(),
+        buffer.getMemory().begin()));
+
+    //work is counted per context
+    REQUIRE(getContextStatistics(shared).submissions == 1);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("submission limits apply backpressure", "[command]") {
+    setSubmissionLimit(getContext(), 1);
+    REQUIRE(getSubmissionLimit(getContext()) == 1);
+    REQUIRE(getSubmissionsInFlight(getContext()) == 0);
+
+    //the first submission is held back by the timeline
+    Timeline timeline(getContext());
+    auto first = beginSequence(timeline).WaitFor(1).Submit();
+    REQUIRE(getSubmissionsInFlight(getContext()) == 1);
+    auto rejected = beginSequence(timeline, 2).WaitFor(3).TrySubmit();
+    REQUIRE(!rejected);
+
+    //blocks until the first one finished
+    timeline.setValue(1);
+    auto second = beginSequence(timeline, 2).WaitFor(3).Submit();
+    timeline.setValue(3);
+    second.wait();
+    first.wait();
+
+    setSubmissionLimit(getContext(), 0);
+    REQUIRE(getSubmissionLimit(getContext()) == 0);
+    REQUIRE(!hasValidationErrorOccurred());
+}
@@ -2,7 +2,11 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstring>
 #include <fstream>
+#include <string>
+#include <vector>
 
 #include <hephaistos/buffer.hpp>
 #include <hephaistos/command.hpp>
@@ -64,7 +68,7 @@ TEST_CASE("compiler can compile GLSL code to SPIR-V", "[compiler]") {
 	beginSequence(getContext())
 		.And(program->dispatch(4))
 		.Then(retrieveTensor(tensorOut, buffer))
-		.Submit();
+		.Submit().wait();
 
 	REQUIRE(std::equal(dataOut.begin(), dataOut.end(), buffer.getMemory().begin()));
 
@@ -112,13 +116,38 @@ TEST_CASE("compiler can include files from header map", "[compiler]") {
 	beginSequence(getContext())
 		.And(program->dispatch(4))
 		.Then(retrieveTensor(tensorOut, buffer))
-		.Submit();
+		.Submit().wait();
 
 	REQUIRE(std::equal(dataOut2.begin(), dataOut2.end(), buffer.getMemory().begin()));
 
 	REQUIRE(!hasValidationErrorOccurred());
 }
 
+TEST_CASE("compiler can include built-in headers without the extension", "[compiler]") {
+	auto source = R"(
+		#version 460
+		#include "hephaistos/random.glsl"
+
+		layout(local_size_x = 1) in;
+
+		void main() {}
+	)";
+
+	Compiler compiler;
+	REQUIRE(!compiler.compile(source).empty());
+
+	//line numbers of errors are unaffected by the enabled extension
+	auto broken = "#version 460\n\nlayout(local_size_x = 1) in;\nvoid main() { foo(); }\n";
+	std::string message;
+	try {
+		compiler.compile(broken);
+	}
+	catch (const std::exception& e) {
+		message = e.what();
+	}
+	REQUIRE(message.find("0:4:") != std::string::npos);
+}
+
 TEST_CASE("compiler can fetch headers from disk", "[compiler]") {
 	//create temp directory
 	//hard coded path is bad, but what are the chances of collision, right? Right?
@@ -177,9 +206,368 @@ TEST_CASE("compiler can fetch headers from disk", "[compiler]") {
 	beginSequence(getContext())
 		.And(program->dispatch(4))
 		.Then(retrieveTensor(tensorOut, buffer))
-		.Submit();
+		.Submit().wait();
 
 	REQUIRE(std::equal(dataOut2.begin(), dataOut2.end(), buffer.getMemory().begin()));
 
 	REQUIRE(!hasValidationErrorOccurred());
 }
+
+TEST_CASE("compiler can cache compiled code on disk", "[compiler]") {
+	auto tmp_dir = std::filesystem::temp_directory_path() / "hephaistos_test_7C1D93B0";
+	auto cache_dir = tmp_dir / "cache";
+	std::filesystem::create_directory(tmp_dir);
+	std::shared_ptr<void> defer_tmp_del(nullptr, [&tmp_dir](...){
+		std::filesystem::remove_all(tmp_dir);
+	});
+	auto writeHeader = [&tmp_dir](const char* body) {
+		std::ofstream file(tmp_dir / "foo.glsl");
+		file << body;
+	};
+	writeHeader("int foo(int a, int b) {\n\treturn 2 * a + b;\n}\n");
+
+	auto source = R"(
+		#version 460
+		#extension GL_GOOGLE_include_directive: require
+		#include "foo.glsl"
+
+		layout(local_size_x = 1) in;
+
+		readonly buffer tensorA { int in_a[]; };
+		readonly buffer tensorB { int in_b[]; };
+		writeonly buffer tensorOut { int out_c[]; };
+
+		void main() {
+			uint idx = gl_GlobalInvocationID.x;
+			out_c[idx] = foo(in_a[idx], in_b[idx]);
+		}
+	)";
+	auto countEntries = [&cache_dir]() {
+		return std::distance(
+			std::filesystem::directory_iterator(cache_dir),
+			std::filesystem::directory_iterator{});
+	};
+
+	Compiler compiler;
+	compiler.addIncludeDir(tmp_dir);
+	compiler.setCacheDir(cache_dir);
+	REQUIRE(compiler.getCacheDir() == cache_dir);
+	auto code = compiler.compile(source);
+	REQUIRE(code.size() > 0);
+	REQUIRE(countEntries() == 1);
+
+	//a new compiler picks up the cached code
+	Compiler other;
+	other.addIncludeDir(tmp_dir);
+	other.setCacheDir(cache_dir);
+	REQUIRE(other.compile(source) == code);
+	REQUIRE(countEntries() == 1);
+
+	//changing an include file invalidates the entry
+	writeHeader("int foo(int a, int b) {\n\treturn a + b;\n}\n");
+	auto changed = other.compile(source);
+	REQUIRE(changed.size() > 0);
+	REQUIRE(changed != code);
+
+	//header maps are part of the key
+	Compiler::HeaderMap headers = {
+		{ "foo.glsl", "int foo(int a, int b) {\n\treturn 2 * a + b;\n}\n" }
+	};
+	REQUIRE(other.compile(source, headers).size() > 0);
+	REQUIRE(countEntries() == 2);
+}
+
+TEST_CASE("compiler can compile multiple sources in parallel", "[compiler]") {
+	Compiler::HeaderMap headers = {
+		{ "foo.glsl", "int foo(int a, int b) {\n\treturn 2 * a + b;\n}\n" }
+	};
+	auto base = std::string(R"(
+		#version 460
+		#extension GL_GOOGLE_include_directive: require
+		#include "foo.glsl"
+
+		layout(local_size_x = 1) in;
+		layout(constant_id = 0) const int offset = )");
+	std::vector<std::string> sources;
+	for (int i = 0; i < 8; ++i) {
+		sources.push_back(base + std::to_string(i) + R"(;
+
+		writeonly buffer tensorOut { int out_c[]; };
+
+		void main() {
+			uint idx = gl_GlobalInvocationID.x;
+			out_c[idx] = foo(int(idx), offset);
+		}
+	)");
+	}
+	std::vector<std::string_view> views(sources.begin(), sources.end());
+
+	Compiler compiler;
+	auto results = compiler.compileMany(views, headers);
+	REQUIRE(results.size() == sources.size());
+	for (size_t i = 0; i < sources.size(); ++i)
+		REQUIRE(results[i] == compiler.compile(sources[i], headers));
+
+	auto future = compiler.compileAsync(sources.front(), headers);
+	REQUIRE(future.get() == results.front());
+
+	//errors are forwarded
+	std::array<std::string_view, 2> broken = { { views.front(), "this is not glsl" } };
+	REQUIRE_THROWS(compiler.compileMany(broken, headers));
+	REQUIRE_THROWS(compiler.compileAsync("this is not glsl").get());
+}
+
+TEST_CASE("compiler options control the generated code", "[compiler]") {
+	auto source = R"(
+		#version 460
+
+		layout(local_size_x = TILE) in;
+
+		writeonly buffer tensorOut { int out_c[]; };
+
+		void main() {
+			uint idx = gl_GlobalInvocationID.x;
+			out_c[idx] = VALUE;
+		}
+	)";
+
+	Compiler compiler;
+	REQUIRE_THROWS(compiler.compile(source));
+
+	compiler.setOptions({ .defines = { { "TILE", "16" }, { "VALUE", "42" } } });
+	auto code = compiler.compile(source);
+	REQUIRE(code.size() > 0);
+	//SPIR-V version is stored in the second word
+	REQUIRE(code[1] == 0x00010400);
+	Program program(getContext(), code);
+	REQUIRE(program.getLocalSize().x == 16);
+
+	SECTION("target selects the SPIR-V version") {
+		auto options = compiler.getOptions();
+		options.target = CompileTarget::VULKAN_1_2_SPIRV_1_5;
+		compiler.setOptions(options);
+		REQUIRE(compiler.compile(source)[1] == 0x00010500);
+		options.target = CompileTarget::VULKAN_1_3;
+		compiler.setOptions(options);
+		REQUIRE(compiler.compile(source)[1] == 0x00010600);
+	}
+
+	SECTION("debug info can be stripped") {
+		auto options = compiler.getOptions();
+		options.stripDebugInfo = true;
+		compiler.setOptions(options);
+		auto stripped = compiler.compile(source);
+		REQUIRE(stripped.size() < code.size());
+		Program strippedProgram(getContext(), stripped);
+		REQUIRE(strippedProgram.getLocalSize().x == 16);
+	}
+
+	REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("compiler caches include files until they change", "[compiler]") {
+	auto tmp_dir = std::filesystem::temp_directory_path() / "hephaistos_test_2B6E0F17";
+	std::filesystem::create_directories(tmp_dir / "lib");
+	std::shared_ptr<void> defer_tmp_del(nullptr, [&tmp_dir](...){
+		std::filesystem::remove_all(tmp_dir);
+	});
+	auto header = tmp_dir / "lib" / "foo.glsl";
+	{
+		std::ofstream file(header);
+		file << "int foo(int a, int b) {\n\treturn 2 * a + b;\n}\n";
+	}
+
+	auto source = R"(
+		#version 460
+		#extension GL_GOOGLE_include_directive: require
+		#include "lib/foo.glsl"
+
+		layout(local_size_x = 1) in;
+
+		writeonly buffer tensorOut { int out_c[]; };
+
+		void main() {
+			uint idx = gl_GlobalInvocationID.x;
+			out_c[idx] = foo(int(idx), 3);
+		}
+	)";
+
+	Compiler compiler;
+	compiler.addIncludeDir(tmp_dir);
+	REQUIRE_NOTHROW(compiler.preloadIncludes());
+	auto code = compiler.compile(source);
+	REQUIRE(code.size() > 0);
+	REQUIRE(compiler.compile(source) == code);
+
+	//changed files are loaded again
+	auto time = std::filesystem::last_write_time(header);
+	{
+		std::ofstream file(header);
+		file << "int foo(int a, int b) {\n\treturn a - b;\n}\n";
+	}
+	std::filesystem::last_write_time(header, time + std::chrono::seconds(1));
+	auto changed = compiler.compile(source);
+	REQUIRE(changed.size() > 0);
+	REQUIRE(changed != code);
+
+	//removed files are not found anymore
+	std::filesystem::remove(header);
+	REQUIRE_THROWS(compiler.compile(source));
+}
+
+TEST_CASE("compiler can build programs in the background", "[compiler]") {
+	auto source = R"(
+		#version 460
+
+		layout(local_size_x = 1) in;
+
+		readonly buffer tensorA { int in_a[]; };
+		readonly buffer tensorB { int in_b[]; };
+		writeonly buffer tensorOut { int out_c[]; };
+
+		void main() {
+			uint idx = gl_GlobalInvocationID.x;
+			out_c[idx] = in_a[idx] + in_b[idx];
+		}
+	)";
+
+	Compiler compiler;
+	auto pending = compiler.buildProgramAsync(getContext(), source);
+	pending.wait();
+	REQUIRE(pending.isReady());
+	auto program = pending.get();
+
+	Tensor<int32_t> tensorA(getContext(), dataA);
+	Tensor<int32_t> tensorB(getContext(), dataB);
+	Tensor<int32_t> tensorOut(getContext(), 4);
+	Buffer<int32_t> buffer(getContext(), 4);
+	program.bindParameterList(tensorA, tensorB, tensorOut);
+	beginSequence(getContext())
+		.And(program.dispatch(4))
+		.Then(retrieveTensor(tensorOut, buffer))
+		.Submit().wait();
+	REQUIRE(std::equal(dataOut.begin(), dataOut.end(), buffer.getMemory().begin()));
+
+	//errors are raised on get
+	auto broken = compiler.buildProgramAsync(getContext(), "this is not glsl");
+	REQUIRE_THROWS(broken.get());
+
+	REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("compiler can request float controls", "[compiler]") {
+	auto source = R"(
+		#version 460
+
+		layout(local_size_x = 4) in;
+
+		buffer tensorIn { float values[]; };
+
+		void main() {
+			uint idx = gl_GlobalInvocationID.x;
+			values[idx] = values[idx] * 0.5;
+		}
+	)";
+	//searches for an instruction by its opcode and the operands following the first one
+	auto contains = [](const std::vector<uint32_t>& code, std::vector<uint32_t> inst) {
+		for (auto i = 5u; i < code.size(); i += code[i] >> 16) {
+			auto count = code[i] >> 16;
+			if ((code[i] & 0xFFFF) == inst[0] && count >= inst.size() &&
+				std::equal(inst.begin() + 1, inst.end(), code.begin() + i + 2))
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+	constexpr uint32_t OpExecutionMode = 16;
+	constexpr uint32_t OpExecutionModeId = 331;
+	constexpr uint32_t OpDecorate = 71;
+
+	Compiler compiler;
+	auto plain = compiler.compile(source);
+	REQUIRE(!contains(plain, { OpExecutionMode, 4460, 32 }));
+
+	compiler.setOptions({ .denormMode = DenormMode::FLUSH_TO_ZERO });
+	auto flushed = compiler.compile(source);
+	//DenormFlushToZero for 32 bit floats
+	REQUIRE(contains(flushed, { OpExecutionMode, 4460, 32 }));
+
+	compiler.setOptions({ .relaxedPrecision = true });
+	//RelaxedPrecision
+	REQUIRE(contains(compiler.compile(source), { OpDecorate, 0 }));
+
+	compiler.setOptions({ .fastMath = true });
+	auto fast = compiler.compile(source);
+	//FPFastMathDefault
+	REQUIRE(contains(fast, { OpExecutionModeId, 6028 }));
+
+	auto props = getFloatControlsProperties(getContext());
+	if (props.denormFlushToZeroFloat32) {
+		//denormalized floats stay denormalized without flushing
+		std::array<uint32_t, 4> bits{ { 1, 2, 3, 0x3F800000 } };
+		std::array<float, 4> data;
+		std::memcpy(data.data(), bits.data(), sizeof(data));
+		Tensor<float> tensor(getContext(), data);
+		Buffer<float> buffer(getContext(), 4);
+		Program program(getContext(), flushed);
+		program.bindParameterList(tensor);
+		beginSequence(getContext())
+			.And(program.dispatch())
+			.Then(retrieveTensor(tensor, buffer))
+			.Submit().wait();
+		auto memory = buffer.getMemory();
+		REQUIRE(memory[1] == 0.0f);
+		REQUIRE(memory[2] == 0.0f);
+		REQUIRE(memory[3] == 0.5f);
+	}
+	if (props.fastMath)
+		REQUIRE(Program(getContext(), fast).getLocalSize().x == 4);
+
+	REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("compiler can target the vulkan memory model", "[compiler]") {
+	auto source = R"(
+		#version 460
+
+		layout(local_size_x = 4) in;
+
+		buffer tensorOut { uint counter; };
+
+		void main() {
+			atomicAdd(counter, 1, gl_ScopeDevice, gl_StorageSemanticsBuffer, gl_SemanticsRelease);
+		}
+	)";
+	//OpMemoryModel with the Vulkan memory model as second operand
+	auto isVulkanModel = [](const std::vector<uint32_t>& code) {
+		for (auto i = 5u; i < code.size(); i += code[i] >> 16) {
+			if ((code[i] & 0xFFFF) == 14)
+				return code[i + 2] == 3;
+		}
+		return false;
+	};
+
+	Compiler compiler;
+	//scoped atomics are unknown without the extension
+	REQUIRE_THROWS(compiler.compile(source));
+	compiler.setOptions({ .vulkanMemoryModel = true });
+	auto code = compiler.compile(source);
+	REQUIRE(isVulkanModel(code));
+
+	auto features = getMemoryModelFeatures(getContext());
+	if (features.vulkanMemoryModel && features.deviceScope) {
+		Tensor<uint32_t> tensor(getContext(), 1);
+		Buffer<uint32_t> buffer(getContext(), 1);
+		Program program(getContext(), code);
+		program.bindParameterList(tensor);
+		beginSequence(getContext())
+			.And(clearTensor(tensor, {}))
+			.Then(program.dispatch(4))
+			.Then(retrieveTensor(tensor, buffer))
+			.Submit().wait();
+		REQUIRE(buffer.getMemory()[0] == 16);
+	}
+
+	REQUIRE(!hasValidationErrorOccurred());
+}
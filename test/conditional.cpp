@@ -0,0 +1,98 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#include <hephaistos/hephaistos.hpp>
+#include <hephaistos/conditional.hpp>
+
+#include "validation.hpp"
+
+//code
+#include "shader/push.h"
+
+using namespace hephaistos;
+
+namespace {
+
+auto Extensions = std::to_array({
+    createConditionalExecutionExtension()
+});
+
+ContextHandle getContext() {
+    static ContextHandle context = createEmptyContext();
+    if (!context)
+        context = createContext(Extensions);
+    return context;
+}
+
+struct Push {
+    int32_t const0;
+    int32_t const1;
+    int32_t const2;
+};
+
+}
+
+TEST_CASE("conditional execution can be enabled", "[conditional]") {
+    REQUIRE(isConditionalExecutionEnabled(getContext()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("conditional blocks skip dispatches based on a predicate", "[conditional]") {
+    //predicates: { false, true }
+    Tensor<uint32_t> predicate(getContext(), std::to_array<uint32_t>({ 0, 1 }));
+    Tensor<int32_t> tensorA(getContext(), 3), tensorB(getContext(), 3);
+    Buffer<int32_t> bufferA(getContext(), 3), bufferB(getContext(), 3);
+    Program programA(getContext(), push_code), programB(getContext(), push_code);
+    programA.bindParameterList(tensorA);
+    programB.bindParameterList(tensorB);
+    Push push{ 5, 6, 7 };
+
+    beginSequence(getContext())
+        .And(clearTensor(tensorA, {}))
+        .And(clearTensor(tensorB, {}))
+        .Then(beginConditional(predicate, 0))
+        .And(programA.dispatch(push, 3))
+        .And(endConditional(getContext()))
+        .And(beginConditional(predicate, 4))
+        .And(programB.dispatch(push, 3))
+        .And(endConditional(getContext()))
+        .Then(retrieveTensor(tensorA, bufferA))
+        .And(retrieveTensor(tensorB, bufferB))
+        .Submit().wait();
+
+    auto expected = std::to_array<int32_t>({ 5, 6, 7 });
+    REQUIRE(std::all_of(bufferA.getMemory().begin(), bufferA.getMemory().end(),
+        [](int32_t v) { return v == 0; }));
+    REQUIRE(std::equal(expected.begin(), expected.end(), bufferB.getMemory().begin()));
+
+    //predicates must be aligned and inside the tensor
+    REQUIRE_THROWS(beginConditional(predicate, 2));
+    REQUIRE_THROWS(beginConditional(predicate, 8));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("inverted conditional blocks run if the predicate is zero", "[conditional]") {
+    Tensor<uint32_t> predicate(getContext(), std::to_array<uint32_t>({ 0 }));
+    Tensor<int32_t> tensor(getContext(), 3);
+    Buffer<int32_t> buffer(getContext(), 3);
+    Program program(getContext(), push_code);
+    program.bindParameterList(tensor);
+    Push push{ 5, 6, 7 };
+
+    beginSequence(getContext())
+        .And(beginConditional(predicate, 0, true))
+        .And(program.dispatch(push, 3))
+        .And(endConditional(getContext()))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+
+    auto expected = std::to_array<int32_t>({ 5, 6, 7 });
+    REQUIRE(std::equal(expected.begin(), expected.end(), buffer.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
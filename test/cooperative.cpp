@@ -0,0 +1,25 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <hephaistos/cooperative.hpp>
+
+using namespace hephaistos;
+
+TEST_CASE("cooperative matrix extension can be used", "[cooperative]") {
+    auto devices = enumerateDevices();
+    auto& device = devices.front();
+    if (!isCooperativeMatrixSupported(device))
+        SKIP("Cooperative matrices are not supported!");
+
+    //supported devices must report at least one configuration
+    auto props = getCooperativeMatrixProperties(device);
+    REQUIRE(!props.empty());
+    for (auto& p : props) {
+        REQUIRE(p.MSize > 0);
+        REQUIRE(p.NSize > 0);
+        REQUIRE(p.KSize > 0);
+    }
+
+    auto ext = createCooperativeMatrixExtension();
+    auto context = createContext(device, { &ext, 1 });
+    REQUIRE(isCooperativeMatrixEnabled(context));
+}
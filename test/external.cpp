@@ -0,0 +1,112 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <hephaistos/hephaistos.hpp>
+#include <hephaistos/external.hpp>
+
+#include "validation.hpp"
+
+using namespace hephaistos;
+
+namespace {
+
+auto Extensions = std::to_array({
+    createExternalMemoryExtension()
+});
+
+bool isSupported() {
+    for (auto& device : enumerateDevices()) {
+        if (isExternalMemorySupported(device))
+            return true;
+    }
+    return false;
+}
+
+ContextHandle getContext() {
+    static ContextHandle context = createEmptyContext();
+    if (!context)
+        context = createContext(Extensions);
+    return context;
+}
+
+void closeHandle(ExternalHandle handle) {
+#ifdef _WIN32
+    CloseHandle(reinterpret_cast<HANDLE>(handle));
+#else
+    close(static_cast<int>(handle));
+#endif
+}
+
+}
+
+TEST_CASE("exportable tensors can be exported", "[external]") {
+    if (!isSupported())
+        SKIP("External memory is not supported");
+    REQUIRE(isExternalMemoryEnabled(getContext()));
+
+    auto tensor = createExportableTensor(getContext(), 1024);
+    REQUIRE(tensor.size_bytes() == 1024);
+
+    auto memory = exportTensor(tensor);
+    REQUIRE(memory.handle >= 0);
+    REQUIRE(memory.size >= memory.offset + 1024);
+    closeHandle(memory.handle);
+
+    //ordinary tensors are not exportable
+    Tensor<std::byte> ordinary(getContext(), 1024);
+    REQUIRE_THROWS(exportTensor(ordinary));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("exportable timelines can be exported", "[external]") {
+    if (!isSupported())
+        SKIP("External memory is not supported");
+
+    auto timeline = createExportableTimeline(getContext(), 5);
+    REQUIRE(timeline.getValue() == 5);
+
+    auto handle = exportTimeline(timeline);
+    REQUIRE(handle >= 0);
+    closeHandle(handle);
+
+    //ordinary timelines are not exportable
+    Timeline ordinary(getContext());
+    REQUIRE_THROWS(exportTimeline(ordinary));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("exported tensors and timelines can be imported", "[external]") {
+    if (!isSupported())
+        SKIP("External memory is not supported");
+
+    auto data = std::to_array<int>({ 3, 1, 4, 1, 5, 9, 2, 6 });
+    auto tensor = createExportableTensor(getContext(), sizeof(data));
+    execute(getContext(), updateTensor(Buffer<int>(getContext(), data), tensor));
+
+    //importing takes ownership of the handle on success
+    auto imported = importTensor(getContext(), exportTensor(tensor), sizeof(data));
+    REQUIRE(imported.size_bytes() == sizeof(data));
+    Buffer<int> buffer(getContext(), data.size());
+    execute(getContext(), retrieveTensor(imported, buffer));
+    REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
+
+    auto timeline = createExportableTimeline(getContext(), 5);
+    auto shared = importTimeline(getContext(), exportTimeline(timeline));
+    REQUIRE(shared.getValue() == 5);
+    shared.setValue(7);
+    REQUIRE(timeline.getValue() == 7);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
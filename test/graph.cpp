@@ -0,0 +1,181 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <hephaistos/hephaistos.hpp>
+#include <hephaistos/graph.hpp>
+
+#include "validation.hpp"
+
+using namespace hephaistos;
+
+namespace {
+
+auto Extensions = std::to_array({
+    createExecutionGraphExtension()
+});
+
+ContextHandle getContext() {
+    static ContextHandle context = createEmptyContext();
+    if (!context)
+        context = createContext(Extensions);
+    return context;
+}
+
+//records count down their remaining steps, while bouncing between both nodes
+constexpr char source[] = R"(
+#include "hephaistos/graph.glsl"
+
+layout(local_size_x = 32) in;
+
+buffer Visits { uint visits[]; };
+
+layout(push_constant) uniform Push {
+    ExecutionGraph graph;
+    uint count;
+    uint _padding;
+};
+
+void main() {
+    uint record;
+    while (graphPop(graph, NODE, record)) {
+        uint i = record % count;
+        uint steps = record / count;
+        atomicAdd(visits[NODE * count + i], 1u);
+        if (steps > 0u)
+            graphEnqueue(graph, 1u - NODE, (steps - 1u) * count + i);
+    }
+}
+)";
+
+std::string getNodeSource(uint32_t node) {
+    return "#version 460\n#define NODE " + std::to_string(node) + "u\n" + source;
+}
+
+struct Push {
+    uint64_t graph;
+    uint32_t count;
+    uint32_t _padding;
+};
+
+}
+
+TEST_CASE("execution graphs can be enabled", "[graph]") {
+    REQUIRE(isExecutionGraphEnabled(getContext()));
+}
+
+TEST_CASE("execution graphs can be built and seeded", "[graph]") {
+    auto context = getContext();
+    Compiler compiler;
+    Program primary(context, compiler.compile(getNodeSource(0)));
+    Program secondary(context, compiler.compile(getNodeSource(1)));
+
+    constexpr uint32_t N = 64;
+    auto nodes = std::to_array<GraphNode>({
+        { primary },
+        { secondary }
+    });
+    ExecutionGraph graph(context, nodes, N);
+    REQUIRE(graph.getNodeCount() == 2);
+    REQUIRE(graph.getCapacity() == N);
+    REQUIRE(graph.getAddress() != 0);
+    REQUIRE(graph.getQueueOffset(1) == sizeof(WorkQueueHeader) + 8ull * N);
+
+    Buffer<WorkQueueHeader> headers(context, 2);
+    Buffer<uint32_t> items(context, 10);
+    beginSequence(context)
+        .And(graph.seed(1, 10, 5))
+        .Then(retrieveTensor(graph.getTensor(), headers, {
+            .tensorOffset = graph.getQueueOffset(0),
+            .size = sizeof(WorkQueueHeader) }))
+        .And(retrieveTensor(graph.getTensor(), headers, {
+            .bufferOffset = sizeof(WorkQueueHeader),
+            .tensorOffset = graph.getQueueOffset(1),
+            .size = sizeof(WorkQueueHeader) }))
+        .And(retrieveTensor(graph.getTensor(), items, {
+            .tensorOffset = graph.getQueueOffset(1) + sizeof(WorkQueueHeader),
+            .size = 10 * sizeof(uint32_t) }))
+        .Submit().wait();
+
+    //only the seeded node holds records
+    auto h = headers.getMemory();
+    REQUIRE(h[0].count[0] == 0);
+    REQUIRE(h[1].count[0] == 10);
+    for (auto& header : h) {
+        REQUIRE(header.round == 0);
+        REQUIRE(header.capacity == N);
+    }
+    auto r = items.getMemory();
+    for (auto i = 0u; i < 10; ++i)
+        REQUIRE(r[i] == 5 + i);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("execution graph nodes enqueue work to each other", "[graph]") {
+    auto context = getContext();
+    Compiler compiler;
+    Program primary(context, compiler.compile(getNodeSource(0)));
+    Program secondary(context, compiler.compile(getNodeSource(1)));
+
+    //record i takes i % 4 + 1 steps starting at the primary node
+    constexpr uint32_t N = 500;
+    std::vector<uint32_t> seed(N);
+    for (auto i = 0u; i < N; ++i)
+        seed[i] = (i % 4) * N + i;
+    Tensor<uint32_t> records(context, seed);
+    Tensor<uint32_t> visits(context, 2 * N);
+    Buffer<uint32_t> result(context, 2 * N);
+    Buffer<WorkQueueHeader> headers(context, 2);
+    primary.bindParameterList(visits);
+    secondary.bindParameterList(visits);
+
+    auto nodes = std::to_array<GraphNode>({
+        { primary },
+        { secondary, 2 }
+    });
+    ExecutionGraph graph(context, nodes, N);
+    REQUIRE(graph.getNodeCount() == 2);
+    REQUIRE(graph.getCapacity() == N);
+    REQUIRE_THROWS_AS(graph.seed(2, 1), std::out_of_range);
+    REQUIRE_THROWS_AS(graph.seed(0, N + 1), std::out_of_range);
+
+    beginSequence(context)
+        .And(clearTensor(visits, {}))
+        .And(graph.seed(0, records))
+        .Then(graph.launch(Push{ graph.getAddress(), N, 0 }, 8))
+        .Then(retrieveTensor(visits, result))
+        .And(retrieveTensor(graph.getTensor(), headers, {
+            .tensorOffset = graph.getQueueOffset(0),
+            .size = sizeof(WorkQueueHeader) }))
+        .And(retrieveTensor(graph.getTensor(), headers, {
+            .bufferOffset = sizeof(WorkQueueHeader),
+            .tensorOffset = graph.getQueueOffset(1),
+            .size = sizeof(WorkQueueHeader) }))
+        .Submit().wait();
+
+    uint32_t processed = 0;
+    for (auto& header : headers.getMemory()) {
+        REQUIRE(header.round == 8);
+        REQUIRE(header.overflow == 0);
+        REQUIRE(header.dispatch[0] == 0);
+        processed += header.processed;
+    }
+    bool correct = true;
+    uint32_t total = 0;
+    auto mem = result.getMemory();
+    for (auto i = 0u; i < N; ++i) {
+        auto steps = i % 4 + 1;
+        correct &= mem[i] == (steps + 1) / 2;
+        correct &= mem[N + i] == steps / 2;
+        total += steps;
+    }
+    REQUIRE(correct);
+    REQUIRE(processed == total);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
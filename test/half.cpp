@@ -0,0 +1,53 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <hephaistos/half.hpp>
+
+using namespace hephaistos;
+
+TEST_CASE("floats can be converted to half precision", "[half]") {
+    REQUIRE(toHalf(0.0f).bits == 0x0000);
+    REQUIRE(toHalf(-0.0f).bits == 0x8000);
+    REQUIRE(toHalf(1.0f).bits == 0x3C00);
+    REQUIRE(toHalf(-2.0f).bits == 0xC000);
+    REQUIRE(toHalf(65504.0f).bits == 0x7BFF);
+    //smallest subnormal
+    REQUIRE(toHalf(5.9604645e-8f).bits == 0x0001);
+    //ties round to even
+    REQUIRE(toHalf(1.0f + 1.0f / 2048.0f).bits == 0x3C00);
+    REQUIRE(toHalf(1.0f + 3.0f / 2048.0f).bits == 0x3C02);
+    //out of range becomes infinity
+    REQUIRE(toHalf(1e6f).bits == 0x7C00);
+    REQUIRE(toHalf(-std::numeric_limits<float>::infinity()).bits == 0xFC00);
+    REQUIRE(std::isnan(fromHalf(toHalf(std::numeric_limits<float>::quiet_NaN()))));
+
+    //all finite values survive the round trip
+    for (uint32_t bits = 0; bits < 0x7C00; ++bits) {
+        half value{ static_cast<uint16_t>(bits) };
+        REQUIRE(toHalf(fromHalf(value)).bits == bits);
+    }
+}
+
+TEST_CASE("floats can be converted to half precision in bulk", "[half]") {
+    //odd size to cover the remainder not handled by SIMD
+    std::vector<float> values(1027);
+    for (auto i = 0u; i < values.size(); ++i)
+        values[i] = (static_cast<float>(i) - 500.0f) * 0.37f;
+
+    std::vector<half> halfs(values.size());
+    convertToHalf(values, halfs);
+    for (auto i = 0u; i < values.size(); ++i)
+        REQUIRE(halfs[i].bits == toHalf(values[i]).bits);
+
+    std::vector<float> back(values.size());
+    convertFromHalf(halfs, back);
+    for (auto i = 0u; i < values.size(); ++i)
+        REQUIRE(back[i] == fromHalf(halfs[i]));
+
+    REQUIRE_THROWS_AS(convertToHalf(values, std::span<half>(halfs).first(10)), std::logic_error);
+}
@@ -3,9 +3,15 @@
 
 #include <algorithm>
 #include <array>
+#include <cstring>
+#include <filesystem>
+#include <future>
 #include <span>
+#include <string>
+#include <vector>
 
 #include <hephaistos/command.hpp>
+#include <hephaistos/compiler.hpp>
 #include <hephaistos/image.hpp>
 #include <hephaistos/program.hpp>
 
@@ -100,9 +106,9 @@ TEST_CASE("image buffer can create images", "[image]") {
 
     SECTION("image has correct format") {
         auto image = buffer.createImage(false);
-        auto size = getElementSize(ImageBuffer::Format) * width * height;
+        auto size = getElementSize(ImageBuffer::DefaultFormat) * width * height;
 
-        REQUIRE(image.getFormat() == ImageBuffer::Format);
+        REQUIRE(image.getFormat() == ImageBuffer::DefaultFormat);
         REQUIRE(image.size_bytes() == size);
     }
 
@@ -122,7 +128,7 @@ TEST_CASE("image buffer can populate created image", "[image]") {
     Timeline timeline(getContext());
     beginSequence(timeline)
         .And(retrieveImage(image, bufferOut))
-        .Submit();
+        .Submit().wait();
     
     //compare data
     auto outMemory = std::span<uint8_t>{
@@ -133,6 +139,158 @@ TEST_CASE("image buffer can populate created image", "[image]") {
     REQUIRE(!hasValidationErrorOccurred());
 }
 
+TEST_CASE("image buffers can be loaded in parallel", "[image]") {
+    ImageBuffer buffer(getContext(), 3, 3);
+    std::memcpy(buffer.getMemory().data(), data.data(), 36);
+
+    //save a couple of copies to disk
+    std::vector<std::filesystem::path> files;
+    for (auto i = 0; i < 8; ++i) {
+        files.push_back(std::filesystem::temp_directory_path() /
+            ("hephaistos_load_" + std::to_string(i) + ".png"));
+        buffer.save(files.back().string().c_str());
+    }
+
+    auto futures = ImageBuffer::loadAsync(getContext(), files);
+    REQUIRE(futures.size() == files.size());
+    for (auto& future : futures) {
+        auto image = future.get();
+        REQUIRE(image.getWidth() == 3);
+        REQUIRE(image.getHeight() == 3);
+        auto mem = std::span<uint8_t>{
+            reinterpret_cast<uint8_t*>(image.getMemory().data()), 36
+        };
+        REQUIRE(std::equal(data.begin(), data.end(), mem.begin(), mem.end()));
+    }
+
+    //missing files are reported through the future
+    std::vector<std::filesystem::path> missing{ "does/not/exist.png" };
+    auto failed = ImageBuffer::loadAsync(getContext(), missing);
+    REQUIRE_THROWS(failed.front().get());
+
+    for (auto& file : files)
+        std::filesystem::remove(file);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("image buffers can be saved in different file formats", "[image]") {
+    ImageBuffer buffer(getContext(), 3, 3);
+    std::memcpy(buffer.getMemory().data(), data.data(), 36);
+    auto path = std::filesystem::temp_directory_path();
+
+    //PNG at any level survives the round trip
+    for (auto level : { -1, 0, 1, 9 }) {
+        auto file = path / "hephaistos_level.png";
+        buffer.save(file, { .fileFormat = ImageFileFormat::PNG, .compressionLevel = level });
+        auto loaded = ImageBuffer::load(getContext(), file.string().c_str());
+        std::filesystem::remove(file);
+        auto mem = std::span<uint8_t>{
+            reinterpret_cast<uint8_t*>(loaded.getMemory().data()), 36
+        };
+        REQUIRE(std::equal(data.begin(), data.end(), mem.begin(), mem.end()));
+    }
+
+    //PPM drops the alpha channel
+    {
+        auto file = path / "hephaistos_save.ppm";
+        buffer.save(file, { .fileFormat = ImageFileFormat::PPM });
+        auto loaded = ImageBuffer::load(getContext(), file.string().c_str());
+        std::filesystem::remove(file);
+        auto mem = reinterpret_cast<uint8_t*>(loaded.getMemory().data());
+        for (auto i = 0u; i < 36; ++i)
+            REQUIRE(mem[i] == (i % 4 == 3 ? 255 : data[i]));
+    }
+
+    //formats stb cannot load are checked by their header
+    auto qoi = encodeImage(buffer.getMemory(), 3, 3, buffer.getFormat(),
+        { .fileFormat = ImageFileFormat::QOI });
+    REQUIRE(std::memcmp(qoi.data(), "qoif", 4) == 0);
+    auto tiff = encodeImage(buffer.getMemory(), 3, 3, buffer.getFormat(),
+        { .fileFormat = ImageFileFormat::TIFF });
+    REQUIRE(std::memcmp(tiff.data(), "II*", 3) == 0);
+    REQUIRE(tiff.size() > 36);
+    REQUIRE_THROWS(encodeImage(buffer.getMemory(), 3, 3, buffer.getFormat(),
+        { .fileFormat = ImageFileFormat::HDR }));
+    REQUIRE_THROWS(encodeImage(buffer.getMemory(), 4, 4, buffer.getFormat()));
+
+    //saving in the background
+    std::vector<std::future<void>> futures;
+    std::vector<std::filesystem::path> files;
+    for (auto i = 0; i < 4; ++i) {
+        files.push_back(path / ("hephaistos_async_" + std::to_string(i) + ".qoi"));
+        futures.push_back(buffer.saveAsync(files.back(), { .fileFormat = ImageFileFormat::QOI }));
+    }
+    for (auto& future : futures)
+        future.get();
+    for (auto& file : files) {
+        REQUIRE(std::filesystem::file_size(file) == qoi.size());
+        std::filesystem::remove(file);
+    }
+    REQUIRE_THROWS(saveImageAsync("does/not/exist.png", buffer.getMemory(),
+        3, 3, buffer.getFormat()).get());
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("image buffers support high precision formats", "[image]") {
+    auto path = std::filesystem::temp_directory_path();
+
+    SECTION("16 bit images survive saving and loading") {
+        ImageBuffer buffer(getContext(), 3, 3, ImageFormat::R16G16B16A16_UNORM);
+        REQUIRE(buffer.getFormat() == ImageFormat::R16G16B16A16_UNORM);
+        REQUIRE(buffer.size_bytes() == 3 * 3 * 8);
+        auto mem = std::span<uint16_t>{
+            reinterpret_cast<uint16_t*>(buffer.getMemory().data()), 36
+        };
+        for (auto i = 0u; i < mem.size(); ++i)
+            mem[i] = static_cast<uint16_t>(data[i] * 257 + i);
+
+        auto file = (path / "hephaistos_16bit.png").string();
+        buffer.save(file.c_str());
+        auto loaded = ImageBuffer::load(getContext(), file.c_str(),
+            ImageFormat::R16G16B16A16_UNORM);
+        std::filesystem::remove(file);
+
+        auto loadedMem = loaded.getMemory();
+        auto bufferMem = buffer.getMemory();
+        REQUIRE(std::equal(bufferMem.begin(), bufferMem.end(),
+            loadedMem.begin(), loadedMem.end()));
+    }
+
+    SECTION("float images survive saving and loading") {
+        ImageBuffer buffer(getContext(), 2, 2, ImageFormat::R32G32B32A32_SFLOAT);
+        auto mem = std::span<float>{
+            reinterpret_cast<float*>(buffer.getMemory().data()), 16
+        };
+        //values exactly representable in RGBE, alpha is not saved
+        std::array<float, 16> values = { {
+            0.5f, 2.0f, 16.0f, 1.0f,   1.0f, 1.0f, 1.0f, 1.0f,
+            8.0f, 0.0f, 4.0f, 1.0f,   0.25f, 0.125f, 0.75f, 1.0f
+        } };
+        std::copy(values.begin(), values.end(), mem.begin());
+
+        auto file = (path / "hephaistos_float.hdr").string();
+        buffer.save(file.c_str());
+        auto loaded = ImageBuffer::load(getContext(), file.c_str(),
+            ImageFormat::R32G32B32A32_SFLOAT);
+        std::filesystem::remove(file);
+
+        auto loadedMem = std::span<float>{
+            reinterpret_cast<float*>(loaded.getMemory().data()), 16
+        };
+        REQUIRE(std::equal(values.begin(), values.end(),
+            loadedMem.begin(), loadedMem.end()));
+    }
+
+    SECTION("unsupported formats are rejected") {
+        REQUIRE(!ImageBuffer::isFormatSupported(ImageFormat::R32_SFLOAT));
+        REQUIRE_THROWS(ImageBuffer(getContext(), 4, 4, ImageFormat::R32_SFLOAT));
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
 TEST_CASE("images can be copied to and from gpu", "[image]") {
     Buffer<int32_t> bufferIn(getContext(), data2);
     Buffer<int32_t> bufferOut(getContext(), data2.size());
@@ -143,7 +301,7 @@ TEST_CASE("images can be copied to and from gpu", "[image]") {
     beginSequence(timeline)
         .And(updateImage(bufferIn, image))
         .Then(retrieveImage(image, bufferOut))
-        .Submit();
+        .Submit().wait();
     
     //check data
     auto mem = bufferOut.getMemory();
@@ -152,6 +310,126 @@ TEST_CASE("images can be copied to and from gpu", "[image]") {
     REQUIRE(!hasValidationErrorOccurred());
 }
 
+TEST_CASE("image regions can be copied", "[image]") {
+    Buffer<int32_t> bufferIn(getContext(), data2);
+    Buffer<int32_t> bufferOut(getContext(), data2.size());
+    Image image(getContext(), ImageFormat::R32_SINT, 4, 4);
+
+    //upload whole image, then overwrite the center 2x2 tile with the
+    //top left tile of the same buffer reading rows of 4 pixels
+    ImageRegion tile{ .x = 1, .y = 1, .width = 2, .height = 2, .bufferRowLength = 4 };
+    Timeline timeline(getContext());
+    beginSequence(timeline)
+        .And(updateImage(bufferIn, image))
+        .Then(updateImage(bufferIn, image, tile))
+        .Then(retrieveImage(image, bufferOut))
+        .Submit().wait();
+
+    auto expected = data2;
+    expected[5] = data2[0]; expected[6] = data2[1];
+    expected[9] = data2[4]; expected[10] = data2[5];
+    auto mem = bufferOut.getMemory();
+    REQUIRE(std::equal(expected.begin(), expected.end(), mem.begin(), mem.end()));
+
+    SECTION("regions can be retrieved into an offset") {
+        Buffer<int32_t> partial(getContext(), 6);
+        ImageRegion row{ .y = 3, .height = 1, .bufferOffset = 2 * sizeof(int32_t) };
+        beginSequence(getContext())
+            .And(retrieveImage(image, partial, row))
+            .Submit().wait();
+
+        auto part = partial.getMemory();
+        REQUIRE(std::equal(expected.begin() + 12, expected.end(),
+            part.begin() + 2, part.end()));
+    }
+
+    SECTION("regions outside the image are rejected") {
+        ImageRegion outside{ .x = 3, .width = 2 };
+        REQUIRE_THROWS(beginSequence(getContext())
+            .And(updateImage(bufferIn, image, outside))
+            .Submit());
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("images can be copied to and from tensors", "[image]") {
+    Buffer<int32_t> bufferIn(getContext(), data2);
+    Buffer<int32_t> bufferOut(getContext(), data2.size());
+    Tensor<int32_t> tensorIn(getContext(), data2.size());
+    Tensor<int32_t> tensorOut(getContext(), data2.size());
+    Image image(getContext(), ImageFormat::R32_SINT, 4, 4);
+
+    //data only passes the host at the start and end
+    beginSequence(getContext())
+        .And(updateTensor(bufferIn, tensorIn))
+        .Then(copyTensorToImage(tensorIn, image))
+        .Then(copyImageToTensor(image, tensorOut))
+        .Then(retrieveTensor(tensorOut, bufferOut))
+        .Submit().wait();
+
+    auto mem = bufferOut.getMemory();
+    REQUIRE(std::equal(data2.begin(), data2.end(), mem.begin(), mem.end()));
+
+    SECTION("tensors can fill textures") {
+        Texture texture(getContext(), ImageFormat::R32_SINT, 4, 4);
+        beginSequence(getContext())
+            .And(copyTensorToTexture(tensorIn, texture, { .y = 2, .height = 2 }))
+            .Submit().wait();
+    }
+
+    SECTION("tensors must be large enough") {
+        Tensor<int32_t> small(getContext(), 8);
+        REQUIRE_THROWS(beginSequence(getContext())
+            .And(copyImageToTensor(image, small))
+            .Submit());
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("array images copy individual layers", "[image]") {
+    Image image(getContext(), ImageFormat::R32_SINT, 4, 4, ArrayLayers{ 2 });
+    REQUIRE(image.getLayers() == 2);
+    REQUIRE(image.getDepth() == 1);
+    REQUIRE(image.size_bytes() == 2 * 4 * 4 * sizeof(int32_t));
+
+    //fill both layers, then overwrite only the second one
+    std::vector<int32_t> layers(32, 0);
+    Buffer<int32_t> bufferIn(getContext(), layers);
+    Buffer<int32_t> layerIn(getContext(), data2);
+    Buffer<int32_t> bufferOut(getContext(), 32);
+    ImageRegion second{ .layer = 1, .layerCount = 1 };
+    beginSequence(getContext())
+        .And(updateImage(bufferIn, image))
+        .Then(updateImage(layerIn, image, second))
+        .Then(retrieveImage(image, bufferOut))
+        .Submit().wait();
+
+    auto mem = bufferOut.getMemory();
+    REQUIRE(std::all_of(mem.begin(), mem.begin() + 16, [](int32_t v) { return v == 0; }));
+    REQUIRE(std::equal(data2.begin(), data2.end(), mem.begin() + 16, mem.end()));
+
+    SECTION("layers outside the image are rejected") {
+        ImageRegion outside{ .layer = 2 };
+        REQUIRE_THROWS(beginSequence(getContext())
+            .And(updateImage(layerIn, image, outside))
+            .Submit());
+    }
+
+    SECTION("array textures can be updated per layer") {
+        Texture texture(getContext(), ImageFormat::R32_SINT, 4, 4, ArrayLayers{ 3 });
+        REQUIRE(texture.getLayers() == 3);
+        REQUIRE(texture.size_bytes() == 3 * 4 * 4 * sizeof(int32_t));
+
+        beginSequence(getContext())
+            .And(updateTexture(layerIn, texture, { .layer = 2, .layerCount = 1 }))
+            .Submit().wait();
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
 TEST_CASE("image buffer can create texture", "[image]") {
     auto width = GENERATE(1, 24, 60);
     auto height = GENERATE(1, 12, 32);
@@ -165,9 +443,9 @@ TEST_CASE("image buffer can create texture", "[image]") {
 
     SECTION("texture has correct format") {
         auto texture = buffer.createTexture({}, false);
-        auto size = getElementSize(ImageBuffer::Format) * width * height;
+        auto size = getElementSize(ImageBuffer::DefaultFormat) * width * height;
 
-        REQUIRE(texture.getFormat() == ImageBuffer::Format);
+        REQUIRE(texture.getFormat() == ImageBuffer::DefaultFormat);
         REQUIRE(texture.size_bytes() == size);
     }
 
@@ -192,7 +470,7 @@ TEST_CASE("image buffer can populate created texture", "[image]") {
     beginSequence(getContext())
         .And(program.dispatch(3, 3))
         .Then(retrieveImage(image, bufferOut))
-        .Submit();
+        .Submit().wait();
 
     //compare data
     auto outMemory = std::span<uint8_t>{
@@ -202,3 +480,345 @@ TEST_CASE("image buffer can populate created texture", "[image]") {
 
     REQUIRE(!hasValidationErrorOccurred());
 }
+
+TEST_CASE("textures share samplers with the same configuration", "[image]") {
+    ImageBuffer buffer(getContext(), 3, 3);
+    ImageBuffer bufferOut(getContext(), 3, 3);
+    std::memcpy(buffer.getMemory().data(), data.data(), 36);
+    auto image = buffer.createImage(false);
+
+    //the sampler must outlive the texture it got shared with first
+    auto texture = buffer.createTexture({ .filter = Filter::NEAREST });
+    {
+        std::vector<Texture> others;
+        for (int i = 0; i < 8; ++i)
+            others.push_back(buffer.createTexture({ .filter = Filter::NEAREST }));
+        auto moved = std::move(others.back());
+        others.back() = std::move(moved);
+    }
+
+    Program program(getContext(), sampler_code);
+    program.bindParameterList(texture, image);
+    beginSequence(getContext())
+        .And(program.dispatch(3, 3))
+        .Then(retrieveImage(image, bufferOut))
+        .Submit().wait();
+
+    auto outMemory = std::span<uint8_t>{
+        reinterpret_cast<uint8_t*>(bufferOut.getMemory().data()), 36
+    };
+    REQUIRE(std::equal(data.begin(), data.end(), outMemory.begin(), outMemory.end()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("textures can be fetched without a sampler", "[image]") {
+    ImageBuffer buffer(getContext(), 3, 3);
+    ImageBuffer bufferOut(getContext(), 3, 3);
+    std::memcpy(buffer.getMemory().data(), data.data(), 36);
+    auto image = buffer.createImage(false);
+    //lookup table configuration
+    auto texture = buffer.createTexture({
+        .filter = Filter::NEAREST,
+        .unnormalizedCoordinates = true
+    });
+
+    Compiler compiler;
+    Program program(getContext(), compiler.compile(R"(
+        #version 460
+        #extension GL_EXT_samplerless_texture_functions : require
+
+        layout(local_size_x = 1, local_size_y = 1) in;
+
+        layout(binding = 0) uniform texture2D lut;
+        layout(binding = 1, rgba8) uniform writeonly image2D outImage;
+
+        void main() {
+            ivec2 pos = ivec2(gl_GlobalInvocationID.xy);
+            imageStore(outImage, pos, texelFetch(lut, pos, 0));
+        }
+    )"));
+    REQUIRE(program.getBindingTraits(0).type == ParameterType::SAMPLED_IMAGE);
+    program.bindParameterList(texture, image);
+    beginSequence(getContext())
+        .And(program.dispatch(3, 3))
+        .Then(retrieveImage(image, bufferOut))
+        .Submit().wait();
+
+    auto outMemory = std::span<uint8_t>{
+        reinterpret_cast<uint8_t*>(bufferOut.getMemory().data()), 36
+    };
+    REQUIRE(std::equal(data.begin(), data.end(), outMemory.begin(), outMemory.end()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("textures can have mip levels", "[image]") {
+    REQUIRE(getMaxMipLevels(1) == 1);
+    REQUIRE(getMaxMipLevels(32, 16) == 6);
+    REQUIRE(getMaxMipLevels(5, 7, 12) == 4);
+
+    SECTION("mip levels are clamped to the full chain") {
+        Texture texture(getContext(), ImageFormat::R8G8B8A8_UNORM, 32, 16, {}, 20);
+        REQUIRE(texture.getMipLevels() == 6);
+    }
+
+    SECTION("zero mip levels creates full chain") {
+        Texture texture(getContext(), ImageFormat::R8G8B8A8_UNORM, 32, 16, {}, 0);
+        REQUIRE(texture.getMipLevels() == 6);
+    }
+
+    SECTION("mip chain can be generated") {
+        ImageBuffer buffer(getContext(), 32, 16);
+        Texture texture(getContext(), ImageBuffer::DefaultFormat, 32, 16,
+            { .mipmapMode = MipmapMode::NEAREST, .maxLod = 3.0f }, 0);
+
+        beginSequence(getContext())
+            .And(updateTexture(buffer, texture))
+            .Then(generateMipmaps(texture))
+            .Submit().wait();
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("tracked subroutines transition image layouts lazily", "[image]") {
+    ImageBuffer buffer(getContext(), 3, 3);
+    ImageBuffer bufferOut(getContext(), 3, 3);
+    std::memcpy(buffer.getMemory().data(), data.data(), 36);
+    auto texture = buffer.createTexture({ .filter = Filter::NEAREST }, false);
+    auto image = buffer.createImage(false);
+
+    Program program(getContext(), sampler_code);
+    program.bindParameterList(texture, image);
+
+    //consecutive uploads keep the texture as transfer destination until it
+    //gets sampled; the image stays in the general layout for the copies
+    auto sub = SubroutineBuilder(getContext())
+        .trackHazards()
+        .addCommand(updateImage(buffer, image))
+        .addCommand(updateTexture(bufferOut, texture))
+        .addCommand(updateTexture(buffer, texture))
+        .addCommand(program.dispatch(3, 3))
+        .addCommand(retrieveImage(image, bufferOut))
+        .finish();
+    execute(getContext(), sub);
+
+    auto outMemory = std::span<uint8_t>{
+        reinterpret_cast<uint8_t*>(bufferOut.getMemory().data()), 36
+    };
+    REQUIRE(std::equal(data.begin(), data.end(), outMemory.begin(), outMemory.end()));
+
+    SECTION("textures are sampleable after the subroutine") {
+        auto upload = SubroutineBuilder(getContext())
+            .trackHazards()
+            .addCommand(updateTexture(buffer, texture))
+            .finish();
+        execute(getContext(), upload);
+        beginSequence(getContext())
+            .And(program.dispatch(3, 3))
+            .Then(retrieveImage(image, bufferOut))
+            .Submit().wait();
+        REQUIRE(std::equal(data.begin(), data.end(), outMemory.begin(), outMemory.end()));
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("compressed formats report their block layout", "[image]") {
+    REQUIRE(!isCompressed(ImageFormat::R8G8B8A8_UNORM));
+    REQUIRE(isCompressed(ImageFormat::BC7_UNORM));
+    REQUIRE(getBlockExtent(ImageFormat::R32_SFLOAT) == 1);
+    REQUIRE(getBlockExtent(ImageFormat::BC6H_UFLOAT) == 4);
+
+    //partial blocks at the edges count as whole ones
+    REQUIRE(getImageSize(ImageFormat::R32_SFLOAT, 5, 3) == 60);
+    REQUIRE(getImageSize(ImageFormat::BC1_RGBA_UNORM, 5, 3) == 16);
+    REQUIRE(getImageSize(ImageFormat::BC7_UNORM, 8, 8, 2) == 128);
+
+    REQUIRE_THROWS(Image(getContext(), ImageFormat::BC7_UNORM, 4, 4));
+}
+
+namespace {
+
+template<class T>
+void appendValue(std::vector<std::byte>& out, T value) {
+    auto bytes = reinterpret_cast<const std::byte*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+//KTX2 file containing a single level of the given format
+std::vector<std::byte> makeKTX2(ImageFormat format,
+    uint32_t width, uint32_t height, std::span<const uint8_t> payload)
+{
+    constexpr uint8_t identifier[] = {
+        0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+    };
+    std::vector<std::byte> file;
+    for (auto c : identifier)
+        file.push_back(static_cast<std::byte>(c));
+    appendValue<uint32_t>(file, static_cast<uint32_t>(format));
+    appendValue<uint32_t>(file, 1);      //typeSize
+    appendValue<uint32_t>(file, width);
+    appendValue<uint32_t>(file, height);
+    appendValue<uint32_t>(file, 0);      //depth
+    appendValue<uint32_t>(file, 0);      //layerCount
+    appendValue<uint32_t>(file, 1);      //faceCount
+    appendValue<uint32_t>(file, 1);      //levelCount
+    appendValue<uint32_t>(file, 0);      //supercompression
+    for (int i = 0; i < 4; ++i)
+        appendValue<uint32_t>(file, 0);  //dfd & kvd
+    appendValue<uint64_t>(file, 0);      //sgd
+    appendValue<uint64_t>(file, 0);
+    //level index
+    appendValue<uint64_t>(file, 104);
+    appendValue<uint64_t>(file, payload.size());
+    appendValue<uint64_t>(file, payload.size());
+    for (auto c : payload)
+        file.push_back(static_cast<std::byte>(c));
+    return file;
+}
+
+}
+
+TEST_CASE("textures can be loaded from container files", "[image]") {
+    SECTION("KTX2 payloads are uploaded as is") {
+        auto file = makeKTX2(ImageFormat::R8G8B8A8_UNORM, 3, 3, data);
+        auto texture = Texture::load(getContext(), file, { .filter = Filter::NEAREST });
+        REQUIRE(texture.getFormat() == ImageFormat::R8G8B8A8_UNORM);
+        REQUIRE(texture.getWidth() == 3);
+        REQUIRE(texture.getHeight() == 3);
+        REQUIRE(texture.getMipLevels() == 1);
+
+        //sample the texture to check its content
+        ImageBuffer bufferOut(getContext(), 3, 3);
+        Image image(getContext(), ImageFormat::R8G8B8A8_UNORM, 3, 3);
+        Program program(getContext(), sampler_code);
+        program.bindParameterList(texture, image);
+        beginSequence(getContext())
+            .And(program.dispatch(3, 3))
+            .Then(retrieveImage(image, bufferOut))
+            .Submit().wait();
+        auto outMemory = std::span<uint8_t>{
+            reinterpret_cast<uint8_t*>(bufferOut.getMemory().data()), 36
+        };
+        REQUIRE(std::equal(data.begin(), data.end(), outMemory.begin(), outMemory.end()));
+    }
+
+    SECTION("DDS files with block compressed formats can be loaded") {
+        if (!isTextureFormatSupported(getContext(), ImageFormat::BC1_RGBA_UNORM))
+            SKIP("BC1 textures are not supported");
+
+        //DXT1 with two levels: 8x8 -> 2x2 blocks, 4x4 -> 1 block
+        std::vector<std::byte> file;
+        appendValue<uint32_t>(file, 0x20534444); //"DDS "
+        appendValue<uint32_t>(file, 124);
+        appendValue<uint32_t>(file, 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000);
+        appendValue<uint32_t>(file, 8);          //height
+        appendValue<uint32_t>(file, 8);          //width
+        appendValue<uint32_t>(file, 32);         //linear size
+        appendValue<uint32_t>(file, 0);          //depth
+        appendValue<uint32_t>(file, 2);          //mip count
+        file.resize(76);
+        appendValue<uint32_t>(file, 32);         //pixel format size
+        appendValue<uint32_t>(file, 0x4);        //fourCC
+        appendValue<uint32_t>(file, 0x31545844); //"DXT1"
+        file.resize(128);
+        file.resize(128 + 40, std::byte{ 0x55 });
+
+        auto texture = Texture::load(getContext(), file);
+        REQUIRE(texture.getFormat() == ImageFormat::BC1_RGBA_UNORM);
+        REQUIRE(texture.getMipLevels() == 2);
+        REQUIRE(texture.size_bytes() == 32);
+    }
+
+    SECTION("truncated files are rejected") {
+        auto file = makeKTX2(ImageFormat::R8G8B8A8_UNORM, 3, 3, data);
+        file.resize(file.size() - 4);
+        REQUIRE_THROWS(Texture::load(getContext(), file));
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("texel buffers view tensors as formatted texels", "[image]") {
+    if (!isTexelBufferFormatSupported(getContext(), ImageFormat::R32_SFLOAT))
+        SKIP("R32 float texel buffers are not supported");
+
+    Tensor<float> tensor(getContext(), 16);
+    TexelBuffer texels(tensor, ImageFormat::R32_SFLOAT);
+    REQUIRE(texels.getFormat() == ImageFormat::R32_SFLOAT);
+    REQUIRE(texels.size() == 16);
+    REQUIRE(texels.size_bytes() == 64);
+
+    //block compressed formats cannot be used as texels
+    REQUIRE_THROWS(TexelBuffer(tensor, ImageFormat::BC1_RGBA_UNORM));
+    //range must be a multiple of the texel size
+    REQUIRE_THROWS(TexelBuffer(tensor, ImageFormat::R32_SFLOAT, 0, 6));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("sparse textures commit tiles and report accesses", "[image]") {
+    auto context = getContext();
+    if (!isSparseTextureFormatSupported(context, ImageFormat::R8G8B8A8_UNORM))
+        SKIP("device does not support sparse textures");
+
+    SparseTexture texture(context, ImageFormat::R8G8B8A8_UNORM, 256, 256, 256, {}, 0);
+    REQUIRE(texture.getTiledLevels() > 0);
+    auto grid = texture.getTileGrid();
+    REQUIRE(grid.x * texture.getTileWidth() >= 256);
+    REQUIRE(grid.z * texture.getTileDepth() >= 256);
+    REQUIRE(texture.size_committed() == 0);
+
+    SparseTile tile{ grid.x - 1, 0, 0 };
+    texture.commit({ &tile, 1 });
+    texture.commit({ &tile, 1 });
+    REQUIRE(texture.isCommitted(tile));
+    REQUIRE(texture.size_committed() == texture.getTileSize());
+    SparseTile outside{ grid.x, 0, 0 };
+    REQUIRE_THROWS(texture.commit({ &outside, 1 }));
+
+    //mark a texel inside the committed tile and one in the mip tail
+    Compiler compiler;
+    Program program(context, compiler.compile(R"(
+        #version 460
+        #include "hephaistos/sparse.glsl"
+
+        layout(local_size_x = 1) in;
+
+        uniform sampler3D volume;
+        writeonly buffer Output { vec4 value; };
+
+        layout(push_constant) uniform Push {
+            SparseFeedback feedback;
+            uint x, y, z, level;
+        };
+
+        void main() {
+            value = texelFetch(volume, ivec3(x, y, z), int(level));
+            sparseFeedbackMark(feedback, uvec3(x, y, z), level);
+        }
+    )"));
+    struct Push {
+        SparseFeedback feedback;
+        uint32_t x, y, z, level;
+    };
+    Tensor<float> output(context, 4);
+    program.bindParameterList(texture, output);
+    auto x = tile.x * texture.getTileWidth();
+    execute(context, program.dispatch(Push{ texture.getFeedback(), x, 1, 2, 0 }));
+    execute(context, program.dispatch(Push{ texture.getFeedback(), 0, 0, 0, texture.getMipLevels() - 1 }));
+
+    auto accessed = texture.fetchAccessedTiles();
+    REQUIRE(accessed.size() == 1);
+    REQUIRE(accessed[0] == tile);
+    //feedback got reset
+    REQUIRE(texture.fetchAccessedTiles().empty());
+
+    texture.decommitAll();
+    REQUIRE(texture.size_committed() == 0);
+    REQUIRE(!texture.isCommitted(tile));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
@@ -0,0 +1,93 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <hephaistos/buffer.hpp>
+#include <hephaistos/command.hpp>
+#include <hephaistos/multidevice.hpp>
+#include <hephaistos/program.hpp>
+
+#include "validation.hpp"
+
+//shader code
+#include "shader/sbo.h"
+
+using namespace hephaistos;
+
+namespace {
+
+ContextHandle getContext() {
+    static ContextHandle context = createEmptyContext();
+    if (!context)
+        context = createContext();
+    return context;
+}
+
+//most machines only have a single device -> use its context twice
+DeviceGroup getGroup() {
+    return DeviceGroup({ getContext(), getContext() });
+}
+
+}
+
+TEST_CASE("device groups create a context per suitable device", "[multidevice]") {
+    DeviceGroup group({}, 1);
+    REQUIRE(group.size() == 1);
+    REQUIRE(group.getContext(0));
+    REQUIRE_THROWS_AS(group.getContext(1), std::out_of_range);
+
+    REQUIRE_THROWS_AS(DeviceGroup(std::vector<ContextHandle>{}), std::logic_error);
+}
+
+TEST_CASE("distribute hands out every item exactly once", "[multidevice]") {
+    auto group = getGroup();
+    for (auto balancing : { LoadBalancing::STATIC, LoadBalancing::DYNAMIC }) {
+        std::vector<int> hits(101, 0);
+        auto processed = distribute(group, 101, [&hits](uint32_t, uint32_t item) {
+            ++hits[item];
+        }, balancing);
+
+        REQUIRE(std::all_of(hits.begin(), hits.end(), [](int h) { return h == 1; }));
+        REQUIRE(processed.size() == 2);
+        REQUIRE(std::accumulate(processed.begin(), processed.end(), 0u) == 101);
+        if (balancing == LoadBalancing::STATIC) {
+            REQUIRE(processed[0] == 50);
+            REQUIRE(processed[1] == 51);
+        }
+    }
+}
+
+TEST_CASE("distribute rethrows exceptions of tasks", "[multidevice]") {
+    auto group = getGroup();
+    REQUIRE_THROWS_AS(distribute(group, 16, [](uint32_t, uint32_t item) {
+        if (item == 3)
+            throw std::runtime_error("task failed");
+    }), std::runtime_error);
+}
+
+TEST_CASE("replicated programs gather results from all devices", "[multidevice]") {
+    auto group = getGroup();
+    auto programs = createPrograms(group, sbo_code);
+    REQUIRE(programs.size() == group.size());
+
+    auto results = gather<int32_t>(group, 8, [&](uint32_t device, uint32_t item) {
+        auto& context = group.getContext(device);
+        Tensor<int32_t> tensor(context, item + 1);
+        Buffer<int32_t> buffer(context, item + 1);
+        //each device processes its items sequentially -> safe to bind
+        auto& program = programs[device];
+        program.bindParameterList(tensor);
+        executeList(context,
+            program.dispatch(item + 1),
+            retrieveTensor(tensor, buffer));
+        return buffer.getMemory().back();
+    });
+
+    for (auto i = 0; i < 8; ++i)
+        REQUIRE(results[i] == i);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
@@ -0,0 +1,142 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <hephaistos/buffer.hpp>
+#include <hephaistos/command.hpp>
+#include <hephaistos/context.hpp>
+#include <hephaistos/neighbours.hpp>
+#include <hephaistos/raytracing.hpp>
+
+#include "validation.hpp"
+
+using namespace hephaistos;
+
+namespace {
+
+auto Extensions = std::to_array({
+    createRaytracingExtension()
+});
+
+ContextHandle getContext() {
+    static ContextHandle context = createEmptyContext();
+    if (!context) {
+        //grid search does not need ray tracing
+        try {
+            context = createContext(Extensions);
+        }
+        catch (const std::runtime_error&) {
+            context = createContext();
+        }
+    }
+    return context;
+}
+
+constexpr uint32_t N = 3000;
+constexpr uint32_t Q = 200;
+constexpr float Radius = 0.8f;
+constexpr uint32_t K = 4;
+
+//deterministic points inside a cube of edge 10
+std::vector<float> createPoints(uint32_t count, uint32_t seed) {
+    std::vector<float> points(3 * count);
+    for (auto& p : points) {
+        seed = seed * 1664525u + 1013904223u;
+        p = 10.0f * static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+    }
+    return points;
+}
+
+//all neighbours of a query ordered by distance and index
+std::vector<std::pair<float, uint32_t>> findNeighbours(
+    const std::vector<float>& points, const float* q)
+{
+    std::vector<std::pair<float, uint32_t>> result;
+    for (auto i = 0u; i < points.size() / 3; ++i) {
+        auto dx = points[3 * i] - q[0];
+        auto dy = points[3 * i + 1] - q[1];
+        auto dz = points[3 * i + 2] - q[2];
+        auto d = std::sqrt(dx * dx + dy * dy + dz * dz);
+        if (d <= Radius)
+            result.push_back({ d, i });
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+}
+
+TEST_CASE("neighbour searches find points within a radius", "[neighbours]") {
+    auto context = getContext();
+    auto points = createPoints(N, 17);
+    auto queries = createPoints(Q, 23);
+    Tensor<float> pointTensor(context, points);
+    Tensor<float> queryTensor(context, queries);
+
+    for (auto method : { NeighbourMethod::GRID, NeighbourMethod::RAYTRACING }) {
+        if (method == NeighbourMethod::RAYTRACING && !isRaytracingEnabled(context))
+            continue;
+        NeighbourSearch search(context, { .method = method });
+        REQUIRE(search.getMethod() == method);
+        auto index = search.build(pointTensor, Radius);
+        REQUIRE(index.getCount() == N);
+        REQUIRE(index.getRadius() == Radius);
+
+        //enough room for all neighbours
+        constexpr uint32_t MaxNeighbours = 64;
+        Tensor<uint32_t> counts(context, Q);
+        Tensor<Neighbour> neighbours(context, Q * MaxNeighbours);
+        Buffer<uint32_t> countBuffer(context, Q);
+        Buffer<Neighbour> neighbourBuffer(context, Q * MaxNeighbours);
+        auto countMem = countBuffer.getMemory();
+        auto neighbourMem = neighbourBuffer.getMemory();
+
+        beginSequence(context)
+            .And(search.queryRadius(index, queryTensor, counts, neighbours, MaxNeighbours))
+            .Then(retrieveTensor(counts, countBuffer))
+            .And(retrieveTensor(neighbours, neighbourBuffer))
+            .Submit().wait();
+        for (auto i = 0u; i < Q; ++i) {
+            auto expected = findNeighbours(points, queries.data() + 3 * i);
+            REQUIRE(expected.size() <= MaxNeighbours);
+            REQUIRE(countMem[i] == expected.size());
+            std::vector<uint32_t> found;
+            for (auto j = 0u; j < countMem[i]; ++j)
+                found.push_back(neighbourMem[i * MaxNeighbours + j].index);
+            std::sort(found.begin(), found.end());
+            for (auto& [d, idx] : expected)
+                REQUIRE(std::binary_search(found.begin(), found.end(), idx));
+        }
+
+        //nearest neighbours are ordered
+        beginSequence(context)
+            .And(search.queryNearest(index, queryTensor, counts, neighbours, K))
+            .Then(retrieveTensor(counts, countBuffer))
+            .And(retrieveTensor(neighbours, neighbourBuffer))
+            .Submit().wait();
+        for (auto i = 0u; i < Q; ++i) {
+            auto expected = findNeighbours(points, queries.data() + 3 * i);
+            REQUIRE(countMem[i] == std::min<size_t>(expected.size(), K));
+            for (auto j = 0u; j < countMem[i]; ++j) {
+                REQUIRE(neighbourMem[i * K + j].index == expected[j].second);
+                REQUIRE_THAT(neighbourMem[i * K + j].distance,
+                    Catch::Matchers::WithinAbs(expected[j].first, 1e-5f));
+            }
+        }
+
+        //output must fit
+        Tensor<Neighbour> small(context, 1);
+        REQUIRE_THROWS_AS(search.queryNearest(index, queryTensor, counts, small, K),
+            std::logic_error);
+    }
+
+    //check validation errors
+    REQUIRE(!hasValidationErrorOccurred());
+}
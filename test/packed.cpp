@@ -0,0 +1,26 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <hephaistos/packed.hpp>
+
+using namespace hephaistos;
+
+TEST_CASE("packed types extension can be used", "[packed]") {
+	//query properties of first device
+	auto devices = enumerateDevices();
+	auto& device = devices.front();
+	auto props = getPackedTypesProperties(device);
+	auto ext = createPackedTypesExtension(props);
+	auto context = hephaistos::createContext(device, { &ext, 1 });
+
+	//check enabled props are the same
+	auto& enabled = getEnabledPackedTypes(context);
+	bool same =
+		props.storageBuffer16BitAccess == enabled.storageBuffer16BitAccess &&
+		props.uniformAndStorageBuffer16BitAccess == enabled.uniformAndStorageBuffer16BitAccess &&
+		props.storagePushConstant16 == enabled.storagePushConstant16 &&
+		props.storageBuffer8BitAccess == enabled.storageBuffer8BitAccess &&
+		props.uniformAndStorageBuffer8BitAccess == enabled.uniformAndStorageBuffer8BitAccess &&
+		props.storagePushConstant8 == enabled.storagePushConstant8 &&
+		props.integerDotProduct == enabled.integerDotProduct;
+	REQUIRE(same);
+}
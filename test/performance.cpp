@@ -0,0 +1,61 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <vector>
+
+#include <hephaistos/hephaistos.hpp>
+#include <hephaistos/performance.hpp>
+
+#include "validation.hpp"
+
+using namespace hephaistos;
+
+namespace {
+
+bool isSupported() {
+    auto devices = enumerateDevices();
+    return std::any_of(devices.begin(), devices.end(),
+        [](const DeviceHandle& d) { return isPerformanceQuerySupported(d); });
+}
+
+ContextHandle getContext() {
+    static ContextHandle context = createEmptyContext();
+    if (!context) {
+        auto extensions = std::to_array({ createPerformanceQueryExtension() });
+        context = createContext(extensions);
+    }
+    return context;
+}
+
+}
+
+TEST_CASE("performance queries measure hardware counters", "[performance]") {
+    if (!isSupported())
+        SKIP("no device supports performance queries");
+    REQUIRE(isPerformanceQueryEnabled(getContext()));
+
+    auto counters = enumeratePerformanceCounters(getContext());
+    REQUIRE(!counters.empty());
+
+    REQUIRE_THROWS(PerformanceQuery(getContext(), std::vector<std::string>{ "no such counter" }));
+
+    std::vector<std::string> names = { counters.front().name };
+    PerformanceQuery query(getContext(), names);
+    REQUIRE(query.getPassCount() >= 1);
+    REQUIRE(query.getCounters().size() == 1);
+
+    Tensor<int> tensor(getContext(), 1024);
+    Buffer<int> buffer(getContext(), 1024);
+    auto results = query.measureList(
+        clearTensor(tensor, { .data = 3 }),
+        retrieveTensor(tensor, buffer));
+    REQUIRE(results.size() == 1);
+    REQUIRE(results[0].name == counters.front().name);
+    REQUIRE(results[0].unit == counters.front().unit);
+    REQUIRE(std::all_of(buffer.getMemory().begin(), buffer.getMemory().end(),
+        [](int v) { return v == 3; }));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
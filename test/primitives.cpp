@@ -0,0 +1,436 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <hephaistos/buffer.hpp>
+#include <hephaistos/command.hpp>
+#include <hephaistos/compiler.hpp>
+#include <hephaistos/context.hpp>
+#include <hephaistos/primitives.hpp>
+#include <hephaistos/program.hpp>
+
+#include "validation.hpp"
+
+using namespace hephaistos;
+
+namespace {
+
+ContextHandle getContext() {
+    static ContextHandle context = createEmptyContext();
+    if (!context)
+        context = createContext();
+    return context;
+}
+
+//spans multiple tiles with a partial last one
+constexpr uint32_t N = 10001;
+
+}
+
+TEST_CASE("primitives scan tensors across tiles", "[primitives]") {
+    auto context = getContext();
+    for (auto useSubgroups : { true, false }) {
+        Primitives primitives(context, { .useSubgroups = useSubgroups });
+        REQUIRE(primitives.getTileSize() < N);
+
+        Buffer<uint32_t> buffer(context, N);
+        auto mem = buffer.getMemory();
+        for (auto i = 0u; i < N; ++i)
+            mem[i] = i % 7;
+        Tensor<uint32_t> tensor(buffer);
+        Tensor<uint32_t> exclusive(context, N);
+
+        execute(context, primitives.exclusiveScan(tensor, exclusive, ElementType::UINT32));
+        execute(context, primitives.inclusiveScan(tensor));
+        execute(context, retrieveTensor(tensor, buffer));
+
+        std::vector<uint32_t> expected(N);
+        for (auto i = 0u; i < N; ++i)
+            expected[i] = i % 7;
+        std::inclusive_scan(expected.begin(), expected.end(), expected.begin());
+        REQUIRE(std::equal(expected.begin(), expected.end(), mem.begin()));
+
+        execute(context, retrieveTensor(exclusive, buffer));
+        REQUIRE(mem[0] == 0);
+        REQUIRE(std::equal(expected.begin(), expected.end() - 1, mem.begin() + 1));
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("primitives reduce tensors", "[primitives]") {
+    auto context = getContext();
+    Primitives primitives(context);
+
+    Buffer<int32_t> buffer(context, N);
+    auto mem = buffer.getMemory();
+    for (auto i = 0u; i < N; ++i)
+        mem[i] = static_cast<int32_t>(i) - 5000;
+    Tensor<int32_t> tensor(buffer);
+    Tensor<int32_t> result(context, 3);
+
+    execute(context, primitives.reduce(tensor, result, ReduceOperation::MIN));
+    Buffer<int32_t> out(context, 3);
+    execute(context, retrieveTensor(result, out));
+    REQUIRE(out.getMemory()[0] == -5000);
+
+    execute(context, primitives.reduce(tensor, result, ReduceOperation::ADD));
+    execute(context, retrieveTensor(result, out));
+    REQUIRE(out.getMemory()[0] == 0);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("primitives compact items in order", "[primitives]") {
+    auto context = getContext();
+    Primitives primitives(context);
+
+    //two columns: one of uint and one of uint pairs
+    Buffer<uint32_t> flagBuffer(context, N);
+    Buffer<uint32_t> srcBuffer(context, 3 * N);
+    auto flagMem = flagBuffer.getMemory();
+    auto srcMem = srcBuffer.getMemory();
+    for (auto i = 0u; i < N; ++i) {
+        flagMem[i] = i % 3 == 0 ? 5 : 0;
+        srcMem[i] = i;
+        srcMem[N + 2 * i] = i;
+        srcMem[N + 2 * i + 1] = 2 * i;
+    }
+    Tensor<uint32_t> flags(flagBuffer);
+    Tensor<uint32_t> src(srcBuffer);
+    Tensor<uint32_t> dst(context, 3 * N);
+    Tensor<uint32_t> count(context, 2);
+
+    std::array<CompactColumn, 2> columns = {
+        CompactColumn{ 0, 0, 4 },
+        CompactColumn{ 4ull * N, 4ull * N, 8 }
+    };
+    execute(context, primitives.compact(flags, src, dst, columns, N, &count, 4));
+
+    Buffer<uint32_t> dstBuffer(context, 3 * N);
+    Buffer<uint32_t> countBuffer(context, 2);
+    execute(context, retrieveTensor(dst, dstBuffer));
+    execute(context, retrieveTensor(count, countBuffer));
+
+    auto kept = (N + 2) / 3;
+    REQUIRE(countBuffer.getMemory()[1] == kept);
+    auto dstMem = dstBuffer.getMemory();
+    bool correct = true;
+    for (auto i = 0u; i < kept; ++i) {
+        correct &= dstMem[i] == 3 * i;
+        correct &= dstMem[N + 2 * i] == 3 * i;
+        correct &= dstMem[N + 2 * i + 1] == 6 * i;
+    }
+    REQUIRE(correct);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("primitives sort keys with values", "[primitives]") {
+    auto context = getContext();
+    for (auto useSubgroups : { true, false }) {
+        Primitives primitives(context, { .useSubgroups = useSubgroups });
+
+        //few distinct keys to check the sort is stable
+        Buffer<float> keyBuffer(context, N);
+        Buffer<uint32_t> valueBuffer(context, N);
+        auto keyMem = keyBuffer.getMemory();
+        auto valueMem = valueBuffer.getMemory();
+        for (auto i = 0u; i < N; ++i) {
+            keyMem[i] = static_cast<float>((i * 7919u) % 101u) - 50.5f;
+            valueMem[i] = i;
+        }
+        std::vector<std::pair<float, uint32_t>> expected(N);
+        for (auto i = 0u; i < N; ++i)
+            expected[i] = { keyMem[i], i };
+        std::stable_sort(expected.begin(), expected.end(),
+            [](auto& a, auto& b) { return a.first < b.first; });
+
+        Tensor<float> keys(keyBuffer);
+        Tensor<uint32_t> values(valueBuffer);
+        execute(context, primitives.sort(keys, SortKeyType::FLOAT32, N, &values));
+        execute(context, retrieveTensor(keys, keyBuffer));
+        execute(context, retrieveTensor(values, valueBuffer));
+
+        bool correct = true;
+        for (auto i = 0u; i < N; ++i) {
+            correct &= keyMem[i] == expected[i].first;
+            correct &= valueMem[i] == expected[i].second;
+        }
+        REQUIRE(correct);
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("primitives sort indices of 64 bit keys", "[primitives]") {
+    auto context = getContext();
+    Primitives primitives(context);
+
+    Buffer<int64_t> keyBuffer(context, N);
+    auto keyMem = keyBuffer.getMemory();
+    for (auto i = 0u; i < N; ++i)
+        keyMem[i] = (static_cast<int64_t>((i * 7919u) % N) - 5000) << 33;
+    Tensor<int64_t> keys(keyBuffer);
+    Tensor<uint32_t> indices(context, N);
+
+    execute(context, primitives.sortIndices(keys, indices, SortKeyType::INT64));
+    Buffer<uint32_t> indexBuffer(context, N);
+    execute(context, retrieveTensor(indices, indexBuffer));
+
+    std::vector<uint32_t> expected(N);
+    std::iota(expected.begin(), expected.end(), 0u);
+    std::stable_sort(expected.begin(), expected.end(),
+        [&](uint32_t a, uint32_t b) { return keyMem[a] < keyMem[b]; });
+    auto indexMem = indexBuffer.getMemory();
+    REQUIRE(std::equal(expected.begin(), expected.end(), indexMem.begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("primitives accumulate histograms", "[primitives]") {
+    auto context = getContext();
+    Primitives primitives(context);
+    REQUIRE(primitives.getHistogramStrategy(ElementType::UINT32, 37) == HistogramStrategy::SHARED);
+
+    //few bins to stress contention; some indices are out of range
+    Buffer<uint32_t> indexBuffer(context, N);
+    auto indexMem = indexBuffer.getMemory();
+    for (auto i = 0u; i < N; ++i)
+        indexMem[i] = (i * 7919u) % 40u;
+    Tensor<uint32_t> indices(indexBuffer);
+    Tensor<uint32_t> histogram(context, 37);
+    execute(context, clearTensor(histogram, {}));
+
+    std::vector<uint32_t> expected(37);
+    for (auto i = 0u; i < N; ++i) {
+        if (indexMem[i] < 37)
+            expected[indexMem[i]] += 2;
+    }
+
+    //each strategy accumulates onto the previous result
+    execute(context, primitives.histogram(indices, histogram, ElementType::UINT32,
+        nullptr, N, HistogramStrategy::GLOBAL));
+    execute(context, primitives.histogram(indices, histogram, ElementType::UINT32,
+        nullptr, N, HistogramStrategy::SHARED));
+
+    Buffer<uint32_t> out(context, 37);
+    execute(context, retrieveTensor(histogram, out));
+    auto outMem = out.getMemory();
+    REQUIRE(std::equal(expected.begin(), expected.end(), outMem.begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("primitives reduce and bin floats deterministically", "[primitives]") {
+    auto context = getContext();
+    //the fixed order must not depend on subgroups
+    Primitives primitives(context, { .localSize = 128, .deterministic = true });
+    Primitives scalar(context, { .localSize = 128, .useSubgroups = false, .deterministic = true });
+    REQUIRE(primitives.isDeterministic());
+    REQUIRE(primitives.getHistogramStrategy(ElementType::FLOAT32, 37) ==
+        HistogramStrategy::DETERMINISTIC);
+
+    //values of varying magnitude make the sum sensitive to the order
+    Buffer<float> buffer(context, N);
+    Buffer<uint32_t> indexBuffer(context, N);
+    auto mem = buffer.getMemory();
+    auto indexMem = indexBuffer.getMemory();
+    double sum = 0.0;
+    std::vector<double> expected(37);
+    for (auto i = 0u; i < N; ++i) {
+        mem[i] = static_cast<float>((i * 7919u) % 1000u) * (i % 3 == 0 ? 1e3f : 1e-3f);
+        indexMem[i] = (i * 31u) % 40u;
+        sum += mem[i];
+        if (indexMem[i] < 37)
+            expected[indexMem[i]] += mem[i];
+    }
+    Tensor<float> tensor(buffer);
+    Tensor<uint32_t> indices(indexBuffer);
+
+    Tensor<float> result(context, size_t{ 1 });
+    Buffer<float> out(context, 1);
+    std::array<uint32_t, 3> bits;
+    for (auto i = 0u; i < bits.size(); ++i) {
+        auto& p = i < 2 ? primitives : scalar;
+        execute(context, p.reduce(tensor, result));
+        execute(context, retrieveTensor(result, out));
+        bits[i] = std::bit_cast<uint32_t>(out.getMemory()[0]);
+    }
+    REQUIRE(bits[0] == bits[1]);
+    REQUIRE(bits[0] == bits[2]);
+    REQUIRE_THAT(std::bit_cast<float>(bits[0]), Catch::Matchers::WithinRel(sum, 1e-5));
+
+    //float bins without atomics
+    Tensor<float> histogram(context, size_t{ 37 });
+    Buffer<float> histOut(context, 37);
+    std::vector<float> first;
+    for (auto i = 0u; i < 2; ++i) {
+        execute(context, clearTensor(histogram, {}));
+        execute(context, primitives.histogram(indices, histogram,
+            ElementType::FLOAT32, &tensor));
+        execute(context, retrieveTensor(histogram, histOut));
+        auto hist = histOut.getMemory();
+        if (i == 0)
+            first.assign(hist.begin(), hist.end());
+        else
+            REQUIRE(std::memcmp(first.data(), hist.data(), hist.size_bytes()) == 0);
+    }
+    for (auto b = 0u; b < expected.size(); ++b)
+        REQUIRE_THAT(first[b], Catch::Matchers::WithinRel(expected[b], 1e-5));
+
+    //integer bins count exactly
+    Tensor<uint32_t> counts(context, 37);
+    execute(context, clearTensor(counts, {}));
+    execute(context, primitives.histogram(indices, counts, ElementType::UINT32,
+        nullptr, N, HistogramStrategy::DETERMINISTIC));
+    Buffer<uint32_t> countOut(context, 37);
+    execute(context, retrieveTensor(counts, countOut));
+    auto countMem = countOut.getMemory();
+    for (auto b = 0u; b < 37; ++b) {
+        auto n = std::count_if(indexMem.begin(), indexMem.end(),
+            [b](uint32_t idx) { return idx == b; });
+        REQUIRE(countMem[b] == static_cast<uint32_t>(n));
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("primitives run chains of indirect dispatches", "[primitives]") {
+    auto context = getContext();
+    Primitives primitives(context);
+
+    //each workgroup adds two items to the count of the next pass
+    constexpr char source[] = R"(
+#version 460
+layout(local_size_x = 4) in;
+layout(binding = 0) buffer Counts { uint counts[]; };
+layout(push_constant) uniform Push { uint pass; };
+void main() {
+    if (gl_LocalInvocationIndex == 0u)
+        atomicAdd(counts[pass + 1u], 2u);
+}
+)";
+    Compiler compiler;
+    Program program(context, compiler.compile(source));
+    Tensor<uint32_t> counts(context, std::to_array<uint32_t>({ 10, 0, 0, 0 }));
+    program.bindParameterList(counts);
+
+    auto push = std::to_array<uint32_t>({ 0, 1, 2 });
+    auto pushData = std::as_bytes(std::span<const uint32_t>(push));
+    auto passes = std::to_array<IndirectPass>({
+        //10 items -> 3 groups
+        { .program = program, .count = counts, .countOffset = 0,
+            .pushData = pushData.subspan(0, 4) },
+        //6 items -> 2 groups
+        { .program = program, .count = counts, .countOffset = 4,
+            .pushData = pushData.subspan(4, 4) },
+        //4 items -> 4 groups clamped to 1
+        { .program = program, .count = counts, .countOffset = 8,
+            .itemsPerGroup = 1, .maxGroups = 1, .pushData = pushData.subspan(8, 4) }
+    });
+    execute(context, primitives.indirectChain(passes));
+
+    Buffer<uint32_t> buffer(context, 4);
+    execute(context, retrieveTensor(counts, buffer));
+    auto expected = std::to_array<uint32_t>({ 10, 6, 4, 2 });
+    REQUIRE(std::equal(expected.begin(), expected.end(), buffer.getMemory().begin()));
+
+    REQUIRE_THROWS_AS(primitives.indirectChain(std::to_array<IndirectPass>({
+        { .program = program, .count = counts, .countOffset = 16 }
+    })), std::out_of_range);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("primitives compress sparse tensors", "[primitives]") {
+    auto context = getContext();
+    Primitives primitives(context);
+
+    //mix of empty, full and partial blocks
+    Buffer<uint32_t> buffer(context, N);
+    auto mem = buffer.getMemory();
+    for (auto i = 0u; i < N; ++i)
+        mem[i] = (i / 32) % 3 == 0 ? 0 : (i / 32) % 3 == 1 ? i + 1 : (i % 5 == 0 ? i : 0);
+    std::vector<uint32_t> expected(mem.begin(), mem.end());
+    Tensor<uint32_t> tensor(buffer);
+    Tensor<std::byte> stream(context, getMaxCompressedSize(N));
+
+    execute(context, primitives.compress(tensor, stream));
+    Buffer<std::byte> streamBuffer(context, getMaxCompressedSize(N));
+    execute(context, retrieveTensor(stream, streamBuffer));
+
+    //device and host encode alike
+    auto compressed = compressData(std::as_bytes(std::span<const uint32_t>(expected)));
+    auto size = getCompressedSize(streamBuffer.getMemory());
+    REQUIRE(size == compressed.size());
+    REQUIRE(size < 4ull * N);
+    REQUIRE(getDecompressedSize(compressed) == 4ull * N);
+    REQUIRE(std::equal(compressed.begin(), compressed.end(), streamBuffer.getMemory().begin()));
+
+    std::vector<uint32_t> decoded(N, 7);
+    decompressData(compressed, std::as_writable_bytes(std::span<uint32_t>(decoded)));
+    REQUIRE(decoded == expected);
+
+    //upload the stream and decompress it on the device
+    Tensor<uint32_t> output(context, N);
+    execute(context, primitives.decompress(stream, output));
+    execute(context, retrieveTensor(output, buffer));
+    REQUIRE(std::equal(expected.begin(), expected.end(), mem.begin()));
+
+    REQUIRE_THROWS_AS(decompressData(std::span(compressed).first(12),
+        std::as_writable_bytes(std::span<uint32_t>(decoded))), std::logic_error);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("primitives copy the prefix counted on the device", "[primitives]") {
+    auto context = getContext();
+    Primitives primitives(context);
+
+    //queue-like layout: count followed by a column of capacity items
+    constexpr uint32_t Capacity = 4096;
+    constexpr uint32_t Live = 37;
+    Buffer<uint32_t> buffer(context, 4 + Capacity);
+    auto mem = buffer.getMemory();
+    std::fill(mem.begin(), mem.end(), 0u);
+    mem[0] = Live;
+    for (auto i = 0u; i < Capacity; ++i)
+        mem[4 + i] = i + 1;
+    Tensor<uint32_t> src(buffer);
+
+    //host reads the mapped tensor directly if possible
+    Tensor<uint32_t> dst(context, 4 + Capacity, true);
+    auto columns = std::to_array<CompactColumn>({ { 16, 16, 4 } });
+    execute(context, clearTensor(dst, {}));
+    execute(context, primitives.copyPrefix(src, dst, 0, columns, Capacity));
+
+    Buffer<uint32_t> out(context, 4 + Capacity);
+    execute(context, retrieveTensor(dst, out));
+    auto outMem = out.getMemory();
+    REQUIRE(outMem[0] == Live);
+    REQUIRE(std::equal(mem.begin() + 4, mem.begin() + 4 + Live, outMem.begin() + 4));
+    REQUIRE(std::all_of(outMem.begin() + 4 + Live, outMem.end(), [](uint32_t v) { return v == 0; }));
+
+    //counts beyond the capacity are clamped
+    mem[0] = Capacity + 100;
+    execute(context, updateTensor(buffer, src));
+    execute(context, primitives.copyPrefix(src, dst, 0, columns, 100));
+    execute(context, retrieveTensor(dst, out));
+    REQUIRE(outMem[0] == 100);
+    REQUIRE(std::equal(mem.begin() + 4, mem.begin() + 104, outMem.begin() + 4));
+
+    REQUIRE_THROWS_AS(primitives.copyPrefix(src, dst, 2, columns, Capacity), std::out_of_range);
+    REQUIRE_THROWS_AS(primitives.copyPrefix(src, src, 0, columns, Capacity), std::logic_error);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
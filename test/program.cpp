@@ -2,12 +2,20 @@
 
 #include <algorithm>
 #include <array>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <hephaistos/buffer.hpp>
 #include <hephaistos/command.hpp>
+#include <hephaistos/compiler.hpp>
 #include <hephaistos/context.hpp>
 #include <hephaistos/image.hpp>
 #include <hephaistos/program.hpp>
+#include <hephaistos/stopwatch.hpp>
 
 #include "validation.hpp"
 
@@ -54,13 +62,41 @@ TEST_CASE("program can use specialization constants", "[program]") {
     beginSequence(timeline)
         .And(program.dispatch(3))
         .Then(retrieveTensor(tensor, buffer))
-        .Submit();
+        .Submit().wait();
     
     REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
 
     REQUIRE(!hasValidationErrorOccurred());
 }
 
+TEST_CASE("specialization constants can be folded into the code", "[program]") {
+    Buffer<int32_t> buffer(getContext(), 3);
+    Tensor<int32_t> tensor(getContext(), 3);
+    auto code = specializeCode(spec_code, dataStruct);
+    REQUIRE(code.size() > 0);
+    Program program(getContext(), code);
+    program.bindParameterList(tensor);
+
+    beginSequence(getContext())
+        .And(program.dispatch(3))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
+
+    //constants without data keep their defaults
+    int32_t first = 7;
+    Program partial(getContext(), specializeCode(spec_code, first));
+    partial.bindParameterList(tensor);
+    beginSequence(getContext())
+        .And(partial.dispatch(3))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    std::array<int32_t, 3> expected = { { 7, 3, 9 } };
+    REQUIRE(std::equal(expected.begin(), expected.end(), buffer.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
 TEST_CASE("program can use push constants", "[program]") {
     Buffer<int32_t> buffer(getContext(), 3);
     Tensor<int32_t> tensor(getContext(), 3);
@@ -71,13 +107,41 @@ TEST_CASE("program can use push constants", "[program]") {
     beginSequence(timeline)
         .And(program.dispatch(dataStruct, 3))
         .Then(retrieveTensor(tensor, buffer))
-        .Submit();
+        .Submit().wait();
     
     REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
 
     REQUIRE(!hasValidationErrorOccurred());
 }
 
+TEST_CASE("dispatches can own their push data", "[program]") {
+    Buffer<int32_t> buffer(getContext(), 3);
+    Tensor<int32_t> tensor(getContext(), 3);
+    Program program(getContext(), push_code);
+    program.bindParameterList(tensor);
+
+    //push data goes out of scope before the commands are recorded
+    std::vector<DispatchCommand> dispatches;
+    for (auto i = 0; i < 2; ++i) {
+        DataStruct push{ 15 * i, 4 * i, 32 * i };
+        dispatches.push_back(program.dispatch(push, 3).copyPushData());
+    }
+    //copies point into their own storage
+    auto copy = dispatches.back();
+    dispatches.clear();
+    REQUIRE(copy.pushData.size() == sizeof(DataStruct));
+
+    Timeline timeline(getContext());
+    beginSequence(timeline)
+        .And(copy)
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+
+    REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
 TEST_CASE("program can use uniform buffers", "[program]") {
     Buffer<int32_t> buffer(getContext(), 3);
     Tensor<int32_t> tensor(getContext(), 3);
@@ -89,13 +153,97 @@ TEST_CASE("program can use uniform buffers", "[program]") {
     beginSequence(timeline)
         .And(program.dispatch(3))
         .Then(retrieveTensor(tensor, buffer))
-        .Submit();
+        .Submit().wait();
     
     REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
 
     REQUIRE(!hasValidationErrorOccurred());
 }
 
+TEST_CASE("uniform rings give each dispatch its own block", "[program]") {
+    Buffer<int32_t> bufferA(getContext(), 3), bufferB(getContext(), 3);
+    Tensor<int32_t> tensorA(getContext(), 3), tensorB(getContext(), 3);
+    UniformRing ring(getContext(), sizeof(DataStruct), 4);
+    Program program(getContext(), ubo_code);
+    DataStruct other{ 7, 8, 9 };
+
+    auto builder = beginSequence(getContext());
+    REQUIRE(ring.push(dataStruct) == 0);
+    program.bindParameterList(ring, tensorA);
+    builder.And(program.dispatch(3));
+    REQUIRE(ring.push(other) == 1);
+    program.bindParameterList(ring, tensorB);
+    builder.And(program.dispatch(3))
+        .Then(retrieveTensor(tensorA, bufferA))
+        .And(retrieveTensor(tensorB, bufferB))
+        .Submit().wait();
+
+    auto expected = std::to_array<int32_t>({ 7, 8, 9 });
+    REQUIRE(std::equal(data.begin(), data.end(), bufferA.getMemory().begin()));
+    REQUIRE(std::equal(expected.begin(), expected.end(), bufferB.getMemory().begin()));
+    REQUIRE(ring.current() == 1);
+    REQUIRE(ring.capacity() == 4);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("argument blocks pass addresses and scalars to programs", "[program]") {
+    constexpr char source[] = R"(
+#version 460
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_scalar_block_layout : require
+
+layout(local_size_x = 4) in;
+
+layout(buffer_reference, scalar) buffer Data { int v[]; };
+
+layout(scalar) uniform Arguments {
+    int scale;
+    Data src;
+    Data dst;
+    float offset;
+};
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    dst.v[i] = src.v[i] * scale + int(offset);
+}
+)";
+    Compiler compiler;
+    Program program(getContext(), compiler.compile(source));
+    auto input = std::to_array<int32_t>({ 1, 2, 3, 4 });
+    Tensor<int32_t> src(getContext(), input);
+    Tensor<int32_t> dstA(getContext(), 4), dstB(getContext(), 4);
+    Buffer<int32_t> bufferA(getContext(), 4), bufferB(getContext(), 4);
+    ArgumentBlock block(getContext(), 64, 4);
+
+    //scale is followed by padding to align the address
+    block.add(int32_t(2)).add(src).add(dstA).add(10.0f);
+    REQUIRE(block.size_bytes() == 28);
+    REQUIRE(block.getTensors().size() == 2);
+    REQUIRE(block.commit() == 0);
+    program.bindParameterList(block);
+    auto builder = beginSequence(getContext());
+    builder.And(program.dispatch(1));
+
+    block.clear();
+    block.add(int32_t(3)).add(src).add(dstB).add(-1.0f);
+    REQUIRE(block.commit() == 1);
+    program.bindParameterList(block);
+    builder.And(program.dispatch(1))
+        .Then(retrieveTensor(dstA, bufferA))
+        .And(retrieveTensor(dstB, bufferB))
+        .Submit().wait();
+
+    auto expectedA = std::to_array<int32_t>({ 12, 14, 16, 18 });
+    auto expectedB = std::to_array<int32_t>({ 2, 5, 8, 11 });
+    REQUIRE(std::equal(expectedA.begin(), expectedA.end(), bufferA.getMemory().begin()));
+    REQUIRE(std::equal(expectedB.begin(), expectedB.end(), bufferB.getMemory().begin()));
+    REQUIRE_THROWS_AS(block.addBytes(std::as_bytes(std::span(input)), 64), std::logic_error);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
 TEST_CASE("program can use storage buffers", "[program]") {
     Buffer<int32_t> buffer(getContext(), 3);
     Tensor<int32_t> tensor(getContext(), 3);
@@ -106,7 +254,7 @@ TEST_CASE("program can use storage buffers", "[program]") {
     beginSequence(timeline)
         .And(program.dispatch(3))
         .Then(retrieveTensor(tensor, buffer))
-        .Submit();
+        .Submit().wait();
     
     REQUIRE(std::equal(dataIdx.begin(), dataIdx.end(), buffer.getMemory().begin()));
 
@@ -123,7 +271,7 @@ TEST_CASE("program can use storage image", "[program]") {
     beginSequence(timeline)
         .And(program.dispatch(3))
         .Then(retrieveImage(image, buffer))
-        .Submit();
+        .Submit().wait();
 
     REQUIRE(std::equal(dataIdx.begin(), dataIdx.end(), buffer.getMemory().begin()));
 
@@ -139,6 +287,89 @@ TEST_CASE("program can reflect the local size", "[program]") {
     REQUIRE(localSize.z == 2);
 }
 
+TEST_CASE("program can reflect the layout of blocks", "[program]") {
+    std::string source = R"(
+#version 460
+#extension GL_EXT_scalar_block_layout : require
+
+layout(local_size_x = 1) in;
+
+struct Item {
+    uint id;
+    vec2 pos;
+};
+
+layout(scalar, binding = 0) buffer Data {
+    vec3 dir;
+    float weight;
+    Item items[2];
+    mat2x3 frame;
+    uint tail[];
+};
+
+layout(scalar, push_constant) uniform Push {
+    float scale;
+    vec3 offset;
+} push;
+
+void main() {
+    dir = push.offset * push.scale;
+    items[1].pos = frame[1].xy;
+    tail[items[0].id] = uint(weight);
+}
+)";
+    Compiler compiler;
+    Program program(getContext(), compiler.compile(source));
+
+    //tightly packed without padding
+    auto& members = program.getBindingTraits(0).members;
+    REQUIRE(members.size() == 5);
+    REQUIRE(members[0].name == "dir");
+    REQUIRE(members[0].offset == 0);
+    REQUIRE(members[0].type == MemberType::FLOAT);
+    REQUIRE(members[0].width == 32);
+    REQUIRE(members[0].components == 3);
+    REQUIRE(members[1].offset == 12);
+    auto& items = members[2];
+    REQUIRE(items.offset == 16);
+    REQUIRE(items.type == MemberType::STRUCT);
+    REQUIRE(items.arrayDims == std::vector<uint32_t>{ 2 });
+    REQUIRE(items.arrayStride == 12);
+    REQUIRE(items.size == 24);
+    REQUIRE(items.members.size() == 2);
+    REQUIRE(items.members[1].name == "pos");
+    REQUIRE(items.members[1].offset == 4);
+    auto& frame = members[3];
+    REQUIRE(frame.offset == 40);
+    REQUIRE(frame.columns == 2);
+    REQUIRE(frame.components == 3);
+    REQUIRE(frame.matrixStride == 12);
+    auto& tail = members[4];
+    REQUIRE(tail.offset == 64);
+    REQUIRE(tail.type == MemberType::UINT);
+    REQUIRE(tail.arrayDims == std::vector<uint32_t>{ 0 });
+    REQUIRE(tail.size == 0);
+
+    REQUIRE(program.getPushConstantSize() == 16);
+    auto& push = program.getPushConstantMembers();
+    REQUIRE(push.size() == 2);
+    REQUIRE(push[1].name == "offset");
+    REQUIRE(push[1].offset == 4);
+
+    //layout survives bundles
+    ProgramBundle bundle;
+    bundle.add("layout", compiler.compile(source));
+    ProgramBundle loaded(bundle.serialize());
+    auto traits = loaded.getBindingTraits("layout");
+    REQUIRE(traits.size() == 1);
+    REQUIRE(traits[0].members.size() == 5);
+    REQUIRE(traits[0].members[2].members[1].offset == 4);
+    auto reloaded = loaded.createProgram(getContext(), "layout");
+    REQUIRE(reloaded.getPushConstantMembers().size() == 2);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
 TEST_CASE("dispatch command checks if all params are bound", "[program]") {
     Program program(getContext(), ubo_code);
     CHECK_THROWS(beginSequence(getContext()).And(program.dispatch(3)));
@@ -165,3 +396,676 @@ TEST_CASE("dispatch indirect correctly reads work group size from buffer", "[pro
 
     REQUIRE(!hasValidationErrorOccurred());
 }
+
+TEST_CASE("consecutive dispatches only rebind changed state", "[program]") {
+    Buffer<int32_t> bufferA(getContext(), 3), bufferB(getContext(), 3);
+    Tensor<int32_t> tensorA(getContext(), 3), tensorB(getContext(), 3);
+    Program program(getContext(), push_code);
+    DataStruct other{ 7, 8, 9 };
+
+    //same program; changing params, changing push data and nothing changed
+    auto builder = beginSequence(getContext());
+    program.bindParameterList(tensorA);
+    builder.And(program.dispatch(dataStruct, 3));
+    program.bindParameterList(tensorB);
+    builder.And(program.dispatch(other, 3))
+        .And(program.dispatch(other, 3))
+        .Then(retrieveTensor(tensorA, bufferA))
+        .And(retrieveTensor(tensorB, bufferB))
+        .Submit().wait();
+
+    auto expected = std::to_array<int32_t>({ 7, 8, 9 });
+    REQUIRE(std::equal(data.begin(), data.end(), bufferA.getMemory().begin()));
+    REQUIRE(std::equal(expected.begin(), expected.end(), bufferB.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("dispatch indirect lists run dispatches of different programs", "[program]") {
+    Tensor<uint32_t> tensorA(getContext(), 3), tensorB(getContext(), 3);
+    Buffer<uint32_t> bufferA(getContext(), 3), bufferB(getContext(), 3);
+
+    //last entry dispatches zero groups, i.e. does not run
+    Buffer<uint32_t> paramBuffer(getContext(), { 12,45,13,46,45,16,0,0,0 });
+    Tensor<uint32_t> paramTensor(getContext(), paramBuffer.size());
+    Program programA(getContext(), dispatchIndirect_code);
+    Program programB(getContext(), dispatchIndirect_code);
+    programA.bindParameterList(tensorA);
+    programB.bindParameterList(tensorB);
+
+    auto dispatches = std::to_array({
+        programA.dispatchIndirect(paramTensor, 12),
+        programB.dispatchIndirect(paramTensor, 0),
+        programB.dispatchIndirect(paramTensor, 24)
+    });
+    beginSequence(getContext())
+        .And(updateTensor(paramBuffer, paramTensor))
+        .And(dispatchIndirectList(dispatches))
+        .AndList(
+            retrieveTensor(tensorA, bufferA),
+            retrieveTensor(tensorB, bufferB)
+        ).Submit().wait();
+
+    auto expectedA = std::to_array<uint32_t>({ 46,45,16 });
+    auto expectedB = std::to_array<uint32_t>({ 12,45,13 });
+    REQUIRE(std::equal(expectedA.begin(), expectedA.end(), bufferA.getMemory().begin()));
+    REQUIRE(std::equal(expectedB.begin(), expectedB.end(), bufferB.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("parameter sets can be rebound without re-recording", "[program]") {
+    Buffer<int32_t> buffer(getContext(), 3);
+    Tensor<int32_t> tensorA(getContext(), 3), tensorB(getContext(), 3);
+    Program program(getContext(), sbo_code);
+    ParameterSet set(program);
+
+    auto sub = createSubroutine(getContext(), program.dispatch(set, 3));
+
+    for (auto tensor : { &tensorA, &tensorB }) {
+        set.bindParameterList(*tensor);
+        set.update();
+        execute(getContext(), sub);
+
+        execute(getContext(), retrieveTensor(*tensor, buffer));
+        REQUIRE(std::equal(dataIdx.begin(), dataIdx.end(), buffer.getMemory().begin()));
+        std::fill(buffer.getMemory().begin(), buffer.getMemory().end(), 0);
+    }
+
+    //sets check their bindings before updating
+    ParameterSet unbound(program);
+    REQUIRE_THROWS(unbound.update());
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("pipeline caches can be saved and loaded", "[program]") {
+    auto path = std::filesystem::temp_directory_path() / "hephaistos_test_cache.bin";
+    std::filesystem::remove(path);
+    REQUIRE(!loadPipelineCache(getContext(), path));
+
+    //ensure there is something in the cache
+    Program program(getContext(), sbo_code);
+    savePipelineCache(getContext(), path);
+    REQUIRE(std::filesystem::exists(path));
+    REQUIRE(loadPipelineCache(getContext(), path));
+
+    REQUIRE(setPipelineCacheFile(getContext(), path));
+    REQUIRE(getPipelineCacheFile(getContext()) == path);
+    setPipelineCacheFile(getContext(), {});
+    REQUIRE(getPipelineCacheFile(getContext()).empty());
+
+    //data from other devices gets rejected
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        std::array<char, 64> garbage{};
+        file.write(garbage.data(), garbage.size());
+    }
+    REQUIRE(!loadPipelineCache(getContext(), path));
+
+    std::filesystem::remove(path);
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("programs can be created in parallel", "[program]") {
+    std::array<ProgramSource, 4> sources{ {
+        { spec_code, std::as_bytes(std::span(&dataStruct, 1)) },
+        { localsize_code },
+        { sbo_code },
+        { localsize_code }
+    } };
+    auto programs = createPrograms(getContext(), sources);
+    REQUIRE(programs.size() == 4);
+    REQUIRE(programs[1].getLocalSize().x == 4);
+    REQUIRE(programs[3].getLocalSize().z == 2);
+
+    //specialization is applied
+    Buffer<int32_t> buffer(getContext(), 3);
+    Tensor<int32_t> tensor(getContext(), 3);
+    programs[0].bindParameterList(tensor);
+    beginSequence(getContext())
+        .And(programs[0].dispatch(3))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("program bundles round trip and create programs", "[program]") {
+    ProgramBundle bundle;
+    bundle.add("spec", spec_code, std::as_bytes(std::span(&dataStruct, 1)));
+    bundle.add("localsize", localsize_code);
+    bundle.add("image", image_code);
+    REQUIRE_THROWS_AS(bundle.add("spec", sbo_code), std::logic_error);
+
+    //reflection survives serialization
+    ProgramBundle loaded(bundle.serialize());
+    REQUIRE(loaded.size() == 3);
+    REQUIRE(loaded.getNames() == bundle.getNames());
+    REQUIRE(loaded.contains("localsize"));
+    REQUIRE(!loaded.contains("sbo"));
+    REQUIRE(loaded.getLocalSize("localsize").x == 4);
+    REQUIRE(loaded.getLocalSize("localsize").z == 2);
+    auto expected = bundle.getBindingTraits("image");
+    auto traits = loaded.getBindingTraits("image");
+    REQUIRE(traits.size() == expected.size());
+    for (auto i = 0u; i < traits.size(); ++i) {
+        REQUIRE(traits[i].name == expected[i].name);
+        REQUIRE(traits[i].binding == expected[i].binding);
+        REQUIRE(traits[i].type == expected[i].type);
+        REQUIRE(traits[i].imageTraits.has_value() == expected[i].imageTraits.has_value());
+    }
+    REQUIRE_THROWS_AS(loaded.getLocalSize("sbo"), std::out_of_range);
+
+    //truncated data is rejected
+    auto blob = bundle.serialize();
+    REQUIRE_THROWS_AS(ProgramBundle(std::span(blob).first(blob.size() - 1)), std::runtime_error);
+
+    loaded.warmUp(getContext()).get();
+    auto programs = loaded.createPrograms(getContext());
+    REQUIRE(programs.size() == 3);
+    REQUIRE(programs[1].getLocalSize().y == 4);
+
+    //specialization is applied
+    auto program = loaded.createProgram(getContext(), "spec");
+    Buffer<int32_t> buffer(getContext(), 3);
+    Tensor<int32_t> tensor(getContext(), 3);
+    program.bindParameterList(tensor);
+    beginSequence(getContext())
+        .And(program.dispatch(3))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("program families create each variant once", "[program]") {
+    ProgramFamily family(getContext(), spec_code);
+    DataStruct other{ 7, 8, 9 };
+    auto& programA = family.getVariant(dataStruct);
+    auto& programB = family.getVariant(other);
+    REQUIRE(&programA != &programB);
+    REQUIRE(&family.getVariant(dataStruct) == &programA);
+    REQUIRE(family.size() == 2);
+
+    Buffer<int32_t> buffer(getContext(), 3);
+    Tensor<int32_t> tensor(getContext(), 3);
+    programB.bindParameterList(tensor);
+    beginSequence(getContext())
+        .And(programB.dispatch(3))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    auto expected = std::to_array<int32_t>({ 7, 8, 9 });
+    REQUIRE(std::equal(expected.begin(), expected.end(), buffer.getMemory().begin()));
+
+    family.clear();
+    REQUIRE(family.size() == 0);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("program caches reuse and evict programs", "[program]") {
+    ProgramCache cache(getContext(), { .maxPrograms = 2 });
+    DataStruct other{ 7, 8, 9 };
+    DataStruct third{ 4, 5, 6 };
+    auto programA = cache.get(spec_code, dataStruct);
+    auto programB = cache.get(spec_code, other);
+    REQUIRE(programA != programB);
+    REQUIRE(cache.get(spec_code, dataStruct) == programA);
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache.getCodeSize() == 2 * sizeof(spec_code));
+
+    //B is least recently used -> gets dropped
+    auto programC = cache.get(spec_code, third);
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache.get(spec_code, dataStruct) == programA);
+    REQUIRE(cache.get(spec_code, other) != programB);
+    auto stats = cache.getStatistics();
+    REQUIRE(stats.hits == 2);
+    REQUIRE(stats.misses == 4);
+    REQUIRE(stats.evictions == 2);
+
+    //dropped programs stay usable
+    Buffer<int32_t> buffer(getContext(), 3);
+    Tensor<int32_t> tensor(getContext(), 3);
+    programB->bindParameterList(tensor);
+    beginSequence(getContext())
+        .And(programB->dispatch(3))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    auto expected = std::to_array<int32_t>({ 7, 8, 9 });
+    REQUIRE(std::equal(expected.begin(), expected.end(), buffer.getMemory().begin()));
+
+    //sources are only compiled once
+    std::string source = R"(
+        #version 460
+        layout(local_size_x = 1) in;
+        buffer Data { int data[]; };
+        void main() { data[0] = 42; }
+    )";
+    Compiler compiler;
+    cache.setLimits({ .maxPrograms = 0, .maxCodeSize = 0 });
+    auto compiled = cache.compile(compiler, source);
+    REQUIRE(cache.compile(compiler, source) == compiled);
+
+    cache.setLimits({ .maxPrograms = 1 });
+    REQUIRE(cache.size() == 1);
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.getCodeSize() == 0);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("programs with the same signature can be dispatched consecutively", "[program]") {
+    Buffer<int32_t> bufferA(getContext(), 3), bufferB(getContext(), 3);
+    Tensor<int32_t> tensorA(getContext(), 3), tensorB(getContext(), 3);
+    //same code -> shared reflection and layout
+    DataStruct other{ 7, 8, 9 };
+    Program programA(getContext(), spec_code, dataStruct);
+    Program programB(getContext(), spec_code, other);
+    programA.bindParameterList(tensorA);
+    programB.bindParameterList(tensorB);
+    REQUIRE(programA.listBindings().size() == programB.listBindings().size());
+
+    beginSequence(getContext())
+        .And(programA.dispatch(3))
+        .And(programB.dispatch(3))
+        .Then(retrieveTensor(tensorA, bufferA))
+        .And(retrieveTensor(tensorB, bufferB))
+        .Submit().wait();
+
+    auto expected = std::to_array<int32_t>({ 7, 8, 9 });
+    REQUIRE(std::equal(data.begin(), data.end(), bufferA.getMemory().begin()));
+    REQUIRE(std::equal(expected.begin(), expected.end(), bufferB.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("parameter sets can use descriptor buffers", "[program]") {
+    auto devices = enumerateDevices();
+    auto device = std::find_if(devices.begin(), devices.end(), isDescriptorBufferSupported);
+    if (device == devices.end())
+        SKIP("no device supports descriptor buffers");
+    auto extensions = std::to_array({ createDescriptorBufferExtension() });
+    auto context = createContext(*device, extensions);
+    REQUIRE(isDescriptorBufferEnabled(context));
+
+    Buffer<int32_t> buffer(context, 3);
+    Tensor<int32_t> tensorA(context, 3), tensorB(context, 3);
+    Program program(context, sbo_code);
+    ParameterSet setA(program), setB(program);
+    setA.bindParameterList(tensorA);
+    setA.update();
+    setB.bindParameterList(tensorB);
+    setB.update();
+    //mixing with pushed descriptors
+    program.bindParameterList(tensorB);
+
+    beginSequence(context)
+        .And(clearTensor(tensorA, {}))
+        .And(clearTensor(tensorB, {}))
+        .Then(program.dispatch(setA, 3))
+        .Then(program.dispatch(3))
+        .Then(program.dispatch(setB, 3))
+        .Then(retrieveTensor(tensorA, buffer))
+        .Submit().wait();
+    REQUIRE(std::equal(dataIdx.begin(), dataIdx.end(), buffer.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("programs can be dispatched using resource heaps", "[program]") {
+    auto devices = enumerateDevices();
+    auto device = std::find_if(devices.begin(), devices.end(), isResourceHeapSupported);
+    if (device == devices.end())
+        SKIP("no device supports resource heaps");
+    auto extensions = std::to_array({ createResourceHeapExtension(16) });
+    auto context = createContext(*device, extensions);
+    REQUIRE(isResourceHeapEnabled(context));
+
+    Buffer<int32_t> buffer(context, 3);
+    Tensor<int32_t> tensorA(context, 3), tensorB(context, 3);
+    ResourceHeap heap(context);
+    REQUIRE(heap.capacity() == 16);
+    REQUIRE(heap.add(tensorA) == 0);
+    REQUIRE(heap.add(tensorB) == 1);
+    REQUIRE(heap.size() == 2);
+    //freed indices get reused
+    heap.remove(0);
+    REQUIRE(heap.size() == 1);
+    REQUIRE_THROWS(heap.remove(0));
+    REQUIRE(heap.add(tensorB) == 0);
+    heap.set(0, tensorA);
+
+    //sbo writes to the first storage buffer in the heap
+    Program program(context, sbo_code);
+    beginSequence(context)
+        .And(clearTensor(tensorA, {}))
+        .Then(program.dispatch(heap, 3))
+        .Then(retrieveTensor(tensorA, buffer))
+        .Submit().wait();
+    REQUIRE(std::equal(dataIdx.begin(), dataIdx.end(), buffer.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("programs can require a subgroup size", "[program]") {
+    auto props = getSubgroupProperties(getContext());
+    REQUIRE(props.minSubgroupSize <= props.subgroupSize);
+    REQUIRE(props.subgroupSize <= props.maxSubgroupSize);
+    if (!props.requiredSubgroupSizeSupport)
+        SKIP("device does not support requiring subgroup sizes");
+
+    Buffer<int32_t> buffer(getContext(), 3);
+    Tensor<int32_t> tensor(getContext(), 3);
+    Program program(getContext(), sbo_code, {},
+        SubgroupRequirements{ .size = props.minSubgroupSize });
+    program.bindParameterList(tensor);
+
+    beginSequence(getContext())
+        .And(program.dispatch(3))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    REQUIRE(std::equal(dataIdx.begin(), dataIdx.end(), buffer.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("dispatching elements splits oversized grids", "[program]") {
+    //exceeds the minimum limit of 65535 groups per dimension
+    constexpr uint32_t n = 70000;
+    Buffer<int32_t> buffer(getContext(), n);
+    Tensor<int32_t> tensor(getContext(), n);
+    Program program(getContext(), sbo_code);
+    program.bindParameterList(tensor);
+
+    beginSequence(getContext())
+        .And(program.dispatchElements(n))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    std::vector<int32_t> expected(n);
+    std::iota(expected.begin(), expected.end(), 0);
+    REQUIRE(std::equal(expected.begin(), expected.end(), buffer.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("pipeline statistics count compute invocations", "[program]") {
+    if (!isPipelineStatisticsSupported(getContext()))
+        SKIP("Pipeline statistics are not supported!");
+
+    constexpr uint32_t n = 1000;
+    Tensor<int32_t> tensor(getContext(), n);
+    Program program(getContext(), sbo_code);
+    program.bindParameterList(tensor);
+    PipelineStatistics stats(getContext());
+
+    //statistics must be recorded within the same step
+    beginSequence(getContext())
+        .And(stats.start())
+        .And(program.dispatch(n))
+        .And(stats.stop())
+        .Submit().wait();
+    auto result = stats.getResult(true);
+    REQUIRE(result.invocations == n);
+    REQUIRE(result.elapsedTime >= 0.0);
+
+    //reset allows to reuse the query
+    stats.reset();
+    beginSequence(getContext())
+        .And(stats.start())
+        .And(program.dispatch(n / 2))
+        .And(stats.stop())
+        .Submit().wait();
+    REQUIRE(stats.getResult(true).invocations == n / 2);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("programs can reload their code", "[program]") {
+    Buffer<int32_t> buffer(getContext(), 3);
+    Tensor<int32_t> tensor(getContext(), 3);
+    Program program(getContext(), sbo_code);
+    program.bindParameterList(tensor);
+    beginSequence(getContext())
+        .And(program.dispatch(3))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    REQUIRE(std::equal(dataIdx.begin(), dataIdx.end(), buffer.getMemory().begin()));
+
+    SECTION("same signature keeps bound parameters") {
+        program.reload(spec_code, dataStruct);
+        REQUIRE(program.isBindingBound(0));
+        beginSequence(getContext())
+            .And(program.dispatch(3))
+            .Then(retrieveTensor(tensor, buffer))
+            .Submit().wait();
+        REQUIRE(std::equal(data.begin(), data.end(), buffer.getMemory().begin()));
+    }
+
+    SECTION("different signature resets bindings") {
+        program.reload(ubo_code);
+        REQUIRE(program.listBindings().size() == 2);
+        REQUIRE(!program.isBindingBound(0));
+        REQUIRE(!program.isBindingBound(1));
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("programs can be created as shader objects", "[program]") {
+    auto devices = enumerateDevices();
+    auto& device = devices.front();
+    if (!isShaderObjectSupported(device))
+        SKIP("Shader objects are not supported!");
+
+    auto ext = createShaderObjectExtension();
+    auto context = createContext(device, { &ext, 1 });
+    REQUIRE(isShaderObjectEnabled(context));
+
+    Buffer<int32_t> buffer(context, 3);
+    Tensor<int32_t> tensor(context, 3);
+    Program program(context, sbo_code);
+    program.bindParameterList(tensor);
+    beginSequence(context)
+        .And(program.dispatch(3))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    REQUIRE(std::equal(dataIdx.begin(), dataIdx.end(), buffer.getMemory().begin()));
+
+    //recreate program from its binary
+    auto binary = program.getShaderBinary();
+    REQUIRE(!binary.empty());
+    Program cached(context, sbo_code, {}, {}, binary);
+    cached.bindParameterList(tensor);
+    std::fill(buffer.getMemory().begin(), buffer.getMemory().end(), 0);
+    beginSequence(context)
+        .And(cached.dispatch(3))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    REQUIRE(std::equal(dataIdx.begin(), dataIdx.end(), buffer.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("programs report their resource usage", "[program]") {
+    constexpr char source[] = R"(
+#version 460
+
+layout(local_size_x = 64) in;
+
+layout(binding = 0) buffer Data { float v[]; };
+
+shared float cache[64];
+shared vec4 extra[4];
+
+void main() {
+    uint i = gl_LocalInvocationID.x;
+    cache[i] = v[i];
+    if (i < 4)
+        extra[i] = vec4(v[i]);
+    barrier();
+    v[i] = cache[63 - i] + extra[i % 4].x;
+}
+)";
+    Compiler compiler;
+    Program program(getContext(), compiler.compile(source));
+    auto stats = program.getStatistics();
+    REQUIRE(stats.sharedMemorySize == 64 * 4 + 4 * 16);
+    REQUIRE(stats.residentGroups > 0);
+    REQUIRE(stats.occupancy > 0.0f);
+    REQUIRE(stats.occupancy <= 1.0f);
+
+    //programs without shared memory are only limited by their threads
+    Program plain(getContext(), sbo_code);
+    REQUIRE(plain.getStatistics().sharedMemorySize == 0);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("programs can override the buffer robustness", "[program]") {
+    if (!isProgramRobustnessSupported(getContext())) {
+        REQUIRE_THROWS_AS(setProgramRobustness(getContext(), BufferRobustness::DISABLED),
+            std::runtime_error);
+        REQUIRE(getProgramRobustness(getContext()) == BufferRobustness::DEFAULT);
+        return;
+    }
+
+    setProgramRobustness(getContext(), BufferRobustness::DISABLED);
+    REQUIRE(getProgramRobustness(getContext()) == BufferRobustness::DISABLED);
+    Buffer<int32_t> buffer(getContext(), 3);
+    Tensor<int32_t> tensor(getContext(), 3);
+    Program program(getContext(), sbo_code);
+    setProgramRobustness(getContext(), BufferRobustness::DEFAULT);
+    program.bindParameterList(tensor);
+
+    Timeline timeline(getContext());
+    beginSequence(timeline)
+        .And(program.dispatch(3))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+
+    REQUIRE(std::equal(dataIdx.begin(), dataIdx.end(), buffer.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("programs can bind cached descriptor sets", "[program]") {
+    setDescriptorSetCache(getContext(), true);
+    REQUIRE(isDescriptorSetCacheEnabled(getContext()));
+    Program program(getContext(), sbo_code);
+    setDescriptorSetCache(getContext(), false);
+    REQUIRE(program.usesDescriptorSetCache());
+
+    Buffer<int32_t> buffer(getContext(), 3);
+    Tensor<int32_t> first(getContext(), 3);
+    Tensor<int32_t> second(getContext(), 3);
+    //switching back and forth reuses the sets written before
+    program.bindParameterList(first);
+    auto dispatchFirst = program.dispatch(3);
+    program.bindParameterList(second);
+    auto dispatchSecond = program.dispatch(3);
+    program.bindParameterList(first);
+
+    Timeline timeline(getContext());
+    beginSequence(timeline)
+        .And(dispatchFirst)
+        .Then(dispatchSecond)
+        .Then(program.dispatch(3))
+        .Then(retrieveTensor(second, buffer))
+        .Submit().wait();
+    REQUIRE(std::equal(dataIdx.begin(), dataIdx.end(), buffer.getMemory().begin()));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("programs with more bindings than can be pushed fall back to cached sets", "[program]") {
+    //exceeds the common limit of 32 push descriptors
+    constexpr auto BindingCount = 40;
+    std::string source = "#version 460\nlayout(local_size_x = 1) in;\n";
+    for (auto i = 0; i < BindingCount; ++i) {
+        auto n = std::to_string(i);
+        source += "layout(binding = " + n + ") buffer B" + n + " { int v" + n + "[]; };\n";
+    }
+    source += "void main() {\n";
+    for (auto i = 0; i < BindingCount; ++i) {
+        auto n = std::to_string(i);
+        source += "    v" + n + "[" + n + "] = " + n + ";\n";
+    }
+    source += "}\n";
+
+    Compiler compiler;
+    Program program(getContext(), compiler.compile(source));
+    Buffer<int32_t> buffer(getContext(), BindingCount);
+    Tensor<int32_t> tensor(getContext(), BindingCount);
+    for (auto i = 0u; i < BindingCount; ++i)
+        program.bindParameter(tensor, i);
+
+    Timeline timeline(getContext());
+    beginSequence(timeline)
+        .And(program.dispatch())
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+    auto memory = buffer.getMemory();
+    for (auto i = 0u; i < BindingCount; ++i)
+        REQUIRE(memory[i] == static_cast<int32_t>(i));
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("programs can bind arrays of parameters", "[program]") {
+    Compiler compiler;
+    Program program(getContext(), compiler.compile(R"(
+#version 460
+layout(local_size_x = 1) in;
+layout(binding = 0) readonly buffer In { int value; } inputs[4];
+layout(binding = 1) writeonly buffer Out { int result[]; };
+void main() {
+    //dynamically uniform index
+    uint i = gl_WorkGroupID.x;
+    result[i] = inputs[i].value;
+}
+)"));
+    REQUIRE(program.listBindings()[0].count == 4);
+
+    std::vector<Tensor<int32_t>> tensors;
+    for (auto i = 0; i < 4; ++i)
+        tensors.emplace_back(getContext(), std::vector<int32_t>{ 10 * i + 1 });
+    std::array<const Argument*, 4> args;
+    for (auto i = 0u; i < 4; ++i)
+        args[i] = &tensors[i];
+    Tensor<int32_t> result(getContext(), 4);
+    Buffer<int32_t> buffer(getContext(), 4);
+
+    //all elements in a single write
+    program.bindParameterArray(args, 0);
+    program.bindParameter(result, 1);
+    execute(getContext(), program.dispatch(4));
+    execute(getContext(), retrieveTensor(result, buffer));
+    auto memory = buffer.getMemory();
+    for (auto i = 0; i < 4; ++i)
+        REQUIRE(memory[i] == 10 * i + 1);
+
+    //arrays must fit the binding
+    std::array<const Argument*, 5> tooMany{ &result, &result, &result, &result, &result };
+    REQUIRE_THROWS_AS(program.bindParameterArray(tooMany, 0), std::logic_error);
+
+    //trailing elements can stay unbound
+    if (isPartiallyBoundEnabled(getContext())) {
+        std::array<const Argument*, 2> partial{ args[3], args[2] };
+        program.bindParameterArray(partial, 0);
+        execute(getContext(), program.dispatch(2));
+        execute(getContext(), retrieveTensor(result, buffer));
+        REQUIRE(memory[0] == 31);
+        REQUIRE(memory[1] == 21);
+    }
+    else {
+        std::array<const Argument*, 2> partial{ args[0], args[1] };
+        REQUIRE_THROWS_AS(program.bindParameterArray(partial, 0), std::logic_error);
+    }
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
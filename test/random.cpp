@@ -0,0 +1,106 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <vector>
+
+#include <hephaistos/buffer.hpp>
+#include <hephaistos/command.hpp>
+#include <hephaistos/compiler.hpp>
+#include <hephaistos/context.hpp>
+#include <hephaistos/program.hpp>
+#include <hephaistos/random.hpp>
+
+#include "validation.hpp"
+
+using namespace hephaistos;
+
+namespace {
+
+ContextHandle getContext() {
+    static ContextHandle context = createEmptyContext();
+    if (!context)
+        context = createContext();
+    return context;
+}
+
+constexpr char source[] = R"(
+#version 460
+
+#include "hephaistos/random.glsl"
+
+layout(local_size_x = 32) in;
+
+writeonly buffer Output { uint values[]; };
+
+layout(push_constant) uniform Push {
+    RandomStreams streams;
+};
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    RandomStream rng = createRandomStream(streams, i);
+    for (uint j = 0u; j < 6u; ++j)
+        values[6u * i + j] = randomUint(rng);
+}
+)";
+
+}
+
+TEST_CASE("philox matches known answers", "[random]") {
+    //test vectors of Random123
+    using Block = std::array<uint32_t, 4>;
+    Block zeros = { 0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u };
+    Block ones = { 0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu };
+    auto a = philox4x32({ 0u, 0u, 0u, 0u }, { 0u, 0u });
+    auto b = philox4x32({ ~0u, ~0u, ~0u, ~0u }, { ~0u, ~0u });
+    REQUIRE(a == zeros);
+    REQUIRE(b == ones);
+}
+
+TEST_CASE("random stream allocator hands out disjoint ranges", "[random]") {
+    RandomStreamAllocator allocator(42, 5);
+    auto a = allocator.allocate(10);
+    auto b = allocator.allocate(3);
+    REQUIRE(a.seed == 42);
+    REQUIRE(a.offset == 5);
+    REQUIRE(b.offset == 15);
+    REQUIRE(allocator.getAllocated() == 18);
+
+    allocator.reset();
+    REQUIRE(allocator.allocate(1).offset == 0);
+}
+
+TEST_CASE("random header generates philox streams on the device", "[random]") {
+    auto context = getContext();
+    Compiler compiler;
+    Program program(context, compiler.compile(source));
+
+    constexpr uint32_t N = 64;
+    Tensor<uint32_t> tensor(context, 6 * N);
+    Buffer<uint32_t> buffer(context, 6 * N);
+    program.bindParameterList(tensor);
+
+    //offset crosses the 32 bit boundary of the stream index
+    RandomStreamAllocator allocator(0x0123456789ABCDEFull, 0xFFFFFFF0ull);
+    auto streams = allocator.allocate(N);
+    beginSequence(context)
+        .And(program.dispatch(streams, N / 32))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+
+    bool correct = true;
+    auto mem = buffer.getMemory();
+    std::array<uint32_t, 2> key = {
+        static_cast<uint32_t>(streams.seed), static_cast<uint32_t>(streams.seed >> 32) };
+    for (auto i = 0u; i < N; ++i) {
+        auto stream = streams.offset + i;
+        for (auto j = 0u; j < 6u; ++j) {
+            auto block = philox4x32({ j / 4, 0u,
+                static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32) }, key);
+            correct &= mem[6 * i + j] == block[j % 4];
+        }
+    }
+    REQUIRE(correct);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
@@ -4,6 +4,10 @@
 #include <algorithm>
 #include <array>
 #include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
 
 #include <hephaistos/hephaistos.hpp>
 #include <hephaistos/raytracing.hpp>
@@ -169,7 +173,7 @@ TEST_CASE("ray queries are available in shaders", "[raytracing]") {
     beginSequence(timeline)
         .And(program.dispatch(6))
         .Then(retrieveTensor(tensor, buffer))
-        .Submit();
+        .Submit().wait();
     
     //check result
     auto result = buffer.getMemory();
@@ -185,3 +189,725 @@ TEST_CASE("ray queries are available in shaders", "[raytracing]") {
     //check validation errors
     REQUIRE(!hasValidationErrorOccurred());
 }
+
+TEST_CASE("geometries can be refit to new vertices", "[raytracing]") {
+    //Check if we have the necessary hardware for this check
+    if (!isRaytracingSupported(getDevice(getContext())))
+        SKIP("No ray tracing hardware for testing available.");
+
+    //build geometries out of reach of the rays
+    auto shift = [](std::span<const float> vertices) {
+        std::vector<float> result(vertices.begin(), vertices.end());
+        for (auto i = 0u; i < result.size(); i += 3)
+            result[i] += 10.f;
+        return result;
+    };
+    auto farTriangle = shift(triangle_vertices);
+    auto farSquare = shift(square_vertices);
+    GeometryStore store(getContext(), std::to_array<Mesh>({
+        { //triangle
+            .vertices = std::as_bytes(std::span<const float>(farTriangle))
+        },
+        { //square
+            .vertices = std::as_bytes(std::span<const float>(farSquare)),
+            .indices = square_indices
+        }
+    }), false, { .allowUpdate = true });
+    REQUIRE(store.updatable());
+
+    //move them back in place
+    Tensor<float> triangleTensor(getContext(), triangle_vertices);
+    Tensor<float> squareTensor(getContext(), square_vertices);
+    Timeline timeline(getContext());
+    beginSequence(timeline)
+        .And(updateGeometry(store, 0, triangleTensor))
+        .And(updateGeometry(store, 1, squareTensor))
+        .Submit().wait();
+
+    //create acceleration structure
+    auto transforms = std::to_array({
+        TopTransform, BottomTransform,
+        LeftTransform, RightTransform,
+        BackTransform, FrontTransform
+    });
+    std::vector<GeometryInstance> instances;
+    for (auto i = 0u; i < transforms.size(); ++i)
+        instances.push_back(store.createInstance(i % 2, transforms[i], customIdx[i]));
+    AccelerationStructure tlas(getContext(), instances);
+
+    //run program
+    Buffer<Result> buffer(getContext(), 6);
+    Tensor<Result> tensor(getContext(), 6);
+    Program program(getContext(), raytracing_code);
+    program.bindParameterList(tlas, tensor);
+    beginSequence(timeline, 1)
+        .And(program.dispatch(6))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+
+    //check result
+    auto result = buffer.getMemory();
+    for (auto i = 0u; i < result.size(); ++i) {
+        REQUIRE(result[i].hit == 1);
+        REQUIRE_THAT(result[i].hitX, Catch::Matchers::WithinAbs(expectedX[i], eps));
+        REQUIRE_THAT(result[i].hitY, Catch::Matchers::WithinAbs(expectedY[i], eps));
+        REQUIRE_THAT(result[i].hitZ, Catch::Matchers::WithinAbs(expectedZ[i], eps));
+    }
+
+    //stores must opt into updates
+    GeometryStore fixed(getContext(), Mesh{
+        .vertices = std::as_bytes(std::span<const float>(triangle_vertices))
+    });
+    REQUIRE(!fixed.updatable());
+
+    //check validation errors
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("acceleration structures can be built in the background", "[raytracing]") {
+    //Check if we have the necessary hardware for this check
+    if (!isRaytracingSupported(getDevice(getContext())))
+        SKIP("No ray tracing hardware for testing available.");
+
+    auto meshes = std::to_array<Mesh>({
+        { //triangle
+            .vertices = std::as_bytes(std::span<const float>(triangle_vertices))
+        },
+        { //square
+            .vertices = std::as_bytes(std::span<const float>(square_vertices)),
+            .indices = square_indices
+        }
+    });
+    auto pendingStore = GeometryStore::buildAsync(getContext(), meshes, true);
+    auto store = pendingStore.get();
+    REQUIRE(store.size() == 2);
+    REQUIRE(store[1].indices_address != 0);
+
+    auto instances = std::to_array({
+        store.createInstance(0, TopTransform),
+        store.createInstance(1, BottomTransform)
+    });
+    auto pendingTlas = AccelerationStructure::buildAsync(getContext(), instances);
+    auto tlas = pendingTlas.get();
+
+    //check validation errors
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("acceleration structures can be rebuilt from tensors", "[raytracing]") {
+    //Check if we have the necessary hardware for this check
+    if (!isRaytracingSupported(getDevice(getContext())))
+        SKIP("No ray tracing hardware for testing available.");
+
+    //build geometries
+    GeometryStore store(getContext(), std::to_array<Mesh>({
+        { //triangle
+            .vertices = std::as_bytes(std::span<const float>(triangle_vertices))
+        },
+        { //square
+            .vertices = std::as_bytes(std::span<const float>(square_vertices)),
+            .indices = square_indices
+        }
+    }));
+
+    //upload instances
+    auto transforms = std::to_array({
+        TopTransform, BottomTransform,
+        LeftTransform, RightTransform,
+        BackTransform, FrontTransform
+    });
+    std::vector<GeometryInstance> instances;
+    for (auto i = 0u; i < transforms.size(); ++i)
+        instances.push_back(store.createInstance(i % 2, transforms[i], customIdx[i]));
+    std::vector<std::byte> instanceData(instances.size() * GeometryInstanceSize);
+    writeInstances(instances, instanceData);
+    Tensor<std::byte> instanceTensor(getContext(), instanceData);
+
+    //build on device
+    AccelerationStructure tlas(getContext(), 8, { .allowUpdate = true });
+    REQUIRE(tlas.maxInstances() == 8);
+    REQUIRE_THROWS(writeInstances(instances, std::span(instanceData).first(64)));
+
+    //create program
+    Buffer<Result> buffer(getContext(), 6);
+    Tensor<Result> tensor(getContext(), 6);
+    Program program(getContext(), raytracing_code);
+    program.bindParameterList(tlas, tensor);
+
+    //run program
+    Timeline timeline(getContext());
+    beginSequence(timeline)
+        .And(rebuildAccelerationStructure(tlas, instanceTensor, 6))
+        .Then(rebuildAccelerationStructure(tlas, instanceTensor, 6, 0, true))
+        .Then(program.dispatch(6))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+
+    //check result
+    auto result = buffer.getMemory();
+    for (auto i = 0u; i < result.size(); ++i) {
+        REQUIRE(result[i].hit == 1);
+        REQUIRE(result[i].customIdx == customIdx[i]);
+        REQUIRE(result[i].instanceIdx == instanceIdx[i]);
+        REQUIRE_THAT(result[i].hitX, Catch::Matchers::WithinAbs(expectedX[i], eps));
+        REQUIRE_THAT(result[i].hitY, Catch::Matchers::WithinAbs(expectedY[i], eps));
+        REQUIRE_THAT(result[i].hitZ, Catch::Matchers::WithinAbs(expectedZ[i], eps));
+    }
+
+    //check validation errors
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("acceleration structures can be built on the compute queue", "[raytracing]") {
+    //Check if we have the necessary hardware for this check
+    if (!isRaytracingSupported(getDevice(getContext())))
+        SKIP("No ray tracing hardware for testing available.");
+
+    //initial builds and compaction keep the main queue free
+    BuildOptions options{ .queue = QueueType::COMPUTE };
+    GeometryStore store(getContext(), std::to_array<Mesh>({
+        { //triangle
+            .vertices = std::as_bytes(std::span<const float>(triangle_vertices))
+        },
+        { //square
+            .vertices = std::as_bytes(std::span<const float>(square_vertices)),
+            .indices = square_indices
+        }
+    }), false, options);
+
+    auto transforms = std::to_array({
+        TopTransform, BottomTransform,
+        LeftTransform, RightTransform,
+        BackTransform, FrontTransform
+    });
+    std::vector<GeometryInstance> instances;
+    for (auto i = 0u; i < transforms.size(); ++i)
+        instances.push_back(store.createInstance(i % 2, transforms[i], customIdx[i]));
+    AccelerationStructure built(getContext(), instances, options);
+    std::vector<std::byte> instanceData(instances.size() * GeometryInstanceSize);
+    writeInstances(instances, instanceData);
+    Tensor<std::byte> instanceTensor(getContext(), instanceData);
+
+    //rebuild on the compute queue while the main queue traces the built one
+    AccelerationStructure rebuilt(getContext(), 8, { .allowUpdate = true });
+    Buffer<Result> buffer(getContext(), 12);
+    Tensor<Result> builtResult(getContext(), 6), rebuiltResult(getContext(), 6);
+    Program builtProgram(getContext(), raytracing_code);
+    builtProgram.bindParameterList(built, builtResult);
+    Program rebuiltProgram(getContext(), raytracing_code);
+    rebuiltProgram.bindParameterList(rebuilt, rebuiltResult);
+
+    //transfer queues may lack the capabilities for building
+    BuildOptions transfer{ .queue = QueueType::TRANSFER };
+    REQUIRE_THROWS_AS(AccelerationStructure(getContext(), instances, transfer),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(GeometryStore(getContext(), Mesh{
+        .vertices = std::as_bytes(std::span<const float>(triangle_vertices))
+    }, false, transfer), std::invalid_argument);
+
+    Timeline timeline(getContext());
+    beginSequence(timeline)
+        .OnQueue(QueueType::COMPUTE)
+        .And(rebuildAccelerationStructure(rebuilt, instanceTensor, 6))
+        .OnQueue(QueueType::MAIN)
+        .And(builtProgram.dispatch(6))
+        .Then(rebuiltProgram.dispatch(6))
+        .Then(retrieveTensor(builtResult, buffer))
+        .And(retrieveTensor(rebuiltResult, buffer, { .bufferOffset = 6 * sizeof(Result) }))
+        .Submit().wait();
+
+    //check result
+    auto result = buffer.getMemory();
+    for (auto i = 0u; i < result.size(); ++i) {
+        auto j = i % 6;
+        REQUIRE(result[i].hit == 1);
+        REQUIRE(result[i].customIdx == customIdx[j]);
+        REQUIRE(result[i].instanceIdx == instanceIdx[j]);
+        REQUIRE_THAT(result[i].hitX, Catch::Matchers::WithinAbs(expectedX[j], eps));
+        REQUIRE_THAT(result[i].hitY, Catch::Matchers::WithinAbs(expectedY[j], eps));
+        REQUIRE_THAT(result[i].hitZ, Catch::Matchers::WithinAbs(expectedZ[j], eps));
+    }
+
+    //check validation errors
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("geometries can be built without compaction", "[raytracing]") {
+    //Check if we have the necessary hardware for this check
+    if (!isRaytracingSupported(getDevice(getContext())))
+        SKIP("No ray tracing hardware for testing available.");
+
+    auto meshes = std::to_array<Mesh>({
+        { //triangle
+            .vertices = std::as_bytes(std::span<const float>(triangle_vertices))
+        },
+        { //square
+            .vertices = std::as_bytes(std::span<const float>(square_vertices)),
+            .indices = square_indices
+        }
+    });
+    GeometryStore compacted(getContext(), meshes);
+    auto& compactedSizes = compacted.buildSizes();
+    REQUIRE(compactedSizes.built > 0);
+    REQUIRE(compactedSizes.compacted > 0);
+    REQUIRE(compactedSizes.compacted <= compactedSizes.built);
+
+    GeometryStore fast(getContext(), meshes, false, {
+        .preference = BuildPreference::FAST_BUILD,
+        .compact = false
+    });
+    REQUIRE(fast.size() == 2);
+    REQUIRE(fast.buildSizes().built == fast.buildSizes().compacted);
+
+    AccelerationStructure tlas(getContext(), std::to_array({
+        fast.createInstance(0, TopTransform),
+        fast.createInstance(1, BottomTransform)
+    }), { .preference = BuildPreference::FAST_BUILD });
+    REQUIRE(tlas.size_bytes() > 0);
+
+    //check validation errors
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("procedural geometries can be built from boxes", "[raytracing]") {
+    //Check if we have the necessary hardware for this check
+    if (!isRaytracingSupported(getDevice(getContext())))
+        SKIP("No ray tracing hardware for testing available.");
+
+    //min xyz followed by max xyz
+    const auto boxes = std::to_array<float>({
+        -1.f, -1.f, -1.f, 0.f, 0.f, 0.f,
+        0.f, 0.f, 0.f, 1.f, 1.f, 1.f
+    });
+    auto sets = std::to_array<BoundingBoxes>({
+        { .boxes = std::as_bytes(std::span<const float>(boxes)) },
+        { .boxes = std::as_bytes(std::span<const float>(boxes).first(6)) }
+    });
+    GeometryStore store(getContext(), sets, true);
+    REQUIRE(store.size() == 2);
+    REQUIRE(store[0].blas_address != 0);
+    REQUIRE(store[0].vertices_address != 0);
+    REQUIRE(store[0].indices_address == 0);
+
+    AccelerationStructure tlas(getContext(), std::to_array({
+        store.createInstance(0, TopTransform, 1),
+        store.createInstance(1, BottomTransform, 2)
+    }));
+    REQUIRE(tlas.size_bytes() > 0);
+
+    //boxes must be 8 byte aligned
+    REQUIRE_THROWS(GeometryStore(getContext(), BoundingBoxes{
+        .boxes = std::as_bytes(std::span<const float>(boxes)),
+        .stride = 7 * sizeof(float)
+    }));
+
+    //check validation errors
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("geometries can be serialized", "[raytracing]") {
+    //Check if we have the necessary hardware for this check
+    if (!isRaytracingSupported(getDevice(getContext())))
+        SKIP("No ray tracing hardware for testing available.");
+
+    auto meshes = std::to_array<Mesh>({
+        { //triangle
+            .vertices = std::as_bytes(std::span<const float>(triangle_vertices))
+        },
+        { //square
+            .vertices = std::as_bytes(std::span<const float>(square_vertices)),
+            .indices = square_indices
+        }
+    });
+    GeometryStore store(getContext(), meshes);
+    REQUIRE(!store.deserialized());
+    auto data = store.serialize();
+    REQUIRE(!data.empty());
+
+    SECTION("serialized geometries can be loaded") {
+        GeometryStore loaded(getContext(), data, meshes);
+        REQUIRE(loaded.deserialized());
+        REQUIRE(loaded.size() == 2);
+        REQUIRE(loaded[1].blas_address != 0);
+
+        AccelerationStructure tlas(getContext(), std::to_array({
+            loaded.createInstance(0, TopTransform),
+            loaded.createInstance(1, BottomTransform)
+        }));
+        REQUIRE(tlas.size_bytes() > 0);
+    }
+    SECTION("malformed data falls back to building") {
+        data[0] = std::byte{ 0 };
+        GeometryStore built(getContext(), data, meshes);
+        REQUIRE(!built.deserialized());
+        REQUIRE(built.size() == 2);
+    }
+    SECTION("mismatching meshes fall back to building") {
+        GeometryStore built(getContext(), data, std::span(meshes).first(1));
+        REQUIRE(!built.deserialized());
+        REQUIRE(built.size() == 1);
+    }
+
+    //check validation errors
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("geometries can be built from compact formats", "[raytracing]") {
+    //Check if we have the necessary hardware for this check
+    if (!isRaytracingSupported(getDevice(getContext())))
+        SKIP("No ray tracing hardware for testing available.");
+
+    //square as half floats (1.0 = 0x3C00, -1.0 = 0xBC00); w is ignored
+    const auto half_vertices = std::to_array<uint16_t>({
+        0x3C00, 0x3C00, 0x0000, 0x0000,
+        0xBC00, 0xBC00, 0x0000, 0x0000,
+        0x3C00, 0xBC00, 0x0000, 0x0000,
+        0xBC00, 0x3C00, 0x0000, 0x0000
+    });
+    //same square as snorm16
+    const auto snorm_vertices = std::to_array<int16_t>({
+        32767, 32767, 0, 0,
+        -32767, -32767, 0, 0,
+        32767, -32767, 0, 0,
+        -32767, 32767, 0, 0
+    });
+    const auto short_indices = std::to_array<uint16_t>({
+        0, 1, 2,
+        0, 3, 1
+    });
+    auto meshes = std::to_array<Mesh>({
+        {
+            .vertices = std::as_bytes(std::span<const uint16_t>(half_vertices)),
+            .vertexStride = 4 * sizeof(uint16_t),
+            .vertexFormat = VertexFormat::FLOAT16,
+            .indices16 = short_indices
+        },
+        {
+            .vertices = std::as_bytes(std::span<const int16_t>(snorm_vertices)),
+            .vertexStride = 4 * sizeof(int16_t),
+            .vertexFormat = VertexFormat::SNORM16,
+            .indices16 = short_indices
+        },
+        { //mixed with regular formats
+            .vertices = std::as_bytes(std::span<const float>(square_vertices)),
+            .indices = square_indices
+        }
+    });
+    GeometryStore store(getContext(), meshes, true);
+    REQUIRE(store.size() == 3);
+    REQUIRE(store[0].indices_address != 0);
+    REQUIRE(store[2].vertices_address % 4 == 0);
+    REQUIRE(store[2].indices_address % 4 == 0);
+
+    AccelerationStructure tlas(getContext(), std::to_array({
+        store.createInstance(0, TopTransform),
+        store.createInstance(1, BottomTransform),
+        store.createInstance(2, LeftTransform)
+    }));
+    REQUIRE(tlas.size_bytes() > 0);
+
+    //only one kind of indices allowed
+    REQUIRE_THROWS(GeometryStore(getContext(), Mesh{
+        .vertices = std::as_bytes(std::span<const float>(square_vertices)),
+        .indices = square_indices,
+        .indices16 = short_indices
+    }));
+
+    //check validation errors
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("geometries can be built from tensors", "[raytracing]") {
+    //Check if we have the necessary hardware for this check
+    if (!isRaytracingSupported(getDevice(getContext())))
+        SKIP("No ray tracing hardware for testing available.");
+
+    Tensor<float> triangleTensor(getContext(), triangle_vertices);
+    Tensor<float> squareTensor(getContext(), square_vertices);
+    Tensor<uint32_t> indexTensor(getContext(), square_indices);
+    GeometryStore store(getContext(), std::to_array<TensorMesh>({
+        { //triangle
+            .vertices = &triangleTensor,
+            .vertexCount = static_cast<uint32_t>(triangle_vertices.size() / 3)
+        },
+        { //square
+            .vertices = &squareTensor,
+            .vertexCount = static_cast<uint32_t>(square_vertices.size() / 3),
+            .indices = &indexTensor,
+            .indexCount = static_cast<uint32_t>(square_indices.size())
+        }
+    }));
+    REQUIRE(store[0].vertices_address == triangleTensor.address());
+    REQUIRE(store[1].indices_address == indexTensor.address());
+
+    //create acceleration structure
+    auto transforms = std::to_array({
+        TopTransform, BottomTransform,
+        LeftTransform, RightTransform,
+        BackTransform, FrontTransform
+    });
+    std::vector<GeometryInstance> instances;
+    for (auto i = 0u; i < transforms.size(); ++i)
+        instances.push_back(store.createInstance(i % 2, transforms[i], customIdx[i]));
+    AccelerationStructure tlas(getContext(), instances);
+
+    //run program
+    Buffer<Result> buffer(getContext(), 6);
+    Tensor<Result> tensor(getContext(), 6);
+    Program program(getContext(), raytracing_code);
+    program.bindParameterList(tlas, tensor);
+    Timeline timeline(getContext());
+    beginSequence(timeline)
+        .And(program.dispatch(6))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+
+    //check result
+    auto result = buffer.getMemory();
+    for (auto i = 0u; i < result.size(); ++i) {
+        REQUIRE(result[i].hit == 1);
+        REQUIRE_THAT(result[i].hitX, Catch::Matchers::WithinAbs(expectedX[i], eps));
+        REQUIRE_THAT(result[i].hitY, Catch::Matchers::WithinAbs(expectedY[i], eps));
+        REQUIRE_THAT(result[i].hitZ, Catch::Matchers::WithinAbs(expectedZ[i], eps));
+    }
+
+    //tensors must hold all vertices
+    REQUIRE_THROWS(GeometryStore(getContext(), std::to_array<TensorMesh>({
+        { .vertices = &triangleTensor, .vertexCount = 100 }
+    })));
+
+    //check validation errors
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("geometries can be loaded from mesh files", "[raytracing]") {
+    //Check if we have the necessary hardware for this check
+    if (!isRaytracingSupported(getDevice(getContext())))
+        SKIP("No ray tracing hardware for testing available.");
+
+    auto meshes = std::to_array<Mesh>({
+        { //triangle
+            .vertices = std::as_bytes(std::span<const float>(triangle_vertices))
+        },
+        { //square
+            .vertices = std::as_bytes(std::span<const float>(square_vertices)),
+            .indices = square_indices
+        }
+    });
+    auto path = std::filesystem::temp_directory_path() / "hephaistos_meshes.bin";
+    saveMeshes(path, meshes);
+
+    {
+        GeometryStore store(getContext(), path, true);
+        REQUIRE(store.size() == 2);
+        REQUIRE(store[0].vertices_address != 0);
+        REQUIRE(store[0].indices_address == 0);
+        REQUIRE(store[1].indices_address != 0);
+
+        AccelerationStructure tlas(getContext(), std::to_array({
+            store.createInstance(0, TopTransform),
+            store.createInstance(1, BottomTransform)
+        }));
+        REQUIRE(tlas.size_bytes() > 0);
+    }
+
+    //truncated files are rejected
+    std::filesystem::resize_file(path, 20);
+    REQUIRE_THROWS_AS(GeometryStore(getContext(), path), std::runtime_error);
+    std::filesystem::remove(path);
+
+    //check validation errors
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+namespace {
+
+constexpr auto RayGenSource = R"(
+    #version 460
+    #extension GL_EXT_ray_tracing : require
+
+    layout(location = 0) rayPayloadEXT uint payload;
+
+    layout(binding = 0) uniform accelerationStructureEXT tlas;
+    layout(binding = 1) writeonly buffer Results { uint results[]; };
+
+    void main() {
+        //first ray hits the top triangle, the second one misses
+        vec3 dir = vec3(0.0, 0.0, gl_LaunchIDEXT.x == 0 ? 1.0 : -1.0);
+        traceRayEXT(tlas, gl_RayFlagsOpaqueEXT, 0xFF, 0, 0, 0,
+            vec3(0.0), 0.0, dir, 100.0, 0);
+        results[gl_LaunchIDEXT.x] = payload;
+    }
+)";
+constexpr auto MissSource = R"(
+    #version 460
+    #extension GL_EXT_ray_tracing : require
+
+    layout(location = 0) rayPayloadInEXT uint payload;
+
+    void main() {
+        payload = 0;
+    }
+)";
+constexpr auto ClosestHitSource = R"(
+    #version 460
+    #extension GL_EXT_ray_tracing : require
+
+    layout(location = 0) rayPayloadInEXT uint payload;
+
+    void main() {
+        payload = gl_InstanceCustomIndexEXT + 1;
+    }
+)";
+
+std::vector<uint32_t> compileStage(std::string_view source, ShaderStage stage) {
+    Compiler compiler;
+    compiler.setOptions({ .stage = stage });
+    return compiler.compile(source);
+}
+
+}
+
+TEST_CASE("ray tracing programs trace rays using shader binding tables", "[raytracing]") {
+    //Check if we have the necessary hardware for this check
+    if (!isRaytracingPipelineSupported(getDevice(getContext())))
+        SKIP("No ray tracing pipeline support for testing available.");
+    auto extensions = std::to_array({ createRaytracingExtension(true) });
+    auto context = createContext(getDevice(getContext()), extensions);
+    REQUIRE(isRaytracingPipelineEnabled(context));
+
+    auto rayGen = compileStage(RayGenSource, ShaderStage::RAYGEN);
+    auto miss = compileStage(MissSource, ShaderStage::MISS);
+    auto closestHit = compileStage(ClosestHitSource, ShaderStage::CLOSEST_HIT);
+    RayTracingProgram program(context, {
+        .rayGen = rayGen,
+        .miss = { miss },
+        .hitGroups = { { .closestHit = closestHit } }
+    });
+    REQUIRE(program.getMissCount() == 1);
+    REQUIRE(program.getHitGroupCount() == 1);
+    //bindings of all shaders are merged
+    REQUIRE(program.listBindings().size() == 2);
+    REQUIRE(program.getBindingTraits(0).type == ParameterType::ACCELERATION_STRUCTURE);
+
+    //build scene
+    GeometryStore store(context, Mesh{
+        .vertices = std::as_bytes(std::span<const float>(triangle_vertices))
+    });
+    GeometryInstance instance{
+        .blas_address = store[0].blas_address,
+        .transform = TopTransform,
+        .customIndex = 41
+    };
+    AccelerationStructure tlas(context, instance);
+
+    //trace
+    Buffer<uint32_t> buffer(context, 2);
+    Tensor<uint32_t> tensor(context, 2);
+    REQUIRE_THROWS_AS(program.traceRays(2), std::logic_error);
+    program.bindParameterList(tlas, tensor);
+    REQUIRE(program.isBindingBound(1));
+    Timeline timeline(context);
+    beginSequence(timeline)
+        .And(program.traceRays(2))
+        .Then(retrieveTensor(tensor, buffer))
+        .Submit().wait();
+
+    auto result = buffer.getMemory();
+    REQUIRE(result[0] == 42);
+    REQUIRE(result[1] == 0);
+
+    //check validation errors
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("ray casters cast rays without custom shaders", "[raytracing]") {
+    //Check if we have the necessary hardware for this check
+    if (!isRaytracingSupported(getDevice(getContext())))
+        SKIP("No ray tracing hardware for testing available.");
+
+    //two triangles behind each other along +z
+    GeometryStore store(getContext(), Mesh{
+        .vertices = std::as_bytes(std::span<const float>(triangle_vertices))
+    });
+    TransformMatrix farTransform = TopTransform;
+    farTransform.matrix[2][3] = 2.0f;
+    AccelerationStructure tlas(getContext(), std::to_array({
+        store.createInstance(0, TopTransform, 7),
+        store.createInstance(0, farTransform, 8)
+    }));
+
+    //first ray hits both, second one misses
+    auto rays = std::to_array<Ray>({
+        { { 0.f, 0.f, 0.f }, 0.f, { 0.f, 0.f, 1.f }, 100.f },
+        { { 0.f, 0.f, 0.f }, 0.f, { 0.f, 0.f, -1.f }, 100.f }
+    });
+    Tensor<Ray> rayTensor(getContext(), rays);
+    Tensor<RayHit> hitTensor(getContext(), rays.size());
+    Buffer<RayHit> buffer(getContext(), rays.size());
+
+    RayCaster caster(getContext());
+    REQUIRE(caster.getLocalSize() > 0);
+    auto cast = [&](RayCastMode mode) {
+        execute(getContext(), caster.castRays(tlas, rayTensor, hitTensor, mode));
+        execute(getContext(), retrieveTensor(hitTensor, buffer));
+        return buffer.getMemory();
+    };
+
+    auto closest = cast(RayCastMode::CLOSEST);
+    REQUIRE_THAT(closest[0].t, Catch::Matchers::WithinAbs(1.0f, eps));
+    REQUIRE(closest[0].instanceIndex == 0);
+    REQUIRE(closest[0].customIndex == 7);
+    REQUIRE(closest[0].count == 1);
+    REQUIRE(closest[1].instanceIndex == RayHit::Miss);
+    REQUIRE(closest[1].count == 0);
+
+    auto any = cast(RayCastMode::ANY);
+    REQUIRE(any[0].instanceIndex != RayHit::Miss);
+    REQUIRE(any[1].instanceIndex == RayHit::Miss);
+
+    auto counted = cast(RayCastMode::COUNT);
+    REQUIRE(counted[0].count == 2);
+    REQUIRE(counted[0].customIndex == 7);
+    REQUIRE(counted[1].count == 0);
+
+    //hits must fit
+    Tensor<RayHit> small(getContext(), 1);
+    REQUIRE_THROWS_AS(caster.castRays(tlas, rayTensor, small), std::logic_error);
+
+    //check validation errors
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("ray casters compile every mode", "[raytracing]") {
+    //Check if we have the necessary hardware for this check
+    if (!isRaytracingSupported(getDevice(getContext())))
+        SKIP("No ray tracing hardware for testing available.");
+
+    GeometryStore store(getContext(), Mesh{
+        .vertices = std::as_bytes(std::span<const float>(triangle_vertices))
+    });
+    AccelerationStructure tlas(getContext(), std::to_array({
+        store.createInstance(0, TopTransform)
+    }));
+
+    //more rays than a single group handles, all hitting the triangle
+    constexpr uint32_t N = 100;
+    std::vector<Ray> rays(N, { { 0.f, 0.f, 0.f }, 0.f, { 0.f, 0.f, 1.f }, 100.f });
+    Tensor<Ray> rayTensor(getContext(), rays);
+    Tensor<RayHit> hitTensor(getContext(), N);
+    Buffer<RayHit> buffer(getContext(), N);
+
+    RayCaster caster(getContext(), { .localSize = 16, .raysPerThread = 4 });
+    for (auto mode : { RayCastMode::CLOSEST, RayCastMode::ANY, RayCastMode::COUNT }) {
+        execute(getContext(), caster.castRays(tlas, rayTensor, hitTensor, mode));
+        execute(getContext(), retrieveTensor(hitTensor, buffer));
+        for (auto& hit : buffer.getMemory()) {
+            REQUIRE(hit.instanceIndex == 0);
+            REQUIRE(hit.count == 1);
+        }
+    }
+
+    //check validation errors
+    REQUIRE(!hasValidationErrorOccurred());
+}
@@ -0,0 +1,141 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include <hephaistos/command.hpp>
+#include <hephaistos/compiler.hpp>
+#include <hephaistos/context.hpp>
+#include <hephaistos/program.hpp>
+#include <hephaistos/stream.hpp>
+
+#include "validation.hpp"
+
+using namespace hephaistos;
+
+namespace {
+
+ContextHandle getContext() {
+    static ContextHandle context = createEmptyContext();
+    if (!context)
+        context = createContext();
+    return context;
+}
+
+constexpr char source[] = R"(
+#version 460
+
+layout(local_size_x = 32) in;
+
+readonly buffer Input { uint x[]; };
+writeonly buffer Output { uint y[]; };
+readonly buffer Count { uint count; };
+
+void main() {
+    uint i = gl_GlobalInvocationID.x;
+    if (i < count)
+        y[i] = 2u * x[i] + 1u;
+}
+)";
+
+}
+
+TEST_CASE("chunk size is derived from the memory budget", "[stream]") {
+    auto context = getContext();
+    auto small = getStreamChunkSize(context, 1024, 3, 0.5f);
+    auto large = getStreamChunkSize(context, 4, 3, 0.5f);
+    REQUIRE(small >= 1);
+    REQUIRE(large >= small);
+}
+
+TEST_CASE("stream executor processes chunks in order", "[stream]") {
+    auto context = getContext();
+    Compiler compiler;
+    Program program(context, compiler.compile(source));
+
+    //many chunks with a partial last one; transfers run on the transfer queue,
+    //which may be a transfer only family
+    constexpr uint32_t ChunkSize = 1000;
+    constexpr uint32_t N = 10501;
+    StreamExecutor executor(context, 4, 4, { .chunkSize = ChunkSize, .useTransferQueue = true });
+    REQUIRE(executor.getChunkSize() == ChunkSize);
+    REQUIRE(executor.getSlotCount() == 3);
+
+    std::vector<Subroutine> subroutines;
+    std::vector<std::reference_wrapper<const Subroutine>> compute;
+    for (auto i = 0u; i < executor.getSlotCount(); ++i) {
+        auto slot = executor.getSlot(i);
+        program.bindParameterList(slot.input, slot.output, slot.count);
+        subroutines.push_back(createSubroutine(context, program.dispatch(ChunkSize / 32 + 1)));
+    }
+    for (auto& s : subroutines)
+        compute.push_back(s);
+
+    std::vector<uint32_t> input(N), output;
+    for (auto i = 0u; i < N; ++i)
+        input[i] = i;
+    uint64_t next = 0;
+    bool ordered = true;
+    auto chunks = executor.run(compute,
+        [&](std::span<std::byte> chunk, uint64_t index) -> uint64_t {
+            auto count = std::min<uint64_t>(ChunkSize, N - next);
+            std::memcpy(chunk.data(), input.data() + next, count * 4);
+            next += count;
+            return count;
+        },
+        [&](std::span<const std::byte> chunk, uint64_t index) {
+            ordered &= output.size() == index * ChunkSize;
+            auto offset = output.size();
+            output.resize(offset + chunk.size() / 4);
+            std::memcpy(output.data() + offset, chunk.data(), chunk.size());
+        });
+
+    REQUIRE(chunks == N / ChunkSize + 1);
+    REQUIRE(ordered);
+    REQUIRE(output.size() == N);
+    bool correct = true;
+    for (auto i = 0u; i < N; ++i)
+        correct &= output[i] == 2 * i + 1;
+    REQUIRE(correct);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("streaming uploader and downloader round trip data", "[stream]") {
+    auto context = getContext();
+    //several staging buffers worth of data with a partial last one
+    constexpr uint32_t N = 10001;
+    StreamingUploader uploader(context, 1024, 2, QueueType::TRANSFER);
+    StreamingDownloader downloader(context, 1000, 3, QueueType::TRANSFER);
+    REQUIRE(uploader.getBufferCount() == 2);
+    REQUIRE(downloader.getBufferSize() == 1000);
+
+    std::vector<uint32_t> data(N), result(N);
+    for (auto i = 0u; i < N; ++i)
+        data[i] = i * 7u;
+    Tensor<uint32_t> tensor(context, N);
+
+    uploader.upload(std::as_bytes(std::span(data)), tensor);
+    uploader.wait();
+    downloader.download(tensor, std::as_writable_bytes(std::span(result)));
+    REQUIRE(downloader.getPendingCount() == 0);
+    REQUIRE(data == result);
+
+    //manual use of the staging memory
+    auto mem = uploader.next();
+    std::memset(mem.data(), 0xFF, 16);
+    uploader.upload(tensor, 8, 16);
+    uploader.wait();
+    downloader.download(tensor, 0, 32);
+    auto chunk = downloader.fetch();
+    REQUIRE(chunk.size() == 32);
+    auto values = reinterpret_cast<const uint32_t*>(chunk.data());
+    REQUIRE(values[1] == 7u);
+    REQUIRE(values[2] == 0xFFFFFFFFu);
+    REQUIRE(values[5] == 0xFFFFFFFFu);
+    REQUIRE(values[6] == 42u);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
@@ -0,0 +1,75 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cmath>
+#include <filesystem>
+
+#include <hephaistos/buffer.hpp>
+#include <hephaistos/compiler.hpp>
+#include <hephaistos/context.hpp>
+#include <hephaistos/program.hpp>
+#include <hephaistos/tuning.hpp>
+
+#include "validation.hpp"
+
+using namespace hephaistos;
+
+namespace {
+
+ContextHandle getContext() {
+    static ContextHandle context = createEmptyContext();
+    if (!context)
+        context = createContext();
+    return context;
+}
+
+constexpr auto tunable_source = R"(
+    #version 460
+
+    layout(local_size_x_id = 0) in;
+
+    writeonly buffer tensorOut { int out_c[]; };
+
+    void main() {
+        uint idx = gl_GlobalInvocationID.x;
+        out_c[idx] = int(idx);
+    }
+)";
+
+struct Candidate {
+    uint32_t localSize;
+};
+
+}
+
+TEST_CASE("programs can be tuned for the device", "[tuning]") {
+    Compiler compiler;
+    auto code = compiler.compile(tunable_source);
+    Tensor<int32_t> tensor(getContext(), 256);
+    auto candidates = std::to_array<Candidate>({ { 16 }, { 32 }, { 64 } });
+    auto dispatch = [&](Program& program, uint32_t i) {
+        program.bindParameterList(tensor);
+        return program.dispatch(256 / candidates[i].localSize);
+    };
+
+    auto cacheFile = std::filesystem::temp_directory_path() / "hephaistos_tuning_test.txt";
+    std::filesystem::remove(cacheFile);
+    TuningOptions options{ .cacheFile = cacheFile };
+
+    auto result = tuneProgram(getContext(), code,
+        std::span<const Candidate>{ candidates }, dispatch, options);
+    REQUIRE(result.index < candidates.size());
+    REQUIRE(result.specialization.size() == sizeof(Candidate));
+    REQUIRE(result.times.size() == candidates.size());
+    for (auto time : result.times)
+        REQUIRE(std::isfinite(time));
+
+    //second run is read from the cache
+    auto cached = tuneProgram(getContext(), code,
+        std::span<const Candidate>{ candidates }, dispatch, options);
+    REQUIRE(cached.index == result.index);
+    REQUIRE(cached.times.empty());
+    std::filesystem::remove(cacheFile);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
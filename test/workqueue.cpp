@@ -0,0 +1,136 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include <hephaistos/buffer.hpp>
+#include <hephaistos/command.hpp>
+#include <hephaistos/compiler.hpp>
+#include <hephaistos/context.hpp>
+#include <hephaistos/program.hpp>
+#include <hephaistos/workqueue.hpp>
+
+#include "validation.hpp"
+
+using namespace hephaistos;
+
+namespace {
+
+ContextHandle getContext() {
+    static ContextHandle context = createEmptyContext();
+    if (!context)
+        context = createContext();
+    return context;
+}
+
+//each item counts down its remaining steps, visiting it once per step
+constexpr char source[] = R"(
+#version 460
+
+#include "hephaistos/workqueue.glsl"
+
+layout(local_size_x = 32) in;
+
+buffer Visits { uint visits[]; };
+
+layout(push_constant) uniform Push {
+    WorkQueue queue;
+    uint count;
+    uint _padding;
+};
+
+void main() {
+    uint item;
+    while (workQueuePop(queue, item)) {
+        uint i = item % count;
+        uint steps = item / count;
+        atomicAdd(visits[i], 1u);
+        if (steps > 0u)
+            workQueuePush(queue, (steps - 1u) * count + i);
+    }
+}
+)";
+
+struct Push {
+    uint64_t queue;
+    uint32_t count;
+    uint32_t _padding;
+};
+
+}
+
+TEST_CASE("work queue processes items until it drains", "[workqueue]") {
+    auto context = getContext();
+    Compiler compiler;
+    Program program(context, compiler.compile(source));
+
+    //item i takes i % 5 + 1 steps
+    constexpr uint32_t N = 1000;
+    std::vector<uint32_t> seed(N);
+    uint32_t total = 0;
+    for (auto i = 0u; i < N; ++i) {
+        seed[i] = (i % 5) * N + i;
+        total += i % 5 + 1;
+    }
+    Tensor<uint32_t> items(context, seed);
+    Tensor<uint32_t> visits(context, N);
+    Buffer<uint32_t> result(context, N);
+    Buffer<WorkQueueHeader> header(context, 1);
+    program.bindParameterList(visits);
+
+    WorkQueue queue(context, N);
+    REQUIRE(queue.getCapacity() == N);
+    REQUIRE(queue.getOccupancy(program) >= 1);
+
+    //limit groups so rounds get spread over multiple passes
+    beginSequence(context)
+        .And(clearTensor(visits, {}))
+        .And(queue.seed(items))
+        .Then(queue.launch(program, Push{ queue.getAddress(), N, 0 }, 8, 4))
+        .Then(retrieveTensor(visits, result))
+        .And(retrieveTensor(queue.getTensor(), header, { .size = sizeof(WorkQueueHeader) }))
+        .Submit().wait();
+
+    auto& state = header.getMemory()[0];
+    REQUIRE(state.round == 8);
+    REQUIRE(state.processed == total);
+    REQUIRE(state.overflow == 0);
+    REQUIRE(state.dispatch[0] == 0);
+    bool correct = true;
+    auto mem = result.getMemory();
+    for (auto i = 0u; i < N; ++i)
+        correct &= mem[i] == i % 5 + 1;
+    REQUIRE(correct);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
+
+TEST_CASE("work queue can be seeded with a range", "[workqueue]") {
+    auto context = getContext();
+    Compiler compiler;
+    Program program(context, compiler.compile(source));
+
+    constexpr uint32_t N = 100;
+    Tensor<uint32_t> visits(context, N);
+    Buffer<uint32_t> result(context, N);
+    program.bindParameterList(visits);
+
+    WorkQueue queue(context, N);
+    REQUIRE_THROWS_AS(queue.seed(N + 1), std::out_of_range);
+
+    //single step per item; remaining rounds dispatch nothing
+    beginSequence(context)
+        .And(clearTensor(visits, {}))
+        .And(queue.seed(N - 10, 10))
+        .Then(queue.launch(program, Push{ queue.getAddress(), N, 0 }))
+        .Then(retrieveTensor(visits, result))
+        .Submit().wait();
+
+    bool correct = true;
+    auto mem = result.getMemory();
+    for (auto i = 0u; i < N; ++i)
+        correct &= mem[i] == (i >= 10 ? 1u : 0u);
+    REQUIRE(correct);
+
+    REQUIRE(!hasValidationErrorOccurred());
+}
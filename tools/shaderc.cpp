@@ -0,0 +1,214 @@
+#include <cctype>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include <hephaistos/hephaistos.hpp>
+
+using namespace hephaistos;
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: hephaistos_shaderc [options] <sources...>\n"
+        << "  -o <header>          Header to write the embedded shaders to\n"
+        << "  -n <namespace>       Namespace of the embedded shaders (default: shaders)\n"
+        << "  -I <dir>             Adds an include directory\n"
+        << "  -D <name>[=<value>]  Defines a macro\n"
+        << "  --strip              Strips debug information\n"
+        << "  --spirv-1.5          Targets SPIR-V 1.5 instead of 1.4\n";
+}
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Could not open " + path.string() + "!");
+    return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+}
+
+//file stem turned into a valid identifier
+std::string getIdentifier(const std::filesystem::path& path) {
+    auto name = path.stem().string();
+    for (auto& c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)))
+            c = '_';
+    }
+    if (name.empty() || std::isdigit(static_cast<unsigned char>(name.front())))
+        name.insert(name.begin(), '_');
+    return name;
+}
+
+std::string getTypeName(ParameterType type) {
+    switch (type) {
+    case ParameterType::COMBINED_IMAGE_SAMPLER: return "COMBINED_IMAGE_SAMPLER";
+    case ParameterType::SAMPLED_IMAGE: return "SAMPLED_IMAGE";
+    case ParameterType::STORAGE_IMAGE: return "STORAGE_IMAGE";
+    case ParameterType::UNIFORM_TEXEL_BUFFER: return "UNIFORM_TEXEL_BUFFER";
+    case ParameterType::STORAGE_TEXEL_BUFFER: return "STORAGE_TEXEL_BUFFER";
+    case ParameterType::UNIFORM_BUFFER: return "UNIFORM_BUFFER";
+    case ParameterType::STORAGE_BUFFER: return "STORAGE_BUFFER";
+    case ParameterType::ACCELERATION_STRUCTURE: return "ACCELERATION_STRUCTURE";
+    default: throw std::runtime_error("Unknown parameter type!");
+    }
+}
+
+template<class T>
+void writeArray(std::ostream& out, std::span<const T> data) {
+    out << "{";
+    for (size_t i = 0; i < data.size(); ++i) {
+        out << (i % 12 ? " " : "\n    ");
+        out << "0x" << std::hex << static_cast<uint32_t>(data[i]) << std::dec;
+        if (i + 1 < data.size())
+            out << ',';
+    }
+    out << "\n}";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::filesystem::path output;
+    std::string ns = "shaders";
+    std::vector<std::filesystem::path> sources;
+    CompileOptions options{};
+    Compiler compiler;
+    for (auto i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (++i >= argc) {
+                printUsage();
+                std::exit(1);
+            }
+            return argv[i];
+        };
+        if (arg == "-o") {
+            output = next();
+        }
+        else if (arg == "-n") {
+            ns = next();
+        }
+        else if (arg == "-I") {
+            compiler.addIncludeDir(next());
+        }
+        else if (arg == "-D") {
+            auto define = next();
+            auto pos = define.find('=');
+            if (pos == std::string::npos)
+                options.defines.emplace_back(define, "");
+            else
+                options.defines.emplace_back(define.substr(0, pos), define.substr(pos + 1));
+        }
+        else if (arg == "--strip") {
+            options.stripDebugInfo = true;
+        }
+        else if (arg == "--spirv-1.5") {
+            options.target = CompileTarget::VULKAN_1_2_SPIRV_1_5;
+        }
+        else if (arg.starts_with("-")) {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+        else {
+            sources.emplace_back(arg);
+        }
+    }
+    if (output.empty() || sources.empty()) {
+        printUsage();
+        return 1;
+    }
+    compiler.setOptions(std::move(options));
+
+    try {
+        std::ostringstream out;
+        out << "//generated by hephaistos_shaderc. Do not edit.\n"
+            << "#pragma once\n\n"
+            << "#include <cstdint>\n"
+            << "#include <span>\n"
+            << "#include <string_view>\n\n"
+            << "#include <hephaistos/program.hpp>\n\n"
+            << "namespace " << ns << " {\n\n";
+
+        ProgramBundle bundle;
+        std::unordered_set<std::string> names;
+        for (auto& source : sources) {
+            auto name = getIdentifier(source);
+            if (!names.insert(name).second)
+                throw std::runtime_error("Shader name " + name + " is used more than once!");
+            std::vector<uint32_t> code;
+            try {
+                code = compiler.compile(readFile(source));
+            }
+            catch (const std::exception& e) {
+                throw std::runtime_error(source.string() + ": " + e.what());
+            }
+            bundle.add(name, code);
+
+            auto& size = bundle.getLocalSize(name);
+            auto bindings = bundle.getBindingTraits(name);
+            out << "//compiled from " << source.filename().string() << '\n'
+                << "inline constexpr uint32_t " << name << "[] = ";
+            writeArray(out, std::span<const uint32_t>(code));
+            out << ";\n"
+                << "inline constexpr hephaistos::LocalSize " << name << "_localSize = { "
+                << size.x << ", " << size.y << ", " << size.z << " };\n"
+                << "inline constexpr uint32_t " << name << "_bindingCount = "
+                << bindings.size() << ";\n";
+            if (!bindings.empty()) {
+                out << "inline constexpr uint32_t " << name << "_bindings[] = {";
+                for (auto& binding : bindings)
+                    out << (&binding == bindings.data() ? " " : ", ") << binding.binding;
+                out << " };\n"
+                    << "inline constexpr std::string_view " << name << "_bindingNames[] = {";
+                for (auto& binding : bindings)
+                    out << (&binding == bindings.data() ? " \"" : ", \"") << binding.name << '"';
+                out << " };\n"
+                    << "inline constexpr hephaistos::ParameterType " << name << "_bindingTypes[] = {";
+                for (auto& binding : bindings) {
+                    out << (&binding == bindings.data() ? " " : ", ")
+                        << "hephaistos::ParameterType::" << getTypeName(binding.type);
+                }
+                out << " };\n";
+            }
+            out << '\n';
+        }
+
+        //the bundle carries the full reflection, so programs skip reflecting
+        auto data = bundle.serialize();
+        out << "//serialized ProgramBundle of all shaders above\n"
+            << "inline constexpr unsigned char bundleData[] = ";
+        writeArray(out, std::span<const std::byte>(data));
+        out << ";\n"
+            << "inline hephaistos::ProgramBundle loadBundle() {\n"
+            << "    return hephaistos::ProgramBundle(std::as_bytes(std::span(bundleData)));\n"
+            << "}\n\n"
+            << "}\n";
+
+        //keep the old file if nothing changed to not trigger a rebuild
+        auto header = out.str();
+        if (std::filesystem::exists(output) && readFile(output) == header)
+            return 0;
+        if (output.has_parent_path())
+            std::filesystem::create_directories(output.parent_path());
+        std::ofstream file(output, std::ios::binary);
+        file << header;
+        if (!file)
+            throw std::runtime_error("Could not write " + output.string() + "!");
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Embedding shaders failed!\n" << e.what() << '\n';
+        return 1;
+    }
+
+    //done
+    return 0;
+}